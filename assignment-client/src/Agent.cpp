@@ -11,15 +11,17 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEventLoop>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegExp>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
-#include <QtNetwork/QNetworkDiskCache>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
 #include <AvatarHashMap.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
+#include <PacketBundle.h>
 #include <PacketHeaders.h>
 #include <ResourceCache.h>
 #include <SoundCache.h>
@@ -55,99 +57,142 @@ void Agent::readPendingDatagrams() {
     auto nodeList = DependencyManager::get<NodeList>();
     
     while (readAvailableDatagram(receivedPacket, senderSockAddr)) {
-        if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
-            PacketType datagramPacketType = packetTypeForPacket(receivedPacket);
+        if (packetTypeForPacket(receivedPacket) == PacketTypeBundle) {
+            // the mixers bundle a frame's packets for us into one datagram, each handled as if it came on its own
+            if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
+                QVector<QByteArray> bundledPackets;
+                PacketBundle::unbundle(receivedPacket, bundledPackets);
+                foreach (const QByteArray& packet, bundledPackets) {
+                    processDatagram(packet, senderSockAddr);
+                }
+            }
+        } else {
+            processDatagram(receivedPacket, senderSockAddr);
+        }
+    }
+}
+
+void Agent::updateQueueDepths(PacketMetrics& metrics) {
+    metrics.setQueueDepth("entity_edit_packets", _entityEditSender.packetsToSendCount());
+}
+
+void Agent::processDatagram(const QByteArray& packet, const HifiSockAddr& senderSockAddr) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    
+    if (nodeList->packetVersionAndHashMatch(packet)) {
+        PacketType datagramPacketType = packetTypeForPacket(packet);
+        PacketMetrics::ProcessingTimer processingTimer(nodeList->getPacketMetrics(), datagramPacketType);
+        
+        if (datagramPacketType == PacketTypeJurisdiction) {
+            int headerBytes = numBytesForPacketHeader(packet);
             
-            if (datagramPacketType == PacketTypeJurisdiction) {
-                int headerBytes = numBytesForPacketHeader(receivedPacket);
-                
-                SharedNodePointer matchedNode = nodeList->sendingNodeForPacket(receivedPacket);
-                
-                if (matchedNode) {
-                    // PacketType_JURISDICTION, first byte is the node type...
-                    switch (receivedPacket[headerBytes]) {
-                        case NodeType::EntityServer:
-                            _scriptEngine.getEntityScriptingInterface()->getJurisdictionListener()->
-                                                                queueReceivedPacket(matchedNode, receivedPacket);
-                            break;
-                    }
+            SharedNodePointer matchedNode = nodeList->sendingNodeForPacket(packet);
+            
+            if (matchedNode) {
+                // PacketType_JURISDICTION, first byte is the node type...
+                switch (packet[headerBytes]) {
+                    case NodeType::EntityServer:
+                        _scriptEngine.getEntityScriptingInterface()->getJurisdictionListener()->
+                                                            queueReceivedPacket(matchedNode, packet);
+                        break;
                 }
-                
-            } else if (datagramPacketType == PacketTypeEntityAddResponse) {
-                // this will keep creatorTokenIDs to IDs mapped correctly
-                EntityItemID::handleAddEntityResponse(receivedPacket);
-                
-                // also give our local entity tree a chance to remap any internal locally created entities
-                _entityViewer.getTree()->handleAddEntityResponse(receivedPacket);
-
-                // Make sure our Node and NodeList knows we've heard from this node.
-                SharedNodePointer sourceNode = nodeList->sendingNodeForPacket(receivedPacket);
-                sourceNode->setLastHeardMicrostamp(usecTimestampNow());
-
-            } else if (datagramPacketType == PacketTypeOctreeStats
-                        || datagramPacketType == PacketTypeEntityData
-                        || datagramPacketType == PacketTypeEntityErase
-            ) {
-                // Make sure our Node and NodeList knows we've heard from this node.
-                SharedNodePointer sourceNode = nodeList->sendingNodeForPacket(receivedPacket);
-                sourceNode->setLastHeardMicrostamp(usecTimestampNow());
-
-                QByteArray mutablePacket = receivedPacket;
-                int messageLength = mutablePacket.size();
-
-                if (datagramPacketType == PacketTypeOctreeStats) {
-
-                    int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(mutablePacket, sourceNode);
-                    if (messageLength > statsMessageLength) {
-                        mutablePacket = mutablePacket.mid(statsMessageLength);
-                        
-                        // TODO: this needs to be fixed, the goal is to test the packet version for the piggyback, but
-                        //       this is testing the version and hash of the original packet
-                        //       need to use numBytesArithmeticCodingFromBuffer()...
-                        if (!DependencyManager::get<NodeList>()->packetVersionAndHashMatch(receivedPacket)) {
-                            return; // bail since piggyback data doesn't match our versioning
-                        }
-                    } else {
-                        return; // bail since no piggyback data
-                    }
+            }
+            
+        } else if (datagramPacketType == PacketTypeEntityAddResponse) {
+            // this will keep creatorTokenIDs to IDs mapped correctly
+            EntityItemID::handleAddEntityResponse(packet);
+            
+            // also give our local entity tree a chance to remap any internal locally created entities
+            _entityViewer.getTree()->handleAddEntityResponse(packet);
+
+            // Make sure our Node and NodeList knows we've heard from this node.
+            SharedNodePointer sourceNode = nodeList->sendingNodeForPacket(packet);
+            sourceNode->setLastHeardMicrostamp(usecTimestampNow());
+
+        } else if (datagramPacketType == PacketTypeOctreeStats
+                    || datagramPacketType == PacketTypeEntityData
+                    || datagramPacketType == PacketTypeEntityErase
+        ) {
+            // Make sure our Node and NodeList knows we've heard from this node.
+            SharedNodePointer sourceNode = nodeList->sendingNodeForPacket(packet);
+            sourceNode->setLastHeardMicrostamp(usecTimestampNow());
 
-                    datagramPacketType = packetTypeForPacket(mutablePacket);
-                } // fall through to piggyback message
+            QByteArray mutablePacket = packet;
+            int messageLength = mutablePacket.size();
 
-                if (datagramPacketType == PacketTypeEntityData || datagramPacketType == PacketTypeEntityErase) {
-                    _entityViewer.processDatagram(mutablePacket, sourceNode);
+            if (datagramPacketType == PacketTypeOctreeStats) {
+
+                int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(mutablePacket, sourceNode);
+                if (messageLength > statsMessageLength) {
+                    mutablePacket = mutablePacket.mid(statsMessageLength);
+                    
+                    // TODO: this needs to be fixed, the goal is to test the packet version for the piggyback, but
+                    //       this is testing the version and hash of the original packet
+                    //       need to use numBytesArithmeticCodingFromBuffer()...
+                    if (!DependencyManager::get<NodeList>()->packetVersionAndHashMatch(packet)) {
+                        return; // bail since piggyback data doesn't match our versioning
+                    }
+                } else {
+                    return; // bail since no piggyback data
                 }
-                
-            } else if (datagramPacketType == PacketTypeMixedAudio || datagramPacketType == PacketTypeSilentAudioFrame) {
-
-                _receivedAudioStream.parseData(receivedPacket);
-
-                _lastReceivedAudioLoudness = _receivedAudioStream.getNextOutputFrameLoudness();
-
-                _receivedAudioStream.clearBuffer();
-                
-                // let this continue through to the NodeList so it updates last heard timestamp
-                // for the sending audio mixer
-                DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, receivedPacket);
-            } else if (datagramPacketType == PacketTypeBulkAvatarData
-                       || datagramPacketType == PacketTypeAvatarIdentity
-                       || datagramPacketType == PacketTypeAvatarBillboard
-                       || datagramPacketType == PacketTypeKillAvatar) {
-                // let the avatar hash map process it
-                DependencyManager::get<AvatarHashMap>()->processAvatarMixerDatagram(receivedPacket, nodeList->sendingNodeForPacket(receivedPacket));
-                
-                // let this continue through to the NodeList so it updates last heard timestamp
-                // for the sending avatar-mixer
-                DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, receivedPacket);
-            } else {
-                DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, receivedPacket);
+
+                datagramPacketType = packetTypeForPacket(mutablePacket);
+            } // fall through to piggyback message
+
+            if (datagramPacketType == PacketTypeEntityData || datagramPacketType == PacketTypeEntityErase) {
+                _entityViewer.processDatagram(mutablePacket, sourceNode);
             }
+            
+        } else if (datagramPacketType == PacketTypeMixedAudio || datagramPacketType == PacketTypeSilentAudioFrame) {
+
+            _receivedAudioStream.parseData(packet);
+
+            _lastReceivedAudioLoudness = _receivedAudioStream.getNextOutputFrameLoudness();
+
+            _receivedAudioStream.clearBuffer();
+            
+            // let this continue through to the NodeList so it updates last heard timestamp
+            // for the sending audio mixer
+            DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, packet);
+        } else if (datagramPacketType == PacketTypeBulkAvatarData
+                   || datagramPacketType == PacketTypeAvatarIdentity
+                   || datagramPacketType == PacketTypeAvatarBillboard
+                   || datagramPacketType == PacketTypeKillAvatar) {
+            // let the avatar hash map process it
+            DependencyManager::get<AvatarHashMap>()->processAvatarMixerDatagram(packet, nodeList->sendingNodeForPacket(packet));
+            
+            // let this continue through to the NodeList so it updates last heard timestamp
+            // for the sending avatar-mixer
+            DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, packet);
+        } else {
+            DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, packet);
         }
     }
 }
 
 const QString AGENT_LOGGING_NAME = "agent";
 
+static QString downloadScript(const QUrl& scriptURL) {
+    QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
+    QNetworkRequest networkRequest = QNetworkRequest(scriptURL);
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
+    QNetworkReply* reply = networkAccessManager.get(networkRequest);
+    
+    qDebug() << "Downloading script at" << scriptURL.toString();
+    
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    
+    loop.exec();
+    
+    QString scriptContents(reply->readAll());
+    delete reply;
+    
+    qDebug() << "Downloaded script:" << scriptContents;
+    
+    return scriptContents;
+}
+
 void Agent::run() {
     ThreadedAssignment::commonInit(AGENT_LOGGING_NAME, NodeType::Agent);
     
@@ -158,38 +203,25 @@ void Agent::run() {
                                                  << NodeType::EntityServer
                                                 );
     
-    // figure out the URL for the script for this agent assignment
-    QUrl scriptURL;
+    // figure out the URLs for the scripts for this agent assignment: the payload may list several, separated by
+    // whitespace, which all run in this process on the one node
+    QList<QUrl> scriptURLs;
     if (_payload.isEmpty())  {
-        scriptURL = QUrl(QString("http://%1:%2/assignment/%3")
+        scriptURLs.append(QUrl(QString("http://%1:%2/assignment/%3")
             .arg(DependencyManager::get<NodeList>()->getDomainHandler().getIP().toString())
             .arg(DOMAIN_SERVER_HTTP_PORT)
-            .arg(uuidStringWithoutCurlyBraces(_uuid)));
+            .arg(uuidStringWithoutCurlyBraces(_uuid))));
     } else {
-        scriptURL = QUrl(_payload);
+        foreach (const QString& url, QString(_payload).split(QRegExp("\\s+"), QString::SkipEmptyParts)) {
+            scriptURLs.append(QUrl(url));
+        }
     }
-   
-    QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
-    QNetworkRequest networkRequest = QNetworkRequest(scriptURL);
-    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
-    QNetworkReply* reply = networkAccessManager.get(networkRequest);
     
-    QNetworkDiskCache* cache = new QNetworkDiskCache();
     QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    cache->setCacheDirectory(!cachePath.isEmpty() ? cachePath : "agentCache");
-    networkAccessManager.setCache(cache);
+    NetworkAccessManager::setDiskCache(!cachePath.isEmpty() ? cachePath : "agentCache");
     
-    qDebug() << "Downloading script at" << scriptURL.toString();
-    
-    QEventLoop loop;
-    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
-    
-    loop.exec();
-    
-    QString scriptContents(reply->readAll());
-    delete reply;
-    
-    qDebug() << "Downloaded script:" << scriptContents;
+    QUrl firstScriptURL = scriptURLs.takeFirst();
+    QString scriptContents = downloadScript(firstScriptURL);
     
     // setup an Avatar for the script to use
     ScriptableAvatar scriptedAvatar(&_scriptEngine);
@@ -215,12 +247,43 @@ void Agent::run() {
     _entityViewer.init();
     _scriptEngine.getEntityScriptingInterface()->setEntityTree(_entityViewer.getTree());
 
-    _scriptEngine.setScriptContents(scriptContents);
-    _scriptEngine.run();
+    _scriptEngine.setScriptContents(scriptContents, firstScriptURL.toString());
+    
+    // the first script drives the node's avatar; the rest share its caches and socket, read its entity tree in place
+    // through regions of their own that it folds into its query, and get a frame in turn
+    QList<ScriptEngine*> scriptEngines;
+    scriptEngines.append(&_scriptEngine);
+    foreach (const QUrl& scriptURL, scriptURLs) {
+        ScriptEngine* scriptEngine = new ScriptEngine(downloadScript(scriptURL), scriptURL.toString());
+        scriptEngine->setParent(this);
+        scriptEngine->setAvatarHashMap(DependencyManager::get<AvatarHashMap>().data(), "AvatarList");
+        scriptEngine->init();
+        scriptEngine->registerGlobalObject("SoundCache", &SoundCache::getInstance());
+        scriptEngine->registerGlobalObject("EntityViewer", _entityViewer.addInterestRegion());
+        _hostedScriptEngines.append(scriptEngine);
+        scriptEngines.append(scriptEngine);
+    }
+    
+    ScriptEngine::runTogether(scriptEngines);
     setFinished(true);
 }
 
+void Agent::sendStatsPacket() {
+    // the profiles of our scripts' callbacks, by script
+    QJsonObject scriptsObject;
+    scriptsObject[_scriptEngine.getFileName()] = _scriptEngine.getProfile().toJson();
+    foreach (ScriptEngine* scriptEngine, _hostedScriptEngines) {
+        scriptsObject[scriptEngine->getFileName()] = scriptEngine->getProfile().toJson();
+    }
+    QJsonObject statsObject;
+    statsObject["scripts"] = scriptsObject;
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+}
+
 void Agent::aboutToFinish() {
     _scriptEngine.stop();
+    foreach (ScriptEngine* scriptEngine, _hostedScriptEngines) {
+        scriptEngine->stop();
+    }
     NetworkAccessManager::getInstance().clearAccessCache();
 }
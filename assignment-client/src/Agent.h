@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <QtScript/QScriptEngine>
+#include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 
@@ -54,9 +55,16 @@ public slots:
     void run();
     void readPendingDatagrams();
     void playAvatarSound(Sound* avatarSound) { _scriptEngine.setAvatarSound(avatarSound); }
+    void sendStatsPacket();
+
+protected:
+    virtual void updateQueueDepths(PacketMetrics& metrics);
 
 private:
+    void processDatagram(const QByteArray& packet, const HifiSockAddr& senderSockAddr);
+    
     ScriptEngine _scriptEngine;
+    QList<ScriptEngine*> _hostedScriptEngines; ///< the scripts after the first, when the payload lists several
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
     
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QLocalSocket>
 #include <QProcess>
 #include <QSettings>
 #include <QSharedMemory>
@@ -28,6 +29,7 @@
 #include <ShutdownEventListener.h>
 #include <SoundCache.h>
 
+#include "AssignmentClientMonitor.h"
 #include "AssignmentFactory.h"
 #include "AssignmentThread.h"
 
@@ -42,8 +44,11 @@ int hifiSockAddrMeta = qRegisterMetaType<HifiSockAddr>("HifiSockAddr");
 
 AssignmentClient::AssignmentClient(int &argc, char **argv) :
     QCoreApplication(argc, argv),
+    _isPinned(false),
     _assignmentServerHostname(DEFAULT_ASSIGNMENT_SERVER_HOSTNAME),
-    _localASPortSharedMem(NULL)
+    _localASPortSharedMem(NULL),
+    _monitorSocket(NULL),
+    _isSpare(false)
 {
     LogUtils::init();
 
@@ -69,6 +74,7 @@ AssignmentClient::AssignmentClient(int &argc, char **argv) :
     LogHandler::getInstance().setTargetName(ASSIGNMENT_CLIENT_TARGET_NAME);
 
     const QVariantMap argumentVariantMap = HifiConfigVariantMap::mergeCLParametersWithJSONConfig(arguments());
+    _schedulingOptions = argumentVariantMap;
 
     const QString ASSIGNMENT_TYPE_OVERRIDE_OPTION = "t";
     const QString ASSIGNMENT_POOL_OPTION = "pool";
@@ -137,10 +143,62 @@ AssignmentClient::AssignmentClient(int &argc, char **argv) :
     // Create Singleton objects on main thread
     NetworkAccessManager::getInstance();
     SoundCache::getInstance();
+    
+    // if we were started by a monitor, tell it what we're up to, and if we're a spare wait for it to say when to start
+    if (argumentVariantMap.contains(MONITOR_SERVER_NAME_OPTION)) {
+        _isSpare = argumentVariantMap.contains(MONITOR_SPARE_OPTION);
+        
+        _monitorSocket = new QLocalSocket(this);
+        connect(_monitorSocket, &QLocalSocket::readyRead, this, &AssignmentClient::readMonitorMessages);
+        _monitorSocket->connectToServer(argumentVariantMap.value(MONITOR_SERVER_NAME_OPTION).toString());
+        
+        const int MONITOR_CONNECT_TIMEOUT_MSECS = 1000;
+        if (!_monitorSocket->waitForConnected(MONITOR_CONNECT_TIMEOUT_MSECS)) {
+            // without the monitor nobody can release us, so don't wait for it
+            qWarning() << "Could not connect to the monitor -" << _monitorSocket->errorString();
+            _isSpare = false;
+        }
+        
+        sendMonitorMessage(CHILD_READY_MESSAGE + " " + argumentVariantMap.value(MONITOR_CHILD_ID_OPTION).toByteArray());
+        
+        if (_isSpare) {
+            qDebug() << "Started as a spare - waiting for the monitor before asking for an assignment.";
+        }
+    }
+}
+
+void AssignmentClient::sendMonitorMessage(const QByteArray& message) {
+    if (_monitorSocket) {
+        _monitorSocket->write(message + "\n");
+        _monitorSocket->flush();
+    }
+}
+
+void AssignmentClient::readMonitorMessages() {
+    while (_monitorSocket->canReadLine()) {
+        QList<QByteArray> message = _monitorSocket->readLine().trimmed().split(' ');
+        
+        if (message.first() == CHILD_REQUEST_MESSAGE && message.size() > 1 && _isSpare) {
+            _isSpare = false;
+            
+            // take the place of the child that died by asking for what it had, then go back to our own request
+            Assignment::Type pinnedType = (Assignment::Type) message.at(1).toInt();
+            if (pinnedType != Assignment::AllTypes && pinnedType != _requestAssignment.getType()) {
+                _unpinnedRequestAssignment = _requestAssignment;
+                _requestAssignment = Assignment(Assignment::RequestCommand, pinnedType,
+                                                _unpinnedRequestAssignment.getPool());
+                _requestAssignment.setWalletUUID(_unpinnedRequestAssignment.getWalletUUID());
+                _isPinned = true;
+            }
+            
+            qDebug() << "Released by the monitor - asking for assignment -" << _requestAssignment;
+            sendAssignmentRequest();
+        }
+    }
 }
 
 void AssignmentClient::sendAssignmentRequest() {
-    if (!_currentAssignment) {
+    if (!_currentAssignment && !_isSpare) {
         
         auto nodeList = DependencyManager::get<NodeList>();
         
@@ -196,6 +254,9 @@ void AssignmentClient::readPendingDatagrams() {
 
                 if (_currentAssignment) {
                     qDebug() << "Received an assignment -" << *_currentAssignment;
+                    
+                    sendMonitorMessage(CHILD_ASSIGNED_MESSAGE + " "
+                                       + QByteArray::number(_currentAssignment->getType()));
 
                     // switch our DomainHandler hostname and port to whoever sent us the assignment
 
@@ -205,7 +266,8 @@ void AssignmentClient::readPendingDatagrams() {
                     qDebug() << "Destination IP for assignment is" << nodeList->getDomainHandler().getIP().toString();
 
                     // start the deployed assignment
-                    AssignmentThread* workerThread = new AssignmentThread(_currentAssignment, this);
+                    AssignmentScheduling scheduling(_schedulingOptions, _currentAssignment->getTypeName());
+                    AssignmentThread* workerThread = new AssignmentThread(_currentAssignment, scheduling, this);
 
                     connect(workerThread, &QThread::started, _currentAssignment.data(), &ThreadedAssignment::run);
                     connect(_currentAssignment.data(), &ThreadedAssignment::finished, workerThread, &QThread::quit);
@@ -280,4 +342,12 @@ void AssignmentClient::assignmentCompleted() {
     nodeList->setOwnerType(NodeType::Unassigned);
     nodeList->reset();
     nodeList->resetNodeInterestSet();
+    
+    // a pinned request was only for the assignment we took over
+    if (_isPinned) {
+        _requestAssignment = _unpinnedRequestAssignment;
+        _isPinned = false;
+    }
+    
+    sendMonitorMessage(CHILD_IDLE_MESSAGE);
 }
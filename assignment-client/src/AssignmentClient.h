@@ -13,9 +13,11 @@
 #define hifi_AssignmentClient_h
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QVariantMap>
 
 #include "ThreadedAssignment.h"
 
+class QLocalSocket;
 class QSharedMemory;
 
 class AssignmentClient : public QCoreApplication {
@@ -29,13 +31,21 @@ private slots:
     void readPendingDatagrams();
     void assignmentCompleted();
     void handleAuthenticationRequest();
+    void readMonitorMessages();
 
 private:
+    void sendMonitorMessage(const QByteArray& message);
+    
     Assignment _requestAssignment;
+    Assignment _unpinnedRequestAssignment;
+    bool _isPinned;
     static SharedAssignmentPointer _currentAssignment;
     QString _assignmentServerHostname;
     HifiSockAddr _assignmentServerSocket;
     QSharedMemory* _localASPortSharedMem;
+    QLocalSocket* _monitorSocket;
+    bool _isSpare;
+    QVariantMap _schedulingOptions; ///< our options, which those for the assignment's scheduling are read from
 };
 
 #endif // hifi_AssignmentClient_h
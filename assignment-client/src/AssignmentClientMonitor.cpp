@@ -17,11 +17,25 @@
 #include "AssignmentClientMonitor.h"
 
 const char* NUM_FORKS_PARAMETER = "-n";
+const char* NUM_SPARES_PARAMETER = "--spares";
+
+const QString MONITOR_SERVER_NAME_OPTION = "monitor";
+const QString MONITOR_CHILD_ID_OPTION = "monitor-child-id";
+const QString MONITOR_SPARE_OPTION = "spare";
+
+const QByteArray CHILD_READY_MESSAGE = "ready";
+const QByteArray CHILD_ASSIGNED_MESSAGE = "assigned";
+const QByteArray CHILD_IDLE_MESSAGE = "idle";
+const QByteArray CHILD_REQUEST_MESSAGE = "request";
 
 const QString ASSIGNMENT_CLIENT_MONITOR_TARGET_NAME = "assignment-client-monitor";
 
-AssignmentClientMonitor::AssignmentClientMonitor(int &argc, char **argv, int numAssignmentClientForks) :
-    QCoreApplication(argc, argv)
+AssignmentClientMonitor::AssignmentClientMonitor(int &argc, char **argv, int numAssignmentClientForks,
+                                                 int numSpareClients) :
+    QCoreApplication(argc, argv),
+    _children(),
+    _nextChildID(0),
+    _childServer(this)
 {    
     // start the Logging class with the parent's target name
     LogHandler::getInstance().setTargetName(ASSIGNMENT_CLIENT_MONITOR_TARGET_NAME);
@@ -42,10 +56,39 @@ AssignmentClientMonitor::AssignmentClientMonitor(int &argc, char **argv, int num
     _childArguments.removeAt(forksParameterIndex);
     _childArguments.removeAt(forksParameterIndex);
     
+    // and the same for the number of spares, if it was given
+    int sparesParameterIndex = _childArguments.indexOf(NUM_SPARES_PARAMETER);
+    if (sparesParameterIndex != -1) {
+        _childArguments.removeAt(sparesParameterIndex);
+        _childArguments.removeAt(sparesParameterIndex);
+    }
+    
+    // and the log file, which each child gets one of its own beside
+    int logFileParameterIndex = _childArguments.indexOf(LOG_FILE_PARAMETER);
+    if (logFileParameterIndex != -1 && logFileParameterIndex + 1 < _childArguments.size()) {
+        _childArguments.removeAt(logFileParameterIndex);
+        _childLogFileName = _childArguments.takeAt(logFileParameterIndex);
+    }
+    
+    // the children connect back to us to say what they're doing, and so the spares can be told when to start asking
+    QString serverName = QString("%1-%2").arg(ASSIGNMENT_CLIENT_MONITOR_TARGET_NAME).arg(applicationPid());
+    QLocalServer::removeServer(serverName);
+    if (_childServer.listen(serverName)) {
+        connect(&_childServer, &QLocalServer::newConnection, this, &AssignmentClientMonitor::newChildConnection);
+        _childArguments << "--" + MONITOR_SERVER_NAME_OPTION << _childServer.fullServerName();
+    } else {
+        qWarning() << "Monitor could not listen for its children -" << _childServer.errorString()
+            << "- running without spares.";
+        numSpareClients = 0;
+    }
+    
     // use QProcess to fork off a process for each of the child assignment clients
     for (int i = 0; i < numAssignmentClientForks; i++) {
         spawnChildClient();
     }
+    for (int i = 0; i < numSpareClients; i++) {
+        spawnChildClient(true);
+    }
 }
 
 AssignmentClientMonitor::~AssignmentClientMonitor() {
@@ -54,45 +97,126 @@ AssignmentClientMonitor::~AssignmentClientMonitor() {
 
 void AssignmentClientMonitor::stopChildProcesses() {
     
-    QList<QPointer<QProcess> >::Iterator it = _childProcesses.begin();
-    while (it != _childProcesses.end()) {
-        if (!it->isNull()) {
-            qDebug() << "Monitor is terminating child process" << it->data();
+    QHash<int, ChildClient>::iterator it = _children.begin();
+    while (it != _children.end()) {
+        QPointer<QProcess> process = it.value().process;
+        if (!process.isNull()) {
+            qDebug() << "Monitor is terminating child process" << process.data();
             
             // don't re-spawn this child when it goes down
-            disconnect(it->data(), 0, this, 0);
+            disconnect(process.data(), 0, this, 0);
             
-            it->data()->terminate();
-            it->data()->waitForFinished();
+            process->terminate();
+            process->waitForFinished();
         }
         
-        it = _childProcesses.erase(it);
+        it = _children.erase(it);
     }
 }
 
-void AssignmentClientMonitor::spawnChildClient() {
+void AssignmentClientMonitor::spawnChildClient(bool isSpare) {
     QProcess *assignmentClient = new QProcess(this);
     
-    _childProcesses.append(QPointer<QProcess>(assignmentClient));
+    int childID = _nextChildID++;
+    assignmentClient->setProperty(qPrintable(MONITOR_CHILD_ID_OPTION), childID);
+    
+    ChildClient child = { QPointer<QProcess>(assignmentClient), NULL, isSpare, Assignment::AllTypes };
+    _children.insert(childID, child);
     
     // make sure that the output from the child process appears in our output
     assignmentClient->setProcessChannelMode(QProcess::ForwardedChannels);
     
-    assignmentClient->start(applicationFilePath(), _childArguments);
+    QStringList arguments = _childArguments;
+    if (!_childLogFileName.isEmpty()) {
+        arguments << LOG_FILE_PARAMETER << QString("%1-child%2").arg(_childLogFileName).arg(childID);
+    }
+    if (_childServer.isListening()) {
+        arguments << "--" + MONITOR_CHILD_ID_OPTION << QString::number(childID);
+        if (isSpare) {
+            arguments << "--" + MONITOR_SPARE_OPTION;
+        }
+    }
+    assignmentClient->start(applicationFilePath(), arguments);
     
     // link the child processes' finished slot to our childProcessFinished slot
     connect(assignmentClient, SIGNAL(finished(int, QProcess::ExitStatus)), this,
             SLOT(childProcessFinished(int, QProcess::ExitStatus)));
     
-    qDebug() << "Spawned a child client with PID" << assignmentClient->pid();
+    qDebug() << "Spawned a" << (isSpare ? "spare" : "child") << "client with PID" << assignmentClient->pid();
+}
+
+bool AssignmentClientMonitor::releaseSpareClient(Assignment::Type pinnedType) {
+    for (QHash<int, ChildClient>::iterator it = _children.begin(); it != _children.end(); ++it) {
+        ChildClient& child = it.value();
+        
+        // only a spare that has said it's ready can be told to start
+        if (child.isSpare && child.socket && child.socket->state() == QLocalSocket::ConnectedState) {
+            child.isSpare = false;
+            child.socket->write(CHILD_REQUEST_MESSAGE + " " + QByteArray::number(pinnedType) + "\n");
+            
+            qDebug() << "Released spare client" << child.process.data() << "to ask for assignment type" << pinnedType;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AssignmentClientMonitor::newChildConnection() {
+    while (_childServer.hasPendingConnections()) {
+        QLocalSocket* socket = _childServer.nextPendingConnection();
+        connect(socket, &QLocalSocket::readyRead, this, &AssignmentClientMonitor::readChildMessages);
+        connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    }
+}
+
+void AssignmentClientMonitor::readChildMessages() {
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    
+    while (socket->canReadLine()) {
+        QList<QByteArray> message = socket->readLine().trimmed().split(' ');
+        
+        if (message.first() == CHILD_READY_MESSAGE && message.size() > 1) {
+            // this tells us which of our children is on the other end
+            int childID = message.at(1).toInt();
+            if (_children.contains(childID)) {
+                _children[childID].socket = socket;
+                socket->setProperty(qPrintable(MONITOR_CHILD_ID_OPTION), childID);
+            }
+            continue;
+        }
+        
+        QVariant childID = socket->property(qPrintable(MONITOR_CHILD_ID_OPTION));
+        if (!childID.isValid() || !_children.contains(childID.toInt())) {
+            continue;
+        }
+        ChildClient& child = _children[childID.toInt()];
+        
+        if (message.first() == CHILD_ASSIGNED_MESSAGE && message.size() > 1) {
+            child.assignmentType = (Assignment::Type) message.at(1).toInt();
+            
+        } else if (message.first() == CHILD_IDLE_MESSAGE) {
+            child.assignmentType = Assignment::AllTypes;
+        }
+    }
 }
 
 void AssignmentClientMonitor::childProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
     qDebug("Replacing dead child assignment client with a new one");
     
-    // remove the old process from our list of child processes
-    qDebug() << "need to remove" << QPointer<QProcess>(qobject_cast<QProcess*>(sender()));
-    _childProcesses.removeOne(QPointer<QProcess>(qobject_cast<QProcess*>(sender())));
+    // remove the old process from our children
+    QProcess* deadProcess = qobject_cast<QProcess*>(sender());
+    qDebug() << "need to remove" << deadProcess;
+    ChildClient deadChild = _children.take(deadProcess->property(qPrintable(MONITOR_CHILD_ID_OPTION)).toInt());
+    deadProcess->deleteLater();
     
-    spawnChildClient();
+    if (deadChild.isSpare) {
+        spawnChildClient(true);
+        
+    } else if (releaseSpareClient(deadChild.assignmentType)) {
+        // a spare has taken its place, pinned to whatever it was doing, so the new process becomes the spare
+        spawnChildClient(true);
+        
+    } else {
+        spawnChildClient();
+    }
 }
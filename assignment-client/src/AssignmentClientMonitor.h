@@ -15,25 +15,58 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/qpointer.h>
 #include <QtCore/QProcess>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
 
 #include <Assignment.h>
 
 extern const char* NUM_FORKS_PARAMETER;
+extern const char* NUM_SPARES_PARAMETER;
 
+// the options the monitor starts its children with, so they can report to it
+extern const QString MONITOR_SERVER_NAME_OPTION;
+extern const QString MONITOR_CHILD_ID_OPTION;
+extern const QString MONITOR_SPARE_OPTION;
+
+// the lines the monitor and its children send each other
+extern const QByteArray CHILD_READY_MESSAGE;
+extern const QByteArray CHILD_ASSIGNED_MESSAGE;
+extern const QByteArray CHILD_IDLE_MESSAGE;
+extern const QByteArray CHILD_REQUEST_MESSAGE;
+
+/// Keeps a number of assignment clients running, along with spares that have started up and found the assignment
+/// server but don't ask for assignments.  When a working child dies, a spare is told to ask right away for the type
+/// of assignment the dead one had, so that it picks up the requeued assignment without the startup of a new process,
+/// and a new spare starts in its place.
 class AssignmentClientMonitor : public QCoreApplication {
     Q_OBJECT
 public:
-    AssignmentClientMonitor(int &argc, char **argv, int numAssignmentClientForks);
+    AssignmentClientMonitor(int &argc, char **argv, int numAssignmentClientForks, int numSpareClients);
     ~AssignmentClientMonitor();
     
     void stopChildProcesses();
 private slots:
     void childProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void newChildConnection();
+    void readChildMessages();
 private:
-    void spawnChildClient();
-    QList<QPointer<QProcess> > _childProcesses;
+    class ChildClient {
+    public:
+        QPointer<QProcess> process;
+        QLocalSocket* socket;
+        bool isSpare;
+        Assignment::Type assignmentType; ///< the type it's working on, or AllTypes while it waits for one
+    };
+    
+    void spawnChildClient(bool isSpare = false);
+    bool releaseSpareClient(Assignment::Type pinnedType);
+    
+    QHash<int, ChildClient> _children;
+    int _nextChildID;
     
     QStringList _childArguments;
+    QString _childLogFileName;
+    QLocalServer _childServer;
 };
 
 #endif // hifi_AssignmentClientMonitor_h
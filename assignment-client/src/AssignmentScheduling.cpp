@@ -0,0 +1,153 @@
+//
+//  AssignmentScheduling.cpp
+//  assignment-client/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#endif
+
+#include "AssignmentScheduling.h"
+
+const QString CPUS_OPTION_SUFFIX = "-cpus";
+const QString NUMA_NODE_OPTION_SUFFIX = "-numa-node";
+const QString REALTIME_PRIORITY_OPTION_SUFFIX = "-realtime-priority";
+
+const int MIN_REALTIME_PRIORITY = 1;
+const int MAX_REALTIME_PRIORITY = 99;
+
+// parses a list of CPUs as the kernel writes them, like 0-3,8,10-11
+static QList<int> parseCPUList(const QString& cpuList) {
+    QList<int> cpus;
+    foreach (const QString& range, cpuList.trimmed().split(',', QString::SkipEmptyParts)) {
+        QStringList bounds = range.trimmed().split('-');
+        bool firstOK = false, lastOK = false;
+        int first = bounds.first().toInt(&firstOK);
+        int last = bounds.last().toInt(&lastOK);
+        if (!firstOK || !lastOK || bounds.size() > 2 || first < 0 || last < first) {
+            qDebug() << "Ignoring CPU range" << range << "that couldn't be parsed.";
+            continue;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.append(cpu);
+        }
+    }
+    return cpus;
+}
+
+AssignmentScheduling::AssignmentScheduling() :
+    numaNode(-1),
+    realtimePriority(0)
+{
+
+}
+
+AssignmentScheduling::AssignmentScheduling(const QVariantMap& options, const QString& typeName) :
+    numaNode(-1),
+    realtimePriority(0)
+{
+    if (options.contains(typeName + CPUS_OPTION_SUFFIX)) {
+        cpus = parseCPUList(options.value(typeName + CPUS_OPTION_SUFFIX).toString());
+    }
+    if (options.contains(typeName + NUMA_NODE_OPTION_SUFFIX)) {
+        numaNode = options.value(typeName + NUMA_NODE_OPTION_SUFFIX).toString().toInt();
+    }
+    if (options.contains(typeName + REALTIME_PRIORITY_OPTION_SUFFIX)) {
+        realtimePriority = qBound(MIN_REALTIME_PRIORITY,
+            options.value(typeName + REALTIME_PRIORITY_OPTION_SUFFIX).toString().toInt(), MAX_REALTIME_PRIORITY);
+    }
+}
+
+void AssignmentScheduling::applyToCurrentThread() const {
+    QList<int> threadCPUs = cpus;
+    if (numaNode >= 0) {
+#ifdef Q_OS_LINUX
+        // there's no need for libnuma: the kernel gives a thread memory from the node it first touches it on, so
+        // keeping the thread on the node's CPUs keeps its memory there too
+        QFile cpuListFile(QString("/sys/devices/system/node/node%1/cpulist").arg(numaNode));
+        if (cpuListFile.open(QIODevice::ReadOnly)) {
+            QList<int> nodeCPUs = parseCPUList(QString::fromLatin1(cpuListFile.readAll()));
+            if (threadCPUs.isEmpty()) {
+                threadCPUs = nodeCPUs;
+            } else {
+                // keep only those of the CPUs asked for that are on the node
+                foreach (int cpu, cpus) {
+                    if (!nodeCPUs.contains(cpu)) {
+                        threadCPUs.removeAll(cpu);
+                    }
+                }
+            }
+        } else {
+            qDebug() << "There's no NUMA node" << numaNode << "- leaving the assignment's CPUs as they were.";
+        }
+#else
+        qDebug() << "NUMA placement is only supported on Linux - leaving the assignment's CPUs as they were.";
+#endif
+    }
+
+    if (!threadCPUs.isEmpty()) {
+#if defined(Q_OS_LINUX)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        foreach (int cpu, threadCPUs) {
+            CPU_SET(cpu, &cpuSet);
+        }
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (error == 0) {
+            qDebug() << "Pinned the assignment to CPUs" << threadCPUs;
+        } else {
+            qDebug() << "Couldn't pin the assignment to CPUs" << threadCPUs << "-" << strerror(error);
+        }
+#elif defined(Q_OS_WIN)
+        DWORD_PTR mask = 0;
+        foreach (int cpu, threadCPUs) {
+            if (cpu < (int)sizeof(DWORD_PTR) * 8) {
+                mask |= (DWORD_PTR)1 << cpu;
+            }
+        }
+        if (SetThreadAffinityMask(GetCurrentThread(), mask) != 0) {
+            qDebug() << "Pinned the assignment to CPUs" << threadCPUs;
+        } else {
+            qDebug() << "Couldn't pin the assignment to CPUs" << threadCPUs << "- error" << GetLastError();
+        }
+#else
+        qDebug() << "Pinning to CPUs isn't supported on this platform - leaving the assignment's CPUs as they were.";
+#endif
+    }
+
+    if (realtimePriority > 0) {
+#ifdef Q_OS_WIN
+        // there's no count of priorities to pick from, just the one above all the others
+        if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+            qDebug() << "Running the assignment at time critical priority.";
+        } else {
+            qDebug() << "Couldn't run the assignment at time critical priority - error" << GetLastError();
+        }
+#else
+        sched_param schedulingParameters;
+        memset(&schedulingParameters, 0, sizeof(schedulingParameters));
+        schedulingParameters.sched_priority = realtimePriority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &schedulingParameters);
+        if (error == 0) {
+            qDebug() << "Running the assignment at real-time priority" << realtimePriority;
+        } else {
+            // most likely we don't have the privilege to (CAP_SYS_NICE, or an rtprio limit on Linux)
+            qDebug() << "Couldn't run the assignment at real-time priority" << realtimePriority
+                << "-" << strerror(error);
+        }
+#endif
+    }
+}
@@ -0,0 +1,40 @@
+//
+//  AssignmentScheduling.h
+//  assignment-client/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssignmentScheduling_h
+#define hifi_AssignmentScheduling_h
+
+#include <QtCore/QList>
+#include <QtCore/QVariantMap>
+
+/// How the thread that an assignment runs on is scheduled, from the assignment client's options for the assignment's
+/// type (so that a machine's mixers can be kept off the cores its octree servers and agents use):
+///
+///     --audio-mixer-cpus 2,3              pins the thread to the listed CPUs (ranges like 2-5 are fine too)
+///     --audio-mixer-numa-node 0           pins it to the CPUs of the NUMA node, which its memory then comes from
+///     --audio-mixer-realtime-priority 50  runs it at a real-time priority (SCHED_FIFO), 1 to 99
+///
+/// The threads that the assignment starts take on its CPUs and priority.
+class AssignmentScheduling {
+public:
+    AssignmentScheduling();
+    AssignmentScheduling(const QVariantMap& options, const QString& typeName);
+
+    bool isDefault() const { return cpus.isEmpty() && numaNode < 0 && realtimePriority <= 0; }
+
+    /// Applies the scheduling to the calling thread, saying so (or why it couldn't) in the log.
+    void applyToCurrentThread() const;
+
+    QList<int> cpus;
+    int numaNode;
+    int realtimePriority;
+};
+
+#endif // hifi_AssignmentScheduling_h
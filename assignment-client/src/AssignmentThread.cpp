@@ -11,9 +11,19 @@
 
 #include "AssignmentThread.h"
 
-AssignmentThread::AssignmentThread(const SharedAssignmentPointer& assignment, QObject* parent) :
+AssignmentThread::AssignmentThread(const SharedAssignmentPointer& assignment, const AssignmentScheduling& scheduling,
+                                   QObject* parent) :
     QThread(parent),
-    _assignment(assignment)
+    _assignment(assignment),
+    _scheduling(scheduling)
 {
     
 }
+
+void AssignmentThread::run() {
+    // the scheduling is for this thread, so it has to be applied from it
+    if (!_scheduling.isDefault()) {
+        _scheduling.applyToCurrentThread();
+    }
+    QThread::run();
+}
@@ -16,11 +16,17 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssignmentScheduling.h"
+
 class AssignmentThread : public QThread {
 public:
-    AssignmentThread(const SharedAssignmentPointer& assignment, QObject* parent);
+    AssignmentThread(const SharedAssignmentPointer& assignment, const AssignmentScheduling& scheduling,
+                     QObject* parent);
+protected:
+    virtual void run();
 private:
     SharedAssignmentPointer _assignment;
+    AssignmentScheduling _scheduling;
 };
 
 #endif // hifi_AssignmentThread_h
@@ -41,12 +41,15 @@
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
+#include <AudioMixKernel.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
 #include <Node.h>
 #include <OctreeConstants.h>
+#include <PacketBuffer.h>
 #include <PacketHeaders.h>
+#include <PerfStat.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
@@ -54,6 +57,7 @@
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AudioMixerDatagramProcessor.h"
+#include "AudioMixerWorker.h"
 #include "AvatarAudioStream.h"
 #include "InjectedAudioStream.h"
 
@@ -62,6 +66,7 @@
 const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
 const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
+const float DEFAULT_LISTENER_CLUSTER_ANGLE = 30.0f;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
@@ -88,12 +93,17 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
     _minAudibilityThreshold(LOUDNESS_TO_DISTANCE_RATIO / 2.0f),
     _performanceThrottlingRatio(0.0f),
     _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
+    _minAttenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
     _noiseMutingThreshold(DEFAULT_NOISE_MUTING_THRESHOLD),
-    _numStatFrames(0),
-    _sumListeners(0),
-    _sumMixes(0),
+    _framesStatID(_stats.registerCounter("frames")),
+    _listenersStatID(_stats.registerCounter("listeners")),
+    _listenerClustersStatID(_stats.registerCounter("listener_clusters")),
+    _mixesStatID(_stats.registerCounter("mixes")),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
+    _distantMixRadius(0.0f),
+    _listenerClusterRadius(0.0f),
+    _listenerClusterMinOrientationDot(cosf(glm::radians(DEFAULT_LISTENER_CLUSTER_ANGLE) / 2.0f)),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -101,55 +111,309 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
 {
     // constant defined in AudioMixer.h.  However, we don't want to include this here
     // we will soon find a better common home for these audio-related constants
+    
+    // until we have domain-server settings we mix on the AudioMixer thread only
+    setupMixWorkers(1);
+}
+
+AudioMixer::~AudioMixer() {
+    _mixThreadPool.waitForDone();
+    qDeleteAll(_mixWorkers);
+}
+
+void AudioMixer::setupMixWorkers(int numMixThreads) {
+    _mixThreadPool.waitForDone();
+    
+    qDeleteAll(_mixWorkers);
+    _mixWorkers.clear();
+    
+    for (int i = 0; i < numMixThreads; ++i) {
+        _mixWorkers.append(new AudioMixerWorker(this));
+    }
+    
+    // the AudioMixer thread runs the first worker itself, so the pool only needs threads for the rest
+    _mixThreadPool.setMaxThreadCount(qMax(numMixThreads - 1, 1));
+    
+    // keep the pool threads around between frames instead of respawning them
+    _mixThreadPool.setExpiryTimeout(-1);
+}
+
+void AudioMixer::setupReceiveShards(int numReceiveThreads) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    
+    // the datagram processing thread setup in run() reads the node socket itself
+    for (int i = _receiveShardThreads.size() + 1; i < numReceiveThreads; i++) {
+        QUdpSocket* shardSocket = nodeList->createReceiveShardSocket();
+        if (!shardSocket) {
+            qDebug() << "Could not share the node socket's port, receiving with" << i << "thread(s)";
+            return;
+        }
+        QThread* shardThread = new QThread(this);
+        shardThread->setObjectName("Datagram Processor Thread " + QString::number(i));
+        
+        // the processor owns its socket, which moves to the thread along with it
+        AudioMixerDatagramProcessor* datagramProcessor = new AudioMixerDatagramProcessor(*shardSocket, NULL);
+        shardSocket->setParent(datagramProcessor);
+        datagramProcessor->moveToThread(shardThread);
+        
+        connect(shardSocket, &QUdpSocket::readyRead, datagramProcessor,
+                &AudioMixerDatagramProcessor::readPendingDatagrams);
+        
+        // the packets are still processed on our thread, where the mix reads the streams they feed
+        connect(datagramProcessor, &AudioMixerDatagramProcessor::packetRequiresProcessing,
+                this, &AudioMixer::readPendingDatagram);
+        
+        connect(shardThread, &QThread::finished, datagramProcessor, &QObject::deleteLater);
+        connect(datagramProcessor, &QObject::destroyed, shardThread, &QThread::deleteLater);
+        
+        shardThread->start();
+        _receiveShardThreads.append(shardThread);
+    }
 }
 
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
+
+// each listener in a cluster hears the others' streams individually, so the cost per cluster grows with its square
+const int MAX_LISTENERS_PER_CLUSTER = 16;
+
+static quint64 keyForCell(int cellX, int cellZ) {
+    return ((quint64)(quint32)cellX << 32) | (quint32)cellZ;
+}
 const float RADIUS_OF_HEAD = 0.076f;
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                         const QUuid& streamUUID,
-                                                         PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
-    // If repetition with fade is enabled:
-    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
-    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
-    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
-    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
-    // This improves the perceived quality of the audio slightly.
+float AudioMixer::audibleRadiusForLoudness(float trailingLoudness) const {
+    // a source is only mixed while trailingLoudness / distance > _minAudibilityThreshold
+    float audibleRadius = trailingLoudness / _minAudibilityThreshold;
     
-    bool showDebug = false;  // (randFloat() < 0.05f);
+    if (glm::isnan(audibleRadius)) {
+        // silence against a zero threshold, which can't pass it at any distance
+        return 0.0f;
+    }
     
-    float repeatedFrameFadeFactor = 1.0f;
+    if (_minAttenuationPerDoublingInDistance > 0.0f) {
+        // past this distance the distance coefficient is zero for every zone pairing, so the source would be silent
+        float silentDistance = ATTENUATION_BEGINS_AT_DISTANCE * exp2f(1.0f / _minAttenuationPerDoublingInDistance);
+        audibleRadius = glm::min(audibleRadius, silentDistance);
+    }
     
-    if (!streamToAdd->lastPopSucceeded()) {
-        if (_streamSettings._repetitionWithFade && !streamToAdd->getLastPopOutput().isNull()) {
-            // reptition with fade is enabled, and we do have a valid previous frame to repeat.
-            // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
-            if (repeatedFrameFadeFactor == 0.0f) {
-                return 0;
+    // a zero threshold with nothing to attenuate lets any sound be heard at any distance
+    return glm::isinf(audibleRadius) ? -1.0f : audibleRadius;
+}
+
+quint64 AudioMixer::zoneMaskForPosition(const glm::vec3& position) const {
+    quint64 zoneMask = 0;
+    for (int i = 0; i < _audioZoneBoxes.size(); ++i) {
+        if (_audioZoneBoxes[i].contains(position)) {
+            zoneMask |= (quint64)1 << i;
+        }
+    }
+    return zoneMask;
+}
+
+void AudioMixer::addFrameSourcesForNode(const SharedNodePointer& node) {
+    AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+    
+    const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+    QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+    for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+        PositionalAudioStream* stream = i.value();
+        
+        // a stream that has gone quiet and run out of silent samples has nothing to mix or repeat
+        if (!stream->lastPopSucceeded() && stream->isInComfortSilence()) {
+            continue;
+        }
+        
+        // If repetition with fade is enabled:
+        // If the stream could not provide a frame (it was starved), then we'll mix its previously-mixed frame
+        // This is preferable to not mixing it at all since that's equivalent to inserting silence.
+        // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
+        // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
+        // This improves the perceived quality of the audio slightly.
+        float repeatedFrameFadeFactor = 1.0f;
+        
+        if (!stream->lastPopSucceeded()) {
+            if (_streamSettings._repetitionWithFade && !stream->getLastPopOutput().isNull()) {
+                // reptition with fade is enabled, and we do have a valid previous frame to repeat.
+                // calculate its fade factor, which depends on how many times it's already been repeated.
+                repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
+                if (repeatedFrameFadeFactor == 0.0f) {
+                    continue;
+                }
+            } else {
+                continue;
             }
-        } else {
-            return 0;
         }
+        
+        // at this point, we know the stream's last pop output is valid
+        
+        // if the frame we're about to mix is silent, no listener will hear it
+        if (stream->getLastPopOutputLoudness() == 0.0f) {
+            continue;
+        }
+        
+        SourceFrameData source;
+        source.node = node;
+        source.streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+        source.stream = stream;
+        source.inverseOrientation = glm::inverse(stream->getOrientation());
+        source.zoneMask = _zonesSettings.isEmpty() ? 0 : zoneMaskForPosition(stream->getPosition());
+        source.trailingLoudness = stream->getLastPopOutputTrailingLoudness();
+        source.repeatedFrameFadeFactor = repeatedFrameFadeFactor;
+        source.distantMixBedIndex = (_distantMixRadius > 0.0f) ? addSourceToDistantMixBed(source) : -1;
+        source.listenerMixIndex = -1;
+        
+        _frameSourceGrid.addSource(_frameSources.size(), stream->getPosition(),
+                                   audibleRadiusForLoudness(source.trailingLoudness));
+        _frameSources.append(source);
+    }
+}
+
+int AudioMixer::addSourceToDistantMixBed(const SourceFrameData& source) {
+    PositionalAudioStream* stream = source.stream;
+    const glm::vec3& position = stream->getPosition();
+    
+    // the beds share the cell size of the source grid
+    int cellX = (int)floorf(position.x / DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE);
+    int cellZ = (int)floorf(position.z / DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE);
+    quint64 cellKey = keyForCell(cellX, cellZ);
+    
+    int bedIndex = _distantMixBedIndices.value(cellKey, -1);
+    if (bedIndex == -1) {
+        bedIndex = _distantMixBeds.size();
+        _distantMixBedIndices.insert(cellKey, bedIndex);
+        
+        _distantMixBeds.resize(bedIndex + 1);
+        DistantMixBed& newBed = _distantMixBeds[bedIndex];
+        newBed.cellX = cellX;
+        newBed.cellZ = cellZ;
+        newBed.position = glm::vec3(0.0f);
+        newBed.trailingLoudness = 0.0f;
+        newBed.loudnessWeight = 0.0f;
+        memset(newBed.accumulator, 0, sizeof(newBed.accumulator));
+    }
+    DistantMixBed& bed = _distantMixBeds[bedIndex];
+    
+    // only the listener independent part of the attenuation can go into the bed
+    float gain = source.repeatedFrameFadeFactor;
+    if (stream->getType() == PositionalAudioStream::Injector) {
+        gain *= reinterpret_cast<InjectedAudioStream*>(stream)->getAttenuationRatio();
+    }
+    
+    AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+    
+    if (stream->isStereo()) {
+        // downmix to mono, splitting the gain between the two channels
+        streamPopOutput.readSamples(_distantMixSourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+            bed.accumulator[i] += (int32_t)((_distantMixSourceSamples[2 * i] + _distantMixSourceSamples[2 * i + 1])
+                                            * gain * 0.5f);
+        }
+    } else {
+        streamPopOutput.readSamples(_distantMixSourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernel::scale(_distantMixSourceSamples, _distantMixSourceSamples, gain,
+                              AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        AudioMixKernel::accumulate(bed.accumulator, _distantMixSourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+    
+    // louder sources pull the position of the bed towards them, silent ones still count a little
+    const float MIN_LOUDNESS_WEIGHT = 0.0001f;
+    float loudnessWeight = glm::max(source.trailingLoudness, MIN_LOUDNESS_WEIGHT);
+    bed.position += position * loudnessWeight;
+    bed.loudnessWeight += loudnessWeight;
+    bed.trailingLoudness += source.trailingLoudness;
+    
+    return bedIndex;
+}
+
+void AudioMixer::finalizeDistantMixBeds() {
+    for (int i = 0; i < _distantMixBeds.size(); i++) {
+        DistantMixBed& bed = _distantMixBeds[i];
+        bed.position /= bed.loudnessWeight;
+        AudioMixKernel::saturate(bed.samples, bed.accumulator, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+}
+
+bool AudioMixer::shouldUseDistantMixBed(const DistantMixBed& bed, const ListenerFrameData& listener) const {
+    // distance on the XZ plane from the listener to the closest point of the bed's cell
+    float cellMinimumX = bed.cellX * DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE;
+    float cellMinimumZ = bed.cellZ * DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE;
+    float deltaX = glm::max(glm::max(cellMinimumX - listener.position.x,
+                                     listener.position.x - (cellMinimumX + DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE)), 0.0f);
+    float deltaZ = glm::max(glm::max(cellMinimumZ - listener.position.z,
+                                     listener.position.z - (cellMinimumZ + DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE)), 0.0f);
+    
+    return (deltaX * deltaX + deltaZ * deltaZ) > (_distantMixRadius * _distantMixRadius);
+}
+
+int AudioMixer::addDistantMixBedToMix(AudioMixerWorker& worker, const DistantMixBed& bed,
+                                      const ListenerFrameData& listener) {
+    glm::vec3 relativePosition = bed.position - listener.position;
+    float distanceBetween = glm::max(glm::length(relativePosition), EPSILON);
+    
+    if (bed.trailingLoudness / distanceBetween <= _minAudibilityThreshold) {
+        return 0;
     }
     
-    // at this point, we know streamToAdd's last pop output is valid
+    // the sources in a bed are spread across different zones, so the bed gets the default attenuation
+    float attenuationCoefficient = 1.0f;
+    if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
+        attenuationCoefficient = glm::max(1.0f - (log2f(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE)
+                                                  * _attenuationPerDoublingInDistance), 0.0f);
+    }
     
-    // if the frame we're about to mix is silent, bail
-    if (streamToAdd->getLastPopOutputLoudness() == 0.0f) {
+    if (attenuationCoefficient == 0.0f) {
         return 0;
     }
     
+    _stats.add(_mixesStatID);
+    
+    // pan by weakening the channel facing away from the bed, distant crowds don't get a phase delay
+    glm::vec3 rotatedSourcePosition = listener.inverseOrientation * relativePosition;
+    rotatedSourcePosition.y = 0.0f;
+    
+    float bearingRelativeAngleToSource = 0.0f;
+    if (glm::length(rotatedSourcePosition) > EPSILON) {
+        bearingRelativeAngleToSource = glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f),
+                                                          glm::normalize(rotatedSourcePosition),
+                                                          glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    
+    const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
+    float weakChannelGain = attenuationCoefficient * (1.0f - (PHASE_AMPLITUDE_RATIO_AT_90
+                                                              * fabsf(sinf(bearingRelativeAngleToSource))));
+    
+    int16_t* preMixSamples = worker.getPreMixSamples();
+    if (bearingRelativeAngleToSource > 0.0f) {
+        AudioMixKernel::interleave(preMixSamples, bed.samples, attenuationCoefficient, bed.samples, weakChannelGain,
+                                   AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        AudioMixKernel::interleave(preMixSamples, bed.samples, weakChannelGain, bed.samples, attenuationCoefficient,
+                                   AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+    
+    AudioMixKernel::accumulate(worker.getMixAccumulator(), preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+    
+    return 1;
+}
+
+int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerWorker& worker,
+                                                         AudioMixerClientData* listenerNodeData,
+                                                         const SourceFrameData& source,
+                                                         const ListenerFrameData& listener) {
+    bool showDebug = false;  // (randFloat() < 0.05f);
+    
+    PositionalAudioStream* streamToAdd = source.stream;
+    float repeatedFrameFadeFactor = source.repeatedFrameFadeFactor;
+    
     float bearingRelativeAngleToSource = 0.0f;
     float attenuationCoefficient = 1.0f;
     int numSamplesDelay = 0;
     float weakChannelAmplitudeRatio = 1.0f;
     
     //  Is the source that I am mixing my own?
-    bool sourceIsSelf = (streamToAdd == listeningNodeStream);
+    bool sourceIsSelf = (streamToAdd == listener.stream);
     
-    glm::vec3 relativePosition = streamToAdd->getPosition() - listeningNodeStream->getPosition();
+    glm::vec3 relativePosition = streamToAdd->getPosition() - listener.position;
     
     float distanceBetween = glm::length(relativePosition);
     
@@ -157,13 +421,13 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         distanceBetween = EPSILON;
     }
     
-    if (streamToAdd->getLastPopOutputTrailingLoudness() / distanceBetween <= _minAudibilityThreshold) {
+    if (source.trailingLoudness / distanceBetween <= _minAudibilityThreshold) {
         // according to mixer performance we have decided this does not get to be mixed in
         // bail out
         return 0;
     }
     
-    ++_sumMixes;
+    _stats.add(_mixesStatID);
     
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
@@ -176,11 +440,9 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         qDebug() << "distance: " << distanceBetween;
     }
     
-    glm::quat inverseOrientation = glm::inverse(listeningNodeStream->getOrientation());
-    
     if (!sourceIsSelf && (streamToAdd->getType() == PositionalAudioStream::Microphone)) {
         //  source is another avatar, apply fixed off-axis attenuation to make them quieter as they turn away from listener
-        glm::vec3 rotatedListenerPosition = glm::inverse(streamToAdd->getOrientation()) * relativePosition;
+        glm::vec3 rotatedListenerPosition = source.inverseOrientation * relativePosition;
         
         float angleOfDelivery = glm::angle(glm::vec3(0.0f, 0.0f, -1.0f),
                                            glm::normalize(rotatedListenerPosition));
@@ -201,17 +463,19 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
     }
     
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
-    for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
-            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
-            break;
+    if (source.zoneMask && listener.zoneMask) {
+        for (int i = 0; i < _zonesSettings.length(); ++i) {
+            if ((source.zoneMask & _zonesSettings[i].sourceZoneBit) &&
+                (listener.zoneMask & _zonesSettings[i].listenerZoneBit)) {
+                attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
+                break;
+            }
         }
     }
     
     if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
         // calculate the distance coefficient using the distance to this node
-        float distanceCoefficient = 1 - (logf(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
+        float distanceCoefficient = 1 - (log2f(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE)
                                          * attenuationPerDoublingInDistance);
         
         if (distanceCoefficient < 0) {
@@ -227,7 +491,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
     
     if (!sourceIsSelf) {
         //  Compute sample delay for the two ears to create phase panning
-        glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
+        glm::vec3 rotatedSourcePosition = listener.inverseOrientation * relativePosition;
 
         // project the rotated source position vector onto the XZ plane
         rotatedSourcePosition.y = 0.0f;
@@ -259,104 +523,51 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
     
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
     
+    // the pre-mix holds only this stream, it is accumulated into the listener's mix once it has been filtered
+    int16_t* preMixSamples = worker.getPreMixSamples();
+    int16_t* streamSamples = worker.getStreamSamples();
+    
+    float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+    
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
         
         // we need to do several things in this process:
         //    1) convert from mono to stereo by copying each input sample into the left and right output samples
-        //    2) 
         //    2) apply an attenuation AND fade to all samples (left and right)
         //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
         //       right channel of the input into the output
         //    4) because one of these channels is delayed, we will need to use historical samples from 
         //       the input stream for that delayed channel
-
-        // Mono input to stereo output (item 1 above)
-        int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
-        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-
-        // attenuation and fade applied to all samples (item 2 above)
-        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        // determine which side is weak and delayed (item 3 above)
-        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
+        int numOutputFrames = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2;
         
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
+        // pull the historical samples for the delayed channel (item 4 above) along with the frame itself into
+        // one contiguous run, so the delayed channel reads from the start and the other one numSamplesDelay in
         
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
-
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
+        // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
+        // maybe make AudioRingBuffer have 1 extra frame in its buffer
+        AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
+        delayStreamSourceSamples.readSamples(streamSamples, numOutputFrames + numSamplesDelay);
         
-        // The weak/delayed channel will be attenuated by this additional amount
+        const int16_t* delayedChannelSamples = streamSamples;
+        const int16_t* undelayedChannelSamples = streamSamples + numSamplesDelay;
+        
+        // The weak/delayed channel will be attenuated by this additional amount (item 3 above)
         float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
         
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
+        // determine which side is weak and delayed (item 3 above) and write both channels (items 1 and 2 above)
+        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
+        
         if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex; 
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
+            AudioMixKernel::interleave(preMixSamples, undelayedChannelSamples, attenuationAndFade,
+                                       delayedChannelSamples, attenuationAndWeakChannelRatioAndFade, numOutputFrames);
         } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
+            AudioMixKernel::interleave(preMixSamples, delayedChannelSamples, attenuationAndWeakChannelRatioAndFade,
+                                       undelayedChannelSamples, attenuationAndFade, numOutputFrames);
         }
-
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample 
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
-
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
-
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        }
-        
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
-
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        streamPopOutput.readSamples(streamSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        AudioMixKernel::scale(preMixSamples, streamSamples, attenuationAndFade, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
@@ -414,59 +625,279 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         }
         
         // Get our per listener/source data so we can get our filter
-        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getPenumbraFilter();
+        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(source.streamUUID)->getPenumbraFilter();
  
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+        penumbraFilter.render(preMixSamples, preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
     }
     
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
-    }
+    // Actually mix the preMixSamples into the listener's mix here, it is only clamped once the frame is finalized
+    AudioMixKernel::accumulate(worker.getMixAccumulator(), preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
-    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
-    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+int AudioMixer::prepareMixForListenerCluster(AudioMixerWorker& worker, int clusterIndex) {
+    // the shared mix is heard from where the cluster's first listener is
+    const ListenerMix& firstListenerMix = _listenerMixes[_listenerClusters[clusterIndex].firstListener];
+    const ListenerFrameData& listener = firstListenerMix.listener;
+    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(firstListenerMix.node->getLinkedData());
+    
+    // zero out the client mix for this cluster
+    worker.clearMixAccumulator();
+
+    // loop through all of the streams that have sufficient audio to mix
+    int streamsMixed = 0;
+    
+    // figure out which distant mix beds this listener hears instead of their individual sources
+    QVector<bool>& usedDistantMixBeds = worker.getUsedDistantMixBeds();
+    usedDistantMixBeds.resize(_distantMixBeds.size());
+    
+    for (int i = 0; i < _distantMixBeds.size(); i++) {
+        usedDistantMixBeds[i] = shouldUseDistantMixBed(_distantMixBeds[i], listener);
+    }
+    
+    // the cluster's own streams are mixed per listener, so the sources in a bed holding one of them are mixed one by
+    // one here instead, or the listeners would hear that stream twice, or their own
+    const ListenerCluster& cluster = _listenerClusters[clusterIndex];
+    for (int i = cluster.firstListener; i != -1; i = _listenerMixes[i].nextInCluster) {
+        const ListenerMix& listenerMix = _listenerMixes[i];
+        for (int j = listenerMix.firstSource; j < listenerMix.firstSource + listenerMix.numSources; j++) {
+            if (_frameSources[j].distantMixBedIndex != -1) {
+                usedDistantMixBeds[_frameSources[j].distantMixBedIndex] = false;
+            }
+        }
+    }
     
-    // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    for (int i = 0; i < _distantMixBeds.size(); i++) {
+        if (usedDistantMixBeds[i]) {
+            streamsMixed += addDistantMixBedToMix(worker, _distantMixBeds[i], listener);
+        }
+    }
+    
+    // _frameSources and their grid were built on the AudioMixer thread before mixing
+    _frameSourceGrid.eachSourceNear(listener.position, [&](int sourceIndex) {
+        const SourceFrameData& source = _frameSources[sourceIndex];
+        
+        if (source.distantMixBedIndex != -1 && usedDistantMixBeds[source.distantMixBedIndex]) {
+            // already heard through its bed
+            return;
+        }
+        
+        if (source.listenerMixIndex != -1 && _listenerMixes[source.listenerMixIndex].clusterIndex == clusterIndex) {
+            // the cluster's own streams are mixed per listener, in addListenerClusterStreamsToMix
+            return;
+        }
+        
+        streamsMixed += addStreamToMixForListeningNodeWithStream(worker, listenerNodeData, source, listener);
+    });
+    
+    return streamsMixed;
+}
 
-    // loop through all other nodes that have sufficient audio to mix
+int AudioMixer::addListenerClusterStreamsToMix(AudioMixerWorker& worker, int clusterIndex, int listenerIndex) {
+    const ListenerMix& listenerMix = _listenerMixes[listenerIndex];
+    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(listenerMix.node->getLinkedData());
+    
     int streamsMixed = 0;
     
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+    for (int i = _listenerClusters[clusterIndex].firstListener; i != -1; i = _listenerMixes[i].nextInCluster) {
+        const ListenerMix& otherListenerMix = _listenerMixes[i];
+        
+        for (int j = otherListenerMix.firstSource; j < otherListenerMix.firstSource + otherListenerMix.numSources; j++) {
+            const SourceFrameData& source = _frameSources[j];
             
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+            // a listener only hears their own streams if they asked for loopback
+            if (i != listenerIndex || source.stream->shouldLoopbackForNode()) {
+                streamsMixed += addStreamToMixForListeningNodeWithStream(worker, listenerNodeData,
+                                                                         source, listenerMix.listener);
+            }
+        }
+    }
+    
+    return streamsMixed;
+}
+
+void AudioMixer::finalizeListenerMix(AudioMixerWorker& worker, ListenerMix& listenerMix) {
+    if (listenerMix.streamsMixed > 0) {
+        AudioMixKernel::saturate(listenerMix.mixSamples, worker.getMixAccumulator(),
+                                 AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        
+        // encode here rather than on the send loop so the cost is spread across the workers
+        AudioMixerClientData* nodeData = (AudioMixerClientData*)listenerMix.node->getLinkedData();
+        listenerMix.codec = nodeData->getOutgoingMixCodec();
+        if (listenerMix.codec == AudioCodec::ADPCM) {
+            listenerMix.encodedSamples.resize(0);
+            nodeData->getOutgoingMixEncoder().encode(listenerMix.mixSamples,
+                                                     AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                                     listenerMix.encodedSamples);
+        }
+    }
+}
+
+void AudioMixer::mixListeners(AudioMixerWorker& worker, int firstCluster, int stride) {
+    PERFORMANCE_TIMER("mixListeners");
+    for (int i = firstCluster; i < _listenerClusters.size(); i += stride) {
+        const ListenerCluster& cluster = _listenerClusters[i];
+        
+        // everything but the cluster's own streams is mixed once for all of its listeners
+        int sharedStreamsMixed = prepareMixForListenerCluster(worker, i);
+        
+        if (cluster.numListeners > 1) {
+            worker.saveSharedMix();
+        }
+        
+        for (int j = cluster.firstListener; j != -1; j = _listenerMixes[j].nextInCluster) {
+            if (j != cluster.firstListener) {
+                worker.restoreSharedMix();
+            }
             
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
-                
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
+            ListenerMix& listenerMix = _listenerMixes[j];
+            listenerMix.streamsMixed = sharedStreamsMixed + addListenerClusterStreamsToMix(worker, i, j);
+            finalizeListenerMix(worker, listenerMix);
+        }
+    }
+}
+
+int AudioMixer::findListenerCluster(const ListenerFrameData& listener, int cellX, int cellZ) const {
+    float clusterRadius = _listenerClusterRadius;
+    
+    // clusters are filed under the cell of their first listener, which is at most one cell away
+    for (int x = cellX - 1; x <= cellX + 1; x++) {
+        for (int z = cellZ - 1; z <= cellZ + 1; z++) {
+            quint64 cellKey = keyForCell(x, z);
+            
+            QMultiHash<quint64, int>::const_iterator i = _listenerClusterCells.constFind(cellKey);
+            for (; i != _listenerClusterCells.constEnd() && i.key() == cellKey; ++i) {
+                const ListenerCluster& cluster = _listenerClusters[i.value()];
+                const ListenerFrameData& firstListener = _listenerMixes[cluster.firstListener].listener;
                 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
+                if (cluster.numListeners < MAX_LISTENERS_PER_CLUSTER
+                    && firstListener.zoneMask == listener.zoneMask
+                    && glm::distance2(firstListener.position, listener.position) <= clusterRadius * clusterRadius
+                    && fabsf(glm::dot(firstListener.inverseOrientation, listener.inverseOrientation))
+                        >= _listenerClusterMinOrientationDot) {
+                    return i.value();
                 }
             }
         }
-    });
+    }
     
-    return streamsMixed;
+    return -1;
+}
+
+void AudioMixer::clusterListeners() {
+    for (int i = 0; i < _listenerMixes.size(); i++) {
+        ListenerMix& listenerMix = _listenerMixes[i];
+        
+        int clusterIndex = -1;
+        quint64 cellKey = 0;
+        
+        if (_listenerClusterRadius > 0.0f) {
+            int cellX = (int)floorf(listenerMix.listener.position.x / _listenerClusterRadius);
+            int cellZ = (int)floorf(listenerMix.listener.position.z / _listenerClusterRadius);
+            cellKey = keyForCell(cellX, cellZ);
+            clusterIndex = findListenerCluster(listenerMix.listener, cellX, cellZ);
+        }
+        
+        if (clusterIndex == -1) {
+            // this listener starts a cluster of its own, which is every listener's when clustering is disabled
+            clusterIndex = _listenerClusters.size();
+            _listenerClusters.resize(clusterIndex + 1);
+            
+            ListenerCluster& newCluster = _listenerClusters[clusterIndex];
+            newCluster.firstListener = i;
+            newCluster.numListeners = 0;
+            
+            if (_listenerClusterRadius > 0.0f) {
+                _listenerClusterCells.insert(cellKey, clusterIndex);
+            }
+        } else {
+            _listenerMixes[_listenerClusters[clusterIndex].lastListener].nextInCluster = i;
+        }
+        
+        ListenerCluster& cluster = _listenerClusters[clusterIndex];
+        cluster.lastListener = i;
+        cluster.numListeners++;
+        
+        listenerMix.clusterIndex = clusterIndex;
+        listenerMix.nextInCluster = -1;
+    }
+    
+    _stats.add(_listenerClustersStatID, _listenerClusters.size());
+}
+
+void AudioMixer::addNodeToFrame(const SharedNodePointer& node, bool isListener) {
+    AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+    
+    // this function will attempt to pop a frame from each audio stream.
+    // a pointer to the popped data is stored as a member in InboundAudioStream.
+    // That's how the popped audio data will be read for mixing (but only if the pop was successful)
+    nodeData->checkBuffersBeforeFrameSend();
+    
+    int firstSource = _frameSources.size();
+    addFrameSourcesForNode(node);
+    
+    if (isListener) {
+        int listenerMixIndex = _listenerMixes.size();
+        _listenerMixes.resize(listenerMixIndex + 1);
+        
+        ListenerMix& listenerMix = _listenerMixes.last();
+        listenerMix.node = node;
+        listenerMix.firstSource = firstSource;
+        listenerMix.numSources = _frameSources.size() - firstSource;
+        
+        AvatarAudioStream* listenerStream = nodeData->getAvatarAudioStream();
+        listenerMix.listener.stream = listenerStream;
+        listenerMix.listener.position = listenerStream->getPosition();
+        listenerMix.listener.inverseOrientation = glm::inverse(listenerStream->getOrientation());
+        listenerMix.listener.zoneMask = _zonesSettings.isEmpty() ? 0 : zoneMaskForPosition(listenerMix.listener.position);
+        
+        for (int i = firstSource; i < _frameSources.size(); i++) {
+            _frameSources[i].listenerMixIndex = listenerMixIndex;
+        }
+    }
+}
+
+void AudioMixer::mixFrame() {
+    PERFORMANCE_TIMER("mixFrame");
+    _frameSourceGrid.finalize();
+    finalizeDistantMixBeds();
+    clusterListeners();
+    mixAllListeners();
+}
+
+void AudioMixer::clearFrame() {
+    // don't hold on to nodes that may be killed before the next frame
+    _frameSources.resize(0);
+    _frameSourceGrid.clear();
+    _distantMixBeds.resize(0);
+    _distantMixBedIndices.clear();
+    _listenerMixes.resize(0);
+    _listenerClusters.resize(0);
+    _listenerClusterCells.clear();
+}
+
+void AudioMixer::mixAllListeners() {
+    int numWorkers = qMin(_mixWorkers.size(), _listenerClusters.size());
+    
+    if (numWorkers == 0) {
+        return;
+    }
+    
+    // hand out the clusters round-robin so that the workers end up with a similar number of streams to mix
+    for (int i = 1; i < numWorkers; ++i) {
+        _mixWorkers[i]->setListeners(i, numWorkers);
+        _mixThreadPool.start(_mixWorkers[i]);
+    }
+    
+    // the AudioMixer thread mixes its share too, instead of sitting idle until the pool is done
+    _mixWorkers[0]->setListeners(0, numWorkers);
+    _mixWorkers[0]->run();
+    
+    _mixThreadPool.waitForDone();
 }
 
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
@@ -522,7 +953,7 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
             memcpy(envDataAt, &wetLevel, sizeof(float));
             envDataAt += sizeof(float);
         }
-        DependencyManager::get<NodeList>()->writeDatagram(clientEnvBuffer, envDataAt - clientEnvBuffer, node);
+        DependencyManager::get<NodeList>()->bundleDatagram(clientEnvBuffer, envDataAt - clientEnvBuffer, node);
     }
 }
 
@@ -532,13 +963,22 @@ void AudioMixer::readPendingDatagram(const QByteArray& receivedPacket, const Hif
     if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
         // pull any new audio data from nodes off of the network stack
         PacketType mixerPacketType = packetTypeForPacket(receivedPacket);
+        PacketMetrics::ProcessingTimer processingTimer(nodeList->getPacketMetrics(), mixerPacketType);
         if (mixerPacketType == PacketTypeMicrophoneAudioNoEcho
             || mixerPacketType == PacketTypeMicrophoneAudioWithEcho
             || mixerPacketType == PacketTypeInjectAudio
-            || mixerPacketType == PacketTypeSilentAudioFrame
-            || mixerPacketType == PacketTypeAudioStreamStats) {
+            || mixerPacketType == PacketTypeSilentAudioFrame) {
             
             nodeList->findNodeAndUpdateWithDataFromPacket(receivedPacket);
+        } else if (mixerPacketType == PacketTypeAudioStreamStats) {
+            SharedNodePointer sendingNode = nodeList->sendingNodeForPacket(receivedPacket);
+            if (sendingNode) {
+                nodeList->updateNodeWithDataFromPacket(sendingNode, receivedPacket);
+                
+                // what the node lost of our mixes tells its congestion controller how the path down to it is doing
+                AudioMixerClientData* clientData = (AudioMixerClientData*)sendingNode->getLinkedData();
+                sendingNode->getCongestionController().lossSampled(clientData->getDownstreamLossRate());
+            }
         } else if (mixerPacketType == PacketTypeMuteEnvironment) {
             QByteArray packet = receivedPacket;
             populatePacketHeader(packet, PacketTypeMuteEnvironment);
@@ -562,18 +1002,21 @@ void AudioMixer::sendStatsPacket() {
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100.0f;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
-    statsObject["average_listeners_per_frame"] = (float) _sumListeners / (float) _numStatFrames;
+    float numStatFrames = _stats.getCount(_framesStatID);
+    quint64 sumListeners = _stats.getCount(_listenersStatID);
+    statsObject["average_listeners_per_frame"] = (float) sumListeners / numStatFrames;
     
-    if (_sumListeners > 0) {
-        statsObject["average_mixes_per_listener"] = (float) _sumMixes / (float) _sumListeners;
+    if (sumListeners > 0) {
+        statsObject["average_mixes_per_listener"] = (float) _stats.getCount(_mixesStatID) / (float) sumListeners;
     } else {
         statsObject["average_mixes_per_listener"] = 0.0;
     }
+    
+    statsObject["average_listener_clusters_per_frame"] =
+        (float) _stats.getCount(_listenerClustersStatID) / numStatFrames;
 
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
-    _sumListeners = 0;
-    _sumMixes = 0;
-    _numStatFrames = 0;
+    _stats.reset();
 
 
     // NOTE: These stats can be too large to fit in an MTU, so we break it up into multiple packts...
@@ -774,72 +1217,85 @@ void AudioMixer::run() {
             if (node->getLinkedData()) {
                 AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
 
-                // this function will attempt to pop a frame from each audio stream.
-                // a pointer to the popped data is stored as a member in InboundAudioStream.
-                // That's how the popped audio data will be read for mixing (but only if the pop was successful)
-                nodeData->checkBuffersBeforeFrameSend();
+                addNodeToFrame(node, node->getType() == NodeType::Agent && node->getActiveSocket()
+                               && nodeData->getAvatarAudioStream());
             
                 // if the stream should be muted, send mute packet
                 if (nodeData->getAvatarAudioStream()
                     && shouldMute(nodeData->getAvatarAudioStream()->getQuietestFrameLoudness())) {
-                    QByteArray packet = byteArrayWithPopulatedHeader(PacketTypeNoisyMute);
-                    nodeList->writeDatagram(packet, node);
+                    PacketBuffer packet;
+                    packet.populateHeader(PacketTypeNoisyMute);
+                    nodeList->writeDatagramInPlace(packet, node);
                 }
+            }
+        });
+        
+        // every stream has popped its frame for this round, now mix for all of the listeners
+        mixFrame();
+        
+        // packets are sent from the AudioMixer thread only, the node socket is not safe to share between the workers,
+        // and each listener's environment, mix and stats go out together in one bundle
+        for (int i = 0; i < _listenerMixes.size(); ++i) {
+            const SharedNodePointer& node = _listenerMixes[i].node;
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+            
+            char* mixDataAt;
+            if (_listenerMixes[i].streamsMixed > 0) {
+                // pack header
+                int numBytesMixPacketHeader = populatePacketHeader(clientMixBuffer, PacketTypeMixedAudio);
+                mixDataAt = clientMixBuffer + numBytesMixPacketHeader;
+
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                memcpy(mixDataAt, &sequence, sizeof(quint16));
+                mixDataAt  += sizeof(quint16);
                 
-                if (node->getType() == NodeType::Agent && node->getActiveSocket()
-                    && nodeData->getAvatarAudioStream()) {
-
-                    int streamsMixed = prepareMixForListeningNode(node.data());
-
-                    char* mixDataAt;
-                    if (streamsMixed > 0) {
-                        // pack header
-                        int numBytesMixPacketHeader = populatePacketHeader(clientMixBuffer, PacketTypeMixedAudio);
-                        mixDataAt = clientMixBuffer + numBytesMixPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt  += sizeof(quint16);
-                        
-                        // pack mixed audio samples
-                        memcpy(mixDataAt, _mixSamples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                        mixDataAt += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                    } else {
-                        // pack header
-                        int numBytesPacketHeader = populatePacketHeader(clientMixBuffer, PacketTypeSilentAudioFrame);
-                        mixDataAt = clientMixBuffer + numBytesPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        memcpy(mixDataAt, &numSilentSamples, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-                    }
-                    
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
-
-                    // send mixed audio packet
-                    nodeList->writeDatagram(clientMixBuffer, mixDataAt - clientMixBuffer, node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                // pack the codec and the mixed audio samples
+                *mixDataAt++ = (char)_listenerMixes[i].codec;
+                if (_listenerMixes[i].codec == AudioCodec::ADPCM) {
+                    memcpy(mixDataAt, _listenerMixes[i].encodedSamples.constData(),
+                           _listenerMixes[i].encodedSamples.size());
+                    mixDataAt += _listenerMixes[i].encodedSamples.size();
+                } else {
+                    memcpy(mixDataAt, _listenerMixes[i].mixSamples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+                    mixDataAt += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+                }
+            } else {
+                // pack header
+                int numBytesPacketHeader = populatePacketHeader(clientMixBuffer, PacketTypeSilentAudioFrame);
+                mixDataAt = clientMixBuffer + numBytesPacketHeader;
+
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                memcpy(mixDataAt, &sequence, sizeof(quint16));
+                mixDataAt += sizeof(quint16);
+
+                // pack number of silent audio samples
+                quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+                memcpy(mixDataAt, &numSilentSamples, sizeof(quint16));
+                mixDataAt += sizeof(quint16);
+            }
+            
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+            // send mixed audio packet
+            nodeList->bundleDatagram(clientMixBuffer, mixDataAt - clientMixBuffer, node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
 
-                    ++_sumListeners;
-                }
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
             }
-        });
+
+            _stats.add(_listenersStatID);
+        }
+        nodeList->flushBundledDatagrams();
+        
+        clearFrame();
         
-        ++_numStatFrames;
+        _stats.add(_framesStatID);
         
         QCoreApplication::processEvents();
         
@@ -977,6 +1433,19 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Using Fred's max-gap method for jitter calc if dynamic jitter buffers enabled";
         }
         
+        const QString USE_PERCENTILE_FOR_DESIRED_CALC_JSON_KEY = "use_percentile_for_desired_calc";
+        _streamSettings._usePercentileForJitterCalc = audioBufferGroupObject[USE_PERCENTILE_FOR_DESIRED_CALC_JSON_KEY].toBool();
+        if (_streamSettings._usePercentileForJitterCalc) {
+            qDebug() << "Using the late loss percentile method with time stretching if dynamic jitter buffers enabled";
+        }
+        
+        const QString TARGET_LATE_LOSS_RATE_JSON_KEY = "target_late_loss_rate";
+        _streamSettings._targetLateLossRate = audioBufferGroupObject[TARGET_LATE_LOSS_RATE_JSON_KEY].toString().toFloat(&ok);
+        if (!ok) {
+            _streamSettings._targetLateLossRate = DEFAULT_TARGET_LATE_LOSS_RATE;
+        }
+        qDebug() << "Target late loss rate:" << _streamSettings._targetLateLossRate;
+        
         const QString WINDOW_STARVE_THRESHOLD_JSON_KEY = "window_starve_threshold";
         _streamSettings._windowStarveThreshold = audioBufferGroupObject[WINDOW_STARVE_THRESHOLD_JSON_KEY].toString().toInt(&ok);
         if (!ok) {
@@ -1022,6 +1491,7 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             float attenuation = audioEnvGroupObject[ATTENATION_PER_DOULING_IN_DISTANCE].toString().toFloat(&ok);
             if (ok) {
                 _attenuationPerDoublingInDistance = attenuation;
+                _minAttenuationPerDoublingInDistance = attenuation;
                 qDebug() << "Attenuation per doubling in distance changed to" << _attenuationPerDoublingInDistance;
             }
         }
@@ -1036,6 +1506,65 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString NUM_MIX_THREADS = "num_mix_threads";
+        if (audioEnvGroupObject[NUM_MIX_THREADS].isString()) {
+            bool ok = false;
+            int numMixThreads = audioEnvGroupObject[NUM_MIX_THREADS].toString().toInt(&ok);
+            if (ok) {
+                // zero means one thread per core
+                if (numMixThreads <= 0) {
+                    numMixThreads = QThread::idealThreadCount();
+                }
+                setupMixWorkers(qMax(numMixThreads, 1));
+                qDebug() << "Mixing for listeners with" << _mixWorkers.size() << "thread(s)";
+            }
+        }
+        
+        const QString NUM_RECEIVE_THREADS = "num_receive_threads";
+        if (audioEnvGroupObject[NUM_RECEIVE_THREADS].isString()) {
+            bool ok = false;
+            int numReceiveThreads = audioEnvGroupObject[NUM_RECEIVE_THREADS].toString().toInt(&ok);
+            if (ok && numReceiveThreads > 1) {
+                setupReceiveShards(numReceiveThreads);
+                qDebug() << "Receiving from listeners with" << _receiveShardThreads.size() + 1 << "thread(s)";
+            }
+        }
+
+        const QString DISTANT_MIX_RADIUS = "distant_mix_radius";
+        if (audioEnvGroupObject[DISTANT_MIX_RADIUS].isString()) {
+            bool ok = false;
+            float distantMixRadius = audioEnvGroupObject[DISTANT_MIX_RADIUS].toString().toFloat(&ok);
+            if (ok && distantMixRadius >= 0.0f) {
+                _distantMixRadius = distantMixRadius;
+                if (_distantMixRadius > 0.0f) {
+                    qDebug() << "Sources further than" << _distantMixRadius << "from a listener will be pre-mixed by area";
+                }
+            }
+        }
+
+        const QString LISTENER_CLUSTER_RADIUS = "listener_cluster_radius";
+        if (audioEnvGroupObject[LISTENER_CLUSTER_RADIUS].isString()) {
+            bool ok = false;
+            float listenerClusterRadius = audioEnvGroupObject[LISTENER_CLUSTER_RADIUS].toString().toFloat(&ok);
+            if (ok && listenerClusterRadius >= 0.0f) {
+                _listenerClusterRadius = listenerClusterRadius;
+                if (_listenerClusterRadius > 0.0f) {
+                    qDebug() << "Listeners within" << _listenerClusterRadius << "of each other will share a mix";
+                }
+            }
+        }
+
+        const QString LISTENER_CLUSTER_ANGLE = "listener_cluster_angle";
+        if (audioEnvGroupObject[LISTENER_CLUSTER_ANGLE].isString()) {
+            bool ok = false;
+            float listenerClusterAngle = audioEnvGroupObject[LISTENER_CLUSTER_ANGLE].toString().toFloat(&ok);
+            if (ok && listenerClusterAngle >= 0.0f && listenerClusterAngle <= 180.0f) {
+                // compared against the dot product of two orientations, which is the cosine of half the angle between them
+                _listenerClusterMinOrientationDot = cosf(glm::radians(listenerClusterAngle) / 2.0f);
+                qDebug() << "Listeners facing within" << listenerClusterAngle << "degrees of each other can share a mix";
+            }
+        }
+
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
             _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
@@ -1080,6 +1609,15 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                             glm::vec3 dimensions(xMax - xMin, yMax - yMin, zMax - zMin);
                             AABox zoneAABox(corner, dimensions);
                             _audioZones.insert(zone, zoneAABox);
+                            
+                            const int MAX_AUDIO_ZONES = 64;
+                            if (_audioZoneBoxes.size() < MAX_AUDIO_ZONES) {
+                                _audioZoneBits.insert(zone, (quint64)1 << _audioZoneBoxes.size());
+                                _audioZoneBoxes.append(zoneAABox);
+                            } else {
+                                qDebug() << "Zone" << zone << "exceeds the maximum of" << MAX_AUDIO_ZONES
+                                    << "zones and will not affect attenuation";
+                            }
                             qDebug() << "Added zone:" << zone << "(corner:" << corner
                                      << ", dimensions:" << dimensions << ")";
                         }
@@ -1112,7 +1650,12 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                     if (ok && settings.coefficient >= 0.0f && settings.coefficient <= 1.0f &&
                         _audioZones.contains(settings.source) && _audioZones.contains(settings.listener)) {
                         
+                        settings.sourceZoneBit = _audioZoneBits.value(settings.source);
+                        settings.listenerZoneBit = _audioZoneBits.value(settings.listener);
+                        
                         _zonesSettings.push_back(settings);
+                        _minAttenuationPerDoublingInDistance = glm::min(_minAttenuationPerDoublingInDistance,
+                                                                        settings.coefficient);
                         qDebug() << "Added Coefficient:" << settings.source << settings.listener << settings.coefficient;
                     }
                 }
@@ -12,13 +12,22 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <QtCore/QThreadPool>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include <AABox.h>
+#include <AudioCodec.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 
+#include "AudioSourceGrid.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
+class AudioMixerWorker;
 
 const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
@@ -27,8 +36,15 @@ const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
+    
+    // drives the frame mixing directly with fake nodes, see tests/audio-mixer
+    friend class AudioMixerBenchmark;
 public:
     AudioMixer(const QByteArray& packet);
+    ~AudioMixer();
+    
+    /// mixes every stride-th listener cluster of the current frame starting at firstCluster, called from the mix workers
+    void mixListeners(AudioMixerWorker& worker, int firstCluster, int stride);
 public slots:
     /// threaded run of assignment
     void run();
@@ -41,25 +57,147 @@ public slots:
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
     
 private:
+    /// per-frame state of a stream that has audio to mix, computed once and shared by every listener's mix
+    struct SourceFrameData {
+        SharedNodePointer node;
+        QUuid streamUUID;
+        PositionalAudioStream* stream;
+        glm::quat inverseOrientation;
+        quint64 zoneMask;
+        float trailingLoudness;
+        float repeatedFrameFadeFactor;
+        int distantMixBedIndex; // -1 if distant crowd mixing is disabled
+        int listenerMixIndex; // -1 unless the stream belongs to one of this frame's listeners
+    };
+    
+    /// a mono downmix of all the sources in one grid cell, shared by every listener that is far enough away from it
+    struct DistantMixBed {
+        int cellX;
+        int cellZ;
+        glm::vec3 position; // loudness weighted center of the sources
+        float trailingLoudness;
+        float loudnessWeight;
+        int32_t accumulator[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    };
+    
+    /// per-frame state of a listener, computed once before it is compared against each of the sources
+    struct ListenerFrameData {
+        AvatarAudioStream* stream;
+        glm::vec3 position;
+        glm::quat inverseOrientation;
+        quint64 zoneMask;
+    };
+    
+    /// adds the node's streams that have something to mix this frame to _frameSources
+    void addFrameSourcesForNode(const SharedNodePointer& node);
+    
+    /// returns the distance beyond which a source with the given trailing loudness can not be heard, or -1 if it can be
+    /// heard at any distance
+    float audibleRadiusForLoudness(float trailingLoudness) const;
+    
+    /// returns a mask of the audio zones (bits in _audioZoneBoxes order) that contain the given position
+    quint64 zoneMaskForPosition(const glm::vec3& position) const;
+    
+    /// adds the source's popped frame to the distant mix bed for its cell, returns the index of that bed
+    int addSourceToDistantMixBed(const SourceFrameData& source);
+    
+    /// saturates the distant mix beds and computes their positions once every source has been added
+    void finalizeDistantMixBeds();
+    
+    /// returns true if the listener is far enough from the bed's cell to hear its sources through the bed
+    bool shouldUseDistantMixBed(const DistantMixBed& bed, const ListenerFrameData& listener) const;
+    
+    /// adds one distant mix bed to the mix for a listening node with a single pan and attenuation
+    int addDistantMixBedToMix(AudioMixerWorker& worker, const DistantMixBed& bed, const ListenerFrameData& listener);
+    
     /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                    const QUuid& streamUUID,
-                                                    PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
+    int addStreamToMixForListeningNodeWithStream(AudioMixerWorker& worker,
+                                                    AudioMixerClientData* listenerNodeData,
+                                                    const SourceFrameData& source,
+                                                    const ListenerFrameData& listener);
+    
+    /// groups this frame's listeners into clusters that are close enough together to share one mix
+    void clusterListeners();
+    
+    /// returns the cluster within the tolerances of the listener, found around the given cell, or -1 if there is none
+    int findListenerCluster(const ListenerFrameData& listener, int cellX, int cellZ) const;
     
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// prepares the mix shared by a cluster's listeners in the worker's mix buffer, without the cluster's own streams
+    int prepareMixForListenerCluster(AudioMixerWorker& worker, int clusterIndex);
+    
+    /// adds the streams of the cluster's listeners to the mix for one of them, as heard from where that listener is
+    int addListenerClusterStreamsToMix(AudioMixerWorker& worker, int clusterIndex, int listenerIndex);
+    
+    /// pops a frame from each of the node's streams into this frame's sources, and adds the node as a listener
+    void addNodeToFrame(const SharedNodePointer& node, bool isListener);
+    
+    /// mixes for every listener once all of the nodes have been added to the frame
+    void mixFrame();
+    
+    /// lets go of the sources and listeners of the frame that was just sent
+    void clearFrame();
+    
+    /// mixes all of this frame's listeners, spreading them across the mix workers
+    void mixAllListeners();
     
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
-
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
     
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    void setupMixWorkers(int numMixThreads);
+    
+    /// adds datagram processing threads, each receiving on its own socket bound to the node socket's port, until there
+    /// are numReceiveThreads of them counting the first
+    void setupReceiveShards(int numReceiveThreads);
+    
+    /// the result of mixing for a single listener in the current frame
+    struct ListenerMix {
+        SharedNodePointer node;
+        ListenerFrameData listener;
+        int firstSource;    // the listener's own streams are _frameSources[firstSource, firstSource + numSources)
+        int numSources;
+        int clusterIndex;
+        int nextInCluster;  // the next listener sharing the cluster's mix, -1 for the last one
+        int streamsMixed;
+        int16_t mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        AudioCodec::Type codec;
+        QByteArray encodedSamples;
+    };
+    
+    /// listeners whose positions and orientations are close enough to the first one's to share its mix
+    struct ListenerCluster {
+        int firstListener;
+        int lastListener;
+        int numListeners;
+    };
+    
+    /// saturates the worker's mix into the listener's mix samples and encodes them for sending
+    void finalizeListenerMix(AudioMixerWorker& worker, ListenerMix& listenerMix);
+    
+    // streams with audio to mix and the listeners, gathered once per frame before mixing
+    QVector<SourceFrameData> _frameSources;
+    
+    // _frameSources indexed by where they can be heard, so a listener only visits sources that could pass
+    // the audibility and distance attenuation checks
+    AudioSourceGrid _frameSourceGrid;
+    
+    // sources further than _distantMixRadius from a listener are heard through these instead of individually
+    float _distantMixRadius;
+    QVector<DistantMixBed> _distantMixBeds;
+    QHash<quint64, int> _distantMixBedIndices;
+    int16_t _distantMixSourceSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    QVector<ListenerMix> _listenerMixes;
+    
+    // listeners within _listenerClusterRadius of each other and facing within the angle that
+    // _listenerClusterMinOrientationDot is the cosine of (halved) share one mix of everything but their own streams
+    float _listenerClusterRadius;
+    float _listenerClusterMinOrientationDot;
+    QVector<ListenerCluster> _listenerClusters;
+    QMultiHash<quint64, int> _listenerClusterCells;
+    
+    // the first worker always mixes on the AudioMixer thread, the others are run on _mixThreadPool
+    QVector<AudioMixerWorker*> _mixWorkers;
+    QThreadPool _mixThreadPool;
 
     void perSecondActions();
     
@@ -76,16 +214,25 @@ private:
     float _minAudibilityThreshold;
     float _performanceThrottlingRatio;
     float _attenuationPerDoublingInDistance;
+    float _minAttenuationPerDoublingInDistance; // the weakest attenuation of the default and all zone coefficients
     float _noiseMutingThreshold;
-    int _numStatFrames;
-    int _sumListeners;
-    int _sumMixes;
+    int _framesStatID;
+    int _listenersStatID;
+    int _listenerClustersStatID;
+    int _mixesStatID;
     
     QHash<QString, AABox> _audioZones;
+    
+    // the zones again, by index, so that zone membership can be kept as a bitmask per stream
+    QVector<AABox> _audioZoneBoxes;
+    QHash<QString, quint64> _audioZoneBits;
+    
     struct ZonesSettings {
         QString source;
         QString listener;
         float coefficient;
+        quint64 sourceZoneBit;
+        quint64 listenerZoneBit;
     };
     QVector<ZonesSettings> _zonesSettings;
     struct ReverbSettings {
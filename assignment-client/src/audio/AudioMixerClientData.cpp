@@ -11,6 +11,7 @@
 
 #include <QDebug>
 
+#include <AudioConstants.h>
 #include <PacketHeaders.h>
 #include <UUID.h>
 
@@ -23,7 +24,9 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
-    _downstreamAudioStreamStats()
+    _outgoingMixEncoder(AudioConstants::STEREO),
+    _downstreamAudioStreamStats(),
+    _downstreamLossRate(0.0f)
 {
 }
 
@@ -48,6 +51,11 @@ AvatarAudioStream* AudioMixerClientData::getAvatarAudioStream() const {
     return NULL;
 }
 
+AudioCodec::Type AudioMixerClientData::getOutgoingMixCodec() const {
+    AvatarAudioStream* avatarAudioStream = getAvatarAudioStream();
+    return avatarAudioStream ? avatarAudioStream->getIncomingCodec() : AudioCodec::PCM;
+}
+
 int AudioMixerClientData::parseData(const QByteArray& packet) {
     PacketType packetType = packetTypeForPacket(packet);
     if (packetType == PacketTypeAudioStreamStats) {
@@ -58,8 +66,18 @@ int AudioMixerClientData::parseData(const QByteArray& packet) {
         dataAt += (numBytesForPacketHeader(packet) + sizeof(quint8) + sizeof(quint16));
 
         // read the downstream audio stream stats
+        PacketStreamStats previousPacketStats = _downstreamAudioStreamStats._packetStreamStats;
         memcpy(&_downstreamAudioStreamStats, dataAt, sizeof(AudioStreamStats));
         dataAt += sizeof(AudioStreamStats);
+        
+        // the counts start over when the node resets its stream, in which case there's nothing to compare
+        const PacketStreamStats& packetStats = _downstreamAudioStreamStats._packetStreamStats;
+        if (packetStats._expectedReceived > previousPacketStats._expectedReceived
+                && packetStats._lost >= previousPacketStats._lost) {
+            _downstreamLossRate = (packetStats - previousPacketStats).getLostRate();
+        } else {
+            _downstreamLossRate = 0.0f;
+        }
 
         return dataAt - packet.data();
 
@@ -192,7 +210,7 @@ void AudioMixerClientData::sendAudioStreamStatsPackets(const SharedNodePointer&
         numStreamStatsRemaining -= numStreamStatsToPack;
 
         // send the current packet
-        nodeList->writeDatagram(packet, dataAt - packet, destinationNode);
+        nodeList->bundleDatagram(packet, dataAt - packet, destinationNode);
     }
 }
 
@@ -206,6 +224,9 @@ QString AudioMixerClientData::getAudioStreamStatsString() const {
         + " not_mixed:" + QString::number(streamStats._consecutiveNotMixedCount)
         + " overflows:" + QString::number(streamStats._overflowCount)
         + " silents_dropped: ?"
+        + " delay_at_percentile:" + formatUsecTime(streamStats._packetDelayAtPercentile)
+        + " expansions:" + QString::number(streamStats._timeStretchExpansions)
+        + " compressions:" + QString::number(streamStats._timeStretchCompressions)
         + " lost%:" + QString::number(streamStats._packetStreamStats.getLostRate() * 100.0f, 'f', 2)
         + " lost%_30s:" + QString::number(streamStats._packetStreamWindowStats.getLostRate() * 100.0f, 'f', 2)
         + " min_gap:" + formatUsecTime(streamStats._timeGapMin)
@@ -226,6 +247,9 @@ QString AudioMixerClientData::getAudioStreamStatsString() const {
             + " not_mixed:" + QString::number(streamStats._consecutiveNotMixedCount)
             + " overflows:" + QString::number(streamStats._overflowCount)
             + " silents_dropped:" + QString::number(streamStats._framesDropped)
+            + " delay_at_percentile:" + formatUsecTime(streamStats._packetDelayAtPercentile)
+            + " expansions:" + QString::number(streamStats._timeStretchExpansions)
+            + " compressions:" + QString::number(streamStats._timeStretchCompressions)
             + " lost%:" + QString::number(streamStats._packetStreamStats.getLostRate() * 100.0f, 'f', 2)
             + " lost%_30s:" + QString::number(streamStats._packetStreamWindowStats.getLostRate() * 100.0f, 'f', 2)
             + " min_gap:" + formatUsecTime(streamStats._timeGapMin)
@@ -250,6 +274,9 @@ QString AudioMixerClientData::getAudioStreamStatsString() const {
                 + " not_mixed:" + QString::number(streamStats._consecutiveNotMixedCount)
                 + " overflows:" + QString::number(streamStats._overflowCount)
                 + " silents_dropped:" + QString::number(streamStats._framesDropped)
+                + " delay_at_percentile:" + formatUsecTime(streamStats._packetDelayAtPercentile)
+                + " expansions:" + QString::number(streamStats._timeStretchExpansions)
+                + " compressions:" + QString::number(streamStats._timeStretchCompressions)
                 + " lost%:" + QString::number(streamStats._packetStreamStats.getLostRate() * 100.0f, 'f', 2)
                 + " lost%_30s:" + QString::number(streamStats._packetStreamWindowStats.getLostRate() * 100.0f, 'f', 2)
                 + " min_gap:" + formatUsecTime(streamStats._timeGapMin)
@@ -294,6 +321,12 @@ void AudioMixerClientData::printAudioStreamStats(const AudioStreamStats& streamS
         streamStats._framesDropped,
         streamStats._overflowCount);
 
+    printf("               Jitter buffer calc | calculated: %u, delay_at_percentile: %9s, expansions: %u, compressions: %u\n",
+        streamStats._calculatedJitterBufferFrames,
+        formatUsecTime(streamStats._packetDelayAtPercentile).toLatin1().data(),
+        streamStats._timeStretchExpansions,
+        streamStats._timeStretchCompressions);
+
     printf("  Inter-packet timegaps (overall) | min: %9s, max: %9s, avg: %9s\n",
         formatUsecTime(streamStats._timeGapMin).toLatin1().data(),
         formatUsecTime(streamStats._timeGapMax).toLatin1().data(),
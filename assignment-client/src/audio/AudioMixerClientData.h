@@ -13,6 +13,7 @@
 #define hifi_AudioMixerClientData_h
 
 #include <AABox.h>
+#include <AudioCodec.h>
 #include <AudioFormat.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
@@ -53,7 +54,14 @@ public:
     void incrementOutgoingMixedAudioSequenceNumber() { _outgoingMixedAudioSequenceNumber++; }
     quint16 getOutgoingSequenceNumber() const { return _outgoingMixedAudioSequenceNumber; }
 
+    /// the mix is sent back with the same codec as the node's microphone audio
+    AudioCodec::Type getOutgoingMixCodec() const;
+    AudioCodec& getOutgoingMixEncoder() { return _outgoingMixEncoder; }
+
     void printUpstreamDownstreamStats() const;
+    
+    /// the fraction of our mixes the node reported losing between its last two stats packets
+    float getDownstreamLossRate() const { return _downstreamLossRate; }
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
 private:
@@ -66,8 +74,10 @@ private:
     QHash<QUuid, PerListenerSourcePairData*> _listenerSourcePairData;
 
     quint16 _outgoingMixedAudioSequenceNumber;
+    AudioCodec _outgoingMixEncoder;
 
     AudioStreamStats _downstreamAudioStreamStats;
+    float _downstreamLossRate;
 };
 
 #endif // hifi_AudioMixerClientData_h
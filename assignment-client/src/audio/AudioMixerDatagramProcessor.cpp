@@ -18,30 +18,25 @@
 
 AudioMixerDatagramProcessor::AudioMixerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread) :
     _nodeSocket(nodeSocket),
+    _batchedNodeSocket(nodeSocket),
     _previousNodeSocketThread(previousNodeSocketThread)
 {
     
 }
 
 AudioMixerDatagramProcessor::~AudioMixerDatagramProcessor() {    
-    // return the node socket to its previous thread
-    _nodeSocket.moveToThread(_previousNodeSocketThread);
+    // return the node socket to its previous thread, unless it's one of our own
+    if (_previousNodeSocketThread) {
+        _nodeSocket.moveToThread(_previousNodeSocketThread);
+    }
 }
 
 void AudioMixerDatagramProcessor::readPendingDatagrams() {
-    
-    HifiSockAddr senderSockAddr;
-    static QByteArray incomingPacket;
-    
-    // read everything that is available
-    while (_nodeSocket.hasPendingDatagrams()) {
-        incomingPacket.resize(_nodeSocket.pendingDatagramSize());
-        
-        // just get this packet off the stack
-        _nodeSocket.readDatagram(incomingPacket.data(), incomingPacket.size(),
-                                  senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
-        
-        // emit the signal to tell AudioMixer it needs to process a packet
-        emit packetRequiresProcessing(incomingPacket, senderSockAddr);
+    // read everything that is available, a batch at a time
+    for (int numRead = _batchedNodeSocket.read(); numRead > 0; numRead = _batchedNodeSocket.read()) {
+        for (int i = 0; i < numRead; i++) {
+            // emit the signal to tell AudioMixer it needs to process a packet
+            emit packetRequiresProcessing(_batchedNodeSocket.getDatagram(i), _batchedNodeSocket.getSenderSockAddr(i));
+        }
     }
 }
@@ -15,6 +15,8 @@
 #include <qobject.h>
 #include <qudpsocket.h>
 
+#include <BatchedDatagramSocket.h>
+
 class AudioMixerDatagramProcessor : public QObject {
     Q_OBJECT
 public:
@@ -26,6 +28,7 @@ signals:
     void packetRequiresProcessing(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
 private:
     QUdpSocket& _nodeSocket;
+    BatchedDatagramSocket _batchedNodeSocket;
     QThread* _previousNodeSocketThread;
 };
 
@@ -0,0 +1,38 @@
+//
+//  AudioMixerWorker.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include "AudioMixerWorker.h"
+
+AudioMixerWorker::AudioMixerWorker(AudioMixer* mixer) :
+    _mixer(mixer),
+    _firstCluster(0),
+    _stride(1)
+{
+    // workers are re-used every frame, the AudioMixer owns them
+    setAutoDelete(false);
+}
+
+void AudioMixerWorker::run() {
+    _mixer->mixListeners(*this, _firstCluster, _stride);
+}
+
+void AudioMixerWorker::clearMixAccumulator() {
+    memset(_mixAccumulator, 0, sizeof(_mixAccumulator));
+}
+
+void AudioMixerWorker::saveSharedMix() {
+    memcpy(_sharedMixAccumulator, _mixAccumulator, sizeof(_mixAccumulator));
+}
+
+void AudioMixerWorker::restoreSharedMix() {
+    memcpy(_mixAccumulator, _sharedMixAccumulator, sizeof(_mixAccumulator));
+}
@@ -0,0 +1,63 @@
+//
+//  AudioMixerWorker.h
+//  assignment-client/src/audio
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerWorker_h
+#define hifi_AudioMixerWorker_h
+
+#include <QtCore/QRunnable>
+
+#include "AudioMixer.h"
+
+/// Mixes a strided subset of the current frame's listener clusters. Each worker owns its scratch buffers so that several
+/// workers can mix in parallel without sharing state.
+class AudioMixerWorker : public QRunnable {
+public:
+    AudioMixerWorker(AudioMixer* mixer);
+    
+    /// this worker will mix listener clusters firstCluster, firstCluster + stride, firstCluster + 2 * stride, ...
+    void setListeners(int firstCluster, int stride) { _firstCluster = firstCluster; _stride = stride; }
+    
+    void run();
+    
+    int16_t* getPreMixSamples() { return _preMixSamples; }
+    int16_t* getStreamSamples() { return _streamSamples; }
+    int32_t* getMixAccumulator() { return _mixAccumulator; }
+    
+    /// zeroes the mix accumulator before mixing for a new listener
+    void clearMixAccumulator();
+    
+    /// keeps a copy of the mix accumulator, the mix shared by a cluster's listeners, so each can start from it
+    void saveSharedMix();
+    void restoreSharedMix();
+    
+    /// for the listener being mixed, which of the frame's distant mix beds are heard instead of their sources
+    QVector<bool>& getUsedDistantMixBeds() { return _usedDistantMixBeds; }
+    
+private:
+    AudioMixer* _mixer;
+    int _firstCluster;
+    int _stride;
+    
+    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
+    // data from a phase delay as well as an entire network buffer
+    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    
+    // a contiguous copy of the stream's popped frame (and the historical samples for a phase delay)
+    // so the mix kernels don't have to deal with the ring buffer wrapping
+    int16_t _streamSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + SAMPLE_PHASE_DELAY_AT_90];
+    
+    // streams are summed here without clamping, the sum is saturated once per listener when the mix is finalized
+    int32_t _mixAccumulator[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int32_t _sharedMixAccumulator[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    
+    QVector<bool> _usedDistantMixBeds;
+};
+
+#endif // hifi_AudioMixerWorker_h
@@ -0,0 +1,75 @@
+//
+//  AudioSourceGrid.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include "AudioSourceGrid.h"
+
+// a source whose audible radius covers more cells than this is checked by every listener instead
+const int MAX_CELLS_PER_SOURCE = 256;
+
+// cell coordinates are offset so that they pack into the key as unsigned values
+const int CELL_COORDINATE_OFFSET = 1 << 30;
+
+AudioSourceGrid::AudioSourceGrid(float cellSize) :
+    _cellSize(cellSize)
+{
+    
+}
+
+void AudioSourceGrid::clear() {
+    _cellEntries.resize(0);
+    _unboundedSources.resize(0);
+}
+
+int AudioSourceGrid::cellCoordinate(float position) const {
+    float cellCoordinate = floorf(position / _cellSize);
+    
+    // converting a NaN or anything out of int range is undefined, those go to the cells at the edge of the grid
+    if (!(cellCoordinate > -CELL_COORDINATE_OFFSET)) {
+        return -CELL_COORDINATE_OFFSET;
+    }
+    if (cellCoordinate >= CELL_COORDINATE_OFFSET) {
+        return CELL_COORDINATE_OFFSET - 1;
+    }
+    return (int)cellCoordinate;
+}
+
+quint64 AudioSourceGrid::keyForCell(int cellX, int cellZ) {
+    return ((quint64)(quint32)(cellX + CELL_COORDINATE_OFFSET) << 32) | (quint32)(cellZ + CELL_COORDINATE_OFFSET);
+}
+
+void AudioSourceGrid::addSource(int sourceIndex, const glm::vec3& position, float audibleRadius) {
+    if (audibleRadius < 0.0f || audibleRadius / _cellSize > MAX_CELLS_PER_SOURCE) {
+        _unboundedSources.append(sourceIndex);
+        return;
+    }
+    
+    int minX = cellCoordinate(position.x - audibleRadius);
+    int maxX = cellCoordinate(position.x + audibleRadius);
+    int minZ = cellCoordinate(position.z - audibleRadius);
+    int maxZ = cellCoordinate(position.z + audibleRadius);
+    
+    if ((maxX - minX + 1) * (maxZ - minZ + 1) > MAX_CELLS_PER_SOURCE) {
+        _unboundedSources.append(sourceIndex);
+        return;
+    }
+    
+    for (int x = minX; x <= maxX; ++x) {
+        for (int z = minZ; z <= maxZ; ++z) {
+            CellEntry entry = { keyForCell(x, z), sourceIndex };
+            _cellEntries.append(entry);
+        }
+    }
+}
+
+void AudioSourceGrid::finalize() {
+    std::sort(_cellEntries.begin(), _cellEntries.end());
+}
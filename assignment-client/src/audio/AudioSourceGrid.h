@@ -0,0 +1,73 @@
+//
+//  AudioSourceGrid.h
+//  assignment-client/src/audio
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceGrid_h
+#define hifi_AudioSourceGrid_h
+
+#include <algorithm>
+
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+const float DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE = 16.0f;
+
+/// A uniform grid over the XZ plane that is rebuilt every frame from the sources that have audio to mix.
+/// Each source is entered in every cell its audible radius reaches, so a listener only has to consider the sources
+/// entered in its own cell. Sources audible further than MAX_CELLS_PER_SOURCE allows are considered by every listener.
+class AudioSourceGrid {
+public:
+    AudioSourceGrid(float cellSize = DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE);
+    
+    void clear();
+    
+    /// adds the source with the given index, audibleRadius < 0 means it can be heard at any distance
+    void addSource(int sourceIndex, const glm::vec3& position, float audibleRadius);
+    
+    /// must be called after the last source is added and before the grid is queried
+    void finalize();
+    
+    /// calls functor(sourceIndex) for each source that may be audible at position
+    template<typename SourceIndexLambda>
+    void eachSourceNear(const glm::vec3& position, SourceIndexLambda functor) const;
+    
+private:
+    struct CellEntry {
+        quint64 cellKey;
+        int sourceIndex;
+        
+        bool operator<(const CellEntry& other) const {
+            return cellKey < other.cellKey || (cellKey == other.cellKey && sourceIndex < other.sourceIndex);
+        }
+    };
+    
+    int cellCoordinate(float position) const;
+    static quint64 keyForCell(int cellX, int cellZ);
+    
+    float _cellSize;
+    QVector<CellEntry> _cellEntries; // sorted by cell once finalized
+    QVector<int> _unboundedSources;
+};
+
+template<typename SourceIndexLambda>
+void AudioSourceGrid::eachSourceNear(const glm::vec3& position, SourceIndexLambda functor) const {
+    foreach (int sourceIndex, _unboundedSources) {
+        functor(sourceIndex);
+    }
+    
+    CellEntry firstEntry = { keyForCell(cellCoordinate(position.x), cellCoordinate(position.z)), -1 };
+    QVector<CellEntry>::const_iterator it = std::lower_bound(_cellEntries.constBegin(), _cellEntries.constEnd(), firstEntry);
+    
+    for (; it != _cellEntries.constEnd() && it->cellKey == firstEntry.cellKey; ++it) {
+        functor(it->sourceIndex);
+    }
+}
+
+#endif // hifi_AudioSourceGrid_h
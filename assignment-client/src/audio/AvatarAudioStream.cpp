@@ -38,6 +38,11 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         bool isStereo = channelFlag == 1;
         readBytes += sizeof(quint8);
 
+        // read the codec of the audio data
+        quint8 codec = packetAfterSeqNum.at(readBytes);
+        _incomingCodec = AudioCodec::isValidType(codec) ? (AudioCodec::Type)codec : AudioCodec::PCM;
+        readBytes += sizeof(quint8);
+
         // if isStereo value has changed, restart the ring buffer with new frame size
         if (isStereo != _isStereo) {
             _ringBuffer.resizeForFrameSize(isStereo
@@ -50,8 +55,7 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
 
         // calculate how many samples are in this packet
-        int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+        numAudioSamples = numSamplesForAudioPayload(packetAfterSeqNum.mid(readBytes));
     }
     
     return readBytes;
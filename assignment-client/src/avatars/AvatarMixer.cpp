@@ -9,19 +9,27 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <float.h>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
 
+#include <glm/glm.hpp>
+
+#include <GLMHelpers.h>
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
+#include <PerfStat.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 
 #include "AvatarMixerClientData.h"
+#include "AvatarMixerWorker.h"
 
 #include "AvatarMixer.h"
 
@@ -32,21 +40,43 @@ const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / 60.0f) * 1000;
 AvatarMixer::AvatarMixer(const QByteArray& packet) :
     ThreadedAssignment(packet),
     _broadcastThread(),
+    _broadcastFrame(0),
     _lastFrameTimestamp(QDateTime::currentMSecsSinceEpoch()),
     _trailingSleepRatio(1.0f),
     _performanceThrottlingRatio(0.0f),
-    _sumListeners(0),
-    _numStatFrames(0),
-    _sumBillboardPackets(0),
-    _sumIdentityPackets(0)
+    _framesStatID(_stats.registerCounter("frames")),
+    _listenersStatID(_stats.registerCounter("listeners")),
+    _avatarUpdatesStatID(_stats.registerCounter("avatar_updates")),
+    _billboardPacketsStatID(_stats.registerCounter("billboard_packets")),
+    _identityPacketsStatID(_stats.registerCounter("identity_packets"))
 {
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
+    
+    // building the packets for each listener is independent of the others, so spread it across the cores
+    setupBroadcastWorkers(QThread::idealThreadCount());
 }
 
 AvatarMixer::~AvatarMixer() {
     _broadcastThread.quit();
     _broadcastThread.wait();
+    
+    _broadcastThreadPool.waitForDone();
+    qDeleteAll(_broadcastWorkers);
+}
+
+void AvatarMixer::setupBroadcastWorkers(int numBroadcastThreads) {
+    numBroadcastThreads = qMax(numBroadcastThreads, 1);
+    
+    for (int i = 0; i < numBroadcastThreads; ++i) {
+        _broadcastWorkers.append(new AvatarMixerWorker(this, i));
+    }
+    
+    // the broadcast thread runs the first worker itself, so the pool only needs threads for the rest
+    _broadcastThreadPool.setMaxThreadCount(qMax(numBroadcastThreads - 1, 1));
+    
+    // keep the pool threads around between frames instead of respawning them
+    _broadcastThreadPool.setExpiryTimeout(-1);
 }
 
 void attachAvatarDataToNode(Node* newNode) {
@@ -57,14 +87,14 @@ void attachAvatarDataToNode(Node* newNode) {
 
 const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 300.0f;
 
-// NOTE: some additional optimizations to consider.
-//    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
-//       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    PERFORMANCE_TIMER("broadcastAvatarData");
+    
+    ++_broadcastFrame;
     
     int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
     
-    ++_numStatFrames;
+    _stats.add(_framesStatID);
     
     const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
     const float BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.20f;
@@ -113,105 +143,245 @@ void AvatarMixer::broadcastAvatarData() {
         ++framesSinceCutoffEvent;
     }
     
-    static QByteArray mixedAvatarByteArray;
+    auto nodeList = DependencyManager::get<NodeList>();
     
-    int numPacketHeaderBytes = populatePacketHeader(mixedAvatarByteArray, PacketTypeBulkAvatarData);
+    // the node list is only read locked once, for the copy, everything after works from _frameAvatars
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        addNodeToFrame(node);
+    });
     
-    auto nodeList = DependencyManager::get<NodeList>();
+    // a worker per few listeners at most, below that the hand off costs more than it saves
+    const int MIN_LISTENERS_PER_WORKER = 8;
+    int numWorkers = qMax(qMin(_broadcastWorkers.size(), _frameListeners.size() / MIN_LISTENERS_PER_WORKER), 1);
     
-    AvatarMixerClientData* nodeData = NULL;
-    AvatarMixerClientData* otherNodeData = NULL;
+    // hand out the listeners round-robin, the ones that joined around the same time end up on different workers
+    for (int i = 1; i < numWorkers; ++i) {
+        _broadcastWorkers[i]->setListeners(i, numWorkers);
+        _broadcastThreadPool.start(_broadcastWorkers[i]);
+    }
     
-    nodeList->eachNode([&](const SharedNodePointer& node) {
-        if (node->getLinkedData() && node->getType() == NodeType::Agent && node->getActiveSocket()
-            && (nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData()))->getMutex().tryLock()) {
-            ++_sumListeners;
-            
-            // reset packet pointers for this node
-            mixedAvatarByteArray.resize(numPacketHeaderBytes);
-            
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getPosition();
-            
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachNode([&](const SharedNodePointer& otherNode) {
-                if (otherNode->getLinkedData() && otherNode->getUUID() != node->getUUID()
-                    && (otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData()))->getMutex().tryLock()) {
-                    
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
-            
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at a distance of twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    const float FULL_RATE_DISTANCE = 2.0f;
-                    
-                    //  Decide whether to send this avatar's data based on it's distance from us
-                    if ((_performanceThrottlingRatio == 0 || randFloat() < (1.0f - _performanceThrottlingRatio))
-                        && (distanceToAvatar == 0.0f || randFloat() < FULL_RATE_DISTANCE / distanceToAvatar)) {
-                        QByteArray avatarByteArray;
-                        avatarByteArray.append(otherNode->getUUID().toRfc4122());
-                        avatarByteArray.append(otherAvatar.toByteArray());
-                        
-                        if (avatarByteArray.size() + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
-                            nodeList->writeDatagram(mixedAvatarByteArray, node);
-                            
-                            // reset the packet
-                            mixedAvatarByteArray.resize(numPacketHeaderBytes);
-                        }
-                        
-                        // copy the avatar into the mixedAvatarByteArray packet
-                        mixedAvatarByteArray.append(avatarByteArray);
-                        
-                        // if the receiving avatar has just connected make sure we send out the mesh and billboard
-                        // for this avatar (assuming they exist)
-                        bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
-                        
-                        // we will also force a send of billboard or identity packet
-                        // if either has changed in the last frame
-                        
-                        if (otherNodeData->getBillboardChangeTimestamp() > 0
-                            && (forceSend
-                                || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                                || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                            QByteArray billboardPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
-                            billboardPacket.append(otherNode->getUUID().toRfc4122());
-                            billboardPacket.append(otherNodeData->getAvatar().getBillboard());
-                            nodeList->writeDatagram(billboardPacket, node);
-                            
-                            ++_sumBillboardPackets;
-                        }
-                        
-                        if (otherNodeData->getIdentityChangeTimestamp() > 0
-                            && (forceSend
-                                || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                                || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                                
-                            QByteArray identityPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
-                            
-                            QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
-                            individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
-                            identityPacket.append(individualData);
-                            
-                            nodeList->writeDatagram(identityPacket, node);
-                                
-                            ++_sumIdentityPackets;
-                        }
-                    }
-                
-                    otherNodeData->getMutex().unlock();
-                }
-            });
+    // the broadcast thread builds its share too, instead of sitting idle until the pool is done
+    _broadcastWorkers[0]->setListeners(0, numWorkers);
+    _broadcastWorkers[0]->run();
+    
+    _broadcastThreadPool.waitForDone();
+    
+    // packets are sent from the broadcast thread only, the node socket is not safe to share between the workers
+    for (int i = 0; i < numWorkers; ++i) {
+        _broadcastWorkers[i]->sendQueuedPackets();
+    }
+    
+    _stats.add(_listenersStatID, _frameListeners.size());
+    
+    // don't hold on to nodes that may be killed before the next frame
+    _frameAvatars.resize(0);
+    _frameListeners.resize(0);
+    
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+void AvatarMixer::addNodeToFrame(const SharedNodePointer& node) {
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+    
+    // a node whose data is being parsed right now sits this frame out, as a listener and as an avatar
+    if (!nodeData || !nodeData->getMutex().tryLock()) {
+        return;
+    }
+    
+    _frameAvatars.resize(_frameAvatars.size() + 1);
+    AvatarFrameData& frameAvatar = _frameAvatars.last();
+    
+    if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+        _frameListeners.append(_frameAvatars.size() - 1);
+        
+        // checked and set here under the lock, this frame's broadcast to it is its first if this is the first time
+        frameAvatar.hasReceivedFirstPackets = nodeData->checkAndSetHasReceivedFirstPackets();
+    } else {
+        frameAvatar.hasReceivedFirstPackets = true;
+    }
+    
+    AvatarData& avatar = nodeData->getAvatar();
+    
+    frameAvatar.node = node;
+    frameAvatar.nodeData = nodeData;
+    frameAvatar.position = avatar.getPosition();
+    frameAvatar.viewDirection = avatar.getHeadOrientation() * IDENTITY_FRONT;
+    
+    // serialized once here rather than once for every listener it is sent to
+    QByteArray uuidByteArray = node->getUUID().toRfc4122();
+    bool wholeReferential = avatar.shouldSendWholeReferential();
+    frameAvatar.avatarByteArray = uuidByteArray;
+    frameAvatar.avatarByteArray.append(avatar.stateToByteArray(true, wholeReferential));
+    
+    if (avatar.hasFaceData()) {
+        frameAvatar.reducedAvatarByteArray = uuidByteArray;
+        frameAvatar.reducedAvatarByteArray.append(avatar.stateToByteArray(false, wholeReferential));
+    } else {
+        // there is no face data to leave out, share the one copy
+        frameAvatar.reducedAvatarByteArray = frameAvatar.avatarByteArray;
+    }
+    frameAvatar.jointData = avatar.getJointData();
+    
+    // these packets are kept by the node's data between frames and only rebuilt when they change
+    frameAvatar.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+    frameAvatar.billboardPacket = (frameAvatar.billboardChangeTimestamp > 0)
+        ? nodeData->getBillboardPacket(node->getUUID()) : QByteArray();
+    
+    frameAvatar.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+    frameAvatar.identityPacket = (frameAvatar.identityChangeTimestamp > 0)
+        ? nodeData->getIdentityPacket(node->getUUID()) : QByteArray();
+    
+    nodeData->getMutex().unlock();
+}
+
+void AvatarMixer::broadcastToListeners(AvatarMixerWorker& worker, int firstListener, int stride) {
+    PERFORMANCE_TIMER("broadcastToListeners");
+    for (int i = firstListener; i < _frameListeners.size(); i += stride) {
+        broadcastToListener(worker, _frameListeners[i]);
+    }
+}
+
+//  The full rate distance is the distance within which EVERY update will be sent for an avatar the listener is facing
+const float FULL_RATE_DISTANCE = 2.0f;
+
+// avatars within this angle of where the listener's head faces may be on screen, the rest are only heard
+const float MIN_IN_VIEW_COSINE = 0.5f; // 60 degrees
+
+// an avatar out of view needs updating this much less often than one in view at the same distance
+const float OUT_OF_VIEW_PRIORITY_RATIO = 0.2f;
+
+// past this distance a face is too small to make out, so the blendshapes are not worth their bytes
+const float FACE_DATA_DISTANCE = 10.0f;
+
+// avatar data sent to each listener, the avatars that don't fit in a frame wait for a later one
+const int AVATAR_DATA_BYTES_PER_SECOND_PER_LISTENER = 5 * 1000 * 1000 / BITS_IN_BYTE;
+
+const quint64 STALE_BROADCAST_FRAMES = 10 * 60;
+
+// a listener is sent all of an avatar's joints at least this often, in case an update with some of them was lost
+const quint64 JOINT_KEYFRAME_FRAMES = 60;
+
+static bool hasHigherPriority(const AvatarMixerWorker::AvatarPriority& a, const AvatarMixerWorker::AvatarPriority& b) {
+    return a.priority > b.priority;
+}
+
+void AvatarMixer::broadcastToListener(AvatarMixerWorker& worker, int avatarIndex) {
+    const AvatarFrameData& listener = _frameAvatars[avatarIndex];
+    const SharedNodePointer& node = listener.node;
+    
+    // each listener is only handled by one worker, so this is the only thread touching its data
+    AvatarMixerClientData* nodeData = listener.nodeData;
+    
+    if (_broadcastFrame % STALE_BROADCAST_FRAMES == 0) {
+        nodeData->removeStaleSentAvatarStates(_broadcastFrame - STALE_BROADCAST_FRAMES);
+    }
+    
+    // rank the other avatars by how close and how visible they are, and by how long the listener has been waiting
+    QVector<AvatarMixerWorker::AvatarPriority>& priorities = worker.getAvatarPriorities();
+    priorities.resize(0);
+    
+    for (int i = 0; i < _frameAvatars.size(); i++) {
+        if (i == avatarIndex) {
+            continue;
+        }
+        
+        const AvatarFrameData& otherAvatar = _frameAvatars[i];
+        glm::vec3 offset = otherAvatar.position - listener.position;
+        float distanceToAvatar = glm::length(offset);
+        bool isInView = distanceToAvatar == 0.0f
+            || glm::dot(listener.viewDirection, offset / distanceToAvatar) >= MIN_IN_VIEW_COSINE;
+        
+        AvatarMixerWorker::AvatarPriority priority;
+        priority.avatarIndex = i;
+        priority.distance = distanceToAvatar;
+        priority.isInView = isInView;
+        
+        if (isInView && distanceToAvatar <= FULL_RATE_DISTANCE) {
+            // sent every frame, whatever the budget
+            priority.priority = FLT_MAX;
+        } else {
+            float framesWaiting = _broadcastFrame - nodeData->getLastBroadcastFrame(otherAvatar.node->getUUID());
+            priority.priority = framesWaiting * (isInView ? 1.0f : OUT_OF_VIEW_PRIORITY_RATIO)
+                * FULL_RATE_DISTANCE / glm::max(distanceToAvatar, FULL_RATE_DISTANCE);
+        }
+        priorities.append(priority);
+    }
+    
+    std::sort(priorities.begin(), priorities.end(), hasHigherPriority);
+    
+    // a struggling mixer sends less to everyone rather than dropping avatars at random
+    int frameBudget = (int)(AVATAR_DATA_BYTES_PER_SECOND_PER_LISTENER * (1.0f - _performanceThrottlingRatio)
+                            * AVATAR_DATA_SEND_INTERVAL_MSECS / MSECS_PER_SECOND);
+    int bytesSent = 0;
+    
+    QByteArray& mixedAvatarByteArray = worker.getBulkAvatarPacket();
+    QByteArray& jointDataBuffer = worker.getJointDataBuffer();
+    
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    for (int i = 0; i < priorities.size(); i++) {
+        const AvatarFrameData& otherAvatar = _frameAvatars[priorities[i].avatarIndex];
+        
+        const QByteArray& avatarByteArray = (priorities[i].isInView && priorities[i].distance <= FACE_DATA_DISTANCE)
+            ? otherAvatar.avatarByteArray : otherAvatar.reducedAvatarByteArray;
+        
+        // the joints only carry what has moved since this listener was last sent them
+        AvatarMixerClientData::SentAvatarState& sentState = nodeData->getSentAvatarState(otherAvatar.node->getUUID());
+        bool sendAllJoints = _broadcastFrame - sentState.jointKeyframe >= JOINT_KEYFRAME_FRAMES;
+        
+        jointDataBuffer.resize(AvatarData::maxJointDataSize(otherAvatar.jointData.size()));
+        int jointDataSize = AvatarData::packJointData(reinterpret_cast<unsigned char*>(jointDataBuffer.data()),
+                                                      otherAvatar.jointData, sentState.jointData, sendAllJoints);
+        
+        int updateSize = avatarByteArray.size() + jointDataSize;
+        if (bytesSent + updateSize > frameBudget && priorities[i].priority != FLT_MAX) {
+            // everything from here on is less urgent, it will have climbed the ranking by the next frame
+            break;
+        }
+        bytesSent += updateSize;
+        
+        AvatarData::updateSentJointData(otherAvatar.jointData, sentState.jointData, sendAllJoints);
+        sentState.frame = _broadcastFrame;
+        if (sendAllJoints) {
+            sentState.jointKeyframe = _broadcastFrame;
+        }
+        _stats.add(_avatarUpdatesStatID);
+        
+        if (updateSize + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
+            worker.queueBulkAvatarPacket(node);
+        }
+        
+        // copy the avatar into the mixedAvatarByteArray packet
+        mixedAvatarByteArray.append(avatarByteArray);
+        mixedAvatarByteArray.append(jointDataBuffer.constData(), jointDataSize);
+        
+        // if the receiving avatar has just connected make sure we send out the mesh and billboard
+        // for this avatar (assuming they exist)
+        bool forceSend = !listener.hasReceivedFirstPackets;
+        
+        // we will also force a send of billboard or identity packet
+        // if either has changed in the last frame
+        
+        if (otherAvatar.billboardChangeTimestamp > 0
+            && (forceSend
+                || otherAvatar.billboardChangeTimestamp > _lastFrameTimestamp
+                || worker.randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+            worker.queuePacket(otherAvatar.billboardPacket, node);
             
-            nodeList->writeDatagram(mixedAvatarByteArray, node);
+            _stats.add(_billboardPacketsStatID);
+        }
+        
+        if (otherAvatar.identityChangeTimestamp > 0
+            && (forceSend
+                || otherAvatar.identityChangeTimestamp > _lastFrameTimestamp
+                || worker.randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+            worker.queuePacket(otherAvatar.identityPacket, node);
             
-            nodeData->getMutex().unlock();
+            _stats.add(_identityPacketsStatID);
         }
-    });
+    }
     
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+    worker.queueBulkAvatarPacket(node);
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -235,7 +405,9 @@ void AvatarMixer::readPendingDatagrams() {
     
     while (readAvailableDatagram(receivedPacket, senderSockAddr)) {
         if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
-            switch (packetTypeForPacket(receivedPacket)) {
+            PacketType packetType = packetTypeForPacket(receivedPacket);
+            PacketMetrics::ProcessingTimer processingTimer(nodeList->getPacketMetrics(), packetType);
+            switch (packetType) {
                 case PacketTypeAvatarData: {
                     nodeList->findNodeAndUpdateWithDataFromPacket(receivedPacket);
                     break;
@@ -289,21 +461,31 @@ void AvatarMixer::readPendingDatagrams() {
 }
 
 void AvatarMixer::sendStatsPacket() {
+    // the broadcast thread and the workers add to these as we read them, so they're read once
+    float numStatFrames = _stats.getCount(_framesStatID);
+    quint64 sumListeners = _stats.getCount(_listenersStatID);
+    
     QJsonObject statsObject;
-    statsObject["average_listeners_last_second"] = (float) _sumListeners / (float) _numStatFrames;
+    statsObject["average_listeners_last_second"] = (float) sumListeners / numStatFrames;
+    
+    statsObject["average_billboard_packets_per_frame"] =
+        (float) _stats.getCount(_billboardPacketsStatID) / numStatFrames;
+    statsObject["average_identity_packets_per_frame"] =
+        (float) _stats.getCount(_identityPacketsStatID) / numStatFrames;
     
-    statsObject["average_billboard_packets_per_frame"] = (float) _sumBillboardPackets / (float) _numStatFrames;
-    statsObject["average_identity_packets_per_frame"] = (float) _sumIdentityPackets / (float) _numStatFrames;
+    if (sumListeners > 0) {
+        statsObject["average_avatar_updates_per_listener"] =
+            (float) _stats.getCount(_avatarUpdatesStatID) / (float) sumListeners;
+    } else {
+        statsObject["average_avatar_updates_per_listener"] = 0.0;
+    }
     
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
     
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
     
-    _sumListeners = 0;
-    _sumBillboardPackets = 0;
-    _sumIdentityPackets = 0;
-    _numStatFrames = 0;
+    _stats.reset();
 }
 
 void AvatarMixer::run() {
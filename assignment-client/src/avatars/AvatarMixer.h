@@ -15,13 +15,25 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
 #include <ThreadedAssignment.h>
 
+class AvatarMixerClientData;
+class AvatarMixerWorker;
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
 public:
     AvatarMixer(const QByteArray& packet);
     ~AvatarMixer();
+    
+    /// builds the packets for every stride-th listener of the current frame starting at firstListener,
+    /// called from the broadcast workers
+    void broadcastToListeners(AvatarMixerWorker& worker, int firstListener, int stride);
 public slots:
     /// runs the avatar mixer
     void run();
@@ -34,19 +46,53 @@ public slots:
     void sendStatsPacket();
     
 private:
+    /// what the broadcast needs from a node, copied out once per frame so the workers never lock the node's data
+    struct AvatarFrameData {
+        SharedNodePointer node;
+        AvatarMixerClientData* nodeData;
+        glm::vec3 position;
+        glm::vec3 viewDirection;    // where the avatar's head faces
+        QByteArray avatarByteArray; // the node's UUID followed by its avatar data up to the joints
+        QByteArray reducedAvatarByteArray; // the same without the face data, for listeners too far away to see it
+        QVector<JointData> jointData; // packed for each listener against what that listener was last sent
+        quint64 billboardChangeTimestamp;
+        QByteArray billboardPacket; // only set if the node has sent a billboard
+        quint64 identityChangeTimestamp;
+        QByteArray identityPacket;  // only set if the node has sent an identity
+        bool hasReceivedFirstPackets; // false if the node is a listener that hasn't been broadcast to before
+    };
+    
     void broadcastAvatarData();
     
+    /// copies the node into this frame's avatars, and adds it as a listener if it is an agent we can send to
+    void addNodeToFrame(const SharedNodePointer& node);
+    
+    /// builds the packets one listener gets this frame
+    void broadcastToListener(AvatarMixerWorker& worker, int avatarIndex);
+    
+    void setupBroadcastWorkers(int numBroadcastThreads);
+    
     QThread _broadcastThread;
+    quint64 _broadcastFrame;
+    
+    // gathered once per frame with a single pass over the node list, the indices in _frameAvatars of the listeners
+    QVector<AvatarFrameData> _frameAvatars;
+    QVector<int> _frameListeners;
+    
+    // the first worker always runs on the broadcast thread, the others are run on _broadcastThreadPool
+    QVector<AvatarMixerWorker*> _broadcastWorkers;
+    QThreadPool _broadcastThreadPool;
     
     quint64 _lastFrameTimestamp;
     
     float _trailingSleepRatio;
     float _performanceThrottlingRatio;
     
-    int _sumListeners;
-    int _numStatFrames;
-    int _sumBillboardPackets;
-    int _sumIdentityPackets;
+    int _framesStatID;
+    int _listenersStatID;
+    int _avatarUpdatesStatID;
+    int _billboardPacketsStatID;
+    int _identityPacketsStatID;
 };
 
 #endif // hifi_AvatarMixer_h
@@ -10,6 +10,7 @@
 //
 
 #include <PacketHeaders.h>
+#include <UUID.h>
 
 #include "AvatarMixerClientData.h"
 
@@ -17,7 +18,9 @@ AvatarMixerClientData::AvatarMixerClientData() :
     NodeData(),
     _hasReceivedFirstPackets(false),
     _billboardChangeTimestamp(0),
-    _identityChangeTimestamp(0)
+    _identityChangeTimestamp(0),
+    _billboardPacketTimestamp(0),
+    _identityPacketTimestamp(0)
 {
     
 }
@@ -33,3 +36,43 @@ bool AvatarMixerClientData::checkAndSetHasReceivedFirstPackets() {
     _hasReceivedFirstPackets = true;
     return oldValue;
 }
+
+const QByteArray& AvatarMixerClientData::getBillboardPacket(const QUuid& nodeUUID) {
+    if (_billboardPacketTimestamp != _billboardChangeTimestamp) {
+        _billboardPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
+        _billboardPacket.append(nodeUUID.toRfc4122());
+        _billboardPacket.append(_avatar.getBillboard());
+        
+        _billboardPacketTimestamp = _billboardChangeTimestamp;
+    }
+    return _billboardPacket;
+}
+
+const QByteArray& AvatarMixerClientData::getIdentityPacket(const QUuid& nodeUUID) {
+    if (_identityPacketTimestamp != _identityChangeTimestamp) {
+        _identityPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
+        
+        QByteArray individualData = _avatar.identityByteArray();
+        individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeUUID.toRfc4122());
+        _identityPacket.append(individualData);
+        
+        _identityPacketTimestamp = _identityChangeTimestamp;
+    }
+    return _identityPacket;
+}
+
+quint64 AvatarMixerClientData::getLastBroadcastFrame(const QUuid& avatarUUID) const {
+    QHash<QUuid, SentAvatarState>::const_iterator i = _sentAvatarStates.constFind(avatarUUID);
+    return (i == _sentAvatarStates.constEnd()) ? 0 : i.value().frame;
+}
+
+void AvatarMixerClientData::removeStaleSentAvatarStates(quint64 oldestFrame) {
+    QHash<QUuid, SentAvatarState>::iterator i = _sentAvatarStates.begin();
+    while (i != _sentAvatarStates.end()) {
+        if (i.value().frame < oldestFrame) {
+            i = _sentAvatarStates.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
@@ -12,7 +12,9 @@
 #ifndef hifi_AvatarMixerClientData_h
 #define hifi_AvatarMixerClientData_h
 
+#include <QtCore/QHash>
 #include <QtCore/QUrl>
+#include <QtCore/QUuid>
 
 #include <AvatarData.h>
 #include <NodeData.h>
@@ -33,11 +35,39 @@ public:
     quint64 getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
     void setIdentityChangeTimestamp(quint64 identityChangeTimestamp) { _identityChangeTimestamp = identityChangeTimestamp; }
     
+    /// returns the packets that carry this avatar's billboard and identity to the other nodes, they are only
+    /// rebuilt when the billboard or identity has changed since the last call
+    const QByteArray& getBillboardPacket(const QUuid& nodeUUID);
+    const QByteArray& getIdentityPacket(const QUuid& nodeUUID);
+    
+    /// what this listener was last sent of another avatar
+    struct SentAvatarState {
+        SentAvatarState() : frame(0), jointKeyframe(0) { }
+        
+        quint64 frame;          // the broadcast frame of the last update, 0 if it never was sent one
+        quint64 jointKeyframe;  // the broadcast frame in which all of the joints were last sent
+        QVector<JointData> jointData; // the joints as the listener should have them
+    };
+    
+    /// the broadcast frame in which this listener was last sent an update of the avatar, 0 if it never was
+    quint64 getLastBroadcastFrame(const QUuid& avatarUUID) const;
+    SentAvatarState& getSentAvatarState(const QUuid& avatarUUID) { return _sentAvatarStates[avatarUUID]; }
+    
+    /// forgets the avatars that have not been sent since before oldestFrame, most of them will have left
+    void removeStaleSentAvatarStates(quint64 oldestFrame);
+    
 private:
     AvatarData _avatar;
     bool _hasReceivedFirstPackets;
     quint64 _billboardChangeTimestamp;
     quint64 _identityChangeTimestamp;
+    
+    QByteArray _billboardPacket;
+    quint64 _billboardPacketTimestamp;
+    QByteArray _identityPacket;
+    quint64 _identityPacketTimestamp;
+    
+    QHash<QUuid, SentAvatarState> _sentAvatarStates;
 };
 
 #endif // hifi_AvatarMixerClientData_h
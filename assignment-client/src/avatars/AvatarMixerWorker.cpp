@@ -0,0 +1,87 @@
+//
+//  AvatarMixerWorker.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <NodeList.h>
+#include <PacketHeaders.h>
+
+#include "AvatarMixer.h"
+
+#include "AvatarMixerWorker.h"
+
+AvatarMixerWorker::AvatarMixerWorker(AvatarMixer* mixer, int seed) :
+    _mixer(mixer),
+    _firstListener(0),
+    _stride(1),
+    _randomState(2463534242u + seed),
+    _numBulkAvatarPacketHeaderBytes(0),
+    _numQueuedPackets(0)
+{
+    // workers are re-used every frame, the AvatarMixer owns them
+    setAutoDelete(false);
+    
+    _bulkAvatarPacket.reserve(MAX_PACKET_SIZE);
+}
+
+void AvatarMixerWorker::run() {
+    // the header carries our session UUID, which can change between frames
+    _numBulkAvatarPacketHeaderBytes = populatePacketHeader(_bulkAvatarPacket, PacketTypeBulkAvatarData);
+    _bulkAvatarPacket.resize(_numBulkAvatarPacketHeaderBytes);
+    
+    _mixer->broadcastToListeners(*this, _firstListener, _stride);
+}
+
+void AvatarMixerWorker::queueBulkAvatarPacket(const SharedNodePointer& destinationNode) {
+    // copy out just the bytes used, the bulk packet keeps its capacity for the next one
+    queuePacket(_bulkAvatarPacket.constData(), _bulkAvatarPacket.size(), destinationNode);
+    _bulkAvatarPacket.resize(_numBulkAvatarPacketHeaderBytes);
+}
+
+void AvatarMixerWorker::queuePacket(const QByteArray& packet, const SharedNodePointer& destinationNode) {
+    queuePacket(packet.constData(), packet.size(), destinationNode);
+}
+
+void AvatarMixerWorker::queuePacket(const char* data, int size, const SharedNodePointer& destinationNode) {
+    if (_numQueuedPackets == _queuedPackets.size()) {
+        _queuedPackets.resize(_numQueuedPackets + 1);
+        
+        // reserving marks the capacity as wanted, so shrinking the packet later won't give it back
+        _queuedPackets.last().packet.reserve(MAX_PACKET_SIZE);
+    }
+    QueuedPacket& queuedPacket = _queuedPackets[_numQueuedPackets++];
+    queuedPacket.destinationNode = destinationNode;
+    
+    // the copy is ours alone, so the hash can be written into it when it's sent
+    queuedPacket.packet.resize(size);
+    memcpy(queuedPacket.packet.data(), data, size);
+}
+
+void AvatarMixerWorker::sendQueuedPackets() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    
+    for (int i = 0; i < _numQueuedPackets; i++) {
+        // a listener's bulk data, identities and billboards share datagrams where they fit
+        nodeList->bundleDatagram(_queuedPackets[i].packet, _queuedPackets[i].destinationNode);
+        
+        // don't hold on to nodes that may be killed before the next frame
+        _queuedPackets[i].destinationNode.clear();
+    }
+    nodeList->flushBundledDatagrams();
+    _numQueuedPackets = 0;
+}
+
+float AvatarMixerWorker::randFloat() {
+    // xorshift32, plenty for deciding which avatars to send
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    return (_randomState >> 8) / (float)(1 << 24);
+}
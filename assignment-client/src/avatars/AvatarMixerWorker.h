@@ -0,0 +1,83 @@
+//
+//  AvatarMixerWorker.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerWorker_h
+#define hifi_AvatarMixerWorker_h
+
+#include <QtCore/QRunnable>
+#include <QtCore/QVector>
+
+#include <Node.h>
+
+class AvatarMixer;
+
+/// Builds the packets for a strided subset of the current frame's listeners. Each worker owns its packet buffer and
+/// queues what it builds, the packets are sent from the broadcast thread once every worker is done.
+class AvatarMixerWorker : public QRunnable {
+public:
+    AvatarMixerWorker(AvatarMixer* mixer, int seed);
+    
+    /// this worker will build for listeners firstListener, firstListener + stride, firstListener + 2 * stride, ...
+    void setListeners(int firstListener, int stride) { _firstListener = firstListener; _stride = stride; }
+    
+    void run();
+    
+    /// one of the other avatars of the frame, and how much the listener being built for needs an update from it
+    struct AvatarPriority {
+        float priority;
+        int avatarIndex;
+        float distance;
+        bool isInView;
+    };
+    
+    /// scratch space for ordering the other avatars for one listener
+    QVector<AvatarPriority>& getAvatarPriorities() { return _avatarPriorities; }
+    
+    /// scratch space for the joint data of one avatar as it is sent to one listener
+    QByteArray& getJointDataBuffer() { return _jointDataBuffer; }
+    
+    /// the bulk avatar data packet being filled for the current listener, and the size of its header
+    QByteArray& getBulkAvatarPacket() { return _bulkAvatarPacket; }
+    int getNumBulkAvatarPacketHeaderBytes() const { return _numBulkAvatarPacketHeaderBytes; }
+    
+    /// queues a copy of the bulk avatar data packet for the node and resets it to just its header
+    void queueBulkAvatarPacket(const SharedNodePointer& destinationNode);
+    void queuePacket(const QByteArray& packet, const SharedNodePointer& destinationNode);
+    void queuePacket(const char* data, int size, const SharedNodePointer& destinationNode);
+    
+    /// writes the packets queued this frame, must be called from the broadcast thread
+    void sendQueuedPackets();
+    
+    /// the same as randFloat() without sharing the state of rand() with the other workers
+    float randFloat();
+    
+private:
+    struct QueuedPacket {
+        SharedNodePointer destinationNode;
+        QByteArray packet;
+    };
+    
+    AvatarMixer* _mixer;
+    int _firstListener;
+    int _stride;
+    quint32 _randomState;
+    
+    QByteArray _bulkAvatarPacket;
+    int _numBulkAvatarPacketHeaderBytes;
+    
+    // the queued packets keep their buffers from frame to frame, only the first _numQueuedPackets are this frame's
+    QVector<QueuedPacket> _queuedPackets;
+    int _numQueuedPackets;
+    
+    QVector<AvatarPriority> _avatarPriorities;
+    QByteArray _jointDataBuffer;
+};
+
+#endif // hifi_AvatarMixerWorker_h
@@ -53,7 +53,8 @@ AnimationDetails ScriptableAvatar::getAnimationDetails() {
 
 void ScriptableAvatar::update(float deltatime) {
     // Run animation
-    if (_animation != NULL && _animation->isValid() && _animation->getFrames().size() > 0) {
+    AnimationClipPointer clip;
+    if (_animation != NULL && _animation->isValid() && (clip = _animation->getClip()) && clip->getFrameCount() > 0) {
         QStringList modelJoints = getJointNames();
         QStringList animationJoints = _animation->getJointNames();
         
@@ -68,17 +69,13 @@ void ScriptableAvatar::update(float deltatime) {
             }
             _animationDetails.frameIndex = frameIndex;
             
-            const int frameCount = _animation->getFrames().size();
-            const FBXAnimationFrame& floorFrame = _animation->getFrames().at((int)glm::floor(frameIndex) % frameCount);
-            const FBXAnimationFrame& ceilFrame = _animation->getFrames().at((int)glm::ceil(frameIndex) % frameCount);
-            const float frameFraction = glm::fract(frameIndex);
-            
+            _clipCursors.resize(clip->getJointCount());
             for (int i = 0; i < modelJoints.size(); i++) {
                 int mapping = animationJoints.indexOf(modelJoints[i]);
                 if (mapping != -1 && !_maskedJoints.contains(modelJoints[i])) {
                     JointData& data = _jointData[i];
                     data.valid = true;
-                    data.rotation = safeMix(floorFrame.rotations.at(i), ceilFrame.rotations.at(i), frameFraction);
+                    data.rotation = clip->sample(mapping, frameIndex, _clipCursors[mapping]);
                 } else {
                     _jointData[i].valid = false;
                 }
@@ -35,6 +35,7 @@ private:
     AnimationPointer _animation;
     AnimationDetails _animationDetails;
     QStringList _maskedJoints;
+    QVector<int> _clipCursors;
 };
 
 #endif // hifi_ScriptableAvatar_h
\ No newline at end of file
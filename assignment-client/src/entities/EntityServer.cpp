@@ -22,11 +22,15 @@ const char* MODEL_SERVER_LOGGING_TARGET_NAME = "entity-server";
 const char* LOCAL_MODELS_PERSIST_FILE = "resources/models.svo";
 
 EntityServer::EntityServer(const QByteArray& packet) 
-    :   OctreeServer(packet), _entitySimulation(NULL) {
+    :   OctreeServer(packet), _entitySimulation(NULL), _handOffPacketSender(NULL) {
     // nothing special to do here...
 }
 
 EntityServer::~EntityServer() {
+    if (_handOffPacketSender) {
+        _handOffPacketSender->terminate();
+        _handOffPacketSender->deleteLater();
+    }
     EntityTree* tree = (EntityTree*)_tree;
     tree->removeNewlyCreatedHook(this);
 }
@@ -52,6 +56,20 @@ void EntityServer::beforeRun() {
     connect(pruneDeletedEntitiesTimer, SIGNAL(timeout()), this, SLOT(pruneDeletedEntities()));
     const int PRUNE_DELETED_MODELS_INTERVAL_MSECS = 1 * 1000; // once every second
     pruneDeletedEntitiesTimer->start(PRUNE_DELETED_MODELS_INTERVAL_MSECS);
+
+    // if we only own part of the domain, entities that move out of it go to the servers that own where they went
+    if (getJurisdiction()) {
+        static_cast<EntityTree*>(_tree)->setJurisdiction(getJurisdiction());
+
+        _handOffPacketSender = new EntityEditPacketSender();
+        _handOffPacketSender->setServerJurisdictions(getPeerJurisdictions());
+        _handOffPacketSender->initialize(true);
+
+        QTimer* handOffEntitiesTimer = new QTimer(this);
+        connect(handOffEntitiesTimer, SIGNAL(timeout()), this, SLOT(handOffEntities()));
+        const int HAND_OFF_ENTITIES_INTERVAL_MSECS = 100;
+        handOffEntitiesTimer->start(HAND_OFF_ENTITIES_INTERVAL_MSECS);
+    }
 }
 
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
@@ -134,7 +152,8 @@ void EntityServer::pruneDeletedEntities() {
         quint64 earliestLastDeletedEntitiesSent = usecTimestampNow() + 1; // in the future
         
         DependencyManager::get<NodeList>()->eachNode([&earliestLastDeletedEntitiesSent](const SharedNodePointer& node) {
-            if (node->getLinkedData()) {
+            // other entity servers we hand entities off to never query us, so they don't hold up the pruning
+            if (node->getType() == NodeType::Agent && node->getLinkedData()) {
                 EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
                 quint64 nodeLastDeletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
                 if (nodeLastDeletedEntitiesSentAt < earliestLastDeletedEntitiesSent) {
@@ -147,3 +166,43 @@ void EntityServer::pruneDeletedEntities() {
     }
 }
 
+void EntityServer::handOffEntities() {
+    EntityTree* tree = static_cast<EntityTree*>(_tree);
+    NodeToJurisdictionMap* peerJurisdictions = getPeerJurisdictions();
+    if (!peerJurisdictions || !_handOffPacketSender->serversExist()) {
+        return;
+    }
+
+    tree->lockForWrite();
+    QVector<EntityItemID> handedOff;
+    foreach (EntityItem* entity, tree->getEntitiesOutsideJurisdiction()) {
+        // an entity nobody owns the new place of stays with us until someone does
+        bool hasOwner = false;
+        glm::vec3 position = entity->getPosition();
+        peerJurisdictions->lockForRead();
+        for (NodeToJurisdictionMapIterator i = peerJurisdictions->begin(); i != peerJurisdictions->end(); i++) {
+            if (i.value().isMyJurisdiction(position) == JurisdictionMap::WITHIN) {
+                hasOwner = true;
+                break;
+            }
+        }
+        peerJurisdictions->unlock();
+        if (!hasOwner) {
+            continue;
+        }
+
+        // the edit carries the entity's position, so the sender routes it to the owner, which adds it with its ID
+        EntityItemProperties properties = entity->getProperties();
+        properties.markAllChanged();
+        _handOffPacketSender->queueEditEntityMessage(PacketTypeEntityAddOrEdit, entity->getEntityItemID(), properties);
+        handedOff.append(entity->getEntityItemID());
+    }
+
+    // deleting them lets our clients know they're gone from here, the new owner's clients will hear from it
+    foreach (const EntityItemID& entityItemID, handedOff) {
+        tree->deleteEntity(entityItemID, true);
+    }
+    tree->unlock();
+
+    _handOffPacketSender->releaseQueuedMessages();
+}
@@ -14,6 +14,7 @@
 
 #include "../octree/OctreeServer.h"
 
+#include "EntityEditPacketSender.h"
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
@@ -39,17 +40,22 @@ public:
     virtual void beforeRun();
     virtual bool hasSpecialPacketToSend(const SharedNodePointer& node);
     virtual int sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent);
+    virtual OctreeEditPacketSender* getPeerEditPacketSender() { return _handOffPacketSender; }
 
     virtual void entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
 public slots:
     void pruneDeletedEntities();
 
+    /// sends the entities that have left our jurisdiction to the servers owning where they went, and deletes them here
+    void handOffEntities();
+
 protected:
     virtual Octree* createTree();
 
 private:
     EntitySimulation* _entitySimulation;
+    EntityEditPacketSender* _handOffPacketSender;
 };
 
 #endif // hifi_EntityServer_h
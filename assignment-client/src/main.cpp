@@ -24,6 +24,11 @@ int main(int argc, char* argv[]) {
     // use the verbose message handler in Logging
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
     
+    const char* logFileString = getCmdOption(argc, (const char**)argv, LOG_FILE_PARAMETER);
+    if (logFileString) {
+        LogHandler::getInstance().setOutputFile(logFileString);
+    }
+    
     const char* numForksString = getCmdOption(argc, (const char**)argv, NUM_FORKS_PARAMETER);
     
     int numForks = 0;
@@ -32,8 +37,13 @@ int main(int argc, char* argv[]) {
         numForks = atoi(numForksString);
     }
     
+    // by default the monitor keeps one spare started up, to take over from a child that dies
+    const int DEFAULT_NUM_SPARES = 1;
+    const char* numSparesString = getCmdOption(argc, (const char**)argv, NUM_SPARES_PARAMETER);
+    int numSpares = numSparesString ? atoi(numSparesString) : DEFAULT_NUM_SPARES;
+    
     if (numForks) {
-        AssignmentClientMonitor monitor(argc, argv, numForks);
+        AssignmentClientMonitor monitor(argc, argv, numForks, numSpares);
         return monitor.exec();
     } else {
         AssignmentClient client(argc, argv);
@@ -13,10 +13,12 @@
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QJsonObject>
 #include <QSaveFile>
 #include <QThread>
 
 #include <PacketHeaders.h>
+#include <SlabAllocator.h>
 
 #include <MetavoxelMessages.h>
 #include <MetavoxelUtil.h>
@@ -55,6 +57,14 @@ void MetavoxelServer::setData(const MetavoxelData& data, bool loaded) {
     }
 }
 
+void MetavoxelServer::addLoadedData(const MetavoxelData& data) {
+    // edits to the roots not yet loaded still need saving
+    _savedData.replaceRoots(data);
+    MetavoxelData merged = _data;
+    merged.replaceRoots(data);
+    emit dataChanged(_data = merged);
+}
+
 const QString METAVOXEL_SERVER_LOGGING_NAME = "metavoxel-server";
 
 void MetavoxelServer::run() {
@@ -105,7 +115,9 @@ void MetavoxelServer::readPendingDatagrams() {
     
     while (readAvailableDatagram(receivedPacket, senderSockAddr)) {
         if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
-            switch (packetTypeForPacket(receivedPacket)) {
+            PacketType packetType = packetTypeForPacket(receivedPacket);
+            PacketMetrics::ProcessingTimer processingTimer(nodeList->getPacketMetrics(), packetType);
+            switch (packetType) {
                 case PacketTypeMetavoxelData:
                     nodeList->findNodeAndUpdateWithDataFromPacket(receivedPacket);
                     break;
@@ -129,6 +141,15 @@ void MetavoxelServer::aboutToFinish() {
     _persister->thread()->wait();
 }
 
+void MetavoxelServer::sendStatsPacket() {
+    QJsonObject statsObject;
+    statsObject["metavoxel_nodes"] = MetavoxelNode::getNodeCount();
+    statsObject["shared_objects"] = SharedObject::getObjectCount();
+    statsObject["slab_memory_bytes"] = (double)SlabAllocator::getSlabMemoryUsage();
+    
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+}
+
 void MetavoxelServer::maybeAttachSession(const SharedNodePointer& node) {
     if (node->getType() == NodeType::Agent) {
         QMutexLocker locker(&node->getMutex());
@@ -170,6 +191,37 @@ MetavoxelSender::MetavoxelSender(MetavoxelServer* server) :
 
 const int SEND_INTERVAL = 50;
 
+// an old entry is dropped for each new one past this
+const int MAX_CACHED_DELTAS = 64;
+
+void MetavoxelSender::writeDelta(const MetavoxelData& reference, const MetavoxelLOD& referenceLOD,
+        Bitstream& out, const MetavoxelLOD& lod) {
+    QSharedPointer<MetavoxelDeltaRecording> recording;
+    foreach (const CachedDelta& cached, _cachedDeltas) {
+        if (cached.reference == reference && cached.referenceLOD == referenceLOD && cached.lod == lod) {
+            recording = cached.recording;
+            break;
+        }
+    }
+    if (!recording) {
+        recording = QSharedPointer<MetavoxelDeltaRecording>(new MetavoxelDeltaRecording(referenceLOD, lod));
+        _data.writeDelta(reference, referenceLOD, recording->getStream(), lod);
+        recording->finish();
+        
+        if (_cachedDeltas.size() == MAX_CACHED_DELTAS) {
+            _cachedDeltas.removeFirst();
+        }
+        CachedDelta cached = { reference, referenceLOD, lod, recording };
+        _cachedDeltas.append(cached);
+    }
+    if (recording->isReplayable()) {
+        out.writeRecording(*recording);
+    } else {
+        // something in the delta depends on the state of the session's stream, so it must be written afresh
+        _data.writeDelta(reference, referenceLOD, out, lod);
+    }
+}
+
 void MetavoxelSender::start() {
     _lastSend = QDateTime::currentMSecsSinceEpoch();
     _sendTimer.start(SEND_INTERVAL);
@@ -194,10 +246,20 @@ void MetavoxelSender::sendDeltas() {
     _sendTimer.start(qMax(0, 2 * SEND_INTERVAL - qMax(elapsed, SEND_INTERVAL)));
 }
 
+void MetavoxelSender::setData(const MetavoxelData& data) {
+    if (_data != data) {
+        _data = data;
+        _cachedDeltas.clear();
+    }
+}
+
 void MetavoxelSender::removeSession(QObject* session) {
     _sessions.remove(static_cast<MetavoxelSession*>(session));
 }
 
+// a full delta for a new client can run to megabytes, so it yields to the main channel's messages
+const float RELIABLE_DELTA_CHANNEL_PRIORITY = 0.25f;
+
 MetavoxelSession::MetavoxelSession(const SharedNodePointer& node, MetavoxelSender* sender) :
     Endpoint(node, new PacketRecord(), NULL),
     _sender(sender),
@@ -224,12 +286,13 @@ void MetavoxelSession::update() {
     int start = _sequencer.getOutputStream().getUnderlying().device()->pos(); 
     out << QVariant::fromValue(MetavoxelDeltaMessage());
     PacketRecord* sendRecord = getLastAcknowledgedSendRecord();
-    _sender->getData().writeDelta(sendRecord->getData(), sendRecord->getLOD(), out, _lod);
+    _sender->writeDelta(sendRecord->getData(), sendRecord->getLOD(), out, _lod);
     out.flush();
     int end = _sequencer.getOutputStream().getUnderlying().device()->pos();
     if (end > _sequencer.getMaxPacketSize()) {
         // we need to send the delta on the reliable channel
         _reliableDeltaChannel = _sequencer.getReliableOutputChannel(RELIABLE_DELTA_CHANNEL_INDEX);
+        _reliableDeltaChannel->setPriority(RELIABLE_DELTA_CHANNEL_PRIORITY);
         _reliableDeltaChannel->startMessage();
         _reliableDeltaChannel->getBuffer().write(_sequencer.getOutgoingPacketData().constData() + start, end - start);
         _reliableDeltaChannel->endMessage();
@@ -308,32 +371,170 @@ MetavoxelPersister::MetavoxelPersister(MetavoxelServer* server) :
     _server(server) {
 }
 
-const char* SAVE_FILE = "/resources/metavoxels.dat";
+const char* SAVE_DIRECTORY = "/resources/metavoxels";
+const char* INDEX_FILE = "index.dat";
+const char* CHUNK_FILE_SUFFIX = ".dat";
+
+// the whole data in one file, as saved before the roots were split up
+const char* WHOLE_SAVE_FILE = "/resources/metavoxels.dat";
 
 const int FILE_MAGIC = 0xDADAFACE;
-const int FILE_VERSION = 4;
+const int WHOLE_FILE_VERSION = 4;
+const int FILE_VERSION = 5;
+
+static QString getChunkPath(const QDir& directory, const QString& name) {
+    return directory.filePath(name + CHUNK_FILE_SUFFIX);
+}
+
+static bool readHeader(Bitstream& in, int expectedVersion, QDebug& debug) {
+    int magic, version;
+    in >> magic;
+    if (magic != FILE_MAGIC) {
+        debug << "wrong file magic: " << magic;
+        return false;
+    }
+    in >> version;
+    if (version != expectedVersion) {
+        debug << "wrong file version: " << version;
+        return false;
+    }
+    return true;
+}
 
 void MetavoxelPersister::load() {
-    QString path = QCoreApplication::applicationDirPath() + SAVE_FILE;
-    QFile file(path);
+    QDir directory(QCoreApplication::applicationDirPath() + SAVE_DIRECTORY);
+    QFile file(directory.filePath(INDEX_FILE));
     if (!file.exists()) {
+        loadWholeFile();
         return;
     }
+    QDebug debug = qDebug() << "Reading index from" << directory.path() << "...";
+    file.open(QIODevice::ReadOnly);
+    QDataStream inStream(&file);
+    Bitstream in(inStream);
+    if (!readHeader(in, FILE_VERSION, debug)) {
+        return;
+    }
+    int chunkCount;
+    in >> chunkCount;
+    for (int i = 0; i < chunkCount; i++) {
+        QString name;
+        in >> name;
+        _chunksToLoad.append(name);
+    }
+    debug << "found" << chunkCount << "chunks.";
+    
+    // the chunks come in one at a time, leaving room for saves in between
+    QMetaObject::invokeMethod(this, "loadNextChunk", Qt::QueuedConnection);
+}
+
+void MetavoxelPersister::save(const MetavoxelData& data) {
+    QDir directory(QCoreApplication::applicationDirPath() + SAVE_DIRECTORY);
+    if (!directory.exists()) {
+        directory.mkpath(".");
+    }
+    QDebug debug = qDebug() << "Writing to" << directory.path() << "...";
+    
+    // roots are copied on write, so a root we saved last time is unchanged if it's still there; a change in size,
+    // though, changes all of them
+    bool sizeChanged = (data.getSize() != _savedData.getSize());
+    QStringList names;
+    int chunksWritten = 0;
+    foreach (const AttributePointer& attribute, data.getAttributes()) {
+        QString name = attribute->getName();
+        names.append(name);
+        
+        // what we have now supersedes anything we were still to load
+        _chunksToLoad.removeOne(name);
+        if (!sizeChanged && data.getRoot(attribute) == _savedData.getRoot(attribute)) {
+            continue;
+        }
+        QSaveFile file(getChunkPath(directory, name));
+        file.open(QIODevice::WriteOnly);
+        QDataStream outStream(&file);
+        Bitstream out(outStream);
+        out << FILE_MAGIC << FILE_VERSION << data.getSize();
+        data.writeRoot(out, attribute);
+        out.flush();
+        file.commit();
+        chunksWritten++;
+    }
+    foreach (const AttributePointer& attribute, _savedData.getAttributes()) {
+        if (!data.getRoot(attribute)) {
+            QFile::remove(getChunkPath(directory, attribute->getName()));
+        }
+    }
+    
+    // the chunks yet to load stay in the index
+    foreach (const QString& name, _chunksToLoad) {
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+    QSaveFile file(directory.filePath(INDEX_FILE));
+    file.open(QIODevice::WriteOnly);
+    QDataStream outStream(&file);
+    Bitstream out(outStream);
+    out << FILE_MAGIC << FILE_VERSION << names.size();
+    foreach (const QString& name, names) {
+        out << name;
+    }
+    out.flush();
+    file.commit();
+    
+    _savedData = data;
+    debug << "done, wrote" << chunksWritten << "of" << names.size() << "chunks.";
+}
+
+void MetavoxelPersister::loadNextChunk() {
+    if (_chunksToLoad.isEmpty()) {
+        return;
+    }
+    QDir directory(QCoreApplication::applicationDirPath() + SAVE_DIRECTORY);
+    QString path = getChunkPath(directory, _chunksToLoad.takeFirst());
     MetavoxelData data;
     {
         QDebug debug = qDebug() << "Reading from" << path << "...";
+        QFile file(path);
         file.open(QIODevice::ReadOnly);
         QDataStream inStream(&file);
         Bitstream in(inStream);
-        int magic, version;
-        in >> magic;
-        if (magic != FILE_MAGIC) {
-            debug << "wrong file magic: " << magic;
-            return;
+        if (readHeader(in, FILE_VERSION, debug)) {
+            try {
+                float size;
+                in >> size;
+                data.setSize(size);
+                data.readRoot(in);
+                
+                _savedData.replaceRoots(data);
+                QMetaObject::invokeMethod(_server, "addLoadedData", Q_ARG(const MetavoxelData&, data));
+                debug << "done.";
+                
+            } catch (const BitstreamException& e) {
+                debug << "failed, " << e.getDescription();
+            }
         }
-        in >> version;
-        if (version != FILE_VERSION) {
-            debug << "wrong file version: " << version;
+    }
+    if (_chunksToLoad.isEmpty()) {
+        _savedData.dumpStats();
+    } else {
+        QMetaObject::invokeMethod(this, "loadNextChunk", Qt::QueuedConnection);
+    }
+}
+
+void MetavoxelPersister::loadWholeFile() {
+    QString path = QCoreApplication::applicationDirPath() + WHOLE_SAVE_FILE;
+    QFile file(path);
+    if (!file.exists()) {
+        return;
+    }
+    MetavoxelData data;
+    {
+        QDebug debug = qDebug() << "Reading from" << path << "...";
+        file.open(QIODevice::ReadOnly);
+        QDataStream inStream(&file);
+        Bitstream in(inStream);
+        if (!readHeader(in, WHOLE_FILE_VERSION, debug)) {
             return;
         }
         try {
@@ -347,20 +548,3 @@ void MetavoxelPersister::load() {
     }
     data.dumpStats();
 }
-
-void MetavoxelPersister::save(const MetavoxelData& data) {
-    QString path = QCoreApplication::applicationDirPath() + SAVE_FILE;
-    QDir directory = QFileInfo(path).dir();
-    if (!directory.exists()) {
-        directory.mkpath(".");
-    }
-    QDebug debug = qDebug() << "Writing to" << path << "...";
-    QSaveFile file(path);
-    file.open(QIODevice::WriteOnly);
-    QDataStream outStream(&file);
-    Bitstream out(outStream);
-    out << FILE_MAGIC << FILE_VERSION << data;
-    out.flush();
-    file.commit();
-    debug << "done.";
-}
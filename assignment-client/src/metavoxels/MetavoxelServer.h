@@ -13,6 +13,8 @@
 #define hifi_MetavoxelServer_h
 
 #include <QList>
+#include <QStringList>
+#include <QSharedPointer>
 #include <QTimer>
 
 #include <ThreadedAssignment.h>
@@ -38,12 +40,20 @@ public:
     
     Q_INVOKABLE void setData(const MetavoxelData& data, bool loaded = false);
 
+    /// Replaces the roots of our data with the loaded ones, which count as saved.
+    Q_INVOKABLE void addLoadedData(const MetavoxelData& data);
+
     virtual void run();
     
     virtual void readPendingDatagrams();
     
     virtual void aboutToFinish();
 
+public slots:
+
+    /// Adds our memory use (node and shared object counts, slab bytes) to the usual stats.
+    virtual void sendStatsPacket();
+
 signals:
 
     void dataChanged(const MetavoxelData& data);
@@ -78,13 +88,18 @@ public:
     
     const MetavoxelData& getData() const { return _data; }
     
+    /// Writes the delta from the reference to our current data.  Sessions that have acknowledged the same state at the
+    /// same LODs share one encoding of the delta, with only their attributes and shared objects written separately.
+    void writeDelta(const MetavoxelData& reference, const MetavoxelLOD& referenceLOD,
+        Bitstream& out, const MetavoxelLOD& lod);
+    
     Q_INVOKABLE void start();
     
     Q_INVOKABLE void addSession(QObject* session);
     
 private slots:
     
-    void setData(const MetavoxelData& data) { _data = data; }
+    void setData(const MetavoxelData& data);
     void sendDeltas();
     void removeSession(QObject* session);
     
@@ -97,6 +112,16 @@ private:
     qint64 _lastSend;
     
     MetavoxelData _data;
+    
+    class CachedDelta {
+    public:
+        MetavoxelData reference;
+        MetavoxelLOD referenceLOD;
+        MetavoxelLOD lod;
+        QSharedPointer<MetavoxelDeltaRecording> recording;
+    };
+    
+    QList<CachedDelta> _cachedDeltas;
 };
 
 /// Contains the state of a single client session.
@@ -138,7 +163,9 @@ private:
     QVariant _reliableDeltaMessage;
 };
 
-/// Handles persistence in a separate thread.
+/// Handles persistence in a separate thread.  Each attribute's root is kept in a file of its own, so that saving
+/// rewrites only the roots that have changed since the last save and loading hands the roots to the server one at a
+/// time.
 class MetavoxelPersister : public QObject {
     Q_OBJECT
 
@@ -149,9 +176,18 @@ public:
     Q_INVOKABLE void load();
     Q_INVOKABLE void save(const MetavoxelData& data);
 
+private slots:
+    
+    void loadNextChunk();
+    
 private:
     
+    void loadWholeFile();
+    
     MetavoxelServer* _server;
+    
+    MetavoxelData _savedData;
+    QStringList _chunksToLoad;
 };
 
 #endif // hifi_MetavoxelServer_h
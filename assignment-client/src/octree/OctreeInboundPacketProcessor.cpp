@@ -20,6 +20,9 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// a busy cycle doesn't hold back every edit until its packets run out, the batch is applied once it gets this large
+const int MAX_PENDING_EDITS = 1000;
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -33,6 +36,12 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
 {
 }
 
+OctreeInboundPacketProcessor::~OctreeInboundPacketProcessor() {
+    foreach (const PendingEdit& pendingEdit, _pendingEdits) {
+        delete pendingEdit.edit;
+    }
+}
+
 void OctreeInboundPacketProcessor::resetStats() {
     _totalTransitTime = 0;
     _totalProcessTime = 0;
@@ -64,6 +73,10 @@ void OctreeInboundPacketProcessor::preProcess() {
 }
 
 void OctreeInboundPacketProcessor::midProcess() {
+    if (_pendingEdits.size() >= MAX_PENDING_EDITS) {
+        applyPendingEdits();
+    }
+
     // check if it's time to send a nack. If yes, do so
     quint64 now = usecTimestampNow();
     if (now - _lastNackTime >= TOO_LONG_SINCE_LAST_NACK) {
@@ -72,6 +85,77 @@ void OctreeInboundPacketProcessor::midProcess() {
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    applyPendingEdits();
+}
+
+void OctreeInboundPacketProcessor::queueDecodedEdit(OctreeDecodedEdit* decodedEdit,
+                                                    const SharedNodePointer& sendingNode) {
+    Octree* tree = _myServer->getOctree();
+    QUuid itemID = tree->getDecodedEditItemID(decodedEdit);
+
+    if (!itemID.isNull()) {
+        QPair<QUuid, QUuid> key(sendingNode ? sendingNode->getUUID() : QUuid(), itemID);
+        QHash<QPair<QUuid, QUuid>, int>::const_iterator earlier = _pendingEditIndexes.constFind(key);
+
+        if (earlier != _pendingEditIndexes.constEnd()) {
+            PendingEdit& earlierEdit = _pendingEdits[earlier.value()];
+            if (tree->decodedEditSupersedes(decodedEdit, earlierEdit.edit)) {
+                tree->releaseDecodedEdit(earlierEdit.edit);
+                earlierEdit.edit = decodedEdit;
+                return;
+            }
+        }
+        _pendingEditIndexes.insert(key, _pendingEdits.size());
+    }
+
+    PendingEdit pendingEdit = { decodedEdit, sendingNode };
+    _pendingEdits.append(pendingEdit);
+}
+
+void OctreeInboundPacketProcessor::applyPendingEdits() {
+    if (_pendingEdits.isEmpty()) {
+        return;
+    }
+
+    Octree* tree = _myServer->getOctree();
+    QHash<QUuid, int> editsBySender;
+
+    quint64 startLock = usecTimestampNow();
+    tree->lockForWrite();
+    quint64 startProcess = usecTimestampNow();
+
+    foreach (const PendingEdit& pendingEdit, _pendingEdits) {
+        if (!_shuttingDown) {
+            tree->applyDecodedEdit(pendingEdit.edit, pendingEdit.sendingNode);
+            editsBySender[pendingEdit.sendingNode ? pendingEdit.sendingNode->getUUID() : QUuid()]++;
+        }
+        tree->releaseDecodedEdit(pendingEdit.edit);
+    }
+
+    tree->unlock();
+    quint64 endProcess = usecTimestampNow();
+
+    quint64 processTime = endProcess - startProcess;
+    quint64 lockWaitTime = startProcess - startLock;
+    _totalProcessTime += processTime;
+    _totalLockWaitTime += lockWaitTime;
+
+    // each sender is charged its share of the batch
+    int editsApplied = _pendingEdits.size();
+    for (QHash<QUuid, int>::const_iterator sender = editsBySender.constBegin(); sender != editsBySender.constEnd();
+         sender++) {
+        NodeToSenderStatsMapIterator stats = _singleSenderStats.find(sender.key());
+        if (stats != _singleSenderStats.end()) {
+            stats.value().trackEditBatch(processTime * sender.value() / editsApplied,
+                                         lockWaitTime * sender.value() / editsApplied);
+        }
+    }
+
+    _pendingEdits.clear();
+    _pendingEditIndexes.clear();
+}
+
 void OctreeInboundPacketProcessor::processPacket(const SharedNodePointer& sendingNode, const QByteArray& packet) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
@@ -140,6 +224,33 @@ void OctreeInboundPacketProcessor::processPacket(const SharedNodePointer& sendin
         
 
         unsigned char* editData = (unsigned char*)&packetData[atByte];
+        Octree* tree = _myServer->getOctree();
+
+        // read as many of the packet's edits as the tree can decode without the lock, they are applied together with
+        // those of the other packets in this processing cycle under a single write lock in applyPendingEdits()
+        int decodedBytes = 0;
+        OctreeDecodedEdit* decodedEdit = NULL;
+        while (atByte < packet.size()
+               && tree->decodeEditPacketData(packetType, editData, packet.size() - atByte, decodedBytes, decodedEdit)) {
+            if (decodedEdit) {
+                queueDecodedEdit(decodedEdit, sendingNode);
+                editsInPacket++;
+            }
+
+            if (decodedBytes <= 0) {
+                // nothing more we can make sense of in this packet
+                atByte = packet.size();
+                break;
+            }
+            editData += decodedBytes;
+            atByte += decodedBytes;
+        }
+
+        if (atByte < packet.size()) {
+            // the rest of the packet is applied as it is read, the batched edits that came before it go first
+            applyPendingEdits();
+        }
+
         while (atByte < packet.size()) {
         
             int maxSize = packet.size() - atByte;
@@ -334,3 +445,8 @@ void SingleSenderStats::trackInboundPacket(unsigned short int incomingSequence,
     _totalElementsInPacket += editsInPacket;
     _totalPackets++;
 }
+
+void SingleSenderStats::trackEditBatch(quint64 processTime, quint64 lockWaitTime) {
+    _totalProcessTime += processTime;
+    _totalLockWaitTime += lockWaitTime;
+}
@@ -14,6 +14,7 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -40,6 +41,9 @@ public:
     void trackInboundPacket(unsigned short int incomingSequence, quint64 transitTime,
         int editsInPacket, quint64 processTime, quint64 lockWaitTime);
 
+    /// adds the time spent on edits that were counted when their packets were tracked but applied later in a batch
+    void trackEditBatch(quint64 processTime, quint64 lockWaitTime);
+
     quint64 _totalTransitTime; 
     quint64 _totalProcessTime;
     quint64 _totalLockWaitTime;
@@ -59,6 +63,7 @@ class OctreeInboundPacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
     OctreeInboundPacketProcessor(OctreeServer* myServer);
+    ~OctreeInboundPacketProcessor();
 
     quint64 getAverageTransitTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalTransitTime / _totalPackets; }
     quint64 getAverageProcessTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalProcessTime / _totalPackets; }
@@ -83,10 +88,23 @@ protected:
     virtual unsigned long getMaxWait() const;
     virtual void preProcess();
     virtual void midProcess();
+    virtual void postProcess();
 
 private:
     int sendNackPackets();
 
+    /// adds a decoded edit to the batch applied at the end of this processing cycle, replacing an earlier edit from the
+    /// same sender to the same item when the tree says the new one supersedes it
+    void queueDecodedEdit(OctreeDecodedEdit* decodedEdit, const SharedNodePointer& sendingNode);
+
+    /// applies the batched edits under a single write lock
+    void applyPendingEdits();
+
+    struct PendingEdit {
+        OctreeDecodedEdit* edit;
+        SharedNodePointer sendingNode;
+    };
+
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime, 
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
@@ -104,5 +122,8 @@ private:
 
     quint64 _lastNackTime;
     bool _shuttingDown;
+
+    QVector<PendingEdit> _pendingEdits;
+    QHash<QPair<QUuid, QUuid>, int> _pendingEditIndexes; // sender and item ID to the item's last edit in _pendingEdits
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
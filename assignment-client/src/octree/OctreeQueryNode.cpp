@@ -14,6 +14,7 @@
 #include "OctreeQueryNode.h"
 #include <cstring>
 #include <cstdio>
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 
 OctreeQueryNode::OctreeQueryNode() :
@@ -33,6 +34,7 @@ OctreeQueryNode::OctreeQueryNode() :
     _viewFrustumJustStoppedChanging(true),
     _currentPacketIsColor(true),
     _currentPacketIsCompressed(false),
+    _currentPacketIsFastCompressed(false),
     _octreeSendThread(NULL),
     _lastClientBoundaryLevelAdjust(0),
     _lastClientOctreeSizeScale(DEFAULT_OCTREE_SIZE_SCALE),
@@ -40,10 +42,13 @@ OctreeQueryNode::OctreeQueryNode() :
     _lodInitialized(false),
     _sequenceNumber(0),
     _lastRootTimestamp(0),
+    _lastSceneHadOccluded(false),
     _myPacketType(PacketTypeUnknown),
     _isShuttingDown(false),
     _sentPacketHistory()
 {
+    // send whatever is biggest on this node's screen first
+    elementBag.setViewFrustum(&_currentViewFrustum);
 }
 
 OctreeQueryNode::~OctreeQueryNode() {
@@ -75,7 +80,6 @@ void OctreeQueryNode::forceNodeShutdown() {
         OctreeSendThread* sendThread = _octreeSendThread;
         _octreeSendThread = NULL;
         sendThread->setIsShuttingDown();
-        sendThread->terminate();
         delete sendThread;
     }
 }
@@ -91,12 +95,14 @@ void OctreeQueryNode::sendThreadFinished() {
     }
 }
 
-void OctreeQueryNode::initializeOctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node) {
-    _octreeSendThread = new OctreeSendThread(myAssignment, node);
+void OctreeQueryNode::initializeOctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node,
+                                                 OctreeSendScheduler* scheduler) {
+    _octreeSendThread = new OctreeSendThread(myAssignment, node, scheduler);
     
-    // we want to be notified when the thread finishes
-    connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
-    _octreeSendThread->initialize(true);
+    // we want to be notified when the thread finishes, that is signaled from one of the scheduler's workers
+    connect(_octreeSendThread, &OctreeSendThread::finished, this, &OctreeQueryNode::sendThreadFinished,
+            Qt::QueuedConnection);
+    scheduler->addSendThread(_octreeSendThread);
 }
 
 bool OctreeQueryNode::packetIsDuplicate() const {
@@ -180,6 +186,7 @@ void OctreeQueryNode::resetOctreePacket() {
     // the clients requested color state.
     _currentPacketIsColor = getWantColor();
     _currentPacketIsCompressed = getWantCompression();
+    _currentPacketIsFastCompressed = getWantsFastCompressedPackets();
     OCTREE_PACKET_FLAGS flags = 0;
     if (_currentPacketIsColor) {
         setAtBit(flags,PACKET_IS_COLOR_BIT);
@@ -187,6 +194,9 @@ void OctreeQueryNode::resetOctreePacket() {
     if (_currentPacketIsCompressed) {
         setAtBit(flags,PACKET_IS_COMPRESSED_BIT);
     }
+    if (_currentPacketIsFastCompressed) {
+        setAtBit(flags,PACKET_IS_FAST_COMPRESSED_BIT);
+    }
 
     _octreePacketAvailableBytes = MAX_PACKET_SIZE;
     int numBytesPacketHeader = populatePacketHeader(reinterpret_cast<char*>(_octreePacket), _myPacketType);
@@ -263,6 +273,7 @@ bool OctreeQueryNode::updateCurrentViewFrustum() {
         _currentViewFrustum = newestViewFrustum;
         _currentViewFrustum.calculate();
         currentViewFrustumChanged = true;
+        elementBag.reprioritize();
     }
 
     // Also check for LOD changes from the client
@@ -369,7 +380,8 @@ void OctreeQueryNode::octreePacketSent() {
 }
 
 void OctreeQueryNode::packetSent(unsigned char* packet, int packetLength) {
-    packetSent(QByteArray((char*)packet, packetLength));
+    _sentPacketHistory.packetSent(_sequenceNumber, (const char*)packet, packetLength);
+    _sequenceNumber++;
 }
 
 void OctreeQueryNode::packetSent(const QByteArray& packet) {
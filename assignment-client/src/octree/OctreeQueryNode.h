@@ -15,17 +15,19 @@
 #include <iostream>
 
 
-#include <CoverageMap.h>
 #include <NodeData.h>
+#include <OcclusionBuffer.h>
 #include <OctreeConstants.h>
 #include <OctreeElementBag.h>
 #include <OctreePacketData.h>
+#include <OctreeSentIndex.h>
 #include <OctreeQuery.h>
 #include <OctreeSceneStats.h>
 #include <ThreadedAssignment.h> // for SharedAssignmentPointer
 #include "SentPacketHistory.h"
 #include <qqueue.h>
 
+class OctreeSendScheduler;
 class OctreeSendThread;
 
 class OctreeQueryNode : public OctreeQuery {
@@ -57,7 +59,8 @@ public:
     void setMaxLevelReached(int maxLevelReached) { _maxLevelReachedInLastSearch = maxLevelReached; }
 
     OctreeElementBag elementBag;
-    CoverageMap map;
+    OcclusionBuffer occlusionBuffer;
+    OctreeSentIndex sentIndex; // the version of each item this node has been sent, across scenes
     OctreeElementExtraEncodeData extraEncodeData;
 
     ViewFrustum& getCurrentViewFrustum() { return _currentViewFrustum; }
@@ -81,21 +84,31 @@ public:
 
     bool getCurrentPacketIsColor() const { return _currentPacketIsColor; }
     bool getCurrentPacketIsCompressed() const { return _currentPacketIsCompressed; }
+    bool getCurrentPacketIsFastCompressed() const { return _currentPacketIsFastCompressed; }
     bool getCurrentPacketFormatMatches() {
-        return (getCurrentPacketIsColor() == getWantColor() && getCurrentPacketIsCompressed() == getWantCompression());
+        return (getCurrentPacketIsColor() == getWantColor() && getCurrentPacketIsCompressed() == getWantCompression()
+                && getCurrentPacketIsFastCompressed() == getWantsFastCompressedPackets());
     }
 
+    /// fast compression only applies to packets that are compressed at all
+    bool getWantsFastCompressedPackets() const { return getWantCompression() && getWantFastCompression(); }
+
     bool hasLodChanged() const { return _lodChanged; }
     
     OctreeSceneStats stats;
     
-    void initializeOctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node);
+    void initializeOctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node,
+                                    OctreeSendScheduler* scheduler);
     bool isOctreeSendThreadInitalized() { return _octreeSendThread; }
     
     void dumpOutOfView();
     
     quint64 getLastRootTimestamp() const { return _lastRootTimestamp; }
     void setLastRootTimestamp(quint64 timestamp) { _lastRootTimestamp = timestamp; }
+
+    /// whether occlusion culling held anything back from the last completed scene
+    bool getLastSceneHadOccluded() const { return _lastSceneHadOccluded; }
+    void setLastSceneHadOccluded(bool lastSceneHadOccluded) { _lastSceneHadOccluded = lastSceneHadOccluded; }
     unsigned int getlastOctreePacketLength() const { return _lastOctreePacketLength; }
     int getDuplicatePacketCount() const { return _duplicatePacketCount; }
     
@@ -140,6 +153,7 @@ private:
     bool _viewFrustumJustStoppedChanging;
     bool _currentPacketIsColor;
     bool _currentPacketIsCompressed;
+    bool _currentPacketIsFastCompressed;
 
     OctreeSendThread* _octreeSendThread;
 
@@ -152,6 +166,7 @@ private:
     OCTREE_PACKET_SEQUENCE _sequenceNumber;
 
     quint64 _lastRootTimestamp;
+    bool _lastSceneHadOccluded;
     
     PacketType _myPacketType;
     bool _isShuttingDown;
@@ -0,0 +1,132 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+#include "OctreeSendScheduler.h"
+
+class OctreeSendWorker : public QRunnable {
+public:
+    OctreeSendWorker(OctreeSendScheduler* scheduler) : _scheduler(scheduler) { }
+
+    void run() { _scheduler->work(); }
+
+private:
+    OctreeSendScheduler* _scheduler;
+};
+
+OctreeSendScheduler::OctreeSendScheduler(int numWorkers) :
+    _numWorkers(std::max(numWorkers, 1)),
+    _isStopping(false)
+{
+    // the workers live as long as the scheduler does, never let the pool expire their threads
+    _pool.setMaxThreadCount(_numWorkers);
+    _pool.setExpiryTimeout(-1);
+
+    for (int i = 0; i < _numWorkers; i++) {
+        _pool.start(new OctreeSendWorker(this));
+    }
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    stop();
+}
+
+void OctreeSendScheduler::addSendThread(OctreeSendThread* sendThread) {
+    QMutexLocker locker(&_mutex);
+    if (!_sendThreads.contains(sendThread)) {
+        _sendThreads.insert(sendThread);
+        queueJob(sendThread, usecTimestampNow());
+    }
+}
+
+void OctreeSendScheduler::removeSendThread(OctreeSendThread* sendThread) {
+    QMutexLocker locker(&_mutex);
+    _sendThreads.remove(sendThread);
+
+    for (size_t i = 0; i < _jobs.size(); i++) {
+        if (_jobs[i].sendThread == sendThread) {
+            _jobs.erase(_jobs.begin() + i);
+            std::make_heap(_jobs.begin(), _jobs.end());
+            break;
+        }
+    }
+
+    // the worker running it won't queue it again once it is out of _sendThreads
+    while (_runningSendThreads.contains(sendThread)) {
+        _jobFinished.wait(&_mutex);
+    }
+}
+
+void OctreeSendScheduler::stop() {
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopping = true;
+        _jobsChanged.wakeAll();
+    }
+    _pool.waitForDone();
+}
+
+void OctreeSendScheduler::queueJob(OctreeSendThread* sendThread, quint64 deadline) {
+    SendJob job = { deadline, sendThread };
+    _jobs.push_back(job);
+    std::push_heap(_jobs.begin(), _jobs.end());
+    _jobsChanged.wakeOne();
+}
+
+void OctreeSendScheduler::work() {
+    const quint64 USECS_PER_MSEC = 1000;
+
+    QMutexLocker locker(&_mutex);
+    while (!_isStopping) {
+        if (_jobs.empty()) {
+            _jobsChanged.wait(&_mutex);
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        if (_jobs.front().deadline > now) {
+            // sleep until the earliest job is due, or until another one is queued ahead of it
+            unsigned long msecsToWait = (_jobs.front().deadline - now + USECS_PER_MSEC - 1) / USECS_PER_MSEC;
+            _jobsChanged.wait(&_mutex, msecsToWait);
+            continue;
+        }
+
+        std::pop_heap(_jobs.begin(), _jobs.end());
+        OctreeSendThread* sendThread = _jobs.back().sendThread;
+        _jobs.pop_back();
+        _runningSendThreads.insert(sendThread);
+
+        locker.unlock();
+        quint64 start = usecTimestampNow();
+        bool keepSending = sendThread->process();
+        if (!keepSending) {
+            // the owner deletes it once told, which waits on us to stop running it below
+            emit sendThread->finished();
+        }
+        locker.relock();
+
+        _runningSendThreads.remove(sendThread);
+        if (keepSending && _sendThreads.contains(sendThread)) {
+            // an interval that overran its budget is due again right away, and goes ahead of the jobs that aren't late
+            queueJob(sendThread, start + OCTREE_SEND_INTERVAL_USECS);
+        } else {
+            _sendThreads.remove(sendThread);
+        }
+        _jobFinished.wakeAll();
+    }
+}
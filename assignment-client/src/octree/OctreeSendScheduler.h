@@ -0,0 +1,70 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+class OctreeSendThread;
+
+/// Runs the send intervals of every connected client on a fixed number of worker threads. Each client's send job is
+/// queued by the time its next interval is due and the workers always take the most overdue job first, so the number
+/// of threads the server uses no longer grows with the number of clients.
+class OctreeSendScheduler {
+public:
+    OctreeSendScheduler(int numWorkers);
+    ~OctreeSendScheduler();
+
+    /// the send thread's first interval runs as soon as a worker is free
+    void addSendThread(OctreeSendThread* sendThread);
+
+    /// blocks while a worker is still running an interval for this send thread, it is never run again afterwards
+    void removeSendThread(OctreeSendThread* sendThread);
+
+    /// stops the workers, the send threads still queued are left alone
+    void stop();
+
+    int getNumWorkers() const { return _numWorkers; }
+
+private:
+    friend class OctreeSendWorker;
+
+    struct SendJob {
+        quint64 deadline;
+        OctreeSendThread* sendThread;
+
+        // std::push_heap keeps the largest element at the front, we want the earliest deadline there
+        bool operator<(const SendJob& other) const { return deadline > other.deadline; }
+    };
+
+    /// the loop run by each of the workers until the scheduler is stopped
+    void work();
+
+    void queueJob(OctreeSendThread* sendThread, quint64 deadline);
+
+    int _numWorkers;
+    QThreadPool _pool;
+
+    QMutex _mutex;
+    QWaitCondition _jobsChanged;
+    QWaitCondition _jobFinished;
+    std::vector<SendJob> _jobs;
+    QSet<OctreeSendThread*> _sendThreads;
+    QSet<OctreeSendThread*> _runningSendThreads;
+    bool _isStopping;
+};
+
+#endif // hifi_OctreeSendScheduler_h
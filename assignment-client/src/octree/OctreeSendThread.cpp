@@ -14,6 +14,7 @@
 #include <PerfStat.h>
 #include <SharedUtil.h>
 
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
@@ -21,9 +22,11 @@
 quint64 startSceneSleepTime = 0;
 quint64 endSceneSleepTime = 0;
 
-OctreeSendThread::OctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node) :
+OctreeSendThread::OctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node,
+                                   OctreeSendScheduler* scheduler) :
     _myAssignment(myAssignment),
     _myServer(static_cast<OctreeServer*>(myAssignment.data())),
+    _scheduler(scheduler),
     _node(node),
     _nodeUUID(node->getUUID()),
     _packetData(),
@@ -49,6 +52,11 @@ OctreeSendThread::~OctreeSendThread() {
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
                                             "- ending sending thread [" << this << "]";
 
+    // waits for a send interval that is still running for us
+    if (_scheduler) {
+        _scheduler->removeSendThread(this);
+    }
+
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
 
@@ -73,8 +81,6 @@ bool OctreeSendThread::process() {
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // don't do any send processing until the initial load of the octree is complete...
     if (_myServer->isInitialLoadComplete()) {
         if (_node) {
@@ -89,31 +95,10 @@ bool OctreeSendThread::process() {
         }
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
-    }
-
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
-        }
-    }
-
-    return isStillRunning();  // keep running till they terminate us
+    // the scheduler queues our next interval OCTREE_SEND_INTERVAL_USECS after this one started
+    return !_isShuttingDown;
 }
 
-quint64 OctreeSendThread::_usleepTime = 0;
-quint64 OctreeSendThread::_usleepCalls = 0;
-
 quint64 OctreeSendThread::_totalBytes = 0;
 quint64 OctreeSendThread::_totalWastedBytes = 0;
 quint64 OctreeSendThread::_totalPackets = 0;
@@ -292,6 +277,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     // calculate max number of packets that can be sent during this interval
     int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxOctreePacketsPerSecond() / INTERVALS_PER_SECOND));
     int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
+    
+    // past the fixed rates, packets go only as fast as the node's congestion controller says the path can take them
+    CongestionController& congestionController = _node->getCongestionController();
 
     int truePacketsSent = 0;
     int trueBytesSent = 0;
@@ -299,6 +287,13 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     bool isFullScene = ((!viewFrustumChanged || !nodeData->getWantDelta()) && nodeData->getViewFrustumJustStoppedChanging()) 
                                 || nodeData->hasLodChanged();
 
+    // something held back as hidden last scene isn't sent as a change once what hid it moves or goes away,
+    // so a change to the tree after a scene that occluded anything means starting over with a full one
+    if (nodeData->getWantOcclusionCulling() && nodeData->getLastSceneHadOccluded()
+            && _myServer->getOctree()->getRoot()->getLastChanged() > nodeData->getLastRootTimestamp()) {
+        isFullScene = true;
+    }
+
     bool somethingToSend = true; // assume we have something
 
     // FOR NOW... node tells us if it wants to receive only view frustum deltas
@@ -323,7 +318,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         if (wantCompression) {
             targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
         }
-        _packetData.changeSettings(wantCompression, targetSize);
+        _packetData.changeSettings(wantCompression, targetSize, nodeData->getWantsFastCompressedPackets());
+        nodeData->sentIndex.discardPending();
     }
 
     const ViewFrustum* lastViewFrustum =  wantDelta ? &nodeData->getLastKnownViewFrustum() : NULL;
@@ -337,13 +333,16 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             if (nodeData->moveShouldDump() || nodeData->hasLodChanged()) {
                 nodeData->dumpOutOfView();
             }
-            nodeData->map.erase();
+            nodeData->occlusionBuffer.erase();
         }
 
+        // changes held back from the last scene have to be looked at again in this one
+        quint64 earliestDeferred = nodeData->sentIndex.takeEarliestDeferred();
+
         if (!viewFrustumChanged && !nodeData->getWantDelta()) {
             // only set our last sent time if we weren't resetting due to frustum change
             quint64 now = usecTimestampNow();
-            nodeData->setLastTimeBagEmpty(now);
+            nodeData->setLastTimeBagEmpty(qMin(now, earliestDeferred));
         }
 
         // track completed scenes and send out the stats packet accordingly
@@ -380,6 +379,13 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         } else {
             nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
         }
+
+        // a full scene encodes everything, so let the tree get what it can of that done in parallel first
+        if (isFullScene) {
+            _myServer->getOctree()->lockForRead();
+            _myServer->getOctree()->prepareFullSceneEncode();
+            _myServer->getOctree()->unlock();
+        }
     }
 
     // If we have something in our elementBag, then turn them into packets and send them out...
@@ -394,7 +400,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         int extraPackingAttempts = 0;
         bool completedScene = false;
         
-        while (somethingToSend && packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
+        while (somethingToSend && packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()
+                && congestionController.canSend(MAX_PACKET_SIZE, usecTimestampNow())) {
             float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
             float encodeElapsedUsec = OctreeServer::SKIP_TIME;
             float compressAndWriteElapsedUsec = OctreeServer::SKIP_TIME;
@@ -435,7 +442,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 */
 
                 bool wantOcclusionCulling = nodeData->getWantOcclusionCulling();
-                CoverageMap* coverageMap = wantOcclusionCulling ? &nodeData->map : IGNORE_COVERAGE_MAP;
+                OcclusionBuffer* occlusionBuffer = wantOcclusionCulling ? &nodeData->occlusionBuffer
+                                                                        : IGNORE_OCCLUSION_BUFFER;
                 
                 float octreeSizeScale = nodeData->getOctreeSizeScale();
                 int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
@@ -445,10 +453,10 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 
                 EncodeBitstreamParams params(INT_MAX, &nodeData->getCurrentViewFrustum(), wantColor,
                                              WANT_EXISTS_BITS, DONT_CHOP, wantDelta, lastViewFrustum,
-                                             wantOcclusionCulling, coverageMap, boundaryLevelAdjust, octreeSizeScale,
+                                             wantOcclusionCulling, occlusionBuffer, boundaryLevelAdjust, octreeSizeScale,
                                              nodeData->getLastTimeBagEmpty(),
                                              isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
-                                             &nodeData->extraEncodeData);
+                                             &nodeData->extraEncodeData, &nodeData->sentIndex);
 
                 // TODO: should this include the lock time or not? This stat is sent down to the client,
                 // it seems like it may be a good idea to include the lock time as part of the encode time
@@ -512,6 +520,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     }
 
                     nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
+                    nodeData->sentIndex.commitPending();
                     extraPackingAttempts = 0;
                     quint64 compressAndWriteEnd = usecTimestampNow();
                     compressAndWriteElapsedUsec = (float)(compressAndWriteEnd - compressAndWriteStart);
@@ -546,17 +555,18 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     // a larger compressed size then uncompressed size
                     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
                 }
-                _packetData.changeSettings(nodeData->getWantCompression(), targetSize); // will do reset
+                _packetData.changeSettings(nodeData->getWantCompression(), targetSize,
+                                           nodeData->getWantsFastCompressedPackets()); // will do reset
 
             }
-            OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
-            OctreeServer::trackEncodeTime(encodeElapsedUsec);
-            OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
-            OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
+            _myServer->trackTreeWaitTime(lockWaitElapsedUsec);
+            _myServer->trackEncodeTime(encodeElapsedUsec);
+            _myServer->trackCompressAndWriteTime(compressAndWriteElapsedUsec);
+            _myServer->trackPacketSendingTime(packetSendingElapsedUsec);
             
             quint64 endInside = usecTimestampNow();
             quint64 elapsedInsideUsecs = endInside - startInside;
-            OctreeServer::trackInsideTime((float)elapsedInsideUsecs);
+            _myServer->trackInsideTime((float)elapsedInsideUsecs);
         }
 
 
@@ -572,7 +582,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         }
 
         // Re-send packets that were nacked by the client
-        while (nodeData->hasNextNackedPacket() && packetsSentThisInterval < maxPacketsPerInterval) {
+        while (nodeData->hasNextNackedPacket() && packetsSentThisInterval < maxPacketsPerInterval
+                && congestionController.canSend(MAX_PACKET_SIZE, usecTimestampNow())) {
             const QByteArray* packet = nodeData->getNextNackedPacket();
             if (packet) {
                 DependencyManager::get<NodeList>()->writeDatagram(*packet, _node);
@@ -587,7 +598,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
 
         quint64 end = usecTimestampNow();
         int elapsedmsec = (end - start)/USECS_PER_MSEC;
-        OctreeServer::trackLoopTime(elapsedmsec);
+        _myServer->trackLoopTime(elapsedmsec);
 
         // TODO: add these to stats page
         //quint64 endCompressCalls = OctreePacketData::getCompressContentCalls();
@@ -600,7 +611,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         if (nodeData->elementBag.isEmpty()) {
             nodeData->updateLastKnownViewFrustum();
             nodeData->setViewSent(true);
-            nodeData->map.erase(); // It would be nice if we could save this, and only reset it when the view frustum changes
+            nodeData->setLastSceneHadOccluded(nodeData->occlusionBuffer.getOccludedCount() > 0);
+            nodeData->occlusionBuffer.erase(); // It would be nice if we could save this, and only reset it when the view frustum changes
         }
 
     } // end if bag wasn't empty, and so we sent stuff...
@@ -14,7 +14,6 @@
 #ifndef hifi_OctreeSendThread_h
 #define hifi_OctreeSendThread_h
 
-#include <GenericThread.h>
 #include <NetworkPacket.h>
 #include <OctreeElementBag.h>
 
@@ -22,29 +21,33 @@
 
 class OctreeServer;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+class OctreeSendScheduler;
+
+/// Processor for sending octree packets to a single client, its send intervals are run by the server's
+/// OctreeSendScheduler
+class OctreeSendThread : public QObject {
     Q_OBJECT
 public:
-    OctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node);
+    OctreeSendThread(const SharedAssignmentPointer& myAssignment, const SharedNodePointer& node,
+                     OctreeSendScheduler* scheduler);
     virtual ~OctreeSendThread();
     
     void setIsShuttingDown();
 
+    /// runs a single send interval, returns false once this client no longer needs sending to
+    bool process();
+
     static quint64 _totalBytes;
     static quint64 _totalWastedBytes;
     static quint64 _totalPackets;
 
-    static quint64 _usleepTime;
-    static quint64 _usleepCalls;
-
-protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process();
+signals:
+    void finished();
 
 private:
     SharedAssignmentPointer _myAssignment;
     OctreeServer* _myServer;
+    OctreeSendScheduler* _scheduler;
     SharedNodePointer _node;
     QUuid _nodeUUID;
 
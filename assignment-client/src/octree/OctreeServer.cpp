@@ -20,6 +20,7 @@
 #include <AccountManager.h>
 #include <HTTPConnection.h>
 #include <LogHandler.h>
+#include <MemoryTracker.h>
 #include <UUID.h>
 
 #include "../AssignmentClient.h"
@@ -30,185 +31,72 @@
 
 OctreeServer* OctreeServer::_instance = NULL;
 int OctreeServer::_clientCount = 0;
-const int MOVING_AVERAGE_SAMPLE_COUNTS = 1000000;
 
-float OctreeServer::SKIP_TIME = -1.0f; // use this for trackXXXTime() calls for non-times
-
-SimpleMovingAverage OctreeServer::_averageLoopTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageInsideTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongEncode = 0;
-int OctreeServer::_longEncode = 0;
-int OctreeServer::_shortEncode = 0;
-int OctreeServer::_noEncode = 0;
-
-SimpleMovingAverage OctreeServer::_averageTreeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongTreeWait = 0;
-int OctreeServer::_longTreeWait = 0;
-int OctreeServer::_shortTreeWait = 0;
-int OctreeServer::_noTreeWait = 0;
-
-SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageCompressAndWriteTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongCompress = 0;
-int OctreeServer::_longCompress = 0;
-int OctreeServer::_shortCompress = 0;
-int OctreeServer::_noCompress = 0;
-
-SimpleMovingAverage OctreeServer::_averagePacketSendingTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_noSend = 0;
-
-SimpleMovingAverage OctreeServer::_averageProcessWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongProcessWait = 0;
-int OctreeServer::_longProcessWait = 0;
-int OctreeServer::_shortProcessWait = 0;
-int OctreeServer::_noProcessWait = 0;
+// the status page is kept this long for the scrapes that follow the one that rendered it
+const int STATUS_SNAPSHOT_LIFETIME_MSECS = 1000;
 
+float OctreeServer::SKIP_TIME = -1.0f; // use this for trackXXXTime() calls for non-times
 
 void OctreeServer::resetSendingStats() {
-    _averageLoopTime.reset();
-
-    _averageEncodeTime.reset();
-    _averageShortEncodeTime.reset();
-    _averageLongEncodeTime.reset();
-    _averageExtraLongEncodeTime.reset();
-    _extraLongEncode = 0;
-    _longEncode = 0;
-    _shortEncode = 0;
-    _noEncode = 0;
-
-    _averageInsideTime.reset();
-    _averageTreeWaitTime.reset();
-    _averageTreeShortWaitTime.reset();
-    _averageTreeLongWaitTime.reset();
-    _averageTreeExtraLongWaitTime.reset();
-    _extraLongTreeWait = 0;
-    _longTreeWait = 0;
-    _shortTreeWait = 0;
-    _noTreeWait = 0;
-
-    _averageNodeWaitTime.reset();
-
-    _averageCompressAndWriteTime.reset();
-    _averageShortCompressTime.reset();
-    _averageLongCompressTime.reset();
-    _averageExtraLongCompressTime.reset();
-    _extraLongCompress = 0;
-    _longCompress = 0;
-    _shortCompress = 0;
-    _noCompress = 0;
-
-    _averagePacketSendingTime.reset();
-    _noSend = 0;
-
-    _averageProcessWaitTime.reset();
-    _averageProcessShortWaitTime.reset();
-    _averageProcessLongWaitTime.reset();
-    _averageProcessExtraLongWaitTime.reset();
-    _extraLongProcessWait = 0;
-    _longProcessWait = 0;
-    _shortProcessWait = 0;
-    _noProcessWait = 0;
+    _stats.reset();
 }
 
-void OctreeServer::trackEncodeTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-
-    if (time == SKIP_TIME) {
-        _noEncode++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortEncode++;
-        _averageShortEncodeTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longEncode++;
-        _averageLongEncodeTime.updateAverage(time);
-    } else {
-        _extraLongEncode++;
-        _averageExtraLongEncodeTime.updateAverage(time);
-    }
-    _averageEncodeTime.updateAverage(time); 
+OctreeServer::TimingStat OctreeServer::registerTimingStat(const QString& name) {
+    const quint64 MAX_SHORT_TIME = 10;
+    const quint64 MAX_LONG_TIME = 100;
+    TimingStat stat = { _stats.registerHistogram(name, QVector<quint64>() << MAX_SHORT_TIME << MAX_LONG_TIME),
+                        _stats.registerCounter(name + "_skipped") };
+    return stat;
 }
 
-void OctreeServer::trackTreeWaitTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
+void OctreeServer::trackTime(const TimingStat& stat, float time) {
     if (time == SKIP_TIME) {
-        _noTreeWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortTreeWait++;
-        _averageTreeShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longTreeWait++;
-        _averageTreeLongWaitTime.updateAverage(time);
+        _stats.add(stat.skippedID);
     } else {
-        _extraLongTreeWait++;
-        _averageTreeExtraLongWaitTime.updateAverage(time);
+        _stats.record(stat.histogramID, (quint64)time);
     }
-    _averageTreeWaitTime.updateAverage(time);
 }
 
-void OctreeServer::trackCompressAndWriteTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noCompress++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortCompress++;
-        _averageShortCompressTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longCompress++;
-        _averageLongCompressTime.updateAverage(time);
-    } else {
-        _extraLongCompress++;
-        _averageExtraLongCompressTime.updateAverage(time);
-    }
-    _averageCompressAndWriteTime.updateAverage(time); 
+float OctreeServer::getAverageTime(const TimingStat& stat) const {
+    // the skipped samples count as taking no time
+    StatsRegistry::Bucket whole = _stats.getHistogram(stat.histogramID).last();
+    quint64 samples = whole.count + _stats.getCount(stat.skippedID);
+    return samples > 0 ? (float)whole.sum / samples : 0.0f;
 }
 
-void OctreeServer::trackPacketSendingTime(float time) { 
-    if (time == SKIP_TIME) {
-        _noSend++;
-        time = 0.0f;
-    }
-    _averagePacketSendingTime.updateAverage(time); 
+float OctreeServer::getAverageTime(int histogramID) const {
+    StatsRegistry::Bucket whole = _stats.getHistogram(histogramID).last();
+    return whole.count > 0 ? (float)whole.sum / whole.count : 0.0f;
 }
 
-
-void OctreeServer::trackProcessWaitTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noProcessWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortProcessWait++;
-        _averageProcessShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longProcessWait++;
-        _averageProcessLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongProcessWait++;
-        _averageProcessExtraLongWaitTime.updateAverage(time);
+QString OctreeServer::getTimingStatsString(const TimingStat& stat, const QString& averageLabel,
+                                           const QString& skippedLabel, const QStringList& bucketLabels) const {
+    const float AS_PERCENT = 100.0f;
+    const int LABEL_WIDTH = 37;
+    QVector<StatsRegistry::Bucket> buckets = _stats.getHistogram(stat.histogramID);
+    quint64 skipped = _stats.getCount(stat.skippedID);
+    quint64 samples = buckets.last().count + skipped;
+
+    QString statsString;
+    statsString += QString().sprintf("%s    %9.2f usecs                 samples: %12llu \r\n",
+                                     qPrintable((averageLabel + ":").rightJustified(LABEL_WIDTH, ' ')),
+                                     getAverageTime(stat), samples);
+
+    float skippedVsTotal = (samples > 0) ? ((float)skipped / (float)samples) : 0.0f;
+    statsString += QString().sprintf("%s                          (%6.2f%%) samples: %12llu \r\n",
+                                     qPrintable((skippedLabel + ":").rightJustified(LABEL_WIDTH, ' ')),
+                                     skippedVsTotal * AS_PERCENT, skipped);
+
+    for (int i = 0; i < bucketLabels.size() && i < buckets.size() - 1; i++) {
+        const StatsRegistry::Bucket& bucket = buckets.at(i);
+        float bucketAverage = (bucket.count > 0) ? ((float)bucket.sum / (float)bucket.count) : 0.0f;
+        float bucketVsTotal = (samples > 0) ? ((float)bucket.count / (float)samples) : 0.0f;
+        statsString += QString().sprintf("%s          %9.2f usecs (%6.2f%%) samples: %12llu \r\n",
+                                         qPrintable((bucketLabels.at(i) + ":").rightJustified(LABEL_WIDTH, ' ')),
+                                         bucketAverage, bucketVsTotal * AS_PERCENT, bucket.count);
     }
-    _averageProcessWaitTime.updateAverage(time);
+    statsString += "\r\n";
+    return statsString;
 }
 
 void OctreeServer::attachQueryNodeToNode(Node* newNode) {
@@ -235,10 +123,20 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     _verboseDebug(false),
     _jurisdiction(NULL),
     _jurisdictionSender(NULL),
+    _peerJurisdictionListener(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _sendScheduler(NULL),
     _started(time(0)),
-    _startedUSecs(usecTimestampNow())
+    _startedUSecs(usecTimestampNow()),
+    _loopTimeStatID(_stats.registerHistogram("loop_time")),
+    _insideTimeStatID(_stats.registerHistogram("inside_time")),
+    _nodeWaitTimeStatID(_stats.registerHistogram("node_wait_time")),
+    _encodeTimeStat(registerTimingStat("encode_time")),
+    _treeWaitTimeStat(registerTimingStat("tree_wait_time")),
+    _compressAndWriteTimeStat(registerTimingStat("compress_and_write_time")),
+    _packetSendingTimeStat(registerTimingStat("packet_sending_time")),
+    _processWaitTimeStat(registerTimingStat("process_wait_time"))
 {
     if (_instance) {
         qDebug() << "Octree Server starting... while old instance still running _instance=["<<_instance<<"] this=[" << this << "]";
@@ -247,7 +145,6 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     qDebug() << "Octree Server starting... setting _instance to=[" << this << "]";
     _instance = this;
 
-    _averageLoopTime.updateAverage(0);
     qDebug() << "Octree server starting... [" << this << "]";
     
     // make sure the AccountManager has an Auth URL for payment redemptions
@@ -269,6 +166,11 @@ OctreeServer::~OctreeServer() {
         _jurisdictionSender->deleteLater();
     }
 
+    if (_peerJurisdictionListener) {
+        _peerJurisdictionListener->terminate();
+        _peerJurisdictionListener->deleteLater();
+    }
+
     if (_octreeInboundPacketProcessor) {
         _octreeInboundPacketProcessor->terminate();
         _octreeInboundPacketProcessor->deleteLater();
@@ -279,6 +181,10 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    // the send threads hold the assignment, so by now they have all been removed from the scheduler
+    delete _sendScheduler;
+    _sendScheduler = NULL;
+
     delete _jurisdiction;
     _jurisdiction = NULL;
     
@@ -304,6 +210,10 @@ void OctreeServer::initHTTPManager(int port) {
 }
 
 bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    // the packet metrics are served from our status port too
+    if (ThreadedAssignment::handleHTTPRequest(connection, url, skipSubHandler)) {
+        return true;
+    }
 
 #ifdef FORCE_CRASH
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation
@@ -437,147 +347,42 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
         float averageLoopTime = getAverageLoopTime();
         statsString += QString().sprintf("           Average packetLoop() time:      %7.2f msecs"
-                                         "                 samples: %12d \r\n", 
-                                         averageLoopTime, _averageLoopTime.getSampleCount());
+                                         "                 samples: %12llu \r\n", 
+                                         averageLoopTime, _stats.getHistogram(_loopTimeStatID).last().count);
 
         float averageInsideTime = getAverageInsideTime();
         statsString += QString().sprintf("               Average 'inside' time:    %9.2f usecs"
-                                         "                 samples: %12d \r\n\r\n", 
-                                         averageInsideTime, _averageInsideTime.getSampleCount());
-
-
-        // Process Wait
-        {
-            int allWaitTimes = _extraLongProcessWait +_longProcessWait + _shortProcessWait + _noProcessWait;
-
-            float averageProcessWaitTime = getAverageProcessWaitTime();
-            statsString += QString().sprintf("      Average process lock wait time:"
-                                             "    %9.2f usecs                 samples: %12d \r\n",
-                                             averageProcessWaitTime, allWaitTimes);
-
-            float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("                        No Lock Wait:"
-                                             "                          (%6.2f%%) samples: %12d \r\n",
-                                             zeroVsTotal * AS_PERCENT, _noProcessWait);
-
-            float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("    Avg process lock short wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             _averageProcessShortWaitTime.getAverage(), 
-                                             shortVsTotal * AS_PERCENT, _shortProcessWait);
-
-            float longVsTotal = (allWaitTimes > 0) ? ((float)_longProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("     Avg process lock long wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             _averageProcessLongWaitTime.getAverage(), 
-                                             longVsTotal * AS_PERCENT, _longProcessWait);
-
-            float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("Avg process lock extralong wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                             _averageProcessExtraLongWaitTime.getAverage(), 
-                                             extraLongVsTotal * AS_PERCENT, _extraLongProcessWait);
-        }
+                                         "                 samples: %12llu \r\n\r\n", 
+                                         averageInsideTime, _stats.getHistogram(_insideTimeStatID).last().count);
 
-        // Tree Wait
-        int allWaitTimes = _extraLongTreeWait +_longTreeWait + _shortTreeWait + _noTreeWait;
+        statsString += getTimingStatsString(_processWaitTimeStat, "Average process lock wait time", "No Lock Wait",
+            QStringList() << "Avg process lock short wait time" << "Avg process lock long wait time"
+                          << "Avg process lock extralong wait time");
 
         float averageTreeWaitTime = getAverageTreeWaitTime();
-        statsString += QString().sprintf("         Average tree lock wait time:"
-                                         "    %9.2f usecs                 samples: %12d \r\n",
-                                         averageTreeWaitTime, allWaitTimes);
-
-        float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("                        No Lock Wait:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotal * AS_PERCENT, _noTreeWait);
-
-        float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("       Avg tree lock short wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageTreeShortWaitTime.getAverage(), 
-                                         shortVsTotal * AS_PERCENT, _shortTreeWait);
-
-        float longVsTotal = (allWaitTimes > 0) ? ((float)_longTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg tree lock long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageTreeLongWaitTime.getAverage(), 
-                                         longVsTotal * AS_PERCENT, _longTreeWait);
-
-        float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("  Avg tree lock extra long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageTreeExtraLongWaitTime.getAverage(), 
-                                         extraLongVsTotal * AS_PERCENT, _extraLongTreeWait);
-
-        // encode
-        float averageEncodeTime = getAverageEncodeTime();
-        statsString += QString().sprintf("                 Average encode time:    %9.2f usecs\r\n", averageEncodeTime);
-        
-        int allEncodeTimes = _noEncode + _shortEncode + _longEncode + _extraLongEncode;
-
-        float zeroVsTotalEncode = (allEncodeTimes > 0) ? ((float)_noEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                           No Encode:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotalEncode * AS_PERCENT, _noEncode);
-
-        float shortVsTotalEncode = (allEncodeTimes > 0) ? ((float)_shortEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("               Avg short encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageShortEncodeTime.getAverage(), 
-                                         shortVsTotalEncode * AS_PERCENT, _shortEncode);
-
-        float longVsTotalEncode = (allEncodeTimes > 0) ? ((float)_longEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                Avg long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageLongEncodeTime.getAverage(), 
-                                         longVsTotalEncode * AS_PERCENT, _longEncode);
-
-        float extraLongVsTotalEncode = (allEncodeTimes > 0) ? ((float)_extraLongEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("          Avg extra long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageExtraLongEncodeTime.getAverage(), 
-                                         extraLongVsTotalEncode * AS_PERCENT, _extraLongEncode);
+        statsString += getTimingStatsString(_treeWaitTimeStat, "Average tree lock wait time", "No Lock Wait",
+            QStringList() << "Avg tree lock short wait time" << "Avg tree lock long wait time"
+                          << "Avg tree lock extra long wait time");
 
+        float averageEncodeTime = getAverageEncodeTime();
+        statsString += getTimingStatsString(_encodeTimeStat, "Average encode time", "No Encode",
+            QStringList() << "Avg short encode time" << "Avg long encode time" << "Avg extra long encode time");
 
         float averageCompressAndWriteTime = getAverageCompressAndWriteTime();
-        statsString += QString().sprintf("     Average compress and write time:    %9.2f usecs\r\n", 
-            averageCompressAndWriteTime);
-
-        int allCompressTimes = _noCompress + _shortCompress + _longCompress + _extraLongCompress;
-
-        float zeroVsTotalCompress = (allCompressTimes > 0) ? ((float)_noCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("                      No compression:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotalCompress * AS_PERCENT, _noCompress);
-
-        float shortVsTotalCompress = (allCompressTimes > 0) ? ((float)_shortCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("             Avg short compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageShortCompressTime.getAverage(), 
-                                         shortVsTotalCompress * AS_PERCENT, _shortCompress);
-
-        float longVsTotalCompress = (allCompressTimes > 0) ? ((float)_longCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("              Avg long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageLongCompressTime.getAverage(), 
-                                         longVsTotalCompress * AS_PERCENT, _longCompress);
-
-        float extraLongVsTotalCompress = (allCompressTimes > 0) ? ((float)_extraLongCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg extra long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageExtraLongCompressTime.getAverage(), 
-                                         extraLongVsTotalCompress * AS_PERCENT, _extraLongCompress);
+        statsString += getTimingStatsString(_compressAndWriteTimeStat, "Average compress and write time",
+            "No compression", QStringList() << "Avg short compress time" << "Avg long compress time"
+                                            << "Avg extra long compress time");
 
         float averagePacketSendingTime = getAveragePacketSendingTime();
         statsString += QString().sprintf("         Average packet sending time:    %9.2f usecs (includes node lock)\r\n", 
                                         averagePacketSendingTime);
 
-        float noVsTotalSend = (_averagePacketSendingTime.getSampleCount() > 0) ? 
-                                        ((float)_noSend / (float)_averagePacketSendingTime.getSampleCount()) : 0.0f;
+        quint64 noSend = _stats.getCount(_packetSendingTimeStat.skippedID);
+        quint64 allSendTimes = _stats.getHistogram(_packetSendingTimeStat.histogramID).last().count + noSend;
+        float noVsTotalSend = (allSendTimes > 0) ? ((float)noSend / (float)allSendTimes) : 0.0f;
         statsString += QString().sprintf("                         Not sending:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         noVsTotalSend * AS_PERCENT, _noSend);
+                                         "                          (%6.2f%%) samples: %12llu \r\n",
+                                         noVsTotalSend * AS_PERCENT, noSend);
                                         
         float averageNodeWaitTime = getAverageNodeWaitTime();
         statsString += QString().sprintf("         Average node lock wait time:    %9.2f usecs\r\n", averageNodeWaitTime);
@@ -723,6 +528,15 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          OctreeElement::getTotalMemoryUsage() / memoryScale, memoryScaleLabel);
         statsString += "\r\n";
 
+        statsString += "Memory Usage by Subsystem...\r\n";
+        foreach (MemoryCounter* counter, MemoryTracker::getInstance().getCounters()) {
+            statsString += QString().sprintf("    %-28s %8.2f MB\r\n", counter->getName().toLocal8Bit().constData(),
+                                             counter->getCPUBytes() / MEGABYTES);
+        }
+        statsString += QString().sprintf("                         Total:  %8.2f MB\r\n",
+                                         MemoryTracker::getInstance().getTotalCPUBytes() / MEGABYTES);
+        statsString += "\r\n";
+
         statsString += "OctreeElement Children Population Statistics...\r\n";
         checkSum = 0;
         for (int i=0; i <= NUMBER_OF_CHILDREN; i++) {
@@ -780,7 +594,9 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += "</pre>\r\n";
         statsString += "</doc></html>";
 
-        connection->respond(HTTPConnection::StatusCode200, qPrintable(statsString), "text/html");
+        QByteArray statsPage = statsString.toLocal8Bit();
+        connection->respond(HTTPConnection::StatusCode200, statsPage, "text/html");
+        connection->parentManager()->publishSnapshot("/", statsPage, "text/html", STATUS_SNAPSHOT_LIFETIME_MSECS);
 
         return true;
     } else {
@@ -790,6 +606,15 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
 }
 
+void OctreeServer::updateQueueDepths(PacketMetrics& metrics) {
+    if (_octreeInboundPacketProcessor) {
+        metrics.setQueueDepth("inbound_edit_packets", _octreeInboundPacketProcessor->packetsToProcessCount());
+    }
+    if (_jurisdictionSender) {
+        metrics.setQueueDepth("jurisdiction_requests", _jurisdictionSender->packetsToProcessCount());
+    }
+}
+
 void OctreeServer::setArguments(int argc, char** argv) {
     _argc = argc;
     _argv = const_cast<const char**>(argv);
@@ -834,6 +659,7 @@ void OctreeServer::readPendingDatagram(const QByteArray& receivedPacket, const H
     
     if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
         PacketType packetType = packetTypeForPacket(receivedPacket);
+        PacketMetrics::ProcessingTimer processingTimer(nodeList->getPacketMetrics(), packetType);
         SharedNodePointer matchingNode = nodeList->sendingNodeForPacket(receivedPacket);
         if (packetType == getMyQueryMessageType()) {
             // If we got a query packet, then we're talking to an agent, and we
@@ -848,7 +674,7 @@ void OctreeServer::readPendingDatagram(const QByteArray& receivedPacket, const H
                     // solution is to get the shared pointer for the current assignment. We need to make sure this is the 
                     // same SharedAssignmentPointer that was ref counted by the assignment client.                    
                     SharedAssignmentPointer sharedAssignment = AssignmentClient::getCurrentAssignment();
-                    nodeData->initializeOctreeSendThread(sharedAssignment, matchingNode);
+                    nodeData->initializeOctreeSendThread(sharedAssignment, matchingNode, _sendScheduler);
                 }
             }
         } else if (packetType == PacketTypeOctreeDataNack) {
@@ -862,6 +688,10 @@ void OctreeServer::readPendingDatagram(const QByteArray& receivedPacket, const H
             }
         } else if (packetType == PacketTypeJurisdictionRequest) {
             _jurisdictionSender->queueReceivedPacket(matchingNode, receivedPacket);
+        } else if (packetType == PacketTypeJurisdiction && _peerJurisdictionListener) {
+            _peerJurisdictionListener->queueReceivedPacket(matchingNode, receivedPacket);
+        } else if (packetType == getMyEditNackType() && getPeerEditPacketSender()) {
+            getPeerEditPacketSender()->processNackPacket(receivedPacket);
         } else if (_octreeInboundPacketProcessor && getOctree()->handlesEditPacketType(packetType)) {
             _octreeInboundPacketProcessor->queueReceivedPacket(matchingNode, receivedPacket);
         } else {
@@ -1096,6 +926,9 @@ void OctreeServer::run() {
     _tree = createTree();
     _tree->setIsServer(true);
 
+    // every client's sending is run by the same fixed set of workers, no matter how many clients connect
+    _sendScheduler = new OctreeSendScheduler(QThread::idealThreadCount());
+
     // make sure our NodeList knows what type we are
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->setOwnerType(getMyNodeType());
@@ -1108,6 +941,13 @@ void OctreeServer::run() {
 
     // read the configuration from either the payload or the domain server configuration
     readConfiguration();
+
+    // a server with a jurisdiction shares the domain with other servers of its type, so it keeps track of theirs, the
+    // listener asks the domain server about them
+    if (_jurisdiction) {
+        _peerJurisdictionListener = new JurisdictionListener(getMyNodeType());
+        _peerJurisdictionListener->initialize(true);
+    }
         
     beforeRun(); // after payload has been processed
 
@@ -20,8 +20,11 @@
 
 #include <ThreadedAssignment.h>
 #include <EnvironmentData.h>
+#include <JurisdictionListener.h>
+#include <OctreeEditPacketSender.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -29,7 +32,7 @@
 const int DEFAULT_PACKETS_PER_INTERVAL = 2000; // some 120,000 packets per second total
 
 /// Handles assignments of type OctreeServer - sending octrees to various clients.
-class OctreeServer : public ThreadedAssignment, public HTTPRequestHandler {
+class OctreeServer : public ThreadedAssignment {
     Q_OBJECT
 public:
     OctreeServer(const QByteArray& packet);
@@ -45,6 +48,10 @@ public:
     Octree* getOctree() { return _tree; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
 
+    /// when we have a jurisdiction, the jurisdictions of the other servers of our type sharing the domain, else NULL
+    NodeToJurisdictionMap* getPeerJurisdictions()
+        { return _peerJurisdictionListener ? _peerJurisdictionListener->getJurisdictions() : NULL; }
+
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval, 
                                 std::max(1, getPacketsTotalPerInterval() / std::max(1, getCurrentClientCount()))); }
 
@@ -75,33 +82,37 @@ public:
     virtual bool hasSpecialPacketToSend(const SharedNodePointer& node) { return false; }
     virtual int sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) { return 0; }
 
+    /// the sender a subclass uses for its edits to the other servers sharing the domain, it gets their nacks
+    virtual OctreeEditPacketSender* getPeerEditPacketSender() { return NULL; }
+
     static void attachQueryNodeToNode(Node* newNode);
     
     static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
 
-    static void trackLoopTime(float time) { _averageLoopTime.updateAverage(time); }
-    static float getAverageLoopTime() { return _averageLoopTime.getAverage(); }
+    // the send threads all track into the assignment's stats registry, each into its own block
+    void trackLoopTime(float time) { _stats.record(_loopTimeStatID, (quint64)time); }
+    float getAverageLoopTime() const { return getAverageTime(_loopTimeStatID); }
 
-    static void trackEncodeTime(float time);
-    static float getAverageEncodeTime() { return _averageEncodeTime.getAverage(); }
+    void trackEncodeTime(float time) { trackTime(_encodeTimeStat, time); }
+    float getAverageEncodeTime() const { return getAverageTime(_encodeTimeStat); }
 
-    static void trackInsideTime(float time) { _averageInsideTime.updateAverage(time); }
-    static float getAverageInsideTime() { return _averageInsideTime.getAverage(); }
+    void trackInsideTime(float time) { _stats.record(_insideTimeStatID, (quint64)time); }
+    float getAverageInsideTime() const { return getAverageTime(_insideTimeStatID); }
 
-    static void trackTreeWaitTime(float time);
-    static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
+    void trackTreeWaitTime(float time) { trackTime(_treeWaitTimeStat, time); }
+    float getAverageTreeWaitTime() const { return getAverageTime(_treeWaitTimeStat); }
 
-    static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
-    static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
+    void trackNodeWaitTime(float time) { _stats.record(_nodeWaitTimeStatID, (quint64)time); }
+    float getAverageNodeWaitTime() const { return getAverageTime(_nodeWaitTimeStatID); }
 
-    static void trackCompressAndWriteTime(float time);
-    static float getAverageCompressAndWriteTime() { return _averageCompressAndWriteTime.getAverage(); }
+    void trackCompressAndWriteTime(float time) { trackTime(_compressAndWriteTimeStat, time); }
+    float getAverageCompressAndWriteTime() const { return getAverageTime(_compressAndWriteTimeStat); }
 
-    static void trackPacketSendingTime(float time);
-    static float getAveragePacketSendingTime() { return _averagePacketSendingTime.getAverage(); }
+    void trackPacketSendingTime(float time) { trackTime(_packetSendingTimeStat, time); }
+    float getAveragePacketSendingTime() const { return getAverageTime(_packetSendingTimeStat); }
 
-    static void trackProcessWaitTime(float time);
-    static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
+    void trackProcessWaitTime(float time) { trackTime(_processWaitTimeStat, time); }
+    float getAverageProcessWaitTime() const { return getAverageTime(_processWaitTimeStat); }
     
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
@@ -147,6 +158,8 @@ protected:
 
     void setupDatagramProcessingThread();
     
+    virtual void updateQueueDepths(PacketMetrics& metrics);
+    
     int _argc;
     const char** _argv;
     char** _parsedArgV;
@@ -167,8 +180,10 @@ protected:
     bool _verboseDebug;
     JurisdictionMap* _jurisdiction;
     JurisdictionSender* _jurisdictionSender;
+    JurisdictionListener* _peerJurisdictionListener;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeSendScheduler* _sendScheduler;
     
     int _persistInterval;
     bool _wantBackup;
@@ -183,50 +198,29 @@ protected:
     QString _safeServerName;
     
     static int _clientCount;
-    static SimpleMovingAverage _averageLoopTime;
-
-    static SimpleMovingAverage _averageEncodeTime;
-    static SimpleMovingAverage _averageShortEncodeTime;
-    static SimpleMovingAverage _averageLongEncodeTime;
-    static SimpleMovingAverage _averageExtraLongEncodeTime;
-    static int _extraLongEncode;
-    static int _longEncode;
-    static int _shortEncode;
-    static int _noEncode;
-
-    static SimpleMovingAverage _averageInsideTime;
-
-    static SimpleMovingAverage _averageTreeWaitTime;
-    static SimpleMovingAverage _averageTreeShortWaitTime;
-    static SimpleMovingAverage _averageTreeLongWaitTime;
-    static SimpleMovingAverage _averageTreeExtraLongWaitTime;
-    static int _extraLongTreeWait;
-    static int _longTreeWait;
-    static int _shortTreeWait;
-    static int _noTreeWait;
-
-    static SimpleMovingAverage _averageNodeWaitTime;
-
-    static SimpleMovingAverage _averageCompressAndWriteTime;
-    static SimpleMovingAverage _averageShortCompressTime;
-    static SimpleMovingAverage _averageLongCompressTime;
-    static SimpleMovingAverage _averageExtraLongCompressTime;
-    static int _extraLongCompress;
-    static int _longCompress;
-    static int _shortCompress;
-    static int _noCompress;
-
-    static SimpleMovingAverage _averagePacketSendingTime;
-    static int _noSend;
-
-    static SimpleMovingAverage _averageProcessWaitTime;
-    static SimpleMovingAverage _averageProcessShortWaitTime;
-    static SimpleMovingAverage _averageProcessLongWaitTime;
-    static SimpleMovingAverage _averageProcessExtraLongWaitTime;
-    static int _extraLongProcessWait;
-    static int _longProcessWait;
-    static int _shortProcessWait;
-    static int _noProcessWait;
+
+    /// A time kept in short, long and extra long buckets, along with how often there was nothing to time.
+    class TimingStat {
+    public:
+        int histogramID;
+        int skippedID;
+    };
+    
+    TimingStat registerTimingStat(const QString& name);
+    void trackTime(const TimingStat& stat, float time);
+    float getAverageTime(const TimingStat& stat) const;
+    float getAverageTime(int histogramID) const;
+    QString getTimingStatsString(const TimingStat& stat, const QString& averageLabel, const QString& skippedLabel,
+                                 const QStringList& bucketLabels) const;
+    
+    int _loopTimeStatID;
+    int _insideTimeStatID;
+    int _nodeWaitTimeStatID;
+    TimingStat _encodeTimeStat;
+    TimingStat _treeWaitTimeStat;
+    TimingStat _compressAndWriteTimeStat;
+    TimingStat _packetSendingTimeStat;
+    TimingStat _processWaitTimeStat;
 
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
@@ -20,6 +20,7 @@
 
 OctreeServerDatagramProcessor::OctreeServerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread) :
     _nodeSocket(nodeSocket),
+    _batchedNodeSocket(nodeSocket),
     _previousNodeSocketThread(previousNodeSocketThread)
 {
     
@@ -31,25 +32,20 @@ OctreeServerDatagramProcessor::~OctreeServerDatagramProcessor() {
 }
 
 void OctreeServerDatagramProcessor::readPendingDatagrams() {
-    
-    HifiSockAddr senderSockAddr;
-    static QByteArray incomingPacket;
-    
-    // read everything that is available
-    while (_nodeSocket.hasPendingDatagrams()) {
-        incomingPacket.resize(_nodeSocket.pendingDatagramSize());
-        
-        // just get this packet off the stack
-        _nodeSocket.readDatagram(incomingPacket.data(), incomingPacket.size(),
-                                  senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
-                                  
-        PacketType packetType = packetTypeForPacket(incomingPacket);
-        if (packetType == PacketTypePing) {
-            DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, incomingPacket);
-            return; // don't emit
+    // read everything that is available, a batch at a time
+    for (int numRead = _batchedNodeSocket.read(); numRead > 0; numRead = _batchedNodeSocket.read()) {
+        for (int i = 0; i < numRead; i++) {
+            QByteArray incomingPacket = _batchedNodeSocket.getDatagram(i);
+            const HifiSockAddr& senderSockAddr = _batchedNodeSocket.getSenderSockAddr(i);
+            
+            PacketType packetType = packetTypeForPacket(incomingPacket);
+            if (packetType == PacketTypePing) {
+                DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, incomingPacket);
+                continue; // don't emit
+            }
+            
+            // emit the signal to tell the OctreeServer it needs to process a packet
+            emit packetRequiresProcessing(incomingPacket, senderSockAddr);
         }
-        
-        // emit the signal to tell AudioMixer it needs to process a packet
-        emit packetRequiresProcessing(incomingPacket, senderSockAddr);
     }
 }
@@ -22,6 +22,9 @@ macro(SETUP_HIFI_PROJECT)
     endif ()
   endforeach()
   
+  # sources from outside of this project's src folder, e.g. the assignment-client code a benchmark drives
+  set(TARGET_SRCS ${TARGET_SRCS} ${${TARGET_NAME}_EXTRA_SRCS})
+  
   # add the executable, include additional optional sources
   add_executable(${TARGET_NAME} ${TARGET_SRCS} "${AUTOMTC_SRC}")
   
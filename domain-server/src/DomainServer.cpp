@@ -44,6 +44,55 @@ const QString ICE_SERVER_DEFAULT_HOSTNAME = "ice.highfidelity.io";
 
 const QString ALLOWED_USERS_SETTINGS_KEYPATH = "security.allowed_users";
 const QString ALLOWED_EDITORS_SETTINGS_KEYPATH = "security.allowed_editors";
+const QString STANDBY_MIXERS_SETTINGS_KEYPATH = "failover.standby_mixers";
+
+// a user's public key is fetched again at most this often, whether the last fetch got one or not, so that a burst of
+// connects from a user without a key (or with a bad signature) doesn't become a burst of requests to the data server
+const quint64 PUBLIC_KEY_REFETCH_INTERVAL_USECS = 10 * USECS_PER_SECOND;
+
+// the audio and avatar mixers report how much of each frame they sleep, and one that hardly sleeps (or has had to
+// throttle its mixing) is saturated; while all the mixers of a type are, we ask for another, up to a limit, and the
+// nodes that connect after get split across them
+const NodeSet SCALABLE_MIXER_TYPES = NodeSet() << NodeType::AudioMixer << NodeType::AvatarMixer;
+const int MAX_MIXERS_PER_TYPE = 4;
+const float SATURATED_MIXER_SLEEP_PERCENTAGE = 10.0f;
+const int MIXER_SCALING_INTERVAL_MSECS = 5 * 1000;
+
+// a mixer we asked for that nobody has been sent to for this long is let go
+const quint64 EMPTY_SCALED_MIXER_LIFETIME_USECS = 30 * USECS_PER_SECOND;
+
+// the nodes report their ping times to the mixers they've been given, which we keep for the network each is on (by
+// the /24 of its public address); a node is given the mixer nearest its network, unless the mixers are within this
+// much of each other, when it's given the one with the fewest nodes as before
+const float MIXER_RTT_TOLERANCE_MSECS = 20.0f;
+const float MIXER_RTT_SMOOTHING_WEIGHT = 0.25f;
+const quint32 NETWORK_ADDRESS_MASK = 0xFFFFFF00;
+
+static quint32 networkForSocket(const HifiSockAddr& socket) {
+    // the networks that aren't IPv4 are lumped in together, as if they were one
+    return socket.getAddress().toIPv4Address() & NETWORK_ADDRESS_MASK;
+}
+
+static bool isMixerSaturated(const SharedNodePointer& mixer) {
+    const QJsonObject& statsObject =
+        reinterpret_cast<DomainServerNodeData*>(mixer->getLinkedData())->getStatsJSONObject();
+    
+    const QString TRAILING_SLEEP_KEY = "trailing_sleep_percentage";
+    const QString PERFORMANCE_THROTTLING_KEY = "performance_throttling_ratio";
+    
+    return statsObject.contains(TRAILING_SLEEP_KEY)
+        && (statsObject[TRAILING_SLEEP_KEY].toDouble() < SATURATED_MIXER_SLEEP_PERCENTAGE
+            || statsObject[PERFORMANCE_THROTTLING_KEY].toDouble() > 0.0);
+}
+
+static bool hasMixerListeners(const SharedNodePointer& mixer) {
+    const QJsonObject& statsObject =
+        reinterpret_cast<DomainServerNodeData*>(mixer->getLinkedData())->getStatsJSONObject();
+    
+    // the audio mixer counts its listeners per frame, the avatar mixer over the last second
+    return statsObject["average_listeners_per_frame"].toDouble() > 0.0
+        || statsObject["average_listeners_last_second"].toDouble() > 0.0;
+}
 
 
 DomainServer::DomainServer(int argc, char* argv[]) :
@@ -61,7 +110,14 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     _cookieSessionHash(),
     _automaticNetworkingSetting(),
     _settingsManager(),
-    _iceServerSocket(ICE_SERVER_DEFAULT_HOSTNAME, ICE_SERVER_DEFAULT_PORT)
+    _iceServerSocket(ICE_SERVER_DEFAULT_HOSTNAME, ICE_SERVER_DEFAULT_PORT),
+    _domainListVersion(0),
+    _domainListRemovals(),
+    _oldestDeltaListVersion(0),
+    _mixerLoads(),
+    _networkMixerRTTs(),
+    _scaledAssignmentUUIDs(),
+    _standbyAssignmentUUIDs()
 {
     LogUtils::init();
 
@@ -76,6 +132,9 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     
     _settingsManager.setupConfigMap(arguments());
     
+    // a change to the settings restarts us, so the permissions read here hold for as long as we run
+    rebuildConnectPermissions();
+    
     // setup a shutdown event listener to handle SIGTERM or WM_CLOSE for us
 #ifdef _WIN32
     installNativeEventFilter(&ShutdownEventListener::getInstance());
@@ -242,6 +301,8 @@ void DomainServer::setupNodeListAndAssignments(const QUuid& sessionUUID) {
     
     // check for scripts the user wants to persist from their domain-server config
     populateStaticScriptedAssignmentsFromSettings();
+    
+    populateStandbyMixerAssignments();
 
     auto nodeList = DependencyManager::set<LimitedNodeList>(domainServerPort, domainServerDTLSPort);
     
@@ -274,6 +335,10 @@ void DomainServer::setupNodeListAndAssignments(const QUuid& sessionUUID) {
     QTimer* silentNodeTimer = new QTimer(this);
     connect(silentNodeTimer, SIGNAL(timeout()), nodeList.data(), SLOT(removeSilentNodes()));
     silentNodeTimer->start(NODE_SILENCE_THRESHOLD_MSECS);
+    
+    QTimer* mixerScalingTimer = new QTimer(this);
+    connect(mixerScalingTimer, &QTimer::timeout, this, &DomainServer::scaleMixerAssignments);
+    mixerScalingTimer->start(MIXER_SCALING_INTERVAL_MSECS);
 
     connect(&nodeList->getNodeSocket(), SIGNAL(readyRead()), SLOT(readAvailableDatagrams()));
 
@@ -552,6 +617,27 @@ void DomainServer::createStaticAssignmentsForType(Assignment::Type type, const Q
     }
 }
 
+void DomainServer::populateStandbyMixerAssignments() {
+    const QVariant* standbyMixersVariant = valueForKeyPath(_settingsManager.getSettingsMap(),
+                                                           STANDBY_MIXERS_SETTINGS_KEYPATH);
+    if (!standbyMixersVariant || !standbyMixersVariant->toBool()) {
+        return;
+    }
+    
+    // each static mixer gets a twin that runs alongside it, sent to nobody, until it has to take over
+    foreach (const SharedAssignmentPointer& assignment, _allAssignments.values()) {
+        if (assignment->isStatic() && (assignment->getType() == Assignment::AudioMixerType
+                                       || assignment->getType() == Assignment::AvatarMixerType)) {
+            Assignment* standbyAssignment = new Assignment(Assignment::CreateCommand, assignment->getType(),
+                                                           assignment->getPool());
+            standbyAssignment->setPayload(assignment->getPayload());
+            
+            addStaticAssignmentToAssignmentHash(standbyAssignment);
+            _standbyAssignmentUUIDs.insert(standbyAssignment->getUUID());
+        }
+    }
+}
+
 void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Assignment::Type>& excludedTypes) {
     // enumerate over all assignment types and see if we've already excluded it
     for (Assignment::Type defaultedType = Assignment::AudioMixerType;
@@ -645,10 +731,8 @@ void DomainServer::handleConnectRequest(const QByteArray& packet, const HifiSock
         }
 
         // if this user is in the editors list (or if the editors list is empty) set the user's node's canAdjustLocks to true
-        const QVariant* allowedEditorsVariant =
-            valueForKeyPath(_settingsManager.getSettingsMap(), ALLOWED_EDITORS_SETTINGS_KEYPATH);
-        QStringList allowedEditors = allowedEditorsVariant ? allowedEditorsVariant->toStringList() : QStringList();
-        bool canAdjustLocks = allowedEditors.isEmpty() || allowedEditors.contains(username);
+        const QSet<QString>& allowedEditors = _connectPermissions.allowedEditors;
+        bool canAdjustLocks = allowedEditors.isEmpty() || allowedEditors.contains(username.toLower());
 
         SharedNodePointer newNode =
             DependencyManager::get<LimitedNodeList>()->addOrUpdateNode(nodeUUID, nodeType,
@@ -668,6 +752,9 @@ void DomainServer::handleConnectRequest(const QByteArray& packet, const HifiSock
         // if we have a username from an OAuth connect request, set it on the DomainServerNodeData
         nodeData->setUsername(username);
         nodeData->setSendingSockAddr(senderSockAddr);
+        
+        // a reconnecting node may have come back with new sockets or permissions
+        domainListEntryChanged(newNode);
 
         // reply back to the user with a PacketTypeDomainList
         sendDomainListToNode(newNode, senderSockAddr, nodeInterestList.toSet());
@@ -678,9 +765,7 @@ void DomainServer::handleConnectRequest(const QByteArray& packet, const HifiSock
 bool DomainServer::shouldAllowConnectionFromNode(const QString& username,
                                                  const QByteArray& usernameSignature,
                                                  const HifiSockAddr& senderSockAddr) {
-    const QVariant* allowedUsersVariant = valueForKeyPath(_settingsManager.getSettingsMap(),
-                                                                 ALLOWED_USERS_SETTINGS_KEYPATH);
-    QStringList allowedUsers = allowedUsersVariant ? allowedUsersVariant->toStringList() : QStringList();
+    const QSet<QString>& allowedUsers = _connectPermissions.allowedUsers;
     
     // we always let in a user who is sending a packet from our local socket or from the localhost address
     if (senderSockAddr.getAddress() == DependencyManager::get<LimitedNodeList>()->getLocalSockAddr().getAddress()
@@ -689,11 +774,17 @@ bool DomainServer::shouldAllowConnectionFromNode(const QString& username,
     }
     
     if (allowedUsers.count() > 0) {
-        if (allowedUsers.contains(username, Qt::CaseInsensitive)) {
+        QString lowerUsername = username.toLower();
+        if (allowedUsers.contains(lowerUsername)) {
             // it's possible this user can be allowed to connect, but we need to check their username signature
             
-            QByteArray publicKeyArray = _userPublicKeys.value(username);
-            if (!publicKeyArray.isEmpty()) {
+            UserPublicKey& userPublicKey = _userPublicKeys[lowerUsername];
+            const QByteArray& publicKeyArray = userPublicKey.keyData;
+            if (!userPublicKey.verifiedSignature.isEmpty() && userPublicKey.verifiedSignature == usernameSignature) {
+                // this is the signature that checked out against the key last time, so there's no need to decrypt it
+                return true;
+                
+            } else if (!publicKeyArray.isEmpty()) {
                 // if we do have a public key for the user, check for a signature match
                 
                 const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
@@ -709,9 +800,11 @@ bool DomainServer::shouldAllowConnectionFromNode(const QString& username,
                                                            rsaPublicKey, RSA_PKCS1_PADDING);
                     
                     if (decryptResult != -1) {
-                        if (username.toLower() == decryptedArray) {
+                        if (lowerUsername == decryptedArray) {
                             qDebug() << "Username signature matches for" << username << "- allowing connection.";
                             
+                            userPublicKey.verifiedSignature = usernameSignature;
+                            
                             // free up the public key before we return
                             RSA_free(rsaPublicKey);
                             
@@ -730,7 +823,9 @@ bool DomainServer::shouldAllowConnectionFromNode(const QString& username,
                     qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
                 }
             }
-        
+            
+            // we have no key for them, or the one we have may be out of date - this won't fetch it again if that
+            // already happened recently
             requestUserPublicKey(username);
         } else {
             qDebug() << "Connect request denied for user" << username << "not in allowed users list.";
@@ -743,24 +838,54 @@ bool DomainServer::shouldAllowConnectionFromNode(const QString& username,
     return false;
 }
 
-void DomainServer::preloadAllowedUserPublicKeys() {
+void DomainServer::rebuildConnectPermissions() {
     const QVariant* allowedUsersVariant = valueForKeyPath(_settingsManager.getSettingsMap(), ALLOWED_USERS_SETTINGS_KEYPATH);
-    QStringList allowedUsers = allowedUsersVariant ? allowedUsersVariant->toStringList() : QStringList();
+    const QVariant* allowedEditorsVariant =
+        valueForKeyPath(_settingsManager.getSettingsMap(), ALLOWED_EDITORS_SETTINGS_KEYPATH);
     
-    if (allowedUsers.size() > 0) {
-        // in the future we may need to limit how many requests here - for now assume that lists of allowed users are not
-        // going to create > 100 requests
-        foreach(const QString& username, allowedUsers) {
-            requestUserPublicKey(username);
+    _connectPermissions = ConnectPermissions();
+    
+    // usernames are compared without regard to case, so keep them lowercased
+    if (allowedUsersVariant) {
+        foreach(const QString& username, allowedUsersVariant->toStringList()) {
+            _connectPermissions.allowedUsers.insert(username.toLower());
+        }
+    }
+    if (allowedEditorsVariant) {
+        foreach(const QString& username, allowedEditorsVariant->toStringList()) {
+            _connectPermissions.allowedEditors.insert(username.toLower());
         }
     }
 }
 
+void DomainServer::preloadAllowedUserPublicKeys() {
+    // in the future we may need to limit how many requests here - for now assume that lists of allowed users are not
+    // going to create > 100 requests
+    foreach(const QString& username, _connectPermissions.allowedUsers) {
+        requestUserPublicKey(username);
+    }
+}
+
 void DomainServer::requestUserPublicKey(const QString& username) {
+    QString lowerUsername = username.toLower();
+    
+    // there's no point asking again while a request is out, or right after the last one came back
+    if (_pendingPublicKeyRequests.contains(lowerUsername)) {
+        return;
+    }
+    QHash<QString, quint64>::const_iterator lastFetch = _publicKeyFetchTimes.constFind(lowerUsername);
+    if (lastFetch != _publicKeyFetchTimes.constEnd()
+        && usecTimestampNow() - lastFetch.value() < PUBLIC_KEY_REFETCH_INTERVAL_USECS) {
+        return;
+    }
+    _pendingPublicKeyRequests.insert(lowerUsername);
+    
     // even if we have a public key for them right now, request a new one in case it has just changed
     JSONCallbackParameters callbackParams;
     callbackParams.jsonCallbackReceiver = this;
     callbackParams.jsonCallbackMethod = "publicKeyJSONCallback";
+    callbackParams.errorCallbackReceiver = this;
+    callbackParams.errorCallbackMethod = "publicKeyJSONErrorCallback";
     
     const QString USER_PUBLIC_KEY_PATH = "api/v1/users/%1/public_key";
     
@@ -844,20 +969,62 @@ NodeSet DomainServer::nodeInterestListFromPacket(const QByteArray& packet, int n
     return nodeInterestSet;
 }
 
+// the nodes removed from the list are remembered for this many removals, after which a node that last heard of a
+// version from before the oldest of them gets the full list again
+const int MAX_DOMAIN_LIST_REMOVALS = 32;
+
+void DomainServer::domainListEntryChanged(const SharedNodePointer& node) {
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (nodeData) {
+        nodeData->setListVersion(++_domainListVersion);
+    }
+}
+
+bool DomainServer::canSendDomainListDelta(DomainServerNodeData* nodeData, const NodeSet& nodeInterestList,
+                                          quint32 knownListVersion) const {
+    // a node that has no version, one from before our oldest remembered removal, or one we never gave out
+    // (because we restarted) needs the full list, as does one that has changed what it's interested in
+    return knownListVersion != 0 && knownListVersion >= _oldestDeltaListVersion
+        && knownListVersion <= _domainListVersion && nodeData->getListInterestSet() == nodeInterestList;
+}
+
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
-                                        const NodeSet& nodeInterestList) {
+                                        const NodeSet& nodeInterestList, quint32 knownListVersion) {
 
     QByteArray broadcastPacket = byteArrayWithPopulatedHeader(PacketTypeDomainList);
 
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    
+    // a node that's been given a different mixer needs the full list, since its new mixer may be older than the
+    // version it has
+    bool didChangeMixers = nodeData->isAuthenticated() && assignMixersToNode(node, nodeInterestList);
+    
+    // send only what has changed since the version the node already has, if we can, otherwise the full list
+    // (which is marked with a base version of zero)
+    quint32 baseListVersion = !didChangeMixers && canSendDomainListDelta(nodeData, nodeInterestList, knownListVersion)
+        ? knownListVersion : 0;
+    
+    // the full list carries all the removals we remember too, so that a node moved off a mixer that's gone drops it
+    QList<QUuid> removedUUIDs;
+    foreach (const DomainListRemoval& removal, _domainListRemovals) {
+        if (removal.listVersion > baseListVersion && nodeInterestList.contains(removal.type)) {
+            removedUUIDs.append(removal.uuid);
+        }
+    }
+    
     // always send the node their own UUID back
     QDataStream broadcastDataStream(&broadcastPacket, QIODevice::Append);
     broadcastDataStream << node->getUUID();
     broadcastDataStream << node->getCanAdjustLocks();
+    broadcastDataStream << _domainListVersion << baseListVersion << removedUUIDs;
+    
+    // each packet is numbered with the count of them once they're all built, so a node can tell it has the whole list
+    int packetIndexOffset = broadcastDataStream.device()->pos();
+    broadcastDataStream << (quint16)0 << (quint16)0;
 
     int numBroadcastPacketLeadBytes = broadcastDataStream.device()->pos();
+    QList<QByteArray> listPackets;
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-    
     auto nodeList = DependencyManager::get<LimitedNodeList>();
     
     // if we've established a connection via ICE with this peer, use that socket
@@ -875,11 +1042,20 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
         if (nodeData->isAuthenticated()) {
             // if this authenticated node has any interest types, send back those nodes as well
             nodeList->eachNode([&](const SharedNodePointer& otherNode){
-                // reset our nodeByteArray and nodeDataStream
-                QByteArray nodeByteArray;
-                QDataStream nodeDataStream(&nodeByteArray, QIODevice::Append);
+                DomainServerNodeData* otherNodeData =
+                    reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData());
                 
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestList.contains(otherNode->getType())) {
+                // when there's more than one mixer of a type, only send the one this node has been given
+                bool isOtherMixer = SCALABLE_MIXER_TYPES.contains(otherNode->getType())
+                    && !SCALABLE_MIXER_TYPES.contains(node->getType())
+                    && nodeData->getMixerHash().value(otherNode->getType()) != otherNode->getUUID();
+                
+                if (otherNode->getUUID() != node->getUUID() && nodeInterestList.contains(otherNode->getType())
+                    && otherNodeData->getListVersion() > baseListVersion && !isOtherMixer) {
+                    
+                    // reset our nodeByteArray and nodeDataStream
+                    QByteArray nodeByteArray;
+                    QDataStream nodeDataStream(&nodeByteArray, QIODevice::Append);
                     
                     // don't send avatar nodes to other avatars, that will come from avatar mixer
                     nodeDataStream << *otherNode.data();
@@ -894,8 +1070,7 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
                         nodeData->getSessionSecretHash().insert(otherNode->getUUID(), secretUUID);
                         
                         // set it on the other Node's sessionSecretHash
-                        reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData())
-                        ->getSessionSecretHash().insert(node->getUUID(), secretUUID);
+                        otherNodeData->getSessionSecretHash().insert(node->getUUID(), secretUUID);
                         
                     }
                     
@@ -903,9 +1078,9 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
                     
                     if (broadcastPacket.size() +  nodeByteArray.size() > dataMTU) {
                         // we need to break here and start a new packet
-                        // so send the current one
+                        // so keep the current one
                         
-                        nodeList->writeDatagram(broadcastPacket, node, senderSockAddr);
+                        listPackets.append(broadcastPacket);
                         
                         // reset the broadcastPacket structure
                         broadcastPacket.resize(numBroadcastPacketLeadBytes);
@@ -919,8 +1094,222 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
         }
     }
     
+    // remember what this list was sent for, so the next one can be a delta against it
+    nodeData->setListInterestSet(nodeData->isAuthenticated() ? nodeInterestList : NodeSet());
+    
     // always write the last broadcastPacket
-    nodeList->writeDatagram(broadcastPacket, node, senderSockAddr);
+    listPackets.append(broadcastPacket);
+    
+    for (int i = 0; i < listPackets.size(); i++) {
+        QByteArray& listPacket = listPackets[i];
+        QDataStream indexStream(&listPacket, QIODevice::ReadWrite);
+        indexStream.device()->seek(packetIndexOffset);
+        indexStream << (quint16)i << (quint16)listPackets.size();
+        
+        nodeList->writeDatagram(listPacket, node, senderSockAddr);
+    }
+}
+
+bool DomainServer::assignMixersToNode(const SharedNodePointer& node, const NodeSet& nodeInterestList) {
+    if (SCALABLE_MIXER_TYPES.contains(node->getType())) {
+        // mixers are sent all the nodes they're interested in
+        return false;
+    }
+    
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    bool didChangeMixers = false;
+    
+    foreach (NodeType_t mixerType, SCALABLE_MIXER_TYPES) {
+        if (!nodeInterestList.contains(mixerType) || _mixerLoads.contains(nodeData->getMixerHash().value(mixerType))) {
+            // a node keeps its mixer for as long as the mixer is around
+            continue;
+        }
+        
+        // give the node the mixer nearest its network, or with the fewest nodes of those about as near, preferring
+        // those that aren't saturated, and a standby only if there's nothing else - a mixer that nobody on the network
+        // has been given yet counts as near, so that the first few nodes from it find out how near it really is
+        QUuid bestMixerUUID;
+        int bestRank = 0;
+        int bestNumAssignedNodes = 0;
+        float bestRTT = 0.0f;
+        const QHash<QUuid, float> networkRTTs = _networkMixerRTTs.value(networkForSocket(node->getPublicSocket()));
+        
+        for (QHash<QUuid, MixerLoad>::const_iterator mixerLoad = _mixerLoads.constBegin();
+             mixerLoad != _mixerLoads.constEnd(); ++mixerLoad) {
+            SharedNodePointer mixer = nodeList->nodeWithUUID(mixerLoad.key());
+            if (mixerLoad.value().type != mixerType || !mixer) {
+                continue;
+            }
+            
+            int rank = (isStandbyMixer(mixer) ? 2 : 0) + (isMixerSaturated(mixer) ? 1 : 0);
+            float rtt = networkRTTs.value(mixerLoad.key());
+            bool isAsNear = qAbs(rtt - bestRTT) <= MIXER_RTT_TOLERANCE_MSECS;
+            if (bestMixerUUID.isNull() || rank < bestRank
+                || (rank == bestRank && !isAsNear && rtt < bestRTT)
+                || (rank == bestRank && isAsNear && mixerLoad.value().numAssignedNodes < bestNumAssignedNodes)) {
+                bestMixerUUID = mixerLoad.key();
+                bestRank = rank;
+                bestNumAssignedNodes = mixerLoad.value().numAssignedNodes;
+                bestRTT = rtt;
+            }
+        }
+        
+        if (!bestMixerUUID.isNull()) {
+            nodeData->getMixerHash().insert(mixerType, bestMixerUUID);
+            
+            MixerLoad& bestMixerLoad = _mixerLoads[bestMixerUUID];
+            bestMixerLoad.numAssignedNodes++;
+            bestMixerLoad.emptySince = 0;
+            
+            didChangeMixers = true;
+        }
+    }
+    
+    return didChangeMixers;
+}
+
+void DomainServer::recordMixerPingTimes(const SharedNodePointer& node, const QHash<QUuid, qint32>& pingTimes) {
+    if (SCALABLE_MIXER_TYPES.contains(node->getType())) {
+        return;
+    }
+    QHash<QUuid, float>* networkRTTs = NULL;
+    for (QHash<QUuid, qint32>::const_iterator pingTime = pingTimes.constBegin(); pingTime != pingTimes.constEnd();
+         ++pingTime) {
+        if (!_mixerLoads.contains(pingTime.key())) {
+            continue;
+        }
+        if (!networkRTTs) {
+            networkRTTs = &_networkMixerRTTs[networkForSocket(node->getPublicSocket())];
+        }
+        QHash<QUuid, float>::iterator rtt = networkRTTs->find(pingTime.key());
+        if (rtt == networkRTTs->end()) {
+            networkRTTs->insert(pingTime.key(), pingTime.value());
+        } else {
+            rtt.value() += (pingTime.value() - rtt.value()) * MIXER_RTT_SMOOTHING_WEIGHT;
+        }
+    }
+}
+
+bool DomainServer::isStandbyMixer(const SharedNodePointer& mixer) const {
+    const DomainServerNodeData* mixerData = reinterpret_cast<DomainServerNodeData*>(mixer->getLinkedData());
+    return mixerData && _standbyAssignmentUUIDs.contains(mixerData->getAssignmentUUID());
+}
+
+bool DomainServer::promoteStandbyMixer(NodeType_t mixerType) {
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    
+    for (QHash<QUuid, MixerLoad>::const_iterator mixerLoad = _mixerLoads.constBegin();
+         mixerLoad != _mixerLoads.constEnd(); ++mixerLoad) {
+        SharedNodePointer mixer = nodeList->nodeWithUUID(mixerLoad.key());
+        if (mixerLoad.value().type == mixerType && mixer && isStandbyMixer(mixer)) {
+            DomainServerNodeData* mixerData = reinterpret_cast<DomainServerNodeData*>(mixer->getLinkedData());
+            _standbyAssignmentUUIDs.remove(mixerData->getAssignmentUUID());
+            
+            qDebug() << "Promoted standby" << *mixer;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DomainServer::repointNodesFromMixer(const SharedNodePointer& mixer) {
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    
+    // send the lists now rather than at their next check-in, so they move to the new mixer as soon as we know
+    nodeList->eachNode([&](const SharedNodePointer& node){
+        DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+        if (nodeData && nodeData->getMixerHash().value(mixer->getType()) == mixer->getUUID()
+            && !nodeData->getListInterestSet().isEmpty()) {
+            sendDomainListToNode(node, nodeData->getSendingSockAddr(), nodeData->getListInterestSet());
+        }
+    });
+}
+
+void DomainServer::scaleMixerAssignments() {
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    quint64 now = usecTimestampNow();
+    
+    foreach (NodeType_t mixerType, SCALABLE_MIXER_TYPES) {
+        int numMixers = 0;
+        int numSaturatedMixers = 0;
+        QList<QUuid> emptyScaledMixerUUIDs;
+        
+        for (QHash<QUuid, MixerLoad>::iterator mixerLoad = _mixerLoads.begin(); mixerLoad != _mixerLoads.end();
+             ++mixerLoad) {
+            SharedNodePointer mixer = nodeList->nodeWithUUID(mixerLoad.key());
+            if (mixerLoad.value().type != mixerType || !mixer || isStandbyMixer(mixer)) {
+                // a standby is idle by design, so it says nothing about the load
+                continue;
+            }
+            
+            numMixers++;
+            if (isMixerSaturated(mixer)) {
+                numSaturatedMixers++;
+            }
+            
+            DomainServerNodeData* mixerData = reinterpret_cast<DomainServerNodeData*>(mixer->getLinkedData());
+            if (!_scaledAssignmentUUIDs.contains(mixerData->getAssignmentUUID())) {
+                continue;
+            }
+            
+            if (mixerLoad.value().numAssignedNodes > 0 || hasMixerListeners(mixer)) {
+                mixerLoad.value().emptySince = 0;
+            } else if (mixerLoad.value().emptySince == 0) {
+                mixerLoad.value().emptySince = now;
+            } else if (now - mixerLoad.value().emptySince > EMPTY_SCALED_MIXER_LIFETIME_USECS) {
+                emptyScaledMixerUUIDs.append(mixerLoad.key());
+            }
+        }
+        
+        Assignment::Type assignmentType = Assignment::typeForNodeType(mixerType);
+        
+        // look for a mixer we've asked for that hasn't been picked up yet
+        SharedAssignmentPointer pendingAssignment;
+        foreach (const SharedAssignmentPointer& assignment, _unfulfilledAssignments) {
+            if (assignment->getType() == assignmentType && _scaledAssignmentUUIDs.contains(assignment->getUUID())) {
+                pendingAssignment = assignment;
+                break;
+            }
+        }
+        
+        if (numMixers > 0 && numSaturatedMixers == numMixers) {
+            if (!pendingAssignment && numMixers < MAX_MIXERS_PER_TYPE) {
+                // every mixer of this type is saturated, so ask for another like the static one
+                Assignment* scaledAssignment = new Assignment(Assignment::CreateCommand, assignmentType);
+                foreach (const SharedAssignmentPointer& assignment, _allAssignments) {
+                    if (assignment->getType() == assignmentType && assignment->isStatic()) {
+                        scaledAssignment->setPayload(assignment->getPayload());
+                        scaledAssignment->setPool(assignment->getPool());
+                        break;
+                    }
+                }
+                
+                qDebug() << "All" << numMixers << "of type" << mixerType << "are saturated, adding assignment"
+                    << *scaledAssignment;
+                
+                SharedAssignmentPointer sharedAssignment(scaledAssignment);
+                _allAssignments.insert(scaledAssignment->getUUID(), sharedAssignment);
+                _unfulfilledAssignments.enqueue(sharedAssignment);
+                _scaledAssignmentUUIDs.insert(scaledAssignment->getUUID());
+            }
+        } else {
+            if (pendingAssignment) {
+                // the load has dropped before anyone picked up the extra mixer, so we don't need it any more
+                removeMatchingAssignmentFromQueue(pendingAssignment);
+                _allAssignments.remove(pendingAssignment->getUUID());
+                _scaledAssignmentUUIDs.remove(pendingAssignment->getUUID());
+            }
+            
+            if (numSaturatedMixers == 0) {
+                // nobody is being sent to these, so let them go; they'll stop when we stop answering their check-ins
+                foreach (const QUuid& mixerUUID, emptyScaledMixerUUIDs) {
+                    qDebug() << "Removing empty scaled mixer" << uuidStringWithoutCurlyBraces(mixerUUID);
+                    nodeList->killNodeWithUUID(mixerUUID);
+                }
+            }
+        }
+    }
 }
 
 void DomainServer::readAvailableDatagrams() {
@@ -1075,30 +1464,54 @@ void DomainServer::sendPendingTransactionsToServer() {
     }
 }
 
+static QString usernameForPublicKeyReply(QNetworkReply& requestReply) {
+    // figure out which user this is for
+    const QString PUBLIC_KEY_URL_REGEX_STRING = "api\\/v1\\/users\\/([A-Za-z0-9_\\.]+)\\/public_key";
+    QRegExp usernameRegex(PUBLIC_KEY_URL_REGEX_STRING);
+    
+    return (usernameRegex.indexIn(requestReply.url().toString()) != -1) ? usernameRegex.cap(1).toLower() : QString();
+}
+
 void DomainServer::publicKeyJSONCallback(QNetworkReply& requestReply) {
     QJsonObject jsonObject = QJsonDocument::fromJson(requestReply.readAll()).object();
+    QString username = usernameForPublicKeyReply(requestReply);
+    if (username.isEmpty()) {
+        return;
+    }
+    _pendingPublicKeyRequests.remove(username);
+    _publicKeyFetchTimes[username] = usecTimestampNow();
     
     if (jsonObject["status"].toString() == "success") {
-        // figure out which user this is for
+        qDebug() << "Storing a public key for user" << username;
         
-        const QString PUBLIC_KEY_URL_REGEX_STRING = "api\\/v1\\/users\\/([A-Za-z0-9_\\.]+)\\/public_key";
-        QRegExp usernameRegex(PUBLIC_KEY_URL_REGEX_STRING);
+        // pull the public key as a QByteArray from this response
+        const QString JSON_DATA_KEY = "data";
+        const QString JSON_PUBLIC_KEY_KEY = "public_key";
         
-        if (usernameRegex.indexIn(requestReply.url().toString()) != -1) {
-            QString username = usernameRegex.cap(1);
-            
-            qDebug() << "Storing a public key for user" << username;
-            
-            // pull the public key as a QByteArray from this response
-            const QString JSON_DATA_KEY = "data";
-            const QString JSON_PUBLIC_KEY_KEY = "public_key";
-            
-            _userPublicKeys[username] =
-                QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+        QByteArray keyData =
+            QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+        
+        UserPublicKey& userPublicKey = _userPublicKeys[username];
+        if (userPublicKey.keyData != keyData) {
+            // the signature that checked out against the old key means nothing for the new one
+            userPublicKey.keyData = keyData;
+            userPublicKey.verifiedSignature.clear();
         }
     }
 }
 
+void DomainServer::publicKeyJSONErrorCallback(QNetworkReply& requestReply) {
+    QString username = usernameForPublicKeyReply(requestReply);
+    if (username.isEmpty()) {
+        return;
+    }
+    qDebug() << "Failed to get a public key for user" << username << "-" << requestReply.errorString();
+    
+    // keep whatever key we had, and hold off on asking again for a while
+    _pendingPublicKeyRequests.remove(username);
+    _publicKeyFetchTimes[username] = usecTimestampNow();
+}
+
 void DomainServer::transactionJSONCallback(const QJsonObject& data) {
     // check if this was successful - if so we can remove it from our list of pending
     if (data.value("status").toString() == "success") {
@@ -1165,10 +1578,7 @@ void DomainServer::sendHeartbeatToDataServer(const QString& networkAddress) {
     // add a flag to indicate if this domain uses restricted access - for now that will exclude it from listings
     const QString RESTRICTED_ACCESS_FLAG = "restricted";
     
-    const QVariant* allowedUsersVariant = valueForKeyPath(_settingsManager.getSettingsMap(),
-                                                          ALLOWED_USERS_SETTINGS_KEYPATH);
-    QStringList allowedUsers = allowedUsersVariant ? allowedUsersVariant->toStringList() : QStringList();
-    domainObject[RESTRICTED_ACCESS_FLAG] = (allowedUsers.size() > 0);
+    domainObject[RESTRICTED_ACCESS_FLAG] = !_connectPermissions.allowedUsers.isEmpty();
     
     // add the number of currently connected agent users
     int numConnectedAuthedUsers = 0;
@@ -1296,17 +1706,39 @@ void DomainServer::processDatagram(const QByteArray& receivedPacket, const HifiS
                                                senderSockAddr);
                     
                     SharedNodePointer checkInNode = nodeList->nodeWithUUID(nodeUUID);
-                    checkInNode->setPublicSocket(nodePublicAddress);
-                    checkInNode->setLocalSocket(nodeLocalAddress);
+                    if (checkInNode->getPublicSocket() != nodePublicAddress
+                        || checkInNode->getLocalSocket() != nodeLocalAddress) {
+                        checkInNode->setPublicSocket(nodePublicAddress);
+                        checkInNode->setLocalSocket(nodeLocalAddress);
+                        domainListEntryChanged(checkInNode);
+                    }
                     
                     // update last receive to now
                     quint64 timeNow = usecTimestampNow();
                     checkInNode->setLastHeardMicrostamp(timeNow);
                     
+                    // the node may be sent a list between check-ins, when its mixer changes
+                    reinterpret_cast<DomainServerNodeData*>(checkInNode->getLinkedData())
+                        ->setSendingSockAddr(senderSockAddr);
+                    
                     QList<NodeType_t> nodeInterestList;
-                    packetStream >> nodeInterestList;
+                    quint32 knownListVersion = 0;
+                    QHash<QUuid, qint32> pingTimes;
+                    packetStream >> nodeInterestList >> knownListVersion >> pingTimes;
                     
-                    sendDomainListToNode(checkInNode, senderSockAddr, nodeInterestList.toSet());
+                    recordMixerPingTimes(checkInNode, pingTimes);
+                    
+                    sendDomainListToNode(checkInNode, senderSockAddr, nodeInterestList.toSet(), knownListVersion);
+                }
+                
+                break;
+            }
+            case PacketTypeDomainDisconnect: {
+                // only take the node's word for it from the socket it checks in from
+                SharedNodePointer leavingNode = nodeList->sendingNodeForPacket(receivedPacket);
+                if (leavingNode && reinterpret_cast<DomainServerNodeData*>(leavingNode->getLinkedData())
+                        ->getSendingSockAddr() == senderSockAddr) {
+                    nodeList->killNodeWithUUID(leavingNode->getUUID());
                 }
                 
                 break;
@@ -1978,6 +2410,11 @@ void DomainServer::refreshStaticAssignmentAndAddToQueue(SharedAssignmentPointer&
         QFile::rename(pathForAssignmentScript(oldUUID), pathForAssignmentScript(assignment->getUUID()));
     }
 
+    // a standby stays one under its new UUID
+    if (_standbyAssignmentUUIDs.remove(oldUUID)) {
+        _standbyAssignmentUUIDs.insert(assignment->getUUID());
+    }
+
     // add the static assignment back under the right UUID, and to the queue
     _allAssignments.insert(assignment->getUUID(), assignment);
     _unfulfilledAssignments.enqueue(assignment);
@@ -1986,6 +2423,12 @@ void DomainServer::refreshStaticAssignmentAndAddToQueue(SharedAssignmentPointer&
 void DomainServer::nodeAdded(SharedNodePointer node) {
     // we don't use updateNodeWithData, so add the DomainServerNodeData to the node here
     node->setLinkedData(new DomainServerNodeData());
+    domainListEntryChanged(node);
+    
+    if (SCALABLE_MIXER_TYPES.contains(node->getType())) {
+        MixerLoad mixerLoad = { node->getType(), 0, 0 };
+        _mixerLoads.insert(node->getUUID(), mixerLoad);
+    }
 }
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
@@ -1993,6 +2436,13 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
     // remove this node from the connecting / connected ICE lists (if they exist)
     _connectingICEPeers.remove(node->getUUID());
     _connectedICEPeers.remove(node->getUUID());
+    
+    // tell the nodes that get deltas that this one is gone, forgetting the oldest removal when we have too many
+    DomainListRemoval removal = { ++_domainListVersion, node->getUUID(), node->getType() };
+    _domainListRemovals.append(removal);
+    if (_domainListRemovals.size() > MAX_DOMAIN_LIST_REMOVALS) {
+        _oldestDeltaListVersion = _domainListRemovals.takeFirst().listVersion;
+    }
 
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
 
@@ -2002,8 +2452,38 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
             SharedAssignmentPointer matchedAssignment = _allAssignments.take(nodeData->getAssignmentUUID());
 
             if (matchedAssignment && matchedAssignment->isStatic()) {
+                if (SCALABLE_MIXER_TYPES.contains(node->getType())
+                    && !_standbyAssignmentUUIDs.contains(matchedAssignment->getUUID())
+                    && promoteStandbyMixer(node->getType())) {
+                    // the standby has taken this mixer's place, so the requeued assignment is the new standby
+                    _standbyAssignmentUUIDs.insert(matchedAssignment->getUUID());
+                }
+                
                 refreshStaticAssignmentAndAddToQueue(matchedAssignment);
             }
+            
+            _scaledAssignmentUUIDs.remove(nodeData->getAssignmentUUID());
+        }
+        
+        // this node no longer counts against the mixers it was given, and if it was a mixer nobody has it any more
+        foreach (const QUuid& mixerUUID, nodeData->getMixerHash()) {
+            if (_mixerLoads.contains(mixerUUID)) {
+                _mixerLoads[mixerUUID].numAssignedNodes--;
+            }
+        }
+        _mixerLoads.remove(node->getUUID());
+        
+        if (SCALABLE_MIXER_TYPES.contains(node->getType())) {
+            for (QHash<quint32, QHash<QUuid, float> >::iterator networkRTTs = _networkMixerRTTs.begin();
+                 networkRTTs != _networkMixerRTTs.end(); ) {
+                networkRTTs.value().remove(node->getUUID());
+                if (networkRTTs.value().isEmpty()) {
+                    networkRTTs = _networkMixerRTTs.erase(networkRTTs);
+                } else {
+                    ++networkRTTs;
+                }
+            }
+            repointNodesFromMixer(node);
         }
 
         // cleanup the connection secrets that we set up for this node (on the other nodes)
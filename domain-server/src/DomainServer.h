@@ -25,6 +25,7 @@
 #include <HTTPSConnection.h>
 #include <LimitedNodeList.h>
 
+#include "DomainServerNodeData.h"
 #include "DomainServerSettingsManager.h"
 #include "DomainServerWebSessionData.h"
 #include "WalletTransaction.h"
@@ -52,6 +53,7 @@ public slots:
     void nodeKilled(SharedNodePointer node);
     
     void publicKeyJSONCallback(QNetworkReply& requestReply);
+    void publicKeyJSONErrorCallback(QNetworkReply& requestReply);
     void transactionJSONCallback(const QJsonObject& data);
     
     void restart();
@@ -68,6 +70,7 @@ private slots:
     void sendHeartbeatToDataServer() { sendHeartbeatToDataServer(QString()); }
     void sendHeartbeatToIceServer();
     void sendICEPingPackets();
+    void scaleMixerAssignments();
 private:
     void setupNodeListAndAssignments(const QUuid& sessionUUID = QUuid::createUuid());
     bool optionallySetupOAuth();
@@ -86,6 +89,7 @@ private:
     bool shouldAllowConnectionFromNode(const QString& username, const QByteArray& usernameSignature,
                                        const HifiSockAddr& senderSockAddr);
     
+    void rebuildConnectPermissions();
     void preloadAllowedUserPublicKeys();
     void requestUserPublicKey(const QString& username);
     
@@ -96,13 +100,22 @@ private:
                                    const HifiSockAddr& senderSockAddr);
     NodeSet nodeInterestListFromPacket(const QByteArray& packet, int numPreceedingBytes);
     void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
-                              const NodeSet& nodeInterestList);
+                              const NodeSet& nodeInterestList, quint32 knownListVersion = 0);
+    bool canSendDomainListDelta(DomainServerNodeData* nodeData, const NodeSet& nodeInterestList,
+                                quint32 knownListVersion) const;
+    void domainListEntryChanged(const SharedNodePointer& node);
+    bool assignMixersToNode(const SharedNodePointer& node, const NodeSet& nodeInterestList);
+    void recordMixerPingTimes(const SharedNodePointer& node, const QHash<QUuid, qint32>& pingTimes);
+    bool isStandbyMixer(const SharedNodePointer& mixer) const;
+    bool promoteStandbyMixer(NodeType_t mixerType);
+    void repointNodesFromMixer(const SharedNodePointer& mixer);
     
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
     void addStaticAssignmentToAssignmentHash(Assignment* newAssignment);
     void createStaticAssignmentsForType(Assignment::Type type, const QVariantList& configList);
     void populateDefaultStaticAssignmentsExcludingTypes(const QSet<Assignment::Type>& excludedTypes);
     void populateStaticScriptedAssignmentsFromSettings();
+    void populateStandbyMixerAssignments();
     
     SharedAssignmentPointer matchingQueuedAssignmentForCheckIn(const QUuid& checkInUUID, NodeType_t nodeType);
     SharedAssignmentPointer deployableAssignmentForRequest(const Assignment& requestAssignment);
@@ -143,7 +156,25 @@ private:
     QSet<QUuid> _webAuthenticationStateSet;
     QHash<QUuid, DomainServerWebSessionData> _cookieSessionHash;
     
-    QHash<QString, QByteArray> _userPublicKeys;
+    /// The access settings that every connect request checks, read out of the settings once rather than per request.
+    class ConnectPermissions {
+    public:
+        QSet<QString> allowedUsers; ///< lowercased
+        QSet<QString> allowedEditors; ///< lowercased
+    };
+    
+    ConnectPermissions _connectPermissions;
+    
+    /// A user's public key, and the signature that last checked out against it, which a reconnect need only compare to.
+    class UserPublicKey {
+    public:
+        QByteArray keyData;
+        QByteArray verifiedSignature;
+    };
+    
+    QHash<QString, UserPublicKey> _userPublicKeys; ///< by lowercased username
+    QSet<QString> _pendingPublicKeyRequests;
+    QHash<QString, quint64> _publicKeyFetchTimes; ///< when each user's last fetch came back, with a key or without
     
     QHash<QUuid, NetworkPeer> _connectingICEPeers;
     QHash<QUuid, HifiSockAddr> _connectedICEPeers;
@@ -153,6 +184,29 @@ private:
     DomainServerSettingsManager _settingsManager;
     
     HifiSockAddr _iceServerSocket;
+    
+    class DomainListRemoval {
+    public:
+        quint32 listVersion;
+        QUuid uuid;
+        NodeType_t type;
+    };
+    
+    quint32 _domainListVersion;
+    QList<DomainListRemoval> _domainListRemovals;
+    quint32 _oldestDeltaListVersion;
+    
+    class MixerLoad {
+    public:
+        NodeType_t type;
+        int numAssignedNodes;
+        quint64 emptySince;
+    };
+    
+    QHash<QUuid, MixerLoad> _mixerLoads;
+    QHash<quint32, QHash<QUuid, float> > _networkMixerRTTs; ///< smoothed ping times to the mixers, by node network
+    QSet<QUuid> _scaledAssignmentUUIDs;
+    QSet<QUuid> _standbyAssignmentUUIDs;
 };
 
 
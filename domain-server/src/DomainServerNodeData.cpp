@@ -25,7 +25,10 @@ DomainServerNodeData::DomainServerNodeData() :
     _paymentIntervalTimer(),
     _statsJSONObject(),
     _sendingSockAddr(),
-    _isAuthenticated(true)
+    _isAuthenticated(true),
+    _listVersion(0),
+    _listInterestSet(),
+    _mixerHash()
 {
     _paymentIntervalTimer.start();
 }
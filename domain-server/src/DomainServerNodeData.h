@@ -18,6 +18,7 @@
 #include <QtCore/QUuid>
 
 #include <HifiSockAddr.h>
+#include <LimitedNodeList.h>
 #include <NodeData.h>
 
 class DomainServerNodeData : public NodeData {
@@ -47,6 +48,17 @@ public:
     bool isAuthenticated() const { return _isAuthenticated; }
     
     QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
+    
+    /// The domain list version at which this node was added or its entry in the list last changed.
+    void setListVersion(quint32 listVersion) { _listVersion = listVersion; }
+    quint32 getListVersion() const { return _listVersion; }
+    
+    /// The interest set the node's last list was sent for, which a delta is only good against.
+    void setListInterestSet(const NodeSet& listInterestSet) { _listInterestSet = listInterestSet; }
+    const NodeSet& getListInterestSet() const { return _listInterestSet; }
+    
+    /// The mixer of each scalable type that this node is sent in its list, when there's more than one to choose from.
+    QHash<NodeType_t, QUuid>& getMixerHash() { return _mixerHash; }
 private:
     QJsonObject mergeJSONStatsFromNewObject(const QJsonObject& newObject, QJsonObject destinationObject);
     
@@ -58,6 +70,9 @@ private:
     QJsonObject _statsJSONObject;
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated;
+    quint32 _listVersion;
+    NodeSet _listInterestSet;
+    QHash<NodeType_t, QUuid> _mixerHash;
 };
 
 #endif // hifi_DomainServerNodeData_h
@@ -29,6 +29,11 @@ int main(int argc, char* argv[]) {
     
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
     
+    const char* logFileString = getCmdOption(argc, (const char**)argv, LOG_FILE_PARAMETER);
+    if (logFileString) {
+        LogHandler::getInstance().setOutputFile(logFileString);
+    }
+    
     int currentExitCode = 0;
     
     // use a do-while to handle domain-server restart
@@ -9,19 +9,23 @@
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 
+var hotPlaces = [
+    "hifi://starchamber",
+    "hifi://apartment",
+    "hifi://rivenglen",
+    "hifi://sanfrancisco",
+    "hifi://porto",
+    "hifi://hoo"
+];
+
+// look the places up now so a key press doesn't have to wait on it
+for (var i = 0; i < hotPlaces.length; i++) {
+    location.prefetchLookupString(hotPlaces[i]);
+}
 
 Controller.keyPressEvent.connect(function (event) {
-    if (event.text == "1") {
-        Window.location = "hifi://starchamber";
-    } else if (event.text == "2") {
-    	Window.location = "hifi://apartment";
-    } else if (event.text == "3") {
-    	Window.location = "hifi://rivenglen";
-    } else if (event.text == "4") {
-    	Window.location = "hifi://sanfrancisco";
-    } else if (event.text == "5") {
-    	Window.location = "hifi://porto";
-    } else if (event.text == "6") {
-    	Window.location = "hifi://hoo";
-    } 
+    var index = parseInt(event.text) - 1;
+    if (index >= 0 && index < hotPlaces.length) {
+        Window.location = hotPlaces[index];
+    }
 });
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QTimer>
 
 #include <LimitedNodeList.h>
@@ -20,6 +22,12 @@
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// a slot comes back around one interval after everyone in it has passed the silence threshold
+const int NUM_EXPIRY_WHEEL_SLOTS = PEER_SILENCE_THRESHOLD_MSECS / CLEAR_INACTIVE_PEERS_INTERVAL_MSECS + 2;
+
+// the datagrams are taken in batches of this many, between which the timers and monitoring requests get their turn
+const int MAX_DATAGRAMS_PER_BATCH = 256;
+
 const quint16 ICE_SERVER_MONITORING_PORT = 40110;
 
 IceServer::IceServer(int argc, char* argv[]) :
@@ -27,13 +35,40 @@ IceServer::IceServer(int argc, char* argv[]) :
     _id(QUuid::createUuid()),
     _serverSocket(),
     _activePeers(),
-    _httpManager(ICE_SERVER_MONITORING_PORT, QString("%1/web/").arg(QCoreApplication::applicationDirPath()), this)
+    _httpManager(ICE_SERVER_MONITORING_PORT, QString("%1/web/").arg(QCoreApplication::applicationDirPath()), this),
+    _incomingPacket(),
+    _outgoingPacket(MAX_PACKET_SIZE, 0),
+    _processDatagramsQueued(false),
+    _expiryWheel(NUM_EXPIRY_WHEEL_SLOTS),
+    _peerExpirySlots(),
+    _currentExpirySlot(0),
+    _statsStartUsecs(usecTimestampNow()),
+    _totalHeartbeats(0),
+    _totalResponsePackets(0),
+    _totalBytesReceived(0),
+    _totalBytesSent(0),
+    _totalPeersExpired(0),
+    _heartbeatsPerSecond(0.0f),
+    _responsePacketsPerSecond(0.0f),
+    _bytesReceivedPerSecond(0.0f),
+    _bytesSentPerSecond(0.0f),
+    _intervalHeartbeats(0),
+    _intervalResponsePackets(0),
+    _intervalBytesReceived(0),
+    _intervalBytesSent(0),
+    _intervalStartUsecs(_statsStartUsecs)
 {
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
     qDebug() << "monitoring http endpoint is listening on " << ICE_SERVER_MONITORING_PORT;
     _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
     
+    // a large receive buffer lets a burst of heartbeats wait for us instead of being dropped
+    const int ICE_SERVER_RECEIVE_BUFFER_BYTES = 4 * 1024 * 1024;
+    _serverSocket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, ICE_SERVER_RECEIVE_BUFFER_BYTES);
+    
+    _incomingPacket.reserve(MAX_PACKET_SIZE);
+    
     // call our process datagrams slot when the UDP socket has packets ready
     connect(&_serverSocket, &QUdpSocket::readyRead, this, &IceServer::processDatagrams);
     
@@ -45,79 +80,107 @@ IceServer::IceServer(int argc, char* argv[]) :
 }
 
 void IceServer::processDatagrams() {
+    _processDatagramsQueued = false;
+    
     HifiSockAddr sendingSockAddr;
-    QByteArray incomingPacket;
     
-    while (_serverSocket.hasPendingDatagrams()) {
-        incomingPacket.resize(_serverSocket.pendingDatagramSize());
+    for (int i = 0; i < MAX_DATAGRAMS_PER_BATCH; i++) {
+        if (!_serverSocket.hasPendingDatagrams()) {
+            return;
+        }
+        _incomingPacket.resize(_serverSocket.pendingDatagramSize());
         
-        _serverSocket.readDatagram(incomingPacket.data(), incomingPacket.size(),
+        _serverSocket.readDatagram(_incomingPacket.data(), _incomingPacket.size(),
                                    sendingSockAddr.getAddressPointer(), sendingSockAddr.getPortPointer());
         
+        _intervalBytesReceived += _incomingPacket.size();
         
-        if (packetTypeForPacket(incomingPacket) == PacketTypeIceServerHeartbeat) {
-            QUuid senderUUID = uuidFromPacketHeader(incomingPacket);
-            
-            // pull the public and private sock addrs for this peer
-            HifiSockAddr publicSocket, localSocket;
-            
-            QDataStream hearbeatStream(incomingPacket);
-            hearbeatStream.skipRawData(numBytesForPacketHeader(incomingPacket));
-            
-            hearbeatStream >> publicSocket >> localSocket;
-            
-            // make sure we have this sender in our peer hash
-            SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
-            
-            if (!matchingPeer) {
-                // if we don't have this sender we need to create them now
-                matchingPeer = SharedNetworkPeer(new NetworkPeer(senderUUID, publicSocket, localSocket));
-                _activePeers.insert(senderUUID, matchingPeer);
-                
-                qDebug() << "Added a new network peer" << *matchingPeer;
-            } else {
-                // we already had the peer so just potentially update their sockets
-                matchingPeer->setPublicSocket(publicSocket);
-                matchingPeer->setLocalSocket(localSocket);
-                
-                qDebug() << "Matched hearbeat to existing network peer" << *matchingPeer;
-            }
-            
-            // update our last heard microstamp for this network peer to now
-            matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-            
-            // check if this node also included a UUID that they would like to connect to
-            QUuid connectRequestID;
-            hearbeatStream >> connectRequestID;
-            
-            // get the peers asking for connections with this peer
-            QSet<QUuid>& requestingConnections = _currentConnections[senderUUID];
-            
-            if (!connectRequestID.isNull()) {
-                qDebug() << "Peer wants to connect to peer with ID" << uuidStringWithoutCurlyBraces(connectRequestID);
-                
-                // ensure this peer is in the set of current connections for the peer with ID it wants to connect with
-                _currentConnections[connectRequestID].insert(senderUUID);
-                
-                // add the ID of the node they have said they would like to connect to
-                requestingConnections.insert(connectRequestID);
-            }
-            
-            if (requestingConnections.size() > 0) {
-                // send a heartbeart response based on the set of connections
-                qDebug() << "Sending a heartbeat response to" << senderUUID << "who has" << requestingConnections.size()
-                    << "potential connections";
-                sendHeartbeatResponse(sendingSockAddr, requestingConnections);
-            }
+        if (packetTypeForPacket(_incomingPacket) == PacketTypeIceServerHeartbeat) {
+            processHeartbeat(_incomingPacket, sendingSockAddr);
         }
     }
+    
+    // there's more waiting, so come back to it once everything else has had a look in
+    if (_serverSocket.hasPendingDatagrams() && !_processDatagramsQueued) {
+        _processDatagramsQueued = true;
+        QMetaObject::invokeMethod(this, "processDatagrams", Qt::QueuedConnection);
+    }
+}
+
+void IceServer::processHeartbeat(const QByteArray& heartbeatPacket, const HifiSockAddr& sendingSockAddr) {
+    _intervalHeartbeats++;
+    
+    QUuid senderUUID = uuidFromPacketHeader(heartbeatPacket);
+    
+    // pull the public and private sock addrs for this peer
+    HifiSockAddr publicSocket, localSocket;
+    
+    QDataStream hearbeatStream(heartbeatPacket);
+    hearbeatStream.skipRawData(numBytesForPacketHeader(heartbeatPacket));
+    
+    hearbeatStream >> publicSocket >> localSocket;
+    
+    // make sure we have this sender in our peer hash
+    SharedNetworkPeer& matchingPeer = _activePeers[senderUUID];
+    
+    if (!matchingPeer) {
+        // if we don't have this sender we need to create them now
+        matchingPeer = SharedNetworkPeer(new NetworkPeer(senderUUID, publicSocket, localSocket));
+        
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(publicSocket);
+        matchingPeer->setLocalSocket(localSocket);
+    }
+    
+    // update our last heard microstamp for this network peer to now
+    matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+    updateExpirySlot(senderUUID);
+    
+    // check if this node also included a UUID that they would like to connect to
+    QUuid connectRequestID;
+    hearbeatStream >> connectRequestID;
+    
+    // get the peers asking for connections with this peer
+    QSet<QUuid>& requestingConnections = _currentConnections[senderUUID];
+    
+    if (!connectRequestID.isNull()) {
+        qDebug() << "Peer wants to connect to peer with ID" << uuidStringWithoutCurlyBraces(connectRequestID);
+        
+        // ensure this peer is in the set of current connections for the peer with ID it wants to connect with
+        _currentConnections[connectRequestID].insert(senderUUID);
+        
+        // add the ID of the node they have said they would like to connect to
+        requestingConnections.insert(connectRequestID);
+    }
+    
+    if (requestingConnections.size() > 0) {
+        // send a heartbeart response based on the set of connections
+        sendHeartbeatResponse(sendingSockAddr, requestingConnections);
+    }
+}
+
+void IceServer::updateExpirySlot(const QUuid& peerID) {
+    QHash<QUuid, int>::iterator expirySlot = _peerExpirySlots.find(peerID);
+    if (expirySlot == _peerExpirySlots.end()) {
+        _peerExpirySlots.insert(peerID, _currentExpirySlot);
+        
+    } else if (expirySlot.value() != _currentExpirySlot) {
+        _expiryWheel[expirySlot.value()].remove(peerID);
+        expirySlot.value() = _currentExpirySlot;
+        
+    } else {
+        // already in the slot for this interval
+        return;
+    }
+    _expiryWheel[_currentExpirySlot].insert(peerID);
 }
 
 void IceServer::sendHeartbeatResponse(const HifiSockAddr& destinationSockAddr, QSet<QUuid>& connections) {
     QSet<QUuid>::iterator peerID = connections.begin();
     
-    QByteArray outgoingPacket(MAX_PACKET_SIZE, 0);
-    int currentPacketSize = populatePacketHeader(outgoingPacket, PacketTypeIceServerHeartbeatResponse, _id);
+    int currentPacketSize = populatePacketHeader(_outgoingPacket, PacketTypeIceServerHeartbeatResponse, _id);
     int numHeaderBytes = currentPacketSize;
     
     // go through the connections, sending packets containing connection information for those nodes
@@ -131,16 +194,13 @@ void IceServer::sendHeartbeatResponse(const HifiSockAddr& destinationSockAddr, Q
             QByteArray peerBytes = matchingPeer->toByteArray();
             
             if (currentPacketSize + peerBytes.size() > MAX_PACKET_SIZE) {
-                // write the current packet
-                _serverSocket.writeDatagram(outgoingPacket.data(), currentPacketSize,
-                                            destinationSockAddr.getAddress(), destinationSockAddr.getPort());
-                
-                // reset the packet size to our number of header bytes
-                currentPacketSize = populatePacketHeader(outgoingPacket, PacketTypeIceServerHeartbeatResponse, _id);
+                // write the current packet, and start the next after its header
+                writeResponsePacket(currentPacketSize, destinationSockAddr);
+                currentPacketSize = numHeaderBytes;
             }
             
-            // append the current peer bytes
-            outgoingPacket.insert(currentPacketSize, peerBytes);
+            // copy the current peer bytes in after what's there, in the buffer we keep for the responses
+            memcpy(_outgoingPacket.data() + currentPacketSize, peerBytes.constData(), peerBytes.size());
             currentPacketSize += peerBytes.size();
             
             ++peerID;
@@ -149,25 +209,81 @@ void IceServer::sendHeartbeatResponse(const HifiSockAddr& destinationSockAddr, Q
     
     if (currentPacketSize > numHeaderBytes) {
         // write the last packet, if there is data in it
-        _serverSocket.writeDatagram(outgoingPacket.data(), currentPacketSize,
-                                    destinationSockAddr.getAddress(), destinationSockAddr.getPort());
+        writeResponsePacket(currentPacketSize, destinationSockAddr);
     }
 }
 
+void IceServer::writeResponsePacket(int packetSize, const HifiSockAddr& destinationSockAddr) {
+    _serverSocket.writeDatagram(_outgoingPacket.constData(), packetSize,
+                                destinationSockAddr.getAddress(), destinationSockAddr.getPort());
+    _intervalResponsePackets++;
+    _intervalBytesSent += packetSize;
+}
+
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+    quint64 now = usecTimestampNow();
     
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+    // the slot we're moving into holds the peers that haven't been heard since it was last the current one
+    _currentExpirySlot = (_currentExpirySlot + 1) % NUM_EXPIRY_WHEEL_SLOTS;
+    QSet<QUuid>& expiringPeers = _expiryWheel[_currentExpirySlot];
+    
+    QSet<QUuid>::iterator peerID = expiringPeers.begin();
+    while (peerID != expiringPeers.end()) {
+        SharedNetworkPeer peer = _activePeers.value(*peerID);
         
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
-            qDebug() << "Removing peer from memory for inactivity -" << *peer;
-            peerItem = _activePeers.erase(peerItem);
+        if (!peer || (now - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+            if (peer) {
+                qDebug() << "Removing peer from memory for inactivity -" << *peer;
+            }
+            _activePeers.remove(*peerID);
+            _currentConnections.remove(*peerID);
+            _peerExpirySlots.remove(*peerID);
+            _totalPeersExpired++;
+            
+            peerID = expiringPeers.erase(peerID);
         } else {
             // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
+            ++peerID;
         }
     }
+    
+    // fold this interval into the totals, and keep its rates for the monitoring endpoint
+    float intervalSeconds = (float)(now - _intervalStartUsecs) / USECS_PER_SECOND;
+    if (intervalSeconds > 0.0f) {
+        _heartbeatsPerSecond = _intervalHeartbeats / intervalSeconds;
+        _responsePacketsPerSecond = _intervalResponsePackets / intervalSeconds;
+        _bytesReceivedPerSecond = _intervalBytesReceived / intervalSeconds;
+        _bytesSentPerSecond = _intervalBytesSent / intervalSeconds;
+    }
+    _totalHeartbeats += _intervalHeartbeats;
+    _totalResponsePackets += _intervalResponsePackets;
+    _totalBytesReceived += _intervalBytesReceived;
+    _totalBytesSent += _intervalBytesSent;
+    
+    _intervalHeartbeats = 0;
+    _intervalResponsePackets = 0;
+    _intervalBytesReceived = 0;
+    _intervalBytesSent = 0;
+    _intervalStartUsecs = now;
+}
+
+QByteArray IceServer::statsJSON() const {
+    QJsonObject statsObject;
+    statsObject["active_peers"] = _activePeers.size();
+    statsObject["uptime_seconds"] = (double)(usecTimestampNow() - _statsStartUsecs) / USECS_PER_SECOND;
+    
+    statsObject["heartbeats_per_second"] = _heartbeatsPerSecond;
+    statsObject["response_packets_per_second"] = _responsePacketsPerSecond;
+    statsObject["bytes_received_per_second"] = _bytesReceivedPerSecond;
+    statsObject["bytes_sent_per_second"] = _bytesSentPerSecond;
+    
+    statsObject["total_heartbeats"] = (double)_totalHeartbeats;
+    statsObject["total_response_packets"] = (double)_totalResponsePackets;
+    statsObject["total_bytes_received"] = (double)_totalBytesReceived;
+    statsObject["total_bytes_sent"] = (double)_totalBytesSent;
+    statsObject["total_peers_expired"] = (double)_totalPeersExpired;
+    
+    return QJsonDocument(statsObject).toJson();
 }
 
 bool IceServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
@@ -179,6 +295,8 @@ bool IceServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, b
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation) {
         if (url.path() == "/status") {
             connection->respond(HTTPConnection::StatusCode200, QByteArray::number(_activePeers.size()));
+        } else if (url.path() == "/stats") {
+            connection->respond(HTTPConnection::StatusCode200, statsJSON(), "application/json");
         }
     }
     return true;
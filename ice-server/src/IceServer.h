@@ -14,6 +14,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
 #include <QUdpSocket>
 
 #include <NetworkPeer.h>
@@ -32,13 +33,47 @@ private slots:
     void clearInactivePeers();
 private:
     
+    void processHeartbeat(const QByteArray& heartbeatPacket, const HifiSockAddr& sendingSockAddr);
     void sendHeartbeatResponse(const HifiSockAddr& destinationSockAddr, QSet<QUuid>& connections);
+    void writeResponsePacket(int packetSize, const HifiSockAddr& destinationSockAddr);
+    
+    void updateExpirySlot(const QUuid& peerID);
+    
+    QByteArray statsJSON() const;
     
     QUuid _id;
     QUdpSocket _serverSocket;
     NetworkPeerHash _activePeers;
     QHash<QUuid, QSet<QUuid> > _currentConnections;
     HTTPManager _httpManager;
+    
+    QByteArray _incomingPacket;
+    QByteArray _outgoingPacket;
+    bool _processDatagramsQueued;
+    
+    // a timing wheel of the peers by the interval they were last heard in, so that checking for the silent ones only
+    // looks at the slot that's coming back around
+    QVector<QSet<QUuid> > _expiryWheel;
+    QHash<QUuid, int> _peerExpirySlots;
+    int _currentExpirySlot;
+    
+    quint64 _statsStartUsecs;
+    quint64 _totalHeartbeats;
+    quint64 _totalResponsePackets;
+    quint64 _totalBytesReceived;
+    quint64 _totalBytesSent;
+    quint64 _totalPeersExpired;
+    
+    // the rates over the last full interval of the inactive peer timer
+    float _heartbeatsPerSecond;
+    float _responsePacketsPerSecond;
+    float _bytesReceivedPerSecond;
+    float _bytesSentPerSecond;
+    quint64 _intervalHeartbeats;
+    quint64 _intervalResponsePackets;
+    quint64 _intervalBytesReceived;
+    quint64 _intervalBytesSent;
+    quint64 _intervalStartUsecs;
 };
 
 #endif // hifi_IceServer_h
\ No newline at end of file
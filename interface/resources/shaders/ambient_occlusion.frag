@@ -45,6 +45,9 @@ uniform float radius;
 // the scale for the noise texture
 uniform vec2 noiseScale;
 
+// the offset of the noise texture, moved each frame when the frames are accumulated
+uniform vec2 noiseOffset;
+
 // given a texture coordinate, returns the 3D view space z coordinate
 float texCoordToViewSpaceZ(vec2 texCoord) {
     return (far * near) / (texture2D(depthTexture, texCoord * texCoordScale + texCoordOffset).r * (far - near) - far);
@@ -57,7 +60,7 @@ vec3 texCoordToViewSpace(vec2 texCoord) {
 }
 
 void main(void) {
-    vec3 rotationX = texture2D(rotationTexture, gl_TexCoord[0].st * noiseScale).rgb;
+    vec3 rotationX = texture2D(rotationTexture, gl_TexCoord[0].st * noiseScale + noiseOffset).rgb;
     vec3 rotationY = normalize(cross(rotationX, vec3(0.0, 0.0, 1.0)));
     mat3 rotation = mat3(rotationX, rotationY, cross(rotationX, rotationY));
     
@@ -75,5 +78,8 @@ void main(void) {
         occlusion += 1.0 - step(offset.z, depth);
     }
     
-    gl_FragColor = vec4(occlusion, occlusion, occlusion, 0.0) / 16.0;
+    // the linear depth goes along in green and blue, for the passes that follow to tell the surfaces apart
+    vec2 packedDepth = fract(vec2(1.0, 255.0) * (center.z / -far));
+    packedDepth.x -= packedDepth.y / 255.0;
+    gl_FragColor = vec4(occlusion / 16.0, packedDepth, 0.0);
 }
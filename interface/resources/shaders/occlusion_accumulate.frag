@@ -0,0 +1,82 @@
+#version 120
+
+//
+//  occlusion_accumulate.frag
+//  fragment shader
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+// the occlusion of this frame, with the linear depth packed in green and blue
+uniform sampler2D currentTexture;
+
+// the accumulated occlusion of the earlier frames, packed the same way
+uniform sampler2D historyTexture;
+
+// the distance to the near clip plane
+uniform float near;
+
+// the distance to the far clip plane
+uniform float far;
+
+// the left and bottom edges of the view window
+uniform vec2 leftBottom;
+
+// the right and top edges of the view window
+uniform vec2 rightTop;
+
+// the left and bottom edges of the previous frame's view window
+uniform vec2 previousLeftBottom;
+
+// the right and top edges of the previous frame's view window
+uniform vec2 previousRightTop;
+
+// takes the view space of this frame to that of the previous one
+uniform mat4 reprojection;
+
+// an offset value to apply to the texture coordinates
+uniform vec2 texCoordOffset;
+
+// a scale value to apply to the texture coordinates
+uniform vec2 texCoordScale;
+
+// takes the texture coordinates of the framebuffer to those of the occlusion textures, which may be a little larger
+uniform vec2 occlusionScale;
+
+// how much of this frame's occlusion goes into the accumulated one
+uniform float currentWeight;
+
+// the difference in depth, relative to the depth, beyond which the history is of another surface
+uniform float depthTolerance;
+
+float unpackDepth(vec2 packedDepth) {
+    return dot(packedDepth, vec2(1.0, 1.0 / 255.0));
+}
+
+void main(void) {
+    vec2 texCoord = gl_TexCoord[0].st;
+    vec4 current = texture2D(currentTexture, (texCoord * texCoordScale + texCoordOffset) * occlusionScale);
+    float z = -far * unpackDepth(current.gb);
+    vec3 position = vec3((leftBottom + texCoord * (rightTop - leftBottom)) * (-z / near), z);
+    
+    // find where the surface was in the previous frame's view
+    vec3 previousPosition = (reprojection * vec4(position, 1.0)).xyz;
+    vec2 previousTexCoord = (previousPosition.xy * (near / -previousPosition.z) - previousLeftBottom) /
+        (previousRightTop - previousLeftBottom);
+    
+    float occlusion = current.r;
+    if (previousPosition.z < 0.0 && all(greaterThanEqual(previousTexCoord, vec2(0.0, 0.0))) &&
+            all(lessThanEqual(previousTexCoord, vec2(1.0, 1.0)))) {
+        vec4 history = texture2D(historyTexture, (previousTexCoord * texCoordScale + texCoordOffset) * occlusionScale);
+        float previousDepth = previousPosition.z / -far;
+        
+        // what was there may have been something else, that has since moved or been uncovered
+        if (abs(unpackDepth(history.gb) - previousDepth) <= depthTolerance * previousDepth) {
+            occlusion = mix(history.r, current.r, currentWeight);
+        }
+    }
+    gl_FragColor = vec4(occlusion, current.gb, 0.0);
+}
@@ -0,0 +1,66 @@
+#version 120
+
+//
+//  occlusion_upsample.frag
+//  fragment shader
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+// the occlusion, at its own resolution, with the linear depth packed in green and blue
+uniform sampler2D occlusionTexture;
+
+// the depth texture, at the full resolution
+uniform sampler2D depthTexture;
+
+// the distance to the near clip plane
+uniform float near;
+
+// the distance to the far clip plane
+uniform float far;
+
+// the size of a texel of the occlusion texture
+uniform vec2 texelSize;
+
+// takes the texture coordinates of the framebuffer to those of the occlusion texture, which may be a little larger
+uniform vec2 occlusionScale;
+
+float unpackDepth(vec2 packedDepth) {
+    return dot(packedDepth, vec2(1.0, 1.0 / 255.0));
+}
+
+// the weight of an occlusion texel: bilinear, but falling off as its depth differs from that of the pixel, so that
+// the occlusion of one surface doesn't bleed onto another across an edge
+float getWeight(vec4 texel, float depth, float bilinearWeight) {
+    const float MIN_BILINEAR_WEIGHT = 0.01;
+    const float MIN_DEPTH_DIFFERENCE = 0.0001;
+    float depthDifference = max(abs(unpackDepth(texel.gb) - depth), MIN_DEPTH_DIFFERENCE * depth);
+    return (bilinearWeight + MIN_BILINEAR_WEIGHT) / depthDifference;
+}
+
+void main(void) {
+    // the linear depth of this pixel, as the occlusion pass packs it
+    float z = (far * near) / (texture2D(depthTexture, gl_TexCoord[0].st).r * (far - near) - far);
+    float depth = z / -far;
+    
+    // the four occlusion texels around the pixel
+    vec2 coord = gl_TexCoord[0].st * occlusionScale / texelSize - vec2(0.5, 0.5);
+    vec2 fraction = fract(coord);
+    vec2 base = (floor(coord) + vec2(0.5, 0.5)) * texelSize;
+    vec4 bottomLeft = texture2D(occlusionTexture, base);
+    vec4 bottomRight = texture2D(occlusionTexture, base + vec2(texelSize.s, 0.0));
+    vec4 topLeft = texture2D(occlusionTexture, base + vec2(0.0, texelSize.t));
+    vec4 topRight = texture2D(occlusionTexture, base + texelSize);
+    
+    vec4 weights = vec4(getWeight(bottomLeft, depth, (1.0 - fraction.s) * (1.0 - fraction.t)),
+        getWeight(bottomRight, depth, fraction.s * (1.0 - fraction.t)),
+        getWeight(topLeft, depth, (1.0 - fraction.s) * fraction.t),
+        getWeight(topRight, depth, fraction.s * fraction.t));
+    float occlusion = dot(vec4(bottomLeft.r, bottomRight.r, topLeft.r, topRight.r), weights) /
+        max(dot(weights, vec4(1.0, 1.0, 1.0, 1.0)), 0.0001);
+    
+    gl_FragColor = vec4(occlusion, occlusion, occlusion, 1.0);
+}
@@ -34,7 +34,6 @@
 #include <QMenuBar>
 #include <QMouseEvent>
 #include <QNetworkReply>
-#include <QNetworkDiskCache>
 #include <QOpenGLFramebufferObject>
 #include <QObject>
 #include <QWheelEvent>
@@ -45,6 +44,8 @@
 #include <QUrl>
 #include <QWindow>
 #include <QtDebug>
+#include <QDateTime>
+#include <QFile>
 #include <QFileDialog>
 #include <QDesktopServices>
 #include <QXmlStreamReader>
@@ -75,6 +76,7 @@
 #include <ProgramObject.h>
 #include <ResourceCache.h>
 #include <ScriptCache.h>
+#include <ScriptSourceCache.h>
 #include <SettingHandle.h>
 #include <SoundCache.h>
 #include <TextRenderer.h>
@@ -185,14 +187,6 @@ public:
 };
 #endif
 
-void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
-    QString logMessage = LogHandler::getInstance().printMessage((LogMsgType) type, context, message);
-    
-    if (!logMessage.isEmpty()) {
-        Application::getInstance()->getLogger()->addMessage(qPrintable(logMessage + "\n"));
-    }
-}
-
 bool setupEssentials(int& argc, char** argv) {
     unsigned int listenPort = 0; // bind to an ephemeral port by default
     const char** constArgv = const_cast<const char**>(argv);
@@ -244,12 +238,14 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
         _toolWindow(NULL),
         _nodeThread(new QThread(this)),
         _datagramProcessor(),
+        _frameCapture(_datagramProcessor),
         _undoStack(),
         _undoStackScriptingInterface(&_undoStack),
         _frameCount(0),
         _fps(60.0f),
         _justStarted(true),
         _physicsEngine(glm::vec3(0.0f)),
+        _physicsThread(&_physicsEngine),
         _entities(true, this, this),
         _entityClipboardRenderer(false, this, this),
         _entityClipboard(),
@@ -283,14 +279,19 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
         _lastSendDownstreamAudioStats(usecTimestampNow()),
         _isVSyncOn(true),
         _aboutToQuit(false),
-        _notifiedPacketVersionMismatchThisDomain(false)
+        _notifiedPacketVersionMismatchThisDomain(false),
+        _domainChangedAt(0)
 {
 #ifdef Q_OS_WIN
     installNativeEventFilter(&MyNativeEventFilter::getInstance());
 #endif
 
     _logger = new FileLogger(this);  // After setting organization name in order to get correct directory
-    qInstallMessageHandler(messageHandler);
+
+    // the messages reach the logger from the log handler's thread, once they're printed
+    connect(&LogHandler::getInstance(), &LogHandler::messagePrinted, _logger, &FileLogger::addMessage,
+        Qt::DirectConnection);
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
 
     QFontDatabase::addApplicationFont(PathUtils::resourcesPath() + "styles/Inconsolata.otf");
     _window->setWindowTitle("Interface");
@@ -396,6 +397,10 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
     addressManager->setOrientationGetter(getOrientationForPath);
     
     connect(addressManager.data(), &AddressManager::rootPlaceNameChanged, this, &Application::updateWindowTitle);
+    
+    // start loading the models of places we might go to, if we've been there before
+    connect(addressManager.data(), &AddressManager::possibleDomainChangeAhead,
+            &_entities, &EntityTreeRenderer::prefetchDomainModels);
 
     #ifdef _WIN32
     WSADATA WsaData;
@@ -427,11 +432,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
     billboardPacketTimer->start(AVATAR_BILLBOARD_PACKET_SEND_INTERVAL_MSECS);
 
     QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
-    QNetworkDiskCache* cache = new QNetworkDiskCache();
-    cache->setMaximumCacheSize(MAXIMUM_CACHE_SIZE);
-    cache->setCacheDirectory(!cachePath.isEmpty() ? cachePath : "interfaceCache");
-    networkAccessManager.setCache(cache);
+    NetworkAccessManager::setDiskCache(!cachePath.isEmpty() ? cachePath : "interfaceCache", MAXIMUM_CACHE_SIZE);
 
     ResourceCache::setRequestLimit(3);
 
@@ -526,6 +527,10 @@ Application::~Application() {
     
     _entities.getTree()->setSimulation(NULL);
     qInstallMessageHandler(NULL);
+
+    // once the handler's drained nothing more is on its way to the logger
+    disconnect(&LogHandler::getInstance(), 0, _logger, 0);
+    LogHandler::getInstance().flush();
     
     _window->saveGeometry();
     
@@ -554,6 +559,7 @@ Application::~Application() {
     audioIO->thread()->quit();
     audioIO->thread()->wait();
     
+    _physicsThread.terminate();
     _octreeProcessor.terminate();
     _entityEditSender.terminate();
 
@@ -640,7 +646,13 @@ void Application::initializeGL() {
 
 void Application::paintGL() {
     PROFILE_RANGE(__FUNCTION__);
-    PerformanceTimer perfTimer("paintGL");
+    PERFORMANCE_TIMER("paintGL");
+
+    // the gpu stats count what this frame draws
+    gpu::GLBackend::resetStats();
+
+    DependencyManager::get<TextureCache>()->uploadPendingTextures();
+    DependencyManager::get<TextureCache>()->enforceTextureMemoryBudget();
 
     PerformanceWarning::setSuppressShortTimings(Menu::getInstance()->isOptionChecked(MenuOption::SuppressShortTimings));
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
@@ -735,7 +747,8 @@ void Application::paintGL() {
         DependencyManager::get<GlowEffect>()->render();
 
         {
-            PerformanceTimer perfTimer("renderOverlay");
+            PERFORMANCE_TIMER("renderOverlay");
+            LODManager::SubsystemTimer lodTimer(LODManager::OVERLAYS_SUBSYSTEM);
             // PrioVR will only work if renderOverlay is called, calibration is connected to Application::renderingOverlay() 
             _applicationOverlay.renderOverlay(true);
             if (Menu::getInstance()->isOptionChecked(MenuOption::UserInterface)) {
@@ -765,6 +778,20 @@ void Application::showEditEntitiesHelp() {
     InfoView::forcedShow(INFO_EDIT_ENTITIES_PATH);
 }
 
+void Application::saveTimingTrace() {
+    // the trace has the last few thousand timed scopes of each thread, to load into chrome://tracing
+    QString fileName = QString("%1/hifi-trace-%2.json")
+        .arg(QStandardPaths::writableLocation(QStandardPaths::DesktopLocation))
+        .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss"));
+    QFile traceFile(fileName);
+    if (traceFile.open(QIODevice::WriteOnly)) {
+        traceFile.write(PerformanceTimer::getChromeTrace());
+        qDebug() << "Saved the timing trace to" << fileName;
+    } else {
+        qDebug() << "Couldn't save the timing trace to" << fileName << "-" << traceFile.errorString();
+    }
+}
+
 void Application::resetCamerasOnResizeGL(Camera& camera, int width, int height) {
     if (OculusManager::isConnected()) {
         OculusManager::configureCamera(camera, width, height);
@@ -1431,7 +1458,7 @@ void Application::timer() {
 }
 
 void Application::idle() {
-    PerformanceTimer perfTimer("idle");
+    PERFORMANCE_TIMER("idle");
 
     // Normally we check PipelineWarnings, but since idle will often take more than 10ms we only show these idle timing
     // details if we're in ExtraDebugging mode. However, the ::update() and it's subcomponents will show their timing
@@ -1449,18 +1476,26 @@ void Application::idle() {
     if (timeSinceLastUpdate > targetFramePeriod) {
         _lastTimeUpdated.start();
         {
-            PerformanceTimer perfTimer("update");
+            PERFORMANCE_TIMER("update");
             PerformanceWarning warn(showWarnings, "Application::idle()... update()");
             const float BIGGEST_DELTA_TIME_SECS = 0.25f;
-            update(glm::clamp((float)timeSinceLastUpdate / 1000.0f, 0.0f, BIGGEST_DELTA_TIME_SECS));
+            float deltaTime = glm::clamp((float)timeSinceLastUpdate / 1000.0f, 0.0f, BIGGEST_DELTA_TIME_SECS);
+
+            // a replayed frame steps by the time it did when it was captured, so that it comes out the same
+            if (_frameCapture.isReplaying()) {
+                deltaTime = qMax(_frameCapture.beginReplayFrame(), 0.0f);
+            }
+            update(deltaTime);
+            _frameCapture.endUpdate(deltaTime);
         }
         {
-            PerformanceTimer perfTimer("updateGL");
+            PERFORMANCE_TIMER("updateGL");
             PerformanceWarning warn(showWarnings, "Application::idle()... updateGL()");
             DependencyManager::get<GLCanvas>()->updateGL();
         }
+        _frameCapture.endFrame();
         {
-            PerformanceTimer perfTimer("rest");
+            PERFORMANCE_TIMER("rest");
             PerformanceWarning warn(showWarnings, "Application::idle()... rest of it");
             _idleLoopStdev.addValue(timeSinceLastUpdate);
 
@@ -1534,6 +1569,11 @@ void Application::setLowVelocityFilter(bool lowVelocityFilter) {
     SixenseManager::getInstance().setLowVelocityFilter(lowVelocityFilter);
 }
 
+void Application::setParallelPhysicsSolver(bool parallelPhysicsSolver) {
+    // leave a core for the main thread, the physics thread itself solves one share of the islands
+    _physicsEngine.setNumSolverThreads(parallelPhysicsSolver ? qMax(QThread::idealThreadCount() - 1, 1) : 1);
+}
+
 bool Application::mouseOnScreen() const {
     if (OculusManager::isConnected()) {
         auto glCanvas = DependencyManager::get<GLCanvas>();
@@ -1602,7 +1642,10 @@ bool Application::exportEntities(const QString& filename, float x, float y, floa
             properties.setPosition(properties.getPosition() - root);
             exportTree.addEntity(id, properties);
         }
-        exportTree.writeToSVOFile(filename.toLocal8Bit().constData());
+        if (!exportTree.writeToSVOFile(filename.toLocal8Bit().constData())) {
+            qDebug() << "Unable to export the models to" << filename;
+            return false;
+        }
     } else {
         qDebug() << "No models were selected";
         return false;
@@ -1687,7 +1730,18 @@ void Application::init() {
         addressLookupString = arguments().value(urlIndex + 1);
     }
     
-    DependencyManager::get<AddressManager>()->loadSettings(addressLookupString);
+    // when --replay in command line, play back a frame capture in place of going to a domain, and when --capture,
+    // record one of this session
+    const QString HIFI_REPLAY_COMMAND_LINE_KEY = "--replay";
+    const QString HIFI_CAPTURE_COMMAND_LINE_KEY = "--capture";
+    int replayIndex = arguments().indexOf(HIFI_REPLAY_COMMAND_LINE_KEY);
+    int captureIndex = arguments().indexOf(HIFI_CAPTURE_COMMAND_LINE_KEY);
+    if (replayIndex == -1 || !_frameCapture.startReplay(arguments().value(replayIndex + 1))) {
+        if (captureIndex != -1) {
+            _frameCapture.startCapture(arguments().value(captureIndex + 1));
+        }
+        DependencyManager::get<AddressManager>()->loadSettings(addressLookupString);
+    }
     
     qDebug() << "Loaded settings";
     
@@ -1719,13 +1773,14 @@ void Application::init() {
     _physicsEngine.setEntityTree(tree);
     tree->setSimulation(&_physicsEngine);
     _physicsEngine.init(&_entityEditSender);
+    _physicsThread.initialize();
 
-    connect(&_physicsEngine, &EntitySimulation::entityCollisionWithEntity,
-            ScriptEngine::getEntityScriptingInterface(), &EntityScriptingInterface::entityCollisionWithEntity);
+    connect(&_physicsEngine, &EntitySimulation::entityCollisions, [](const EntityCollisions& collisions) {
+        ScriptEngine::getEntityScriptingInterface()->relayEntityCollisions(collisions);
+    });
 
     // connect the _entityCollisionSystem to our EntityTreeRenderer since that's what handles running entity scripts
-    connect(&_physicsEngine, &EntitySimulation::entityCollisionWithEntity,
-            &_entities, &EntityTreeRenderer::entityCollisionWithEntity);
+    connect(&_physicsEngine, &EntitySimulation::entityCollisions, &_entities, &EntityTreeRenderer::entityCollisions);
 
     // connect the _entities (EntityTreeRenderer) to our script engine's EntityScriptingInterface for firing
     // of events related clicking, hovering over, and entering entities
@@ -1783,7 +1838,7 @@ bool Application::isLookingAtMyAvatar(Avatar* avatar) {
 }
 
 void Application::updateLOD() {
-    PerformanceTimer perfTimer("LOD");
+    PERFORMANCE_TIMER("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!Menu::getInstance()->isOptionChecked(MenuOption::DisableAutoAdjustLOD) && !isThrottleRendering()) {
         DependencyManager::get<LODManager>()->autoAdjustLOD(_fps);
@@ -1793,7 +1848,7 @@ void Application::updateLOD() {
 }
 
 void Application::updateMouseRay() {
-    PerformanceTimer perfTimer("mouseRay");
+    PERFORMANCE_TIMER("mouseRay");
 
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMouseRay()");
@@ -1845,7 +1900,7 @@ void Application::updateDDE() {
 }
 
 void Application::updateMyAvatarLookAtPosition() {
-    PerformanceTimer perfTimer("lookAt");
+    PERFORMANCE_TIMER("lookAt");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMyAvatarLookAtPosition()");
 
@@ -1918,7 +1973,6 @@ void Application::updateMyAvatarLookAtPosition() {
 }
 
 void Application::updateThreads(float deltaTime) {
-    PerformanceTimer perfTimer("updateThreads");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateThreads()");
 
@@ -1930,7 +1984,6 @@ void Application::updateThreads(float deltaTime) {
 }
 
 void Application::updateMetavoxels(float deltaTime) {
-    PerformanceTimer perfTimer("updateMetavoxels");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMetavoxels()");
 
@@ -1956,7 +2009,6 @@ void Application::cameraMenuChanged() {
 }
 
 void Application::updateCamera(float deltaTime) {
-    PerformanceTimer perfTimer("updateCamera");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateCamera()");
 
@@ -1974,7 +2026,6 @@ void Application::updateCamera(float deltaTime) {
 }
 
 void Application::updateDialogs(float deltaTime) {
-    PerformanceTimer perfTimer("updateDialogs");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateDialogs()");
     auto dialogsManager = DependencyManager::get<DialogsManager>();
@@ -1992,7 +2043,6 @@ void Application::updateDialogs(float deltaTime) {
 }
 
 void Application::updateCursor(float deltaTime) {
-    PerformanceTimer perfTimer("updateCursor");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateCursor()");
 
@@ -2014,63 +2064,67 @@ void Application::setCursorVisible(bool visible) {
     updateCursorVisibility();
 }
 
-void Application::update(float deltaTime) {
-    bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
-    PerformanceWarning warn(showWarnings, "Application::update()");
-
-    updateLOD();
-    updateMouseRay(); // check what's under the mouse and update the mouse voxel
-    {
-        PerformanceTimer perfTimer("devices");
+void Application::setupUpdateJobs() {
+    // The phases run on the main thread in the order they're added here.  The dependencies are the ones each phase has
+    // on the results of an earlier one this frame, and they're what the critical path is traced through.
+    int lod = _updateJobs.addJob("lod", [this](float deltaTime) {
+        updateLOD();
+    });
+    _updateJobs.addJob("mouseRay", [this](float deltaTime) {
+        updateMouseRay(); // check what's under the mouse and update the mouse voxel
+    });
+    int devices = _updateJobs.addJob("devices", [this](float deltaTime) {
         DeviceTracker::updateAll();
         updateFaceshift();
         updateVisage();
         SixenseManager::getInstance().update(deltaTime);
         JoystickScriptingInterface::getInstance().update();
         _prioVR.update(deltaTime);
-
-    }
-    
-    // Dispatch input events
-    _controllerScriptingInterface.updateInputControllers();
-
-    updateThreads(deltaTime); // If running non-threaded, then give the threads some time to process...
-    
-    DependencyManager::get<AvatarManager>()->updateOtherAvatars(deltaTime); //loop through all the other avatars and simulate them...
-
-    updateMetavoxels(deltaTime); // update metavoxels
-    updateCamera(deltaTime); // handle various camera tweaks like off axis projection
-    updateDialogs(deltaTime); // update various stats dialogs if present
-    updateCursor(deltaTime); // Handle cursor updates
-
-    {
-        PerformanceTimer perfTimer("physics");
-        _physicsEngine.stepSimulation();
-    }
-
-    if (!_aboutToQuit) {
-        PerformanceTimer perfTimer("entities");
-        // NOTE: the _entities.update() call below will wait for lock 
-        // and will simulate entity motion (the EntityTree has been given an EntitySimulation).  
-        _entities.update(); // update the models...
-    }
-
-    {
-        PerformanceTimer perfTimer("overlays");
+    });
+    _updateJobs.addJob("inputControllers", [this](float deltaTime) {
+        // Dispatch input events
+        _controllerScriptingInterface.updateInputControllers();
+    });
+    int threads = _updateJobs.addJob("updateThreads", [this](float deltaTime) {
+        updateThreads(deltaTime); // If running non-threaded, then give the threads some time to process...
+    });
+    _updateJobs.addJob("otherAvatars", [this](float deltaTime) {
+        DependencyManager::get<AvatarManager>()->updateOtherAvatars(deltaTime); //loop through all the other avatars and simulate them...
+    });
+    _updateJobs.addJob("updateMetavoxels", [this](float deltaTime) {
+        updateMetavoxels(deltaTime); // update metavoxels
+    }, QVector<int>() << lod); // the metavoxel LOD threshold is updated with the rest
+    int camera = _updateJobs.addJob("updateCamera", [this](float deltaTime) {
+        updateCamera(deltaTime); // handle various camera tweaks like off axis projection
+    });
+    _updateJobs.addJob("updateDialogs", [this](float deltaTime) {
+        updateDialogs(deltaTime); // update various stats dialogs if present
+    });
+    _updateJobs.addJob("updateCursor", [this](float deltaTime) {
+        updateCursor(deltaTime); // Handle cursor updates
+    });
+    _updateJobs.addJob("entities", [this](float deltaTime) {
+        if (!_aboutToQuit) {
+            // NOTE: the _entities.update() call below will wait for lock 
+            // and will simulate entity motion (the EntityTree has been given an EntitySimulation).  
+            // The physics simulation steps on the _physicsThread, this is where the entities pick up its results.
+            _entities.update(); // update the models...
+        }
+    }, QVector<int>() << threads); // the packets given time above have to be in the tree first
+    _updateJobs.addJob("physics", [this](float deltaTime) {
+        _physicsEngine.dispatchCollisionEvents();
+    });
+    _updateJobs.addJob("overlays", [this](float deltaTime) {
         _overlays.update(deltaTime);
-    }
-    
-    {
-        PerformanceTimer perfTimer("myAvatar");
+    });
+    _updateJobs.addJob("myAvatar", [this](float deltaTime) {
         updateMyAvatarLookAtPosition();
         DependencyManager::get<AvatarManager>()->updateMyAvatar(deltaTime); // Sample hardware, update view frustum if needed, and send avatar data to mixer/nodes
-    }
-
-    {
-        PerformanceTimer perfTimer("emitSimulating");
+    }, QVector<int>() << devices);
+    _updateJobs.addJob("emitSimulating", [this](float deltaTime) {
         // let external parties know we're updating
         emit simulating(deltaTime);
-    }
+    });
 
     // Update _viewFrustum with latest camera and view frustum data...
     // NOTE: we get this from the view frustum, to make it simpler, since the
@@ -2078,16 +2132,13 @@ void Application::update(float deltaTime) {
     // We could optimize this to not actually load the viewFrustum, since we don't
     // actually need to calculate the view frustum planes to send these details
     // to the server.
-    {
-        PerformanceTimer perfTimer("loadViewFrustum");
+    int viewFrustum = _updateJobs.addJob("loadViewFrustum", [this](float deltaTime) {
         loadViewFrustum(_myCamera, _viewFrustum);
-    }
-
-    quint64 now = usecTimestampNow();
+    }, QVector<int>() << camera);
 
     // Update my voxel servers with my current voxel query...
-    {
-        PerformanceTimer perfTimer("queryOctree");
+    _updateJobs.addJob("queryOctree", [this](float deltaTime) {
+        quint64 now = usecTimestampNow();
         quint64 sinceLastQuery = now - _lastQueriedTime;
         const quint64 TOO_LONG_SINCE_LAST_QUERY = 3 * USECS_PER_SECOND;
         bool queryIsDue = sinceLastQuery > TOO_LONG_SINCE_LAST_QUERY;
@@ -2102,26 +2153,40 @@ void Application::update(float deltaTime) {
             }
             _lastQueriedViewFrustum = _viewFrustum;
         }
-    }
+    }, QVector<int>() << viewFrustum);
 
-    // sent nack packets containing missing sequence numbers of received packets from nodes
-    {
+    _updateJobs.addJob("sendStats", [this](float deltaTime) {
+        quint64 now = usecTimestampNow();
+
+        // sent nack packets containing missing sequence numbers of received packets from nodes
         quint64 sinceLastNack = now - _lastNackTime;
         const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
         if (sinceLastNack > TOO_LONG_SINCE_LAST_NACK) {
             _lastNackTime = now;
             sendNackPackets();
         }
-    }
 
-    // send packet containing downstream audio stats to the AudioMixer 
-    {
-        quint64 sinceLastNack = now - _lastSendDownstreamAudioStats;
-        if (sinceLastNack > TOO_LONG_SINCE_LAST_SEND_DOWNSTREAM_AUDIO_STATS) {
+        // send packet containing downstream audio stats to the AudioMixer 
+        quint64 sinceLastSend = now - _lastSendDownstreamAudioStats;
+        if (sinceLastSend > TOO_LONG_SINCE_LAST_SEND_DOWNSTREAM_AUDIO_STATS) {
             _lastSendDownstreamAudioStats = now;
 
             QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "sendDownstreamAudioStatsPacket", Qt::QueuedConnection);
         }
+    }, QVector<int>() << threads); // the nacks leave out packets still waiting to be processed
+}
+
+void Application::update(float deltaTime) {
+    bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
+    PerformanceWarning warn(showWarnings, "Application::update()");
+
+    if (_updateJobs.isEmpty()) {
+        setupUpdateJobs();
+    }
+    _updateJobs.run(deltaTime);
+
+    if (showWarnings) {
+        qDebug() << "Application::update() critical path:" << qPrintable(_updateJobs.getCriticalPathDescription());
     }
 }
 
@@ -2213,8 +2278,9 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType, Node
     _octreeQuery.setWantLowResMoving(true);
     _octreeQuery.setWantColor(true);
     _octreeQuery.setWantDelta(true);
-    _octreeQuery.setWantOcclusionCulling(false);
+    _octreeQuery.setWantOcclusionCulling(true);
     _octreeQuery.setWantCompression(true);
+    _octreeQuery.setWantFastCompression(true);
 
     _octreeQuery.setCameraPosition(_viewFrustum.getPosition());
     _octreeQuery.setCameraOrientation(_viewFrustum.getOrientation());
@@ -2224,7 +2290,15 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType, Node
     _octreeQuery.setCameraFarClip(_viewFrustum.getFarClip());
     _octreeQuery.setCameraEyeOffsetPosition(_viewFrustum.getEyeOffsetPosition());
     auto lodManager = DependencyManager::get<LODManager>();
-    _octreeQuery.setOctreeSizeScale(lodManager->getOctreeSizeScale());
+    
+    // right after a domain change ask for a coarse scene, so the big things show up before the servers get to the details
+    const quint64 COARSE_SCENE_USECS = 2 * USECS_PER_SECOND;
+    const float COARSE_SCENE_SIZE_SCALE_RATIO = 0.25f;
+    float octreeSizeScale = lodManager->getOctreeSizeScale();
+    if (usecTimestampNow() - _domainChangedAt < COARSE_SCENE_USECS) {
+        octreeSizeScale *= COARSE_SCENE_SIZE_SCALE_RATIO;
+    }
+    _octreeQuery.setOctreeSizeScale(octreeSizeScale);
     _octreeQuery.setBoundaryLevelAdjust(lodManager->getBoundaryLevelAdjust());
 
     unsigned char queryPacket[MAX_PACKET_SIZE];
@@ -2450,12 +2524,25 @@ glm::vec3 Application::getSunDirection() {
     return glm::normalize(_environment.getClosestData(_myCamera.getPosition()).getSunLocation(_myCamera.getPosition()));
 }
 
+// the first cascade that may be kept from an earlier frame, the ones before it hold the avatar and what is moving
+// around it and are drawn every frame
+const int FIRST_CACHED_SHADOW_CASCADE = 2;
+
+// the number of frames the first cached cascade may be kept, doubling for each cascade after it
+const int MAX_SHADOW_CACHE_AGE = 4;
+
+// how much bigger than they need to be the cached cascades are drawn, so that they last while the camera moves
+const float SHADOW_CACHE_RADIUS_SCALE = 1.25f;
+
+// the cached cascades are drawn again when the sun moves further than this, as the cosine of the angle
+const float SHADOW_CACHE_MIN_LIGHT_DOT = 0.99999f;
+
 void Application::updateShadowMap() {
-    PerformanceTimer perfTimer("shadowMap");
+    PERFORMANCE_TIMER("shadowMap");
+    LODManager::SubsystemTimer lodTimer(LODManager::SHADOWS_SUBSYSTEM);
     QOpenGLFramebufferObject* fbo = DependencyManager::get<TextureCache>()->getShadowFramebufferObject();
     fbo->bind();
     glEnable(GL_DEPTH_TEST);
-    glClear(GL_DEPTH_BUFFER_BIT);
 
     glm::vec3 lightDirection = -getSunDirection();
     glm::quat rotation = rotationBetween(IDENTITY_FRONT, lightDirection);
@@ -2465,7 +2552,9 @@ void Application::updateShadowMap() {
     const glm::vec2 MAP_COORDS[] = { glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.0f),
         glm::vec2(0.0f, 0.5f), glm::vec2(0.5f, 0.5f) };
     
-    float frustumScale = 1.0f / (_viewFrustum.getFarClip() - _viewFrustum.getNearClip());
+    // the cascades reach out as far as the LOD lets them
+    float frustumScale = DependencyManager::get<LODManager>()->getShadowDistanceScale() /
+        (_viewFrustum.getFarClip() - _viewFrustum.getNearClip());
     loadViewFrustum(_myCamera, _viewFrustum);
     
     int matrixCount = 1;
@@ -2476,9 +2565,14 @@ void Application::updateShadowMap() {
         targetSize = fbo->width() / 2;
         targetScale = 0.5f;
     }
+    bool cacheValid = (matrixCount == CASCADED_SHADOW_MATRIX_COUNT && _shadowCacheTargetSize == targetSize &&
+        glm::dot(_shadowCacheLightDirection, lightDirection) > SHADOW_CACHE_MIN_LIGHT_DOT);
+    if (!cacheValid) {
+        _shadowCacheLightDirection = lightDirection;
+        _shadowCacheTargetSize = (matrixCount == CASCADED_SHADOW_MATRIX_COUNT) ? targetSize : 0;
+    }
     for (int i = 0; i < matrixCount; i++) {
         const glm::vec2& coord = MAP_COORDS[i];
-        glViewport(coord.s * fbo->width(), coord.t * fbo->height(), targetSize, targetSize);
 
         // if simple shadow then since the resolution is twice as much as with cascaded, cover 2 regions with the map, not just one
         int regionIncrement = (matrixCount == 1 ? 2 : 1);
@@ -2508,11 +2602,35 @@ void Application::updateShadowMap() {
         }
         center = inverseRotation * center;
         
+        bool cached = (_shadowCacheTargetSize != 0 && i >= FIRST_CACHED_SHADOW_CASCADE);
+        if (cached) {
+            // keep the cascade, along with its matrix, for as long as it holds the region needed now
+            int maxAge = MAX_SHADOW_CACHE_AGE << (i - FIRST_CACHED_SHADOW_CASCADE);
+            if (cacheValid && ++_shadowCacheAges[i] < maxAge &&
+                    glm::distance(center, _shadowCacheCenters[i]) + radius <= _shadowCacheRadii[i]) {
+                continue;
+            }
+            radius *= SHADOW_CACHE_RADIUS_SCALE;
+        }
+        
         // to reduce texture "shimmer," move in texel increments
         float texelSize = (2.0f * radius) / targetSize;
         center = glm::vec3(roundf(center.x / texelSize) * texelSize, roundf(center.y / texelSize) * texelSize,
             roundf(center.z / texelSize) * texelSize);
         
+        if (cached) {
+            _shadowCacheCenters[i] = center;
+            _shadowCacheRadii[i] = radius;
+            _shadowCacheAges[i] = 0;
+        }
+        
+        // clear only this cascade's part of the map, the others may be kept
+        glViewport(coord.s * fbo->width(), coord.t * fbo->height(), targetSize, targetSize);
+        glScissor(coord.s * fbo->width(), coord.t * fbo->height(), targetSize, targetSize);
+        glEnable(GL_SCISSOR_TEST);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+        
         glm::vec3 minima(center.x - radius, center.y - radius, center.z - radius);
         glm::vec3 maxima(center.x + radius, center.y + radius, center.z + radius);
 
@@ -2563,23 +2681,23 @@ void Application::updateShadowMap() {
         glPolygonOffset(1.1f, 4.0f); // magic numbers courtesy http://www.eecs.berkeley.edu/~ravir/6160/papers/shadowmaps.ppt
 
         {
-            PerformanceTimer perfTimer("avatarManager");
+            PERFORMANCE_TIMER("avatarManager");
             DependencyManager::get<AvatarManager>()->renderAvatars(Avatar::SHADOW_RENDER_MODE);
         }
 
         {
-            PerformanceTimer perfTimer("entities");
+            PERFORMANCE_TIMER("entities");
             _entities.render(RenderArgs::SHADOW_RENDER_MODE);
         }
 
         // render JS/scriptable overlays
         {
-            PerformanceTimer perfTimer("3dOverlays");
+            PERFORMANCE_TIMER("3dOverlays");
             _overlays.renderWorld(false, RenderArgs::SHADOW_RENDER_MODE);
         }
 
         {
-            PerformanceTimer perfTimer("3dOverlaysFront");
+            PERFORMANCE_TIMER("3dOverlaysFront");
             _overlays.renderWorld(true, RenderArgs::SHADOW_RENDER_MODE);
         }
 
@@ -2654,9 +2772,48 @@ QImage Application::renderAvatarBillboard() {
     return image;
 }
 
+void Application::renderAvatarImpostor(Avatar* avatar, const glm::quat& rotation, GLuint texture,
+                                       int x, int y, int size) {
+    DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->bind();
+
+    int viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // the "glow" here causes an alpha of one
+    Glower glower;
+
+    _mirrorCamera.setFieldOfView(BILLBOARD_FIELD_OF_VIEW);
+    _mirrorCamera.setAspectRatio(1.0f);
+    _mirrorCamera.setPosition(avatar->getPosition() +
+                              rotation * glm::vec3(0.0f, 0.0f, BILLBOARD_DISTANCE * avatar->getScale()));
+    _mirrorCamera.setRotation(rotation);
+    _mirrorCamera.update(1.0f / _fps);
+
+    glViewport(0, 0, size, size);
+    glScissor(0, 0, size, size);
+    bool updateViewFrustum = false;
+    updateProjectionMatrix(_mirrorCamera, updateViewFrustum);
+    glEnable(GL_SCISSOR_TEST);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glPushMatrix();
+    displaySide(_mirrorCamera, true);
+    glPopMatrix();
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, size, size);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glDisable(GL_SCISSOR_TEST);
+    updateProjectionMatrix(_myCamera, updateViewFrustum);
+
+    DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->release();
+}
+
 void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs::RenderSide renderSide) {
     PROFILE_RANGE(__FUNCTION__);
-    PerformanceTimer perfTimer("display");
+    PERFORMANCE_TIMER("display");
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings), "Application::displaySide()");
     // transform by eye offset
 
@@ -2713,7 +2870,7 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
     //  Setup 3D lights (after the camera transform, so that they are positioned in world space)
     {
-        PerformanceTimer perfTimer("lights");
+        PERFORMANCE_TIMER("lights");
         setupWorldLight();
     }
 
@@ -2732,7 +2889,7 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
     }
 
     if (!selfAvatarOnly && Menu::getInstance()->isOptionChecked(MenuOption::Stars)) {
-        PerformanceTimer perfTimer("stars");
+        PERFORMANCE_TIMER("stars");
         PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
             "Application::displaySide() ... stars...");
         if (!_stars.isStarsLoaded()) {
@@ -2765,7 +2922,7 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
     // draw the sky dome
     if (!selfAvatarOnly && Menu::getInstance()->isOptionChecked(MenuOption::Atmosphere)) {
-        PerformanceTimer perfTimer("atmosphere");
+        PERFORMANCE_TIMER("atmosphere");
         PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
             "Application::displaySide() ... atmosphere...");
         _environment.renderAtmospheres(theCamera);
@@ -2782,7 +2939,8 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
         
         // also, metavoxels
         if (Menu::getInstance()->isOptionChecked(MenuOption::Metavoxels)) {
-            PerformanceTimer perfTimer("metavoxels");
+            PERFORMANCE_TIMER("metavoxels");
+            LODManager::SubsystemTimer lodTimer(LODManager::METAVOXELS_SUBSYSTEM);
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... metavoxels...");
             _metavoxels.render();
@@ -2790,7 +2948,8 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
         // render models...
         if (Menu::getInstance()->isOptionChecked(MenuOption::Entities)) {
-            PerformanceTimer perfTimer("entities");
+            PERFORMANCE_TIMER("entities");
+            LODManager::SubsystemTimer lodTimer(LODManager::ENTITIES_SUBSYSTEM);
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... entities...");
             _entities.render(RenderArgs::DEFAULT_RENDER_MODE, renderSide);
@@ -2798,16 +2957,21 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
         // render JS/scriptable overlays
         {
-            PerformanceTimer perfTimer("3dOverlays");
+            PERFORMANCE_TIMER("3dOverlays");
+            LODManager::SubsystemTimer lodTimer(LODManager::OVERLAYS_SUBSYSTEM);
             _overlays.renderWorld(false);
         }
 
         // render the ambient occlusion effect if enabled
         if (Menu::getInstance()->isOptionChecked(MenuOption::AmbientOcclusion)) {
-            PerformanceTimer perfTimer("ambientOcclusion");
+            PERFORMANCE_TIMER("ambientOcclusion");
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... AmbientOcclusion...");
-            DependencyManager::get<AmbientOcclusionEffect>()->render();
+            auto ambientOcclusionEffect = DependencyManager::get<AmbientOcclusionEffect>();
+            ambientOcclusionEffect->setResolutionDivider(getAmbientOcclusionResolutionDivider());
+            ambientOcclusionEffect->setTemporalAccumulationEnabled(
+                Menu::getInstance()->isOptionChecked(MenuOption::AmbientOcclusionTemporal));
+            ambientOcclusionEffect->render();
         }
     }
 
@@ -2815,7 +2979,8 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
     bool mirrorMode = (theCamera.getMode() == CAMERA_MODE_MIRROR);
     {
-        PerformanceTimer perfTimer("avatars");
+        PERFORMANCE_TIMER("avatars");
+        LODManager::SubsystemTimer lodTimer(LODManager::AVATARS_SUBSYSTEM);
         DependencyManager::get<AvatarManager>()->renderAvatars(mirrorMode ? Avatar::MIRROR_RENDER_MODE : Avatar::NORMAL_RENDER_MODE,
             false, selfAvatarOnly);   
     }
@@ -2825,12 +2990,12 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
         DependencyManager::get<DeferredLightingEffect>()->setAmbientLightMode(getRenderAmbientLight());
 
         PROFILE_RANGE("DeferredLighting"); 
-        PerformanceTimer perfTimer("lighting");
+        PERFORMANCE_TIMER("lighting");
         DependencyManager::get<DeferredLightingEffect>()->render();
     }
 
     {
-        PerformanceTimer perfTimer("avatarsPostLighting");
+        PERFORMANCE_TIMER("avatarsPostLighting");
         DependencyManager::get<AvatarManager>()->renderAvatars(mirrorMode ? Avatar::MIRROR_RENDER_MODE : Avatar::NORMAL_RENDER_MODE,
             true, selfAvatarOnly);   
     }
@@ -2846,13 +3011,13 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
         //  Render the world box
         if (theCamera.getMode() != CAMERA_MODE_MIRROR && Menu::getInstance()->isOptionChecked(MenuOption::Stats) && 
                 Menu::getInstance()->isOptionChecked(MenuOption::UserInterface)) {
-            PerformanceTimer perfTimer("worldBox");
+            PERFORMANCE_TIMER("worldBox");
             renderWorldBox();
         }
 
         // render octree fades if they exist
         if (_octreeFades.size() > 0) {
-            PerformanceTimer perfTimer("octreeFades");
+            PERFORMANCE_TIMER("octreeFades");
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... octree fades...");
             _octreeFadesLock.lockForWrite();
@@ -2869,7 +3034,7 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
         // give external parties a change to hook in
         {
-            PerformanceTimer perfTimer("inWorldInterface");
+            PERFORMANCE_TIMER("inWorldInterface");
             emit renderingInWorldInterface();
         }
     }
@@ -2880,7 +3045,8 @@ void Application::displaySide(Camera& theCamera, bool selfAvatarOnly, RenderArgs
 
     // Render 3D overlays that should be drawn in front
     {
-        PerformanceTimer perfTimer("3dOverlaysFront");
+        PERFORMANCE_TIMER("3dOverlaysFront");
+        LODManager::SubsystemTimer lodTimer(LODManager::OVERLAYS_SUBSYSTEM);
         glClear(GL_DEPTH_BUFFER_BIT);
         _overlays.renderWorld(true);
     }
@@ -3201,6 +3367,9 @@ void Application::clearDomainOctreeDetails() {
 void Application::domainChanged(const QString& domainHostname) {
     updateWindowTitle();
     clearDomainOctreeDetails();
+    
+    _entities.setDomainHostname(domainHostname);
+    _domainChangedAt = usecTimestampNow();
 }
 
 void Application::connectedToDomain(const QString& hostname) {
@@ -3219,8 +3388,8 @@ void Application::connectedToDomain(const QString& hostname) {
 
 void Application::nodeAdded(SharedNodePointer node) {
     if (node->getType() == NodeType::AvatarMixer) {
-        // new avatar mixer, send off our identity packet right away
-        _myAvatar->sendIdentityPacket();
+        // new avatar mixer, send off our identity packet right away, with everything it doesn't have yet
+        _myAvatar->sendFullIdentityPacket();
     }
 }
 
@@ -3595,6 +3764,8 @@ void Application::stopScript(const QString &scriptName) {
 }
 
 void Application::reloadAllScripts() {
+    // fetch them again, which the disk cache revalidates with their servers
+    ScriptSourceCache::getInstance().clear();
     stopAllScripts(true);
 }
 
@@ -3948,6 +4119,16 @@ float Application::getRenderResolutionScale() const {
     }
 }
 
+int Application::getAmbientOcclusionResolutionDivider() const {
+    if (Menu::getInstance()->isOptionChecked(MenuOption::AmbientOcclusionResolutionFull)) {
+        return 1;
+    } else if (Menu::getInstance()->isOptionChecked(MenuOption::AmbientOcclusionResolutionQuarter)) {
+        return 4;
+    } else {
+        return 2;
+    }
+}
+
 int Application::getRenderAmbientLight() const {
     if (Menu::getInstance()->isOptionChecked(MenuOption::RenderAmbientLightGlobal)) {
         return -1;
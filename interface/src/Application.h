@@ -26,12 +26,14 @@
 #include <AbstractViewStateInterface.h>
 #include <EntityEditPacketSender.h>
 #include <EntityTreeRenderer.h>
+#include <FrameJobGraph.h>
 #include <GeometryCache.h>
 #include <NetworkPacket.h>
 #include <NodeList.h>
 #include <OctreeQuery.h>
 #include <PacketHeaders.h>
 #include <PhysicsEngine.h>
+#include <PhysicsThread.h>
 #include <ScriptEngine.h>
 #include <StDev.h>
 #include <TextureCache.h>
@@ -43,6 +45,7 @@
 #include "DatagramProcessor.h"
 #include "Environment.h"
 #include "FileLogger.h"
+#include "FrameCapture.h"
 #include "GLCanvas.h"
 #include "Menu.h"
 #include "MetavoxelSystem.h"
@@ -180,6 +183,8 @@ public:
     const OctreePacketProcessor& getOctreePacketProcessor() const { return _octreeProcessor; }
     MetavoxelSystem* getMetavoxels() { return &_metavoxels; }
     EntityTreeRenderer* getEntities() { return &_entities; }
+    FrameCapture& getFrameCapture() { return _frameCapture; }
+    PhysicsEngine* getPhysicsEngine() { return &_physicsEngine; }
     Environment* getEnvironment() { return &_environment; }
     PrioVR* getPrioVR() { return &_prioVR; }
     QUndoStack* getUndoStack() { return &_undoStack; }
@@ -236,6 +241,10 @@ public:
 
     QImage renderAvatarBillboard();
 
+    /// Renders the avatar as seen from the given rotation at billboard distance, and copies the result into a square
+    /// of the texture at the given offset.
+    void renderAvatarImpostor(Avatar* avatar, const glm::quat& rotation, GLuint texture, int x, int y, int size);
+
     void displaySide(Camera& whichCamera, bool selfAvatarOnly = false, RenderArgs::RenderSide renderSide = RenderArgs::MONO);
 
     /// Stores the current modelview matrix as the untranslated view matrix to use for transforms and the supplied vector as
@@ -282,6 +291,7 @@ public:
     bool isLookingAtMyAvatar(Avatar* avatar);
 
     float getRenderResolutionScale() const;
+    int getAmbientOcclusionResolutionDivider() const;
     int getRenderAmbientLight() const;
 
     unsigned int getRenderTargetFramerate() const;
@@ -331,6 +341,7 @@ public slots:
     bool importEntities(const QString& filename);
 
     void setLowVelocityFilter(bool lowVelocityFilter);
+    void setParallelPhysicsSolver(bool parallelPhysicsSolver);
     void loadDialog();
     void loadScriptURLDialog();
     void toggleLogDialog();
@@ -360,6 +371,7 @@ public slots:
     void resetSensors();
     void aboutApp();
     void showEditEntitiesHelp();
+    void saveTimingTrace();
     
     void loadSettings();
     void saveSettings();
@@ -411,6 +423,7 @@ private:
     void initDisplay();
     void init();
 
+    void setupUpdateJobs();
     void update(float deltaTime);
 
     // Various helper functions called during update()
@@ -452,6 +465,7 @@ private:
 
     QThread* _nodeThread;
     DatagramProcessor _datagramProcessor;
+    FrameCapture _frameCapture;
 
     QUndoStack _undoStack;
     UndoStackScriptingInterface _undoStackScriptingInterface;
@@ -469,6 +483,7 @@ private:
     Stars _stars;
 
     PhysicsEngine _physicsEngine;
+    PhysicsThread _physicsThread;
 
     EntityTreeRenderer _entities;
     EntityTreeRenderer _entityClipboardRenderer;
@@ -513,6 +528,13 @@ private:
     glm::mat4 _shadowMatrices[CASCADED_SHADOW_MATRIX_COUNT];
     glm::vec3 _shadowDistances;
 
+    // the far shadow cascades are kept while the region they need stays inside the one they were last drawn for
+    glm::vec3 _shadowCacheCenters[CASCADED_SHADOW_MATRIX_COUNT];
+    float _shadowCacheRadii[CASCADED_SHADOW_MATRIX_COUNT];
+    int _shadowCacheAges[CASCADED_SHADOW_MATRIX_COUNT];
+    glm::vec3 _shadowCacheLightDirection;
+    int _shadowCacheTargetSize = 0; // zero when nothing is cached
+
     Environment _environment;
 
     bool _cursorVisible;
@@ -586,6 +608,9 @@ private:
     Bookmarks* _bookmarks;
 
     bool _notifiedPacketVersionMismatchThisDomain;
+    quint64 _domainChangedAt;
+
+    FrameJobGraph _updateJobs;
     
     QThread _settingsThread;
     QTimer _settingsTimer;
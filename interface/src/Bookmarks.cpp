@@ -94,11 +94,13 @@ void Bookmarks::setupMenus(Menu* menubar, QMenu* menu) {
     // Enable/Disable menus as needed
     enableMenuItems(_bookmarks.count() > 0);
     
-    // Load bookmarks
+    // Load bookmarks, and look up their places ahead of time so picking one goes there right away
+    auto addressManager = DependencyManager::get<AddressManager>();
     for (auto it = _bookmarks.begin(); it != _bookmarks.end(); ++it ) {
         QString bookmarkName = it.key();
         QString bookmarkAddress = it.value().toString();
         addLocationToMenu(menubar, bookmarkName, bookmarkAddress);
+        addressManager->prefetchLookupString(bookmarkAddress);
     }
 }
 
@@ -12,6 +12,7 @@
 #include <QtCore/QWeakPointer>
 
 #include <AccountManager.h>
+#include <PacketBundle.h>
 #include <PerfStat.h>
 
 #include "Application.h"
@@ -35,7 +36,6 @@ void DatagramProcessor::processDatagrams() {
     
     static QByteArray incomingPacket;
     
-    Application* application = Application::getInstance();
     auto nodeList = DependencyManager::get<NodeList>();
     
     while (DependencyManager::get<NodeList>()->getNodeSocket().hasPendingDatagrams()) {
@@ -45,120 +45,156 @@ void DatagramProcessor::processDatagrams() {
         _inPacketCount++;
         _inByteCount += incomingPacket.size();
         
-        if (nodeList->packetVersionAndHashMatch(incomingPacket)) {
-            
-            PacketType incomingType = packetTypeForPacket(incomingPacket);
-            // only process this packet if we have a match on the packet version
-            switch (incomingType) {
-                case PacketTypeAudioEnvironment:
-                case PacketTypeAudioStreamStats:
-                case PacketTypeMixedAudio:
-                case PacketTypeSilentAudioFrame: {
-                    if (incomingType == PacketTypeAudioStreamStats) {
-                        QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "parseAudioStreamStatsPacket",
-                                                  Qt::QueuedConnection,
-                                                  Q_ARG(QByteArray, incomingPacket));
-                    } else if (incomingType == PacketTypeAudioEnvironment) {
-                        QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "parseAudioEnvironmentData",
-                                                  Qt::QueuedConnection,
-                                                  Q_ARG(QByteArray, incomingPacket));
-                    } else {
-                        QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "addReceivedAudioToStream",
-                                                  Qt::QueuedConnection,
-                                                  Q_ARG(QByteArray, incomingPacket));
-                    }
-                    
-                    // update having heard from the audio-mixer and record the bytes received
-                    SharedNodePointer audioMixer = nodeList->sendingNodeForPacket(incomingPacket);
-                    
-                    if (audioMixer) {
-                        audioMixer->setLastHeardMicrostamp(usecTimestampNow());
-                    }
-                    
-                    break;
+        if (packetTypeForPacket(incomingPacket) == PacketTypeBundle) {
+            // the mixers bundle a frame's packets for us into one datagram, each handled as if it came on its own
+            if (nodeList->packetVersionAndHashMatch(incomingPacket)) {
+                QVector<QByteArray> bundledPackets;
+                PacketBundle::unbundle(incomingPacket, bundledPackets);
+                foreach (const QByteArray& packet, bundledPackets) {
+                    processDatagram(packet, senderSockAddr);
                 }
-                case PacketTypeEntityAddResponse:
-                    // this will keep creatorTokenIDs to IDs mapped correctly
-                    EntityItemID::handleAddEntityResponse(incomingPacket);
-                    application->getEntities()->getTree()->handleAddEntityResponse(incomingPacket);
-                    break;
-                case PacketTypeEntityData:
-                case PacketTypeEntityErase:
-                case PacketTypeOctreeStats:
-                case PacketTypeEnvironmentData: {
-                    PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
-                                            "Application::networkReceive()... _octreeProcessor.queueReceivedPacket()");
-                    SharedNodePointer matchedNode = DependencyManager::get<NodeList>()->sendingNodeForPacket(incomingPacket);
-                    
-                    if (matchedNode) {
-                        // add this packet to our list of octree packets and process them on the octree data processing
-                        application->_octreeProcessor.queueReceivedPacket(matchedNode, incomingPacket);
-                    }
-                    break;
+            }
+        } else {
+            processDatagram(incomingPacket, senderSockAddr);
+        }
+    }
+}
+
+void DatagramProcessor::queueReplayedDatagram(const QByteArray& packet) {
+    QMutexLocker locker(&_replayedDatagramsMutex);
+    _replayedDatagrams.append(packet);
+}
+
+void DatagramProcessor::processReplayedDatagrams() {
+    QVector<QByteArray> replayedDatagrams;
+    {
+        QMutexLocker locker(&_replayedDatagramsMutex);
+        replayedDatagrams.swap(_replayedDatagrams);
+    }
+    foreach (const QByteArray& packet, replayedDatagrams) {
+        processDatagram(packet, HifiSockAddr());
+    }
+}
+
+void DatagramProcessor::processDatagram(const QByteArray& packet, const HifiSockAddr& senderSockAddr) {
+    Application* application = Application::getInstance();
+    auto nodeList = DependencyManager::get<NodeList>();
+    
+    if (nodeList->packetVersionAndHashMatch(packet)) {
+        if (application->getFrameCapture().isCapturing()) {
+            application->getFrameCapture().capturePacket(packet);
+        }
+        
+        PacketType incomingType = packetTypeForPacket(packet);
+        // only process this packet if we have a match on the packet version
+        switch (incomingType) {
+            case PacketTypeAudioEnvironment:
+            case PacketTypeAudioStreamStats:
+            case PacketTypeMixedAudio:
+            case PacketTypeSilentAudioFrame: {
+                if (incomingType == PacketTypeAudioStreamStats) {
+                    QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "parseAudioStreamStatsPacket",
+                                              Qt::QueuedConnection,
+                                              Q_ARG(QByteArray, packet));
+                } else if (incomingType == PacketTypeAudioEnvironment) {
+                    QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "parseAudioEnvironmentData",
+                                              Qt::QueuedConnection,
+                                              Q_ARG(QByteArray, packet));
+                } else {
+                    QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "addReceivedAudioToStream",
+                                              Qt::QueuedConnection,
+                                              Q_ARG(QByteArray, packet));
                 }
-                case PacketTypeMetavoxelData:
-                    nodeList->findNodeAndUpdateWithDataFromPacket(incomingPacket);
-                    break;
-                case PacketTypeBulkAvatarData:
-                case PacketTypeKillAvatar:
-                case PacketTypeAvatarIdentity:
-                case PacketTypeAvatarBillboard: {
-                    // update having heard from the avatar-mixer and record the bytes received
-                    SharedNodePointer avatarMixer = nodeList->sendingNodeForPacket(incomingPacket);
-                    
-                    if (avatarMixer) {
-                        avatarMixer->setLastHeardMicrostamp(usecTimestampNow());
-                        
-                        QMetaObject::invokeMethod(DependencyManager::get<AvatarManager>().data(), "processAvatarMixerDatagram",
-                                                  Q_ARG(const QByteArray&, incomingPacket),
-                                                  Q_ARG(const QWeakPointer<Node>&, avatarMixer));
-                    }
-                    break;
+                
+                // update having heard from the audio-mixer and record the bytes received
+                SharedNodePointer audioMixer = nodeList->sendingNodeForPacket(packet);
+                
+                if (audioMixer) {
+                    audioMixer->setLastHeardMicrostamp(usecTimestampNow());
                 }
-                case PacketTypeDomainConnectionDenied: {
-                    // output to the log so the user knows they got a denied connection request
-                    // and check and signal for an access token so that we can make sure they are logged in
-                    qDebug() << "The domain-server denied a connection request.";
-                    qDebug() << "You may need to re-log to generate a keypair so you can provide a username signature.";
-                    AccountManager::getInstance().checkAndSignalForAccessToken();
-                    break;
+                
+                break;
+            }
+            case PacketTypeEntityAddResponse:
+                // this will keep creatorTokenIDs to IDs mapped correctly
+                EntityItemID::handleAddEntityResponse(packet);
+                application->getEntities()->getTree()->handleAddEntityResponse(packet);
+                break;
+            case PacketTypeEntityData:
+            case PacketTypeEntityErase:
+            case PacketTypeOctreeStats:
+            case PacketTypeEnvironmentData: {
+                PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
+                                        "Application::networkReceive()... _octreeProcessor.queueReceivedPacket()");
+                SharedNodePointer matchedNode = DependencyManager::get<NodeList>()->sendingNodeForPacket(packet);
+                
+                if (matchedNode) {
+                    // add this packet to our list of octree packets and process them on the octree data processing
+                    application->_octreeProcessor.queueReceivedPacket(matchedNode, packet);
                 }
-                case PacketTypeNoisyMute:
-                case PacketTypeMuteEnvironment: {
-                    bool mute = !DependencyManager::get<AudioClient>()->isMuted();
+                break;
+            }
+            case PacketTypeMetavoxelData:
+                nodeList->findNodeAndUpdateWithDataFromPacket(packet);
+                break;
+            case PacketTypeBulkAvatarData:
+            case PacketTypeKillAvatar:
+            case PacketTypeAvatarIdentity:
+            case PacketTypeAvatarBillboard: {
+                // update having heard from the avatar-mixer and record the bytes received
+                SharedNodePointer avatarMixer = nodeList->sendingNodeForPacket(packet);
+                
+                if (avatarMixer) {
+                    avatarMixer->setLastHeardMicrostamp(usecTimestampNow());
                     
-                    if (incomingType == PacketTypeMuteEnvironment) {
-                        glm::vec3 position;
-                        float radius, distance;
-                        
-                        int headerSize = numBytesForPacketHeaderGivenPacketType(PacketTypeMuteEnvironment);
-                        memcpy(&position, incomingPacket.constData() + headerSize, sizeof(glm::vec3));
-                        memcpy(&radius, incomingPacket.constData() + headerSize + sizeof(glm::vec3), sizeof(float));
-                        distance = glm::distance(DependencyManager::get<AvatarManager>()->getMyAvatar()->getPosition(),
-                                                 position);
-                        
-                        mute = mute && (distance < radius);
-                    }
+                    // avatar data is parsed here, off the main thread, which picks it up each frame
+                    DependencyManager::get<AvatarManager>()->queueAvatarMixerDatagram(packet, avatarMixer);
+                }
+                break;
+            }
+            case PacketTypeDomainConnectionDenied: {
+                // output to the log so the user knows they got a denied connection request
+                // and check and signal for an access token so that we can make sure they are logged in
+                qDebug() << "The domain-server denied a connection request.";
+                qDebug() << "You may need to re-log to generate a keypair so you can provide a username signature.";
+                AccountManager::getInstance().checkAndSignalForAccessToken();
+                break;
+            }
+            case PacketTypeNoisyMute:
+            case PacketTypeMuteEnvironment: {
+                bool mute = !DependencyManager::get<AudioClient>()->isMuted();
+                
+                if (incomingType == PacketTypeMuteEnvironment) {
+                    glm::vec3 position;
+                    float radius, distance;
                     
-                    if (mute) {
-                        DependencyManager::get<AudioClient>()->toggleMute();
-                        if (incomingType == PacketTypeMuteEnvironment) {
-                            AudioScriptingInterface::getInstance().environmentMuted();
-                        } else {
-                            AudioScriptingInterface::getInstance().mutedByMixer();
-                        }
-                    }
-                    break;
+                    int headerSize = numBytesForPacketHeaderGivenPacketType(PacketTypeMuteEnvironment);
+                    memcpy(&position, packet.constData() + headerSize, sizeof(glm::vec3));
+                    memcpy(&radius, packet.constData() + headerSize + sizeof(glm::vec3), sizeof(float));
+                    distance = glm::distance(DependencyManager::get<AvatarManager>()->getMyAvatar()->getPosition(),
+                                             position);
+                    
+                    mute = mute && (distance < radius);
                 }
-                case PacketTypeEntityEditNack:
-                    if (!Menu::getInstance()->isOptionChecked(MenuOption::DisableNackPackets)) {
-                        application->_entityEditSender.processNackPacket(incomingPacket);
+                
+                if (mute) {
+                    DependencyManager::get<AudioClient>()->toggleMute();
+                    if (incomingType == PacketTypeMuteEnvironment) {
+                        AudioScriptingInterface::getInstance().environmentMuted();
+                    } else {
+                        AudioScriptingInterface::getInstance().mutedByMixer();
                     }
-                    break;
-                default:
-                    nodeList->processNodeData(senderSockAddr, incomingPacket);
-                    break;
+                }
+                break;
             }
+            case PacketTypeEntityEditNack:
+                if (!Menu::getInstance()->isOptionChecked(MenuOption::DisableNackPackets)) {
+                    application->_entityEditSender.processNackPacket(packet);
+                }
+                break;
+            default:
+                nodeList->processNodeData(senderSockAddr, packet);
+                break;
         }
     }
 }
@@ -12,7 +12,11 @@
 #ifndef hifi_DatagramProcessor_h
 #define hifi_DatagramProcessor_h
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include <HifiSockAddr.h>
 
 class DatagramProcessor : public QObject {
     Q_OBJECT
@@ -25,14 +29,26 @@ public:
     int getOutByteCount() const { return _outByteCount; }
     
     void resetCounters() { _inPacketCount = 0; _outPacketCount = 0; _inByteCount = 0; _outByteCount = 0; }
+    
+    /// Holds a packet from a frame capture until processReplayedDatagrams, from the thread that's replaying it.
+    void queueReplayedDatagram(const QByteArray& packet);
+    
 public slots:
     void processDatagrams();
     
+    /// Handles the replayed packets queued since the last call, as if they'd arrived from the network.
+    void processReplayedDatagrams();
+    
 private:
+    void processDatagram(const QByteArray& packet, const HifiSockAddr& senderSockAddr);
+    
     int _inPacketCount;
     int _outPacketCount;
     int _inByteCount;
     int _outByteCount;
+    
+    QMutex _replayedDatagramsMutex;
+    QVector<QByteArray> _replayedDatagrams;
 };
 
 #endif // hifi_DatagramProcessor_h
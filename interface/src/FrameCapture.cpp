@@ -0,0 +1,224 @@
+//
+//  FrameCapture.cpp
+//  interface/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtDebug>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include <gpu/GLBackend.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+#include <StreamUtils.h>
+
+#include "avatar/AvatarManager.h"
+#include "DatagramProcessor.h"
+
+#include "FrameCapture.h"
+
+const quint32 CAPTURE_FILE_MAGIC = 0x48464350; // "HFCP"
+const quint32 CAPTURE_FILE_VERSION = 1;
+
+// there's no cross-platform way to ask how much of us is resident, so this is only logged on Linux
+static quint64 getResidentMemory() {
+#ifdef Q_OS_LINUX
+    QFile statmFile("/proc/self/statm");
+    if (statmFile.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> fields = statmFile.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields.at(1).toULongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return 0;
+}
+
+FrameCapture::FrameCapture(DatagramProcessor& datagramProcessor) :
+    _datagramProcessor(datagramProcessor),
+    _isCapturing(false),
+    _isReplaying(false),
+    _replayedFrameCount(0)
+{
+
+}
+
+FrameCapture::~FrameCapture() {
+    QMutexLocker locker(&_streamMutex);
+    _isCapturing = false;
+    _stream.setDevice(NULL);
+}
+
+bool FrameCapture::startCapture(const QString& fileName) {
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Couldn't open" << fileName << "to capture frames to -" << _file.errorString();
+        return false;
+    }
+    QMutexLocker locker(&_streamMutex);
+    _stream.setDevice(&_file);
+    _stream << CAPTURE_FILE_MAGIC << CAPTURE_FILE_VERSION;
+    _isCapturing = true;
+    qDebug() << "Capturing frames to" << fileName;
+    return true;
+}
+
+bool FrameCapture::startReplay(const QString& fileName) {
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Couldn't open" << fileName << "to replay frames from -" << _file.errorString();
+        return false;
+    }
+    _stream.setDevice(&_file);
+    quint32 magic = 0, version = 0;
+    _stream >> magic >> version;
+    if (magic != CAPTURE_FILE_MAGIC || version != CAPTURE_FILE_VERSION) {
+        qDebug() << fileName << "isn't a frame capture we can replay.";
+        _stream.setDevice(NULL);
+        _file.close();
+        return false;
+    }
+    _logFile.setFileName(fileName + ".frames.csv");
+    if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qDebug() << "Couldn't open" << _logFile.fileName() << "to log the replayed frames to -"
+            << _logFile.errorString();
+        _stream.setDevice(NULL);
+        _file.close();
+        return false;
+    }
+    _logStream.setDevice(&_logFile);
+    _logStream << "frame,usecs,draws,state_changes,texture_memory_bytes,resident_memory_bytes\n";
+    _isReplaying = true;
+    qDebug() << "Replaying frames from" << fileName << "and logging them to" << _logFile.fileName();
+    return true;
+}
+
+void FrameCapture::capturePacket(const QByteArray& packet) {
+    SharedNodePointer sendingNode = DependencyManager::get<NodeList>()->sendingNodeForPacket(packet);
+
+    QMutexLocker locker(&_streamMutex);
+    if (!_isCapturing) {
+        return;
+    }
+    // the replay stands in the node that sent the packet, with the secret the packet's hash is checked with
+    if (sendingNode && !_capturedNodes.contains(sendingNode->getUUID())) {
+        _capturedNodes.insert(sendingNode->getUUID());
+        _stream << (quint8)NODE_RECORD << sendingNode->getUUID() << (quint8)sendingNode->getType()
+            << sendingNode->getConnectionSecret();
+    }
+    _stream << (quint8)PACKET_RECORD << packet;
+}
+
+float FrameCapture::beginReplayFrame() {
+    _frameTimer.start();
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    bool hasPackets = false;
+    while (!_stream.atEnd()) {
+        quint8 recordType;
+        _stream >> recordType;
+
+        if (recordType == NODE_RECORD) {
+            QUuid uuid, connectionSecret;
+            quint8 nodeType;
+            _stream >> uuid >> nodeType >> connectionSecret;
+
+            // no sockets, so that nothing we send the node while replaying goes anywhere
+            SharedNodePointer node = nodeList->addOrUpdateNode(uuid, (NodeType_t)nodeType,
+                                                               HifiSockAddr(), HifiSockAddr(), false);
+            node->setConnectionSecret(connectionSecret);
+
+        } else if (recordType == PACKET_RECORD) {
+            QByteArray packet;
+            _stream >> packet;
+            _datagramProcessor.queueReplayedDatagram(packet);
+            hasPackets = true;
+
+        } else if (recordType == FRAME_RECORD) {
+            float deltaTime;
+            _stream >> deltaTime >> _replayedPose.position >> _replayedPose.orientation
+                >> _replayedPose.headPitch >> _replayedPose.headYaw >> _replayedPose.headRoll;
+
+            // the packets are handled on the datagram processor's thread, as they were when they arrived, but they're
+            // done before the frame goes on, so that a replay comes out the same every time
+            if (hasPackets) {
+                QMetaObject::invokeMethod(&_datagramProcessor, "processReplayedDatagrams",
+                                          Qt::BlockingQueuedConnection);
+            }
+
+            // the replayed nodes go silent between their packets, which shouldn't get them taken for dead
+            quint64 now = usecTimestampNow();
+            nodeList->eachNode([now](const SharedNodePointer& node){
+                node->setLastHeardMicrostamp(now);
+            });
+            return deltaTime;
+
+        } else {
+            qDebug() << "Frame capture has a record we don't know, stopping the replay there.";
+            break;
+        }
+    }
+    finishReplay();
+    return -1.0f;
+}
+
+void FrameCapture::endUpdate(float deltaTime) {
+    MyAvatar* myAvatar = DependencyManager::get<AvatarManager>()->getMyAvatar();
+    if (_isCapturing) {
+        QMutexLocker locker(&_streamMutex);
+        _stream << (quint8)FRAME_RECORD << deltaTime << myAvatar->getPosition() << myAvatar->getOrientation()
+            << myAvatar->getHeadPitch() << myAvatar->getHeadYaw() << myAvatar->getHeadRoll();
+
+    } else if (_isReplaying) {
+        // the render follows the avatar, so putting it back where it was puts the camera there too
+        myAvatar->setPosition(_replayedPose.position);
+        myAvatar->setOrientation(_replayedPose.orientation);
+        myAvatar->setHeadPitch(_replayedPose.headPitch);
+        myAvatar->setHeadYaw(_replayedPose.headYaw);
+        myAvatar->setHeadRoll(_replayedPose.headRoll);
+    }
+}
+
+void FrameCapture::endFrame() {
+    if (!_isReplaying) {
+        return;
+    }
+    quint64 frameUsecs = _frameTimer.nsecsElapsed() / 1000;
+    _frameUsecs.append(frameUsecs);
+
+    // the gpu stats are reset at the start of each render, so they're all this frame's
+    const gpu::GLBackend::Stats& gpuStats = gpu::GLBackend::getStats();
+    _logStream << _replayedFrameCount++ << "," << frameUsecs << "," << gpuStats._draws << ","
+        << gpuStats._stateChanges << "," << gpu::GLBackend::getTextureMemory() << "," << getResidentMemory() << "\n";
+}
+
+void FrameCapture::finishReplay() {
+    _isReplaying = false;
+    _stream.setDevice(NULL);
+    _file.close();
+    _logStream.flush();
+    _logFile.close();
+
+    if (!_frameUsecs.isEmpty()) {
+        quint64 totalUsecs = 0;
+        foreach (quint64 frameUsecs, _frameUsecs) {
+            totalUsecs += frameUsecs;
+        }
+        qSort(_frameUsecs);
+        const float HIGH_PERCENTILE = 0.99f;
+        qDebug() << "Replayed" << _frameUsecs.size() << "frames, averaging"
+            << (float)totalUsecs / _frameUsecs.size() / USECS_PER_MSEC << "msecs, with a median of"
+            << (float)_frameUsecs.at(_frameUsecs.size() / 2) / USECS_PER_MSEC << "msecs and a 99th percentile of"
+            << (float)_frameUsecs.at((int)((_frameUsecs.size() - 1) * HIGH_PERCENTILE)) / USECS_PER_MSEC << "msecs.";
+    }
+    QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+}
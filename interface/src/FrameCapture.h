@@ -0,0 +1,90 @@
+//
+//  FrameCapture.h
+//  interface/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameCapture_h
+#define hifi_FrameCapture_h
+
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class DatagramProcessor;
+
+/// Records what the interface takes in a frame at a time - the packets the DatagramProcessor handles, with the nodes
+/// they came from, and where the avatar was and was looking after each update - to a file, and plays such a file
+/// back in place of the network and the input devices, logging each frame's time, draws and memory, so that a report
+/// of poor performance in a domain can be reproduced, and a change to the rendering measured against it.
+///
+/// Start the interface with --capture <file> to record, and with --replay <file> to play one back, which writes the
+/// frames to <file>.frames.csv and quits at the end.  A replay doesn't go to a domain, and its nodes have no sockets,
+/// so nothing we send while replaying goes anywhere.
+class FrameCapture {
+public:
+    FrameCapture(DatagramProcessor& datagramProcessor);
+    ~FrameCapture();
+
+    bool startCapture(const QString& fileName);
+    bool startReplay(const QString& fileName);
+
+    bool isCapturing() const { return _isCapturing; }
+    bool isReplaying() const { return _isReplaying; }
+
+    /// Records a packet that the DatagramProcessor is about to handle, from whichever thread it's on.
+    void capturePacket(const QByteArray& packet);
+
+    /// Hands the packets that arrived before the next replayed frame to the DatagramProcessor, and returns the time
+    /// the frame's update took when it was captured, or a negative number when there are no frames left.
+    float beginReplayFrame();
+
+    /// Records where the avatar is after the frame's update, or (when replaying) puts it where it was.
+    void endUpdate(float deltaTime);
+
+    /// Logs how long the replayed frame took, from the start of its update to the end of its render.
+    void endFrame();
+
+private:
+    enum RecordType { NODE_RECORD, PACKET_RECORD, FRAME_RECORD };
+
+    class FramePose {
+    public:
+        glm::vec3 position;
+        glm::quat orientation;
+        float headPitch;
+        float headYaw;
+        float headRoll;
+    };
+
+    void finishReplay();
+
+    DatagramProcessor& _datagramProcessor;
+    QFile _file;
+    QDataStream _stream;
+    QMutex _streamMutex; ///< the packets are captured on the datagram processor's thread, the frames on ours
+    bool _isCapturing;
+    bool _isReplaying;
+    QSet<QUuid> _capturedNodes;
+
+    FramePose _replayedPose;
+    int _replayedFrameCount;
+    QElapsedTimer _frameTimer;
+    QVector<quint64> _frameUsecs;
+    QFile _logFile;
+    QTextStream _logStream;
+};
+
+#endif // hifi_FrameCapture_h
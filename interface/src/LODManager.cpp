@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <math.h>
+
 #include <SettingHandle.h>
 #include <Util.h>
 
@@ -18,76 +20,75 @@
 #include "LODManager.h"
 
 Setting::Handle<bool> automaticAvatarLOD("automaticAvatarLOD", true);
-Setting::Handle<float> avatarLODDecreaseFPS("avatarLODDecreaseFPS", DEFAULT_ADJUST_AVATAR_LOD_DOWN_FPS);
-Setting::Handle<float> avatarLODIncreaseFPS("avatarLODIncreaseFPS",  ADJUST_LOD_UP_FPS);
+Setting::Handle<float> lodTargetFPS("lodTargetFPS", DEFAULT_LOD_TARGET_FPS);
 Setting::Handle<float> avatarLODDistanceMultiplier("avatarLODDistanceMultiplier",
                                                            DEFAULT_AVATAR_LOD_DISTANCE_MULTIPLIER);
+Setting::Handle<float> avatarImpostorDistance("avatarImpostorDistance", DEFAULT_AVATAR_IMPOSTOR_DISTANCE);
 Setting::Handle<int> boundaryLevelAdjust("boundaryLevelAdjust", 0);
 Setting::Handle<float> octreeSizeScale("octreeSizeScale", DEFAULT_OCTREE_SIZE_SCALE);
 
 
+// each subsystem's share of the target frame time, with what's left over for the rest of the frame
+const float SUBSYSTEM_BUDGETS[LODManager::SUBSYSTEM_COUNT] = { 0.35f, 0.2f, 0.15f, 0.15f, 0.05f };
+
+// the gains on how far over its budget a subsystem is, as a proportion of the budget, and on how long it's been over
+// and how fast that's changing, in seconds
+const float PROPORTIONAL_GAIN = 0.25f;
+const float INTEGRAL_GAIN = 0.5f;
+const float DERIVATIVE_GAIN = 0.02f;
+
+// how much of each frame's time goes into the subsystems' averages
+const float SUBSYSTEM_TIME_AVERAGE_RATE = 0.1f;
+
+// the knobs move only once their targets are this proportion away, so that the LOD in our queries, which the servers
+// restart their scenes for, isn't changed by every frame's noise
+const float MIN_KNOB_STEP = 0.05f;
+
+static float interpolateExponentially(float from, float to, float proportion) {
+    return from * powf(to / from, proportion);
+}
+
+static float proportionBetween(float from, float to, float value) {
+    return glm::clamp(logf(value / from) / logf(to / from), 0.0f, 1.0f);
+}
+
+static bool stepKnob(float& knob, float target) {
+    if (qAbs(target - knob) < knob * MIN_KNOB_STEP) {
+        return false;
+    }
+    knob = target;
+    return true;
+}
+
+LODManager::SubsystemTimer::~SubsystemTimer() {
+    DependencyManager::get<LODManager>()->addSubsystemTime(_subsystem, usecTimestampNow() - _start);
+}
+
+float LODManager::getSubsystemBudgetMsecs(Subsystem subsystem) const {
+    return SUBSYSTEM_BUDGETS[subsystem] * MSECS_PER_SECOND / qMax(_targetFPS, EPSILON);
+}
+
 void LODManager::autoAdjustLOD(float currentFPS) {
     // NOTE: our first ~100 samples at app startup are completely all over the place, and we don't
-    // really want to count them in our average, so we will ignore the real frame rates and stuff
-    // our moving average with simulated good data
+    // really want to count them, so we let the subsystems' times pass us by until we're past them
     const int IGNORE_THESE_SAMPLES = 100;
-    const float ASSUMED_FPS = 60.0f;
-    if (_fpsAverage.getSampleCount() < IGNORE_THESE_SAMPLES) {
-        currentFPS = ASSUMED_FPS;
-    }
     _fpsAverage.updateAverage(currentFPS);
-    _fastFPSAverage.updateAverage(currentFPS);
     
     quint64 now = usecTimestampNow();
+    float deltaTime = (float)(now - _lastAdjust) / USECS_PER_SECOND;
+    _lastAdjust = now;
     
-    const quint64 ADJUST_AVATAR_LOD_DOWN_DELAY = 1000 * 1000;
-    if (_automaticAvatarLOD) {
-        if (_fastFPSAverage.getAverage() < _avatarLODDecreaseFPS) {
-            if (now - _lastAvatarDetailDrop > ADJUST_AVATAR_LOD_DOWN_DELAY) {
-                // attempt to lower the detail in proportion to the fps difference
-                float targetFps = (_avatarLODDecreaseFPS + _avatarLODIncreaseFPS) * 0.5f;
-                float averageFps = _fastFPSAverage.getAverage();
-                const float MAXIMUM_MULTIPLIER_SCALE = 2.0f;
-                _avatarLODDistanceMultiplier = qMin(MAXIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER, _avatarLODDistanceMultiplier *
-                                                    (averageFps < EPSILON ? MAXIMUM_MULTIPLIER_SCALE :
-                                                     qMin(MAXIMUM_MULTIPLIER_SCALE, targetFps / averageFps)));
-                _lastAvatarDetailDrop = now;
-            }
-        } else if (_fastFPSAverage.getAverage() > _avatarLODIncreaseFPS) {
-            // let the detail level creep slowly upwards
-            const float DISTANCE_DECREASE_RATE = 0.05f;
-            _avatarLODDistanceMultiplier = qMax(MINIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER,
-                                                _avatarLODDistanceMultiplier - DISTANCE_DECREASE_RATE);
+    if (_fpsAverage.getSampleCount() < IGNORE_THESE_SAMPLES) {
+        for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+            _governors[i].usecsThisFrame = 0;
         }
+        return;
     }
     
     bool changed = false;
-    quint64 elapsed = now - _lastAdjust;
-    
-    if (elapsed > ADJUST_LOD_DOWN_DELAY && _fpsAverage.getAverage() < ADJUST_LOD_DOWN_FPS
-        && _octreeSizeScale > ADJUST_LOD_MIN_SIZE_SCALE) {
-        
-        _octreeSizeScale *= ADJUST_LOD_DOWN_BY;
-        
-        if (_octreeSizeScale < ADJUST_LOD_MIN_SIZE_SCALE) {
-            _octreeSizeScale = ADJUST_LOD_MIN_SIZE_SCALE;
-        }
-        changed = true;
-        _lastAdjust = now;
-        qDebug() << "adjusting LOD down... average fps for last approximately 5 seconds=" << _fpsAverage.getAverage()
-        << "_octreeSizeScale=" << _octreeSizeScale;
-    }
-    
-    if (elapsed > ADJUST_LOD_UP_DELAY && _fpsAverage.getAverage() > ADJUST_LOD_UP_FPS
-        && _octreeSizeScale < ADJUST_LOD_MAX_SIZE_SCALE) {
-        _octreeSizeScale *= ADJUST_LOD_UP_BY;
-        if (_octreeSizeScale > ADJUST_LOD_MAX_SIZE_SCALE) {
-            _octreeSizeScale = ADJUST_LOD_MAX_SIZE_SCALE;
-        }
-        changed = true;
-        _lastAdjust = now;
-        qDebug() << "adjusting LOD up... average fps for last approximately 5 seconds=" << _fpsAverage.getAverage()
-        << "_octreeSizeScale=" << _octreeSizeScale;
+    for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        governSubsystem((Subsystem)i, deltaTime);
+        changed |= applyDetail((Subsystem)i);
     }
     
     if (changed) {
@@ -101,8 +102,75 @@ void LODManager::autoAdjustLOD(float currentFPS) {
 
 void LODManager::resetLODAdjust() {
     _fpsAverage.reset();
-    _fastFPSAverage.reset();
-    _lastAvatarDetailDrop = _lastAdjust = usecTimestampNow();
+    _lastAdjust = usecTimestampNow();
+    
+    // pick up from wherever the knobs are now, as though each subsystem had been running on its budget
+    _governors[ENTITIES_SUBSYSTEM].detail = proportionBetween(ADJUST_LOD_MIN_SIZE_SCALE, ADJUST_LOD_MAX_SIZE_SCALE,
+                                                              _octreeSizeScale);
+    _governors[AVATARS_SUBSYSTEM].detail = proportionBetween(MAXIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER,
+                                                             MINIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER,
+                                                             _avatarLODDistanceMultiplier);
+    _governors[METAVOXELS_SUBSYSTEM].detail = proportionBetween(MAXIMUM_METAVOXEL_LOD_THRESHOLD,
+                                                                DEFAULT_METAVOXEL_LOD_THRESHOLD,
+                                                                _metavoxelLODThreshold);
+    _governors[SHADOWS_SUBSYSTEM].detail = proportionBetween(MINIMUM_SHADOW_DISTANCE_SCALE,
+                                                             DEFAULT_SHADOW_DISTANCE_SCALE, _shadowDistanceScale);
+    for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        Governor& governor = _governors[i];
+        governor.usecsThisFrame = 0;
+        governor.lastError = 0.0f;
+        governor.integral = (1.0f - governor.detail) / INTEGRAL_GAIN;
+    }
+}
+
+void LODManager::governSubsystem(Subsystem subsystem, float deltaTime) {
+    Governor& governor = _governors[subsystem];
+    governor.averageMsecs = glm::mix(governor.averageMsecs, (float)governor.usecsThisFrame / USECS_PER_MSEC,
+                                     SUBSYSTEM_TIME_AVERAGE_RATE);
+    governor.usecsThisFrame = 0;
+    
+    float budget = getSubsystemBudgetMsecs(subsystem);
+    float error = (governor.averageMsecs - budget) / budget;
+    
+    // the detail can't go past the most, so nor can the time spent under budget pile up past what gets us there
+    governor.integral = glm::clamp(governor.integral + error * deltaTime, 0.0f, 1.0f / INTEGRAL_GAIN);
+    float derivative = (deltaTime > EPSILON) ? (error - governor.lastError) / deltaTime : 0.0f;
+    governor.lastError = error;
+    
+    governor.detail = glm::clamp(1.0f - PROPORTIONAL_GAIN * error - INTEGRAL_GAIN * governor.integral -
+        DERIVATIVE_GAIN * derivative, 0.0f, 1.0f);
+}
+
+bool LODManager::applyDetail(Subsystem subsystem) {
+    float detail = _governors[subsystem].detail;
+    switch (subsystem) {
+        case ENTITIES_SUBSYSTEM:
+            return stepKnob(_octreeSizeScale, interpolateExponentially(ADJUST_LOD_MIN_SIZE_SCALE,
+                                                                       ADJUST_LOD_MAX_SIZE_SCALE, detail));
+        case AVATARS_SUBSYSTEM:
+            if (!_automaticAvatarLOD) {
+                return false;
+            }
+            stepKnob(_avatarImpostorDistance, interpolateExponentially(MINIMUM_AVATAR_IMPOSTOR_DISTANCE,
+                                                                       MAXIMUM_AVATAR_IMPOSTOR_DISTANCE, detail));
+            stepKnob(_avatarLODDistanceMultiplier, interpolateExponentially(MAXIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER,
+                                                                            MINIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER,
+                                                                            detail));
+            return false;
+
+        case METAVOXELS_SUBSYSTEM:
+            stepKnob(_metavoxelLODThreshold, interpolateExponentially(MAXIMUM_METAVOXEL_LOD_THRESHOLD,
+                                                                      DEFAULT_METAVOXEL_LOD_THRESHOLD, detail));
+            return false;
+
+        case SHADOWS_SUBSYSTEM:
+            stepKnob(_shadowDistanceScale, interpolateExponentially(MINIMUM_SHADOW_DISTANCE_SCALE,
+                                                                    DEFAULT_SHADOW_DISTANCE_SCALE, detail));
+            return false;
+
+        default:
+            return false; // the overlays are placed by scripts, and have no detail to give up
+    }
 }
 
 QString LODManager::getLODFeedbackText() {
@@ -191,18 +259,19 @@ void LODManager::setBoundaryLevelAdjust(int boundaryLevelAdjust) {
 
 void LODManager::loadSettings() {
     setAutomaticAvatarLOD(automaticAvatarLOD.get());
-    setAvatarLODDecreaseFPS(avatarLODDecreaseFPS.get());
-    setAvatarLODIncreaseFPS(avatarLODIncreaseFPS.get());
+    setTargetFPS(lodTargetFPS.get());
     setAvatarLODDistanceMultiplier(avatarLODDistanceMultiplier.get());
+    setAvatarImpostorDistance(avatarImpostorDistance.get());
     setBoundaryLevelAdjust(boundaryLevelAdjust.get());
     setOctreeSizeScale(octreeSizeScale.get());
+    resetLODAdjust();
 }
 
 void LODManager::saveSettings() {
     automaticAvatarLOD.set(getAutomaticAvatarLOD());
-    avatarLODDecreaseFPS.set(getAvatarLODDecreaseFPS());
-    avatarLODIncreaseFPS.set(getAvatarLODIncreaseFPS());
+    lodTargetFPS.set(getTargetFPS());
     avatarLODDistanceMultiplier.set(getAvatarLODDistanceMultiplier());
+    avatarImpostorDistance.set(getAvatarImpostorDistance());
     boundaryLevelAdjust.set(getBoundaryLevelAdjust());
     octreeSizeScale.set(getOctreeSizeScale());
 }
@@ -17,15 +17,7 @@
 #include <SharedUtil.h>
 #include <SimpleMovingAverage.h>
 
-const float ADJUST_LOD_DOWN_FPS = 40.0;
-const float ADJUST_LOD_UP_FPS = 55.0;
-const float DEFAULT_ADJUST_AVATAR_LOD_DOWN_FPS = 30.0f;
-
-const quint64 ADJUST_LOD_DOWN_DELAY = 1000 * 1000 * 5;
-const quint64 ADJUST_LOD_UP_DELAY = ADJUST_LOD_DOWN_DELAY * 2;
-
-const float ADJUST_LOD_DOWN_BY = 0.9f;
-const float ADJUST_LOD_UP_BY = 1.1f;
+const float DEFAULT_LOD_TARGET_FPS = 60.0f;
 
 const float ADJUST_LOD_MIN_SIZE_SCALE = DEFAULT_OCTREE_SIZE_SCALE * 0.25f;
 const float ADJUST_LOD_MAX_SIZE_SCALE = DEFAULT_OCTREE_SIZE_SCALE;
@@ -34,22 +26,68 @@ const float MINIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER = 0.1f;
 const float MAXIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER = 15.0f;
 const float DEFAULT_AVATAR_LOD_DISTANCE_MULTIPLIER = 1.0f;
 
+const float MINIMUM_AVATAR_IMPOSTOR_DISTANCE = 10.0f;
+const float MAXIMUM_AVATAR_IMPOSTOR_DISTANCE = 400.0f;
+const float DEFAULT_AVATAR_IMPOSTOR_DISTANCE = 40.0f;
+
+const float DEFAULT_METAVOXEL_LOD_THRESHOLD = 0.01f;
+const float MAXIMUM_METAVOXEL_LOD_THRESHOLD = DEFAULT_METAVOXEL_LOD_THRESHOLD * 8.0f;
+
+const float MINIMUM_SHADOW_DISTANCE_SCALE = 0.25f;
+const float DEFAULT_SHADOW_DISTANCE_SCALE = 1.0f;
+
 const int ONE_SECOND_OF_FRAMES = 60;
 const int FIVE_SECONDS_OF_FRAMES = 5 * ONE_SECOND_OF_FRAMES;
 
 
+/// Governs the detail that each part of the render draws at.  The parts time their rendering into the manager with a
+/// SubsystemTimer, and once a frame autoAdjustLOD steers each part's detail towards the share of the target frame time
+/// that it's budgeted, with a PID controller on how far over or under its budget it's running.  Each part's detail
+/// moves by small steps as it closes on its budget, rather than jumping whenever the frame rate crosses a threshold.
 class LODManager : public Dependency {
     SINGLETON_DEPENDENCY
     
 public:
+    /// The parts of the render that are timed, and (all but the overlays, which have no detail to give up) governed.
+    enum Subsystem { ENTITIES_SUBSYSTEM, AVATARS_SUBSYSTEM, METAVOXELS_SUBSYSTEM, SHADOWS_SUBSYSTEM, OVERLAYS_SUBSYSTEM,
+        SUBSYSTEM_COUNT };
+
+    /// Adds the time from its construction to its destruction to a subsystem's time for the frame.
+    class SubsystemTimer {
+    public:
+        SubsystemTimer(Subsystem subsystem) : _subsystem(subsystem), _start(usecTimestampNow()) { }
+        ~SubsystemTimer();
+
+    private:
+        Subsystem _subsystem;
+        quint64 _start;
+    };
+
+    void addSubsystemTime(Subsystem subsystem, quint64 usecs) { _governors[subsystem].usecsThisFrame += usecs; }
+
+    /// Returns a subsystem's smoothed time per frame.
+    float getSubsystemMsecs(Subsystem subsystem) const { return _governors[subsystem].averageMsecs; }
+
+    /// Returns a subsystem's share of the target frame time.
+    float getSubsystemBudgetMsecs(Subsystem subsystem) const;
+
+    void setTargetFPS(float targetFPS) { _targetFPS = targetFPS; }
+    float getTargetFPS() const { return _targetFPS; }
+
     void setAutomaticAvatarLOD(bool automaticAvatarLOD) { _automaticAvatarLOD = automaticAvatarLOD; }
     bool getAutomaticAvatarLOD() const { return _automaticAvatarLOD; }
-    void setAvatarLODDecreaseFPS(float avatarLODDecreaseFPS) { _avatarLODDecreaseFPS = avatarLODDecreaseFPS; }
-    float getAvatarLODDecreaseFPS() const { return _avatarLODDecreaseFPS; }
-    void setAvatarLODIncreaseFPS(float avatarLODIncreaseFPS) { _avatarLODIncreaseFPS = avatarLODIncreaseFPS; }
-    float getAvatarLODIncreaseFPS() const { return _avatarLODIncreaseFPS; }
     void setAvatarLODDistanceMultiplier(float multiplier) { _avatarLODDistanceMultiplier = multiplier; }
     float getAvatarLODDistanceMultiplier() const { return _avatarLODDistanceMultiplier; }
+
+    /// Sets the distance, scaled by the avatar's scale, beyond which other avatars render as impostor cards.
+    void setAvatarImpostorDistance(float distance) { _avatarImpostorDistance = distance; }
+    float getAvatarImpostorDistance() const { return _avatarImpostorDistance; }
+
+    /// The threshold that the metavoxels subdivide by, where higher thresholds keep coarser voxels.
+    float getMetavoxelLODThreshold() const { return _metavoxelLODThreshold; }
+
+    /// The proportion of the usual distances that the shadow cascades reach out to.
+    float getShadowDistanceScale() const { return _shadowDistanceScale; }
     
     // User Tweakable LOD Items
     QString getLODFeedbackText();
@@ -69,19 +107,36 @@ public:
     
 private:
     LODManager() {}
+
+    /// A subsystem's time and the state of the controller on it.  The controller's output is the subsystem's detail,
+    /// from zero (the least) to one (the most), which its knob is set from.
+    class Governor {
+    public:
+        quint64 usecsThisFrame = 0;
+        float averageMsecs = 0.0f;
+        float integral = 0.0f;
+        float lastError = 0.0f;
+        float detail = 1.0f;
+    };
+
+    void governSubsystem(Subsystem subsystem, float deltaTime);
+    bool applyDetail(Subsystem subsystem);
+
+    Governor _governors[SUBSYSTEM_COUNT];
+    float _targetFPS = DEFAULT_LOD_TARGET_FPS;
     
     bool _automaticAvatarLOD = true;
-    float _avatarLODDecreaseFPS = DEFAULT_ADJUST_AVATAR_LOD_DOWN_FPS;
-    float _avatarLODIncreaseFPS = ADJUST_LOD_UP_FPS;
     float _avatarLODDistanceMultiplier = DEFAULT_AVATAR_LOD_DISTANCE_MULTIPLIER;
+    float _avatarImpostorDistance = DEFAULT_AVATAR_IMPOSTOR_DISTANCE;
     
     float _octreeSizeScale = DEFAULT_OCTREE_SIZE_SCALE;
     int _boundaryLevelAdjust = 0;
+
+    float _metavoxelLODThreshold = DEFAULT_METAVOXEL_LOD_THRESHOLD;
+    float _shadowDistanceScale = DEFAULT_SHADOW_DISTANCE_SCALE;
     
     quint64 _lastAdjust = 0;
-    quint64 _lastAvatarDetailDrop = 0;
     SimpleMovingAverage _fpsAverage = FIVE_SECONDS_OF_FRAMES;
-    SimpleMovingAverage _fastFPSAverage = ONE_SECOND_OF_FRAMES;
     
     bool _shouldRenderTableNeedsRebuilding = true;
     QMap<float, float> _shouldRenderTable;
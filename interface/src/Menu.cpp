@@ -297,6 +297,18 @@ Menu::Menu() {
     addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::Metavoxels, 0, true);
     addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::Entities, 0, true);
     addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::AmbientOcclusion);
+    
+    QMenu* ambientOcclusionResolutionMenu = renderOptionsMenu->addMenu(MenuOption::AmbientOcclusionResolution);
+    QActionGroup* ambientOcclusionResolutionGroup = new QActionGroup(ambientOcclusionResolutionMenu);
+    ambientOcclusionResolutionGroup->setExclusive(true);
+    ambientOcclusionResolutionGroup->addAction(addCheckableActionToQMenuAndActionHash(ambientOcclusionResolutionMenu,
+        MenuOption::AmbientOcclusionResolutionFull, 0, false));
+    ambientOcclusionResolutionGroup->addAction(addCheckableActionToQMenuAndActionHash(ambientOcclusionResolutionMenu,
+        MenuOption::AmbientOcclusionResolutionHalf, 0, true));
+    ambientOcclusionResolutionGroup->addAction(addCheckableActionToQMenuAndActionHash(ambientOcclusionResolutionMenu,
+        MenuOption::AmbientOcclusionResolutionQuarter, 0, false));
+    addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::AmbientOcclusionTemporal, 0, true);
+    
     addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::DontFadeOnOctreeServerChanges);
     addCheckableActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::DisableAutoAdjustLOD);
 
@@ -383,6 +395,10 @@ Menu::Menu() {
     addActionToQMenuAndActionHash(metavoxelOptionsMenu, MenuOption::NetworkSimulator, 0,
                                   dialogsManager.data(), SLOT(showMetavoxelNetworkSimulator()));
     
+    QMenu* physicsOptionsMenu = developerMenu->addMenu("Physics");
+    addCheckableActionToQMenuAndActionHash(physicsOptionsMenu, MenuOption::ParallelPhysicsSolver, 0, false,
+                                           qApp, SLOT(setParallelPhysicsSolver(bool)));
+
     QMenu* handOptionsMenu = developerMenu->addMenu("Hands");
     addCheckableActionToQMenuAndActionHash(handOptionsMenu, MenuOption::AlignForearmsWithWrists, 0, false);
     addCheckableActionToQMenuAndActionHash(handOptionsMenu, MenuOption::AlternateIK, 0, false);
@@ -441,6 +457,7 @@ Menu::Menu() {
     addCheckableActionToQMenuAndActionHash(perfTimerMenu, MenuOption::ExpandMyAvatarSimulateTiming, 0, false);
     addCheckableActionToQMenuAndActionHash(perfTimerMenu, MenuOption::ExpandOtherAvatarTiming, 0, false);
     addCheckableActionToQMenuAndActionHash(perfTimerMenu, MenuOption::ExpandPaintGLTiming, 0, false);
+    addActionToQMenuAndActionHash(perfTimerMenu, MenuOption::SaveTimingTrace, 0, qApp, SLOT(saveTimingTrace()));
 
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::TestPing, 0, true);
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::FrameTimer);
@@ -104,6 +104,11 @@ namespace MenuOption {
     const QString AlignForearmsWithWrists = "Align Forearms with Wrists";
     const QString AlternateIK = "Alternate IK";
     const QString AmbientOcclusion = "Ambient Occlusion";
+    const QString AmbientOcclusionResolution = "Ambient Occlusion Resolution";
+    const QString AmbientOcclusionResolutionFull = "Full";
+    const QString AmbientOcclusionResolutionHalf = "Half";
+    const QString AmbientOcclusionResolutionQuarter = "Quarter";
+    const QString AmbientOcclusionTemporal = "Accumulate Ambient Occlusion";
     const QString Animations = "Animations...";
     const QString Atmosphere = "Atmosphere";
     const QString Attachments = "Attachments...";
@@ -197,6 +202,7 @@ namespace MenuOption {
     const QString OffAxisProjection = "Off-Axis Projection";
     const QString OldVoxelCullingMode = "Old Voxel Culling Mode";
     const QString Pair = "Pair";
+    const QString ParallelPhysicsSolver = "Solve Physics Islands in Parallel";
     const QString PipelineWarnings = "Log Render Pipeline Warnings";
     const QString Preferences = "Preferences...";
     const QString Quit =  "Quit";
@@ -237,6 +243,7 @@ namespace MenuOption {
     const QString ResetSensors = "Reset Sensors";
     const QString RunningScripts = "Running Scripts";
     const QString RunTimingTests = "Run Timing Tests";
+    const QString SaveTimingTrace = "Save Timing Trace";
     const QString ScriptEditor = "Script Editor...";
     const QString ScriptedMotorControl = "Enable Scripted Motor Control";
     const QString ShowBordersEntityNodes = "Show Entity Nodes";
@@ -19,6 +19,7 @@
 #include <QReadLocker>
 #include <QWriteLocker>
 #include <QThreadPool>
+#include <QtAlgorithms>
 #include <QtDebug>
 
 #include <glm/gtx/transform.hpp>
@@ -34,6 +35,7 @@
 #include <ScriptCache.h>
 
 #include "Application.h"
+#include "LODManager.h"
 #include "MetavoxelSystem.h"
 
 using namespace std;
@@ -60,9 +62,14 @@ MetavoxelSystem::~MetavoxelSystem() {
     _updater = NULL;
 }
 
+// building a mesh costs little on the main thread, but uploading one several megabytes in size can stall a frame
+const int MAX_UPLOAD_BYTES_PER_FRAME = 1024 * 1024;
+
 void MetavoxelSystem::init() {
     MetavoxelClientManager::init();
     
+    _uploadBudget = MAX_UPLOAD_BYTES_PER_FRAME;
+    
     _baseHeightfieldProgram.addShaderFromSourceFile(QGLShader::Vertex, PathUtils::resourcesPath() +
             "shaders/metavoxel_heightfield_base.vert");
     _baseHeightfieldProgram.addShaderFromSourceFile(QGLShader::Fragment, PathUtils::resourcesPath() +
@@ -149,8 +156,8 @@ void MetavoxelSystem::simulate(float deltaTime) {
     // update the lod
     {
         QWriteLocker locker(&_lodLock);
-        const float DEFAULT_LOD_THRESHOLD = 0.01f;
-        _lod = MetavoxelLOD(Application::getInstance()->getCamera()->getPosition(), DEFAULT_LOD_THRESHOLD);
+        _lod = MetavoxelLOD(Application::getInstance()->getCamera()->getPosition(),
+                            DependencyManager::get<LODManager>()->getMetavoxelLODThreshold());
     }
 
     SimulateVisitor simulateVisitor(deltaTime, getLOD());
@@ -191,6 +198,12 @@ const GLint SPLAT_TEXTURE_UNITS[] = { 3, 4, 5, 6 };
 static const int EIGHT_BIT_MAXIMUM = 255;
 static const float EIGHT_BIT_MAXIMUM_RECIPROCAL = 1.0f / EIGHT_BIT_MAXIMUM;
 
+// orders batches so that those sharing a vertex buffer (all the heightfield nodes of a size share a grid) are drawn
+// together, with the buffer bound once
+template<class T> static bool vertexBufferLessThan(const T& first, const T& second) {
+    return first.vertexBufferID < second.vertexBufferID;
+}
+
 void MetavoxelSystem::render() {
     // update the frustum
     ViewFrustum* viewFrustum = Application::getInstance()->getDisplayViewFrustum();
@@ -198,6 +211,8 @@ void MetavoxelSystem::render() {
         viewFrustum->getFarBottomRight(), viewFrustum->getNearTopLeft(), viewFrustum->getNearTopRight(),
         viewFrustum->getNearBottomLeft(), viewFrustum->getNearBottomRight());
    
+    _uploadBudget = MAX_UPLOAD_BYTES_PER_FRAME;
+   
     RenderVisitor renderVisitor(getLOD());
     guideToAugmented(renderVisitor, true);
     
@@ -216,6 +231,9 @@ void MetavoxelSystem::render() {
         
         _baseHeightfieldProgram.bind();
         
+        qStableSort(_heightfieldBaseBatches.begin(), _heightfieldBaseBatches.end(),
+            vertexBufferLessThan<HeightfieldBaseLayerBatch>);
+        GLuint boundVertexBufferID = 0;
         foreach (const HeightfieldBaseLayerBatch& batch, _heightfieldBaseBatches) {
             glPushMatrix();
             glTranslatef(batch.translation.x, batch.translation.y, batch.translation.z);
@@ -223,12 +241,14 @@ void MetavoxelSystem::render() {
             glRotatef(glm::degrees(glm::angle(batch.rotation)), axis.x, axis.y, axis.z);
             glScalef(batch.scale.x, batch.scale.y, batch.scale.z);
             
-            glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBufferID);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBufferID);
-        
-            HeightfieldPoint* point = 0;
-            glVertexPointer(3, GL_FLOAT, sizeof(HeightfieldPoint), &point->vertex);
-            glTexCoordPointer(2, GL_FLOAT, sizeof(HeightfieldPoint), &point->textureCoord);
+            if (batch.vertexBufferID != boundVertexBufferID) {
+                glBindBuffer(GL_ARRAY_BUFFER, boundVertexBufferID = batch.vertexBufferID);
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBufferID);
+            
+                HeightfieldPoint* point = 0;
+                glVertexPointer(3, GL_FLOAT, sizeof(HeightfieldPoint), &point->vertex);
+                glTexCoordPointer(2, GL_FLOAT, sizeof(HeightfieldPoint), &point->textureCoord);
+            }
             
             glBindTexture(GL_TEXTURE_2D, batch.heightTextureID);
             
@@ -240,17 +260,20 @@ void MetavoxelSystem::render() {
             
             glDrawRangeElements(GL_TRIANGLES, 0, batch.vertexCount - 1, batch.indexCount, GL_UNSIGNED_INT, 0);
             
-            glBindTexture(GL_TEXTURE_2D, 0);
-            
             glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, 0);
-        
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         
             glPopMatrix();
         }
         
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        
         DependencyManager::get<TextureCache>()->setPrimaryDrawBuffers(true, false);
         
         _baseHeightfieldProgram.release();
@@ -266,6 +289,9 @@ void MetavoxelSystem::render() {
             
             _splatHeightfieldProgram.bind();
             
+            qStableSort(_heightfieldSplatBatches.begin(), _heightfieldSplatBatches.end(),
+                vertexBufferLessThan<HeightfieldSplatBatch>);
+            boundVertexBufferID = 0;
             foreach (const HeightfieldSplatBatch& batch, _heightfieldSplatBatches) {
                 glPushMatrix();
                 glTranslatef(batch.translation.x, batch.translation.y, batch.translation.z);
@@ -273,12 +299,14 @@ void MetavoxelSystem::render() {
                 glRotatef(glm::degrees(glm::angle(batch.rotation)), axis.x, axis.y, axis.z);
                 glScalef(batch.scale.x, batch.scale.y, batch.scale.z);
                 
-                glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBufferID);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBufferID);
-            
-                HeightfieldPoint* point = 0;
-                glVertexPointer(3, GL_FLOAT, sizeof(HeightfieldPoint), &point->vertex);
-                glTexCoordPointer(2, GL_FLOAT, sizeof(HeightfieldPoint), &point->textureCoord);
+                if (batch.vertexBufferID != boundVertexBufferID) {
+                    glBindBuffer(GL_ARRAY_BUFFER, boundVertexBufferID = batch.vertexBufferID);
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indexBufferID);
+                
+                    HeightfieldPoint* point = 0;
+                    glVertexPointer(3, GL_FLOAT, sizeof(HeightfieldPoint), &point->vertex);
+                    glTexCoordPointer(2, GL_FLOAT, sizeof(HeightfieldPoint), &point->textureCoord);
+                }
                 
                 glBindTexture(GL_TEXTURE_2D, batch.heightTextureID);
                 
@@ -312,24 +340,26 @@ void MetavoxelSystem::render() {
                 }
                 
                 glDrawRangeElements(GL_TRIANGLES, 0, batch.vertexCount - 1, batch.indexCount, GL_UNSIGNED_INT, 0);
-             
-                for (int i = 0; i < SPLAT_COUNT; i++) {
-                    glActiveTexture(GL_TEXTURE0 + SPLAT_TEXTURE_UNITS[i]);
-                    glBindTexture(GL_TEXTURE_2D, 0);
-                }
-            
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, 0);
             
                 glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, 0);
-            
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
                 
                 glPopMatrix();   
             }
             
+            for (int i = 0; i < SPLAT_COUNT; i++) {
+                glActiveTexture(GL_TEXTURE0 + SPLAT_TEXTURE_UNITS[i]);
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+        
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            
             _splatHeightfieldProgram.release();
             
             glDisable(GL_POLYGON_OFFSET_FILL);
@@ -541,6 +571,15 @@ void MetavoxelSystem::setHeightfieldMaterial(const SharedObjectPointer& spanner,
     applyMaterialEdit(edit, true);
 }
 
+bool MetavoxelSystem::spendUploadBudget(int bytes) {
+    // one upload per frame always goes ahead, however large
+    if (_uploadBudget <= 0) {
+        return false;
+    }
+    _uploadBudget -= bytes;
+    return true;
+}
+
 void MetavoxelSystem::deleteTextures(int heightTextureID, int colorTextureID, int materialTextureID) const {
     glDeleteTextures(1, (const GLuint*)&heightTextureID);
     glDeleteTextures(1, (const GLuint*)&colorTextureID);
@@ -909,6 +948,7 @@ public:
     AugmentVisitor(const MetavoxelLOD& lod, const MetavoxelData& previousData);
     
     virtual int visit(MetavoxelInfo& info);
+    virtual MetavoxelVisitor* createParallelCopy() const;
 
 private:
     
@@ -930,6 +970,11 @@ int AugmentVisitor::visit(MetavoxelInfo& info) {
     return STOP_RECURSION;
 }
 
+MetavoxelVisitor* AugmentVisitor::createParallelCopy() const {
+    // the implementations augment independent areas of the data, so the tour can be split among threads
+    return new AugmentVisitor(_lod, _previousData);
+}
+
 class Augmenter : public QRunnable {
 public:
     
@@ -1027,11 +1072,12 @@ void VoxelPoint::setNormal(const glm::vec3& normal) {
 }
 
 VoxelBuffer::VoxelBuffer(const QVector<VoxelPoint>& vertices, const QVector<int>& indices, const QVector<glm::vec3>& hermite,
-        const QMultiHash<VoxelCoord, int>& quadIndices, int size, const QVector<SharedObjectPointer>& materials) :
+        const QMultiHash<VoxelCoord, int>& quadIndices, int size, bool hermiteEnabled,
+        const QVector<SharedObjectPointer>& materials) :
     _vertices(vertices),
     _indices(indices),
     _hermite(hermite),
-    _hermiteEnabled(Menu::getInstance()->isOptionChecked(MenuOption::DisplayHermiteData)),
+    _hermiteEnabled(hermiteEnabled),
     _quadIndices(quadIndices),
     _size(size),
     _vertexCount(vertices.size()),
@@ -1048,6 +1094,11 @@ VoxelBuffer::~VoxelBuffer() {
         Q_ARG(int, _indexBufferID), Q_ARG(int, _hermiteBufferID));
 }
 
+int VoxelBuffer::getUploadSize() const {
+    return _vertices.size() * sizeof(VoxelPoint) + _indices.size() * sizeof(int) +
+        (_hermiteEnabled ? _hermite.size() * sizeof(glm::vec3) : 0);
+}
+
 bool VoxelBuffer::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         float boundsDistance, float& distance) const {
     float highest = _size - 1.0f;
@@ -1586,6 +1637,686 @@ static StackArray::Entry getEntry(const StackArray* lineSrc, int stackWidth, int
     return entry;
 }
 
+static BufferDataPointer buildVoxelBuffer(const HeightfieldNodePointer& node, const glm::vec3& scale,
+        bool displayHermite) {
+    int width = node->getHeight()->getWidth();
+    // see http://www.frankpetterson.com/publications/dualcontour/dualcontour.pdf for a description of the
+    // dual contour algorithm for generating meshes from voxel data using Hermite-tagged edges
+    
+    QVector<VoxelPoint> vertices;
+    QVector<int> indices;
+    QVector<glm::vec3> hermiteSegments;
+    QMultiHash<VoxelCoord, int> quadIndices;
+    
+    int stackWidth = node->getStack()->getWidth();
+    int stackHeight = node->getStack()->getContents().size() / stackWidth;
+    int innerStackWidth = stackWidth - HeightfieldData::SHARED_EDGE;
+    int innerStackHeight = stackHeight - HeightfieldData::SHARED_EDGE;
+    const StackArray* src = node->getStack()->getContents().constData();
+    const quint16* heightSrc = node->getHeight()->getContents().constData() +
+        (width + 1) * HeightfieldHeight::HEIGHT_BORDER;
+    QVector<SharedObjectPointer> stackMaterials = node->getStack()->getMaterials();
+    QHash<int, int> materialMap;
+    
+    int colorWidth;
+    const uchar* colorSrc = NULL;
+    float colorStepX, colorStepZ;
+    if (node->getColor()) {
+        colorWidth = node->getColor()->getWidth();
+        int colorHeight = node->getColor()->getContents().size() / (colorWidth * DataBlock::COLOR_BYTES);
+        colorSrc = (const uchar*)node->getColor()->getContents().constData();
+        colorStepX = (colorWidth - HeightfieldData::SHARED_EDGE) / (float)innerStackWidth;
+        colorStepZ = (colorHeight - HeightfieldData::SHARED_EDGE) / (float)innerStackHeight;
+    }
+    
+    int materialWidth;
+    const uchar* materialSrc = NULL;
+    float materialStepX, materialStepZ;
+    if (node->getMaterial()) {
+        materialWidth = node->getMaterial()->getWidth();
+        int materialHeight = node->getMaterial()->getContents().size() / materialWidth;
+        materialSrc = (const uchar*)node->getMaterial()->getContents().constData();
+        materialStepX = (materialWidth - HeightfieldData::SHARED_EDGE) / (float)innerStackWidth;
+        materialStepZ = (materialHeight - HeightfieldData::SHARED_EDGE) / (float)innerStackHeight;
+    }
+    
+    const int EDGES_PER_CUBE = 12;
+    EdgeCrossing crossings[EDGES_PER_CUBE * 2];
+    
+    // as we scan down the cube generating vertices between grid points, we remember the indices of the last
+    // (element, line, section--x, y, z) so that we can connect generated vertices as quads
+    IndexVector indicesX;
+    IndexVector lastIndicesX;
+    QVector<IndexVector> indicesZ(stackWidth + 1);
+    QVector<IndexVector> lastIndicesZ(stackWidth + 1);
+    float step = 1.0f / innerStackWidth;
+    float voxelScale = scale.y / (numeric_limits<quint16>::max() * scale.x * step);
+    
+    for (int z = 0; z <= stackHeight; z++) {
+        bool middleZ = (z != 0 && z != stackHeight);
+        const StackArray* lineSrc = src;
+        const quint16* heightLineSrc = heightSrc;
+        for (int x = 0; x <= stackWidth; x++) {
+            bool middleX = (x != 0 && x != stackWidth);
+            
+            // find the y extents of this and the neighboring columns
+            int minimumY = INT_MAX, maximumY = -1;
+            lineSrc->getExtents(minimumY, maximumY);
+            if (middleX) {
+                lineSrc[1].getExtents(minimumY, maximumY);
+                if (middleZ) {
+                    lineSrc[stackWidth + 1].getExtents(minimumY, maximumY);
+                }
+            }
+            if (middleZ) {
+                lineSrc[stackWidth].getExtents(minimumY, maximumY);
+            }
+            if (maximumY >= minimumY) {
+                float heightfieldHeight = *heightLineSrc * voxelScale;
+                float nextHeightfieldHeightX = heightLineSrc[1] * voxelScale;
+                float nextHeightfieldHeightZ = heightLineSrc[width] * voxelScale;
+                float nextHeightfieldHeightXZ = heightLineSrc[width + 1] * voxelScale;
+                const int UPPER_LEFT_CORNER = 1;
+                const int UPPER_RIGHT_CORNER = 2;
+                const int LOWER_LEFT_CORNER = 4;
+                const int LOWER_RIGHT_CORNER = 8;
+                const int NO_CORNERS = 0;
+                const int ALL_CORNERS = UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER | LOWER_LEFT_CORNER | LOWER_RIGHT_CORNER;
+                const int NEXT_CORNERS[] = { 1, 3, 0, 2 };
+                int corners = NO_CORNERS;
+                if (heightfieldHeight != 0.0f) {
+                    corners |= UPPER_LEFT_CORNER;
+                }
+                if (nextHeightfieldHeightX != 0.0f && x != stackWidth) {
+                    corners |= UPPER_RIGHT_CORNER;
+                }
+                if (nextHeightfieldHeightZ != 0.0f && z != stackHeight) {
+                    corners |= LOWER_LEFT_CORNER;
+                }
+                if (nextHeightfieldHeightXZ != 0.0f && x != stackWidth && z != stackHeight) {
+                    corners |= LOWER_RIGHT_CORNER;
+                }
+                bool stitchable = x != 0 && z != 0 && !(corners == NO_CORNERS || corners == ALL_CORNERS);
+                EdgeCrossing cornerCrossings[CORNER_COUNT];
+                int clampedX = qMax(x - 1, 0), clampedZ = qMax(z - 1, 0);
+                int cornerMinimumY = INT_MAX, cornerMaximumY = -1;
+                if (stitchable) {
+                    for (int i = 0; i < CORNER_COUNT; i++) {
+                        if (!(corners & (1 << i))) {
+                            continue;
+                        }
+                        int offsetX = (i & X_MAXIMUM_FLAG) ? 1 : 0;
+                        int offsetZ = (i & Y_MAXIMUM_FLAG) ? 1 : 0;
+                        const quint16* height = heightLineSrc + offsetZ * width + offsetX;
+                        float heightValue = *height * voxelScale;
+                        int y = (int)heightValue;
+                        cornerMinimumY = qMin(cornerMinimumY, y);
+                        cornerMaximumY = qMax(cornerMaximumY, y);
+                        EdgeCrossing& crossing = cornerCrossings[i];
+                        crossing.point = glm::vec3(offsetX, heightValue, offsetZ);
+                        int left = height[-1];
+                        int right = height[1];
+                        int down = height[-width];
+                        int up = height[width];
+                        crossing.normal = glm::normalize(glm::vec3((left == 0 || right == 0) ? 0.0f : left - right,
+                            2.0f / voxelScale, (up == 0 || down == 0) ? 0.0f : down - up));
+                        int clampedOffsetX = clampedX + offsetX, clampedOffsetZ = clampedZ + offsetZ;
+                        if (colorSrc) {
+                            const uchar* color = colorSrc + ((int)(clampedOffsetZ * colorStepZ) * colorWidth +
+                                (int)(clampedOffsetX * colorStepX)) * DataBlock::COLOR_BYTES;
+                            crossing.color = qRgb(color[0], color[1], color[2]);
+                         
+                        } else {
+                            crossing.color = qRgb(numeric_limits<quint8>::max(), numeric_limits<quint8>::max(),
+                                numeric_limits<quint8>::max());
+                        }
+                        int material = 0;
+                        if (materialSrc) {
+                            material = materialSrc[(int)(clampedOffsetZ * materialStepZ) * materialWidth +
+                                (int)(clampedOffsetX * materialStepX)];
+                            if (material != 0) {
+                                int& mapping = materialMap[material];
+                                if (mapping == 0) {
+                                    mapping = getMaterialIndex(node->getMaterial()->getMaterials().at(material - 1),
+                                        stackMaterials);
+                                }
+                                material = mapping;
+                            }
+                        }
+                        crossing.material = material;
+                    }
+                    minimumY = qMin(minimumY, cornerMinimumY);
+                    maximumY = qMax(maximumY, cornerMaximumY);
+                    
+                    if (corners == (LOWER_LEFT_CORNER | UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER)) {
+                        appendTriangle(cornerCrossings[1], cornerCrossings[0], cornerCrossings[2],
+                            clampedX, clampedZ, step, vertices, indices, quadIndices);
+                    
+                    } else if (corners == (UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER)) {
+                        appendTriangle(cornerCrossings[2], cornerCrossings[3], cornerCrossings[1],
+                            clampedX, clampedZ, step, vertices, indices, quadIndices);
+                    }
+                }
+                int position = minimumY;
+                int count = maximumY - minimumY + 1;
+                NormalIndex lastIndexY = { { -1, -1, -1, -1 } };
+                indicesX.position = position;
+                indicesX.resize(count);
+                indicesZ[x].position = position;
+                indicesZ[x].resize(count);
+                for (int y = position, end = position + count; y < end; y++) {
+                    StackArray::Entry entry = getEntry(lineSrc, stackWidth, y, heightfieldHeight, cornerCrossings, 0);
+                    if (displayHermite && x != 0 && z != 0 && !lineSrc->isEmpty() && y >= lineSrc->getPosition()) {
+                        glm::vec3 normal;
+                        if (entry.hermiteX != 0) {
+                            glm::vec3 start = glm::vec3(clampedX + entry.getHermiteX(normal), y, clampedZ) * step;
+                            hermiteSegments.append(start);
+                            hermiteSegments.append(start + normal * step);
+                        }
+                        if (entry.hermiteY != 0) {
+                            glm::vec3 start = glm::vec3(clampedX, y + entry.getHermiteY(normal), clampedZ) * step;
+                            hermiteSegments.append(start);
+                            hermiteSegments.append(start + normal * step);
+                        }
+                        if (entry.hermiteZ != 0) {
+                            glm::vec3 start = glm::vec3(clampedX, y, clampedZ + entry.getHermiteZ(normal)) * step;
+                            hermiteSegments.append(start);
+                            hermiteSegments.append(start + normal * step);
+                        }
+                    }
+                    // number variables correspond to cube corners, where the x, y, and z components are represented as
+                    // bits in the 0, 1, and 2 position, respectively; hence, alpha0 is the value at the minimum x, y, and
+                    // z corner and alpha7 is the value at the maximum x, y, and z
+                    int alpha0 = lineSrc->getEntryAlpha(y, heightfieldHeight);
+                    int alpha2 = lineSrc->getEntryAlpha(y + 1, heightfieldHeight);
+                    int alpha1 = alpha0, alpha3 = alpha2, alpha4 = alpha0, alpha6 = alpha2;
+                    int alphaTotal = alpha0 + alpha2;
+                    int possibleTotal = 2 * numeric_limits<uchar>::max();
+                    
+                    // cubes on the edge are two-dimensional: this ensures that their vertices will be shared between
+                    // neighboring blocks, which share only one layer of points
+                    if (middleZ) {
+                        alphaTotal += (alpha4 = lineSrc[stackWidth].getEntryAlpha(y, nextHeightfieldHeightZ));
+                        possibleTotal += numeric_limits<uchar>::max();
+                        
+                        alphaTotal += (alpha6 = lineSrc[stackWidth].getEntryAlpha(y + 1, nextHeightfieldHeightZ));
+                        possibleTotal += numeric_limits<uchar>::max();
+                    }
+                    int alpha5 = alpha4, alpha7 = alpha6;
+                    if (middleX) {
+                        alphaTotal += (alpha1 = lineSrc[1].getEntryAlpha(y, nextHeightfieldHeightX));
+                        possibleTotal += numeric_limits<uchar>::max();
+                        
+                        alphaTotal += (alpha3 = lineSrc[1].getEntryAlpha(y + 1, nextHeightfieldHeightX));
+                        possibleTotal += numeric_limits<uchar>::max();
+                            
+                        if (middleZ) {
+                            alphaTotal += (alpha5 = lineSrc[stackWidth + 1].getEntryAlpha(y, nextHeightfieldHeightXZ));
+                            possibleTotal += numeric_limits<uchar>::max();
+                            
+                            alphaTotal += (alpha7 = lineSrc[stackWidth + 1].getEntryAlpha(y + 1, nextHeightfieldHeightXZ));
+                            possibleTotal += numeric_limits<uchar>::max();
+                        }
+                    }
+                    if (alphaTotal == 0 || alphaTotal == possibleTotal) {
+                        continue; // no corners set/all corners set
+                    }
+                    // we first look for crossings with the heightfield corner vertices; these take priority
+                    int crossingCount = 0;
+                    if (y >= cornerMinimumY && y <= cornerMaximumY) {
+                        // first look for set corners, which override any interpolated values
+                        int crossedCorners = NO_CORNERS;
+                        for (int i = 0; i < CORNER_COUNT; i++) {
+                            if (!(corners & (1 << i))) {
+                                continue;
+                            }
+                            const EdgeCrossing& cornerCrossing = cornerCrossings[i];
+                            if (cornerCrossing.point.y >= y && cornerCrossing.point.y < y + 1) {
+                                crossedCorners |= (1 << i);
+                            }
+                        }
+                        switch (crossedCorners) {
+                            case UPPER_LEFT_CORNER:
+                            case LOWER_LEFT_CORNER | UPPER_LEFT_CORNER:
+                            case LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER | UPPER_LEFT_CORNER:
+                            case UPPER_LEFT_CORNER | LOWER_RIGHT_CORNER:
+                                crossings[crossingCount++] = cornerCrossings[0];
+                                crossings[crossingCount - 1].point.y -= y;
+                                break;
+                            
+                            case UPPER_RIGHT_CORNER:
+                            case UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER:
+                            case UPPER_RIGHT_CORNER | LOWER_LEFT_CORNER:
+                            case LOWER_LEFT_CORNER | UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER:
+                                crossings[crossingCount++] = cornerCrossings[1];
+                                crossings[crossingCount - 1].point.y -= y;
+                                break;
+                            
+                            case LOWER_LEFT_CORNER:
+                            case LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER:
+                            case UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER:
+                                crossings[crossingCount++] = cornerCrossings[2];
+                                crossings[crossingCount - 1].point.y -= y;
+                                break;
+                            
+                            case LOWER_RIGHT_CORNER:
+                            case UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER:
+                            case UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER:
+                                crossings[crossingCount++] = cornerCrossings[3];
+                                crossings[crossingCount - 1].point.y -= y;
+                                break;
+                            
+                            case NO_CORNERS:
+                                for (int i = 0; i < CORNER_COUNT; i++) {
+                                    if (!(corners & (1 << i))) {
+                                        continue;
+                                    }
+                                    int nextIndex = NEXT_CORNERS[i];
+                                    if (!(corners & (1 << nextIndex))) {
+                                        continue;
+                                    }
+                                    const EdgeCrossing& cornerCrossing = cornerCrossings[i];
+                                    const EdgeCrossing& nextCornerCrossing = cornerCrossings[nextIndex];
+                                    float divisor = (nextCornerCrossing.point.y - cornerCrossing.point.y);
+                                    if (divisor == 0.0f) {
+                                        continue;
+                                    }
+                                    float t1 = (y - cornerCrossing.point.y) / divisor;
+                                    float t2 = (y + 1 - cornerCrossing.point.y) / divisor;
+                                    if (t1 >= 0.0f && t1 <= 1.0f) {
+                                        crossings[crossingCount++].mix(cornerCrossing, nextCornerCrossing, t1);
+                                        crossings[crossingCount - 1].point.y -= y;
+                                    }
+                                    if (t2 >= 0.0f && t2 <= 1.0f) {
+                                        crossings[crossingCount++].mix(cornerCrossing, nextCornerCrossing, t2);
+                                        crossings[crossingCount - 1].point.y -= y;
+                                    }
+                                }
+                                break;
+                        }
+                    }
+                    
+                    // the terrifying conditional code that follows checks each cube edge for a crossing, gathering
+                    // its properties (color, material, normal) if one is present; as before, boundary edges are excluded
+                    if (crossingCount == 0) {
+                        StackArray::Entry nextEntryY = getEntry(lineSrc, stackWidth, y + 1,
+                            heightfieldHeight, cornerCrossings, 0);
+                        if (middleX) {
+                            StackArray::Entry nextEntryX = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightX,
+                                cornerCrossings, 1);
+                            StackArray::Entry nextEntryXY = getEntry(lineSrc, stackWidth, y + 1, nextHeightfieldHeightX,
+                                cornerCrossings, 1);   
+                            if (alpha0 != alpha1) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(entry.getHermiteX(crossing.normal), 0.0f, 0.0f);
+                                crossing.setColorMaterial(alpha0 == 0 ? nextEntryX : entry);
+                            }
+                            if (alpha1 != alpha3) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(1.0f, nextEntryX.getHermiteY(crossing.normal), 0.0f);
+                                crossing.setColorMaterial(alpha1 == 0 ? nextEntryXY : nextEntryX);
+                            }
+                            if (alpha2 != alpha3) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(nextEntryY.getHermiteX(crossing.normal), 1.0f, 0.0f);
+                                crossing.setColorMaterial(alpha2 == 0 ? nextEntryXY : nextEntryY);
+                            }
+                            if (middleZ) {
+                                StackArray::Entry nextEntryZ = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightZ,
+                                    cornerCrossings, 2);
+                                StackArray::Entry nextEntryXZ = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightXZ,
+                                    cornerCrossings, 3);
+                                StackArray::Entry nextEntryXYZ = getEntry(lineSrc, stackWidth, y + 1,
+                                    nextHeightfieldHeightXZ, cornerCrossings, 3);
+                                if (alpha1 != alpha5) {
+                                    EdgeCrossing& crossing = crossings[crossingCount++];
+                                    crossing.point = glm::vec3(1.0f, 0.0f, nextEntryX.getHermiteZ(crossing.normal));
+                                    crossing.setColorMaterial(alpha1 == 0 ? nextEntryXZ : nextEntryX);
+                                }
+                                if (alpha3 != alpha7) {
+                                    EdgeCrossing& crossing = crossings[crossingCount++];
+                                    StackArray::Entry nextEntryXY = getEntry(lineSrc, stackWidth, y + 1,
+                                        nextHeightfieldHeightX, cornerCrossings, 1);
+                                    crossing.point = glm::vec3(1.0f, 1.0f, nextEntryXY.getHermiteZ(crossing.normal));
+                                    crossing.setColorMaterial(alpha3 == 0 ? nextEntryXYZ : nextEntryXY);
+                                }
+                                if (alpha4 != alpha5) {
+                                    EdgeCrossing& crossing = crossings[crossingCount++];
+                                    crossing.point = glm::vec3(nextEntryZ.getHermiteX(crossing.normal), 0.0f, 1.0f);
+                                    crossing.setColorMaterial(alpha4 == 0 ? nextEntryXZ : nextEntryZ);
+                                }
+                                if (alpha5 != alpha7) {
+                                    EdgeCrossing& crossing = crossings[crossingCount++];
+                                    StackArray::Entry nextEntryXZ = getEntry(lineSrc, stackWidth, y,
+                                        nextHeightfieldHeightXZ, cornerCrossings, 3);
+                                    crossing.point = glm::vec3(1.0f, nextEntryXZ.getHermiteY(crossing.normal), 1.0f);
+                                    crossing.setColorMaterial(alpha5 == 0 ? nextEntryXYZ : nextEntryXZ);
+                                }
+                                if (alpha6 != alpha7) {
+                                    EdgeCrossing& crossing = crossings[crossingCount++];
+                                    StackArray::Entry nextEntryYZ = getEntry(lineSrc, stackWidth, y + 1,
+                                        nextHeightfieldHeightZ, cornerCrossings, 2);
+                                    crossing.point = glm::vec3(nextEntryYZ.getHermiteX(crossing.normal), 1.0f, 1.0f);
+                                    crossing.setColorMaterial(alpha6 == 0 ? nextEntryXYZ : nextEntryYZ);
+                                }
+                            }
+                        }
+                        if (alpha0 != alpha2) {
+                            EdgeCrossing& crossing = crossings[crossingCount++];
+                            crossing.point = glm::vec3(0.0f, entry.getHermiteY(crossing.normal), 0.0f);
+                            crossing.setColorMaterial(alpha0 == 0 ? nextEntryY : entry);
+                        }
+                        if (middleZ) {
+                            StackArray::Entry nextEntryZ = getEntry(lineSrc, stackWidth, y,
+                                nextHeightfieldHeightZ, cornerCrossings, 2);
+                            StackArray::Entry nextEntryYZ = getEntry(lineSrc, stackWidth, y + 1,
+                                nextHeightfieldHeightZ, cornerCrossings, 2);
+                            if (alpha0 != alpha4) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(0.0f, 0.0f, entry.getHermiteZ(crossing.normal));
+                                crossing.setColorMaterial(alpha0 == 0 ? nextEntryZ : entry);
+                            }
+                            if (alpha2 != alpha6) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(0.0f, 1.0f, nextEntryY.getHermiteZ(crossing.normal));
+                                crossing.setColorMaterial(alpha2 == 0 ? nextEntryYZ : nextEntryY);
+                            }
+                            if (alpha4 != alpha6) {
+                                EdgeCrossing& crossing = crossings[crossingCount++];
+                                crossing.point = glm::vec3(0.0f, nextEntryZ.getHermiteY(crossing.normal), 1.0f);
+                                crossing.setColorMaterial(alpha4 == 0 ? nextEntryYZ : nextEntryZ);
+                            }
+                        }
+                    }
+                    // make sure we have valid crossings to include
+                    int validCrossings = 0;
+                    for (int i = 0; i < crossingCount; i++) {
+                        if (qAlpha(crossings[i].color) != 0) {
+                            validCrossings++;
+                        }
+                    }
+                    NormalIndex index = { { -1, -1, -1, -1 } };
+                    if (validCrossings != 0) {
+                        index.indices[0] = index.indices[1] = index.indices[2] = index.indices[3] = vertices.size();
+                        glm::vec3 center;
+                        glm::vec3 normals[MAX_NORMALS_PER_VERTEX];
+                        int normalCount = 0;
+                        const float CREASE_COS_NORMAL = glm::cos(glm::radians(45.0f));
+                        const int MAX_MATERIALS_PER_VERTEX = 4;
+                        quint8 materials[] = { 0, 0, 0, 0 };
+                        glm::vec4 materialWeights;
+                        float totalWeight = 0.0f;
+                        int red = 0, green = 0, blue = 0;
+                        for (int i = 0; i < crossingCount; i++) {
+                            const EdgeCrossing& crossing = crossings[i];
+                            if (qAlpha(crossing.color) == 0) {
+                                continue;
+                            }
+                            center += crossing.point;
+                            
+                            int j = 0;
+                            for (; j < normalCount; j++) {
+                                if (glm::dot(normals[j], crossing.normal) > CREASE_COS_NORMAL) {
+                                    normals[j] = safeNormalize(normals[j] + crossing.normal);
+                                    break;
+                                }
+                            }
+                            if (j == normalCount) {
+                                normals[normalCount++] = crossing.normal;
+                            }
+                            
+                            red += qRed(crossing.color);
+                            green += qGreen(crossing.color);
+                            blue += qBlue(crossing.color);
+                            
+                            // when assigning a material, search for its presence and, if not found,
+                            // place it in the first empty slot
+                            if (crossing.material != 0) {
+                                for (j = 0; j < MAX_MATERIALS_PER_VERTEX; j++) {
+                                    if (materials[j] == crossing.material) {
+                                        materialWeights[j] += 1.0f;
+                                        totalWeight += 1.0f;
+                                        break;
+                                        
+                                    } else if (materials[j] == 0) {
+                                        materials[j] = crossing.material;
+                                        materialWeights[j] = 1.0f;
+                                        totalWeight += 1.0f;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                        center /= validCrossings;
+                        
+                        // use a sequence of Givens rotations to perform a QR decomposition
+                        // see http://www.cs.rice.edu/~jwarren/papers/techreport02408.pdf
+                        glm::mat4 r(0.0f);
+                        glm::vec4 bottom;
+                        for (int i = 0; i < crossingCount; i++) {
+                            const EdgeCrossing& crossing = crossings[i];
+                            if (qAlpha(crossing.color) == 0) {
+                                continue;
+                            }
+                            bottom = glm::vec4(crossing.normal, glm::dot(crossing.normal, crossing.point - center));
+                            
+                            for (int j = 0; j < 4; j++) {
+                                float angle = glm::atan(-bottom[j], r[j][j]);
+                                float sina = glm::sin(angle);
+                                float cosa = glm::cos(angle);
+                                
+                                for (int k = 0; k < 4; k++) {
+                                    float tmp = bottom[k];
+                                    bottom[k] = sina * r[k][j] + cosa * tmp;
+                                    r[k][j] = cosa * r[k][j] - sina * tmp;
+                                }
+                            }
+                        }
+                        
+                        // extract the submatrices, form ata
+                        glm::mat3 a(r);
+                        glm::vec3 b(r[3]);
+                        glm::mat3 atrans = glm::transpose(a);
+                        glm::mat3 ata = atrans * a;
+                        
+                        // find the eigenvalues and eigenvectors of ata
+                        // (see http://en.wikipedia.org/wiki/Jacobi_eigenvalue_algorithm)
+                        glm::mat3 d = ata;
+                        glm::quat combinedRotation;
+                        const int MAX_ITERATIONS = 20;
+                        for (int i = 0; i < MAX_ITERATIONS; i++) {
+                            glm::vec3 offDiagonals = glm::abs(glm::vec3(d[1][0], d[2][0], d[2][1]));
+                            int largestIndex = (offDiagonals[0] > offDiagonals[1]) ?
+                                (offDiagonals[0] > offDiagonals[2] ? 0 : 2) : (offDiagonals[1] > offDiagonals[2] ? 1 : 2);
+                            const float DESIRED_PRECISION = 0.00001f;
+                            if (offDiagonals[largestIndex] < DESIRED_PRECISION) {
+                                break;
+                            }
+                            int largestJ = (largestIndex == 2) ? 1 : 0;
+                            int largestI = (largestIndex == 0) ? 1 : 2; 
+                            float sjj = d[largestJ][largestJ];
+                            float sii = d[largestI][largestI];
+                            float angle = glm::atan(2.0f * d[largestJ][largestI], sjj - sii) / 2.0f;
+                            glm::quat rotation = glm::angleAxis(angle, largestIndex == 0 ? glm::vec3(0.0f, 0.0f, -1.0f) :
+                                (largestIndex == 1 ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(-1.0f, 0.0f, 0.0f)));
+                            combinedRotation = glm::normalize(rotation * combinedRotation);
+                            glm::mat3 matrix = glm::mat3_cast(combinedRotation);
+                            d = matrix * ata * glm::transpose(matrix);
+                        }
+                        
+                        // form the singular matrix from the eigenvalues
+                        const float MIN_SINGULAR_THRESHOLD = 0.1f;
+                        d[0][0] = (d[0][0] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[0][0];
+                        d[1][1] = (d[1][1] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[1][1];
+                        d[2][2] = (d[2][2] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[2][2];
+                        
+                        // compute the pseudo-inverse, ataplus, and use to find the minimizing solution
+                        glm::mat3 u = glm::mat3_cast(combinedRotation);
+                        glm::mat3 ataplus = glm::transpose(u) * d * u; 
+                        glm::vec3 solution = (ataplus * atrans * b) + center;
+                        
+                        // make sure it doesn't fall beyond the cell boundaries
+                        center = glm::clamp(solution, 0.0f, 1.0f);
+                    
+                        if (totalWeight > 0.0f) {
+                            materialWeights *= (numeric_limits<quint8>::max() / totalWeight);
+                        }
+                        VoxelPoint point = { (glm::vec3(clampedX, y, clampedZ) + center) * step,
+                            { (quint8)(red / validCrossings), (quint8)(green / validCrossings),
+                                (quint8)(blue / validCrossings) },
+                            { (char)(normals[0].x * 127.0f), (char)(normals[0].y * 127.0f),
+                                (char)(normals[0].z * 127.0f) },
+                            { materials[0], materials[1], materials[2], materials[3] },
+                            { (quint8)materialWeights[0], (quint8)materialWeights[1], (quint8)materialWeights[2],
+                                (quint8)materialWeights[3] } };
+                        
+                        vertices.append(point);
+                        for (int i = 1; i < normalCount; i++) {
+                            index.indices[i] = vertices.size();
+                            point.setNormal(normals[i]);
+                            vertices.append(point);
+                        }
+                    }
+                    
+                    // the first x, y, and z are repeated for the boundary edge; past that, we consider generating
+                    // quads for each edge that includes a transition, using indices of previously generated vertices
+                    int reclampedX = qMin(clampedX, stackWidth - 1);
+                    int reclampedZ = qMin(clampedZ, stackHeight - 1);
+                    if (alpha0 != alpha1 && y > position && z > 0) {
+                        const NormalIndex& index1 = lastIndexY;
+                        const NormalIndex& index2 = lastIndicesZ[x].get(y - 1);
+                        const NormalIndex& index3 = lastIndicesZ[x].get(y);
+                        if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
+                            quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
+                            quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ), indices.size());
+                            if (reclampedZ > 0) {
+                                quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ - 1), indices.size());
+                                quadIndices.insert(qRgb(reclampedX, y, reclampedZ - 1), indices.size());
+                            }
+                            glm::vec3 normal = getNormal(vertices, index, index1, index2, index3);
+                            if (alpha0 == 0) { // quad faces negative x
+                                indices.append(index3.getClosestIndex(normal = -normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index1.getClosestIndex(normal, vertices));
+                            } else { // quad faces positive x
+                                indices.append(index1.getClosestIndex(normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index3.getClosestIndex(normal, vertices));
+                            }
+                            indices.append(index.getClosestIndex(normal, vertices));
+                        }
+                    }
+                    
+                    if (alpha0 != alpha2 && x > 0 && z > 0) {
+                        const NormalIndex& index1 = lastIndicesZ[x].get(y);
+                        const NormalIndex& index2 = lastIndicesZ[x - 1].get(y);
+                        const NormalIndex& index3 = lastIndicesX.get(y);
+                        if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
+                            quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
+                            if (reclampedX > 0) {
+                                quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ), indices.size());
+                                if (reclampedZ > 0) {
+                                    quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ - 1), indices.size());
+                                }
+                            }
+                            if (reclampedZ > 0) {
+                                quadIndices.insert(qRgb(reclampedX, y, reclampedZ - 1), indices.size());
+                            }
+                            glm::vec3 normal = getNormal(vertices, index, index3, index2, index1);
+                            if (alpha0 == 0) { // quad faces negative y
+                                indices.append(index3.getClosestIndex(normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index1.getClosestIndex(normal, vertices));
+                            } else { // quad faces positive y
+                                indices.append(index1.getClosestIndex(normal = -normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index3.getClosestIndex(normal, vertices));
+                            }
+                            indices.append(index.getClosestIndex(normal, vertices));
+                        }
+                    }
+                    
+                    if (alpha0 != alpha4 && x > 0 && y > position) {
+                        const NormalIndex& index1 = lastIndexY;
+                        const NormalIndex& index2 = lastIndicesX.get(y - 1);
+                        const NormalIndex& index3 = lastIndicesX.get(y);
+                        if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
+                            quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
+                            if (reclampedX > 0) {
+                                quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ), indices.size());
+                                quadIndices.insert(qRgb(reclampedX - 1, y - 1, reclampedZ), indices.size());
+                            }
+                            quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ), indices.size());
+                            
+                            glm::vec3 normal = getNormal(vertices, index, index1, index2, index3);
+                            if (alpha0 == 0) { // quad faces negative z
+                                indices.append(index1.getClosestIndex(normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index3.getClosestIndex(normal, vertices));
+                            } else { // quad faces positive z
+                                indices.append(index3.getClosestIndex(normal = -normal, vertices));
+                                indices.append(index2.getClosestIndex(normal, vertices));
+                                indices.append(index1.getClosestIndex(normal, vertices));
+                            }
+                            indices.append(index.getClosestIndex(normal, vertices));
+                        }
+                    }
+                    lastIndexY = index;
+                    indicesX[y - position] = index;
+                    indicesZ[x][y - position] = index;
+                }
+            } else {
+                indicesX.clear();
+                indicesZ[x].clear();
+            }
+            if (x != 0) {
+                lineSrc++;
+                heightLineSrc++;
+            }
+            indicesX.swap(lastIndicesX);
+        }
+        if (z != 0) {
+            src += stackWidth;
+            heightSrc += width;
+        }
+        indicesZ.swap(lastIndicesZ);
+        lastIndicesX.clear();
+    }
+    return BufferDataPointer(new VoxelBuffer(vertices, indices, hermiteSegments, quadIndices, stackWidth,
+        displayHermite, stackMaterials));
+}
+
+/// Builds the voxel buffer of a heightfield node on a worker thread.
+class VoxelBufferBuilder : public QRunnable {
+public:
+    
+    VoxelBufferBuilder(const HeightfieldNodePointer& node, const glm::vec3& scale, bool displayHermite,
+        const QSharedPointer<PendingVoxelBuffer>& pending);
+    
+    virtual void run();
+
+private:
+    
+    HeightfieldNodePointer _node;
+    glm::vec3 _scale;
+    bool _displayHermite;
+    QSharedPointer<PendingVoxelBuffer> _pending;
+};
+
+VoxelBufferBuilder::VoxelBufferBuilder(const HeightfieldNodePointer& node, const glm::vec3& scale, bool displayHermite,
+        const QSharedPointer<PendingVoxelBuffer>& pending) :
+    _node(node),
+    _scale(scale),
+    _displayHermite(displayHermite),
+    _pending(pending) {
+}
+
+void VoxelBufferBuilder::run() {
+    BufferDataPointer buffer = buildVoxelBuffer(_node, _scale, _displayHermite);
+    QMutexLocker locker(&_pending->mutex);
+    _pending->buffer = buffer;
+}
+
 void HeightfieldNodeRenderer::render(const HeightfieldNodePointer& node, const glm::vec3& translation,
         const glm::quat& rotation, const glm::vec3& scale, bool cursor) {
     if (!node->getHeight()) {
@@ -1711,650 +2442,23 @@ void HeightfieldNodeRenderer::render(const HeightfieldNodePointer& node, const g
         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     }
     bool displayHermite = Menu::getInstance()->isOptionChecked(MenuOption::DisplayHermiteData);
-    if ((!_voxels || (displayHermite && !static_cast<VoxelBuffer*>(_voxels.data())->isHermiteEnabled())) && node->getStack()) {
-        // see http://www.frankpetterson.com/publications/dualcontour/dualcontour.pdf for a description of the
-        // dual contour algorithm for generating meshes from voxel data using Hermite-tagged edges
-        
-        QVector<VoxelPoint> vertices;
-        QVector<int> indices;
-        QVector<glm::vec3> hermiteSegments;
-        QMultiHash<VoxelCoord, int> quadIndices;
-        
-        int stackWidth = node->getStack()->getWidth();
-        int stackHeight = node->getStack()->getContents().size() / stackWidth;
-        int innerStackWidth = stackWidth - HeightfieldData::SHARED_EDGE;
-        int innerStackHeight = stackHeight - HeightfieldData::SHARED_EDGE;
-        const StackArray* src = node->getStack()->getContents().constData();
-        const quint16* heightSrc = node->getHeight()->getContents().constData() +
-            (width + 1) * HeightfieldHeight::HEIGHT_BORDER;
-        QVector<SharedObjectPointer> stackMaterials = node->getStack()->getMaterials();
-        QHash<int, int> materialMap;
-        
-        int colorWidth;
-        const uchar* colorSrc = NULL;
-        float colorStepX, colorStepZ;
-        if (node->getColor()) {
-            colorWidth = node->getColor()->getWidth();
-            int colorHeight = node->getColor()->getContents().size() / (colorWidth * DataBlock::COLOR_BYTES);
-            colorSrc = (const uchar*)node->getColor()->getContents().constData();
-            colorStepX = (colorWidth - HeightfieldData::SHARED_EDGE) / (float)innerStackWidth;
-            colorStepZ = (colorHeight - HeightfieldData::SHARED_EDGE) / (float)innerStackHeight;
-        }
-        
-        int materialWidth;
-        const uchar* materialSrc = NULL;
-        float materialStepX, materialStepZ;
-        if (node->getMaterial()) {
-            materialWidth = node->getMaterial()->getWidth();
-            int materialHeight = node->getMaterial()->getContents().size() / materialWidth;
-            materialSrc = (const uchar*)node->getMaterial()->getContents().constData();
-            materialStepX = (materialWidth - HeightfieldData::SHARED_EDGE) / (float)innerStackWidth;
-            materialStepZ = (materialHeight - HeightfieldData::SHARED_EDGE) / (float)innerStackHeight;
+    if ((!_voxels || (displayHermite && !static_cast<VoxelBuffer*>(_voxels.data())->isHermiteEnabled())) &&
+            node->getStack() && !_pendingVoxels) {
+        // the mesh is built on a worker thread; until it's ready, we keep drawing what we had
+        _pendingVoxels = QSharedPointer<PendingVoxelBuffer>(new PendingVoxelBuffer());
+        QThreadPool::globalInstance()->start(new VoxelBufferBuilder(node, scale, displayHermite, _pendingVoxels));
+    }
+    if (_pendingVoxels) {
+        BufferDataPointer buffer;
+        {
+            QMutexLocker locker(&_pendingVoxels->mutex);
+            buffer = _pendingVoxels->buffer;
         }
-        
-        const int EDGES_PER_CUBE = 12;
-        EdgeCrossing crossings[EDGES_PER_CUBE * 2];
-        
-        // as we scan down the cube generating vertices between grid points, we remember the indices of the last
-        // (element, line, section--x, y, z) so that we can connect generated vertices as quads
-        IndexVector indicesX;
-        IndexVector lastIndicesX;
-        QVector<IndexVector> indicesZ(stackWidth + 1);
-        QVector<IndexVector> lastIndicesZ(stackWidth + 1);
-        float step = 1.0f / innerStackWidth;
-        float voxelScale = scale.y / (numeric_limits<quint16>::max() * scale.x * step);
-        
-        for (int z = 0; z <= stackHeight; z++) {
-            bool middleZ = (z != 0 && z != stackHeight);
-            const StackArray* lineSrc = src;
-            const quint16* heightLineSrc = heightSrc;
-            for (int x = 0; x <= stackWidth; x++) {
-                bool middleX = (x != 0 && x != stackWidth);
-                
-                // find the y extents of this and the neighboring columns
-                int minimumY = INT_MAX, maximumY = -1;
-                lineSrc->getExtents(minimumY, maximumY);
-                if (middleX) {
-                    lineSrc[1].getExtents(minimumY, maximumY);
-                    if (middleZ) {
-                        lineSrc[stackWidth + 1].getExtents(minimumY, maximumY);
-                    }
-                }
-                if (middleZ) {
-                    lineSrc[stackWidth].getExtents(minimumY, maximumY);
-                }
-                if (maximumY >= minimumY) {
-                    float heightfieldHeight = *heightLineSrc * voxelScale;
-                    float nextHeightfieldHeightX = heightLineSrc[1] * voxelScale;
-                    float nextHeightfieldHeightZ = heightLineSrc[width] * voxelScale;
-                    float nextHeightfieldHeightXZ = heightLineSrc[width + 1] * voxelScale;
-                    const int UPPER_LEFT_CORNER = 1;
-                    const int UPPER_RIGHT_CORNER = 2;
-                    const int LOWER_LEFT_CORNER = 4;
-                    const int LOWER_RIGHT_CORNER = 8;
-                    const int NO_CORNERS = 0;
-                    const int ALL_CORNERS = UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER | LOWER_LEFT_CORNER | LOWER_RIGHT_CORNER;
-                    const int NEXT_CORNERS[] = { 1, 3, 0, 2 };
-                    int corners = NO_CORNERS;
-                    if (heightfieldHeight != 0.0f) {
-                        corners |= UPPER_LEFT_CORNER;
-                    }
-                    if (nextHeightfieldHeightX != 0.0f && x != stackWidth) {
-                        corners |= UPPER_RIGHT_CORNER;
-                    }
-                    if (nextHeightfieldHeightZ != 0.0f && z != stackHeight) {
-                        corners |= LOWER_LEFT_CORNER;
-                    }
-                    if (nextHeightfieldHeightXZ != 0.0f && x != stackWidth && z != stackHeight) {
-                        corners |= LOWER_RIGHT_CORNER;
-                    }
-                    bool stitchable = x != 0 && z != 0 && !(corners == NO_CORNERS || corners == ALL_CORNERS);
-                    EdgeCrossing cornerCrossings[CORNER_COUNT];
-                    int clampedX = qMax(x - 1, 0), clampedZ = qMax(z - 1, 0);
-                    int cornerMinimumY = INT_MAX, cornerMaximumY = -1;
-                    if (stitchable) {
-                        for (int i = 0; i < CORNER_COUNT; i++) {
-                            if (!(corners & (1 << i))) {
-                                continue;
-                            }
-                            int offsetX = (i & X_MAXIMUM_FLAG) ? 1 : 0;
-                            int offsetZ = (i & Y_MAXIMUM_FLAG) ? 1 : 0;
-                            const quint16* height = heightLineSrc + offsetZ * width + offsetX;
-                            float heightValue = *height * voxelScale;
-                            int y = (int)heightValue;
-                            cornerMinimumY = qMin(cornerMinimumY, y);
-                            cornerMaximumY = qMax(cornerMaximumY, y);
-                            EdgeCrossing& crossing = cornerCrossings[i];
-                            crossing.point = glm::vec3(offsetX, heightValue, offsetZ);
-                            int left = height[-1];
-                            int right = height[1];
-                            int down = height[-width];
-                            int up = height[width];
-                            crossing.normal = glm::normalize(glm::vec3((left == 0 || right == 0) ? 0.0f : left - right,
-                                2.0f / voxelScale, (up == 0 || down == 0) ? 0.0f : down - up));
-                            int clampedOffsetX = clampedX + offsetX, clampedOffsetZ = clampedZ + offsetZ;
-                            if (colorSrc) {
-                                const uchar* color = colorSrc + ((int)(clampedOffsetZ * colorStepZ) * colorWidth +
-                                    (int)(clampedOffsetX * colorStepX)) * DataBlock::COLOR_BYTES;
-                                crossing.color = qRgb(color[0], color[1], color[2]);
-                             
-                            } else {
-                                crossing.color = qRgb(numeric_limits<quint8>::max(), numeric_limits<quint8>::max(),
-                                    numeric_limits<quint8>::max());
-                            }
-                            int material = 0;
-                            if (materialSrc) {
-                                material = materialSrc[(int)(clampedOffsetZ * materialStepZ) * materialWidth +
-                                    (int)(clampedOffsetX * materialStepX)];
-                                if (material != 0) {
-                                    int& mapping = materialMap[material];
-                                    if (mapping == 0) {
-                                        mapping = getMaterialIndex(node->getMaterial()->getMaterials().at(material - 1),
-                                            stackMaterials);
-                                    }
-                                    material = mapping;
-                                }
-                            }
-                            crossing.material = material;
-                        }
-                        minimumY = qMin(minimumY, cornerMinimumY);
-                        maximumY = qMax(maximumY, cornerMaximumY);
-                        
-                        if (corners == (LOWER_LEFT_CORNER | UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER)) {
-                            appendTriangle(cornerCrossings[1], cornerCrossings[0], cornerCrossings[2],
-                                clampedX, clampedZ, step, vertices, indices, quadIndices);
-                        
-                        } else if (corners == (UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER)) {
-                            appendTriangle(cornerCrossings[2], cornerCrossings[3], cornerCrossings[1],
-                                clampedX, clampedZ, step, vertices, indices, quadIndices);
-                        }
-                    }
-                    int position = minimumY;
-                    int count = maximumY - minimumY + 1;
-                    NormalIndex lastIndexY = { { -1, -1, -1, -1 } };
-                    indicesX.position = position;
-                    indicesX.resize(count);
-                    indicesZ[x].position = position;
-                    indicesZ[x].resize(count);
-                    for (int y = position, end = position + count; y < end; y++) {
-                        StackArray::Entry entry = getEntry(lineSrc, stackWidth, y, heightfieldHeight, cornerCrossings, 0);
-                        if (displayHermite && x != 0 && z != 0 && !lineSrc->isEmpty() && y >= lineSrc->getPosition()) {
-                            glm::vec3 normal;
-                            if (entry.hermiteX != 0) {
-                                glm::vec3 start = glm::vec3(clampedX + entry.getHermiteX(normal), y, clampedZ) * step;
-                                hermiteSegments.append(start);
-                                hermiteSegments.append(start + normal * step);
-                            }
-                            if (entry.hermiteY != 0) {
-                                glm::vec3 start = glm::vec3(clampedX, y + entry.getHermiteY(normal), clampedZ) * step;
-                                hermiteSegments.append(start);
-                                hermiteSegments.append(start + normal * step);
-                            }
-                            if (entry.hermiteZ != 0) {
-                                glm::vec3 start = glm::vec3(clampedX, y, clampedZ + entry.getHermiteZ(normal)) * step;
-                                hermiteSegments.append(start);
-                                hermiteSegments.append(start + normal * step);
-                            }
-                        }
-                        // number variables correspond to cube corners, where the x, y, and z components are represented as
-                        // bits in the 0, 1, and 2 position, respectively; hence, alpha0 is the value at the minimum x, y, and
-                        // z corner and alpha7 is the value at the maximum x, y, and z
-                        int alpha0 = lineSrc->getEntryAlpha(y, heightfieldHeight);
-                        int alpha2 = lineSrc->getEntryAlpha(y + 1, heightfieldHeight);
-                        int alpha1 = alpha0, alpha3 = alpha2, alpha4 = alpha0, alpha6 = alpha2;
-                        int alphaTotal = alpha0 + alpha2;
-                        int possibleTotal = 2 * numeric_limits<uchar>::max();
-                        
-                        // cubes on the edge are two-dimensional: this ensures that their vertices will be shared between
-                        // neighboring blocks, which share only one layer of points
-                        if (middleZ) {
-                            alphaTotal += (alpha4 = lineSrc[stackWidth].getEntryAlpha(y, nextHeightfieldHeightZ));
-                            possibleTotal += numeric_limits<uchar>::max();
-                            
-                            alphaTotal += (alpha6 = lineSrc[stackWidth].getEntryAlpha(y + 1, nextHeightfieldHeightZ));
-                            possibleTotal += numeric_limits<uchar>::max();
-                        }
-                        int alpha5 = alpha4, alpha7 = alpha6;
-                        if (middleX) {
-                            alphaTotal += (alpha1 = lineSrc[1].getEntryAlpha(y, nextHeightfieldHeightX));
-                            possibleTotal += numeric_limits<uchar>::max();
-                            
-                            alphaTotal += (alpha3 = lineSrc[1].getEntryAlpha(y + 1, nextHeightfieldHeightX));
-                            possibleTotal += numeric_limits<uchar>::max();
-                                
-                            if (middleZ) {
-                                alphaTotal += (alpha5 = lineSrc[stackWidth + 1].getEntryAlpha(y, nextHeightfieldHeightXZ));
-                                possibleTotal += numeric_limits<uchar>::max();
-                                
-                                alphaTotal += (alpha7 = lineSrc[stackWidth + 1].getEntryAlpha(y + 1, nextHeightfieldHeightXZ));
-                                possibleTotal += numeric_limits<uchar>::max();
-                            }
-                        }
-                        if (alphaTotal == 0 || alphaTotal == possibleTotal) {
-                            continue; // no corners set/all corners set
-                        }
-                        // we first look for crossings with the heightfield corner vertices; these take priority
-                        int crossingCount = 0;
-                        if (y >= cornerMinimumY && y <= cornerMaximumY) {
-                            // first look for set corners, which override any interpolated values
-                            int crossedCorners = NO_CORNERS;
-                            for (int i = 0; i < CORNER_COUNT; i++) {
-                                if (!(corners & (1 << i))) {
-                                    continue;
-                                }
-                                const EdgeCrossing& cornerCrossing = cornerCrossings[i];
-                                if (cornerCrossing.point.y >= y && cornerCrossing.point.y < y + 1) {
-                                    crossedCorners |= (1 << i);
-                                }
-                            }
-                            switch (crossedCorners) {
-                                case UPPER_LEFT_CORNER:
-                                case LOWER_LEFT_CORNER | UPPER_LEFT_CORNER:
-                                case LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER | UPPER_LEFT_CORNER:
-                                case UPPER_LEFT_CORNER | LOWER_RIGHT_CORNER:
-                                    crossings[crossingCount++] = cornerCrossings[0];
-                                    crossings[crossingCount - 1].point.y -= y;
-                                    break;
-                                
-                                case UPPER_RIGHT_CORNER:
-                                case UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER:
-                                case UPPER_RIGHT_CORNER | LOWER_LEFT_CORNER:
-                                case LOWER_LEFT_CORNER | UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER:
-                                    crossings[crossingCount++] = cornerCrossings[1];
-                                    crossings[crossingCount - 1].point.y -= y;
-                                    break;
-                                
-                                case LOWER_LEFT_CORNER:
-                                case LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER:
-                                case UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER | LOWER_LEFT_CORNER:
-                                    crossings[crossingCount++] = cornerCrossings[2];
-                                    crossings[crossingCount - 1].point.y -= y;
-                                    break;
-                                
-                                case LOWER_RIGHT_CORNER:
-                                case UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER:
-                                case UPPER_LEFT_CORNER | UPPER_RIGHT_CORNER | LOWER_RIGHT_CORNER:
-                                    crossings[crossingCount++] = cornerCrossings[3];
-                                    crossings[crossingCount - 1].point.y -= y;
-                                    break;
-                                
-                                case NO_CORNERS:
-                                    for (int i = 0; i < CORNER_COUNT; i++) {
-                                        if (!(corners & (1 << i))) {
-                                            continue;
-                                        }
-                                        int nextIndex = NEXT_CORNERS[i];
-                                        if (!(corners & (1 << nextIndex))) {
-                                            continue;
-                                        }
-                                        const EdgeCrossing& cornerCrossing = cornerCrossings[i];
-                                        const EdgeCrossing& nextCornerCrossing = cornerCrossings[nextIndex];
-                                        float divisor = (nextCornerCrossing.point.y - cornerCrossing.point.y);
-                                        if (divisor == 0.0f) {
-                                            continue;
-                                        }
-                                        float t1 = (y - cornerCrossing.point.y) / divisor;
-                                        float t2 = (y + 1 - cornerCrossing.point.y) / divisor;
-                                        if (t1 >= 0.0f && t1 <= 1.0f) {
-                                            crossings[crossingCount++].mix(cornerCrossing, nextCornerCrossing, t1);
-                                            crossings[crossingCount - 1].point.y -= y;
-                                        }
-                                        if (t2 >= 0.0f && t2 <= 1.0f) {
-                                            crossings[crossingCount++].mix(cornerCrossing, nextCornerCrossing, t2);
-                                            crossings[crossingCount - 1].point.y -= y;
-                                        }
-                                    }
-                                    break;
-                            }
-                        }
-                        
-                        // the terrifying conditional code that follows checks each cube edge for a crossing, gathering
-                        // its properties (color, material, normal) if one is present; as before, boundary edges are excluded
-                        if (crossingCount == 0) {
-                            StackArray::Entry nextEntryY = getEntry(lineSrc, stackWidth, y + 1,
-                                heightfieldHeight, cornerCrossings, 0);
-                            if (middleX) {
-                                StackArray::Entry nextEntryX = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightX,
-                                    cornerCrossings, 1);
-                                StackArray::Entry nextEntryXY = getEntry(lineSrc, stackWidth, y + 1, nextHeightfieldHeightX,
-                                    cornerCrossings, 1);   
-                                if (alpha0 != alpha1) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(entry.getHermiteX(crossing.normal), 0.0f, 0.0f);
-                                    crossing.setColorMaterial(alpha0 == 0 ? nextEntryX : entry);
-                                }
-                                if (alpha1 != alpha3) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(1.0f, nextEntryX.getHermiteY(crossing.normal), 0.0f);
-                                    crossing.setColorMaterial(alpha1 == 0 ? nextEntryXY : nextEntryX);
-                                }
-                                if (alpha2 != alpha3) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(nextEntryY.getHermiteX(crossing.normal), 1.0f, 0.0f);
-                                    crossing.setColorMaterial(alpha2 == 0 ? nextEntryXY : nextEntryY);
-                                }
-                                if (middleZ) {
-                                    StackArray::Entry nextEntryZ = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightZ,
-                                        cornerCrossings, 2);
-                                    StackArray::Entry nextEntryXZ = getEntry(lineSrc, stackWidth, y, nextHeightfieldHeightXZ,
-                                        cornerCrossings, 3);
-                                    StackArray::Entry nextEntryXYZ = getEntry(lineSrc, stackWidth, y + 1,
-                                        nextHeightfieldHeightXZ, cornerCrossings, 3);
-                                    if (alpha1 != alpha5) {
-                                        EdgeCrossing& crossing = crossings[crossingCount++];
-                                        crossing.point = glm::vec3(1.0f, 0.0f, nextEntryX.getHermiteZ(crossing.normal));
-                                        crossing.setColorMaterial(alpha1 == 0 ? nextEntryXZ : nextEntryX);
-                                    }
-                                    if (alpha3 != alpha7) {
-                                        EdgeCrossing& crossing = crossings[crossingCount++];
-                                        StackArray::Entry nextEntryXY = getEntry(lineSrc, stackWidth, y + 1,
-                                            nextHeightfieldHeightX, cornerCrossings, 1);
-                                        crossing.point = glm::vec3(1.0f, 1.0f, nextEntryXY.getHermiteZ(crossing.normal));
-                                        crossing.setColorMaterial(alpha3 == 0 ? nextEntryXYZ : nextEntryXY);
-                                    }
-                                    if (alpha4 != alpha5) {
-                                        EdgeCrossing& crossing = crossings[crossingCount++];
-                                        crossing.point = glm::vec3(nextEntryZ.getHermiteX(crossing.normal), 0.0f, 1.0f);
-                                        crossing.setColorMaterial(alpha4 == 0 ? nextEntryXZ : nextEntryZ);
-                                    }
-                                    if (alpha5 != alpha7) {
-                                        EdgeCrossing& crossing = crossings[crossingCount++];
-                                        StackArray::Entry nextEntryXZ = getEntry(lineSrc, stackWidth, y,
-                                            nextHeightfieldHeightXZ, cornerCrossings, 3);
-                                        crossing.point = glm::vec3(1.0f, nextEntryXZ.getHermiteY(crossing.normal), 1.0f);
-                                        crossing.setColorMaterial(alpha5 == 0 ? nextEntryXYZ : nextEntryXZ);
-                                    }
-                                    if (alpha6 != alpha7) {
-                                        EdgeCrossing& crossing = crossings[crossingCount++];
-                                        StackArray::Entry nextEntryYZ = getEntry(lineSrc, stackWidth, y + 1,
-                                            nextHeightfieldHeightZ, cornerCrossings, 2);
-                                        crossing.point = glm::vec3(nextEntryYZ.getHermiteX(crossing.normal), 1.0f, 1.0f);
-                                        crossing.setColorMaterial(alpha6 == 0 ? nextEntryXYZ : nextEntryYZ);
-                                    }
-                                }
-                            }
-                            if (alpha0 != alpha2) {
-                                EdgeCrossing& crossing = crossings[crossingCount++];
-                                crossing.point = glm::vec3(0.0f, entry.getHermiteY(crossing.normal), 0.0f);
-                                crossing.setColorMaterial(alpha0 == 0 ? nextEntryY : entry);
-                            }
-                            if (middleZ) {
-                                StackArray::Entry nextEntryZ = getEntry(lineSrc, stackWidth, y,
-                                    nextHeightfieldHeightZ, cornerCrossings, 2);
-                                StackArray::Entry nextEntryYZ = getEntry(lineSrc, stackWidth, y + 1,
-                                    nextHeightfieldHeightZ, cornerCrossings, 2);
-                                if (alpha0 != alpha4) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(0.0f, 0.0f, entry.getHermiteZ(crossing.normal));
-                                    crossing.setColorMaterial(alpha0 == 0 ? nextEntryZ : entry);
-                                }
-                                if (alpha2 != alpha6) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(0.0f, 1.0f, nextEntryY.getHermiteZ(crossing.normal));
-                                    crossing.setColorMaterial(alpha2 == 0 ? nextEntryYZ : nextEntryY);
-                                }
-                                if (alpha4 != alpha6) {
-                                    EdgeCrossing& crossing = crossings[crossingCount++];
-                                    crossing.point = glm::vec3(0.0f, nextEntryZ.getHermiteY(crossing.normal), 1.0f);
-                                    crossing.setColorMaterial(alpha4 == 0 ? nextEntryYZ : nextEntryZ);
-                                }
-                            }
-                        }
-                        // make sure we have valid crossings to include
-                        int validCrossings = 0;
-                        for (int i = 0; i < crossingCount; i++) {
-                            if (qAlpha(crossings[i].color) != 0) {
-                                validCrossings++;
-                            }
-                        }
-                        NormalIndex index = { { -1, -1, -1, -1 } };
-                        if (validCrossings != 0) {
-                            index.indices[0] = index.indices[1] = index.indices[2] = index.indices[3] = vertices.size();
-                            glm::vec3 center;
-                            glm::vec3 normals[MAX_NORMALS_PER_VERTEX];
-                            int normalCount = 0;
-                            const float CREASE_COS_NORMAL = glm::cos(glm::radians(45.0f));
-                            const int MAX_MATERIALS_PER_VERTEX = 4;
-                            quint8 materials[] = { 0, 0, 0, 0 };
-                            glm::vec4 materialWeights;
-                            float totalWeight = 0.0f;
-                            int red = 0, green = 0, blue = 0;
-                            for (int i = 0; i < crossingCount; i++) {
-                                const EdgeCrossing& crossing = crossings[i];
-                                if (qAlpha(crossing.color) == 0) {
-                                    continue;
-                                }
-                                center += crossing.point;
-                                
-                                int j = 0;
-                                for (; j < normalCount; j++) {
-                                    if (glm::dot(normals[j], crossing.normal) > CREASE_COS_NORMAL) {
-                                        normals[j] = safeNormalize(normals[j] + crossing.normal);
-                                        break;
-                                    }
-                                }
-                                if (j == normalCount) {
-                                    normals[normalCount++] = crossing.normal;
-                                }
-                                
-                                red += qRed(crossing.color);
-                                green += qGreen(crossing.color);
-                                blue += qBlue(crossing.color);
-                                
-                                // when assigning a material, search for its presence and, if not found,
-                                // place it in the first empty slot
-                                if (crossing.material != 0) {
-                                    for (j = 0; j < MAX_MATERIALS_PER_VERTEX; j++) {
-                                        if (materials[j] == crossing.material) {
-                                            materialWeights[j] += 1.0f;
-                                            totalWeight += 1.0f;
-                                            break;
-                                            
-                                        } else if (materials[j] == 0) {
-                                            materials[j] = crossing.material;
-                                            materialWeights[j] = 1.0f;
-                                            totalWeight += 1.0f;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
-                            center /= validCrossings;
-                            
-                            // use a sequence of Givens rotations to perform a QR decomposition
-                            // see http://www.cs.rice.edu/~jwarren/papers/techreport02408.pdf
-                            glm::mat4 r(0.0f);
-                            glm::vec4 bottom;
-                            for (int i = 0; i < crossingCount; i++) {
-                                const EdgeCrossing& crossing = crossings[i];
-                                if (qAlpha(crossing.color) == 0) {
-                                    continue;
-                                }
-                                bottom = glm::vec4(crossing.normal, glm::dot(crossing.normal, crossing.point - center));
-                                
-                                for (int j = 0; j < 4; j++) {
-                                    float angle = glm::atan(-bottom[j], r[j][j]);
-                                    float sina = glm::sin(angle);
-                                    float cosa = glm::cos(angle);
-                                    
-                                    for (int k = 0; k < 4; k++) {
-                                        float tmp = bottom[k];
-                                        bottom[k] = sina * r[k][j] + cosa * tmp;
-                                        r[k][j] = cosa * r[k][j] - sina * tmp;
-                                    }
-                                }
-                            }
-                            
-                            // extract the submatrices, form ata
-                            glm::mat3 a(r);
-                            glm::vec3 b(r[3]);
-                            glm::mat3 atrans = glm::transpose(a);
-                            glm::mat3 ata = atrans * a;
-                            
-                            // find the eigenvalues and eigenvectors of ata
-                            // (see http://en.wikipedia.org/wiki/Jacobi_eigenvalue_algorithm)
-                            glm::mat3 d = ata;
-                            glm::quat combinedRotation;
-                            const int MAX_ITERATIONS = 20;
-                            for (int i = 0; i < MAX_ITERATIONS; i++) {
-                                glm::vec3 offDiagonals = glm::abs(glm::vec3(d[1][0], d[2][0], d[2][1]));
-                                int largestIndex = (offDiagonals[0] > offDiagonals[1]) ?
-                                    (offDiagonals[0] > offDiagonals[2] ? 0 : 2) : (offDiagonals[1] > offDiagonals[2] ? 1 : 2);
-                                const float DESIRED_PRECISION = 0.00001f;
-                                if (offDiagonals[largestIndex] < DESIRED_PRECISION) {
-                                    break;
-                                }
-                                int largestJ = (largestIndex == 2) ? 1 : 0;
-                                int largestI = (largestIndex == 0) ? 1 : 2; 
-                                float sjj = d[largestJ][largestJ];
-                                float sii = d[largestI][largestI];
-                                float angle = glm::atan(2.0f * d[largestJ][largestI], sjj - sii) / 2.0f;
-                                glm::quat rotation = glm::angleAxis(angle, largestIndex == 0 ? glm::vec3(0.0f, 0.0f, -1.0f) :
-                                    (largestIndex == 1 ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(-1.0f, 0.0f, 0.0f)));
-                                combinedRotation = glm::normalize(rotation * combinedRotation);
-                                glm::mat3 matrix = glm::mat3_cast(combinedRotation);
-                                d = matrix * ata * glm::transpose(matrix);
-                            }
-                            
-                            // form the singular matrix from the eigenvalues
-                            const float MIN_SINGULAR_THRESHOLD = 0.1f;
-                            d[0][0] = (d[0][0] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[0][0];
-                            d[1][1] = (d[1][1] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[1][1];
-                            d[2][2] = (d[2][2] < MIN_SINGULAR_THRESHOLD) ? 0.0f : 1.0f / d[2][2];
-                            
-                            // compute the pseudo-inverse, ataplus, and use to find the minimizing solution
-                            glm::mat3 u = glm::mat3_cast(combinedRotation);
-                            glm::mat3 ataplus = glm::transpose(u) * d * u; 
-                            glm::vec3 solution = (ataplus * atrans * b) + center;
-                            
-                            // make sure it doesn't fall beyond the cell boundaries
-                            center = glm::clamp(solution, 0.0f, 1.0f);
-                        
-                            if (totalWeight > 0.0f) {
-                                materialWeights *= (numeric_limits<quint8>::max() / totalWeight);
-                            }
-                            VoxelPoint point = { (glm::vec3(clampedX, y, clampedZ) + center) * step,
-                                { (quint8)(red / validCrossings), (quint8)(green / validCrossings),
-                                    (quint8)(blue / validCrossings) },
-                                { (char)(normals[0].x * 127.0f), (char)(normals[0].y * 127.0f),
-                                    (char)(normals[0].z * 127.0f) },
-                                { materials[0], materials[1], materials[2], materials[3] },
-                                { (quint8)materialWeights[0], (quint8)materialWeights[1], (quint8)materialWeights[2],
-                                    (quint8)materialWeights[3] } };
-                            
-                            vertices.append(point);
-                            for (int i = 1; i < normalCount; i++) {
-                                index.indices[i] = vertices.size();
-                                point.setNormal(normals[i]);
-                                vertices.append(point);
-                            }
-                        }
-                        
-                        // the first x, y, and z are repeated for the boundary edge; past that, we consider generating
-                        // quads for each edge that includes a transition, using indices of previously generated vertices
-                        int reclampedX = qMin(clampedX, stackWidth - 1);
-                        int reclampedZ = qMin(clampedZ, stackHeight - 1);
-                        if (alpha0 != alpha1 && y > position && z > 0) {
-                            const NormalIndex& index1 = lastIndexY;
-                            const NormalIndex& index2 = lastIndicesZ[x].get(y - 1);
-                            const NormalIndex& index3 = lastIndicesZ[x].get(y);
-                            if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
-                                quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
-                                quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ), indices.size());
-                                if (reclampedZ > 0) {
-                                    quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ - 1), indices.size());
-                                    quadIndices.insert(qRgb(reclampedX, y, reclampedZ - 1), indices.size());
-                                }
-                                glm::vec3 normal = getNormal(vertices, index, index1, index2, index3);
-                                if (alpha0 == 0) { // quad faces negative x
-                                    indices.append(index3.getClosestIndex(normal = -normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index1.getClosestIndex(normal, vertices));
-                                } else { // quad faces positive x
-                                    indices.append(index1.getClosestIndex(normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index3.getClosestIndex(normal, vertices));
-                                }
-                                indices.append(index.getClosestIndex(normal, vertices));
-                            }
-                        }
-                        
-                        if (alpha0 != alpha2 && x > 0 && z > 0) {
-                            const NormalIndex& index1 = lastIndicesZ[x].get(y);
-                            const NormalIndex& index2 = lastIndicesZ[x - 1].get(y);
-                            const NormalIndex& index3 = lastIndicesX.get(y);
-                            if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
-                                quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
-                                if (reclampedX > 0) {
-                                    quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ), indices.size());
-                                    if (reclampedZ > 0) {
-                                        quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ - 1), indices.size());
-                                    }
-                                }
-                                if (reclampedZ > 0) {
-                                    quadIndices.insert(qRgb(reclampedX, y, reclampedZ - 1), indices.size());
-                                }
-                                glm::vec3 normal = getNormal(vertices, index, index3, index2, index1);
-                                if (alpha0 == 0) { // quad faces negative y
-                                    indices.append(index3.getClosestIndex(normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index1.getClosestIndex(normal, vertices));
-                                } else { // quad faces positive y
-                                    indices.append(index1.getClosestIndex(normal = -normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index3.getClosestIndex(normal, vertices));
-                                }
-                                indices.append(index.getClosestIndex(normal, vertices));
-                            }
-                        }
-                        
-                        if (alpha0 != alpha4 && x > 0 && y > position) {
-                            const NormalIndex& index1 = lastIndexY;
-                            const NormalIndex& index2 = lastIndicesX.get(y - 1);
-                            const NormalIndex& index3 = lastIndicesX.get(y);
-                            if (index.isValid() && index1.isValid() && index2.isValid() && index3.isValid()) {
-                                quadIndices.insert(qRgb(reclampedX, y, reclampedZ), indices.size());
-                                if (reclampedX > 0) {
-                                    quadIndices.insert(qRgb(reclampedX - 1, y, reclampedZ), indices.size());
-                                    quadIndices.insert(qRgb(reclampedX - 1, y - 1, reclampedZ), indices.size());
-                                }
-                                quadIndices.insert(qRgb(reclampedX, y - 1, reclampedZ), indices.size());
-                                
-                                glm::vec3 normal = getNormal(vertices, index, index1, index2, index3);
-                                if (alpha0 == 0) { // quad faces negative z
-                                    indices.append(index1.getClosestIndex(normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index3.getClosestIndex(normal, vertices));
-                                } else { // quad faces positive z
-                                    indices.append(index3.getClosestIndex(normal = -normal, vertices));
-                                    indices.append(index2.getClosestIndex(normal, vertices));
-                                    indices.append(index1.getClosestIndex(normal, vertices));
-                                }
-                                indices.append(index.getClosestIndex(normal, vertices));
-                            }
-                        }
-                        lastIndexY = index;
-                        indicesX[y - position] = index;
-                        indicesZ[x][y - position] = index;
-                    }
-                } else {
-                    indicesX.clear();
-                    indicesZ[x].clear();
-                }
-                if (x != 0) {
-                    lineSrc++;
-                    heightLineSrc++;
-                }
-                indicesX.swap(lastIndicesX);
-            }
-            if (z != 0) {
-                src += stackWidth;
-                heightSrc += width;
-            }
-            indicesZ.swap(lastIndicesZ);
-            lastIndicesX.clear();
+        if (buffer && Application::getInstance()->getMetavoxels()->spendUploadBudget(
+                static_cast<VoxelBuffer*>(buffer.data())->getUploadSize())) {
+            _voxels = buffer;
+            _pendingVoxels.clear();
         }
-        _voxels = new VoxelBuffer(vertices, indices, hermiteSegments, quadIndices, stackWidth, stackMaterials);
     }
     
     if (_voxels) {
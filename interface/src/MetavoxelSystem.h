@@ -13,8 +13,10 @@
 #define hifi_MetavoxelSystem_h
 
 #include <QList>
+#include <QMutex>
 #include <QOpenGLBuffer>
 #include <QReadWriteLock>
+#include <QSharedPointer>
 #include <QVector>
 
 #include <glm/glm.hpp>
@@ -81,6 +83,10 @@ public:
     
     void addHermiteBatch(const HermiteBatch& batch) { _hermiteBatches.append(batch); }
 
+    /// Claims part of the frame's budget for uploading newly built buffers.
+    /// \return false if the budget has been spent, in which case the upload should wait for a later frame
+    bool spendUploadBudget(int bytes);
+
     Q_INVOKABLE void deleteTextures(int heightTextureID, int colorTextureID, int materialTextureID) const;
     Q_INVOKABLE void deleteBuffers(int vertexBufferID, int indexBufferID, int hermiteBufferID) const;
     
@@ -111,6 +117,8 @@ private:
     QVector<VoxelSplatBatch> _voxelSplatBatches;
     QVector<HermiteBatch> _hermiteBatches;
     
+    int _uploadBudget;
+    
     ProgramObject _baseHeightfieldProgram;
     int _baseHeightScaleLocation;
     int _baseColorScaleLocation;
@@ -315,12 +323,15 @@ class VoxelBuffer : public BufferData {
 public:
     
     VoxelBuffer(const QVector<VoxelPoint>& vertices, const QVector<int>& indices, const QVector<glm::vec3>& hermite,
-        const QMultiHash<VoxelCoord, int>& quadIndices, int size, const QVector<SharedObjectPointer>& materials =
-            QVector<SharedObjectPointer>());
+        const QMultiHash<VoxelCoord, int>& quadIndices, int size, bool hermiteEnabled,
+            const QVector<SharedObjectPointer>& materials = QVector<SharedObjectPointer>());
     virtual ~VoxelBuffer();
 
     bool isHermiteEnabled() const { return _hermiteEnabled; }
 
+    /// Returns the number of bytes that the first render will upload.
+    int getUploadSize() const;
+
     /// Finds the first intersection between the described ray and the voxel data.
     bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float boundsDistance, float& distance) const;
         
@@ -415,6 +426,13 @@ public:
     virtual void render(const MetavoxelLOD& lod = MetavoxelLOD(), bool contained = false, bool cursor = false);
 };
 
+/// A voxel buffer being built on a worker thread, which sets the buffer when done.
+class PendingVoxelBuffer {
+public:
+    QMutex mutex;
+    BufferDataPointer buffer;
+};
+
 /// Renders a single quadtree node.
 class HeightfieldNodeRenderer : public AbstractHeightfieldNodeRenderer {
 public:
@@ -436,6 +454,7 @@ private:
     QVector<NetworkTexturePointer> _networkTextures;
     
     BufferDataPointer _voxels;
+    QSharedPointer<PendingVoxelBuffer> _pendingVoxels;
     
     typedef QPair<int, int> IntPair;    
     typedef QPair<QOpenGLBuffer, QOpenGLBuffer> BufferPair;
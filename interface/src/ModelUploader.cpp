@@ -12,6 +12,7 @@
 #include <QBuffer>
 #include <QCheckBox>
 #include <QComboBox>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDialogButtonBox>
 #include <QDoubleSpinBox>
@@ -46,6 +47,7 @@
 static const QString NAME_FIELD = "name";
 static const QString FILENAME_FIELD = "filename";
 static const QString TEXDIR_FIELD = "texdir";
+static const QString TEXHASH_FIELD = "texhash";
 static const QString LOD_FIELD = "lod";
 static const QString JOINT_INDEX_FIELD = "jointIndex";
 static const QString SCALE_FIELD = "scale";
@@ -239,6 +241,14 @@ bool ModelUploader::zip() {
         }
     }
     
+    // Textures before the fst, which lists their hashes
+    if (!addTextures(texDir, geometry)) {
+        return false;
+    }
+    if (!_textureHashes.isEmpty()) {
+        mapping.insert(TEXHASH_FIELD, _textureHashes);
+    }
+    
     // Write out, compress and copy the fst
     if (!addPart(*fst, writeMapping(mapping), QString("fst"))) {
         return false;
@@ -248,10 +258,6 @@ bool ModelUploader::zip() {
     if (!addPart(fbx, fbxContents, "fbx")) {
         return false;
     }
-                
-    if (!addTextures(texDir, geometry)) {
-        return false;
-    }
     
     QHttpPart textPart;
     textPart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data;"
@@ -536,37 +542,9 @@ void ModelUploader::processCheck() {
 bool ModelUploader::addTextures(const QString& texdir, const FBXGeometry& geometry) {
     foreach (FBXMesh mesh, geometry.meshes) {
         foreach (FBXMeshPart part, mesh.parts) {
-            if (!part.diffuseTexture.filename.isEmpty() && part.diffuseTexture.content.isEmpty() &&
-                    !_textureFilenames.contains(part.diffuseTexture.filename)) {
-                if (!addPart(texdir + "/" + part.diffuseTexture.filename,
-                             QString("texture%1").arg(++_texturesCount), true)) {
-                    return false;
-                }
-                _textureFilenames.insert(part.diffuseTexture.filename);
-            }
-            if (!part.normalTexture.filename.isEmpty() && part.normalTexture.content.isEmpty() &&
-                    !_textureFilenames.contains(part.normalTexture.filename)) {
-                if (!addPart(texdir + "/" + part.normalTexture.filename,
-                             QString("texture%1").arg(++_texturesCount), true)) {
-                    return false;
-                }
-                _textureFilenames.insert(part.normalTexture.filename);
-            }
-            if (!part.specularTexture.filename.isEmpty() && part.specularTexture.content.isEmpty() &&
-                    !_textureFilenames.contains(part.specularTexture.filename)) {
-                if (!addPart(texdir + "/" + part.specularTexture.filename,
-                             QString("texture%1").arg(++_texturesCount), true)) {
-                    return false;
-                }
-                _textureFilenames.insert(part.specularTexture.filename);
-            }
-            if (!part.emissiveTexture.filename.isEmpty() && part.emissiveTexture.content.isEmpty() &&
-                    !_textureFilenames.contains(part.emissiveTexture.filename)) {
-                if (!addPart(texdir + "/" + part.emissiveTexture.filename,
-                             QString("texture%1").arg(++_texturesCount), true)) {
-                    return false;
-                }
-                _textureFilenames.insert(part.emissiveTexture.filename);
+            if (!addTexture(texdir, part.diffuseTexture) || !addTexture(texdir, part.normalTexture) ||
+                    !addTexture(texdir, part.specularTexture) || !addTexture(texdir, part.emissiveTexture)) {
+                return false;
             }
         }
     }
@@ -574,7 +552,29 @@ bool ModelUploader::addTextures(const QString& texdir, const FBXGeometry& geomet
     return true;
 }
 
-bool ModelUploader::addPart(const QString &path, const QString& name, bool isTexture) {
+bool ModelUploader::addTexture(const QString& texdir, const FBXTexture& texture) {
+    if (texture.filename.isEmpty() || !texture.content.isEmpty() || _textureFilenames.contains(texture.filename)) {
+        return true;
+    }
+    QString name = QString("texture%1").arg(++_texturesCount);
+    QByteArray contentHash;
+    if (!addPart(texdir + "/" + texture.filename, name, true, &contentHash)) {
+        return false;
+    }
+    _textureFilenames.insert(texture.filename);
+    
+    // the hash of what's served goes in the fst, so clients share the texture with any other model that has it, and
+    // to the server, so it can store the content once
+    _textureHashes.insert(texture.filename, contentHash.toHex());
+    QHttpPart hashPart;
+    hashPart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data;"
+                       " name=\"" + name.toUtf8() + "_hash\"");
+    hashPart.setBody(contentHash.toHex());
+    _dataMultiPart->append(hashPart);
+    return true;
+}
+
+bool ModelUploader::addPart(const QString &path, const QString& name, bool isTexture, QByteArray* contentHash) {
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
         QMessageBox::warning(NULL,
@@ -584,10 +584,11 @@ bool ModelUploader::addPart(const QString &path, const QString& name, bool isTex
         qDebug() << "[Warning] " << QString("Could not open %1").arg(path);
         return false;
     }
-    return addPart(file, file.readAll(), name, isTexture);
+    return addPart(file, file.readAll(), name, isTexture, contentHash);
 }
 
-bool ModelUploader::addPart(const QFile& file, const QByteArray& contents, const QString& name, bool isTexture) {
+bool ModelUploader::addPart(const QFile& file, const QByteArray& contents, const QString& name, bool isTexture,
+        QByteArray* contentHash) {
     QFileInfo fileInfo(file);
     QByteArray recodedContents = contents;
     if (isTexture) {
@@ -606,6 +607,9 @@ bool ModelUploader::addPart(const QFile& file, const QByteArray& contents, const
             recodedContents = buffer.data();
         }
     }
+    if (contentHash) {
+        *contentHash = QCryptographicHash::hash(recodedContents, QCryptographicHash::Sha256);
+    }
     QByteArray buffer = qCompress(recodedContents);
     
     // Qt's qCompress() default compression level (-1) is the standard zLib compression.
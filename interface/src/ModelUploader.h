@@ -57,12 +57,15 @@ private:
     void populateBasicMapping(QVariantHash& mapping, QString filename, const FBXGeometry& geometry);
     bool zip();
     bool addTextures(const QString& texdir, const FBXGeometry& geometry);
-    bool addPart(const QString& path, const QString& name, bool isTexture = false);
-    bool addPart(const QFile& file, const QByteArray& contents, const QString& name, bool isTexture = false);
+    bool addTexture(const QString& texdir, const FBXTexture& texture);
+    bool addPart(const QString& path, const QString& name, bool isTexture = false, QByteArray* contentHash = NULL);
+    bool addPart(const QFile& file, const QByteArray& contents, const QString& name, bool isTexture = false,
+        QByteArray* contentHash = NULL);
     
     QString _url;
     QString _textureBase;
     QSet<QByteArray> _textureFilenames;
+    QVariantHash _textureHashes; // the SHA-256 of each texture as uploaded, by filename
     int _lodCount;
     int _texturesCount;
     unsigned long _totalSize;
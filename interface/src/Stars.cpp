@@ -28,10 +28,6 @@ bool Stars::generate(unsigned numStars, unsigned seed) {
     return _starsLoaded;
 }
 
-bool Stars::setResolution(unsigned k) { 
-    return _controller->setResolution(k); 
-}
-
 void Stars::render(float fovY, float aspect, float nearZ, float alpha) {
     // determine length of screen diagonal from quadrant height and aspect ratio
     float quadrantHeight = nearZ * tan(RADIANS_PER_DEGREE * fovY * 0.5f);
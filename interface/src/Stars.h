@@ -30,15 +30,6 @@ public:
     // The parameters specifiy the field of view.
     void render(float fovY, float aspect, float nearZ, float alpha);
 
-    // Sets the resolution for FOV culling.
-    //
-    // The parameter determines the number of tiles in azimuthal 
-    // and altitudinal directions. 
-    //
-    // GPU resources are updated upon change in which case 'true'
-    // is returned.
-    bool setResolution(unsigned k);
-
     // Returns true when stars have been loaded
     bool isStarsLoaded() const { return _starsLoaded; };
 private:
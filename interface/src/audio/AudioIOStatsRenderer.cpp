@@ -42,10 +42,10 @@ void AudioIOStatsRenderer::render(const float* color, int width, int height) {
         return;
     }
     
-    const int linesWhenCentered = _shouldShowInjectedStreams ? 34 : 27;
+    const int linesWhenCentered = _shouldShowInjectedStreams ? 37 : 29;
     const int CENTERED_BACKGROUND_HEIGHT = STATS_HEIGHT_PER_LINE * linesWhenCentered;
     
-    int lines = _shouldShowInjectedStreams ? _stats->getMixerInjectedStreamStatsMap().size() * 7 + 27 : 27;
+    int lines = _shouldShowInjectedStreams ? _stats->getMixerInjectedStreamStatsMap().size() * 8 + 29 : 29;
     int statsHeight = STATS_HEIGHT_PER_LINE * lines;
     
     
@@ -211,6 +211,14 @@ void AudioIOStatsRenderer::renderAudioStreamStats(const AudioStreamStats* stream
             streamStats->_overflowCount);
     verticalOffset += STATS_HEIGHT_PER_LINE;
     drawText(horizontalOffset, verticalOffset, scale, rotation, font, stringBuffer, color);
+
+    sprintf(stringBuffer, "               Jitter buffer calc | calculated: %u, delay_at_percentile: %9s, expansions: %u, compressions: %u",
+            streamStats->_calculatedJitterBufferFrames,
+            formatUsecTime(streamStats->_packetDelayAtPercentile).toLatin1().data(),
+            streamStats->_timeStretchExpansions,
+            streamStats->_timeStretchCompressions);
+    verticalOffset += STATS_HEIGHT_PER_LINE;
+    drawText(horizontalOffset, verticalOffset, scale, rotation, font, stringBuffer, color);
     
     sprintf(stringBuffer, "  Inter-packet timegaps (overall) | min: %9s, max: %9s, avg: %9s",
             formatUsecTime(streamStats->_timeGapMin).toLatin1().data(),
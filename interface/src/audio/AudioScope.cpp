@@ -11,11 +11,14 @@
 
 #include <gpu/GPUConfig.h>
 
+#include <algorithm>
 #include <limits>
 
 #include <AudioClient.h>
 #include <AudioConstants.h>
 #include <GeometryCache.h>
+#include <gpu/Batch.h>
+#include <gpu/GLBackend.h>
 
 #include "AudioScope.h"
 
@@ -24,30 +27,40 @@ static const unsigned int SCOPE_WIDTH = AudioConstants::NETWORK_FRAME_SAMPLES_PE
 static const unsigned int MULTIPLIER_SCOPE_HEIGHT = 20;
 static const unsigned int SCOPE_HEIGHT = 2 * 15 * MULTIPLIER_SCOPE_HEIGHT;
 
+// enough for the render thread to fall a few frames behind the audio without the queues dropping samples
+static const int SCOPE_QUEUE_FRAMES = 50;
+
+// every point is stored at its place in the ring and again one ring further on
+static const int SCOPE_POINTS = SCOPE_WIDTH;
+static const int SCOPE_POINT_SLOTS = 2 * SCOPE_POINTS;
+
+const int STEREO_FACTOR = 2;
+
 AudioScope::AudioScope() :
     _isEnabled(false),
     _isPaused(false),
-    _scopeInputOffset(0),
-    _scopeOutputOffset(0),
     _framesPerScope(DEFAULT_FRAMES_PER_SCOPE),
-    _samplesPerScope(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * _framesPerScope),
-    _scopeInput(NULL),
-    _scopeOutputLeft(NULL),
-    _scopeOutputRight(NULL),
+    _inputQueue(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, false, SCOPE_QUEUE_FRAMES),
+    _outputQueue(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, false, SCOPE_QUEUE_FRAMES),
     _scopeLastFrame(),
-    _audioScopeGrid(DependencyManager::get<GeometryCache>()->allocateID()),
-    _inputID(DependencyManager::get<GeometryCache>()->allocateID()),
-    _outputLeftID(DependencyManager::get<GeometryCache>()->allocateID()),
-    _outputRightD(DependencyManager::get<GeometryCache>()->allocateID())
+    _streamFormat(new gpu::Stream::Format()),
+    _audioScopeGrid(DependencyManager::get<GeometryCache>()->allocateID())
 {
+    _inputQueue.setIsLockFree(true);
+    _outputQueue.setIsLockFree(true);
+
+    _streamFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::XYZ), 0);
+    _streamFormat->setAttribute(gpu::Stream::COLOR, 1, gpu::Element(gpu::VEC4, gpu::UINT8, gpu::RGBA));
+
+    // the slots only write to the lock-free queues, so they run right on the audio threads rather than being queued
     auto audioIO = DependencyManager::get<AudioClient>();
     connect(&audioIO->getReceivedAudioStream(), &MixedProcessedAudioStream::addedSilence,
-            this, &AudioScope::addStereoSilenceToScope);
+            this, &AudioScope::addStereoSilenceToScope, Qt::DirectConnection);
     connect(&audioIO->getReceivedAudioStream(), &MixedProcessedAudioStream::addedLastFrameRepeatedWithFade,
-            this, &AudioScope::addLastFrameRepeatedWithFadeToScope);
+            this, &AudioScope::addLastFrameRepeatedWithFadeToScope, Qt::DirectConnection);
     connect(&audioIO->getReceivedAudioStream(), &MixedProcessedAudioStream::addedStereoSamples,
-            this, &AudioScope::addStereoSamplesToScope);
-    connect(audioIO.data(), &AudioClient::inputReceived, this, &AudioScope::addInputToScope);
+            this, &AudioScope::addStereoSamplesToScope, Qt::DirectConnection);
+    connect(audioIO.data(), &AudioClient::inputReceived, this, &AudioScope::addInputToScope, Qt::DirectConnection);
 }
 
 void AudioScope::toggle() {
@@ -72,36 +85,61 @@ void AudioScope::selectAudioScopeFiftyFrames() {
 }
 
 void AudioScope::allocateScope() {
-    _scopeInputOffset = 0;
-    _scopeOutputOffset = 0;
-    int num = _samplesPerScope * sizeof(int16_t);
-    _scopeInput = new QByteArray(num, 0);
-    _scopeOutputLeft = new QByteArray(num, 0);
-    _scopeOutputRight = new QByteArray(num, 0);
+    static const glm::vec4 inputColor = { 0.3f, 1.0f, 0.3f, 1.0f };
+    static const glm::vec4 outputLeftColor = { 1.0f, 0.3f, 0.3f, 1.0f };
+    static const glm::vec4 outputRightColor = { 0.3f, 0.3f, 1.0f, 1.0f };
+    allocateChannel(_input, inputColor);
+    allocateChannel(_outputLeft, outputLeftColor);
+    allocateChannel(_outputRight, outputRightColor);
+
+    // whatever was queued before the scope was last freed is stale
+    _inputQueue.shiftReadPosition(_inputQueue.samplesAvailable());
+    _outputQueue.shiftReadPosition(_outputQueue.samplesAvailable());
 }
 
 void AudioScope::reallocateScope(int frames) {
     if (_framesPerScope != frames) {
         _framesPerScope = frames;
-        _samplesPerScope = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * _framesPerScope;
-        freeScope();
-        allocateScope();
+        if (_input.vertices) {
+            resetChannel(_input);
+            resetChannel(_outputLeft);
+            resetChannel(_outputRight);
+        }
     }
 }
 
 void AudioScope::freeScope() {
-    if (_scopeInput) {
-        delete _scopeInput;
-        _scopeInput = 0;
-    }
-    if (_scopeOutputLeft) {
-        delete _scopeOutputLeft;
-        _scopeOutputLeft = 0;
-    }
-    if (_scopeOutputRight) {
-        delete _scopeOutputRight;
-        _scopeOutputRight = 0;
+    _input = Channel();
+    _outputLeft = Channel();
+    _outputRight = Channel();
+}
+
+void AudioScope::allocateChannel(Channel& channel, const glm::vec4& color) {
+    int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
+                        ((int(color.y * 255.0f) & 0xFF) << 8) |
+                        ((int(color.z * 255.0f) & 0xFF) << 16) |
+                        ((int(color.w * 255.0f) & 0xFF) << 24);
+    QVector<int> colors(SCOPE_POINT_SLOTS, compactColor);
+
+    channel.vertices.reset(new gpu::Buffer());
+    channel.colors.reset(new gpu::Buffer());
+    channel.colors->setData(colors.size() * sizeof(int), (const gpu::Buffer::Byte*)colors.constData());
+    channel.stream.reset(new gpu::BufferStream());
+    channel.stream->addBuffer(channel.vertices, 0, _streamFormat->getChannels().at(0)._stride);
+    channel.stream->addBuffer(channel.colors, 0, _streamFormat->getChannels().at(1)._stride);
+    resetChannel(channel);
+}
+
+void AudioScope::resetChannel(Channel& channel) {
+    // a point's x is its slot, drawing from the oldest shifts them all back into place
+    QVector<glm::vec2> points(SCOPE_POINT_SLOTS);
+    for (int i = 0; i < SCOPE_POINT_SLOTS; i++) {
+        points[i] = glm::vec2((float)i, 0.0f);
     }
+    channel.vertices->setData(points.size() * sizeof(glm::vec2), (const gpu::Buffer::Byte*)points.constData());
+    channel.pointOffset = 0;
+    channel.sampleSum = 0;
+    channel.samplesSummed = 0;
 }
 
 void AudioScope::render(int width, int height) {
@@ -110,11 +148,13 @@ void AudioScope::render(int width, int height) {
         return;
     }
     
+    Channel* inputChannels[] = { &_input };
+    readQueue(_inputQueue, inputChannels, 1);
+    Channel* outputChannels[STEREO_FACTOR] = { &_outputLeft, &_outputRight };
+    readQueue(_outputQueue, outputChannels, STEREO_FACTOR);
+
     static const glm::vec4 backgroundColor = { 0.4f, 0.4f, 0.4f, 0.6f };
     static const glm::vec4 gridColor = { 0.7f, 0.7f, 0.7f, 1.0f };
-    static const glm::vec4 inputColor = { 0.3f, 1.0f, 0.3f, 1.0f };
-    static const glm::vec4 outputLeftColor = { 1.0f, 0.3f, 0.3f, 1.0f };
-    static const glm::vec4 outputRightColor = { 0.3f, 0.3f, 1.0f, 1.0f };
     static const int gridRows = 2;
     int gridCols = _framesPerScope;
     
@@ -126,9 +166,9 @@ void AudioScope::render(int width, int height) {
     renderBackground(backgroundColor, x, y, w, h);
     renderGrid(gridColor, x, y, w, h, gridRows, gridCols);
     
-    renderLineStrip(_inputID, inputColor, x, y, _samplesPerScope, _scopeInputOffset, _scopeInput);
-    renderLineStrip(_outputLeftID, outputLeftColor, x, y, _samplesPerScope, _scopeOutputOffset, _scopeOutputLeft);
-    renderLineStrip(_outputRightD, outputRightColor, x, y, _samplesPerScope, _scopeOutputOffset, _scopeOutputRight);
+    renderChannel(_input, x, y);
+    renderChannel(_outputLeft, x, y);
+    renderChannel(_outputRight, x, y);
 }
 
 void AudioScope::renderBackground(const glm::vec4& color, int x, int y, int width, int height) {
@@ -139,141 +179,110 @@ void AudioScope::renderGrid(const glm::vec4& color, int x, int y, int width, int
     DependencyManager::get<GeometryCache>()->renderGrid(x, y, width, height, rows, cols, color, _audioScopeGrid);
 }
 
-void AudioScope::renderLineStrip(int id, const glm::vec4& color, int x, int y, int n, int offset, const QByteArray* byteArray) {
+void AudioScope::renderChannel(Channel& channel, int x, int y) {
+    gpu::Batch batch;
+    batch.setInputFormat(_streamFormat);
+    batch.setInputStream(0, *channel.stream);
+    batch.draw(gpu::LINE_STRIP, SCOPE_POINTS, channel.pointOffset);
 
-    int16_t sample;
-    int16_t* samples = ((int16_t*) byteArray->data()) + offset;
-    int numSamplesToAverage = _framesPerScope / DEFAULT_FRAMES_PER_SCOPE;
-    int count = (n - offset) / numSamplesToAverage;
-    int remainder = (n - offset) % numSamplesToAverage;
-    y += SCOPE_HEIGHT / 2;
-    
-    auto geometryCache = DependencyManager::get<GeometryCache>();
-
-    QVector<glm::vec2> points;
-    
+    glPushMatrix();
+    glTranslatef((float)(x - channel.pointOffset), (float)(y + SCOPE_HEIGHT / 2), 0.0f);
+    gpu::GLBackend::renderBatch(batch);
+    glPopMatrix();
 
-    // Compute and draw the sample averages from the offset position
-    for (int i = count; --i >= 0; ) {
-        sample = 0;
-        for (int j = numSamplesToAverage; --j >= 0; ) {
-            sample += *samples++;
-        }
-        sample /= numSamplesToAverage;
-        points << glm::vec2(x++, y - sample);
-    }
-
-    // Compute and draw the sample average across the wrap boundary
-    if (remainder != 0) {
-        sample = 0;
-        for (int j = remainder; --j >= 0; ) {
-            sample += *samples++;
-        }
-    
-        samples = (int16_t*) byteArray->data();
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-        for (int j = numSamplesToAverage - remainder; --j >= 0; ) {
-            sample += *samples++;
-        }
-        sample /= numSamplesToAverage;
-        points << glm::vec2(x++, y - sample);
-    } else {
-        samples = (int16_t*) byteArray->data();
-    }
+void AudioScope::readQueue(AudioRingBuffer& queue, Channel* const* channels, int numChannels) {
+    const int MAX_SAMPLES_PER_READ = 512 * STEREO_FACTOR;
+    int16_t samples[MAX_SAMPLES_PER_READ];
+    float heights[MAX_SAMPLES_PER_READ];
+    int numSamplesToAverage = std::max(1, _framesPerScope / (int)DEFAULT_FRAMES_PER_SCOPE);
+    int samplesPerRead = MAX_SAMPLES_PER_READ / numChannels * numChannels;
 
-    // Compute and draw the sample average from the beginning to the offset
-    count = (offset - remainder) / numSamplesToAverage;
-    for (int i = count; --i >= 0; ) {
-        sample = 0;
-        for (int j = numSamplesToAverage; --j >= 0; ) {
-            sample += *samples++;
+    int samplesRead;
+    while ((samplesRead = queue.readSamples(samples, samplesPerRead)) > 0) {
+        for (int c = 0; c < numChannels; c++) {
+            Channel& channel = *channels[c];
+            int numPoints = 0;
+            for (int i = c; i < samplesRead; i += numChannels) {
+                channel.sampleSum += samples[i];
+                if (++channel.samplesSummed == numSamplesToAverage) {
+                    float sample = (float)channel.sampleSum / numSamplesToAverage;
+                    heights[numPoints++] = -sample / (float)AudioConstants::MAX_SAMPLE_VALUE * (float)SCOPE_HEIGHT / 2.0f;
+                    channel.sampleSum = 0;
+                    channel.samplesSummed = 0;
+                }
+            }
+            addPointsToChannel(channel, heights, numPoints);
         }
-        sample /= numSamplesToAverage;
-        points << glm::vec2(x++, y - sample);
     }
-    
-    
-    geometryCache->updateVertices(id, points, color);
-    geometryCache->renderVertices(gpu::LINE_STRIP, id);
 }
 
-int AudioScope::addBufferToScope(QByteArray* byteArray, int frameOffset, const int16_t* source, int sourceSamplesPerChannel,
-                            unsigned int sourceChannel, unsigned int sourceNumberOfChannels, float fade) {
-    if (!_isEnabled || _isPaused) {
-        return 0;
+void AudioScope::addPointsToChannel(Channel& channel, const float* heights, int numPoints) {
+    // only the newest ring's worth of points can still be seen
+    if (numPoints > SCOPE_POINTS) {
+        channel.pointOffset = (channel.pointOffset + numPoints - SCOPE_POINTS) % SCOPE_POINTS;
+        heights += numPoints - SCOPE_POINTS;
+        numPoints = SCOPE_POINTS;
     }
-    
-    // Temporary variable receives sample value
-    float sample;
-    
-    // Short int pointer to mapped samples in byte array
-    int16_t* destination = (int16_t*) byteArray->data();
-    
-    for (int i = 0; i < sourceSamplesPerChannel; i++) {
-        sample = (float)source[i * sourceNumberOfChannels + sourceChannel];
-        destination[frameOffset] = sample / (float) AudioConstants::MAX_SAMPLE_VALUE * (float)SCOPE_HEIGHT / 2.0f;
-        frameOffset = (frameOffset == _samplesPerScope - 1) ? 0 : frameOffset + 1;
-    }
-    return frameOffset;
-}
 
-int AudioScope::addSilenceToScope(QByteArray* byteArray, int frameOffset, int silentSamples) {
-                                                                                                                                                                                                                                    
-    // Short int pointer to mapped samples in byte array
-    int16_t* destination = (int16_t*)byteArray->data();
-    
-    if (silentSamples >= _samplesPerScope) {
-        memset(destination, 0, byteArray->size());
-        return frameOffset;
-    }
-    
-    int samplesToBufferEnd = _samplesPerScope - frameOffset;
-    if (silentSamples > samplesToBufferEnd) {
-        memset(destination + frameOffset, 0, samplesToBufferEnd * sizeof(int16_t));
-        memset(destination, 0, silentSamples - samplesToBufferEnd * sizeof(int16_t));
-    } else {
-        memset(destination + frameOffset, 0, silentSamples * sizeof(int16_t));
+    // write up to the end of the ring and then from its start, each run at both of the places its points are kept
+    while (numPoints > 0) {
+        int runPoints = std::min(numPoints, SCOPE_POINTS - channel.pointOffset);
+        glm::vec2 points[SCOPE_POINTS];
+        for (int i = 0; i < runPoints; i++) {
+            points[i] = glm::vec2((float)(channel.pointOffset + i), heights[i]);
+        }
+        gpu::Buffer::Size offset = channel.pointOffset * sizeof(glm::vec2);
+        gpu::Buffer::Size size = runPoints * sizeof(glm::vec2);
+        channel.vertices->updateSubData(offset, size, (const gpu::Buffer::Byte*)points);
+        for (int i = 0; i < runPoints; i++) {
+            points[i].x += (float)SCOPE_POINTS;
+        }
+        channel.vertices->updateSubData(offset + SCOPE_POINTS * sizeof(glm::vec2), size, (const gpu::Buffer::Byte*)points);
+
+        channel.pointOffset = (channel.pointOffset + runPoints) % SCOPE_POINTS;
+        heights += runPoints;
+        numPoints -= runPoints;
     }
-    
-    return (frameOffset + silentSamples) % _samplesPerScope;
 }
 
-
-const int STEREO_FACTOR = 2;
-
 void AudioScope::addStereoSilenceToScope(int silentSamplesPerChannel) {
     if (!_isEnabled || _isPaused) {
         return;
     }
-    addSilenceToScope(_scopeOutputLeft, _scopeOutputOffset, silentSamplesPerChannel);
-    _scopeOutputOffset = addSilenceToScope(_scopeOutputRight, _scopeOutputOffset, silentSamplesPerChannel);
+    _outputQueue.addSilentSamples(silentSamplesPerChannel * STEREO_FACTOR);
 }
 
 void AudioScope::addStereoSamplesToScope(const QByteArray& samples) {
     if (!_isEnabled || _isPaused) {
         return;
     }
-    const int16_t* samplesData = reinterpret_cast<const int16_t*>(samples.data());
-    int samplesPerChannel = samples.size() / sizeof(int16_t) / STEREO_FACTOR;
-    
-    addBufferToScope(_scopeOutputLeft, _scopeOutputOffset, samplesData, samplesPerChannel, 0, STEREO_FACTOR);
-    _scopeOutputOffset = addBufferToScope(_scopeOutputRight, _scopeOutputOffset, samplesData, samplesPerChannel, 1, STEREO_FACTOR);
+    _outputQueue.writeData(samples.data(), samples.size());
     
     _scopeLastFrame = samples.right(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
 }
 
 void AudioScope::addLastFrameRepeatedWithFadeToScope(int samplesPerChannel) {
+    if (!_isEnabled || _isPaused || _scopeLastFrame.isEmpty()) {
+        return;
+    }
     const int16_t* lastFrameData = reinterpret_cast<const int16_t*>(_scopeLastFrame.data());
+    int lastFrameSamples = _scopeLastFrame.size() / sizeof(int16_t);
+    int16_t fadedFrame[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     
-    int samplesRemaining = samplesPerChannel;
+    int samplesRemaining = samplesPerChannel * STEREO_FACTOR;
     int indexOfRepeat = 0;
     do {
-        int samplesToWriteThisIteration = std::min(samplesRemaining, (int) AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        int samplesToWriteThisIteration = std::min(samplesRemaining, lastFrameSamples);
         float fade = calculateRepeatedFrameFadeFactor(indexOfRepeat);
-        addBufferToScope(_scopeOutputLeft, _scopeOutputOffset, lastFrameData,
-                         samplesToWriteThisIteration, 0, STEREO_FACTOR, fade);
-        _scopeOutputOffset = addBufferToScope(_scopeOutputRight, _scopeOutputOffset,
-                                              lastFrameData, samplesToWriteThisIteration, 1, STEREO_FACTOR, fade);
+        for (int i = 0; i < samplesToWriteThisIteration; i++) {
+            fadedFrame[i] = (int16_t)(lastFrameData[i] * fade);
+        }
+        _outputQueue.writeSamples(fadedFrame, samplesToWriteThisIteration);
         
         samplesRemaining -= samplesToWriteThisIteration;
         indexOfRepeat++;
@@ -284,11 +293,5 @@ void AudioScope::addInputToScope(const QByteArray& inputSamples) {
     if (!_isEnabled || _isPaused) {
         return;
     }
-    
-    const int INPUT_AUDIO_CHANNEL = 0;
-    const int NUM_INPUT_CHANNELS = 1;
-    
-    _scopeInputOffset = addBufferToScope(_scopeInput, _scopeInputOffset,
-                                         reinterpret_cast<const int16_t*>(inputSamples.data()),
-                                         inputSamples.size() / sizeof(int16_t), INPUT_AUDIO_CHANNEL, NUM_INPUT_CHANNELS);
+    _inputQueue.writeData(inputSamples.data(), inputSamples.size());
 }
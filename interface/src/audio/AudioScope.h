@@ -12,13 +12,20 @@
 #ifndef hifi_AudioScope_h
 #define hifi_AudioScope_h
 
+#include <atomic>
+
 #include <glm/glm.hpp>
 
+#include <AudioRingBuffer.h>
 #include <DependencyManager.h>
+#include <gpu/Stream.h>
 
 #include <QByteArray>
 #include <QObject>
 
+/// Draws the last few frames of microphone input and mixed output. The audio threads hand their samples over through
+/// lock-free single producer queues, and the render thread averages them into points kept in a ring on the gpu, only
+/// writing the new ones, so each channel is drawn with a single call and the audio threads never wait on the scope.
 class AudioScope : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
@@ -41,38 +48,48 @@ protected:
     AudioScope();
     
 private slots:
+    // these are called on the audio threads, they only write to the queues
     void addStereoSilenceToScope(int silentSamplesPerChannel);
     void addLastFrameRepeatedWithFadeToScope(int samplesPerChannel);
     void addStereoSamplesToScope(const QByteArray& samples);
     void addInputToScope(const QByteArray& inputSamples);
     
 private:
+    // one waveform, its points are stored twice over so any window of them is contiguous
+    class Channel {
+    public:
+        gpu::BufferPointer vertices;
+        gpu::BufferPointer colors;
+        gpu::BufferStreamPointer stream;
+        int pointOffset; // the next point written, and the oldest drawn
+        int sampleSum; // of the samples that will make up the next point
+        int samplesSummed;
+    };
+
     // Audio scope methods for rendering
     static void renderBackground(const glm::vec4& color, int x, int y, int width, int height);
     void renderGrid(const glm::vec4& color, int x, int y, int width, int height, int rows, int cols);
-    void renderLineStrip(int id, const glm::vec4& color, int x, int  y, int n, int offset, const QByteArray* byteArray);
-    
+    void renderChannel(Channel& channel, int x, int y);
+
     // Audio scope methods for data acquisition
-    int addBufferToScope(QByteArray* byteArray, int frameOffset, const int16_t* source, int sourceSamples,
-                         unsigned int sourceChannel, unsigned int sourceNumberOfChannels, float fade = 1.0f);
-    int addSilenceToScope(QByteArray* byteArray, int frameOffset, int silentSamples);
+    void allocateChannel(Channel& channel, const glm::vec4& color);
+    void resetChannel(Channel& channel);
+    void readQueue(AudioRingBuffer& queue, Channel* const* channels, int numChannels);
+    void addPointsToChannel(Channel& channel, const float* heights, int numPoints);
     
-    bool _isEnabled;
-    bool _isPaused;
-    int _scopeInputOffset;
-    int _scopeOutputOffset;
+    std::atomic<bool> _isEnabled;
+    std::atomic<bool> _isPaused;
     int _framesPerScope;
-    int _samplesPerScope;
-    QByteArray* _scopeInput;
-    QByteArray* _scopeOutputLeft;
-    QByteArray* _scopeOutputRight;
-    QByteArray _scopeLastFrame;
+    AudioRingBuffer _inputQueue;
+    AudioRingBuffer _outputQueue; // stereo interleaved
+    QByteArray _scopeLastFrame; // only touched by the output audio thread
 
-    int _audioScopeGrid;
-    int _inputID;
-    int _outputLeftID;
-    int _outputRightD;
+    gpu::Stream::FormatPointer _streamFormat;
+    Channel _input;
+    Channel _outputLeft;
+    Channel _outputRight;
 
+    int _audioScopeGrid;
 };
 
-#endif // hifi_AudioScope_h
\ No newline at end of file
+#endif // hifi_AudioScope_h
@@ -77,7 +77,9 @@ Avatar::Avatar() :
     _moving(false),
     _collisionGroups(0),
     _initialized(false),
-    _shouldRenderBillboard(true)
+    _shouldRenderBillboard(true),
+    _inViewFrustum(false),
+    _impostorDue(false)
 {
     // we may have been created in the network thread, but we live in the main thread
     moveToThread(Application::getInstance()->thread());
@@ -90,13 +92,11 @@ Avatar::Avatar() :
 Avatar::~Avatar() {
 }
 
-const float BILLBOARD_LOD_DISTANCE = 40.0f;
-
 void Avatar::init() {
     getHead()->init();
     _skeletonModel.init();
     _initialized = true;
-    _shouldRenderBillboard = (getLODDistance() >= BILLBOARD_LOD_DISTANCE);
+    _shouldRenderBillboard = getImpostorDistance() >= DependencyManager::get<LODManager>()->getAvatarImpostorDistance();
 }
 
 glm::vec3 Avatar::getChestPosition() const {
@@ -116,27 +116,34 @@ glm::quat Avatar::getWorldAlignedOrientation () const {
 }
 
 float Avatar::getLODDistance() const {
-    return DependencyManager::get<LODManager>()->getAvatarLODDistanceMultiplier() *
-            glm::distance(qApp->getCamera()->getPosition(), _position) / _scale;
+    return DependencyManager::get<LODManager>()->getAvatarLODDistanceMultiplier() * getImpostorDistance();
+}
+
+float Avatar::getImpostorDistance() const {
+    return glm::distance(qApp->getCamera()->getPosition(), _position) / _scale;
 }
 
 void Avatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
-    
+    PERFORMANCE_TIMER("simulate");
+    prepareToSimulate();
+    simulatePrepared(deltaTime);
+}
+
+void Avatar::prepareToSimulate() {
     // update the avatar's position according to its referential
     if (_referential) {
         if (_referential->hasExtraData()) {
             EntityTree* tree = Application::getInstance()->getEntities()->getTree();
             switch (_referential->type()) {
                 case Referential::MODEL:
-                    _referential = new ModelReferential(_referential,
-                                                        tree,
-                                                        this);
+                    changeReferential(new ModelReferential(_referential,
+                                                           tree,
+                                                           this));
                     break;
                 case Referential::JOINT:
-                    _referential = new JointReferential(_referential,
-                                                        tree,
-                                                        this);
+                    changeReferential(new JointReferential(_referential,
+                                                           tree,
+                                                           this));
                     break;
                 default:
                     qDebug() << "[WARNING] Avatar::simulate(): Unknown referential type.";
@@ -151,30 +158,52 @@ void Avatar::simulate(float deltaTime) {
         setScale(_targetScale);
     }
 
-    // update the billboard render flag
+    // update the billboard render flag; the distance comes from the frame time budget rather than the LOD multiplier
     const float BILLBOARD_HYSTERESIS_PROPORTION = 0.1f;
+    float impostorDistance = DependencyManager::get<LODManager>()->getAvatarImpostorDistance();
     if (_shouldRenderBillboard) {
-        if (getLODDistance() < BILLBOARD_LOD_DISTANCE * (1.0f - BILLBOARD_HYSTERESIS_PROPORTION)) {
+        if (getImpostorDistance() < impostorDistance * (1.0f - BILLBOARD_HYSTERESIS_PROPORTION)) {
             _shouldRenderBillboard = false;
         }
-    } else if (getLODDistance() > BILLBOARD_LOD_DISTANCE * (1.0f + BILLBOARD_HYSTERESIS_PROPORTION)) {
+    } else if (getImpostorDistance() > impostorDistance * (1.0f + BILLBOARD_HYSTERESIS_PROPORTION)) {
         _shouldRenderBillboard = true;
     }
 
     // simple frustum check
     float boundingRadius = getBillboardSize();
-    bool inViewFrustum = Application::getInstance()->getViewFrustum()->sphereInFrustum(_position, boundingRadius) !=
+    _inViewFrustum = Application::getInstance()->getViewFrustum()->sphereInFrustum(_position, boundingRadius) !=
         ViewFrustum::OUTSIDE;
 
+    // a distant avatar only poses its models when its impostor is due to be redrawn
+    _impostorDue = _shouldRenderBillboard && _inViewFrustum && _skeletonModel.isRenderable() &&
+        getHead()->getFaceModel().isRenderable() && DependencyManager::get<AvatarManager>()->getImpostors().claimUpdate(
+            this, qApp->getCamera()->getPosition());
+
+    _skeletonModel.setLODDistance(getLODDistance());
+    if ((!_shouldRenderBillboard || _impostorDue) && _inViewFrustum) {
+        // switching geometry or LOD requests resources and touches GL, so it happens here rather than in the simulation
+        _skeletonModel.prepareGeometry();
+        FaceModel& faceModel = getHead()->getFaceModel();
+        faceModel.setLODDistance(getLODDistance());
+        faceModel.prepareGeometry();
+        foreach (Model* model, _attachmentModels) {
+            if (!isMyAvatar()) {
+                model->setLODDistance(getLODDistance());
+            }
+            model->prepareGeometry();
+        }
+    }
+}
+
+void Avatar::simulatePrepared(float deltaTime) {
     {
-        PerformanceTimer perfTimer("hand");
+        PERFORMANCE_TIMER("hand");
         getHand()->simulate(deltaTime, false);
     }
-    _skeletonModel.setLODDistance(getLODDistance());
     
-    if (!_shouldRenderBillboard && inViewFrustum) {
+    if ((!_shouldRenderBillboard || _impostorDue) && _inViewFrustum) {
         {
-            PerformanceTimer perfTimer("skeleton");
+            PERFORMANCE_TIMER("skeleton");
             if (_hasNewJointRotations) {
                 for (int i = 0; i < _jointData.size(); i++) {
                     const JointData& data = _jointData.at(i);
@@ -186,13 +215,13 @@ void Avatar::simulate(float deltaTime) {
             _hasNewJointRotations = false;
         }
         {
-            PerformanceTimer perfTimer("head");
+            PERFORMANCE_TIMER("head");
             glm::vec3 headPosition = _position;
             _skeletonModel.getHeadPosition(headPosition);
             Head* head = getHead();
             head->setPosition(headPosition);
             head->setScale(_scale);
-            head->simulate(deltaTime, false, _shouldRenderBillboard);
+            head->simulate(deltaTime, false, _shouldRenderBillboard && !_impostorDue);
         }
     }
 
@@ -450,7 +479,8 @@ void Avatar::render(const glm::vec3& cameraPosition, RenderMode renderMode, bool
     const float DISPLAYNAME_DISTANCE = 20.0f;
     setShowDisplayName(renderMode == NORMAL_RENDER_MODE && distanceToTarget < DISPLAYNAME_DISTANCE);
     if (!postLighting || renderMode != NORMAL_RENDER_MODE || (isMyAvatar() &&
-            Application::getInstance()->getCamera()->getMode() == CAMERA_MODE_FIRST_PERSON)) {
+            Application::getInstance()->getCamera()->getMode() == CAMERA_MODE_FIRST_PERSON) ||
+            DependencyManager::get<AvatarManager>()->getImpostors().getRenderingAvatar() == this) {
         return;
     }
     renderDisplayName();
@@ -478,10 +508,15 @@ void Avatar::renderBody(RenderMode renderMode, bool postLighting, float glowLeve
     {
         Glower glower(glowLevel);
         
-        if (_shouldRenderBillboard || !(_skeletonModel.isRenderable() && getHead()->getFaceModel().isRenderable())) {
+        AvatarImpostors& impostors = DependencyManager::get<AvatarManager>()->getImpostors();
+        bool drawingImpostor = (impostors.getRenderingAvatar() == this);
+        if ((_shouldRenderBillboard && !drawingImpostor) ||
+                !(_skeletonModel.isRenderable() && getHead()->getFaceModel().isRenderable())) {
             if (postLighting || renderMode == SHADOW_RENDER_MODE) {
-                // render the billboard until both models are loaded
-                renderBillboard();
+                // queue the impostor card if there is one, else render the billboard until both models are loaded
+                if (!(_shouldRenderBillboard && impostors.queue(this, qApp->getCamera()->getPosition()))) {
+                    renderBillboard();
+                }
             }
             return;
         }
@@ -942,6 +977,21 @@ int Avatar::parseDataAtOffset(const QByteArray& packet, int offset) {
     return bytesRead;
 }
 
+void Avatar::applyParsedData(AvatarData& parsed) {
+    if (!_initialized) {
+        // now that we have data for this Avatar we are go for init
+        init();
+    }
+    
+    // change in position implies movement
+    glm::vec3 oldPosition = _position;
+    
+    AvatarData::applyParsedData(parsed);
+    
+    const float MOVE_DISTANCE_THRESHOLD = 0.001f;
+    _moving = glm::distance(oldPosition, _position) > MOVE_DISTANCE_THRESHOLD;
+}
+
 int Avatar::_jointConesID = GeometryCache::UNKNOWN_ID;
 
 // render a makeshift cone section that serves as a body part connecting joint spheres
@@ -68,6 +68,13 @@ public:
 
     void init();
     void simulate(float deltaTime);
+
+    /// The part of simulate() that has to run on the main thread: referentials, scale, billboard and frustum state, and
+    /// any geometry or LOD switches of the avatar's models.
+    void prepareToSimulate();
+
+    /// The rest of simulate(), which only touches this avatar and may run on a worker thread once prepared.
+    void simulatePrepared(float deltaTime);
     
     enum RenderMode { NORMAL_RENDER_MODE, SHADOW_RENDER_MODE, MIRROR_RENDER_MODE };
     
@@ -92,6 +99,9 @@ public:
     /// Returns the distance to use as a LOD parameter.
     float getLODDistance() const;
 
+    /// Returns the half extent of the avatar's billboard and impostor cards.
+    float getBillboardSize() const;
+
     bool findRayIntersection(RayIntersectionInfo& intersection) const;
 
     /// \param shapes list of shapes to collide against avatar
@@ -128,6 +138,7 @@ public:
     void setShowDisplayName(bool showDisplayName);
     
     virtual int parseDataAtOffset(const QByteArray& packet, int offset);
+    virtual void applyParsedData(AvatarData& parsed);
 
     static void renderJointConnectingCone(glm::vec3 position1, glm::vec3 position2, 
                                                 float radius1, float radius2, const glm::vec4& color);
@@ -236,11 +247,13 @@ private:
     bool _initialized;
     QScopedPointer<Texture> _billboardTexture;
     bool _shouldRenderBillboard;
+    bool _inViewFrustum;
+    bool _impostorDue;
     bool _isLookAtTarget;
 
     void renderBillboard();
     
-    float getBillboardSize() const;
+    float getImpostorDistance() const;
     
     static int _jointConesID;
 };
@@ -0,0 +1,185 @@
+//
+//  AvatarImpostors.cpp
+//  interface/src/avatar
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <gpu/GPUConfig.h>
+
+#include <glm/gtx/quaternion.hpp>
+
+#include <SharedUtil.h>
+#include <TextureCache.h>
+
+#include "Application.h"
+#include "Avatar.h"
+
+#include "AvatarImpostors.h"
+
+const int IMPOSTOR_ATLAS_SIZE = 1024;
+const int IMPOSTOR_CELL_SIZE = 128;
+const int IMPOSTOR_CELLS_PER_ROW = IMPOSTOR_ATLAS_SIZE / IMPOSTOR_CELL_SIZE;
+const int IMPOSTOR_CELL_COUNT = IMPOSTOR_CELLS_PER_ROW * IMPOSTOR_CELLS_PER_ROW;
+
+// drawing a card costs a full render of the avatar, so only a couple are drawn each frame and each is kept while the
+// view stays within a few degrees of where it was drawn from
+const int MAX_IMPOSTOR_UPDATES_PER_FRAME = 2;
+const quint64 IMPOSTOR_UPDATE_INTERVAL = USECS_PER_SECOND / 2;
+const float MAX_IMPOSTOR_VIEW_CHANGE_COSINE = 0.966f; // 15 degrees
+const quint64 UNUSED_IMPOSTOR_LIFETIME = USECS_PER_SECOND * 2;
+
+static glm::vec3 getHorizontalDirection(const glm::vec3& from, const glm::vec3& to) {
+    glm::vec3 direction(to.x - from.x, 0.0f, to.z - from.z);
+    float length = glm::length(direction);
+    return length > EPSILON ? direction / length : glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+static glm::quat getFacingRotation(const glm::vec3& direction) {
+    return glm::angleAxis(atan2f(direction.x, direction.z), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+AvatarImpostors::AvatarImpostors() :
+    _renderingAvatar(NULL)
+{
+    for (int i = IMPOSTOR_CELL_COUNT - 1; i >= 0; i--) {
+        _freeCells.append(i);
+    }
+}
+
+AvatarImpostors::~AvatarImpostors() {
+}
+
+bool AvatarImpostors::claimUpdate(Avatar* avatar, const glm::vec3& cameraPosition) {
+    if (_pendingUpdates.size() >= MAX_IMPOSTOR_UPDATES_PER_FRAME) {
+        return false;
+    }
+    QHash<QUuid, Card>::const_iterator card = _cards.constFind(avatar->getSessionUUID());
+    if (card == _cards.constEnd()) {
+        if (_freeCells.isEmpty()) {
+            return false;
+        }
+    } else if (isUpToDate(card.value(), getHorizontalDirection(avatar->getPosition(), cameraPosition),
+            usecTimestampNow())) {
+        return false;
+    }
+    _pendingUpdates.append(avatar);
+    return true;
+}
+
+void AvatarImpostors::update(const glm::vec3& cameraPosition) {
+    quint64 now = usecTimestampNow();
+    for (QHash<QUuid, Card>::iterator card = _cards.begin(); card != _cards.end(); ) {
+        if (now - card.value().used > UNUSED_IMPOSTOR_LIFETIME) {
+            _freeCells.append(card.value().cell);
+            card = _cards.erase(card);
+        } else {
+            ++card;
+        }
+    }
+    if (_pendingUpdates.isEmpty()) {
+        return;
+    }
+    if (!_atlas) {
+        _atlas.reset(new Texture());
+        glBindTexture(GL_TEXTURE_2D, _atlas->getID());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, IMPOSTOR_ATLAS_SIZE, IMPOSTOR_ATLAS_SIZE, 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    foreach (Avatar* avatar, _pendingUpdates) {
+        QUuid id = avatar->getSessionUUID();
+        QHash<QUuid, Card>::iterator card = _cards.find(id);
+        if (card == _cards.end()) {
+            if (_freeCells.isEmpty()) {
+                continue;
+            }
+            Card newCard = { _freeCells.takeLast(), glm::vec3(), 0, now };
+            card = _cards.insert(id, newCard);
+        }
+        glm::vec3 direction = getHorizontalDirection(avatar->getPosition(), cameraPosition);
+        glm::vec2 origin = getCellOrigin(card.value().cell) * (float)IMPOSTOR_ATLAS_SIZE;
+
+        _renderingAvatar = avatar;
+        Application::getInstance()->renderAvatarImpostor(avatar, getFacingRotation(direction), _atlas->getID(),
+            (int)origin.x, (int)origin.y, IMPOSTOR_CELL_SIZE);
+        _renderingAvatar = NULL;
+
+        card.value().direction = direction;
+        card.value().updated = now;
+    }
+    _pendingUpdates.clear();
+}
+
+bool AvatarImpostors::queue(Avatar* avatar, const glm::vec3& cameraPosition) {
+    QHash<QUuid, Card>::iterator card = _cards.find(avatar->getSessionUUID());
+    if (card == _cards.end() || card.value().updated == 0) {
+        return false;
+    }
+    card.value().used = usecTimestampNow();
+
+    // turn about the vertical to face the camera, like the billboards
+    glm::vec3 position = avatar->getPosition();
+    glm::quat rotation = getFacingRotation(getHorizontalDirection(position, cameraPosition));
+    float size = avatar->getBillboardSize();
+    glm::vec3 right = rotation * glm::vec3(size, 0.0f, 0.0f);
+    glm::vec3 up = rotation * glm::vec3(0.0f, size, 0.0f);
+
+    const float CELL_EXTENT = (float)IMPOSTOR_CELL_SIZE / IMPOSTOR_ATLAS_SIZE;
+    glm::vec2 minimum = getCellOrigin(card.value().cell);
+    glm::vec2 maximum = minimum + glm::vec2(CELL_EXTENT, CELL_EXTENT);
+    CardVertex corners[] = {
+        { position - right - up, minimum },
+        { position + right - up, glm::vec2(maximum.x, minimum.y) },
+        { position + right + up, maximum },
+        { position - right + up, glm::vec2(minimum.x, maximum.y) } };
+    for (int i = 0; i < 4; i++) {
+        _vertices.append(corners[i]);
+    }
+    return true;
+}
+
+void AvatarImpostors::render() {
+    if (_vertices.isEmpty()) {
+        return;
+    }
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.5f);
+
+    glEnable(GL_TEXTURE_2D);
+    glDisable(GL_LIGHTING);
+    glBindTexture(GL_TEXTURE_2D, _atlas->getID());
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glVertexPointer(3, GL_FLOAT, sizeof(CardVertex), &_vertices.constData()->vertex);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(CardVertex), &_vertices.constData()->texCoord);
+    glDrawArrays(GL_QUADS, 0, _vertices.size());
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_LIGHTING);
+    glDisable(GL_ALPHA_TEST);
+
+    _vertices.clear();
+}
+
+bool AvatarImpostors::isUpToDate(const Card& card, const glm::vec3& direction, quint64 now) const {
+    return card.updated != 0 && now - card.updated < IMPOSTOR_UPDATE_INTERVAL &&
+        glm::dot(card.direction, direction) > MAX_IMPOSTOR_VIEW_CHANGE_COSINE;
+}
+
+glm::vec2 AvatarImpostors::getCellOrigin(int cell) const {
+    const float CELL_EXTENT = (float)IMPOSTOR_CELL_SIZE / IMPOSTOR_ATLAS_SIZE;
+    return glm::vec2(cell % IMPOSTOR_CELLS_PER_ROW, cell / IMPOSTOR_CELLS_PER_ROW) * CELL_EXTENT;
+}
@@ -0,0 +1,77 @@
+//
+//  AvatarImpostors.h
+//  interface/src/avatar
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarImpostors_h
+#define hifi_AvatarImpostors_h
+
+#include <QHash>
+#include <QScopedPointer>
+#include <QUuid>
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+class Avatar;
+class Texture;
+
+/// Renders distant avatars as camera-facing cards.  Each card is drawn from the avatar's current pose into a cell of a
+/// shared atlas, redrawn a few at a time as it ages or the view moves around it, and all the cards of a frame go out in
+/// one draw.
+class AvatarImpostors {
+public:
+    AvatarImpostors();
+    ~AvatarImpostors();
+
+    /// Claims one of this frame's redraws for the avatar if its card is missing or out of date, in which case its models
+    /// should be simulated so that update() can draw it.
+    bool claimUpdate(Avatar* avatar, const glm::vec3& cameraPosition);
+
+    /// Redraws the claimed cards and frees the ones that have gone unused.  Must be called on the main thread once the
+    /// claiming avatars have been simulated.
+    void update(const glm::vec3& cameraPosition);
+
+    /// The avatar whose card is being drawn, which should render its models rather than its card.
+    Avatar* getRenderingAvatar() const { return _renderingAvatar; }
+
+    /// Queues the avatar's card for the next render().
+    /// \return false if the avatar has no card yet
+    bool queue(Avatar* avatar, const glm::vec3& cameraPosition);
+
+    /// Draws and clears the queued cards.
+    void render();
+
+private:
+
+    class Card {
+    public:
+        int cell;
+        glm::vec3 direction;
+        quint64 updated;
+        quint64 used;
+    };
+
+    class CardVertex {
+    public:
+        glm::vec3 vertex;
+        glm::vec2 texCoord;
+    };
+
+    bool isUpToDate(const Card& card, const glm::vec3& direction, quint64 now) const;
+    glm::vec2 getCellOrigin(int cell) const;
+
+    QHash<QUuid, Card> _cards;
+    QVector<int> _freeCells;
+    QVector<Avatar*> _pendingUpdates;
+    QVector<CardVertex> _vertices;
+    QScopedPointer<Texture> _atlas;
+    Avatar* _renderingAvatar;
+};
+
+#endif // hifi_AvatarImpostors_h
@@ -11,6 +11,7 @@
 
 #include <string>
 
+#include <QRunnable>
 #include <QScriptEngine>
 
 #include <glm/gtx/string_cast.hpp>
@@ -73,22 +74,24 @@ void AvatarManager::updateMyAvatar(float deltaTime) {
     
     if (dt > MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS) {
         // send head/hand data to the avatar mixer and voxel server
-        PerformanceTimer perfTimer("send");
+        PERFORMANCE_TIMER("send");
         _myAvatar->sendAvatarDataPacket();
         _lastSendAvatarDataTime = now;
     }
 }
 
 void AvatarManager::updateOtherAvatars(float deltaTime) {
+    // take what the datagram processor parsed since the last frame
+    applyParsedAvatarData();
+    
     if (_avatarHash.size() < 2 && _avatarFades.isEmpty()) {
         return;
     }
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateAvatars()");
 
-    PerformanceTimer perfTimer("otherAvatars");
-    
-    // simulate avatars
+    // prepare avatars on this thread, then simulate them in parallel
+    QVector<Avatar*> avatarsToSimulate;
     AvatarHash::iterator avatarIterator = _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
         AvatarSharedPointer sharedAvatar = avatarIterator.value();
@@ -102,16 +105,21 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         }
         if (!shouldKillAvatar(sharedAvatar)) {
             // this avatar's mixer is still around, go ahead and simulate it
-            avatar->simulate(deltaTime);
+            avatar->prepareToSimulate();
+            avatarsToSimulate.append(avatar);
             ++avatarIterator;
         } else {
             // the mixer that owned this avatar is gone, give it to the vector of fades and kill it
             avatarIterator = erase(avatarIterator);
         }
     }
+    simulatePreparedAvatars(avatarsToSimulate, deltaTime);
     
     // simulate avatar fades
     simulateAvatarFades(deltaTime);
+
+    // redraw the impostors claimed during the simulation
+    _impostors.update(Application::getInstance()->getCamera()->getPosition());
 }
 
 void AvatarManager::renderAvatars(Avatar::RenderMode renderMode, bool postLighting, bool selfAvatarOnly) {
@@ -131,6 +139,12 @@ void AvatarManager::renderAvatars(Avatar::RenderMode renderMode, bool postLighti
             avatar->setDisplayingLookatVectors(renderLookAtVectors);
         }
         renderAvatarFades(cameraPosition, renderMode);
+        _impostors.render();
+
+    } else if (_impostors.getRenderingAvatar()) {
+        // just render the avatar whose impostor is being drawn
+        _impostors.getRenderingAvatar()->render(cameraPosition, renderMode, postLighting);
+
     } else {
         // just render myAvatar
         _myAvatar->render(cameraPosition, renderMode, postLighting);
@@ -138,6 +152,29 @@ void AvatarManager::renderAvatars(Avatar::RenderMode renderMode, bool postLighti
     }
 }
 
+class AvatarSimulator : public QRunnable {
+public:
+    AvatarSimulator(Avatar* avatar, float deltaTime) : _avatar(avatar), _deltaTime(deltaTime) { }
+
+    virtual void run() { _avatar->simulatePrepared(_deltaTime); }
+
+private:
+    Avatar* _avatar;
+    float _deltaTime;
+};
+
+void AvatarManager::simulatePreparedAvatars(const QVector<Avatar*>& avatars, float deltaTime) {
+    if (avatars.size() == 1) {
+        avatars.first()->simulatePrepared(deltaTime);
+        return;
+    }
+    foreach (Avatar* avatar, avatars) {
+        _simulationPool.start(new AvatarSimulator(avatar, deltaTime));
+    }
+    // rendering reads the joint states, so every avatar has to be done first
+    _simulationPool.waitForDone();
+}
+
 void AvatarManager::simulateAvatarFades(float deltaTime) {
     QVector<AvatarSharedPointer>::iterator fadingIterator = _avatarFades.begin();
     
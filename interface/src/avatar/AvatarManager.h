@@ -15,10 +15,12 @@
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
 #include <AvatarHashMap.h>
 
 #include "Avatar.h"
+#include "AvatarImpostors.h"
 
 class MyAvatar;
 
@@ -34,6 +36,7 @@ public:
     void init();
 
     MyAvatar* getMyAvatar() { return _myAvatar.data(); }
+    AvatarImpostors& getImpostors() { return _impostors; }
     
     void updateMyAvatar(float deltaTime);
     void updateOtherAvatars(float deltaTime);
@@ -54,6 +57,7 @@ private:
     AvatarManager(QObject* parent = 0);
     AvatarManager(const AvatarManager& other);
 
+    void simulatePreparedAvatars(const QVector<Avatar*>& avatars, float deltaTime);
     void simulateAvatarFades(float deltaTime);
     void renderAvatarFades(const glm::vec3& cameraPosition, Avatar::RenderMode renderMode);
     
@@ -67,6 +71,9 @@ private:
     quint64 _lastSendAvatarDataTime = 0; // Controls MyAvatar send data rate.
     
     QVector<AvatarManager::LocalLight> _localLights;
+
+    QThreadPool _simulationPool;
+    AvatarImpostors _impostors;
 };
 
 Q_DECLARE_METATYPE(AvatarManager::LocalLight)
@@ -19,6 +19,8 @@ ModelReferential::ModelReferential(Referential* referential, EntityTree* tree, A
     Referential(MODEL, avatar),
     _tree(tree) 
 {
+    // the same referential, now that it's unpacked, so the whole ones that follow it aren't taken for changes
+    _version = referential->version();
     _translation = referential->getTranslation();
     _rotation = referential->getRotation();
     _scale = referential->getScale();
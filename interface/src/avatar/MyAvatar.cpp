@@ -114,18 +114,18 @@ MyAvatar::~MyAvatar() {
     _lookAtTargetAvatar.clear();
 }
 
-QByteArray MyAvatar::toByteArray() {
+QByteArray MyAvatar::toByteArray(bool includeFaceData) {
     CameraMode mode = Application::getInstance()->getCamera()->getMode();
     if (mode == CAMERA_MODE_THIRD_PERSON || mode == CAMERA_MODE_INDEPENDENT) {
         // fake the avatar position that is sent up to the AvatarMixer
         glm::vec3 oldPosition = _position;
         _position = getSkeletonPosition();
-        QByteArray array = AvatarData::toByteArray();
+        QByteArray array = AvatarData::toByteArray(includeFaceData);
         // copy the correct position back
         _position = oldPosition;
         return array;
     }
-    return AvatarData::toByteArray();
+    return AvatarData::toByteArray(includeFaceData);
 }
 
 void MyAvatar::reset() {
@@ -165,7 +165,7 @@ void MyAvatar::update(float deltaTime) {
 }
 
 void MyAvatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
     
     // Play back recording
     if (_player && _player->isPlaying()) {
@@ -180,28 +180,28 @@ void MyAvatar::simulate(float deltaTime) {
     _skeletonModel.setShowTrueJointTransforms(! Menu::getInstance()->isOptionChecked(MenuOption::CollideAsRagdoll));
 
     {
-        PerformanceTimer perfTimer("transform");
+        PERFORMANCE_TIMER("transform");
         updateOrientation(deltaTime);
         updatePosition(deltaTime);
     }
     
     {
-        PerformanceTimer perfTimer("hand");
+        PERFORMANCE_TIMER("hand");
         // update avatar skeleton and simulate hand and head
         getHand()->simulate(deltaTime, true);
     }
 
     {
-        PerformanceTimer perfTimer("skeleton");
+        PERFORMANCE_TIMER("skeleton");
         _skeletonModel.simulate(deltaTime);
     }
     {
-        PerformanceTimer perfTimer("attachments");
+        PERFORMANCE_TIMER("attachments");
         simulateAttachments(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("joints");
+        PERFORMANCE_TIMER("joints");
         // copy out the skeleton joints from the model
         _jointData.resize(_skeletonModel.getJointStateCount());
         if (Menu::getInstance()->isOptionChecked(MenuOption::CollideAsRagdoll)) {
@@ -218,7 +218,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("head");
+        PERFORMANCE_TIMER("head");
         Head* head = getHead();
         glm::vec3 headPosition;
         if (!_skeletonModel.getHeadPosition(headPosition)) {
@@ -230,7 +230,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
     
     {
-        PerformanceTimer perfTimer("physics");
+        PERFORMANCE_TIMER("physics");
         const float minError = 0.00001f;
         const float maxIterations = 3;
         const quint64 maxUsec = 4000;
@@ -253,7 +253,7 @@ void MyAvatar::simulate(float deltaTime) {
 
     // now that we're done stepping the avatar forward in time, compute new collisions
     if (_collisionGroups != 0) {
-        PerformanceTimer perfTimer("collisions");
+        PERFORMANCE_TIMER("collisions");
         Camera* myCamera = Application::getInstance()->getCamera();
 
         float radius = getSkeletonHeight() * COLLISION_RADIUS_SCALE;
@@ -262,17 +262,17 @@ void MyAvatar::simulate(float deltaTime) {
             radius *= COLLISION_RADIUS_SCALAR;
         }
         if (_collisionGroups & COLLISION_GROUP_ENVIRONMENT) {
-            PerformanceTimer perfTimer("environment");
+            PERFORMANCE_TIMER("environment");
             updateCollisionWithEnvironment(deltaTime, radius);
         }
         if (_collisionGroups & COLLISION_GROUP_VOXELS) {
-            PerformanceTimer perfTimer("voxels");
+            PERFORMANCE_TIMER("voxels");
             updateCollisionWithVoxels(deltaTime, radius);
         } else {
             _trapDuration = 0.0f;
         }
         if (_collisionGroups & COLLISION_GROUP_AVATARS) {
-            PerformanceTimer perfTimer("avatars");
+            PERFORMANCE_TIMER("avatars");
             updateCollisionWithAvatars(deltaTime);
         }
     }
@@ -44,6 +44,7 @@ struct Packet{
 };
 
 DdeFaceTracker::DdeFaceTracker() :
+_udpSocket(this),
 _lastReceiveTimestamp(0),
 _reset(false),
 _leftBlinkIndex(0), // see http://support.faceshift.com/support/articles/35129-export-of-blendshapes
@@ -60,15 +61,18 @@ _mouthSmileRightIndex(29),
 _jawOpenIndex(21)
 {
     _blendshapeCoefficients.resize(NUM_EXPRESSION);
+    _receivedCoefficients.resize(NUM_EXPRESSION);
     
     connect(&_udpSocket, SIGNAL(readyRead()), SLOT(readPendingDatagrams()));
     connect(&_udpSocket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(socketErrorOccurred(QAbstractSocket::SocketError)));
     connect(&_udpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), SLOT(socketStateChanged(QAbstractSocket::SocketState)));
     
     bindTo(DDE_FEATURE_POINT_SERVER_PORT);
+    startIngestThread("DDE Face Tracker");
 }
 
 DdeFaceTracker::DdeFaceTracker(const QHostAddress& host, quint16 port) :
+_udpSocket(this),
 _lastReceiveTimestamp(0),
 _reset(false),
 _leftBlinkIndex(0), // see http://support.faceshift.com/support/articles/35129-export-of-blendshapes
@@ -85,15 +89,18 @@ _mouthSmileRightIndex(29),
 _jawOpenIndex(21)
 {
     _blendshapeCoefficients.resize(NUM_EXPRESSION);
+    _receivedCoefficients.resize(NUM_EXPRESSION);
     
     connect(&_udpSocket, SIGNAL(readyRead()), SLOT(readPendingDatagrams()));
     connect(&_udpSocket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(socketErrorOccurred(QAbstractSocket::SocketError)));
     connect(&_udpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), SIGNAL(socketStateChanged(QAbstractSocket::SocketState)));
     
     bindTo(host, port);
+    startIngestThread("DDE Face Tracker");
 }
 
 DdeFaceTracker::~DdeFaceTracker() {
+    stopIngestThread();
     if(_udpSocket.isOpen())
         _udpSocket.close();
 }
@@ -107,7 +114,13 @@ void DdeFaceTracker::reset() {
 }
 
 void DdeFaceTracker::update() {
-    
+    if (_samples.update()) {
+        _previousSample = _latestSample;
+        _latestSample = _samples.getReadBuffer();
+    }
+    if (_latestSample.timestamp != 0) {
+        extrapolateSamples(_previousSample, _latestSample);
+    }
 }
 
 void DdeFaceTracker::bindTo(quint16 port) {
@@ -232,10 +245,6 @@ void DdeFaceTracker::decodePacket(const QByteArray& buffer) {
         // Compute relative rotation
         rotation = glm::inverse(_referenceRotation) * rotation;
         
-        // copy values
-        _headTranslation = translation;
-        _headRotation = rotation;
-        
         if (_lastReceiveTimestamp == 0) {
             //  On first packet, reset coefficients
         }
@@ -243,35 +252,44 @@ void DdeFaceTracker::decodePacket(const QByteArray& buffer) {
         // Set blendshapes
         float EYE_MAGNIFIER = 4.0f;
         float rightEye = glm::clamp((updateAndGetCoefficient(_rightEye, packet.expressions[0])) * EYE_MAGNIFIER, 0.0f, 1.0f);
-        _blendshapeCoefficients[_rightBlinkIndex] = rightEye;
+        _receivedCoefficients[_rightBlinkIndex] = rightEye;
         float leftEye = glm::clamp((updateAndGetCoefficient(_leftEye, packet.expressions[1])) * EYE_MAGNIFIER, 0.0f, 1.0f);
-        _blendshapeCoefficients[_leftBlinkIndex] = leftEye;
+        _receivedCoefficients[_leftBlinkIndex] = leftEye;
 
         
         float leftBrow = 1.0f - rescaleCoef(packet.expressions[14]);
         if (leftBrow < 0.5f) {
-            _blendshapeCoefficients[_browDownLeftIndex] = 1.0f - 2.0f * leftBrow;
-            _blendshapeCoefficients[_browUpLeftIndex] = 0.0f;
+            _receivedCoefficients[_browDownLeftIndex] = 1.0f - 2.0f * leftBrow;
+            _receivedCoefficients[_browUpLeftIndex] = 0.0f;
         } else {
-            _blendshapeCoefficients[_browDownLeftIndex] = 0.0f;
-            _blendshapeCoefficients[_browUpLeftIndex] = 2.0f * (leftBrow - 0.5f);
+            _receivedCoefficients[_browDownLeftIndex] = 0.0f;
+            _receivedCoefficients[_browUpLeftIndex] = 2.0f * (leftBrow - 0.5f);
         }
         float rightBrow = 1.0f - rescaleCoef(packet.expressions[15]);
         if (rightBrow < 0.5f) {
-            _blendshapeCoefficients[_browDownRightIndex] = 1.0f - 2.0f * rightBrow;
-            _blendshapeCoefficients[_browUpRightIndex] = 0.0f;
+            _receivedCoefficients[_browDownRightIndex] = 1.0f - 2.0f * rightBrow;
+            _receivedCoefficients[_browUpRightIndex] = 0.0f;
         } else {
-            _blendshapeCoefficients[_browDownRightIndex] = 0.0f;
-            _blendshapeCoefficients[_browUpRightIndex] = 2.0f * (rightBrow - 0.5f);
+            _receivedCoefficients[_browDownRightIndex] = 0.0f;
+            _receivedCoefficients[_browUpRightIndex] = 2.0f * (rightBrow - 0.5f);
         }
         
         float JAW_OPEN_MAGNIFIER = 1.4f;
-        _blendshapeCoefficients[_jawOpenIndex] = rescaleCoef(packet.expressions[21]) * JAW_OPEN_MAGNIFIER;
+        _receivedCoefficients[_jawOpenIndex] = rescaleCoef(packet.expressions[21]) * JAW_OPEN_MAGNIFIER;
         
         float SMILE_MULTIPLIER = 2.0f;
-        _blendshapeCoefficients[_mouthSmileLeftIndex] = glm::clamp(packet.expressions[24] * SMILE_MULTIPLIER, 0.0f, 1.0f);
-        _blendshapeCoefficients[_mouthSmileRightIndex] = glm::clamp(packet.expressions[23] * SMILE_MULTIPLIER, 0.0f, 1.0f);
+        _receivedCoefficients[_mouthSmileLeftIndex] = glm::clamp(packet.expressions[24] * SMILE_MULTIPLIER,
+            0.0f, 1.0f);
+        _receivedCoefficients[_mouthSmileRightIndex] = glm::clamp(packet.expressions[23] * SMILE_MULTIPLIER,
+            0.0f, 1.0f);
         
+        // hand it to the main thread, which takes the latest once a frame
+        FaceTrackerSample& sample = _samples.getWriteBuffer();
+        sample.timestamp = usecTimestampNow();
+        sample.headTranslation = translation;
+        sample.headRotation = rotation;
+        sample.blendshapeCoefficients = _receivedCoefficients;
+        _samples.publish();
         
     } else {
         qDebug() << "[Error] DDE Face Tracker Decode Error";
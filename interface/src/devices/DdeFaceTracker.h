@@ -12,9 +12,12 @@
 #ifndef hifi_DdeFaceTracker_h
 #define hifi_DdeFaceTracker_h
 
+#include <atomic>
+
 #include <QUdpSocket>
 
 #include <DependencyManager.h>
+#include <TripleBuffer.h>
 
 #include "FaceTracker.h"
 
@@ -28,7 +31,7 @@ public:
     void reset();
     void update();
     
-    //sockets
+    //sockets, bound before the tracker moves to its ingest thread
     void bindTo(quint16 port);
     void bindTo(const QHostAddress& host, quint16 port);
     bool isActive() const;
@@ -65,9 +68,17 @@ private:
     
     // sockets
     QUdpSocket _udpSocket;
-    quint64 _lastReceiveTimestamp;
+    std::atomic<quint64> _lastReceiveTimestamp;
+    
+    // received on the ingest thread, taken on the main thread
+    TripleBuffer<FaceTrackerSample> _samples;
+    FaceTrackerSample _previousSample;
+    FaceTrackerSample _latestSample;
+    
+    // ingest thread only
+    QVector<float> _receivedCoefficients;
     
-    bool _reset;
+    std::atomic<bool> _reset;
     glm::vec3 _referenceTranslation;
     glm::quat _referenceRotation;
     
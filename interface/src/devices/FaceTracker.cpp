@@ -9,9 +9,70 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QCoreApplication>
+
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
 #include "FaceTracker.h"
 
+// past this, a tracker that went quiet is held where it was rather than guessed at
+const quint64 MAX_EXTRAPOLATION_USECS = 100 * 1000;
+
 FaceTracker::FaceTracker() :
     _estimatedEyePitch(0.0f),
-    _estimatedEyeYaw(0.0f) {
+    _estimatedEyeYaw(0.0f),
+    _ingestThread(NULL) {
+}
+
+FaceTracker::~FaceTracker() {
+    stopIngestThread();
+}
+
+void FaceTracker::startIngestThread(const QString& name) {
+    _ingestThread = new QThread();
+    _ingestThread->setObjectName(name);
+    moveToThread(_ingestThread);
+    _ingestThread->start();
+}
+
+void FaceTracker::stopIngestThread() {
+    if (!_ingestThread) {
+        return;
+    }
+    // the sockets have to be closed and deleted on the thread they belong to, so they come back here first
+    QMetaObject::invokeMethod(this, "returnToMainThread", Qt::BlockingQueuedConnection);
+    _ingestThread->quit();
+    _ingestThread->wait();
+    delete _ingestThread;
+    _ingestThread = NULL;
+}
+
+void FaceTracker::returnToMainThread() {
+    moveToThread(QCoreApplication::instance() ? QCoreApplication::instance()->thread() : NULL);
+}
+
+void FaceTracker::extrapolateSamples(const FaceTrackerSample& previous, const FaceTrackerSample& latest) {
+    _headTranslation = latest.headTranslation;
+    _headRotation = latest.headRotation;
+    _blendshapeCoefficients = latest.blendshapeCoefficients;
+    
+    quint64 now = usecTimestampNow();
+    if (previous.timestamp == 0 || latest.timestamp <= previous.timestamp || now <= latest.timestamp ||
+            now - latest.timestamp > MAX_EXTRAPOLATION_USECS) {
+        return;
+    }
+    quint64 interval = latest.timestamp - previous.timestamp;
+    float ratio = (float)qMin(now - latest.timestamp, interval) / interval;
+    
+    _headTranslation += (latest.headTranslation - previous.headTranslation) * ratio;
+    _headRotation = safeMix(previous.headRotation, latest.headRotation, 1.0f + ratio);
+    
+    // coefficients don't go below zero, or past one unless the tracker put them there
+    int coefficientCount = qMin(previous.blendshapeCoefficients.size(), latest.blendshapeCoefficients.size());
+    for (int i = 0; i < coefficientCount; i++) {
+        float coefficient = latest.blendshapeCoefficients.at(i);
+        float extrapolated = coefficient + (coefficient - previous.blendshapeCoefficients.at(i)) * ratio;
+        _blendshapeCoefficients[i] = glm::clamp(extrapolated, 0.0f, qMax(coefficient, 1.0f));
+    }
 }
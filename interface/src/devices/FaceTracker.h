@@ -13,18 +13,28 @@
 #define hifi_FaceTracker_h
 
 #include <QObject>
+#include <QThread>
 #include <QVector>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+/// The head and face as a tracker reported them, stamped with when the report arrived.
+class FaceTrackerSample {
+public:
+    quint64 timestamp = 0; ///< usecs, zero before the first report
+    glm::vec3 headTranslation;
+    glm::quat headRotation;
+    QVector<float> blendshapeCoefficients;
+};
+
 /// Base class for face trackers (Faceshift, Visage).
 class FaceTracker : public QObject {
     Q_OBJECT
     
 public:
     FaceTracker();
-    virtual ~FaceTracker() {}
+    virtual ~FaceTracker();
     
     const glm::vec3& getHeadTranslation() const { return _headTranslation; }
     const glm::quat& getHeadRotation() const { return _headRotation; }
@@ -36,11 +46,29 @@ public:
     
 protected:
     
+    /// Moves the tracker, and the sockets that are its children, to a thread of their own, so that what the tracker
+    /// sends is received and parsed as it arrives rather than when the frame gets to it.
+    void startIngestThread(const QString& name);
+    
+    /// Brings the tracker back to the main thread and stops the ingest thread.  Called by the destructors of the
+    /// trackers that started one, before they touch their sockets.
+    void stopIngestThread();
+    
+    /// Sets the head pose and blendshapes to where the two latest samples put them now, carrying the motion between
+    /// them on past the latest by up to the interval between them, to make up for the latency of the tracker and of
+    /// the frame.
+    void extrapolateSamples(const FaceTrackerSample& previous, const FaceTrackerSample& latest);
+    
     glm::vec3 _headTranslation;
     glm::quat _headRotation;
     float _estimatedEyePitch;
     float _estimatedEyeYaw;
     QVector<float> _blendshapeCoefficients;
+
+private:
+    Q_INVOKABLE void returnToMainThread();
+
+    QThread* _ingestThread;
 };
 
 #endif // hifi_FaceTracker_h
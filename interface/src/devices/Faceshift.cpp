@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QThread>
 #include <QTimer>
 
 #include <GLMHelpers.h>
@@ -29,9 +30,12 @@ const quint16 FACESHIFT_PORT = 33433;
 float STARTING_FACESHIFT_FRAME_TIME = 0.033f;
 
 Faceshift::Faceshift() :
+    _tcpSocket(this),
+    _udpSocket(this),
     _tcpEnabled(true),
     _tcpRetryCount(0),
     _lastTrackingStateReceived(0),
+    _connectedOrConnecting(false),
     _averageFrameTime(STARTING_FACESHIFT_FRAME_TIME),
     _headAngularVelocity(0),
     _headLinearVelocity(0),
@@ -59,18 +63,26 @@ Faceshift::Faceshift() :
     _eyeDeflection("faceshiftEyeDeflection", DEFAULT_FACESHIFT_EYE_DEFLECTION),
     _hostname("faceshiftHostname", DEFAULT_FACESHIFT_HOSTNAME)
 {
+    _tcpHostname = _hostname.get();
 #ifdef HAVE_FACESHIFT
     connect(&_tcpSocket, SIGNAL(connected()), SLOT(noteConnected()));
     connect(&_tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(noteError(QAbstractSocket::SocketError)));
     connect(&_tcpSocket, SIGNAL(readyRead()), SLOT(readFromSocket()));
-    connect(&_tcpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), SIGNAL(connectionStateChanged()));
+    connect(&_tcpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), SLOT(noteStateChanged()));
 
     connect(&_udpSocket, SIGNAL(readyRead()), SLOT(readPendingDatagrams()));
 
     _udpSocket.bind(FACESHIFT_PORT);
+    
+    // the tracking states are parsed as they arrive, and the frame takes the latest
+    startIngestThread("Faceshift");
 #endif
 }
 
+Faceshift::~Faceshift() {
+    stopIngestThread();
+}
+
 void Faceshift::init() {
 #ifdef HAVE_FACESHIFT
     setTCPEnabled(Menu::getInstance()->isOptionChecked(MenuOption::Faceshift));
@@ -78,8 +90,7 @@ void Faceshift::init() {
 }
 
 bool Faceshift::isConnectedOrConnecting() const {
-    return _tcpSocket.state() == QAbstractSocket::ConnectedState ||
-    (_tcpRetryCount == 0 && _tcpSocket.state() != QAbstractSocket::UnconnectedState);
+    return _connectedOrConnecting;
 }
 
 bool Faceshift::isActive() const {
@@ -92,10 +103,21 @@ bool Faceshift::isActive() const {
 }
 
 void Faceshift::update() {
+    if (_samples.update()) {
+        _previousSample = _latestSample;
+        _latestSample = _samples.getReadBuffer();
+        _headAngularVelocity = _latestSample.headAngularVelocity;
+        _eyeGazeLeftPitch = _latestSample.eyeGazeLeftPitch;
+        _eyeGazeLeftYaw = _latestSample.eyeGazeLeftYaw;
+        _eyeGazeRightPitch = _latestSample.eyeGazeRightPitch;
+        _eyeGazeRightYaw = _latestSample.eyeGazeRightYaw;
+    }
     if (!isActive()) {
         return;
     }
-    PerformanceTimer perfTimer("faceshift");
+    PERFORMANCE_TIMER("faceshift");
+    extrapolateSamples(_previousSample, _latestSample);
+    
     // get the euler angles relative to the window
     glm::vec3 eulers = glm::degrees(safeEulerAngles(_headRotation * glm::quat(glm::radians(glm::vec3(
         (_eyeGazeLeftPitch + _eyeGazeRightPitch) / 2.0f, (_eyeGazeLeftYaw + _eyeGazeRightYaw) / 2.0f, 0.0f)))));
@@ -116,13 +138,19 @@ void Faceshift::update() {
 }
 
 void Faceshift::reset() {
+#ifdef HAVE_FACESHIFT
+    QMetaObject::invokeMethod(this, "calibrateNeutral");
+    _longTermAverageInitialized = false;
+#endif
+}
+
+void Faceshift::calibrateNeutral() {
 #ifdef HAVE_FACESHIFT
     if (_tcpSocket.state() == QAbstractSocket::ConnectedState) {
         string message;
         fsBinaryStream::encode_message(message, fsMsgCalibrateNeutral());
         send(message);
     }
-    _longTermAverageInitialized = false;
 #endif
 }
 
@@ -148,6 +176,10 @@ void Faceshift::updateFakeCoefficients(float leftBlink, float rightBlink, float
 }
 
 void Faceshift::setTCPEnabled(bool enabled) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setTCPEnabled", Q_ARG(bool, enabled));
+        return;
+    }
     if ((_tcpEnabled = enabled)) {
         connectSocket();
 
@@ -162,7 +194,7 @@ void Faceshift::connectSocket() {
             qDebug("Faceshift: Connecting...");
         }
 
-        _tcpSocket.connectToHost(_hostname.get(), FACESHIFT_PORT);
+        _tcpSocket.connectToHost(_tcpHostname, FACESHIFT_PORT);
         _tracking = false;
     }
 }
@@ -187,6 +219,14 @@ void Faceshift::noteError(QAbstractSocket::SocketError error) {
         _tcpRetryCount++;
         QTimer::singleShot(2000, this, SLOT(connectSocket()));
     }
+    noteStateChanged();
+}
+
+void Faceshift::noteStateChanged() {
+    QAbstractSocket::SocketState state = _tcpSocket.state();
+    _connectedOrConnecting = state == QAbstractSocket::ConnectedState ||
+        (_tcpRetryCount == 0 && state != QAbstractSocket::UnconnectedState);
+    emit connectionStateChanged();
 }
 
 void Faceshift::readPendingDatagrams() {
@@ -219,20 +259,23 @@ void Faceshift::receive(const QByteArray& buffer) {
             case fsMsg::MSG_OUT_TRACKING_STATE: {
                 const fsTrackingData& data = static_cast<fsMsgTrackingState*>(msg.get())->tracking_data();
                 if ((_tracking = data.m_trackingSuccessful)) {
+                    // everything but the sample is the ingest thread's own
+                    FaceshiftSample& sample = _samples.getWriteBuffer();
                     glm::quat newRotation = glm::quat(data.m_headRotation.w, -data.m_headRotation.x,
                                                       data.m_headRotation.y, -data.m_headRotation.z);
                     // Compute angular velocity of the head
-                    glm::quat r = newRotation * glm::inverse(_headRotation);
+                    glm::quat r = newRotation * glm::inverse(_receivedHeadRotation);
                     float theta = 2 * acos(r.w);
                     if (theta > EPSILON) {
                         float rMag = glm::length(glm::vec3(r.x, r.y, r.z));
-                        _headAngularVelocity = theta / _averageFrameTime * glm::vec3(r.x, r.y, r.z) / rMag;
+                        sample.headAngularVelocity = theta / _averageFrameTime * glm::vec3(r.x, r.y, r.z) / rMag;
                     } else {
-                        _headAngularVelocity = glm::vec3(0,0,0);
+                        sample.headAngularVelocity = glm::vec3(0,0,0);
                     }
                     const float ANGULAR_VELOCITY_FILTER_STRENGTH = 0.3f;
-                    _headRotation = safeMix(_headRotation, newRotation, glm::clamp(glm::length(_headAngularVelocity) *
-                                                                                   ANGULAR_VELOCITY_FILTER_STRENGTH, 0.0f, 1.0f));
+                    _receivedHeadRotation = safeMix(_receivedHeadRotation, newRotation,
+                        glm::clamp(glm::length(sample.headAngularVelocity) * ANGULAR_VELOCITY_FILTER_STRENGTH,
+                            0.0f, 1.0f));
 
                     const float TRANSLATION_SCALE = 0.02f;
                     glm::vec3 newHeadTranslation = glm::vec3(data.m_headTranslation.x, data.m_headTranslation.y,
@@ -246,16 +289,19 @@ void Faceshift::receive(const QByteArray& buffer) {
                     _filteredHeadTranslation = velocityFilter * _filteredHeadTranslation + (1.0f - velocityFilter) * newHeadTranslation;
                     
                     _lastHeadTranslation = newHeadTranslation;
-                    _headTranslation = _filteredHeadTranslation;
                     
-                    _eyeGazeLeftPitch = -data.m_eyeGazeLeftPitch;
-                    _eyeGazeLeftYaw = data.m_eyeGazeLeftYaw;
-                    _eyeGazeRightPitch = -data.m_eyeGazeRightPitch;
-                    _eyeGazeRightYaw = data.m_eyeGazeRightYaw;
-                    _blendshapeCoefficients = QVector<float>::fromStdVector(data.m_coeffs);
+                    quint64 usecsNow = usecTimestampNow();
+                    sample.timestamp = usecsNow;
+                    sample.headTranslation = _filteredHeadTranslation;
+                    sample.headRotation = _receivedHeadRotation;
+                    sample.eyeGazeLeftPitch = -data.m_eyeGazeLeftPitch;
+                    sample.eyeGazeLeftYaw = data.m_eyeGazeLeftYaw;
+                    sample.eyeGazeRightPitch = -data.m_eyeGazeRightPitch;
+                    sample.eyeGazeRightYaw = data.m_eyeGazeRightYaw;
+                    sample.blendshapeCoefficients = QVector<float>::fromStdVector(data.m_coeffs);
+                    _samples.publish();
 
                     const float FRAME_AVERAGING_FACTOR = 0.99f;
-                    quint64 usecsNow = usecTimestampNow();
                     if (_lastTrackingStateReceived != 0) {
                         _averageFrameTime = FRAME_AVERAGING_FACTOR * _averageFrameTime +
                         (1.0f - FRAME_AVERAGING_FACTOR) * (float)(usecsNow - _lastTrackingStateReceived) / 1000000.0f;
@@ -319,4 +365,9 @@ void Faceshift::setEyeDeflection(float faceshiftEyeDeflection) {
 
 void Faceshift::setHostname(const QString& hostname) {
     _hostname.set(hostname);
+    QMetaObject::invokeMethod(this, "setTCPHostname", Q_ARG(const QString&, hostname));
+}
+
+void Faceshift::setTCPHostname(const QString& hostname) {
+    _tcpHostname = hostname;
 }
@@ -12,6 +12,8 @@
 #ifndef hifi_Faceshift_h
 #define hifi_Faceshift_h
 
+#include <atomic>
+
 #include <QTcpSocket>
 #include <QUdpSocket>
 
@@ -21,12 +23,23 @@
 
 #include <DependencyManager.h>
 #include <SettingHandle.h>
+#include <TripleBuffer.h>
 
 #include "FaceTracker.h"
 
 const float DEFAULT_FACESHIFT_EYE_DEFLECTION = 0.25f;
 const QString DEFAULT_FACESHIFT_HOSTNAME = "localhost";
 
+/// A tracking state from Faceshift, with the angles of the eyes in degrees.
+class FaceshiftSample : public FaceTrackerSample {
+public:
+    glm::vec3 headAngularVelocity;
+    float eyeGazeLeftPitch = 0.0f;
+    float eyeGazeLeftYaw = 0.0f;
+    float eyeGazeRightPitch = 0.0f;
+    float eyeGazeRightYaw = 0.0f;
+};
+
 /// Handles interaction with the Faceshift software, which provides head position/orientation and facial features.
 class Faceshift : public FaceTracker, public Dependency {
     Q_OBJECT
@@ -94,12 +107,16 @@ private slots:
     void connectSocket();
     void noteConnected();
     void noteError(QAbstractSocket::SocketError error);
+    void noteStateChanged();
     void readPendingDatagrams();
     void readFromSocket();        
+    void setTCPHostname(const QString& hostname);
     
 private:
     Faceshift();
-    virtual ~Faceshift() {}
+    virtual ~Faceshift();
+    
+    Q_INVOKABLE void calibrateNeutral();
     
     float getBlendshapeCoefficient(int index) const;
     
@@ -113,11 +130,19 @@ private:
     fs::fsBinaryStream _stream;
 #endif
     
+    // the sockets and what they receive belong to the ingest thread
     bool _tcpEnabled;
     int _tcpRetryCount;
+    QString _tcpHostname;
     bool _tracking;
-    quint64 _lastTrackingStateReceived;
+    std::atomic<quint64> _lastTrackingStateReceived;
+    std::atomic<bool> _connectedOrConnecting;
     float _averageFrameTime;
+    glm::quat _receivedHeadRotation;
+    
+    TripleBuffer<FaceshiftSample> _samples;
+    FaceshiftSample _previousSample;
+    FaceshiftSample _latestSample;
     
     glm::vec3 _headAngularVelocity;
     glm::vec3 _headLinearVelocity;
@@ -130,22 +155,23 @@ private:
     float _eyeGazeRightPitch;
     float _eyeGazeRightYaw;
     
-    int _leftBlinkIndex;
-    int _rightBlinkIndex;
-    int _leftEyeOpenIndex;
-    int _rightEyeOpenIndex;
+    // set on the ingest thread as the names arrive
+    std::atomic<int> _leftBlinkIndex;
+    std::atomic<int> _rightBlinkIndex;
+    std::atomic<int> _leftEyeOpenIndex;
+    std::atomic<int> _rightEyeOpenIndex;
 
     // Brows
-    int _browDownLeftIndex;
-    int _browDownRightIndex;
-    int _browUpCenterIndex;
-    int _browUpLeftIndex;
-    int _browUpRightIndex;
+    std::atomic<int> _browDownLeftIndex;
+    std::atomic<int> _browDownRightIndex;
+    std::atomic<int> _browUpCenterIndex;
+    std::atomic<int> _browUpLeftIndex;
+    std::atomic<int> _browUpRightIndex;
     
-    int _mouthSmileLeftIndex;
-    int _mouthSmileRightIndex;
+    std::atomic<int> _mouthSmileLeftIndex;
+    std::atomic<int> _mouthSmileRightIndex;
     
-    int _jawOpenIndex;
+    std::atomic<int> _jawOpenIndex;
     
     // degrees
     float _longTermAverageEyePitch;
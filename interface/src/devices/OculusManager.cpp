@@ -64,6 +64,9 @@ bool OculusManager::_frameTimingActive = false;
 bool OculusManager::_programInitialized = false;
 Camera* OculusManager::_camera = NULL;
 int OculusManager::_activeEyeIndex = -1;
+GLuint OculusManager::_lastEyeTexture = 0;
+ovrPosef OculusManager::_lastEyeRenderPose[ovrEye_Count];
+bool OculusManager::_reprojectedLastFrame = false;
 
 float OculusManager::CALIBRATION_DELTA_MINIMUM_LENGTH = 0.02f;
 float OculusManager::CALIBRATION_DELTA_MINIMUM_ANGLE = 5.0f * RADIANS_PER_DEGREE;
@@ -180,6 +183,7 @@ void OculusManager::disconnect() {
 #ifdef HAVE_LIBOVR
     if (_isConnected) {
         _isConnected = false;
+        _lastEyeTexture = 0;
         ovrHmd_Destroy(_ovrHmd);
         ovr_Shutdown();
 
@@ -445,6 +449,17 @@ void OculusManager::display(const glm::quat &bodyOrientation, const glm::vec3 &p
         return;
     }
 
+    // If the simulation ran so long that the eyes can no longer be drawn before this frame's timewarp point, show the
+    // last frame's eyes warped to where the head is now instead of dropping the frame in the headset.  We only do so
+    // once in a row, so that a slow scene still gets drawn.
+    if (_lastEyeTexture != 0 && !_reprojectedLastFrame &&
+            ovr_GetTimeInSeconds() > _hmdFrameTiming.TimewarpPointSeconds) {
+        _reprojectedLastFrame = true;
+        reprojectLastFrame();
+        return;
+    }
+    _reprojectedLastFrame = false;
+
     ApplicationOverlay& applicationOverlay = Application::getInstance()->getApplicationOverlay();
 
     // We only need to render the overlays to a texture once, then we just render the texture on the hemisphere
@@ -494,12 +509,18 @@ void OculusManager::display(const glm::quat &bodyOrientation, const glm::vec3 &p
 #else
         ovrEyeType eye = _ovrHmdDesc.EyeRenderOrder[eyeIndex];
 #endif
-        // Set the camera rotation for this eye
+        // Set the camera rotation for this eye, from the pose predicted for its scan-out, sampled as late as we can
         eyeRenderPose[eye] = ovrHmd_GetEyePose(_ovrHmd, eye);
         orientation.x = eyeRenderPose[eye].Orientation.x;
         orientation.y = eyeRenderPose[eye].Orientation.y;
         orientation.z = eyeRenderPose[eye].Orientation.z;
         orientation.w = eyeRenderPose[eye].Orientation.w;
+
+#if defined(__APPLE__) || defined(_WIN32)
+        // the position comes from the same late sample, rather than the one taken before the overlay was drawn
+        trackerPosition = bodyOrientation * glm::vec3(eyeRenderPose[eye].Position.x, eyeRenderPose[eye].Position.y,
+                                                      eyeRenderPose[eye].Position.z);
+#endif
         
         // Update the application camera with the latest HMD position
         whichCamera.setHmdPosition(trackerPosition);
@@ -542,7 +563,7 @@ void OculusManager::display(const glm::quat &bodyOrientation, const glm::vec3 &p
         //glTranslatef(_eyeRenderDesc[eye].ViewAdjust.x, _eyeRenderDesc[eye].ViewAdjust.y, _eyeRenderDesc[eye].ViewAdjust.z);
         
         _camera->setEyeOffsetPosition(glm::vec3(-_eyeRenderDesc[eye].ViewAdjust.x, -_eyeRenderDesc[eye].ViewAdjust.y, -_eyeRenderDesc[eye].ViewAdjust.z));
-        Application::getInstance()->displaySide(*_camera, false, RenderArgs::MONO);
+        Application::getInstance()->displaySide(*_camera, false, renderSide);
 
         applicationOverlay.displayOverlayTextureOculus(*_camera);
         _activeEyeIndex = -1;
@@ -559,10 +580,14 @@ void OculusManager::display(const glm::quat &bodyOrientation, const glm::vec3 &p
     //Bind the output texture from the glow shader. If glow effect is disabled, we just grab the texture
     if (Menu::getInstance()->isOptionChecked(MenuOption::EnableGlowEffect)) {
         QOpenGLFramebufferObject* fbo = DependencyManager::get<GlowEffect>()->render(true);
-        glBindTexture(GL_TEXTURE_2D, fbo->texture());
+        _lastEyeTexture = fbo->texture();
     } else {
         DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->release();
-        glBindTexture(GL_TEXTURE_2D, DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->texture());
+        _lastEyeTexture = DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->texture();
+    }
+    glBindTexture(GL_TEXTURE_2D, _lastEyeTexture);
+    for (int eye = 0; eye < ovrEye_Count; eye++) {
+        _lastEyeRenderPose[eye] = eyeRenderPose[eye];
     }
 
     // restore our normal viewport
@@ -582,6 +607,21 @@ void OculusManager::display(const glm::quat &bodyOrientation, const glm::vec3 &p
 }
 
 #ifdef HAVE_LIBOVR
+void OculusManager::reprojectLastFrame() {
+    auto glCanvas = DependencyManager::get<GLCanvas>();
+    glViewport(0, 0, glCanvas->getDeviceWidth(), glCanvas->getDeviceHeight());
+
+    // the timewarp takes the eyes from the poses they were drawn with to the ones predicted for this frame
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glBindTexture(GL_TEXTURE_2D, _lastEyeTexture);
+    renderDistortionMesh(_lastEyeRenderPose);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
 void OculusManager::renderDistortionMesh(ovrPosef eyeRenderPose[ovrEye_Count]) {
 
     glLoadIdentity();
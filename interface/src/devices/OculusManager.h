@@ -56,6 +56,7 @@ private:
 #ifdef HAVE_LIBOVR
     static void generateDistortionMesh();
     static void renderDistortionMesh(ovrPosef eyeRenderPose[ovrEye_Count]);
+    static void reprojectLastFrame();
 
     static bool similarNames(const QString& nameA,const QString& nameB);
 
@@ -105,6 +106,11 @@ private:
     static Camera* _camera;
     static int _activeEyeIndex;
 
+    // the eyes last drawn, which a frame that starts too late to draw its own shows warped to the latest head pose
+    static GLuint _lastEyeTexture;
+    static ovrPosef _lastEyeRenderPose[ovrEye_Count];
+    static bool _reprojectedLastFrame;
+
     static void calibrate(const glm::vec3 position, const glm::quat orientation);
     enum CalibrationState {
         UNCALIBRATED,
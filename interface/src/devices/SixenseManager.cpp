@@ -157,7 +157,7 @@ void SixenseManager::update(float deltaTime) {
             return;
         }
         
-        PerformanceTimer perfTimer("sixense");
+        PERFORMANCE_TIMER("sixense");
         if (!_hydrasConnected) {
             _hydrasConnected = true;
             UserActivityLogger::getInstance().connectedDevice("spatial_controller", "hydra");
@@ -132,7 +132,7 @@ void Visage::update() {
     if (!_active) {
         return;
     }
-    PerformanceTimer perfTimer("visage");
+    PERFORMANCE_TIMER("visage");
     _headRotation = glm::quat(glm::vec3(-_data->faceRotation[0], -_data->faceRotation[1], _data->faceRotation[2]));    
     _headTranslation = (glm::vec3(_data->faceTranslation[0], _data->faceTranslation[1], _data->faceTranslation[2]) -
         _headOrigin) * TRANSLATION_SCALE;
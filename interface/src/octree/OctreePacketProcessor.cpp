@@ -9,12 +9,36 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QRunnable>
+
 #include <PerfStat.h>
 
 #include "Application.h"
 #include "Menu.h"
 #include "OctreePacketProcessor.h"
 
+// how many entity data packets we hold back before decoding them, so that a steady stream of them still gets read
+// into the tree as it goes
+const int MAX_PENDING_ENTITY_DATA = 64;
+
+// how many decoded packets are read into the tree under each write lock
+const int MAX_ENTITY_DATA_PER_WRITE_LOCK = 8;
+
+class EntityDataDecoder : public QRunnable {
+public:
+    EntityDataDecoder(const NetworkPacket& packet, DecodedOctreePacket* decodedPacket) :
+        _packet(packet), _decodedPacket(decodedPacket) { }
+
+    virtual void run() {
+        Application::getInstance()->getEntities()->decodeDatagram(_packet.getByteArray(), _packet.getNode(),
+                                                                  *_decodedPacket);
+    }
+
+private:
+    NetworkPacket _packet;
+    DecodedOctreePacket* _decodedPacket;
+};
+
 void OctreePacketProcessor::processPacket(const SharedNodePointer& sendingNode, const QByteArray& packet) {
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                             "OctreePacketProcessor::processPacket()");
@@ -82,13 +106,15 @@ void OctreePacketProcessor::processPacket(const SharedNodePointer& sendingNode,
         switch(voxelPacketType) {
             case PacketTypeEntityErase: {
                 if (Menu::getInstance()->isOptionChecked(MenuOption::Entities)) {
+                    // the data that came before the erase has to be in the tree before it
+                    processPendingEntityData();
                     app->_entities.processEraseMessage(mutablePacket, sendingNode);
                 }
             } break;
 
             case PacketTypeEntityData: {
                 if (Menu::getInstance()->isOptionChecked(MenuOption::Entities)) {
-                    app->_entities.processDatagram(mutablePacket, sendingNode);
+                    _pendingEntityData.append(NetworkPacket(sendingNode, mutablePacket));
                 }
             } break;
 
@@ -103,3 +129,35 @@ void OctreePacketProcessor::processPacket(const SharedNodePointer& sendingNode,
     }
 }
 
+
+void OctreePacketProcessor::midProcess() {
+    if (_pendingEntityData.size() >= MAX_PENDING_ENTITY_DATA) {
+        processPendingEntityData();
+    }
+}
+
+void OctreePacketProcessor::postProcess() {
+    processPendingEntityData();
+}
+
+void OctreePacketProcessor::processPendingEntityData() {
+    if (_pendingEntityData.isEmpty()) {
+        return;
+    }
+    PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
+                            "OctreePacketProcessor::processPendingEntityData()");
+
+    // each decoder fills in its own slot, so the vector mustn't move while they're running
+    _decodedEntityData.resize(_pendingEntityData.size());
+    for (int i = 0; i < _pendingEntityData.size(); i++) {
+        _decodePool.start(new EntityDataDecoder(_pendingEntityData.at(i), &_decodedEntityData[i]));
+    }
+    _decodePool.waitForDone();
+    _pendingEntityData.clear();
+
+    EntityTreeRenderer* entities = Application::getInstance()->getEntities();
+    for (int start = 0; start < _decodedEntityData.size(); start += MAX_ENTITY_DATA_PER_WRITE_LOCK) {
+        entities->applyDecodedPackets(_decodedEntityData.mid(start, MAX_ENTITY_DATA_PER_WRITE_LOCK));
+    }
+    _decodedEntityData.clear();
+}
@@ -12,10 +12,17 @@
 #ifndef hifi_OctreePacketProcessor_h
 #define hifi_OctreePacketProcessor_h
 
+#include <QtCore/QThreadPool>
+
+#include <OctreeRenderer.h>
 #include <ReceivedPacketProcessor.h>
 
 /// Handles processing of incoming voxel packets for the interface application. As with other ReceivedPacketProcessor classes 
 /// the user is responsible for reading inbound packets and adding them to the processing queue by calling queueReceivedPacket()
+///
+/// The entity data packets are held back as they're taken from the queue, and decompressed a batch at a time across
+/// the decode pool, then read into the tree in order, a few at a time under each write lock so that the render can get
+/// at the tree between them.
 class OctreePacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 
@@ -24,5 +31,14 @@ signals:
 
 protected:
     virtual void processPacket(const SharedNodePointer& sendingNode, const QByteArray& packet);
+    virtual void midProcess();
+    virtual void postProcess();
+
+private:
+    void processPendingEntityData();
+
+    QThreadPool _decodePool;
+    QVector<NetworkPacket> _pendingEntityData;
+    QVector<DecodedOctreePacket> _decodedEntityData;
 };
 #endif // hifi_OctreePacketProcessor_h
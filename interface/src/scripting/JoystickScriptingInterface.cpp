@@ -102,7 +102,7 @@ Joystick* JoystickScriptingInterface::joystickWithName(const QString& name) {
 void JoystickScriptingInterface::update() {
 #ifdef HAVE_SDL2
     if (_isInitialized) {
-        PerformanceTimer perfTimer("JoystickScriptingInterface::update");
+        PERFORMANCE_TIMER("JoystickScriptingInterface::update");
         SDL_GameControllerUpdate();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
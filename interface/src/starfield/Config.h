@@ -37,9 +37,6 @@
 #include <ProgramObject.h>
 
 #include "AngleUtil.h"
-#include "Radix2InplaceSort.h"
-#include "Radix2IntegerScanner.h"
-#include "FloodFill.h"
 
 // Namespace configuration:
 
@@ -19,32 +19,20 @@ bool Controller::computeStars(unsigned numStars, unsigned seed) {
     QElapsedTimer startTime;
     startTime.start();
     
-    Generator::computeStarPositions(_inputSequence, numStars, seed);
-    
-    this->retile(numStars, _tileResolution);
-    
+    // the stars go to the GPU once and in any order, so their positions are only kept until then
+    InputVertices inputSequence;
+    Generator::computeStarPositions(inputSequence, numStars, seed);
+
+    delete _renderer;
+    _renderer = new Renderer(inputSequence, numStars);
+
     double NSEC_TO_MSEC = 1.0 / 1000000.0;
     double timeDiff = (double)startTime.nsecsElapsed() * NSEC_TO_MSEC;
-    qDebug() << "Total time to retile and generate stars: " << timeDiff << "msec";
+    qDebug() << "Total time to generate and upload stars: " << timeDiff << "msec";
     
     return true;
 }
 
-bool Controller::setResolution(unsigned tileResolution) {
-    if (tileResolution <= 3) {
-        return false;
-    }
-
-    if (tileResolution != _tileResolution) {
-
-        this->retile(_numStars, tileResolution);
-
-        return true;
-    } else {
-        return false;
-    }
-}
-
 void Controller::render(float perspective, float angle, mat4 const& orientation, float alpha) {
     Renderer* renderer = _renderer;
 
@@ -52,18 +40,3 @@ void Controller::render(float perspective, float angle, mat4 const& orientation,
         renderer->render(perspective, angle, orientation, alpha);
     }
 }
-
-void Controller::retile(unsigned numStars, unsigned tileResolution) {
-    Tiling tiling(tileResolution);
-    VertexOrder scanner(tiling);
-    radix2InplaceSort(_inputSequence.begin(), _inputSequence.end(), scanner);
-
-    recreateRenderer(numStars, tileResolution);
-
-    _tileResolution = tileResolution;
-}
-
-void Controller::recreateRenderer(unsigned numStars, unsigned tileResolution) {
-    delete _renderer;
-    _renderer = new Renderer(_inputSequence, numStars, tileResolution);
-}
@@ -18,26 +18,17 @@
 #include "starfield/Generator.h"
 #include "starfield/data/InputVertex.h"
 #include "starfield/renderer/Renderer.h"
-#include "starfield/renderer/VertexOrder.h"
 
 namespace starfield {
     class Controller {
     public:
-        Controller() : _tileResolution(20), _renderer(0l) { }
+        Controller() : _renderer(0l) { }
         
         ~Controller() { delete _renderer; }
         
         bool computeStars(unsigned numStars, unsigned seed);
-        bool setResolution(unsigned tileResolution);
         void render(float perspective, float angle, mat4 const& orientation, float alpha);
     private:
-        void retile(unsigned numStars, unsigned tileResolution);
-
-        void recreateRenderer(unsigned numStars, unsigned tileResolution);
-
-        InputVertices _inputSequence;
-        unsigned _tileResolution;
-        unsigned _numStars;
         Renderer* _renderer;
     };
 }
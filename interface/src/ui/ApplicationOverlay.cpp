@@ -16,6 +16,7 @@
 #include <avatar/AvatarManager.h>
 #include <PathUtils.h>
 #include <PerfStat.h>
+#include <SettingHandle.h>
 
 #include "AudioClient.h"
 #include "audio/AudioIOStatsRenderer.h"
@@ -43,6 +44,8 @@ const float reticleSize = TWO_PI / 100.0f;
 const float CONNECTION_STATUS_BORDER_COLOR[] = { 1.0f, 0.0f, 0.0f };
 const float CONNECTION_STATUS_BORDER_LINE_WIDTH = 4.0f;
 
+Setting::Handle<float> panelsUpdateRate("overlayPanelsUpdateRate", DEFAULT_PANELS_UPDATE_RATE);
+
 static const float MOUSE_PITCH_RANGE = 1.0f * PI;
 static const float MOUSE_YAW_RANGE = 0.5f * TWO_PI;
 
@@ -144,7 +147,10 @@ ApplicationOverlay::ApplicationOverlay() :
     _previousMagnifierBottomLeft(),
     _previousMagnifierBottomRight(),
     _previousMagnifierTopLeft(),
-    _previousMagnifierTopRight()
+    _previousMagnifierTopRight(),
+    _panelsFramebufferObject(NULL),
+    _lastPanelsUpdate(0),
+    _panelsUpdateRate(panelsUpdateRate.get())
 {
     memset(_reticleActive, 0, sizeof(_reticleActive));
     memset(_magActive, 0, sizeof(_reticleActive));
@@ -163,6 +169,12 @@ ApplicationOverlay::ApplicationOverlay() :
 }
 
 ApplicationOverlay::~ApplicationOverlay() {
+    delete _panelsFramebufferObject;
+}
+
+void ApplicationOverlay::setPanelsUpdateRate(float rate) {
+    _panelsUpdateRate = rate;
+    panelsUpdateRate.set(rate);
 }
 
 // Renders the overlays either to a texture or to the screen
@@ -187,6 +199,9 @@ void ApplicationOverlay::renderOverlay(bool renderToTexture) {
         }
     }
 
+    // bring the cached panels up to date before we bind the overlay's framebuffer, since they have one of their own
+    updatePanels();
+
     // Render 2D overlay
     glMatrixMode(GL_PROJECTION);
     glDisable(GL_DEPTH_TEST);
@@ -209,7 +224,7 @@ void ApplicationOverlay::renderOverlay(bool renderToTexture) {
 
         renderAudioMeter();
 
-        renderStatsAndLogs();
+        renderPanels();
 
         // give external parties a change to hook in
         emit qApp->renderingOverlay();
@@ -839,9 +854,6 @@ void ApplicationOverlay::renderAudioMeter() {
     }
 
     DependencyManager::get<AudioToolBox>()->render(MIRROR_VIEW_LEFT_PADDING + AUDIO_METER_GAP, audioMeterY, boxed);
-    
-    DependencyManager::get<AudioScope>()->render(glCanvas->width(), glCanvas->height());
-    DependencyManager::get<AudioIOStatsRenderer>()->render(WHITE_TEXT, glCanvas->width(), glCanvas->height());
 
     audioMeterY += AUDIO_METER_HEIGHT;
 
@@ -902,12 +914,14 @@ void ApplicationOverlay::renderStatsAndLogs() {
     
     auto glCanvas = DependencyManager::get<GLCanvas>();
     const OctreePacketProcessor& octreePacketProcessor = application->getOctreePacketProcessor();
-    NodeBounds& nodeBoundsDisplay = application->getNodeBoundsDisplay();
 
     //  Display stats and log text onscreen
     glLineWidth(1.0f);
     glPointSize(1.0f);
 
+    DependencyManager::get<AudioScope>()->render(glCanvas->width(), glCanvas->height());
+    DependencyManager::get<AudioIOStatsRenderer>()->render(WHITE_TEXT, glCanvas->width(), glCanvas->height());
+
     if (Menu::getInstance()->isOptionChecked(MenuOption::Stats)) {
         // let's set horizontal offset to give stats some margin to mirror
         int horizontalOffset = MIRROR_VIEW_WIDTH + MIRROR_VIEW_LEFT_PADDING * 2;
@@ -920,8 +934,74 @@ void ApplicationOverlay::renderStatsAndLogs() {
                                       bandwidthRecorder->getCachedTotalAverageOutputKilobitsPerSecond(),
                                       voxelPacketsToProcess);
     }
+}
+
+void ApplicationOverlay::updatePanels() {
+    auto glCanvas = DependencyManager::get<GLCanvas>();
+    QSize size = glCanvas->getDeviceSize();
+    quint64 now = usecTimestampNow();
+    bool resized = !_panelsFramebufferObject || _panelsFramebufferObject->size() != size;
+    if (!resized && _panelsUpdateRate > 0.0f && now - _lastPanelsUpdate < USECS_PER_SECOND / _panelsUpdateRate) {
+        return;
+    }
+    _lastPanelsUpdate = now;
+    if (resized) {
+        delete _panelsFramebufferObject;
+        _panelsFramebufferObject = new QOpenGLFramebufferObject(size);
+    }
+    PERFORMANCE_TIMER("updatePanels");
+    _panelsFramebufferObject->bind();
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // the panels' alpha goes into the cache along with their color, so that drawing it blends as they would have
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix(); {
+        const float NEAR_CLIP = -10000;
+        const float FAR_CLIP = 10000;
+        glLoadIdentity();
+        glOrtho(0, glCanvas->width(), glCanvas->height(), 0, NEAR_CLIP, FAR_CLIP);
+
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        renderStatsAndLogs();
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+    } glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    _panelsFramebufferObject->release();
+}
+
+void ApplicationOverlay::renderPanels() {
+    auto glCanvas = DependencyManager::get<GLCanvas>();
+
+    // the cache holds premultiplied color
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, _panelsFramebufferObject->texture());
+
+    glm::vec2 topLeft(0.0f, 0.0f);
+    glm::vec2 bottomRight(glCanvas->width(), glCanvas->height());
+    glm::vec2 texCoordTopLeft(0.0f, 1.0f);
+    glm::vec2 texCoordBottomRight(1.0f, 0.0f);
+    DependencyManager::get<GeometryCache>()->renderQuad(topLeft, bottomRight, texCoordTopLeft, texCoordBottomRight,
+                                                        glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    //  Show on-screen msec timer
+    //  Show on-screen msec timer, which like the node bounds under the mouse is drawn fresh each frame
     if (Menu::getInstance()->isOptionChecked(MenuOption::FrameTimer)) {
         quint64 mSecsNow = floor(usecTimestampNow() / 1000.0 + 0.5);
         QString frameTimer = QString("%1\n").arg((int)(mSecsNow % 1000));
@@ -931,7 +1011,7 @@ void ApplicationOverlay::renderStatsAndLogs() {
         drawText(glCanvas->width() - 100, glCanvas->height() - timerBottom,
             0.30f, 0.0f, 0, frameTimer.toUtf8().constData(), WHITE_TEXT);
     }
-    nodeBoundsDisplay.drawOverlay();
+    Application::getInstance()->getNodeBoundsDisplay().drawOverlay();
 }
 
 void ApplicationOverlay::renderDomainConnectionStatusBorder() {
@@ -22,6 +22,9 @@ const float MAGNIFY_MULT = 2.0f;
 
 const float DEFAULT_OCULUS_UI_ANGULAR_SIZE = 72.0f;
 
+// how many times a second the stats and audio panels are redrawn, in between which they're drawn from a cache
+const float DEFAULT_PANELS_UPDATE_RATE = 10.0f;
+
 // Handles the drawing of the overlays to the screen
 class ApplicationOverlay {
 public:
@@ -39,6 +42,9 @@ public:
     
     float getOculusUIAngularSize() const { return _oculusUIAngularSize; }
     void setOculusUIAngularSize(float oculusUIAngularSize) { _oculusUIAngularSize = oculusUIAngularSize; }
+
+    float getPanelsUpdateRate() const { return _panelsUpdateRate; }
+    void setPanelsUpdateRate(float panelsUpdateRate);
     
     // Converter from one frame of reference to another.
     // Frame of reference:
@@ -98,6 +104,9 @@ private:
     void renderStatsAndLogs();
     void renderDomainConnectionStatusBorder();
 
+    void updatePanels();
+    void renderPanels();
+
     TexturedHemisphere _overlays;
     
     float _textureFov;
@@ -132,6 +141,10 @@ private:
     glm::vec3 _previousMagnifierTopLeft;
     glm::vec3 _previousMagnifierTopRight;
 
+    // the stats and audio panels, which change a little at a time but cost the most of the overlay to draw
+    QOpenGLFramebufferObject* _panelsFramebufferObject;
+    quint64 _lastPanelsUpdate;
+    float _panelsUpdateRate;
 };
 
 #endif // hifi_ApplicationOverlay_h
@@ -11,11 +11,14 @@
 
 #include <QDoubleSpinBox>
 #include <QFormLayout>
+#include <QLabel>
 #include <QPushButton>
+#include <QTimer>
 
 #include <AnimationCache.h>
 #include <DependencyManager.h>
 #include <GeometryCache.h>
+#include <MemoryTracker.h>
 #include <ScriptCache.h>
 #include <SoundCache.h>
 #include <TextureCache.h>
@@ -45,9 +48,17 @@ CachesSizeDialog::CachesSizeDialog(QWidget* parent) :
     form->addRow("Scripts cache size (MB):", _scripts = createDoubleSpinBox(this));
     form->addRow("Sounds cache size (MB):", _sounds = createDoubleSpinBox(this));
     form->addRow("Textures cache size (MB):", _textures = createDoubleSpinBox(this));
+    form->addRow("Memory in use:", _memoryUsage = new QLabel(this));
     
     resetClicked(true);
     
+    // what the caches hold changes as they load, so it's kept up to date while the dialog is open
+    const int MEMORY_USAGE_UPDATE_INTERVAL_MSECS = 1000;
+    QTimer* memoryUsageTimer = new QTimer(this);
+    connect(memoryUsageTimer, SIGNAL(timeout()), this, SLOT(updateMemoryUsage()));
+    memoryUsageTimer->start(MEMORY_USAGE_UPDATE_INTERVAL_MSECS);
+    updateMemoryUsage();
+    
     // Add a button to reset
     QPushButton* confirmButton = new QPushButton("Confirm", this);
     QPushButton* resetButton = new QPushButton("Reset", this);
@@ -74,6 +85,21 @@ void CachesSizeDialog::resetClicked(bool checked) {
     _textures->setValue(DependencyManager::get<TextureCache>()->getUnusedResourceCacheSize() / BYTES_PER_MEGABYTES);
 }
 
+void CachesSizeDialog::updateMemoryUsage() {
+    QStringList lines;
+    foreach (MemoryCounter* counter, MemoryTracker::getInstance().getCounters()) {
+        if (!counter->getName().endsWith("Cache")) {
+            continue;
+        }
+        QString line = QString("%1: %2 MB").arg(counter->getName()).arg(counter->getCPUBytes() / BYTES_PER_MEGABYTES);
+        if (counter->getGPUBytes() > 0) {
+            line += QString(", %1 MB GPU").arg(counter->getGPUBytes() / BYTES_PER_MEGABYTES);
+        }
+        lines.append(line);
+    }
+    _memoryUsage->setText(lines.isEmpty() ? QString("nothing loaded") : lines.join("\n"));
+}
+
 void CachesSizeDialog::reject() {
     // Just regularly close upon ESC
     QDialog::close();
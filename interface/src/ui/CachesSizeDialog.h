@@ -15,6 +15,7 @@
 #include <QDialog>
 
 class QDoubleSpinBox;
+class QLabel;
 
 class CachesSizeDialog : public QDialog {
     Q_OBJECT
@@ -29,6 +30,7 @@ public slots:
     void reject();
     void confirmClicked(bool checked);
     void resetClicked(bool checked);
+    void updateMemoryUsage();
     
 protected:
     // Emits a 'closed' signal when this dialog is closed.
@@ -40,6 +42,7 @@ private:
     QDoubleSpinBox* _scripts = nullptr;
     QDoubleSpinBox* _sounds = nullptr;
     QDoubleSpinBox* _textures = nullptr;
+    QLabel* _memoryUsage = nullptr;
 };
 
 #endif // hifi_CachesSizeDialog_h
\ No newline at end of file
@@ -79,20 +79,17 @@ LodToolsDialog::LodToolsDialog(QWidget* parent) :
     _feedback->setFixedWidth(FEEDBACK_WIDTH);
     form->addRow("You can see... ", _feedback);
     
+    form->addRow("Target FPS:", _targetFPS = new QDoubleSpinBox(this));
+    const double MAX_TARGET_FPS = 240.0;
+    _targetFPS->setRange(1.0, MAX_TARGET_FPS);
+    _targetFPS->setDecimals(0);
+    _targetFPS->setValue(lodManager->getTargetFPS());
+    connect(_targetFPS, SIGNAL(valueChanged(double)), SLOT(targetFPSValueChanged(double)));
+    
     form->addRow("Automatic Avatar LOD Adjustment:", _automaticAvatarLOD = new QCheckBox(this));
     _automaticAvatarLOD->setChecked(lodManager->getAutomaticAvatarLOD());
     connect(_automaticAvatarLOD, SIGNAL(toggled(bool)), SLOT(updateAvatarLODControls()));
     
-    form->addRow("Decrease Avatar LOD Below FPS:", _avatarLODDecreaseFPS = new QDoubleSpinBox(this));
-    _avatarLODDecreaseFPS->setValue(lodManager->getAvatarLODDecreaseFPS());
-    _avatarLODDecreaseFPS->setDecimals(0);
-    connect(_avatarLODDecreaseFPS, SIGNAL(valueChanged(double)), SLOT(updateAvatarLODValues()));
-    
-    form->addRow("Increase Avatar LOD Above FPS:", _avatarLODIncreaseFPS = new QDoubleSpinBox(this));
-    _avatarLODIncreaseFPS->setValue(lodManager->getAvatarLODIncreaseFPS());
-    _avatarLODIncreaseFPS->setDecimals(0);
-    connect(_avatarLODIncreaseFPS, SIGNAL(valueChanged(double)), SLOT(updateAvatarLODValues()));
-    
     form->addRow("Avatar LOD:", _avatarLOD = new QDoubleSpinBox(this));
     _avatarLOD->setDecimals(3);
     _avatarLOD->setRange(1.0 / MAXIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER, 1.0 / MINIMUM_AVATAR_LOD_DISTANCE_MULTIPLIER);
@@ -123,12 +120,6 @@ void LodToolsDialog::updateAvatarLODControls() {
     auto lodManager = DependencyManager::get<LODManager>();
     lodManager->setAutomaticAvatarLOD(_automaticAvatarLOD->isChecked());
     
-    _avatarLODDecreaseFPS->setVisible(_automaticAvatarLOD->isChecked());
-    form->labelForField(_avatarLODDecreaseFPS)->setVisible(_automaticAvatarLOD->isChecked());
-    
-    _avatarLODIncreaseFPS->setVisible(_automaticAvatarLOD->isChecked());
-    form->labelForField(_avatarLODIncreaseFPS)->setVisible(_automaticAvatarLOD->isChecked());
-    
     _avatarLOD->setVisible(!_automaticAvatarLOD->isChecked());
     form->labelForField(_avatarLOD)->setVisible(!_automaticAvatarLOD->isChecked());
     
@@ -143,15 +134,15 @@ void LodToolsDialog::updateAvatarLODControls() {
 
 void LodToolsDialog::updateAvatarLODValues() {
     auto lodManager = DependencyManager::get<LODManager>();
-    if (_automaticAvatarLOD->isChecked()) {
-        lodManager->setAvatarLODDecreaseFPS(_avatarLODDecreaseFPS->value());
-        lodManager->setAvatarLODIncreaseFPS(_avatarLODIncreaseFPS->value());
-        
-    } else {
+    if (!_automaticAvatarLOD->isChecked()) {
         lodManager->setAvatarLODDistanceMultiplier(1.0 / _avatarLOD->value());
     }
 }
 
+void LodToolsDialog::targetFPSValueChanged(double value) {
+    DependencyManager::get<LODManager>()->setTargetFPS(value);
+}
+
 void LodToolsDialog::sizeScaleValueChanged(int value) {
     auto lodManager = DependencyManager::get<LODManager>();
     float realValue = value * TREE_SCALE;
@@ -172,8 +163,7 @@ void LodToolsDialog::resetClicked(bool checked) {
     _lodSize->setValue(sliderValue);
     _boundaryLevelAdjust->setValue(0);
     _automaticAvatarLOD->setChecked(true);
-    _avatarLODDecreaseFPS->setValue(DEFAULT_ADJUST_AVATAR_LOD_DOWN_FPS);
-    _avatarLODIncreaseFPS->setValue(ADJUST_LOD_UP_FPS);
+    _targetFPS->setValue(DEFAULT_LOD_TARGET_FPS);
 }
 
 void LodToolsDialog::reject() {
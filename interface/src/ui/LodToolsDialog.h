@@ -36,6 +36,7 @@ public slots:
     void reloadSliders();
     void updateAvatarLODControls();
     void updateAvatarLODValues();
+    void targetFPSValueChanged(double value);
 
 protected:
 
@@ -45,9 +46,8 @@ protected:
 private:
     QSlider* _lodSize;
     QSlider* _boundaryLevelAdjust;
+    QDoubleSpinBox* _targetFPS;
     QCheckBox* _automaticAvatarLOD;
-    QDoubleSpinBox* _avatarLODDecreaseFPS;
-    QDoubleSpinBox* _avatarLODIncreaseFPS;
     QDoubleSpinBox* _avatarLOD;
     QLabel* _feedback;
 };
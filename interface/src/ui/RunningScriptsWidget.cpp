@@ -21,7 +21,9 @@
 #include <QTableWidgetItem>
 #include <QWindow>
 
+#include <EntityTreeRenderer.h>
 #include <PathUtils.h>
+#include <ScriptEngine.h>
 
 #include "Application.h"
 #include "Menu.h"
@@ -34,7 +36,8 @@ RunningScriptsWidget::RunningScriptsWidget(QWidget* parent) :
     ui(new Ui::RunningScriptsWidget),
     _signalMapper(this),
     _scriptsModelFilter(this),
-    _scriptsModel(this) {
+    _scriptsModel(this),
+    _entityScriptsProfileLabel(NULL) {
     ui->setupUi(this);
 
     setAttribute(Qt::WA_DeleteOnClose, false);
@@ -64,6 +67,10 @@ RunningScriptsWidget::RunningScriptsWidget(QWidget* parent) :
     connect(ui->loadScriptFromURLButton, &QPushButton::clicked,
             Application::getInstance(), &Application::loadScriptURLDialog);
     connect(&_signalMapper, SIGNAL(mapped(QString)), Application::getInstance(), SLOT(stopScript(const QString&)));
+
+    const int PROFILE_UPDATE_INTERVAL_MSECS = 1000;
+    connect(&_profileTimer, &QTimer::timeout, this, &RunningScriptsWidget::updateProfiles);
+    _profileTimer.start(PROFILE_UPDATE_INTERVAL_MSECS);
 }
 
 RunningScriptsWidget::~RunningScriptsWidget() {
@@ -96,6 +103,8 @@ void RunningScriptsWidget::setRunningScripts(const QStringList& list) {
         delete widget->widget();
         delete widget;
     }
+    _profileLabels.clear();
+    _entityScriptsProfileLabel = NULL;
     QHash<QString, int> hash;
     const int CLOSE_ICON_HEIGHT = 12;
     for (int i = 0; i < list.size(); i++) {
@@ -127,7 +136,12 @@ void RunningScriptsWidget::setRunningScripts(const QStringList& list) {
         row->layout()->setContentsMargins(4, 4, 4, 4);
         row->layout()->setSpacing(0);
 
+        QLabel* profile = new QLabel(row);
+        profile->setStyleSheet("color: #8A8A8A;");
+        _profileLabels.append(qMakePair(profile, list.at(i)));
+
         row->layout()->addWidget(name);
+        row->layout()->addWidget(profile);
         row->layout()->addWidget(closeButton);
 
         row->setToolTip(url.toString());
@@ -140,6 +154,20 @@ void RunningScriptsWidget::setRunningScripts(const QStringList& list) {
         ui->scriptListWidget->layout()->addWidget(line);
     }
 
+    // the entity scripts all run in the one engine, which profiles their callbacks by script
+    if (Application::getInstance()->getEntities()->getEntityScriptProfile()) {
+        QWidget* row = new QWidget(ui->scriptListWidget);
+        row->setLayout(new QHBoxLayout(row));
+        row->layout()->setContentsMargins(4, 4, 4, 4);
+        row->layout()->setSpacing(0);
+        row->layout()->addWidget(new QLabel("Entity scripts", row));
+        _entityScriptsProfileLabel = new QLabel(row);
+        _entityScriptsProfileLabel->setStyleSheet("color: #8A8A8A;");
+        row->layout()->addWidget(_entityScriptsProfileLabel);
+        ui->scriptListWidget->layout()->addWidget(row);
+    }
+    updateProfiles();
+
 
     ui->noRunningScriptsLabel->setVisible(list.isEmpty());
     ui->reloadAllButton->setVisible(!list.isEmpty());
@@ -167,6 +195,25 @@ void RunningScriptsWidget::showEvent(QShowEvent* event) {
     QWidget::showEvent(event);
 }
 
+void RunningScriptsWidget::updateProfiles() {
+    if (!isVisible()) {
+        return;
+    }
+    // each shows the share of the time since the script started that it has spent in its busiest callbacks
+    for (int i = 0; i < _profileLabels.size(); i++) {
+        ScriptEngine* scriptEngine = Application::getInstance()->getScriptEngine(_profileLabels.at(i).second);
+        if (scriptEngine) {
+            _profileLabels.at(i).first->setText(scriptEngine->getProfile().getSummary(1));
+            _profileLabels.at(i).first->setToolTip(scriptEngine->getProfile().getSummary());
+        }
+    }
+    const ScriptProfile* entityScriptProfile = Application::getInstance()->getEntities()->getEntityScriptProfile();
+    if (_entityScriptsProfileLabel && entityScriptProfile) {
+        _entityScriptsProfileLabel->setText(entityScriptProfile->getSummary(1));
+        _entityScriptsProfileLabel->setToolTip(entityScriptProfile->getSummary());
+    }
+}
+
 void RunningScriptsWidget::selectFirstInList() {
     if (_scriptsModelFilter.rowCount() > 0) {
         ui->scriptTreeView->setCurrentIndex(_scriptsModelFilter.index(0, 0));
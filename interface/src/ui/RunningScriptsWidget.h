@@ -16,6 +16,7 @@
 #include <QFileSystemModel>
 #include <QSignalMapper>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 
 #include "ScriptsModel.h"
 #include "ScriptsModelFilter.h"
@@ -25,6 +26,9 @@ namespace Ui {
     class RunningScriptsWidget;
 }
 
+class QLabel;
+class ScriptProfile;
+
 class RunningScriptsWidget : public QWidget {
     Q_OBJECT
 public:
@@ -51,6 +55,7 @@ private slots:
     void loadScriptFromList(const QModelIndex& index);
     void loadSelectedScript();
     void selectFirstInList();
+    void updateProfiles();
 
 private:
     Ui::RunningScriptsWidget* ui;
@@ -60,6 +65,11 @@ private:
     ScriptsTableWidget* _recentlyLoadedScriptsTable;
     QStringList _recentlyLoadedScripts;
     QString _lastStoppedScript;
+
+    /// the labels showing each running script's profile, with the script each is for
+    QList<QPair<QLabel*, QString> > _profileLabels;
+    QLabel* _entityScriptsProfileLabel;
+    QTimer _profileTimer;
 };
 
 #endif // hifi_RunningScriptsWidget_h
@@ -23,7 +23,9 @@
 #include <GeometryCache.h>
 #include <GLCanvas.h>
 #include <LODManager.h>
+#include <MemoryTracker.h>
 #include <PerfStat.h>
+#include <gpu/GLBackend.h>
 
 #include "Stats.h"
 #include "BandwidthRecorder.h"
@@ -42,6 +44,8 @@ const int STATS_PING_MIN_WIDTH = 190;
 const int STATS_GEO_MIN_WIDTH = 240;
 const int STATS_OCTREE_MIN_WIDTH = 410;
 
+const int BYTES_PER_KILOBYTE = 1024;
+
 Stats* Stats::getInstance() {
     static Stats stats;
     return &stats;
@@ -494,7 +498,7 @@ void Stats::display(
     verticalOffset = 0;
     horizontalOffset = _lastHorizontalOffset + _generalStatsWidth + _bandwidthStatsWidth + _pingStatsWidth + _geoStatsWidth + 3;
 
-    lines = _expanded ? 14 : 3;
+    lines = _expanded ? 18 : 3;
 
     drawBackground(backgroundColor, horizontalOffset, 0, glCanvas->width() - horizontalOffset,
         lines * STATS_PELS_PER_LINE + 10);
@@ -529,6 +533,42 @@ void Stats::display(
                     << " / Translucent:" << entities->getTranslucentMeshPartsRendered();
         verticalOffset += STATS_PELS_PER_LINE;
         drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)octreeStats.str().c_str(), color);
+
+        const gpu::GLBackend::Stats& gpuStats = gpu::GLBackend::getStats();
+        octreeStats.str("");
+        octreeStats << "  GPU draws: " << gpuStats._draws
+                    << " / State changes:" << gpuStats._stateChanges
+                    << " / Redundant:" << gpuStats._redundantStateChanges
+                    << " / Uploads:" << (gpuStats._bufferUploads + gpuStats._textureUploads)
+                    << " (" << gpuStats._bytesUploaded / BYTES_PER_KILOBYTE << " KB)"
+                    << " / Textures:" << gpu::GLBackend::getTextureMemory() / (BYTES_PER_KILOBYTE * BYTES_PER_KILOBYTE)
+                    << " MB";
+        verticalOffset += STATS_PELS_PER_LINE;
+        drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)octreeStats.str().c_str(), color);
+
+        PhysicsEngine* physicsEngine = Application::getInstance()->getPhysicsEngine();
+        octreeStats.str("");
+        octreeStats << "  Physics substep: " << (int)physicsEngine->getAverageSubstepUsecs() << " usecs"
+                    << " / Solving:" << (int)physicsEngine->getAverageSolveUsecs() << " usecs"
+                    << " on " << physicsEngine->getNumSolverThreads() << " thread(s)";
+        verticalOffset += STATS_PELS_PER_LINE;
+        drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)octreeStats.str().c_str(), color);
+
+        MemoryTracker& memoryTracker = MemoryTracker::getInstance();
+        octreeStats.str("");
+        octreeStats << "  Tracked memory: " << memoryTracker.getTotalCPUBytes() / BYTES_PER_MEGABYTES << " MB"
+                    << " / GPU:" << memoryTracker.getTotalGPUBytes() / BYTES_PER_MEGABYTES << " MB";
+        verticalOffset += STATS_PELS_PER_LINE;
+        drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)octreeStats.str().c_str(), color);
+
+        octreeStats.str("");
+        octreeStats << " ";
+        foreach (MemoryCounter* counter, memoryTracker.getCounters()) {
+            octreeStats << " " << qPrintable(counter->getName()) << ": "
+                        << (counter->getCPUBytes() + counter->getGPUBytes()) / BYTES_PER_MEGABYTES << " MB";
+        }
+        verticalOffset += STATS_PELS_PER_LINE;
+        drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)octreeStats.str().c_str(), color);
     }
 
     // iterate all the current voxel stats, and list their sending modes, and total voxel counts
@@ -64,8 +64,12 @@ AnimationReader::AnimationReader(const QWeakPointer<Resource>& animation, QNetwo
 void AnimationReader::run() {
     QSharedPointer<Resource> animation = _animation.toStrongRef();
     if (!animation.isNull()) {
+        // compress the frames here rather than on the main thread, and keep only the compressed copy
+        FBXGeometry geometry = readFBX(_reply->readAll(), QVariantHash());
+        AnimationClipPointer clip(new AnimationClip(geometry.animationFrames));
+        geometry.animationFrames.clear();
         QMetaObject::invokeMethod(animation.data(), "setGeometry",
-            Q_ARG(const FBXGeometry&, readFBX(_reply->readAll(), QVariantHash())));
+            Q_ARG(const FBXGeometry&, geometry), Q_ARG(const AnimationClipPointer&, clip));
     }
     _reply->deleteLater();
 }
@@ -91,11 +95,22 @@ QVector<FBXAnimationFrame> Animation::getFrames() const {
             Q_RETURN_ARG(QVector<FBXAnimationFrame>, result));
         return result;
     }
-    return _geometry.animationFrames;
+    return _clip ? _clip->getFrames() : QVector<FBXAnimationFrame>();
 }
 
-void Animation::setGeometry(const FBXGeometry& geometry) {
+AnimationClipPointer Animation::getClip() const {
+    if (QThread::currentThread() != thread()) {
+        AnimationClipPointer result;
+        QMetaObject::invokeMethod(const_cast<Animation*>(this), "getClip", Qt::BlockingQueuedConnection,
+            Q_RETURN_ARG(AnimationClipPointer, result));
+        return result;
+    }
+    return _clip;
+}
+
+void Animation::setGeometry(const FBXGeometry& geometry, const AnimationClipPointer& clip) {
     _geometry = geometry;
+    _clip = clip;
     finishedLoading(true);
     _isValid = true;
 }
@@ -19,6 +19,8 @@
 #include <FBXReader.h>
 #include <ResourceCache.h>
 
+#include "AnimationClip.h"
+
 class Animation;
 
 typedef QSharedPointer<Animation> AnimationPointer;
@@ -52,23 +54,30 @@ public:
 
     Animation(const QUrl& url);
 
+    /// Returns the geometry of the animation's document.  Its frames are moved into the clip once it loads.
     const FBXGeometry& getGeometry() const { return _geometry; }
     
     Q_INVOKABLE QStringList getJointNames() const;
     
+    /// Decompresses the frames of the clip, for scripts.
     Q_INVOKABLE QVector<FBXAnimationFrame> getFrames() const;
 
+    /// Returns the compressed clip, which is shared by everything playing the animation and may be sampled from any
+    /// thread.  Null until the animation has loaded.
+    Q_INVOKABLE AnimationClipPointer getClip() const;
+
     bool isValid() const { return _isValid; }
     
 protected:
 
-    Q_INVOKABLE void setGeometry(const FBXGeometry& geometry);
+    Q_INVOKABLE void setGeometry(const FBXGeometry& geometry, const AnimationClipPointer& clip);
     
     virtual void downloadFinished(QNetworkReply* reply);
 
 private:
     
     FBXGeometry _geometry;
+    AnimationClipPointer _clip;
     bool _isValid;
 };
 
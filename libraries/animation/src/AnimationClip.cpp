@@ -0,0 +1,187 @@
+//
+//  AnimationClip.cpp
+//  libraries/animation/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <QtAlgorithms>
+#include <QtDebug>
+
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+#include "AnimationClip.h"
+
+static int animationClipPointerMetaTypeId = qRegisterMetaType<AnimationClipPointer>();
+
+const float AnimationClip::MAX_KEY_ERROR = 0.25f * RADIANS_PER_DEGREE;
+
+// a kept key is never more than this many frames from the last, which bounds the work of checking the frames between
+const int MAX_KEY_SPAN = 64;
+
+const int MAX_FRAME_COUNT = 65536;
+
+// the three smallest components of a unit quaternion lie within +/- 1/sqrt(2), and get 15 bits each; the top bits of
+// the first two words hold the index of the largest, which is made positive and rebuilt from the others
+const int ROTATION_WORDS = 3;
+const float SMALLEST_COMPONENT_RANGE = 1.0f / sqrtf(2.0f);
+const float COMPONENT_QUANTUM_MAX = 32767.0f;
+const quint16 COMPONENT_MASK = 0x7FFF;
+const quint16 LARGEST_INDEX_BIT = 0x8000;
+
+static void packRotation(const glm::quat& rotation, quint16* words) {
+    float components[] = { rotation.x, rotation.y, rotation.z, rotation.w };
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largest])) {
+            largest = i;
+        }
+    }
+    float sign = (components[largest] < 0.0f) ? -1.0f : 1.0f;
+    for (int i = 0, word = 0; i < 4; i++) {
+        if (i != largest) {
+            float unit = glm::clamp(sign * components[i] / SMALLEST_COMPONENT_RANGE * 0.5f + 0.5f, 0.0f, 1.0f);
+            words[word++] = (quint16)(unit * COMPONENT_QUANTUM_MAX + 0.5f);
+        }
+    }
+    words[0] |= (largest & 2) ? LARGEST_INDEX_BIT : 0;
+    words[1] |= (largest & 1) ? LARGEST_INDEX_BIT : 0;
+}
+
+static glm::quat unpackRotation(const quint16* words) {
+    int largest = ((words[0] & LARGEST_INDEX_BIT) ? 2 : 0) | ((words[1] & LARGEST_INDEX_BIT) ? 1 : 0);
+    float components[4];
+    float sumOfSquares = 0.0f;
+    for (int i = 0, word = 0; i < 4; i++) {
+        if (i != largest) {
+            float unit = (words[word++] & COMPONENT_MASK) / COMPONENT_QUANTUM_MAX;
+            components[i] = (unit * 2.0f - 1.0f) * SMALLEST_COMPONENT_RANGE;
+            sumOfSquares += components[i] * components[i];
+        }
+    }
+    components[largest] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+static glm::quat quantizeRotation(const glm::quat& rotation) {
+    quint16 words[ROTATION_WORDS];
+    packRotation(rotation, words);
+    return unpackRotation(words);
+}
+
+static bool isWithinError(const glm::quat& approximation, const glm::quat& rotation, float minimumDot) {
+    return fabsf(glm::dot(approximation, rotation)) >= minimumDot;
+}
+
+static glm::quat getRotation(const QVector<FBXAnimationFrame>& frames, int frame, int joint) {
+    const QVector<glm::quat>& rotations = frames.at(frame).rotations;
+    return joint < rotations.size() ? rotations.at(joint) : glm::quat();
+}
+
+AnimationClip::AnimationClip(const QVector<FBXAnimationFrame>& frames) :
+    _frameCount(qMin(frames.size(), MAX_FRAME_COUNT)) {
+
+    if (frames.size() > MAX_FRAME_COUNT) {
+        qWarning() << "Animation has" << frames.size() << "frames, keeping the first" << MAX_FRAME_COUNT;
+    }
+    int jointCount = 0;
+    for (int i = 0; i < _frameCount; i++) {
+        jointCount = qMax(jointCount, frames.at(i).rotations.size());
+    }
+
+    // comparing half angles, since that's what the dot product of two quaternions measures
+    const float MIN_KEY_DOT = cosf(MAX_KEY_ERROR * 0.5f);
+
+    _trackOffsets.append(0);
+    for (int joint = 0; joint < jointCount; joint++) {
+        // a joint that holds still throughout needs only the one key
+        glm::quat first = quantizeRotation(getRotation(frames, 0, joint));
+        bool constant = true;
+        for (int frame = 1; frame < _frameCount && constant; frame++) {
+            constant = isWithinError(first, getRotation(frames, frame, joint), MIN_KEY_DOT);
+        }
+        appendKey(0, getRotation(frames, 0, joint));
+
+        if (!constant) {
+            // keep each frame that the span from the last key to the frame after it can't do without
+            int anchor = 0;
+            glm::quat anchorRotation = first;
+            for (int frame = 1; frame < _frameCount - 1; frame++) {
+                int next = frame + 1;
+                glm::quat nextRotation = quantizeRotation(getRotation(frames, next, joint));
+                bool keep = (next - anchor > MAX_KEY_SPAN);
+                for (int between = anchor + 1; between < next && !keep; between++) {
+                    float proportion = (float)(between - anchor) / (next - anchor);
+                    keep = !isWithinError(safeMix(anchorRotation, nextRotation, proportion),
+                        getRotation(frames, between, joint), MIN_KEY_DOT);
+                }
+                if (keep) {
+                    appendKey(frame, getRotation(frames, frame, joint));
+                    anchor = frame;
+                    anchorRotation = getKeyRotation(_keyFrames.size() - 1);
+                }
+            }
+            appendKey(_frameCount - 1, getRotation(frames, _frameCount - 1, joint));
+        }
+        _trackOffsets.append(_keyFrames.size());
+    }
+}
+
+glm::quat AnimationClip::sampleFrame(int joint, int frame, int& cursor) const {
+    int offset = _trackOffsets.at(joint);
+    int keyCount = _trackOffsets.at(joint + 1) - offset;
+    const quint16* keyFrames = _keyFrames.constData() + offset;
+
+    // step forward from the last key when we can, and search only when the frame has gone back or skipped ahead
+    if (cursor < 0 || cursor >= keyCount || keyFrames[cursor] > frame) {
+        cursor = qMax(0, (int)(qUpperBound(keyFrames, keyFrames + keyCount, (quint16)frame) - keyFrames) - 1);
+    } else {
+        while (cursor + 1 < keyCount && keyFrames[cursor + 1] <= frame) {
+            cursor++;
+        }
+    }
+    if (cursor + 1 >= keyCount) {
+        return getKeyRotation(offset + cursor);
+    }
+    float proportion = (float)(frame - keyFrames[cursor]) / (keyFrames[cursor + 1] - keyFrames[cursor]);
+    return safeMix(getKeyRotation(offset + cursor), getKeyRotation(offset + cursor + 1), proportion);
+}
+
+glm::quat AnimationClip::sample(int joint, float frameIndex, int& cursor) const {
+    glm::quat floorRotation = sampleFrame(joint, (int)glm::floor(frameIndex) % _frameCount, cursor);
+    float frameFraction = glm::fract(frameIndex);
+    if (frameFraction == 0.0f) {
+        return floorRotation;
+    }
+    glm::quat ceilRotation = sampleFrame(joint, (int)glm::ceil(frameIndex) % _frameCount, cursor);
+    return safeMix(floorRotation, ceilRotation, frameFraction);
+}
+
+QVector<FBXAnimationFrame> AnimationClip::getFrames() const {
+    QVector<FBXAnimationFrame> frames(_frameCount);
+    int jointCount = getJointCount();
+    for (int joint = 0; joint < jointCount; joint++) {
+        int cursor = 0;
+        for (int frame = 0; frame < _frameCount; frame++) {
+            frames[frame].rotations.append(sampleFrame(joint, frame, cursor));
+        }
+    }
+    return frames;
+}
+
+void AnimationClip::appendKey(int frame, const glm::quat& rotation) {
+    _keyFrames.append((quint16)frame);
+    int start = _keyRotations.size();
+    _keyRotations.resize(start + ROTATION_WORDS);
+    packRotation(rotation, _keyRotations.data() + start);
+}
+
+glm::quat AnimationClip::getKeyRotation(int key) const {
+    return unpackRotation(_keyRotations.constData() + key * ROTATION_WORDS);
+}
@@ -0,0 +1,65 @@
+//
+//  AnimationClip.h
+//  libraries/animation/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimationClip_h
+#define hifi_AnimationClip_h
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <FBXReader.h>
+
+/// The joint rotations of an animation, compressed for playback.  Each joint keeps only the frames that interpolating
+/// between its neighbors can't reproduce to within a fraction of a degree, and each kept rotation is quantized to the
+/// three smallest of its components in six bytes.
+class AnimationClip {
+public:
+
+    /// The largest angle, in radians, that a dropped frame may be off from the interpolation of its neighbors.
+    static const float MAX_KEY_ERROR;
+
+    AnimationClip(const QVector<FBXAnimationFrame>& frames = QVector<FBXAnimationFrame>());
+
+    int getFrameCount() const { return _frameCount; }
+    int getJointCount() const { return _trackOffsets.size() - 1; }
+
+    /// Returns the number of keys kept for all joints.
+    int getKeyCount() const { return _keyFrames.size(); }
+
+    /// Returns the rotation of a joint at a whole frame.
+    /// \param cursor the key the joint's last sample was found at, which playing forward finds the next keys from
+    /// without a search; start it at zero
+    glm::quat sampleFrame(int joint, int frame, int& cursor) const;
+
+    /// Returns the rotation of a joint at a fractional frame, blending the last frame into the first.
+    glm::quat sample(int joint, float frameIndex, int& cursor) const;
+
+    /// Decompresses the whole clip.
+    QVector<FBXAnimationFrame> getFrames() const;
+
+private:
+
+    void appendKey(int frame, const glm::quat& rotation);
+    glm::quat getKeyRotation(int key) const;
+
+    int _frameCount;
+    QVector<int> _trackOffsets;
+    QVector<quint16> _keyFrames;
+    QVector<quint16> _keyRotations;
+};
+
+typedef QSharedPointer<AnimationClip> AnimationClipPointer;
+
+Q_DECLARE_METATYPE(AnimationClipPointer)
+
+#endif // hifi_AnimationClip_h
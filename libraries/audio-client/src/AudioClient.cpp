@@ -55,6 +55,8 @@ Setting::Handle<int> maxFramesOverDesired("maxFramesOverDesired", DEFAULT_MAX_FR
 Setting::Handle<int> staticDesiredJitterBufferFrames("staticDesiredJitterBufferFrames",
                                                      DEFAULT_STATIC_DESIRED_JITTER_BUFFER_FRAMES);
 Setting::Handle<bool> useStDevForJitterCalc("useStDevForJitterCalc", DEFAULT_USE_STDEV_FOR_JITTER_CALC);
+Setting::Handle<bool> usePercentileForJitterCalc("usePercentileForJitterCalc", DEFAULT_USE_PERCENTILE_FOR_JITTER_CALC);
+Setting::Handle<float> targetLateLossRate("targetLateLossRate", DEFAULT_TARGET_LATE_LOSS_RATE);
 Setting::Handle<int> windowStarveThreshold("windowStarveThreshold", DEFAULT_WINDOW_STARVE_THRESHOLD);
 Setting::Handle<int> windowSecondsForDesiredCalcOnTooManyStarves("windowSecondsForDesiredCalcOnTooManyStarves",
                                                                  DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES);
@@ -94,6 +96,8 @@ AudioClient::AudioClient() :
                                      DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_PERIOD),
     _outputStarveDetectionThreshold("audioOutputStarveDetectionThreshold",
                                     DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_THRESHOLD),
+    _audioCompressionEnabled("audioCompressionEnabled", DEFAULT_AUDIO_COMPRESSION_ENABLED),
+    _inputAudioEncoder(AudioConstants::MONO),
     _averagedLatency(0.0f),
     _lastInputLoudness(0.0f),
     _timeSinceLastClip(-1.0f),
@@ -112,6 +116,7 @@ AudioClient::AudioClient() :
     _noiseSourceEnabled(false),
     _toneSourceEnabled(true),
     _outgoingAvatarAudioSequenceNumber(0),
+    _numConsecutiveSilentFrames(0),
     _audioOutputIODevice(_receivedAudioStream, this),
     _stats(&_receivedAudioStream),
     _inputGate()
@@ -119,6 +124,9 @@ AudioClient::AudioClient() :
     // clear the array of locally injected samples
     memset(_localProceduralSamples, 0, AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
     
+    // mixed audio is parsed on the network thread and popped by the audio output callback
+    _receivedAudioStream.setIsLockFree(true);
+    
     connect(&_receivedAudioStream, &MixedProcessedAudioStream::processSamples,
             this, &AudioClient::processReceivedSamples, Qt::DirectConnection);
     
@@ -155,6 +163,7 @@ void AudioClient::reset() {
 
 void AudioClient::audioMixerKilled() {
     _outgoingAvatarAudioSequenceNumber = 0;
+    _numConsecutiveSilentFrames = 0;
     _stats.reset();
 }
 
@@ -372,6 +381,9 @@ bool sampleChannelConversion(const int16_t* sourceSamples, int16_t* destinationS
     return false;
 }
 
+// enough for a network frame at 48kHz on up to 8 channels
+const int MAX_STACK_CHANNEL_CONVERSION_SAMPLES = 2 * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * 8;
+
 soxr_error_t possibleResampling(soxr_t resampler,
                                 const int16_t* sourceSamples, int16_t* destinationSamples,
                                 unsigned int numSourceSamples, unsigned int numDestinationSamples,
@@ -393,20 +405,23 @@ soxr_error_t possibleResampling(soxr_t resampler,
                 float channelCountRatio = (float) destinationAudioFormat.channelCount() / sourceAudioFormat.channelCount();
                 
                 int numChannelCoversionSamples = (int) (numSourceSamples * channelCountRatio);
-                int16_t* channelConversionSamples = new int16_t[numChannelCoversionSamples];
+                
+                // this runs for every input and output callback, so the conversion goes on the stack unless it won't fit
+                int16_t stackConversionSamples[MAX_STACK_CHANNEL_CONVERSION_SAMPLES];
+                int16_t* channelConversionSamples = (numChannelCoversionSamples <= MAX_STACK_CHANNEL_CONVERSION_SAMPLES)
+                    ? stackConversionSamples : new int16_t[numChannelCoversionSamples];
                 
                 sampleChannelConversion(sourceSamples, channelConversionSamples,
                                         numSourceSamples,
                                         sourceAudioFormat, destinationAudioFormat);
                 
-                qDebug() << "resample from" << sourceAudioFormat << "to" << destinationAudioFormat
-                    << "from" << numChannelCoversionSamples << "to" << numDestinationSamples;
-                
                 resampleError = soxr_process(resampler,
                                              channelConversionSamples, numChannelCoversionSamples, NULL,
                                              destinationSamples, numDestinationSamples, NULL);
                 
-                delete[] channelConversionSamples;
+                if (channelConversionSamples != stackConversionSamples) {
+                    delete[] channelConversionSamples;
+                }
             } else {
                 resampleError = soxr_process(resampler,
                                              sourceSamples, numSourceSamples, NULL,
@@ -695,14 +710,29 @@ void AudioClient::handleAudioInput() {
     // NOTE: we assume PacketTypeMicrophoneAudioWithEcho has same size headers as
     // PacketTypeMicrophoneAudioNoEcho.  If not, then networkAudioSamples will be pointing to the wrong place for writing
     // audio samples with echo.
-    static int leadingBytes = numBytesPacketHeader + sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(quint8);
+    static int leadingBytes = numBytesPacketHeader + sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat)
+        + sizeof(quint8) + sizeof(quint8);
     static int16_t* networkAudioSamples = (int16_t*)(audioDataPacket + leadingBytes);
 
     float inputToNetworkInputRatio = calculateDeviceToNetworkInputRatio();
 
     int inputSamplesRequired = (int)((float)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * inputToNetworkInputRatio);
 
-    QByteArray inputByteArray = _inputDevice->readAll();
+    // read the device into a buffer that is kept from callback to callback, readAll would allocate a new one each time
+    int numInputBytes = (int)_inputDevice->bytesAvailable();
+    if (_inputCaptureBuffer.capacity() < numInputBytes) {
+        _inputCaptureBuffer.reserve(numInputBytes);
+    }
+    _inputCaptureBuffer.resize(numInputBytes);
+    numInputBytes = (int)_inputDevice->read(_inputCaptureBuffer.data(), numInputBytes);
+    _inputCaptureBuffer.resize(std::max(numInputBytes, 0));
+    
+    QByteArray& inputByteArray = _inputCaptureBuffer;
+    
+    if (_inputResamplingBuffer.capacity() < inputSamplesRequired * (int)sizeof(int16_t)) {
+        _inputResamplingBuffer.reserve(inputSamplesRequired * sizeof(int16_t));
+    }
+    _inputResamplingBuffer.resize(inputSamplesRequired * sizeof(int16_t));
 
     if (!_muted && _audioSourceInjectEnabled) {
         
@@ -754,7 +784,8 @@ void AudioClient::handleAudioInput() {
                 _timeSinceLastClip += (float) numNetworkSamples / (float) AudioConstants::SAMPLE_RATE;
             }
             
-            int16_t* inputAudioSamples = new int16_t[inputSamplesRequired];
+            // resample straight into the packet
+            int16_t* inputAudioSamples = reinterpret_cast<int16_t*>(_inputResamplingBuffer.data());
             _inputRingBuffer.readSamples(inputAudioSamples, inputSamplesRequired);
             
             possibleResampling(_inputToNetworkResampler,
@@ -762,8 +793,6 @@ void AudioClient::handleAudioInput() {
                                inputSamplesRequired, numNetworkSamples,
                                _inputFormat, _desiredInputFormat);
             
-            delete[] inputAudioSamples;
-            
             // only impose the noise gate and perform tone injection if we are sending mono audio
             if (!_isStereoInput && !_audioSourceInjectEnabled && _isNoiseGateEnabled) {
                 _inputGate.gateSamples(networkAudioSamples, numNetworkSamples);
@@ -819,6 +848,17 @@ void AudioClient::handleAudioInput() {
                 }
             }
 
+            // discontinuous transmission - a silent frame still goes out every frame with our position and
+            // orientation, but only the first of a run carries silent samples. the rest leave the mixer nothing to mix
+            quint16 numSilentSamples = 0;
+            if (packetType == PacketTypeSilentAudioFrame) {
+                if (_numConsecutiveSilentFrames++ == 0) {
+                    numSilentSamples = numNetworkSamples;
+                }
+            } else {
+                _numConsecutiveSilentFrames = 0;
+            }
+
             char* currentPacketPtr = audioDataPacket + populatePacketHeader(audioDataPacket, packetType);
 
             // pack sequence number
@@ -827,7 +867,6 @@ void AudioClient::handleAudioInput() {
 
             if (packetType == PacketTypeSilentAudioFrame) {
                 // pack num silent samples
-                quint16 numSilentSamples = numNetworkSamples;
                 memcpy(currentPacketPtr, &numSilentSamples, sizeof(quint16));
                 currentPacketPtr += sizeof(quint16);
 
@@ -843,6 +882,10 @@ void AudioClient::handleAudioInput() {
                 // set the mono/stereo byte
                 *currentPacketPtr++ = isStereo;
 
+                // set the codec byte
+                bool isCompressed = _audioCompressionEnabled.get();
+                *currentPacketPtr++ = (char)(isCompressed ? AudioCodec::ADPCM : AudioCodec::PCM);
+
                 // memcpy the three float positions
                 memcpy(currentPacketPtr, &headPosition, sizeof(headPosition));
                 currentPacketPtr += (sizeof(headPosition));
@@ -852,7 +895,16 @@ void AudioClient::handleAudioInput() {
                 currentPacketPtr += sizeof(headOrientation);
 
                 // audio samples have already been packed (written to networkAudioSamples)
-                currentPacketPtr += numNetworkBytes;
+                if (isCompressed) {
+                    // encode them and write the result back over the raw samples, it is always smaller
+                    _encodedInputAudio.resize(0);
+                    _inputAudioEncoder.encode(networkAudioSamples, numNetworkSamples, _encodedInputAudio);
+
+                    memcpy(currentPacketPtr, _encodedInputAudio.constData(), _encodedInputAudio.size());
+                    currentPacketPtr += _encodedInputAudio.size();
+                } else {
+                    currentPacketPtr += numNetworkBytes;
+                }
             }
 
             _stats.sentPacket();
@@ -941,6 +993,7 @@ void AudioClient::toggleMute() {
 void AudioClient::setIsStereoInput(bool isStereoInput) {
     if (isStereoInput != _isStereoInput) {
         _isStereoInput = isStereoInput;
+        _inputAudioEncoder.reset(_isStereoInput ? AudioConstants::STEREO : AudioConstants::MONO);
         
         if (_isStereoInput) {
             _desiredInputFormat.setChannelCount(2);
@@ -1274,6 +1327,8 @@ void AudioClient::loadSettings() {
     _receivedAudioStream.setMaxFramesOverDesired(maxFramesOverDesired.get());
     _receivedAudioStream.setStaticDesiredJitterBufferFrames(staticDesiredJitterBufferFrames.get());
     _receivedAudioStream.setUseStDevForJitterCalc(useStDevForJitterCalc.get());
+    _receivedAudioStream.setUsePercentileForJitterCalc(usePercentileForJitterCalc.get());
+    _receivedAudioStream.setTargetLateLossRate(targetLateLossRate.get());
     _receivedAudioStream.setWindowStarveThreshold(windowStarveThreshold.get());
     _receivedAudioStream.setWindowSecondsForDesiredCalcOnTooManyStarves(
                                                                         windowSecondsForDesiredCalcOnTooManyStarves.get());
@@ -1285,6 +1340,8 @@ void AudioClient::saveSettings() {
     dynamicJitterBuffers.set(_receivedAudioStream.getDynamicJitterBuffers());
     maxFramesOverDesired.set(_receivedAudioStream.getMaxFramesOverDesired());
     staticDesiredJitterBufferFrames.set(_receivedAudioStream.getDesiredJitterBufferFrames());
+    usePercentileForJitterCalc.set(_receivedAudioStream.getUsePercentileForJitterCalc());
+    targetLateLossRate.set(_receivedAudioStream.getTargetLateLossRate());
     windowStarveThreshold.set(_receivedAudioStream.getWindowStarveThreshold());
     windowSecondsForDesiredCalcOnTooManyStarves.set(_receivedAudioStream.
                                                     getWindowSecondsForDesiredCalcOnTooManyStarves());
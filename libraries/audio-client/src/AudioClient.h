@@ -25,6 +25,7 @@
 
 #include <AbstractAudioInterface.h>
 #include <AudioBuffer.h>
+#include <AudioCodec.h>
 #include <AudioEffectOptions.h>
 #include <AudioFormat.h>
 #include <AudioGain.h>
@@ -63,6 +64,7 @@ static const int MAX_AUDIO_OUTPUT_BUFFER_SIZE_FRAMES = 20;
 static const int DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_ENABLED = true;
 static const int DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_THRESHOLD = 3;
 static const quint64 DEFAULT_AUDIO_OUTPUT_STARVE_DETECTION_PERIOD = 10 * 1000; // 10 Seconds
+static const bool DEFAULT_AUDIO_COMPRESSION_ENABLED = false;
 
 class QAudioInput;
 class QAudioOutput;
@@ -123,6 +125,10 @@ public:
     
     int getOutputStarveDetectionThreshold() { return _outputStarveDetectionThreshold.get(); }
     void setOutputStarveDetectionThreshold(int threshold) { _outputStarveDetectionThreshold.set(threshold); }
+
+    /// when enabled, microphone audio is sent ADPCM encoded and the audio-mixer answers with an encoded mix
+    bool getAudioCompressionEnabled() { return _audioCompressionEnabled.get(); }
+    void setAudioCompressionEnabled(bool enabled) { _audioCompressionEnabled.set(enabled); }
     
     void setPositionGetter(AudioPositionGetter positionGetter) { _positionGetter = positionGetter; }
     void setOrientationGetter(AudioOrientationGetter orientationGetter) { _orientationGetter = orientationGetter; }
@@ -197,6 +203,8 @@ private:
     QAudioFormat _inputFormat;
     QIODevice* _inputDevice;
     int _numInputCallbackBytes;
+    QByteArray _inputCaptureBuffer;         // what the input device had for us in the last callback
+    QByteArray _inputResamplingBuffer;      // one network frame worth of input device samples
     int16_t _localProceduralSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
     QAudioOutput* _audioOutput;
     QAudioFormat _desiredOutputFormat;
@@ -221,6 +229,10 @@ private:
     Setting::Handle<int> _outputStarveDetectionPeriodMsec;
      // Maximum number of starves per _outputStarveDetectionPeriod before increasing buffer size
     Setting::Handle<int> _outputStarveDetectionThreshold;
+
+    Setting::Handle<bool> _audioCompressionEnabled;
+    AudioCodec _inputAudioEncoder;
+    QByteArray _encodedInputAudio;
     
     StDev _stdev;
     QElapsedTimer _timeSinceLastReceived;
@@ -280,6 +292,7 @@ private:
     AudioSourceTone _toneSource;
 
     quint16 _outgoingAvatarAudioSequenceNumber;
+    int _numConsecutiveSilentFrames;
 
     AudioOutputIODevice _audioOutputIODevice;
     
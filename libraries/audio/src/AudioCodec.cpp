@@ -0,0 +1,185 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include "AudioCodec.h"
+
+static const int ADPCM_INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int ADPCM_NUM_STEPS = 89;
+
+static const int ADPCM_STEP_TABLE[ADPCM_NUM_STEPS] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+// channel count, then a 16-bit predictor and a step index per channel
+static const int ADPCM_BYTES_PER_CHANNEL_HEADER = sizeof(int16_t) + sizeof(uint8_t);
+
+static int headerBytesForChannels(int numChannels) {
+    return sizeof(uint8_t) + numChannels * ADPCM_BYTES_PER_CHANNEL_HEADER;
+}
+
+AudioCodec::AudioCodec(int numChannels) {
+    reset(numChannels);
+}
+
+void AudioCodec::reset(int numChannels) {
+    _numChannels = numChannels < 1 ? 1 : (numChannels > MAX_CHANNELS ? MAX_CHANNELS : numChannels);
+    memset(_state, 0, sizeof(_state));
+}
+
+void AudioCodec::encode(const int16_t* samples, int numSamples, QByteArray& destination) {
+    int headerBytes = headerBytesForChannels(_numChannels);
+    int offset = destination.size();
+    destination.resize(offset + headerBytes + numSamples / 2);
+
+    char* dataAt = destination.data() + offset;
+
+    // pack the state the decoder starts from
+    *dataAt++ = (char)_numChannels;
+    for (int channel = 0; channel < _numChannels; channel++) {
+        memcpy(dataAt, &_state[channel].predictor, sizeof(int16_t));
+        dataAt += sizeof(int16_t);
+        *dataAt++ = (char)_state[channel].stepIndex;
+    }
+
+    // every byte holds two consecutive interleaved samples, so mono and stereo pack the same way
+    for (int i = 0; i + 1 < numSamples; i += 2) {
+        uint8_t low = encodeSample(samples[i], _state[i % _numChannels]);
+        uint8_t high = encodeSample(samples[i + 1], _state[(i + 1) % _numChannels]);
+        *dataAt++ = (char)(low | (high << 4));
+    }
+}
+
+int AudioCodec::decode(const char* data, int numBytes, QByteArray& destination) {
+    int numSamples = numSamplesForEncodedBytes(data, numBytes);
+    if (numSamples == 0) {
+        return 0;
+    }
+
+    int numChannels = (uint8_t)*data++;
+
+    ChannelState state[MAX_CHANNELS];
+    for (int channel = 0; channel < numChannels; channel++) {
+        memcpy(&state[channel].predictor, data, sizeof(int16_t));
+        data += sizeof(int16_t);
+        state[channel].stepIndex = (uint8_t)*data++;
+        if (state[channel].stepIndex >= ADPCM_NUM_STEPS) {
+            return 0;
+        }
+    }
+
+    int offset = destination.size();
+    destination.resize(offset + numSamples * sizeof(int16_t));
+    int16_t* samplesAt = reinterpret_cast<int16_t*>(destination.data() + offset);
+
+    for (int i = 0; i < numSamples; i += 2) {
+        uint8_t packed = (uint8_t)*data++;
+        samplesAt[i] = decodeSample(packed & 0x0F, state[i % numChannels]);
+        samplesAt[i + 1] = decodeSample(packed >> 4, state[(i + 1) % numChannels]);
+    }
+
+    return numSamples;
+}
+
+int AudioCodec::numSamplesForEncodedBytes(const char* data, int numBytes) {
+    if (numBytes < 1) {
+        return 0;
+    }
+
+    int numChannels = (uint8_t)data[0];
+    if (numChannels < 1 || numChannels > MAX_CHANNELS) {
+        return 0;
+    }
+
+    int headerBytes = headerBytesForChannels(numChannels);
+    if (numBytes < headerBytes) {
+        return 0;
+    }
+
+    return (numBytes - headerBytes) * 2;
+}
+
+int AudioCodec::numEncodedBytesForSamples(int numSamples, int numChannels) {
+    return headerBytesForChannels(numChannels) + numSamples / 2;
+}
+
+uint8_t AudioCodec::encodeSample(int16_t sample, ChannelState& state) {
+    int step = ADPCM_STEP_TABLE[state.stepIndex];
+    int difference = (int)sample - (int)state.predictor;
+
+    uint8_t nibble = 0;
+    if (difference < 0) {
+        nibble = 8;
+        difference = -difference;
+    }
+
+    // quantize the difference the same way decodeSample reconstructs it
+    int delta = step >> 3;
+    if (difference >= step) {
+        nibble |= 4;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 2;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 1;
+        delta += step;
+    }
+
+    int predictor = (int)state.predictor + ((nibble & 8) ? -delta : delta);
+    state.predictor = (int16_t)(predictor < INT16_MIN ? INT16_MIN : (predictor > INT16_MAX ? INT16_MAX : predictor));
+
+    int stepIndex = (int)state.stepIndex + ADPCM_INDEX_TABLE[nibble];
+    state.stepIndex = (uint8_t)(stepIndex < 0 ? 0 : (stepIndex >= ADPCM_NUM_STEPS ? ADPCM_NUM_STEPS - 1 : stepIndex));
+
+    return nibble;
+}
+
+int16_t AudioCodec::decodeSample(uint8_t nibble, ChannelState& state) {
+    int step = ADPCM_STEP_TABLE[state.stepIndex];
+
+    int delta = step >> 3;
+    if (nibble & 4) {
+        delta += step;
+    }
+    if (nibble & 2) {
+        delta += step >> 1;
+    }
+    if (nibble & 1) {
+        delta += step >> 2;
+    }
+
+    int predictor = (int)state.predictor + ((nibble & 8) ? -delta : delta);
+    state.predictor = (int16_t)(predictor < INT16_MIN ? INT16_MIN : (predictor > INT16_MAX ? INT16_MAX : predictor));
+
+    int stepIndex = (int)state.stepIndex + ADPCM_INDEX_TABLE[nibble];
+    state.stepIndex = (uint8_t)(stepIndex < 0 ? 0 : (stepIndex >= ADPCM_NUM_STEPS ? ADPCM_NUM_STEPS - 1 : stepIndex));
+
+    return state.predictor;
+}
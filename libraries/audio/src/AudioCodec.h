@@ -0,0 +1,68 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+
+//
+// Codec for the audio payload of microphone and mixed audio packets.
+//
+// ADPCM is 4-bit IMA ADPCM, a quarter of the size of the raw 16-bit samples. Each encoded packet starts with the
+// channel count and the predictor state of every channel, so packets decode independently of each other and a
+// dropped packet costs nothing more than its own audio. Stereo payloads hold one frame per byte, left channel in
+// the low nibble.
+//
+class AudioCodec {
+public:
+    enum Type {
+        PCM = 0,
+        ADPCM
+    };
+
+    AudioCodec(int numChannels = 1);
+
+    /// resets the predictor state, called when the stream restarts or changes channel count
+    void reset(int numChannels);
+
+    /// encodes numSamples interleaved samples, appending them to destination.
+    /// numSamples must be a multiple of two frames.
+    void encode(const int16_t* samples, int numSamples, QByteArray& destination);
+
+    /// decodes a packet written by encode, appending the samples to destination.
+    /// returns the number of samples decoded, or 0 if the payload is malformed
+    static int decode(const char* data, int numBytes, QByteArray& destination);
+
+    /// returns the number of samples a payload written by encode will decode to, or 0 if it is malformed
+    static int numSamplesForEncodedBytes(const char* data, int numBytes);
+
+    static int numEncodedBytesForSamples(int numSamples, int numChannels);
+
+    static bool isValidType(quint8 type) { return type <= ADPCM; }
+
+private:
+    struct ChannelState {
+        int16_t predictor;
+        uint8_t stepIndex;
+    };
+
+    static uint8_t encodeSample(int16_t sample, ChannelState& state);
+    static int16_t decodeSample(uint8_t nibble, ChannelState& state);
+
+    static const int MAX_CHANNELS = 2;
+
+    int _numChannels;
+    ChannelState _state[MAX_CHANNELS];
+};
+
+#endif // hifi_AudioCodec_h
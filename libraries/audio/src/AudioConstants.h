@@ -21,6 +21,9 @@ namespace AudioConstants {
     
     typedef int16_t AudioSample;
     
+    const int MONO = 1;
+    const int STEREO = 2;
+    
     const int NETWORK_FRAME_BYTES_STEREO = 1024;
     const int NETWORK_FRAME_SAMPLES_STEREO = NETWORK_FRAME_BYTES_STEREO / sizeof(AudioSample);
     const int NETWORK_FRAME_BYTES_PER_CHANNEL = 512;
@@ -13,7 +13,8 @@
 #define hifi_AudioFilter_h
 
 //
-// Implements a standard biquad filter in "Direct Form 1"
+// Implements a standard biquad filter in "Transposed Direct Form 2", the form AudioFilterBank vectorizes across
+// channels (see AudioMixKernel::biquadCascade)
 // Reference http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
 //
 class AudioBiquad {
@@ -27,10 +28,8 @@ class AudioBiquad {
     float32_t _b1;  // feedback 1
     float32_t _b2;  // feedback 2
 
-    float32_t _xm1;
-    float32_t _xm2;
-    float32_t _ym1;
-    float32_t _ym2;
+    float32_t _s1;
+    float32_t _s2;
 
 public:
 
@@ -38,10 +37,8 @@ public:
     // ctor/dtor
     //
     AudioBiquad() :
-    _xm1(0.),
-    _xm2(0.),
-    _ym1(0.),
-    _ym2(0.) {
+    _s1(0.),
+    _s2(0.) {
         setParameters(0.,0.,0.,0.,0.);
     }
 
@@ -59,6 +56,14 @@ public:
         a0 = _a0; a1 = _a1; a2 = _a2; b1 = _b1; b2 = _b2;
     }
 
+    void setState(const float32_t s1, const float32_t s2) {
+        _s1 = s1; _s2 = s2;
+    }
+
+    void getState(float32_t& s1, float32_t& s2) {
+        s1 = _s1; s2 = _s2;
+    }
+
     void render(const float32_t* in, float32_t* out, const uint32_t frames) {
         
         float32_t x;
@@ -69,26 +74,20 @@ public:
             x = *in++;
 
             // biquad
-            y = (_a0 * x)
-              + (_a1 * _xm1) 
-              + (_a2 * _xm2)
-              - (_b1 * _ym1) 
-              - (_b2 * _ym2);
+            y = (_a0 * x) + _s1;
 
             y = (y >= -EPSILON && y < EPSILON) ? 0.0f : y; // clamp to 0
 
-            // update delay line
-            _xm2 = _xm1;
-            _xm1 = x;
-            _ym2 = _ym1;
-            _ym1 = y;
+            // update state
+            _s1 = (_a1 * x) - (_b1 * y) + _s2;
+            _s2 = (_a2 * x) - (_b2 * y);
 
             *out++ = y;
         }
     }
 
     void reset() {
-        _xm1 = _xm2 = _ym1 = _ym2 = 0.;
+        _s1 = _s2 = 0.;
     }
 };
 
@@ -121,8 +120,12 @@ public:
     //
     // ctor/dtor
     //
-    AudioFilter() {
-        setParameters(0.,0.,0.,0.);
+    AudioFilter() :
+        _sampleRate(1.0f),
+        _frequency(2.0f),
+        _gain(0.0f),
+        _slope(0.00001f) {
+        updateKernel();
     }
     
     ~AudioFilter() {
@@ -133,10 +136,21 @@ public:
     //
     void setParameters(const float32_t sampleRate, const float32_t frequency, const float32_t gain, const float32_t slope) {
         
-        _sampleRate = std::max(sampleRate, 1.0f);
-        _frequency = std::max(frequency, 2.0f);
-        _gain = std::max(gain, 0.0f);
-        _slope = std::max(slope, 0.00001f);
+        const float32_t clampedSampleRate = std::max(sampleRate, 1.0f);
+        const float32_t clampedFrequency = std::max(frequency, 2.0f);
+        const float32_t clampedGain = std::max(gain, 0.0f);
+        const float32_t clampedSlope = std::max(slope, 0.00001f);
+        
+        // the mixer sets its penumbra filters for every source every frame, only redesign the kernel on a change
+        if (clampedSampleRate == _sampleRate && clampedFrequency == _frequency
+            && clampedGain == _gain && clampedSlope == _slope) {
+            return;
+        }
+        
+        _sampleRate = clampedSampleRate;
+        _frequency = clampedFrequency;
+        _gain = clampedGain;
+        _slope = clampedSlope;
         
         updateKernel();
     }
@@ -149,6 +163,10 @@ public:
         _kernel.render(in,out,frames);
     }
     
+    AudioBiquad& getKernel() {
+        return _kernel;
+    }
+    
     void reset() {
         _kernel.reset();
     }
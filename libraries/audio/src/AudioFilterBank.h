@@ -12,6 +12,8 @@
 #ifndef hifi_AudioFilterBank_h
 #define hifi_AudioFilterBank_h
 
+#include "AudioMixKernel.h"
+
 //
 // Helper/convenience class that implements a bank of Filter objects
 //
@@ -35,15 +37,42 @@ class AudioFilterBank {
     static const uint32_t _profileCount  = 4;
     
     static FilterParameter _profiles[ _profileCount ][ _filterCount ];
+    
+    // one kernel lane per channel
+    typedef char ChannelCountFitsKernelLanes[ (_channelCount <= AudioMixKernel::BIQUAD_LANES) ? 1 : -1 ];
 
     //
     // private data
     //
     T           _filters[ _filterCount ][ _channelCount ];
-    float32_t*  _buffer[ _channelCount ];
     float32_t   _sampleRate;
     uint32_t    _frameCount;
 
+    //
+    // helpers
+    //
+    
+    // gathers every channel of each stage into the lanes of a kernel stage, unused lanes pass through as silence
+    void loadStages(AudioMixKernel::BiquadStage* stages) {
+        memset(stages, 0, _filterCount * sizeof(AudioMixKernel::BiquadStage));
+        
+        for (uint32_t i = 0; i < _filterCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                AudioBiquad& kernel = _filters[i][j].getKernel();
+                kernel.getParameters(stages[i].a0[j], stages[i].a1[j], stages[i].a2[j], stages[i].b1[j], stages[i].b2[j]);
+                kernel.getState(stages[i].s1[j], stages[i].s2[j]);
+            }
+        }
+    }
+    
+    void storeStages(const AudioMixKernel::BiquadStage* stages) {
+        for (uint32_t i = 0; i < _filterCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                _filters[i][j].getKernel().setState(stages[i].s1[j], stages[i].s2[j]);
+            }
+        }
+    }
+
 public:
 
     //
@@ -52,9 +81,6 @@ public:
     AudioFilterBank() :
         _sampleRate(0.0f),
         _frameCount(0) {
-        for (uint32_t i = 0; i < _channelCount; ++i) {
-            _buffer[ i ] = NULL;
-        }
     }
 
     ~AudioFilterBank() {
@@ -66,10 +92,6 @@ public:
     //
     void initialize(const float32_t sampleRate, const uint32_t frameCount = 0) {
         finalize();
-
-        for (uint32_t i = 0; i < _channelCount; ++i) {
-            _buffer[i] = (float32_t*)malloc(frameCount * sizeof(float32_t));
-        }
         
         _sampleRate = sampleRate;
         _frameCount = frameCount;
@@ -79,12 +101,7 @@ public:
     }
 
     void finalize() {
-        for (uint32_t i = 0; i < _channelCount; ++i) {
-            if (_buffer[i]) {
-                free (_buffer[i]);
-                _buffer[i] = NULL;
-            }
-        }
+        _frameCount = 0;
     }
 
     void loadProfile(int profileIndex) {
@@ -115,41 +132,29 @@ public:
     }
     
     void render(const int16_t* in, int16_t* out, const uint32_t frameCount) {
-        if (!_buffer || (frameCount > _frameCount))
+        if (frameCount > _frameCount)
             return;
 
         const int scale = (2 << ((8 * sizeof(int16_t)) - 1));
 
-        // de-interleave and convert int16_t to float32 (normalized to -1. ... 1.)
-        for (uint32_t i = 0; i < frameCount; ++i) {
-            for (uint32_t j = 0; j < _channelCount; ++j) {
-                _buffer[j][i] = ((float)(*in++)) / scale;
-            }
-        }
-
-        // now step through each filter
-        for (uint32_t i = 0; i < _channelCount; ++i) {
-            for (uint32_t j = 0; j < _filterCount; ++j) {
-                _filters[j][i].render( &_buffer[i][0], &_buffer[i][0], frameCount );
-            }
-        }
-
-        // convert float32 to int16_t and interleave
-        for (uint32_t i = 0; i < frameCount; ++i) {
-            for (uint32_t j = 0; j < _channelCount; ++j) {
-                *out++ = (int16_t)(_buffer[j][i] * scale);
-            }
-        }
+        // de-interleaving, conversion to float32 (normalized to -1. ... 1.) and interleaving happen in the kernel
+        AudioMixKernel::BiquadStage stages[ _filterCount ];
+        loadStages(stages);
+        AudioMixKernel::biquadCascade< _filterCount >(stages, in, out, frameCount, _channelCount, (float32_t)scale);
+        storeStages(stages);
     }
 
     void render(AudioBufferFloat32& frameBuffer) {
         
-        float32_t** samples = frameBuffer.getFrameData();
-        for (uint32_t j = 0; j < frameBuffer.getChannelCount(); ++j) {
-            for (uint32_t i = 0; i < _filterCount; ++i) {
-                _filters[i][j].render( samples[j], samples[j], frameBuffer.getFrameCount() );
-            }
+        if (frameBuffer.getChannelCount() > _channelCount) {
+            return;
         }
+        
+        AudioMixKernel::BiquadStage stages[ _filterCount ];
+        loadStages(stages);
+        AudioMixKernel::biquadCascade< _filterCount >(stages, frameBuffer.getFrameData(), frameBuffer.getFrameCount(),
+                                                      frameBuffer.getChannelCount());
+        storeStages(stages);
     }
     
     void reset() {
@@ -17,6 +17,7 @@
 #include <UUID.h>
 
 #include "AbstractAudioInterface.h"
+#include "AudioInjectorScheduler.h"
 #include "AudioRingBuffer.h"
 
 #include "AudioInjector.h"
@@ -36,18 +37,36 @@ AudioInjector::AudioInjector(QObject* parent) :
     _loudness(0.0f),
     _isFinished(false),
     _currentSendPosition(0),
-    _localBuffer(NULL)
+    _localBuffer(NULL),
+    _numPreSequenceNumberBytes(0),
+    _positionOptionOffset(0),
+    _orientationOptionOffset(0),
+    _volumeOptionOffset(0),
+    _numPreAudioDataBytes(0),
+    _outgoingSequenceNumber(0),
+    _starvedSince(0),
+    _injectStartTime(0),
+    _framesSent(0)
 {
 }
 
 AudioInjector::AudioInjector(Sound* sound, const AudioInjectorOptions& injectorOptions) :
-    _audioData(sound->getByteArray()),
+    _decodingSamples(sound->getSamples()),
     _options(injectorOptions),
     _shouldStop(false),
     _loudness(0.0f),
     _isFinished(false),
     _currentSendPosition(0),
-    _localBuffer(NULL)
+    _localBuffer(NULL),
+    _numPreSequenceNumberBytes(0),
+    _positionOptionOffset(0),
+    _orientationOptionOffset(0),
+    _volumeOptionOffset(0),
+    _numPreAudioDataBytes(0),
+    _outgoingSequenceNumber(0),
+    _starvedSince(0),
+    _injectStartTime(0),
+    _framesSent(0)
 {
 }
 
@@ -58,12 +77,23 @@ AudioInjector::AudioInjector(const QByteArray& audioData, const AudioInjectorOpt
     _loudness(0.0f),
     _isFinished(false),
     _currentSendPosition(0),
-    _localBuffer(NULL)
+    _localBuffer(NULL),
+    _numPreSequenceNumberBytes(0),
+    _positionOptionOffset(0),
+    _orientationOptionOffset(0),
+    _volumeOptionOffset(0),
+    _numPreAudioDataBytes(0),
+    _outgoingSequenceNumber(0),
+    _starvedSince(0),
+    _injectStartTime(0),
+    _framesSent(0)
 {
     
 }
 
 AudioInjector::~AudioInjector() {
+    AudioInjectorScheduler::getInstance().removeInjector(this);
+    
     if (_localBuffer) {
         _localBuffer->stop();
     }
@@ -77,6 +107,21 @@ float AudioInjector::getLoudness() {
     return _loudness;
 }
 
+int AudioInjector::getAvailableBytes() {
+    if (!_decodingSamples.isNull()) {
+        {
+            QMutexLocker locker(&_decodingSamples->mutex);
+            if (!_decodingSamples->isComplete) {
+                return _decodingSamples->samples.size();
+            }
+            _audioData = _decodingSamples->samples;
+        }
+        // the Sound won't touch its samples again, so from here they're read like any other audio
+        _decodingSamples.clear();
+    }
+    return _audioData.size();
+}
+
 void AudioInjector::injectAudio() {
     
     // check if we need to offset the sound by some number of seconds
@@ -99,6 +144,11 @@ void AudioInjector::injectAudio() {
 void AudioInjector::injectLocally() {
     bool success = false;
     if (_localAudioInterface) {
+        if (getAvailableBytes() > 0 && !_decodingSamples.isNull()) {
+            // the local buffer plays out of a single array, so it gets what has been decoded by now
+            QMutexLocker locker(&_decodingSamples->mutex);
+            _audioData = _decodingSamples->samples;
+        }
         if (_audioData.size() > 0) {
             
             _localBuffer = new AudioInjectorLocalBuffer(_audioData, this);
@@ -132,125 +182,168 @@ void AudioInjector::injectLocally() {
 }
 
 const uchar MAX_INJECTOR_VOLUME = 0xFF;
+const quint64 MAX_DOWNLOAD_STALL_USECS = 10 * USECS_PER_SECOND;
 
 void AudioInjector::injectToMixer() {
+    // a sound still downloading may not have reached the offset yet, but it will
+    int availableBytes = getAvailableBytes();
     if (_currentSendPosition < 0 ||
-        _currentSendPosition >= _audioData.size()) {
+        (_decodingSamples.isNull() && _currentSendPosition >= availableBytes)) {
         _currentSendPosition = 0;
     }
     
-    // make sure we actually have samples downloaded to inject
-    if (_audioData.size()) {
-        
-        // setup the packet for injected audio
-        QByteArray injectAudioPacket = byteArrayWithPopulatedHeader(PacketTypeInjectAudio);
-        QDataStream packetStream(&injectAudioPacket, QIODevice::Append);
-        
-        // pack some placeholder sequence number for now
-        int numPreSequenceNumberBytes = injectAudioPacket.size();
-        packetStream << (quint16)0;
-        
-        // pack stream identifier (a generated UUID)
-        packetStream << QUuid::createUuid();
-        
-        // pack the stereo/mono type of the stream
-        packetStream << _options.stereo;
-        
-        // pack the flag for loopback
-        uchar loopbackFlag = (uchar) true;
-        packetStream << loopbackFlag;
-        
-        // pack the position for injected audio
-        int positionOptionOffset = injectAudioPacket.size();
-        packetStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
-                                  sizeof(_options.position));
-        
-        // pack our orientation for injected audio
-        int orientationOptionOffset = injectAudioPacket.size();
-        packetStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
-                                  sizeof(_options.orientation));
-        
-        // pack zero for radius
-        float radius = 0;
-        packetStream << radius;
-        
-        // pack 255 for attenuation byte
-        int volumeOptionOffset = injectAudioPacket.size();
-        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
-        packetStream << volume;
-        
-        packetStream << _options.ignorePenumbra;
-        
-        QElapsedTimer timer;
-        timer.start();
-        int nextFrame = 0;
-        
-        int numPreAudioDataBytes = injectAudioPacket.size();
-        bool shouldLoop = _options.loop;
-        
-        // loop to send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
-        quint16 outgoingInjectedAudioSequenceNumber = 0;
-        while (_currentSendPosition < _audioData.size() && !_shouldStop) {
-            
-            int bytesToCopy = std::min(((_options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
-                                       _audioData.size() - _currentSendPosition);
-            
-            //  Measure the loudness of this frame
-            _loudness = 0.0f;
-            for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
-                _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + _currentSendPosition + i)) /
-                (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
-            }
-            _loudness /= (float)(bytesToCopy / sizeof(int16_t));
-
-            memcpy(injectAudioPacket.data() + positionOptionOffset,
-                   &_options.position,
-                   sizeof(_options.position));
-            memcpy(injectAudioPacket.data() + orientationOptionOffset,
-                   &_options.orientation,
-                   sizeof(_options.orientation));
-            volume = MAX_INJECTOR_VOLUME * _options.volume;
-            memcpy(injectAudioPacket.data() + volumeOptionOffset, &volume, sizeof(volume));
-            
-            // resize the QByteArray to the right size
-            injectAudioPacket.resize(numPreAudioDataBytes + bytesToCopy);
-
-            // pack the sequence number
-            memcpy(injectAudioPacket.data() + numPreSequenceNumberBytes,
-                   &outgoingInjectedAudioSequenceNumber, sizeof(quint16));
-            
-            // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
-            memcpy(injectAudioPacket.data() + numPreAudioDataBytes,
-                   _audioData.data() + _currentSendPosition, bytesToCopy);
-            
-            // grab our audio mixer from the NodeList, if it exists
-            auto nodeList = DependencyManager::get<NodeList>();
-            SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
-            
-            // send off this audio packet
-            nodeList->writeDatagram(injectAudioPacket, audioMixer);
-            outgoingInjectedAudioSequenceNumber++;
-            
-            _currentSendPosition += bytesToCopy;
-            
-            // send two packets before the first sleep so the mixer can start playback right away
-            
-            if (_currentSendPosition != bytesToCopy && _currentSendPosition < _audioData.size()) {
-                // not the first packet and not done
-                // sleep for the appropriate time
-                int usecToSleep = (++nextFrame * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000;
-                
-                if (usecToSleep > 0) {
-                    usleep(usecToSleep);
-                } 
-            }
+    // make sure we actually have samples downloaded to inject, or have them on the way
+    if (_decodingSamples.isNull() && !availableBytes) {
+        finishInjecting();
+        return;
+    }
+    
+    // setup the packet for injected audio
+    _injectAudioPacket = byteArrayWithPopulatedHeader(PacketTypeInjectAudio);
+    QDataStream packetStream(&_injectAudioPacket, QIODevice::Append);
+    
+    // pack some placeholder sequence number for now
+    _numPreSequenceNumberBytes = _injectAudioPacket.size();
+    packetStream << (quint16)0;
+    
+    // pack stream identifier (a generated UUID)
+    packetStream << QUuid::createUuid();
+    
+    // pack the stereo/mono type of the stream
+    packetStream << _options.stereo;
+    
+    // pack the flag for loopback
+    uchar loopbackFlag = (uchar) true;
+    packetStream << loopbackFlag;
+    
+    // pack the position for injected audio
+    _positionOptionOffset = _injectAudioPacket.size();
+    packetStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
+                              sizeof(_options.position));
+    
+    // pack our orientation for injected audio
+    _orientationOptionOffset = _injectAudioPacket.size();
+    packetStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
+                              sizeof(_options.orientation));
+    
+    // pack zero for radius
+    float radius = 0;
+    packetStream << radius;
+    
+    // pack 255 for attenuation byte
+    _volumeOptionOffset = _injectAudioPacket.size();
+    quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+    packetStream << volume;
+    
+    packetStream << _options.ignorePenumbra;
+    
+    _numPreAudioDataBytes = _injectAudioPacket.size();
+    
+    // allocate for the largest frame up front so sending never has to
+    _injectAudioPacket.reserve(_numPreAudioDataBytes + 2 * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+    
+    _outgoingSequenceNumber = 0;
+    _framesSent = 0;
+    _starvedSince = 0;
+    _injectStartTime = usecTimestampNow();
+    
+    // from here the scheduler sends our frames in time with everyone else's
+    AudioInjectorScheduler::getInstance().addInjector(this);
+}
 
-            if (shouldLoop && _currentSendPosition >= _audioData.size()) {
+bool AudioInjector::sendFramesDue(quint64 now, const SharedNodePointer& audioMixer) {
+    // send two packets before the first frame time so the mixer can start playback right away
+    int framesDue = 2 + (int)((now - _injectStartTime) / AudioConstants::NETWORK_FRAME_USECS);
+    
+    while (_framesSent < framesDue) {
+        if (_shouldStop) {
+            return false;
+        }
+        
+        if (_currentSendPosition >= getAvailableBytes()) {
+            if (_decodingSamples.isNull()) {
+                if (!_options.loop || _audioData.isEmpty()) {
+                    return false;
+                }
                 _currentSendPosition = 0;
+                
+            } else {
+                // the sound hasn't downloaded this far yet. a download that stalls for good is given up on
+                if (_starvedSince == 0) {
+                    _starvedSince = now;
+                    
+                } else if (now - _starvedSince > MAX_DOWNLOAD_STALL_USECS) {
+                    qDebug() << "AudioInjector giving up on a sound that stopped downloading.";
+                    return false;
+                }
+                
+                // wait without falling behind, or everything that arrives in the meantime would go out at once
+                _injectStartTime = now - (quint64)std::max(_framesSent - 2, 0) * AudioConstants::NETWORK_FRAME_USECS;
+                return true;
             }
         }
+        
+        sendFrame(audioMixer);
+        _starvedSince = 0;
+    }
+    
+    return !_shouldStop && (!_decodingSamples.isNull() || _options.loop || _currentSendPosition < _audioData.size());
+}
+
+int AudioInjector::copyFrameToPacket(const QByteArray& audio) {
+    // send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
+    int bytesToCopy = std::min(((_options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
+                               std::max(audio.size() - _currentSendPosition, 0));
+    
+    // resize the QByteArray to the right size, it stays within what was reserved
+    _injectAudioPacket.resize(_numPreAudioDataBytes + bytesToCopy);
+    
+    // only ever read the audio through constData, anything else would detach it from the Sound
+    memcpy(_injectAudioPacket.data() + _numPreAudioDataBytes, audio.constData() + _currentSendPosition, bytesToCopy);
+    return bytesToCopy;
+}
+
+void AudioInjector::sendFrame(const SharedNodePointer& audioMixer) {
+    // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
+    int bytesToCopy;
+    if (_decodingSamples.isNull()) {
+        bytesToCopy = copyFrameToPacket(_audioData);
+    } else {
+        QMutexLocker locker(&_decodingSamples->mutex);
+        bytesToCopy = copyFrameToPacket(_decodingSamples->samples);
     }
+    const int16_t* frameSamples = reinterpret_cast<const int16_t*>(_injectAudioPacket.constData() + _numPreAudioDataBytes);
+    
+    //  Measure the loudness of this frame
+    int numSamples = bytesToCopy / sizeof(int16_t);
+    float loudness = 0.0f;
+    for (int i = 0; i < numSamples; i++) {
+        loudness += abs(frameSamples[i]) / (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+    }
+    _loudness = numSamples > 0 ? loudness / (float)numSamples : 0.0f;
+    
+    memcpy(_injectAudioPacket.data() + _positionOptionOffset,
+           &_options.position,
+           sizeof(_options.position));
+    memcpy(_injectAudioPacket.data() + _orientationOptionOffset,
+           &_options.orientation,
+           sizeof(_options.orientation));
+    quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+    memcpy(_injectAudioPacket.data() + _volumeOptionOffset, &volume, sizeof(volume));
     
+    // pack the sequence number
+    memcpy(_injectAudioPacket.data() + _numPreSequenceNumberBytes,
+           &_outgoingSequenceNumber, sizeof(quint16));
+    
+    // send off this audio packet
+    DependencyManager::get<NodeList>()->writeDatagram(_injectAudioPacket, audioMixer);
+    _outgoingSequenceNumber++;
+    _framesSent++;
+    
+    _currentSendPosition += bytesToCopy;
+}
+
+void AudioInjector::finishInjecting() {
     _isFinished = true;
     emit finished();
 }
@@ -260,7 +353,6 @@ void AudioInjector::stop() {
     
     if (_options.localOnly) {
         // we're only a local injector, so we can say we are finished right away too
-        _isFinished = true;
-        emit finished();
+        finishInjecting();
     }
 }
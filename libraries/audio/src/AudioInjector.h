@@ -18,6 +18,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <LimitedNodeList.h>
+
 #include "AudioInjectorLocalBuffer.h"
 #include "AudioInjectorOptions.h"
 #include "Sound.h"
@@ -49,10 +51,26 @@ public slots:
 signals:
     void finished();
 private:
+    friend class AudioInjectorScheduler;
+    
     void injectToMixer();
     void injectLocally();
     
+    /// sends every frame due by now, called by the AudioInjectorScheduler. returns false once there is nothing left to send
+    bool sendFramesDue(quint64 now, const SharedNodePointer& audioMixer);
+    void sendFrame(const SharedNodePointer& audioMixer);
+    int copyFrameToPacket(const QByteArray& audio);
+    void finishInjecting();
+    
+    /// returns how much audio there is to play so far, taking all of a Sound's samples once it's done decoding them
+    int getAvailableBytes();
+    
+    // shares the Sound's data, it is only ever read so it is never copied
     QByteArray _audioData;
+    
+    // the samples of a Sound that was still decoding when we were made, until it's done
+    SoundSamplesPointer _decodingSamples;
+    
     AudioInjectorOptions _options;
     bool _shouldStop;
     float _loudness;
@@ -60,6 +78,19 @@ private:
     int _currentSendPosition;
     AbstractAudioInterface* _localAudioInterface;
     AudioInjectorLocalBuffer* _localBuffer;
+    
+    // the packet is written once and only the options, sequence number and audio change frame to frame
+    QByteArray _injectAudioPacket;
+    int _numPreSequenceNumberBytes;
+    int _positionOptionOffset;
+    int _orientationOptionOffset;
+    int _volumeOptionOffset;
+    int _numPreAudioDataBytes;
+    quint16 _outgoingSequenceNumber;
+    
+    quint64 _starvedSince; // when we ran out of downloaded audio to send, or 0
+    quint64 _injectStartTime;
+    int _framesSent;
 };
 
 Q_DECLARE_METATYPE(AudioInjector*)
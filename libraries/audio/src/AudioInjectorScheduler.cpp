@@ -0,0 +1,115 @@
+//
+//  AudioInjectorScheduler.cpp
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QMutexLocker>
+
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+#include "AudioConstants.h"
+#include "AudioInjector.h"
+
+#include "AudioInjectorScheduler.h"
+
+// ticks a little faster than the network frame rate, the injectors work out how many frames are due from the time
+const int SEND_FRAMES_INTERVAL_MSECS = (int)AudioConstants::NETWORK_FRAME_MSECS;
+
+AudioInjectorScheduler& AudioInjectorScheduler::getInstance() {
+    static AudioInjectorScheduler staticInstance;
+    return staticInstance;
+}
+
+AudioInjectorScheduler::AudioInjectorScheduler() :
+    _thread(new QThread()),
+    _timer(new QTimer()),
+    _finishingInjector(NULL)
+{
+    _thread->setObjectName("Audio Injector Thread");
+
+    _timer->setTimerType(Qt::PreciseTimer);
+    _timer->setInterval(SEND_FRAMES_INTERVAL_MSECS);
+    _timer->moveToThread(_thread);
+
+    // the timer has to be started and stopped on the thread it fires on
+    connect(_thread, SIGNAL(started()), _timer, SLOT(start()));
+    connect(_thread, SIGNAL(finished()), _timer, SLOT(stop()));
+    connect(_timer, &QTimer::timeout, this, &AudioInjectorScheduler::sendFrames, Qt::DirectConnection);
+}
+
+AudioInjectorScheduler::~AudioInjectorScheduler() {
+    _thread->quit();
+    _thread->wait();
+
+    delete _timer;
+    delete _thread;
+}
+
+QThread* AudioInjectorScheduler::getThread() {
+    // nothing is sent until the first injector wants its thread
+    if (!_thread->isRunning()) {
+        _thread->start();
+    }
+    return _thread;
+}
+
+void AudioInjectorScheduler::addInjector(AudioInjector* injector) {
+    getThread();
+
+    QMutexLocker locker(&_injectorsMutex);
+    _injectors.append(injector);
+}
+
+void AudioInjectorScheduler::removeInjector(AudioInjector* injector) {
+    // once this returns injector won't be touched again, it is safe to delete
+    QMutexLocker locker(&_injectorsMutex);
+    _injectors.removeOne(injector);
+    _finishingInjectors.removeOne(injector);
+
+    // unless it is being deleted from its own finished signal, wait for the scheduler thread to be done telling it
+    while (_finishingInjector == injector && QThread::currentThread() != _thread) {
+        _finishingInjectorDone.wait(&_injectorsMutex);
+    }
+}
+
+int AudioInjectorScheduler::getNumInjectors() {
+    QMutexLocker locker(&_injectorsMutex);
+    return _injectors.size();
+}
+
+void AudioInjectorScheduler::sendFrames() {
+    quint64 now = usecTimestampNow();
+
+    // grab our audio mixer from the NodeList once for every injector
+    SharedNodePointer audioMixer = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::AudioMixer);
+
+    QMutexLocker locker(&_injectorsMutex);
+
+    int i = 0;
+    while (i < _injectors.size()) {
+        AudioInjector* injector = _injectors[i];
+        if (injector->sendFramesDue(now, audioMixer)) {
+            i++;
+        } else {
+            _injectors.remove(i);
+            _finishingInjectors.append(injector);
+        }
+    }
+
+    // finished is emitted without the lock, a handler that deletes the injector right away goes through
+    // removeInjector. one deleted on another thread in the meantime has taken itself off the list
+    while (!_finishingInjectors.isEmpty()) {
+        _finishingInjector = _finishingInjectors.takeFirst();
+        locker.unlock();
+        _finishingInjector->finishInjecting();
+        locker.relock();
+        _finishingInjector = NULL;
+        _finishingInjectorDone.wakeAll();
+    }
+}
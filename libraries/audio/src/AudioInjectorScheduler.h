@@ -0,0 +1,57 @@
+//
+//  AudioInjectorScheduler.h
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioInjectorScheduler_h
+#define hifi_AudioInjectorScheduler_h
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+class AudioInjector;
+
+/// Sends the frames of every injector going to the audio mixer from one thread and one timer, so a script can have
+/// hundreds of sounds playing without a thread of its own for each of them
+class AudioInjectorScheduler : public QObject {
+    Q_OBJECT
+public:
+    static AudioInjectorScheduler& getInstance();
+
+    /// the thread injectors are sent from, injectors that live here need no thread of their own
+    QThread* getThread();
+
+    void addInjector(AudioInjector* injector);
+    void removeInjector(AudioInjector* injector);
+
+    int getNumInjectors();
+
+private slots:
+    void sendFrames();
+
+private:
+    AudioInjectorScheduler();
+    ~AudioInjectorScheduler();
+
+    QThread* _thread;
+    QTimer* _timer;
+
+    QMutex _injectorsMutex;
+    QVector<AudioInjector*> _injectors;
+
+    // injectors that are done, told so once the lock is let go since their finished handlers may take it again
+    QVector<AudioInjector*> _finishingInjectors;
+    AudioInjector* _finishingInjector;
+    QWaitCondition _finishingInjectorDone;
+};
+
+#endif // hifi_AudioInjectorScheduler_h
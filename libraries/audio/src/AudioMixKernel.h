@@ -0,0 +1,407 @@
+//
+//  AudioMixKernel.h
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernel_h
+#define hifi_AudioMixKernel_h
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HIFI_AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define HIFI_AUDIO_MIX_NEON
+#include <arm_neon.h>
+#endif
+
+//
+// Mix-accumulate kernels shared by the AudioMixer and the AudioClient.
+//
+// Streams are scaled into int16_t pre-mix buffers, summed into an int32_t accumulator without clamping, and
+// the accumulator is saturated to int16_t once when the frame is finalized.
+//
+// Float to int conversions truncate, which matches the scalar mixing code these kernels replace.
+// The SIMD paths handle 8 samples at a time, whatever is left over runs through the scalar path.
+//
+// The biquad kernels behind AudioFilterBank run every channel of a frame at once, one channel per lane, since the
+// feedback in each channel leaves nothing to vectorize along time.
+//
+namespace AudioMixKernel {
+
+inline int16_t saturateSample(int32_t sample) {
+    return (int16_t)(sample < INT16_MIN ? INT16_MIN : (sample > INT16_MAX ? INT16_MAX : sample));
+}
+
+/// destination[i] = saturate(source[i] * gain)
+inline void scale(int16_t* destination, const int16_t* source, float gain, int numSamples) {
+    int i = 0;
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+    const __m128 gain4 = _mm_set1_ps(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+        __m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+        __m128i scaled = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(low, gain4)),
+                                         _mm_cvttps_epi32(_mm_mul_ps(high, gain4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), scaled);
+    }
+#elif defined(HIFI_AUDIO_MIX_NEON)
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t samples = vld1q_s16(source + i);
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+        int16x8_t scaled = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(low, gain))),
+                                        vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(high, gain))));
+        vst1q_s16(destination + i, scaled);
+    }
+#endif
+
+    for (; i < numSamples; ++i) {
+        destination[i] = saturateSample((int32_t)(source[i] * gain));
+    }
+}
+
+/// interleaves two scaled mono channels into a stereo destination of numFrames frames
+inline void interleave(int16_t* destination, const int16_t* left, float leftGain,
+                       const int16_t* right, float rightGain, int numFrames) {
+    int i = 0;
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+    const __m128 leftGain4 = _mm_set1_ps(leftGain);
+    const __m128 rightGain4 = _mm_set1_ps(rightGain);
+    for (; i + 8 <= numFrames; i += 8) {
+        __m128i leftSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+        __m128i rightSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+
+        __m128 leftLow = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(leftSamples, leftSamples), 16));
+        __m128 leftHigh = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(leftSamples, leftSamples), 16));
+        __m128 rightLow = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(rightSamples, rightSamples), 16));
+        __m128 rightHigh = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(rightSamples, rightSamples), 16));
+
+        __m128i leftScaled = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(leftLow, leftGain4)),
+                                             _mm_cvttps_epi32(_mm_mul_ps(leftHigh, leftGain4)));
+        __m128i rightScaled = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(rightLow, rightGain4)),
+                                              _mm_cvttps_epi32(_mm_mul_ps(rightHigh, rightGain4)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 2 * i), _mm_unpacklo_epi16(leftScaled, rightScaled));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 2 * i + 8), _mm_unpackhi_epi16(leftScaled, rightScaled));
+    }
+#elif defined(HIFI_AUDIO_MIX_NEON)
+    for (; i + 8 <= numFrames; i += 8) {
+        int16x8_t leftSamples = vld1q_s16(left + i);
+        int16x8_t rightSamples = vld1q_s16(right + i);
+
+        int16x8x2_t stereo;
+        stereo.val[0] = vcombine_s16(
+            vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(leftSamples))), leftGain))),
+            vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(leftSamples))), leftGain))));
+        stereo.val[1] = vcombine_s16(
+            vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(rightSamples))), rightGain))),
+            vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(rightSamples))), rightGain))));
+
+        // vst2q interleaves the two channels as it stores them
+        vst2q_s16(destination + 2 * i, stereo);
+    }
+#endif
+
+    for (; i < numFrames; ++i) {
+        destination[2 * i] = saturateSample((int32_t)(left[i] * leftGain));
+        destination[2 * i + 1] = saturateSample((int32_t)(right[i] * rightGain));
+    }
+}
+
+/// accumulator[i] += source[i], without any clamping
+inline void accumulate(int32_t* accumulator, const int16_t* source, int numSamples) {
+    int i = 0;
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128i* at = reinterpret_cast<__m128i*>(accumulator + i);
+        _mm_storeu_si128(at, _mm_add_epi32(_mm_loadu_si128(at),
+                                           _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)));
+        _mm_storeu_si128(at + 1, _mm_add_epi32(_mm_loadu_si128(at + 1),
+                                               _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)));
+    }
+#elif defined(HIFI_AUDIO_MIX_NEON)
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t samples = vld1q_s16(source + i);
+        vst1q_s32(accumulator + i, vaddw_s16(vld1q_s32(accumulator + i), vget_low_s16(samples)));
+        vst1q_s32(accumulator + i + 4, vaddw_s16(vld1q_s32(accumulator + i + 4), vget_high_s16(samples)));
+    }
+#endif
+
+    for (; i < numSamples; ++i) {
+        accumulator[i] += source[i];
+    }
+}
+
+/// destination[i] = saturate(accumulator[i]), called once per frame after every stream has been accumulated
+inline void saturate(int16_t* destination, const int32_t* accumulator, int numSamples) {
+    int i = 0;
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128i* at = reinterpret_cast<const __m128i*>(accumulator + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i),
+                         _mm_packs_epi32(_mm_loadu_si128(at), _mm_loadu_si128(at + 1)));
+    }
+#elif defined(HIFI_AUDIO_MIX_NEON)
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_s16(destination + i, vcombine_s16(vqmovn_s32(vld1q_s32(accumulator + i)),
+                                                vqmovn_s32(vld1q_s32(accumulator + i + 4))));
+    }
+#endif
+
+    for (; i < numSamples; ++i) {
+        destination[i] = saturateSample(accumulator[i]);
+    }
+}
+
+/// samples[i] *= gain, for the planar float buffers of AudioGain and AudioPan
+inline void multiply(float* samples, float gain, int numSamples) {
+    int i = 0;
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+    const __m128 gain4 = _mm_set1_ps(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gain4));
+        _mm_storeu_ps(samples + i + 4, _mm_mul_ps(_mm_loadu_ps(samples + i + 4), gain4));
+    }
+#elif defined(HIFI_AUDIO_MIX_NEON)
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+        vst1q_f32(samples + i + 4, vmulq_n_f32(vld1q_f32(samples + i + 4), gain));
+    }
+#endif
+
+    for (; i < numSamples; ++i) {
+        samples[i] *= gain;
+    }
+}
+
+const int BIQUAD_LANES = 4;
+
+// outputs this close to zero are flushed so that decaying filters never go denormal, same as AudioBiquad
+const float BIQUAD_FLUSH_THRESHOLD = 0.000001f;
+
+/// one biquad stage for up to BIQUAD_LANES channels in transposed direct form II, one channel per lane.
+/// the coefficients are named the way AudioBiquad names them, a0 - a2 feed forward and b1 - b2 feed back
+struct BiquadStage {
+    float a0[BIQUAD_LANES];
+    float a1[BIQUAD_LANES];
+    float a2[BIQUAD_LANES];
+    float b1[BIQUAD_LANES];
+    float b2[BIQUAD_LANES];
+    float s1[BIQUAD_LANES];
+    float s2[BIQUAD_LANES];
+};
+
+#if defined(HIFI_AUDIO_MIX_SSE2)
+
+struct BiquadVectors {
+    __m128 a0, a1, a2, b1, b2, s1, s2;
+};
+
+inline void loadBiquadStage(BiquadVectors& vectors, const BiquadStage& stage) {
+    vectors.a0 = _mm_loadu_ps(stage.a0);
+    vectors.a1 = _mm_loadu_ps(stage.a1);
+    vectors.a2 = _mm_loadu_ps(stage.a2);
+    vectors.b1 = _mm_loadu_ps(stage.b1);
+    vectors.b2 = _mm_loadu_ps(stage.b2);
+    vectors.s1 = _mm_loadu_ps(stage.s1);
+    vectors.s2 = _mm_loadu_ps(stage.s2);
+}
+
+inline void storeBiquadState(BiquadStage& stage, const BiquadVectors& vectors) {
+    _mm_storeu_ps(stage.s1, vectors.s1);
+    _mm_storeu_ps(stage.s2, vectors.s2);
+}
+
+inline __m128 renderBiquadFrame(BiquadVectors* stages, int numStages, __m128 x) {
+    const __m128 threshold = _mm_set1_ps(BIQUAD_FLUSH_THRESHOLD);
+    const __m128 negativeThreshold = _mm_set1_ps(-BIQUAD_FLUSH_THRESHOLD);
+
+    for (int k = 0; k < numStages; ++k) {
+        BiquadVectors& stage = stages[k];
+        __m128 y = _mm_add_ps(_mm_mul_ps(stage.a0, x), stage.s1);
+        y = _mm_andnot_ps(_mm_and_ps(_mm_cmpge_ps(y, negativeThreshold), _mm_cmplt_ps(y, threshold)), y);
+
+        stage.s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(stage.a1, x), _mm_mul_ps(stage.b1, y)), stage.s2);
+        stage.s2 = _mm_sub_ps(_mm_mul_ps(stage.a2, x), _mm_mul_ps(stage.b2, y));
+        x = y;
+    }
+    return x;
+}
+
+inline __m128 loadBiquadLanes(const float* lanes) {
+    return _mm_loadu_ps(lanes);
+}
+
+inline void storeBiquadLanes(float* lanes, __m128 x) {
+    _mm_storeu_ps(lanes, x);
+}
+
+#elif defined(HIFI_AUDIO_MIX_NEON)
+
+struct BiquadVectors {
+    float32x4_t a0, a1, a2, b1, b2, s1, s2;
+};
+
+inline void loadBiquadStage(BiquadVectors& vectors, const BiquadStage& stage) {
+    vectors.a0 = vld1q_f32(stage.a0);
+    vectors.a1 = vld1q_f32(stage.a1);
+    vectors.a2 = vld1q_f32(stage.a2);
+    vectors.b1 = vld1q_f32(stage.b1);
+    vectors.b2 = vld1q_f32(stage.b2);
+    vectors.s1 = vld1q_f32(stage.s1);
+    vectors.s2 = vld1q_f32(stage.s2);
+}
+
+inline void storeBiquadState(BiquadStage& stage, const BiquadVectors& vectors) {
+    vst1q_f32(stage.s1, vectors.s1);
+    vst1q_f32(stage.s2, vectors.s2);
+}
+
+inline float32x4_t renderBiquadFrame(BiquadVectors* stages, int numStages, float32x4_t x) {
+    const float32x4_t threshold = vdupq_n_f32(BIQUAD_FLUSH_THRESHOLD);
+    const float32x4_t negativeThreshold = vdupq_n_f32(-BIQUAD_FLUSH_THRESHOLD);
+
+    for (int k = 0; k < numStages; ++k) {
+        BiquadVectors& stage = stages[k];
+        float32x4_t y = vaddq_f32(vmulq_f32(stage.a0, x), stage.s1);
+        uint32x4_t isNearZero = vandq_u32(vcgeq_f32(y, negativeThreshold), vcltq_f32(y, threshold));
+        y = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(y), isNearZero));
+
+        // separate multiplies and adds rather than vmlaq so the lanes round the way the scalar path does
+        stage.s1 = vaddq_f32(vsubq_f32(vmulq_f32(stage.a1, x), vmulq_f32(stage.b1, y)), stage.s2);
+        stage.s2 = vsubq_f32(vmulq_f32(stage.a2, x), vmulq_f32(stage.b2, y));
+        x = y;
+    }
+    return x;
+}
+
+inline float32x4_t loadBiquadLanes(const float* lanes) {
+    return vld1q_f32(lanes);
+}
+
+inline void storeBiquadLanes(float* lanes, float32x4_t x) {
+    vst1q_f32(lanes, x);
+}
+
+#else
+
+struct BiquadVectors {
+    BiquadStage lanes;
+};
+
+inline void loadBiquadStage(BiquadVectors& vectors, const BiquadStage& stage) {
+    vectors.lanes = stage;
+}
+
+inline void storeBiquadState(BiquadStage& stage, const BiquadVectors& vectors) {
+    memcpy(stage.s1, vectors.lanes.s1, sizeof(stage.s1));
+    memcpy(stage.s2, vectors.lanes.s2, sizeof(stage.s2));
+}
+
+struct BiquadFrame {
+    float lanes[BIQUAD_LANES];
+};
+
+inline BiquadFrame renderBiquadFrame(BiquadVectors* stages, int numStages, BiquadFrame x) {
+    for (int k = 0; k < numStages; ++k) {
+        BiquadStage& stage = stages[k].lanes;
+        for (int j = 0; j < BIQUAD_LANES; ++j) {
+            float y = stage.a0[j] * x.lanes[j] + stage.s1[j];
+            y = (y >= -BIQUAD_FLUSH_THRESHOLD && y < BIQUAD_FLUSH_THRESHOLD) ? 0.0f : y;
+
+            stage.s1[j] = stage.a1[j] * x.lanes[j] - stage.b1[j] * y + stage.s2[j];
+            stage.s2[j] = stage.a2[j] * x.lanes[j] - stage.b2[j] * y;
+            x.lanes[j] = y;
+        }
+    }
+    return x;
+}
+
+inline BiquadFrame loadBiquadLanes(const float* lanes) {
+    BiquadFrame frame;
+    memcpy(frame.lanes, lanes, sizeof(frame.lanes));
+    return frame;
+}
+
+inline void storeBiquadLanes(float* lanes, BiquadFrame x) {
+    memcpy(lanes, x.lanes, sizeof(x.lanes));
+}
+
+#endif
+
+/// runs numFrames interleaved frames of numChannels through the NUM_STAGES stages in order, in may equal out.
+/// samples are divided by scale on the way in and multiplied by it on the way out, saturating to int16_t
+template< int NUM_STAGES >
+inline void biquadCascade(BiquadStage* stages, const int16_t* in, int16_t* out, int numFrames, int numChannels,
+                          float scale) {
+    BiquadVectors vectors[NUM_STAGES];
+    for (int k = 0; k < NUM_STAGES; ++k) {
+        loadBiquadStage(vectors[k], stages[k]);
+    }
+
+    const float inverseScale = 1.0f / scale;
+    float lanes[BIQUAD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (int i = 0; i < numFrames; ++i) {
+        for (int j = 0; j < numChannels; ++j) {
+            lanes[j] = in[j] * inverseScale;
+        }
+        in += numChannels;
+
+        storeBiquadLanes(lanes, renderBiquadFrame(vectors, NUM_STAGES, loadBiquadLanes(lanes)));
+
+        for (int j = 0; j < numChannels; ++j) {
+            *out++ = saturateSample((int32_t)(lanes[j] * scale));
+        }
+    }
+
+    for (int k = 0; k < NUM_STAGES; ++k) {
+        storeBiquadState(stages[k], vectors[k]);
+    }
+}
+
+/// runs numFrames frames of numChannels planar float channels through the NUM_STAGES stages in order, in place
+template< int NUM_STAGES >
+inline void biquadCascade(BiquadStage* stages, float** channels, int numFrames, int numChannels) {
+    BiquadVectors vectors[NUM_STAGES];
+    for (int k = 0; k < NUM_STAGES; ++k) {
+        loadBiquadStage(vectors[k], stages[k]);
+    }
+
+    float lanes[BIQUAD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (int i = 0; i < numFrames; ++i) {
+        for (int j = 0; j < numChannels; ++j) {
+            lanes[j] = channels[j][i];
+        }
+
+        storeBiquadLanes(lanes, renderBiquadFrame(vectors, NUM_STAGES, loadBiquadLanes(lanes)));
+
+        for (int j = 0; j < numChannels; ++j) {
+            channels[j][i] = lanes[j];
+        }
+    }
+
+    for (int k = 0; k < NUM_STAGES; ++k) {
+        storeBiquadState(stages[k], vectors[k]);
+    }
+}
+
+}
+
+#endif // hifi_AudioMixKernel_h
@@ -12,6 +12,8 @@
 #ifndef hifi_AudioPan_h
 #define hifi_AudioPan_h
 
+#include "AudioMixKernel.h"
+
 class AudioPan
 {
     float32_t _pan;
@@ -47,55 +49,8 @@ inline void AudioPan::render(AudioBufferFloat32& frameBuffer) {
     }
     
     float32_t** samples = frameBuffer.getFrameData();
-    
-    bool frameAlignment16 = (frameBuffer.getFrameCount() & 0x0F) == 0;
-    if (frameAlignment16) {
-        
-        if (frameBuffer.getChannelCount() == 2) {
-            
-            for (uint32_t i = 0; i < frameBuffer.getFrameCount(); i += 16) {
-                samples[0][i + 0] *= _gainLeft;
-                samples[0][i + 1] *= _gainLeft;
-                samples[0][i + 2] *= _gainLeft;
-                samples[0][i + 3] *= _gainLeft;
-                samples[0][i + 4] *= _gainLeft;
-                samples[0][i + 5] *= _gainLeft;
-                samples[0][i + 6] *= _gainLeft;
-                samples[0][i + 7] *= _gainLeft;
-                samples[0][i + 8] *= _gainLeft;
-                samples[0][i + 9] *= _gainLeft;
-                samples[0][i + 10] *= _gainLeft;
-                samples[0][i + 11] *= _gainLeft;
-                samples[0][i + 12] *= _gainLeft;
-                samples[0][i + 13] *= _gainLeft;
-                samples[0][i + 14] *= _gainLeft;
-                samples[0][i + 15] *= _gainLeft;
-                samples[1][i + 0] *= _gainRight;
-                samples[1][i + 1] *= _gainRight;
-                samples[1][i + 2] *= _gainRight;
-                samples[1][i + 3] *= _gainRight;
-                samples[1][i + 4] *= _gainRight;
-                samples[1][i + 5] *= _gainRight;
-                samples[1][i + 6] *= _gainRight;
-                samples[1][i + 7] *= _gainRight;
-                samples[1][i + 8] *= _gainRight;
-                samples[1][i + 9] *= _gainRight;
-                samples[1][i + 10] *= _gainRight;
-                samples[1][i + 11] *= _gainRight;
-                samples[1][i + 12] *= _gainRight;
-                samples[1][i + 13] *= _gainRight;
-                samples[1][i + 14] *= _gainRight;
-                samples[1][i + 15] *= _gainRight;
-            }
-        } else {
-            assert("unsupported channel format");
-        }
-    } else {
-        for (uint32_t i = 0; i < frameBuffer.getFrameCount(); i += 1) {
-            samples[0][i] *= _gainLeft;
-            samples[1][i] *= _gainRight;
-        }
-    }
+    AudioMixKernel::multiply(samples[0], _gainLeft, frameBuffer.getFrameCount());
+    AudioMixKernel::multiply(samples[1], _gainRight, frameBuffer.getFrameCount());
 }
 
 inline void AudioPan::updateCoefficients() {
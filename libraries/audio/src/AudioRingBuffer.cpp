@@ -25,17 +25,19 @@ _sampleCapacity(numFrameSamples * numFramesCapacity),
 _bufferLength(numFrameSamples * (numFramesCapacity + 1)),
 _numFrameSamples(numFrameSamples),
 _randomAccessMode(randomAccessMode),
-_overflowCount(0)
+_isLockFree(false),
+_endOfLastWrite(NULL),
+_pendingDiscardIndex(-1),
+_overflowCount(0),
+_nextOutput(NULL),
+_releasedOutput(NULL)
 {
     if (numFrameSamples) {
         _buffer = new int16_t[_bufferLength];
         memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-        _nextOutput = _buffer;
-        _endOfLastWrite = _buffer;
+        clear();
     } else {
         _buffer = NULL;
-        _nextOutput = NULL;
-        _endOfLastWrite = NULL;
     }
 };
 
@@ -62,8 +64,10 @@ void AudioRingBuffer::resizeForFrameSize(int numFrameSamples) {
 }
 
 void AudioRingBuffer::clear() {
-    _endOfLastWrite = _buffer;
-    _nextOutput = _buffer;
+    _endOfLastWrite.store(_buffer);
+    _nextOutput.store(_buffer);
+    _releasedOutput.store(_buffer);
+    _pendingDiscardIndex.store(-1);
 }
 
 int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
@@ -71,6 +75,7 @@ int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
 }
 
 int AudioRingBuffer::readData(char *data, int maxSize) {
+    int16_t* nextOutput = applyPendingDiscard();
 
     // only copy up to the number of samples we have available
     int numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), samplesAvailable());
@@ -79,17 +84,17 @@ int AudioRingBuffer::readData(char *data, int maxSize) {
     // differently. Namely, if anything has been written, we say we have as many samples as they ask for
     // otherwise we say we have nothing available
     if (_randomAccessMode) {
-        numReadSamples = _endOfLastWrite ? (maxSize / sizeof(int16_t)) : 0;
+        numReadSamples = _endOfLastWrite.load() ? (maxSize / sizeof(int16_t)) : 0;
     }
 
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
+    if (nextOutput + numReadSamples > _buffer + _bufferLength) {
         // we're going to need to do two reads to get this data, it wraps around the edge
 
         // read to the end of the buffer
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
-        memcpy(data, _nextOutput, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - nextOutput;
+        memcpy(data, nextOutput, numSamplesToEnd * sizeof(int16_t));
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
+            memset(nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
         }
 
         // read the rest from the beginning of the buffer
@@ -99,14 +104,17 @@ int AudioRingBuffer::readData(char *data, int maxSize) {
         }
     } else {
         // read the data
-        memcpy(data, _nextOutput, numReadSamples * sizeof(int16_t));
+        memcpy(data, nextOutput, numReadSamples * sizeof(int16_t));
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
+            memset(nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
         }
     }
 
-    // push the position of _nextOutput by the number of samples read
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numReadSamples);
+    // push the position of _nextOutput by the number of samples read.
+    // the samples have been copied out, so the writer can have them back straight away
+    nextOutput = shiftedPositionAccomodatingWrap(nextOutput, numReadSamples);
+    _nextOutput.storeRelease(nextOutput);
+    _releasedOutput.storeRelease(nextOutput);
 
     return numReadSamples * sizeof(int16_t);
 }
@@ -118,57 +126,132 @@ int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
 int AudioRingBuffer::writeData(const char* data, int maxSize) {
     // make sure we have enough bytes left for this to be the right amount of audio
     // otherwise we should not copy that data, and leave the buffer pointers where they are
-    int samplesToCopy = std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity);
+    int samplesToCopy = prepareForWrite(maxSize / sizeof(int16_t));
 
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qDebug() << "Overflowed ring buffer! Overwriting old data";
-    }
-
-    if (_endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
-        memcpy(_endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
+    int16_t* endOfLastWrite = _endOfLastWrite.load();
+    if (endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
+        memcpy(endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memcpy(endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
         memcpy(_buffer, data + (numSamplesToEnd * sizeof(int16_t)), (samplesToCopy - numSamplesToEnd) * sizeof(int16_t));
     }
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+    _endOfLastWrite.storeRelease(shiftedPositionAccomodatingWrap(endOfLastWrite, samplesToCopy));
 
     return samplesToCopy * sizeof(int16_t);
 }
 
 int16_t& AudioRingBuffer::operator[](const int index) {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(applyPendingDiscard(), index);
 }
 
 const int16_t& AudioRingBuffer::operator[] (const int index) const {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return *shiftedPositionAccomodatingWrap(_nextOutput.load(), index);
 }
 
 void AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numSamples);
+    int16_t* nextOutput = applyPendingDiscard();
+
+    // in lock-free mode the samples just shifted past are still being read through the last nextOutput(),
+    // hold on to them until the next read
+    _releasedOutput.storeRelease(_isLockFree ? nextOutput : shiftedPositionAccomodatingWrap(nextOutput, numSamples));
+    _nextOutput.storeRelease(shiftedPositionAccomodatingWrap(nextOutput, numSamples));
+}
+
+void AudioRingBuffer::discardOldestSamples(int numSamples) {
+    if (!_isLockFree) {
+        shiftReadPosition(numSamples);
+        return;
+    }
+
+    // build on a discard the reader hasn't picked up yet, otherwise start from where the reader is
+    int16_t* readPosition = _nextOutput.loadAcquire();
+    int pendingDiscardIndex = _pendingDiscardIndex.loadAcquire();
+    if (pendingDiscardIndex >= 0) {
+        readPosition = _buffer + pendingDiscardIndex;
+    }
+
+    int16_t* discardPosition = shiftedPositionAccomodatingWrap(readPosition, numSamples);
+    _pendingDiscardIndex.storeRelease(discardPosition - _buffer);
+}
+
+int16_t* AudioRingBuffer::applyPendingDiscard() {
+    int16_t* nextOutput = _nextOutput.load();
+    if (!_isLockFree) {
+        return nextOutput;
+    }
+
+    int pendingDiscardIndex = _pendingDiscardIndex.fetchAndStoreAcquire(-1);
+    if (pendingDiscardIndex >= 0) {
+        int16_t* discardPosition = _buffer + pendingDiscardIndex;
+        int16_t* endOfLastWrite = _endOfLastWrite.loadAcquire();
+
+        // the reader may have already read past the position the writer asked for
+        if (samplesBetween(nextOutput, discardPosition) <= samplesBetween(nextOutput, endOfLastWrite)) {
+            nextOutput = discardPosition;
+            _nextOutput.storeRelease(nextOutput);
+            _releasedOutput.storeRelease(nextOutput);
+        }
+    }
+    return nextOutput;
 }
 
 int AudioRingBuffer::samplesAvailable() const {
-    if (!_endOfLastWrite) {
+    int16_t* endOfLastWrite = _endOfLastWrite.loadAcquire();
+    if (!endOfLastWrite) {
         return 0;
     }
 
-    int sampleDifference = _endOfLastWrite - _nextOutput;
+    int16_t* nextOutput = _nextOutput.loadAcquire();
+    int sampleDifference = samplesBetween(nextOutput, endOfLastWrite);
+
+    if (_isLockFree) {
+        // samples the writer has asked to discard are already gone as far as either side is concerned
+        int pendingDiscardIndex = _pendingDiscardIndex.loadAcquire();
+        if (pendingDiscardIndex >= 0) {
+            int discardedSamples = samplesBetween(nextOutput, _buffer + pendingDiscardIndex);
+            if (discardedSamples <= sampleDifference) {
+                sampleDifference -= discardedSamples;
+            }
+        }
+    }
+    return sampleDifference;
+}
+
+int AudioRingBuffer::samplesBetween(const int16_t* from, const int16_t* to) const {
+    int sampleDifference = to - from;
     if (sampleDifference < 0) {
         sampleDifference += _bufferLength;
     }
     return sampleDifference;
 }
 
+int AudioRingBuffer::prepareForWrite(int numSamples) {
+    int samplesToCopy = std::min(numSamples, _sampleCapacity);
+
+    // the writer can only use the space the reader has released, which in lock-free mode trails _nextOutput
+    int samplesRoomFor = _sampleCapacity - samplesBetween(_releasedOutput.loadAcquire(), _endOfLastWrite.load());
+    if (samplesToCopy > samplesRoomFor) {
+        _overflowCount++;
+
+        if (_isLockFree) {
+            // the read position belongs to the reader, drop the new data rather than overwrite the old
+            samplesToCopy = samplesRoomFor;
+            qDebug() << "Overflowed ring buffer! Dropping new data";
+        } else {
+            // there's not enough room for this write.  erase old data to make room for this new data
+            int samplesToDelete = samplesToCopy - samplesRoomFor;
+            shiftReadPosition(samplesToDelete);
+            qDebug() << "Overflowed ring buffer! Overwriting old data";
+        }
+    }
+    return samplesToCopy;
+}
+
 int AudioRingBuffer::addSilentSamples(int silentSamples) {
 
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
+    int samplesRoomFor = _sampleCapacity - samplesBetween(_releasedOutput.loadAcquire(), _endOfLastWrite.load());
     if (silentSamples > samplesRoomFor) {
         // there's not enough room for this write. write as many silent samples as we have room for
         silentSamples = samplesRoomFor;
@@ -177,14 +260,15 @@ int AudioRingBuffer::addSilentSamples(int silentSamples) {
 
     // memset zeroes into the buffer, accomodate a wrap around the end
     // push the _endOfLastWrite to the correct spot
-    if (_endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
-        memset(_endOfLastWrite, 0, silentSamples * sizeof(int16_t));
+    int16_t* endOfLastWrite = _endOfLastWrite.load();
+    if (endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
+        memset(endOfLastWrite, 0, silentSamples * sizeof(int16_t));
     } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memset(_endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memset(endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
         memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
     }
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, silentSamples);
+    _endOfLastWrite.storeRelease(shiftedPositionAccomodatingWrap(endOfLastWrite, silentSamples));
 
     return silentSamples;
 }
@@ -225,47 +309,35 @@ float AudioRingBuffer::getFrameLoudness(ConstIterator frameStart) const {
 }
 
 float AudioRingBuffer::getNextOutputFrameLoudness() const {
-    return getFrameLoudness(_nextOutput);
+    return getFrameLoudness(_nextOutput.load());
 }
 
 int AudioRingBuffer::writeSamples(ConstIterator source, int maxSamples) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qDebug() << "Overflowed ring buffer! Overwriting old data";
-    }
+    int samplesToCopy = prepareForWrite(maxSamples);
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load();
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = *source;
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.storeRelease(endOfLastWrite);
 
     return samplesToCopy;
 }
 
 int AudioRingBuffer::writeSamplesWithFade(ConstIterator source, int maxSamples, float fade) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qDebug() << "Overflowed ring buffer! Overwriting old data";
-    }
+    int samplesToCopy = prepareForWrite(maxSamples);
 
+    int16_t* endOfLastWrite = _endOfLastWrite.load();
     int16_t* bufferLast = _buffer + _bufferLength - 1;
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (int16_t)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = (int16_t)((float)(*source) * fade);
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.storeRelease(endOfLastWrite);
 
     return samplesToCopy;
 }
@@ -14,6 +14,8 @@
 
 #include "AudioConstants.h"
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -21,6 +23,18 @@
 
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
+const int RING_BUFFER_CACHE_LINE_BYTES = 64;
+
+// In lock-free mode the ring buffer may be written by one thread and read by another without any external locking.
+//
+// The writer owns _endOfLastWrite and the reader owns _nextOutput, each is published with release semantics and
+// they sit on separate cache lines. The writer never moves the read position: an overflow drops the new samples
+// instead of overwriting old ones, and discardOldestSamples asks the reader to skip ahead on its next read.
+//
+// The samples handed out by the most recent nextOutput/shiftReadPosition stay reserved until the following read,
+// so a ConstIterator taken from nextOutput can be read after the read position has moved past it.
+//
+// reset, clear and resizeForFrameSize are never lock-free, both sides must be idle when they are called.
 class AudioRingBuffer {
 public:
     AudioRingBuffer(int numFrameSamples, bool randomAccessMode = false, int numFramesCapacity = DEFAULT_RING_BUFFER_FRAME_CAPACITY);
@@ -31,6 +45,10 @@ public:
 
     void clear();
 
+    /// must be set before the buffer is shared between a writing and a reading thread
+    void setIsLockFree(bool isLockFree) { _isLockFree = isLockFree; }
+    bool isLockFree() const { return _isLockFree; }
+
     int getSampleCapacity() const { return _sampleCapacity; }
     int getFrameCapacity() const { return _frameCapacity; }
 
@@ -45,6 +63,9 @@ public:
 
     void shiftReadPosition(unsigned int numSamples);
 
+    /// drops the oldest samples, safe to call from the writing thread in lock-free mode
+    void discardOldestSamples(int numSamples);
+
     float getNextOutputFrameLoudness() const;
 
     int samplesAvailable() const;
@@ -65,18 +86,34 @@ protected:
     AudioRingBuffer& operator= (const AudioRingBuffer&);
 
     int16_t* shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const;
+    int samplesBetween(const int16_t* from, const int16_t* to) const;
+
+    /// returns how many of numSamples can be written, in the default mode this makes room by dropping old samples
+    int prepareForWrite(int numSamples);
+
+    /// called by the reader before it touches _nextOutput, applies a discard asked for by the writer
+    int16_t* applyPendingDiscard();
 
     int _frameCapacity;
     int _sampleCapacity;
     int _bufferLength;      // actual length of _buffer: will be one frame larger than _sampleCapacity
     int _numFrameSamples;
-    int16_t* _nextOutput;
-    int16_t* _endOfLastWrite;
     int16_t* _buffer;
     bool _randomAccessMode; /// will this ringbuffer be used for random access? if so, do some special processing
+    bool _isLockFree;
 
+    // written by the writer only
+    char _writerPadding[RING_BUFFER_CACHE_LINE_BYTES];
+    QAtomicPointer<int16_t> _endOfLastWrite;
+    QAtomicInt _pendingDiscardIndex;    /// the read position the writer asked the reader to skip to, -1 for none
     int _overflowCount; /// how many times has the ring buffer has overwritten old data
 
+    // written by the reader only
+    char _readerPadding[RING_BUFFER_CACHE_LINE_BYTES];
+    QAtomicPointer<int16_t> _nextOutput;
+    QAtomicPointer<int16_t> _releasedOutput; /// the writer may write up to here, trails _nextOutput in lock-free mode
+    char _endPadding[RING_BUFFER_CACHE_LINE_BYTES];
+
 public:
     class ConstIterator { //public std::iterator < std::forward_iterator_tag, int16_t > {
     public:
@@ -174,8 +211,10 @@ public:
         int16_t* _at;
     };
 
-    ConstIterator nextOutput() const { return ConstIterator(_buffer, _bufferLength, _nextOutput); }
-    ConstIterator lastFrameWritten() const { return ConstIterator(_buffer, _bufferLength, _endOfLastWrite) - _numFrameSamples; }
+    ConstIterator nextOutput() { return ConstIterator(_buffer, _bufferLength, applyPendingDiscard()); }
+    ConstIterator lastFrameWritten() const {
+        return ConstIterator(_buffer, _bufferLength, _endOfLastWrite.load()) - _numFrameSamples;
+    }
 
     float getFrameLoudness(ConstIterator frameStart) const;
 
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "AudioInjectorScheduler.h"
+
 #include "AudioScriptingInterface.h"
 
 void registerAudioMetaTypes(QScriptEngine* engine) {
@@ -49,34 +51,39 @@ AudioInjector* AudioScriptingInterface::playSound(Sound* sound, const AudioInjec
         AudioInjectorOptions optionsCopy = injectorOptions;
         optionsCopy.stereo = sound->isStereo();
         
-        AudioInjector* injector = new AudioInjector(sound, optionsCopy);
-        injector->setLocalAudioInterface(_localAudioInterface);
-        
-        QThread* injectorThread = new QThread();
-        injectorThread->setObjectName("Audio Injector Thread");
-        
-        injector->moveToThread(injectorThread);
-        
-        // start injecting when the injector thread starts
-        connect(injectorThread, &QThread::started, injector, &AudioInjector::injectAudio);
-        
-        // connect the right slots and signals so that the AudioInjector is killed once the injection is complete
-        connect(injector, &AudioInjector::finished, injector, &AudioInjector::deleteLater);
-        connect(injector, &AudioInjector::finished, injectorThread, &QThread::quit);
-        connect(injector, &AudioInjector::finished, this, &AudioScriptingInterface::injectorStopped);
-        connect(injectorThread, &QThread::finished, injectorThread, &QThread::deleteLater);
-        
-        injectorThread->start();
-        
-        _activeInjectors.append(QPointer<AudioInjector>(injector));
-        
-        return injector;
+        return startInjector(new AudioInjector(sound, optionsCopy));
     } else {
         qDebug() << "AudioScriptingInterface::playSound called with null Sound object.";
         return NULL;
     }
 }
 
+AudioInjector* AudioScriptingInterface::playBuffer(const QByteArray& samples,
+        const AudioInjectorOptions& injectorOptions) {
+    if (samples.isEmpty()) {
+        qDebug() << "AudioScriptingInterface::playBuffer called with no samples.";
+        return NULL;
+    }
+    return startInjector(new AudioInjector(samples, injectorOptions));
+}
+
+AudioInjector* AudioScriptingInterface::startInjector(AudioInjector* injector) {
+    injector->setLocalAudioInterface(_localAudioInterface);
+    
+    // every injector shares the scheduler's thread instead of spinning up one of its own
+    injector->moveToThread(AudioInjectorScheduler::getInstance().getThread());
+    
+    // connect the right slots and signals so that the AudioInjector is killed once the injection is complete
+    connect(injector, &AudioInjector::finished, injector, &AudioInjector::deleteLater);
+    connect(injector, &AudioInjector::finished, this, &AudioScriptingInterface::injectorStopped);
+    
+    QMetaObject::invokeMethod(injector, "injectAudio", Qt::QueuedConnection);
+    
+    _activeInjectors.append(QPointer<AudioInjector>(injector));
+    
+    return injector;
+}
+
 void AudioScriptingInterface::stopInjector(AudioInjector* injector) {
     if (injector) {
         injector->stop();
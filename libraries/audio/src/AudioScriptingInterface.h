@@ -32,6 +32,11 @@ public slots:
 
     AudioInjector* playSound(Sound* sound, const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
     
+    /// Plays 16-bit samples that a script has made, such as an ArrayBuffer or a typed array over one, without copying
+    /// them when the view covers the whole buffer.
+    AudioInjector* playBuffer(const QByteArray& samples,
+        const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
+    
     void stopInjector(AudioInjector* injector);
     bool isInjectorPlaying(AudioInjector* injector);
     
@@ -45,6 +50,7 @@ signals:
     
 private:
     AudioScriptingInterface();
+    AudioInjector* startInjector(AudioInjector* injector);
     QList< QPointer<AudioInjector> > _activeInjectors;
     AbstractAudioInterface* _localAudioInterface;
 };
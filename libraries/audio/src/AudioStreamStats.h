@@ -32,6 +32,10 @@ public:
         _consecutiveNotMixedCount(0),
         _overflowCount(0),
         _framesDropped(0),
+        _calculatedJitterBufferFrames(0),
+        _packetDelayAtPercentile(0),
+        _timeStretchExpansions(0),
+        _timeStretchCompressions(0),
         _packetStreamStats(),
         _packetStreamWindowStats()
     {}
@@ -54,6 +58,12 @@ public:
     quint32 _overflowCount;
     quint32 _framesDropped;
 
+    // decisions of the late loss percentile method
+    quint16 _calculatedJitterBufferFrames;
+    quint32 _packetDelayAtPercentile;   // usecs
+    quint32 _timeStretchExpansions;
+    quint32 _timeStretchCompressions;
+
     PacketStreamStats _packetStreamStats;
     PacketStreamStats _packetStreamWindowStats;
 };
@@ -0,0 +1,142 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include "AudioMixKernel.h"
+
+#include "AudioTimeStretch.h"
+
+// a frame is split so that the longest period plus the cross-fade still fits in it
+static const int OVERLAP_DIVISOR = 3;
+static const int MIN_PERIOD_DIVISOR = 5;
+
+// how well the frame has to match itself one period later before we'll cut or repeat that period
+static const float MIN_PERIOD_CORRELATION = 0.7f;
+
+// below this RMS there is nothing to hear, so any period will do and the longest one moves the buffer the most
+static const float MAX_SILENT_RMS = 64.0f;
+
+float AudioTimeStretch::sampleAt(const int16_t* samples, int frame, int numChannels) {
+    const int16_t* frameAt = samples + frame * numChannels;
+    float sample = frameAt[0];
+    for (int channel = 1; channel < numChannels; channel++) {
+        sample += frameAt[channel];
+    }
+    return sample / numChannels;
+}
+
+int AudioTimeStretch::findPeriod(const int16_t* samples, int numFrames, int numChannels, int overlap) {
+    const int minPeriod = numFrames / MIN_PERIOD_DIVISOR;
+    const int maxPeriod = numFrames - overlap;
+    if (overlap < 1 || minPeriod < 1 || maxPeriod < minPeriod) {
+        return 0;
+    }
+
+    float leadingEnergy = 0.0f;
+    float laggingEnergy = 0.0f;
+    for (int i = 0; i < overlap; i++) {
+        float leading = sampleAt(samples, i, numChannels);
+        float lagging = sampleAt(samples, i + minPeriod, numChannels);
+        leadingEnergy += leading * leading;
+        laggingEnergy += lagging * lagging;
+    }
+
+    const float maxSilentEnergy = overlap * MAX_SILENT_RMS * MAX_SILENT_RMS;
+
+    int bestPeriod = 0;
+    float bestCorrelation = MIN_PERIOD_CORRELATION;
+
+    for (int period = minPeriod; period <= maxPeriod; period++) {
+        if (leadingEnergy <= maxSilentEnergy && laggingEnergy <= maxSilentEnergy) {
+            // too quiet to hear a seam, keep looking for the longest quiet period
+            bestPeriod = period;
+            bestCorrelation = 1.0f;
+        } else if (leadingEnergy > 0.0f && laggingEnergy > 0.0f) {
+            float crossEnergy = 0.0f;
+            for (int i = 0; i < overlap; i++) {
+                crossEnergy += sampleAt(samples, i, numChannels) * sampleAt(samples, i + period, numChannels);
+            }
+
+            float correlation = crossEnergy / sqrtf(leadingEnergy * laggingEnergy);
+            if (correlation > bestCorrelation) {
+                bestPeriod = period;
+                bestCorrelation = correlation;
+            }
+        }
+
+        // slide the lagging window along by one frame
+        if (period < maxPeriod) {
+            float leaving = sampleAt(samples, period, numChannels);
+            float entering = sampleAt(samples, period + overlap, numChannels);
+            laggingEnergy += entering * entering - leaving * leaving;
+            laggingEnergy = laggingEnergy < 0.0f ? 0.0f : laggingEnergy;
+        }
+    }
+
+    return bestPeriod;
+}
+
+int AudioTimeStretch::compress(const int16_t* samples, int numFrames, int numChannels, QByteArray& destination) {
+    const int overlap = numFrames / OVERLAP_DIVISOR;
+    int period = findPeriod(samples, numFrames, numChannels, overlap);
+    if (period == 0) {
+        return 0;
+    }
+
+    int offset = destination.size();
+    destination.resize(offset + (numFrames - period) * numChannels * sizeof(int16_t));
+    int16_t* outputAt = reinterpret_cast<int16_t*>(destination.data() + offset);
+
+    // fade from the start of the frame into the same point one period on, then carry on from there
+    for (int i = 0; i < overlap; i++) {
+        float fade = (i + 0.5f) / overlap;
+        for (int channel = 0; channel < numChannels; channel++) {
+            float sample = (1.0f - fade) * samples[i * numChannels + channel]
+                + fade * samples[(i + period) * numChannels + channel];
+            *outputAt++ = AudioMixKernel::saturateSample((int32_t)sample);
+        }
+    }
+
+    int remainingSamples = (numFrames - period - overlap) * numChannels;
+    memcpy(outputAt, samples + (period + overlap) * numChannels, remainingSamples * sizeof(int16_t));
+
+    return period;
+}
+
+int AudioTimeStretch::expand(const int16_t* samples, int numFrames, int numChannels, QByteArray& destination) {
+    const int overlap = numFrames / OVERLAP_DIVISOR;
+    int period = findPeriod(samples, numFrames, numChannels, overlap);
+    if (period == 0) {
+        return 0;
+    }
+
+    int offset = destination.size();
+    destination.resize(offset + (numFrames + period) * numChannels * sizeof(int16_t));
+    int16_t* outputAt = reinterpret_cast<int16_t*>(destination.data() + offset);
+
+    // play the first period, fade from there back to the start of the frame, then play the frame out
+    memcpy(outputAt, samples, period * numChannels * sizeof(int16_t));
+    outputAt += period * numChannels;
+
+    for (int i = 0; i < overlap; i++) {
+        float fade = (i + 0.5f) / overlap;
+        for (int channel = 0; channel < numChannels; channel++) {
+            float sample = (1.0f - fade) * samples[(i + period) * numChannels + channel]
+                + fade * samples[i * numChannels + channel];
+            *outputAt++ = AudioMixKernel::saturateSample((int32_t)sample);
+        }
+    }
+
+    int remainingSamples = (numFrames - overlap) * numChannels;
+    memcpy(outputAt, samples + overlap * numChannels, remainingSamples * sizeof(int16_t));
+
+    return period;
+}
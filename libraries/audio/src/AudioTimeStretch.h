@@ -0,0 +1,43 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+
+//
+// Shortens or lengthens a single network frame by one pitch period, so a jitter buffer can drain or grow without
+// audible gaps or dropped frames.
+//
+// The period is picked the way WSOLA picks its overlap, by where the frame best correlates with itself. The frame is
+// then cross-faded with itself shifted by that period: compressing skips one period, expanding plays one twice.
+// Both ends of the frame are kept intact so it still joins up with the frames around it.
+//
+class AudioTimeStretch {
+public:
+    /// appends the frame minus one period to destination and returns the number of frames per channel removed,
+    /// or returns 0 and leaves destination alone if the frame has no period that can be removed cleanly
+    static int compress(const int16_t* samples, int numFrames, int numChannels, QByteArray& destination);
+
+    /// appends the frame plus one period to destination and returns the number of frames per channel added,
+    /// or returns 0 and leaves destination alone if the frame has no period that can be repeated cleanly
+    static int expand(const int16_t* samples, int numFrames, int numChannels, QByteArray& destination);
+
+private:
+    /// returns the lag with the best normalized correlation, or 0 if no lag correlates well enough
+    static int findPeriod(const int16_t* samples, int numFrames, int numChannels, int overlap);
+
+    static float sampleAt(const int16_t* samples, int frame, int numChannels);
+};
+
+#endif // hifi_AudioTimeStretch_h
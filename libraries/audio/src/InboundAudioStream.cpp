@@ -11,11 +11,24 @@
 
 #include <glm/glm.hpp>
 
+#include "AudioTimeStretch.h"
 #include "InboundAudioStream.h"
 #include "PacketHeaders.h"
 
 const int STARVE_HISTORY_CAPACITY = 50;
 
+// the late loss percentile method waits for this many packet delays before it sets the desired frames
+const int MIN_PACKET_DELAYS_FOR_DESIRED_CALC = 100;
+
+// how much of the previous level is kept each packet when smoothing the frames available, about 200ms worth
+const float FRAMES_AVAILABLE_SMOOTHING = 0.95f;
+
+// how far the smoothed frames available can stray from desired before the buffer is time-stretched
+const float TIME_STRETCH_HYSTERESIS_FRAMES = 0.5f;
+
+// a stretch moves the buffer by up to most of a frame, this spaces them out so the change in speed stays subtle
+const int MIN_PACKETS_BETWEEN_TIME_STRETCHES = 5;
+
 InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacity, const Settings& settings) :
     _ringBuffer(numFrameSamples, false, numFramesCapacity),
     _lastPopSucceeded(false),
@@ -38,6 +51,15 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _stdevStatsForDesiredCalcOnTooManyStarves(),
     _calculatedJitterBufferFramesUsingStDev(0),
     _timeGapStatsForDesiredReduction(0, settings._windowSecondsForDesiredReduction),
+    _usePercentileForJitterCalc(settings._usePercentileForJitterCalc),
+    _packetDelayPercentile(PACKET_DELAY_PERCENTILE_WINDOW_PACKETS, 1.0f - settings._targetLateLossRate),
+    _expectedPacketReceivedTime(0),
+    _minPacketDelayThisInterval(std::numeric_limits<quint64>::max()),
+    _calculatedJitterBufferFramesUsingPercentile(0),
+    _smoothedFramesAvailable(0.0f),
+    _packetsSinceTimeStretch(0),
+    _timeStretchExpansions(0),
+    _timeStretchCompressions(0),
     _starveHistoryWindowSeconds(settings._windowSecondsForDesiredCalcOnTooManyStarves),
     _starveHistory(STARVE_HISTORY_CAPACITY),
     _starveThreshold(settings._windowStarveThreshold),
@@ -45,12 +67,15 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
-    _hasReverb(false)
+    _hasReverb(false),
+    _incomingCodec(AudioCodec::PCM),
+    _isInComfortSilence(false)
 {
 }
 
 void InboundAudioStream::reset() {
     _ringBuffer.reset();
+    _isInComfortSilence = false;
     _lastPopSucceeded = false;
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
@@ -71,6 +96,14 @@ void InboundAudioStream::resetStats() {
     _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
     _stdevStatsForDesiredCalcOnTooManyStarves = StDev();
     _timeGapStatsForDesiredReduction.reset();
+    _packetDelayPercentile.reset();
+    _expectedPacketReceivedTime = 0;
+    _minPacketDelayThisInterval = std::numeric_limits<quint64>::max();
+    _calculatedJitterBufferFramesUsingPercentile = 0;
+    _smoothedFramesAvailable = 0.0f;
+    _packetsSinceTimeStretch = 0;
+    _timeStretchExpansions = 0;
+    _timeStretchCompressions = 0;
     _starveHistory.clear();
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
@@ -94,6 +127,13 @@ void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _timeGapStatsForDesiredCalcOnTooManyStarves.currentIntervalComplete();
     _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
+
+    // let the reference for packet delays follow a sender whose clock runs slower than ours:
+    // the earliest packet of the last interval becomes a packet with no delay
+    if (_minPacketDelayThisInterval != std::numeric_limits<quint64>::max()) {
+        _expectedPacketReceivedTime += _minPacketDelayThisInterval;
+        _minPacketDelayThisInterval = std::numeric_limits<quint64>::max();
+    }
 }
 
 int InboundAudioStream::parseData(const QByteArray& packet) {
@@ -113,6 +153,7 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
     SequenceNumberStats::ArrivalInfo arrivalInfo = _incomingSequenceNumberStats.sequenceNumberReceived(sequence, senderUUID);
 
     packetReceivedUpdateTimingStats();
+    packetReceivedUpdatePacketDelayStats(arrivalInfo);
 
     int networkSamples;
 
@@ -132,10 +173,31 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
         }
         case SequenceNumberStats::OnTime: {
             // Packet is on time; parse its data to the ringbuffer
+            // a silent frame means the sender has gone quiet and sends no more silent samples, until its next
+            // audio packet we are in comfort silence and running out of samples is not a starve
+            _isInComfortSilence = (packetType == PacketTypeSilentAudioFrame);
+
             if (packetType == PacketTypeSilentAudioFrame) {
                 writeDroppableSilentSamples(networkSamples);
+                break;
+            }
+
+            QByteArray audioPayload = packet.mid(readBytes);
+            readBytes += audioPayload.size();
+
+            if (_incomingCodec != AudioCodec::PCM) {
+                _decodedAudio.resize(0);
+                if (AudioCodec::decode(audioPayload.constData(), audioPayload.size(), _decodedAudio) == 0) {
+                    break;
+                }
+                audioPayload = _decodedAudio;
+            }
+
+            int stretchedSamples = timeStretchAudio(audioPayload, networkSamples);
+            if (stretchedSamples != networkSamples) {
+                parseAudioData(packetType, _stretchedAudio, stretchedSamples);
             } else {
-                readBytes += parseAudioData(packetType, packet.mid(readBytes), networkSamples);
+                parseAudioData(packetType, audioPayload, networkSamples);
             }
             break;
         }
@@ -155,7 +217,7 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
     // drop the oldest frames so the ringbuffer is down to the desired size.
     if (framesAvailable > _desiredJitterBufferFrames + _maxFramesOverDesired) {
         int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
-        _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
+        _ringBuffer.discardOldestSamples(framesToDrop * _ringBuffer.getNumFrameSamples());
         
         _framesAvailableStat.reset();
         _currentJitterBufferFrames = 0;
@@ -175,12 +237,22 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         numAudioSamples = numSilentSamples;
         return sizeof(quint16);
     } else {
-        // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
-        return 0;
+        // mixed audio packets only have the codec between the seq num and the audio data.
+        quint8 codec = packetAfterSeqNum.size() > 0 ? (quint8)packetAfterSeqNum.at(0) : AudioCodec::PCM;
+        _incomingCodec = AudioCodec::isValidType(codec) ? (AudioCodec::Type)codec : AudioCodec::PCM;
+
+        numAudioSamples = numSamplesForAudioPayload(packetAfterSeqNum.mid(sizeof(quint8)));
+        return sizeof(quint8);
     }
 }
 
+int InboundAudioStream::numSamplesForAudioPayload(const QByteArray& audioPayload) const {
+    if (_incomingCodec == AudioCodec::ADPCM) {
+        return AudioCodec::numSamplesForEncodedBytes(audioPayload.constData(), audioPayload.size());
+    }
+    return audioPayload.size() / sizeof(int16_t);
+}
+
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int numAudioSamples) {
     return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
 }
@@ -231,7 +303,7 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, bool starv
             samplesPopped = samplesAvailable;
         } else {
             // we can't pop any samples. set this stream to starved if needed
-            if (starveIfNoSamplesPopped) {
+            if (starveIfNoSamplesPopped && !_isInComfortSilence) {
                 setToStarved();
                 _consecutiveNotMixedCount++;
             }
@@ -260,7 +332,7 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveI
             framesPopped = framesAvailable;
         } else {
             // we can't pop any frames. set this stream to starved if needed
-            if (starveIfNoFramesPopped) {
+            if (starveIfNoFramesPopped && !_isInComfortSilence) {
                 setToStarved();
                 _consecutiveNotMixedCount = 1;
             }
@@ -299,7 +371,7 @@ void InboundAudioStream::setToStarved() {
     quint64 now = usecTimestampNow();
     _starveHistory.insert(now);
 
-    if (_dynamicJitterBuffers) {
+    if (_dynamicJitterBuffers && !_usePercentileForJitterCalc) {
         // dynamic jitter buffers are enabled. check if this starve put us over the window
         // starve threshold
         quint64 windowEnd = now - _starveHistoryWindowSeconds * USECS_PER_SECOND;
@@ -345,6 +417,8 @@ void InboundAudioStream::setSettings(const Settings& settings) {
     setWindowSecondsForDesiredCalcOnTooManyStarves(settings._windowSecondsForDesiredCalcOnTooManyStarves);
     setWindowSecondsForDesiredReduction(settings._windowSecondsForDesiredReduction);
     setRepetitionWithFade(settings._repetitionWithFade);
+    setUsePercentileForJitterCalc(settings._usePercentileForJitterCalc);
+    setTargetLateLossRate(settings._targetLateLossRate);
 }
 
 void InboundAudioStream::setDynamicJitterBuffers(bool dynamicJitterBuffers) {
@@ -375,6 +449,21 @@ void InboundAudioStream::setWindowSecondsForDesiredReduction(int windowSecondsFo
     _timeGapStatsForDesiredReduction.setWindowIntervals(windowSecondsForDesiredReduction);
 }
 
+void InboundAudioStream::setUsePercentileForJitterCalc(bool usePercentileForJitterCalc) {
+    _usePercentileForJitterCalc = usePercentileForJitterCalc;
+}
+
+void InboundAudioStream::setTargetLateLossRate(float targetLateLossRate) {
+    _packetDelayPercentile.setPercentile(1.0f - glm::clamp(targetLateLossRate, 0.0f, 1.0f));
+}
+
+int InboundAudioStream::getCalculatedJitterBufferFrames() const {
+    if (_usePercentileForJitterCalc) {
+        return _calculatedJitterBufferFramesUsingPercentile;
+    }
+    return _useStDevForJitterCalc ? _calculatedJitterBufferFramesUsingStDev : _calculatedJitterBufferFramesUsingMaxGap;
+}
+
 
 int InboundAudioStream::clampDesiredJitterBufferFramesValue(int desired) const {
     const int MIN_FRAMES_DESIRED = 0;
@@ -412,7 +501,7 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
             _stdevStatsForDesiredCalcOnTooManyStarves.reset();
         }
 
-        if (_dynamicJitterBuffers) {
+        if (_dynamicJitterBuffers && !_usePercentileForJitterCalc) {
             // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
             // then reduce _desiredJitterBufferFrames to that number of frames.
             if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
@@ -429,6 +518,100 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
     _lastPacketReceivedTime = now;
 }
 
+void InboundAudioStream::packetReceivedUpdatePacketDelayStats(const SequenceNumberStats::ArrivalInfo& arrivalInfo) {
+    if (arrivalInfo._status != SequenceNumberStats::OnTime && arrivalInfo._status != SequenceNumberStats::Early) {
+        return;
+    }
+
+    // called right after packetReceivedUpdateTimingStats, which took the time for this packet
+    quint64 now = _lastPacketReceivedTime;
+
+    if (_expectedPacketReceivedTime == 0 || _isInComfortSilence) {
+        // the sender may have been quiet for any amount of time, so this packet becomes the new reference
+        _expectedPacketReceivedTime = now;
+        return;
+    }
+
+    // every packet holds a network frame, so it's expected one frame after the last, plus one for each dropped packet
+    int packetsSinceLastPacket = 1;
+    if (arrivalInfo._status == SequenceNumberStats::Early) {
+        packetsSinceLastPacket += arrivalInfo._seqDiffFromExpected;
+    }
+    _expectedPacketReceivedTime += packetsSinceLastPacket * AudioConstants::NETWORK_FRAME_USECS;
+
+    quint64 delay = 0;
+    if (now < _expectedPacketReceivedTime) {
+        // this packet beat every packet before it, it is the new reference
+        _expectedPacketReceivedTime = now;
+    } else {
+        delay = now - _expectedPacketReceivedTime;
+    }
+    _minPacketDelayThisInterval = std::min(_minPacketDelayThisInterval, delay);
+
+    _packetDelayPercentile.updatePercentile((float)delay);
+
+    // the frame being played out when a packet with no delay arrives, plus enough frames to cover the delay
+    _calculatedJitterBufferFramesUsingPercentile = 1 + (int)ceilf(_packetDelayPercentile.getValueAtPercentile()
+                                                                  / (float)AudioConstants::NETWORK_FRAME_USECS);
+
+    if (_dynamicJitterBuffers && _usePercentileForJitterCalc
+        && _packetDelayPercentile.getNumSamples() >= MIN_PACKET_DELAYS_FOR_DESIRED_CALC) {
+        _desiredJitterBufferFrames = clampDesiredJitterBufferFramesValue(_calculatedJitterBufferFramesUsingPercentile);
+    }
+}
+
+int InboundAudioStream::timeStretchAudio(const QByteArray& audio, int networkSamples) {
+    if (!_dynamicJitterBuffers || !_usePercentileForJitterCalc) {
+        return networkSamples;
+    }
+
+    if (_isStarved) {
+        // the buffer refills to desired before it plays out again, start smoothing from there
+        _smoothedFramesAvailable = _desiredJitterBufferFrames;
+        return networkSamples;
+    }
+
+    // count the frame in this packet, so a buffer that holds steady at desired reads as desired
+    _smoothedFramesAvailable = FRAMES_AVAILABLE_SMOOTHING * _smoothedFramesAvailable
+        + (1.0f - FRAMES_AVAILABLE_SMOOTHING) * (_ringBuffer.framesAvailable() + 1);
+
+    if (++_packetsSinceTimeStretch < MIN_PACKETS_BETWEEN_TIME_STRETCHES) {
+        return networkSamples;
+    }
+
+    // only whole network frames of mono or stereo audio are stretched
+    int numFrames = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    int numChannels = networkSamples / numFrames;
+    if (numChannels < 1 || numChannels > 2 || numChannels * numFrames != networkSamples
+        || audio.size() < networkSamples * (int)sizeof(int16_t)) {
+        return networkSamples;
+    }
+
+    const int16_t* samples = reinterpret_cast<const int16_t*>(audio.constData());
+    int stretchedFrames = 0;
+
+    _stretchedAudio.resize(0);
+    if (_smoothedFramesAvailable < _desiredJitterBufferFrames - TIME_STRETCH_HYSTERESIS_FRAMES) {
+        stretchedFrames = AudioTimeStretch::expand(samples, numFrames, numChannels, _stretchedAudio);
+        if (stretchedFrames > 0) {
+            _timeStretchExpansions++;
+        }
+    } else if (_smoothedFramesAvailable > _desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING
+               + TIME_STRETCH_HYSTERESIS_FRAMES) {
+        stretchedFrames = -AudioTimeStretch::compress(samples, numFrames, numChannels, _stretchedAudio);
+        if (stretchedFrames < 0) {
+            _timeStretchCompressions++;
+        }
+    }
+
+    if (stretchedFrames == 0) {
+        return networkSamples;
+    }
+
+    _packetsSinceTimeStretch = 0;
+    return (numFrames + stretchedFrames) * numChannels;
+}
+
 int InboundAudioStream::writeSamplesForDroppedPackets(int networkSamples) {
     if (_repetitionWithFade) {
         return writeLastFrameRepeatedWithFade(networkSamples);
@@ -473,6 +656,11 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._overflowCount = _ringBuffer.getOverflowCount();
     streamStats._framesDropped = _silentFramesDropped + _oldFramesDropped;    // TODO: add separate stat for old frames dropped
 
+    streamStats._calculatedJitterBufferFrames = getCalculatedJitterBufferFrames();
+    streamStats._packetDelayAtPercentile = (quint32)_packetDelayPercentile.getValueAtPercentile();
+    streamStats._timeStretchExpansions = _timeStretchExpansions;
+    streamStats._timeStretchCompressions = _timeStretchCompressions;
+
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
 
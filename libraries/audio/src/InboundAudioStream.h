@@ -13,8 +13,10 @@
 #define hifi_InboundAudioStream_h
 
 #include "NodeData.h"
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
+#include "MovingPercentile.h"
 #include "SequenceNumberStats.h"
 #include "AudioStreamStats.h"
 #include "PacketHeaders.h"
@@ -35,11 +37,16 @@ const int STATS_FOR_STATS_PACKET_WINDOW_SECONDS = 30;
 // _currentJitterBufferFrames is updated with the time-weighted avg and the running time-weighted avg is reset.
 const quint64 FRAMES_AVAILABLE_STAT_WINDOW_USECS = 10 * USECS_PER_SECOND;
 
+// the number of packets whose delay the late loss percentile method picks its percentile from
+const int PACKET_DELAY_PERCENTILE_WINDOW_PACKETS = 500;
+
 // default values for members of the Settings struct
 const int DEFAULT_MAX_FRAMES_OVER_DESIRED = 10;
 const bool DEFAULT_DYNAMIC_JITTER_BUFFERS = true;
 const int DEFAULT_STATIC_DESIRED_JITTER_BUFFER_FRAMES = 1;
 const bool DEFAULT_USE_STDEV_FOR_JITTER_CALC = false;
+const bool DEFAULT_USE_PERCENTILE_FOR_JITTER_CALC = false;
+const float DEFAULT_TARGET_LATE_LOSS_RATE = 0.01f;
 const int DEFAULT_WINDOW_STARVE_THRESHOLD = 3;
 const int DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES = 50;
 const int DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
@@ -61,7 +68,9 @@ public:
             _windowStarveThreshold(DEFAULT_WINDOW_STARVE_THRESHOLD),
             _windowSecondsForDesiredCalcOnTooManyStarves(DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES),
             _windowSecondsForDesiredReduction(DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION),
-            _repetitionWithFade(DEFAULT_REPETITION_WITH_FADE)
+            _repetitionWithFade(DEFAULT_REPETITION_WITH_FADE),
+            _usePercentileForJitterCalc(DEFAULT_USE_PERCENTILE_FOR_JITTER_CALC),
+            _targetLateLossRate(DEFAULT_TARGET_LATE_LOSS_RATE)
         {}
 
         Settings(int maxFramesOverDesired, bool dynamicJitterBuffers, int staticDesiredJitterBufferFrames,
@@ -74,14 +83,17 @@ public:
             _windowStarveThreshold(windowStarveThreshold),
             _windowSecondsForDesiredCalcOnTooManyStarves(windowSecondsForDesiredCalcOnTooManyStarves),
             _windowSecondsForDesiredReduction(windowSecondsForDesiredCalcOnTooManyStarves),
-            _repetitionWithFade(repetitionWithFade)
+            _repetitionWithFade(repetitionWithFade),
+            _usePercentileForJitterCalc(DEFAULT_USE_PERCENTILE_FOR_JITTER_CALC),
+            _targetLateLossRate(DEFAULT_TARGET_LATE_LOSS_RATE)
         {}
 
         // max number of frames over desired in the ringbuffer.
         int _maxFramesOverDesired; 
 
         // if false, _desiredJitterBufferFrames will always be _staticDesiredJitterBufferFrames.  Otherwise,
-        // either fred or philip's method will be used to calculate _desiredJitterBufferFrames based on packet timegaps.
+        // fred's or philip's method will be used to calculate _desiredJitterBufferFrames based on packet timegaps,
+        // or the late loss percentile method based on packet delays.
         bool _dynamicJitterBuffers;
 
         // settings for static jitter buffer mode
@@ -96,6 +108,12 @@ public:
         // if true, the prev frame will be repeated (fading to silence) for dropped frames.
         // otherwise, silence will be inserted.
         bool _repetitionWithFade;
+
+        // if true, _desiredJitterBufferFrames follows the packet delay that only _targetLateLossRate of packets
+        // exceed, and the buffer is time-stretched towards it instead of starving or dropping frames to get there.
+        // this takes the place of both fred's and philip's method.
+        bool _usePercentileForJitterCalc;
+        float _targetLateLossRate;
     };
 
 public:
@@ -111,6 +129,12 @@ public:
     int popSamples(int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped = true);
 
     bool lastPopSucceeded() const { return _lastPopSucceeded; };
+
+    /// true from a silent frame until the next audio packet, while the sender's silent frames carry no samples
+    bool isInComfortSilence() const { return _isInComfortSilence; }
+
+    /// the codec of the audio payload in the most recently parsed packet
+    AudioCodec::Type getIncomingCodec() const { return _incomingCodec; }
     const AudioRingBuffer::ConstIterator& getLastPopOutput() const { return _lastPopOutput; }
 
     void setToStarved();
@@ -125,18 +149,25 @@ public:
     void setWindowSecondsForDesiredCalcOnTooManyStarves(int windowSecondsForDesiredCalcOnTooManyStarves);
     void setWindowSecondsForDesiredReduction(int windowSecondsForDesiredReduction);
     void setRepetitionWithFade(bool repetitionWithFade) { _repetitionWithFade = repetitionWithFade; }
+    void setUsePercentileForJitterCalc(bool usePercentileForJitterCalc);
+    void setTargetLateLossRate(float targetLateLossRate);
+
+    /// lets packets be parsed on one thread while samples are popped on another, see AudioRingBuffer
+    void setIsLockFree(bool isLockFree) { _ringBuffer.setIsLockFree(isLockFree); }
 
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
-    int getCalculatedJitterBufferFrames() const { return _useStDevForJitterCalc ? 
-        _calculatedJitterBufferFramesUsingStDev : _calculatedJitterBufferFramesUsingMaxGap; };
+    int getCalculatedJitterBufferFrames() const;
 
     /// returns the desired number of jitter buffer frames using Philip's method
     int getCalculatedJitterBufferFramesUsingStDev() const { return _calculatedJitterBufferFramesUsingStDev; }
 
     /// returns the desired number of jitter buffer frames using Freddy's method
     int getCalculatedJitterBufferFramesUsingMaxGap() const { return _calculatedJitterBufferFramesUsingMaxGap; }
+
+    /// returns the desired number of jitter buffer frames using the late loss percentile method
+    int getCalculatedJitterBufferFramesUsingPercentile() const { return _calculatedJitterBufferFramesUsingPercentile; }
     
     int getWindowSecondsForDesiredReduction() const {
         return _timeGapStatsForDesiredReduction.getWindowIntervals(); }
@@ -146,6 +177,8 @@ public:
     bool getRepetitionWithFade() const { return _repetitionWithFade;}
     int getWindowStarveThreshold() const { return _starveThreshold;}
     bool getUseStDevForJitterCalc() const { return _useStDevForJitterCalc; }
+    bool getUsePercentileForJitterCalc() const { return _usePercentileForJitterCalc; }
+    float getTargetLateLossRate() const { return 1.0f - _packetDelayPercentile.getPercentile(); }
     int getDesiredJitterBufferFrames() const { return _desiredJitterBufferFrames; }
     int getMaxFramesOverDesired() const { return _maxFramesOverDesired; }
     int getNumFrameSamples() const { return _ringBuffer.getNumFrameSamples(); }
@@ -160,6 +193,8 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    int getTimeStretchExpansions() const { return _timeStretchExpansions; }
+    int getTimeStretchCompressions() const { return _timeStretchCompressions; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -177,8 +212,13 @@ public slots:
 
 private:
     void packetReceivedUpdateTimingStats();
+    void packetReceivedUpdatePacketDelayStats(const SequenceNumberStats::ArrivalInfo& arrivalInfo);
     int clampDesiredJitterBufferFramesValue(int desired) const;
 
+    /// shortens or lengthens the audio of a packet to move the buffer towards _desiredJitterBufferFrames.
+    /// returns the number of samples to write, if it differs from networkSamples they are in _stretchedAudio
+    int timeStretchAudio(const QByteArray& audio, int networkSamples);
+
     int writeSamplesForDroppedPackets(int networkSamples);
 
     void popSamplesNoCheck(int samples);
@@ -194,8 +234,12 @@ protected:
     /// default implementation assumes no stream properties and raw audio samples after stream propertiess
     virtual int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& networkSamples);
 
+    /// returns how many samples an audio payload in _incomingCodec holds
+    int numSamplesForAudioPayload(const QByteArray& audioPayload) const;
+
     /// parses the audio data in the network packet.
-    /// default implementation assumes packet contains raw audio samples after stream properties
+    /// default implementation assumes packet contains raw audio samples after stream properties.
+    /// encoded payloads are decoded by parseData before they get here, so this always sees raw samples
     virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
 
     /// writes silent samples to the buffer that may be dropped to reduce latency caused by the buffer
@@ -244,6 +288,21 @@ protected:
     int _calculatedJitterBufferFramesUsingStDev;                     // the most recent desired frames calculated by Philip's method
     MovingMinMaxAvg<quint64> _timeGapStatsForDesiredReduction;
 
+    // for the late loss percentile method. a packet's delay is how long after the earliest packet of the stream,
+    // counted on by a network frame per packet, it arrived
+    bool _usePercentileForJitterCalc;
+    MovingPercentile _packetDelayPercentile;
+    quint64 _expectedPacketReceivedTime;
+    quint64 _minPacketDelayThisInterval;
+    int _calculatedJitterBufferFramesUsingPercentile;
+
+    // the frames available as packets are written, smoothed so a burst of packets doesn't look like a full buffer
+    float _smoothedFramesAvailable;
+    int _packetsSinceTimeStretch;
+    int _timeStretchExpansions;
+    int _timeStretchCompressions;
+    QByteArray _stretchedAudio;
+
     int _starveHistoryWindowSeconds;
     RingBufferHistory<quint64> _starveHistory;
     int _starveThreshold;
@@ -262,6 +321,12 @@ protected:
     bool _hasReverb;
     float _reverbTime;
     float _wetLevel;
+
+    // set by parseStreamProperties, anything other than PCM is decoded into _decodedAudio before parseAudioData
+    AudioCodec::Type _incomingCodec;
+    QByteArray _decodedAudio;
+
+    bool _isInComfortSilence;
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -28,6 +29,7 @@
 #include "AudioBuffer.h"
 #include "AudioEditBuffer.h"
 #include "Sound.h"
+#include "SoundCache.h"
 
 static int soundMetaTypeId = qRegisterMetaType<Sound*>();
 
@@ -49,90 +51,231 @@ void soundPointerFromScriptValue(const QScriptValue &object, Sound* &out) {
 
 Sound::Sound(const QUrl& url, bool isStereo) :
     Resource(url),
+    _samples(new SoundSamples()),
     _isStereo(isStereo),
-    _isReady(false)
+    _isReady(false),
+    _shouldDecode(false),
+    _isDecodedFromCache(false),
+    _isWav(false),
+    _isWavHeaderRead(false),
+    _wavBytesRemaining(0)
 {
     
 }
 
-void Sound::downloadFinished(QNetworkReply* reply) {
-    // replace our byte array with the downloaded data
-    QByteArray rawAudioByteArray = reply->readAll();
+bool Sound::isPlayable() const {
+    QMutexLocker locker(&_samples->mutex);
+    return !_samples->samples.isEmpty();
+}
 
-    if (reply->hasRawHeader("Content-Type")) {
+void Sound::startDecoding(QNetworkReply* reply) {
+    // this may be a retry, start over on whatever the last reply left behind
+    _decodingReply = reply;
+    _samples->samples.clear();
+    _samples->isComplete = false;
+    _undecodedBytes.clear();
+    _shouldDecode = false;
+    _isDecodedFromCache = false;
+    _isWavHeaderRead = false;
+    _wavBytesRemaining = 0;
+    
+    _decodedAudioValidator = getContentValidator(reply);
+    
+    bool isStereo = _isStereo;
+    QByteArray decodedAudio = SoundCache::getInstance().findDecodedAudio(_url, _decodedAudioValidator, isStereo);
+    if (!decodedAudio.isEmpty()) {
+        // we've decoded this exact sound before, the rest of the download is of no use
+        _samples->samples = decodedAudio;
+        _isStereo = isStereo;
+        _isDecodedFromCache = true;
+        return;
+    }
+    
+    if (!reply->hasRawHeader("Content-Type")) {
+        qDebug() << "Network reply without 'Content-Type'.";
+        return;
+    }
+    
+    QByteArray headerContentType = reply->rawHeader("Content-Type");
+    
+    // WAV audio file encountered
+    _isWav = headerContentType == "audio/x-wav"
+        || headerContentType == "audio/wav"
+        || headerContentType == "audio/wave";
+    
+    if (!_isWav) {
+        // check if this was a stereo raw file
+        // since it's raw the only way for us to know that is if the file was called .stereo.raw
+        if (reply->url().fileName().toLower().endsWith("stereo.raw")) {
+            _isStereo = true;
+            qDebug() << "Processing sound from" << reply->url() << "as stereo audio file.";
+        }
+        
+        // Process as RAW file, the downsampled audio is half its size
+        qint64 contentLength = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+        if (contentLength > 0) {
+            _samples->samples.reserve(contentLength / 2);
+        }
+    }
+    
+    _shouldDecode = true;
+}
 
-        QByteArray headerContentType = reply->rawHeader("Content-Type");
+void Sound::decodeReceived(QNetworkReply* reply, bool isFinished) {
+    if (reply != _decodingReply) {
+        startDecoding(reply);
+    }
+    
+    QByteArray receivedBytes = reply->readAll();
+    if (!_shouldDecode) {
+        return;
+    }
+    _undecodedBytes.append(receivedBytes);
+    
+    int numBytesToDecode = _undecodedBytes.size();
+    
+    if (_isWav) {
+        if (!_isWavHeaderRead) {
+            int dataOffset = 0;
+            quint32 dataSize = 0;
+            WavHeaderStatus status = interpretWavHeader(_undecodedBytes, dataOffset, dataSize);
+            
+            if (status == WavHeaderIncomplete && !isFinished) {
+                // wait for the rest of the header
+                return;
+            } else if (status != WavHeaderRead) {
+                if (status == WavHeaderIncomplete) {
+                    qDebug() << "Could not read wav audio file header.";
+                }
+                _shouldDecode = false;
+                _undecodedBytes.clear();
+                return;
+            }
+            
+            _undecodedBytes.remove(0, dataOffset);
+            _wavBytesRemaining = dataSize;
+            _isWavHeaderRead = true;
+            _samples->samples.reserve(dataSize / 2);
+        }
+        
+        numBytesToDecode = (int)std::min((quint32)_undecodedBytes.size(), _wavBytesRemaining);
+    }
+    
+    bool isLastPart = isFinished || (_isWav && (quint32)numBytesToDecode == _wavBytesRemaining);
+    
+    int numSamplesDecoded = downSample(reinterpret_cast<const int16_t*>(_undecodedBytes.constData()),
+                                       numBytesToDecode / sizeof(int16_t), isLastPart);
+    int numBytesDecoded = numSamplesDecoded * sizeof(int16_t);
+    _undecodedBytes.remove(0, numBytesDecoded);
+    
+    if (_isWav) {
+        _wavBytesRemaining -= numBytesDecoded;
+        if (isFinished && _wavBytesRemaining > 0) {
+            qDebug() << "Error reading WAV file";
+        }
+    }
+    
+    if (isLastPart) {
+        _shouldDecode = false;
+        _undecodedBytes.clear();
+    }
+}
 
-        // WAV audio file encountered
-        if (headerContentType == "audio/x-wav"
-            || headerContentType == "audio/wav"
-            || headerContentType == "audio/wave") {
+void Sound::downloadReceived(QNetworkReply* reply) {
+    // decode as the download arrives, so injectors can start on it and a large sound is mostly decoded by the time it
+    // has all arrived
+    {
+        QMutexLocker locker(&_samples->mutex);
+        decodeReceived(reply, false);
+    }
+    
+    if (_isDecodedFromCache) {
+        // the cached audio is the whole sound, so there's no need to wait for the rest of the download
+        abandonDownload();
+        finishDecoding();
+    }
+}
 
-            QByteArray outputAudioByteArray;
+void Sound::downloadFinished(QNetworkReply* reply) {
+    {
+        QMutexLocker locker(&_samples->mutex);
+        decodeReceived(reply, true);
+    }
+    finishDecoding();
+    reply->deleteLater();
+}
 
-            interpretAsWav(rawAudioByteArray, outputAudioByteArray);
-            downSample(outputAudioByteArray);
-        } else {
-            // check if this was a stereo raw file
-            // since it's raw the only way for us to know that is if the file was called .stereo.raw
-            if (reply->url().fileName().toLower().endsWith("stereo.raw")) {
-                _isStereo = true;
-                qDebug() << "Processing sound from" << reply->url() << "as stereo audio file.";
-            }
-            
-            // Process as RAW file
-            downSample(rawAudioByteArray);
+void Sound::finishDecoding() {
+    {
+        QMutexLocker locker(&_samples->mutex);
+        if (!_isDecodedFromCache) {
+            trimFrames();
         }
-        trimFrames();
-    } else {
-        qDebug() << "Network reply without 'Content-Type'.";
+        _samples->isComplete = true;
+    }
+    
+    // nothing changes the samples from here, so they can be read without the lock
+    if (!_isDecodedFromCache) {
+        SoundCache::getInstance().storeDecodedAudio(_url, _decodedAudioValidator, _samples->samples, _isStereo);
     }
     
     _isReady = true;
-    reply->deleteLater();
+    finishedLoading(true);
 }
 
-void Sound::downSample(const QByteArray& rawAudioByteArray) {
+int Sound::downSample(const int16_t* sourceSamples, int numSourceSamples, bool isLastPart) {
     // assume that this was a RAW file and is now an array of samples that are
     // signed, 16-bit, 48Khz, mono
 
     // we want to convert it to the format that the audio-mixer wants
     // which is signed, 16-bit, 24Khz, mono
-
-    _byteArray.resize(rawAudioByteArray.size() / 2);
-
-    int numSourceSamples = rawAudioByteArray.size() / sizeof(int16_t);
-    int16_t* sourceSamples = (int16_t*) rawAudioByteArray.data();
-    int16_t* destinationSamples = (int16_t*) _byteArray.data();
-
     
     if (_isStereo) {
-        for (int i = 0; i < numSourceSamples; i += 4) {
+        // every two stereo frames become one, nothing is needed from the next part
+        int numSourceFramePairs = numSourceSamples / 4;
+        
+        int offset = _samples->samples.size();
+        _samples->samples.resize(offset + numSourceFramePairs * 2 * sizeof(int16_t));
+        int16_t* destinationSamples = reinterpret_cast<int16_t*>(_samples->samples.data() + offset);
+        
+        for (int i = 0; i < numSourceFramePairs * 4; i += 4) {
             destinationSamples[i / 2] = (sourceSamples[i] / 2) + (sourceSamples[i + 2] / 2);
             destinationSamples[(i / 2) + 1] = (sourceSamples[i + 1] / 2) + (sourceSamples[i + 3] / 2);
         }
-    } else {
-        for (int i = 1; i < numSourceSamples; i += 2) {
-            if (i + 1 >= numSourceSamples) {
-                destinationSamples[(i - 1) / 2] = (sourceSamples[i - 1] / 2) + (sourceSamples[i] / 2);
-            } else {
-                destinationSamples[(i - 1) / 2] = (sourceSamples[i - 1] / 4) + (sourceSamples[i] / 2)
-                                                + (sourceSamples[i + 1] / 4);
-            }
+        
+        return numSourceFramePairs * 4;
+    }
+    
+    // every pair of samples becomes one, smoothed with the sample after the pair. the last pair of a part that
+    // isn't the last needs the first sample of the next part, so it waits for it
+    int numSourcePairs = isLastPart ? numSourceSamples / 2 : std::max(numSourceSamples - 1, 0) / 2;
+    
+    int offset = _samples->samples.size();
+    _samples->samples.resize(offset + numSourcePairs * sizeof(int16_t));
+    int16_t* destinationSamples = reinterpret_cast<int16_t*>(_samples->samples.data() + offset);
+    
+    for (int i = 1; i < numSourcePairs * 2; i += 2) {
+        if (i + 1 >= numSourceSamples) {
+            destinationSamples[(i - 1) / 2] = (sourceSamples[i - 1] / 2) + (sourceSamples[i] / 2);
+        } else {
+            destinationSamples[(i - 1) / 2] = (sourceSamples[i - 1] / 4) + (sourceSamples[i] / 2)
+                                            + (sourceSamples[i + 1] / 4);
         }
     }
+    
+    return numSourcePairs * 2;
 }
 
 void Sound::trimFrames() {
     
-    const uint32_t inputFrameCount = _byteArray.size() / sizeof(int16_t);
+    const uint32_t inputFrameCount = _samples->samples.size() / sizeof(int16_t);
     const uint32_t trimCount = 1024;  // number of leading and trailing frames to trim
     
     if (inputFrameCount <= (2 * trimCount)) {
         return;
     }
     
-    int16_t* inputFrameData = (int16_t*)_byteArray.data();
+    int16_t* inputFrameData = (int16_t*)_samples->samples.data();
 
     AudioEditBufferFloat32 editBuffer(1, inputFrameCount);
     editBuffer.copyFrames(1, inputFrameCount, inputFrameData, false /*copy in*/);
@@ -194,77 +337,78 @@ struct CombinedHeader {
     WAVEHeader  wave;
 };
 
-void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
+Sound::WavHeaderStatus Sound::interpretWavHeader(const QByteArray& inputAudioByteArray, int& dataOffset,
+                                                 quint32& dataSize) {
 
     CombinedHeader fileHeader;
 
     // Create a data stream to analyze the data
     QDataStream waveStream(const_cast<QByteArray *>(&inputAudioByteArray), QIODevice::ReadOnly);
-    if (waveStream.readRawData(reinterpret_cast<char *>(&fileHeader), sizeof(CombinedHeader)) == sizeof(CombinedHeader)) {
+    if (waveStream.readRawData(reinterpret_cast<char *>(&fileHeader), sizeof(CombinedHeader)) != sizeof(CombinedHeader)) {
+        return WavHeaderIncomplete;
+    }
 
-        if (strncmp(fileHeader.riff.descriptor.id, "RIFF", 4) == 0) {
-            waveStream.setByteOrder(QDataStream::LittleEndian);
-        } else {
-            // descriptor.id == "RIFX" also signifies BigEndian file
-            // waveStream.setByteOrder(QDataStream::BigEndian);
-            qDebug() << "Currently not supporting big-endian audio files.";
-            return;
-        }
+    if (strncmp(fileHeader.riff.descriptor.id, "RIFF", 4) == 0) {
+        waveStream.setByteOrder(QDataStream::LittleEndian);
+    } else {
+        // descriptor.id == "RIFX" also signifies BigEndian file
+        // waveStream.setByteOrder(QDataStream::BigEndian);
+        qDebug() << "Currently not supporting big-endian audio files.";
+        return WavHeaderInvalid;
+    }
 
-        if (strncmp(fileHeader.riff.type, "WAVE", 4) != 0
-            || strncmp(fileHeader.wave.descriptor.id, "fmt", 3) != 0) {
-            qDebug() << "Not a WAVE Audio file.";
-            return;
-        }
+    if (strncmp(fileHeader.riff.type, "WAVE", 4) != 0
+        || strncmp(fileHeader.wave.descriptor.id, "fmt", 3) != 0) {
+        qDebug() << "Not a WAVE Audio file.";
+        return WavHeaderInvalid;
+    }
 
-        // added the endianess check as an extra level of security
+    // added the endianess check as an extra level of security
 
-        if (qFromLittleEndian<quint16>(fileHeader.wave.audioFormat) != 1) {
-            qDebug() << "Currently not supporting non PCM audio files.";
-            return;
-        }
-        if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) == 2) {
-            _isStereo = true;
-        } else if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) > 2) {
-            qDebug() << "Currently not support audio files with more than 2 channels.";
-        }
-        
-        if (qFromLittleEndian<quint16>(fileHeader.wave.bitsPerSample) != 16) {
-            qDebug() << "Currently not supporting non 16bit audio files.";
-            return;
-        }
-        if (qFromLittleEndian<quint32>(fileHeader.wave.sampleRate) != 48000) {
-            qDebug() << "Currently not supporting non 48KHz audio files.";
-            return;
-        }
+    if (qFromLittleEndian<quint16>(fileHeader.wave.audioFormat) != 1) {
+        qDebug() << "Currently not supporting non PCM audio files.";
+        return WavHeaderInvalid;
+    }
+    if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) == 2) {
+        _isStereo = true;
+    } else if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) > 2) {
+        qDebug() << "Currently not support audio files with more than 2 channels.";
+    }
+    
+    if (qFromLittleEndian<quint16>(fileHeader.wave.bitsPerSample) != 16) {
+        qDebug() << "Currently not supporting non 16bit audio files.";
+        return WavHeaderInvalid;
+    }
+    if (qFromLittleEndian<quint32>(fileHeader.wave.sampleRate) != 48000) {
+        qDebug() << "Currently not supporting non 48KHz audio files.";
+        return WavHeaderInvalid;
+    }
 
-        // Skip any extra data in the WAVE chunk
-        waveStream.skipRawData(fileHeader.wave.descriptor.size - (sizeof(WAVEHeader) - sizeof(chunk)));
+    // Skip any extra data in the WAVE chunk
+    int extraWaveBytes = fileHeader.wave.descriptor.size - (sizeof(WAVEHeader) - sizeof(chunk));
+    if (extraWaveBytes > 0 && waveStream.skipRawData(extraWaveBytes) != extraWaveBytes) {
+        return WavHeaderIncomplete;
+    }
 
-        // Read off remaining header information
-        DATAHeader dataHeader;
-        while (true) {
-            // Read chunks until the "data" chunk is found
-            if (waveStream.readRawData(reinterpret_cast<char *>(&dataHeader), sizeof(DATAHeader)) == sizeof(DATAHeader)) {
-                if (strncmp(dataHeader.descriptor.id, "data", 4) == 0) {
-                    break;
-                }
-                waveStream.skipRawData(dataHeader.descriptor.size);
-            } else {
-                qDebug() << "Could not read wav audio data header.";
-                return;
+    // Read off remaining header information
+    DATAHeader dataHeader;
+    while (true) {
+        // Read chunks until the "data" chunk is found
+        if (waveStream.readRawData(reinterpret_cast<char *>(&dataHeader), sizeof(DATAHeader)) == sizeof(DATAHeader)) {
+            if (strncmp(dataHeader.descriptor.id, "data", 4) == 0) {
+                break;
             }
+            if (waveStream.skipRawData(dataHeader.descriptor.size) != (int)dataHeader.descriptor.size) {
+                return WavHeaderIncomplete;
+            }
+        } else {
+            // the data chunk may not have arrived yet
+            return WavHeaderIncomplete;
         }
-
-        // Now pull out the data
-        quint32 outputAudioByteArraySize = qFromLittleEndian<quint32>(dataHeader.descriptor.size);
-        outputAudioByteArray.resize(outputAudioByteArraySize);
-        if (waveStream.readRawData(outputAudioByteArray.data(), outputAudioByteArraySize) != (int)outputAudioByteArraySize) {
-            qDebug() << "Error reading WAV file";
-        }
-
-    } else {
-        qDebug() << "Could not read wav audio file header.";
-        return;
     }
+
+    // the data is everything after the data chunk header
+    dataOffset = waveStream.device()->pos();
+    dataSize = qFromLittleEndian<quint32>(dataHeader.descriptor.size);
+    return WavHeaderRead;
 }
@@ -12,33 +12,82 @@
 #ifndef hifi_Sound_h
 #define hifi_Sound_h
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
 #include <QtNetwork/QNetworkReply>
 #include <QtScript/qscriptengine.h>
 
 #include <ResourceCache.h>
 
+/// The samples of a Sound as far as they've been decoded, shared with the injectors playing it.  Until isComplete the
+/// Sound adds to them as its download arrives, and both sides only touch them under the mutex.
+class SoundSamples {
+public:
+    QMutex mutex;
+    QByteArray samples;
+    bool isComplete = false;
+};
+
+typedef QSharedPointer<SoundSamples> SoundSamplesPointer;
+
 class Sound : public Resource {
     Q_OBJECT
     
     Q_PROPERTY(bool downloaded READ isReady)
+    Q_PROPERTY(bool playable READ isPlayable)
+    Q_PROPERTY(QByteArray data READ getByteArray)
 public:
     Sound(const QUrl& url, bool isStereo = false);
     
     bool isStereo() const { return _isStereo; }    
     bool isReady() const { return _isReady; }
+    
+    /// Whether some of the sound has been decoded, so it can be played while the rest downloads.
+    bool isPlayable() const;
      
-    const QByteArray& getByteArray() { return _byteArray; }
+    /// The decoded 16-bit samples.  Scripts get them as an ArrayBuffer that shares this array rather than copying it.
+    /// Until the sound is ready this is only safe to read on the Sound's thread.
+    const QByteArray& getByteArray() const { return _samples->samples; }
+    
+    const SoundSamplesPointer& getSamples() const { return _samples; }
 
 private:
-    QByteArray _byteArray;
+    enum WavHeaderStatus {
+        WavHeaderIncomplete,
+        WavHeaderInvalid,
+        WavHeaderRead
+    };
+    
+    SoundSamplesPointer _samples;
     bool _isStereo;
     bool _isReady;
     
+    // the download is decoded as it arrives, these carry what's left over from one part of it to the next
+    QPointer<QNetworkReply> _decodingReply;
+    QByteArray _undecodedBytes;
+    QByteArray _decodedAudioValidator;
+    bool _shouldDecode;
+    bool _isDecodedFromCache;
+    bool _isWav;
+    bool _isWavHeaderRead;
+    quint32 _wavBytesRemaining;
+    
     void trimFrames();
-    void downSample(const QByteArray& rawAudioByteArray);
-    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
     
+    /// downsamples whole frames from the start of source onto the end of the samples, and returns how many source
+    /// samples that took. unless isLastPart, the samples the next part will need are left for it
+    int downSample(const int16_t* sourceSamples, int numSourceSamples, bool isLastPart);
+    
+    /// on WavHeaderRead, dataOffset and dataSize locate the audio data
+    WavHeaderStatus interpretWavHeader(const QByteArray& inputAudioByteArray, int& dataOffset, quint32& dataSize);
+    
+    void startDecoding(QNetworkReply* reply);
+    void decodeReceived(QNetworkReply* reply, bool isFinished);
+    void finishDecoding();
+    
+    virtual void downloadReceived(QNetworkReply* reply);
     virtual void downloadFinished(QNetworkReply* reply);
 };
 
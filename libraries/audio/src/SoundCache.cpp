@@ -9,12 +9,41 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <string.h>
+
+#include <QtGlobal>
+
+#ifdef Q_OS_WIN
+#include <sys/types.h>
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
 #include <qthread.h>
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
 #include "SoundCache.h"
 
 static int soundPointerMetaTypeId = qRegisterMetaType<SharedSoundPointer>();
 
+// decoded audio is stored after this header, whose version goes up whenever the decoding changes
+struct DecodedAudioHeader {
+    char id[4];         // "HFDA"
+    quint8 version;
+    quint8 isStereo;
+    quint16 reserved;
+};
+
+const char DECODED_AUDIO_ID[4] = { 'H', 'F', 'D', 'A' };
+const quint8 DECODED_AUDIO_VERSION = 1;
+
+const qint64 DECODED_AUDIO_MAX_DIRECTORY_SIZE = 256 * BYTES_PER_MEGABYTES;
+
 SoundCache& SoundCache::getInstance() {
     static SoundCache staticInstance;
     return staticInstance;
@@ -25,6 +54,16 @@ SoundCache::SoundCache(QObject* parent) :
 {
     const qint64 SOUND_DEFAULT_UNUSED_MAX_SIZE = 50 * BYTES_PER_MEGABYTES;
     setUnusedResourceCacheSize(SOUND_DEFAULT_UNUSED_MAX_SIZE);
+    
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    _decodedAudioDirectory = QDir((!cachePath.isEmpty() ? cachePath : "soundCache") + "/decodedAudio").absolutePath();
+    QDir().mkpath(_decodedAudioDirectory);
+}
+
+SoundCache::~SoundCache() {
+    foreach (const MappedAudio& mappedAudio, _mappedDecodedAudio) {
+        delete mappedAudio.file;
+    }
 }
 
 SharedSoundPointer SoundCache::getSound(const QUrl& url) {
@@ -41,4 +80,101 @@ QSharedPointer<Resource> SoundCache::createResource(const QUrl& url, const QShar
                                                     bool delayLoad, const void* extra) {
     qDebug() << "Requesting sound at" << url.toString();
     return QSharedPointer<Resource>(new Sound(url), &Resource::allReferencesCleared);
-}
\ No newline at end of file
+}
+
+QString SoundCache::decodedAudioPath(const QUrl& url, const QByteArray& validator) const {
+    QByteArray key = url.toEncoded() + '\n' + validator;
+    return _decodedAudioDirectory + "/" + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".pcm";
+}
+
+QByteArray SoundCache::findDecodedAudio(const QUrl& url, const QByteArray& validator, bool& isStereo) {
+    if (validator.isEmpty()) {
+        return QByteArray();
+    }
+    
+    QString path = decodedAudioPath(url, validator);
+    if (_mappedDecodedAudio.contains(path)) {
+        const MappedAudio& mappedAudio = _mappedDecodedAudio[path];
+        isStereo = mappedAudio.isStereo;
+        return mappedAudio.audio;
+    }
+    
+    QFile* file = new QFile(path);
+    const char* mapped = NULL;
+    if (file->open(QIODevice::ReadOnly) && file->size() > (qint64)sizeof(DecodedAudioHeader)) {
+        mapped = reinterpret_cast<const char*>(file->map(0, file->size()));
+    }
+    
+    const DecodedAudioHeader* header = reinterpret_cast<const DecodedAudioHeader*>(mapped);
+    if (!mapped || memcmp(header->id, DECODED_AUDIO_ID, sizeof(DECODED_AUDIO_ID)) != 0
+        || header->version != DECODED_AUDIO_VERSION) {
+        delete file;
+        return QByteArray();
+    }
+    
+    // mark the file as just used, the directory is trimmed least recently modified first
+    utime(QFile::encodeName(path).constData(), NULL);
+    
+    // refer straight into the mapping, the audio is only ever read so it is never copied out of the file
+    MappedAudio mappedAudio;
+    mappedAudio.file = file;
+    mappedAudio.audio = QByteArray::fromRawData(mapped + sizeof(DecodedAudioHeader),
+                                                file->size() - sizeof(DecodedAudioHeader));
+    mappedAudio.isStereo = header->isStereo;
+    _mappedDecodedAudio.insert(path, mappedAudio);
+    
+    isStereo = mappedAudio.isStereo;
+    return mappedAudio.audio;
+}
+
+void SoundCache::storeDecodedAudio(const QUrl& url, const QByteArray& validator, const QByteArray& audio,
+                                   bool isStereo) {
+    if (validator.isEmpty() || audio.isEmpty()) {
+        return;
+    }
+    
+    QString path = decodedAudioPath(url, validator);
+    if (_mappedDecodedAudio.contains(path)) {
+        // already stored, and replacing it would pull the file out from under its mapping
+        return;
+    }
+    
+    DecodedAudioHeader header;
+    memcpy(header.id, DECODED_AUDIO_ID, sizeof(DECODED_AUDIO_ID));
+    header.version = DECODED_AUDIO_VERSION;
+    header.isStereo = isStereo;
+    header.reserved = 0;
+    
+    // write to the side and rename, so a half written file is never found
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Could not store decoded audio for" << url << "at" << path;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(audio);
+    
+    if (file.commit()) {
+        trimDecodedAudioDirectory();
+    } else {
+        qDebug() << "Could not store decoded audio for" << url << "at" << path;
+    }
+}
+
+void SoundCache::trimDecodedAudioDirectory() {
+    QDir directory(_decodedAudioDirectory);
+    QFileInfoList files = directory.entryInfoList(QStringList("*.pcm"), QDir::Files, QDir::Time);
+    
+    qint64 totalSize = 0;
+    foreach (const QFileInfo& fileInfo, files) {
+        totalSize += fileInfo.size();
+    }
+    
+    // files are touched when they're found, so the list is most recently used first. drop from the back until the
+    // directory fits again
+    for (int i = files.size() - 1; i >= 0 && totalSize > DECODED_AUDIO_MAX_DIRECTORY_SIZE; i--) {
+        if (!_mappedDecodedAudio.contains(files[i].absoluteFilePath()) && directory.remove(files[i].fileName())) {
+            totalSize -= files[i].size();
+        }
+    }
+}
@@ -12,6 +12,9 @@
 #ifndef hifi_SoundCache_h
 #define hifi_SoundCache_h
 
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
 #include <ResourceCache.h>
 
 #include "Sound.h"
@@ -24,11 +27,33 @@ public:
     
     Q_INVOKABLE SharedSoundPointer getSound(const QUrl& url);
     
+    /// Finds the decoded audio of a sound that was stored on disk under this URL and validator (ETag or Last-Modified).
+    /// The audio is mapped from the file and stays valid until the cache goes away. Returns an empty array on a miss.
+    QByteArray findDecodedAudio(const QUrl& url, const QByteArray& validator, bool& isStereo);
+    
+    /// Stores decoded audio on disk so the next time it is downloaded with the same validator it doesn't need decoding
+    void storeDecodedAudio(const QUrl& url, const QByteArray& validator, const QByteArray& audio, bool isStereo);
+    
 protected:
     virtual QSharedPointer<Resource> createResource(const QUrl& url,
                                                     const QSharedPointer<Resource>& fallback, bool delayLoad, const void* extra);
 private:
     SoundCache(QObject* parent = NULL);
+    ~SoundCache();
+    
+    QString decodedAudioPath(const QUrl& url, const QByteArray& validator) const;
+    void trimDecodedAudioDirectory();
+    
+    QString _decodedAudioDirectory;
+    
+    struct MappedAudio {
+        QFile* file;
+        QByteArray audio;   // points into the mapping of file
+        bool isStereo;
+    };
+    
+    // mapped files are never unmapped while the cache is around, injectors may still be playing out of them
+    QHash<QString, MappedAudio> _mappedDecodedAudio;
 };
 
 #endif // hifi_SoundCache_h
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include <NodeList.h>
 #include <PacketHeaders.h>
 #include <GLMHelpers.h>
+#include <MemoryTracker.h>
 #include <StreamUtils.h>
 #include <UUID.h>
 
@@ -32,6 +33,18 @@ quint64 DEFAULT_FILTERED_LOG_EXPIRY = 2 * USECS_PER_SECOND;
 
 using namespace std;
 
+static MemoryCounter& avatarMemory = MemoryTracker::getInstance().getCounter("Avatars");
+
+void* AvatarData::operator new(size_t size) {
+    avatarMemory.addCPUBytes(size);
+    return ::operator new(size);
+}
+
+void AvatarData::operator delete(void* avatar, size_t size) {
+    avatarMemory.removeCPUBytes(size);
+    ::operator delete(avatar);
+}
+
 AvatarData::AvatarData() :
     _sessionUUID(),
     _position(0.0f),
@@ -46,9 +59,16 @@ AvatarData::AvatarData() :
     _isChatCirclingEnabled(false),
     _forceFaceshiftConnected(false),
     _hasNewJointRotations(true),
+    _lastJointKeyframeTime(0),
+    _sentReferentialVersion(-1),
+    _wholeReferentialRepeats(0),
+    _lastWholeReferentialTime(0),
     _headData(NULL),
     _handData(NULL),
     _faceModelURL("http://invalid.com"),
+    _attachmentDataVersion(0),
+    _sentAttachmentDataVersion(-1),
+    _identityPacketsWithoutAttachments(0),
     _displayNameBoundingRect(), 
     _displayNameTargetAlpha(0.0f), 
     _displayNameAlpha(0.0f),
@@ -127,7 +147,137 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
     _handPosition = glm::inverse(getOrientation()) * (handPosition - _position);
 }
 
-QByteArray AvatarData::toByteArray() {
+// a joint that has turned less than this since it was last sent isn't sent again
+const float MIN_JOINT_ROTATION_CHANGE_DOT = 0.999999f; // about 0.16 degrees
+
+// all joints are sent this often, so a receiver that lost an update does not keep a stale joint for long
+const quint64 JOINT_KEYFRAME_INTERVAL_USECS = USECS_PER_SECOND;
+
+const int BYTES_PER_JOINT_ROTATION = 6; // packOrientationQuatToSixBytes
+
+static bool shouldSendJoint(const QVector<JointData>& jointData, const QVector<JointData>& sentJointData,
+                            int jointIndex, bool sendAllJoints) {
+    const JointData& data = jointData.at(jointIndex);
+    if (!data.valid) {
+        return false;
+    }
+    if (sendAllJoints || jointIndex >= sentJointData.size() || !sentJointData.at(jointIndex).valid) {
+        return true;
+    }
+    return fabsf(glm::dot(data.rotation, sentJointData.at(jointIndex).rotation)) < MIN_JOINT_ROTATION_CHANGE_DOT;
+}
+
+QByteArray AvatarData::toByteArray(bool includeFaceData) {
+    QByteArray avatarDataByteArray = stateToByteArray(includeFaceData, shouldSendWholeReferential());
+    
+    quint64 now = usecTimestampNow();
+    bool sendAllJoints = (now - _lastJointKeyframeTime) >= JOINT_KEYFRAME_INTERVAL_USECS;
+    if (sendAllJoints) {
+        _lastJointKeyframeTime = now;
+    }
+    
+    int stateSize = avatarDataByteArray.size();
+    avatarDataByteArray.resize(stateSize + maxJointDataSize(_jointData.size()));
+    
+    int jointDataSize = packJointData(reinterpret_cast<unsigned char*>(avatarDataByteArray.data()) + stateSize,
+                                      _jointData, _sentJointData, sendAllJoints);
+    updateSentJointData(_jointData, _sentJointData, sendAllJoints);
+    
+    avatarDataByteArray.resize(stateSize + jointDataSize);
+    return avatarDataByteArray;
+}
+
+int AvatarData::maxJointDataSize(int numJoints) {
+    int bytesOfBits = (numJoints + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+    return 1 + 2 * bytesOfBits + numJoints * BYTES_PER_JOINT_ROTATION;
+}
+
+int AvatarData::packJointData(unsigned char* destinationBuffer, const QVector<JointData>& jointData,
+                              const QVector<JointData>& sentJointData, bool sendAllJoints) {
+    unsigned char* startPosition = destinationBuffer;
+    
+    *destinationBuffer++ = jointData.size();
+    
+    // validity bits
+    unsigned char validity = 0;
+    int validityBit = 0;
+    foreach (const JointData& data, jointData) {
+        if (data.valid) {
+            validity |= (1 << validityBit);
+        }
+        if (++validityBit == BITS_IN_BYTE) {
+            *destinationBuffer++ = validity;
+            validityBit = validity = 0;
+        }
+    }
+    if (validityBit != 0) {
+        *destinationBuffer++ = validity;
+    }
+    
+    // sent bits, the joints with a valid but unsent rotation keep the one the receiver has
+    unsigned char sent = 0;
+    int sentBit = 0;
+    for (int i = 0; i < jointData.size(); i++) {
+        if (shouldSendJoint(jointData, sentJointData, i, sendAllJoints)) {
+            sent |= (1 << sentBit);
+        }
+        if (++sentBit == BITS_IN_BYTE) {
+            *destinationBuffer++ = sent;
+            sentBit = sent = 0;
+        }
+    }
+    if (sentBit != 0) {
+        *destinationBuffer++ = sent;
+    }
+    
+    for (int i = 0; i < jointData.size(); i++) {
+        if (shouldSendJoint(jointData, sentJointData, i, sendAllJoints)) {
+            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, jointData.at(i).rotation);
+        }
+    }
+    
+    return destinationBuffer - startPosition;
+}
+
+void AvatarData::updateSentJointData(const QVector<JointData>& jointData, QVector<JointData>& sentJointData,
+                                     bool sendAllJoints) {
+    int oldSentSize = sentJointData.size();
+    sentJointData.resize(jointData.size());
+    
+    for (int i = 0; i < jointData.size(); i++) {
+        if (i >= oldSentSize) {
+            sentJointData[i].valid = false;
+        }
+        if (shouldSendJoint(jointData, sentJointData, i, sendAllJoints)) {
+            sentJointData[i] = jointData.at(i);
+        } else if (!jointData.at(i).valid) {
+            sentJointData[i].valid = false;
+        }
+    }
+}
+
+const int WHOLE_REFERENTIAL_REPEATS = 3;
+const quint64 WHOLE_REFERENTIAL_INTERVAL_USECS = USECS_PER_SECOND;
+
+bool AvatarData::shouldSendWholeReferential() {
+    if (_referential == NULL || !_referential->isValid()) {
+        _sentReferentialVersion = -1;
+        return false;
+    }
+    if (_referential->version() != _sentReferentialVersion) {
+        _sentReferentialVersion = _referential->version();
+        _wholeReferentialRepeats = WHOLE_REFERENTIAL_REPEATS;
+    }
+    quint64 now = usecTimestampNow();
+    if (_wholeReferentialRepeats > 0 || now - _lastWholeReferentialTime >= WHOLE_REFERENTIAL_INTERVAL_USECS) {
+        _wholeReferentialRepeats = qMax(_wholeReferentialRepeats - 1, 0);
+        _lastWholeReferentialTime = now;
+        return true;
+    }
+    return false;
+}
+
+QByteArray AvatarData::stateToByteArray(bool includeFaceData, bool wholeReferential) {
     // TODO: DRY this up to a shared method
     // that can pack any type given the number of bytes
     // and return the number of bytes to push the pointer
@@ -139,6 +289,7 @@ QByteArray AvatarData::toByteArray() {
     if (_forceFaceshiftConnected) {
         _headData->_isFaceshiftConnected = true;
     }
+    bool sendFaceData = includeFaceData && _headData->_isFaceshiftConnected;
     
     QByteArray avatarDataByteArray;
     avatarDataByteArray.resize(MAX_PACKET_SIZE);
@@ -191,7 +342,7 @@ QByteArray AvatarData::toByteArray() {
         setAtBit(bitItems, HAND_STATE_FINGER_POINTING_BIT);
     }
     // faceshift state
-    if (_headData->_isFaceshiftConnected) {
+    if (sendFaceData) {
         setAtBit(bitItems, IS_FACESHIFT_CONNECTED);
     }
     if (_isChatCirclingEnabled) {
@@ -204,11 +355,11 @@ QByteArray AvatarData::toByteArray() {
     
     // Add referential
     if (_referential != NULL && _referential->isValid()) {
-        destinationBuffer += _referential->packReferential(destinationBuffer);
+        destinationBuffer += _referential->packReferential(destinationBuffer, wholeReferential);
     }
 
     // If it is connected, pack up the data
-    if (_headData->_isFaceshiftConnected) {
+    if (sendFaceData) {
         memcpy(destinationBuffer, &_headData->_leftEyeBlink, sizeof(float));
         destinationBuffer += sizeof(float);
 
@@ -229,29 +380,7 @@ QByteArray AvatarData::toByteArray() {
     
     // pupil dilation
     destinationBuffer += packFloatToByte(destinationBuffer, _headData->_pupilDilation, 1.0f);
-
-    // joint data
-    *destinationBuffer++ = _jointData.size();
-    unsigned char validity = 0;
-    int validityBit = 0;
-    foreach (const JointData& data, _jointData) {
-        if (data.valid) {
-            validity |= (1 << validityBit);
-        }
-        if (++validityBit == BITS_IN_BYTE) {
-            *destinationBuffer++ = validity;
-            validityBit = validity = 0;
-        }
-    }
-    if (validityBit != 0) {
-        *destinationBuffer++ = validity;
-    }
-    foreach (const JointData& data, _jointData) {
-        if (data.valid) {
-            destinationBuffer += packOrientationQuatToBytes(destinationBuffer, data.rotation);
-        }
-    }
-        
+    
     return avatarDataByteArray.left(destinationBuffer - startPosition);
 }
 
@@ -423,14 +552,21 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
         
         // Referential
         if (hasReferential) {
-            Referential* ref = new Referential(sourceBuffer, this);
-            if (_referential == NULL ||
-                ref->version() != _referential->version()) {
-                changeReferential(ref);
+            if (Referential::isWholeReferential(sourceBuffer)) {
+                Referential* ref = new Referential(sourceBuffer, this);
+                if (_referential == NULL ||
+                    ref->version() != _referential->version()) {
+                    changeReferential(ref);
+                } else {
+                    delete ref;
+                }
             } else {
-                delete ref;
+                // the one we have stays, it's current unless the whole one after a change was lost
+                sourceBuffer += Referential::TYPE_AND_VERSION_SIZE;
+            }
+            if (_referential != NULL) {
+                _referential->update();
             }
-            _referential->update();
         } else if (_referential != NULL) {
             changeReferential(NULL);
         }
@@ -501,8 +637,8 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
     
     // joint data
     int numJoints = *sourceBuffer++;
-    int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-    minPossibleSize += bytesOfValidity;
+    int bytesOfBits = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+    minPossibleSize += 2 * bytesOfBits;
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qDebug() << "Malformed AvatarData packet after JointValidityBits;"
@@ -512,7 +648,6 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
         }
         return maxAvailableSize;
     }
-    int numValidJoints = 0;
     _jointData.resize(numJoints);
     { // validity bits
         unsigned char validity = 0;
@@ -521,19 +656,33 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
             if (validityBit == 0) {
                 validity = *sourceBuffer++;
             }
-            bool valid = (bool)(validity & (1 << validityBit));
-            if (valid) {
-                ++numValidJoints;
-            }
-            _jointData[i].valid = valid;
+            _jointData[i].valid = (bool)(validity & (1 << validityBit));
             validityBit = (validityBit + 1) % BITS_IN_BYTE; 
         }
     }
-    // 1 + bytesOfValidity bytes
+    // 1 + bytesOfBits bytes
+
+    // sent bits, a valid joint that wasn't sent keeps the last rotation we got for it
+    const int MAX_PACKED_JOINTS = 256; // numJoints is a single byte
+    bool jointSent[MAX_PACKED_JOINTS];
+    int numSentJoints = 0;
+    {
+        unsigned char sent = 0;
+        int sentBit = 0;
+        for (int i = 0; i < numJoints; i++) {
+            if (sentBit == 0) {
+                sent = *sourceBuffer++;
+            }
+            jointSent[i] = _jointData[i].valid && (sent & (1 << sentBit));
+            if (jointSent[i]) {
+                ++numSentJoints;
+            }
+            sentBit = (sentBit + 1) % BITS_IN_BYTE;
+        }
+    }
+    // bytesOfBits bytes
 
-    // each joint rotation component is stored in two bytes (sizeof(uint16_t))
-    int COMPONENTS_PER_QUATERNION = 4;
-    minPossibleSize += numValidJoints * COMPONENTS_PER_QUATERNION * sizeof(uint16_t);
+    minPossibleSize += numSentJoints * BYTES_PER_JOINT_ROTATION;
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qDebug() << "Malformed AvatarData packet after JointData;"
@@ -546,17 +695,79 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
 
     { // joint data
         for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (data.valid) {
+            if (jointSent[i]) {
                 _hasNewJointRotations = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
+                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, _jointData[i].rotation);
             }
         }
-    } // numJoints * 8 bytes
+    } // numSentJoints * 6 bytes
     
     return sourceBuffer - startPosition;
 }
 
+void AvatarData::applyParsedData(AvatarData& parsed) {
+    _lastUpdateTimer.restart();
+    
+    if (!_headData) {
+        _headData = new HeadData(this);
+    }
+    if (!_handData) {
+        _handData = new HandData(this);
+    }
+    
+    // in the order parseDataAtOffset sets them, so that a referential governs the position the same way
+    setPosition(parsed._position);
+    if (_bodyYaw != parsed._bodyYaw || _bodyPitch != parsed._bodyPitch || _bodyRoll != parsed._bodyRoll) {
+        _hasNewJointRotations = true;
+        _bodyYaw = parsed._bodyYaw;
+        _bodyPitch = parsed._bodyPitch;
+        _bodyRoll = parsed._bodyRoll;
+    }
+    _targetScale = parsed._targetScale;
+    
+    const HeadData* parsedHead = parsed._headData;
+    _headData->setBasePitch(parsedHead->_basePitch);
+    _headData->setBaseYaw(parsedHead->_baseYaw);
+    _headData->setBaseRoll(parsedHead->_baseRoll);
+    _headData->_lookAtPosition = parsedHead->_lookAtPosition;
+    _headData->_audioLoudness = parsedHead->_audioLoudness;
+    
+    _keyState = parsed._keyState;
+    _handState = parsed._handState;
+    _headData->_isFaceshiftConnected = parsedHead->_isFaceshiftConnected;
+    _isChatCirclingEnabled = parsed._isChatCirclingEnabled;
+    
+    if (parsed._referential) {
+        if (_referential == NULL || _referential->version() != parsed._referential->version()) {
+            // the parsed one belongs to the other avatar, so this one gets its own from the same data
+            unsigned char referentialBuffer[MAX_PACKET_SIZE];
+            parsed._referential->packReferential(referentialBuffer);
+            const unsigned char* sourceBuffer = referentialBuffer;
+            changeReferential(new Referential(sourceBuffer, this));
+        }
+        _referential->update();
+    } else if (_referential != NULL) {
+        changeReferential(NULL);
+    }
+    
+    // without faceshift, the face is animated locally rather than from the packets
+    if (_headData->_isFaceshiftConnected) {
+        _headData->_leftEyeBlink = parsedHead->_leftEyeBlink;
+        _headData->_rightEyeBlink = parsedHead->_rightEyeBlink;
+        _headData->_averageLoudness = parsedHead->_averageLoudness;
+        _headData->_browAudioLift = parsedHead->_browAudioLift;
+        _headData->_blendshapeCoefficients = parsedHead->_blendshapeCoefficients;
+    }
+    _headData->_pupilDilation = parsedHead->_pupilDilation;
+    
+    // implicitly shared, the parsing thread copies the joints only when it next writes them
+    _jointData = parsed._jointData;
+    if (parsed._hasNewJointRotations) {
+        _hasNewJointRotations = true;
+        parsed._hasNewJointRotations = false;
+    }
+}
+
 bool AvatarData::hasReferential() {
     return _referential != NULL;
 }
@@ -868,7 +1079,11 @@ bool AvatarData::hasIdentityChangedAfterParsing(const QByteArray &packet) {
     QUrl faceModelURL, skeletonModelURL;
     QVector<AttachmentData> attachmentData;
     QString displayName;
-    packetStream >> avatarUUID >> faceModelURL >> skeletonModelURL >> attachmentData >> displayName;
+    bool hasAttachmentData;
+    packetStream >> avatarUUID >> faceModelURL >> skeletonModelURL >> displayName >> hasAttachmentData;
+    if (hasAttachmentData) {
+        packetStream >> attachmentData;
+    }
     
     bool hasIdentityChanged = false;
     
@@ -887,7 +1102,7 @@ bool AvatarData::hasIdentityChangedAfterParsing(const QByteArray &packet) {
         hasIdentityChanged = true;
     }
     
-    if (attachmentData != _attachmentData) {
+    if (hasAttachmentData && attachmentData != _attachmentData) {
         setAttachmentData(attachmentData);
         hasIdentityChanged = true;
     }
@@ -895,11 +1110,14 @@ bool AvatarData::hasIdentityChangedAfterParsing(const QByteArray &packet) {
     return hasIdentityChanged;
 }
 
-QByteArray AvatarData::identityByteArray() {
+QByteArray AvatarData::identityByteArray(bool includeAttachments) {
     QByteArray identityData;
     QDataStream identityStream(&identityData, QIODevice::Append);
 
-    identityStream << QUuid() << _faceModelURL << _skeletonModelURL << _attachmentData << _displayName;
+    identityStream << QUuid() << _faceModelURL << _skeletonModelURL << _displayName << includeAttachments;
+    if (includeAttachments) {
+        identityStream << _attachmentData;
+    }
     
     return identityData;
 }
@@ -948,7 +1166,10 @@ void AvatarData::setAttachmentData(const QVector<AttachmentData>& attachmentData
         QMetaObject::invokeMethod(this, "setAttachmentData", Q_ARG(const QVector<AttachmentData>&, attachmentData));
         return;
     }
-    _attachmentData = attachmentData;
+    if (attachmentData != _attachmentData) {
+        _attachmentData = attachmentData;
+        _attachmentDataVersion++;
+    }
 }
 
 void AvatarData::attach(const QString& modelURL, const QString& jointName, const glm::vec3& translation,
@@ -1075,9 +1296,27 @@ void AvatarData::sendAvatarDataPacket() {
     DependencyManager::get<NodeList>()->broadcastToNodes(dataPacket, NodeSet() << NodeType::AvatarMixer);
 }
 
+// the attachments are sent again this often even when they haven't changed, in case the mixer lost them
+const int IDENTITY_PACKETS_PER_ATTACHMENT_DATA = 10;
+
 void AvatarData::sendIdentityPacket() {
+    sendIdentity(_attachmentDataVersion != _sentAttachmentDataVersion ||
+        _identityPacketsWithoutAttachments >= IDENTITY_PACKETS_PER_ATTACHMENT_DATA - 1);
+}
+
+void AvatarData::sendFullIdentityPacket() {
+    sendIdentity(true);
+}
+
+void AvatarData::sendIdentity(bool includeAttachments) {
+    if (includeAttachments) {
+        _sentAttachmentDataVersion = _attachmentDataVersion;
+        _identityPacketsWithoutAttachments = 0;
+    } else {
+        _identityPacketsWithoutAttachments++;
+    }
     QByteArray identityPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
-    identityPacket.append(identityByteArray());
+    identityPacket.append(identityByteArray(includeAttachments));
     
     DependencyManager::get<NodeList>()->broadcastToNodes(identityPacket, NodeSet() << NodeType::AvatarMixer);
 }
@@ -156,6 +156,10 @@ class AvatarData : public QObject {
 public:
     AvatarData();
     virtual ~AvatarData();
+
+    /// Avatars are counted in the MemoryTracker at the size of the type made.
+    static void* operator new(size_t size);
+    static void operator delete(void* avatar, size_t size);
     
     virtual bool isMyAvatar() { return false; }
 
@@ -167,7 +171,31 @@ public:
     glm::vec3 getHandPosition() const;
     void setHandPosition(const glm::vec3& handPosition);
 
-    virtual QByteArray toByteArray();
+    /// \param includeFaceData false to leave out the faceshift blendshapes, for listeners too far away to see them
+    virtual QByteArray toByteArray(bool includeFaceData = true);
+    
+    /// everything toByteArray packs ahead of the joint data
+    /// \param wholeReferential false to send only the type and version of the referential, for receivers that have
+    /// the rest of it from before
+    QByteArray stateToByteArray(bool includeFaceData = true, bool wholeReferential = true);
+    
+    /// Whether the referential should go whole in the next avatar data: the first few times after it changes, in
+    /// case one is lost, and once a second for the receivers that joined since.  Just its type and version go
+    /// otherwise, as what it holds is relative to the entity and stays put while the entity moves.
+    bool shouldSendWholeReferential();
+    
+    /// Packs the joint data that ends the avatar data: the validity bits, a bit per joint (set if its rotation follows)
+    /// and those rotations. Unless sendAllJoints is set, a valid joint is only sent if it has moved away from the
+    /// rotation in sentJointData, the receiver keeps the last rotation it got for the others.
+    /// \return the number of bytes written, at most maxJointDataSize(jointData.size())
+    static int packJointData(unsigned char* destinationBuffer, const QVector<JointData>& jointData,
+                             const QVector<JointData>& sentJointData, bool sendAllJoints);
+    
+    /// records in sentJointData what packJointData sent with the same arguments
+    static void updateSentJointData(const QVector<JointData>& jointData, QVector<JointData>& sentJointData,
+                                    bool sendAllJoints);
+    
+    static int maxJointDataSize(int numJoints);
 
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
@@ -177,6 +205,10 @@ public:
     /// \return number of bytes parsed
     virtual int parseDataAtOffset(const QByteArray& packet, int offset);
 
+    /// Takes on the state another AvatarData parsed from avatar data packets, as if this one had parsed them.
+    /// \param parsed the avatar a network thread parses into; its new joint rotations flag is cleared
+    virtual void applyParsedData(AvatarData& parsed);
+
     //  Body Rotation (degrees)
     float getBodyYaw() const { return _bodyYaw; }
     void setBodyYaw(float bodyYaw) { _bodyYaw = bodyYaw; }
@@ -242,6 +274,9 @@ public:
     Q_INVOKABLE void setBlendshape(QString name, float val) { _headData->setBlendshape(name, val); }
 
     void setForceFaceshiftConnected(bool connected) { _forceFaceshiftConnected = connected; }
+    
+    /// whether stateToByteArray has face data to include when it is asked to
+    bool hasFaceData() const { return _forceFaceshiftConnected || (_headData && _headData->_isFaceshiftConnected); }
 
     // key state
     void setKeyState(KeyState s) { _keyState = s; }
@@ -256,7 +291,9 @@ public:
     }
 
     bool hasIdentityChangedAfterParsing(const QByteArray& packet);
-    QByteArray identityByteArray();
+    
+    /// \param includeAttachments false to leave the attachments out, for the receiver to keep those it has
+    QByteArray identityByteArray(bool includeAttachments = true);
     
     bool hasBillboardChangedAfterParsing(const QByteArray& packet);
     
@@ -302,7 +339,12 @@ public:
 
 public slots:
     void sendAvatarDataPacket();
+    /// Sends the identity to the mixer.  The attachments go along only if they changed since they were last sent, or
+    /// haven't been sent for a while.
     void sendIdentityPacket();
+    
+    /// Sends the identity with the attachments, as to a mixer that just connected.
+    void sendFullIdentityPacket();
     void sendBillboardPacket();
     
     void setBillboardFromNetworkReply();
@@ -352,6 +394,15 @@ protected:
     char _handState;
 
     QVector<JointData> _jointData; ///< the state of the skeleton joints
+    
+    // what toByteArray last sent of each joint, and when it last sent all of them
+    QVector<JointData> _sentJointData;
+    quint64 _lastJointKeyframeTime;
+    
+    // the version of the referential last sent, or -1, how many more times it's to be sent whole, and when it last was
+    int _sentReferentialVersion;
+    int _wholeReferentialRepeats;
+    quint64 _lastWholeReferentialTime;
 
     // key state
     KeyState _keyState;
@@ -366,6 +417,9 @@ protected:
     QUrl _faceModelURL = DEFAULT_HEAD_MODEL_URL;
     QUrl _skeletonModelURL = DEFAULT_BODY_MODEL_URL;
     QVector<AttachmentData> _attachmentData;
+    int _attachmentDataVersion; ///< goes up as the attachments change
+    int _sentAttachmentDataVersion; ///< what the identity packets last carried, or -1
+    int _identityPacketsWithoutAttachments;
     QString _displayName;
 
     QRect _displayNameBoundingRect;
@@ -388,6 +442,7 @@ protected:
     /// Loads the joint indices, names from the FST file (if any)
     virtual void updateJointMappings();
     void changeReferential(Referential* ref);
+    void sendIdentity(bool includeAttachments);
 
 private:
     // privatize the copy constructor and assignment operator so they cannot be called
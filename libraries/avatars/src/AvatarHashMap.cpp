@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QMutexLocker>
+
 #include <NodeList.h>
 #include <PacketHeaders.h>
 
@@ -21,6 +23,11 @@ AvatarHashMap::AvatarHashMap() {
 
 AvatarHash::iterator AvatarHashMap::erase(const AvatarHash::iterator& iterator) {
     qDebug() << "Removing Avatar with UUID" << iterator.key() << "from AvatarHashMap.";
+    {
+        QMutexLocker locker(&_parsedAvatarsMutex);
+        _parsedAvatars.remove(iterator.key());
+        _updatedParsedAvatars.remove(iterator.key());
+    }
     return _avatarHash.erase(iterator);
 }
 
@@ -50,6 +57,61 @@ void AvatarHashMap::processAvatarMixerDatagram(const QByteArray& datagram, const
     }
 }
 
+void AvatarHashMap::queueAvatarMixerDatagram(const QByteArray& datagram, const QWeakPointer<Node>& mixerWeakPointer) {
+    PacketType packetType = packetTypeForPacket(datagram);
+    if (packetType == PacketTypeBulkAvatarData) {
+        parseAvatarDataPacket(datagram, mixerWeakPointer);
+        return;
+    }
+    if (packetType == PacketTypeKillAvatar) {
+        // so that data parsed before the kill doesn't bring the avatar back
+        QUuid sessionUUID = QUuid::fromRfc4122(datagram.mid(numBytesForPacketHeader(datagram), NUM_BYTES_RFC4122_UUID));
+        QMutexLocker locker(&_parsedAvatarsMutex);
+        _parsedAvatars.remove(sessionUUID);
+        _updatedParsedAvatars.remove(sessionUUID);
+    }
+    QMetaObject::invokeMethod(this, "processAvatarMixerDatagram", Q_ARG(const QByteArray&, datagram),
+        Q_ARG(const QWeakPointer<Node>&, mixerWeakPointer));
+}
+
+void AvatarHashMap::parseAvatarDataPacket(const QByteArray& datagram, const QWeakPointer<Node>& mixerWeakPointer) {
+    int bytesRead = numBytesForPacketHeader(datagram);
+    
+    QMutexLocker locker(&_parsedAvatarsMutex);
+    while (bytesRead < datagram.size() && mixerWeakPointer.data()) {
+        QUuid sessionUUID = QUuid::fromRfc4122(datagram.mid(bytesRead, NUM_BYTES_RFC4122_UUID));
+        bytesRead += NUM_BYTES_RFC4122_UUID;
+        
+        if (sessionUUID != _parsedOwnerSessionUUID) {
+            AvatarSharedPointer& parsedAvatar = _parsedAvatars[sessionUUID];
+            if (!parsedAvatar) {
+                // a plain AvatarData, which has none of the models an avatar in the hash loads
+                parsedAvatar = AvatarSharedPointer(new AvatarData());
+                parsedAvatar->setSessionUUID(sessionUUID);
+            }
+            bytesRead += parsedAvatar->parseDataAtOffset(datagram, bytesRead);
+            _updatedParsedAvatars.insert(sessionUUID, mixerWeakPointer);
+        } else {
+            // create a dummy AvatarData class to throw this data on the ground
+            AvatarData dummyData;
+            bytesRead += dummyData.parseDataAtOffset(datagram, bytesRead);
+        }
+    }
+}
+
+void AvatarHashMap::applyParsedAvatarData() {
+    QMutexLocker locker(&_parsedAvatarsMutex);
+    for (QHash<QUuid, QWeakPointer<Node> >::const_iterator it = _updatedParsedAvatars.constBegin();
+            it != _updatedParsedAvatars.constEnd(); it++) {
+        AvatarSharedPointer parsedAvatar = _parsedAvatars.value(it.key());
+        // only add them if the mixer is still around, as when parsing on this thread
+        if (parsedAvatar && it.value().data()) {
+            matchingOrNewAvatar(it.key(), it.value())->applyParsedData(*parsedAvatar);
+        }
+    }
+    _updatedParsedAvatars.clear();
+}
+
 bool AvatarHashMap::containsAvatarWithDisplayName(const QString& displayName) {
     return !avatarWithDisplayName(displayName).isNull();
 }
@@ -129,7 +191,11 @@ void AvatarHashMap::processAvatarIdentityPacket(const QByteArray &packet, const
         QUrl faceMeshURL, skeletonURL;
         QVector<AttachmentData> attachmentData;
         QString displayName;
-        identityStream >> sessionUUID >> faceMeshURL >> skeletonURL >> attachmentData >> displayName;
+        bool hasAttachmentData;
+        identityStream >> sessionUUID >> faceMeshURL >> skeletonURL >> displayName >> hasAttachmentData;
+        if (hasAttachmentData) {
+            identityStream >> attachmentData;
+        }
         
         // mesh URL for a UUID, find avatar in our list
         AvatarSharedPointer matchingAvatar = matchingOrNewAvatar(sessionUUID, mixerWeakPointer);
@@ -143,7 +209,7 @@ void AvatarHashMap::processAvatarIdentityPacket(const QByteArray &packet, const
                 matchingAvatar->setSkeletonModelURL(skeletonURL);
             }
             
-            if (matchingAvatar->getAttachmentData() != attachmentData) {
+            if (hasAttachmentData && matchingAvatar->getAttachmentData() != attachmentData) {
                 matchingAvatar->setAttachmentData(attachmentData);
             }
             
@@ -180,4 +246,7 @@ void AvatarHashMap::processKillAvatar(const QByteArray& datagram) {
 
 void AvatarHashMap::sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID) {
     _lastOwnerSessionUUID = oldUUID;
+    
+    QMutexLocker locker(&_parsedAvatarsMutex);
+    _parsedOwnerSessionUUID = oldUUID;
 }
\ No newline at end of file
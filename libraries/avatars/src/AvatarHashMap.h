@@ -13,6 +13,7 @@
 #define hifi_AvatarHashMap_h
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QUuid>
 
@@ -33,6 +34,13 @@ public:
     const AvatarHash& getAvatarHash() { return _avatarHash; }
     int size() { return _avatarHash.size(); }
     
+    /// Parses avatar data on the calling network thread into avatars of its own, for applyParsedAvatarData to copy into
+    /// the hash. The identity, billboard and kill packets, which can change models, go to this object's thread instead.
+    void queueAvatarMixerDatagram(const QByteArray& datagram, const QWeakPointer<Node>& mixerWeakPointer);
+    
+    /// Copies what the network thread parsed since the last call into the avatars, adding any new ones.
+    void applyParsedAvatarData();
+    
 public slots:
     void processAvatarMixerDatagram(const QByteArray& datagram, const QWeakPointer<Node>& mixerWeakPointer);
     bool containsAvatarWithDisplayName(const QString& displayName);
@@ -57,6 +65,14 @@ protected:
 
     AvatarHash _avatarHash;
     QUuid _lastOwnerSessionUUID;
+    
+private:
+    void parseAvatarDataPacket(const QByteArray& packet, const QWeakPointer<Node>& mixerWeakPointer);
+    
+    QMutex _parsedAvatarsMutex; ///< guards everything below, shared with the network thread
+    AvatarHash _parsedAvatars; ///< what the network thread parses into, one per avatar
+    QHash<QUuid, QWeakPointer<Node> > _updatedParsedAvatars; ///< parsed into since the last apply, and by which mixer
+    QUuid _parsedOwnerSessionUUID; ///< the network thread's copy of _lastOwnerSessionUUID
 };
 
 #endif // hifi_AvatarHashMap_h
@@ -169,7 +169,12 @@ void Player::setupAudioThread() {
     _audioThread->setObjectName("Player Audio Thread");
     _options.position = _avatar->getPosition();
     _options.orientation = _avatar->getOrientation();
-    _injector.reset(new AudioInjector(_recording->getAudioData(), _options), &QObject::deleteLater);
+    
+    // a mapped recording's audio points into its file, which clear() unmaps while the injector may still be reading
+    // from the scheduler thread, so the injector gets a copy of its own
+    const QByteArray& audioData = _recording->getAudioData();
+    _injector.reset(new AudioInjector(QByteArray(audioData.constData(), audioData.size()), _options),
+                    &QObject::deleteLater);
     _injector->moveToThread(_audioThread);
     _audioThread->start();
     QMetaObject::invokeMethod(_injector.data(), "injectAudio", Qt::QueuedConnection);
@@ -196,6 +201,9 @@ void Player::loopRecording() {
 }
 
 void Player::loadFromFile(const QString& file) {
+    if (isPlaying()) {
+        stopPlaying();
+    }
     if (_recording) {
         _recording->clear();
     } else {
@@ -33,7 +33,21 @@
 static const int MAGIC_NUMBER_SIZE = 8;
 static const char MAGIC_NUMBER[MAGIC_NUMBER_SIZE] = {17, 72, 70, 82, 13, 10, 26, 10};
 // Version (Major, Minor)
-static const QPair<quint8, quint8> VERSION(0, 2);
+static const QPair<quint8, quint8> VERSION(0, 3);
+
+// Versions before 0.3 store every frame one after the other, delta encoded against the frame before it
+static const QPair<quint8, quint8> VERSION_SEQUENTIAL_FIXED_FLOATS(0, 1);
+static const QPair<quint8, quint8> VERSION_SEQUENTIAL(0, 2);
+
+// About a second of frames, any frame can be decoded without decoding more than this many
+static const int FRAMES_PER_CHUNK = 60;
+
+// The chunks either side of a chunk boundary are both needed while interpolating across it
+static const int MAX_DECODED_CHUNKS = 2;
+
+void readRecordingFrame(QDataStream& stream, RecordingFrame& frame, const RecordingFrame& previousFrame,
+                        QPair<quint8, quint8> version, quint32& numBlendshapes, quint32& numJoints,
+                        bool readCounts);
 
 int SCALE_RADIX = 10;
 int BLENDSHAPE_RADIX = 15;
@@ -43,6 +57,18 @@ void RecordingFrame::setBlendshapeCoefficients(QVector<float> blendshapeCoeffici
     _blendshapeCoefficients = blendshapeCoefficients;
 }
 
+Recording::Recording() :
+    _framesPerChunk(FRAMES_PER_CHUNK),
+    _numBlendshapes(0),
+    _numJoints(0)
+{
+}
+
+Recording::~Recording() {
+    // the audio and file data may point into the mapping, let go of them before it is unmapped
+    clear();
+}
+
 int Recording::getLength() const {
     if (_timestamps.isEmpty()) {
         return 0;
@@ -60,9 +86,59 @@ qint32 Recording::getFrameTimestamp(int i) const {
     return _timestamps[i];
 }
 
-const RecordingFrame& Recording::getFrame(int i) const {
+RecordingFrame Recording::getFrame(int i) const {
     assert(i < _timestamps.size());
-    return _frames[i];
+    if (_frameChunks.isEmpty()) {
+        return _frames[i];
+    }
+    
+    const QVector<RecordingFrame>& chunkFrames = getChunkFrames(i / _framesPerChunk);
+    int frameInChunk = i % _framesPerChunk;
+    return (frameInChunk < chunkFrames.size()) ? chunkFrames[frameInChunk] : RecordingFrame();
+}
+
+const QVector<RecordingFrame>& Recording::getChunkFrames(int chunkIndex) const {
+    for (int i = 0; i < _decodedChunks.size(); ++i) {
+        if (_decodedChunks[i].index == chunkIndex) {
+            _decodedChunks.move(i, 0);
+            return _decodedChunks[0].frames;
+        }
+    }
+    
+    DecodedChunk decodedChunk;
+    decodedChunk.index = chunkIndex;
+    
+    const FrameChunk& chunk = _frameChunks[chunkIndex];
+    QByteArray chunkData = QByteArray::fromRawData(_fileData.constData() + chunk.offset, chunk.size);
+    if (qChecksum(chunkData.constData(), chunkData.size()) != chunk.crc16) {
+        qDebug() << "Checksum of recording chunk" << chunkIndex << "does not match, skipping its frames.";
+    } else {
+        if (chunk.isCompressed) {
+            chunkData = qUncompress(chunkData);
+        }
+        
+        int numFrames = qMin(_framesPerChunk, _timestamps.size() - chunkIndex * _framesPerChunk);
+        decodedChunk.frames.resize(numFrames);
+        
+        QDataStream stream(chunkData);
+        quint32 numBlendshapes = _numBlendshapes;
+        quint32 numJoints = _numJoints;
+        RecordingFrame keyframe;
+        for (int i = 0; i < numFrames; ++i) {
+            readRecordingFrame(stream, decodedChunk.frames[i], (i == 0) ? keyframe : decodedChunk.frames[i - 1],
+                               VERSION, numBlendshapes, numJoints, false);
+        }
+        if (stream.status() != QDataStream::Ok) {
+            qDebug() << "Recording chunk" << chunkIndex << "is truncated, skipping its frames.";
+            decodedChunk.frames.clear();
+        }
+    }
+    
+    _decodedChunks.prepend(decodedChunk);
+    while (_decodedChunks.size() > MAX_DECODED_CHUNKS) {
+        _decodedChunks.removeLast();
+    }
+    return _decodedChunks[0].frames;
 }
 
 void Recording::addFrame(int timestamp, RecordingFrame &frame) {
@@ -74,6 +150,11 @@ void Recording::clear() {
     _timestamps.clear();
     _frames.clear();
     _audioData.clear();
+    
+    _decodedChunks.clear();
+    _frameChunks.clear();
+    _fileData.clear();
+    _mappedFile.reset();
 }
 
 void writeVec3(QDataStream& stream, const glm::vec3& value) {
@@ -117,6 +198,164 @@ bool readFloat(QDataStream& stream, float& value, int radix) {
     return true;
 }
 
+void writeRecordingFrame(QDataStream& stream, const RecordingFrame& frame, const RecordingFrame* previousFrame,
+                         quint32 numBlendshapes, quint32 numJoints) {
+    // with no previous frame this is a keyframe and every value is written
+    QBitArray mask(numBlendshapes + numJoints + 7);
+    int maskIndex = 0;
+    QByteArray buffer;
+    QDataStream frameStream(&buffer, QIODevice::WriteOnly);
+    
+    // Blendshape Coefficients
+    for (quint32 j = 0; j < numBlendshapes; ++j) {
+        if (!previousFrame ||
+            frame._blendshapeCoefficients[j] != previousFrame->_blendshapeCoefficients[j]) {
+            frameStream << frame._blendshapeCoefficients[j];
+            mask.setBit(maskIndex);
+        }
+        ++maskIndex;
+    }
+    
+    // Joint Rotations
+    for (quint32 j = 0; j < numJoints; ++j) {
+        if (!previousFrame ||
+            frame._jointRotations[j] != previousFrame->_jointRotations[j]) {
+            writeQuat(frameStream, frame._jointRotations[j]);
+            mask.setBit(maskIndex);
+        }
+        maskIndex++;
+    }
+    
+    // Translation
+    if (!previousFrame || frame._translation != previousFrame->_translation) {
+        writeVec3(frameStream, frame._translation);
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // Rotation
+    if (!previousFrame || frame._rotation != previousFrame->_rotation) {
+        writeQuat(frameStream, frame._rotation);
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // Scale
+    if (!previousFrame || frame._scale != previousFrame->_scale) {
+        frameStream << frame._scale;
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // Head Rotation
+    if (!previousFrame || frame._headRotation != previousFrame->_headRotation) {
+        writeQuat(frameStream, frame._headRotation);
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // Lean Sideways
+    if (!previousFrame || frame._leanSideways != previousFrame->_leanSideways) {
+        frameStream << frame._leanSideways;
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // Lean Forward
+    if (!previousFrame || frame._leanForward != previousFrame->_leanForward) {
+        frameStream << frame._leanForward;
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    // LookAt Position
+    if (!previousFrame || frame._lookAtPosition != previousFrame->_lookAtPosition) {
+        writeVec3(frameStream, frame._lookAtPosition);
+        mask.setBit(maskIndex);
+    }
+    maskIndex++;
+    
+    stream << mask;
+    stream << buffer;
+}
+
+void readRecordingFrame(QDataStream& stream, RecordingFrame& frame, const RecordingFrame& previousFrame,
+                        QPair<quint8, quint8> version, quint32& numBlendshapes, quint32& numJoints,
+                        bool readCounts) {
+    QBitArray mask;
+    QByteArray buffer;
+    stream >> mask;
+    stream >> buffer;
+    QDataStream frameStream(&buffer, QIODevice::ReadOnly);
+    int maskIndex = 0;
+    
+    // Blendshape Coefficients
+    if (readCounts) {
+        // before version 0.3 the counts are stored in the first frame
+        frameStream >> numBlendshapes;
+    }
+    frame._blendshapeCoefficients.resize(numBlendshapes);
+    for (quint32 j = 0; j < numBlendshapes; ++j) {
+        if (!mask[maskIndex++]) {
+            frame._blendshapeCoefficients[j] = previousFrame._blendshapeCoefficients.value(j);
+        } else if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
+            readFloat(frameStream, frame._blendshapeCoefficients[j], BLENDSHAPE_RADIX);
+        } else {
+            frameStream >> frame._blendshapeCoefficients[j];
+        }
+    }
+    // Joint Rotations
+    if (readCounts) {
+        frameStream >> numJoints;
+    }
+    frame._jointRotations.resize(numJoints);
+    for (quint32 j = 0; j < numJoints; ++j) {
+        if (!mask[maskIndex++] || !readQuat(frameStream, frame._jointRotations[j])) {
+            frame._jointRotations[j] = previousFrame._jointRotations.value(j);
+        }
+    }
+    
+    if (!mask[maskIndex++] || !readVec3(frameStream, frame._translation)) {
+        frame._translation = previousFrame._translation;
+    }
+    
+    if (!mask[maskIndex++] || !readQuat(frameStream, frame._rotation)) {
+        frame._rotation = previousFrame._rotation;
+    }
+    
+    if (!mask[maskIndex++]) {
+        frame._scale = previousFrame._scale;
+    } else if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
+        readFloat(frameStream, frame._scale, SCALE_RADIX);
+    } else {
+        frameStream >> frame._scale;
+    }
+    
+    if (!mask[maskIndex++] || !readQuat(frameStream, frame._headRotation)) {
+        frame._headRotation = previousFrame._headRotation;
+    }
+    
+    if (!mask[maskIndex++]) {
+        frame._leanSideways = previousFrame._leanSideways;
+    } else if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
+        readFloat(frameStream, frame._leanSideways, LEAN_RADIX);
+    } else {
+        frameStream >> frame._leanSideways;
+    }
+    
+    if (!mask[maskIndex++]) {
+        frame._leanForward = previousFrame._leanForward;
+    } else if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
+        readFloat(frameStream, frame._leanForward, LEAN_RADIX);
+    } else {
+        frameStream >> frame._leanForward;
+    }
+    
+    if (!mask[maskIndex++] || !readVec3(frameStream, frame._lookAtPosition)) {
+        frame._lookAtPosition = previousFrame._lookAtPosition;
+    }
+}
+
 void writeRecordingToFile(RecordingPointer recording, const QString& filename) {
     if (!recording || recording->getFrameNumber() < 1) {
         qDebug() << "Can't save empty recording";
@@ -190,137 +429,79 @@ void writeRecordingToFile(RecordingPointer recording, const QString& filename) {
     }
     
     // RECORDING
+    // The frames are cut into chunks that each start with a keyframe, so any frame is decoded from the start of its
+    // chunk. The index of the chunks comes before them and the audio is stored raw after them, which lets the player
+    // map the file and only decode the frames it is about to play.
+    quint32 numFrames = recording->getFrameNumber();
+    RecordingFrame firstFrame = recording->getFrame(0);
+    quint32 numBlendshapes = firstFrame._blendshapeCoefficients.size();
+    quint32 numJoints = firstFrame._jointRotations.size();
+    fileStream << numBlendshapes;
+    fileStream << numJoints;
+    fileStream << (quint32)FRAMES_PER_CHUNK;
     fileStream << recording->_timestamps;
     
-    QBitArray mask;
-    quint32 numBlendshapes = 0;
-    quint32 numJoints = 0;
+    quint32 numChunks = (numFrames + FRAMES_PER_CHUNK - 1) / FRAMES_PER_CHUNK;
+    fileStream << numChunks;
+    const qint64 chunkIndexPos = file.pos();
+    for (quint32 i = 0; i < numChunks; ++i) {
+        // Save empty bytes for the offset, size, compression flag and CRC-16 of each chunk
+        fileStream << (quint64)0 << (quint32)0 << (quint8)0 << (quint16)0;
+    }
+    // Save empty bytes for the audio offset and size
+    fileStream << (quint64)0 << (quint64)0;
     
-    for (int i = 0; i < recording->_timestamps.size(); ++i) {
-        mask.fill(false);
-        int maskIndex = 0;
-        QByteArray buffer;
-        QDataStream stream(&buffer, QIODevice::WriteOnly);
-        RecordingFrame& previousFrame = recording->_frames[(i != 0) ? i - 1 : i];
-        RecordingFrame& frame = recording->_frames[i];
-        
-        // Blendshape Coefficients
-        if (i == 0) {
-            numBlendshapes = frame.getBlendshapeCoefficients().size();
-            stream << numBlendshapes;
-            mask.resize(mask.size() + numBlendshapes);
-        }
-        for (quint32 j = 0; j < numBlendshapes; ++j) {
-            if (i == 0 ||
-                frame._blendshapeCoefficients[j] != previousFrame._blendshapeCoefficients[j]) {
-                stream << frame.getBlendshapeCoefficients()[j];
-                mask.setBit(maskIndex);
-            }
-            ++maskIndex;
-        }
-        
-        // Joint Rotations
-        if (i == 0) {
-            numJoints = frame.getJointRotations().size();
-            stream << numJoints;
-            mask.resize(mask.size() + numJoints);
-        }
-        for (quint32 j = 0; j < numJoints; ++j) {
-            if (i == 0 ||
-                frame._jointRotations[j] != previousFrame._jointRotations[j]) {
-                writeQuat(stream, frame._jointRotations[j]);
-                mask.setBit(maskIndex);
-            }
-            maskIndex++;
-        }
-        
-        // Translation
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._translation != previousFrame._translation) {
-            writeVec3(stream, frame._translation);
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // Rotation
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._rotation != previousFrame._rotation) {
-            writeQuat(stream, frame._rotation);
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // Scale
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._scale != previousFrame._scale) {
-            stream << frame._scale;
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // Head Rotation
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._headRotation != previousFrame._headRotation) {
-            writeQuat(stream, frame._headRotation);
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // Lean Sideways
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._leanSideways != previousFrame._leanSideways) {
-            stream << frame._leanSideways;
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // Lean Forward
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._leanForward != previousFrame._leanForward) {
-            stream << frame._leanForward;
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        // LookAt Position
-        if (i == 0) {
-            mask.resize(mask.size() + 1);
-        }
-        if (i == 0 || frame._lookAtPosition != previousFrame._lookAtPosition) {
-            writeVec3(stream, frame._lookAtPosition);
-            mask.setBit(maskIndex);
-        }
-        maskIndex++;
-        
-        fileStream << mask;
-        fileStream << buffer;
+    // The checksum only covers the context and the index, each chunk has its own
+    quint32 dataLength = file.pos() - dataOffset;
+    
+    QVector<Recording::FrameChunk> chunks(numChunks);
+    for (quint32 i = 0; i < numChunks; ++i) {
+        QByteArray chunkData;
+        QDataStream chunkStream(&chunkData, QIODevice::WriteOnly);
+        int firstFrameInChunk = i * FRAMES_PER_CHUNK;
+        int endOfChunk = qMin(firstFrameInChunk + FRAMES_PER_CHUNK, (int)numFrames);
+        
+        RecordingFrame previousFrame;
+        for (int j = firstFrameInChunk; j < endOfChunk; ++j) {
+            RecordingFrame frame = recording->getFrame(j);
+            writeRecordingFrame(chunkStream, frame, (j == firstFrameInChunk) ? NULL : &previousFrame,
+                                numBlendshapes, numJoints);
+            previousFrame = frame;
+        }
+        
+        Recording::FrameChunk& chunk = chunks[i];
+        QByteArray compressedData = qCompress(chunkData);
+        chunk.isCompressed = compressedData.size() < chunkData.size();
+        if (chunk.isCompressed) {
+            chunkData = compressedData;
+        }
+        chunk.offset = file.pos();
+        chunk.size = chunkData.size();
+        chunk.crc16 = qChecksum(chunkData.constData(), chunkData.size());
+        file.write(chunkData);
     }
     
-    fileStream << recording->getAudioData();
+    quint64 audioOffset = file.pos();
+    file.write(recording->getAudioData());
+    const qint64 endPos = file.pos();
+    
+    // Fill in the index
+    file.seek(chunkIndexPos);
+    foreach (const Recording::FrameChunk& chunk, chunks) {
+        fileStream << chunk.offset << chunk.size << (quint8)chunk.isCompressed << chunk.crc16;
+    }
+    fileStream << audioOffset << (quint64)recording->getAudioData().size();
     
     qint64 writingTime = timer.restart();
     // Write data length and CRC-16
-    quint32 dataLength = file.pos() - dataOffset;
     file.seek(dataOffset); // Go to beginning of data for checksum
-    quint16 crc16 = qChecksum(file.readAll().constData(), dataLength);
+    quint16 crc16 = qChecksum(file.read(dataLength).constData(), dataLength);
     
     file.seek(dataLengthPos);
     fileStream << dataLength;
     file.seek(crc16Pos);
     fileStream << crc16;
-    file.seek(dataOffset + dataLength);
+    file.seek(endPos);
     
     bool wantDebug = true;
     if (wantDebug) {
@@ -360,6 +541,7 @@ void writeRecordingToFile(RecordingPointer recording, const QString& filename) {
 
 RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString& filename) {
     QByteArray byteArray;
+    QScopedPointer<QFile> file;
     QUrl url(filename);
     QElapsedTimer timer;
     timer.start(); // timer used for debug informations (download/parsing time)
@@ -386,15 +568,19 @@ RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString
         // print debug + restart timer
         qDebug() << "Downloaded " << byteArray.size() << " bytes in " << timer.restart() << " ms.";
     } else {
-        // If local file, just read it.
+        // If local file, map it. A chunked recording keeps the mapping and only pages in what it plays.
         qDebug() << "Reading recording from " << filename << ".";
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly)){
+        file.reset(new QFile(filename));
+        if (!file->open(QIODevice::ReadOnly)){
             qDebug() << "Could not open local file: " << url;
             return recording;
         }
-        byteArray = file.readAll();
-        file.close();
+        uchar* mappedData = file->map(0, file->size());
+        if (mappedData) {
+            byteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData), file->size());
+        } else {
+            byteArray = file->readAll();
+        }
     }
     
     if (filename.endsWith(".rec") || filename.endsWith(".REC")) {
@@ -422,7 +608,7 @@ RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString
     
     QPair<quint8, quint8> version;
     fileStream >> version; // File format version
-    if (version != VERSION && version != QPair<quint8, quint8>(0,1)) {
+    if (version != VERSION && version != VERSION_SEQUENTIAL && version != VERSION_SEQUENTIAL_FIXED_FLOATS) {
         qDebug() << "ERROR: This file format version is not supported.";
         return recording;
     }
@@ -468,7 +654,7 @@ RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString
     }
     
     // Scale
-    if (version == QPair<quint8, quint8>(0,1)) {
+    if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
         readFloat(fileStream, context.scale, SCALE_RADIX);
     } else {
         fileStream >> context.scale;
@@ -503,7 +689,7 @@ RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString
         }
         
         // Scale
-        if (version == QPair<quint8, quint8>(0,1)) {
+        if (version == VERSION_SEQUENTIAL_FIXED_FLOATS) {
             readFloat(fileStream, data.scale, SCALE_RADIX);
         } else {
             fileStream >> data.scale;
@@ -514,91 +700,60 @@ RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString
     quint32 numBlendshapes = 0;
     quint32 numJoints = 0;
     // RECORDING
-    fileStream >> recording->_timestamps;
-    
-    for (int i = 0; i < recording->_timestamps.size(); ++i) {
-        QBitArray mask;
-        QByteArray buffer;
-        QDataStream stream(&buffer, QIODevice::ReadOnly);
-        RecordingFrame frame;
-        RecordingFrame& previousFrame = (i == 0) ? frame : recording->_frames.last();
-        
-        fileStream >> mask;
-        fileStream >> buffer;
-        int maskIndex = 0;
-        
-        // Blendshape Coefficients
-        if (i == 0) {
-            stream >> numBlendshapes;
-        }
-        frame._blendshapeCoefficients.resize(numBlendshapes);
-        for (quint32 j = 0; j < numBlendshapes; ++j) {
-            if (!mask[maskIndex++]) {
-                frame._blendshapeCoefficients[j] = previousFrame._blendshapeCoefficients[j];
-            } else if (version == QPair<quint8, quint8>(0,1)) {
-                readFloat(stream, frame._blendshapeCoefficients[j], BLENDSHAPE_RADIX);
-            } else {
-                stream >> frame._blendshapeCoefficients[j];
-            }
-        }
-        // Joint Rotations
-        if (i == 0) {
-            stream >> numJoints;
-        }
-        frame._jointRotations.resize(numJoints);
-        for (quint32 j = 0; j < numJoints; ++j) {
-            if (!mask[maskIndex++] || !readQuat(stream, frame._jointRotations[j])) {
-                frame._jointRotations[j] = previousFrame._jointRotations[j];
-            }
-        }
-        
-        if (!mask[maskIndex++] || !readVec3(stream, frame._translation)) {
-            frame._translation = previousFrame._translation;
-        }
-        
-        if (!mask[maskIndex++] || !readQuat(stream, frame._rotation)) {
-            frame._rotation = previousFrame._rotation;
-        }
-        
-        if (!mask[maskIndex++]) {
-            frame._scale = previousFrame._scale;
-        } else if (version == QPair<quint8, quint8>(0,1)) {
-            readFloat(stream, frame._scale, SCALE_RADIX);
-        } else {
-            stream >> frame._scale;
-        }
-        
-        if (!mask[maskIndex++] || !readQuat(stream, frame._headRotation)) {
-            frame._headRotation = previousFrame._headRotation;
-        }
-        
-        if (!mask[maskIndex++]) {
-            frame._leanSideways = previousFrame._leanSideways;
-        } else if (version == QPair<quint8, quint8>(0,1)) {
-            readFloat(stream, frame._leanSideways, LEAN_RADIX);
-        } else {
-            stream >> frame._leanSideways;
+    if (version == VERSION) {
+        // only the index is read now, the frames are decoded as they are played
+        quint32 framesPerChunk = 0;
+        quint32 numChunks = 0;
+        fileStream >> numBlendshapes;
+        fileStream >> numJoints;
+        fileStream >> framesPerChunk;
+        fileStream >> recording->_timestamps;
+        fileStream >> numChunks;
+        
+        bool isIndexValid = framesPerChunk > 0
+            && numChunks == (recording->_timestamps.size() + framesPerChunk - 1) / framesPerChunk;
+        recording->_frameChunks.resize(isIndexValid ? numChunks : 0);
+        for (int i = 0; i < recording->_frameChunks.size(); ++i) {
+            Recording::FrameChunk& chunk = recording->_frameChunks[i];
+            quint8 isCompressed = 0;
+            fileStream >> chunk.offset >> chunk.size >> isCompressed >> chunk.crc16;
+            chunk.isCompressed = isCompressed;
+            isIndexValid = isIndexValid && chunk.offset + chunk.size <= (quint64)byteArray.size();
+        }
+        
+        quint64 audioOffset = 0;
+        quint64 audioSize = 0;
+        fileStream >> audioOffset >> audioSize;
+        isIndexValid = isIndexValid && audioOffset + audioSize <= (quint64)byteArray.size();
+        
+        if (!isIndexValid || fileStream.status() != QDataStream::Ok) {
+            qDebug() << "Couldn't read file correctly. (Invalid chunk index)";
+            recording->clear();
+            recording.clear();
+            return recording;
         }
         
-        if (!mask[maskIndex++]) {
-            frame._leanForward = previousFrame._leanForward;
-        } else if (version == QPair<quint8, quint8>(0,1)) {
-            readFloat(stream, frame._leanForward, LEAN_RADIX);
-        } else {
-            stream >> frame._leanForward;
-        }
+        recording->_framesPerChunk = framesPerChunk;
+        recording->_numBlendshapes = numBlendshapes;
+        recording->_numJoints = numJoints;
+        recording->_fileData = byteArray;
+        recording->_mappedFile.reset(file.take());
+        recording->_audioData = QByteArray::fromRawData(recording->_fileData.constData() + audioOffset, audioSize);
+    } else {
+        fileStream >> recording->_timestamps;
         
-        if (!mask[maskIndex++] || !readVec3(stream, frame._lookAtPosition)) {
-            frame._lookAtPosition = previousFrame._lookAtPosition;
+        for (int i = 0; i < recording->_timestamps.size(); ++i) {
+            RecordingFrame frame;
+            const RecordingFrame& previousFrame = (i == 0) ? frame : recording->_frames.last();
+            readRecordingFrame(fileStream, frame, previousFrame, version, numBlendshapes, numJoints, i == 0);
+            recording->_frames << frame;
         }
         
-        recording->_frames << frame;
+        QByteArray audioArray;
+        fileStream >> audioArray;
+        recording->addAudioPacket(audioArray);
     }
     
-    QByteArray audioArray;
-    fileStream >> audioArray;
-    recording->addAudioPacket(audioArray);
-    
     bool wantDebug = true;
     if (wantDebug) {
         qDebug() << "[DEBUG] READ recording";
@@ -12,6 +12,10 @@
 #ifndef hifi_Recording_h
 #define hifi_Recording_h
 
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QScopedPointer>
 #include <QString>
 #include <QVector>
 
@@ -22,6 +26,8 @@ template<class C>
 class QSharedPointer;
 
 class AttachmentData;
+class QDataStream;
+class QFile;
 class Recording;
 class RecordingFrame;
 class Sound;
@@ -46,15 +52,21 @@ public:
 };
 
 /// Stores a recording
+///
+/// A recording read from a file in the chunked format keeps only its timestamps in memory. The file is mapped, the
+/// frames are decoded a chunk at a time as they are asked for and the audio points straight into the mapping.
 class Recording {
 public:
+    Recording();
+    ~Recording();
+    
     bool isEmpty() const { return _timestamps.isEmpty(); }
     int getLength() const; // in ms
     
     RecordingContext& getContext() { return _context; }
-    int getFrameNumber() const { return _frames.size(); }
+    int getFrameNumber() const { return _timestamps.size(); }
     qint32 getFrameTimestamp(int i) const;
-    const RecordingFrame& getFrame(int i) const;
+    RecordingFrame getFrame(int i) const;
     const QByteArray& getAudioData() const { return _audioData; }
     
 protected:
@@ -63,12 +75,36 @@ protected:
     void clear();
     
 private:
+    /// where a chunk of frames is in _fileData, each chunk starts with a keyframe
+    struct FrameChunk {
+        quint64 offset;
+        quint32 size;
+        bool isCompressed;
+        quint16 crc16;
+    };
+    
+    struct DecodedChunk {
+        int index;
+        QVector<RecordingFrame> frames;
+    };
+    
+    /// decodes the chunk unless it is one of the last few decoded, returns no frames if it is corrupt
+    const QVector<RecordingFrame>& getChunkFrames(int chunkIndex) const;
+    
     RecordingContext _context;
     QVector<qint32> _timestamps;
-    QVector<RecordingFrame> _frames;
+    QVector<RecordingFrame> _frames; // empty if the frames are decoded from _frameChunks
     
     QByteArray _audioData;
     
+    QScopedPointer<QFile> _mappedFile;
+    QByteArray _fileData; // the whole file, usually backed by _mappedFile
+    QVector<FrameChunk> _frameChunks;
+    int _framesPerChunk;
+    quint32 _numBlendshapes;
+    quint32 _numJoints;
+    mutable QList<DecodedChunk> _decodedChunks; // most recently used first
+    
     friend class Recorder;
     friend class Player;
     friend void writeRecordingToFile(RecordingPointer recording, const QString& file);
@@ -80,6 +116,8 @@ private:
 /// Stores the different values associated to one recording frame
 class RecordingFrame {
 public:
+    RecordingFrame() : _scale(1.0f), _leanSideways(0.0f), _leanForward(0.0f) { }
+    
     QVector<float> getBlendshapeCoefficients() const { return _blendshapeCoefficients; }
     QVector<glm::quat> getJointRotations() const { return _jointRotations; }
     glm::vec3 getTranslation() const { return _translation; }
@@ -117,6 +155,11 @@ private:
     friend RecordingPointer readRecordingFromFile(RecordingPointer recording, const QString& file);
     friend RecordingPointer readRecordingFromRecFile(RecordingPointer recording, const QString& filename,
                                                      const QByteArray& byteArray);
+    friend void writeRecordingFrame(QDataStream& stream, const RecordingFrame& frame,
+                                    const RecordingFrame* previousFrame, quint32 numBlendshapes, quint32 numJoints);
+    friend void readRecordingFrame(QDataStream& stream, RecordingFrame& frame, const RecordingFrame& previousFrame,
+                                   QPair<quint8, quint8> version, quint32& numBlendshapes, quint32& numJoints,
+                                   bool readCounts);
 };
 
 void writeRecordingToFile(RecordingPointer recording, const QString& filename);
@@ -14,6 +14,13 @@
 #include "AvatarData.h"
 #include "Referential.h"
 
+// set in the type byte of a referential packed with its data
+const unsigned char WHOLE_REFERENTIAL_FLAG = 0x80;
+
+bool Referential::isWholeReferential(const unsigned char* sourceBuffer) {
+    return *sourceBuffer & WHOLE_REFERENTIAL_FLAG;
+}
+
 Referential::Referential(Type type, AvatarData* avatar) :
     _type(type),
     _version(0),
@@ -43,7 +50,12 @@ Referential::Referential(const unsigned char*& sourceBuffer, AvatarData* avatar)
 Referential::~Referential() {
 }
 
-int Referential::packReferential(unsigned char* destinationBuffer) const {
+int Referential::packReferential(unsigned char* destinationBuffer, bool whole) const {
+    if (!whole) {
+        *destinationBuffer++ = (unsigned char)_type;
+        memcpy(destinationBuffer, &_version, sizeof(_version));
+        return TYPE_AND_VERSION_SIZE;
+    }
     const unsigned char* startPosition = destinationBuffer;
     destinationBuffer += pack(destinationBuffer);
     
@@ -70,7 +82,7 @@ int Referential::unpackReferential(const unsigned char* sourceBuffer) {
 
 int Referential::pack(unsigned char* destinationBuffer) const {
     unsigned char* startPosition = destinationBuffer;
-    *destinationBuffer++ = (unsigned char)_type;
+    *destinationBuffer++ = (unsigned char)_type | WHOLE_REFERENTIAL_FLAG;
     memcpy(destinationBuffer, &_version, sizeof(_version));
     destinationBuffer += sizeof(_version);
     
@@ -82,7 +94,7 @@ int Referential::pack(unsigned char* destinationBuffer) const {
 
 int Referential::unpack(const unsigned char* sourceBuffer) {
     const unsigned char* startPosition = sourceBuffer;
-    _type = (Type)*sourceBuffer++;
+    _type = (Type)(*sourceBuffer++ & ~WHOLE_REFERENTIAL_FLAG);
     if (_type < 0 || _type >= NUM_TYPES) {
         _type = UNKNOWN;
     }
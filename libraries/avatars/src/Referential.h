@@ -29,6 +29,12 @@ public:
         NUM_TYPES
     };
     
+    /// what a referential takes when it's packed without its data, just its type and version
+    static const int TYPE_AND_VERSION_SIZE = 2;
+    
+    /// Whether the referential packed here has its data, or only its type and version.
+    static bool isWholeReferential(const unsigned char* sourceBuffer);
+    
     Referential(const unsigned char*& sourceBuffer, AvatarData* avatar);
     virtual ~Referential();
     
@@ -43,7 +49,8 @@ public:
     QByteArray getExtraData() const { return _extraDataBuffer; }
     
     virtual void update() {}
-    int packReferential(unsigned char* destinationBuffer) const;
+    /// \param whole false to pack only the type and version, for receivers that have the rest from before
+    int packReferential(unsigned char* destinationBuffer, bool whole = true) const;
     int unpackReferential(const unsigned char* sourceBuffer);
     
 protected:
@@ -13,6 +13,8 @@
 #include <QBuffer>
 #include <QCryptographicHash>
 #include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
 
 #include "HTTPConnection.h"
 #include "HTTPManager.h"
@@ -25,20 +27,33 @@ const char* HTTPConnection::StatusCode401 = "401 Unauthorized";
 const char* HTTPConnection::StatusCode404 = "404 Not Found";
 const char* HTTPConnection::DefaultContentType = "text/plain; charset=ISO-8859-1";
 
+// a kept-alive connection that sends nothing for this long is closed, so idle scrapers don't pile up
+const int KEEP_ALIVE_IDLE_TIMEOUT_MSECS = 15 * 1000;
+
 HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager) :
     QObject(parentManager),
     _parentManager(parentManager),
     _socket(socket),
     _stream(socket),
-    _address(socket->peerAddress())
+    _address(socket->peerAddress()),
+    _requestIsHTTP11(false),
+    _keepAlive(false),
+    _awaitingResponse(false),
+    _responseFinished(false),
+    _chunked(false),
+    _socketClosed(false),
+    _idleTimer(new QTimer(this))
 {
     // take over ownership of the socket
     _socket->setParent(this);
 
+    _idleTimer->setSingleShot(true);
+    connect(_idleTimer, SIGNAL(timeout()), SLOT(closeIdleConnection()));
+
     // connect initial slots
     connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
-    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(deleteLater()));
-    connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(socketClosed()));
+    connect(socket, SIGNAL(disconnected()), SLOT(socketClosed()));
 }
 
 HTTPConnection::~HTTPConnection() {
@@ -106,44 +121,168 @@ QList<FormData> HTTPConnection::parseFormData() const {
 }
 
 void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
-    _socket->write("HTTP/1.1 ");
-    _socket->write(code);
-    _socket->write("\r\n");
+    QByteArray response = responseHeader(code, headers);
 
+    // a kept-alive client finds the end of each response by its length, even an empty one
     int csize = content.size();
+    response.append("Content-Length: ");
+    response.append(QByteArray::number(csize));
+    response.append("\r\n");
 
-    for (Headers::const_iterator it = headers.constBegin(), end = headers.constEnd();
-            it != end; it++) {
-        _socket->write(it.key());
-        _socket->write(": ");
-        _socket->write(it.value());
-        _socket->write("\r\n");
-    }
     if (csize > 0) {
-        _socket->write("Content-Length: ");
-        _socket->write(QByteArray::number(csize));
-        _socket->write("\r\n");
+        response.append("Content-Type: ");
+        response.append(contentType);
+        response.append("\r\n");
+    }
+    response.append(_keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
 
-        _socket->write("Content-Type: ");
-        _socket->write(contentType);
-        _socket->write("\r\n");
+    if (csize > 0 && _requestOperation != QNetworkAccessManager::HeadOperation) {
+        response.append(content);
     }
-    _socket->write("Connection: close\r\n\r\n");
+    writeResponse(response, true);
+}
 
-    if (csize > 0) {
-        _socket->write(content);
+void HTTPConnection::beginChunkedResponse(const char* code, const char* contentType, const Headers& headers) {
+    QByteArray response = responseHeader(code, headers);
+    response.append("Content-Type: ");
+    response.append(contentType);
+    response.append("\r\n");
+
+    // without chunks, the only way an HTTP/1.0 client can find the end of the content is the connection closing
+    if (_requestIsHTTP11) {
+        response.append("Transfer-Encoding: chunked\r\n");
+    } else {
+        _keepAlive = false;
     }
+    response.append(_keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
 
-    // make sure we receive no further read notifications
-    _socket->disconnect(SIGNAL(readyRead()), this);
+    _chunked = true;
+    writeResponse(response, false);
+}
 
+void HTTPConnection::writeChunk(const QByteArray& content) {
+    if (!_chunked || content.isEmpty() || _requestOperation == QNetworkAccessManager::HeadOperation) {
+        return;
+    }
+    if (!_requestIsHTTP11) {
+        writeResponse(content, false);
+        return;
+    }
+    QByteArray chunk = QByteArray::number(content.size(), 16);
+    chunk.append("\r\n");
+    chunk.append(content);
+    chunk.append("\r\n");
+    writeResponse(chunk, false);
+}
+
+void HTTPConnection::endChunkedResponse() {
+    if (!_chunked) {
+        return;
+    }
+    _chunked = false;
+    bool writesLastChunk = _requestIsHTTP11 && _requestOperation != QNetworkAccessManager::HeadOperation;
+    writeResponse(writesLastChunk ? QByteArray("0\r\n\r\n") : QByteArray(), true);
+}
+
+void HTTPConnection::finishRequest() {
+    _awaitingResponse = false;
+    if (_chunked) {
+        endChunkedResponse();
+
+    } else if (!_responseFinished) {
+        // the handler didn't answer, and the client has no way of knowing, so don't leave it waiting
+        _keepAlive = false;
+        _responseFinished = true;
+    }
+    completeResponse();
+}
+
+void HTTPConnection::writeResponse(const QByteArray& data, bool finished) {
+    if (QThread::currentThread() != thread()) {
+        // the handler answers on its own thread, and only ours may touch the socket
+        QMetaObject::invokeMethod(this, "writeResponse", Qt::QueuedConnection,
+            Q_ARG(QByteArray, data), Q_ARG(bool, finished));
+        return;
+    }
+    if (!data.isEmpty() && !_socketClosed) {
+        _socket->write(data);
+    }
+    if (finished) {
+        _responseFinished = true;
+
+        // the responses to bad requests don't go through the manager, so nothing else will move us on
+        if (!_awaitingResponse) {
+            completeResponse();
+        }
+    }
+}
+
+void HTTPConnection::socketClosed() {
+    _socketClosed = true;
+    if (!_awaitingResponse) {
+        deleteLater();
+    }
+}
+
+void HTTPConnection::closeIdleConnection() {
+    _socket->disconnect(SIGNAL(readyRead()), this);
     _socket->disconnectFromHost();
 }
 
+void HTTPConnection::queueRequest() {
+    _awaitingResponse = true;
+    _responseFinished = false;
+    _parentManager->queueRequest(this);
+}
+
+void HTTPConnection::completeResponse() {
+    if (_socketClosed) {
+        deleteLater();
+        return;
+    }
+
+    // make sure we receive no further read notifications until we're ready for them
+    _socket->disconnect(SIGNAL(readyRead()), this);
+
+    if (!_keepAlive) {
+        _socket->disconnectFromHost();
+        return;
+    }
+    _requestHeaders.clear();
+    _lastRequestHeader.clear();
+    _requestContent.clear();
+
+    _idleTimer->start(KEEP_ALIVE_IDLE_TIMEOUT_MSECS);
+    connect(_socket, SIGNAL(readyRead()), SLOT(readRequest()));
+
+    // a pipelining client may have sent its next request already
+    readRequest();
+}
+
+QByteArray HTTPConnection::responseHeader(const char* code, const Headers& headers) const {
+    QByteArray header("HTTP/1.1 ");
+    header.append(code);
+    header.append("\r\n");
+
+    for (Headers::const_iterator it = headers.constBegin(), end = headers.constEnd();
+            it != end; it++) {
+        header.append(it.key());
+        header.append(": ");
+        header.append(it.value());
+        header.append("\r\n");
+    }
+    return header;
+}
+
 void HTTPConnection::readRequest() {
     if (!_socket->canReadLine()) {
         return;
     }
+    _idleTimer->stop();
+
+    // until the request line and headers say otherwise, the connection closes after the response
+    _keepAlive = false;
+
     // parse out the method and resource
     QByteArray line = _socket->readLine().trimmed();
     if (line.startsWith("HEAD")) {
@@ -169,6 +308,9 @@ void HTTPConnection::readRequest() {
     int idx = line.indexOf(' ') + 1;
     _requestUrl.setUrl(line.mid(idx, line.lastIndexOf(' ') - idx));
 
+    // HTTP/1.1 connections persist by default, and HTTP/1.0 ones only if the headers ask
+    _requestIsHTTP11 = line.endsWith("HTTP/1.1");
+
     // switch to reading the header
     _socket->disconnect(this, SLOT(readRequest()));
     connect(_socket, SIGNAL(readyRead()), SLOT(readHeaders()));
@@ -184,9 +326,13 @@ void HTTPConnection::readHeaders() {
         if (trimmed.isEmpty()) {
             _socket->disconnect(this, SLOT(readHeaders()));
 
+            QByteArray connectionHeader = _requestHeaders.value("Connection").toLower();
+            _keepAlive = _requestIsHTTP11 ? !connectionHeader.contains("close")
+                                          : connectionHeader.contains("keep-alive");
+
             QByteArray clength = _requestHeaders.value("Content-Length");
             if (clength.isEmpty()) {
-                _parentManager->handleHTTPRequest(this, _requestUrl);
+                queueRequest();
 
             } else {
                 _requestContent.resize(clength.toInt());
@@ -225,5 +371,5 @@ void HTTPConnection::readContent() {
     _socket->read(_requestContent.data(), size);
     _socket->disconnect(this, SLOT(readContent()));
 
-    _parentManager->handleHTTPRequest(this, _requestUrl.path());
+    queueRequest();
 }
@@ -27,6 +27,7 @@
 #include <QUrl>
 
 class QTcpSocket;
+class QTimer;
 class HTTPManager;
 class MaskFilter;
 class ServerApp;
@@ -37,7 +38,9 @@ typedef QHash<QByteArray, QByteArray> Headers;
 /// A form data element
 typedef QPair<Headers, QByteArray> FormData;
 
-/// Handles a single HTTP connection.
+/// Handles a single HTTP connection.  The connection reads its requests and writes its responses on the thread it lives
+/// on, which is its manager's I/O thread, while the manager's handler answers them on its own.  A client that keeps the
+/// connection alive can send its next request, or pipeline several, without reconnecting.
 class HTTPConnection : public QObject {
    Q_OBJECT
 
@@ -62,6 +65,9 @@ public:
     /// Returns a pointer to the underlying socket, to which WebSocket message bodies should be written.
     QTcpSocket* socket () const { return _socket; }
 
+    /// Returns a pointer to the manager that accepted the connection.
+    HTTPManager* parentManager () const { return _parentManager; }
+
     /// Returns the request operation.
     QNetworkAccessManager::Operation requestOperation () const { return _requestOperation; }
 
@@ -77,11 +83,26 @@ public:
     /// Parses the request content as form data, returning a list of header/content pairs.
     QList<FormData> parseFormData () const;
 
-    /// Sends a response and closes the connection.
+    /// Sends a response, then reads the next request if the client asked to keep the connection alive, or closes it.
+    /// May be called from the handler's thread.
     void respond (const char* code, const QByteArray& content = QByteArray(),
         const char* contentType = DefaultContentType,
         const Headers& headers = Headers());
 
+    /// Starts a response whose content is streamed with writeChunk, chunked for HTTP/1.1 clients.  The handler must
+    /// call endChunkedResponse before it returns.  May be called from the handler's thread.
+    void beginChunkedResponse (const char* code, const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
+    /// Writes the next part of a chunked response.
+    void writeChunk (const QByteArray& content);
+
+    /// Ends a chunked response.
+    void endChunkedResponse ();
+
+    /// Called by the manager once the handler is done with the request, on the connection's thread.
+    Q_INVOKABLE void finishRequest ();
+
 protected slots:
 
     /// Reads the request line.
@@ -93,8 +114,26 @@ protected slots:
     /// Reads the content.
     void readContent ();
 
+    /// Writes part or all of a response, on the connection's thread.
+    void writeResponse (const QByteArray& data, bool finished);
+
+    /// Deletes the connection once the socket has closed, unless the handler has yet to answer.
+    void socketClosed ();
+
+    /// Closes a kept-alive connection that has sent nothing for a while.
+    void closeIdleConnection ();
+
 protected:
 
+    /// Hands a complete request to the manager.
+    void queueRequest ();
+
+    /// Moves on to the next request once a response has been written, or closes the connection.
+    void completeResponse ();
+
+    /// Writes the status line and headers of a response.
+    QByteArray responseHeader (const char* code, const Headers& headers) const;
+
     /// The parent HTTP manager
     HTTPManager* _parentManager;
 
@@ -121,6 +160,27 @@ protected:
 
     /// The content of the request.
     QByteArray _requestContent;
+
+    /// Whether the request came from an HTTP/1.1 client.
+    bool _requestIsHTTP11;
+
+    /// Whether the connection stays open for another request once this one is answered.
+    bool _keepAlive;
+
+    /// Whether the request is with the manager's handler.
+    bool _awaitingResponse;
+
+    /// Whether the whole of the response has been written.
+    bool _responseFinished;
+
+    /// Whether a chunked response has been started and not yet ended.
+    bool _chunked;
+
+    /// Whether the socket has closed.
+    bool _socketClosed;
+
+    /// Closes the connection when a kept-alive client sends nothing more.
+    QTimer* _idleTimer;
 };
 
 #endif // hifi_HTTPConnection_h
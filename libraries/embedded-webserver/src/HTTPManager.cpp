@@ -9,10 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeDatabase>
+#include <QtCore/QThread>
 #include <QtNetwork/QTcpSocket>
 
 #include "HTTPConnection.h"
@@ -21,8 +23,11 @@
 HTTPManager::HTTPManager(quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler, QObject* parent) :
     QTcpServer(parent),
     _documentRoot(documentRoot),
-    _requestHandler(requestHandler)
+    _requestHandler(requestHandler),
+    _ioThread(new QThread(this))
 {
+    _ioThread->start();
+    
     // start listening on the passed port
     if (!listen(QHostAddress("0.0.0.0"), port)) {
         qDebug() << "Failed to open HTTP server socket:" << errorString();
@@ -30,16 +35,78 @@ HTTPManager::HTTPManager(quint16 port, const QString& documentRoot, HTTPRequestH
     }
 }
 
+HTTPManager::~HTTPManager() {
+    // the connections still open are deleted as the I/O thread finishes
+    _ioThread->quit();
+    _ioThread->wait();
+}
+
 void HTTPManager::incomingConnection(qintptr socketDescriptor) {
     QTcpSocket* socket = new QTcpSocket(this);
     
     if (socket->setSocketDescriptor(socketDescriptor)) {
-        new HTTPConnection(socket, this);
+        startConnection(new HTTPConnection(socket, this));
     } else {
         delete socket;
     }
 }
 
+void HTTPManager::startConnection(HTTPConnection* connection) {
+    // an object with a parent can't change threads, so the connection cleans up after itself, or with the thread
+    connection->setParent(NULL);
+    connection->moveToThread(_ioThread);
+    connect(_ioThread, &QThread::finished, connection, &QObject::deleteLater);
+}
+
+void HTTPManager::queueRequest(HTTPConnection* connection) {
+    if (respondWithSnapshot(connection)) {
+        connection->finishRequest();
+        
+    } else if (connection->thread() == thread()) {
+        handleHTTPRequest(connection, connection->requestUrl());
+        connection->finishRequest();
+        
+    } else {
+        // the connection waits on the I/O thread, and responds from there, while the handler has it
+        QMetaObject::invokeMethod(this, "handleQueuedRequest", Qt::QueuedConnection,
+            Q_ARG(HTTPConnection*, connection));
+    }
+}
+
+void HTTPManager::handleQueuedRequest(HTTPConnection* connection) {
+    handleHTTPRequest(connection, connection->requestUrl());
+    QMetaObject::invokeMethod(connection, "finishRequest", Qt::QueuedConnection);
+}
+
+void HTTPManager::publishSnapshot(const QString& path, const QByteArray& content, const char* contentType,
+                                  int lifetimeMsecs) {
+    Snapshot snapshot = { content, contentType, QDateTime::currentMSecsSinceEpoch() + lifetimeMsecs };
+    QMutexLocker locker(&_snapshotMutex);
+    _snapshots.insert(path, snapshot);
+}
+
+bool HTTPManager::respondWithSnapshot(HTTPConnection* connection) {
+    if (connection->requestOperation() != QNetworkAccessManager::GetOperation &&
+            connection->requestOperation() != QNetworkAccessManager::HeadOperation) {
+        return false;
+    }
+    Snapshot snapshot;
+    {
+        QMutexLocker locker(&_snapshotMutex);
+        QHash<QString, Snapshot>::iterator it = _snapshots.find(connection->requestUrl().path());
+        if (it == _snapshots.end()) {
+            return false;
+        }
+        if (it.value().expiry < QDateTime::currentMSecsSinceEpoch()) {
+            _snapshots.erase(it);
+            return false;
+        }
+        snapshot = it.value();
+    }
+    connection->respond(HTTPConnection::StatusCode200, snapshot.content, snapshot.contentType.constData());
+    return true;
+}
+
 bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
     if (!skipSubHandler && requestHandledByRequestHandler(connection, url)) {
         // this request was handled by our request handler object
@@ -16,8 +16,11 @@
 #ifndef hifi_HTTPManager_h
 #define hifi_HTTPManager_h
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtNetwork/QTcpServer>
 
+class QThread;
 class HTTPConnection;
 class HTTPSConnection;
 
@@ -27,22 +30,53 @@ public:
     virtual bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) = 0;
 };
 
-/// Handles HTTP connections
+/// Handles HTTP connections.  The connections read and write on an I/O thread of the manager's own, so that a slow
+/// client or a big response costs that thread rather than the owner's, and only complete requests are handed to the
+/// handler, on the thread the manager lives on.  GETs of a path with a published snapshot are answered on the I/O
+/// thread without reaching the handler at all.
 class HTTPManager : public QTcpServer, public HTTPRequestHandler {
    Q_OBJECT
 public:
     /// Initializes the manager.
     HTTPManager(quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler = NULL, QObject* parent = 0);
+    virtual ~HTTPManager();
     
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false);
     
+    /// Serves the content at the path until the lifetime has passed, without asking the handler.  May be called from
+    /// any thread; a handler can publish what it has just rendered so that the next scrapes are answered from it.
+    void publishSnapshot(const QString& path, const QByteArray& content, const char* contentType, int lifetimeMsecs);
+    
+    /// Hands a complete request to the handler, or answers it from a snapshot.  Called on the connection's thread.
+    void queueRequest(HTTPConnection* connection);
+    
 protected:
     /// Accepts all pending connections
     virtual void incomingConnection(qintptr socketDescriptor);
     virtual bool requestHandledByRequestHandler(HTTPConnection* connection, const QUrl& url);
+    
+    /// Moves a newly accepted connection to the I/O thread.
+    void startConnection(HTTPConnection* connection);
+    
+protected slots:
+    void handleQueuedRequest(HTTPConnection* connection);
+    
 protected:
+    class Snapshot {
+    public:
+        QByteArray content;
+        QByteArray contentType;
+        qint64 expiry; ///< msecs since the epoch
+    };
+    
+    bool respondWithSnapshot(HTTPConnection* connection);
+    
     QString _documentRoot;
     HTTPRequestHandler* _requestHandler;
+    QThread* _ioThread;
+    
+    QMutex _snapshotMutex;
+    QHash<QString, Snapshot> _snapshots;
 };
 
 #endif // hifi_HTTPManager_h
@@ -32,7 +32,7 @@ void HTTPSManager::incomingConnection(qintptr socketDescriptor) {
     sslSocket->setPrivateKey(_privateKey);
     
     if (sslSocket->setSocketDescriptor(socketDescriptor)) {
-        new HTTPSConnection(sslSocket, this);
+        startConnection(new HTTPSConnection(sslSocket, this));
     } else {
         delete sslSocket;
     }
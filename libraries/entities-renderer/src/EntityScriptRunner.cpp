@@ -0,0 +1,287 @@
+//
+//  EntityScriptRunner.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QMutexLocker>
+#include <QScriptSyntaxCheckResult>
+#include <QUrl>
+#include <QtDebug>
+
+#include <ScriptEngine.h>
+#include <ScriptSourceCache.h>
+#include <SharedUtil.h>
+
+#include "EntityScriptRunner.h"
+
+// the calls run for at most about a frame before the script thread gets back to its timers and other events
+const quint64 MAX_CALL_SLICE_USECS = USECS_PER_SECOND / 60;
+
+// these report only where the mouse is now, so a call still waiting to run can take the newer event instead
+static bool isLatestOnly(const QString& methodName) {
+    return methodName == "mouseMoveEvent" || methodName == "mouseMoveOnEntity" ||
+        methodName == "hoverOverEntity" || methodName == "holdingClickOnEntity";
+}
+
+EntityScriptRunner::EntityScriptRunner(ScriptEngine* entitiesScriptEngine, ScriptEngine* sandboxScriptEngine) :
+    _entitiesScriptEngine(entitiesScriptEngine),
+    _sandboxScriptEngine(sandboxScriptEngine),
+    _processCallsQueued(false) {
+}
+
+EntityScriptRunner::~EntityScriptRunner() {
+    delete _sandboxScriptEngine;
+}
+
+void EntityScriptRunner::callMethod(const EntityItemID& entityID, const QString& entityScript,
+        const QString& methodName) {
+    if (entityScript.isEmpty()) {
+        return;
+    }
+    Call call;
+    call.type = Call::METHOD;
+    call.entityID = entityID;
+    call.entityScript = entityScript;
+    call.methodName = methodName;
+    queueCall(call);
+}
+
+void EntityScriptRunner::callMethod(const EntityItemID& entityID, const QString& entityScript,
+        const QString& methodName, const MouseEvent& event) {
+    if (entityScript.isEmpty()) {
+        return;
+    }
+    Call call;
+    call.type = Call::MOUSE_METHOD;
+    call.entityID = entityID;
+    call.entityScript = entityScript;
+    call.methodName = methodName;
+    call.mouseEvent = event;
+    queueCall(call);
+}
+
+void EntityScriptRunner::callCollisionWithEntity(const EntityItemID& entityID, const QString& entityScript,
+        const EntityItemID& otherID, const Collision& collision) {
+    if (entityScript.isEmpty()) {
+        return;
+    }
+    Call call;
+    call.type = Call::COLLISION;
+    call.entityID = entityID;
+    call.entityScript = entityScript;
+    call.methodName = "collisionWithEntity";
+    call.otherID = otherID;
+    call.collision = collision;
+    queueCall(call);
+}
+
+void EntityScriptRunner::unloadEntityScript(const EntityItemID& entityID) {
+    Call call;
+    call.type = Call::UNLOAD;
+    call.entityID = entityID;
+    queueCall(call);
+}
+
+void EntityScriptRunner::unloadAllEntityScripts() {
+    Call call;
+    call.type = Call::UNLOAD_ALL;
+    queueCall(call);
+}
+
+void EntityScriptRunner::changeEntityID(const EntityItemID& oldEntityID, const EntityItemID& newEntityID) {
+    Call call;
+    call.type = Call::CHANGE_ID;
+    call.entityID = oldEntityID;
+    call.otherID = newEntityID;
+    queueCall(call);
+}
+
+void EntityScriptRunner::queueCall(const Call& call) {
+    QMutexLocker locker(&_callsMutex);
+    if (call.type == Call::MOUSE_METHOD && isLatestOnly(call.methodName)) {
+        for (QList<Call>::iterator pending = _calls.begin(); pending != _calls.end(); pending++) {
+            if (pending->type == Call::MOUSE_METHOD && pending->entityID == call.entityID &&
+                    pending->methodName == call.methodName && pending->entityScript == call.entityScript) {
+                pending->mouseEvent = call.mouseEvent;
+                return;
+            }
+        }
+    }
+    _calls.append(call);
+
+    // wake the script thread unless it's already due to run the queue
+    if (!_processCallsQueued) {
+        _processCallsQueued = true;
+        QMetaObject::invokeMethod(this, "processCalls", Qt::QueuedConnection);
+    }
+}
+
+void EntityScriptRunner::processCalls() {
+    quint64 start = usecTimestampNow();
+    forever {
+        Call call;
+        {
+            QMutexLocker locker(&_callsMutex);
+            if (_calls.isEmpty()) {
+                _processCallsQueued = false;
+                return;
+            }
+            if (usecTimestampNow() - start > MAX_CALL_SLICE_USECS) {
+                QMetaObject::invokeMethod(this, "processCalls", Qt::QueuedConnection);
+                return;
+            }
+            call = _calls.takeFirst();
+        }
+        runCall(call);
+    }
+}
+
+void EntityScriptRunner::runCall(const Call& call) {
+    switch (call.type) {
+        case Call::UNLOAD:
+            unload(call.entityID);
+            _entityScripts.remove(call.entityID);
+            return;
+
+        case Call::UNLOAD_ALL:
+            foreach (const EntityItemID& entityID, _entityScripts.keys()) {
+                unload(entityID);
+            }
+            _entityScripts.clear();
+            return;
+
+        case Call::CHANGE_ID:
+            if (_entityScripts.contains(call.entityID)) {
+                _entityScripts[call.otherID] = _entityScripts.take(call.entityID);
+            }
+            return;
+
+        default:
+            break;
+    }
+    QScriptValue entityScript = loadEntityScript(call.entityID, call.entityScript);
+    QScriptValue method = entityScript.property(call.methodName);
+    if (!method.isValid()) {
+        return;
+    }
+    ScriptCallbackTimer timer(_entitiesScriptEngine->getProfile(),
+        _entityScripts.value(call.entityID).profileName + "." + call.methodName);
+    QScriptValueList args;
+    args << call.entityID.toScriptValue(_entitiesScriptEngine);
+    if (call.type == Call::MOUSE_METHOD) {
+        args << call.mouseEvent.toScriptValue(_entitiesScriptEngine);
+
+    } else if (call.type == Call::COLLISION) {
+        args << call.otherID.toScriptValue(_entitiesScriptEngine);
+        args << collisionToScriptValue(_entitiesScriptEngine, call.collision);
+    }
+    method.call(entityScript, args);
+}
+
+void EntityScriptRunner::unload(const EntityItemID& entityID) {
+    if (!_entityScripts.contains(entityID)) {
+        return;
+    }
+    const EntityScriptDetails& details = _entityScripts[entityID];
+    QScriptValue entityScript = details.scriptObject;
+    if (entityScript.property("unload").isValid()) {
+        ScriptCallbackTimer timer(_entitiesScriptEngine->getProfile(), details.profileName + ".unload");
+        QScriptValueList entityArgs;
+        entityArgs << entityID.toScriptValue(_entitiesScriptEngine);
+        entityScript.property("unload").call(entityScript, entityArgs);
+    }
+}
+
+QString EntityScriptRunner::loadScriptContents(const QString& scriptMaybeURLorText, bool& isURL) {
+    QUrl url(scriptMaybeURLorText);
+
+    // If the url is not valid, this must be script text...
+    if (!url.isValid()) {
+        isURL = false;
+        return scriptMaybeURLorText;
+    }
+    isURL = true;
+
+    QString scriptContents; // assume empty
+
+    // if the scheme length is one or lower, maybe they typed in a file, let's try
+    const int WINDOWS_DRIVE_LETTER_SIZE = 1;
+    if (url.scheme().size() <= WINDOWS_DRIVE_LETTER_SIZE) {
+        url = QUrl::fromLocalFile(scriptMaybeURLorText);
+    }
+
+    // ok, let's see if it's valid... and if so, load it, once for all the entities that share it
+    if (url.isValid()) {
+        scriptContents = ScriptSourceCache::getInstance().loadSource(url);
+    }
+
+    return scriptContents;
+}
+
+QScriptValue EntityScriptRunner::loadEntityScript(const EntityItemID& entityID, const QString& entityScript) {
+    if (_entityScripts.contains(entityID)) {
+        EntityScriptDetails details = _entityScripts[entityID];
+
+        // check to make sure our script text hasn't changed on us since we last loaded it
+        if (details.scriptText == entityScript) {
+            return details.scriptObject; // previously loaded
+        }
+
+        // if we got here, then we previously loaded a script, but the entity's script value
+        // has changed and so we need to reload it.
+        _entityScripts.remove(entityID);
+    }
+    if (entityScript.isEmpty()) {
+        return QScriptValue(); // no script
+    }
+
+    bool isURL = false; // loadScriptContents() will tell us if this is a URL or just text.
+    QString scriptContents = loadScriptContents(entityScript, isURL);
+
+    // the entities that share a script share its parsed program, which was checked when it was first parsed
+    QString fileName = isURL ? entityScript : QString();
+    if (!_sandboxScriptEngine->hasProgram(scriptContents, fileName)) {
+        QScriptSyntaxCheckResult syntaxCheck = QScriptEngine::checkSyntax(scriptContents);
+        if (syntaxCheck.state() != QScriptSyntaxCheckResult::Valid) {
+            qDebug() << "EntityScriptRunner::loadEntityScript() entity:" << entityID;
+            qDebug() << "   " << syntaxCheck.errorMessage() << ":"
+                              << syntaxCheck.errorLineNumber() << syntaxCheck.errorColumnNumber();
+            qDebug() << "    SCRIPT:" << entityScript;
+            return QScriptValue(); // invalid script
+        }
+    }
+
+    if (isURL) {
+        _entitiesScriptEngine->setParentURL(entityScript);
+    }
+    QScriptValue entityScriptConstructor = _sandboxScriptEngine->evaluateProgram(scriptContents, fileName);
+
+    if (!entityScriptConstructor.isFunction()) {
+        qDebug() << "EntityScriptRunner::loadEntityScript() entity:" << entityID;
+        qDebug() << "    NOT CONSTRUCTOR";
+        qDebug() << "    SCRIPT:" << entityScript;
+        return QScriptValue(); // invalid script
+    } else {
+        entityScriptConstructor = _entitiesScriptEngine->evaluateProgram(scriptContents, fileName);
+    }
+
+    QString profileName = isURL ? QUrl(entityScript).fileName() : QString("inline");
+    QScriptValue entityScriptObject;
+    {
+        ScriptCallbackTimer timer(_entitiesScriptEngine->getProfile(), profileName + ".construct");
+        entityScriptObject = entityScriptConstructor.construct();
+    }
+    EntityScriptDetails newDetails = { entityScript, entityScriptObject, profileName };
+    _entityScripts[entityID] = newDetails;
+
+    if (isURL) {
+        _entitiesScriptEngine->setParentURL("");
+    }
+
+    return entityScriptObject; // newly constructed
+}
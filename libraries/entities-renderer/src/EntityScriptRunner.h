@@ -0,0 +1,100 @@
+//
+//  EntityScriptRunner.h
+//  libraries/entities-renderer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptRunner_h
+#define hifi_EntityScriptRunner_h
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QScriptValue>
+
+#include <EntityItemID.h>
+#include <MouseEvent.h>
+#include <RegisteredMetaTypes.h>
+
+class ScriptEngine;
+
+class EntityScriptDetails {
+public:
+    QString scriptText;
+    QScriptValue scriptObject;
+    QString profileName; ///< the script's file, or "inline", which its callbacks are profiled under
+};
+
+/// Runs the entity scripts on a thread of their own, so that a slow one costs the scripts' frames rather than the
+/// client's.  The renderer queues the calls from the main thread with the entity's script text, and they run in order
+/// on the script thread a slice at a time, with the calls that only report where the mouse is now collapsed into the
+/// latest of them.
+class EntityScriptRunner : public QObject {
+    Q_OBJECT
+public:
+
+    /// Takes ownership of the sandbox engine.  Both engines should be moved to the runner's thread along with it.
+    EntityScriptRunner(ScriptEngine* entitiesScriptEngine, ScriptEngine* sandboxScriptEngine);
+    virtual ~EntityScriptRunner();
+
+    /// Queues a call of an entity script method that takes the entity's ID, loading the script if need be.
+    void callMethod(const EntityItemID& entityID, const QString& entityScript, const QString& methodName);
+
+    /// Queues a call of an entity script method that takes the entity's ID and a mouse event.
+    void callMethod(const EntityItemID& entityID, const QString& entityScript, const QString& methodName,
+        const MouseEvent& event);
+
+    /// Queues a call of an entity script's collisionWithEntity.
+    void callCollisionWithEntity(const EntityItemID& entityID, const QString& entityScript,
+        const EntityItemID& otherID, const Collision& collision);
+
+    /// Queues the unload of the entity's script, if one was loaded.
+    void unloadEntityScript(const EntityItemID& entityID);
+
+    /// Queues the unload of all the loaded scripts.
+    void unloadAllEntityScripts();
+
+    /// Queues the move of a loaded script to the entity's new ID.
+    void changeEntityID(const EntityItemID& oldEntityID, const EntityItemID& newEntityID);
+
+private slots:
+
+    void processCalls();
+
+private:
+
+    class Call {
+    public:
+        enum Type { METHOD, MOUSE_METHOD, COLLISION, UNLOAD, UNLOAD_ALL, CHANGE_ID };
+
+        Type type;
+        EntityItemID entityID;
+        EntityItemID otherID;
+        QString entityScript;
+        QString methodName;
+        MouseEvent mouseEvent;
+        Collision collision;
+    };
+
+    void queueCall(const Call& call);
+    void runCall(const Call& call);
+    void unload(const EntityItemID& entityID);
+
+    QScriptValue loadEntityScript(const EntityItemID& entityID, const QString& entityScript);
+    QString loadScriptContents(const QString& scriptMaybeURLorText, bool& isURL);
+
+    ScriptEngine* _entitiesScriptEngine;
+    ScriptEngine* _sandboxScriptEngine;
+    QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+
+    QMutex _callsMutex;
+    QList<Call> _calls;
+    bool _processCallsQueued;
+};
+
+#endif // hifi_EntityScriptRunner_h
@@ -13,18 +13,20 @@
 
 #include <glm/gtx/quaternion.hpp>
 
-#include <QEventLoop>
-#include <QScriptSyntaxCheckResult>
+#include <QThread>
 
 #include <AbstractScriptingServicesInterface.h>
 #include <AbstractViewStateInterface.h>
 #include <DeferredLightingEffect.h>
+#include <GeometryCache.h>
 #include <GlowEffect.h>
 #include <Model.h>
-#include <NetworkAccessManager.h>
 #include <PerfStat.h>
 #include <ScriptEngine.h>
+#include <gpu/Batch.h>
+#include <gpu/GLBackend.h>
 
+#include "EntityScriptRunner.h"
 #include "EntityTreeRenderer.h"
 
 #include "RenderableBoxEntityItem.h"
@@ -39,7 +41,8 @@ EntityTreeRenderer::EntityTreeRenderer(bool wantScripts, AbstractViewStateInterf
     OctreeRenderer(),
     _wantScripts(wantScripts),
     _entitiesScriptEngine(NULL),
-    _sandboxScriptEngine(NULL),
+    _scriptRunner(NULL),
+    _scriptThread(NULL),
     _lastMouseEventValid(false),
     _viewState(viewState),
     _scriptingServices(scriptingServices),
@@ -60,18 +63,79 @@ EntityTreeRenderer::EntityTreeRenderer(bool wantScripts, AbstractViewStateInterf
 
 EntityTreeRenderer::~EntityTreeRenderer() {
     // NOTE: we don't need to delete _entitiesScriptEngine because it's owned by the application and gets cleaned up 
-    // automatically but we do need to delete our sandbox script engine.
-    delete _sandboxScriptEngine;
-    _sandboxScriptEngine = NULL;
+    // automatically but we do need to stop our script thread and delete the runner, which owns the sandbox engine.
+    if (_scriptThread) {
+        _scriptThread->quit();
+        _scriptThread->wait();
+    }
+    delete _scriptRunner;
+    _scriptRunner = NULL;
 }
 
 void EntityTreeRenderer::clear() {
     leaveAllEntities();
-    foreach (const EntityItemID& entityID, _entityScripts.keys()) {
-        checkAndCallUnload(entityID);
+    rememberDomainModels();
+    _renderableEntities.clear();
+    if (_scriptRunner) {
+        _scriptRunner->unloadAllEntityScripts();
     }
     OctreeRenderer::clear();
-    _entityScripts.clear();
+}
+
+void EntityTreeRenderer::setDomainHostname(const QString& domainHostname) {
+    if (domainHostname != _domainHostname) {
+        _domainHostname = domainHostname;
+        prefetchDomainModels(_domainHostname);
+    }
+}
+
+const int MAX_REMEMBERED_DOMAINS = 8;
+
+void EntityTreeRenderer::rememberDomainModels() {
+    if (_domainHostname.isEmpty() || !_tree) {
+        return;
+    }
+    
+    QSet<QUrl> modelURLs;
+    QVector<EntityItem*> entities;
+    
+    _tree->lockForRead();
+    getTree()->findEntities(AACube(glm::vec3(0.0f), 1.0f), entities);
+    foreach (EntityItem* entity, entities) {
+        if (entity->getType() == EntityTypes::Model) {
+            QUrl modelURL = static_cast<ModelEntityItem*>(entity)->getModelURL();
+            if (!modelURL.isEmpty()) {
+                modelURLs.insert(modelURL);
+            }
+        }
+    }
+    _tree->unlock();
+    
+    // an empty tree tells us nothing new, keep whatever we saw there last time
+    if (modelURLs.isEmpty()) {
+        return;
+    }
+    
+    _domainModelURLs.insert(_domainHostname, modelURLs);
+    _rememberedDomains.removeOne(_domainHostname);
+    _rememberedDomains.append(_domainHostname);
+    
+    while (_rememberedDomains.size() > MAX_REMEMBERED_DOMAINS) {
+        _domainModelURLs.remove(_rememberedDomains.takeFirst());
+    }
+}
+
+void EntityTreeRenderer::prefetchDomainModels(const QString& domainHostname) {
+    QHash<QString, QSet<QUrl> >::const_iterator modelURLs = _domainModelURLs.constFind(domainHostname);
+    if (modelURLs == _domainModelURLs.constEnd()) {
+        return;
+    }
+    
+    // nobody owns these yet so they load after anything in view, and stay in the cache's unused list once they have
+    auto geometryCache = DependencyManager::get<GeometryCache>();
+    foreach (const QUrl& modelURL, modelURLs.value()) {
+        geometryCache->getGeometry(modelURL);
+    }
 }
 
 void EntityTreeRenderer::init() {
@@ -84,7 +148,16 @@ void EntityTreeRenderer::init() {
                                         _scriptingServices->getControllerScriptingInterface());
         _scriptingServices->registerScriptEngineWithApplicationServices(_entitiesScriptEngine);
 
-        _sandboxScriptEngine = new ScriptEngine(NO_SCRIPT, "Entities Sandbox", NULL);
+        ScriptEngine* sandboxScriptEngine = new ScriptEngine(NO_SCRIPT, "Entities Sandbox", NULL);
+        _scriptRunner = new EntityScriptRunner(_entitiesScriptEngine, sandboxScriptEngine);
+
+        // the entity scripts run on a thread of their own, so that a slow one can't hold up our frames
+        _scriptThread = new QThread(this);
+        _scriptThread->setObjectName("Entity Script Thread");
+        _entitiesScriptEngine->moveToThread(_scriptThread);
+        sandboxScriptEngine->moveToThread(_scriptThread);
+        _scriptRunner->moveToThread(_scriptThread);
+        _scriptThread->start();
     }
 
     // make sure our "last avatar position" is something other than our current position, so that on our
@@ -92,146 +165,50 @@ void EntityTreeRenderer::init() {
     _lastAvatarPosition = _viewState->getAvatarPosition() + glm::vec3(1.0f, 1.0f, 1.0f);
     
     connect(entityTree, &EntityTree::deletingEntity, this, &EntityTreeRenderer::deletingEntity);
-    connect(entityTree, &EntityTree::addingEntity, this, &EntityTreeRenderer::checkAndCallPreload);
+    connect(entityTree, &EntityTree::addingEntity, this, &EntityTreeRenderer::addingEntity);
     connect(entityTree, &EntityTree::entityScriptChanging, this, &EntityTreeRenderer::entitySciptChanging);
     connect(entityTree, &EntityTree::changingEntityID, this, &EntityTreeRenderer::changingEntityID);
 }
 
-QScriptValue EntityTreeRenderer::loadEntityScript(const EntityItemID& entityItemID) {
-    EntityItem* entity = static_cast<EntityTree*>(_tree)->findEntityByEntityItemID(entityItemID);
-    return loadEntityScript(entity);
+const ScriptProfile* EntityTreeRenderer::getEntityScriptProfile() const {
+    return _entitiesScriptEngine ? &_entitiesScriptEngine->getProfile() : NULL;
 }
 
-
-QString EntityTreeRenderer::loadScriptContents(const QString& scriptMaybeURLorText, bool& isURL) {
-    QUrl url(scriptMaybeURLorText);
-    
-    // If the url is not valid, this must be script text...
-    if (!url.isValid()) {
-        isURL = false;
-        return scriptMaybeURLorText;
-    }
-    isURL = true;
-
-    QString scriptContents; // assume empty
-    
-    // if the scheme length is one or lower, maybe they typed in a file, let's try
-    const int WINDOWS_DRIVE_LETTER_SIZE = 1;
-    if (url.scheme().size() <= WINDOWS_DRIVE_LETTER_SIZE) {
-        url = QUrl::fromLocalFile(scriptMaybeURLorText);
-    }
-
-    // ok, let's see if it's valid... and if so, load it
-    if (url.isValid()) {
-        if (url.scheme() == "file") {
-            QString fileName = url.toLocalFile();
-            QFile scriptFile(fileName);
-            if (scriptFile.open(QFile::ReadOnly | QFile::Text)) {
-                qDebug() << "Loading file:" << fileName;
-                QTextStream in(&scriptFile);
-                scriptContents = in.readAll();
-            } else {
-                qDebug() << "ERROR Loading file:" << fileName;
-            }
-        } else {
-            QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
-            QNetworkRequest networkRequest = QNetworkRequest(url);
-            networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
-            QNetworkReply* reply = networkAccessManager.get(networkRequest);
-            qDebug() << "Downloading script at" << url;
-            QEventLoop loop;
-            QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
-            loop.exec();
-            if (reply->error() == QNetworkReply::NoError && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) == 200) {
-                scriptContents = reply->readAll();
-            } else {
-                qDebug() << "ERROR Loading file:" << url.toString();
-            }
-            delete reply;
-        }
-    }
-    
-    return scriptContents;
+QString EntityTreeRenderer::getEntityScript(const EntityItemID& entityItemID) {
+    EntityItem* entity = static_cast<EntityTree*>(_tree)->findEntityByEntityItemID(entityItemID);
+    return entity ? entity->getScript() : QString();
 }
 
-
-QScriptValue EntityTreeRenderer::loadEntityScript(EntityItem* entity) {
-    if (!entity) {
-        return QScriptValue(); // no entity...
+void EntityTreeRenderer::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName) {
+    if (_scriptRunner) {
+        _scriptRunner->callMethod(entityID, getEntityScript(entityID), methodName);
     }
-    
-    // NOTE: we keep local variables for the entityID and the script because
-    // below in loadScriptContents() it's possible for us to execute the
-    // application event loop, which may cause our entity to be deleted on
-    // us. We don't really need access the entity after this point, can
-    // can accomplish all we need to here with just the script "text" and the ID.
-    EntityItemID entityID = entity->getEntityItemID();
-    QString entityScript = entity->getScript();
-    
-    if (_entityScripts.contains(entityID)) {
-        EntityScriptDetails details = _entityScripts[entityID];
-        
-        // check to make sure our script text hasn't changed on us since we last loaded it
-        if (details.scriptText == entityScript) {
-            return details.scriptObject; // previously loaded
-        }
-        
-        // if we got here, then we previously loaded a script, but the entity's script value
-        // has changed and so we need to reload it.
-        _entityScripts.remove(entityID);
-    }
-    if (entityScript.isEmpty()) {
-        return QScriptValue(); // no script
-    }
-    
-    bool isURL = false; // loadScriptContents() will tell us if this is a URL or just text.
-    QString scriptContents = loadScriptContents(entityScript, isURL);
-    
-    QScriptSyntaxCheckResult syntaxCheck = QScriptEngine::checkSyntax(scriptContents);
-    if (syntaxCheck.state() != QScriptSyntaxCheckResult::Valid) {
-        qDebug() << "EntityTreeRenderer::loadEntityScript() entity:" << entityID;
-        qDebug() << "   " << syntaxCheck.errorMessage() << ":"
-                          << syntaxCheck.errorLineNumber() << syntaxCheck.errorColumnNumber();
-        qDebug() << "    SCRIPT:" << entityScript;
-        return QScriptValue(); // invalid script
-    }
-    
-    if (isURL) {
-        _entitiesScriptEngine->setParentURL(entity->getScript());
-    }
-    QScriptValue entityScriptConstructor = _sandboxScriptEngine->evaluate(scriptContents);
-    
-    if (!entityScriptConstructor.isFunction()) {
-        qDebug() << "EntityTreeRenderer::loadEntityScript() entity:" << entityID;
-        qDebug() << "    NOT CONSTRUCTOR";
-        qDebug() << "    SCRIPT:" << entityScript;
-        return QScriptValue(); // invalid script
-    } else {
-        entityScriptConstructor = _entitiesScriptEngine->evaluate(scriptContents);
-    }
-
-    QScriptValue entityScriptObject = entityScriptConstructor.construct();
-    EntityScriptDetails newDetails = { entityScript, entityScriptObject };
-    _entityScripts[entityID] = newDetails;
+}
 
-    if (isURL) {
-        _entitiesScriptEngine->setParentURL("");
+void EntityTreeRenderer::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+        const MouseEvent& event) {
+    if (_scriptRunner) {
+        _scriptRunner->callMethod(entityID, getEntityScript(entityID), methodName, event);
     }
-
-    return entityScriptObject; // newly constructed
 }
 
-QScriptValue EntityTreeRenderer::getPreviouslyLoadedEntityScript(const EntityItemID& entityID) {
-    if (_entityScripts.contains(entityID)) {
-        EntityScriptDetails details = _entityScripts[entityID];
-        return details.scriptObject; // previously loaded
+static bool collectEntitiesOperation(OctreeElement* element, void* extraData) {
+    QSet<EntityItemID>* entities = static_cast<QSet<EntityItemID>*>(extraData);
+    for (EntityItem* entity : static_cast<EntityTreeElement*>(element)->getEntities()) {
+        entities->insert(entity->getEntityItemID());
     }
-    return QScriptValue(); // no script
+    return true;
 }
 
 void EntityTreeRenderer::setTree(Octree* newTree) {
     OctreeRenderer::setTree(newTree);
     static_cast<EntityTree*>(_tree)->setFBXService(this);
+
+    // the new tree's entities are already in it, so we won't hear of them being added
+    _renderableEntities.clear();
+    _tree->lockForRead();
+    _tree->recurseTreeWithOperation(collectEntitiesOperation, &_renderableEntities);
+    _tree->unlock();
 }
 
 void EntityTreeRenderer::update() {
@@ -247,11 +224,7 @@ void EntityTreeRenderer::update() {
         // and we want to simulate this message here as well as in mouse move
         if (_lastMouseEventValid && !_currentClickingOnEntityID.isInvalidID()) {
             emit holdingClickOnEntity(_currentClickingOnEntityID, _lastMouseEvent);
-            QScriptValueList currentClickingEntityArgs = createMouseEventArgs(_currentClickingOnEntityID, _lastMouseEvent);
-            QScriptValue currentClickingEntity = loadEntityScript(_currentClickingOnEntityID);
-            if (currentClickingEntity.property("holdingClickOnEntity").isValid()) {
-                currentClickingEntity.property("holdingClickOnEntity").call(currentClickingEntity, currentClickingEntityArgs);
-            }
+            callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", _lastMouseEvent);
         }
 
     }
@@ -259,7 +232,7 @@ void EntityTreeRenderer::update() {
 
 void EntityTreeRenderer::checkEnterLeaveEntities() {
     if (_tree) {
-        _tree->lockForWrite(); // so that our scripts can do edits if they want
+        _tree->lockForRead();
         glm::vec3 avatarPosition = _viewState->getAvatarPosition() / (float) TREE_SCALE;
         
         if (avatarPosition != _lastAvatarPosition) {
@@ -281,12 +254,7 @@ void EntityTreeRenderer::checkEnterLeaveEntities() {
             foreach(const EntityItemID& entityID, _currentEntitiesInside) {
                 if (!entitiesContainingAvatar.contains(entityID)) {
                     emit leaveEntity(entityID);
-                    QScriptValueList entityArgs = createEntityArgs(entityID);
-                    QScriptValue entityScript = loadEntityScript(entityID);
-                    if (entityScript.property("leaveEntity").isValid()) {
-                        entityScript.property("leaveEntity").call(entityScript, entityArgs);
-                    }
-
+                    callEntityScriptMethod(entityID, "leaveEntity");
                 }
             }
 
@@ -294,11 +262,7 @@ void EntityTreeRenderer::checkEnterLeaveEntities() {
             foreach(const EntityItemID& entityID, entitiesContainingAvatar) {
                 if (!_currentEntitiesInside.contains(entityID)) {
                     emit enterEntity(entityID);
-                    QScriptValueList entityArgs = createEntityArgs(entityID);
-                    QScriptValue entityScript = loadEntityScript(entityID);
-                    if (entityScript.property("enterEntity").isValid()) {
-                        entityScript.property("enterEntity").call(entityScript, entityArgs);
-                    }
+                    callEntityScriptMethod(entityID, "enterEntity");
                 }
             }
             _currentEntitiesInside = entitiesContainingAvatar;
@@ -310,16 +274,12 @@ void EntityTreeRenderer::checkEnterLeaveEntities() {
 
 void EntityTreeRenderer::leaveAllEntities() {
     if (_tree) {
-        _tree->lockForWrite(); // so that our scripts can do edits if they want
+        _tree->lockForRead();
         
         // for all of our previous containing entities, if they are no longer containing then send them a leave event
         foreach(const EntityItemID& entityID, _currentEntitiesInside) {
             emit leaveEntity(entityID);
-            QScriptValueList entityArgs = createEntityArgs(entityID);
-            QScriptValue entityScript = loadEntityScript(entityID);
-            if (entityScript.property("leaveEntity").isValid()) {
-                entityScript.property("leaveEntity").call(entityScript, entityArgs);
-            }
+            callEntityScriptMethod(entityID, "leaveEntity");
         }
         _currentEntitiesInside.clear();
         
@@ -335,7 +295,12 @@ void EntityTreeRenderer::render(RenderArgs::RenderMode renderMode, RenderArgs::R
         RenderArgs args = { this, _viewFrustum, getSizeScale(), getBoundaryLevelAdjust(), renderMode, renderSide,
                                             0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
         _tree->lockForRead();
-        _tree->recurseTreeWithOperation(renderOperation, &args);
+        if (_displayModelElementProxy) {
+            // the element proxies need the walk of the elements
+            _tree->recurseTreeWithOperation(renderOperation, &args);
+        } else {
+            renderEntities(&args);
+        }
 
         Model::RenderMode modelRenderMode = renderMode == RenderArgs::SHADOW_RENDER_MODE
                                             ? Model::SHADOW_RENDER_MODE : Model::DEFAULT_RENDER_MODE;
@@ -450,7 +415,7 @@ void EntityTreeRenderer::renderElementProxy(EntityTreeElement* entityTreeElement
 void EntityTreeRenderer::renderProxies(const EntityItem* entity, RenderArgs* args) {
     bool isShadowMode = args->_renderMode == RenderArgs::SHADOW_RENDER_MODE;
     if (!isShadowMode && _displayModelBounds) {
-        PerformanceTimer perfTimer("renderProxies");
+        PERFORMANCE_TIMER("renderProxies");
 
         AACube maxCube = entity->getMaximumAACube();
         AACube minCube = entity->getMinimumAACube();
@@ -504,13 +469,128 @@ void EntityTreeRenderer::renderProxies(const EntityItem* entity, RenderArgs* arg
     }
 }
 
+void EntityTreeRenderer::renderEntities(RenderArgs* args) {
+    PERFORMANCE_TIMER("renderEntities");
+    EntityTree* entityTree = static_cast<EntityTree*>(_tree);
+
+    // gather the visible entities and their boxes, dropping those that have left the tree without our hearing of it
+    _visibleEntities.clear();
+    _visibleEntityBoxes.clear();
+    QVector<EntityItemID> missingEntities;
+    foreach (const EntityItemID& entityID, _renderableEntities) {
+        EntityItem* entity = entityTree->findEntityByEntityItemID(entityID);
+        if (!entity) {
+            missingEntities.append(entityID);
+            continue;
+        }
+        if (entity->isVisible()) {
+            AABox entityBox = entity->getAABox();
+            entityBox.scale(TREE_SCALE);
+            _visibleEntities.append(entity);
+            _visibleEntityBoxes.append(entityBox);
+        }
+    }
+    foreach (const EntityItemID& entityID, missingEntities) {
+        _renderableEntities.remove(entityID);
+    }
+
+    // cull them all against the frustum in one go
+    args->_viewFrustum->cullBoxes(_visibleEntityBoxes, _entitiesOutside);
+
+    // the unglowing boxes and spheres are drawn together afterwards, and the rest one at a time as we go
+    _cubeTransforms.clear();
+    _cubeColors.clear();
+    _sphereTransforms.clear();
+    _sphereColors.clear();
+    const float MAX_COLOR = 255.0f;
+    for (int i = 0; i < _visibleEntities.size(); i++) {
+        if (_entitiesOutside.at(i)) {
+            args->_itemsOutOfView++;
+            continue;
+        }
+        const AABox& entityBox = _visibleEntityBoxes.at(i);
+        float distance = args->_viewFrustum->distanceToCamera(entityBox.calcCenter());
+        if (!_viewState->shouldRenderMesh(entityBox.getLargestDimension(), distance)) {
+            args->_itemsTooSmall++;
+            continue;
+        }
+        EntityItem* entity = _visibleEntities.at(i);
+        renderProxies(entity, args);
+        args->_itemsRendered++;
+
+        bool isCube = entity->getType() == EntityTypes::Box;
+        if (!(isCube || entity->getType() == EntityTypes::Sphere) || entity->getGlowLevel() > 0.0f) {
+            renderEntity(entity, args);
+            continue;
+        }
+        glm::vec3 position = entity->getPositionInMeters();
+        glm::vec3 center = entity->getCenterInMeters();
+        Transform transform;
+        transform.postTranslate(position);
+        transform.postRotate(entity->getRotation());
+        transform.postTranslate(center - position);
+        transform.postScale(entity->getDimensions() * (float)TREE_SCALE);
+
+        const rgbColor& color = isCube ? static_cast<BoxEntityItem*>(entity)->getColor() :
+            static_cast<SphereEntityItem*>(entity)->getColor();
+        glm::vec4 renderColor(color[RED_INDEX] / MAX_COLOR, color[GREEN_INDEX] / MAX_COLOR,
+            color[BLUE_INDEX] / MAX_COLOR, entity->getLocalRenderAlpha());
+        if (isCube) {
+            _cubeTransforms.append(transform);
+            _cubeColors.append(renderColor);
+        } else {
+            _sphereTransforms.append(transform);
+            _sphereColors.append(renderColor);
+        }
+    }
+    if (_cubeTransforms.isEmpty() && _sphereTransforms.isEmpty()) {
+        return;
+    }
+
+    // the same as RenderableSphereEntityItem draws
+    const float SPHERE_RADIUS = 0.5f;
+    const int SPHERE_SLICES = 15;
+    const int SPHERE_STACKS = 15;
+
+    gpu::Batch batch;
+    batch.setViewTransform(_viewState->getViewTransform());
+    QSharedPointer<GeometryCache> geometryCache = DependencyManager::get<GeometryCache>();
+    geometryCache->renderSolidCubeInstances(batch, _cubeTransforms, _cubeColors);
+    geometryCache->renderSphereInstances(batch, SPHERE_RADIUS, SPHERE_SLICES, SPHERE_STACKS,
+        _sphereTransforms, _sphereColors);
+
+    QSharedPointer<DeferredLightingEffect> deferredLighting = DependencyManager::get<DeferredLightingEffect>();
+    deferredLighting->bindSimpleProgram();
+    glPushMatrix();
+    gpu::GLBackend::renderBatch(batch);
+    glPopMatrix();
+    deferredLighting->releaseSimpleProgram();
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void EntityTreeRenderer::renderEntity(EntityItem* entity, RenderArgs* args) {
+    Glower* glower = NULL;
+    if (entity->getGlowLevel() > 0.0f) {
+        glower = new Glower(entity->getGlowLevel());
+    }
+    entity->render(args);
+    if (glower) {
+        delete glower;
+    }
+}
+
 void EntityTreeRenderer::renderElement(OctreeElement* element, RenderArgs* args) {
     args->_elementsTouched++;
     // actually render it here...
     // we need to iterate the actual entityItems of the element
     EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
 
-    QList<EntityItem*>& entityItems = entityTreeElement->getEntities();
+    const EntityItemList& entityItems = entityTreeElement->getEntities();
     
 
     uint16_t numberOfEntities = entityItems.size();
@@ -540,16 +620,8 @@ void EntityTreeRenderer::renderElement(OctreeElement* element, RenderArgs* args)
                 
                 if (bigEnoughToRender) {
                     renderProxies(entityItem, args);
-
-                    Glower* glower = NULL;
-                    if (entityItem->getGlowLevel() > 0.0f) {
-                        glower = new Glower(entityItem->getGlowLevel());
-                    }
-                    entityItem->render(args);
+                    renderEntity(entityItem, args);
                     args->_itemsRendered++;
-                    if (glower) {
-                        delete glower;
-                    }
                 } else {
                     args->_itemsTooSmall++;
                 }
@@ -678,29 +750,8 @@ void EntityTreeRenderer::connectSignalsToSlots(EntityScriptingInterface* entityS
     connect(this, &EntityTreeRenderer::leaveEntity, entityScriptingInterface, &EntityScriptingInterface::leaveEntity);
 }
 
-QScriptValueList EntityTreeRenderer::createMouseEventArgs(const EntityItemID& entityID, QMouseEvent* event, unsigned int deviceID) {
-    QScriptValueList args;
-    args << entityID.toScriptValue(_entitiesScriptEngine);
-    args << MouseEvent(*event, deviceID).toScriptValue(_entitiesScriptEngine);
-    return args;
-}
-
-QScriptValueList EntityTreeRenderer::createMouseEventArgs(const EntityItemID& entityID, const MouseEvent& mouseEvent) {
-    QScriptValueList args;
-    args << entityID.toScriptValue(_entitiesScriptEngine);
-    args << mouseEvent.toScriptValue(_entitiesScriptEngine);
-    return args;
-}
-
-
-QScriptValueList EntityTreeRenderer::createEntityArgs(const EntityItemID& entityID) {
-    QScriptValueList args;
-    args << entityID.toScriptValue(_entitiesScriptEngine);
-    return args;
-}
-
 void EntityTreeRenderer::mousePressEvent(QMouseEvent* event, unsigned int deviceID) {
-    PerformanceTimer perfTimer("EntityTreeRenderer::mousePressEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mousePressEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
     
     bool precisionPicking = !_dontDoPrecisionPicking;
@@ -708,49 +759,32 @@ void EntityTreeRenderer::mousePressEvent(QMouseEvent* event, unsigned int device
     if (rayPickResult.intersects) {
         //qDebug() << "mousePressEvent over entity:" << rayPickResult.entityID;
         emit mousePressOnEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-
-        QScriptValueList entityScriptArgs = createMouseEventArgs(rayPickResult.entityID, event, deviceID);
-        QScriptValue entityScript = loadEntityScript(rayPickResult.entity);
-        if (entityScript.property("mousePressOnEntity").isValid()) {
-            entityScript.property("mousePressOnEntity").call(entityScript, entityScriptArgs);
-        }
+        callEntityScriptMethod(rayPickResult.entityID, "mousePressOnEntity", MouseEvent(*event, deviceID));
         
         _currentClickingOnEntityID = rayPickResult.entityID;
         emit clickDownOnEntity(_currentClickingOnEntityID, MouseEvent(*event, deviceID));
-        if (entityScript.property("clickDownOnEntity").isValid()) {
-            entityScript.property("clickDownOnEntity").call(entityScript, entityScriptArgs);
-        }
+        callEntityScriptMethod(_currentClickingOnEntityID, "clickDownOnEntity", MouseEvent(*event, deviceID));
     }
     _lastMouseEvent = MouseEvent(*event, deviceID);
     _lastMouseEventValid = true;
 }
 
 void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event, unsigned int deviceID) {
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseReleaseEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseReleaseEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
     bool precisionPicking = !_dontDoPrecisionPicking;
     RayToEntityIntersectionResult rayPickResult = findRayIntersectionWorker(ray, Octree::Lock, precisionPicking);
     if (rayPickResult.intersects) {
         //qDebug() << "mouseReleaseEvent over entity:" << rayPickResult.entityID;
         emit mouseReleaseOnEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-
-        QScriptValueList entityScriptArgs = createMouseEventArgs(rayPickResult.entityID, event, deviceID);
-        QScriptValue entityScript = loadEntityScript(rayPickResult.entity);
-        if (entityScript.property("mouseReleaseOnEntity").isValid()) {
-            entityScript.property("mouseReleaseOnEntity").call(entityScript, entityScriptArgs);
-        }
+        callEntityScriptMethod(rayPickResult.entityID, "mouseReleaseOnEntity", MouseEvent(*event, deviceID));
     }
     
     // Even if we're no longer intersecting with an entity, if we started clicking on it, and now
     // we're releasing the button, then this is considered a clickOn event
     if (!_currentClickingOnEntityID.isInvalidID()) {
         emit clickReleaseOnEntity(_currentClickingOnEntityID, MouseEvent(*event, deviceID));
-
-        QScriptValueList currentClickingEntityArgs = createMouseEventArgs(_currentClickingOnEntityID, event, deviceID);
-        QScriptValue currentClickingEntity = loadEntityScript(_currentClickingOnEntityID);
-        if (currentClickingEntity.property("clickReleaseOnEntity").isValid()) {
-            currentClickingEntity.property("clickReleaseOnEntity").call(currentClickingEntity, currentClickingEntityArgs);
-        }
+        callEntityScriptMethod(_currentClickingOnEntityID, "clickReleaseOnEntity", MouseEvent(*event, deviceID));
     }
     
     // makes it the unknown ID, we just released so we can't be clicking on anything
@@ -760,57 +794,40 @@ void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event, unsigned int devi
 }
 
 void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceID) {
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseMoveEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseMoveEvent");
 
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
     
     bool precisionPicking = false; // for mouse moves we do not do precision picking
     RayToEntityIntersectionResult rayPickResult = findRayIntersectionWorker(ray, Octree::TryLock, precisionPicking);
     if (rayPickResult.intersects) {
-        QScriptValueList entityScriptArgs = createMouseEventArgs(rayPickResult.entityID, event, deviceID);
-
-        // load the entity script if needed...
-        QScriptValue entityScript = loadEntityScript(rayPickResult.entity);
-        if (entityScript.property("mouseMoveEvent").isValid()) {
-            entityScript.property("mouseMoveEvent").call(entityScript, entityScriptArgs);
-        }
+        MouseEvent mouseEvent(*event, deviceID);
+        callEntityScriptMethod(rayPickResult.entityID, "mouseMoveEvent", mouseEvent);
     
         //qDebug() << "mouseMoveEvent over entity:" << rayPickResult.entityID;
-        emit mouseMoveOnEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-        if (entityScript.property("mouseMoveOnEntity").isValid()) {
-            entityScript.property("mouseMoveOnEntity").call(entityScript, entityScriptArgs);
-        }
+        emit mouseMoveOnEntity(rayPickResult.entityID, mouseEvent);
+        callEntityScriptMethod(rayPickResult.entityID, "mouseMoveOnEntity", mouseEvent);
         
         // handle the hover logic...
         
         // if we were previously hovering over an entity, and this new entity is not the same as our previous entity
         // then we need to send the hover leave.
         if (!_currentHoverOverEntityID.isInvalidID() && rayPickResult.entityID != _currentHoverOverEntityID) {
-            emit hoverLeaveEntity(_currentHoverOverEntityID, MouseEvent(*event, deviceID));
-
-            QScriptValueList currentHoverEntityArgs = createMouseEventArgs(_currentHoverOverEntityID, event, deviceID);
-
-            QScriptValue currentHoverEntity = loadEntityScript(_currentHoverOverEntityID);
-            if (currentHoverEntity.property("hoverLeaveEntity").isValid()) {
-                currentHoverEntity.property("hoverLeaveEntity").call(currentHoverEntity, currentHoverEntityArgs);
-            }
+            emit hoverLeaveEntity(_currentHoverOverEntityID, mouseEvent);
+            callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", mouseEvent);
         }
 
         // If the new hover entity does not match the previous hover entity then we are entering the new one
         // this is true if the _currentHoverOverEntityID is known or unknown
         if (rayPickResult.entityID != _currentHoverOverEntityID) {
-            emit hoverEnterEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-            if (entityScript.property("hoverEnterEntity").isValid()) {
-                entityScript.property("hoverEnterEntity").call(entityScript, entityScriptArgs);
-            }
+            emit hoverEnterEntity(rayPickResult.entityID, mouseEvent);
+            callEntityScriptMethod(rayPickResult.entityID, "hoverEnterEntity", mouseEvent);
         }
 
         // and finally, no matter what, if we're intersecting an entity then we're definitely hovering over it, and
         // we should send our hover over event
-        emit hoverOverEntity(rayPickResult.entityID, MouseEvent(*event, deviceID));
-        if (entityScript.property("hoverOverEntity").isValid()) {
-            entityScript.property("hoverOverEntity").call(entityScript, entityScriptArgs);
-        }
+        emit hoverOverEntity(rayPickResult.entityID, mouseEvent);
+        callEntityScriptMethod(rayPickResult.entityID, "hoverOverEntity", mouseEvent);
 
         // remember what we're hovering over
         _currentHoverOverEntityID = rayPickResult.entityID;
@@ -821,13 +838,7 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceI
         // send the hover leave for our previous entity
         if (!_currentHoverOverEntityID.isInvalidID()) {
             emit hoverLeaveEntity(_currentHoverOverEntityID, MouseEvent(*event, deviceID));
-
-            QScriptValueList currentHoverEntityArgs = createMouseEventArgs(_currentHoverOverEntityID, event, deviceID);
-
-            QScriptValue currentHoverEntity = loadEntityScript(_currentHoverOverEntityID);
-            if (currentHoverEntity.property("hoverLeaveEntity").isValid()) {
-                currentHoverEntity.property("hoverLeaveEntity").call(currentHoverEntity, currentHoverEntityArgs);
-            }
+            callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", MouseEvent(*event, deviceID));
 
             _currentHoverOverEntityID = EntityItemID::createInvalidEntityID(); // makes it the unknown ID
         }
@@ -837,21 +848,20 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceI
     // not yet released the hold then this is still considered a holdingClickOnEntity event
     if (!_currentClickingOnEntityID.isInvalidID()) {
         emit holdingClickOnEntity(_currentClickingOnEntityID, MouseEvent(*event, deviceID));
-
-        QScriptValueList currentClickingEntityArgs = createMouseEventArgs(_currentClickingOnEntityID, event, deviceID);
-
-        QScriptValue currentClickingEntity = loadEntityScript(_currentClickingOnEntityID);
-        if (currentClickingEntity.property("holdingClickOnEntity").isValid()) {
-            currentClickingEntity.property("holdingClickOnEntity").call(currentClickingEntity, currentClickingEntityArgs);
-        }
+        callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", MouseEvent(*event, deviceID));
     }
     _lastMouseEvent = MouseEvent(*event, deviceID);
     _lastMouseEventValid = true;
 }
 
+void EntityTreeRenderer::addingEntity(const EntityItemID& entityID) {
+    _renderableEntities.insert(entityID);
+    checkAndCallPreload(entityID);
+}
+
 void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
+    _renderableEntities.remove(entityID);
     checkAndCallUnload(entityID);
-    _entityScripts.remove(entityID);
 }
 
 void EntityTreeRenderer::entitySciptChanging(const EntityItemID& entityID) {
@@ -861,48 +871,36 @@ void EntityTreeRenderer::entitySciptChanging(const EntityItemID& entityID) {
 
 void EntityTreeRenderer::checkAndCallPreload(const EntityItemID& entityID) {
     // load the entity script if needed...
-    QScriptValue entityScript = loadEntityScript(entityID);
-    if (entityScript.property("preload").isValid()) {
-        QScriptValueList entityArgs = createEntityArgs(entityID);
-        entityScript.property("preload").call(entityScript, entityArgs);
-    }
+    callEntityScriptMethod(entityID, "preload");
 }
 
 void EntityTreeRenderer::checkAndCallUnload(const EntityItemID& entityID) {
-    QScriptValue entityScript = getPreviouslyLoadedEntityScript(entityID);
-    if (entityScript.property("unload").isValid()) {
-        QScriptValueList entityArgs = createEntityArgs(entityID);
-        entityScript.property("unload").call(entityScript, entityArgs);
+    if (_scriptRunner) {
+        _scriptRunner->unloadEntityScript(entityID);
     }
 }
 
 
 void EntityTreeRenderer::changingEntityID(const EntityItemID& oldEntityID, const EntityItemID& newEntityID) {
-    if (_entityScripts.contains(oldEntityID)) {
-        EntityScriptDetails details = _entityScripts[oldEntityID];
-        _entityScripts.remove(oldEntityID);
-        _entityScripts[newEntityID] = details;
+    if (_renderableEntities.remove(oldEntityID)) {
+        _renderableEntities.insert(newEntityID);
+    }
+    if (_scriptRunner) {
+        _scriptRunner->changeEntityID(oldEntityID, newEntityID);
+    }
+}
+
+void EntityTreeRenderer::entityCollisions(const EntityCollisions& collisions) {
+    foreach (const EntityCollision& collision, collisions) {
+        entityCollisionWithEntity(collision.idA, collision.idB, collision.collision);
     }
 }
 
 void EntityTreeRenderer::entityCollisionWithEntity(const EntityItemID& idA, const EntityItemID& idB, 
                                                     const Collision& collision) {
-    QScriptValue entityScriptA = loadEntityScript(idA);
-    if (entityScriptA.property("collisionWithEntity").isValid()) {
-        QScriptValueList args;
-        args << idA.toScriptValue(_entitiesScriptEngine);
-        args << idB.toScriptValue(_entitiesScriptEngine);
-        args << collisionToScriptValue(_entitiesScriptEngine, collision);
-        entityScriptA.property("collisionWithEntity").call(entityScriptA, args);
-    }
-
-    QScriptValue entityScriptB = loadEntityScript(idB);
-    if (entityScriptB.property("collisionWithEntity").isValid()) {
-        QScriptValueList args;
-        args << idB.toScriptValue(_entitiesScriptEngine);
-        args << idA.toScriptValue(_entitiesScriptEngine);
-        args << collisionToScriptValue(_entitiesScriptEngine, collision);
-        entityScriptB.property("collisionWithEntity").call(entityScriptA, args);
+    if (_scriptRunner) {
+        _scriptRunner->callCollisionWithEntity(idA, getEntityScript(idA), idB, collision);
+        _scriptRunner->callCollisionWithEntity(idB, getEntityScript(idB), idA, collision);
     }
 }
 
@@ -12,23 +12,24 @@
 #ifndef hifi_EntityTreeRenderer_h
 #define hifi_EntityTreeRenderer_h
 
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QUrl>
+
 #include <EntityTree.h>
 #include <EntityScriptingInterface.h> // for RayToEntityIntersectionResult
 #include <MouseEvent.h>
 #include <OctreeRenderer.h>
+#include <Transform.h>
 
 class Model;
 class ScriptEngine;
 class AbstractViewStateInterface;
 class AbstractScriptingServicesInterface;
-
-class ScriptEngine;
-
-class EntityScriptDetails {
-public:
-    QString scriptText;
-    QScriptValue scriptObject;
-};
+class EntityScriptRunner;
+class QThread;
+class ScriptProfile;
 
 // Generic client side Octree renderer class.
 class EntityTreeRenderer : public OctreeRenderer, public EntityItemFBXService {
@@ -59,9 +60,12 @@ public:
     virtual const FBXGeometry* getGeometryForEntity(const EntityItem* entityItem);
     virtual const Model* getModelForEntityItem(const EntityItem* entityItem);
     
-    /// clears the tree
+    /// clears the tree, remembering the models of the domain it held
     virtual void clear();
 
+    /// sets the domain whose entities the tree will hold, and starts loading the models remembered for it
+    void setDomainHostname(const QString& domainHostname);
+
     /// if a renderable entity item needs a model, we will allocate it for them
     Q_INVOKABLE Model* allocateModel(const QString& url);
     
@@ -82,6 +86,9 @@ public:
     /// hovering over, and entering entities
     void connectSignalsToSlots(EntityScriptingInterface* entityScriptingInterface);
 
+    /// Returns the profile of the entity scripts' callbacks, or NULL if we don't run scripts.
+    const ScriptProfile* getEntityScriptProfile() const;
+
 signals:
     void mousePressOnEntity(const EntityItemID& entityItemID, const MouseEvent& event);
     void mouseMoveOnEntity(const EntityItemID& entityItemID, const MouseEvent& event);
@@ -99,10 +106,14 @@ signals:
     void leaveEntity(const EntityItemID& entityItemID);
 
 public slots:
+    void addingEntity(const EntityItemID& entityID);
     void deletingEntity(const EntityItemID& entityID);
     void changingEntityID(const EntityItemID& oldEntityID, const EntityItemID& newEntityID);
     void entitySciptChanging(const EntityItemID& entityID);
-    void entityCollisionWithEntity(const EntityItemID& idA, const EntityItemID& idB, const Collision& collision);
+    void entityCollisions(const EntityCollisions& collisions);
+
+    /// starts loading the models last seen in a domain at the lowest priority, ahead of going there
+    void prefetchDomainModels(const QString& domainHostname);
 
     // optional slots that can be wired to menu items
     void setDisplayElementChildProxies(bool value) { _displayElementChildProxies = value; }
@@ -115,6 +126,8 @@ protected:
 
 private:
     void renderElementProxy(EntityTreeElement* entityTreeElement);
+    void renderEntities(RenderArgs* args);
+    void renderEntity(EntityItem* entity, RenderArgs* args);
     void checkAndCallPreload(const EntityItemID& entityID);
     void checkAndCallUnload(const EntityItemID& entityID);
 
@@ -126,24 +139,21 @@ private:
     EntityItemID _currentHoverOverEntityID;
     EntityItemID _currentClickingOnEntityID;
 
-    QScriptValueList createEntityArgs(const EntityItemID& entityID);
     void checkEnterLeaveEntities();
     void leaveAllEntities();
+    void rememberDomainModels();
     glm::vec3 _lastAvatarPosition;
     QVector<EntityItemID> _currentEntitiesInside;
     
     bool _wantScripts;
     ScriptEngine* _entitiesScriptEngine;
-    ScriptEngine* _sandboxScriptEngine;
-
-    QScriptValue loadEntityScript(EntityItem* entity);
-    QScriptValue loadEntityScript(const EntityItemID& entityItemID);
-    QScriptValue getPreviouslyLoadedEntityScript(const EntityItemID& entityItemID);
-    QString loadScriptContents(const QString& scriptMaybeURLorText, bool& isURL);
-    QScriptValueList createMouseEventArgs(const EntityItemID& entityID, QMouseEvent* event, unsigned int deviceID);
-    QScriptValueList createMouseEventArgs(const EntityItemID& entityID, const MouseEvent& mouseEvent);
-    
-    QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+    EntityScriptRunner* _scriptRunner;
+    QThread* _scriptThread;
+
+    QString getEntityScript(const EntityItemID& entityItemID);
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName);
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName, const MouseEvent& event);
+    void entityCollisionWithEntity(const EntityItemID& idA, const EntityItemID& idB, const Collision& collision);
 
     bool _lastMouseEventValid;
     MouseEvent _lastMouseEvent;
@@ -153,7 +163,22 @@ private:
     bool _displayModelBounds;
     bool _displayModelElementProxy;
     bool _dontDoPrecisionPicking;
-    
+
+    // every entity in the tree, kept up to date by its signals so that rendering needn't walk the tree
+    QSet<EntityItemID> _renderableEntities;
+
+    QString _domainHostname;
+    QHash<QString, QSet<QUrl> > _domainModelURLs;
+    QStringList _rememberedDomains; // least recently left first
+
+    // the scratch of each frame's render, kept so as not to reallocate it every frame
+    QVector<EntityItem*> _visibleEntities;
+    QVector<AABox> _visibleEntityBoxes;
+    QVector<bool> _entitiesOutside;
+    QVector<Transform> _cubeTransforms;
+    QVector<glm::vec4> _cubeColors;
+    QVector<Transform> _sphereTransforms;
+    QVector<glm::vec4> _sphereColors;
 };
 
 #endif // hifi_EntityTreeRenderer_h
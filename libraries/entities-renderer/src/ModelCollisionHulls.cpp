@@ -0,0 +1,239 @@
+//
+//  ModelCollisionHulls.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <float.h>
+
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QRunnable>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QtDebug>
+
+#include <GeometryCache.h>
+#include <SharedUtil.h>
+
+#include "ModelCollisionHulls.h"
+
+// cached hulls are stored after this header, whose version goes up whenever the format or the way they're built changes
+static const char HULL_CACHE_ID[] = "HFCH";
+static const quint8 HULL_CACHE_VERSION = 1;
+
+static bool readHulls(const QString& filename, ConvexHulls& hulls) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    char id[sizeof(HULL_CACHE_ID) - 1];
+    quint8 version;
+    quint32 hullCount;
+    if (in.readRawData(id, sizeof(id)) != (int)sizeof(id) || memcmp(id, HULL_CACHE_ID, sizeof(id)) != 0) {
+        return false;
+    }
+    in >> version >> hullCount;
+    if (in.status() != QDataStream::Ok || version != HULL_CACHE_VERSION) {
+        return false;
+    }
+    ConvexHulls read;
+    for (quint32 i = 0; i < hullCount && in.status() == QDataStream::Ok; i++) {
+        quint32 pointCount;
+        in >> pointCount;
+        QVector<glm::vec3> hull;
+        for (quint32 j = 0; j < pointCount && in.status() == QDataStream::Ok; j++) {
+            glm::vec3 point;
+            in >> point.x >> point.y >> point.z;
+            hull.push_back(point);
+        }
+        read.push_back(hull);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Discarding truncated collision hulls" << filename;
+        file.close();
+        QFile::remove(filename);
+        return false;
+    }
+    hulls = read;
+    return true;
+}
+
+static void writeHulls(const QString& filename, const ConvexHulls& hulls) {
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Failed to write collision hulls" << filename;
+        return;
+    }
+    QDataStream out(&file);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out.writeRawData(HULL_CACHE_ID, sizeof(HULL_CACHE_ID) - 1);
+    out << HULL_CACHE_VERSION << (quint32)hulls.size();
+    foreach (const QVector<glm::vec3>& hull, hulls) {
+        out << (quint32)hull.size();
+        foreach (const glm::vec3& point, hull) {
+            out << point.x << point.y << point.z;
+        }
+    }
+}
+
+class ConvexHullsBuilder : public QRunnable {
+public:
+    ConvexHullsBuilder(const QUrl& url, const QSharedPointer<NetworkGeometry>& geometry,
+            const QVector<glm::vec3>& directions, const QString& cacheDirectory) :
+        _url(url),
+        _geometry(geometry),
+        _directions(directions),
+        _cacheDirectory(cacheDirectory),
+        _extents(geometry->getFBXGeometry().meshExtents) {
+        // the vertex arrays are shared with the geometry rather than copied
+        foreach (const FBXMesh& mesh, geometry->getFBXGeometry().meshes) {
+            _vertices.push_back(mesh.vertices);
+            _transforms.push_back(mesh.modelTransform);
+        }
+    }
+
+    virtual void run() {
+        // the same URL may serve a different model by the next session, so the mesh data is part of the key
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(_url.toEncoded());
+        hash.addData(reinterpret_cast<const char*>(&_extents.minimum), sizeof(glm::vec3));
+        hash.addData(reinterpret_cast<const char*>(&_extents.maximum), sizeof(glm::vec3));
+        for (int i = 0; i < _vertices.size(); i++) {
+            hash.addData(reinterpret_cast<const char*>(&_transforms[i]), sizeof(glm::mat4));
+            hash.addData(reinterpret_cast<const char*>(_vertices[i].constData()),
+                _vertices[i].size() * sizeof(glm::vec3));
+        }
+        QString cacheFilename = _cacheDirectory + "/" + hash.result().toHex() + ".hulls";
+
+        ConvexHulls hulls;
+        if (!readHulls(cacheFilename, hulls)) {
+            hulls = buildHulls();
+            writeHulls(cacheFilename, hulls);
+        }
+        ModelCollisionHulls::getInstance().finishHulls(_url, _geometry, hulls);
+    }
+
+private:
+    ConvexHulls buildHulls() const {
+        glm::vec3 center = 0.5f * (_extents.minimum + _extents.maximum);
+        glm::vec3 size = glm::max(_extents.maximum - _extents.minimum, glm::vec3(EPSILON));
+
+        ConvexHulls hulls;
+        QVector<float> furthest(_directions.size());
+        QVector<int> furthestIndex(_directions.size());
+        for (int i = 0; i < _vertices.size(); i++) {
+            const QVector<glm::vec3>& vertices = _vertices[i];
+            if (vertices.isEmpty()) {
+                continue;
+            }
+            furthest.fill(-FLT_MAX);
+            furthestIndex.fill(-1);
+            QVector<glm::vec3> points(vertices.size());
+            for (int j = 0; j < vertices.size(); j++) {
+                // into the unit box around the whole model
+                glm::vec3 point = glm::vec3(_transforms[i] * glm::vec4(vertices[j], 1.0f));
+                points[j] = (point - center) / size;
+                for (int k = 0; k < _directions.size(); k++) {
+                    float distance = glm::dot(points[j], _directions[k]);
+                    if (distance > furthest[k]) {
+                        furthest[k] = distance;
+                        furthestIndex[k] = j;
+                    }
+                }
+            }
+
+            QSet<int> kept;
+            QVector<glm::vec3> hull;
+            foreach (int index, furthestIndex) {
+                if (!kept.contains(index)) {
+                    kept.insert(index);
+                    hull.push_back(points[index]);
+                }
+            }
+            hulls.push_back(hull);
+        }
+        return hulls;
+    }
+
+    QUrl _url;
+    QWeakPointer<NetworkGeometry> _geometry;
+    QVector<glm::vec3> _directions;
+    QString _cacheDirectory;
+    Extents _extents;
+    QVector<QVector<glm::vec3> > _vertices;
+    QVector<glm::mat4> _transforms;
+};
+
+ModelCollisionHulls& ModelCollisionHulls::getInstance() {
+    static ModelCollisionHulls instance;
+    return instance;
+}
+
+ModelCollisionHulls::ModelCollisionHulls() {
+    // the hull of a mesh is made of its vertices furthest along each of these directions, every (x, y, z) with
+    // components in [-2, 2] that isn't a multiple of another, which keeps at most 98 points a hull
+    for (int x = -2; x <= 2; x++) {
+        for (int y = -2; y <= 2; y++) {
+            for (int z = -2; z <= 2; z++) {
+                bool allEven = (x % 2 == 0) && (y % 2 == 0) && (z % 2 == 0);
+                if (!allEven) {
+                    _directions.push_back(glm::normalize(glm::vec3(x, y, z)));
+                }
+            }
+        }
+    }
+
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    _cacheDirectory = QDir((!cachePath.isEmpty() ? cachePath : "hullCache") + "/collisionHulls").absolutePath();
+    QDir().mkpath(_cacheDirectory);
+}
+
+bool ModelCollisionHulls::getHulls(const QUrl& url, const QSharedPointer<NetworkGeometry>& geometry,
+                                   ConvexHulls& hulls) {
+    QMutexLocker locker(&_mutex);
+    QHash<QUrl, BuiltHulls>::iterator built = _hulls.find(url);
+    if (built != _hulls.end()) {
+        if (geometry) {
+            // the geometry may have been released and loaded again since the hulls were built
+            built.value().geometry = geometry;
+        }
+        hulls = built.value().hulls;
+        return true;
+    }
+    if (!_pending.contains(url) && geometry && geometry->isLoaded()) {
+        _pending.insert(url);
+        QThreadPool::globalInstance()->start(new ConvexHullsBuilder(url, geometry, _directions, _cacheDirectory));
+    }
+    return false;
+}
+
+void ModelCollisionHulls::finishHulls(const QUrl& url, const QWeakPointer<NetworkGeometry>& geometry,
+                                      const ConvexHulls& hulls) {
+    QMutexLocker locker(&_mutex);
+    _pending.remove(url);
+
+    // the hulls are only kept while their geometry is, the entities showing the model hold copies of their own
+    for (QHash<QUrl, BuiltHulls>::iterator built = _hulls.begin(); built != _hulls.end(); ) {
+        if (built.value().geometry.isNull()) {
+            built = _hulls.erase(built);
+        } else {
+            built++;
+        }
+    }
+    if (!geometry.isNull()) {
+        BuiltHulls& built = _hulls[url];
+        built.hulls = hulls;
+        built.geometry = geometry;
+    }
+}
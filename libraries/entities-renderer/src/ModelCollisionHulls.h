@@ -0,0 +1,62 @@
+//
+//  ModelCollisionHulls.h
+//  libraries/entities-renderer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ModelCollisionHulls_h
+#define hifi_ModelCollisionHulls_h
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QUrl>
+#include <QVector>
+#include <QWeakPointer>
+
+#include <glm/glm.hpp>
+
+class NetworkGeometry;
+
+typedef QVector<QVector<glm::vec3> > ConvexHulls;
+
+/// Builds the approximate convex decomposition a model entity collides with, one hull per mesh of the model thinned
+/// down to the mesh's extreme points, on the global thread pool. The hulls are kept by model URL in a unit box
+/// centered on the model's mesh extents, so every entity showing the model scales the same hulls to its dimensions,
+/// for as long as the model's geometry is in use.  They're also written to the cache directory, keyed by the URL and
+/// the model's mesh data, and later sessions read them back on the pool instead of building them again.
+class ModelCollisionHulls {
+public:
+    static ModelCollisionHulls& getInstance();
+
+    /// \return true and the hulls of the model at url if they're built, otherwise starts building them from the
+    /// loaded geometry unless that's already under way
+    bool getHulls(const QUrl& url, const QSharedPointer<NetworkGeometry>& geometry, ConvexHulls& hulls);
+
+private:
+    ModelCollisionHulls();
+
+    class BuiltHulls {
+    public:
+        ConvexHulls hulls;
+        QWeakPointer<NetworkGeometry> geometry;
+    };
+
+    void finishHulls(const QUrl& url, const QWeakPointer<NetworkGeometry>& geometry, const ConvexHulls& hulls);
+
+    QVector<glm::vec3> _directions; ///< filled in up front, the builders share them on the pool threads
+    QString _cacheDirectory;
+
+    QMutex _mutex;
+    QHash<QUrl, BuiltHulls> _hulls;
+    QSet<QUrl> _pending;
+
+    friend class ConvexHullsBuilder;
+};
+
+#endif // hifi_ModelCollisionHulls_h
@@ -23,10 +23,11 @@ EntityItem* RenderableBoxEntityItem::factory(const EntityItemID& entityID, const
 }
 
 void RenderableBoxEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableBoxEntityItem::render");
+    PERFORMANCE_TIMER("RenderableBoxEntityItem::render");
     assert(getType() == EntityTypes::Box);
-    glm::vec3 position = getPositionInMeters();
-    glm::vec3 center = getCenter() * (float)TREE_SCALE;
+    glm::vec3 positionCorrection = getPositionCorrectionInMeters();
+    glm::vec3 position = getPositionInMeters() + positionCorrection;
+    glm::vec3 center = getCenter() * (float)TREE_SCALE + positionCorrection;
     glm::vec3 dimensions = getDimensions() * (float)TREE_SCALE;
     glm::quat rotation = getRotation();
 
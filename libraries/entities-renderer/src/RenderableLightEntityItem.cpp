@@ -24,9 +24,9 @@ EntityItem* RenderableLightEntityItem::factory(const EntityItemID& entityID, con
 }
 
 void RenderableLightEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableLightEntityItem::render");
+    PERFORMANCE_TIMER("RenderableLightEntityItem::render");
     assert(getType() == EntityTypes::Light);
-    glm::vec3 position = getPositionInMeters();
+    glm::vec3 position = getPositionInMeters() + getPositionCorrectionInMeters();
     glm::vec3 dimensions = getDimensions() * (float)TREE_SCALE;
     glm::quat rotation = getRotation();
     float largestDiameter = glm::max(dimensions.x, dimensions.y, dimensions.z);
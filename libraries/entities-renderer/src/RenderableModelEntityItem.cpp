@@ -18,6 +18,7 @@
 #include <DeferredLightingEffect.h>
 #include <Model.h>
 #include <PerfStat.h>
+#include <ShapeInfo.h>
 
 #include "EntityTreeRenderer.h"
 #include "RenderableModelEntityItem.h"
@@ -39,6 +40,8 @@ bool RenderableModelEntityItem::setProperties(const EntityItemProperties& proper
     bool somethingChanged = ModelEntityItem::setProperties(properties);
     if (somethingChanged && oldModelURL != getModelURL()) {
         _needsModelReload = true;
+        _collisionHulls.clear();
+        _collisionHullsPending = true;
     }
     return somethingChanged;
 }
@@ -51,6 +54,8 @@ int RenderableModelEntityItem::readEntitySubclassDataFromBuffer(const unsigned c
                                                                         args, propertyFlags, overwriteLocalData);
     if (oldModelURL != getModelURL()) {
         _needsModelReload = true;
+        _collisionHulls.clear();
+        _collisionHullsPending = true;
     }
     return bytesRead;
 }
@@ -109,12 +114,12 @@ void RenderableModelEntityItem::remapTextures() {
 
 
 void RenderableModelEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RMEIrender");
+    PERFORMANCE_TIMER("RMEIrender");
     assert(getType() == EntityTypes::Model);
     
     bool drawAsModel = hasModel();
 
-    glm::vec3 position = getPosition() * (float)TREE_SCALE;
+    glm::vec3 position = getPositionInMeters() + getPositionCorrectionInMeters();
     float size = getSize() * (float)TREE_SCALE;
     glm::vec3 dimensions = getDimensions() * (float)TREE_SCALE;
     
@@ -126,7 +131,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
 
             if (!_model || _needsModelReload) {
                 // TODO: this getModel() appears to be about 3% of model render time. We should optimize
-                PerformanceTimer perfTimer("getModel");
+                PERFORMANCE_TIMER("getModel");
                 EntityTreeRenderer* renderer = static_cast<EntityTreeRenderer*>(args->_renderer);
                 getModel(renderer);
             }
@@ -148,7 +153,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                 }
 
                 glm::quat rotation = getRotation();
-                bool movingOrAnimating = isMoving() || isAnimatingSomething();
+                bool movingOrAnimating = isMoving() || isAnimatingSomething() || isBlendingPositionCorrection();
                 if ((movingOrAnimating || _needsInitialSimulation) && _model->isActive()) {
                     _model->setScaleToFit(true, dimensions);
                     _model->setSnapModelToRegistrationPoint(true, getRegistrationPoint());
@@ -157,7 +162,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                     
                     // make sure to simulate so everything gets set up correctly for rendering
                     {
-                        PerformanceTimer perfTimer("_model->simulate");
+                        PERFORMANCE_TIMER("_model->simulate");
                         _model->simulate(0.0f);
                     }
                     _needsInitialSimulation = false;
@@ -166,7 +171,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                 if (_model->isActive()) {
                     // TODO: this is the majority of model render time. And rendering of a cube model vs the basic Box render
                     // is significantly more expensive. Is there a way to call this that doesn't cost us as much? 
-                    PerformanceTimer perfTimer("model->render");
+                    PERFORMANCE_TIMER("model->render");
                     // filter out if not needed to render
                     if (args && (args->_renderMode == RenderArgs::SHADOW_RENDER_MODE)) {
                         if (movingOrAnimating) {
@@ -243,7 +248,34 @@ Model* RenderableModelEntityItem::getModel(EntityTreeRenderer* renderer) {
 }
 
 bool RenderableModelEntityItem::needsToCallUpdate() const {
-    return _needsInitialSimulation || ModelEntityItem::needsToCallUpdate();
+    return _needsInitialSimulation || ModelEntityItem::needsToCallUpdate()
+        || (_collisionHullsPending && !getIgnoreForCollisions());
+}
+
+void RenderableModelEntityItem::update(const quint64& now) {
+    ModelEntityItem::update(now);
+    if (_collisionHullsPending && !getIgnoreForCollisions() && _model && _model->isActive()) {
+        if (ModelCollisionHulls::getInstance().getHulls(QUrl(getModelURL()), _model->getGeometry(), _collisionHulls)) {
+            _collisionHullsPending = false;
+            _dirtyFlags |= EntityItem::DIRTY_SHAPE | EntityItem::DIRTY_MASS;
+        }
+    }
+}
+
+void RenderableModelEntityItem::computeShapeInfo(ShapeInfo& info) const {
+    ModelEntityItem::computeShapeInfo(info);
+    // a model too big to boxify that is a single mesh is most likely a building, which we don't want to fill in
+    if (_collisionHulls.isEmpty() || (_collisionHulls.size() == 1 && info.getType() != BOX_SHAPE)) {
+        return;
+    }
+    glm::vec3 dimensions = getDimensionsInMeters();
+    ConvexHulls hulls = _collisionHulls;
+    for (int i = 0; i < hulls.size(); i++) {
+        for (int j = 0; j < hulls[i].size(); j++) {
+            hulls[i][j] *= dimensions;
+        }
+    }
+    info.setConvexHulls(0.5f * dimensions, hulls, getModelURL());
 }
 
 EntityItemProperties RenderableModelEntityItem::getProperties() const {
@@ -17,6 +17,8 @@
 
 #include <ModelEntityItem.h>
 
+#include "ModelCollisionHulls.h"
+
 class Model;
 class EntityTreeRenderer;
 
@@ -30,7 +32,8 @@ public:
         _needsInitialSimulation(true),
         _needsModelReload(true),
         _myRenderer(NULL),
-        _originalTexturesRead(false) { }
+        _originalTexturesRead(false),
+        _collisionHullsPending(true) { }
 
     virtual ~RenderableModelEntityItem();
 
@@ -51,6 +54,10 @@ public:
     Model* getModel(EntityTreeRenderer* renderer);
 
     bool needsToCallUpdate() const;
+    virtual void update(const quint64& now);
+
+    /// collides as the convex hulls of the model's meshes once they're built, and as the ModelEntityItem until then
+    virtual void computeShapeInfo(ShapeInfo& info) const;
 
 private:
     void remapTextures();
@@ -62,6 +69,9 @@ private:
     QString _currentTextures;
     QStringList _originalTextures;
     bool _originalTexturesRead;
+
+    ConvexHulls _collisionHulls; // in the unit box around the model's mesh extents
+    bool _collisionHullsPending;
 };
 
 #endif // hifi_RenderableModelEntityItem_h
@@ -24,10 +24,11 @@ EntityItem* RenderableSphereEntityItem::factory(const EntityItemID& entityID, co
 }
 
 void RenderableSphereEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableSphereEntityItem::render");
+    PERFORMANCE_TIMER("RenderableSphereEntityItem::render");
     assert(getType() == EntityTypes::Sphere);
-    glm::vec3 position = getPositionInMeters();
-    glm::vec3 center = getCenterInMeters();
+    glm::vec3 positionCorrection = getPositionCorrectionInMeters();
+    glm::vec3 position = getPositionInMeters() + positionCorrection;
+    glm::vec3 center = getCenterInMeters() + positionCorrection;
     glm::vec3 dimensions = getDimensions() * (float)TREE_SCALE;
     glm::quat rotation = getRotation();
 
@@ -27,9 +27,9 @@ EntityItem* RenderableTextEntityItem::factory(const EntityItemID& entityID, cons
 }
 
 void RenderableTextEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableTextEntityItem::render");
+    PERFORMANCE_TIMER("RenderableTextEntityItem::render");
     assert(getType() == EntityTypes::Text);
-    glm::vec3 position = getPositionInMeters();
+    glm::vec3 position = getPositionInMeters() + getPositionCorrectionInMeters();
     glm::vec3 dimensions = getDimensions() * (float)TREE_SCALE;
     glm::vec3 halfDimensions = dimensions / 2.0f;
     glm::quat rotation = getRotation();
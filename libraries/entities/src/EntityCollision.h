@@ -0,0 +1,31 @@
+//
+//  EntityCollision.h
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityCollision_h
+#define hifi_EntityCollision_h
+
+#include <QVector>
+
+#include <RegisteredMetaTypes.h>
+
+#include "EntityItemID.h"
+
+/// a contact between two entities, or between an entity and something else when one of the ids is unknown
+class EntityCollision {
+public:
+    EntityItemID idA;
+    EntityItemID idB;
+    Collision collision;
+};
+
+/// the collisions of a simulation frame, with at most one per pair of entities
+typedef QVector<EntityCollision> EntityCollisions;
+
+#endif // hifi_EntityCollision_h
@@ -26,7 +26,8 @@ void EntityEditPacketSender::adjustEditPacketForClockSkew(PacketType type,
 }
 
 void EntityEditPacketSender::queueEditEntityMessage(PacketType type, EntityItemID modelID, 
-                                                                const EntityItemProperties& properties) {
+                                                                const EntityItemProperties& properties,
+                                                                bool isInteractive) {
     if (!_shouldSend) {
         return; // bail early
     }
@@ -41,7 +42,7 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type, EntityItemI
             qDebug() << "    id:" << modelID;
             qDebug() << "    properties:" << properties;
         #endif
-        queueOctreeEditMessage(type, bufferOut, sizeOut);
+        queueOctreeEditMessage(type, bufferOut, sizeOut, 0, isInteractive);
     }
 }
 
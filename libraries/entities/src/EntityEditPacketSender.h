@@ -24,7 +24,9 @@ public:
     /// which voxel-server node or nodes the packet should be sent to. Can be called even before voxel servers are known, in
     /// which case up to MaxPendingMessages will be buffered and processed when voxel servers are known.
     /// NOTE: EntityItemProperties assumes that all distances are in meter units
-    void queueEditEntityMessage(PacketType type, EntityItemID modelID, const EntityItemProperties& properties);
+    /// An interactive edit, one the user is driving, doesn't wait to be batched with other edits.
+    void queueEditEntityMessage(PacketType type, EntityItemID modelID, const EntityItemProperties& properties,
+                                bool isInteractive = false);
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
@@ -13,7 +13,9 @@
 
 #include <ByteCountCoding.h>
 #include <GLMHelpers.h>
+#include <MemoryTracker.h>
 #include <Octree.h>
+#include <OctreeSentIndex.h>
 #include <PhysicsHelpers.h>
 #include <RegisteredMetaTypes.h>
 #include <SharedUtil.h> // usecTimestampNow()
@@ -24,6 +26,22 @@
 
 bool EntityItem::_sendPhysicsUpdates = true;
 
+const quint64 POSITION_CORRECTION_BLEND_TIME = USECS_PER_SECOND / 5;
+const float MAX_BLENDED_POSITION_CORRECTION = 2.0f; // meters, anything further is a jump and isn't blended
+
+static MemoryCounter& entityMemory = MemoryTracker::getInstance().getCounter("Entity items");
+
+void* EntityItem::operator new(size_t size) {
+    entityMemory.addCPUBytes(size);
+    return ::operator new(size);
+}
+
+void EntityItem::operator delete(void* entity, size_t size) {
+    // the destructor is virtual, so this is the size of the type that was made
+    entityMemory.removeCPUBytes(size);
+    ::operator delete(entity);
+}
+
 void EntityItem::initFromEntityItemID(const EntityItemID& entityItemID) {
     _id = entityItemID.id;
     _creatorTokenID = entityItemID.creatorTokenID;
@@ -37,6 +55,8 @@ void EntityItem::initFromEntityItemID(const EntityItemID& entityItemID) {
     _lastEditedFromRemoteInRemoteTime = 0;
     _created = UNKNOWN_CREATED_TIME;
     _changedOnServer = 0;
+    _positionCorrection = ENTITY_ITEM_ZERO_VEC3;
+    _positionCorrectionStart = 0;
 
     _position = ENTITY_ITEM_ZERO_VEC3;
     _dimensions = ENTITY_ITEM_DEFAULT_DIMENSIONS;
@@ -124,6 +144,66 @@ EntityPropertyFlags EntityItem::getEntityProperties(EncodeBitstreamParams& param
     return requestedProperties;
 }
 
+EntityPropertyFlags EntityItem::getEntityPropertiesToSend(EncodeBitstreamParams& params) const {
+    EntityPropertyFlags requestedProperties = getEntityProperties(params);
+
+    quint64 sentVersion;
+    EntityPropertyFlags changedProperties;
+    if (params.sentIndex && params.sentIndex->getSentVersion(getEntityItemID().id, sentVersion)
+            && getPropertiesChangedSince(sentVersion, changedProperties)) {
+        requestedProperties &= changedProperties;
+
+        // an edit to nothing the client is sent still goes out with the position, so the client learns the new last
+        // edited time and the entity counts as sent at this version
+        if (!requestedProperties) {
+            requestedProperties += PROP_POSITION;
+        }
+    }
+    return requestedProperties;
+}
+
+void EntityItem::markAsChangedOnServer(const EntityPropertyFlags& changedProperties) {
+    quint64 previousVersion = _changedOnServer;
+    markAsChangedOnServer();
+
+    bool newestIsPrevious = _numberOfServerChanges > 0
+        && _serverChanges[_numberOfServerChanges - 1].changedOnServer == previousVersion;
+    if (_changedOnServer == previousVersion && newestIsPrevious) {
+        // a second edit within the same microsecond is part of the same version
+        _serverChanges[_numberOfServerChanges - 1].changedProperties |= changedProperties;
+        return;
+    }
+    if (!newestIsPrevious) {
+        // the version before this edit came from somewhere we didn't see the properties of, start over from it
+        _numberOfServerChanges = 0;
+        _serverChangesSince = previousVersion;
+    } else if (_numberOfServerChanges == MAX_SERVER_CHANGES) {
+        _serverChangesSince = _serverChanges[0].changedOnServer;
+        for (int i = 1; i < MAX_SERVER_CHANGES; i++) {
+            _serverChanges[i - 1] = _serverChanges[i];
+        }
+        _numberOfServerChanges--;
+    }
+    _serverChanges[_numberOfServerChanges].changedOnServer = _changedOnServer;
+    _serverChanges[_numberOfServerChanges].changedProperties = changedProperties;
+    _numberOfServerChanges++;
+}
+
+bool EntityItem::getPropertiesChangedSince(quint64 changedOnServer, EntityPropertyFlags& changedProperties) const {
+    // the history only speaks for the entity if its newest change is the entity's current version
+    if (_numberOfServerChanges == 0 || changedOnServer < _serverChangesSince
+            || _serverChanges[_numberOfServerChanges - 1].changedOnServer != _changedOnServer) {
+        return false;
+    }
+    changedProperties = EntityPropertyFlags();
+    for (int i = 0; i < _numberOfServerChanges; i++) {
+        if (_serverChanges[i].changedOnServer > changedOnServer) {
+            changedProperties |= _serverChanges[i].changedProperties;
+        }
+    }
+    return true;
+}
+
 OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params, 
                                             EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const {
     // ALL this fits...
@@ -141,17 +221,20 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     // encode our type as a byte count coded byte stream
     ByteCountCoded<quint32> typeCoder = getType();
-    QByteArray encodedType = typeCoder;
+    unsigned char encodedType[ByteCountCoded<quint32>::MAX_ENCODED_BYTES];
+    int encodedTypeLength = typeCoder.encode(encodedType);
 
     // last updated (animations, non-physics changes)
     quint64 updateDelta = getLastUpdated() <= getLastEdited() ? 0 : getLastUpdated() - getLastEdited();
     ByteCountCoded<quint64> updateDeltaCoder = updateDelta;
-    QByteArray encodedUpdateDelta = updateDeltaCoder;
+    unsigned char encodedUpdateDelta[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+    int encodedUpdateDeltaLength = updateDeltaCoder.encode(encodedUpdateDelta);
 
     // last simulated (velocity, angular velocity, physics changes)
     quint64 simulatedDelta = getLastSimulated() <= getLastEdited() ? 0 : getLastSimulated() - getLastEdited();
     ByteCountCoded<quint64> simulatedDeltaCoder = simulatedDelta;
-    QByteArray encodedSimulatedDelta = simulatedDeltaCoder;
+    unsigned char encodedSimulatedDelta[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+    int encodedSimulatedDeltaLength = simulatedDeltaCoder.encode(encodedSimulatedDelta);
 
 
     EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
@@ -184,12 +267,12 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     bool successPropertyFlagsFits = false;
     int propertyFlagsOffset = 0;
     int oldPropertyFlagsLength = 0;
-    QByteArray encodedPropertyFlags;
+    unsigned char encodedPropertyFlags[EntityPropertyFlags::MAX_ENCODED_BYTES];
     int propertyCount = 0;
 
     successIDFits = packetData->appendValue(encodedID);
     if (successIDFits) {
-        successTypeFits = packetData->appendValue(encodedType);
+        successTypeFits = packetData->appendRawData(encodedType, encodedTypeLength);
     }
     if (successTypeFits) {
         successCreatedFits = packetData->appendValue(_created);
@@ -198,17 +281,16 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         successLastEditedFits = packetData->appendValue(lastEdited);
     }
     if (successLastEditedFits) {
-        successLastUpdatedFits = packetData->appendValue(encodedUpdateDelta);
+        successLastUpdatedFits = packetData->appendRawData(encodedUpdateDelta, encodedUpdateDeltaLength);
     }
     if (successLastUpdatedFits) {
-        successLastSimulatedFits = packetData->appendValue(encodedSimulatedDelta);
+        successLastSimulatedFits = packetData->appendRawData(encodedSimulatedDelta, encodedSimulatedDeltaLength);
     }
     
     if (successLastSimulatedFits) {
         propertyFlagsOffset = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        oldPropertyFlagsLength = encodedPropertyFlags.length();
-        successPropertyFlagsFits = packetData->appendValue(encodedPropertyFlags);
+        oldPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags);
+        successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags, oldPropertyFlagsLength);
     }
 
     bool headerFits = successIDFits && successTypeFits && successCreatedFits && successLastEditedFits 
@@ -253,10 +335,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     if (propertyCount > 0) {
         int endOfEntityItemData = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        int newPropertyFlagsLength = encodedPropertyFlags.length();
-        packetData->updatePriorBytes(propertyFlagsOffset, 
-                (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+        int newPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags);
+        packetData->updatePriorBytes(propertyFlagsOffset, encodedPropertyFlags, newPropertyFlagsLength);
         
         // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
         if (newPropertyFlagsLength < oldPropertyFlagsLength) {
@@ -327,27 +407,22 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
     int bytesRead = 0;
     if (bytesLeftToRead >= MINIMUM_HEADER_BYTES) {
 
-        int originalLength = bytesLeftToRead;
-        QByteArray originalDataBuffer((const char*)data, originalLength);
-
         int clockSkew = args.sourceNode ? args.sourceNode->getClockSkewUsec() : 0;
 
         const unsigned char* dataAt = data;
 
         // id
-        QByteArray encodedID = originalDataBuffer.mid(bytesRead, NUM_BYTES_RFC4122_UUID); // maximum possible size
-        _id = QUuid::fromRfc4122(encodedID);
+        _id = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)dataAt, NUM_BYTES_RFC4122_UUID));
         _creatorTokenID = UNKNOWN_ENTITY_TOKEN; // if we know the id, then we don't care about the creator token
         _newlyCreated = false;
-        dataAt += encodedID.size();
-        bytesRead += encodedID.size();
+        dataAt += NUM_BYTES_RFC4122_UUID;
+        bytesRead += NUM_BYTES_RFC4122_UUID;
         
         // type
-        QByteArray encodedType = originalDataBuffer.mid(bytesRead); // maximum possible size
-        ByteCountCoded<quint32> typeCoder = encodedType;
-        encodedType = typeCoder; // determine true length
-        dataAt += encodedType.size();
-        bytesRead += encodedType.size();
+        ByteCountCoded<quint32> typeCoder;
+        int encodedTypeLength = typeCoder.decode(dataAt, bytesLeftToRead - bytesRead);
+        dataAt += encodedTypeLength;
+        bytesRead += encodedTypeLength;
         quint32 type = typeCoder;
         _type = (EntityTypes::EntityType)type;
 
@@ -413,6 +488,10 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
             qDebug() << "                     fromSameServerEdit:" << fromSameServerEdit;
         #endif
 
+        // where the entity is drawn right now, so a correction from the server can be blended in from there
+        bool hadDataFromRemote = (_lastEditedFromRemote != 0);
+        glm::vec3 drawnPosition = _position + getPositionCorrection(now);
+
         bool ignoreServerPacket = false; // assume we'll use this server packet
         
         // If this packet is from the same server edit as the last packet we accepted from the server
@@ -456,8 +535,8 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         }
 
         // last updated is stored as ByteCountCoded delta from lastEdited
-        QByteArray encodedUpdateDelta = originalDataBuffer.mid(bytesRead); // maximum possible size
-        ByteCountCoded<quint64> updateDeltaCoder = encodedUpdateDelta;
+        ByteCountCoded<quint64> updateDeltaCoder;
+        int encodedUpdateDeltaLength = updateDeltaCoder.decode(dataAt, bytesLeftToRead - bytesRead);
         quint64 updateDelta = updateDeltaCoder;
         if (overwriteLocalData) {
             _lastUpdated = lastEditedFromBufferAdjusted + updateDelta; // don't adjust for clock skew since we already did that
@@ -467,15 +546,14 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 qDebug() << "           lastEditedFromBufferAdjusted:" << debugTime(lastEditedFromBufferAdjusted, now);
             #endif
         }
-        encodedUpdateDelta = updateDeltaCoder; // determine true length
-        dataAt += encodedUpdateDelta.size();
-        bytesRead += encodedUpdateDelta.size();
+        dataAt += encodedUpdateDeltaLength;
+        bytesRead += encodedUpdateDeltaLength;
         
         // Newer bitstreams will have a last simulated and a last updated value
         if (args.bitstreamVersion >= VERSION_ENTITIES_HAS_LAST_SIMULATED_TIME) {
             // last simulated is stored as ByteCountCoded delta from lastEdited
-            QByteArray encodedSimulatedDelta = originalDataBuffer.mid(bytesRead); // maximum possible size
-            ByteCountCoded<quint64> simulatedDeltaCoder = encodedSimulatedDelta;
+            ByteCountCoded<quint64> simulatedDeltaCoder;
+            int encodedSimulatedDeltaLength = simulatedDeltaCoder.decode(dataAt, bytesLeftToRead - bytesRead);
             quint64 simulatedDelta = simulatedDeltaCoder;
             if (overwriteLocalData) {
                 _lastSimulated = lastEditedFromBufferAdjusted + simulatedDelta; // don't adjust for clock skew since we already did that
@@ -485,9 +563,8 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                     qDebug() << "           lastEditedFromBufferAdjusted:" << debugTime(lastEditedFromBufferAdjusted, now);
                 #endif
             }
-            encodedSimulatedDelta = simulatedDeltaCoder; // determine true length
-            dataAt += encodedSimulatedDelta.size();
-            bytesRead += encodedSimulatedDelta.size();
+            dataAt += encodedSimulatedDeltaLength;
+            bytesRead += encodedSimulatedDeltaLength;
         }
         
         #ifdef WANT_DEBUG
@@ -501,10 +578,10 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         
 
         // Property Flags
-        QByteArray encodedPropertyFlags = originalDataBuffer.mid(bytesRead); // maximum possible size
-        EntityPropertyFlags propertyFlags = encodedPropertyFlags;
-        dataAt += propertyFlags.getEncodedLength();
-        bytesRead += propertyFlags.getEncodedLength();
+        EntityPropertyFlags propertyFlags;
+        int encodedPropertyFlagsLength = propertyFlags.decode(dataAt, bytesLeftToRead - bytesRead);
+        dataAt += encodedPropertyFlagsLength;
+        bytesRead += encodedPropertyFlagsLength;
         
         READ_ENTITY_PROPERTY_SETTER(PROP_POSITION, glm::vec3, updatePosition);
 
@@ -559,11 +636,35 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 simulateKinematicMotion(skipTimeForward);
             }
             _lastSimulated = now;
+
+            // both sides extrapolated the same way, so this is a correction to our own estimate, rather than pop to
+            // it we keep drawing the entity where it was and let that offset fade out, unless it was clearly a jump
+            glm::vec3 correction = drawnPosition - _position;
+            if (hadDataFromRemote && glm::length(correction) * (float)TREE_SCALE < MAX_BLENDED_POSITION_CORRECTION) {
+                _positionCorrection = correction;
+                _positionCorrectionStart = now;
+            } else {
+                _positionCorrection = ENTITY_ITEM_ZERO_VEC3;
+                _positionCorrectionStart = 0;
+            }
         }
     }
     return bytesRead;
 }
 
+glm::vec3 EntityItem::getPositionCorrection(quint64 now) const {
+    if (_positionCorrectionStart == 0 || now >= _positionCorrectionStart + POSITION_CORRECTION_BLEND_TIME) {
+        return ENTITY_ITEM_ZERO_VEC3;
+    }
+    float blend = (float)(now - _positionCorrectionStart) / (float)POSITION_CORRECTION_BLEND_TIME;
+    return _positionCorrection * (1.0f - blend);
+}
+
+bool EntityItem::isBlendingPositionCorrection() const {
+    return _positionCorrectionStart != 0
+        && usecTimestampNow() < _positionCorrectionStart + POSITION_CORRECTION_BLEND_TIME;
+}
+
 void EntityItem::debugDump() const {
     qDebug() << "EntityItem id:" << getEntityItemID();
     qDebug(" edited ago:%f", getEditedAgo());
@@ -758,8 +859,7 @@ void EntityItem::simulateKinematicMotion(float timeElapsed) {
         }
 
         float speed = glm::length(velocity);
-        const float EPSILON_LINEAR_VELOCITY_LENGTH = 0.001f / (float)TREE_SCALE; // 1mm/sec
-        if (speed < EPSILON_LINEAR_VELOCITY_LENGTH) {
+        if (speed < ENTITY_ITEM_EPSILON_LINEAR_VELOCITY_LENGTH) {
             setVelocity(ENTITY_ITEM_ZERO_VEC3);
             if (speed > 0.0f) {
                 _dirtyFlags |= EntityItem::DIRTY_MOTION_TYPE;
@@ -778,6 +878,15 @@ void EntityItem::simulateKinematicMotion(float timeElapsed) {
     }
 }
 
+void EntityItem::setSimulatedMotion(const glm::vec3& position, const glm::vec3& velocity, quint64 lastSimulated) {
+    if (velocity == ENTITY_ITEM_ZERO_VEC3 && hasVelocity()) {
+        _dirtyFlags |= EntityItem::DIRTY_MOTION_TYPE;
+    }
+    setPosition(position);
+    setVelocity(velocity);
+    _lastSimulated = lastSimulated;
+}
+
 bool EntityItem::isMoving() const {
     return hasVelocity() || hasAngularVelocity();
 }
@@ -990,6 +1099,7 @@ void EntityItem::setRadius(float value) {
     float diameter = value * 2.0f;
     float maxDimension = sqrt((diameter * diameter) / 3.0f);
     _dimensions = glm::vec3(maxDimension, maxDimension, maxDimension);
+    updateSpatialIndex();
 }
 
 // TODO: get rid of all users of this function...
@@ -1013,6 +1123,14 @@ void EntityItem::recalculateCollisionShape() {
     _collisionShape.setScale(entityAACube.getScale());
 }
 
+void EntityItem::updateSpatialIndex() {
+    // an entity that isn't in an element isn't in the index either, it's added with its element
+    if (_element) {
+        _element->updateEntityBounds(this);
+        _element->getTree()->updateSpatialIndex(this);
+    }
+}
+
 const float MIN_POSITION_DELTA = 0.0001f;
 const float MIN_ALIGNMENT_DOT = 0.9999f;
 const float MIN_VELOCITY_DELTA = 0.01f;
@@ -1024,6 +1142,7 @@ void EntityItem::updatePosition(const glm::vec3& value) {
     if (glm::distance(_position, value) * (float)TREE_SCALE > MIN_POSITION_DELTA) {
         _position = value; 
         recalculateCollisionShape();
+        updateSpatialIndex();
         _dirtyFlags |= EntityItem::DIRTY_POSITION;
     }
 }
@@ -1033,6 +1152,7 @@ void EntityItem::updatePositionInMeters(const glm::vec3& value) {
     if (glm::distance(_position, position) * (float)TREE_SCALE > MIN_POSITION_DELTA) {
         _position = position;
         recalculateCollisionShape();
+        updateSpatialIndex();
         _dirtyFlags |= EntityItem::DIRTY_POSITION;
     }
 }
@@ -1041,6 +1161,7 @@ void EntityItem::updateDimensions(const glm::vec3& value) {
     if (_dimensions != value) {
         _dimensions = glm::abs(value);
         recalculateCollisionShape();
+        updateSpatialIndex();
         _dirtyFlags |= (EntityItem::DIRTY_SHAPE | EntityItem::DIRTY_MASS);
     }
 }
@@ -1050,6 +1171,7 @@ void EntityItem::updateDimensionsInMeters(const glm::vec3& value) {
     if (_dimensions != dimensions) {
         _dimensions = dimensions;
         recalculateCollisionShape();
+        updateSpatialIndex();
         _dirtyFlags |= (EntityItem::DIRTY_SHAPE | EntityItem::DIRTY_MASS);
     }
 }
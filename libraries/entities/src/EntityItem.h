@@ -40,6 +40,8 @@ class EntityTreeElementExtraEncodeData;
 #define debugTimeOnly(T) qPrintable(QString("%1").arg(T, 16, 10))
 #define debugTreeVector(V) V << "[" << (V * (float)TREE_SCALE) << " in meters ]"
 
+const float DEFAULT_MAX_EXTRAPOLATION_ERROR = 0.03f; // meters
+
 
 /// EntityItem class this is the base class for all entity types. It handles the basic properties and functionality available
 /// to all other entity types. In particular: postion, size, rotation, age, lifetime, velocity, gravity. You can not instantiate
@@ -64,6 +66,10 @@ public:
     EntityItem(const EntityItemID& entityItemID, const EntityItemProperties& properties);
     virtual ~EntityItem();
 
+    /// Entities are counted in the MemoryTracker at the size of the type made.
+    static void* operator new(size_t size);
+    static void operator delete(void* entity, size_t size);
+
     // ID and EntityItemID related methods
     QUuid getID() const { return _id; }
     void setID(const QUuid& id) { _id = id; }
@@ -73,6 +79,10 @@ public:
     bool isKnownID() const { return getID() != UNKNOWN_ENTITY_ID; }
     EntityItemID getEntityItemID() const { return EntityItemID(getID(), getCreatorTokenID(), getID() != UNKNOWN_ENTITY_ID); }
 
+    /// on a client, the entity server this entity was last received from
+    const QUuid& getSourceUUID() const { return _sourceUUID; }
+    void setSourceUUID(const QUuid& sourceUUID) { _sourceUUID = sourceUUID; }
+
     // methods for getting/setting all properties of an entity
     virtual EntityItemProperties getProperties() const;
     
@@ -97,8 +107,19 @@ public:
     void markAsChangedOnServer() {  _changedOnServer = usecTimestampNow();  }
     quint64 getLastChangedOnServer() const { return _changedOnServer; }
 
-    // TODO: eventually only include properties changed since the params.lastViewFrustumSent time
+    /// marks the entity changed on the server by an edit that set changedProperties, and remembers them so a client
+    /// holding an earlier version can be sent only what changed since
+    void markAsChangedOnServer(const EntityPropertyFlags& changedProperties);
+
+    /// the properties changed on the server since the given version, returns false when the entity doesn't remember
+    /// back that far and a client holding that version needs everything
+    bool getPropertiesChangedSince(quint64 changedOnServer, EntityPropertyFlags& changedProperties) const;
+
     virtual EntityPropertyFlags getEntityProperties(EncodeBitstreamParams& params) const;
+
+    /// the requested properties the receiving client is missing, all of them unless params.sentIndex knows the version
+    /// the client has and the entity remembers what changed since
+    EntityPropertyFlags getEntityPropertiesToSend(EncodeBitstreamParams& params) const;
         
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                                 EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const;
@@ -135,6 +156,9 @@ public:
     void simulate(const quint64& now);
     void simulateKinematicMotion(float timeElapsed);
 
+    /// takes the linear motion of an entity that was simulated outside of it, as simulate() would have left it
+    void setSimulatedMotion(const glm::vec3& position, const glm::vec3& velocity, quint64 lastSimulated);
+
     virtual bool needsToCallUpdate() const { return false; }
 
     virtual void debugDump() const;
@@ -150,7 +174,7 @@ public:
     glm::vec3 getPositionInMeters() const { return _position * (float) TREE_SCALE; } /// get position in meters
     
     /// set position in domain scale units (0.0 - 1.0)
-    void setPosition(const glm::vec3& value) { _position = value; recalculateCollisionShape(); }
+    void setPosition(const glm::vec3& value) { _position = value; recalculateCollisionShape(); updateSpatialIndex(); }
     void setPositionInMeters(const glm::vec3& value) /// set position in meter units (0.0 - TREE_SCALE)
             { setPosition(glm::clamp(value / (float) TREE_SCALE, 0.0f, 1.0f)); }
 
@@ -162,7 +186,8 @@ public:
     float getLargestDimension() const { return glm::length(_dimensions); } /// get the largest possible dimension
 
     /// set dimensions in domain scale units (0.0 - 1.0) this will also reset radius appropriately
-    virtual void setDimensions(const glm::vec3& value) { _dimensions = value; recalculateCollisionShape(); }
+    virtual void setDimensions(const glm::vec3& value)
+            { _dimensions = value; recalculateCollisionShape(); updateSpatialIndex(); }
 
     /// set dimensions in meter units (0.0 - TREE_SCALE) this will also reset radius appropriately
     void setDimensionsInMeters(const glm::vec3& value) { setDimensions(value / (float) TREE_SCALE); }
@@ -173,6 +198,16 @@ public:
     float getGlowLevel() const { return _glowLevel; }
     void setGlowLevel(float glowLevel) { _glowLevel = glowLevel; }
 
+    /// how far, in meters, the simulation owning this entity lets it stray from where its last update extrapolates to
+    /// before it sends another, entity types whose errors are easier or harder to notice override this
+    virtual float getMaxExtrapolationError() const { return DEFAULT_MAX_EXTRAPOLATION_ERROR; }
+
+    /// what is left, in domain scale units, of the offset between where the entity was drawn and where the last update
+    /// from the server put it, add it to the position when rendering so corrections blend in rather than pop
+    glm::vec3 getPositionCorrection(quint64 now) const;
+    glm::vec3 getPositionCorrectionInMeters() const { return getPositionCorrection(usecTimestampNow()) * (float)TREE_SCALE; }
+    bool isBlendingPositionCorrection() const;
+
     float getLocalRenderAlpha() const { return _localRenderAlpha; }
     void setLocalRenderAlpha(float localRenderAlpha) { _localRenderAlpha = localRenderAlpha; }
 
@@ -299,9 +334,13 @@ protected:
     virtual void initFromEntityItemID(const EntityItemID& entityItemID); // maybe useful to allow subclasses to init
     virtual void recalculateCollisionShape();
 
+    /// tells the tree's spatial index the position or dimensions changed, call after changing either
+    void updateSpatialIndex();
+
     EntityTypes::EntityType _type;
     QUuid _id;
     uint32_t _creatorTokenID;
+    QUuid _sourceUUID;
     bool _newlyCreated;
     quint64 _lastSimulated; // last time this entity called simulate(), this includes velocity, angular velocity, and physics changes
     quint64 _lastUpdated; // last time this entity called update(), this includes animations and non-physics changes
@@ -312,6 +351,19 @@ protected:
     quint64 _created;
     quint64 _changedOnServer;
 
+    glm::vec3 _positionCorrection; // domain scale units, fades out over POSITION_CORRECTION_BLEND_TIME
+    quint64 _positionCorrectionStart; // when the correction was made, 0 if there is none
+
+    // the last few edits made on the server, oldest first, and the version the oldest of them was made to
+    static const int MAX_SERVER_CHANGES = 4;
+    struct ServerChange {
+        quint64 changedOnServer;
+        EntityPropertyFlags changedProperties;
+    };
+    ServerChange _serverChanges[MAX_SERVER_CHANGES];
+    int _numberOfServerChanges = 0;
+    quint64 _serverChangesSince = 0;
+
     glm::vec3 _position;
     glm::vec3 _dimensions;
     glm::quat _rotation;
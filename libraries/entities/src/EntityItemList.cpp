@@ -0,0 +1,89 @@
+//
+//  EntityItemList.cpp
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "EntityItem.h"
+
+#include "EntityItemList.h"
+
+EntityItemList::EntityItemList() :
+    _entities(_inlineEntities),
+    _bounds(_inlineBounds),
+    _size(0),
+    _capacity(INLINE_CAPACITY)
+{
+
+}
+
+EntityItemList::~EntityItemList() {
+    if (_entities != _inlineEntities) {
+        delete[] _entities;
+        delete[] _bounds;
+    }
+}
+
+int EntityItemList::indexOf(const EntityItem* entity) const {
+    for (int i = 0; i < _size; i++) {
+        if (_entities[i] == entity) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void EntityItemList::append(EntityItem* entity) {
+    if (_size == _capacity) {
+        grow();
+    }
+    _entities[_size] = entity;
+    updateBoundsAt(_size++);
+}
+
+void EntityItemList::removeAt(int index) {
+    // keep the order, the entities of an element are encoded in it
+    std::copy(_entities + index + 1, _entities + _size, _entities + index);
+    std::copy(_bounds + index + 1, _bounds + _size, _bounds + index);
+    _size--;
+}
+
+bool EntityItemList::removeOne(const EntityItem* entity) {
+    int index = indexOf(entity);
+    if (index == -1) {
+        return false;
+    }
+    removeAt(index);
+    return true;
+}
+
+void EntityItemList::clear() {
+    _size = 0;
+}
+
+void EntityItemList::updateBoundsAt(int index) {
+    const EntityItem* entity = _entities[index];
+    _bounds[index] = glm::vec4(entity->getPosition(), entity->getRadius());
+}
+
+void EntityItemList::grow() {
+    int newCapacity = _capacity * 2;
+    EntityItem** newEntities = new EntityItem*[newCapacity];
+    glm::vec4* newBounds = new glm::vec4[newCapacity];
+    std::copy(_entities, _entities + _size, newEntities);
+    std::copy(_bounds, _bounds + _size, newBounds);
+
+    if (_entities != _inlineEntities) {
+        delete[] _entities;
+        delete[] _bounds;
+    }
+    _entities = newEntities;
+    _bounds = newBounds;
+    _capacity = newCapacity;
+}
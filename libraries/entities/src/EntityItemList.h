@@ -0,0 +1,65 @@
+//
+//  EntityItemList.h
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityItemList_h
+#define hifi_EntityItemList_h
+
+#include <QtGlobal>
+
+#include <glm/glm.hpp>
+
+class EntityItem;
+
+/// The entities of an element. The few most elements hold are kept inline, with no allocation of their own, and next to
+/// the entities is an array of their bounding spheres so spatial queries scan those without touching the entities.
+/// The bounds are in tree units, xyz the entity's position and w its radius, and are refreshed through updateBoundsAt()
+/// whenever an entity's position or dimensions change.
+class EntityItemList {
+public:
+    EntityItemList();
+    ~EntityItemList();
+
+    int size() const { return _size; }
+    bool isEmpty() const { return _size == 0; }
+
+    EntityItem* at(int index) const { return _entities[index]; }
+    EntityItem* operator[](int index) const { return _entities[index]; }
+    const glm::vec4& boundsAt(int index) const { return _bounds[index]; }
+
+    EntityItem* const* begin() const { return _entities; }
+    EntityItem* const* end() const { return _entities + _size; }
+
+    /// returns -1 if the entity isn't in the list
+    int indexOf(const EntityItem* entity) const;
+
+    void append(EntityItem* entity);
+    void removeAt(int index);
+    bool removeOne(const EntityItem* entity);
+    void clear();
+
+    void updateBoundsAt(int index);
+
+private:
+    Q_DISABLE_COPY(EntityItemList)
+
+    void grow();
+
+    static const int INLINE_CAPACITY = 4;
+
+    EntityItem** _entities;
+    glm::vec4* _bounds;
+    int _size;
+    int _capacity;
+
+    EntityItem* _inlineEntities[INLINE_CAPACITY];
+    glm::vec4 _inlineBounds[INLINE_CAPACITY];
+};
+
+#endif // hifi_EntityItemList_h
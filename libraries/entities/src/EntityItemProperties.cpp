@@ -15,6 +15,7 @@
 
 #include <ByteCountCoding.h>
 #include <GLMHelpers.h>
+#include <JurisdictionMap.h>
 #include <RegisteredMetaTypes.h>
 
 #include "EntityItem.h"
@@ -214,14 +215,16 @@ EntityPropertyFlags EntityItemProperties::getChangedProperties() const {
     return changedProperties;
 }
 
-QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine) const {
+QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine,
+        const QSet<QString>* desiredProperties) const {
     QScriptValue properties = engine->newObject();
 
+    // the identity always comes along, so that a sparse copy can still be told apart from an unknown entity
     if (_idSet) {
-        COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(id, _id.toString());
-        COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(isKnownID, (_id != UNKNOWN_ENTITY_ID));
+        properties.setProperty("id", _id.toString());
+        properties.setProperty("isKnownID", (_id != UNKNOWN_ENTITY_ID));
     } else {
-        COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(isKnownID, false);
+        properties.setProperty("isKnownID", false);
     }
 
     COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(type, EntityTypes::getEntityTypeName(_type));
@@ -270,31 +273,34 @@ QScriptValue EntityItemProperties::copyToScriptValue(QScriptEngine* engine) cons
     COPY_PROPERTY_TO_QSCRIPTVALUE_COLOR_GETTER(backgroundColor, getBackgroundColor());
 
     // Sitting properties support
-    QScriptValue sittingPoints = engine->newObject();
-    for (int i = 0; i < _sittingPoints.size(); ++i) {
-        QScriptValue sittingPoint = engine->newObject();
-        sittingPoint.setProperty("name", _sittingPoints.at(i).name);
-        sittingPoint.setProperty("position", vec3toScriptValue(engine, _sittingPoints.at(i).position));
-        sittingPoint.setProperty("rotation", quatToScriptValue(engine, _sittingPoints.at(i).rotation));
-        sittingPoints.setProperty(i, sittingPoint);
+    if (IS_DESIRED_PROPERTY(sittingPoints)) {
+        QScriptValue sittingPoints = engine->newObject();
+        for (int i = 0; i < _sittingPoints.size(); ++i) {
+            QScriptValue sittingPoint = engine->newObject();
+            sittingPoint.setProperty("name", _sittingPoints.at(i).name);
+            sittingPoint.setProperty("position", vec3toScriptValue(engine, _sittingPoints.at(i).position));
+            sittingPoint.setProperty("rotation", quatToScriptValue(engine, _sittingPoints.at(i).rotation));
+            sittingPoints.setProperty(i, sittingPoint);
+        }
+        sittingPoints.setProperty("length", _sittingPoints.size());
+        properties.setProperty("sittingPoints", sittingPoints); // gettable, but not settable
+    }
+
+    if (IS_DESIRED_PROPERTY(boundingBox)) {
+        AABox aaBox = getAABoxInMeters();
+        QScriptValue boundingBox = engine->newObject();
+        QScriptValue bottomRightNear = vec3toScriptValue(engine, aaBox.getCorner());
+        QScriptValue topFarLeft = vec3toScriptValue(engine, aaBox.calcTopFarLeft());
+        QScriptValue center = vec3toScriptValue(engine, aaBox.calcCenter());
+        QScriptValue boundingBoxDimensions = vec3toScriptValue(engine, aaBox.getDimensions());
+        boundingBox.setProperty("brn", bottomRightNear);
+        boundingBox.setProperty("tfl", topFarLeft);
+        boundingBox.setProperty("center", center);
+        boundingBox.setProperty("dimensions", boundingBoxDimensions);
+        properties.setProperty("boundingBox", boundingBox); // gettable, but not settable
     }
-    sittingPoints.setProperty("length", _sittingPoints.size());
-    COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(sittingPoints, sittingPoints); // gettable, but not settable
-
-    AABox aaBox = getAABoxInMeters();
-    QScriptValue boundingBox = engine->newObject();
-    QScriptValue bottomRightNear = vec3toScriptValue(engine, aaBox.getCorner());
-    QScriptValue topFarLeft = vec3toScriptValue(engine, aaBox.calcTopFarLeft());
-    QScriptValue center = vec3toScriptValue(engine, aaBox.calcCenter());
-    QScriptValue boundingBoxDimensions = vec3toScriptValue(engine, aaBox.getDimensions());
-    boundingBox.setProperty("brn", bottomRightNear);
-    boundingBox.setProperty("tfl", topFarLeft);
-    boundingBox.setProperty("center", center);
-    boundingBox.setProperty("dimensions", boundingBoxDimensions);
-    COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(boundingBox, boundingBox); // gettable, but not settable
-
-    QString textureNamesList = _textureNames.join(",\n");
-    COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(originalTextures, textureNamesList); // gettable, but not settable
+
+    COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(originalTextures, _textureNames.join(",\n")); // gettable, but not settable
 
     return properties;
 }
@@ -383,15 +389,12 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
     OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
     sizeOut = 0;
 
-    // TODO: We need to review how jurisdictions should be handled for entities. (The old Models and Particles code
-    // didn't do anything special for jurisdictions, so we're keeping that same behavior here.)
-    //
-    // Always include the root octcode. This is only because the OctreeEditPacketSender will check these octcodes
-    // to determine which server to send the changes to in the case of multiple jurisdictions. The root will be sent
-    // to all servers.
-    glm::vec3 rootPosition(0);
-    float rootScale = 0.5f;
-    unsigned char* octcode = pointToOctalCode(rootPosition.x, rootPosition.y, rootPosition.z, rootScale);
+    // The OctreeEditPacketSender checks these octcodes to determine which server to send the changes to in the case
+    // of multiple jurisdictions. An edit that moves the entity goes to the server owning where it moves to, any other
+    // edit carries the root octcode, which is sent to all servers and applied by the one that has the entity.
+    unsigned char* octcode = properties.containsPositionChange()
+        ? JurisdictionMap::octalCodeForPoint(properties.getPosition() / (float)TREE_SCALE)
+        : pointToOctalCode(0.0f, 0.0f, 0.0f, 1.0f);
 
     success = packetData->startSubTree(octcode);
     delete[] octcode;
@@ -408,22 +411,25 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
 
         // encode our ID as a byte count coded byte stream
         ByteCountCoded<quint32> tokenCoder;
-        QByteArray encodedToken;
+        unsigned char encodedToken[ByteCountCoded<quint32>::MAX_ENCODED_BYTES];
+        int encodedTokenLength = 0;
 
         // special case for handling "new" modelItems
         if (isNewEntityItem) {
             // encode our creator token as a byte count coded byte stream
             tokenCoder = id.creatorTokenID;
-            encodedToken = tokenCoder;
+            encodedTokenLength = tokenCoder.encode(encodedToken);
         }
 
         // encode our type as a byte count coded byte stream
         ByteCountCoded<quint32> typeCoder = (quint32)properties.getType();
-        QByteArray encodedType = typeCoder;
+        unsigned char encodedType[ByteCountCoded<quint32>::MAX_ENCODED_BYTES];
+        int encodedTypeLength = typeCoder.encode(encodedType);
 
         quint64 updateDelta = 0; // this is an edit so by definition, it's update is in sync
         ByteCountCoded<quint64> updateDeltaCoder = updateDelta;
-        QByteArray encodedUpdateDelta = updateDeltaCoder;
+        unsigned char encodedUpdateDelta[ByteCountCoded<quint64>::MAX_ENCODED_BYTES];
+        int encodedUpdateDeltaLength = updateDeltaCoder.encode(encodedUpdateDelta);
 
         EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
         EntityPropertyFlags requestedProperties = properties.getChangedProperties();
@@ -446,21 +452,21 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
 
         bool successIDFits = packetData->appendValue(encodedID);
         if (isNewEntityItem && successIDFits) {
-            successIDFits = packetData->appendValue(encodedToken);
+            successIDFits = packetData->appendRawData(encodedToken, encodedTokenLength);
         }
-        bool successTypeFits = packetData->appendValue(encodedType);
+        bool successTypeFits = packetData->appendRawData(encodedType, encodedTypeLength);
 
         // NOTE: We intentionally do not send "created" times in edit messages. This is because:
         //   1) if the edit is to an existing entity, the created time can not be changed
         //   2) if the edit is to a new entity, the created time is the last edited time
 
         // TODO: Should we get rid of this in this in edit packets, since this has to always be 0?
-        bool successLastUpdatedFits = packetData->appendValue(encodedUpdateDelta);
+        bool successLastUpdatedFits = packetData->appendRawData(encodedUpdateDelta, encodedUpdateDeltaLength);
     
         int propertyFlagsOffset = packetData->getUncompressedByteOffset();
-        QByteArray encodedPropertyFlags = propertyFlags;
-        int oldPropertyFlagsLength = encodedPropertyFlags.length();
-        bool successPropertyFlagsFits = packetData->appendValue(encodedPropertyFlags);
+        unsigned char encodedPropertyFlags[EntityPropertyFlags::MAX_ENCODED_BYTES];
+        int oldPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags);
+        bool successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags, oldPropertyFlagsLength);
         int propertyCount = 0;
 
         bool headerFits = successIDFits && successTypeFits && successLastEditedFits
@@ -527,10 +533,8 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
         if (propertyCount > 0) {
             int endOfEntityItemData = packetData->getUncompressedByteOffset();
         
-            encodedPropertyFlags = propertyFlags;
-            int newPropertyFlagsLength = encodedPropertyFlags.length();
-            packetData->updatePriorBytes(propertyFlagsOffset, 
-                    (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+            int newPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags);
+            packetData->updatePriorBytes(propertyFlagsOffset, encodedPropertyFlags, newPropertyFlagsLength);
         
             // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
             if (newPropertyFlagsLength < oldPropertyFlagsLength) {
@@ -631,10 +635,9 @@ bool EntityItemProperties::decodeEntityEditPacket(const unsigned char* data, int
     //   2) if the edit is to a new entity, the created time is the last edited time
 
     // encoded id
-    QByteArray encodedID((const char*)dataAt, NUM_BYTES_RFC4122_UUID); // maximum possible size
-    QUuid editID = QUuid::fromRfc4122(encodedID);
-    dataAt += encodedID.size();
-    processedBytes += encodedID.size();
+    QUuid editID = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)dataAt, NUM_BYTES_RFC4122_UUID));
+    dataAt += NUM_BYTES_RFC4122_UUID;
+    processedBytes += NUM_BYTES_RFC4122_UUID;
 
     bool isNewEntityItem = (editID == NEW_ENTITY);
 
@@ -642,12 +645,11 @@ bool EntityItemProperties::decodeEntityEditPacket(const unsigned char* data, int
         // If this is a NEW_ENTITY, then we assume that there's an additional uint32_t creatorToken, that
         // we want to send back to the creator as an map to the actual id
 
-        QByteArray encodedToken((const char*)dataAt, (bytesToRead - processedBytes));
-        ByteCountCoded<quint32> tokenCoder = encodedToken;
+        ByteCountCoded<quint32> tokenCoder;
+        int encodedTokenLength = tokenCoder.decode(dataAt, bytesToRead - processedBytes);
         quint32 creatorTokenID = tokenCoder;
-        encodedToken = tokenCoder; // determine true bytesToRead
-        dataAt += encodedToken.size();
-        processedBytes += encodedToken.size();
+        dataAt += encodedTokenLength;
+        processedBytes += encodedTokenLength;
 
         //newEntityItem.setCreatorTokenID(creatorTokenID);
         //newEntityItem._newlyCreated = true;
@@ -668,34 +670,32 @@ bool EntityItemProperties::decodeEntityEditPacket(const unsigned char* data, int
     }
 
     // Entity Type...
-    QByteArray encodedType((const char*)dataAt, (bytesToRead - processedBytes));
-    ByteCountCoded<quint32> typeCoder = encodedType;
+    ByteCountCoded<quint32> typeCoder;
+    int encodedTypeLength = typeCoder.decode(dataAt, bytesToRead - processedBytes);
     quint32 entityTypeCode = typeCoder;
     properties.setType((EntityTypes::EntityType)entityTypeCode);
-    encodedType = typeCoder; // determine true bytesToRead
-    dataAt += encodedType.size();
-    processedBytes += encodedType.size();
+    dataAt += encodedTypeLength;
+    processedBytes += encodedTypeLength;
 
     // Update Delta - when was this item updated relative to last edit... this really should be 0
     // TODO: Should we get rid of this in this in edit packets, since this has to always be 0?
     // TODO: do properties need to handle lastupdated???
 
     // last updated is stored as ByteCountCoded delta from lastEdited
-    QByteArray encodedUpdateDelta((const char*)dataAt, (bytesToRead - processedBytes));
-    ByteCountCoded<quint64> updateDeltaCoder = encodedUpdateDelta;
-    encodedUpdateDelta = updateDeltaCoder; // determine true bytesToRead
-    dataAt += encodedUpdateDelta.size();
-    processedBytes += encodedUpdateDelta.size();
+    ByteCountCoded<quint64> updateDeltaCoder;
+    int encodedUpdateDeltaLength = updateDeltaCoder.decode(dataAt, bytesToRead - processedBytes);
+    dataAt += encodedUpdateDeltaLength;
+    processedBytes += encodedUpdateDeltaLength;
 
     // TODO: Do we need this lastUpdated?? We don't seem to use it.
     //quint64 updateDelta = updateDeltaCoder;
     //quint64 lastUpdated = lastEdited + updateDelta; // don't adjust for clock skew since we already did that for lastEdited
     
     // Property Flags...
-    QByteArray encodedPropertyFlags((const char*)dataAt, (bytesToRead - processedBytes));
-    EntityPropertyFlags propertyFlags = encodedPropertyFlags;
-    dataAt += propertyFlags.getEncodedLength();
-    processedBytes += propertyFlags.getEncodedLength();
+    EntityPropertyFlags propertyFlags;
+    int encodedPropertyFlagsLength = propertyFlags.decode(dataAt, bytesToRead - processedBytes);
+    dataAt += encodedPropertyFlagsLength;
+    processedBytes += encodedPropertyFlagsLength;
 
     READ_ENTITY_PROPERTY_TO_PROPERTIES(PROP_POSITION, glm::vec3, setPosition);
     READ_ENTITY_PROPERTY_TO_PROPERTIES(PROP_DIMENSIONS, glm::vec3, setDimensions);  // NOTE: PROP_RADIUS obsolete
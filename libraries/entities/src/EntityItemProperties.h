@@ -19,6 +19,7 @@
 
 #include <QtScript/QScriptEngine>
 #include <QtCore/QObject>
+#include <QSet>
 #include <QVector>
 #include <QString>
 
@@ -93,7 +94,8 @@ enum EntityPropertyList {
     PROP_BACKGROUND_COLOR = PROP_ANIMATION_FPS,
 };
 
-typedef PropertyFlags<EntityPropertyList> EntityPropertyFlags;
+// sized by the last property, so that the flags fit in the one word
+typedef PropertyFlags<EntityPropertyList, PROP_LAST_ITEM + 1> EntityPropertyFlags;
 
 const quint64 UNKNOWN_CREATED_TIME = 0;
 
@@ -115,7 +117,8 @@ public:
     EntityTypes::EntityType getType() const { return _type; }
     void setType(EntityTypes::EntityType type) { _type = type; }
 
-    virtual QScriptValue copyToScriptValue(QScriptEngine* engine) const;
+    /// \param desiredProperties the names of the properties to convert, or null for all of them
+    virtual QScriptValue copyToScriptValue(QScriptEngine* engine, const QSet<QString>* desiredProperties = NULL) const;
     virtual void copyFromScriptValue(const QScriptValue& object);
 
     // editing related features supported by all entities
@@ -243,6 +246,7 @@ private:
     glm::vec3 _naturalDimensions;
 };
 Q_DECLARE_METATYPE(EntityItemProperties);
+Q_DECLARE_METATYPE(QVector<EntityItemProperties>);
 QScriptValue EntityItemPropertiesToScriptValue(QScriptEngine* engine, const EntityItemProperties& properties);
 void EntityItemPropertiesFromScriptValue(const QScriptValue &object, EntityItemProperties& properties);
 
@@ -74,18 +74,19 @@
             }                                                               \
         }
 
-#define READ_ENTITY_PROPERTY_STRING(P,O)                \
-        if (propertyFlags.getHasProperty(P)) {          \
-            uint16_t length;                            \
-            memcpy(&length, dataAt, sizeof(length));    \
-            dataAt += sizeof(length);                   \
-            bytesRead += sizeof(length);                \
-            QString value((const char*)dataAt);         \
-            dataAt += length;                           \
-            bytesRead += length;                        \
-            if (overwriteLocalData) {                   \
-                O(value);                               \
-            }                                           \
+#define READ_ENTITY_PROPERTY_STRING(P,O)                                       \
+        if (propertyFlags.getHasProperty(P)) {                                 \
+            uint16_t length;                                                   \
+            memcpy(&length, dataAt, sizeof(length));                           \
+            dataAt += sizeof(length);                                          \
+            bytesRead += sizeof(length);                                       \
+            const char* chars = (const char*)dataAt;                           \
+            QString value = QString::fromUtf8(chars, qstrnlen(chars, length)); \
+            dataAt += length;                                                  \
+            bytesRead += length;                                               \
+            if (overwriteLocalData) {                                          \
+                O(value);                                                      \
+            }                                                                  \
         }
 
 #define READ_ENTITY_PROPERTY_COLOR(P,M)         \
@@ -115,16 +116,17 @@
             properties.O(fromBuffer);                                       \
         }
 
-#define READ_ENTITY_PROPERTY_STRING_TO_PROPERTIES(P,O)  \
-        if (propertyFlags.getHasProperty(P)) {          \
-            uint16_t length;                            \
-            memcpy(&length, dataAt, sizeof(length));    \
-            dataAt += sizeof(length);                   \
-            processedBytes += sizeof(length);           \
-            QString value((const char*)dataAt);         \
-            dataAt += length;                           \
-            processedBytes += length;                   \
-            properties.O(value);                        \
+#define READ_ENTITY_PROPERTY_STRING_TO_PROPERTIES(P,O)                         \
+        if (propertyFlags.getHasProperty(P)) {                                 \
+            uint16_t length;                                                   \
+            memcpy(&length, dataAt, sizeof(length));                           \
+            dataAt += sizeof(length);                                          \
+            processedBytes += sizeof(length);                                  \
+            const char* chars = (const char*)dataAt;                           \
+            QString value = QString::fromUtf8(chars, qstrnlen(chars, length)); \
+            dataAt += length;                                                  \
+            processedBytes += length;                                          \
+            properties.O(value);                                               \
         }
 
 #define READ_ENTITY_PROPERTY_COLOR_TO_PROPERTIES(P,O)   \
@@ -158,27 +160,43 @@
     }
 
 
+// a null desiredProperties set asks for every property
+#define IS_DESIRED_PROPERTY(P) \
+    (!desiredProperties || desiredProperties->contains(QStringLiteral(#P)))
+
 #define COPY_PROPERTY_TO_QSCRIPTVALUE_VEC3(P) \
-    QScriptValue P = vec3toScriptValue(engine, _##P); \
-    properties.setProperty(#P, P);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        QScriptValue P = vec3toScriptValue(engine, _##P); \
+        properties.setProperty(#P, P); \
+    }
 
 #define COPY_PROPERTY_TO_QSCRIPTVALUE_QUAT(P) \
-    QScriptValue P = quatToScriptValue(engine, _##P); \
-    properties.setProperty(#P, P);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        QScriptValue P = quatToScriptValue(engine, _##P); \
+        properties.setProperty(#P, P); \
+    }
 
 #define COPY_PROPERTY_TO_QSCRIPTVALUE_COLOR(P) \
-    QScriptValue P = xColorToScriptValue(engine, _##P); \
-    properties.setProperty(#P, P);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        QScriptValue P = xColorToScriptValue(engine, _##P); \
+        properties.setProperty(#P, P); \
+    }
 
 #define COPY_PROPERTY_TO_QSCRIPTVALUE_COLOR_GETTER(P,G) \
-    QScriptValue P = xColorToScriptValue(engine, G); \
-    properties.setProperty(#P, P);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        QScriptValue P = xColorToScriptValue(engine, G); \
+        properties.setProperty(#P, P); \
+    }
 
 #define COPY_PROPERTY_TO_QSCRIPTVALUE_GETTER(P, G) \
-    properties.setProperty(#P, G);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        properties.setProperty(#P, G); \
+    }
 
 #define COPY_PROPERTY_TO_QSCRIPTVALUE(P) \
-    properties.setProperty(#P, _##P);
+    if (IS_DESIRED_PROPERTY(P)) { \
+        properties.setProperty(#P, _##P); \
+    }
 
 #define COPY_PROPERTY_FROM_QSCRIPTVALUE_FLOAT(P, S) \
     QScriptValue P = object.property(#P);           \
@@ -74,33 +74,92 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(EntityItemID
     EntityItemID identity = identifyEntity(entityID);
     if (_entityTree) {
         _entityTree->lockForRead();
-        EntityItem* entity = const_cast<EntityItem*>(_entityTree->findEntityByEntityItemID(identity));
-        
-        if (entity) {
-            results = entity->getProperties();
-
-            // TODO: improve sitting points and naturalDimensions in the future, 
-            //       for now we've included the old sitting points model behavior for entity types that are models
-            //        we've also added this hack for setting natural dimensions of models
-            if (entity->getType() == EntityTypes::Model) {
-                const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
-                if (geometry) {
-                    results.setSittingPoints(geometry->sittingPoints);
-                    Extents meshExtents = geometry->getUnscaledMeshExtents();
-                    results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
-                }
-            }
+        results = getEntityPropertiesWorker(identity);
+        _entityTree->unlock();
+    }
+    
+    return results;
+}
 
-        } else {
-            results.setIsUnknownID();
+QScriptValue EntityScriptingInterface::getEntitiesProperties(const QVector<EntityItemID>& entityIDs,
+        const QStringList& propertyNames) {
+    QScriptValue results = engine()->newArray(entityIDs.size());
+    QSet<QString> desiredProperties = QSet<QString>::fromList(propertyNames);
+    if (_entityTree) {
+        _entityTree->lockForRead();
+    }
+    for (int i = 0; i < entityIDs.size(); i++) {
+        EntityItemProperties properties;
+        if (_entityTree) {
+            properties = getEntityPropertiesWorker(identifyEntity(entityIDs.at(i)));
         }
+        results.setProperty(i, properties.copyToScriptValue(engine(), &desiredProperties));
+    }
+    if (_entityTree) {
         _entityTree->unlock();
     }
+    return results;
+}
+
+EntityItemProperties EntityScriptingInterface::getEntityPropertiesWorker(const EntityItemID& identity) {
+    EntityItemProperties results;
+    EntityItem* entity = const_cast<EntityItem*>(_entityTree->findEntityByEntityItemID(identity));
     
+    if (entity) {
+        results = entity->getProperties();
+
+        // TODO: improve sitting points and naturalDimensions in the future, 
+        //       for now we've included the old sitting points model behavior for entity types that are models
+        //        we've also added this hack for setting natural dimensions of models
+        if (entity->getType() == EntityTypes::Model) {
+            const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
+            if (geometry) {
+                results.setSittingPoints(geometry->sittingPoints);
+                Extents meshExtents = geometry->getUnscaledMeshExtents();
+                results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
+            }
+        }
+
+    } else {
+        results.setIsUnknownID();
+    }
     return results;
 }
 
 EntityItemID EntityScriptingInterface::editEntity(EntityItemID entityID, const EntityItemProperties& properties) {
+    if (_entityTree) {
+        _entityTree->lockForWrite();
+    }
+    EntityItemID result = editEntityWorker(entityID, properties, canAdjustLocks());
+    if (_entityTree) {
+        _entityTree->unlock();
+    }
+    return result;
+}
+
+QVector<EntityItemID> EntityScriptingInterface::editEntities(const QVector<EntityItemID>& entityIDs,
+        const QVector<EntityItemProperties>& properties) {
+    QVector<EntityItemID> results = entityIDs;
+    if (properties.size() != 1 && properties.size() != entityIDs.size()) {
+        qDebug() << "EntityScriptingInterface::editEntities called with" << entityIDs.size() << "entities and"
+            << properties.size() << "sets of properties.";
+        return results;
+    }
+    bool canAdjust = canAdjustLocks();
+    if (_entityTree) {
+        _entityTree->lockForWrite();
+    }
+    for (int i = 0; i < results.size(); i++) {
+        results[i] = editEntityWorker(results.at(i), properties.at(properties.size() == 1 ? 0 : i), canAdjust);
+    }
+    if (_entityTree) {
+        _entityTree->unlock();
+    }
+    return results;
+}
+
+EntityItemID EntityScriptingInterface::editEntityWorker(EntityItemID entityID,
+        const EntityItemProperties& properties, bool canAdjustLocks) {
     EntityItemID actualID = entityID;
     // if the entity is unknown, attempt to look it up
     if (!entityID.isKnownID) {
@@ -114,15 +173,13 @@ EntityItemID EntityScriptingInterface::editEntity(EntityItemID entityID, const E
     // If we have a local entity tree set, then also update it. We can do this even if we don't know
     // the actual id, because we can edit out local entities just with creatorTokenID
     if (_entityTree) {
-        _entityTree->lockForWrite();
-        _entityTree->updateEntity(entityID, properties, canAdjustLocks());
-        _entityTree->unlock();
+        _entityTree->updateEntity(entityID, properties, canAdjustLocks);
     }
 
     // if at this point, we know the id, send the update to the entity server
     if (entityID.isKnownID) {
         // make sure the properties has a type, so that the encode can know which properties to include
-        if (properties.getType() == EntityTypes::Unknown) {
+        if (properties.getType() == EntityTypes::Unknown && _entityTree) {
             EntityItem* entity = _entityTree->findEntityByEntityItemID(entityID);
             if (entity) {
                 EntityItemProperties tempProperties = properties;
@@ -261,6 +318,16 @@ bool EntityScriptingInterface::getSendPhysicsUpdates() const {
     return EntityItem::getSendPhysicsUpdates();
 }
 
+void EntityScriptingInterface::relayEntityCollisions(const EntityCollisions& collisions) {
+    // most of the time no script is connected, and then a busy scene shouldn't pay for a signal per collision
+    if (receivers(SIGNAL(entityCollisionWithEntity(const EntityItemID&, const EntityItemID&, const Collision&))) == 0) {
+        return;
+    }
+    foreach (const EntityCollision& collision, collisions) {
+        emit entityCollisionWithEntity(collision.idA, collision.idB, collision.collision);
+    }
+}
+
 
 RayToEntityIntersectionResult::RayToEntityIntersectionResult() : 
     intersects(false), 
@@ -15,12 +15,15 @@
 #define hifi_EntityScriptingInterface_h
 
 #include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtScript/QScriptable>
 
 #include <CollisionInfo.h>
 #include <Octree.h>
 #include <OctreeScriptingInterface.h>
 #include <RegisteredMetaTypes.h>
 
+#include "EntityCollision.h"
 #include "EntityEditPacketSender.h"
 
 
@@ -48,7 +51,7 @@ void RayToEntityIntersectionResultFromScriptValue(const QScriptValue& object, Ra
 
 
 /// handles scripting of Entity commands from JS passed to assigned clients
-class EntityScriptingInterface : public OctreeScriptingInterface {
+class EntityScriptingInterface : public OctreeScriptingInterface, protected QScriptable {
     Q_OBJECT
 public:
     EntityScriptingInterface();
@@ -59,6 +62,9 @@ public:
 
     void setEntityTree(EntityTree* modelTree) { _entityTree = modelTree; }
     EntityTree* getEntityTree(EntityTree*) { return _entityTree; }
+
+    /// emits entityCollisionWithEntity() for each of a frame's collisions, if any script is listening for them
+    void relayEntityCollisions(const EntityCollisions& collisions);
     
 public slots:
 
@@ -75,10 +81,20 @@ public slots:
     /// this function will not find return results in script engine contexts which don't have access to models
     Q_INVOKABLE EntityItemProperties getEntityProperties(EntityItemID entityID);
 
+    /// gets only the named properties of each of the entities, which is much cheaper than getting them all when
+    /// scripts want a few properties of many entities; an unknown entity gives an object whose isKnownID is false
+    Q_INVOKABLE QScriptValue getEntitiesProperties(const QVector<EntityItemID>& entityIDs,
+        const QStringList& propertyNames);
+
     /// edits a model updating only the included properties, will return the identified EntityItemID in case of
     /// successful edit, if the input entityID is for an unknown model this function will have no effect
     Q_INVOKABLE EntityItemID editEntity(EntityItemID entityID, const EntityItemProperties& properties);
 
+    /// edits many models under one lock of the tree, giving each the properties at its index, or all of them the
+    /// same properties if only one set is given; returns the identified EntityItemIDs
+    Q_INVOKABLE QVector<EntityItemID> editEntities(const QVector<EntityItemID>& entityIDs,
+        const QVector<EntityItemProperties>& properties);
+
     /// deletes a model
     Q_INVOKABLE void deleteEntity(EntityItemID entityID);
 
@@ -129,6 +145,12 @@ signals:
 private:
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
 
+    /// gets the properties of an identified entity; the tree must be locked for reading
+    EntityItemProperties getEntityPropertiesWorker(const EntityItemID& identity);
+
+    /// edits an entity and queues its edit message; the tree, if any, must be locked for writing
+    EntityItemID editEntityWorker(EntityItemID entityID, const EntityItemProperties& properties, bool canAdjustLocks);
+
     /// actually does the work of finding the ray intersection, can be called in locking mode or tryLock mode
     RayToEntityIntersectionResult findRayIntersectionWorker(const PickRay& ray, Octree::lockType lockType, 
                                                                         bool precisionPicking);
@@ -66,7 +66,8 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
 
 // private
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
-    PerformanceTimer perfTimer("updatingEntities");
+    PERFORMANCE_TIMER("updatingEntities");
+    QVector<EntityItem*> changedEntities;
     QSet<EntityItem*>::iterator itemItr = _updateableEntities.begin();
     while (itemItr != _updateableEntities.end()) {
         EntityItem* entity = *itemItr;
@@ -75,18 +76,29 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
         if (!entity->needsToCallUpdate()) {
             itemItr = _updateableEntities.erase(itemItr);
         } else {
+            uint32_t dirtyFlags = entity->getDirtyFlags();
             entity->update(now);
+            if (entity->getDirtyFlags() != dirtyFlags) {
+                changedEntities.push_back(entity);
+            }
             ++itemItr;
         }
     }
+
+    // an entity can change itself in update(), e.g. a model whose collision shape just finished building, which
+    // is relayed once we're done going through _updateableEntities since entityChanged() may add or remove from it
+    foreach (EntityItem* entity, changedEntities) {
+        entityChanged(entity);
+    }
 }
 
 // private
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
-    PerformanceTimer perfTimer("sortingEntities");
+    PERFORMANCE_TIMER("sortingEntities");
     MovingEntitiesOperator moveOperator(_entityTree);
+    moveOperator.reserve(_entitiesToBeSorted.size());
     AACube domainBounds(glm::vec3(0.0f,0.0f,0.0f), 1.0f);
     QSet<EntityItem*>::iterator itemItr = _entitiesToBeSorted.begin();
     while (itemItr != _entitiesToBeSorted.end()) {
@@ -105,8 +117,8 @@ void EntitySimulation::sortEntitiesThatMoved() {
         ++itemItr;
     }
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
-        _entityTree->recurseTreeWithOperator(&moveOperator);
+        PERFORMANCE_TIMER("moveEntities");
+        moveOperator.moveEntities();
     }
 
     sortEntitiesThatMovedInternal();
@@ -17,6 +17,7 @@
 
 #include <PerfStat.h>
 
+#include "EntityCollision.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
 
@@ -64,7 +65,8 @@ public:
     EntityTree* getEntityTree() { return _entityTree; }
 
 signals:
-    void entityCollisionWithEntity(const EntityItemID& idA, const EntityItemID& idB, const Collision& collision);
+    /// all the collisions of a frame at once
+    void entityCollisions(const EntityCollisions& collisions);
 
 protected:
 
@@ -0,0 +1,289 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <float.h>
+
+#include "EntityItem.h"
+
+#include "EntitySpatialIndex.h"
+
+// 64 meter cells, an entity with a radius bigger than that goes in the large entities
+static const int CELLS_PER_AXIS = 256;
+static const float CELL_SCALE = 1.0f / CELLS_PER_AXIS;
+static const int LARGE_ENTITIES_CELL = -1;
+static const int CELL_KEY_BITS = 10;
+
+quint32 EntitySpatialIndex::keyFor(int x, int y, int z) {
+    return (quint32)x | ((quint32)y << CELL_KEY_BITS) | ((quint32)z << (2 * CELL_KEY_BITS));
+}
+
+static int cellCoordinate(float value) {
+    return glm::clamp((int)(value * CELLS_PER_AXIS), 0, CELLS_PER_AXIS - 1);
+}
+
+int EntitySpatialIndex::cellFor(const glm::vec3& position, float radius) {
+    if (radius > CELL_SCALE) {
+        return LARGE_ENTITIES_CELL;
+    }
+
+    int x = cellCoordinate(position.x);
+    int y = cellCoordinate(position.y);
+    int z = cellCoordinate(position.z);
+    quint32 key = keyFor(x, y, z);
+
+    QHash<quint32, int>::const_iterator existing = _cellIndexes.constFind(key);
+    if (existing != _cellIndexes.constEnd()) {
+        return existing.value();
+    }
+
+    // cells are never freed, an emptied one just waits for the next entity to come along
+    Cell cell;
+    cell.corner = glm::vec3(x, y, z) * CELL_SCALE;
+    _cells.append(cell);
+    _cellIndexes.insert(key, _cells.size() - 1);
+    return _cells.size() - 1;
+}
+
+void EntitySpatialIndex::addToCell(int cellIndex, EntityItem* entity, const glm::vec3& position, float radius) {
+    Cell& cell = cellAt(cellIndex);
+    Slot slot = { cellIndex, cell.entities.size() };
+
+    cell.x.append(position.x);
+    cell.y.append(position.y);
+    cell.z.append(position.z);
+    cell.radius.append(radius);
+    cell.entities.append(entity);
+    cell.maxRadius = glm::max(cell.maxRadius, radius);
+
+    _slots.insert(entity, slot);
+}
+
+void EntitySpatialIndex::insert(EntityItem* entity) {
+    if (_slots.contains(entity)) {
+        update(entity);
+        return;
+    }
+    float radius = entity->getRadius();
+    addToCell(cellFor(entity->getPosition(), radius), entity, entity->getPosition(), radius);
+}
+
+void EntitySpatialIndex::update(EntityItem* entity) {
+    QHash<EntityItem*, Slot>::iterator slot = _slots.find(entity);
+    if (slot == _slots.end()) {
+        return;
+    }
+
+    const glm::vec3& position = entity->getPosition();
+    float radius = entity->getRadius();
+    int cellIndex = cellFor(position, radius);
+
+    if (cellIndex == slot.value().cell) {
+        Cell& cell = cellAt(cellIndex);
+        int index = slot.value().index;
+        cell.x[index] = position.x;
+        cell.y[index] = position.y;
+        cell.z[index] = position.z;
+        cell.radius[index] = radius;
+        cell.maxRadius = glm::max(cell.maxRadius, radius);
+    } else {
+        remove(entity);
+        addToCell(cellIndex, entity, position, radius);
+    }
+}
+
+void EntitySpatialIndex::remove(EntityItem* entity) {
+    QHash<EntityItem*, Slot>::iterator slot = _slots.find(entity);
+    if (slot == _slots.end()) {
+        return;
+    }
+
+    Cell& cell = cellAt(slot.value().cell);
+    int index = slot.value().index;
+    int last = cell.entities.size() - 1;
+
+    // the last entity of the cell takes the place of the one leaving
+    if (index != last) {
+        cell.x[index] = cell.x[last];
+        cell.y[index] = cell.y[last];
+        cell.z[index] = cell.z[last];
+        cell.radius[index] = cell.radius[last];
+        cell.entities[index] = cell.entities[last];
+        _slots[cell.entities[index]].index = index;
+    }
+    cell.x.resize(last);
+    cell.y.resize(last);
+    cell.z.resize(last);
+    cell.radius.resize(last);
+    cell.entities.resize(last);
+    if (last == 0) {
+        cell.maxRadius = 0.0f;
+    }
+
+    _slots.erase(slot);
+}
+
+void EntitySpatialIndex::clear() {
+    _cells.clear();
+    _cellIndexes.clear();
+    _largeEntities = Cell();
+    _slots.clear();
+}
+
+static bool cellReaches(const glm::vec3& corner, float maxRadius, const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 cellMinimum = corner - glm::vec3(maxRadius);
+    glm::vec3 cellMaximum = corner + glm::vec3(CELL_SCALE + maxRadius);
+    return cellMinimum.x <= maximum.x && cellMaximum.x >= minimum.x
+        && cellMinimum.y <= maximum.y && cellMaximum.y >= minimum.y
+        && cellMinimum.z <= maximum.z && cellMaximum.z >= minimum.z;
+}
+
+template<typename Visitor> void EntitySpatialIndex::visitCells(const glm::vec3& minimum, const glm::vec3& maximum,
+                                                               Visitor& visit) const {
+    if (!_largeEntities.entities.isEmpty()) {
+        visit(_largeEntities);
+    }
+
+    // an entity reaches at most a cell beyond the one holding its position
+    int minimumX = cellCoordinate(minimum.x - CELL_SCALE);
+    int minimumY = cellCoordinate(minimum.y - CELL_SCALE);
+    int minimumZ = cellCoordinate(minimum.z - CELL_SCALE);
+    int maximumX = cellCoordinate(maximum.x + CELL_SCALE);
+    int maximumY = cellCoordinate(maximum.y + CELL_SCALE);
+    int maximumZ = cellCoordinate(maximum.z + CELL_SCALE);
+    qint64 cellsInRange = (qint64)(maximumX - minimumX + 1) * (maximumY - minimumY + 1) * (maximumZ - minimumZ + 1);
+
+    if (cellsInRange > _cells.size()) {
+        // a query bigger than the populated part of the grid is cheaper answered by going through the cells we have
+        foreach (const Cell& cell, _cells) {
+            if (!cell.entities.isEmpty() && cellReaches(cell.corner, cell.maxRadius, minimum, maximum)) {
+                visit(cell);
+            }
+        }
+        return;
+    }
+
+    for (int z = minimumZ; z <= maximumZ; z++) {
+        for (int y = minimumY; y <= maximumY; y++) {
+            for (int x = minimumX; x <= maximumX; x++) {
+                QHash<quint32, int>::const_iterator cellIndex = _cellIndexes.constFind(keyFor(x, y, z));
+                if (cellIndex != _cellIndexes.constEnd()) {
+                    const Cell& cell = _cells[cellIndex.value()];
+                    if (!cell.entities.isEmpty() && cellReaches(cell.corner, cell.maxRadius, minimum, maximum)) {
+                        visit(cell);
+                    }
+                }
+            }
+        }
+    }
+}
+
+class FindEntitiesInSphereCellVisitor {
+public:
+    FindEntitiesInSphereCellVisitor(const glm::vec3& center, float radius, QVector<const EntityItem*>& foundEntities) :
+        center(center),
+        radius(radius),
+        foundEntities(foundEntities) { }
+
+    void operator()(const EntitySpatialIndex::Cell& cell) {
+        int numberOfEntities = cell.entities.size();
+        const float* x = cell.x.constData();
+        const float* y = cell.y.constData();
+        const float* z = cell.z.constData();
+        const float* entityRadius = cell.radius.constData();
+        for (int i = 0; i < numberOfEntities; i++) {
+            float dx = x[i] - center.x;
+            float dy = y[i] - center.y;
+            float dz = z[i] - center.z;
+            float reach = radius + entityRadius[i];
+            if (dx * dx + dy * dy + dz * dz < reach * reach) {
+                foundEntities.push_back(cell.entities[i]);
+            }
+        }
+    }
+
+    glm::vec3 center;
+    float radius;
+    QVector<const EntityItem*>& foundEntities;
+};
+
+void EntitySpatialIndex::findEntities(const glm::vec3& center, float radius,
+                                      QVector<const EntityItem*>& foundEntities) const {
+    foundEntities.clear();
+    FindEntitiesInSphereCellVisitor visitor(center, radius, foundEntities);
+    visitCells(center - glm::vec3(radius), center + glm::vec3(radius), visitor);
+}
+
+class FindEntitiesInCubeCellVisitor {
+public:
+    FindEntitiesInCubeCellVisitor(const AACube& cube, QVector<EntityItem*>& foundEntities) :
+        center(cube.calcCenter()),
+        halfScale(0.5f * cube.getScale()),
+        foundEntities(foundEntities) { }
+
+    void operator()(const EntitySpatialIndex::Cell& cell) {
+        // the same cube to cube test as EntityTreeElement::getEntities(), with the entity as a cube around its radius
+        int numberOfEntities = cell.entities.size();
+        const float* x = cell.x.constData();
+        const float* y = cell.y.constData();
+        const float* z = cell.z.constData();
+        const float* entityRadius = cell.radius.constData();
+        for (int i = 0; i < numberOfEntities; i++) {
+            float reach = halfScale + entityRadius[i];
+            if (fabsf(x[i] - center.x) <= reach && fabsf(y[i] - center.y) <= reach && fabsf(z[i] - center.z) <= reach) {
+                foundEntities.push_back(cell.entities[i]);
+            }
+        }
+    }
+
+    glm::vec3 center;
+    float halfScale;
+    QVector<EntityItem*>& foundEntities;
+};
+
+void EntitySpatialIndex::findEntities(const AACube& cube, QVector<EntityItem*>& foundEntities) const {
+    foundEntities.clear();
+    FindEntitiesInCubeCellVisitor visitor(cube, foundEntities);
+    visitCells(cube.getCorner(), cube.getCorner() + glm::vec3(cube.getScale()), visitor);
+}
+
+class FindClosestEntityCellVisitor {
+public:
+    FindClosestEntityCellVisitor(const glm::vec3& position, float targetRadius) :
+        position(position),
+        closestEntity(NULL),
+        closestDistanceSquared(targetRadius * targetRadius) { }
+
+    void operator()(const EntitySpatialIndex::Cell& cell) {
+        int numberOfEntities = cell.entities.size();
+        const float* x = cell.x.constData();
+        const float* y = cell.y.constData();
+        const float* z = cell.z.constData();
+        for (int i = 0; i < numberOfEntities; i++) {
+            float dx = x[i] - position.x;
+            float dy = y[i] - position.y;
+            float dz = z[i] - position.z;
+            float distanceSquared = dx * dx + dy * dy + dz * dz;
+            if (distanceSquared <= closestDistanceSquared) {
+                closestEntity = cell.entities[i];
+                closestDistanceSquared = distanceSquared;
+            }
+        }
+    }
+
+    glm::vec3 position;
+    const EntityItem* closestEntity;
+    float closestDistanceSquared;
+};
+
+const EntityItem* EntitySpatialIndex::findClosestEntity(const glm::vec3& position, float targetRadius) const {
+    FindClosestEntityCellVisitor visitor(position, targetRadius);
+    visitCells(position - glm::vec3(targetRadius), position + glm::vec3(targetRadius), visitor);
+    return visitor.closestEntity;
+}
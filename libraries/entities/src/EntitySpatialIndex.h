@@ -0,0 +1,84 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <QHash>
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+#include <AACube.h>
+
+class EntityItem;
+
+/// A loose grid over the domain that answers the EntityTree's range and nearest queries without walking the octree.
+/// Each entity is kept in the cell holding its position, with its position and radius copied into arrays per cell so
+/// a query scans contiguous floats, and an entity bigger than a cell is kept in a list every query scans.
+/// The EntityTreeElement and EntityItem keep it in step as entities are added, moved, resized and removed.
+class EntitySpatialIndex {
+public:
+    void insert(EntityItem* entity);
+    void update(EntityItem* entity);
+    void remove(EntityItem* entity);
+    void clear();
+
+    int size() const { return _slots.size(); }
+
+    /// finds all entities that touch a sphere, in domain units
+    void findEntities(const glm::vec3& center, float radius, QVector<const EntityItem*>& foundEntities) const;
+
+    /// finds all entities whose bounding cube touches a cube, in domain units
+    void findEntities(const AACube& cube, QVector<EntityItem*>& foundEntities) const;
+
+    /// the entity whose position is nearest to position and no further than targetRadius from it, or NULL
+    const EntityItem* findClosestEntity(const glm::vec3& position, float targetRadius) const;
+
+private:
+    struct Cell {
+        Cell() : maxRadius(0.0f) { }
+
+        QVector<float> x;
+        QVector<float> y;
+        QVector<float> z;
+        QVector<float> radius;
+        QVector<EntityItem*> entities;
+        float maxRadius; // only grows until the cell empties
+        glm::vec3 corner;
+    };
+
+    struct Slot {
+        int cell; // LARGE_ENTITIES_CELL for the large entities
+        int index;
+    };
+
+    int cellFor(const glm::vec3& position, float radius);
+    static quint32 keyFor(int x, int y, int z);
+
+    void addToCell(int cellIndex, EntityItem* entity, const glm::vec3& position, float radius);
+    Cell& cellAt(int cellIndex) { return cellIndex < 0 ? _largeEntities : _cells[cellIndex]; }
+    const Cell& cellAt(int cellIndex) const { return cellIndex < 0 ? _largeEntities : _cells[cellIndex]; }
+
+    /// calls visit(cell) for the large entities and every cell whose loose bounds may reach the given box
+    template<typename Visitor> void visitCells(const glm::vec3& minimum, const glm::vec3& maximum,
+                                               Visitor& visit) const;
+
+    QVector<Cell> _cells;
+    QHash<quint32, int> _cellIndexes;
+    Cell _largeEntities;
+    QHash<EntityItem*, Slot> _slots;
+
+    friend class FindEntitiesInSphereCellVisitor;
+    friend class FindEntitiesInCubeCellVisitor;
+    friend class FindClosestEntityCellVisitor;
+};
+
+#endif // hifi_EntitySpatialIndex_h
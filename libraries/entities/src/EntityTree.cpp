@@ -9,6 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
 #include <PerfStat.h>
 
 #include "EntityTree.h"
@@ -21,6 +26,7 @@
 EntityTree::EntityTree(bool shouldReaverage) : 
     Octree(shouldReaverage), 
     _fbxService(NULL),
+    _jurisdiction(NULL),
     _simulation(NULL)
 {
     _rootElement = createNewElement();
@@ -28,6 +34,7 @@ EntityTree::EntityTree(bool shouldReaverage) :
 
 EntityTree::~EntityTree() {
     eraseAllOctreeElements(false);
+    qDeleteAll(_decodedEditPool);
 }
 
 EntityTreeElement* EntityTree::createNewElement(unsigned char * octalCode) {
@@ -43,13 +50,138 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         _simulation->clearEntities();
         _simulation->unlock();
     }
+    _spatialIndex.clear();
+    _entitiesOutsideJurisdiction.clear();
     foreach (EntityTreeElement* element, _entityToElementMap) {
         element->cleanupEntities();
     }
     _entityToElementMap.clear();
+    _entityDataCacheLock.lockForWrite();
+    _entityDataCache.clear();
+    _entityDataCacheLock.unlock();
     Octree::eraseAllOctreeElements(createNewRoot);
 }
 
+bool EntityTree::appendCachedEntityData(OctreePacketData* packetData, const EntityItem* entity) {
+    if (!getIsServer()) {
+        return false;
+    }
+    QReadLocker locker(&_entityDataCacheLock);
+    QHash<QUuid, CachedEntityData>::const_iterator cached = _entityDataCache.constFind(entity->getEntityItemID().id);
+    
+    // every change to what is encoded moves one of these times on
+    if (cached == _entityDataCache.constEnd()
+            || cached.value().lastEdited != entity->getLastEdited()
+            || cached.value().lastUpdated != entity->getLastUpdated()
+            || cached.value().lastSimulated != entity->getLastSimulated()) {
+        return false;
+    }
+    const QByteArray& data = cached.value().data;
+    return packetData->appendRawData(reinterpret_cast<const unsigned char*>(data.constData()), data.size());
+}
+
+void EntityTree::cacheEntityData(const EntityItem* entity, const unsigned char* data, int length) {
+    if (!getIsServer()) {
+        return;
+    }
+    CachedEntityData cached;
+    cached.lastEdited = entity->getLastEdited();
+    cached.lastUpdated = entity->getLastUpdated();
+    cached.lastSimulated = entity->getLastSimulated();
+    cached.data = QByteArray(reinterpret_cast<const char*>(data), length);
+    
+    QWriteLocker locker(&_entityDataCacheLock);
+    _entityDataCache.insert(entity->getEntityItemID().id, cached);
+}
+
+bool EntityTree::hasCachedEntityData(const EntityItem* entity) {
+    QReadLocker locker(&_entityDataCacheLock);
+    QHash<QUuid, CachedEntityData>::const_iterator cached = _entityDataCache.constFind(entity->getEntityItemID().id);
+    return cached != _entityDataCache.constEnd()
+        && cached.value().lastEdited == entity->getLastEdited()
+        && cached.value().lastUpdated == entity->getLastUpdated()
+        && cached.value().lastSimulated == entity->getLastSimulated();
+}
+
+void EntityTree::encodeEntitiesIntoCache(const QVector<EntityItem*>& entities, int first, int stride) {
+    OctreePacketData packetData(false, MAX_OCTREE_PACKET_DATA_SIZE);
+    EntityTreeElementExtraEncodeData extraEncodeData;
+    EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, NO_EXISTS_BITS);
+
+    for (int i = first; i < entities.size(); i += stride) {
+        EntityItem* entity = entities[i];
+        packetData.reset();
+        extraEncodeData.entities.clear();
+
+        // an entity too big for one packet is left to the send threads, which split it over several
+        if (entity->appendEntityData(&packetData, params, &extraEncodeData) == OctreeElement::COMPLETED) {
+            cacheEntityData(entity, packetData.getUncompressedData(0), packetData.getUncompressedByteOffset());
+        }
+    }
+}
+
+class EntityEncodeWorker : public QRunnable {
+public:
+    EntityEncodeWorker(EntityTree* tree, const QVector<EntityItem*>& entities, int first, int stride,
+                       QSemaphore& finished) :
+        _tree(tree), _entities(entities), _first(first), _stride(stride), _finished(finished) { }
+
+    virtual void run() {
+        _tree->encodeEntitiesIntoCache(_entities, _first, _stride);
+        _finished.release();
+    }
+
+private:
+    EntityTree* _tree;
+    const QVector<EntityItem*>& _entities;
+    int _first;
+    int _stride;
+    QSemaphore& _finished;
+};
+
+class FindUncachedEntitiesVisitor {
+public:
+    FindUncachedEntitiesVisitor(EntityTree* tree) : _tree(tree) { }
+
+    bool operator()(OctreeElement* element) {
+        EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
+        for (EntityItem* entity : entityTreeElement->getEntities()) {
+            if (!_tree->hasCachedEntityData(entity)) {
+                entities.append(entity);
+            }
+        }
+        return true;
+    }
+
+    EntityTree* _tree;
+    QVector<EntityItem*> entities;
+};
+
+// below this many entities per thread the hand off costs more than the encoding
+static const int MIN_ENTITIES_PER_ENCODE_THREAD = 32;
+
+// NOTE: assumes caller has handled locking
+void EntityTree::prepareFullSceneEncode() {
+    if (!getIsServer()) {
+        return;
+    }
+    PerformanceWarning warn(false, "EntityTree::prepareFullSceneEncode()", false);
+
+    FindUncachedEntitiesVisitor visitor(this);
+    visitTreeDepthFirst(visitor);
+    const QVector<EntityItem*>& entities = visitor.entities;
+
+    int numThreads = qBound(1, entities.size() / MIN_ENTITIES_PER_ENCODE_THREAD, QThread::idealThreadCount());
+
+    // the calling thread takes the first share, it would only be waiting otherwise
+    QSemaphore finished;
+    for (int i = 1; i < numThreads; i++) {
+        QThreadPool::globalInstance()->start(new EntityEncodeWorker(this, entities, i, numThreads, finished));
+    }
+    encodeEntitiesIntoCache(entities, 0, numThreads);
+    finished.acquire(numThreads - 1);
+}
+
 bool EntityTree::handlesEditPacketType(PacketType packetType) const {
     // we handle these types of "edit" packets
     switch (packetType) {
@@ -313,6 +445,9 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
         if (_simulation) {
             _simulation->removeEntity(theEntity);
         }
+        _entityDataCacheLock.lockForWrite();
+        _entityDataCache.remove(theEntity->getEntityItemID().id);
+        _entityDataCacheLock.unlock();
         delete theEntity; // now actually delete the entity!
     }
     if (_simulation) {
@@ -409,124 +544,21 @@ void EntityTree::handleAddEntityResponse(const QByteArray& packet) {
 }
 
 
-class FindNearPointArgs {
-public:
-    glm::vec3 position;
-    float targetRadius;
-    bool found;
-    const EntityItem* closestEntity;
-    float closestEntityDistance;
-};
-
-
-bool EntityTree::findNearPointOperation(OctreeElement* element, void* extraData) {
-    FindNearPointArgs* args = static_cast<FindNearPointArgs*>(extraData);
-    EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
-
-    glm::vec3 penetration;
-    bool sphereIntersection = entityTreeElement->getAACube().findSpherePenetration(args->position,
-                                                                    args->targetRadius, penetration);
-
-    // If this entityTreeElement contains the point, then search it...
-    if (sphereIntersection) {
-        const EntityItem* thisClosestEntity = entityTreeElement->getClosestEntity(args->position);
-
-        // we may have gotten NULL back, meaning no entity was available
-        if (thisClosestEntity) {
-            glm::vec3 entityPosition = thisClosestEntity->getPosition();
-            float distanceFromPointToEntity = glm::distance(entityPosition, args->position);
-
-            // If we're within our target radius
-            if (distanceFromPointToEntity <= args->targetRadius) {
-                // we are closer than anything else we've found
-                if (distanceFromPointToEntity < args->closestEntityDistance) {
-                    args->closestEntity = thisClosestEntity;
-                    args->closestEntityDistance = distanceFromPointToEntity;
-                    args->found = true;
-                }
-            }
-        }
-
-        // we should be able to optimize this...
-        return true; // keep searching in case children have closer entities
-    }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
-}
-
 const EntityItem* EntityTree::findClosestEntity(glm::vec3 position, float targetRadius) {
-    FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
     lockForRead();
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findNearPointOperation, &args);
+    const EntityItem* closestEntity = _spatialIndex.findClosestEntity(position, targetRadius);
     unlock();
-    return args.closestEntity;
-}
-
-class FindAllNearPointArgs {
-public:
-    glm::vec3 position;
-    float targetRadius;
-    QVector<const EntityItem*> entities;
-};
-
-
-bool EntityTree::findInSphereOperation(OctreeElement* element, void* extraData) {
-    FindAllNearPointArgs* args = static_cast<FindAllNearPointArgs*>(extraData);
-    glm::vec3 penetration;
-    bool sphereIntersection = element->getAACube().findSpherePenetration(args->position,
-                                                                    args->targetRadius, penetration);
-
-    // If this element contains the point, then search it...
-    if (sphereIntersection) {
-        EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
-        entityTreeElement->getEntities(args->position, args->targetRadius, args->entities);
-        return true; // keep searching in case children have closer entities
-    }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
+    return closestEntity;
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<const EntityItem*>& foundEntities) {
-    FindAllNearPointArgs args = { center, radius };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInSphereOperation, &args);
-
-    // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args.entities);
-}
-
-class FindEntitiesInCubeArgs {
-public:
-    FindEntitiesInCubeArgs(const AACube& cube) 
-        : _cube(cube), _foundEntities() {
-    }
-
-    AACube _cube;
-    QVector<EntityItem*> _foundEntities;
-};
-
-bool EntityTree::findInCubeOperation(OctreeElement* element, void* extraData) {
-    FindEntitiesInCubeArgs* args = static_cast<FindEntitiesInCubeArgs*>(extraData);
-    const AACube& elementCube = element->getAACube();
-    if (elementCube.touches(args->_cube)) {
-        EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
-        entityTreeElement->getEntities(args->_cube, args->_foundEntities);
-        return true;
-    }
-    return false;
+    _spatialIndex.findEntities(center, radius, foundEntities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AACube& cube, QVector<EntityItem*>& foundEntities) {
-    FindEntitiesInCubeArgs args(cube);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInCubeOperation, &args);
-    // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args._foundEntities);
+    _spatialIndex.findEntities(cube, foundEntities);
 }
 
 EntityItem* EntityTree::findEntityByID(const QUuid& id) {
@@ -584,28 +616,7 @@ int EntityTree::processEditPacketData(PacketType packetType, const unsigned char
             // If we got a valid edit packet, then it could be a new entity or it could be an update to
             // an existing entity... handle appropriately
             if (validEditPacket) {
-            
-                // If this is a knownID, then it should exist in our tree
-                if (entityItemID.isKnownID) {
-                    // search for the entity by EntityItemID
-                    EntityItem* existingEntity = findEntityByEntityItemID(entityItemID);
-                    
-                    // if the EntityItem exists, then update it
-                    if (existingEntity) {
-                        updateEntity(entityItemID, properties, senderNode->getCanAdjustLocks());
-                        existingEntity->markAsChangedOnServer();
-                    } else {
-                        qDebug() << "User attempted to edit an unknown entity. ID:" << entityItemID;
-                    }
-                } else {
-                    // this is a new entity... assign a new entityID
-                    entityItemID = assignEntityID(entityItemID);
-                    EntityItem* newEntity = addEntity(entityItemID, properties);
-                    if (newEntity) {
-                        newEntity->markAsChangedOnServer();
-                        notifyNewlyCreatedEntity(*newEntity, senderNode);
-                    }
-                }
+                applyEntityEdit(entityItemID, properties, senderNode);
             }
             break;
         }
@@ -617,6 +628,138 @@ int EntityTree::processEditPacketData(PacketType packetType, const unsigned char
     return processedBytes;
 }
 
+class DecodedEntityEdit : public OctreeDecodedEdit {
+public:
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+};
+
+bool EntityTree::decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                      int& processedBytes, OctreeDecodedEdit*& decodedEdit) {
+    // erases are cheap to read and all of their work is in the tree, so they are left to processEditPacketData()
+    if (!getIsServer() || packetType != PacketTypeEntityAddOrEdit) {
+        return false;
+    }
+
+    DecodedEntityEdit* entityEdit = NULL;
+    _decodedEditPoolLock.lock();
+    if (!_decodedEditPool.isEmpty()) {
+        entityEdit = static_cast<DecodedEntityEdit*>(_decodedEditPool.last());
+        _decodedEditPool.removeLast();
+    }
+    _decodedEditPoolLock.unlock();
+
+    if (!entityEdit) {
+        entityEdit = new DecodedEntityEdit();
+    }
+
+    if (EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                     entityEdit->entityItemID, entityEdit->properties)) {
+        decodedEdit = entityEdit;
+    } else {
+        releaseDecodedEdit(entityEdit);
+        decodedEdit = NULL;
+    }
+    return true;
+}
+
+const int MAX_POOLED_DECODED_EDITS = 256;
+
+void EntityTree::releaseDecodedEdit(OctreeDecodedEdit* decodedEdit) {
+    // a function local default so it's constructed on first use, after everything EntityItemProperties depends on
+    static const EntityItemProperties DEFAULT_PROPERTIES;
+
+    DecodedEntityEdit* entityEdit = static_cast<DecodedEntityEdit*>(decodedEdit);
+
+    // back to defaults before it's pooled, the decode only sets what's in the packet and this lets go of any strings
+    entityEdit->entityItemID = EntityItemID();
+    entityEdit->properties = DEFAULT_PROPERTIES;
+
+    QMutexLocker locker(&_decodedEditPoolLock);
+    if (_decodedEditPool.size() < MAX_POOLED_DECODED_EDITS) {
+        _decodedEditPool.append(entityEdit);
+    } else {
+        delete entityEdit;
+    }
+}
+
+void EntityTree::applyDecodedEdit(const OctreeDecodedEdit* decodedEdit, const SharedNodePointer& senderNode) {
+    const DecodedEntityEdit* entityEdit = static_cast<const DecodedEntityEdit*>(decodedEdit);
+    applyEntityEdit(entityEdit->entityItemID, entityEdit->properties, senderNode);
+}
+
+QUuid EntityTree::getDecodedEditItemID(const OctreeDecodedEdit* decodedEdit) const {
+    // adds carry a creator token rather than an ID, each one makes a new entity
+    const DecodedEntityEdit* entityEdit = static_cast<const DecodedEntityEdit*>(decodedEdit);
+    return entityEdit->entityItemID.isKnownID ? entityEdit->entityItemID.id : QUuid();
+}
+
+bool EntityTree::decodedEditSupersedes(const OctreeDecodedEdit* laterEdit, const OctreeDecodedEdit* earlierEdit) const {
+    const EntityItemProperties& later = static_cast<const DecodedEntityEdit*>(laterEdit)->properties;
+    const EntityItemProperties& earlier = static_cast<const DecodedEntityEdit*>(earlierEdit)->properties;
+
+    // the later edit has to be at least as new and set every property the earlier one did
+    return later.getLastEdited() >= earlier.getLastEdited()
+        && !(earlier.getChangedProperties() - later.getChangedProperties());
+}
+
+void EntityTree::applyEntityEdit(EntityItemID entityItemID, const EntityItemProperties& properties,
+                                 const SharedNodePointer& senderNode) {
+    // If this is a knownID, then it should exist in our tree
+    if (entityItemID.isKnownID) {
+        // search for the entity by EntityItemID
+        EntityItem* existingEntity = findEntityByEntityItemID(entityItemID);
+        
+        // if the EntityItem exists, then update it
+        if (existingEntity) {
+            updateEntity(entityItemID, properties, senderNode->getCanAdjustLocks());
+            existingEntity->markAsChangedOnServer(properties.getChangedProperties());
+        } else if (senderNode->getType() == NodeType::EntityServer) {
+            // another server is handing us an entity that moved into our jurisdiction, it keeps its ID
+            EntityItem* handedOffEntity = addEntity(entityItemID, properties);
+            if (handedOffEntity) {
+                handedOffEntity->markAsChangedOnServer();
+            }
+        } else {
+            qDebug() << "User attempted to edit an unknown entity. ID:" << entityItemID;
+        }
+    } else {
+        // this is a new entity... assign a new entityID
+        entityItemID = assignEntityID(entityItemID);
+        EntityItem* newEntity = addEntity(entityItemID, properties);
+        if (newEntity) {
+            newEntity->markAsChangedOnServer();
+            notifyNewlyCreatedEntity(*newEntity, senderNode);
+        }
+    }
+}
+
+
+void EntityTree::addToSpatialIndex(EntityItem* entity) {
+    _spatialIndex.insert(entity);
+    checkJurisdiction(entity);
+}
+
+void EntityTree::updateSpatialIndex(EntityItem* entity) {
+    _spatialIndex.update(entity);
+    checkJurisdiction(entity);
+}
+
+void EntityTree::removeFromSpatialIndex(EntityItem* entity) {
+    _spatialIndex.remove(entity);
+    _entitiesOutsideJurisdiction.remove(entity);
+}
+
+void EntityTree::checkJurisdiction(EntityItem* entity) {
+    if (!_jurisdiction) {
+        return;
+    }
+    if (_jurisdiction->isMyJurisdiction(entity->getPosition()) == JurisdictionMap::WITHIN) {
+        _entitiesOutsideJurisdiction.remove(entity);
+    } else {
+        _entitiesOutsideJurisdiction.insert(entity);
+    }
+}
 
 void EntityTree::notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
     _newlyCreatedHooksLock.lockForRead();
@@ -645,10 +788,8 @@ void EntityTree::removeNewlyCreatedHook(NewlyCreatedEntityHook* hook) {
 
 
 void EntityTree::releaseSceneEncodeData(OctreeElementExtraEncodeData* extraEncodeData) const {
-    foreach(void* extraData, *extraEncodeData) {
-        EntityTreeElementExtraEncodeData* thisExtraEncodeData = static_cast<EntityTreeElementExtraEncodeData*>(extraData);
-        delete thisExtraEncodeData;
-    }
+    // every element's extra encode data came from the scene's arena, it all goes in one
+    delete static_cast<EntityTreeElementExtraEncodeDataArena*>(extraEncodeData->value(NULL));
     extraEncodeData->clear();
 }
 
@@ -843,7 +984,14 @@ int EntityTree::processEraseMessage(const QByteArray& dataByteArray, const Share
             dataAt += encodedID.size();
             processedBytes += encodedID.size();
             
+            // an entity handed off between servers is erased by the one it left, which may reach us after the one it
+            // went to has sent it, so only the server we last heard about the entity from gets to erase it
             EntityItemID entityItemID(entityID);
+            EntityItem* existingEntity = findEntityByEntityItemID(entityItemID);
+            if (existingEntity && sourceNode && !existingEntity->getSourceUUID().isNull()
+                    && existingEntity->getSourceUUID() != sourceNode->getUUID()) {
+                continue;
+            }
             entityItemIDsToDelete << entityItemID;
         }
         deleteEntities(entityItemIDsToDelete);
@@ -1009,7 +1157,7 @@ bool EntityTree::sendEntitiesOperation(OctreeElement* element, void* extraData)
     SendEntitiesOperationArgs* args = static_cast<SendEntitiesOperationArgs*>(extraData);
     EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
 
-    const QList<EntityItem*>&  entities = entityTreeElement->getEntities();
+    const EntityItemList& entities = entityTreeElement->getEntities();
     for (int i = 0; i < entities.size(); i++) {
         EntityItemID newID(NEW_ENTITY, EntityItemID::getNextCreatorTokenID(), false);
         EntityItemProperties properties = entities[i]->getProperties();
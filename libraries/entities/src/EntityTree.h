@@ -12,10 +12,12 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <QMutex>
 #include <QSet>
 
 #include <Octree.h>
 #include "EntityTreeElement.h"
+#include "EntitySpatialIndex.h"
 #include "DeleteEntityOperator.h"
 
 
@@ -65,6 +67,12 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const;
     virtual int processEditPacketData(PacketType packetType, const unsigned char* packetData, int packetLength,
                     const unsigned char* editData, int maxLength, const SharedNodePointer& senderNode);
+    virtual bool decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                      int& processedBytes, OctreeDecodedEdit*& decodedEdit);
+    virtual void applyDecodedEdit(const OctreeDecodedEdit* decodedEdit, const SharedNodePointer& senderNode);
+    virtual QUuid getDecodedEditItemID(const OctreeDecodedEdit* decodedEdit) const;
+    virtual bool decodedEditSupersedes(const OctreeDecodedEdit* laterEdit, const OctreeDecodedEdit* earlierEdit) const;
+    virtual void releaseDecodedEdit(OctreeDecodedEdit* decodedEdit);
 
     virtual bool rootElementHasData() const { return true; }
     
@@ -115,6 +123,19 @@ public:
     /// \remark Side effect: any initial contents in entities will be lost
     void findEntities(const AACube& cube, QVector<EntityItem*>& foundEntities);
 
+    /// keep the spatial index behind findEntities() and findClosestEntity() in step, EntityTreeElement calls these as
+    /// entities join and leave it and EntityItem as an entity's position or dimensions change
+    void addToSpatialIndex(EntityItem* entity);
+    void updateSpatialIndex(EntityItem* entity);
+    void removeFromSpatialIndex(EntityItem* entity);
+
+    /// On a server sharing the domain with others, the part of it this tree owns. Entities whose position is outside
+    /// it are collected for the server to hand off to the server that owns where they are.
+    void setJurisdiction(const JurisdictionMap* jurisdiction) { _jurisdiction = jurisdiction; }
+
+    /// the entities whose position is outside our jurisdiction, an entity leaves this as it moves back in or is deleted
+    const QSet<EntityItem*>& getEntitiesOutsideJurisdiction() const { return _entitiesOutsideJurisdiction; }
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -152,6 +173,16 @@ public:
 
     void setSimulation(EntitySimulation* simulation);
 
+    /// On the server the send threads share the encoding of each entity that was appended whole, so an entity is only
+    /// encoded once per change however many nodes it is sent to. These are safe to call from several send threads.
+    /// \return false if there is no encoding of the entity as it is now or it did not fit, in which case nothing was
+    /// appended
+    bool appendCachedEntityData(OctreePacketData* packetData, const EntityItem* entity);
+    void cacheEntityData(const EntityItem* entity, const unsigned char* data, int length);
+
+    /// encodes every entity with a missing or stale shared encoding, split over several threads
+    virtual void prepareFullSceneEncode();
+
 signals:
     void deletingEntity(const EntityItemID& entityID);
     void addingEntity(const EntityItemID& entityID);
@@ -163,13 +194,14 @@ private:
     void processRemovedEntities(const DeleteEntityOperator& theOperator);
     bool updateEntityWithElement(EntityItem* entity, const EntityItemProperties& properties, 
                                  EntityTreeElement* containingElement, bool allowLockChange);
-    static bool findNearPointOperation(OctreeElement* element, void* extraData);
-    static bool findInSphereOperation(OctreeElement* element, void* extraData);
-    static bool findInCubeOperation(OctreeElement* element, void* extraData);
     static bool sendEntitiesOperation(OctreeElement* element, void* extraData);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
+    /// updates the entity if the ID is known, otherwise adds it
+    void applyEntityEdit(EntityItemID entityItemID, const EntityItemProperties& properties,
+                         const SharedNodePointer& senderNode);
+
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
 
@@ -178,8 +210,32 @@ private:
     EntityItemFBXService* _fbxService;
 
     QHash<EntityItemID, EntityTreeElement*> _entityToElementMap;
+    EntitySpatialIndex _spatialIndex;
+
+    void checkJurisdiction(EntityItem* entity);
+    const JurisdictionMap* _jurisdiction;
+    QSet<EntityItem*> _entitiesOutsideJurisdiction;
 
     EntitySimulation* _simulation;
+
+    struct CachedEntityData {
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        QByteArray data;
+    };
+
+    // applied edits kept to decode later ones into, so a busy server isn't allocating a set of properties per edit
+    QMutex _decodedEditPoolLock;
+    QVector<OctreeDecodedEdit*> _decodedEditPool;
+
+    QReadWriteLock _entityDataCacheLock;
+    QHash<QUuid, CachedEntityData> _entityDataCache;
+
+    friend class EntityEncodeWorker;
+    friend class FindUncachedEntitiesVisitor;
+    bool hasCachedEntityData(const EntityItem* entity);
+    void encodeEntitiesIntoCache(const QVector<EntityItem*>& entities, int first, int stride);
 };
 
 #endif // hifi_EntityTree_h
@@ -16,18 +16,63 @@
 
 #include <FBXReader.h>
 #include <GeometryUtil.h>
+#include <OcclusionBuffer.h>
+#include <OctreeSentIndex.h>
 
 #include "EntityTree.h"
 #include "EntityTreeElement.h"
 
-EntityTreeElement::EntityTreeElement(unsigned char* octalCode) : OctreeElement(), _entityItems(NULL) {
+// a moving entity that looks smaller than this to a client is sent to it less often, the client extrapolates in between
+const float FULL_UPDATE_RATE_ANGULAR_SIZE = 0.05f; // radians
+const quint64 MAX_MOVING_ENTITY_UPDATE_INTERVAL = USECS_PER_SECOND;
+
+// true if the client has an older version of this moving entity that is recent enough for how small it looks to them
+static bool shouldDeferMovingEntity(const EntityItem* entity, const EncodeBitstreamParams& params) {
+    quint64 sentVersion;
+    if (params.forceSendScene || !params.sentIndex || !params.viewFrustum || !entity->isMoving()
+            || !params.sentIndex->getSentVersion(entity->getEntityItemID().id, sentVersion)) {
+        return false;
+    }
+    glm::vec3 viewerPosition = params.viewFrustum->getPosition() / (float)TREE_SCALE;
+    float distance = glm::max(glm::distance(viewerPosition, entity->getPosition()), EPSILON);
+    float angularSize = entity->getLargestDimension() / distance;
+    if (angularSize >= FULL_UPDATE_RATE_ANGULAR_SIZE) {
+        return false;
+    }
+    quint64 interval = (quint64)(MAX_MOVING_ENTITY_UPDATE_INTERVAL * (1.0f - angularSize / FULL_UPDATE_RATE_ANGULAR_SIZE));
+    return entity->getLastChangedOnServer() < sentVersion + interval;
+}
+
+EntityTreeElementExtraEncodeDataArena::~EntityTreeElementExtraEncodeDataArena() {
+    foreach (EntityTreeElementExtraEncodeData* block, _blocks) {
+        delete[] block;
+    }
+}
+
+EntityTreeElementExtraEncodeDataArena* EntityTreeElementExtraEncodeDataArena::forScene(
+        OctreeElementExtraEncodeData* extraEncodeData) {
+    void*& arena = (*extraEncodeData)[NULL];
+    if (!arena) {
+        arena = new EntityTreeElementExtraEncodeDataArena();
+    }
+    return static_cast<EntityTreeElementExtraEncodeDataArena*>(arena);
+}
+
+EntityTreeElementExtraEncodeData* EntityTreeElementExtraEncodeDataArena::allocate() {
+    if (_used == _blocks.size() * BLOCK_SIZE) {
+        _blocks.append(new EntityTreeElementExtraEncodeData[BLOCK_SIZE]);
+    }
+    EntityTreeElementExtraEncodeData* data = &_blocks[_used / BLOCK_SIZE][_used % BLOCK_SIZE];
+    _used++;
+    return data;
+}
+
+EntityTreeElement::EntityTreeElement(unsigned char* octalCode) : OctreeElement() {
     init(octalCode);
 };
 
 EntityTreeElement::~EntityTreeElement() {
-    _octreeMemoryUsage -= sizeof(EntityTreeElement);
-    delete _entityItems;
-    _entityItems = NULL;
+    _octreeMemory.removeCPUBytes(sizeof(EntityTreeElement));
 }
 
 // This will be called primarily on addChildAt(), which means we're adding a child of our
@@ -41,8 +86,7 @@ OctreeElement* EntityTreeElement::createNewElement(unsigned char* octalCode) {
 
 void EntityTreeElement::init(unsigned char* octalCode) {
     OctreeElement::init(octalCode);
-    _entityItems = new QList<EntityItem*>;
-    _octreeMemoryUsage += sizeof(EntityTreeElement);
+    _octreeMemory.addCPUBytes(sizeof(EntityTreeElement));
 }
 
 EntityTreeElement* EntityTreeElement::addChildAtIndex(int index) {
@@ -72,8 +116,9 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
     // Check to see if this element yet has encode data... if it doesn't create it
     if (!extraEncodeData->contains(this)) {
-        EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData = new EntityTreeElementExtraEncodeData();
-        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems->size() == 0);
+        EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData =
+            EntityTreeElementExtraEncodeDataArena::forScene(extraEncodeData)->allocate();
+        entityTreeElementExtraEncodeData->elementCompleted = _entityItems.isEmpty();
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             EntityTreeElement* child = getChildAtIndex(i);
             if (!child) {
@@ -86,8 +131,8 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
                 }
             }
         }
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
         }
         
@@ -158,6 +203,19 @@ void EntityTreeElement::updateEncodedData(int childIndex, AppendState childAppen
 
 
 
+void EntityTreeElement::addOccluders(const ViewFrustum& viewFrustum, OcclusionBuffer& occlusionBuffer) const {
+    for (const EntityItem* entity : _entityItems) {
+        // boxes and spheres are solid, and whichever way they are turned they hold the sphere as wide as their
+        // smallest dimension. anything moving may not be in front of the same things for long.
+        EntityTypes::EntityType type = entity->getType();
+        if ((type == EntityTypes::Box || type == EntityTypes::Sphere) && entity->isVisible() && !entity->isMoving()) {
+            glm::vec3 dimensions = entity->getDimensionsInMeters();
+            float radius = 0.5f * glm::min(dimensions.x, glm::min(dimensions.y, dimensions.z));
+            occlusionBuffer.addOccluder(viewFrustum, entity->getCenterInMeters(), radius);
+        }
+    }
+}
+
 void EntityTreeElement::elementEncodeComplete(EncodeBitstreamParams& params, OctreeElementBag* bag) const {
     const bool wantDebug = false;
     
@@ -243,14 +301,16 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     // first, check the params.extraEncodeData to see if there's any partial re-encode data for this element
     OctreeElementExtraEncodeData* extraEncodeData = params.extraEncodeData;
     EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData = NULL;
+    EntityTreeElementExtraEncodeData unkeptExtraEncodeData; // for encodes that don't keep any between calls
     bool hadElementExtraData = false;
     if (extraEncodeData && extraEncodeData->contains(this)) {
         entityTreeElementExtraEncodeData = static_cast<EntityTreeElementExtraEncodeData*>(extraEncodeData->value(this));
         hadElementExtraData = true;
     } else {
         // if there wasn't one already, then create one
-        entityTreeElementExtraEncodeData = new EntityTreeElementExtraEncodeData();
-        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems->size() == 0);
+        entityTreeElementExtraEncodeData = extraEncodeData
+            ? EntityTreeElementExtraEncodeDataArena::forScene(extraEncodeData)->allocate() : &unkeptExtraEncodeData;
+        entityTreeElementExtraEncodeData->elementCompleted = _entityItems.isEmpty();
 
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             EntityTreeElement* child = getChildAtIndex(i);
@@ -264,8 +324,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                 }
             }
         }
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
         }
     }
@@ -285,8 +345,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     // entities for encoding. This is needed because we encode the element data at the "parent" level, and so we 
     // need to handle the case where our sibling elements need encoding but we don't.
     if (!entityTreeElementExtraEncodeData->elementCompleted) {
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             bool includeThisEntity = true;
             
             if (!params.forceSendScene && entity->getLastChangedOnServer() < params.lastViewFrustumSent) {
@@ -297,6 +357,20 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                 includeThisEntity = includeThisEntity && 
                                         entityTreeElementExtraEncodeData->entities.contains(entity->getEntityItemID());
             }
+
+            // the client already has this entity as it is now, there is nothing of it left to send
+            if (includeThisEntity && params.sentIndex
+                    && params.sentIndex->hasSent(entity->getEntityItemID().id, entity->getLastChangedOnServer())) {
+                entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                includeThisEntity = false;
+            }
+
+            // far away moving entities wait their turn, the send thread brings the held back change round again
+            if (includeThisEntity && shouldDeferMovingEntity(entity, params)) {
+                entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                params.sentIndex->defer(entity->getLastChangedOnServer());
+                includeThisEntity = false;
+            }
         
             if (includeThisEntity && params.viewFrustum) {
             
@@ -323,10 +397,32 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
 
     if (successAppendEntityCount) {
         foreach (uint16_t i, indexesOfEntitiesToInclude) {
-            EntityItem* entity = (*_entityItems)[i];
+            EntityItem* entity = _entityItems[i];
             LevelDetails entityLevel = packetData->startLevel();
-            OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData, 
-                                                                        params, entityTreeElementExtraEncodeData);
+            OctreeElement::AppendState appendEntityState;
+            
+            // an entity that is to be sent whole only needs what changed since the version the client has, which
+            // is worked out now so it matches the version the entity is recorded as sent at
+            EntityPropertyFlags allProperties = entity->getEntityProperties(params);
+            EntityPropertyFlags requestedProperties =
+                entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID());
+            if (requestedProperties == allProperties) {
+                requestedProperties = entity->getEntityPropertiesToSend(params);
+                entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), requestedProperties);
+            }
+
+            // an entity that is to be sent whole may already have been encoded for another node
+            bool wantsAllProperties = requestedProperties == allProperties;
+            if (wantsAllProperties && _myTree->appendCachedEntityData(packetData, entity)) {
+                appendEntityState = OctreeElement::COMPLETED;
+            } else {
+                int entityDataOffset = packetData->getUncompressedByteOffset();
+                appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+                if (wantsAllProperties && appendEntityState == OctreeElement::COMPLETED) {
+                    _myTree->cacheEntityData(entity, packetData->getUncompressedData(entityDataOffset),
+                                             packetData->getUncompressedByteOffset() - entityDataOffset);
+                }
+            }
 
             // If none of this entity data was able to be appended, then discard it
             // and don't include it in our entity count
@@ -342,6 +438,9 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             // If the entity item got completely appended, then we can remove it from the extra encode data
             if (appendEntityState == OctreeElement::COMPLETED) {
                 entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                if (params.sentIndex) {
+                    params.sentIndex->addPending(entity->getEntityItemID().id, entity->getLastChangedOnServer());
+                }
             }
 
             // If any part of the entity items didn't fit, then the element is considered partial
@@ -479,8 +578,8 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
     int entityNumber = 0;
     
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::const_iterator entityEnd = _entityItems->end();
+    EntityItem* const* entityItr = _entityItems.begin();
+    EntityItem* const* entityEnd = _entityItems.end();
     bool somethingIntersected = false;
     
     //float bestEntityDistance = distance;
@@ -548,12 +647,11 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
 // TODO: change this to use better bounding shape for entity than sphere
 bool EntityTreeElement::findSpherePenetration(const glm::vec3& center, float radius,
                                     glm::vec3& penetration, void** penetratedObject) const {
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::const_iterator entityEnd = _entityItems->end();
-    while(entityItr != entityEnd) {
-        EntityItem* entity = (*entityItr);
-        glm::vec3 entityCenter = entity->getPosition();
-        float entityRadius = entity->getRadius();
+    int numberOfEntities = _entityItems.size();
+    for (int i = 0; i < numberOfEntities; i++) {
+        const glm::vec4& bounds = _entityItems.boundsAt(i);
+        glm::vec3 entityCenter = glm::vec3(bounds);
+        float entityRadius = bounds.w;
 
         // don't penetrate yourself
         if (entityCenter == center && entityRadius == radius) {
@@ -562,18 +660,17 @@ bool EntityTreeElement::findSpherePenetration(const glm::vec3& center, float rad
 
         if (findSphereSpherePenetration(center, radius, entityCenter, entityRadius, penetration)) {
             // return true on first valid entity penetration
-            *penetratedObject = (void*)(entity);
+            *penetratedObject = (void*)(_entityItems[i]);
             return true;
         }
-        ++entityItr;
     }
     return false;
 }
 
 bool EntityTreeElement::findShapeCollisions(const Shape* shape, CollisionList& collisions) const {
     bool atLeastOneCollision = false;
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::const_iterator entityEnd = _entityItems->end();
+    EntityItem* const* entityItr = _entityItems.begin();
+    EntityItem* const* entityEnd = _entityItems.end();
     while(entityItr != entityEnd) {
         EntityItem* entity = (*entityItr);
         
@@ -598,9 +695,9 @@ bool EntityTreeElement::findShapeCollisions(const Shape* shape, CollisionList& c
 }
 
 void EntityTreeElement::updateEntityItemID(const EntityItemID& creatorTokenEntityID, const EntityItemID& knownIDEntityID) {
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        EntityItem* thisEntity = (*_entityItems)[i];
+        EntityItem* thisEntity = _entityItems[i];
 
         EntityItemID thisEntityID = thisEntity->getEntityItemID();
         
@@ -613,11 +710,11 @@ void EntityTreeElement::updateEntityItemID(const EntityItemID& creatorTokenEntit
 const EntityItem* EntityTreeElement::getClosestEntity(glm::vec3 position) const {
     const EntityItem* closestEntity = NULL;
     float closestEntityDistance = FLT_MAX;
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        float distanceToEntity = glm::distance(position, (*_entityItems)[i]->getPosition());
+        float distanceToEntity = glm::distance(position, glm::vec3(_entityItems.boundsAt(i)));
         if (distanceToEntity < closestEntityDistance) {
-            closestEntity = (*_entityItems)[i];
+            closestEntity = _entityItems[i];
         }
     }
     return closestEntity;
@@ -625,41 +722,38 @@ const EntityItem* EntityTreeElement::getClosestEntity(glm::vec3 position) const
 
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<const EntityItem*>& foundEntities) const {
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        const EntityItem* entity = (*_entityItems)[i];
-        float distance = glm::length(entity->getPosition() - searchPosition);
-        if (distance < searchRadius + entity->getRadius()) {
-            foundEntities.push_back(entity);
+        const glm::vec4& bounds = _entityItems.boundsAt(i);
+        float distance = glm::length(glm::vec3(bounds) - searchPosition);
+        if (distance < searchRadius + bounds.w) {
+            foundEntities.push_back(_entityItems[i]);
         }
     }
 }
 
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const AACube& box, QVector<EntityItem*>& foundEntities) {
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::iterator entityEnd = _entityItems->end();
+    uint16_t numberOfEntities = _entityItems.size();
     AACube entityCube;
-    while(entityItr != entityEnd) {
-        EntityItem* entity = (*entityItr);
-        float radius = entity->getRadius();
+    for (uint16_t i = 0; i < numberOfEntities; i++) {
+        const glm::vec4& bounds = _entityItems.boundsAt(i);
         // NOTE: we actually do cube-cube collision queries here, which is sloppy but good enough for now
         // TODO: decide whether to replace entityCube-cube query with sphere-cube (requires a square root
         // but will be slightly more accurate).
-        entityCube.setBox(entity->getPosition() - glm::vec3(radius), 2.0f * radius);
+        entityCube.setBox(glm::vec3(bounds) - glm::vec3(bounds.w), 2.0f * bounds.w);
         if (entityCube.touches(box)) {
-            foundEntities.push_back(entity);
+            foundEntities.push_back(_entityItems[i]);
         }
-        ++entityItr;
     }
 }
 
 const EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id) const {
     const EntityItem* foundEntity = NULL;
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
-            foundEntity = (*_entityItems)[i];
+        if (_entityItems[i]->getEntityItemID() == id) {
+            foundEntity = _entityItems[i];
             break;
         }
     }
@@ -668,10 +762,10 @@ const EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemI
    
 EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id) {
     EntityItem* foundEntity = NULL;
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
-            foundEntity = (*_entityItems)[i];
+        if (_entityItems[i]->getEntityItemID() == id) {
+            foundEntity = _entityItems[i];
             break;
         }
     }
@@ -679,23 +773,24 @@ EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id)
 }
 
 void EntityTreeElement::cleanupEntities() {
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        EntityItem* entity = (*_entityItems)[i];
+        EntityItem* entity = _entityItems[i];
         entity->_element = NULL;
         delete entity;
     }
-    _entityItems->clear();
+    _entityItems.clear();
 }
 
 bool EntityTreeElement::removeEntityWithEntityItemID(const EntityItemID& id) {
     bool foundEntity = false;
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
+        if (_entityItems[i]->getEntityItemID() == id) {
             foundEntity = true;
-            (*_entityItems)[i]->_element = NULL;
-            _entityItems->removeAt(i);
+            _myTree->removeFromSpatialIndex(_entityItems[i]);
+            _entityItems[i]->_element = NULL;
+            _entityItems.removeAt(i);
             break;
         }
     }
@@ -703,9 +798,9 @@ bool EntityTreeElement::removeEntityWithEntityItemID(const EntityItemID& id) {
 }
 
 bool EntityTreeElement::removeEntityItem(EntityItem* entity) {
-    int numEntries = _entityItems->removeAll(entity);
-    if (numEntries > 0) {
+    if (_entityItems.removeOne(entity)) {
         assert(entity->_element == this);
+        _myTree->removeFromSpatialIndex(entity);
         entity->_element = NULL;
         return true;
     }
@@ -772,6 +867,7 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                     EntityTreeElement* currentContainingElement = _myTree->getContainingElement(entityItemID);
 
                     bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
+                    entityItem->setSourceUUID(args.sourceUUID);
                     if (entityItem->getDirtyFlags()) {
                         _myTree->entityChanged(entityItem);
                     }
@@ -798,6 +894,7 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                     entityItem = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead, args);
                     if (entityItem) {
                         bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
+                        entityItem->setSourceUUID(args.sourceUUID);
                         addEntityItem(entityItem); // add this new entity to this elements entities
                         entityItemID = entityItem->getEntityItemID();
                         _myTree->setContainingElement(entityItemID, this);
@@ -818,8 +915,16 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
 void EntityTreeElement::addEntityItem(EntityItem* entity) {
     assert(entity);
     assert(entity->_element == NULL);
-    _entityItems->push_back(entity);
+    _entityItems.append(entity);
     entity->_element = this;
+    _myTree->addToSpatialIndex(entity);
+}
+
+void EntityTreeElement::updateEntityBounds(const EntityItem* entity) {
+    int index = _entityItems.indexOf(entity);
+    if (index != -1) {
+        _entityItems.updateBoundsAt(index);
+    }
 }
 
 // will average a "common reduced LOD view" from the the child elements...
@@ -857,11 +962,11 @@ void EntityTreeElement::debugDump() {
     temp.scale((float)TREE_SCALE);
     qDebug() << "    cube:" << temp;
     qDebug() << "    has child elements:" << getChildCount();
-    if (_entityItems->size()) {
-        qDebug() << "    has entities:" << _entityItems->size();
+    if (_entityItems.size()) {
+        qDebug() << "    has entities:" << _entityItems.size();
         qDebug() << "--------------------------------------------------";
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entity->debugDump();
         }
         qDebug() << "--------------------------------------------------";
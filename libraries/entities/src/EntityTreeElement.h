@@ -14,9 +14,11 @@
 
 #include <OctreeElement.h>
 #include <QList>
+#include <QVector>
 
 #include "EntityEditPacketSender.h"
 #include "EntityItem.h"
+#include "EntityItemList.h"
 #include "EntityTree.h"
 
 class EntityTree;
@@ -62,6 +64,27 @@ inline QDebug operator<<(QDebug debug, const EntityTreeElementExtraEncodeData* d
     return debug;
 }
 
+/// Hands out the extra encode data of one scene's elements from blocks that are all freed together. It is kept in the
+/// scene's OctreeElementExtraEncodeData under the NULL element, and EntityTree::releaseSceneEncodeData() deletes it.
+class EntityTreeElementExtraEncodeDataArena {
+public:
+    EntityTreeElementExtraEncodeDataArena() : _used(0) { }
+    ~EntityTreeElementExtraEncodeDataArena();
+
+    /// finds the arena of a scene's extra encode data, making it if the scene doesn't have one yet
+    static EntityTreeElementExtraEncodeDataArena* forScene(OctreeElementExtraEncodeData* extraEncodeData);
+
+    EntityTreeElementExtraEncodeData* allocate();
+
+private:
+    Q_DISABLE_COPY(EntityTreeElementExtraEncodeDataArena)
+
+    static const int BLOCK_SIZE = 64;
+
+    QVector<EntityTreeElementExtraEncodeData*> _blocks;
+    int _used;
+};
+
 
 class SendModelsOperationArgs {
 public:
@@ -116,6 +139,7 @@ public:
     virtual bool shouldRecurseChildTree(int childIndex, EncodeBitstreamParams& params) const;
     virtual void updateEncodedData(int childIndex, AppendState childAppendState, EncodeBitstreamParams& params) const;
     virtual void elementEncodeComplete(EncodeBitstreamParams& params, OctreeElementBag* bag) const;
+    virtual void addOccluders(const ViewFrustum& viewFrustum, OcclusionBuffer& occlusionBuffer) const;
 
     bool alreadyFullyEncoded(EncodeBitstreamParams& params) const;
 
@@ -144,15 +168,17 @@ public:
 
     virtual bool findShapeCollisions(const Shape* shape, CollisionList& collisions) const;
 
-    const QList<EntityItem*>& getEntities() const { return *_entityItems; }
-    QList<EntityItem*>& getEntities() { return *_entityItems; }
-    bool hasEntities() const { return _entityItems ? _entityItems->size() > 0 : false; }
+    const EntityItemList& getEntities() const { return _entityItems; }
+    bool hasEntities() const { return !_entityItems.isEmpty(); }
 
     void setTree(EntityTree* tree) { _myTree = tree; }
+    EntityTree* getTree() const { return _myTree; }
 
     bool updateEntity(const EntityItem& entity);
     void addEntityItem(EntityItem* entity);
 
+    /// called as an entity's position or dimensions change, to keep the bounds spatial queries scan up to date
+    void updateEntityBounds(const EntityItem* entity);
 
     void updateEntityItemID(const EntityItemID& creatorTokenEntityID, const EntityItemID& knownIDEntityID);
 
@@ -201,7 +227,7 @@ public:
 protected:
     virtual void init(unsigned char * octalCode);
     EntityTree* _myTree;
-    QList<EntityItem*>* _entityItems;
+    EntityItemList _entityItems;
 };
 
 #endif // hifi_EntityTreeElement_h
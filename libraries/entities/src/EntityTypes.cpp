@@ -102,19 +102,13 @@ EntityItem* EntityTypes::constructEntityItem(const unsigned char* data, int byte
 
     int bytesRead = 0;
     if (bytesToRead >= MINIMUM_HEADER_BYTES) {
-        int originalLength = bytesToRead;
-        QByteArray originalDataBuffer((const char*)data, originalLength);
-
         // id
-        QByteArray encodedID = originalDataBuffer.mid(bytesRead, NUM_BYTES_RFC4122_UUID); // maximum possible size
-        QUuid actualID = QUuid::fromRfc4122(encodedID);
-        bytesRead += encodedID.size();
+        QUuid actualID = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)data, NUM_BYTES_RFC4122_UUID));
+        bytesRead += NUM_BYTES_RFC4122_UUID;
 
         // type
-        QByteArray encodedType = originalDataBuffer.mid(bytesRead); // maximum possible size
-        ByteCountCoded<quint32> typeCoder = encodedType;
-        encodedType = typeCoder; // determine true length
-        bytesRead += encodedType.size();
+        ByteCountCoded<quint32> typeCoder;
+        bytesRead += typeCoder.decode(data + bytesRead, bytesToRead - bytesRead);
         quint32 type = typeCoder;
         EntityTypes::EntityType entityType = (EntityTypes::EntityType)type;
         
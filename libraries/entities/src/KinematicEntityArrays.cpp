@@ -0,0 +1,220 @@
+//
+//  KinematicEntityArrays.cpp
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <SharedUtil.h>
+
+#include "EntityItem.h"
+
+#include "KinematicEntityArrays.h"
+
+// an entity gets its state back once it has moved 10cm since the last time, or after a quarter second, well inside the
+// second a client will extrapolate an entity forward from its last simulated time
+static const float WRITE_BACK_DISTANCE = 0.1f / (float)TREE_SCALE;
+static const quint64 MAX_WRITE_BACK_INTERVAL = USECS_PER_SECOND / 4;
+
+void KinematicEntityArrays::add(EntityItem* entity) {
+    if (contains(entity)) {
+        return;
+    }
+    _indexes.insert(entity, _entities.size());
+    _entities.append(entity);
+
+    const glm::vec3& position = entity->getPosition();
+    const glm::vec3& velocity = entity->getVelocity();
+    const glm::vec3& gravity = entity->getGravity();
+    _positionX.append(position.x);
+    _positionY.append(position.y);
+    _positionZ.append(position.z);
+    _velocityX.append(velocity.x);
+    _velocityY.append(velocity.y);
+    _velocityZ.append(velocity.z);
+    _gravityX.append(gravity.x);
+    _gravityY.append(gravity.y);
+    _gravityZ.append(gravity.z);
+    _damping.append(entity->getDamping());
+    _lastSimulated.append(entity->getLastSimulated());
+
+    _writtenBackPosition.append(position);
+    _writtenBackAt.append(entity->getLastSimulated());
+}
+
+void KinematicEntityArrays::removeAt(int index) {
+    // the last entity takes the place of the one leaving
+    int last = _entities.size() - 1;
+    _indexes.remove(_entities[index]);
+    if (index != last) {
+        _entities[index] = _entities[last];
+        _indexes[_entities[index]] = index;
+        _positionX[index] = _positionX[last];
+        _positionY[index] = _positionY[last];
+        _positionZ[index] = _positionZ[last];
+        _velocityX[index] = _velocityX[last];
+        _velocityY[index] = _velocityY[last];
+        _velocityZ[index] = _velocityZ[last];
+        _gravityX[index] = _gravityX[last];
+        _gravityY[index] = _gravityY[last];
+        _gravityZ[index] = _gravityZ[last];
+        _damping[index] = _damping[last];
+        _lastSimulated[index] = _lastSimulated[last];
+        _writtenBackPosition[index] = _writtenBackPosition[last];
+        _writtenBackAt[index] = _writtenBackAt[last];
+    }
+    _entities.resize(last);
+    _positionX.resize(last);
+    _positionY.resize(last);
+    _positionZ.resize(last);
+    _velocityX.resize(last);
+    _velocityY.resize(last);
+    _velocityZ.resize(last);
+    _gravityX.resize(last);
+    _gravityY.resize(last);
+    _gravityZ.resize(last);
+    _damping.resize(last);
+    _lastSimulated.resize(last);
+    _writtenBackPosition.resize(last);
+    _writtenBackAt.resize(last);
+}
+
+void KinematicEntityArrays::remove(EntityItem* entity) {
+    QHash<EntityItem*, int>::const_iterator index = _indexes.constFind(entity);
+    if (index != _indexes.constEnd()) {
+        removeAt(index.value());
+    }
+}
+
+void KinematicEntityArrays::clear() {
+    _entities.clear();
+    _indexes.clear();
+    _positionX.clear();
+    _positionY.clear();
+    _positionZ.clear();
+    _velocityX.clear();
+    _velocityY.clear();
+    _velocityZ.clear();
+    _gravityX.clear();
+    _gravityY.clear();
+    _gravityZ.clear();
+    _damping.clear();
+    _lastSimulated.clear();
+    _writtenBackPosition.clear();
+    _writtenBackAt.clear();
+}
+
+void KinematicEntityArrays::writeBack(int index) {
+    glm::vec3 position(_positionX[index], _positionY[index], _positionZ[index]);
+    glm::vec3 velocity(_velocityX[index], _velocityY[index], _velocityZ[index]);
+    _entities[index]->setSimulatedMotion(position, velocity, _lastSimulated[index]);
+    _writtenBackPosition[index] = position;
+    _writtenBackAt[index] = _lastSimulated[index];
+}
+
+void KinematicEntityArrays::writeBackAndRemove(EntityItem* entity, bool keepPosition, bool keepVelocity) {
+    QHash<EntityItem*, int>::const_iterator found = _indexes.constFind(entity);
+    if (found == _indexes.constEnd()) {
+        return;
+    }
+    int index = found.value();
+
+    // the entity was just changed from outside, its last simulated time is now and it keeps what it was given
+    glm::vec3 position = keepPosition ? entity->getPosition()
+        : glm::vec3(_positionX[index], _positionY[index], _positionZ[index]);
+    glm::vec3 velocity = keepVelocity ? entity->getVelocity()
+        : glm::vec3(_velocityX[index], _velocityY[index], _velocityZ[index]);
+    quint64 lastSimulated = qMax(entity->getLastSimulated(), _lastSimulated[index]);
+    entity->setSimulatedMotion(position, velocity, lastSimulated);
+
+    removeAt(index);
+}
+
+void KinematicEntityArrays::simulate(quint64 now, QVector<EntityItem*>& writtenBack, QVector<EntityItem*>& stopped) {
+    int numberOfEntities = _entities.size();
+    _timeElapsed.resize(numberOfEntities);
+    _dampingFactor.resize(numberOfEntities);
+
+    float* timeElapsed = _timeElapsed.data();
+    float* dampingFactor = _dampingFactor.data();
+    quint64* lastSimulated = _lastSimulated.data();
+    const float* damping = _damping.constData();
+
+    for (int i = 0; i < numberOfEntities; i++) {
+        timeElapsed[i] = lastSimulated[i] == 0 || lastSimulated[i] > now
+            ? 0.0f : (float)(now - lastSimulated[i]) / (float)USECS_PER_SECOND;
+        dampingFactor[i] = damping[i] > 0.0f ? powf(1.0f - damping[i], timeElapsed[i]) : 1.0f;
+        lastSimulated[i] = now;
+    }
+
+    // the same steps as EntityItem::simulateKinematicMotion(), damp, move, then accelerate, and an entity slowed below
+    // the epsilon stops where it was
+    float* positionX = _positionX.data();
+    float* positionY = _positionY.data();
+    float* positionZ = _positionZ.data();
+    float* velocityX = _velocityX.data();
+    float* velocityY = _velocityY.data();
+    float* velocityZ = _velocityZ.data();
+    const float* gravityX = _gravityX.constData();
+    const float* gravityY = _gravityY.constData();
+    const float* gravityZ = _gravityZ.constData();
+    const float EPSILON_SPEED_SQUARED = ENTITY_ITEM_EPSILON_LINEAR_VELOCITY_LENGTH
+        * ENTITY_ITEM_EPSILON_LINEAR_VELOCITY_LENGTH;
+
+    QVector<int> stoppedIndexes;
+    for (int i = 0; i < numberOfEntities; i++) {
+        float dt = timeElapsed[i];
+        float x = velocityX[i] * dampingFactor[i];
+        float y = velocityY[i] * dampingFactor[i];
+        float z = velocityZ[i] * dampingFactor[i];
+        float newPositionX = positionX[i] + x * dt;
+        float newPositionY = positionY[i] + y * dt;
+        float newPositionZ = positionZ[i] + z * dt;
+        x += gravityX[i] * dt;
+        y += gravityY[i] * dt;
+        z += gravityZ[i] * dt;
+
+        if (x * x + y * y + z * z < EPSILON_SPEED_SQUARED) {
+            velocityX[i] = velocityY[i] = velocityZ[i] = 0.0f;
+            stoppedIndexes.append(i);
+        } else {
+            positionX[i] = newPositionX;
+            positionY[i] = newPositionY;
+            positionZ[i] = newPositionZ;
+            velocityX[i] = x;
+            velocityY[i] = y;
+            velocityZ[i] = z;
+        }
+    }
+
+    const float WRITE_BACK_DISTANCE_SQUARED = WRITE_BACK_DISTANCE * WRITE_BACK_DISTANCE;
+    int nextStopped = 0;
+    for (int i = 0; i < numberOfEntities; i++) {
+        if (nextStopped < stoppedIndexes.size() && stoppedIndexes[nextStopped] == i) {
+            nextStopped++;
+            continue;
+        }
+        const glm::vec3& writtenBackPosition = _writtenBackPosition[i];
+        float dx = positionX[i] - writtenBackPosition.x;
+        float dy = positionY[i] - writtenBackPosition.y;
+        float dz = positionZ[i] - writtenBackPosition.z;
+        if (dx * dx + dy * dy + dz * dz > WRITE_BACK_DISTANCE_SQUARED
+                || now - _writtenBackAt[i] >= MAX_WRITE_BACK_INTERVAL) {
+            writeBack(i);
+            writtenBack.append(_entities[i]);
+        }
+    }
+
+    // stopped entities leave from the back so the ones still to go keep their indexes
+    for (int i = stoppedIndexes.size() - 1; i >= 0; i--) {
+        int index = stoppedIndexes[i];
+        writeBack(index);
+        stopped.append(_entities[index]);
+        removeAt(index);
+    }
+}
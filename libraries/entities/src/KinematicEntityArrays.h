@@ -0,0 +1,73 @@
+//
+//  KinematicEntityArrays.h
+//  libraries/entities/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KinematicEntityArrays_h
+#define hifi_KinematicEntityArrays_h
+
+#include <QHash>
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+class EntityItem;
+
+/// The linear motion state of the entities a SimpleEntitySimulation moves, kept in arrays so one pass over contiguous
+/// floats integrates all of them the way EntityItem::simulate() would. An entity only gets its state back when it has
+/// moved far enough that the tree and its packets want the new position, when enough time has gone by, or when it
+/// stops. In between the entity keeps the position and velocity it had at its last simulated time, which clients
+/// extrapolate from the same way.
+class KinematicEntityArrays {
+public:
+    bool contains(EntityItem* entity) const { return _indexes.contains(entity); }
+    int size() const { return _entities.size(); }
+
+    /// copies the entity's linear motion in, the entity should have a velocity and no angular velocity
+    void add(EntityItem* entity);
+
+    /// drops the entity without writing its state back
+    void remove(EntityItem* entity);
+    void clear();
+
+    /// writes the entity's simulated state back to it and drops it, keeping the position and velocity the entity was
+    /// just given if keepPosition or keepVelocity is set
+    void writeBackAndRemove(EntityItem* entity, bool keepPosition = false, bool keepVelocity = false);
+
+    /// integrates every entity forward to now
+    /// \param writtenBack[out] entities whose state was written back, and need to be sorted in the tree
+    /// \param stopped[out] entities that came to rest, they are written back and no longer in the arrays
+    void simulate(quint64 now, QVector<EntityItem*>& writtenBack, QVector<EntityItem*>& stopped);
+
+private:
+    void removeAt(int index);
+    void writeBack(int index);
+
+    QVector<EntityItem*> _entities;
+    QHash<EntityItem*, int> _indexes;
+
+    QVector<float> _positionX;
+    QVector<float> _positionY;
+    QVector<float> _positionZ;
+    QVector<float> _velocityX;
+    QVector<float> _velocityY;
+    QVector<float> _velocityZ;
+    QVector<float> _gravityX;
+    QVector<float> _gravityY;
+    QVector<float> _gravityZ;
+    QVector<float> _damping;
+    QVector<quint64> _lastSimulated;
+
+    QVector<glm::vec3> _writtenBackPosition;
+    QVector<quint64> _writtenBackAt;
+
+    QVector<float> _timeElapsed; // scratch for simulate()
+    QVector<float> _dampingFactor;
+};
+
+#endif // hifi_KinematicEntityArrays_h
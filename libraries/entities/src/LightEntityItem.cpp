@@ -52,6 +52,7 @@ void LightEntityItem::setDimensions(const glm::vec3& value) {
     float maxDimension = glm::max(value.x, value.y, value.z);
     _dimensions = glm::vec3(maxDimension, maxDimension, maxDimension); 
     recalculateCollisionShape(); 
+    updateSpatialIndex();
 }
 
 
@@ -100,6 +100,9 @@ public:
     
     virtual const Shape& getCollisionShapeInMeters() const { return _emptyShape; }
 
+    // the edge of a light is soft, drifting a little further before a correction goes unnoticed
+    virtual float getMaxExtrapolationError() const { return 0.1f; }
+
     static bool getLightsArePickable() { return _lightsArePickable; }
     static void setLightsArePickable(bool value) { _lightsArePickable = value; }
     
@@ -156,7 +156,7 @@ void ModelEntityItem::appendSubclassData(OctreePacketData* packetData, EncodeBit
 }
 
 
-QMap<QString, AnimationPointer> ModelEntityItem::_loadedAnimations; // TODO: improve cleanup by leveraging the AnimationPointer(s)
+QHash<InternedString, AnimationPointer> ModelEntityItem::_loadedAnimations; // TODO: improve cleanup by leveraging the AnimationPointer(s)
 
 // This class/instance will cleanup the animations once unloaded.
 class EntityAnimationsBookkeeper {
@@ -175,15 +175,16 @@ void ModelEntityItem::cleanupLoadedAnimations() {
     _loadedAnimations.clear();
 }
 
-Animation* ModelEntityItem::getAnimation(const QString& url) {
+Animation* ModelEntityItem::getAnimation(const InternedString& url) {
     AnimationPointer animation;
     
-    // if we don't already have this model then create it and initialize it
-    if (_loadedAnimations.find(url) == _loadedAnimations.end()) {
-        animation = DependencyManager::get<AnimationCache>()->getAnimation(url);
-        _loadedAnimations[url] = animation;
+    // if we don't already have this model then create it and initialize it, looked up by handle every frame
+    QHash<InternedString, AnimationPointer>::const_iterator loaded = _loadedAnimations.constFind(url);
+    if (loaded == _loadedAnimations.constEnd()) {
+        animation = DependencyManager::get<AnimationCache>()->getAnimation(url.toString());
+        _loadedAnimations.insert(url, animation);
     } else {
-        animation = _loadedAnimations[url];
+        animation = loaded.value();
     }
     return animation.data();
 }
@@ -213,21 +214,20 @@ QVector<glm::quat> ModelEntityItem::getAnimationFrame() {
     QVector<glm::quat> frameData;
     if (hasAnimation() && _jointMappingCompleted) {
         Animation* myAnimation = getAnimation(_animationURL);
-        QVector<FBXAnimationFrame> frames = myAnimation->getFrames();
-        int frameCount = frames.size();
+        AnimationClipPointer clip = myAnimation->getClip();
+        int frameCount = clip ? clip->getFrameCount() : 0;
         if (frameCount > 0) {
             int animationFrameIndex = (int)(glm::floor(getAnimationFrameIndex())) % frameCount;
             if (animationFrameIndex < 0 || animationFrameIndex > frameCount) {
                 animationFrameIndex = 0;
             }
             
-            QVector<glm::quat> rotations = frames[animationFrameIndex].rotations;
-
+            _clipCursors.resize(clip->getJointCount());
             frameData.resize(_jointMapping.size());
             for (int j = 0; j < _jointMapping.size(); j++) {
                 int rotationIndex = _jointMapping[j];
-                if (rotationIndex != -1 && rotationIndex < rotations.size()) {
-                    frameData[j] = rotations[rotationIndex];
+                if (rotationIndex != -1 && rotationIndex < clip->getJointCount()) {
+                    frameData[j] = clip->sampleFrame(rotationIndex, animationFrameIndex, _clipCursors[rotationIndex]);
                 }
             }
         }
@@ -13,6 +13,7 @@
 #define hifi_ModelEntityItem_h
 
 #include <AnimationLoop.h>
+#include <InternedString.h>
 
 #include "EntityItem.h" 
 
@@ -58,11 +59,11 @@ public:
     bool hasModel() const { return !_modelURL.isEmpty(); }
 
     static const QString DEFAULT_MODEL_URL;
-    const QString& getModelURL() const { return _modelURL; }
+    QString getModelURL() const { return _modelURL.toString(); }
 
     bool hasAnimation() const { return !_animationURL.isEmpty(); }
     static const QString DEFAULT_ANIMATION_URL;
-    const QString& getAnimationURL() const { return _animationURL; }
+    QString getAnimationURL() const { return _animationURL.toString(); }
 
     void setColor(const rgbColor& value) { memcpy(_color, value, sizeof(_color)); }
     void setColor(const xColor& value) {
@@ -119,10 +120,10 @@ protected:
     bool isAnimatingSomething() const;
 
     rgbColor _color;
-    QString _modelURL;
+    InternedString _modelURL;
 
     quint64 _lastAnimated;
-    QString _animationURL;
+    InternedString _animationURL;
     AnimationLoop _animationLoop;
     QString _animationSettings;
     QString _textures;
@@ -130,9 +131,10 @@ protected:
     // used on client side
     bool _jointMappingCompleted;
     QVector<int> _jointMapping;
+    QVector<int> _clipCursors;
 
-    static Animation* getAnimation(const QString& url);
-    static QMap<QString, AnimationPointer> _loadedAnimations;
+    static Animation* getAnimation(const InternedString& url);
+    static QHash<InternedString, AnimationPointer> _loadedAnimations;
     static AnimationCache _animationCache;
 
 };
@@ -9,45 +9,60 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <Radix2InplaceSort.h>
+#include <Radix2IntegerScanner.h>
+
 #include "EntityItem.h"
 #include "EntityTree.h"
 #include "EntityTreeElement.h"
 
 #include "MovingEntitiesOperator.h"
 
-MovingEntitiesOperator::MovingEntitiesOperator(EntityTree* tree) :
-    _tree(tree),
-    _changeTime(usecTimestampNow()),
-    _foundOldCount(0),
-    _foundNewCount(0),
-    _lookingCount(0),
-    _wantDebug(false)
-{
-}
-
-MovingEntitiesOperator::~MovingEntitiesOperator() {
-    if (_wantDebug) {
-        bool stopExecution = false;
-        qDebug() << "MovingEntitiesOperator::~MovingEntitiesOperator() -----------------------------";
-        qDebug() << "    _lookingCount:" << _lookingCount;
-        qDebug() << "    _foundOldCount:" << _foundOldCount;
-        qDebug() << "    _foundNewCount:" << _foundNewCount;
-        if (_foundOldCount < _lookingCount) {
-            qDebug() << "    FAILURE: **** _foundOldCount < _lookingCount ******";
-            stopExecution = true;
-        }
-        if (_foundNewCount < _lookingCount) {
-            qDebug() << "    FAILURE: **** _foundNewCount < _lookingCount ******";
-            stopExecution = true;
+// 21 levels of three bits is as much of the path as a key holds, entities that go deeper than that only come out
+// of the sort grouped by their first 21 levels, which is all the walk down the tree needs from the order
+static const int DESTINATION_KEY_LEVELS = 21;
+static const int DESTINATION_KEY_BITS = 3 * DESTINATION_KEY_LEVELS;
+
+// spells out the same descent as EntityTreeElement::bestFitBounds() from the root, without the tree
+static quint64 destinationKeyFor(const AABox& newCubeClamped) {
+    const glm::vec3& minimum = newCubeClamped.getMinimumPoint();
+    glm::vec3 maximum = newCubeClamped.getMaximumPoint();
+    glm::vec3 corner(0.0f);
+    float scale = 1.0f;
+    quint64 key = 0;
+    for (int level = 0; level < DESTINATION_KEY_LEVELS; level++) {
+        float childScale = scale / 2.0f;
+        if (childScale <= SMALLEST_REASONABLE_OCTREE_ELEMENT_SCALE) {
+            break;
         }
-        qDebug() << "--------------------------------------------------------------------------";
-        if(stopExecution) {
-            debug();
-            assert(false);
+        glm::vec3 center = corner + glm::vec3(childScale);
+        glm::bvec3 minimumAbove = glm::greaterThan(minimum, center);
+        glm::bvec3 maximumAbove = glm::greaterThan(maximum, center);
+        if (minimumAbove != maximumAbove) {
+            break; // the corners are in two different children, this level is the best fit
         }
+        quint64 branch = (minimumAbove.x ? 4 : 0) | (minimumAbove.y ? 2 : 0) | (minimumAbove.z ? 1 : 0);
+        key |= branch << (DESTINATION_KEY_BITS - 3 * (level + 1));
+        corner += glm::vec3(minimumAbove) * childScale;
+        scale = childScale;
     }
+    return key;
 }
 
+class EntityToMoveDestinationOrder : public Radix2IntegerScanner<quint64> {
+public:
+    EntityToMoveDestinationOrder() : Radix2IntegerScanner<quint64>(DESTINATION_KEY_BITS) { }
+
+    bool bit(const EntityToMoveDetails& details, const state_type& state) const {
+        return !!(details.destinationKey & state);
+    }
+};
+
+MovingEntitiesOperator::MovingEntitiesOperator(EntityTree* tree) :
+    _tree(tree),
+    _wantDebug(false)
+{
+}
 
 void MovingEntitiesOperator::addEntityToMoveList(EntityItem* entity, const AACube& newCube) {
     EntityTreeElement* oldContainingElement = _tree->getContainingElement(entity->getEntityItemID());
@@ -75,26 +90,19 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItem* entity, const AACub
     // If the original containing element is the best fit for the requested newCube locations then
     // we don't actually need to add the entity for moving and we can short circuit all this work
     if (!oldContainingElement->bestFitBounds(newCubeClamped)) {
-        // check our tree, to determine if this entity is known
         EntityToMoveDetails details;
         details.oldContainingElement = oldContainingElement;
         details.oldContainingElementCube = oldContainingElement->getAACube();
         details.entity = entity;
-        details.oldFound = false;
-        details.newFound = false;
         details.newCube = newCube;
         details.newCubeClamped = newCubeClamped;
+        details.destinationKey = destinationKeyFor(newCubeClamped);
         _entitiesToMove << details;
-        _lookingCount++;
 
         if (_wantDebug) {
-            qDebug() << "MovingEntitiesOperator::addEntityToMoveList() -----------------------------";
             qDebug() << "    details.entity:" << details.entity->getEntityItemID();
             qDebug() << "    details.oldContainingElementCube:" << details.oldContainingElementCube;
-            qDebug() << "    details.newCube:" << details.newCube;
-            qDebug() << "    details.newCubeClamped:" << details.newCubeClamped;
-            qDebug() << "    _lookingCount:" << _lookingCount;
-            qDebug() << "--------------------------------------------------------------------------";
+            qDebug() << "    details.destinationKey:" << details.destinationKey;
         }
     } else {
         if (_wantDebug) {
@@ -107,183 +115,82 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItem* entity, const AACub
     }
 }
 
-// does this entity tree element contain the old entity
-bool MovingEntitiesOperator::shouldRecurseSubTree(OctreeElement* element) {
-    bool containsEntity = false;
-
-    // If we don't have an old entity, then we don't contain the entity, otherwise
-    // check the bounds
-    if (_entitiesToMove.size() > 0) {
-        AACube elementCube = element->getAACube();
-        int detailIndex = 0;
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-
-            if (_wantDebug) {
-                qDebug() << "MovingEntitiesOperator::shouldRecurseSubTree() details["<< detailIndex <<"]-----------------------------";
-                qDebug() << "    element:" << element->getAACube();
-                qDebug() << "    details.entity:" << details.entity->getEntityItemID();
-                qDebug() << "    details.oldContainingElementCube:" << details.oldContainingElementCube;
-                qDebug() << "    details.newCube:" << details.newCube;
-                qDebug() << "    details.newCubeClamped:" << details.newCubeClamped;
-                qDebug() << "    elementCube.contains(details.newCube)" << elementCube.contains(details.newCube);
-                qDebug() << "    elementCube.contains(details.newCubeClamped)" << elementCube.contains(details.newCubeClamped);
-                qDebug() << "--------------------------------------------------------------------------";
-            }
-
-            if (elementCube.contains(details.oldContainingElementCube) || elementCube.contains(details.newCubeClamped)) {
-                containsEntity = true;
-                break; // if it contains at least one, we're good to go
+EntityTreeElement* MovingEntitiesOperator::findDestination(const AABox& newCubeClamped) {
+    // _path holds the elements down to the last destination, as long as this entity goes the same way we reuse them
+    int depth = 0;
+    EntityTreeElement* element = _path[0];
+    while (!element->bestFitBounds(newCubeClamped)) {
+        int childIndex = element->getMyChildContaining(newCubeClamped);
+        if (childIndex == OctreeElement::CHILD_UNKNOWN) {
+            break; // can't happen when the element isn't the best fit, but don't walk off the tree
+        }
+        EntityTreeElement* child = element->getChildAtIndex(childIndex);
+        depth++;
+        if (!child || depth >= _path.size() || _path[depth] != child) {
+            _path.resize(depth);
+            if (!child) {
+                child = static_cast<EntityTreeElement*>(element->addChildAtIndex(childIndex));
             }
-            detailIndex++;
+            child->markWithChangedTime();
+            _path.append(child);
         }
+        element = child;
     }
-    return containsEntity;
+    return element;
 }
 
-bool MovingEntitiesOperator::preRecursion(OctreeElement* element) {
-    EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
-    
-    // In Pre-recursion, we're generally deciding whether or not we want to recurse this
-    // path of the tree. For this operation, we want to recurse the branch of the tree if
-    // and of the following are true:
-    //   * We have not yet found the old entity, and this branch contains our old entity
-    //   * We have not yet found the new entity, and this branch contains our new entity
-    //
-    // Note: it's often the case that the branch in question contains both the old entity
-    // and the new entity.
-    
-    bool keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
-
-    // If we haven't yet found all the entities, and this sub tree contains at least one of our
-    // entities, then we need to keep searching.
-    if (keepSearching && shouldRecurseSubTree(element)) {
-
-        // check against each of our search entities
-        int detailIndex = 0;
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-        
-            if (_wantDebug) {
-                qDebug() << "MovingEntitiesOperator::preRecursion() details["<< detailIndex <<"]-----------------------------";
-                qDebug() << "    entityTreeElement:" << entityTreeElement->getAACube();
-                qDebug() << "    entityTreeElement->bestFitBounds(details.newCube):" << entityTreeElement->bestFitBounds(details.newCube);
-                qDebug() << "    details.entity:" << details.entity->getEntityItemID();
-                qDebug() << "    details.oldContainingElementCube:" << details.oldContainingElementCube;
-                qDebug() << "    entityTreeElement:" << entityTreeElement;
-                qDebug() << "    details.newCube:" << details.newCube;
-                qDebug() << "    details.newCubeClamped:" << details.newCubeClamped;
-                qDebug() << "    _lookingCount:" << _lookingCount;
-                qDebug() << "    _foundOldCount:" << _foundOldCount;
-                qDebug() << "--------------------------------------------------------------------------";
-            }
-        
-
-            // If this is one of the old elements we're looking for, then ask it to remove the old entity
-            if (!details.oldFound && entityTreeElement == details.oldContainingElement) {
-                // DO NOT remove the entity here.  It will be removed when added to the destination element.
-                _foundOldCount++;
-                //details.oldFound = true; // TODO: would be nice to add this optimization
-                if (_wantDebug) {
-                    qDebug() << "MovingEntitiesOperator::preRecursion() -----------------------------";
-                    qDebug() << "    FOUND OLD - REMOVING";
-                    qDebug() << "    entityTreeElement == details.oldContainingElement";
-                    qDebug() << "--------------------------------------------------------------------------";
-                }
-            }
-
-            // If this element is the best fit for the new bounds of this entity then add the entity to the element
-            if (!details.newFound && entityTreeElement->bestFitBounds(details.newCube)) {
-                EntityItemID entityItemID = details.entity->getEntityItemID();
-                // remove from the old before adding
-                EntityTreeElement* oldElement = details.entity->getElement();
-                if (oldElement != entityTreeElement) {
-                    if (oldElement) {
-                        oldElement->removeEntityItem(details.entity);
-                    }
-                    entityTreeElement->addEntityItem(details.entity);
-                    _tree->setContainingElement(entityItemID, entityTreeElement);
-                }
-                _foundNewCount++;
-                //details.newFound = true; // TODO: would be nice to add this optimization
-                if (_wantDebug) {
-                    qDebug() << "MovingEntitiesOperator::preRecursion() -----------------------------";
-                    qDebug() << "    FOUND NEW - ADDING";
-                    qDebug() << "    entityTreeElement->bestFitBounds(details.newCube)";
-                    qDebug() << "--------------------------------------------------------------------------";
-                }
-            }
-            detailIndex++;
+void MovingEntitiesOperator::markAndPruneOldPath(const AACube& oldContainingElementCube) {
+    // the old element may already be pruned by an entity that left it before this one, so we follow its cube down
+    // and stop at the first missing child instead of holding on to the element
+    glm::vec3 oldCenter = oldContainingElementCube.calcCenter();
+    _path.resize(1);
+    EntityTreeElement* element = _path[0];
+    while (element->getScale() > oldContainingElementCube.getScale()) {
+        element = element->getChildAtIndex(element->getMyChildContainingPoint(oldCenter));
+        if (!element) {
+            break;
         }
-        // if we haven't found all of our search for entities, then keep looking
-        keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
+        element->markWithChangedTime();
+        _path.append(element);
     }
 
-    return keepSearching; // if we haven't yet found it, keep looking
+    // prune on the way back up, so an element emptied by pruning its children can itself be pruned by its parent
+    for (int i = _path.size() - 1; i >= 0; i--) {
+        _path[i]->pruneChildren();
+    }
 }
 
-bool MovingEntitiesOperator::postRecursion(OctreeElement* element) {
-    // Post-recursion is the unwinding process. For this operation, while we
-    // unwind we want to mark the path as being dirty if we changed it below.
-    // We might have two paths, one for the old entity and one for the new entity.
-    bool keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
-
-    // As we unwind, if we're in either of these two paths, we mark our element
-    // as dirty.
-    if ((shouldRecurseSubTree(element))) {
-        element->markWithChangedTime();
+void MovingEntitiesOperator::moveEntities() {
+    if (_entitiesToMove.isEmpty()) {
+        return;
     }
-    
+    radix2InplaceSort(_entitiesToMove.begin(), _entitiesToMove.end(), EntityToMoveDestinationOrder());
 
+    EntityTreeElement* root = _tree->getRoot();
+    root->markWithChangedTime();
+    _path.resize(0);
+    _path.append(root);
 
-    // It's not OK to prune if we have the potential of deleting the original containing element
-    // because if we prune the containing element then new might end up reallocating the same memory later 
-    // and that will confuse our logic.
-    // 
-    // it's ok to prune if:
-    // 2) this subtree doesn't contain any old elements
-    // 3) this subtree contains an old element, but this element isn't a direct parent of any old containing element
+    foreach (const EntityToMoveDetails& details, _entitiesToMove) {
+        EntityTreeElement* destination = findDestination(details.newCubeClamped);
 
-    bool elementSubTreeContainsOldElements = false;
-    bool elementIsDirectParentOfOldElment = false;
-    foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-        if (element->getAACube().contains(details.oldContainingElementCube)) {
-            elementSubTreeContainsOldElements = true;
-        }
-        if (element->isParentOf(details.oldContainingElement)) {
-            elementIsDirectParentOfOldElment = true;
+        // remove from the old before adding
+        EntityTreeElement* oldElement = details.entity->getElement();
+        if (oldElement != destination) {
+            if (oldElement) {
+                oldElement->removeEntityItem(details.entity);
+            }
+            destination->addEntityItem(details.entity);
+            _tree->setContainingElement(details.entity->getEntityItemID(), destination);
         }
     }
-    if (!elementSubTreeContainsOldElements || !elementIsDirectParentOfOldElment) {
-        EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
-        entityTreeElement->pruneChildren(); // take this opportunity to prune any empty leaves
-    }
-
-    return keepSearching; // if we haven't yet found it, keep looking
-}
 
-OctreeElement* MovingEntitiesOperator::possiblyCreateChildAt(OctreeElement* element, int childIndex) {
-    // If we're getting called, it's because there was no child element at this index while recursing.
-    // We only care if this happens while still searching for the new entity locations.
-    if (_foundNewCount < _lookingCount) {
-
-        float childElementScale = element->getAACube().getScale() / 2.0f; // all of our children will be half our scale
-    
-        // check against each of our entities
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-
-            // if the scale of our desired cube is smaller than our children, then consider making a child
-            if (details.newCubeClamped.getLargestDimension() <= childElementScale) {
-
-                int indexOfChildContainingNewEntity = element->getMyChildContaining(details.newCubeClamped);
-            
-                // If the childIndex we were asked if we wanted to create contains this newCube,
-                // then we will create this branch and continue. We can exit this loop immediately
-                // because if we need this branch for any one entity then it doesn't matter if it's
-                // needed for more entities.
-                if (childIndex == indexOfChildContainingNewEntity) {
-                    return element->addChildAtIndex(childIndex);
-                }
-            }
+    // every entity is in its new element before any pruning, so no element an entity still needs goes away
+    AACube lastOldContainingElementCube;
+    foreach (const EntityToMoveDetails& details, _entitiesToMove) {
+        if (details.oldContainingElementCube != lastOldContainingElementCube) {
+            markAndPruneOldPath(details.oldContainingElementCube);
+            lastOldContainingElementCube = details.oldContainingElementCube;
         }
     }
-    return NULL; 
 }
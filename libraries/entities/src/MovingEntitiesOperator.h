@@ -12,6 +12,15 @@
 #ifndef hifi_MovingEntitiesOperator_h
 #define hifi_MovingEntitiesOperator_h
 
+#include <QVector>
+
+#include <AABox.h>
+#include <AACube.h>
+
+class EntityItem;
+class EntityTree;
+class EntityTreeElement;
+
 class EntityToMoveDetails {
 public:
     EntityItem* entity;
@@ -20,37 +29,31 @@ public:
     AABox newCubeClamped;
     EntityTreeElement* oldContainingElement;
     AACube oldContainingElementCube;
-    bool oldFound;
-    bool newFound;
+    quint64 destinationKey; // the path to the new best fit element, three bits a level from the root down
 };
 
-inline uint qHash(const EntityToMoveDetails& a, uint seed) {
-    return qHash(a.entity->getEntityItemID(), seed);
-}
-
-inline bool operator==(const EntityToMoveDetails& a, const EntityToMoveDetails& b) {
-    return a.entity->getEntityItemID() == b.entity->getEntityItemID();
-}
-
-class MovingEntitiesOperator : public RecurseOctreeOperator {
+/// Moves the entities a simulation moved this frame into their new best fit elements. The entities are sorted by the
+/// path to their destination, so the walk down the tree for one entity picks up where the last one left off and each
+/// element along the way is marked once, instead of recursing the tree and checking every entity at every element.
+class MovingEntitiesOperator {
 public:
     MovingEntitiesOperator(EntityTree* tree);
-    ~MovingEntitiesOperator();
 
+    void reserve(int numberOfEntities) { _entitiesToMove.reserve(numberOfEntities); }
     void addEntityToMoveList(EntityItem* entity, const AACube& newCube);
-    virtual bool preRecursion(OctreeElement* element);
-    virtual bool postRecursion(OctreeElement* element);
-    virtual OctreeElement* possiblyCreateChildAt(OctreeElement* element, int childIndex);
     bool hasMovingEntities() const { return _entitiesToMove.size() > 0; }
+
+    /// moves every entity on the list, marks the old and new paths changed and prunes the emptied elements
+    void moveEntities();
+
 private:
+    EntityTreeElement* findDestination(const AABox& newCubeClamped);
+    void markAndPruneOldPath(const AACube& oldContainingElementCube);
+
     EntityTree* _tree;
-    QSet<EntityToMoveDetails> _entitiesToMove;
-    quint64 _changeTime;
-    int _foundOldCount;
-    int _foundNewCount;
-    int _lookingCount;
-    bool shouldRecurseSubTree(OctreeElement* element);
-    
+    QVector<EntityToMoveDetails> _entitiesToMove;
+    QVector<EntityTreeElement*> _path; // the elements from the root down to the last destination or old element
+
     bool _wantDebug;
 };
 
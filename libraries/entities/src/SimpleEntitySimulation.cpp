@@ -21,17 +21,40 @@ void SimpleEntitySimulation::updateEntitiesInternal(const quint64& now) {
         if (!entity->isMoving()) {
             itemItr = _movingEntities.erase(itemItr);
             _movableButStoppedEntities.insert(entity);
+        } else if (!entity->hasAngularVelocity()) {
+            // it stopped spinning, the arrays below take it from here
+            itemItr = _movingEntities.erase(itemItr);
+            _kinematicEntities.add(entity);
         } else {
             entity->simulate(now);
             _entitiesToBeSorted.insert(entity);
             ++itemItr;
         }
     }
+
+    QVector<EntityItem*> writtenBack;
+    QVector<EntityItem*> stopped;
+    _kinematicEntities.simulate(now, writtenBack, stopped);
+    foreach (EntityItem* entity, writtenBack) {
+        _entitiesToBeSorted.insert(entity);
+    }
+    foreach (EntityItem* entity, stopped) {
+        _entitiesToBeSorted.insert(entity);
+        _movableButStoppedEntities.insert(entity);
+    }
+}
+
+void SimpleEntitySimulation::addMovingEntity(EntityItem* entity) {
+    if (entity->hasAngularVelocity()) {
+        _movingEntities.insert(entity);
+    } else {
+        _kinematicEntities.add(entity);
+    }
 }
 
 void SimpleEntitySimulation::addEntityInternal(EntityItem* entity) {
     if (entity->isMoving()) {
-        _movingEntities.insert(entity);
+        addMovingEntity(entity);
     } else if (entity->getCollisionsWillMove()) {
         _movableButStoppedEntities.insert(entity);
     }
@@ -39,6 +62,7 @@ void SimpleEntitySimulation::addEntityInternal(EntityItem* entity) {
 
 void SimpleEntitySimulation::removeEntityInternal(EntityItem* entity) {
     _movingEntities.remove(entity);
+    _kinematicEntities.remove(entity);
     _movableButStoppedEntities.remove(entity);
 }
 
@@ -46,9 +70,17 @@ const int SIMPLE_SIMULATION_DIRTY_FLAGS = EntityItem::DIRTY_VELOCITY | EntityIte
 
 void SimpleEntitySimulation::entityChangedInternal(EntityItem* entity) {
     int dirtyFlags = entity->getDirtyFlags();
+    if (_kinematicEntities.contains(entity)
+            && (dirtyFlags & (SIMPLE_SIMULATION_DIRTY_FLAGS | EntityItem::DIRTY_POSITION))) {
+        // the entity hasn't been told where it got to, it keeps whatever part of its motion wasn't just changed
+        _kinematicEntities.writeBackAndRemove(entity, dirtyFlags & EntityItem::DIRTY_POSITION,
+                                              dirtyFlags & EntityItem::DIRTY_VELOCITY);
+        dirtyFlags |= EntityItem::DIRTY_VELOCITY;
+    }
     if (dirtyFlags & SIMPLE_SIMULATION_DIRTY_FLAGS) {
         if (entity->isMoving()) {
-            _movingEntities.insert(entity);
+            _movingEntities.remove(entity);
+            addMovingEntity(entity);
         } else if (entity->getCollisionsWillMove()) {
             _movableButStoppedEntities.remove(entity);
         } else {
@@ -61,6 +93,7 @@ void SimpleEntitySimulation::entityChangedInternal(EntityItem* entity) {
 
 void SimpleEntitySimulation::clearEntitiesInternal() {
     _movingEntities.clear();
+    _kinematicEntities.clear();
     _movableButStoppedEntities.clear();
 }
 
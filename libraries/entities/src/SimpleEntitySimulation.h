@@ -13,6 +13,7 @@
 #define hifi_SimpleEntitySimulation_h
 
 #include "EntitySimulation.h"
+#include "KinematicEntityArrays.h"
 
 /// provides simple velocity + gravity extrapolation of EntityItem's
 
@@ -28,7 +29,11 @@ protected:
     virtual void entityChangedInternal(EntityItem* entity);
     virtual void clearEntitiesInternal();
 
-    QSet<EntityItem*> _movingEntities;
+    /// adds a moving entity to _kinematicEntities, or to _movingEntities if it also spins
+    void addMovingEntity(EntityItem* entity);
+
+    QSet<EntityItem*> _movingEntities; // entities with an angular velocity, these simulate themselves
+    KinematicEntityArrays _kinematicEntities; // entities that only move in a line
     QSet<EntityItem*> _movableButStoppedEntities;
 };
 
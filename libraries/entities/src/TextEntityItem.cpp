@@ -45,6 +45,7 @@ void TextEntityItem::setDimensions(const glm::vec3& value) {
     float fixedDepth = 0.01f / (float)TREE_SCALE;
     _dimensions = glm::vec3(value.x, value.y, fixedDepth); 
     recalculateCollisionShape(); 
+    updateSpatialIndex();
 }
 
 EntityItemProperties TextEntityItem::getProperties() const {
@@ -49,6 +49,9 @@ public:
                          bool& keepSearching, OctreeElement*& element, float& distance, BoxFace& face, 
                          void** intersectedObject, bool precisionPicking) const;
 
+    // text that shifts under the reader's eye is easy to notice, keep it close
+    virtual float getMaxExtrapolationError() const { return 0.01f; }
+
     static const QString DEFAULT_TEXT;
     void setText(const QString& value) { _text = value; }
     const QString& getText() const { return _text; }
@@ -9,12 +9,16 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
 #include <iostream>
 #include <QBuffer>
 #include <QDataStream>
 #include <QIODevice>
+#include <QRunnable>
+#include <QSharedPointer>
 #include <QStringList>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QtDebug>
 #include <QtEndian>
 
@@ -1027,6 +1031,51 @@ void setTangents(FBXMesh& mesh, int firstIndex, int secondIndex) {
         glm::normalize(bitangent), normalizedNormal);
 }
 
+void computeTangents(FBXMesh& mesh) {
+    foreach (const FBXMeshPart& part, mesh.parts) {
+        for (int i = 0; i < part.quadIndices.size(); i += 4) {
+            setTangents(mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
+            setTangents(mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
+            setTangents(mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
+            setTangents(mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
+        }
+        // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0 
+        // This is most likely evidence of a further problem in extractMesh()
+        for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
+            setTangents(mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
+            setTangents(mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
+            setTangents(mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
+        }
+        if ((part.triangleIndices.size() % 3) != 0){
+            qDebug() << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
+        }
+    }
+}
+
+/// Extracts a mesh on the extraction pool while the rest of the document is read.  The node and the extracted mesh
+/// must outlive the run.
+class MeshExtractor : public QRunnable {
+public:
+    MeshExtractor(const FBXNode& object, ExtractedMesh& extracted) : _object(object), _extracted(extracted) { }
+
+    virtual void run() { _extracted = extractMesh(_object); }
+
+private:
+    const FBXNode& _object;
+    ExtractedMesh& _extracted;
+};
+
+/// Computes the tangents of a mesh on the extraction pool, each mesh on its own.
+class TangentGenerator : public QRunnable {
+public:
+    TangentGenerator(FBXMesh& mesh) : _mesh(mesh) { }
+
+    virtual void run() { computeTangents(_mesh); }
+
+private:
+    FBXMesh& _mesh;
+};
+
 QVector<int> getIndices(const QVector<QString> ids, QVector<QString> modelIDs) {
     QVector<int> indices;
     foreach (const QString& id, ids) {
@@ -1205,6 +1254,11 @@ FBXLight extractLight(const FBXNode& object) {
 FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping, bool loadLightmaps, float lightmapLevel) {
     QHash<QString, ExtractedMesh> meshes;
     QHash<QString, QString> modelIDsToNames;
+
+    // meshes are extracted on a pool of our own as their nodes come up, since the reader itself runs on the global one
+    QThreadPool extractionPool;
+    QVector<QString> pendingMeshIDs;
+    QVector<QSharedPointer<ExtractedMesh> > pendingMeshes;
     QHash<QString, int> meshIDsToMeshIndices;
     QHash<QString, QString> ooChildToParent;
 
@@ -1334,7 +1388,10 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object));
+                        QSharedPointer<ExtractedMesh> extracted(new ExtractedMesh());
+                        pendingMeshIDs.append(getID(object.properties));
+                        pendingMeshes.append(extracted);
+                        extractionPool.start(new MeshExtractor(object, *extracted));
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1840,6 +1897,11 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
         }
     }
 
+    extractionPool.waitForDone();
+    for (int i = 0; i < pendingMeshes.size(); i++) {
+        meshes.insert(pendingMeshIDs.at(i), *pendingMeshes.at(i));
+    }
+
     // assign the blendshapes to their corresponding meshes
     foreach (const ExtractedBlendshape& extracted, blendshapes) {
         QString blendshapeChannelID = parentMap.value(extracted.id);
@@ -2007,6 +2069,7 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
     // see if any materials have texture children
     bool materialsHaveTextures = checkMaterialsHaveTextures(materials, textureFilenames, childMap);
     
+    QVector<int> tangentMeshIndices;
     for (QHash<QString, ExtractedMesh>::iterator it = meshes.begin(); it != meshes.end(); it++) {
         ExtractedMesh& extracted = it.value();
         
@@ -2141,24 +2204,7 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
         // if we have a normal map (and texture coordinates), we must compute tangents
         if (generateTangents && !extracted.mesh.texCoords.isEmpty()) {
             extracted.mesh.tangents.resize(extracted.mesh.vertices.size());
-            foreach (const FBXMeshPart& part, extracted.mesh.parts) {
-                for (int i = 0; i < part.quadIndices.size(); i += 4) {
-                    setTangents(extracted.mesh, part.quadIndices.at(i), part.quadIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 1), part.quadIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 2), part.quadIndices.at(i + 3));
-                    setTangents(extracted.mesh, part.quadIndices.at(i + 3), part.quadIndices.at(i));
-                }
-                // <= size - 3 in order to prevent overflowing triangleIndices when (i % 3) != 0 
-                // This is most likely evidence of a further problem in extractMesh()
-                for (int i = 0; i <= part.triangleIndices.size() - 3; i += 3) {
-                    setTangents(extracted.mesh, part.triangleIndices.at(i), part.triangleIndices.at(i + 1));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 1), part.triangleIndices.at(i + 2));
-                    setTangents(extracted.mesh, part.triangleIndices.at(i + 2), part.triangleIndices.at(i));
-                }
-                if ((part.triangleIndices.size() % 3) != 0){
-                    qDebug() << "Error in extractFBXGeometry part.triangleIndices.size() is not divisible by three ";
-                }
-            }
+            tangentMeshIndices.append(geometry.meshes.size());
         }
 
         // find the clusters with which the mesh is associated
@@ -2348,6 +2394,12 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
 
     }
 
+    // the tangents of each mesh only depend on that mesh, so they're computed side by side
+    foreach (int meshIndex, tangentMeshIndices) {
+        extractionPool.start(new TangentGenerator(geometry.meshes[meshIndex]));
+    }
+    extractionPool.waitForDone();
+
     // now that all joints have been scanned, compute a collision shape for each joint
     glm::vec3 defaultCapsuleAxis(0.0f, 1.0f, 0.0f);
     for (int i = 0; i < geometry.joints.size(); ++i) {
@@ -2506,3 +2558,362 @@ FBXGeometry readFBX(const QByteArray& model, const QVariantHash& mapping, bool l
 FBXGeometry readFBX(QIODevice* device, const QVariantHash& mapping, bool loadLightmaps, float lightmapLevel) {
     return extractFBXGeometry(parseFBX(device), mapping, loadLightmaps, lightmapLevel);
 }
+
+// the cached form starts with this id and version, which goes up whenever FBXGeometry or its extraction changes
+const char CACHED_FBX_ID[4] = { 'H', 'F', 'G', 'C' };
+const quint32 CACHED_FBX_VERSION = 1;
+
+// plain values and arrays of them go in as their bytes, the cache is only ever read back on the machine that wrote it
+template<typename T> static void writeCachedValue(QDataStream& out, const T& value) {
+    out.writeRawData(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T> static void readCachedValue(QDataStream& in, T& value) {
+    if (in.readRawData(reinterpret_cast<char*>(&value), sizeof(T)) != (int)sizeof(T)) {
+        throw QString("cached geometry is truncated");
+    }
+}
+
+template<typename T> static void writeCachedArray(QDataStream& out, const QVector<T>& array) {
+    out << (qint32)array.size();
+    out.writeRawData(reinterpret_cast<const char*>(array.constData()), array.size() * sizeof(T));
+}
+
+template<typename T> static void readCachedArray(QDataStream& in, QVector<T>& array) {
+    qint32 size;
+    in >> size;
+    if (in.status() != QDataStream::Ok || size < 0 || size > in.device()->bytesAvailable() / (qint64)sizeof(T)) {
+        throw QString("cached geometry is truncated");
+    }
+    array.resize(size);
+    in.readRawData(reinterpret_cast<char*>(array.data()), size * sizeof(T));
+}
+
+template<typename T> static void writeCachedList(QDataStream& out, const QVector<T>& list) {
+    out << (qint32)list.size();
+    foreach (const T& element, list) {
+        writeCached(out, element);
+    }
+}
+
+template<typename T> static void readCachedList(QDataStream& in, QVector<T>& list) {
+    qint32 size;
+    in >> size;
+    if (in.status() != QDataStream::Ok || size < 0 || size > in.device()->bytesAvailable()) {
+        throw QString("cached geometry is truncated");
+    }
+    list.resize(size);
+    for (int i = 0; i < size; i++) {
+        readCached(in, list[i]);
+    }
+}
+
+static void writeCached(QDataStream& out, const Transform& transform) {
+    writeCachedValue(out, transform.getTranslation());
+    writeCachedValue(out, transform.getRotation());
+    writeCachedValue(out, transform.getScale());
+}
+
+static void readCached(QDataStream& in, Transform& transform) {
+    Transform::Vec3 translation, scale;
+    Transform::Quat rotation;
+    readCachedValue(in, translation);
+    readCachedValue(in, rotation);
+    readCachedValue(in, scale);
+    transform.setTranslation(translation);
+    transform.setRotation(rotation);
+    transform.setScale(scale);
+}
+
+static void writeCached(QDataStream& out, const FBXTexture& texture) {
+    out << texture.name << texture.filename << texture.content;
+    writeCached(out, texture.transform);
+    out << (qint32)texture.texcoordSet << texture.texcoordSetName;
+}
+
+static void readCached(QDataStream& in, FBXTexture& texture) {
+    qint32 texcoordSet;
+    in >> texture.name >> texture.filename >> texture.content;
+    readCached(in, texture.transform);
+    in >> texcoordSet >> texture.texcoordSetName;
+    texture.texcoordSet = texcoordSet;
+}
+
+static void writeCached(QDataStream& out, const FBXMeshPart& part) {
+    writeCachedArray(out, part.quadIndices);
+    writeCachedArray(out, part.triangleIndices);
+    writeCachedValue(out, part.diffuseColor);
+    writeCachedValue(out, part.specularColor);
+    writeCachedValue(out, part.emissiveColor);
+    writeCachedValue(out, part.emissiveParams);
+    writeCachedValue(out, part.shininess);
+    writeCachedValue(out, part.opacity);
+    writeCached(out, part.diffuseTexture);
+    writeCached(out, part.normalTexture);
+    writeCached(out, part.specularTexture);
+    writeCached(out, part.emissiveTexture);
+    out << part.materialID << !part._material.isNull();
+}
+
+static void readCached(QDataStream& in, FBXMeshPart& part) {
+    readCachedArray(in, part.quadIndices);
+    readCachedArray(in, part.triangleIndices);
+    readCachedValue(in, part.diffuseColor);
+    readCachedValue(in, part.specularColor);
+    readCachedValue(in, part.emissiveColor);
+    readCachedValue(in, part.emissiveParams);
+    readCachedValue(in, part.shininess);
+    readCachedValue(in, part.opacity);
+    readCached(in, part.diffuseTexture);
+    readCached(in, part.normalTexture);
+    readCached(in, part.specularTexture);
+    readCached(in, part.emissiveTexture);
+    bool hasMaterial;
+    in >> part.materialID >> hasMaterial;
+    if (hasMaterial) {
+        // a placeholder until readCachedFBX gives the parts of each material one material again
+        part._material = model::MaterialPointer(new model::Material());
+    }
+}
+
+static void writeCached(QDataStream& out, const FBXCluster& cluster) {
+    out << (qint32)cluster.jointIndex;
+    writeCachedValue(out, cluster.inverseBindMatrix);
+}
+
+static void readCached(QDataStream& in, FBXCluster& cluster) {
+    qint32 jointIndex;
+    in >> jointIndex;
+    readCachedValue(in, cluster.inverseBindMatrix);
+    cluster.jointIndex = jointIndex;
+}
+
+static void writeCached(QDataStream& out, const FBXBlendshape& blendshape) {
+    writeCachedArray(out, blendshape.indices);
+    writeCachedArray(out, blendshape.vertices);
+    writeCachedArray(out, blendshape.normals);
+}
+
+static void readCached(QDataStream& in, FBXBlendshape& blendshape) {
+    readCachedArray(in, blendshape.indices);
+    readCachedArray(in, blendshape.vertices);
+    readCachedArray(in, blendshape.normals);
+}
+
+static void writeCached(QDataStream& out, const FBXMesh& mesh) {
+    writeCachedList(out, mesh.parts);
+    writeCachedArray(out, mesh.vertices);
+    writeCachedArray(out, mesh.normals);
+    writeCachedArray(out, mesh.tangents);
+    writeCachedArray(out, mesh.colors);
+    writeCachedArray(out, mesh.texCoords);
+    writeCachedArray(out, mesh.texCoords1);
+    writeCachedArray(out, mesh.clusterIndices);
+    writeCachedArray(out, mesh.clusterWeights);
+    writeCachedList(out, mesh.clusters);
+    writeCachedValue(out, mesh.meshExtents);
+    writeCachedValue(out, mesh.modelTransform);
+    out << mesh.isEye;
+    writeCachedList(out, mesh.blendshapes);
+}
+
+static void readCached(QDataStream& in, FBXMesh& mesh) {
+    readCachedList(in, mesh.parts);
+    readCachedArray(in, mesh.vertices);
+    readCachedArray(in, mesh.normals);
+    readCachedArray(in, mesh.tangents);
+    readCachedArray(in, mesh.colors);
+    readCachedArray(in, mesh.texCoords);
+    readCachedArray(in, mesh.texCoords1);
+    readCachedArray(in, mesh.clusterIndices);
+    readCachedArray(in, mesh.clusterWeights);
+    readCachedList(in, mesh.clusters);
+    readCachedValue(in, mesh.meshExtents);
+    readCachedValue(in, mesh.modelTransform);
+    in >> mesh.isEye;
+    readCachedList(in, mesh.blendshapes);
+}
+
+static void writeCached(QDataStream& out, const FBXJoint& joint) {
+    out << joint.isFree;
+    writeCachedArray(out, joint.freeLineage);
+    out << (qint32)joint.parentIndex;
+    writeCachedValue(out, joint.distanceToParent);
+    writeCachedValue(out, joint.boneRadius);
+    writeCachedValue(out, joint.translation);
+    writeCachedValue(out, joint.preTransform);
+    writeCachedValue(out, joint.preRotation);
+    writeCachedValue(out, joint.rotation);
+    writeCachedValue(out, joint.postRotation);
+    writeCachedValue(out, joint.postTransform);
+    writeCachedValue(out, joint.transform);
+    writeCachedValue(out, joint.rotationMin);
+    writeCachedValue(out, joint.rotationMax);
+    writeCachedValue(out, joint.inverseDefaultRotation);
+    writeCachedValue(out, joint.inverseBindRotation);
+    writeCachedValue(out, joint.bindTransform);
+    out << joint.name;
+    writeCachedValue(out, joint.shapePosition);
+    writeCachedValue(out, joint.shapeRotation);
+    out << (qint32)joint.shapeType << joint.isSkeletonJoint;
+}
+
+static void readCached(QDataStream& in, FBXJoint& joint) {
+    qint32 parentIndex, shapeType;
+    in >> joint.isFree;
+    readCachedArray(in, joint.freeLineage);
+    in >> parentIndex;
+    readCachedValue(in, joint.distanceToParent);
+    readCachedValue(in, joint.boneRadius);
+    readCachedValue(in, joint.translation);
+    readCachedValue(in, joint.preTransform);
+    readCachedValue(in, joint.preRotation);
+    readCachedValue(in, joint.rotation);
+    readCachedValue(in, joint.postRotation);
+    readCachedValue(in, joint.postTransform);
+    readCachedValue(in, joint.transform);
+    readCachedValue(in, joint.rotationMin);
+    readCachedValue(in, joint.rotationMax);
+    readCachedValue(in, joint.inverseDefaultRotation);
+    readCachedValue(in, joint.inverseBindRotation);
+    readCachedValue(in, joint.bindTransform);
+    in >> joint.name;
+    readCachedValue(in, joint.shapePosition);
+    readCachedValue(in, joint.shapeRotation);
+    in >> shapeType >> joint.isSkeletonJoint;
+    joint.parentIndex = parentIndex;
+    joint.shapeType = (ShapeType)shapeType;
+}
+
+static void writeCached(QDataStream& out, const FBXAnimationFrame& frame) {
+    writeCachedArray(out, frame.rotations);
+}
+
+static void readCached(QDataStream& in, FBXAnimationFrame& frame) {
+    readCachedArray(in, frame.rotations);
+}
+
+static void writeCached(QDataStream& out, const FBXAttachment& attachment) {
+    out << (qint32)attachment.jointIndex << attachment.url;
+    writeCachedValue(out, attachment.translation);
+    writeCachedValue(out, attachment.rotation);
+    writeCachedValue(out, attachment.scale);
+}
+
+static void readCached(QDataStream& in, FBXAttachment& attachment) {
+    qint32 jointIndex;
+    in >> jointIndex >> attachment.url;
+    readCachedValue(in, attachment.translation);
+    readCachedValue(in, attachment.rotation);
+    readCachedValue(in, attachment.scale);
+    attachment.jointIndex = jointIndex;
+}
+
+static void writeCached(QDataStream& out, const SittingPoint& sittingPoint) {
+    out << sittingPoint.name;
+    writeCachedValue(out, sittingPoint.position);
+    writeCachedValue(out, sittingPoint.rotation);
+}
+
+static void readCached(QDataStream& in, SittingPoint& sittingPoint) {
+    in >> sittingPoint.name;
+    readCachedValue(in, sittingPoint.position);
+    readCachedValue(in, sittingPoint.rotation);
+}
+
+QByteArray writeCachedFBX(const FBXGeometry& geometry) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.writeRawData(CACHED_FBX_ID, sizeof(CACHED_FBX_ID));
+    out << CACHED_FBX_VERSION;
+
+    out << geometry.author << geometry.applicationName;
+    writeCachedList(out, geometry.joints);
+    out << geometry.jointIndices << geometry.hasSkeletonJoints;
+    writeCachedList(out, geometry.meshes);
+    writeCachedValue(out, geometry.offset);
+    out << (qint32)geometry.leftEyeJointIndex << (qint32)geometry.rightEyeJointIndex
+        << (qint32)geometry.neckJointIndex << (qint32)geometry.rootJointIndex << (qint32)geometry.leanJointIndex
+        << (qint32)geometry.headJointIndex << (qint32)geometry.leftHandJointIndex
+        << (qint32)geometry.rightHandJointIndex << (qint32)geometry.leftToeJointIndex
+        << (qint32)geometry.rightToeJointIndex;
+    writeCachedArray(out, geometry.humanIKJointIndices);
+    writeCachedValue(out, geometry.palmDirection);
+    writeCachedList(out, geometry.sittingPoints);
+    writeCachedValue(out, geometry.neckPivot);
+    writeCachedValue(out, geometry.bindExtents);
+    writeCachedValue(out, geometry.meshExtents);
+    writeCachedList(out, geometry.animationFrames);
+    writeCachedList(out, geometry.attachments);
+    out << geometry.meshIndicesToModelNames;
+    return data;
+}
+
+FBXGeometry readCachedFBX(const QByteArray& data) {
+    QDataStream in(data);
+    char id[sizeof(CACHED_FBX_ID)];
+    quint32 version;
+    if (in.readRawData(id, sizeof(id)) != (int)sizeof(id) || memcmp(id, CACHED_FBX_ID, sizeof(id)) != 0) {
+        throw QString("not cached geometry");
+    }
+    in >> version;
+    if (version != CACHED_FBX_VERSION) {
+        throw QString("cached geometry is from another version");
+    }
+
+    FBXGeometry geometry;
+    in >> geometry.author >> geometry.applicationName;
+    readCachedList(in, geometry.joints);
+    in >> geometry.jointIndices >> geometry.hasSkeletonJoints;
+    readCachedList(in, geometry.meshes);
+    readCachedValue(in, geometry.offset);
+    qint32 jointIndices[10];
+    for (int i = 0; i < 10; i++) {
+        in >> jointIndices[i];
+    }
+    geometry.leftEyeJointIndex = jointIndices[0];
+    geometry.rightEyeJointIndex = jointIndices[1];
+    geometry.neckJointIndex = jointIndices[2];
+    geometry.rootJointIndex = jointIndices[3];
+    geometry.leanJointIndex = jointIndices[4];
+    geometry.headJointIndex = jointIndices[5];
+    geometry.leftHandJointIndex = jointIndices[6];
+    geometry.rightHandJointIndex = jointIndices[7];
+    geometry.leftToeJointIndex = jointIndices[8];
+    geometry.rightToeJointIndex = jointIndices[9];
+    readCachedArray(in, geometry.humanIKJointIndices);
+    readCachedValue(in, geometry.palmDirection);
+    readCachedList(in, geometry.sittingPoints);
+    readCachedValue(in, geometry.neckPivot);
+    readCachedValue(in, geometry.bindExtents);
+    readCachedValue(in, geometry.meshExtents);
+    readCachedList(in, geometry.animationFrames);
+    readCachedList(in, geometry.attachments);
+    in >> geometry.meshIndicesToModelNames;
+    if (in.status() != QDataStream::Ok) {
+        throw QString("cached geometry is truncated");
+    }
+
+    // the parts of a material share one, as they do when extracted, which the renderer relies on to batch them
+    QHash<QString, model::MaterialPointer> materials;
+    for (int i = 0; i < geometry.meshes.size(); i++) {
+        FBXMesh& mesh = geometry.meshes[i];
+        for (int j = 0; j < mesh.parts.size(); j++) {
+            FBXMeshPart& part = mesh.parts[j];
+            if (part._material.isNull()) {
+                continue;
+            }
+            model::MaterialPointer& material = materials[part.materialID];
+            if (material.isNull()) {
+                material = part._material;
+                material->setEmissive(part.emissiveColor);
+                material->setDiffuse(part.diffuseColor);
+                material->setSpecular(part.specularColor);
+                material->setShininess(part.shininess);
+                material->setOpacity(part.opacity);
+            }
+            part._material = material;
+        }
+    }
+    return geometry;
+}
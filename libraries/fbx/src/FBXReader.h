@@ -280,4 +280,12 @@ FBXGeometry readFBX(const QByteArray& model, const QVariantHash& mapping, bool l
 /// \exception QString if an error occurs in parsing
 FBXGeometry readFBX(QIODevice* device, const QVariantHash& mapping, bool loadLightmaps = true, float lightmapLevel = 1.0f);
 
+/// Writes FBX geometry in a binary form that readCachedFBX reads back without parsing or extracting anything. The form
+/// is tied to this version of the reader and to the machine's byte order, so it is only good for a local cache.
+QByteArray writeCachedFBX(const FBXGeometry& geometry);
+
+/// Reads FBX geometry written by writeCachedFBX.
+/// \exception QString if the data is from another version, truncated or not cached geometry at all
+FBXGeometry readCachedFBX(const QByteArray& data);
+
 #endif // hifi_FBXReader_h
@@ -0,0 +1,349 @@
+//
+//  MeshSimplifier.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <queue>
+#include <vector>
+
+#include <QHash>
+
+#include <SharedUtil.h>
+
+#include "MeshSimplifier.h"
+
+// meshes smaller than this are left as they are
+static const int MIN_SIMPLIFIED_TRIANGLES = 64;
+
+// a collapse may not turn a triangle further than about 75 degrees from where it faced
+static const float MIN_COLLAPSED_NORMAL_DOT = 0.25f;
+
+/// The error quadric of a vertex: the weighted sum of the squared distances to the planes of the triangles around it.
+class Quadric {
+public:
+    Quadric() { for (int i = 0; i < VALUE_COUNT; i++) { _values[i] = 0.0; } }
+
+    void addPlane(const glm::vec3& normal, float distance, float weight);
+    void add(const Quadric& other) { for (int i = 0; i < VALUE_COUNT; i++) { _values[i] += other._values[i]; } }
+
+    double evaluate(const glm::vec3& point) const;
+
+private:
+    static const int VALUE_COUNT = 10;
+
+    // the upper triangle of the symmetric 4x4 matrix, row by row
+    double _values[VALUE_COUNT];
+};
+
+void Quadric::addPlane(const glm::vec3& normal, float distance, float weight) {
+    double a = normal.x, b = normal.y, c = normal.z, d = distance;
+    _values[0] += weight * a * a;
+    _values[1] += weight * a * b;
+    _values[2] += weight * a * c;
+    _values[3] += weight * a * d;
+    _values[4] += weight * b * b;
+    _values[5] += weight * b * c;
+    _values[6] += weight * b * d;
+    _values[7] += weight * c * c;
+    _values[8] += weight * c * d;
+    _values[9] += weight * d * d;
+}
+
+double Quadric::evaluate(const glm::vec3& point) const {
+    double x = point.x, y = point.y, z = point.z;
+    return _values[0] * x * x + 2.0 * _values[1] * x * y + 2.0 * _values[2] * x * z + 2.0 * _values[3] * x +
+        _values[4] * y * y + 2.0 * _values[5] * y * z + 2.0 * _values[6] * y +
+        _values[7] * z * z + 2.0 * _values[8] * z + _values[9];
+}
+
+/// A candidate collapse of one vertex onto another, stale once either vertex has changed since it was queued.
+class EdgeCollapse {
+public:
+    double cost;
+    int from;
+    int to;
+    int fromVersion;
+    int toVersion;
+
+    // the queue is a max heap, so the cheapest collapse compares as the greatest
+    bool operator<(const EdgeCollapse& other) const { return cost > other.cost; }
+};
+
+/// The triangles using an edge, and the part they're in, or -1 if they're in different parts.
+class EdgeUse {
+public:
+    int count;
+    int part;
+};
+
+static quint64 getEdgeKey(int first, int second) {
+    return first < second ? ((quint64)first << 32) | (quint32)second : ((quint64)second << 32) | (quint32)first;
+}
+
+template<class T> static QVector<T> keepValues(const QVector<T>& values, const QVector<int>& keptVertices,
+        int vertexCount) {
+    QVector<T> kept;
+    if (values.size() != vertexCount) {
+        return kept;
+    }
+    kept.reserve(keptVertices.size());
+    foreach (int index, keptVertices) {
+        kept.append(values.at(index));
+    }
+    return kept;
+}
+
+static FBXMesh simplifyMesh(const FBXMesh& mesh, float ratio) {
+    // gather the triangles of every part, splitting the quads
+    QVector<int> corners;
+    QVector<int> triangleParts;
+    for (int i = 0; i < mesh.parts.size(); i++) {
+        const FBXMeshPart& part = mesh.parts.at(i);
+        for (int j = 0; j <= part.quadIndices.size() - 4; j += 4) {
+            corners << part.quadIndices.at(j) << part.quadIndices.at(j + 1) << part.quadIndices.at(j + 2);
+            corners << part.quadIndices.at(j) << part.quadIndices.at(j + 2) << part.quadIndices.at(j + 3);
+            triangleParts << i << i;
+        }
+        for (int j = 0; j <= part.triangleIndices.size() - 3; j += 3) {
+            corners << part.triangleIndices.at(j) << part.triangleIndices.at(j + 1) << part.triangleIndices.at(j + 2);
+            triangleParts << i;
+        }
+    }
+    int triangleCount = triangleParts.size();
+    int targetCount = (int)(triangleCount * ratio);
+    if (triangleCount < MIN_SIMPLIFIED_TRIANGLES || targetCount >= triangleCount) {
+        return mesh;
+    }
+
+    // open edges, texture seams (where the vertices are split) and part borders are locked in place
+    int vertexCount = mesh.vertices.size();
+    QHash<quint64, EdgeUse> edgeUses;
+    QVector<QVector<int> > vertexTriangles(vertexCount);
+    QVector<Quadric> quadrics(vertexCount);
+    for (int i = 0; i < triangleCount; i++) {
+        const int* triangle = corners.constData() + i * 3;
+        for (int j = 0; j < 3; j++) {
+            quint64 key = getEdgeKey(triangle[j], triangle[(j + 1) % 3]);
+            QHash<quint64, EdgeUse>::iterator use = edgeUses.find(key);
+            if (use == edgeUses.end()) {
+                EdgeUse newUse = { 1, triangleParts.at(i) };
+                edgeUses.insert(key, newUse);
+            } else {
+                use.value().count++;
+                if (use.value().part != triangleParts.at(i)) {
+                    use.value().part = -1;
+                }
+            }
+            vertexTriangles[triangle[j]].append(i);
+        }
+        const glm::vec3& first = mesh.vertices.at(triangle[0]);
+        glm::vec3 normal = glm::cross(mesh.vertices.at(triangle[1]) - first, mesh.vertices.at(triangle[2]) - first);
+        float length = glm::length(normal);
+        if (length > EPSILON) {
+            // weighted by area so that slivers count for less
+            normal /= length;
+            for (int j = 0; j < 3; j++) {
+                quadrics[triangle[j]].addPlane(normal, -glm::dot(normal, first), length * 0.5f);
+            }
+        }
+    }
+    QVector<bool> locked(vertexCount, false);
+    for (QHash<quint64, EdgeUse>::const_iterator it = edgeUses.constBegin(); it != edgeUses.constEnd(); it++) {
+        if (it.value().count != 2 || it.value().part == -1) {
+            locked[(int)(it.key() >> 32)] = true;
+            locked[(int)(it.key() & 0xFFFFFFFF)] = true;
+        }
+    }
+
+    QVector<int> versions(vertexCount, 0);
+    QVector<int> collapsedInto(vertexCount, -1);
+    QVector<bool> liveTriangles(triangleCount, true);
+    std::priority_queue<EdgeCollapse> collapses;
+    for (QHash<quint64, EdgeUse>::const_iterator it = edgeUses.constBegin(); it != edgeUses.constEnd(); it++) {
+        int first = (int)(it.key() >> 32);
+        int second = (int)(it.key() & 0xFFFFFFFF);
+        Quadric sum = quadrics.at(first);
+        sum.add(quadrics.at(second));
+        if (!locked.at(first)) {
+            EdgeCollapse collapse = { sum.evaluate(mesh.vertices.at(second)), first, second, 0, 0 };
+            collapses.push(collapse);
+        }
+        if (!locked.at(second)) {
+            EdgeCollapse collapse = { sum.evaluate(mesh.vertices.at(first)), second, first, 0, 0 };
+            collapses.push(collapse);
+        }
+    }
+
+    int liveTriangleCount = triangleCount;
+    QVector<int> neighbors;
+    while (liveTriangleCount > targetCount && !collapses.empty()) {
+        EdgeCollapse collapse = collapses.top();
+        collapses.pop();
+        if (collapsedInto.at(collapse.from) != -1 || collapsedInto.at(collapse.to) != -1 ||
+                versions.at(collapse.from) != collapse.fromVersion || versions.at(collapse.to) != collapse.toVersion) {
+            continue;
+        }
+
+        // reject the collapse if it would fold any of the triangles that keep their area
+        const glm::vec3& destination = mesh.vertices.at(collapse.to);
+        bool folds = false;
+        foreach (int triangleIndex, vertexTriangles.at(collapse.from)) {
+            const int* triangle = corners.constData() + triangleIndex * 3;
+            if (!liveTriangles.at(triangleIndex) ||
+                    triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                continue;
+            }
+            glm::vec3 points[3];
+            for (int i = 0; i < 3; i++) {
+                points[i] = mesh.vertices.at(triangle[i]);
+            }
+            glm::vec3 oldNormal = glm::cross(points[1] - points[0], points[2] - points[0]);
+            for (int i = 0; i < 3; i++) {
+                if (triangle[i] == collapse.from) {
+                    points[i] = destination;
+                }
+            }
+            glm::vec3 newNormal = glm::cross(points[1] - points[0], points[2] - points[0]);
+            float lengths = glm::length(oldNormal) * glm::length(newNormal);
+            if (lengths < EPSILON || glm::dot(oldNormal, newNormal) < MIN_COLLAPSED_NORMAL_DOT * lengths) {
+                folds = true;
+                break;
+            }
+        }
+        if (folds) {
+            continue;
+        }
+
+        foreach (int triangleIndex, vertexTriangles.at(collapse.from)) {
+            if (!liveTriangles.at(triangleIndex)) {
+                continue;
+            }
+            int* triangle = corners.data() + triangleIndex * 3;
+            if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                liveTriangles[triangleIndex] = false;
+                liveTriangleCount--;
+                continue;
+            }
+            for (int i = 0; i < 3; i++) {
+                if (triangle[i] == collapse.from) {
+                    triangle[i] = collapse.to;
+                }
+            }
+            vertexTriangles[collapse.to].append(triangleIndex);
+        }
+        vertexTriangles[collapse.from].clear();
+        collapsedInto[collapse.from] = collapse.to;
+        quadrics[collapse.to].add(quadrics.at(collapse.from));
+        int toVersion = ++versions[collapse.to];
+
+        // requeue the edges around the vertex that grew, dropping the triangles it no longer has on the way
+        QVector<int>& toTriangles = vertexTriangles[collapse.to];
+        neighbors.clear();
+        for (int i = toTriangles.size() - 1; i >= 0; i--) {
+            if (!liveTriangles.at(toTriangles.at(i))) {
+                toTriangles.remove(i);
+                continue;
+            }
+            const int* triangle = corners.constData() + toTriangles.at(i) * 3;
+            for (int j = 0; j < 3; j++) {
+                if (triangle[j] != collapse.to && !neighbors.contains(triangle[j])) {
+                    neighbors.append(triangle[j]);
+                }
+            }
+        }
+        foreach (int neighbor, neighbors) {
+            Quadric sum = quadrics.at(collapse.to);
+            sum.add(quadrics.at(neighbor));
+            if (!locked.at(collapse.to)) {
+                EdgeCollapse outward = { sum.evaluate(mesh.vertices.at(neighbor)), collapse.to, neighbor,
+                    toVersion, versions.at(neighbor) };
+                collapses.push(outward);
+            }
+            if (!locked.at(neighbor)) {
+                EdgeCollapse inward = { sum.evaluate(destination), neighbor, collapse.to,
+                    versions.at(neighbor), toVersion };
+                collapses.push(inward);
+            }
+        }
+    }
+
+    // keep the vertices the remaining triangles use, in their original order
+    QVector<int> newIndices(vertexCount, -1);
+    for (int i = 0; i < triangleCount; i++) {
+        if (liveTriangles.at(i)) {
+            for (int j = 0; j < 3; j++) {
+                newIndices[corners.at(i * 3 + j)] = 0;
+            }
+        }
+    }
+    QVector<int> keptVertices;
+    for (int i = 0; i < vertexCount; i++) {
+        if (newIndices.at(i) != -1) {
+            newIndices[i] = keptVertices.size();
+            keptVertices.append(i);
+        }
+    }
+
+    FBXMesh simplified = mesh;
+    simplified.vertices = keepValues(mesh.vertices, keptVertices, vertexCount);
+    simplified.normals = keepValues(mesh.normals, keptVertices, vertexCount);
+    simplified.tangents = keepValues(mesh.tangents, keptVertices, vertexCount);
+    simplified.colors = keepValues(mesh.colors, keptVertices, vertexCount);
+    simplified.texCoords = keepValues(mesh.texCoords, keptVertices, vertexCount);
+    simplified.texCoords1 = keepValues(mesh.texCoords1, keptVertices, vertexCount);
+    simplified.clusterIndices = keepValues(mesh.clusterIndices, keptVertices, vertexCount);
+    simplified.clusterWeights = keepValues(mesh.clusterWeights, keptVertices, vertexCount);
+
+    for (int i = 0; i < simplified.parts.size(); i++) {
+        simplified.parts[i].quadIndices.clear();
+        simplified.parts[i].triangleIndices.clear();
+    }
+    for (int i = 0; i < triangleCount; i++) {
+        if (liveTriangles.at(i)) {
+            QVector<int>& triangleIndices = simplified.parts[triangleParts.at(i)].triangleIndices;
+            for (int j = 0; j < 3; j++) {
+                triangleIndices.append(newIndices.at(corners.at(i * 3 + j)));
+            }
+        }
+    }
+
+    // the offsets of the vertices that went away go with them
+    for (int i = 0; i < simplified.blendshapes.size(); i++) {
+        const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+        FBXBlendshape& simplifiedBlendshape = simplified.blendshapes[i];
+        simplifiedBlendshape = FBXBlendshape();
+        for (int j = 0; j < blendshape.indices.size(); j++) {
+            int index = blendshape.indices.at(j);
+            if (index >= 0 && index < vertexCount && newIndices.at(index) != -1 && j < blendshape.vertices.size() &&
+                    j < blendshape.normals.size()) {
+                simplifiedBlendshape.indices.append(newIndices.at(index));
+                simplifiedBlendshape.vertices.append(blendshape.vertices.at(j));
+                simplifiedBlendshape.normals.append(blendshape.normals.at(j));
+            }
+        }
+    }
+    return simplified;
+}
+
+int getFBXTriangleCount(const FBXGeometry& geometry) {
+    int count = 0;
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        foreach (const FBXMeshPart& part, mesh.parts) {
+            count += part.quadIndices.size() / 2 + part.triangleIndices.size() / 3;
+        }
+    }
+    return count;
+}
+
+FBXGeometry simplifyFBXGeometry(const FBXGeometry& geometry, float ratio) {
+    FBXGeometry simplified = geometry;
+    for (int i = 0; i < simplified.meshes.size(); i++) {
+        simplified.meshes[i] = simplifyMesh(geometry.meshes.at(i), ratio);
+    }
+    return simplified;
+}
@@ -0,0 +1,25 @@
+//
+//  MeshSimplifier.h
+//  libraries/fbx/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshSimplifier_h
+#define hifi_MeshSimplifier_h
+
+#include "FBXReader.h"
+
+/// Returns the number of triangles in the geometry, counting each quad as two.
+int getFBXTriangleCount(const FBXGeometry& geometry);
+
+/// Reduces the triangles of every mesh in the geometry by quadric edge collapse, for use as a generated LOD.  Each
+/// collapse keeps one of the edge's vertices, so texture coordinates, skinning and blendshapes carry over as they are,
+/// and vertices on open edges, texture seams and part borders stay where they are.
+/// \param ratio the fraction of each mesh's triangles to keep
+FBXGeometry simplifyFBXGeometry(const FBXGeometry& geometry, float ratio);
+
+#endif // hifi_MeshSimplifier_h
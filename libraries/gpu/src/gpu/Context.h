@@ -40,6 +40,11 @@ public:
 
     void syncGPUObject(const Buffer& buffer);
 
+    // Frees the sysmem copy of a gpu resident buffer once the backend's copy is up to date
+    static void releaseSysmem(const Buffer& buffer) {
+        buffer.releaseSysmem();
+    }
+
     template< typename T >
     static void setGPUObject(const Texture& texture, T* to) {
         texture.setGPUObject(reinterpret_cast<GPUObject*>(to));
@@ -69,9 +69,13 @@ GLBackend::CommandCall GLBackend::_commandCalls[Batch::NUM_COMMANDS] =
     (&::gpu::GLBackend::do_glColor4f),
 };
 
+GLBackend::Stats GLBackend::_stats;
+Resource::Size GLBackend::_textureMemory = 0;
+
 GLBackend::GLBackend() :
     _input(),
-    _transform()
+    _transform(),
+    _glState()
 {
 
 }
@@ -95,6 +99,111 @@ void GLBackend::renderBatch(Batch& batch) {
     }
 }
 
+void GLBackend::renderBatch(Batch& batch, const Transform& viewCorrection) {
+    uint32 numCommands = batch.getCommands().size();
+    const Batch::Commands::value_type* command = batch.getCommands().data();
+    const Batch::CommandOffsets::value_type* offset = batch.getCommandOffsets().data();
+
+    GLBackend backend;
+    backend._transform._viewCorrection = viewCorrection;
+    backend._transform._correctView = true;
+
+    for (unsigned int i = 0; i < numCommands; i++) {
+        CommandCall call = _commandCalls[(*command)];
+        (backend.*(call))(batch, *offset);
+        command++;
+        offset++;
+    }
+}
+
+void GLBackend::countStateChange(bool changed) {
+    if (changed) {
+        _stats._stateChanges++;
+    } else {
+        _stats._redundantStateChanges++;
+    }
+}
+
+bool GLBackend::changeCapability(std::map<GLenum, bool>& capabilities, GLenum capability, bool enabled) {
+    std::map<GLenum, bool>::iterator known = capabilities.find(capability);
+    if (known != capabilities.end() && known->second == enabled) {
+        countStateChange(false);
+        return false;
+    }
+    capabilities[capability] = enabled;
+    countStateChange(true);
+    return true;
+}
+
+void GLBackend::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* bound = (target == GL_ARRAY_BUFFER) ? &_glState._arrayBuffer :
+        (target == GL_ELEMENT_ARRAY_BUFFER) ? &_glState._elementArrayBuffer : NULL;
+    if (bound && *bound == buffer) {
+        countStateChange(false);
+        return;
+    }
+    glBindBuffer(target, buffer);
+    if (bound) {
+        *bound = buffer;
+    }
+    countStateChange(true);
+}
+
+void GLBackend::activeTexture(GLenum texture) {
+    if (_glState._activeTexture == texture) {
+        countStateChange(false);
+        return;
+    }
+    glActiveTexture(texture);
+    _glState._activeTexture = texture;
+    countStateChange(true);
+}
+
+void GLBackend::bindTexture(GLenum target, GLuint texture) {
+    // only the 2d binding of the units we know to be active is cached
+    GLuint* bound = NULL;
+    int unit = _glState._activeTexture - GL_TEXTURE0;
+    if (target == GL_TEXTURE_2D && _glState._activeTexture != 0 && unit < MAX_NUM_CACHED_TEXTURE_UNITS) {
+        bound = &_glState._textures[unit];
+    }
+    if (bound && *bound == texture) {
+        countStateChange(false);
+        return;
+    }
+    glBindTexture(target, texture);
+    if (bound) {
+        *bound = texture;
+    }
+    countStateChange(true);
+}
+
+bool GLBackend::changeUniform(GLint location, GLfloat v0, GLfloat v1) {
+    if (!_glState._programKnown) {
+        countStateChange(true);
+        return true;
+    }
+    std::pair<GLfloat, GLfloat> value(v0, v1);
+    std::pair<GLuint, GLint> key(_shader._program, location);
+    GLStateCache::UniformValues::iterator known = _glState._uniformValues.find(key);
+    if (known != _glState._uniformValues.end() && known->second == value) {
+        countStateChange(false);
+        return false;
+    }
+    _glState._uniformValues[key] = value;
+    countStateChange(true);
+    return true;
+}
+
+GLuint GLBackend::syncBuffer(const Buffer& buffer) {
+    // uploading goes through the array buffer binding
+    uint32 uploads = _stats._bufferUploads;
+    GLuint id = getBufferID(buffer);
+    if (_stats._bufferUploads != uploads) {
+        _glState._arrayBuffer = UNKNOWN_NAME;
+    }
+    return id;
+}
+
 void GLBackend::checkGLError() {
     GLenum error = glGetError();
     if (!error) {
@@ -137,6 +246,7 @@ void GLBackend::do_draw(Batch& batch, uint32 paramOffset) {
     uint32 startVertex = batch._params[paramOffset + 0]._uint;
 
     glDrawArrays(mode, startVertex, numVertices);
+    _stats._draws++;
     CHECK_GL_ERROR();
 }
 
@@ -152,6 +262,7 @@ void GLBackend::do_drawIndexed(Batch& batch, uint32 paramOffset) {
     GLenum glType = _elementTypeToGLType[_input._indexBufferType];
 
     glDrawElements(mode, numIndices, glType, reinterpret_cast<GLvoid*>(startIndex + _input._indexBufferOffset));
+    _stats._draws++;
     CHECK_GL_ERROR();
 }
 
@@ -257,8 +368,8 @@ void GLBackend::updateInput() {
                     int bufferNum = (*channelIt).first;
 
                     if (_input._buffersState.test(bufferNum) || _input._invalidFormat) {
-                        GLuint vbo = gpu::GLBackend::getBufferID((*buffers[bufferNum]));
-                        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+                        GLuint vbo = syncBuffer((*buffers[bufferNum]));
+                        bindBuffer(GL_ARRAY_BUFFER, vbo);
                         CHECK_GL_ERROR();
                         _input._buffersState[bufferNum] = false;
 
@@ -366,9 +477,9 @@ void GLBackend::do_setIndexBuffer(Batch& batch, uint32 paramOffset) {
     _input._indexBufferOffset = batch._params[paramOffset + 0]._uint;
     _input._indexBuffer = indexBuffer;
     if (indexBuffer) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getBufferID(*indexBuffer));
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, syncBuffer(*indexBuffer));
     } else {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
     CHECK_GL_ERROR();
 }
@@ -381,7 +492,12 @@ void GLBackend::do_setModelTransform(Batch& batch, uint32 paramOffset) {
 }
 
 void GLBackend::do_setViewTransform(Batch& batch, uint32 paramOffset) {
-    _transform._view = batch._transforms.get(batch._params[paramOffset]._uint);
+    if (_transform._correctView) {
+        Transform::mult(_transform._view, batch._transforms.get(batch._params[paramOffset]._uint),
+                        _transform._viewCorrection);
+    } else {
+        _transform._view = batch._transforms.get(batch._params[paramOffset]._uint);
+    }
     _transform._invalidView = true;
 }
 
@@ -449,7 +565,7 @@ void GLBackend::do_setUniformBuffer(Batch& batch, uint32 paramOffset) {
     // GLuint bo = getBufferID(*uniformBuffer);
     //glUniformBufferEXT(_shader._program, slot, bo);
 #elif defined(Q_OS_WIN)
-    GLuint bo = getBufferID(*uniformBuffer);
+    GLuint bo = syncBuffer(*uniformBuffer);
     glBindBufferRange(GL_UNIFORM_BUFFER, slot, bo, rangeStart, rangeSize);
 #else
     GLfloat* data = (GLfloat*) (uniformBuffer->getData() + rangeStart);
@@ -463,8 +579,8 @@ void GLBackend::do_setUniformTexture(Batch& batch, uint32 paramOffset) {
     TexturePointer uniformTexture = batch._textures.get(batch._params[paramOffset + 0]._uint);
 
     GLuint to = getTextureID(uniformTexture);
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, to);
+    activeTexture(GL_TEXTURE0 + slot);
+    bindTexture(GL_TEXTURE_2D, to);
 
     CHECK_GL_ERROR();
 }
@@ -488,7 +604,10 @@ void Batch::_glEnable(GLenum cap) {
     DO_IT_NOW(_glEnable, 1);
 }
 void GLBackend::do_glEnable(Batch& batch, uint32 paramOffset) {
-    glEnable(batch._params[paramOffset]._uint);
+    GLenum capability = batch._params[paramOffset]._uint;
+    if (changeCapability(_glState._capabilities, capability, true)) {
+        glEnable(capability);
+    }
     CHECK_GL_ERROR();
 }
 
@@ -500,7 +619,10 @@ void Batch::_glDisable(GLenum cap) {
     DO_IT_NOW(_glDisable, 1);
 }
 void GLBackend::do_glDisable(Batch& batch, uint32 paramOffset) {
-    glDisable(batch._params[paramOffset]._uint);
+    GLenum capability = batch._params[paramOffset]._uint;
+    if (changeCapability(_glState._capabilities, capability, false)) {
+        glDisable(capability);
+    }
     CHECK_GL_ERROR();
 }
 
@@ -536,7 +658,12 @@ void Batch::_glCullFace(GLenum mode) {
     DO_IT_NOW(_glCullFace, 1);
 }
 void GLBackend::do_glCullFace(Batch& batch, uint32 paramOffset) {
-    glCullFace(batch._params[paramOffset]._uint);
+    GLenum mode = batch._params[paramOffset]._uint;
+    countStateChange(mode != _glState._cullFace);
+    if (mode != _glState._cullFace) {
+        glCullFace(mode);
+        _glState._cullFace = mode;
+    }
     CHECK_GL_ERROR();
 }
 
@@ -549,9 +676,15 @@ void Batch::_glAlphaFunc(GLenum func, GLclampf ref) {
     DO_IT_NOW(_glAlphaFunc, 2);
 }
 void GLBackend::do_glAlphaFunc(Batch& batch, uint32 paramOffset) {
-    glAlphaFunc(
-        batch._params[paramOffset + 1]._uint,
-        batch._params[paramOffset + 0]._float);
+    GLenum func = batch._params[paramOffset + 1]._uint;
+    GLclampf ref = batch._params[paramOffset + 0]._float;
+    bool changed = (func != _glState._alphaFunc || ref != _glState._alphaRef);
+    countStateChange(changed);
+    if (changed) {
+        glAlphaFunc(func, ref);
+        _glState._alphaFunc = func;
+        _glState._alphaRef = ref;
+    }
     CHECK_GL_ERROR();
 }
 
@@ -563,7 +696,12 @@ void Batch::_glDepthFunc(GLenum func) {
     DO_IT_NOW(_glDepthFunc, 1);
 }
 void GLBackend::do_glDepthFunc(Batch& batch, uint32 paramOffset) {
-    glDepthFunc(batch._params[paramOffset]._uint);
+    GLenum func = batch._params[paramOffset]._uint;
+    countStateChange(func != _glState._depthFunc);
+    if (func != _glState._depthFunc) {
+        glDepthFunc(func);
+        _glState._depthFunc = func;
+    }
     CHECK_GL_ERROR();
 }
 
@@ -575,7 +713,12 @@ void Batch::_glDepthMask(GLboolean flag) {
     DO_IT_NOW(_glDepthMask, 1);
 }
 void GLBackend::do_glDepthMask(Batch& batch, uint32 paramOffset) {
-    glDepthMask(batch._params[paramOffset]._uint);
+    int flag = batch._params[paramOffset]._uint ? GL_TRUE : GL_FALSE;
+    countStateChange(flag != _glState._depthMask);
+    if (flag != _glState._depthMask) {
+        glDepthMask(flag);
+        _glState._depthMask = flag;
+    }
     CHECK_GL_ERROR();
 }
 
@@ -603,7 +746,7 @@ void Batch::_glBindBuffer(GLenum target, GLuint buffer) {
     DO_IT_NOW(_glBindBuffer, 2);
 }
 void GLBackend::do_glBindBuffer(Batch& batch, uint32 paramOffset) {
-    glBindBuffer(
+    bindBuffer(
         batch._params[paramOffset + 1]._uint,
         batch._params[paramOffset + 0]._uint);
     CHECK_GL_ERROR();
@@ -618,7 +761,7 @@ void Batch::_glBindTexture(GLenum target, GLuint texture) {
     DO_IT_NOW(_glBindTexture, 2);
 }
 void GLBackend::do_glBindTexture(Batch& batch, uint32 paramOffset) {
-    glBindTexture(
+    bindTexture(
         batch._params[paramOffset + 1]._uint,
         batch._params[paramOffset + 0]._uint);
     CHECK_GL_ERROR();
@@ -632,7 +775,7 @@ void Batch::_glActiveTexture(GLenum texture) {
     DO_IT_NOW(_glActiveTexture, 1);
 }
 void GLBackend::do_glActiveTexture(Batch& batch, uint32 paramOffset) {
-    glActiveTexture(batch._params[paramOffset]._uint);
+    activeTexture(batch._params[paramOffset]._uint);
     CHECK_GL_ERROR();
 }
 
@@ -659,9 +802,14 @@ void Batch::_glUseProgram(GLuint program) {
     DO_IT_NOW(_glUseProgram, 1);
 }
 void GLBackend::do_glUseProgram(Batch& batch, uint32 paramOffset) {
-    
-    _shader._program = batch._params[paramOffset]._uint;
-    glUseProgram(_shader._program);
+    GLuint program = batch._params[paramOffset]._uint;
+    bool changed = !_glState._programKnown || program != _shader._program;
+    countStateChange(changed);
+    if (changed) {
+        _shader._program = program;
+        _glState._programKnown = true;
+        glUseProgram(_shader._program);
+    }
 
     CHECK_GL_ERROR();
 }
@@ -675,9 +823,11 @@ void Batch::_glUniform1f(GLint location, GLfloat v0) {
     DO_IT_NOW(_glUniform1f, 1);
 }
 void GLBackend::do_glUniform1f(Batch& batch, uint32 paramOffset) {
-    glUniform1f(
-        batch._params[paramOffset + 1]._int,
-        batch._params[paramOffset + 0]._float);
+    GLint location = batch._params[paramOffset + 1]._int;
+    GLfloat v0 = batch._params[paramOffset + 0]._float;
+    if (changeUniform(location, v0, 0.0f)) {
+        glUniform1f(location, v0);
+    }
     CHECK_GL_ERROR();
 }
 
@@ -691,10 +841,12 @@ void Batch::_glUniform2f(GLint location, GLfloat v0, GLfloat v1) {
     DO_IT_NOW(_glUniform2f, 1);
 }
 void GLBackend::do_glUniform2f(Batch& batch, uint32 paramOffset) {
-    glUniform2f(
-        batch._params[paramOffset + 2]._int,
-        batch._params[paramOffset + 1]._float,
-        batch._params[paramOffset + 0]._float);
+    GLint location = batch._params[paramOffset + 2]._int;
+    GLfloat v0 = batch._params[paramOffset + 1]._float;
+    GLfloat v1 = batch._params[paramOffset + 0]._float;
+    if (changeUniform(location, v0, v1)) {
+        glUniform2f(location, v0, v1);
+    }
     CHECK_GL_ERROR();
 }
 
@@ -751,6 +903,7 @@ void GLBackend::do_glDrawArrays(Batch& batch, uint32 paramOffset) {
         batch._params[paramOffset + 2]._uint,
         batch._params[paramOffset + 1]._int,
         batch._params[paramOffset + 0]._int);
+    _stats._draws++;
     CHECK_GL_ERROR();
 }
 
@@ -774,6 +927,7 @@ void GLBackend::do_glDrawRangeElements(Batch& batch, uint32 paramOffset) {
         batch._params[paramOffset + 2]._int,
         batch._params[paramOffset + 1]._uint,
         batch.editResource(batch._params[paramOffset + 0]._uint)->_pointer);
+    _stats._draws++;
     CHECK_GL_ERROR();
 }
 
@@ -921,7 +1075,8 @@ void GLBackend::do_glColor4f(Batch& batch, uint32 paramOffset) {
 GLBackend::GLBuffer::GLBuffer() :
     _stamp(0),
     _buffer(0),
-    _size(0)
+    _size(0),
+    _streamEnd(0)
 {}
 
 GLBackend::GLBuffer::~GLBuffer() {
@@ -946,14 +1101,41 @@ void GLBackend::syncGPUObject(const Buffer& buffer) {
     }
 
     // Now let's update the content of the bo with the sysmem version
-    // TODO: in the future, be smarter about when to actually upload the glBO version based on the data that did change
-    //if () {
+    // a buffer only streamed into since the last sync just needs the bytes of the stream run we don't have yet
     glBindBuffer(GL_ARRAY_BUFFER, object->_buffer);
-    glBufferData(GL_ARRAY_BUFFER, buffer.getSysmem().getSize(), buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
+    bool streamed = (object->_size == buffer.getSysmem().getSize()
+        && buffer.getSysmem().getStamp() == buffer.getStreamStamp());
+    if (streamed && object->_stamp >= buffer.getStreamRunStamp()) {
+        GLuint size = buffer.getStreamEnd() - object->_streamEnd;
+        glBufferSubData(GL_ARRAY_BUFFER, object->_streamEnd, size, buffer.getSysmem().readData() + object->_streamEnd);
+        _stats._bytesUploaded += size;
+
+    } else if (object->_size == buffer.getSysmem().getSize() && buffer.getSysmem().getStamp() == buffer.getUpdateStamp()
+            && object->_stamp >= buffer.getUpdateBaseStamp()) {
+        // only updated in place since we last synced, upload the range the updates cover
+        GLuint size = buffer.getUpdateEnd() - buffer.getUpdateBegin();
+        glBufferSubData(GL_ARRAY_BUFFER, buffer.getUpdateBegin(), size,
+            buffer.getSysmem().readData() + buffer.getUpdateBegin());
+        _stats._bytesUploaded += size;
+
+    } else if (streamed && buffer.getStreamBegin() == 0) {
+        // the stream started over, orphan the storage the draws in flight read from rather than wait for them
+        glBufferData(GL_ARRAY_BUFFER, object->_size, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, buffer.getStreamEnd(), buffer.getSysmem().readData());
+        _stats._bytesUploaded += buffer.getStreamEnd();
+
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, buffer.getSysmem().getSize(), buffer.getSysmem().readData(), GL_DYNAMIC_DRAW);
+        _stats._bytesUploaded += buffer.getSysmem().getSize();
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _stats._bufferUploads++;
     object->_stamp = buffer.getSysmem().getStamp();
     object->_size = buffer.getSysmem().getSize();
-    //}
+    object->_streamEnd = (object->_stamp == buffer.getStreamStamp()) ? buffer.getStreamEnd() : 0;
+    if (buffer.isGPUResident()) {
+        Backend::releaseSysmem(buffer);
+    }
     CHECK_GL_ERROR();
 }
 
@@ -17,6 +17,7 @@
 #include "Context.h"
 #include "Batch.h"
 #include <bitset>
+#include <map>
 
 
 namespace gpu {
@@ -29,14 +30,51 @@ public:
 
     static void renderBatch(Batch& batch);
 
+    /// Draws a batch recorded from one view as seen from another, such as the second eye of a stereo frame.  Each view
+    /// transform the batch sets is followed by the correction, which takes the recorded view to the one to draw from.
+    static void renderBatch(Batch& batch, const Transform& viewCorrection);
+
     static void checkGLError();
 
+    /// What the backends did since the stats were last reset, the Stats overlay shows them for every frame.
+    class Stats {
+    public:
+        uint32 _draws;
+        uint32 _stateChanges; // state commands handed to gl
+        uint32 _redundantStateChanges; // state commands dropped because gl already had that state
+        uint32 _bufferUploads;
+        uint32 _textureUploads;
+        uint32 _bytesUploaded;
+
+        Stats() :
+            _draws(0),
+            _stateChanges(0),
+            _redundantStateChanges(0),
+            _bufferUploads(0),
+            _textureUploads(0),
+            _bytesUploaded(0) {}
+    };
+    static const Stats& getStats() { return _stats; }
+    static void resetStats() { _stats = Stats(); }
+
+    /// The bytes of texture memory the textures synced to gl take up, mips included
+    static Resource::Size getTextureMemory() { return _textureMemory; }
+
+    /// The bytes of texture memory one texture synced to gl takes up, mips included, 0 if it isn't resident
+    static Resource::Size getTextureSize(const Texture& texture);
+
+    /// Drops the largest mip of a resident mipmapped texture so the next one becomes its whole image, giving back three
+    /// quarters of its memory. The mip is read back from gl, which waits on pending work, so call it sparingly.
+    /// \return the bytes given back, 0 if the texture isn't resident, has no mips or is no bigger than minimumSize
+    static Resource::Size shrinkTexture(const Texture& texture, uint16 minimumSize);
+
 
     class GLBuffer {
     public:
         Stamp _stamp;
         GLuint _buffer;
         GLuint _size;
+        GLuint _streamEnd; // how far the buffer's current stream run was uploaded
 
         GLBuffer();
         ~GLBuffer();
@@ -50,6 +88,9 @@ public:
         Stamp _contentStamp;
         GLuint _texture;
         GLuint _size;
+        GLuint _width;
+        GLuint _height;
+        bool _mipmapped;
 
         GLTexture();
         ~GLTexture();
@@ -118,6 +159,8 @@ protected:
         Transform _model;
         Transform _view;
         Transform _projection;
+        Transform _viewCorrection;
+        bool _correctView;
         bool _invalidModel;
         bool _invalidView;
         bool _invalidProj;
@@ -128,12 +171,66 @@ protected:
             _model(),
             _view(),
             _projection(),
+            _viewCorrection(),
+            _correctView(false),
             _invalidModel(true),
             _invalidView(true),
             _invalidProj(true),
             _lastMode(GL_TEXTURE) {}
     } _transform;
 
+    // What this backend last handed gl, so the commands that would not change anything can be dropped. A backend
+    // lives for one batch and gl may be changed by anyone in between batches, so the cache starts out knowing nothing.
+    static const GLuint UNKNOWN_NAME = 0xFFFFFFFF;
+    static const int MAX_NUM_CACHED_TEXTURE_UNITS = 8;
+
+    bool changeCapability(std::map<GLenum, bool>& capabilities, GLenum capability, bool enabled);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void activeTexture(GLenum texture);
+    void bindTexture(GLenum target, GLuint texture);
+    void countStateChange(bool changed);
+    GLuint syncBuffer(const Buffer& buffer);
+
+    struct GLStateCache {
+        std::map<GLenum, bool> _capabilities;
+
+        GLenum _cullFace; // 0 when unknown, like the funcs
+        GLenum _alphaFunc;
+        GLclampf _alphaRef;
+        GLenum _depthFunc;
+        int _depthMask; // -1 when unknown
+
+        GLuint _arrayBuffer;
+        GLuint _elementArrayBuffer;
+
+        GLenum _activeTexture;
+        GLuint _textures[MAX_NUM_CACHED_TEXTURE_UNITS];
+
+        bool _programKnown;
+        typedef std::map<std::pair<GLuint, GLint>, std::pair<GLfloat, GLfloat> > UniformValues;
+        UniformValues _uniformValues; // the 1f and 2f uniforms of the programs, by program and location
+
+        GLStateCache() :
+            _cullFace(0),
+            _alphaFunc(0),
+            _alphaRef(0.0f),
+            _depthFunc(0),
+            _depthMask(-1),
+            _arrayBuffer(UNKNOWN_NAME),
+            _elementArrayBuffer(UNKNOWN_NAME),
+            _activeTexture(0),
+            _programKnown(false) {
+            for (int i = 0; i < MAX_NUM_CACHED_TEXTURE_UNITS; i++) {
+                _textures[i] = UNKNOWN_NAME;
+            }
+        }
+    } _glState;
+
+    bool changeUniform(GLint location, GLfloat v0, GLfloat v1);
+
+    static Stats _stats;
+    static Resource::Size _textureMemory;
+
     // Shader Stage
     void do_setUniformBuffer(Batch& batch, uint32 paramOffset);
     void do_setUniformTexture(Batch& batch, uint32 paramOffset);
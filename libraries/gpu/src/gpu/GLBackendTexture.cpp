@@ -15,13 +15,17 @@ GLBackend::GLTexture::GLTexture() :
     _storageStamp(0),
     _contentStamp(0),
     _texture(0),
-    _size(0)
+    _size(0),
+    _width(0),
+    _height(0),
+    _mipmapped(false)
 {}
 
 GLBackend::GLTexture::~GLTexture() {
     if (_texture != 0) {
         glDeleteTextures(1, &_texture);
     }
+    _textureMemory -= _size;
 }
 
 class GLTexelFormat {
@@ -279,6 +283,8 @@ void GLBackend::syncGPUObject(const Texture& texture) {
 
                 glBindTexture(GL_TEXTURE_2D, boundTex);
                 object->_contentStamp = texture.getDataStamp();
+                _stats._textureUploads++;
+                _stats._bytesUploaded += mip->_sysmem.getSize();
             }
         } else {
             const GLvoid* bytes = 0;
@@ -312,7 +318,16 @@ void GLBackend::syncGPUObject(const Texture& texture) {
 
             glBindTexture(GL_TEXTURE_2D, boundTex);
             object->_storageStamp = texture.getStamp();
-            object->_size = texture.getSize();
+            _stats._textureUploads++;
+            _stats._bytesUploaded += texture.getSize();
+
+            // a full chain of mips takes another third
+            object->_mipmapped = (bytes && texture.isAutogenerateMips());
+            GLuint size = object->_mipmapped ? texture.getSize() + texture.getSize() / 3 : texture.getSize();
+            _textureMemory += size - object->_size;
+            object->_size = size;
+            object->_width = texture.getWidth();
+            object->_height = texture.getHeight();
         }
         break;
     }
@@ -324,6 +339,43 @@ void GLBackend::syncGPUObject(const Texture& texture) {
 
 
 
+Resource::Size GLBackend::shrinkTexture(const Texture& texture, uint16 minimumSize) {
+    GLTexture* object = Backend::getGPUObject<GLBackend::GLTexture>(texture);
+    if (!object || !object->_mipmapped || object->_width <= minimumSize || object->_height <= minimumSize) {
+        return 0;
+    }
+
+    GLint boundTex = -1;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTex);
+    glBindTexture(GL_TEXTURE_2D, object->_texture);
+
+    // the second mip is the texture at half the size already, it becomes the first and the rest are made again
+    GLint internalFormat = GL_RGBA;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    GLuint width = object->_width / 2;
+    GLuint height = object->_height / 2;
+    const int BYTES_PER_READ_TEXEL = 4;
+    std::vector<GLubyte> texels(width * height * BYTES_PER_READ_TEXEL);
+    glGetTexImage(GL_TEXTURE_2D, 1, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, boundTex);
+    CHECK_GL_ERROR();
+
+    Resource::Size freed = object->_size - object->_size / 4;
+    _textureMemory -= freed;
+    object->_size /= 4;
+    object->_width = width;
+    object->_height = height;
+    return freed;
+}
+
+Resource::Size GLBackend::getTextureSize(const Texture& texture) {
+    GLTexture* object = Backend::getGPUObject<GLBackend::GLTexture>(texture);
+    return object ? object->_size : 0;
+}
+
 GLuint GLBackend::getTextureID(const TexturePointer& texture) {
     if (!texture) {
         return 0;
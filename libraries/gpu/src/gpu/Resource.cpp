@@ -12,6 +12,8 @@
 #include "Context.h"
 #include "Resource.h"
 
+#include <algorithm>
+
 #include <QDebug>
 
 using namespace gpu;
@@ -170,6 +172,11 @@ Resource::Size Resource::Sysmem::append(Size size, const Byte* bytes) {
     return 0;
 }
 
+void Resource::Sysmem::release() {
+    deallocateMemory(_data, _size);
+    _data = NULL;
+}
+
 Buffer::Buffer() :
     Resource(),
     _sysmem(new Sysmem()),
@@ -220,3 +227,35 @@ Buffer::Size Buffer::append(Size size, const Byte* data) {
     return editSysmem().append( size, data);
 }
 
+Buffer::Size Buffer::streamSubData(Size offset, Size size, const Byte* data) {
+    bool continuesRun = (offset != 0 && offset == _streamEnd && getSysmem().getStamp() == _streamStamp);
+    Size copied = editSysmem().setSubData(offset, size, data);
+    if (copied) {
+        if (!continuesRun) {
+            _streamBegin = offset;
+            _streamRunStamp = getSysmem().getStamp();
+        }
+        _streamEnd = offset + size;
+        _streamStamp = getSysmem().getStamp();
+    }
+    return copied;
+}
+
+Buffer::Size Buffer::updateSubData(Size offset, Size size, const Byte* data) {
+    bool continuesRun = (getSysmem().getStamp() == _updateStamp);
+    Stamp baseStamp = getSysmem().getStamp();
+    Size copied = editSysmem().setSubData(offset, size, data);
+    if (copied) {
+        if (continuesRun) {
+            _updateBegin = std::min(_updateBegin, offset);
+            _updateEnd = std::max(_updateEnd, offset + size);
+        } else {
+            _updateBegin = offset;
+            _updateEnd = offset + size;
+            _updateBaseStamp = baseStamp;
+        }
+        _updateStamp = getSysmem().getStamp();
+    }
+    return copied;
+}
+
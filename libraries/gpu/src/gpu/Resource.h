@@ -93,6 +93,9 @@ protected:
 
         bool isAvailable() const { return (_data != 0); }
 
+        // Free the byte array but keep the size and stamp, for a buffer whose only copy now lives on the gpu
+        void release();
+
     private:
         Stamp _stamp;
         Size  _size;
@@ -132,19 +135,63 @@ public:
     // \return the number of bytes copied
     Size append(Size size, const Byte* data);
 
+    // Write data at offset the way setSubData does, for a buffer streamed into a piece at a time. Each write goes where
+    // the last one ended and the backend only uploads what is new since it last synced. A write at offset 0 starts the
+    // buffer over, what was written before it is no longer drawn and the backend can drop the storage still in use
+    // \return the number of bytes copied
+    Size streamSubData(Size offset, Size size, const Byte* data);
+
+    // The range written by the current run of streamSubData and the sysmem versions after its first and last write,
+    // a run ends with the next write at offset 0, a write somewhere else or any other change to the buffer
+    Size getStreamBegin() const { return _streamBegin; }
+    Size getStreamEnd() const { return _streamEnd; }
+    Stamp getStreamRunStamp() const { return _streamRunStamp; }
+    Stamp getStreamStamp() const { return _streamStamp; }
+
+    // Write data at offset the way setSubData does, for a buffer rewritten in place a range at a time while the rest
+    // stays as it is. The backend only uploads the range covering the updates since the buffer last changed some other
+    // way, as long as it had synced since then
+    // \return the number of bytes copied
+    Size updateSubData(Size offset, Size size, const Byte* data);
+
+    // The range covering the writes of the current run of updateSubData, the sysmem version before its first write and
+    // the one after its last, a run ends with any other change to the buffer
+    Size getUpdateBegin() const { return _updateBegin; }
+    Size getUpdateEnd() const { return _updateEnd; }
+    Stamp getUpdateBaseStamp() const { return _updateBaseStamp; }
+    Stamp getUpdateStamp() const { return _updateStamp; }
+
     // Access the sysmem object.
     const Sysmem& getSysmem() const { assert(_sysmem); return (*_sysmem); }
     Sysmem& editSysmem() { assert(_sysmem); return (*_sysmem); }
 
+    // A gpu resident buffer is written once: after the backend uploads it the sysmem bytes are freed and only the size
+    // is kept, so it must not be read or changed again
+    void setGPUResident(bool resident) { _gpuResident = resident; }
+    bool isGPUResident() const { return _gpuResident; }
+
 protected:
 
     Sysmem* _sysmem = NULL;
 
+    Size _streamBegin = 0;
+    Size _streamEnd = 0;
+    Stamp _streamRunStamp = -1;
+    Stamp _streamStamp = -1;
+
+    Size _updateBegin = 0;
+    Size _updateEnd = 0;
+    Stamp _updateBaseStamp = -1;
+    Stamp _updateStamp = -1;
+
+    bool _gpuResident = false;
+
     mutable GPUObject* _gpuObject = NULL;
 
     // This shouldn't be used by anything else than the Backend class with the proper casting.
     void setGPUObject(GPUObject* gpuObject) const { _gpuObject = gpuObject; }
     GPUObject* getGPUObject() const { return _gpuObject; }
+    void releaseSysmem() const { _sysmem->release(); }
 
     friend class Backend;
 };
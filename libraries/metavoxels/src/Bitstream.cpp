@@ -18,6 +18,7 @@
 #include <QScriptValueIterator>
 #include <QUrl>
 #include <QtDebug>
+#include <QtEndian>
 
 #include <RegisteredMetaTypes.h>
 #include <SharedUtil.h>
@@ -51,6 +52,8 @@ static int genericValueStreamer = Bitstream::registerTypeStreamer(
 
 static int qVariantPairListMetaTypeId = qRegisterMetaType<QVariantPairList>();
 
+const int MD5_HASH_SIZE = 16;
+
 IDStreamer::IDStreamer(Bitstream& stream) :
     _stream(stream),
     _bits(1) {
@@ -92,6 +95,14 @@ void Bitstream::preThreadingInit() {
     getObjectStreamers();
     getEnumStreamers();
     getEnumStreamersByName();    
+    
+    // the metadata hashes are likewise computed on first use
+    foreach (const TypeStreamer* streamer, getTypeStreamers()) {
+        streamer->getMetadataHash();
+    }
+    foreach (const TypeStreamer* streamer, getEnumStreamers()) {
+        streamer->getMetadataHash();
+    }
 }
 
 int Bitstream::registerMetaObject(const char* className, const QMetaObject* metaObject) {
@@ -104,6 +115,12 @@ int Bitstream::registerMetaObject(const char* className, const QMetaObject* meta
     return 0;
 }
 
+int Bitstream::registerPropertyAccessor(const QMetaObject* metaObject, const char* propertyName,
+        PropertyAccessor* accessor) {
+    getPropertyAccessors().insert(MetaObjectNamePair(metaObject, propertyName), accessor);
+    return 0;
+}
+
 int Bitstream::registerTypeStreamer(int type, TypeStreamer* streamer) {
     streamer->_type = type;
     if (!streamer->_self) {
@@ -152,6 +169,7 @@ Bitstream::Bitstream(QDataStream& underlying, MetadataType metadataType, Generic
     _metadataType(metadataType),
     _genericsMode(genericsMode),
     _context(NULL),
+    _recording(NULL),
     _objectStreamerStreamer(*this),
     _typeStreamerStreamer(*this),
     _attributeStreamer(*this),
@@ -179,6 +197,13 @@ const int LAST_BIT_POSITION = BITS_IN_BYTE - 1;
 
 Bitstream& Bitstream::write(const void* data, int bits, int offset) {
     const quint8* source = (const quint8*)data;
+    if (offset == 0 && bits >= BITS_IN_BYTE) {
+        // whole bytes go in bulk, leaving only the last few bits to go one piece at a time
+        int bytes = bits / BITS_IN_BYTE;
+        writeBytes(source, bytes);
+        source += bytes;
+        bits -= bytes * BITS_IN_BYTE;
+    }
     while (bits > 0) {
         int bitsToWrite = qMin(BITS_IN_BYTE - _position, qMin(BITS_IN_BYTE - offset, bits));
         _byte |= ((*source >> offset) & ((1 << bitsToWrite) - 1)) << _position;
@@ -196,6 +221,12 @@ Bitstream& Bitstream::write(const void* data, int bits, int offset) {
 
 Bitstream& Bitstream::read(void* data, int bits, int offset) {
     quint8* dest = (quint8*)data;
+    if (offset == 0 && bits >= BITS_IN_BYTE) {
+        int bytes = bits / BITS_IN_BYTE;
+        readBytes(dest, bytes);
+        dest += bytes;
+        bits -= bytes * BITS_IN_BYTE;
+    }
     while (bits > 0) {
         if (_position == 0) {
             _underlying >> _byte;
@@ -213,6 +244,72 @@ Bitstream& Bitstream::read(void* data, int bits, int offset) {
     return *this;
 }
 
+// bytes that don't line up with the stream are shifted through a word at a time, and written or read a buffer at a time
+const int BULK_WORD_BYTES = sizeof(quint64);
+const int BULK_WORD_BITS = BULK_WORD_BYTES * BITS_IN_BYTE;
+const int BULK_BUFFER_WORDS = 64;
+
+void Bitstream::writeBytes(const quint8* source, int bytes) {
+    if (_position == 0) {
+        _underlying.writeRawData((const char*)source, bytes);
+        return;
+    }
+    quint8 buffer[BULK_BUFFER_WORDS * BULK_WORD_BYTES];
+    quint64 carry = _byte;
+    while (bytes >= BULK_WORD_BYTES) {
+        int words = qMin(bytes / BULK_WORD_BYTES, BULK_BUFFER_WORDS);
+        quint8* dest = buffer;
+        for (int i = 0; i < words; i++, source += BULK_WORD_BYTES, dest += BULK_WORD_BYTES) {
+            quint64 word = qFromLittleEndian<quint64>(source);
+            qToLittleEndian<quint64>((word << _position) | carry, dest);
+            carry = word >> (BULK_WORD_BITS - _position);
+        }
+        _underlying.writeRawData((const char*)buffer, words * BULK_WORD_BYTES);
+        bytes -= words * BULK_WORD_BYTES;
+    }
+    _byte = carry;
+    for (; bytes > 0; bytes--, source++) {
+        _byte |= *source << _position;
+        _underlying << _byte;
+        _byte = *source >> (BITS_IN_BYTE - _position);
+    }
+}
+
+void Bitstream::readBytes(quint8* dest, int bytes) {
+    if (_position == 0) {
+        readBytesAligned(dest, bytes);
+        return;
+    }
+    // the current byte's unread bits start each one we return, and the next byte's fill it out
+    quint8 buffer[BULK_BUFFER_WORDS * BULK_WORD_BYTES];
+    while (bytes >= BULK_WORD_BYTES) {
+        int words = qMin(bytes / BULK_WORD_BYTES, BULK_BUFFER_WORDS);
+        readBytesAligned(buffer, words * BULK_WORD_BYTES);
+        const quint8* source = buffer;
+        for (int i = 0; i < words; i++, source += BULK_WORD_BYTES, dest += BULK_WORD_BYTES) {
+            quint64 word = qFromLittleEndian<quint64>(source);
+            qToLittleEndian<quint64>((_byte >> _position) | (word << (BITS_IN_BYTE - _position)), dest);
+            _byte = word >> (BULK_WORD_BITS - BITS_IN_BYTE);
+        }
+        bytes -= words * BULK_WORD_BYTES;
+    }
+    for (; bytes > 0; bytes--, dest++) {
+        quint8 next;
+        _underlying >> next;
+        *dest = (_byte >> _position) | (next << (BITS_IN_BYTE - _position));
+        _byte = next;
+    }
+}
+
+void Bitstream::readBytesAligned(quint8* dest, int bytes) {
+    int bytesRead = qMax(_underlying.readRawData((char*)dest, bytes), 0);
+    if (bytesRead < bytes) {
+        // reading past the end gives zeros, as it does a bit at a time
+        memset(dest + bytesRead, 0, bytes - bytesRead);
+        _underlying.setStatus(QDataStream::ReadPastEnd);
+    }
+}
+
 void Bitstream::flush() {
     if (_position != 0) {
         _underlying << _byte;
@@ -225,6 +322,35 @@ void Bitstream::reset() {
     _position = 0;
 }
 
+static void writeRecordedBits(Bitstream& out, const QByteArray& bits, int start, int end) {
+    const quint8* source = (const quint8*)bits.constData() + start / BITS_IN_BYTE;
+    int offset = start % BITS_IN_BYTE;
+    int count = end - start;
+    if (offset != 0 && count > 0) {
+        // finish the partial byte so that the rest can go in bulk
+        int leading = qMin(BITS_IN_BYTE - offset, count);
+        out.write(source++, leading, offset);
+        count -= leading;
+    }
+    out.write(source, count);
+}
+
+void Bitstream::writeRecording(const BitstreamRecording& recording) {
+    int position = 0;
+    foreach (const BitstreamRecording::DeferredWrite& write, recording._deferredWrites) {
+        writeRecordedBits(*this, recording._bits, position, write.position);
+        recording.writeDeferred(*this, write);
+        position = write.position;
+    }
+    writeRecordedBits(*this, recording._bits, position, recording._bitCount);
+}
+
+void Bitstream::spoilRecording() {
+    if (_recording) {
+        _recording->_replayable = false;
+    }
+}
+
 Bitstream::WriteMappings Bitstream::getAndResetWriteMappings() {
     WriteMappings mappings = { _objectStreamerStreamer.getAndResetTransientOffsets(),
         _typeStreamerStreamer.getAndResetTransientOffsets(),
@@ -352,11 +478,13 @@ void Bitstream::writeDelta(const QVariant& value, const QVariant& reference) {
          return;
     }
     *this << true;
+    spoilRecording();
     _typeStreamerStreamer << streamer;
     streamer->writeRawDelta(*this, value, reference);
 }
 
 void Bitstream::writeRawDelta(const QVariant& value, const QVariant& reference) {
+    spoilRecording();
     const TypeStreamer* streamer = getTypeStreamers().value(value.userType());
     _typeStreamerStreamer << streamer;
     streamer->writeRawDelta(*this, value, reference);
@@ -369,6 +497,7 @@ void Bitstream::readRawDelta(QVariant& value, const QVariant& reference) {
 }
 
 void Bitstream::writeRawDelta(const QObject* value, const QObject* reference) {
+    spoilRecording();
     if (!value) {
         _objectStreamerStreamer << NULL;
         return;
@@ -824,6 +953,7 @@ Bitstream& Bitstream::operator>>(QRegExp& regExp) {
 }
 
 Bitstream& Bitstream::operator<<(const QVariant& value) {
+    spoilRecording();
     if (!value.isValid()) {
         _typeStreamerStreamer << NULL;
         return *this;
@@ -849,7 +979,7 @@ Bitstream& Bitstream::operator>>(QVariant& value) {
 }
 
 Bitstream& Bitstream::operator<<(const AttributeValue& attributeValue) {
-    _attributeStreamer << attributeValue.getAttribute();
+    *this << attributeValue.getAttribute();
     if (attributeValue.getAttribute()) {
         attributeValue.getAttribute()->write(*this, attributeValue.getValue(), true);
     }
@@ -882,6 +1012,7 @@ Bitstream& Bitstream::operator>>(GenericValue& value) {
 }
 
 Bitstream& Bitstream::operator<<(const QObject* object) {
+    spoilRecording();
     if (!object) {
         _objectStreamerStreamer << NULL;
         return *this;
@@ -902,6 +1033,7 @@ Bitstream& Bitstream::operator>>(QObject*& object) {
 }
 
 Bitstream& Bitstream::operator<<(const QMetaObject* metaObject) {
+    spoilRecording();
     _objectStreamerStreamer << getObjectStreamers().value(metaObject);
     return *this;
 }
@@ -914,6 +1046,7 @@ Bitstream& Bitstream::operator>>(const QMetaObject*& metaObject) {
 }
 
 Bitstream& Bitstream::operator<<(const ObjectStreamer* streamer) {
+    spoilRecording();
     _objectStreamerStreamer << streamer;
     return *this;
 }
@@ -931,6 +1064,7 @@ Bitstream& Bitstream::operator>>(ObjectStreamerPointer& streamer) {
 }
 
 Bitstream& Bitstream::operator<<(const TypeStreamer* streamer) {
+    spoilRecording();
     _typeStreamerStreamer << streamer;    
     return *this;
 }
@@ -948,7 +1082,11 @@ Bitstream& Bitstream::operator>>(TypeStreamerPointer& streamer) {
 }
 
 Bitstream& Bitstream::operator<<(const AttributePointer& attribute) {
-    _attributeStreamer << attribute;
+    if (_recording) {
+        _recording->defer(true, attribute, SharedObjectPointer());
+    } else {
+        _attributeStreamer << attribute;
+    }
     return *this;
 }
 
@@ -958,6 +1096,7 @@ Bitstream& Bitstream::operator>>(AttributePointer& attribute) {
 }
 
 Bitstream& Bitstream::operator<<(const QScriptString& string) {
+    spoilRecording();
     _scriptStringStreamer << string;
     return *this;
 }
@@ -1147,7 +1286,11 @@ Bitstream& Bitstream::operator>>(QScriptValue& value) {
 }
 
 Bitstream& Bitstream::operator<<(const SharedObjectPointer& object) {
-    _sharedObjectStreamer << object;
+    if (_recording) {
+        _recording->defer(false, AttributePointer(), object);
+    } else {
+        _sharedObjectStreamer << object;
+    }
     return *this;
 }
 
@@ -1169,13 +1312,14 @@ Bitstream& Bitstream::operator<(const ObjectStreamer* streamer) {
 }
 
 static MappedObjectStreamer* createMappedObjectStreamer(const QMetaObject* metaObject,
-        const QVector<StreamerPropertyPair>& properties) {
+        const QVector<StreamerPropertyPair>& properties,
+        const QVector<const PropertyAccessor*>& accessors = QVector<const PropertyAccessor*>()) {
     for (const QMetaObject* super = metaObject; super; super = super->superClass()) {
         if (super == &SharedObject::staticMetaObject) {
-            return new SharedObjectStreamer(metaObject, properties);
+            return new SharedObjectStreamer(metaObject, properties, accessors);
         }
     }
-    return new MappedObjectStreamer(metaObject, properties);    
+    return new MappedObjectStreamer(metaObject, properties, accessors);    
 }
 
 Bitstream& Bitstream::operator>(ObjectStreamerPointer& streamer) {
@@ -1227,27 +1371,26 @@ Bitstream& Bitstream::operator>(ObjectStreamerPointer& streamer) {
     }
     // for hash metadata, check the names/types of the properties as well as the name hash against our own class
     if (_metadataType == HASH_METADATA) {
-        QCryptographicHash hash(QCryptographicHash::Md5);
-        bool matches = true;
+        bool matches = (metaObject != NULL);
         if (metaObject) {
             const QVector<StreamerPropertyPair>& localProperties = streamer->getProperties();
             if (localProperties.size() == properties.size()) {
                 for (int i = 0; i < localProperties.size(); i++) {
-                    const StreamerPropertyPair& localProperty = localProperties.at(i);
-                    if (localProperty.first != properties.at(i).first) {
+                    if (localProperties.at(i).first != properties.at(i).first) {
                         matches = false;
                         break;
                     }
-                    hash.addData(localProperty.second.name(), strlen(localProperty.second.name()) + 1); 
                 }
             } else {
                 matches = false;
             }
         }
-        QByteArray localHashResult = hash.result();
-        QByteArray remoteHashResult(localHashResult.size(), 0);
+        QByteArray remoteHashResult(MD5_HASH_SIZE, 0);
         read(remoteHashResult.data(), remoteHashResult.size() * BITS_IN_BYTE);
-        if (metaObject && matches && localHashResult == remoteHashResult) {
+        
+        // the built-in streamers are always mapped, and hash their property names when created
+        if (matches && static_cast<const MappedObjectStreamer*>(streamer.data())->getMetadataHash() ==
+                remoteHashResult) {
             return *this;
         }
     } else if (metaObject) {
@@ -1357,19 +1500,9 @@ Bitstream& Bitstream::operator>(TypeStreamerPointer& streamer) {
             } else {
                 int bits;
                 *this >> bits;
-                QCryptographicHash hash(QCryptographicHash::Md5);
-                if (baseStreamer->getCategory() == TypeStreamer::ENUM_CATEGORY) {
-                    QMetaEnum metaEnum = baseStreamer->getMetaEnum();
-                    for (int i = 0; i < metaEnum.keyCount(); i++) {
-                        hash.addData(metaEnum.key(i), strlen(metaEnum.key(i)) + 1);
-                        qint32 value = metaEnum.value(i);
-                        hash.addData((const char*)&value, sizeof(qint32));
-                    }
-                }
-                QByteArray localHashResult = hash.result();
-                QByteArray remoteHashResult(localHashResult.size(), 0);
+                QByteArray remoteHashResult(MD5_HASH_SIZE, 0);
                 read(remoteHashResult.data(), remoteHashResult.size() * BITS_IN_BYTE);
-                if (localHashResult != remoteHashResult) {
+                if (baseStreamer->getMetadataHash() != remoteHashResult) {
                     streamer = TypeStreamerPointer(new MappedEnumTypeStreamer(baseStreamer, bits, QHash<int, int>()));
                 }
             }
@@ -1413,7 +1546,6 @@ Bitstream& Bitstream::operator>(TypeStreamerPointer& streamer) {
     }
     // for hash metadata, check the names/types of the fields as well as the name hash against our own class
     if (_metadataType == HASH_METADATA) {
-        QCryptographicHash hash(QCryptographicHash::Md5);
         bool matches = true;
         const QVector<MetaField>& localFields = baseStreamer->getMetaFields();
         if (fieldCount != localFields.size()) {
@@ -1424,18 +1556,15 @@ Bitstream& Bitstream::operator>(TypeStreamerPointer& streamer) {
                 return *this;
             }
             for (int i = 0; i < fieldCount; i++) {
-                const MetaField& localField = localFields.at(i);
-                if (fields.at(i).first != localField.getStreamer()) {
+                if (fields.at(i).first != localFields.at(i).getStreamer()) {
                     matches = false;
                     break;
                 }
-                hash.addData(localField.getName().constData(), localField.getName().size() + 1);
             }   
         }
-        QByteArray localHashResult = hash.result();
-        QByteArray remoteHashResult(localHashResult.size(), 0);
+        QByteArray remoteHashResult(MD5_HASH_SIZE, 0);
         read(remoteHashResult.data(), remoteHashResult.size() * BITS_IN_BYTE);
-        if (matches && localHashResult == remoteHashResult) {
+        if (matches && baseStreamer->getMetadataHash() == remoteHashResult) {
             // since everything is the same, we can use the default streamer
             return *this;
         }
@@ -1675,6 +1804,7 @@ QHash<const QMetaObject*, const ObjectStreamer*> Bitstream::createObjectStreamer
     QHash<const QMetaObject*, const ObjectStreamer*> objectStreamers;
     foreach (const QMetaObject* metaObject, getMetaObjects()) {
         QVector<StreamerPropertyPair> properties;
+        QVector<const PropertyAccessor*> accessors;
         for (int i = 0; i < metaObject->propertyCount(); i++) {
             QMetaProperty property = metaObject->property(i);
             if (!property.isStored()) {
@@ -1691,9 +1821,12 @@ QHash<const QMetaObject*, const ObjectStreamer*> Bitstream::createObjectStreamer
             }
             if (streamer) {
                 properties.append(StreamerPropertyPair(streamer->getSelf(), property));
+                accessors.append(property.isEnumType() ? NULL :
+                    getPropertyAccessor(getPropertyAccessors(), metaObject, property, property.userType()));
             }
         }
-        ObjectStreamerPointer streamer = ObjectStreamerPointer(createMappedObjectStreamer(metaObject, properties));
+        ObjectStreamerPointer streamer = ObjectStreamerPointer(createMappedObjectStreamer(metaObject,
+            properties, accessors));
         streamer->_self = streamer;
         objectStreamers.insert(metaObject, streamer.data());
     }
@@ -1705,6 +1838,23 @@ QHash<int, const TypeStreamer*>& Bitstream::getTypeStreamers() {
     return typeStreamers;
 }
 
+QHash<MetaObjectNamePair, const PropertyAccessor*>& Bitstream::getPropertyAccessors() {
+    static QHash<MetaObjectNamePair, const PropertyAccessor*> propertyAccessors;
+    return propertyAccessors;
+}
+
+static const PropertyAccessor* getPropertyAccessor(const QHash<MetaObjectNamePair, const PropertyAccessor*>& accessors,
+        const QMetaObject* metaObject, const QMetaProperty& property, int type) {
+    // look for the accessor under the class that declares the property, and make sure it streams the property's type
+    for (const QMetaObject* super = metaObject; super; super = super->superClass()) {
+        if (property.propertyIndex() >= super->propertyOffset()) {
+            const PropertyAccessor* accessor = accessors.value(MetaObjectNamePair(super, property.name()));
+            return (accessor && accessor->getType() == type) ? accessor : NULL;
+        }
+    }
+    return NULL;
+}
+
 const QHash<ScopeNamePair, const TypeStreamer*>& Bitstream::getEnumStreamers() {
     static QHash<ScopeNamePair, const TypeStreamer*> enumStreamers = createEnumStreamers();
     return enumStreamers;
@@ -1757,6 +1907,45 @@ const TypeStreamer* Bitstream::createInvalidTypeStreamer() {
     return streamer;
 }
 
+BitstreamRecording::BitstreamRecording() :
+    _dataStream(&_bits, QIODevice::WriteOnly),
+    _stream(_dataStream),
+    _bitCount(0),
+    _replayable(true) {
+    
+    _stream._recording = this;
+}
+
+BitstreamRecording::~BitstreamRecording() {
+}
+
+void BitstreamRecording::finish() {
+    _bitCount = getPosition();
+    _stream.flush();
+    _stream._recording = NULL;
+}
+
+int BitstreamRecording::recordContext(void* context) {
+    return -1;
+}
+
+void BitstreamRecording::writeDeferred(Bitstream& out, const DeferredWrite& write) const {
+    if (write.isAttribute) {
+        out << write.attribute;
+    } else {
+        out << write.object;
+    }
+}
+
+void BitstreamRecording::defer(bool isAttribute, const AttributePointer& attribute, const SharedObjectPointer& object) {
+    DeferredWrite write = { getPosition(), isAttribute, attribute, object, recordContext(_stream.getContext()) };
+    _deferredWrites.append(write);
+}
+
+int BitstreamRecording::getPosition() const {
+    return _dataStream.device()->pos() * BITS_IN_BYTE + _stream._position;
+}
+
 BitstreamException::BitstreamException(const QString& description) :
     _description(description) {
 }
@@ -2332,9 +2521,22 @@ const QVector<StreamerPropertyPair>& ObjectStreamer::getProperties() const {
     return emptyProperties;
 }
 
-MappedObjectStreamer::MappedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties) :
+MappedObjectStreamer::MappedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties,
+        const QVector<const PropertyAccessor*>& accessors) :
     ObjectStreamer(metaObject),
-    _properties(properties) {
+    _properties(properties),
+    _accessors(accessors) {
+    
+    // streamers mapped from remote metadata use reflection throughout
+    _accessors.resize(_properties.size());
+    
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    foreach (const StreamerPropertyPair& property, _properties) {
+        if (property.second.isValid()) {
+            hash.addData(property.second.name(), strlen(property.second.name()) + 1);
+        }
+    }
+    _metadataHash = hash.result();
 }
 
 const char* MappedObjectStreamer::getName() const {
@@ -2350,18 +2552,14 @@ void MappedObjectStreamer::writeMetadata(Bitstream& out, bool full) const {
     if (_properties.isEmpty()) {
         return;
     }
-    QCryptographicHash hash(QCryptographicHash::Md5);
     foreach (const StreamerPropertyPair& property, _properties) {
         out << property.first.data();
         if (full) {
             out << QByteArray::fromRawData(property.second.name(), strlen(property.second.name()));
-        } else {
-            hash.addData(property.second.name(), strlen(property.second.name()) + 1);
         }
     }
     if (!full) {
-        QByteArray hashResult = hash.result();
-        out.write(hashResult.constData(), hashResult.size() * BITS_IN_BYTE);
+        out.write(_metadataHash.constData(), _metadataHash.size() * BITS_IN_BYTE);
     }
 }
 
@@ -2419,15 +2617,30 @@ bool MappedObjectStreamer::equal(const QObject* first, const QObject* second) co
 }
 
 void MappedObjectStreamer::write(Bitstream& out, const QObject* object) const {
-    foreach (const StreamerPropertyPair& property, _properties) {
-        property.first->write(out, property.second.read(object));
+    for (int i = 0; i < _properties.size(); i++) {
+        const StreamerPropertyPair& property = _properties.at(i);
+        const PropertyAccessor* accessor = _accessors.at(i);
+        if (accessor) {
+            accessor->write(out, object);
+        } else {
+            property.first->write(out, property.second.read(object));
+        }
     }
 }
 
 void MappedObjectStreamer::writeRawDelta(Bitstream& out, const QObject* object, const QObject* reference) const {
-    foreach (const StreamerPropertyPair& property, _properties) {
-        property.first->writeDelta(out, property.second.read(object), (reference && reference->metaObject() == _metaObject) ?
-            property.second.read(reference) : QVariant());
+    if (reference && reference->metaObject() != _metaObject) {
+        reference = NULL;
+    }
+    for (int i = 0; i < _properties.size(); i++) {
+        const StreamerPropertyPair& property = _properties.at(i);
+        const PropertyAccessor* accessor = _accessors.at(i);
+        if (accessor) {
+            accessor->writeDelta(out, object, reference);
+        } else {
+            property.first->writeDelta(out, property.second.read(object),
+                reference ? property.second.read(reference) : QVariant());
+        }
     }
 }
 
@@ -2436,7 +2649,13 @@ QObject* MappedObjectStreamer::read(Bitstream& in, QObject* object) const {
     if (!object && _metaObject) {
         object = _metaObject->newInstance();
     }
-    foreach (const StreamerPropertyPair& property, _properties) {
+    for (int i = 0; i < _properties.size(); i++) {
+        const StreamerPropertyPair& property = _properties.at(i);
+        const PropertyAccessor* accessor = _accessors.at(i);
+        if (accessor) {
+            accessor->read(in, reread ? NULL : object);
+            continue;
+        }
         QVariant value = property.first->read(in);
         if (property.second.isValid() && object && !reread) {
             property.second.write(object, value);
@@ -2450,10 +2669,19 @@ QObject* MappedObjectStreamer::readRawDelta(Bitstream& in, const QObject* refere
     if (!object && _metaObject) {
         object = _metaObject->newInstance();
     }
-    foreach (const StreamerPropertyPair& property, _properties) {
+    if (reference && reference->metaObject() != _metaObject) {
+        reference = NULL;
+    }
+    for (int i = 0; i < _properties.size(); i++) {
+        const StreamerPropertyPair& property = _properties.at(i);
+        const PropertyAccessor* accessor = _accessors.at(i);
+        if (accessor) {
+            accessor->readDelta(in, reread ? NULL : object, reference);
+            continue;
+        }
         QVariant value;
-        property.first->readDelta(in, value, (property.second.isValid() && reference &&
-            reference->metaObject() == _metaObject) ? property.second.read(reference) : QVariant());
+        property.first->readDelta(in, value, (property.second.isValid() && reference) ?
+            property.second.read(reference) : QVariant());
         if (property.second.isValid() && object && !reread) {
             property.second.write(object, value);
         }
@@ -2461,8 +2689,9 @@ QObject* MappedObjectStreamer::readRawDelta(Bitstream& in, const QObject* refere
     return object;
 }
 
-SharedObjectStreamer::SharedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties) :
-    MappedObjectStreamer(metaObject, properties) {
+SharedObjectStreamer::SharedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties,
+        const QVector<const PropertyAccessor*>& accessors) :
+    MappedObjectStreamer(metaObject, properties, accessors) {
 }
 
 void SharedObjectStreamer::write(Bitstream& out, const QObject* object) const {
@@ -2627,6 +2856,9 @@ QObject* GenericObjectStreamer::readRawDelta(Bitstream& in, const QObject* refer
     return object;
 }
 
+PropertyAccessor::~PropertyAccessor() {
+}
+
 MetaField::MetaField(const QByteArray& name, const TypeStreamer* streamer) :
     _name(name),
     _streamer(streamer) {
@@ -2666,21 +2898,40 @@ void TypeStreamer::writeMetadata(Bitstream& out, bool full) const {
     if (metaFields.isEmpty()) {
         return;
     }
-    QCryptographicHash hash(QCryptographicHash::Md5);
     foreach (const MetaField& metaField, metaFields) {
         out << metaField.getStreamer();
         if (full) {
             out << metaField.getName();
-        } else {
-            hash.addData(metaField.getName().constData(), metaField.getName().size() + 1);
         }
     }
     if (!full) {
-        QByteArray hashResult = hash.result();
+        const QByteArray& hashResult = getMetadataHash();
         out.write(hashResult.constData(), hashResult.size() * BITS_IN_BYTE);
     }
 }
 
+const QByteArray& TypeStreamer::getMetadataHash() const {
+    // computed on first use (or by preThreadingInit) and kept, since the keys and fields never change
+    if (_metadataHash.isEmpty()) {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        Category category = getCategory();
+        if (category == ENUM_CATEGORY) {
+            QMetaEnum metaEnum = getMetaEnum();
+            for (int i = 0; i < metaEnum.keyCount(); i++) {
+                hash.addData(metaEnum.key(i), strlen(metaEnum.key(i)) + 1);
+                qint32 value = metaEnum.value(i);
+                hash.addData((const char*)&value, sizeof(qint32));
+            }
+        } else if (category == STREAMABLE_CATEGORY) {
+            foreach (const MetaField& metaField, getMetaFields()) {
+                hash.addData(metaField.getName().constData(), metaField.getName().size() + 1);
+            }
+        }
+        const_cast<TypeStreamer*>(this)->_metadataHash = hash.result();
+    }
+    return _metadataHash;
+}
+
 QJsonValue TypeStreamer::getJSONMetadata(JSONWriter& writer) const {
     Category category = getCategory();
     switch (category) {
@@ -2904,13 +3155,7 @@ void EnumTypeStreamer::writeMetadata(Bitstream& out, bool full) const {
         }
     } else {
         out << getBits();
-        QCryptographicHash hash(QCryptographicHash::Md5);    
-        for (int i = 0; i < metaEnum.keyCount(); i++) {
-            hash.addData(metaEnum.key(i), strlen(metaEnum.key(i)) + 1);
-            qint32 value = metaEnum.value(i);
-            hash.addData((const char*)&value, sizeof(qint32));
-        }
-        QByteArray hashResult = hash.result();
+        const QByteArray& hashResult = getMetadataHash();
         out.write(hashResult.constData(), hashResult.size() * BITS_IN_BYTE);
     }
 }
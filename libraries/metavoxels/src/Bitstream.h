@@ -12,6 +12,7 @@
 #ifndef hifi_Bitstream_h
 #define hifi_Bitstream_h
 
+#include <QDataStream>
 #include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -27,11 +28,12 @@
 
 #include <glm/glm.hpp>
 
+#include <SharedUtil.h>
+
 #include "SharedObject.h"
 
 class QByteArray;
 class QColor;
-class QDataStream;
 class QScriptEngine;
 class QScriptValue;
 class QUrl;
@@ -39,17 +41,20 @@ class QUrl;
 class Attribute;
 class AttributeValue;
 class Bitstream;
+class BitstreamRecording;
 class GenericValue;
 class JSONWriter;
 class ObjectReader;
 class ObjectStreamer;
 class OwnedAttributeValue;
+class PropertyAccessor;
 class TypeStreamer;
 
 typedef SharedObjectPointerTemplate<Attribute> AttributePointer;
 
 typedef QPair<QByteArray, QByteArray> ScopeNamePair;
 typedef QPair<QByteArray, int> NameIntPair;
+typedef QPair<const QMetaObject*, QByteArray> MetaObjectNamePair;
 typedef QSharedPointer<ObjectStreamer> ObjectStreamerPointer;
 typedef QWeakPointer<ObjectStreamer> WeakObjectStreamerPointer;
 typedef QSharedPointer<TypeStreamer> TypeStreamerPointer;
@@ -304,6 +309,13 @@ public:
     /// \return zero; the function only returns a value so that it can be used in static initialization
     static int registerMetaObject(const char* className, const QMetaObject* metaObject);
 
+    /// Registers an accessor for a property declared by the supplied metaobject, which the built-in streamers for it and its
+    /// subclasses will use in place of reflection.  Consider using the REGISTER_PROPERTY_ACCESSOR macro at the top level of
+    /// the source file associated with the class rather than calling this function directly.
+    /// \return zero; the function only returns a value so that it can be used in static initialization
+    static int registerPropertyAccessor(const QMetaObject* metaObject, const char* propertyName,
+        PropertyAccessor* accessor);
+
     /// Registers a streamer for the specified Qt-registered type.  Consider using one of the registration macros (such as
     /// REGISTER_SIMPLE_TYPE_STREAMER) at the top level of the associated source file rather than calling this function
     /// directly. 
@@ -377,6 +389,9 @@ public:
     /// Resets to the initial state.
     void reset();
 
+    /// Writes the bits of a finished recording, repeating its deferred writes against the state of this stream.
+    void writeRecording(const BitstreamRecording& recording);
+
     /// Adds a subdivided object, which will be added to the read mappings and used as a reference if persisted.
     void addSubdividedObject(const SharedObjectPointer& object) { _subdividedObjects.append(object); }
     
@@ -561,12 +576,26 @@ private slots:
 
 private:
     
+    friend class BitstreamRecording;
     friend class JSONReader;
     friend class JSONWriter;
     
+    /// Notes a write whose encoding depends on the state of the stream, which a recording can't replay.
+    void spoilRecording();
+    
     ObjectStreamerPointer readGenericObjectStreamer(const QByteArray& name);
     TypeStreamerPointer readGenericTypeStreamer(const QByteArray& name, int category);
     
+    /// Writes and reads whole bytes in bulk: straight through when we're on a byte boundary, shifted a word at a time
+    /// when we're not.
+    void writeBytes(const quint8* source, int bytes);
+    void readBytes(quint8* dest, int bytes);
+    void readBytesAligned(quint8* dest, int bytes);
+    
+    /// Streams a vector whose elements are streamed as their raw bytes as one block.
+    template<class T> Bitstream& writeRawVector(const QVector<T>& vector);
+    template<class T> Bitstream& readRawVector(QVector<T>& vector);
+    
     QDataStream& _underlying;
     quint8 _byte;
     int _position;
@@ -576,6 +605,8 @@ private:
 
     void* _context;
 
+    BitstreamRecording* _recording;
+
     RepeatedValueStreamer<const ObjectStreamer*, const ObjectStreamer*, ObjectStreamerPointer> _objectStreamerStreamer;
     RepeatedValueStreamer<const TypeStreamer*, const TypeStreamer*, TypeStreamerPointer> _typeStreamerStreamer;
     RepeatedValueStreamer<AttributePointer> _attributeStreamer;
@@ -594,6 +625,7 @@ private:
     static QHash<QByteArray, const QMetaObject*>& getMetaObjects();
     static QMultiHash<const QMetaObject*, const QMetaObject*>& getMetaObjectSubClasses();
     static QHash<int, const TypeStreamer*>& getTypeStreamers();
+    static QHash<MetaObjectNamePair, const PropertyAccessor*>& getPropertyAccessors();
          
     static const QHash<const QMetaObject*, const ObjectStreamer*>& getObjectStreamers();
     static QHash<const QMetaObject*, const ObjectStreamer*> createObjectStreamers();
@@ -608,6 +640,60 @@ private:
     static const TypeStreamer* createInvalidTypeStreamer();
 };
 
+/// A stretch of bits recorded once for replay into any number of streams.  Attributes and shared objects, which a stream
+/// writes in full only the first time it sees them, are kept as values and written anew against the state of each stream
+/// that the recording is replayed into.  Any other write that depends on the state of the stream (of a QVariant or
+/// QObject, for instance) leaves the recording unreplayable.
+class BitstreamRecording {
+public:
+
+    BitstreamRecording();
+    virtual ~BitstreamRecording();
+
+    /// Returns the stream to write the bits to record to.
+    Bitstream& getStream() { return _stream; }
+
+    /// Finishes the recording, after which nothing more may be written to its stream.
+    void finish();
+
+    /// Checks whether the recording may be replayed with Bitstream::writeRecording.
+    bool isReplayable() const { return _replayable; }
+
+protected:
+
+    /// A write held back until the recording is replayed.
+    class DeferredWrite {
+    public:
+        int position;
+        bool isAttribute;
+        AttributePointer attribute;
+        SharedObjectPointer object;
+        int context;
+    };
+
+    /// Notes the context of the recording stream at a deferred write.  The default implementation keeps nothing.
+    /// \return the value to pass back to writeDeferred
+    virtual int recordContext(void* context);
+
+    /// Repeats a deferred write.  Subclasses that keep the context may set it around the write.
+    virtual void writeDeferred(Bitstream& out, const DeferredWrite& write) const;
+
+private:
+
+    friend class Bitstream;
+
+    void defer(bool isAttribute, const AttributePointer& attribute, const SharedObjectPointer& object);
+
+    int getPosition() const;
+
+    QByteArray _bits;
+    QDataStream _dataStream;
+    Bitstream _stream;
+    int _bitCount;
+    QVector<DeferredWrite> _deferredWrites;
+    bool _replayable;
+};
+
 template<class T> inline void Bitstream::writeDelta(const T& value, const T& reference) {
     if (value == reference) {
         *this << false;
@@ -844,6 +930,36 @@ template<class T> inline Bitstream& Bitstream::operator>>(QVector<T>& vector) {
     return *this;
 }
 
+template<class T> inline Bitstream& Bitstream::writeRawVector(const QVector<T>& vector) {
+    *this << vector.size();
+    return write(vector.constData(), vector.size() * sizeof(T) * BITS_IN_BYTE);
+}
+
+template<class T> inline Bitstream& Bitstream::readRawVector(QVector<T>& vector) {
+    int size;
+    *this >> size;
+    vector.resize(qMax(size, 0));
+    return read(vector.data(), vector.size() * sizeof(T) * BITS_IN_BYTE);
+}
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<int>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<int>& vector) { return readRawVector(vector); }
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<uint>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<uint>& vector) { return readRawVector(vector); }
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<qint64>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<qint64>& vector) { return readRawVector(vector); }
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<float>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<float>& vector) { return readRawVector(vector); }
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<double>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<double>& vector) { return readRawVector(vector); }
+
+template<> inline Bitstream& Bitstream::operator<<(const QVector<glm::vec3>& vector) { return writeRawVector(vector); }
+template<> inline Bitstream& Bitstream::operator>>(QVector<glm::vec3>& vector) { return readRawVector(vector); }
+
 template<class T> inline Bitstream& Bitstream::operator<<(const QSet<T>& set) {
     *this << set.size();
     foreach (const T& entry, set) {
@@ -1122,7 +1238,11 @@ protected:
 class MappedObjectStreamer : public ObjectStreamer {
 public:
 
-    MappedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties);
+    MappedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties,
+        const QVector<const PropertyAccessor*>& accessors = QVector<const PropertyAccessor*>());
+
+    /// Returns the hash of the property names sent in place of the names themselves with hash metadata.
+    const QByteArray& getMetadataHash() const { return _metadataHash; }
 
     virtual const char* getName() const;
     virtual const QVector<StreamerPropertyPair>& getProperties() const;
@@ -1139,13 +1259,16 @@ public:
 private:
     
     QVector<StreamerPropertyPair> _properties;
+    QVector<const PropertyAccessor*> _accessors; ///< for each property, the accessor to use in place of reflection, if any
+    QByteArray _metadataHash;
 };
 
 /// A streamer that maps to a local shared object class.  Shared objects can write extra, non-property data.
 class SharedObjectStreamer : public MappedObjectStreamer {
 public:
     
-    SharedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties);
+    SharedObjectStreamer(const QMetaObject* metaObject, const QVector<StreamerPropertyPair>& properties,
+        const QVector<const PropertyAccessor*>& accessors = QVector<const PropertyAccessor*>());
     
     virtual void write(Bitstream& out, const QObject* object) const;
     virtual void writeRawDelta(Bitstream& out, const QObject* object, const QObject* reference) const;
@@ -1204,6 +1327,67 @@ Q_DECLARE_METATYPE(const QMetaObject*)
 /// associated with the class.  The class should have a no-argument constructor flagged with Q_INVOKABLE.
 #define REGISTER_META_OBJECT(x) static int x##Registration = Bitstream::registerMetaObject(#x, &x::staticMetaObject);
 
+/// Streams a property through its typed getter and setter, skipping the QMetaProperty/QVariant round trip.  The wire format
+/// is the same as that of the property type's streamer, so accessors are purely a local optimization.
+class PropertyAccessor {
+public:
+    
+    virtual ~PropertyAccessor();
+    
+    /// Returns the Qt type of the property.
+    virtual int getType() const = 0;
+    
+    virtual void write(Bitstream& out, const QObject* object) const = 0;
+    
+    /// \param reference the object to write the delta against, or NULL to write against the default value
+    virtual void writeDelta(Bitstream& out, const QObject* object, const QObject* reference) const = 0;
+    
+    /// \param object the object to set the value on, or NULL to discard it
+    virtual void read(Bitstream& in, QObject* object) const = 0;
+    
+    virtual void readDelta(Bitstream& in, QObject* object, const QObject* reference) const = 0;
+};
+
+/// An accessor that calls member functions of the declaring class.
+template<class T, class O, class R, class P> class MemberPropertyAccessor : public PropertyAccessor {
+public:
+    
+    typedef R (O::*Getter)() const;
+    typedef void (O::*Setter)(P);
+    
+    MemberPropertyAccessor(Getter getter, Setter setter) : _getter(getter), _setter(setter) { }
+    
+    virtual int getType() const { return qMetaTypeId<T>(); }
+    virtual void write(Bitstream& out, const QObject* object) const { out << get(object); }
+    virtual void writeDelta(Bitstream& out, const QObject* object, const QObject* reference) const {
+        out.writeDelta(get(object), reference ? get(reference) : T()); }
+    virtual void read(Bitstream& in, QObject* object) const { T value; in >> value; set(object, value); }
+    virtual void readDelta(Bitstream& in, QObject* object, const QObject* reference) const {
+        T value; in.readDelta(value, reference ? get(reference) : T()); set(object, value); }
+
+private:
+    
+    T get(const QObject* object) const { return (static_cast<const O*>(object)->*_getter)(); }
+    void set(QObject* object, const T& value) const {
+        if (object) {
+            (static_cast<O*>(object)->*_setter)(value);
+        }
+    }
+    
+    Getter _getter;
+    Setter _setter;
+};
+
+template<class T, class O, class R, class P> inline PropertyAccessor* createPropertyAccessor(
+        R (O::*getter)() const, void (O::*setter)(P)) {
+    return new MemberPropertyAccessor<T, O, R, P>(getter, setter);
+}
+
+/// Macro for registering accessors for the properties of streamable meta-objects.  The getter and setter must be declared
+/// by the class that declares the property, and must respectively return and accept values of the property's type.
+#define REGISTER_PROPERTY_ACCESSOR(x, type, name, getter, setter) static int x##name##AccessorRegistration = \
+    Bitstream::registerPropertyAccessor(&x::staticMetaObject, #name, createPropertyAccessor<type>(&x::getter, &x::setter));
+
 /// Contains a value along with a pointer to its streamer.  This is stored in QVariants when using fallback generics and
 /// no mapping to a built-in type can be found, or when using all generics and the value is any non-simple type.
 class GenericValue {
@@ -1262,6 +1446,9 @@ public:
     
     virtual void writeMetadata(Bitstream& out, bool full) const;
     
+    /// Returns the hash of the enum keys or streamable field names sent in place of them with hash metadata.
+    const QByteArray& getMetadataHash() const;
+    
     virtual QJsonValue getJSONMetadata(JSONWriter& writer) const;
     virtual QJsonValue getJSONData(JSONWriter& writer, const QVariant& value) const;
     virtual QJsonValue getJSONVariantData(JSONWriter& writer, const QVariant& value) const;
@@ -1313,6 +1500,7 @@ protected:
     
     int _type;
     TypeStreamerPointer _self; ///< set/used for built-in types (never deleted), to obtain shared pointers
+    QByteArray _metadataHash;
 };
 
 QDebug& operator<<(QDebug& debug, const TypeStreamer* typeStreamer);
@@ -9,8 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cfloat>
 #include <cstring>
 
+#include <QtAlgorithms>
 #include <QtDebug>
 
 #include <LimitedNodeList.h>
@@ -368,28 +370,32 @@ void DatagramSequencer::appendReliableData(int bytes, QVector<ChannelSpan>& span
     // gather total number of bytes to write, priority
     int totalBytes = 0;
     float totalPriority = 0.0f;
-    int totalChannels = 0;
+    QVector<ChannelDemand> demands;
     foreach (ReliableChannel* channel, _reliableOutputChannels) {
         int channelBytes = channel->getBytesAvailable();
         if (channelBytes > 0) {
             totalBytes += channelBytes;
             totalPriority += channel->getPriority();
-            totalChannels++;
+            ChannelDemand demand = { channel, channelBytes, channel->getPriority() > 0.0f ?
+                channelBytes / channel->getPriority() : FLT_MAX };
+            demands.append(demand);
         }
     }
-    _outgoingPacketStream << (quint32)totalChannels;
-    if (totalChannels == 0) {
+    _outgoingPacketStream << (quint32)demands.size();
+    if (demands.isEmpty()) {
         return;    
     }
     totalBytes = qMin(bytes, totalBytes);
     
-    foreach (ReliableChannel* channel, _reliableOutputChannels) {
-        int channelBytes = channel->getBytesAvailable();
-        if (channelBytes == 0) {
-            continue;
-        }
+    // fill the channels wanting the least for their priority first, so that whatever share of the packet one of them
+    // can't use passes to the rest: a few bytes of edits go out whole alongside a bulk transfer, which takes the
+    // remainder rather than being held to a fixed fraction
+    qSort(demands);
+    foreach (const ChannelDemand& demand, demands) {
+        ReliableChannel* channel = demand.channel;
         _outgoingPacketStream << (quint32)channel->getIndex();
-        channelBytes = qMin(channelBytes, (int)(totalBytes * channel->getPriority() / totalPriority));
+        int channelBytes = qMin(demand.bytes, totalPriority > 0.0f ?
+            (int)(totalBytes * channel->getPriority() / totalPriority) : totalBytes);
         channel->writeData(_outgoingPacketStream, channelBytes, spans);   
         totalBytes -= channelBytes;
         totalPriority -= channel->getPriority();
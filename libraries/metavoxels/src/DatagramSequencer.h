@@ -49,9 +49,10 @@ class ReliableChannel;
 /// created lazily through the getReliableOutputChannel/getReliableInputChannel functions.  Output channels contain buffers
 /// to which one may write either arbitrary data (as a QIODevice) or messages (as QVariants), or switch between the two.
 /// Each time a packet is sent, data pending for reliable output channels is added, in proportion to their relative priorities,
-/// until the packet size limit set by setMaxPacketSize is reached.  On the receive side, the streams are reconstructed and
-/// (again, depending on whether messages are enabled) either the QIODevice reports that data is available, or, when a complete
-/// message is decoded, the receivedMessage signal is fired.
+/// until the packet size limit set by setMaxPacketSize is reached.  Any share that a channel doesn't need goes to the others,
+/// so a low-priority bulk transfer fills whatever room is left by small, higher-priority messages without delaying them.
+/// On the receive side, the streams are reconstructed and (again, depending on whether messages are enabled) either
+/// the QIODevice reports that data is available, or, when a complete message is decoded, the receivedMessage signal is fired.
 class DatagramSequencer : public QObject {
     Q_OBJECT
 
@@ -192,6 +193,16 @@ private:
         bool operator<(const ReceiveRecord& other) const { return packetNumber < other.packetNumber; }
     };
     
+    /// The data a reliable channel has waiting to go out, ordered by how much that is relative to its priority.
+    class ChannelDemand {
+    public:
+        ReliableChannel* channel;
+        int bytes;
+        float bytesPerPriority;
+        
+        bool operator<(const ChannelDemand& other) const { return bytesPerPriority < other.bytesPerPriority; }
+    };
+    
     /// Notes that the described send was acknowledged by the other party.
     void sendRecordAcknowledged(const SendRecord& record);
     
@@ -11,8 +11,15 @@
 
 #include <QDateTime>
 #include <QDebugStateSaver>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 #include <QtDebug>
 
+#include <MemoryTracker.h>
+#include <SlabAllocator.h>
+
 #include "MetavoxelData.h"
 #include "Spanner.h"
 
@@ -139,8 +146,12 @@ void MetavoxelData::guide(MetavoxelVisitor& visitor) {
         MetavoxelNode* node = _roots.value(outputs.at(i));
         firstVisitation.outputNodes[i] = node;
     }
-    static_cast<MetavoxelGuide*>(firstVisitation.info.inputValues.last().getInlineValue<
+    MetavoxelVisitor* parallelCopy = visitor.startParallelTour();
+    bool completed = static_cast<MetavoxelGuide*>(firstVisitation.info.inputValues.last().getInlineValue<
         SharedObjectPointer>().data())->guide(firstVisitation);
+    if (parallelCopy) {
+        visitor.finishParallelTour(parallelCopy, !completed);
+    }
     for (int i = 0; i < outputs.size(); i++) {
         OwnedAttributeValue& value = firstVisitation.info.outputValues[i];
         if (!value.getAttribute()) {
@@ -205,8 +216,12 @@ void MetavoxelData::guideToDifferent(const MetavoxelData& other, MetavoxelVisito
             MetavoxelNode* node = _roots.value(outputs.at(i));
             firstVisitation.outputNodes[i] = node;
         }
-        static_cast<MetavoxelGuide*>(firstVisitation.info.inputValues.last().getInlineValue<
+        MetavoxelVisitor* parallelCopy = visitor.startParallelTour();
+        bool completed = static_cast<MetavoxelGuide*>(firstVisitation.info.inputValues.last().getInlineValue<
             SharedObjectPointer>().data())->guideToDifferent(firstVisitation);
+        if (parallelCopy) {
+            visitor.finishParallelTour(parallelCopy, !completed);
+        }
         for (int i = 0; i < outputs.size(); i++) {
             OwnedAttributeValue& value = firstVisitation.info.outputValues[i];
             if (!value.getAttribute()) {
@@ -602,32 +617,42 @@ void MetavoxelData::read(Bitstream& in, const MetavoxelLOD& lod) {
     
     // read in the new roots
     forever {
-        AttributePointer attribute;
-        in >> attribute;
-        if (!attribute) {
+        if (!readRoot(in, lod)) {
             break;
         }
-        MetavoxelStreamBase base = { attribute, in, lod, lod };
-        MetavoxelStreamState state = { base, getMinimum(), _size };
-        in.setContext(&base);
-        attribute->readMetavoxelRoot(*this, state);
-        in.setContext(NULL);
     }
 }
 
 void MetavoxelData::write(Bitstream& out, const MetavoxelLOD& lod) const {
     out << _size;
     for (QHash<AttributePointer, MetavoxelNode*>::const_iterator it = _roots.constBegin(); it != _roots.constEnd(); it++) {
-        out << it.key();
-        MetavoxelStreamBase base = { it.key(), out, lod, lod };
-        MetavoxelStreamState state = { base, getMinimum(), _size };
-        out.setContext(&base);
-        it.key()->writeMetavoxelRoot(*it.value(), state);
-        out.setContext(NULL);
+        writeRoot(out, it.key(), lod);
     }
     out << AttributePointer();
 }
 
+void MetavoxelData::writeRoot(Bitstream& out, const AttributePointer& attribute, const MetavoxelLOD& lod) const {
+    out << attribute;
+    MetavoxelStreamBase base = { attribute, out, lod, lod };
+    MetavoxelStreamState state = { base, getMinimum(), _size };
+    out.setContext(&base);
+    attribute->writeMetavoxelRoot(*_roots.value(attribute), state);
+    out.setContext(NULL);
+}
+
+AttributePointer MetavoxelData::readRoot(Bitstream& in, const MetavoxelLOD& lod) {
+    AttributePointer attribute;
+    in >> attribute;
+    if (attribute) {
+        MetavoxelStreamBase base = { attribute, in, lod, lod };
+        MetavoxelStreamState state = { base, getMinimum(), _size };
+        in.setContext(&base);
+        attribute->readMetavoxelRoot(*this, state);
+        in.setContext(NULL);
+    }
+    return attribute;
+}
+
 void MetavoxelData::readDelta(const MetavoxelData& reference, const MetavoxelLOD& referenceLOD, 
         Bitstream& in, const MetavoxelLOD& lod) {
     // shallow copy the reference
@@ -781,6 +806,25 @@ MetavoxelNode* MetavoxelData::createRoot(const AttributePointer& attribute) {
     return root;
 }
 
+void MetavoxelData::replaceRoots(const MetavoxelData& other) {
+    if (other._size < _size) {
+        MetavoxelData expanded = other;
+        while (expanded._size < _size) {
+            expanded.expand();
+        }
+        replaceRoots(expanded);
+        return;
+    }
+    while (_size < other._size) {
+        expand();
+    }
+    for (QHash<AttributePointer, MetavoxelNode*>::const_iterator it = other._roots.constBegin();
+            it != other._roots.constEnd(); it++) {
+        it.value()->incrementReferenceCount();
+        setRoot(it.key(), it.value());
+    }
+}
+
 bool MetavoxelData::deepEquals(const MetavoxelData& other, const MetavoxelLOD& lod) const {
     if (_size != other._size) {
         return false;
@@ -883,10 +927,55 @@ void MetavoxelStreamState::setMinimum(const glm::vec3& lastMinimum, int index) {
     minimum = getNextMinimum(lastMinimum, size, index);
 }
 
+MetavoxelDeltaRecording::MetavoxelDeltaRecording(const MetavoxelLOD& referenceLOD, const MetavoxelLOD& lod) :
+    _referenceLOD(referenceLOD),
+    _lod(lod) {
+}
+
+int MetavoxelDeltaRecording::recordContext(void* context) {
+    if (!context) {
+        return -1;
+    }
+    // the deferred writes of a root all share its context
+    const AttributePointer& attribute = static_cast<MetavoxelStreamBase*>(context)->attribute;
+    if (_contextAttributes.isEmpty() || _contextAttributes.last() != attribute) {
+        _contextAttributes.append(attribute);
+    }
+    return _contextAttributes.size() - 1;
+}
+
+void MetavoxelDeltaRecording::writeDeferred(Bitstream& out, const DeferredWrite& write) const {
+    if (write.context == -1) {
+        BitstreamRecording::writeDeferred(out, write);
+        return;
+    }
+    MetavoxelStreamBase base = { _contextAttributes.at(write.context), out, _lod, _referenceLOD };
+    void* context = out.getContext();
+    out.setContext(&base);
+    BitstreamRecording::writeDeferred(out, write);
+    out.setContext(context);
+}
+
 int MetavoxelNode::getOppositeChildIndex(int index) {
     return index ^ MAXIMUM_FLAG_MASK;
 }
 
+QAtomicInt MetavoxelNode::_nodeCount;
+
+static MemoryCounter& nodeMemory = MemoryTracker::getInstance().getCounter("Metavoxel nodes");
+
+void* MetavoxelNode::operator new(size_t size) {
+    _nodeCount.ref();
+    nodeMemory.addCPUBytes(size);
+    return SlabAllocator::allocate(size);
+}
+
+void MetavoxelNode::operator delete(void* node, size_t size) {
+    _nodeCount.deref();
+    nodeMemory.removeCPUBytes(size);
+    SlabAllocator::free(node, size);
+}
+
 MetavoxelNode::MetavoxelNode(const AttributeValue& attributeValue, const MetavoxelNode* copyChildren) :
         _referenceCount(1) {
 
@@ -1348,7 +1437,8 @@ MetavoxelVisitor::MetavoxelVisitor(const QVector<AttributePointer>& inputs,
     _outputs(outputs),
     _lod(lod),
     _minimumLODThresholdMultiplier(FLT_MAX),
-    _depth(-1) {
+    _depth(-1),
+    _deferring(false) {
     
     // find the minimum LOD threshold multiplier over all attributes
     foreach (const AttributePointer& attribute, _inputs) {
@@ -1370,6 +1460,14 @@ bool MetavoxelVisitor::postVisit(MetavoxelInfo& info) {
     return false;
 }
 
+MetavoxelVisitor* MetavoxelVisitor::createParallelCopy() const {
+    return NULL;
+}
+
+void MetavoxelVisitor::mergeParallelCopy(MetavoxelVisitor* copy) {
+    // nothing by default
+}
+
 MetavoxelVisitation& MetavoxelVisitor::acquireVisitation() {
     if (++_depth >= _visitations.size()) {
         _visitations.append(MetavoxelVisitation(_depth == 0 ? NULL : &_visitations[_depth - 1],
@@ -1378,6 +1476,140 @@ MetavoxelVisitation& MetavoxelVisitor::acquireVisitation() {
     return _visitations[_depth];
 }
 
+/// The depth at which parallel tours are split, which gives up to 64 subtrees to share among the threads.
+const int PARALLEL_SPLIT_DEPTH = 2;
+
+bool MetavoxelVisitor::deferVisitation(const MetavoxelVisitation& visitation, bool toDifferent) {
+    if (!(_deferring && _depth == PARALLEL_SPLIT_DEPTH)) {
+        return false;
+    }
+    _deferredVisitations.append(visitation);
+    MetavoxelVisitation& deferred = _deferredVisitations.last();
+    deferred.previous = NULL;
+    deferred.info.parentInfo = NULL;
+    if (!toDifferent) {
+        deferred.compareNodes.clear();
+    }
+    return true;
+}
+
+bool MetavoxelVisitor::tourDeferredVisitation(const MetavoxelVisitation& deferred) {
+    MetavoxelVisitation& visitation = acquireVisitation();
+    visitation.inputNodes = deferred.inputNodes;
+    visitation.compareNodes = deferred.compareNodes;
+    visitation.info.inputValues = deferred.info.inputValues;
+    visitation.info.minimum = deferred.info.minimum;
+    visitation.info.size = deferred.info.size;
+    MetavoxelGuide* guide = static_cast<MetavoxelGuide*>(visitation.info.inputValues.last().getInlineValue<
+        SharedObjectPointer>().data());
+    bool completed = deferred.compareNodes.isEmpty() ? guide->guide(visitation) : guide->guideToDifferent(visitation);
+    releaseVisitation();
+    return completed;
+}
+
+MetavoxelVisitor* MetavoxelVisitor::startParallelTour() {
+    if (!_outputs.isEmpty() || QThread::idealThreadCount() < 2) {
+        return NULL;
+    }
+    MetavoxelVisitor* copy = createParallelCopy();
+    if (copy) {
+        copy->_data = _data;
+        _deferring = true;
+    }
+    return copy;
+}
+
+/// The subtrees of a split tour, which the touring threads claim one at a time until none are left.
+class ParallelTour {
+public:
+    
+    QList<MetavoxelVisitation> visitations;
+    QAtomicInt nextVisitation;
+    QAtomicInt shortCircuited;
+    QSemaphore toured;
+    QMutex copiesMutex;
+    QList<MetavoxelVisitor*> copies;
+    
+    /// Tours subtrees until they run out.
+    /// \return the number of subtrees claimed
+    int tour(MetavoxelVisitor* visitor);
+};
+
+typedef QSharedPointer<ParallelTour> ParallelTourPointer;
+
+int ParallelTour::tour(MetavoxelVisitor* visitor) {
+    int claimed = 0;
+    for (int index; (index = nextVisitation.fetchAndAddOrdered(1)) < visitations.size(); claimed++) {
+        // once short-circuited, the rest are claimed without being toured
+        if (!shortCircuited.load() && !visitor->tourDeferredVisitation(visitations.at(index))) {
+            shortCircuited.store(1);
+        }
+    }
+    return claimed;
+}
+
+/// Helps with a split tour on a pool thread.  The tour is shared so that a helper that starts late, after the subtrees
+/// have all been claimed, can simply find nothing left to do.
+class ParallelTourHelper : public QRunnable {
+public:
+    
+    ParallelTourHelper(const ParallelTourPointer& tour, MetavoxelVisitor* copy);
+    
+    virtual void run();
+
+private:
+    
+    ParallelTourPointer _tour;
+    MetavoxelVisitor* _copy;
+};
+
+ParallelTourHelper::ParallelTourHelper(const ParallelTourPointer& tour, MetavoxelVisitor* copy) :
+    _tour(tour),
+    _copy(copy) {
+}
+
+void ParallelTourHelper::run() {
+    int claimed = _tour->tour(_copy);
+    if (claimed == 0) {
+        delete _copy;
+        return;
+    }
+    // hand the copy over for merging before reporting the subtrees toured
+    {
+        QMutexLocker locker(&_tour->copiesMutex);
+        _tour->copies.append(_copy);
+    }
+    _tour->toured.release(claimed);
+}
+
+void MetavoxelVisitor::finishParallelTour(MetavoxelVisitor* firstCopy, bool shortCircuited) {
+    _deferring = false;
+    ParallelTourPointer tour(new ParallelTour());
+    tour->visitations.swap(_deferredVisitations);
+    int helperCount = shortCircuited ? 0 : qMin(QThread::idealThreadCount(), tour->visitations.size()) - 1;
+    if (helperCount <= 0) {
+        delete firstCopy;
+        if (!shortCircuited) {
+            tour->tour(this);
+        }
+        return;
+    }
+    QThreadPool::globalInstance()->start(new ParallelTourHelper(tour, firstCopy));
+    for (int i = 1; i < helperCount; i++) {
+        MetavoxelVisitor* copy = createParallelCopy();
+        copy->_data = _data;
+        QThreadPool::globalInstance()->start(new ParallelTourHelper(tour, copy));
+    }
+    
+    // tour alongside the helpers, then wait for the subtrees they claimed
+    int claimed = tour->tour(this);
+    tour->toured.acquire(tour->visitations.size() - claimed);
+    foreach (MetavoxelVisitor* copy, tour->copies) {
+        mergeParallelCopy(copy);
+        delete copy;
+    }
+}
+
 SpannerVisitor::SpannerVisitor(const QVector<AttributePointer>& spannerInputs, const QVector<AttributePointer>& inputs,
         const QVector<AttributePointer>& outputs, const MetavoxelLOD& lod, int order) :
     MetavoxelVisitor(inputs + spannerInputs, outputs, lod),
@@ -1491,6 +1723,9 @@ static inline bool defaultGuideToChildren(MetavoxelVisitation& visitation, int e
             nextVisitation.outputNodes[j] = child;
         }
         nextVisitation.info.minimum = getNextMinimum(visitation.info.minimum, nextVisitation.info.size, index);
+        if (visitation.visitor->deferVisitation(nextVisitation, false)) {
+            continue;
+        }
         if (!static_cast<MetavoxelGuide*>(nextVisitation.info.inputValues.last().getInlineValue<
                 SharedObjectPointer>().data())->guide(nextVisitation)) {
             visitation.visitor->releaseVisitation();
@@ -1656,6 +1891,9 @@ bool DefaultMetavoxelGuide::guideToDifferent(MetavoxelVisitation& visitation) {
             nextVisitation.outputNodes[j] = child;
         }
         nextVisitation.info.minimum = getNextMinimum(visitation.info.minimum, nextVisitation.info.size, index);
+        if (visitation.visitor->deferVisitation(nextVisitation, true)) {
+            continue;
+        }
         if (!static_cast<MetavoxelGuide*>(nextVisitation.info.inputValues.last().getInlineValue<
                 SharedObjectPointer>().data())->guideToDifferent(nextVisitation)) {
             visitation.visitor->releaseVisitation();
@@ -139,10 +139,24 @@ public:
     void writeDelta(const MetavoxelData& reference, const MetavoxelLOD& referenceLOD,
         Bitstream& out, const MetavoxelLOD& lod) const;
 
+    /// Writes the root of a single attribute, in the form that write() uses for each.
+    void writeRoot(Bitstream& out, const AttributePointer& attribute, const MetavoxelLOD& lod = MetavoxelLOD()) const;
+    
+    /// Reads a root written by writeRoot, replacing any existing root of its attribute.
+    /// \return the attribute read, or null at the end of the list that write() writes
+    AttributePointer readRoot(Bitstream& in, const MetavoxelLOD& lod = MetavoxelLOD());
+
     void setRoot(const AttributePointer& attribute, MetavoxelNode* root);
     MetavoxelNode* getRoot(const AttributePointer& attribute) const { return _roots.value(attribute); }    
     MetavoxelNode* createRoot(const AttributePointer& attribute);
 
+    /// Returns the attributes that have roots.
+    QList<AttributePointer> getAttributes() const { return _roots.keys(); }
+
+    /// Shares the other data's roots in place of our own for each of its attributes, first expanding whichever of the two
+    /// is smaller.
+    void replaceRoots(const MetavoxelData& other);
+
     /// Performs a deep comparison between this data and the specified other (as opposed to the == operator, which does a
     /// shallow comparison).
     bool deepEquals(const MetavoxelData& other, const MetavoxelLOD& lod = MetavoxelLOD()) const;
@@ -201,6 +215,25 @@ public:
     void setMinimum(const glm::vec3& lastMinimum, int index);
 };
 
+/// A recording of MetavoxelData::writeDelta between a pair of LODs, which keeps the attribute of the stream context at
+/// each deferred write so that the context can be rebuilt when the recording is replayed.
+class MetavoxelDeltaRecording : public BitstreamRecording {
+public:
+    
+    MetavoxelDeltaRecording(const MetavoxelLOD& referenceLOD, const MetavoxelLOD& lod);
+
+protected:
+    
+    virtual int recordContext(void* context);
+    virtual void writeDeferred(Bitstream& out, const DeferredWrite& write) const;
+
+private:
+    
+    MetavoxelLOD _referenceLOD;
+    MetavoxelLOD _lod;
+    QVector<AttributePointer> _contextAttributes;
+};
+
 /// A single node within a metavoxel layer.
 class MetavoxelNode {
 public:
@@ -209,6 +242,13 @@ public:
 
     static int getOppositeChildIndex(int index);
 
+    /// Returns the number of nodes in existence, across all data.
+    static int getNodeCount() { return _nodeCount.load(); }
+
+    /// Nodes come out of the SlabAllocator slabs.
+    static void* operator new(size_t size);
+    static void operator delete(void* node, size_t size);
+
     MetavoxelNode(const AttributeValue& attributeValue, const MetavoxelNode* copyChildren = NULL);
     MetavoxelNode(const AttributePointer& attribute, const MetavoxelNode* copy);
     
@@ -272,6 +312,8 @@ private:
     QAtomicInt _referenceCount;
     void* _attributeValue;
     MetavoxelNode* _children[CHILD_COUNT];
+    
+    static QAtomicInt _nodeCount;
 };
 
 /// Contains information about a metavoxel (explicit or procedural).
@@ -356,12 +398,30 @@ public:
     /// \return whether or not any outputs were set in the info
     virtual bool postVisit(MetavoxelInfo& info);
 
+    /// Creates a copy of this visitor that can tour part of the data on another thread, or returns NULL (the default) to
+    /// keep the tour on one thread.  Only visitors without outputs are split.  When they are, the subtrees beneath the upper
+    /// levels are toured by this visitor and its copies in no set order, after the upper levels have been post-visited, and
+    /// a short circuit only stops the subtrees that haven't yet begun.  Copies should start out without any results of their
+    /// own, since they're merged back in once the tour is complete.
+    virtual MetavoxelVisitor* createParallelCopy() const;
+    
+    /// Merges the results of a parallel copy into this visitor.
+    virtual void mergeParallelCopy(MetavoxelVisitor* copy);
+
     /// Acquires the next visitation, incrementing the depth.
     MetavoxelVisitation& acquireVisitation();
 
     /// Releases the current visitation, decrementing the depth.
     void releaseVisitation() { _depth--; }
 
+    /// If the tour is being split among threads and the visitation is at the depth where it splits, saves the visitation
+    /// to be toured later and returns true.
+    bool deferVisitation(const MetavoxelVisitation& visitation, bool toDifferent);
+    
+    /// Tours a visitation saved by deferVisitation.
+    /// \return true to keep going, false to short circuit the tour
+    bool tourDeferredVisitation(const MetavoxelVisitation& deferred);
+
 protected:
 
     QVector<AttributePointer> _inputs;
@@ -371,6 +431,16 @@ protected:
     MetavoxelData* _data;
     QList<MetavoxelVisitation> _visitations;
     int _depth;
+
+private:
+    
+    friend class MetavoxelData;
+    
+    MetavoxelVisitor* startParallelTour();
+    void finishParallelTour(MetavoxelVisitor* firstCopy, bool shortCircuited);
+    
+    bool _deferring;
+    QList<MetavoxelVisitation> _deferredVisitations; ///< those with compare nodes are toured to the different nodes
 };
 
 /// Base class for visitors to spanners.
@@ -16,12 +16,27 @@
 #include <QVBoxLayout>
 #include <QWriteLocker>
 
+#include <SlabAllocator.h>
+
 #include "Bitstream.h"
 #include "MetavoxelUtil.h"
 #include "SharedObject.h"
 
 REGISTER_META_OBJECT(SharedObject)
 
+int SharedObject::getObjectCount() {
+    QReadLocker locker(&_weakHashLock);
+    return _weakHash.size();
+}
+
+void* SharedObject::operator new(size_t size) {
+    return SlabAllocator::allocate(size);
+}
+
+void SharedObject::operator delete(void* object, size_t size) {
+    SlabAllocator::free(object, size);
+}
+
 SharedObject::SharedObject() :
     _id(_nextID.fetchAndAddOrdered(1)),
     _originID(_id),
@@ -41,6 +41,13 @@ public:
     /// Returns a reference to the weak hash lock.
     static QReadWriteLock& getWeakHashLock() { return _weakHashLock; }
     
+    /// Returns the number of shared objects registered under their IDs, of all classes.
+    static int getObjectCount();
+
+    /// Shared objects of all but the largest classes come out of the SlabAllocator slabs.
+    static void* operator new(size_t size);
+    static void operator delete(void* object, size_t size);
+
     Q_INVOKABLE SharedObject();
 
     /// Returns the unique local ID for this object.
@@ -36,6 +36,21 @@ REGISTER_META_OBJECT(Cuboid)
 REGISTER_META_OBJECT(StaticModel)
 REGISTER_META_OBJECT(MaterialObject)
 
+// spanners are streamed with every edit and subdivision, so their properties bypass reflection
+REGISTER_PROPERTY_ACCESSOR(Spanner, Box, bounds, getBounds, setBounds)
+REGISTER_PROPERTY_ACCESSOR(Spanner, float, placementGranularity, getPlacementGranularity, setPlacementGranularity)
+REGISTER_PROPERTY_ACCESSOR(Spanner, float, voxelizationGranularity, getVoxelizationGranularity, setVoxelizationGranularity)
+REGISTER_PROPERTY_ACCESSOR(Spanner, bool, willBeVoxelized, getWillBeVoxelized, setWillBeVoxelized)
+REGISTER_PROPERTY_ACCESSOR(Transformable, glm::vec3, translation, getTranslation, setTranslation)
+REGISTER_PROPERTY_ACCESSOR(Transformable, glm::quat, rotation, getRotation, setRotation)
+REGISTER_PROPERTY_ACCESSOR(Transformable, float, scale, getScale, setScale)
+REGISTER_PROPERTY_ACCESSOR(ColorTransformable, QColor, color, getColor, setColor)
+REGISTER_PROPERTY_ACCESSOR(Cuboid, float, aspectY, getAspectY, setAspectY)
+REGISTER_PROPERTY_ACCESSOR(Cuboid, float, aspectZ, getAspectZ, setAspectZ)
+REGISTER_PROPERTY_ACCESSOR(StaticModel, QUrl, url, getURL, setURL)
+REGISTER_PROPERTY_ACCESSOR(Heightfield, float, aspectY, getAspectY, setAspectY)
+REGISTER_PROPERTY_ACCESSOR(Heightfield, float, aspectZ, getAspectZ, setAspectZ)
+
 static int heightfieldHeightTypeId = registerSimpleMetaType<HeightfieldHeightPointer>();
 static int heightfieldColorTypeId = registerSimpleMetaType<HeightfieldColorPointer>();
 static int heightfieldMaterialTypeId = registerSimpleMetaType<HeightfieldMaterialPointer>();
@@ -15,9 +15,11 @@
 #include <QJsonDocument>
 #include <QRegExp>
 #include <QStringList>
+#include <QThread>
 
 #include <GLMHelpers.h>
 #include <SettingHandle.h>
+#include <SharedUtil.h>
 #include <UUID.h>
 
 #include "NodeList.h"
@@ -29,6 +31,12 @@ const QString SETTINGS_CURRENT_ADDRESS_KEY = "address";
 
 Setting::Handle<QUrl> currentAddressHandle(QStringList() << ADDRESS_MANAGER_SETTINGS_GROUP << "address");
 
+// a place looked up this recently is gone to without asking the API again
+const quint64 PLACE_CACHE_FRESH_USECS = 5 * 60 * USECS_PER_SECOND;
+// up to this age it is still gone to right away but looked up again in the background, past it we wait for the lookup
+const quint64 PLACE_CACHE_MAX_AGE_USECS = 24 * 60 * 60 * USECS_PER_SECOND;
+const int MAX_CACHED_PLACES = 100;
+
 
 AddressManager::AddressManager() :
     _rootPlaceName(),
@@ -143,53 +151,100 @@ bool AddressManager::handleUrl(const QUrl& lookupUrl) {
     return false;
 }
 
+QUrl AddressManager::lookupUrlFromString(const QString& lookupString) const {
+    // make this a valid hifi URL
+    QString sanitizedString = lookupString.trimmed();
+    
+    if (!lookupString.startsWith('/')) {
+        const QRegExp HIFI_SCHEME_REGEX = QRegExp(HIFI_URL_SCHEME + ":\\/{1,2}", Qt::CaseInsensitive);
+        sanitizedString = sanitizedString.remove(HIFI_SCHEME_REGEX);
+        
+        return QUrl(HIFI_URL_SCHEME + "://" + sanitizedString);
+    } else {
+        return QUrl(lookupString);
+    }
+}
+
 void AddressManager::handleLookupString(const QString& lookupString) {
     if (!lookupString.isEmpty()) {
         // make this a valid hifi URL and handle it off to handleUrl
-        QString sanitizedString = lookupString.trimmed();
-        QUrl lookupURL;
-        
-        if (!lookupString.startsWith('/')) {
-            const QRegExp HIFI_SCHEME_REGEX = QRegExp(HIFI_URL_SCHEME + ":\\/{1,2}", Qt::CaseInsensitive);
-            sanitizedString = sanitizedString.remove(HIFI_SCHEME_REGEX);
-            
-            lookupURL = QUrl(HIFI_URL_SCHEME + "://" + sanitizedString);
-        } else {
-            lookupURL = QUrl(lookupString);
-        }
-        
-        handleUrl(lookupURL);
+        handleUrl(lookupUrlFromString(lookupString));
     }
 }
 
+const char OVERRIDE_PATH_KEY[] = "override_path";
+const char LOOKUP_PLACE_KEY[] = "lookup_place";
+const char LOOKUP_MODE_KEY[] = "lookup_mode";
+
+const QString LOOKUP_MODE_PREFETCH = "prefetch";
+const QString LOOKUP_MODE_REVALIDATE = "revalidate";
+
+const QString DATA_OBJECT_PLACE_KEY = "place";
+const QString DATA_OBJECT_USER_LOCATION_KEY = "location";
+
+const QString LOCATION_API_ROOT_KEY = "root";
+const QString LOCATION_API_DOMAIN_KEY = "domain";
+const QString LOCATION_API_ONLINE_KEY = "online";
+
+static QVariantMap locationMapFromData(const QVariantMap& dataObject) {
+    if (dataObject.contains(DATA_OBJECT_PLACE_KEY)) {
+        return dataObject[DATA_OBJECT_PLACE_KEY].toMap();
+    } else {
+        return dataObject[DATA_OBJECT_USER_LOCATION_KEY].toMap();
+    }
+}
+
+static QVariantMap domainMapFromData(const QVariantMap& dataObject) {
+    QVariantMap locationMap = locationMapFromData(dataObject);
+    
+    QVariantMap rootMap = locationMap[LOCATION_API_ROOT_KEY].toMap();
+    if (rootMap.isEmpty()) {
+        rootMap = locationMap;
+    }
+    
+    return rootMap[LOCATION_API_DOMAIN_KEY].toMap();
+}
+
 void AddressManager::handleAPIResponse(QNetworkReply& requestReply) {
     QJsonObject responseObject = QJsonDocument::fromJson(requestReply.readAll()).object();
-    QJsonObject dataObject = responseObject["data"].toObject();
+    QVariantMap dataObject = responseObject["data"].toObject().toVariantMap();
+    
+    QString lookupPlace = requestReply.property(LOOKUP_PLACE_KEY).toString();
+    QString lookupMode = requestReply.property(LOOKUP_MODE_KEY).toString();
+    
+    if (!lookupPlace.isEmpty()) {
+        QVariantMap previousDataObject = _placeCache.value(lookupPlace.toLower()).dataObject;
+        cachePlace(lookupPlace, dataObject);
+        
+        if (lookupMode == LOOKUP_MODE_PREFETCH) {
+            // nobody is waiting on this one - let whoever cares get ready for a possible trip to its domain
+            const QString DOMAIN_NETWORK_ADDRESS_KEY = "network_address";
+            QString domainHostname = domainMapFromData(dataObject)[DOMAIN_NETWORK_ADDRESS_KEY].toString();
+            if (!domainHostname.isEmpty()) {
+                emit possibleDomainChangeAhead(domainHostname);
+            }
+            return;
+        } else if (lookupMode == LOOKUP_MODE_REVALIDATE) {
+            // we already went to this place from the cache - only go again if we're still there and it has moved
+            if (QString::compare(lookupPlace, _rootPlaceName, Qt::CaseInsensitive) == 0
+                && domainMapFromData(dataObject) != domainMapFromData(previousDataObject)) {
+                qDebug() << "Domain for place" << lookupPlace << "changed since it was cached, going there again.";
+                goToAddressFromObject(dataObject, requestReply.property(OVERRIDE_PATH_KEY).toString());
+            }
+            return;
+        }
+    }
     
-    goToAddressFromObject(dataObject.toVariantMap(), requestReply);
+    goToAddressFromObject(dataObject, requestReply.property(OVERRIDE_PATH_KEY).toString());
     
     emit lookupResultsFinished();
 }
 
-const char OVERRIDE_PATH_KEY[] = "override_path";
-
-void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const QNetworkReply& reply) {
+void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const QString& overridePath) {
     
-    const QString DATA_OBJECT_PLACE_KEY = "place";
-    const QString DATA_OBJECT_USER_LOCATION_KEY = "location";
-    
-    QVariantMap locationMap;
-    if (dataObject.contains(DATA_OBJECT_PLACE_KEY)) {
-        locationMap = dataObject[DATA_OBJECT_PLACE_KEY].toMap();
-    } else {
-        locationMap = dataObject[DATA_OBJECT_USER_LOCATION_KEY].toMap();
-    }
+    QVariantMap locationMap = locationMapFromData(dataObject);
     
     if (!locationMap.isEmpty()) {
-        const QString LOCATION_API_ROOT_KEY = "root";
-        const QString LOCATION_API_DOMAIN_KEY = "domain";
-        const QString LOCATION_API_ONLINE_KEY = "online";
-        
         if (!locationMap.contains(LOCATION_API_ONLINE_KEY)
             || locationMap[LOCATION_API_ONLINE_KEY].toBool()) {
             
@@ -238,8 +293,6 @@ void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const
                 setRootPlaceName(newRootPlaceName);
                 
                 // check if we had a path to override the path returned
-                QString overridePath = reply.property(OVERRIDE_PATH_KEY).toString();
-                
                 if (!overridePath.isEmpty()) {
                     if (!handleRelativeViewpoint(overridePath)){
                         qDebug() << "User entered path could not be handled as a viewpoint - " << overridePath;
@@ -277,6 +330,18 @@ void AddressManager::goToAddressFromObject(const QVariantMap& dataObject, const
 void AddressManager::handleAPIError(QNetworkReply& errorReply) {
     qDebug() << "AddressManager API error -" << errorReply.error() << "-" << errorReply.errorString();
     
+    QString lookupPlace = errorReply.property(LOOKUP_PLACE_KEY).toString();
+    
+    if (errorReply.error() == QNetworkReply::ContentNotFoundError && !lookupPlace.isEmpty()) {
+        // the place is gone, don't keep sending people to it from the cache
+        _placeCache.remove(lookupPlace.toLower());
+    }
+    
+    if (!errorReply.property(LOOKUP_MODE_KEY).toString().isEmpty()) {
+        // background lookups have nobody waiting on their result
+        return;
+    }
+    
     if (errorReply.error() == QNetworkReply::ContentNotFoundError) {
         emit lookupResultIsNotFound();
     }
@@ -286,15 +351,42 @@ void AddressManager::handleAPIError(QNetworkReply& errorReply) {
 const QString GET_PLACE = "/api/v1/places/%1";
 
 void AddressManager::attemptPlaceNameLookup(const QString& lookupString, const QString& overridePath) {
-    // assume this is a place name and see if we can get any info on it
-    QString placeName = QUrl::toPercentEncoding(lookupString);
+    QHash<QString, CachedPlace>::iterator cachedPlace = _placeCache.find(lookupString.toLower());
+    
+    if (cachedPlace != _placeCache.end()) {
+        quint64 age = usecTimestampNow() - cachedPlace->resolvedAt;
+        
+        if (age < PLACE_CACHE_MAX_AGE_USECS) {
+            // go there now with what we have, and if it's getting old check that it hasn't moved
+            QVariantMap dataObject = cachedPlace->dataObject;
+            
+            if (age >= PLACE_CACHE_FRESH_USECS) {
+                requestPlace(lookupString, overridePath, LOOKUP_MODE_REVALIDATE);
+            }
+            
+            goToAddressFromObject(dataObject, overridePath);
+            emit lookupResultsFinished();
+            return;
+        }
+        
+        _placeCache.erase(cachedPlace);
+    }
     
+    // assume this is a place name and see if we can get any info on it
+    requestPlace(lookupString, overridePath, QString());
+}
+
+void AddressManager::requestPlace(const QString& placeName, const QString& overridePath, const QString& lookupMode) {
     QVariantMap requestParams;
     if (!overridePath.isEmpty()) {
         requestParams.insert(OVERRIDE_PATH_KEY, overridePath);
     }
+    if (!lookupMode.isEmpty()) {
+        requestParams.insert(LOOKUP_MODE_KEY, lookupMode);
+    }
+    requestParams.insert(LOOKUP_PLACE_KEY, placeName);
     
-    AccountManager::getInstance().unauthenticatedRequest(GET_PLACE.arg(placeName),
+    AccountManager::getInstance().unauthenticatedRequest(GET_PLACE.arg(QString(QUrl::toPercentEncoding(placeName))),
                                                          QNetworkAccessManager::GetOperation,
                                                          apiCallbackParameters(),
                                                          QByteArray(),
@@ -302,6 +394,60 @@ void AddressManager::attemptPlaceNameLookup(const QString& lookupString, const Q
                                                          requestParams);
 }
 
+void AddressManager::cachePlace(const QString& placeName, const QVariantMap& dataObject) {
+    QString cacheKey = placeName.toLower();
+    QVariantMap locationMap = locationMapFromData(dataObject);
+    
+    if (domainMapFromData(dataObject).isEmpty()
+        || (locationMap.contains(LOCATION_API_ONLINE_KEY) && !locationMap[LOCATION_API_ONLINE_KEY].toBool())) {
+        // offline or unusable places have to be asked about every time
+        _placeCache.remove(cacheKey);
+        return;
+    }
+    
+    if (!_placeCache.contains(cacheKey) && _placeCache.size() >= MAX_CACHED_PLACES) {
+        // make room by dropping the place we resolved longest ago
+        QHash<QString, CachedPlace>::iterator oldest = _placeCache.begin();
+        for (QHash<QString, CachedPlace>::iterator it = _placeCache.begin(); it != _placeCache.end(); ++it) {
+            if (it->resolvedAt < oldest->resolvedAt) {
+                oldest = it;
+            }
+        }
+        _placeCache.erase(oldest);
+    }
+    
+    CachedPlace& cachedPlace = _placeCache[cacheKey];
+    cachedPlace.dataObject = dataObject;
+    cachedPlace.resolvedAt = usecTimestampNow();
+}
+
+void AddressManager::prefetchLookupString(const QString& lookupString) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "prefetchLookupString", Q_ARG(const QString&, lookupString));
+        return;
+    }
+    
+    if (lookupString.isEmpty()) {
+        return;
+    }
+    
+    // only place names go through the API - usernames move around too much to be worth it, and addresses need no lookup
+    QUrl lookupUrl = lookupUrlFromString(lookupString);
+    QString host = lookupUrl.host();
+    
+    if (lookupUrl.scheme() != HIFI_URL_SCHEME || host.isEmpty() || lookupUrl.authority().startsWith('@')
+        || host.contains('.') || host == "localhost") {
+        return;
+    }
+    
+    QHash<QString, CachedPlace>::const_iterator cachedPlace = _placeCache.constFind(host.toLower());
+    if (cachedPlace != _placeCache.constEnd() && usecTimestampNow() - cachedPlace->resolvedAt < PLACE_CACHE_FRESH_USECS) {
+        return;
+    }
+    
+    requestPlace(host, QString(), LOOKUP_MODE_PREFETCH);
+}
+
 bool AddressManager::handleNetworkAddress(const QString& lookupString) {
     const QString IP_ADDRESS_REGEX_STRING = "^((?:(?:[0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\\.){3}"
         "(?:[0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5]))(?::(\\d{1,5}))?$";
@@ -12,6 +12,7 @@
 #ifndef hifi_AddressManager_h
 #define hifi_AddressManager_h
 
+#include <qhash.h>
 #include <qobject.h>
 
 #include <glm/glm.hpp>
@@ -57,7 +58,10 @@ public:
 public slots:
     void handleLookupString(const QString& lookupString);
     void goToUser(const QString& username);
-    void goToAddressFromObject(const QVariantMap& addressMap, const QNetworkReply& reply);
+    void goToAddressFromObject(const QVariantMap& addressMap, const QString& overridePath = QString());
+
+    /// looks up the place a lookup string names ahead of time, so going there later doesn't wait on the lookup
+    void prefetchLookupString(const QString& lookupString);
     
     void storeCurrentAddress();
     
@@ -69,6 +73,7 @@ signals:
     void lookupResultIsOffline();
     void lookupResultIsNotFound();
     void possibleDomainChangeRequired(const QString& newHostname, quint16 newPort);
+    void possibleDomainChangeAhead(const QString& hostname);
     void possibleDomainChangeRequiredViaICEForID(const QString& iceServerHostname, const QUuid& domainID);
     void locationChangeRequired(const glm::vec3& newPosition,
                                 bool hasOrientationChange, const glm::quat& newOrientation,
@@ -80,11 +85,22 @@ private slots:
     void handleAPIResponse(QNetworkReply& requestReply);
     void handleAPIError(QNetworkReply& errorReply);
 private:
+    // what a place lookup came back with, kept so going there again can start right away
+    class CachedPlace {
+    public:
+        QVariantMap dataObject;
+        quint64 resolvedAt;
+    };
+
     void setDomainInfo(const QString& hostname, quint16 port);
     
     const JSONCallbackParameters& apiCallbackParameters();
     
+    QUrl lookupUrlFromString(const QString& lookupString) const;
     bool handleUrl(const QUrl& lookupUrl);
+
+    void requestPlace(const QString& placeName, const QString& overridePath, const QString& lookupMode);
+    void cachePlace(const QString& placeName, const QVariantMap& dataObject);
     
     bool handleNetworkAddress(const QString& lookupString);
     bool handleRelativeViewpoint(const QString& pathSubsection, bool shouldFace = false);
@@ -94,6 +110,8 @@ private:
     QUuid _rootPlaceID;
     PositionGetter _positionGetter;
     OrientationGetter _orientationGetter;
+
+    QHash<QString, CachedPlace> _placeCache; // by lower case place name
 };
 
 #endif // hifi_AddressManager_h
\ No newline at end of file
@@ -0,0 +1,148 @@
+//
+//  BatchedDatagramSocket.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <QtCore/QDebug>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+
+#include "BatchedDatagramSocket.h"
+
+BatchedDatagramSocket::BatchedDatagramSocket(QUdpSocket& socket) :
+    _socket(socket),
+    _numQueuedDatagrams(0)
+{
+    
+}
+
+int BatchedDatagramSocket::read() {
+    if (_readBuffer.isEmpty()) {
+        _readBuffer.resize(MAX_BATCH_DATAGRAMS * MAX_DATAGRAM_BYTES);
+        _sizes.resize(MAX_BATCH_DATAGRAMS);
+        _senderSockAddrs.resize(MAX_BATCH_DATAGRAMS);
+    }
+    if (!_socket.hasPendingDatagrams()) {
+        return 0;
+    }
+    
+    // the first goes through the QUdpSocket, which turns its read notification back on so readyRead() keeps coming
+    qint64 size = _socket.readDatagram(_readBuffer.data(), MAX_DATAGRAM_BYTES,
+                                       _senderSockAddrs[0].getAddressPointer(), _senderSockAddrs[0].getPortPointer());
+    if (size < 0) {
+        return 0;
+    }
+    _sizes[0] = size;
+    int numRead = 1;
+    
+#ifdef Q_OS_LINUX
+    // then everything else that's waiting, in one call
+    const int MAX_BATCHED_READS = MAX_BATCH_DATAGRAMS - 1;
+    mmsghdr messages[MAX_BATCHED_READS];
+    iovec vectors[MAX_BATCHED_READS];
+    sockaddr_storage addresses[MAX_BATCHED_READS];
+    memset(messages, 0, sizeof(messages));
+    for (int i = 0; i < MAX_BATCHED_READS; i++) {
+        vectors[i].iov_base = _readBuffer.data() + (i + 1) * MAX_DATAGRAM_BYTES;
+        vectors[i].iov_len = MAX_DATAGRAM_BYTES;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+    }
+    int numReceived = recvmmsg(_socket.socketDescriptor(), messages, MAX_BATCHED_READS, MSG_DONTWAIT, NULL);
+    for (int i = 0; i < numReceived; i++) {
+        _sizes[numRead] = messages[i].msg_len;
+        _senderSockAddrs[numRead++] = HifiSockAddr(reinterpret_cast<const sockaddr*>(&addresses[i]));
+    }
+#else
+    while (numRead < MAX_BATCH_DATAGRAMS && _socket.hasPendingDatagrams()) {
+        size = _socket.readDatagram(_readBuffer.data() + numRead * MAX_DATAGRAM_BYTES, MAX_DATAGRAM_BYTES,
+                                    _senderSockAddrs[numRead].getAddressPointer(),
+                                    _senderSockAddrs[numRead].getPortPointer());
+        if (size < 0) {
+            break;
+        }
+        _sizes[numRead++] = size;
+    }
+#endif
+
+    return numRead;
+}
+
+void BatchedDatagramSocket::queue(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr) {
+    if (_numQueuedDatagrams == _queuedDatagrams.size()) {
+        _queuedDatagrams.resize(_numQueuedDatagrams + 1);
+    }
+    QueuedDatagram& datagram = _queuedDatagrams[_numQueuedDatagrams++];
+    datagram.data = data;
+    datagram.size = size;
+    datagram.destinationSockAddr = destinationSockAddr;
+}
+
+int BatchedDatagramSocket::flush() {
+    int numWritten = 0;
+    
+#ifdef Q_OS_LINUX
+    mmsghdr messages[MAX_BATCH_DATAGRAMS];
+    iovec vectors[MAX_BATCH_DATAGRAMS];
+    sockaddr_in addresses[MAX_BATCH_DATAGRAMS];
+    for (int first = 0; first < _numQueuedDatagrams; ) {
+        // the node socket is IPv4, anything else is left to the QUdpSocket
+        int numBatched = 0;
+        memset(messages, 0, sizeof(messages));
+        memset(addresses, 0, sizeof(addresses));
+        while (numBatched < MAX_BATCH_DATAGRAMS && first + numBatched < _numQueuedDatagrams) {
+            const QueuedDatagram& datagram = _queuedDatagrams.at(first + numBatched);
+            const QHostAddress& address = datagram.destinationSockAddr.getAddress();
+            if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+                break;
+            }
+            addresses[numBatched].sin_family = AF_INET;
+            addresses[numBatched].sin_port = htons(datagram.destinationSockAddr.getPort());
+            addresses[numBatched].sin_addr.s_addr = htonl(address.toIPv4Address());
+            vectors[numBatched].iov_base = const_cast<char*>(datagram.data);
+            vectors[numBatched].iov_len = datagram.size;
+            messages[numBatched].msg_hdr.msg_iov = &vectors[numBatched];
+            messages[numBatched].msg_hdr.msg_iovlen = 1;
+            messages[numBatched].msg_hdr.msg_name = &addresses[numBatched];
+            messages[numBatched].msg_hdr.msg_namelen = sizeof(addresses[numBatched]);
+            numBatched++;
+        }
+        int numSent = (numBatched > 0) ? sendmmsg(_socket.socketDescriptor(), messages, numBatched, 0) : 0;
+        if (numSent > 0) {
+            numWritten += numSent;
+            first += numSent;
+        } else {
+            // the QUdpSocket reports why the first one can't go
+            numWritten += writeQueuedDatagram(_queuedDatagrams.at(first++));
+        }
+    }
+#else
+    for (int i = 0; i < _numQueuedDatagrams; i++) {
+        numWritten += writeQueuedDatagram(_queuedDatagrams.at(i));
+    }
+#endif
+
+    _numQueuedDatagrams = 0;
+    return numWritten;
+}
+
+int BatchedDatagramSocket::writeQueuedDatagram(const QueuedDatagram& datagram) {
+    if (_socket.writeDatagram(datagram.data, datagram.size, datagram.destinationSockAddr.getAddress(),
+                              datagram.destinationSockAddr.getPort()) < 0) {
+        qDebug() << "ERROR in writeDatagram:" << _socket.error() << "-" << _socket.errorString();
+        return 0;
+    }
+    return 1;
+}
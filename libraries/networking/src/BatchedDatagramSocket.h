@@ -0,0 +1,68 @@
+//
+//  BatchedDatagramSocket.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BatchedDatagramSocket_h
+#define hifi_BatchedDatagramSocket_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <QtNetwork/QUdpSocket>
+
+#include "HifiSockAddr.h"
+
+/// Reads and writes a QUdpSocket's datagrams in batches. On Linux a batch goes through a single recvmmsg() or
+/// sendmmsg(), elsewhere each datagram still takes a QUdpSocket call.
+class BatchedDatagramSocket {
+public:
+    static const int MAX_BATCH_DATAGRAMS = 32;
+
+    BatchedDatagramSocket(QUdpSocket& socket);
+    
+    /// Reads up to MAX_BATCH_DATAGRAMS of the datagrams waiting on the socket and returns how many were read. Call it
+    /// until it returns zero from the slot connected to readyRead().
+    int read();
+    
+    /// Returns a copy of a read datagram, which can outlive the next read().
+    QByteArray getDatagram(int index) const { return QByteArray(getDatagramData(index), _sizes.at(index)); }
+    
+    /// Returns the bytes of a read datagram in place, which the next read() overwrites.
+    const char* getDatagramData(int index) const { return _readBuffer.constData() + index * MAX_DATAGRAM_BYTES; }
+    int getDatagramSize(int index) const { return _sizes.at(index); }
+    const HifiSockAddr& getSenderSockAddr(int index) const { return _senderSockAddrs.at(index); }
+    
+    /// Queues a datagram for flush(), which must be called before the data changes.
+    void queue(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr);
+    
+    /// Writes the queued datagrams and returns how many went out.
+    int flush();
+
+private:
+    
+    static const int MAX_DATAGRAM_BYTES = 65536;
+    
+    struct QueuedDatagram {
+        const char* data;
+        qint64 size;
+        HifiSockAddr destinationSockAddr;
+    };
+    
+    int writeQueuedDatagram(const QueuedDatagram& datagram);
+    
+    QUdpSocket& _socket;
+    
+    QByteArray _readBuffer;
+    QVector<int> _sizes;
+    QVector<HifiSockAddr> _senderSockAddrs;
+    
+    QVector<QueuedDatagram> _queuedDatagrams;
+    int _numQueuedDatagrams;
+};
+
+#endif // hifi_BatchedDatagramSocket_h
@@ -0,0 +1,343 @@
+//
+//  CoalescedNetworkReply.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include "NetworkAccessManager.h"
+#include "CoalescedNetworkReply.h"
+
+// guards the downloads in flight and everything in them, which the threads of the leaders and followers share
+static QMutex downloadsMutex;
+static QHash<QByteArray, QSharedPointer<SharedDownload> > downloadsInFlight;
+
+// the attributes of the real reply that the followers are given
+static const QNetworkRequest::Attribute COPIED_ATTRIBUTES[] = {
+    QNetworkRequest::HttpStatusCodeAttribute,
+    QNetworkRequest::HttpReasonPhraseAttribute,
+    QNetworkRequest::RedirectionTargetAttribute,
+    QNetworkRequest::ConnectionEncryptedAttribute,
+    QNetworkRequest::SourceIsFromCacheAttribute
+};
+static const int COPIED_ATTRIBUTE_COUNT = sizeof(COPIED_ATTRIBUTES) / sizeof(COPIED_ATTRIBUTES[0]);
+
+// two requests share a download only if they'd be answered the same
+static QByteArray getRequestKey(const QNetworkRequest& request) {
+    QByteArray key = request.url().toEncoded();
+    key += '\n';
+    key += QByteArray::number(request.attribute(QNetworkRequest::CacheLoadControlAttribute,
+        QNetworkRequest::PreferNetwork).toInt());
+    foreach (const QByteArray& header, request.rawHeaderList()) {
+        key += '\n' + header + ": " + request.rawHeader(header);
+    }
+    return key;
+}
+
+static void removeFromFlight(const QSharedPointer<SharedDownload>& download) {
+    QHash<QByteArray, QSharedPointer<SharedDownload> >::iterator it = downloadsInFlight.find(download->key);
+    if (it != downloadsInFlight.end() && it.value() == download) {
+        downloadsInFlight.erase(it);
+    }
+}
+
+static void updateFollowers(const SharedDownload& download) {
+    foreach (CoalescedNetworkReply* follower, download.followers) {
+        follower->queueUpdate();
+    }
+}
+
+// passes a download without a leader to a follower to resume on its thread, or cancels it if nothing follows it
+static void handOverDownload(const QSharedPointer<SharedDownload>& download) {
+    if (download->followers.isEmpty()) {
+        download->finished = true;
+        download->error = QNetworkReply::OperationCanceledError;
+        download->errorString = "The download was cancelled";
+        removeFromFlight(download);
+        return;
+    }
+    download->resumingFollower = download->followers.first();
+    QMetaObject::invokeMethod(download->resumingFollower, "resumeDownload", Qt::QueuedConnection);
+}
+
+DownloadLeader::DownloadLeader(QNetworkReply* reply, const QSharedPointer<SharedDownload>& download,
+        qint64 resumeOffset) :
+    QObject(reply),
+    _reply(reply),
+    _download(download),
+    _resumeOffset(resumeOffset),
+    _bytesToSkip(resumeOffset) {
+
+    connect(reply, &QNetworkReply::metaDataChanged, this, &DownloadLeader::handleMetaDataChanged);
+    connect(reply, &QNetworkReply::downloadProgress, this, &DownloadLeader::handleDownloadProgress);
+    connect(reply, &QNetworkReply::readyRead, this, &DownloadLeader::handleReadyRead);
+    connect(reply, &QNetworkReply::finished, this, &DownloadLeader::handleFinished);
+}
+
+DownloadLeader::~DownloadLeader() {
+    QMutexLocker locker(&downloadsMutex);
+    _download->leader = nullptr;
+    if (!_download->finished) {
+        // the reply went without finishing, as when the manager of a thread that's exiting is deleted, so the download
+        // carries on from a thread that still wants it
+        handOverDownload(_download);
+    }
+}
+
+void DownloadLeader::abortIfUnwanted() {
+    {
+        QMutexLocker locker(&downloadsMutex);
+        if (!_download->followers.isEmpty() || _download->finished) {
+            return;
+        }
+        // out of flight first, so that nothing new joins a download about to be aborted
+        removeFromFlight(_download);
+    }
+    _reply->abort();
+}
+
+void DownloadLeader::handleMetaDataChanged() {
+    QMutexLocker locker(&downloadsMutex);
+    if (_resumeOffset > 0) {
+        // the followers keep the first reply's metadata, this one only tells us whether the range was honored
+        const int PARTIAL_CONTENT = 206;
+        if (_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == PARTIAL_CONTENT) {
+            _bytesToSkip = 0;
+        }
+        return;
+    }
+    updateMetaData();
+    updateFollowers(*_download);
+}
+
+void DownloadLeader::handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal) {
+    QMutexLocker locker(&downloadsMutex);
+    _download->bytesTotal = bytesTotal;
+}
+
+void DownloadLeader::handleReadyRead() {
+    QByteArray data = _reply->readAll();
+    QMutexLocker locker(&downloadsMutex);
+    appendData(data);
+    updateFollowers(*_download);
+}
+
+void DownloadLeader::handleFinished() {
+    QByteArray data = _reply->readAll();
+    {
+        QMutexLocker locker(&downloadsMutex);
+        appendData(data);
+        if (_resumeOffset == 0) {
+            updateMetaData();
+        }
+        _download->finished = true;
+        _download->error = _reply->error();
+        _download->errorString = _reply->errorString();
+        removeFromFlight(_download);
+        updateFollowers(*_download);
+    }
+    _reply->deleteLater();
+}
+
+void DownloadLeader::updateMetaData() {
+    _download->metaDataVersion++;
+    _download->url = _reply->url();
+    _download->rawHeaders = _reply->rawHeaderPairs();
+    _download->attributes.clear();
+    for (int i = 0; i < COPIED_ATTRIBUTE_COUNT; i++) {
+        QVariant value = _reply->attribute(COPIED_ATTRIBUTES[i]);
+        if (value.isValid()) {
+            _download->attributes.append(qMakePair(COPIED_ATTRIBUTES[i], value));
+        }
+    }
+}
+
+void DownloadLeader::appendData(const QByteArray& data) {
+    int skipped = (int)qMin(_bytesToSkip, (qint64)data.size());
+    _bytesToSkip -= skipped;
+    _download->data.append(data.constData() + skipped, data.size() - skipped);
+}
+
+QNetworkReply* CoalescedNetworkReply::get(const QNetworkRequest& request) {
+    QByteArray key = getRequestKey(request);
+    QMutexLocker locker(&downloadsMutex);
+    QSharedPointer<SharedDownload> download = downloadsInFlight.value(key);
+    if (!download) {
+        download = QSharedPointer<SharedDownload>(new SharedDownload());
+        download->key = key;
+        download->leader = new DownloadLeader(NetworkAccessManager::getInstance().get(request), download);
+        downloadsInFlight.insert(key, download);
+    }
+    CoalescedNetworkReply* reply = new CoalescedNetworkReply(request, download);
+    download->followers.append(reply);
+
+    // a reply that joins late catches up with what has arrived already
+    reply->queueUpdate();
+    return reply;
+}
+
+CoalescedNetworkReply::CoalescedNetworkReply(const QNetworkRequest& request,
+        const QSharedPointer<SharedDownload>& download) :
+    _download(download),
+    _attached(true),
+    _updateQueued(false),
+    _metaDataVersion(0),
+    _bytesReceived(0),
+    _readOffset(0) {
+
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::GetOperation);
+    open(QIODevice::ReadOnly);
+}
+
+CoalescedNetworkReply::~CoalescedNetworkReply() {
+    QMutexLocker locker(&downloadsMutex);
+    detach();
+}
+
+void CoalescedNetworkReply::abort() {
+    {
+        QMutexLocker locker(&downloadsMutex);
+        detach();
+    }
+    if (isFinished()) {
+        return;
+    }
+    setError(OperationCanceledError, "Operation canceled");
+    setFinished(true);
+    emit error(OperationCanceledError);
+    emit finished();
+}
+
+qint64 CoalescedNetworkReply::bytesAvailable() const {
+    QMutexLocker locker(&downloadsMutex);
+    return _download->data.size() - _readOffset + QNetworkReply::bytesAvailable();
+}
+
+qint64 CoalescedNetworkReply::readData(char* data, qint64 maxSize) {
+    QMutexLocker locker(&downloadsMutex);
+    qint64 available = _download->data.size() - _readOffset;
+    if (available <= 0) {
+        return _download->finished ? -1 : 0;
+    }
+    qint64 size = qMin(available, maxSize);
+    memcpy(data, _download->data.constData() + _readOffset, size);
+    _readOffset += size;
+    return size;
+}
+
+void CoalescedNetworkReply::queueUpdate() {
+    if (!_updateQueued) {
+        _updateQueued = true;
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+    }
+}
+
+void CoalescedNetworkReply::detach() {
+    if (!_attached) {
+        return;
+    }
+    _attached = false;
+    _download->followers.removeOne(this);
+    if (_download->finished) {
+        return;
+    }
+    if (_download->resumingFollower == this) {
+        // we were to take over the download, so someone else has to
+        _download->resumingFollower = nullptr;
+        handOverDownload(_download);
+
+    } else if (_download->followers.isEmpty() && _download->leader) {
+        QMetaObject::invokeMethod(_download->leader, "abortIfUnwanted", Qt::QueuedConnection);
+    }
+}
+
+void CoalescedNetworkReply::update() {
+    bool metaDataUpdated = false;
+    bool dataReceived = false;
+    bool downloadFinished = false;
+    qint64 bytesTotal;
+    NetworkError downloadError = NoError;
+    QString downloadErrorString;
+    {
+        QMutexLocker locker(&downloadsMutex);
+        _updateQueued = false;
+        if (!_attached) {
+            return;
+        }
+        const SharedDownload& download = *_download;
+        if (download.metaDataVersion != _metaDataVersion) {
+            _metaDataVersion = download.metaDataVersion;
+            metaDataUpdated = true;
+            setUrl(download.url);
+            foreach (const RawHeaderPair& header, download.rawHeaders) {
+                setRawHeader(header.first, header.second);
+            }
+            for (int i = 0; i < download.attributes.size(); i++) {
+                setAttribute(download.attributes.at(i).first, download.attributes.at(i).second);
+            }
+        }
+        if (download.data.size() > _bytesReceived) {
+            _bytesReceived = download.data.size();
+            dataReceived = true;
+        }
+        bytesTotal = download.bytesTotal;
+        if (download.finished) {
+            downloadFinished = true;
+            downloadError = download.error;
+            downloadErrorString = download.errorString;
+            detach();
+        }
+    }
+
+    // in the order the real reply emits them, finishing last as the receivers can delete the reply then
+    if (metaDataUpdated) {
+        emit metaDataChanged();
+    }
+    if (dataReceived) {
+        emit readyRead();
+        if (!downloadFinished) {
+            emit downloadProgress(_bytesReceived, bytesTotal);
+        }
+    }
+    if (!downloadFinished) {
+        return;
+    }
+    if (downloadError != NoError) {
+        setError(downloadError, downloadErrorString);
+        setFinished(true);
+        emit error(downloadError);
+
+    } else {
+        setFinished(true);
+        emit downloadProgress(_bytesReceived, _bytesReceived);
+    }
+    emit readChannelFinished();
+    emit finished();
+}
+
+void CoalescedNetworkReply::resumeDownload() {
+    QMutexLocker locker(&downloadsMutex);
+    if (_download->resumingFollower != this) {
+        return;
+    }
+    _download->resumingFollower = nullptr;
+
+    // ask for only what we don't have yet
+    QNetworkRequest resumeRequest = request();
+    qint64 resumeOffset = _download->data.size();
+    if (resumeOffset > 0) {
+        resumeRequest.setRawHeader("Range", "bytes=" + QByteArray::number(resumeOffset) + "-");
+    }
+    _download->leader = new DownloadLeader(NetworkAccessManager::getInstance().get(resumeRequest), _download,
+        resumeOffset);
+}
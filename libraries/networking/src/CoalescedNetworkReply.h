@@ -0,0 +1,118 @@
+//
+//  CoalescedNetworkReply.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CoalescedNetworkReply_h
+#define hifi_CoalescedNetworkReply_h
+
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QSharedPointer>
+#include <QtNetwork/QNetworkReply>
+
+class CoalescedNetworkReply;
+class DownloadLeader;
+
+/// What has arrived of a GET that any number of replies follow, on whichever threads they were made.  Only touched
+/// with the downloads' mutex held.
+class SharedDownload {
+public:
+    QByteArray key;
+    DownloadLeader* leader = nullptr;
+    QList<CoalescedNetworkReply*> followers;
+    CoalescedNetworkReply* resumingFollower = nullptr; // the follower the download is handed to if its leader goes
+
+    int metaDataVersion = 0;
+    QUrl url;
+    QList<QNetworkReply::RawHeaderPair> rawHeaders;
+    QList<QPair<QNetworkRequest::Attribute, QVariant> > attributes;
+
+    QByteArray data;
+    qint64 bytesTotal = -1;
+
+    bool finished = false;
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+    QString errorString;
+};
+
+/// Makes the real request on the thread that first asked for it, and collects what arrives for the followers.  It's a
+/// child of the reply, so it goes when the reply does, including when the thread's manager is deleted.  If that
+/// happens before the download is done, it's resumed on the thread of a follower, from where it left off.
+class DownloadLeader : public QObject {
+    Q_OBJECT
+
+public:
+    /// A leader resuming a download asks for what follows the bytes already received, and drops that many from the
+    /// start if the server sends the whole thing again.
+    DownloadLeader(QNetworkReply* reply, const QSharedPointer<SharedDownload>& download, qint64 resumeOffset = 0);
+    virtual ~DownloadLeader();
+
+    /// Aborts the request if nothing follows it anymore.
+    Q_INVOKABLE void abortIfUnwanted();
+
+private slots:
+    void handleMetaDataChanged();
+    void handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
+    void handleReadyRead();
+    void handleFinished();
+
+private:
+    void updateMetaData();
+    void appendData(const QByteArray& data);
+
+    QNetworkReply* _reply;
+    QSharedPointer<SharedDownload> _download;
+    qint64 _resumeOffset;
+    qint64 _bytesToSkip;
+};
+
+/// A reply to a GET that follows the same request already in flight, if there is one, rather than starting another
+/// download.  It acts as any other reply on the thread it was made on, and belongs to the caller the same way.
+class CoalescedNetworkReply : public QNetworkReply {
+    Q_OBJECT
+
+public:
+    /// Makes the request on the calling thread's manager, or follows the same one, with the same headers and cache
+    /// control, in flight on any thread.
+    static QNetworkReply* get(const QNetworkRequest& request);
+
+    virtual ~CoalescedNetworkReply();
+
+    virtual void abort();
+    virtual qint64 bytesAvailable() const;
+    virtual bool isSequential() const { return true; }
+
+protected:
+    virtual qint64 readData(char* data, qint64 maxSize);
+
+private:
+    CoalescedNetworkReply(const QNetworkRequest& request, const QSharedPointer<SharedDownload>& download);
+
+    friend class DownloadLeader;
+
+    /// Has the reply catch up with the download on its own thread, the mutex being held.
+    void queueUpdate();
+
+    /// Stops following the download, the mutex being held.
+    void detach();
+
+    Q_INVOKABLE void update();
+
+    /// Takes over a download whose leader went before it finished, if it's still this reply's to take.
+    Q_INVOKABLE void resumeDownload();
+
+    QSharedPointer<SharedDownload> _download;
+    bool _attached;
+    bool _updateQueued;
+    int _metaDataVersion;
+    qint64 _bytesReceived;
+    qint64 _readOffset;
+};
+
+#endif // hifi_CoalescedNetworkReply_h
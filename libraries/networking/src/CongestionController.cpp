@@ -0,0 +1,150 @@
+//
+//  CongestionController.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <SharedUtil.h>
+
+#include "CongestionController.h"
+
+const int CongestionController::MIN_SEND_RATE = 32 * 1024;
+const int CongestionController::MAX_SEND_RATE = 16 * 1024 * 1024;
+const int CongestionController::INITIAL_SEND_RATE = 512 * 1024;
+
+const quint64 CongestionController::TARGET_QUEUING_DELAY = 50 * USECS_PER_MSEC;
+
+// the bucket holds what a sender that goes out once a frame needs for a frame, and at least a few full packets
+const quint64 MAX_BURST_USECS = 20 * USECS_PER_MSEC;
+const float MIN_BURST_BYTES = 4 * 1450;
+
+// real time streams can run the bucket into debt, which is paid back before bulk traffic goes again, up to a limit
+const quint64 MAX_DEBT_USECS = USECS_PER_SECOND / 4;
+
+// each base history entry covers this long, so the base round trip forgets a route within about a minute
+const quint64 BASE_HISTORY_INTERVAL = 15 * USECS_PER_SECOND;
+
+// how much of the rate one round trip sample can add, when on target, or take away, when a full target over it
+const float RATE_INCREASE_GAIN = 0.25f;
+const float RATE_DECREASE_GAIN = 0.5f;
+
+// the rate only grows from a sample taken while we were sending at least this much of it
+const float MIN_UTILIZATION_FOR_INCREASE = 0.5f;
+
+// a little loss is normal on wireless links and doesn't mean a queue is overflowing
+const float LOSS_TOLERANCE = 0.02f;
+const float MAX_LOSS_DECREASE = 0.5f;
+
+CongestionController::CongestionController() :
+    _sendRate(INITIAL_SEND_RATE),
+    _tokens(MIN_BURST_BYTES),
+    _lastRefill(0),
+    _baseHistoryIndex(0),
+    _baseHistoryRotated(0),
+    _queuingDelay(0),
+    _bytesSinceSample(0),
+    _lastSample(0)
+{
+    std::fill(_baseHistory, _baseHistory + BASE_HISTORY_SIZE, 0);
+}
+
+void CongestionController::roundTripSampled(quint64 roundTrip, quint64 now) {
+    QMutexLocker locker(&_mutex);
+    _queuingDelay = roundTrip - updateBaseRoundTrip(roundTrip, now);
+    
+    // how far under the target we are, as a fraction of it, or over it, down to a full target over
+    float offTarget = std::max(-1.0f, ((float)TARGET_QUEUING_DELAY - (float)_queuingDelay) / TARGET_QUEUING_DELAY);
+    
+    if (offTarget < 0.0f) {
+        _sendRate *= 1.0f + RATE_DECREASE_GAIN * offTarget;
+        
+    } else if (_lastSample != 0 && now > _lastSample) {
+        float sendable = _sendRate * (now - _lastSample) / USECS_PER_SECOND;
+        if (_bytesSinceSample >= sendable * MIN_UTILIZATION_FOR_INCREASE) {
+            _sendRate *= 1.0f + RATE_INCREASE_GAIN * offTarget;
+        }
+    }
+    _sendRate = std::min(std::max(_sendRate, (float)MIN_SEND_RATE), (float)MAX_SEND_RATE);
+    _bytesSinceSample = 0;
+    _lastSample = now;
+}
+
+void CongestionController::lossSampled(float lossRate) {
+    QMutexLocker locker(&_mutex);
+    if (lossRate > LOSS_TOLERANCE) {
+        _sendRate = std::max((float)MIN_SEND_RATE, _sendRate * (1.0f - std::min(lossRate, MAX_LOSS_DECREASE)));
+    }
+}
+
+void CongestionController::packetSent(int bytes, quint64 now) {
+    QMutexLocker locker(&_mutex);
+    refill(now);
+    _tokens = std::max(_tokens - bytes, -_sendRate * MAX_DEBT_USECS / USECS_PER_SECOND);
+    _bytesSinceSample += bytes;
+}
+
+bool CongestionController::canSend(int bytes, quint64 now) {
+    QMutexLocker locker(&_mutex);
+    refill(now);
+    
+    // a packet bigger than the bucket would never fit, so it goes once the bucket is full
+    float burst = std::max(_sendRate * MAX_BURST_USECS / USECS_PER_SECOND, MIN_BURST_BYTES);
+    return _tokens >= std::min((float)bytes, burst);
+}
+
+int CongestionController::getSendRate() const {
+    QMutexLocker locker(&_mutex);
+    return (int)_sendRate;
+}
+
+quint64 CongestionController::getBaseRoundTrip() const {
+    QMutexLocker locker(&_mutex);
+    quint64 baseRoundTrip = 0;
+    for (int i = 0; i < BASE_HISTORY_SIZE; i++) {
+        if (_baseHistory[i] != 0 && (baseRoundTrip == 0 || _baseHistory[i] < baseRoundTrip)) {
+            baseRoundTrip = _baseHistory[i];
+        }
+    }
+    return baseRoundTrip;
+}
+
+quint64 CongestionController::getQueuingDelay() const {
+    QMutexLocker locker(&_mutex);
+    return _queuingDelay;
+}
+
+void CongestionController::refill(quint64 now) {
+    if (_lastRefill != 0 && now > _lastRefill) {
+        float burst = std::max(_sendRate * MAX_BURST_USECS / USECS_PER_SECOND, MIN_BURST_BYTES);
+        _tokens = std::min(burst, _tokens + _sendRate * (now - _lastRefill) / USECS_PER_SECOND);
+    }
+    _lastRefill = std::max(_lastRefill, now);
+}
+
+quint64 CongestionController::updateBaseRoundTrip(quint64 roundTrip, quint64 now) {
+    if (_baseHistoryRotated == 0) {
+        _baseHistoryRotated = now;
+        
+    } else if (now - _baseHistoryRotated >= BASE_HISTORY_INTERVAL) {
+        _baseHistoryIndex = (_baseHistoryIndex + 1) % BASE_HISTORY_SIZE;
+        _baseHistory[_baseHistoryIndex] = 0;
+        _baseHistoryRotated = now;
+    }
+    quint64& current = _baseHistory[_baseHistoryIndex];
+    if (current == 0 || roundTrip < current) {
+        current = roundTrip;
+    }
+    quint64 baseRoundTrip = roundTrip;
+    for (int i = 0; i < BASE_HISTORY_SIZE; i++) {
+        if (_baseHistory[i] != 0) {
+            baseRoundTrip = std::min(baseRoundTrip, _baseHistory[i]);
+        }
+    }
+    return baseRoundTrip;
+}
@@ -0,0 +1,78 @@
+//
+//  CongestionController.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionController_h
+#define hifi_CongestionController_h
+
+#include <QtCore/QMutex>
+
+/// Estimates how fast we can send to one node without building a queue in front of it, and paces what we send to that.
+///
+/// The estimate is delay based, like LEDBAT: the smallest round trip seen recently is taken as the path with empty
+/// queues, and the rate grows while round trips stay within a target delay of that and shrinks in proportion as they
+/// go past it.  Reported loss beyond a small tolerance cuts it as well.  The rate only grows while we're using most of
+/// it, so a quiet stream can't build up a rate it never tested.
+///
+/// Every stream to the node shares one token bucket filled at the rate.  Real time streams send regardless and just
+/// spend from it, while bulk senders wait until canSend() says the bucket has room, so they're the ones that yield.
+class CongestionController {
+public:
+    
+    static const int MIN_SEND_RATE; // bytes per second
+    static const int MAX_SEND_RATE;
+    static const int INITIAL_SEND_RATE;
+    
+    /// how far over the smallest recent round trip the round trip may get before the rate comes down, in usecs
+    static const quint64 TARGET_QUEUING_DELAY;
+    
+    CongestionController();
+    
+    /// Updates the rate from a measured round trip, in usecs.
+    void roundTripSampled(quint64 roundTrip, quint64 now);
+    
+    /// Updates the rate from the fraction of packets the node reports having lost since its last report.
+    void lossSampled(float lossRate);
+    
+    /// Spends from the bucket for a packet sent to the node, whether or not canSend() allowed it.
+    void packetSent(int bytes, quint64 now);
+    
+    /// Returns whether a bulk packet of this size can go out now without exceeding the rate.
+    bool canSend(int bytes, quint64 now);
+    
+    int getSendRate() const;
+    quint64 getBaseRoundTrip() const;
+    quint64 getQueuingDelay() const;
+
+private:
+    
+    void refill(quint64 now);
+    quint64 updateBaseRoundTrip(quint64 roundTrip, quint64 now);
+    
+    // the base round trip is the smallest of the minimums kept for each of the last few intervals, so that it can
+    // rise when the route changes
+    static const int BASE_HISTORY_SIZE = 4;
+    
+    mutable QMutex _mutex;
+    
+    float _sendRate;
+    float _tokens;
+    quint64 _lastRefill;
+    
+    quint64 _baseHistory[BASE_HISTORY_SIZE];
+    int _baseHistoryIndex;
+    quint64 _baseHistoryRotated;
+    quint64 _queuingDelay;
+    
+    // how much went out between round trip samples, to tell whether we've been using the rate
+    quint64 _bytesSinceSample;
+    quint64 _lastSample;
+};
+
+#endif // hifi_CongestionController_h
@@ -110,9 +110,16 @@ void DomainHandler::setHostnameAndPort(const QString& hostname, quint16 port) {
             
             qDebug() << "Updated domain hostname to" << _hostname;
             
-            // re-set the sock addr to null and fire off a lookup of the IP address for this domain-server's hostname
-            qDebug("Looking up DS hostname %s.", _hostname.toLocal8Bit().constData());
-            QHostInfo::lookupHost(_hostname, this, SLOT(completedHostnameLookup(const QHostInfo&)));
+            if (_prefetchedAddresses.contains(_hostname)) {
+                // we looked this one up ahead of time, no need to wait on another lookup
+                _sockAddr.setAddress(_prefetchedAddresses.take(_hostname));
+                qDebug("DS at %s was prefetched at %s", _hostname.toLocal8Bit().constData(),
+                       _sockAddr.getAddress().toString().toLocal8Bit().constData());
+            } else {
+                // re-set the sock addr to null and fire off a lookup of the IP address for this domain-server's hostname
+                qDebug("Looking up DS hostname %s.", _hostname.toLocal8Bit().constData());
+                QHostInfo::lookupHost(_hostname, this, SLOT(completedHostnameLookup(const QHostInfo&)));
+            }
             
             UserActivityLogger::getInstance().changedDomain(_hostname);
             emit hostnameChanged(_hostname);
@@ -169,6 +176,29 @@ void DomainHandler::completedHostnameLookup(const QHostInfo& hostInfo) {
     qDebug("Failed domain server lookup");
 }
 
+void DomainHandler::prefetchHostname(const QString& hostname) {
+    // addresses given as IPs have nothing to look up
+    if (hostname != _hostname && QHostAddress(hostname).isNull()) {
+        QHostInfo::lookupHost(hostname, this, SLOT(completedHostnamePrefetch(const QHostInfo&)));
+    }
+}
+
+void DomainHandler::completedHostnamePrefetch(const QHostInfo& hostInfo) {
+    // we only ever prefetch a few places, don't let the addresses pile up if nobody goes to them
+    const int MAX_PREFETCHED_ADDRESSES = 16;
+    
+    for (int i = 0; i < hostInfo.addresses().size(); i++) {
+        if (hostInfo.addresses()[i].protocol() == QAbstractSocket::IPv4Protocol) {
+            if (_prefetchedAddresses.size() >= MAX_PREFETCHED_ADDRESSES
+                && !_prefetchedAddresses.contains(hostInfo.hostName())) {
+                _prefetchedAddresses.erase(_prefetchedAddresses.begin());
+            }
+            _prefetchedAddresses.insert(hostInfo.hostName(), hostInfo.addresses()[i]);
+            return;
+        }
+    }
+}
+
 void DomainHandler::setIsConnected(bool isConnected) {
     if (_isConnected != isConnected) {
         _isConnected = isConnected;
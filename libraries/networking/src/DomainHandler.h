@@ -12,6 +12,7 @@
 #ifndef hifi_DomainHandler_h
 #define hifi_DomainHandler_h
 
+#include <QtCore/QHash>
 #include <QtCore/QJsonObject>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -76,8 +77,12 @@ public slots:
     void setHostnameAndPort(const QString& hostname, quint16 port = DEFAULT_DOMAIN_SERVER_PORT);
     void setIceServerHostnameAndID(const QString& iceServerHostname, const QUuid& id);
     
+    /// looks up the address of a domain-server we may be asked to go to, so going there needn't wait on it
+    void prefetchHostname(const QString& hostname);
+    
 private slots:
     void completedHostnameLookup(const QHostInfo& hostInfo);
+    void completedHostnamePrefetch(const QHostInfo& hostInfo);
     void settingsRequestFinished();
 signals:
     void hostnameChanged(const QString& hostname);
@@ -103,6 +108,7 @@ private:
     QTimer* _handshakeTimer;
     QJsonObject _settingsObject;
     int _failedSettingsRequests;
+    QHash<QString, QHostAddress> _prefetchedAddresses;
 };
 
 #endif // hifi_DomainHandler_h
@@ -11,11 +11,14 @@
 
 #include <cstring>
 #include <cstdlib>
+#include <climits>
 #include <cstdio>
 
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
 
@@ -23,10 +26,17 @@
 
 #include <tbb/parallel_for.h>
 
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+
 #include "AccountManager.h"
 #include "Assignment.h"
 #include "HifiSockAddr.h"
 #include "LimitedNodeList.h"
+#include "PacketBuffer.h"
 #include "PacketHeaders.h"
 #include "SharedUtil.h"
 #include "UUID.h"
@@ -38,12 +48,21 @@ const char SOLO_NODE_TYPES[2] = {
 
 const QUrl DEFAULT_NODE_AUTH_URL = QUrl("https://metaverse.highfidelity.io");
 
+const QString NETWORK_IMPAIRMENT_ENV = "HIFI_NETWORK_IMPAIRMENT";
+
+// how often held back datagrams are checked for, well under the jitter any profile has
+const int IMPAIRMENT_UPDATE_INTERVAL_MSECS = 1;
+
 LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short dtlsListenPort) :
     _sessionUUID(),
     _nodeHash(),
     _nodeMutex(QReadWriteLock::Recursive),
+    _nodeSnapshot(new NodeSnapshot()),
     _nodeSocket(this),
+    _batchedNodeSocket(_nodeSocket),
     _dtlsSocket(NULL),
+    _isImpaired(false),
+    _impairmentTimer(NULL),
     _localSockAddr(),
     _publicSockAddr(),
     _stunSockAddr(STUN_SERVER_HOSTNAME, STUN_SERVER_PORT),
@@ -78,6 +97,24 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     connect(localSocketUpdate, &QTimer::timeout, this, &LimitedNodeList::updateLocalSockAddr);
     localSocketUpdate->start(LOCAL_SOCKET_UPDATE_INTERVAL_MSECS);
     
+    // the reliable channels resend on timeouts well above this, so it mostly bounds how long a window stays closed
+    const int RELIABLE_CHANNEL_UPDATE_INTERVAL_MSECS = 20;
+    QTimer* reliableChannelUpdate = new QTimer(this);
+    connect(reliableChannelUpdate, &QTimer::timeout, this, &LimitedNodeList::updateReliableChannels);
+    reliableChannelUpdate->start(RELIABLE_CHANNEL_UPDATE_INTERVAL_MSECS);
+    
+    QString impairment = QProcessEnvironment::systemEnvironment().value(NETWORK_IMPAIRMENT_ENV);
+    if (!impairment.isEmpty()) {
+        NetworkImpairment::Settings impairmentSettings;
+        if (NetworkImpairment::parseSettings(impairment, impairmentSettings)) {
+            setNetworkImpairment(impairmentSettings);
+        } else {
+            qDebug() << "Ignoring unreadable" << NETWORK_IMPAIRMENT_ENV << impairment
+                << "- expected one of" << NetworkImpairment::getProfileNames()
+                << "and/or latency, jitter, loss, reorder, bandwidth or queue=value";
+        }
+    }
+    
     // check the local socket right now
     updateLocalSockAddr();
     
@@ -112,6 +149,46 @@ QUdpSocket& LimitedNodeList::getDTLSSocket() {
     return *_dtlsSocket;
 }
 
+QUdpSocket* LimitedNodeList::createReceiveShardSocket() {
+#if defined(Q_OS_LINUX) && defined(SO_REUSEPORT)
+    // the node socket has to allow sharing too, the kernel checks both when the new one binds
+    int enable = 1;
+    if (setsockopt(_nodeSocket.socketDescriptor(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        qDebug() << "Could not enable SO_REUSEPORT on the node socket -" << strerror(errno);
+        return NULL;
+    }
+    int descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(_nodeSocket.localPort());
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(descriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0 ||
+            bind(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        qDebug() << "Could not bind a receive shard socket to port" << _nodeSocket.localPort()
+            << "-" << strerror(errno);
+        close(descriptor);
+        return NULL;
+    }
+    QUdpSocket* shardSocket = new QUdpSocket();
+    if (!shardSocket->setSocketDescriptor(descriptor)) {
+        close(descriptor);
+        delete shardSocket;
+        return NULL;
+    }
+    
+    // it takes its share of the same traffic, so give it the same room to queue it
+    shardSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                                 _nodeSocket.socketOption(QAbstractSocket::ReceiveBufferSizeSocketOption));
+    return shardSocket;
+#else
+    return NULL;
+#endif
+}
+
 void LimitedNodeList::changeSocketBufferSizes(int numBytes) {
     for (int i = 0; i < 2; i++) {
         QAbstractSocket::SocketOption bufferOpt;
@@ -142,6 +219,8 @@ bool LimitedNodeList::packetVersionAndHashMatch(const QByteArray& packet) {
     PacketType checkType = packetTypeForPacket(packet);
     int numPacketTypeBytes = numBytesArithmeticCodingFromBuffer(packet.data());
     
+    _packetMetrics.packetReceived(checkType, packet.size());
+    
     if (packet[numPacketTypeBytes] != versionForPacketType(checkType)
         && checkType != PacketTypeStunResponse) {
         PacketType mismatchType = packetTypeForPacket(packet);
@@ -166,8 +245,8 @@ bool LimitedNodeList::packetVersionAndHashMatch(const QByteArray& packet) {
         // figure out which node this is from
         SharedNodePointer sendingNode = sendingNodeForPacket(packet);
         if (sendingNode) {
-            // check if the md5 hash in the header matches the hash we would expect
-            if (hashFromPacketHeader(packet) == hashForPacketAndConnectionUUID(packet, sendingNode->getConnectionSecret())) {
+            // check if the hash in the header matches the hash we would expect
+            if (packetHashMatchesConnectionUUID(packet, sendingNode->getConnectionSecret())) {
                 return true;
             } else {
                 static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
@@ -211,19 +290,46 @@ qint64 LimitedNodeList::readDatagram(QByteArray& incomingPacket, QHostAddress* a
 
 qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr,
                                       const QUuid& connectionSecret) {
-    QByteArray datagramCopy = datagram;
+    if (connectionSecret.isNull()) {
+        // nothing to patch, send the caller's bytes as they are
+        return writeDatagramInPlace(const_cast<char*>(datagram.constData()), datagram.size(),
+                                    destinationSockAddr, connectionSecret);
+    }
     
+    // the hash goes in the header, so verified packets are sent from a copy the caller can't see, pooled when the
+    // packet is of a size we'd ever send
+    if (datagram.size() <= PacketBuffer::CAPACITY) {
+        PacketBuffer datagramCopy;
+        datagramCopy.append(datagram.constData(), datagram.size());
+        return writeDatagramInPlace(datagramCopy.data(), datagramCopy.size(), destinationSockAddr, connectionSecret);
+    }
+    QByteArray datagramCopy(datagram.constData(), datagram.size());
+    return writeDatagramInPlace(datagramCopy.data(), datagramCopy.size(), destinationSockAddr, connectionSecret);
+}
+
+void LimitedNodeList::prepareDatagramInPlace(char* data, qint64 size, const QUuid& connectionSecret) {
     if (!connectionSecret.isNull()) {
-        // setup the MD5 hash for source verification in the header
-        replaceHashInPacketGivenConnectionUUID(datagramCopy, connectionSecret);
+        // setup the hash for source verification in the header
+        replaceHashInPacketGivenConnectionUUID(data, size, connectionSecret);
     }
     
     // XXX can BandwidthRecorder be used for this?
     // stat collection for packets
     ++_numCollectedPackets;
-    _numCollectedBytes += datagram.size();
+    _numCollectedBytes += size;
+    _packetMetrics.packetSent(packetTypeForPacket(data), size);
+}
+
+qint64 LimitedNodeList::writeDatagramInPlace(char* data, qint64 size, const HifiSockAddr& destinationSockAddr,
+                                             const QUuid& connectionSecret) {
+    prepareDatagramInPlace(data, size, connectionSecret);
+    
+    if (_isImpaired) {
+        _networkImpairment.push(data, size, destinationSockAddr, usecTimestampNow());
+        return size;
+    }
     
-    qint64 bytesWritten = _nodeSocket.writeDatagram(datagramCopy,
+    qint64 bytesWritten = _nodeSocket.writeDatagram(data, size,
                                                     destinationSockAddr.getAddress(), destinationSockAddr.getPort());
     
     if (bytesWritten < 0) {
@@ -233,23 +339,28 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSock
     return bytesWritten;
 }
 
+void LimitedNodeList::datagramSentToNode(const SharedNodePointer& destinationNode, qint64 size) {
+    emit dataSent(destinationNode->getType(), size);
+    destinationNode->getCongestionController().packetSent(size, usecTimestampNow());
+}
+
+const HifiSockAddr* LimitedNodeList::getDestinationSockAddr(const SharedNodePointer& destinationNode,
+                                                            const HifiSockAddr& overridenSockAddr) {
+    // if we don't have an overridden address, assume they want to send to the node's active socket
+    return overridenSockAddr.isNull() ? destinationNode->getActiveSocket() : &overridenSockAddr;
+}
+
 qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
                                       const SharedNodePointer& destinationNode,
                                       const HifiSockAddr& overridenSockAddr) {
     if (destinationNode) {
-        // if we don't have an overridden address, assume they want to send to the node's active socket
-        const HifiSockAddr* destinationSockAddr = &overridenSockAddr;
-        if (overridenSockAddr.isNull()) {
-            if (destinationNode->getActiveSocket()) {
-                // use the node's active socket as the destination socket
-                destinationSockAddr = destinationNode->getActiveSocket();
-            } else {
-                // we don't have a socket to send to, return 0
-                return 0;
-            }
+        const HifiSockAddr* destinationSockAddr = getDestinationSockAddr(destinationNode, overridenSockAddr);
+        if (!destinationSockAddr) {
+            // we don't have a socket to send to, return 0
+            return 0;
         }
 
-        emit dataSent(destinationNode->getType(), datagram.size());
+        datagramSentToNode(destinationNode, datagram.size());
         
         return writeDatagram(datagram, *destinationSockAddr, destinationNode->getConnectionSecret());
     }
@@ -258,6 +369,175 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
     return 0;
 }
 
+qint64 LimitedNodeList::writeDatagramInPlace(char* data, qint64 size, const SharedNodePointer& destinationNode,
+                                             const HifiSockAddr& overridenSockAddr) {
+    if (destinationNode) {
+        const HifiSockAddr* destinationSockAddr = getDestinationSockAddr(destinationNode, overridenSockAddr);
+        if (!destinationSockAddr) {
+            // we don't have a socket to send to, return 0
+            return 0;
+        }
+        
+        datagramSentToNode(destinationNode, size);
+        
+        return writeDatagramInPlace(data, size, *destinationSockAddr, destinationNode->getConnectionSecret());
+    }
+    
+    // didn't have a destinationNode to send to, return 0
+    return 0;
+}
+
+qint64 LimitedNodeList::writeDatagramInPlace(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                             const HifiSockAddr& overridenSockAddr) {
+    // data() only copies if the buffer is shared, which a pooled one isn't
+    return writeDatagramInPlace(datagram.data(), datagram.size(), destinationNode, overridenSockAddr);
+}
+
+qint64 LimitedNodeList::writeDatagramInPlace(PacketBuffer& packet, const SharedNodePointer& destinationNode,
+                                             const HifiSockAddr& overridenSockAddr) {
+    return writeDatagramInPlace(packet.data(), packet.size(), destinationNode, overridenSockAddr);
+}
+
+qint64 LimitedNodeList::queueDatagramInPlace(char* data, qint64 size, const SharedNodePointer& destinationNode,
+                                             const HifiSockAddr& overridenSockAddr) {
+    if (destinationNode) {
+        const HifiSockAddr* destinationSockAddr = getDestinationSockAddr(destinationNode, overridenSockAddr);
+        if (!destinationSockAddr) {
+            // we don't have a socket to send to, return 0
+            return 0;
+        }
+        
+        datagramSentToNode(destinationNode, size);
+        
+        prepareDatagramInPlace(data, size, destinationNode->getConnectionSecret());
+        if (_isImpaired) {
+            _networkImpairment.push(data, size, *destinationSockAddr, usecTimestampNow());
+        } else {
+            _batchedNodeSocket.queue(data, size, *destinationSockAddr);
+        }
+        return size;
+    }
+    
+    // didn't have a destinationNode to send to, return 0
+    return 0;
+}
+
+qint64 LimitedNodeList::queueDatagramInPlace(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                             const HifiSockAddr& overridenSockAddr) {
+    return queueDatagramInPlace(datagram.data(), datagram.size(), destinationNode, overridenSockAddr);
+}
+
+void LimitedNodeList::flushQueuedDatagrams() {
+    _batchedNodeSocket.flush();
+}
+
+void LimitedNodeList::setNetworkImpairment(const NetworkImpairment::Settings& settings) {
+    _networkImpairment.setSettings(settings);
+    _isImpaired = settings.isImpaired();
+    
+    if (!_impairmentTimer) {
+        _impairmentTimer = new QTimer(this);
+        _impairmentTimer->setTimerType(Qt::PreciseTimer);
+        connect(_impairmentTimer, &QTimer::timeout, this, &LimitedNodeList::sendImpairedDatagrams);
+    }
+    
+    if (_isImpaired) {
+        qDebug() << "Impairing the node socket with" << settings.latency << "ms latency," << settings.jitter << "ms jitter,"
+            << settings.lossRate << "loss," << settings.reorderRate << "reordering and"
+            << settings.bandwidth << "kbps bandwidth";
+        _impairmentTimer->start(IMPAIRMENT_UPDATE_INTERVAL_MSECS);
+    } else {
+        // the timer keeps going until what was held back has gone out
+        sendImpairedDatagrams();
+    }
+}
+
+void LimitedNodeList::sendImpairedDatagrams() {
+    QVector<NetworkImpairment::Datagram> due;
+    _networkImpairment.takeDueDatagrams(_isImpaired ? usecTimestampNow() : ULLONG_MAX, due);
+    foreach (const NetworkImpairment::Datagram& datagram, due) {
+        if (_nodeSocket.writeDatagram(datagram.data, datagram.destination.getAddress(),
+                                      datagram.destination.getPort()) < 0) {
+            qDebug() << "ERROR in writeDatagram:" << _nodeSocket.error() << "-" << _nodeSocket.errorString();
+        }
+    }
+    if (!_isImpaired && !_networkImpairment.hasQueuedDatagrams()) {
+        _impairmentTimer->stop();
+    }
+}
+
+qint64 LimitedNodeList::bundleDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode) {
+    if (!destinationNode) {
+        return 0;
+    }
+    if (destinationNode->getType() != NodeType::Agent || NON_VERIFIED_PACKETS.contains(packetTypeForPacket(data)) ||
+            numBytesForPacketHeaderGivenPacketType(PacketTypeBundle) + PacketBundle::BYTES_PER_PACKET + size >
+                MAX_PACKET_SIZE) {
+        return writeDatagram(data, size, destinationNode);
+    }
+    QMutexLocker locker(&_bundleMutex);
+    PacketBundle& bundle = destinationNode->getPacketBundle();
+    bool wasEmpty = bundle.isEmpty();
+    if (!bundle.append(data, size, destinationNode->getConnectionSecret())) {
+        // this one starts the next bundle, the node stays in the list for it
+        writeDatagramInPlace(bundle.getDatagram(), bundle.getDatagramSize(), destinationNode);
+        bundle.clear();
+        bundle.append(data, size, destinationNode->getConnectionSecret());
+    }
+    if (wasEmpty) {
+        _bundledNodes.append(destinationNode);
+    }
+    // the bundle is counted when it's sent, this counts what's in it by type
+    _packetMetrics.packetSent(packetTypeForPacket(data), size);
+    return size;
+}
+
+qint64 LimitedNodeList::bundleDatagram(const QByteArray& datagram, const SharedNodePointer& destinationNode) {
+    return bundleDatagram(datagram.constData(), datagram.size(), destinationNode);
+}
+
+void LimitedNodeList::flushBundledDatagrams() {
+    QMutexLocker locker(&_bundleMutex);
+    foreach (const SharedNodePointer& node, _bundledNodes) {
+        PacketBundle& bundle = node->getPacketBundle();
+        queueDatagramInPlace(bundle.getDatagram(), bundle.getDatagramSize(), node);
+    }
+    // the queued datagrams point into the bundles, so they can only be cleared once sent
+    flushQueuedDatagrams();
+    foreach (const SharedNodePointer& node, _bundledNodes) {
+        node->getPacketBundle().clear();
+    }
+    // don't hold on to nodes that may be killed before the next frame
+    _bundledNodes.clear();
+}
+
+void LimitedNodeList::sendReliableMessage(const QByteArray& packet, const SharedNodePointer& destinationNode) {
+    if (!destinationNode) {
+        return;
+    }
+    if (numBytesForPacketHeaderGivenPacketType(PacketTypeReliableMessage) + ReliableChannel::MAX_OVERHEAD_BYTES +
+            packet.size() > MAX_PACKET_SIZE) {
+        qDebug() << "Dropping reliable message of" << packet.size() << "bytes, too large for one packet";
+        return;
+    }
+    destinationNode->getReliableChannel().queueMessage(packet);
+    sendReliablePackets(destinationNode);
+}
+
+void LimitedNodeList::updateReliableChannels() {
+    eachNode([&](const SharedNodePointer& node){
+        sendReliablePackets(node);
+    });
+}
+
+void LimitedNodeList::sendReliablePackets(const SharedNodePointer& node) {
+    QVector<QByteArray> payloads;
+    node->getReliableChannel().update(usecTimestampNow(), payloads);
+    foreach (const QByteArray& payload, payloads) {
+        writeDatagram(byteArrayWithPopulatedHeader(PacketTypeReliableMessage) + payload, node);
+    }
+}
+
 qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, const SharedNodePointer& destinationNode,
                                const HifiSockAddr& overridenSockAddr) {
     if (destinationNode) {
@@ -273,6 +553,8 @@ qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, cons
             }
         }
         
+        destinationNode->getCongestionController().packetSent(datagram.size(), usecTimestampNow());
+        
         // don't use the node secret!
         return writeDatagram(datagram, *destinationSockAddr, QUuid());
     }
@@ -287,20 +569,37 @@ qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, cons
 
 qint64 LimitedNodeList::writeDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                                const HifiSockAddr& overridenSockAddr) {
-    return writeDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
+    return writeDatagram(QByteArray::fromRawData(data, size), destinationNode, overridenSockAddr);
 }
 
 qint64 LimitedNodeList::writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                                const HifiSockAddr& overridenSockAddr) {
-    return writeUnverifiedDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
+    return writeUnverifiedDatagram(QByteArray::fromRawData(data, size), destinationNode, overridenSockAddr);
 }
 
 void LimitedNodeList::processNodeData(const HifiSockAddr& senderSockAddr, const QByteArray& packet) {
     // the node decided not to do anything with this packet
     // if it comes from a known source we should keep that node alive
     SharedNodePointer matchingNode = sendingNodeForPacket(packet);
-    if (matchingNode) {
-        matchingNode->setLastHeardMicrostamp(usecTimestampNow());
+    if (!matchingNode) {
+        return;
+    }
+    quint64 now = usecTimestampNow();
+    matchingNode->setLastHeardMicrostamp(now);
+    
+    if (packetTypeForPacket(packet) == PacketTypeReliableMessage) {
+        QVector<QByteArray> messages;
+        if (!matchingNode->getReliableChannel().packetReceived(packet.mid(numBytesForPacketHeader(packet)), now,
+                messages)) {
+            qDebug() << "Dropping malformed reliable message packet from" << matchingNode->getUUID();
+            return;
+        }
+        // acknowledge right away, so the sender's round trip estimate isn't padded by our update interval
+        sendReliablePackets(matchingNode);
+        
+        foreach (const QByteArray& message, messages) {
+            emit reliableMessageReceived(message, matchingNode);
+        }
     }
 }
 
@@ -356,6 +655,8 @@ void LimitedNodeList::eraseAllNodes() {
     _nodeHash.clear();
     _nodeMutex.unlock();
     
+    publishNodeSnapshot();
+    
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -374,8 +675,11 @@ void LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
         
         _nodeMutex.unlock();
         
-        QWriteLocker writeLocker(&_nodeMutex);
+        _nodeMutex.lockForWrite();
         _nodeHash.unsafe_erase(it);
+        _nodeMutex.unlock();
+        
+        publishNodeSnapshot();
         
         handleNodeKill(matchingNode);
     } else {
@@ -396,6 +700,24 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
     emit nodeKilled(node);
 }
 
+void LimitedNodeList::publishNodeSnapshot() {
+    // building and storing under one lock means the last one stored is the last one built, which has every change
+    // finished before it
+    QMutexLocker snapshotLocker(&_nodeSnapshotMutex);
+    
+    NodeSnapshot* snapshot = new NodeSnapshot();
+    {
+        QReadLocker readLock(&_nodeMutex);
+        snapshot->reserve(_nodeHash.size());
+        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+            snapshot->append(it->second);
+        }
+    }
+    
+    // readers still holding the old one keep it until they're done
+    std::atomic_store(&_nodeSnapshot, NodeSnapshotPointer(snapshot));
+}
+
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool canAdjustLocks) {
@@ -416,6 +738,8 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         
         _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
         
+        publishNodeSnapshot();
+        
         qDebug() << "Added" << *newNode;
         
         emit nodeAdded(newNodePointer);
@@ -507,6 +831,10 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
     
+    if (!killedNodes.isEmpty()) {
+        publishNodeSnapshot();
+    }
+    
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
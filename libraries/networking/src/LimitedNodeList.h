@@ -13,6 +13,7 @@
 #define hifi_LimitedNodeList_h
 
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 
@@ -21,9 +22,11 @@
 #endif
 
 #include <qelapsedtimer.h>
+#include <qmutex.h>
 #include <qreadwritelock.h>
 #include <qset.h>
 #include <qsharedpointer.h>
+#include <qvector.h>
 #include <QtNetwork/qudpsocket.h>
 #include <QtNetwork/qhostaddress.h>
 
@@ -31,12 +34,18 @@
 
 #include <DependencyManager.h>
 
+#include "BatchedDatagramSocket.h"
 #include "DomainHandler.h"
+#include "NetworkImpairment.h"
 #include "Node.h"
+#include "PacketMetrics.h"
 #include "UUIDHasher.h"
 
 const int MAX_PACKET_SIZE = 1450;
 
+class PacketBuffer;
+class QTimer;
+
 const quint64 NODE_SILENCE_THRESHOLD_MSECS = 2 * 1000;
 
 extern const char SOLO_NODE_TYPES[2];
@@ -61,6 +70,10 @@ using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
 
+/// The nodes as they were at the last add or kill, which stays the same for as long as anyone holds onto it.
+typedef QVector<SharedNodePointer> NodeSnapshot;
+typedef std::shared_ptr<const NodeSnapshot> NodeSnapshotPointer;
+
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -82,6 +95,11 @@ public:
     
     void rebindNodeSocket();
     QUdpSocket& getNodeSocket() { return _nodeSocket; }
+    
+    /// Binds another socket to the node socket's port for a second thread to receive on. The kernel spreads incoming
+    /// datagrams across the sockets by a hash of their source, so each node's packets keep arriving on the same one.
+    /// Returns NULL where SO_REUSEPORT doesn't balance like that.  The caller owns the socket.
+    QUdpSocket* createReceiveShardSocket();
     QUdpSocket& getDTLSSocket();
     
     bool packetVersionAndHashMatch(const QByteArray& packet);
@@ -100,6 +118,41 @@ public:
 
     qint64 writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                          const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    
+    /// Sends a packet whose buffer the caller owns and will rewrite before its next send. The hash for source
+    /// verification is written into the buffer's header rather than into a copy, so nothing is allocated.
+    qint64 writeDatagramInPlace(char* data, qint64 size, const SharedNodePointer& destinationNode,
+                                const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    qint64 writeDatagramInPlace(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    qint64 writeDatagramInPlace(PacketBuffer& packet, const SharedNodePointer& destinationNode,
+                                const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    
+    /// Like writeDatagramInPlace(), but holds the packet back for flushQueuedDatagrams() to send along with the others
+    /// queued with it. The buffer must stay untouched until then.
+    qint64 queueDatagramInPlace(char* data, qint64 size, const SharedNodePointer& destinationNode,
+                                const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    qint64 queueDatagramInPlace(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+    void flushQueuedDatagrams();
+    
+    /// Sends every datagram from the node socket through an impairment that delays, drops and reorders them like a
+    /// worse link would, or straight out again once the settings are unimpaired.  It starts out with the settings
+    /// parseSettings() reads from the HIFI_NETWORK_IMPAIRMENT environment variable, if there are any.  Must be called
+    /// on the node list's thread.
+    void setNetworkImpairment(const NetworkImpairment::Settings& settings);
+    const NetworkImpairment& getNetworkImpairment() const { return _networkImpairment; }
+    
+    /// Adds a packet to the node's bundle for flushBundledDatagrams() to send in as few datagrams as it can, which
+    /// the node splits back into the packets it would have had.  Only agents know to split bundles, so a packet to any
+    /// other node, or one that can't be verified or bundled, is sent right away.
+    qint64 bundleDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode);
+    qint64 bundleDatagram(const QByteArray& datagram, const SharedNodePointer& destinationNode);
+    void flushBundledDatagrams();
+    
+    /// Sends a packet to the node through its reliable channel, which delivers it exactly once and in the order sent,
+    /// as reliableMessageReceived() on the other side. The packet must fit in one datagram with the channel's header.
+    void sendReliableMessage(const QByteArray& packet, const SharedNodePointer& destinationNode);
 
     void(*linkedDataCreateCallback)(Node *);
     
@@ -126,6 +179,9 @@ public:
     void getPacketStats(float &packetsPerSecond, float &bytesPerSecond);
     void resetPacketStats();
     
+    /// per type counts of every packet sent and every packet checked by packetVersionAndHashMatch()
+    PacketMetrics& getPacketMetrics() { return _packetMetrics; }
+    
     QByteArray constructPingPacket(PingType_t pingType = PingType::Agnostic, bool isVerified = true,
                                    const QUuid& packetHeaderID = QUuid());
     QByteArray constructPingReplyPacket(const QByteArray& pingPacket, const QUuid& packetHeaderID = QUuid());
@@ -136,21 +192,25 @@ public:
     void sendHeartbeatToIceServer(const HifiSockAddr& iceServerSockAddr,
                                   QUuid headerID = QUuid(), const QUuid& connectRequestID = QUuid());
     
+    /// Returns the current snapshot of the nodes without taking the node lock, so iterating it never holds up an add
+    /// or a kill. A node killed since is still in it, but stays valid for as long as the snapshot does.
+    NodeSnapshotPointer getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
+    
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
         
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (NodeSnapshot::const_iterator it = snapshot->cbegin(); it != snapshot->cend(); ++it) {
+            functor(*it);
         }
     }
     
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
         
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (NodeSnapshot::const_iterator it = snapshot->cbegin(); it != snapshot->cend(); ++it) {
+            if (!functor(*it)) {
                 break;
             }
         }
@@ -158,11 +218,11 @@ public:
     
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshotPointer snapshot = getNodeSnapshot();
         
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (NodeSnapshot::const_iterator it = snapshot->cbegin(); it != snapshot->cend(); ++it) {
+            if (predicate(*it)) {
+                return *it;
             }
         }
         
@@ -178,6 +238,12 @@ public slots:
     void updateLocalSockAddr();
     
     void killNodeWithUUID(const QUuid& nodeUUID);
+    
+    /// sends what each node's reliable channel has due: new messages, retransmissions and acknowledgements
+    void updateReliableChannels();
+    
+    /// sends the datagrams the network impairment has let through by now
+    void sendImpairedDatagrams();
 signals:
     void uuidChanged(const QUuid& ownerUUID, const QUuid& oldUUID);
     void nodeAdded(SharedNodePointer);
@@ -191,6 +257,8 @@ signals:
 
     void packetVersionMismatch();
     
+    void reliableMessageReceived(const QByteArray& packet, const SharedNodePointer& sendingNode);
+    
 protected:
     LimitedNodeList(unsigned short socketListenPort = 0, unsigned short dtlsListenPort = 0);
     LimitedNodeList(LimitedNodeList const&); // Don't implement, needed to avoid copies of singleton
@@ -198,17 +266,38 @@ protected:
     
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr,
                          const QUuid& connectionSecret);
+    qint64 writeDatagramInPlace(char* data, qint64 size, const HifiSockAddr& destinationSockAddr,
+                                const QUuid& connectionSecret);
+    void prepareDatagramInPlace(char* data, qint64 size, const QUuid& connectionSecret);
+    const HifiSockAddr* getDestinationSockAddr(const SharedNodePointer& destinationNode,
+                                               const HifiSockAddr& overridenSockAddr);
     
     void changeSocketBufferSizes(int numBytes);
     
-    void handleNodeKill(const SharedNodePointer& node);
+    virtual void handleNodeKill(const SharedNodePointer& node);
+    
+    /// counts a datagram to the node in the stats and against its pacer
+    void datagramSentToNode(const SharedNodePointer& destinationNode, qint64 size);
+    
+    void sendReliablePackets(const SharedNodePointer& node);
+    
+    /// replaces the node snapshot with one of the hash as it is now, must be called without the node lock held
+    void publishNodeSnapshot();
 
     QUuid _sessionUUID;
     bool _thisNodeCanAdjustLocks;
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
+    NodeSnapshotPointer _nodeSnapshot;
+    QMutex _nodeSnapshotMutex;
     QUdpSocket _nodeSocket;
+    BatchedDatagramSocket _batchedNodeSocket;
+    QVector<SharedNodePointer> _bundledNodes;
+    QMutex _bundleMutex;
     QUdpSocket* _dtlsSocket;
+    NetworkImpairment _networkImpairment;
+    std::atomic<bool> _isImpaired;
+    QTimer* _impairmentTimer;
     HifiSockAddr _localSockAddr;
     HifiSockAddr _publicSockAddr;
     HifiSockAddr _stunSockAddr;
@@ -216,6 +305,7 @@ protected:
     // XXX can BandwidthRecorder be used for this?
     int _numCollectedPackets;
     int _numCollectedBytes;
+    PacketMetrics _packetMetrics;
 
     QElapsedTimer _packetStatTimer;
     
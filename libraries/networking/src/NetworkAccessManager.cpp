@@ -9,16 +9,91 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QMutex>
+#include <QNetworkDiskCache>
 #include <QThreadStorage>
 
+#include "CoalescedNetworkReply.h"
 #include "NetworkAccessManager.h"
 
 QThreadStorage<QNetworkAccessManager*> networkAccessManagers;
 
+// the disk cache isn't thread-safe, so the managers go through proxies of their own that take turns with it
+static QMutex diskCacheMutex;
+static QNetworkDiskCache* sharedDiskCache = NULL;
+
+class DiskCacheProxy : public QAbstractNetworkCache {
+public:
+    virtual QNetworkCacheMetaData metaData(const QUrl& url) {
+        QMutexLocker locker(&diskCacheMutex);
+        return sharedDiskCache->metaData(url);
+    }
+
+    virtual void updateMetaData(const QNetworkCacheMetaData& metaData) {
+        QMutexLocker locker(&diskCacheMutex);
+        sharedDiskCache->updateMetaData(metaData);
+    }
+
+    virtual QIODevice* data(const QUrl& url) {
+        QMutexLocker locker(&diskCacheMutex);
+        return sharedDiskCache->data(url);
+    }
+
+    virtual bool remove(const QUrl& url) {
+        QMutexLocker locker(&diskCacheMutex);
+        return sharedDiskCache->remove(url);
+    }
+
+    virtual qint64 cacheSize() const {
+        QMutexLocker locker(&diskCacheMutex);
+        return sharedDiskCache->cacheSize();
+    }
+
+    virtual QIODevice* prepare(const QNetworkCacheMetaData& metaData) {
+        QMutexLocker locker(&diskCacheMutex);
+        return sharedDiskCache->prepare(metaData);
+    }
+
+    virtual void insert(QIODevice* device) {
+        QMutexLocker locker(&diskCacheMutex);
+        sharedDiskCache->insert(device);
+    }
+
+    virtual void clear() {
+        QMutexLocker locker(&diskCacheMutex);
+        sharedDiskCache->clear();
+    }
+};
+
 QNetworkAccessManager& NetworkAccessManager::getInstance() {
     if (!networkAccessManagers.hasLocalData()) {
-        networkAccessManagers.setLocalData(new QNetworkAccessManager());
+        QNetworkAccessManager* networkAccessManager = new QNetworkAccessManager();
+        QMutexLocker locker(&diskCacheMutex);
+        if (sharedDiskCache) {
+            networkAccessManager->setCache(new DiskCacheProxy());
+        }
+        networkAccessManagers.setLocalData(networkAccessManager);
     }
     
     return *networkAccessManagers.localData();
 }
+
+void NetworkAccessManager::setDiskCache(const QString& directory, qint64 maximumSize) {
+    {
+        QMutexLocker locker(&diskCacheMutex);
+        if (!sharedDiskCache) {
+            // kept to the end, as the managers of the threads still running use it
+            sharedDiskCache = new QNetworkDiskCache();
+        }
+        sharedDiskCache->setCacheDirectory(directory);
+        sharedDiskCache->setMaximumCacheSize(maximumSize);
+    }
+    QNetworkAccessManager& networkAccessManager = getInstance();
+    if (!networkAccessManager.cache()) {
+        networkAccessManager.setCache(new DiskCacheProxy());
+    }
+}
+
+QNetworkReply* NetworkAccessManager::get(const QNetworkRequest& request) {
+    return CoalescedNetworkReply::get(request);
+}
@@ -14,11 +14,21 @@
 
 #include <QtNetwork/qnetworkaccessmanager.h>
 
+const qint64 DEFAULT_DISK_CACHE_SIZE = 50 * 1024 * 1024;
+
 /// Wrapper around QNetworkAccessManager to restrict at one instance by thread
 class NetworkAccessManager : public QObject {
     Q_OBJECT
 public:
     static QNetworkAccessManager& getInstance();
+
+    /// Has the managers of all the threads share one disk cache, in the given directory and of at most the given size.
+    /// It's taken up by the calling thread's manager and by those made after, so it's best set before anything loads.
+    static void setDiskCache(const QString& directory, qint64 maximumSize = DEFAULT_DISK_CACHE_SIZE);
+
+    /// Starts a GET on the calling thread's manager, unless the same request is already in flight on any thread, in
+    /// which case the reply follows that download rather than starting another.
+    static QNetworkReply* get(const QNetworkRequest& request);
 };
 
-#endif // hifi_NetworkAccessManager_h
\ No newline at end of file
+#endif // hifi_NetworkAccessManager_h
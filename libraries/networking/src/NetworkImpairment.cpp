@@ -0,0 +1,221 @@
+//
+//  NetworkImpairment.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+
+#include <SharedUtil.h>
+
+#include "NetworkImpairment.h"
+
+static const float DEFAULT_MAX_QUEUE_DELAY = 200.0f;
+
+// held back by this many times the jitter, or a few msecs if there's none, when picked to be reordered
+static const float REORDER_JITTER_MULTIPLE = 2.0f;
+static const float MIN_REORDER_DELAY = 5.0f;
+
+struct Profile {
+    const char* name;
+    float latency;
+    float jitter;
+    float lossRate;
+    float reorderRate;
+    int bandwidth;
+};
+
+static const Profile PROFILES[] = {
+    { "lan", 0.5f, 0.2f, 0.0f, 0.0f, 0 },
+    { "cable", 15.0f, 3.0f, 0.001f, 0.0f, 20000 },
+    { "dsl", 30.0f, 5.0f, 0.005f, 0.001f, 3000 },
+    { "wifi", 20.0f, 15.0f, 0.01f, 0.005f, 10000 },
+    { "mobile", 80.0f, 40.0f, 0.02f, 0.01f, 1500 },
+    { "congested", 150.0f, 80.0f, 0.05f, 0.02f, 512 }
+};
+static const int NUM_PROFILES = sizeof(PROFILES) / sizeof(Profile);
+
+NetworkImpairment::Settings::Settings() :
+    latency(0.0f),
+    jitter(0.0f),
+    lossRate(0.0f),
+    reorderRate(0.0f),
+    bandwidth(0),
+    maxQueueDelay(DEFAULT_MAX_QUEUE_DELAY)
+{
+}
+
+bool NetworkImpairment::Settings::isImpaired() const {
+    return latency > 0.0f || jitter > 0.0f || lossRate > 0.0f || reorderRate > 0.0f || bandwidth > 0;
+}
+
+QStringList NetworkImpairment::getProfileNames() {
+    QStringList names;
+    for (int i = 0; i < NUM_PROFILES; i++) {
+        names << PROFILES[i].name;
+    }
+    return names;
+}
+
+bool NetworkImpairment::parseSettings(const QString& description, Settings& settings) {
+    Settings parsed;
+    QStringList parts = description.split(',', QString::SkipEmptyParts);
+    for (int i = 0; i < parts.size(); i++) {
+        QString part = parts.at(i).trimmed();
+        int equals = part.indexOf('=');
+        if (equals == -1) {
+            // only the first part can name a profile
+            if (i > 0) {
+                return false;
+            }
+            if (part == "none") {
+                continue;
+            }
+            int profile = 0;
+            while (profile < NUM_PROFILES && part != PROFILES[profile].name) {
+                profile++;
+            }
+            if (profile == NUM_PROFILES) {
+                return false;
+            }
+            parsed.latency = PROFILES[profile].latency;
+            parsed.jitter = PROFILES[profile].jitter;
+            parsed.lossRate = PROFILES[profile].lossRate;
+            parsed.reorderRate = PROFILES[profile].reorderRate;
+            parsed.bandwidth = PROFILES[profile].bandwidth;
+            continue;
+        }
+
+        QString key = part.left(equals).trimmed();
+        bool ok = false;
+        float value = part.mid(equals + 1).trimmed().toFloat(&ok);
+        if (!ok || value < 0.0f) {
+            return false;
+        }
+        if (key == "latency") {
+            parsed.latency = value;
+        } else if (key == "jitter") {
+            parsed.jitter = value;
+        } else if (key == "loss") {
+            parsed.lossRate = qMin(value, 1.0f);
+        } else if (key == "reorder") {
+            parsed.reorderRate = qMin(value, 1.0f);
+        } else if (key == "bandwidth") {
+            parsed.bandwidth = (int)value;
+        } else if (key == "queue") {
+            parsed.maxQueueDelay = value;
+        } else {
+            return false;
+        }
+    }
+    settings = parsed;
+    return true;
+}
+
+NetworkImpairment::Stats::Stats() :
+    sent(0),
+    lost(0),
+    overflowed(0),
+    reordered(0)
+{
+}
+
+NetworkImpairment::NetworkImpairment(unsigned int seed) :
+    _random(seed),
+    _lastReleaseTime(0),
+    _linkFreeTime(0)
+{
+}
+
+void NetworkImpairment::setSettings(const Settings& settings) {
+    QMutexLocker locker(&_mutex);
+    _settings = settings;
+}
+
+NetworkImpairment::Settings NetworkImpairment::getSettings() const {
+    QMutexLocker locker(&_mutex);
+    return _settings;
+}
+
+bool NetworkImpairment::isEnabled() const {
+    QMutexLocker locker(&_mutex);
+    return _settings.isImpaired();
+}
+
+float NetworkImpairment::randomFraction() {
+    return (float)(_random() - _random.min()) / (float)(_random.max() - _random.min());
+}
+
+bool NetworkImpairment::admit(int size, quint64 now, quint64& releaseTime) {
+    QMutexLocker locker(&_mutex);
+
+    // the cap serializes the datagrams one after the other, and the queue in front of it only holds so much
+    quint64 departure = now;
+    if (_settings.bandwidth > 0) {
+        quint64 linkStart = qMax(now, _linkFreeTime);
+        if (linkStart - now > (quint64)(_settings.maxQueueDelay * USECS_PER_MSEC)) {
+            _stats.overflowed++;
+            return false;
+        }
+        // kbits per second is bits per msec
+        quint64 transmission = (quint64)size * BITS_IN_BYTE * USECS_PER_MSEC / _settings.bandwidth;
+        _linkFreeTime = linkStart + transmission;
+        departure = _linkFreeTime;
+    }
+
+    // lost on the way, after having taken its share of the link
+    if (_settings.lossRate > 0.0f && randomFraction() < _settings.lossRate) {
+        _stats.lost++;
+        return false;
+    }
+
+    float delay = _settings.latency + _settings.jitter * (2.0f * randomFraction() - 1.0f);
+    releaseTime = departure + (quint64)(qMax(delay, 0.0f) * USECS_PER_MSEC);
+
+    if (_settings.reorderRate > 0.0f && randomFraction() < _settings.reorderRate) {
+        float holdBack = qMax(REORDER_JITTER_MULTIPLE * _settings.jitter, MIN_REORDER_DELAY);
+        releaseTime = qMax(releaseTime, _lastReleaseTime) + (quint64)(holdBack * USECS_PER_MSEC);
+        _stats.reordered++;
+    } else {
+        releaseTime = qMax(releaseTime, _lastReleaseTime);
+        _lastReleaseTime = releaseTime;
+    }
+    _stats.sent++;
+    return true;
+}
+
+void NetworkImpairment::push(const char* data, int size, const HifiSockAddr& destination, quint64 now) {
+    quint64 releaseTime;
+    if (!admit(size, now, releaseTime)) {
+        return;
+    }
+    Datagram datagram;
+    datagram.data = QByteArray(data, size);
+    datagram.destination = destination;
+
+    QMutexLocker locker(&_mutex);
+    _queue.insert(std::make_pair(releaseTime, datagram));
+}
+
+void NetworkImpairment::takeDueDatagrams(quint64 now, QVector<Datagram>& due) {
+    QMutexLocker locker(&_mutex);
+    std::multimap<quint64, Datagram>::iterator it = _queue.begin();
+    while (it != _queue.end() && it->first <= now) {
+        due.append(it->second);
+        it = _queue.erase(it);
+    }
+}
+
+bool NetworkImpairment::hasQueuedDatagrams() const {
+    QMutexLocker locker(&_mutex);
+    return !_queue.empty();
+}
+
+NetworkImpairment::Stats NetworkImpairment::getStats() const {
+    QMutexLocker locker(&_mutex);
+    return _stats;
+}
@@ -0,0 +1,105 @@
+//
+//  NetworkImpairment.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkImpairment_h
+#define hifi_NetworkImpairment_h
+
+#include <map>
+#include <random>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "HifiSockAddr.h"
+
+/// Holds outgoing datagrams back to make the link look worse than it is: a base latency with jitter, random loss,
+/// reordering and a bandwidth cap with a bounded queue in front of it, tail dropping like a router's buffer.
+///
+/// Jitter alone doesn't reorder, a datagram never leaves before the one sent ahead of it unless it was picked to be
+/// reordered, and then it's held back by an extra delay for those behind it to pass it.
+///
+/// The LimitedNodeList sends its datagrams through one when it's enabled, the times passed in are usecTimestampNow()
+/// there but any clock will do, so tests and benchmarks can run it in simulated time.
+class NetworkImpairment {
+public:
+    struct Settings {
+        Settings();
+
+        float latency;          // msecs each way
+        float jitter;           // msecs either side of the latency
+        float lossRate;         // fraction dropped at random
+        float reorderRate;      // fraction held back for later datagrams to pass
+        int bandwidth;          // kbits per second, 0 for no cap
+        float maxQueueDelay;    // msecs of data the cap can queue before dropping
+
+        bool isImpaired() const;
+    };
+
+    /// the names of the standard profiles, from a clean LAN to a congested mobile link
+    static QStringList getProfileNames();
+
+    /// Reads a profile name, key=value pairs (latency, jitter, loss, reorder, bandwidth, queue) separated by commas,
+    /// or a profile name followed by pairs overriding it, e.g. "mobile,loss=0.05".  "none" or an empty string is an
+    /// unimpaired link.  Returns false if it couldn't be read, leaving settings as they were.
+    static bool parseSettings(const QString& description, Settings& settings);
+
+    struct Datagram {
+        QByteArray data;
+        HifiSockAddr destination;
+    };
+
+    struct Stats {
+        Stats();
+
+        quint64 sent;
+        quint64 lost;           // dropped at random
+        quint64 overflowed;     // dropped because the cap's queue was full
+        quint64 reordered;
+    };
+
+    NetworkImpairment(unsigned int seed = 1);
+
+    void setSettings(const Settings& settings);
+    Settings getSettings() const;
+    bool isEnabled() const;
+
+    /// Decides what happens to a datagram sent at now without holding on to it.
+    /// \return false if it's dropped, otherwise true with the time it arrives in releaseTime
+    bool admit(int size, quint64 now, quint64& releaseTime);
+
+    /// Copies a datagram sent at now into the queue for takeDueDatagrams() unless admit() drops it.
+    void push(const char* data, int size, const HifiSockAddr& destination, quint64 now);
+
+    /// Moves the datagrams whose time has come by now into due, in the order they're due.
+    void takeDueDatagrams(quint64 now, QVector<Datagram>& due);
+
+    bool hasQueuedDatagrams() const;
+    Stats getStats() const;
+
+private:
+    float randomFraction();
+
+    mutable QMutex _mutex;
+    Settings _settings;
+    std::minstd_rand _random;
+
+    quint64 _lastReleaseTime;   // of the latest datagram that wasn't reordered, no other may leave before it
+    quint64 _linkFreeTime;      // when the capped link has sent everything admitted so far
+
+    // by release time, datagrams due at the same time keep the order they were sent in
+    std::multimap<quint64, Datagram> _queue;
+
+    Stats _stats;
+};
+
+#endif // hifi_NetworkImpairment_h
@@ -20,9 +20,12 @@
 #include <QtCore/QUuid>
 #include <QMutex>
 
+#include "CongestionController.h"
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
 #include "NodeData.h"
+#include "PacketBundle.h"
+#include "ReliableChannel.h"
 #include "SimpleMovingAverage.h"
 #include "MovingPercentile.h"
 
@@ -85,6 +88,15 @@ public:
     void activateLocalSocket();
     void activateSymmetricSocket();
     
+    /// the channel LimitedNodeList::sendReliableMessage() sends through to this node
+    ReliableChannel& getReliableChannel() { return _reliableChannel; }
+    
+    /// the send rate estimate and pacer shared by all of our streams to this node
+    CongestionController& getCongestionController() { return _congestionController; }
+    
+    /// the packets LimitedNodeList::bundleDatagram() has gathered for this node since the last flush
+    PacketBundle& getPacketBundle() { return _packetBundle; }
+    
     friend QDataStream& operator<<(QDataStream& out, const Node& node);
     friend QDataStream& operator>>(QDataStream& in, Node& node);
 
@@ -106,6 +118,9 @@ private:
     QMutex _mutex;
     MovingPercentile _clockSkewMovingPercentile;
     bool _canAdjustLocks;
+    ReliableChannel _reliableChannel;
+    CongestionController _congestionController;
+    PacketBundle _packetBundle;
 };
 
 QDebug operator<<(QDebug debug, const Node &message);
@@ -34,7 +34,11 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     _numNoReplyDomainCheckIns(0),
     _assignmentServerSocket(),
     _hasCompletedInitialSTUNFailure(false),
-    _stunRequestsSinceSuccess(0)
+    _stunRequestsSinceSuccess(0),
+    _domainListVersion(0),
+    _isApplyingDomainListRemovals(false),
+    _incomingListVersion(0),
+    _incomingListBaseVersion(0)
 {
     static bool firstCall = true;
     if (firstCall) {
@@ -52,6 +56,10 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     connect(addressManager.data(), &AddressManager::possibleDomainChangeRequiredViaICEForID,
             &_domainHandler, &DomainHandler::setIceServerHostnameAndID);
     
+    // look up the domain-servers of places we might go to before we're asked to
+    connect(addressManager.data(), &AddressManager::possibleDomainChangeAhead,
+            &_domainHandler, &DomainHandler::prefetchHostname);
+    
     // clear our NodeList when the domain changes
     connect(&_domainHandler, &DomainHandler::disconnectedFromDomain, this, &NodeList::reset);
     
@@ -71,6 +79,13 @@ qint64 NodeList::sendStatsToDomainServer(const QJsonObject& statsObject) {
     return writeUnverifiedDatagram(statsPacket, _domainHandler.getSockAddr());
 }
 
+void NodeList::sendDomainServerDisconnect() {
+    if (_domainHandler.isConnected()) {
+        QByteArray disconnectPacket = byteArrayWithPopulatedHeader(PacketTypeDomainDisconnect);
+        writeUnverifiedDatagram(disconnectPacket, _domainHandler.getSockAddr());
+    }
+}
+
 void NodeList::timePingReply(const QByteArray& packet, const SharedNodePointer& sendingNode) {
     QDataStream packetStream(packet);
     packetStream.skipRawData(numBytesForPacketHeader(packet));
@@ -91,6 +106,9 @@ void NodeList::timePingReply(const QByteArray& packet, const SharedNodePointer&
     
     sendingNode->setPingMs(pingTime / 1000);
     sendingNode->updateClockSkewUsec(clockSkew);
+    
+    // pings queue behind whatever else we're sending the node, so they tell us how much we're queuing
+    sendingNode->getCongestionController().roundTripSampled(pingTime, now);
 
     const bool wantDebug = false;
     
@@ -192,6 +210,8 @@ void NodeList::reset() {
     LimitedNodeList::reset();
     
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
+    _incomingListPackets.clear();
 
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
@@ -297,6 +317,20 @@ void NodeList::sendDomainServerCheckIn() {
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
         
+        // if this is a list request, tell the domain-server which version of the list we have so it can send what's
+        // changed since
+        if (domainPacketType == PacketTypeDomainListRequest) {
+            packetStream << _domainListVersion;
+            
+            // and how far we are from the nodes we've heard back from, so it can give us the nearest mixers
+            QHash<QUuid, qint32> pingTimes;
+            eachNode([&pingTimes](const SharedNodePointer& node){
+                if (node->getPingMs() >= 0) {
+                    pingTimes.insert(node->getUUID(), node->getPingMs());
+                }
+            });
+            packetStream << pingTimes;
+        }
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected()) {
@@ -383,6 +417,37 @@ int NodeList::processDomainServerList(const QByteArray& packet) {
     packetStream >> thisNodeCanAdjustLocks;
     setThisNodeCanAdjustLocks(thisNodeCanAdjustLocks);
     
+    // the nodes that follow are the whole list if the base version is zero, otherwise those that changed since it
+    quint32 listVersion, baseListVersion;
+    QList<QUuid> removedUUIDs;
+    quint16 packetIndex, packetCount;
+    packetStream >> listVersion >> baseListVersion >> removedUUIDs >> packetIndex >> packetCount;
+    
+    // the version only moves on once every packet of the list is in, until then we keep asking from the one we have,
+    // and the domain-server sends the same list again
+    if (listVersion != _incomingListVersion || baseListVersion != _incomingListBaseVersion) {
+        _incomingListVersion = listVersion;
+        _incomingListBaseVersion = baseListVersion;
+        _incomingListPackets.clear();
+    }
+    _incomingListPackets.insert(packetIndex);
+    
+    if (_incomingListPackets.size() == packetCount) {
+        if (baseListVersion == 0 || baseListVersion == _domainListVersion) {
+            // a full list, or the delta against the version we have
+            _domainListVersion = listVersion;
+        } else {
+            // we've missed a change somewhere, so take what's here but ask for the full list next time
+            _domainListVersion = 0;
+        }
+    }
+    
+    _isApplyingDomainListRemovals = true;
+    foreach (const QUuid& removedUUID, removedUUIDs) {
+        killNodeWithUUID(removedUUID);
+    }
+    _isApplyingDomainListRemovals = false;
+    
     // pull each node in the packet
     while(packetStream.device()->pos() < packet.size()) {
         // setup variables to read into from QDataStream
@@ -412,6 +477,15 @@ int NodeList::processDomainServerList(const QByteArray& packet) {
     return readNodes;
 }
 
+void NodeList::handleNodeKill(const SharedNodePointer& node) {
+    if (!_isApplyingDomainListRemovals) {
+        // a delta only carries what changed on the domain-server, so a node we dropped ourselves (for going silent, or
+        // from a kill packet) would never be sent again - ask for the full list next time instead
+        _domainListVersion = 0;
+    }
+    LimitedNodeList::handleNodeKill(node);
+}
+
 void NodeList::sendAssignment(Assignment& assignment) {
     
     PacketType assignmentPacketType = assignment.getCommand() == Assignment::CreateCommand
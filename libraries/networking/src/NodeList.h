@@ -48,6 +48,10 @@ public:
     void setOwnerType(NodeType_t ownerType) { _ownerType = ownerType; }
 
     qint64 sendStatsToDomainServer(const QJsonObject& statsObject);
+    
+    /// Tells the domain-server we're leaving, so it can hand our place to someone else without waiting for us to go
+    /// silent.
+    void sendDomainServerDisconnect();
 
     int getNumNoReplyDomainCheckIns() const { return _numNoReplyDomainCheckIns; }
     DomainHandler& getDomainHandler() { return _domainHandler; }
@@ -87,6 +91,8 @@ private:
     void activateSocketFromNodeCommunication(const QByteArray& packet, const SharedNodePointer& sendingNode);
     void timePingReply(const QByteArray& packet, const SharedNodePointer& sendingNode);
     
+    virtual void handleNodeKill(const SharedNodePointer& node);
+    
     NodeType_t _ownerType;
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
@@ -94,6 +100,13 @@ private:
     HifiSockAddr _assignmentServerSocket;
     bool _hasCompletedInitialSTUNFailure;
     unsigned int _stunRequestsSinceSuccess;
+    quint32 _domainListVersion;
+    bool _isApplyingDomainListRemovals;
+    
+    // the list being received, which only becomes ours once every packet of it has come in
+    quint32 _incomingListVersion;
+    quint32 _incomingListBaseVersion;
+    QSet<quint16> _incomingListPackets;
 };
 
 #endif // hifi_NodeList_h
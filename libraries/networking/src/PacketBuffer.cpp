@@ -0,0 +1,78 @@
+//
+//  PacketBuffer.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+#include "PacketBuffer.h"
+
+// a thread rarely has more than a few packets in hand at once, so beyond this returned buffers are just freed
+const int MAX_POOLED_BUFFERS = 16;
+
+class PacketBufferPool {
+public:
+    ~PacketBufferPool() {
+        foreach (char* buffer, _buffers) {
+            delete[] buffer;
+        }
+    }
+    
+    QVector<char*> _buffers;
+};
+
+static QThreadStorage<PacketBufferPool*> packetBufferPools;
+
+static PacketBufferPool& getPacketBufferPool() {
+    if (!packetBufferPools.hasLocalData()) {
+        packetBufferPools.setLocalData(new PacketBufferPool());
+    }
+    return *packetBufferPools.localData();
+}
+
+PacketBuffer::PacketBuffer() :
+    _size(0)
+{
+    PacketBufferPool& pool = getPacketBufferPool();
+    if (pool._buffers.isEmpty()) {
+        _data = new char[CAPACITY];
+    } else {
+        _data = pool._buffers.last();
+        pool._buffers.removeLast();
+    }
+}
+
+PacketBuffer::~PacketBuffer() {
+    PacketBufferPool& pool = getPacketBufferPool();
+    if (pool._buffers.size() < MAX_POOLED_BUFFERS) {
+        pool._buffers.append(_data);
+    } else {
+        delete[] _data;
+    }
+}
+
+void PacketBuffer::resize(int size) {
+    _size = qBound(0, size, (int)CAPACITY);
+}
+
+int PacketBuffer::populateHeader(PacketType type, const QUuid& connectionUUID) {
+    _size = populatePacketHeader(_data, type, connectionUUID);
+    return _size;
+}
+
+bool PacketBuffer::append(const char* data, int size) {
+    if (size > getBytesAvailable()) {
+        return false;
+    }
+    memcpy(_data + _size, data, size);
+    _size += size;
+    return true;
+}
@@ -0,0 +1,56 @@
+//
+//  PacketBuffer.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBuffer_h
+#define hifi_PacketBuffer_h
+
+#include <QtCore/QUuid>
+
+#include "LimitedNodeList.h"
+#include "PacketHeaders.h"
+
+/// A MAX_PACKET_SIZE buffer to build an outgoing packet in, taken from a pool kept for each thread and handed back when
+/// the buffer goes out of scope, so that building and sending a packet allocates nothing once the pool is warm.
+/// Send it with LimitedNodeList::writeDatagramInPlace(); a buffer should be released on the thread that took it.
+class PacketBuffer {
+public:
+    
+    static const int CAPACITY = MAX_PACKET_SIZE;
+    
+    PacketBuffer();
+    ~PacketBuffer();
+    
+    char* data() { return _data; }
+    const char* constData() const { return _data; }
+    
+    int size() const { return _size; }
+    
+    /// Sets the size of the packet, up to the capacity.
+    void resize(int size);
+    
+    /// Starts the packet over with a header for the given type.
+    /// \return the number of header bytes
+    int populateHeader(PacketType type, const QUuid& connectionUUID = nullUUID);
+    
+    /// Appends to the packet.
+    /// \return false, having appended nothing, if it doesn't fit
+    bool append(const char* data, int size);
+    
+    /// the room left after what's been written
+    int getBytesAvailable() const { return CAPACITY - _size; }
+
+private:
+    Q_DISABLE_COPY(PacketBuffer)
+    
+    char* _data;
+    int _size;
+};
+
+#endif // hifi_PacketBuffer_h
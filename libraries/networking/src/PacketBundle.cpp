@@ -0,0 +1,83 @@
+//
+//  PacketBundle.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include "LimitedNodeList.h"
+#include "PacketHeaders.h"
+
+#include "PacketBundle.h"
+
+PacketBundle::PacketBundle() :
+    _numHeaderBytes(0),
+    _size(0),
+    _packetCount(0)
+{
+}
+
+bool PacketBundle::append(const char* packet, int size, const QUuid& connectionSecret) {
+    if (_packetCount == 0) {
+        if (_buffer.isEmpty()) {
+            // every node has a bundle, but only the ones we send frames to need the space
+            _buffer.resize(MAX_PACKET_SIZE);
+        }
+        // the header carries our session UUID, which can change between frames
+        _numHeaderBytes = populatePacketHeader(_buffer.data(), PacketTypeBundle);
+        _size = _numHeaderBytes;
+    }
+    if (_size + BYTES_PER_PACKET + size > _buffer.size()) {
+        return false;
+    }
+    char* bundleAt = _buffer.data() + _size;
+    quint16 packetSize = size;
+    memcpy(bundleAt, &packetSize, sizeof(packetSize));
+    bundleAt += sizeof(packetSize);
+    
+    memcpy(bundleAt, packet, size);
+    if (!connectionSecret.isNull()) {
+        replaceHashInPacketGivenConnectionUUID(bundleAt, size, connectionSecret);
+    }
+    _size += BYTES_PER_PACKET + size;
+    _packetCount++;
+    return true;
+}
+
+char* PacketBundle::getDatagram() {
+    return _packetCount == 1 ? _buffer.data() + _numHeaderBytes + BYTES_PER_PACKET : _buffer.data();
+}
+
+int PacketBundle::getDatagramSize() const {
+    return _packetCount == 1 ? _size - _numHeaderBytes - BYTES_PER_PACKET : _size;
+}
+
+void PacketBundle::clear() {
+    _size = 0;
+    _packetCount = 0;
+}
+
+bool PacketBundle::unbundle(const QByteArray& bundle, QVector<QByteArray>& packets) {
+    const char* bundleAt = bundle.constData() + numBytesForPacketHeader(bundle);
+    const char* bundleEnd = bundle.constData() + bundle.size();
+    while (bundleAt < bundleEnd) {
+        quint16 packetSize;
+        if (bundleEnd - bundleAt < (int)sizeof(packetSize)) {
+            return false;
+        }
+        memcpy(&packetSize, bundleAt, sizeof(packetSize));
+        bundleAt += sizeof(packetSize);
+        
+        if (packetSize == 0 || bundleEnd - bundleAt < packetSize) {
+            return false;
+        }
+        packets.append(QByteArray(bundleAt, packetSize));
+        bundleAt += packetSize;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+//
+//  PacketBundle.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBundle_h
+#define hifi_PacketBundle_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+/// Packs the packets of a frame for one node into a single PacketTypeBundle datagram, up to MAX_PACKET_SIZE, each as
+/// a 16 bit length followed by the whole packet, header and hash included.  The receiver splits the bundle and handles
+/// each packet as though it had arrived on its own, so only the datagram, its UDP and IP headers and its syscalls are
+/// saved; a bundle of one goes out as just that packet.
+class PacketBundle {
+public:
+    
+    /// what bundling adds to each packet
+    static const int BYTES_PER_PACKET = sizeof(quint16);
+    
+    PacketBundle();
+    
+    bool isEmpty() const { return _packetCount == 0; }
+    int getPacketCount() const { return _packetCount; }
+    
+    /// Appends a copy of a verified packet, hashed with the connection secret.
+    /// \return false, having appended nothing, if it doesn't fit
+    bool append(const char* packet, int size, const QUuid& connectionSecret);
+    
+    /// The datagram to send, which the sender may hash in place: the one packet as it is, or the bundle of them all.
+    char* getDatagram();
+    int getDatagramSize() const;
+    
+    void clear();
+    
+    /// Splits a received bundle into its packets.
+    /// \return false if the bundle was malformed, in which case packets may hold the ones before the error
+    static bool unbundle(const QByteArray& bundle, QVector<QByteArray>& packets);
+
+private:
+    
+    QByteArray _buffer;
+    int _numHeaderBytes;
+    int _size;
+    int _packetCount;
+};
+
+#endif // hifi_PacketBundle_h
@@ -10,6 +10,7 @@
 //
 
 #include <math.h>
+#include <string.h>
 
 #include <QtCore/QDebug>
 
@@ -49,22 +50,27 @@ PacketVersion versionForPacketType(PacketType type) {
     switch (type) {
         case PacketTypeMicrophoneAudioNoEcho:
         case PacketTypeMicrophoneAudioWithEcho:
-            return 2;
+            return 3;
         case PacketTypeSilentAudioFrame:
             return 4;
         case PacketTypeMixedAudio:
-            return 1;
+            return 2;
         case PacketTypeInjectAudio:
             return 1;
         case PacketTypeAvatarData:
-            return 5;
+            return 7;
+        case PacketTypeBulkAvatarData:
+            return 2;
         case PacketTypeAvatarIdentity:
-            return 1;
+            return 2;
         case PacketTypeEnvironmentData:
             return 2;
         case PacketTypeDomainList:
+            return 6;
         case PacketTypeDomainListRequest:
-            return 4;
+            return 7;
+        case PacketTypeDomainConnectRequest:
+            return 1;
         case PacketTypeCreateAssignment:
         case PacketTypeRequestAssignment:
             return 2;
@@ -76,7 +82,7 @@ PacketVersion versionForPacketType(PacketType type) {
         case PacketTypeEntityErase:
             return 2;
         case PacketTypeAudioStreamStats:
-            return 1;
+            return 2;
         case PacketTypeMetavoxelData:
             return 13;
         default:
@@ -109,6 +115,7 @@ QString nameForPacketType(PacketType type) {
         PACKET_TYPE_NAME_LOOKUP(PacketTypeMuteEnvironment);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeAudioStreamStats);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeDataServerConfirm);
+        PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainDisconnect);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeOctreeStats);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeJurisdiction);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeJurisdictionRequest);
@@ -131,6 +138,8 @@ QString nameForPacketType(PacketType type) {
         PACKET_TYPE_NAME_LOOKUP(PacketTypeIceServerHeartbeatResponse);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeUnverifiedPing);
         PACKET_TYPE_NAME_LOOKUP(PacketTypeUnverifiedPingReply);
+        PACKET_TYPE_NAME_LOOKUP(PacketTypeReliableMessage);
+        PACKET_TYPE_NAME_LOOKUP(PacketTypeBundle);
         default:
             return QString("Type: ") + QString::number((int)type);
     }
@@ -166,9 +175,9 @@ int populatePacketHeader(char* packet, PacketType type, const QUuid& connectionU
     position += NUM_BYTES_RFC4122_UUID;
     
     if (!NON_VERIFIED_PACKETS.contains(type)) {
-        // pack 16 bytes of zeros where the md5 hash will be placed once data is packed
-        memset(position, 0, NUM_BYTES_MD5_HASH);
-        position += NUM_BYTES_MD5_HASH;
+        // pack zeros where the hash will be placed once data is packed
+        memset(position, 0, NUM_BYTES_PACKET_HASH);
+        position += NUM_BYTES_PACKET_HASH;
     }
     
     // return the number of bytes written for pointer pushing
@@ -196,7 +205,7 @@ int numBytesForPacketHeaderGivenPacketType(PacketType type) {
 }
 
 int numHashBytesInPacketHeaderGivenPacketType(PacketType type) {
-    return (NON_VERIFIED_PACKETS.contains(type) ? 0 : NUM_BYTES_MD5_HASH);
+    return (NON_VERIFIED_PACKETS.contains(type) ? 0 : NUM_BYTES_PACKET_HASH);
 }
 
 QUuid uuidFromPacketHeader(const QByteArray& packet) {
@@ -205,17 +214,59 @@ QUuid uuidFromPacketHeader(const QByteArray& packet) {
 }
 
 QByteArray hashFromPacketHeader(const QByteArray& packet) {
-    return packet.mid(numBytesForPacketHeader(packet) - NUM_BYTES_MD5_HASH, NUM_BYTES_MD5_HASH);
+    return packet.mid(numBytesForPacketHeader(packet) - NUM_BYTES_PACKET_HASH, NUM_BYTES_PACKET_HASH);
+}
+
+// the secret's bytes in the order toRfc4122() gives them, without building the array
+static void keyForConnectionUUID(const QUuid& connectionUUID, uchar* key) {
+    key[0] = (uchar)(connectionUUID.data1 >> 24);
+    key[1] = (uchar)(connectionUUID.data1 >> 16);
+    key[2] = (uchar)(connectionUUID.data1 >> 8);
+    key[3] = (uchar)connectionUUID.data1;
+    key[4] = (uchar)(connectionUUID.data2 >> 8);
+    key[5] = (uchar)connectionUUID.data2;
+    key[6] = (uchar)(connectionUUID.data3 >> 8);
+    key[7] = (uchar)connectionUUID.data3;
+    memcpy(key + 8, connectionUUID.data4, sizeof(connectionUUID.data4));
+}
+
+static void hashPacketPayload(const char* packet, int size, int headerBytes, const QUuid& connectionUUID,
+                              uchar* hash) {
+    uchar key[SipHash::KEY_BYTES];
+    keyForConnectionUUID(connectionUUID, key);
+    SipHash::hash128(key, reinterpret_cast<const uchar*>(packet) + headerBytes, size - headerBytes, hash);
+}
+
+static void hashPacketPayload(const QByteArray& packet, int headerBytes, const QUuid& connectionUUID, uchar* hash) {
+    hashPacketPayload(packet.constData(), packet.size(), headerBytes, connectionUUID, hash);
 }
 
 QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID) {
-    return QCryptographicHash::hash(packet.mid(numBytesForPacketHeader(packet)) + connectionUUID.toRfc4122(),
-                                    QCryptographicHash::Md5);
+    QByteArray hash(NUM_BYTES_PACKET_HASH, 0);
+    hashPacketPayload(packet, numBytesForPacketHeader(packet), connectionUUID, reinterpret_cast<uchar*>(hash.data()));
+    return hash;
 }
 
 void replaceHashInPacketGivenConnectionUUID(QByteArray& packet, const QUuid& connectionUUID) {
-    packet.replace(numBytesForPacketHeader(packet) - NUM_BYTES_MD5_HASH, NUM_BYTES_MD5_HASH,
-                   hashForPacketAndConnectionUUID(packet, connectionUUID));
+    replaceHashInPacketGivenConnectionUUID(packet.data(), packet.size(), connectionUUID);
+}
+
+void replaceHashInPacketGivenConnectionUUID(char* packet, int size, const QUuid& connectionUUID) {
+    // the payload is read before the hash is written, so it can go straight into the header
+    uchar hash[NUM_BYTES_PACKET_HASH];
+    int headerBytes = numBytesForPacketHeader(packet);
+    hashPacketPayload(packet, size, headerBytes, connectionUUID, hash);
+    memcpy(packet + headerBytes - NUM_BYTES_PACKET_HASH, hash, NUM_BYTES_PACKET_HASH);
+}
+
+bool packetHashMatchesConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID) {
+    uchar hash[NUM_BYTES_PACKET_HASH];
+    int headerBytes = numBytesForPacketHeader(packet);
+    if (packet.size() < headerBytes) {
+        return false;
+    }
+    hashPacketPayload(packet, headerBytes, connectionUUID, hash);
+    return memcmp(packet.constData() + headerBytes - NUM_BYTES_PACKET_HASH, hash, NUM_BYTES_PACKET_HASH) == 0;
 }
 
 PacketType packetTypeForPacket(const QByteArray& packet) {
@@ -16,6 +16,8 @@
 #include <QtCore/QSet>
 #include <QtCore/QUuid>
 
+#include <SipHash.h>
+
 #include "UUID.h"
 
 // NOTE: if adding a new packet type, you can replace one marked usable or add at the end
@@ -42,7 +44,7 @@ enum PacketType {
     PacketTypeMuteEnvironment,
     PacketTypeAudioStreamStats,
     PacketTypeDataServerConfirm, // 20
-    UNUSED_5,
+    PacketTypeDomainDisconnect,
     UNUSED_6,
     UNUSED_7,
     UNUSED_8,
@@ -74,7 +76,9 @@ enum PacketType {
     PacketTypeIceServerHeartbeat, // 50
     PacketTypeIceServerHeartbeatResponse,
     PacketTypeUnverifiedPing,
-    PacketTypeUnverifiedPingReply
+    PacketTypeUnverifiedPingReply,
+    PacketTypeReliableMessage,
+    PacketTypeBundle // 55
 };
 
 typedef char PacketVersion;
@@ -86,11 +90,12 @@ const QSet<PacketType> NON_VERIFIED_PACKETS = QSet<PacketType>()
     << PacketTypeNodeJsonStats << PacketTypeEntityQuery
     << PacketTypeOctreeDataNack << PacketTypeEntityEditNack
     << PacketTypeIceServerHeartbeat << PacketTypeIceServerHeartbeatResponse
-    << PacketTypeUnverifiedPing << PacketTypeUnverifiedPingReply;
+    << PacketTypeUnverifiedPing << PacketTypeUnverifiedPingReply << PacketTypeDomainDisconnect;
 
-const int NUM_BYTES_MD5_HASH = 16;
+// verified packets carry a SipHash of their payload keyed by the connection secret
+const int NUM_BYTES_PACKET_HASH = SipHash::HASH_BYTES;
 const int NUM_STATIC_HEADER_BYTES = sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-const int MAX_PACKET_HEADER_BYTES = sizeof(PacketType) + NUM_BYTES_MD5_HASH + NUM_STATIC_HEADER_BYTES;
+const int MAX_PACKET_HEADER_BYTES = sizeof(PacketType) + NUM_BYTES_PACKET_HASH + NUM_STATIC_HEADER_BYTES;
 
 PacketVersion versionForPacketType(PacketType type);
 QString nameForPacketType(PacketType type);
@@ -112,6 +117,10 @@ QUuid uuidFromPacketHeader(const QByteArray& packet);
 QByteArray hashFromPacketHeader(const QByteArray& packet);
 QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID);
 void replaceHashInPacketGivenConnectionUUID(QByteArray& packet, const QUuid& connectionUUID);
+void replaceHashInPacketGivenConnectionUUID(char* packet, int size, const QUuid& connectionUUID);
+
+/// checks the hash in the header against the payload without copying either
+bool packetHashMatchesConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID);
 
 PacketType packetTypeForPacket(const QByteArray& packet);
 PacketType packetTypeForPacket(const char* packet);
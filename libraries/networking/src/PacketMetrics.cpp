@@ -0,0 +1,145 @@
+//
+//  PacketMetrics.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <SharedUtil.h>
+
+#include "PacketMetrics.h"
+
+// enough samples that the 99th percentile is more than the slowest one or two
+const int PROCESSING_SAMPLES = 500;
+
+PacketMetrics::ProcessingTimer::ProcessingTimer(PacketMetrics& metrics, PacketType type) :
+    _metrics(metrics),
+    _type(type),
+    _start(usecTimestampNow())
+{
+}
+
+PacketMetrics::ProcessingTimer::~ProcessingTimer() {
+    _metrics.packetProcessed(_type, usecTimestampNow() - _start);
+}
+
+PacketMetrics::ProcessingPercentiles::ProcessingPercentiles() :
+    median(PROCESSING_SAMPLES, 0.5f),
+    ninetyFifth(PROCESSING_SAMPLES, 0.95f),
+    ninetyNinth(PROCESSING_SAMPLES, 0.99f)
+{
+}
+
+PacketMetrics::PacketMetrics() :
+    _lastRateUpdate(0)
+{
+    for (int i = 0; i < MAX_PACKET_TYPES; i++) {
+        _counters[i].packetsReceived = 0;
+        _counters[i].bytesReceived = 0;
+        _counters[i].packetsSent = 0;
+        _counters[i].bytesSent = 0;
+        
+        Rates rates = { 0, 0, 0.0f, 0.0f };
+        _rates[i] = rates;
+    }
+}
+
+PacketMetrics::~PacketMetrics() {
+    qDeleteAll(_processingPercentiles);
+}
+
+void PacketMetrics::packetReceived(PacketType type, int size) {
+    Counters* counters = getCounters(type);
+    if (counters) {
+        counters->packetsReceived.fetch_add(1, std::memory_order_relaxed);
+        counters->bytesReceived.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void PacketMetrics::packetSent(PacketType type, int size) {
+    Counters* counters = getCounters(type);
+    if (counters) {
+        counters->packetsSent.fetch_add(1, std::memory_order_relaxed);
+        counters->bytesSent.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void PacketMetrics::packetProcessed(PacketType type, quint64 usecs) {
+    QMutexLocker locker(&_mutex);
+    ProcessingPercentiles*& percentiles = _processingPercentiles[type];
+    if (!percentiles) {
+        percentiles = new ProcessingPercentiles();
+    }
+    percentiles->median.updatePercentile(usecs);
+    percentiles->ninetyFifth.updatePercentile(usecs);
+    percentiles->ninetyNinth.updatePercentile(usecs);
+}
+
+void PacketMetrics::setQueueDepth(const QString& queue, int depth) {
+    QMutexLocker locker(&_mutex);
+    _queueDepths.insert(queue, depth);
+}
+
+void PacketMetrics::updateRates(quint64 now) {
+    QMutexLocker locker(&_mutex);
+    float elapsedSeconds = (float)(now - _lastRateUpdate) / USECS_PER_SECOND;
+    for (int i = 0; i < MAX_PACKET_TYPES; i++) {
+        Rates& rates = _rates[i];
+        quint64 bytesReceived = _counters[i].bytesReceived.load(std::memory_order_relaxed);
+        quint64 bytesSent = _counters[i].bytesSent.load(std::memory_order_relaxed);
+        if (_lastRateUpdate != 0 && elapsedSeconds > 0.0f) {
+            rates.bytesReceivedPerSecond = (bytesReceived - rates.lastBytesReceived) / elapsedSeconds;
+            rates.bytesSentPerSecond = (bytesSent - rates.lastBytesSent) / elapsedSeconds;
+        }
+        rates.lastBytesReceived = bytesReceived;
+        rates.lastBytesSent = bytesSent;
+    }
+    _lastRateUpdate = now;
+}
+
+QJsonObject PacketMetrics::toJson() {
+    QMutexLocker locker(&_mutex);
+    QJsonObject typesObject;
+    for (int i = 0; i < MAX_PACKET_TYPES; i++) {
+        const Counters& counters = _counters[i];
+        quint64 packetsReceived = counters.packetsReceived.load(std::memory_order_relaxed);
+        quint64 packetsSent = counters.packetsSent.load(std::memory_order_relaxed);
+        if (packetsReceived == 0 && packetsSent == 0) {
+            continue;
+        }
+        QJsonObject typeObject;
+        typeObject["packets_received"] = (double)packetsReceived;
+        typeObject["bytes_received"] = (double)counters.bytesReceived.load(std::memory_order_relaxed);
+        typeObject["packets_sent"] = (double)packetsSent;
+        typeObject["bytes_sent"] = (double)counters.bytesSent.load(std::memory_order_relaxed);
+        typeObject["bytes_received_per_second"] = _rates[i].bytesReceivedPerSecond;
+        typeObject["bytes_sent_per_second"] = _rates[i].bytesSentPerSecond;
+        
+        ProcessingPercentiles* percentiles = _processingPercentiles.value(i);
+        if (percentiles) {
+            QJsonObject processingObject;
+            processingObject["samples"] = percentiles->median.getNumSamples();
+            processingObject["median"] = percentiles->median.getValueAtPercentile();
+            processingObject["95th_percentile"] = percentiles->ninetyFifth.getValueAtPercentile();
+            processingObject["99th_percentile"] = percentiles->ninetyNinth.getValueAtPercentile();
+            typeObject["processing_usecs"] = processingObject;
+        }
+        typesObject[nameForPacketType((PacketType)i)] = typeObject;
+    }
+    QJsonObject queuesObject;
+    for (QHash<QString, int>::const_iterator it = _queueDepths.constBegin(); it != _queueDepths.constEnd(); it++) {
+        queuesObject[it.key()] = it.value();
+    }
+    QJsonObject metricsObject;
+    metricsObject["packet_types"] = typesObject;
+    metricsObject["queue_depths"] = queuesObject;
+    return metricsObject;
+}
+
+PacketMetrics::Counters* PacketMetrics::getCounters(PacketType type) {
+    int index = type;
+    return (index >= 0 && index < MAX_PACKET_TYPES) ? &_counters[index] : NULL;
+}
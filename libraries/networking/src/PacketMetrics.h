@@ -0,0 +1,100 @@
+//
+//  PacketMetrics.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketMetrics_h
+#define hifi_PacketMetrics_h
+
+#include <atomic>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <PercentileEstimator.h>
+
+#include "PacketHeaders.h"
+
+/// Counts the packets and bytes of each type sent and received, samples how long each type takes to process, and keeps
+/// the depths of the queues packets wait in, for export as JSON.  The counts are lock free, since every receive thread
+/// adds to them for every packet.
+class PacketMetrics {
+public:
+    
+    /// Times its scope as the processing of one packet of a type.
+    class ProcessingTimer {
+    public:
+        ProcessingTimer(PacketMetrics& metrics, PacketType type);
+        ~ProcessingTimer();
+        
+    private:
+        PacketMetrics& _metrics;
+        PacketType _type;
+        quint64 _start;
+    };
+    
+    PacketMetrics();
+    ~PacketMetrics();
+    
+    void packetReceived(PacketType type, int size);
+    void packetSent(PacketType type, int size);
+    void packetProcessed(PacketType type, quint64 usecs);
+    
+    void setQueueDepth(const QString& queue, int depth);
+    
+    /// Works out the byte rates since the last update, which should come about once a second.
+    void updateRates(quint64 now);
+    
+    /// The types seen so far by name, each with its totals, rates and processing percentiles, and the queue depths.
+    QJsonObject toJson();
+
+private:
+    Q_DISABLE_COPY(PacketMetrics)
+    
+    /// packet types are arithmetic coded, but none yet needs more than the one byte
+    static const int MAX_PACKET_TYPES = 256;
+    
+    class Counters {
+    public:
+        std::atomic<quint64> packetsReceived;
+        std::atomic<quint64> bytesReceived;
+        std::atomic<quint64> packetsSent;
+        std::atomic<quint64> bytesSent;
+    };
+    
+    class Rates {
+    public:
+        quint64 lastBytesReceived;
+        quint64 lastBytesSent;
+        float bytesReceivedPerSecond;
+        float bytesSentPerSecond;
+    };
+    
+    class ProcessingPercentiles {
+    public:
+        ProcessingPercentiles();
+        
+        PercentileEstimator median;
+        PercentileEstimator ninetyFifth;
+        PercentileEstimator ninetyNinth;
+    };
+    
+    Counters* getCounters(PacketType type);
+    
+    Counters _counters[MAX_PACKET_TYPES];
+    
+    QMutex _mutex;
+    Rates _rates[MAX_PACKET_TYPES];
+    quint64 _lastRateUpdate;
+    QHash<int, ProcessingPercentiles*> _processingPercentiles;
+    QHash<QString, int> _queueDepths;
+};
+
+#endif // hifi_PacketMetrics_h
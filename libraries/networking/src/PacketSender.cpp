@@ -25,8 +25,10 @@ const int PacketSender::MAX_SLEEP_INTERVAL = PacketSender::USECS_PER_SECOND;
 const int PacketSender::DEFAULT_PACKETS_PER_SECOND = 30;
 const int PacketSender::MINIMUM_PACKETS_PER_SECOND = 1;
 const int PacketSender::MINIMAL_SLEEP_INTERVAL = (USECS_PER_SECOND / TARGET_FPS) / 2;
+const int PacketSender::DEFAULT_MAX_BURST_PACKETS = 5;
 
 const int AVERAGE_CALL_TIME_SAMPLES = 10;
+const int AVERAGE_QUEUED_TIME_SAMPLES = 100;
 
 PacketSender::PacketSender(int packetsPerSecond) :
     _packetsPerSecond(packetsPerSecond),
@@ -40,7 +42,11 @@ PacketSender::PacketSender(int packetsPerSecond) :
     _totalPacketsSent(0),
     _totalBytesSent(0),
     _totalPacketsQueued(0),
-    _totalBytesQueued(0)
+    _totalBytesQueued(0),
+    _maxBurstPackets(DEFAULT_MAX_BURST_PACKETS),
+    _burstTokens(DEFAULT_MAX_BURST_PACKETS),
+    _lastBurstRefill(0),
+    _averageQueuedTime(AVERAGE_QUEUED_TIME_SAMPLES)
 {
 }
 
@@ -48,10 +54,15 @@ PacketSender::~PacketSender() {
 }
 
 
-void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet) {
-    NetworkPacket networkPacket(destinationNode, packet);
+void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet,
+                                         bool highPriority) {
+    QueuedPacket queuedPacket(NetworkPacket(destinationNode, packet), usecTimestampNow());
     lock();
-    _packets.push_back(networkPacket);
+    if (highPriority) {
+        _priorityPackets.push_back(queuedPacket);
+    } else {
+        _packets.push_back(queuedPacket);
+    }
     unlock();
     _totalPacketsQueued++;
     _totalBytesQueued += packet.size();
@@ -84,7 +95,7 @@ bool PacketSender::threadedProcess() {
     }
 
     // in threaded mode, we keep running and just empty our packet queue sleeping enough to keep our PPS on target
-    while (_packets.size() > 0) {
+    while (hasPacketsToSend()) {
         // Recalculate our SEND_INTERVAL_USECS each time, in case the caller has changed it on us..
         int packetsPerSecondTarget = (_packetsPerSecond > MINIMUM_PACKETS_PER_SECOND)
                                             ? _packetsPerSecond : MINIMUM_PACKETS_PER_SECOND;
@@ -163,7 +174,7 @@ bool PacketSender::nonThreadedProcess() {
         averageCallTime = _usecsPerProcessCallHint;
     }
 
-    if (_packets.size() == 0) {
+    if (!hasPacketsToSend()) {
         // in non-threaded mode, if there's nothing to do, just return, keep running till they terminate us
         return isStillRunning();
     }
@@ -259,27 +270,59 @@ bool PacketSender::nonThreadedProcess() {
         }
     }
 
-    int packetsLeft = _packets.size();
-
-    // Now that we know how many packets to send this call to process, just send them.
-    while ((packetsSentThisCall < packetsToSendThisCall) && (packetsLeft > 0)) {
-        lock();
-        NetworkPacket& packet = _packets.front();
-        NetworkPacket temporary = packet; // make a copy
-        _packets.erase(_packets.begin());
-        packetsLeft = _packets.size();
-        unlock();
-
-        // send the packet through the NodeList...
-        DependencyManager::get<NodeList>()->writeDatagram(temporary.getByteArray(), temporary.getNode());
+    // the burst allowance refills at our target rate, and every packet we send takes from it, so it only builds up
+    // while we've been sending less than our target
+    if (_lastBurstRefill == 0) {
+        _lastBurstRefill = now;
+    }
+    float elapsedSinceRefill = (float)(now - _lastBurstRefill) / (float)USECS_PER_SECOND;
+    _burstTokens = std::min((float)_maxBurstPackets, _burstTokens + _packetsPerSecond * elapsedSinceRefill);
+    _lastBurstRefill = now;
+
+    // Now that we know how many packets to send this call to process, just send them, high priority ones first. A high
+    // priority packet beyond our count for this call can still go out on the burst allowance, and is counted in our
+    // check interval so the packets after it make up for it.
+    while (hasPacketsToSend()) {
+        if (packetsSentThisCall >= packetsToSendThisCall && (_priorityPackets.empty() || _burstTokens < 1.0f)) {
+            break;
+        }
+        if (!nextPacketFitsPacing(now)) {
+            // the rest wait behind it, in order, for the node's pacer to catch up
+            break;
+        }
+        sendNextPacket(now);
         packetsSentThisCall++;
         _packetsOverCheckInterval++;
-        _totalPacketsSent++;
-        _totalBytesSent += temporary.getByteArray().size();
-        
-        emit packetSent(temporary.getByteArray().size());
-        
-        _lastSendTime = now;
+        _burstTokens = std::max(0.0f, _burstTokens - 1.0f);
     }
     return isStillRunning();
 }
+
+bool PacketSender::nextPacketFitsPacing(quint64 now) {
+    lock();
+    const std::deque<QueuedPacket>& queue = _priorityPackets.empty() ? _packets : _priorityPackets;
+    SharedNodePointer node = queue.front().packet.getNode();
+    int size = queue.front().packet.getByteArray().size();
+    unlock();
+
+    return !node || node->getCongestionController().canSend(size, now);
+}
+
+void PacketSender::sendNextPacket(quint64 now) {
+    lock();
+    std::deque<QueuedPacket>& queue = _priorityPackets.empty() ? _packets : _priorityPackets;
+    QueuedPacket temporary = queue.front(); // make a copy
+    queue.pop_front();
+    unlock();
+
+    // send the packet through the NodeList...
+    const QByteArray& packet = temporary.packet.getByteArray();
+    DependencyManager::get<NodeList>()->writeDatagram(packet, temporary.packet.getNode());
+    _totalPacketsSent++;
+    _totalBytesSent += packet.size();
+    _averageQueuedTime.updateAverage(now - temporary.queuedAt);
+
+    emit packetSent(packet.size());
+
+    _lastSendTime = now;
+}
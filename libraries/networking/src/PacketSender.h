@@ -14,6 +14,9 @@
 #ifndef hifi_PacketSender_h
 #define hifi_PacketSender_h
 
+#include <algorithm>
+#include <deque>
+
 #include <QWaitCondition>
 
 #include "GenericThread.h"
@@ -34,24 +37,39 @@ public:
     static const int DEFAULT_PACKETS_PER_SECOND;
     static const int MINIMUM_PACKETS_PER_SECOND;
     static const int MINIMAL_SLEEP_INTERVAL;
+    static const int DEFAULT_MAX_BURST_PACKETS;
 
     PacketSender(int packetsPerSecond = DEFAULT_PACKETS_PER_SECOND);
     ~PacketSender();
 
-    /// Add packet to outbound queue.
-    void queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet);
+    /// Add packet to outbound queue. A high priority packet goes out ahead of the others, and if the sender has been
+    /// quiet it may go out ahead of the packets per second pacing, which is paid back by the packets that follow.
+    /// Either way it also waits for room in its node's congestion controller, which every stream to the node spends.
+    void queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet,
+                               bool highPriority = false);
 
     void setPacketsPerSecond(int packetsPerSecond);
     int getPacketsPerSecond() const { return _packetsPerSecond; }
 
+    /// Sets how many high priority packets can go out ahead of the packets per second pacing. The allowance refills
+    /// at the packets per second rate while the sender sends less than that.
+    void setMaxBurstPackets(int maxBurstPackets) { _maxBurstPackets = std::max(0, maxBurstPackets); }
+    int getMaxBurstPackets() const { return _maxBurstPackets; }
+
     virtual bool process();
     virtual void terminating();
 
     /// are there packets waiting in the send queue to be sent
-    bool hasPacketsToSend() const { return _packets.size() > 0; }
+    bool hasPacketsToSend() const { return packetsToSendCount() > 0; }
 
     /// how many packets are there in the send queue waiting to be sent
-    int packetsToSendCount() const { return _packets.size(); }
+    int packetsToSendCount() const { return (int)(_packets.size() + _priorityPackets.size()); }
+
+    /// how many of the packets waiting in the send queue are high priority
+    int priorityPacketsToSendCount() const { return (int)_priorityPackets.size(); }
+
+    /// returns the average time in usecs recent packets waited in the send queue before being sent
+    float getAverageQueuedUsecs() const { return _averageQueuedTime.getAverage(); }
 
     /// If you're running in non-threaded mode, call this to give us a hint as to how frequently you will call process.
     /// This has no effect in threaded mode. This is only considered a hint in non-threaded mode.
@@ -100,11 +118,26 @@ protected:
     SimpleMovingAverage _averageProcessCallTime;
 
 private:
-    std::vector<NetworkPacket> _packets;
+    struct QueuedPacket {
+        QueuedPacket(const NetworkPacket& packet, quint64 queuedAt) : packet(packet), queuedAt(queuedAt) { }
+
+        NetworkPacket packet;
+        quint64 queuedAt;
+    };
+
+    std::deque<QueuedPacket> _packets;
+    std::deque<QueuedPacket> _priorityPackets;
     quint64 _lastSendTime;
 
     bool threadedProcess();
     bool nonThreadedProcess();
+    bool nextPacketFitsPacing(quint64 now);
+    void sendNextPacket(quint64 now);
+
+    int _maxBurstPackets;
+    float _burstTokens;
+    quint64 _lastBurstRefill;
+    SimpleMovingAverage _averageQueuedTime;
 
     quint64 _lastPPSCheck;
     int _packetsOverCheckInterval;
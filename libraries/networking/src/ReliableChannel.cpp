@@ -0,0 +1,271 @@
+//
+//  ReliableChannel.cpp
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <string.h>
+
+#include <SharedUtil.h>
+
+#include "ReliableChannel.h"
+
+const quint8 HAS_MESSAGE_FLAG = 0x01;
+const int NUM_ACK_BYTES = sizeof(quint8) + sizeof(quint16) + sizeof(quint32);
+
+// like TCP, a packet is taken as lost once three sent after it have arrived
+const int LOST_AFTER_LATER_ACKNOWLEDGED = 3;
+
+const float INITIAL_CONGESTION_WINDOW = 2.0f;
+const float MIN_SLOW_START_THRESHOLD = 2.0f;
+
+const quint64 INITIAL_RETRANSMIT_TIMEOUT = 500 * USECS_PER_MSEC;
+const quint64 MIN_RETRANSMIT_TIMEOUT = 50 * USECS_PER_MSEC;
+const quint64 MAX_RETRANSMIT_TIMEOUT = 5 * USECS_PER_SECOND;
+
+// the distance from one sequence number to a later one, negative if it's earlier
+static inline int sequenceDistance(quint16 from, quint16 to) {
+    return (qint16)(quint16)(to - from);
+}
+
+ReliableChannel::ReliableChannel() :
+    _oldestUnacknowledged(0),
+    _nextSequenceNumber(0),
+    _sendCount(0),
+    _sentMessages(MAX_WINDOW),
+    _congestionWindow(INITIAL_CONGESTION_WINDOW),
+    _slowStartThreshold(MAX_WINDOW),
+    _recoveryEnd(0),
+    _inRecovery(false),
+    _hasRoundTripSample(false),
+    _smoothedRoundTrip(0.0f),
+    _roundTripVariance(0.0f),
+    _retransmitTimeout(INITIAL_RETRANSMIT_TIMEOUT),
+    _nextExpected(0),
+    _acknowledgementDue(false)
+{
+    memset(_inFlight, 0, sizeof(_inFlight));
+}
+
+void ReliableChannel::queueMessage(const QByteArray& message) {
+    QMutexLocker locker(&_mutex);
+    _queuedMessages.append(message);
+}
+
+void ReliableChannel::update(quint64 now, QVector<QByteArray>& packets) {
+    QMutexLocker locker(&_mutex);
+    int packetsBefore = packets.size();
+    
+    // send again whatever the peer has skipped over or taken too long to acknowledge
+    quint64 retransmitTimeout = _retransmitTimeout;
+    for (quint16 sequenceNumber = _oldestUnacknowledged; sequenceNumber != _nextSequenceNumber; sequenceNumber++) {
+        InFlight& inFlight = getInFlight(sequenceNumber);
+        if (inFlight.acknowledged) {
+            continue;
+        }
+        bool timedOut = (now - inFlight.sentAt >= retransmitTimeout);
+        if (timedOut || inFlight.laterAcknowledged >= LOST_AFTER_LATER_ACKNOWLEDGED) {
+            loseSequence(sequenceNumber, timedOut);
+            inFlight.sentAt = now;
+            inFlight.sendOrder = _sendCount++;
+            inFlight.laterAcknowledged = 0;
+            inFlight.resent = true;
+            packets.append(buildPacket(true, sequenceNumber, *_sentMessages.getPacket(sequenceNumber)));
+        }
+    }
+    
+    // then as many new ones as the window has room for
+    int window = qMin((int)_congestionWindow, MAX_WINDOW);
+    while (!_queuedMessages.isEmpty() && sequenceDistance(_oldestUnacknowledged, _nextSequenceNumber) < window) {
+        quint16 sequenceNumber = _nextSequenceNumber++;
+        QByteArray message = _queuedMessages.takeFirst();
+        _sentMessages.packetSent(sequenceNumber, message);
+        
+        InFlight& inFlight = getInFlight(sequenceNumber);
+        inFlight.sentAt = now;
+        inFlight.sendOrder = _sendCount++;
+        inFlight.laterAcknowledged = 0;
+        inFlight.acknowledged = false;
+        inFlight.resent = false;
+        packets.append(buildPacket(true, sequenceNumber, message));
+    }
+    
+    // every packet carries the acknowledgement, so one is only sent on its own when nothing else went
+    if (_acknowledgementDue && packets.size() == packetsBefore) {
+        packets.append(buildPacket(false, 0, QByteArray()));
+    }
+}
+
+bool ReliableChannel::packetReceived(const QByteArray& payload, quint64 now, QVector<QByteArray>& messages) {
+    QMutexLocker locker(&_mutex);
+    if (payload.size() < NUM_ACK_BYTES) {
+        return false;
+    }
+    const char* data = payload.constData();
+    quint8 flags;
+    quint16 cumulativeAck;
+    quint32 selectiveAcks;
+    memcpy(&flags, data, sizeof(flags));
+    memcpy(&cumulativeAck, data + sizeof(flags), sizeof(cumulativeAck));
+    memcpy(&selectiveAcks, data + sizeof(flags) + sizeof(cumulativeAck), sizeof(selectiveAcks));
+    acknowledge(cumulativeAck, selectiveAcks, now);
+    
+    if (!(flags & HAS_MESSAGE_FLAG)) {
+        return true;
+    }
+    if (payload.size() < NUM_ACK_BYTES + (int)sizeof(quint16)) {
+        return false;
+    }
+    quint16 sequenceNumber;
+    memcpy(&sequenceNumber, data + NUM_ACK_BYTES, sizeof(sequenceNumber));
+    
+    // acknowledge even a copy of one we have, since it means the peer missed our acknowledgement
+    _acknowledgementDue = true;
+    _incomingStats.sequenceNumberReceived(sequenceNumber);
+    
+    int distance = sequenceDistance(_nextExpected, sequenceNumber);
+    if (distance < 0 || distance >= MAX_WINDOW) {
+        return true;
+    }
+    QByteArray message = payload.mid(NUM_ACK_BYTES + sizeof(quint16));
+    if (distance > 0) {
+        _heldMessages.insert(sequenceNumber, message);
+        return true;
+    }
+    messages.append(message);
+    for (_nextExpected++; _heldMessages.contains(_nextExpected); _nextExpected++) {
+        messages.append(_heldMessages.take(_nextExpected));
+    }
+    return true;
+}
+
+int ReliableChannel::getPendingMessageCount() const {
+    QMutexLocker locker(&_mutex);
+    return sequenceDistance(_oldestUnacknowledged, _nextSequenceNumber) + _queuedMessages.size();
+}
+
+QByteArray ReliableChannel::buildPacket(bool hasMessage, quint16 sequenceNumber, const QByteArray& message) {
+    // everything up to the one we're waiting for has arrived, and a bit for each of the ones after that
+    quint8 flags = hasMessage ? HAS_MESSAGE_FLAG : 0;
+    quint16 cumulativeAck = _nextExpected - 1;
+    quint32 selectiveAcks = 0;
+    if (!_heldMessages.isEmpty()) {
+        for (int i = 0; i < MAX_WINDOW; i++) {
+            if (_heldMessages.contains(_nextExpected + 1 + i)) {
+                selectiveAcks |= (1U << i);
+            }
+        }
+    }
+    _acknowledgementDue = false;
+    
+    QByteArray packet(NUM_ACK_BYTES + (hasMessage ? sizeof(quint16) + message.size() : 0), 0);
+    char* data = packet.data();
+    memcpy(data, &flags, sizeof(flags));
+    memcpy(data + sizeof(flags), &cumulativeAck, sizeof(cumulativeAck));
+    memcpy(data + sizeof(flags) + sizeof(cumulativeAck), &selectiveAcks, sizeof(selectiveAcks));
+    if (hasMessage) {
+        memcpy(data + NUM_ACK_BYTES, &sequenceNumber, sizeof(sequenceNumber));
+        memcpy(data + NUM_ACK_BYTES + sizeof(sequenceNumber), message.constData(), message.size());
+    }
+    return packet;
+}
+
+void ReliableChannel::acknowledge(quint16 cumulativeAck, quint32 selectiveAcks, quint64 now) {
+    // an acknowledgement older than what we've already had, or of what we never sent, says nothing new
+    int cumulativeDistance = sequenceDistance(_oldestUnacknowledged, cumulativeAck + 1);
+    if (cumulativeDistance < 0 || cumulativeDistance > sequenceDistance(_oldestUnacknowledged, _nextSequenceNumber)) {
+        return;
+    }
+    for (quint16 sequenceNumber = _oldestUnacknowledged; sequenceNumber != (quint16)(cumulativeAck + 1);
+            sequenceNumber++) {
+        acknowledgeSequence(sequenceNumber, now);
+    }
+    for (int i = 0; i < MAX_WINDOW; i++) {
+        quint16 sequenceNumber = cumulativeAck + 2 + i;
+        if ((selectiveAcks & (1U << i)) && isInFlight(sequenceNumber)) {
+            acknowledgeSequence(sequenceNumber, now);
+        }
+    }
+    
+    // count for each one still missing how many sent after it have arrived; that's by when they were last sent rather
+    // than by sequence number, so that a retransmission gets the same chance to arrive as the original did
+    for (quint16 missing = _oldestUnacknowledged; missing != _nextSequenceNumber; missing++) {
+        InFlight& inFlight = getInFlight(missing);
+        if (inFlight.acknowledged) {
+            continue;
+        }
+        inFlight.laterAcknowledged = 0;
+        for (quint16 later = _oldestUnacknowledged; later != _nextSequenceNumber; later++) {
+            const InFlight& laterInFlight = getInFlight(later);
+            if (laterInFlight.acknowledged && (qint32)(laterInFlight.sendOrder - inFlight.sendOrder) > 0) {
+                inFlight.laterAcknowledged++;
+            }
+        }
+    }
+    
+    while (_oldestUnacknowledged != _nextSequenceNumber && getInFlight(_oldestUnacknowledged).acknowledged) {
+        _oldestUnacknowledged++;
+    }
+    if (_inRecovery && sequenceDistance(_recoveryEnd, _oldestUnacknowledged) >= 0) {
+        _inRecovery = false;
+    }
+}
+
+void ReliableChannel::acknowledgeSequence(quint16 sequenceNumber, quint64 now) {
+    InFlight& inFlight = getInFlight(sequenceNumber);
+    if (inFlight.acknowledged) {
+        return;
+    }
+    inFlight.acknowledged = true;
+    
+    // a packet that was sent twice can't say which copy was acknowledged, so only the others time the round trip
+    if (!inFlight.resent) {
+        float roundTrip = now - inFlight.sentAt;
+        if (_hasRoundTripSample) {
+            const float VARIANCE_GAIN = 0.25f;
+            const float ROUND_TRIP_GAIN = 0.125f;
+            _roundTripVariance += VARIANCE_GAIN * (fabsf(_smoothedRoundTrip - roundTrip) - _roundTripVariance);
+            _smoothedRoundTrip += ROUND_TRIP_GAIN * (roundTrip - _smoothedRoundTrip);
+        } else {
+            _smoothedRoundTrip = roundTrip;
+            _roundTripVariance = roundTrip * 0.5f;
+            _hasRoundTripSample = true;
+        }
+        _retransmitTimeout = qBound(MIN_RETRANSMIT_TIMEOUT, (quint64)(_smoothedRoundTrip + 4.0f * _roundTripVariance),
+                                    MAX_RETRANSMIT_TIMEOUT);
+    }
+    
+    // grow quickly until the first loss, then by about one packet per window
+    if (_congestionWindow < _slowStartThreshold) {
+        _congestionWindow += 1.0f;
+    } else {
+        _congestionWindow += 1.0f / _congestionWindow;
+    }
+    _congestionWindow = qMin(_congestionWindow, (float)MAX_WINDOW);
+}
+
+void ReliableChannel::loseSequence(quint16 sequenceNumber, bool timedOut) {
+    if (timedOut) {
+        // nothing came back for a whole timeout, so wait longer before the next
+        _retransmitTimeout = qMin(_retransmitTimeout * 2, MAX_RETRANSMIT_TIMEOUT);
+    }
+    
+    // the window shrinks once for each window's worth of losses, not once per lost packet
+    if (_inRecovery && sequenceDistance(_recoveryEnd, sequenceNumber) < 0) {
+        return;
+    }
+    _slowStartThreshold = qMax(_congestionWindow * 0.5f, MIN_SLOW_START_THRESHOLD);
+    _congestionWindow = timedOut ? 1.0f : _slowStartThreshold;
+    _recoveryEnd = _nextSequenceNumber;
+    _inRecovery = true;
+}
+
+bool ReliableChannel::isInFlight(quint16 sequenceNumber) const {
+    int distance = sequenceDistance(_oldestUnacknowledged, sequenceNumber);
+    return distance >= 0 && distance < sequenceDistance(_oldestUnacknowledged, _nextSequenceNumber);
+}
@@ -0,0 +1,104 @@
+//
+//  ReliableChannel.h
+//  libraries/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReliableChannel_h
+#define hifi_ReliableChannel_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include "SentPacketHistory.h"
+#include "SequenceNumberStats.h"
+
+/// A reliable, in-order stream of messages to one peer over unreliable datagrams.  Each message goes out in a packet
+/// of its own, numbered in sequence.  Every packet acknowledges what has arrived from the other side: everything up to
+/// a cumulative sequence number, and which of the packets after it have arrived too.  A packet the peer has seen three
+/// later ones past, or that hasn't been acknowledged within the retransmit timeout, is sent again.  How many packets
+/// may be unacknowledged grows as they're acknowledged and halves when one is lost, the way TCP's window does.
+///
+/// The channel only builds and reads payloads; its owner puts them into packets and sends them.
+class ReliableChannel {
+public:
+    
+    /// the most packets that may be unacknowledged at once, which is also how many the receiver will hold out of order
+    static const int MAX_WINDOW = 32;
+    
+    /// what the channel adds to each message
+    static const int MAX_OVERHEAD_BYTES = 9;
+    
+    ReliableChannel();
+    
+    /// Queues a message to be sent by a later update().
+    void queueMessage(const QByteArray& message);
+    
+    /// Appends the payloads that should go out now to packets: queued messages that fit in the window, those that need
+    /// to be sent again, and an acknowledgement on its own if nothing else carries one.
+    void update(quint64 now, QVector<QByteArray>& packets);
+    
+    /// Reads a payload from the peer, appending the messages it completes to messages in the order they were sent.
+    /// \return false if the payload was malformed
+    bool packetReceived(const QByteArray& payload, quint64 now, QVector<QByteArray>& messages);
+    
+    /// the number of messages sent but not yet acknowledged, or queued and not yet sent
+    int getPendingMessageCount() const;
+    
+    float getCongestionWindow() const { return _congestionWindow; }
+    quint64 getRetransmitTimeout() const { return _retransmitTimeout; }
+    
+    const SequenceNumberStats& getIncomingStats() const { return _incomingStats; }
+
+private:
+    
+    struct InFlight {
+        quint64 sentAt;
+        quint32 sendOrder; // counts every send, retransmissions included
+        int laterAcknowledged; // how many sent after it the peer has acknowledged
+        bool acknowledged;
+        bool resent;
+    };
+    
+    QByteArray buildPacket(bool hasMessage, quint16 sequenceNumber, const QByteArray& message);
+    void acknowledge(quint16 cumulativeAck, quint32 selectiveAcks, quint64 now);
+    void acknowledgeSequence(quint16 sequenceNumber, quint64 now);
+    void loseSequence(quint16 sequenceNumber, bool timedOut);
+    bool isInFlight(quint16 sequenceNumber) const;
+    InFlight& getInFlight(quint16 sequenceNumber) { return _inFlight[sequenceNumber % MAX_WINDOW]; }
+    
+    mutable QMutex _mutex;
+    
+    // sending: the oldest unacknowledged sequence number, the next one to use, and the window between them
+    quint16 _oldestUnacknowledged;
+    quint16 _nextSequenceNumber;
+    quint32 _sendCount;
+    QList<QByteArray> _queuedMessages;
+    SentPacketHistory _sentMessages;
+    InFlight _inFlight[MAX_WINDOW];
+    float _congestionWindow;
+    float _slowStartThreshold;
+    quint16 _recoveryEnd; // losses before this are part of the loss event that last halved the window
+    bool _inRecovery;
+    
+    // round trip estimates, in usecs
+    bool _hasRoundTripSample;
+    float _smoothedRoundTrip;
+    float _roundTripVariance;
+    quint64 _retransmitTimeout;
+    
+    // receiving: everything before _nextExpected has been delivered, later arrivals wait in _heldMessages
+    quint16 _nextExpected;
+    QHash<quint16, QByteArray> _heldMessages;
+    bool _acknowledgementDue;
+    SequenceNumberStats _incomingStats;
+};
+
+#endif // hifi_ReliableChannel_h
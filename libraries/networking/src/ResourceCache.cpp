@@ -12,10 +12,12 @@
 #include <cfloat>
 #include <cmath>
 
+#include <QDateTime>
 #include <QThread>
 #include <QTimer>
 #include <QtDebug>
 
+#include <MemoryTracker.h>
 #include <SharedUtil.h>
 
 #include "NetworkAccessManager.h"
@@ -111,31 +113,45 @@ void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
     }
 }
 
+const int SCHEDULE_INTERVAL_MS = 100;
+
+// a download that gets this far has shown itself to be large, and streams on without holding back the smaller ones
+// waiting behind it, so that what's visible in a new domain isn't stuck behind the biggest assets
+const qint64 BACKGROUND_DOWNLOAD_BYTES = 512 * 1024;
+const int MAX_BACKGROUND_REQUESTS = 4;
+
+// a request that has received less than this gives up its slot to a waiting one with a higher priority
+const qint64 MAX_PREEMPTED_BYTES = 16 * 1024;
+
 void ResourceCache::attemptRequest(Resource* resource) {
     auto sharedItems = DependencyManager::get<ResouceCacheSharedItems>();
-    if (_requestLimit <= 0) {
+    if (!sharedItems->_scheduleTimer) {
+        sharedItems->_scheduleTimer = new QTimer();
+        connect(sharedItems->_scheduleTimer, &QTimer::timeout, &ResourceCache::updateRequests);
+        sharedItems->_scheduleTimer->start(SCHEDULE_INTERVAL_MS);
+        sharedItems->_lastTuning = usecTimestampNow();
+    }
+    if (getFreeRequestSlots() <= 0) {
         // wait until a slot becomes available
         sharedItems->_pendingRequests.append(resource);
         return;
     }
-    _requestLimit--;
     sharedItems->_loadingRequests.append(resource);
     resource->makeRequest();
 }
 
 void ResourceCache::requestCompleted(Resource* resource) {
-    
-    auto sharedItems = DependencyManager::get<ResouceCacheSharedItems>();
-    sharedItems->_loadingRequests.removeOne(resource);
-    _requestLimit++;
-    
-    // look for the highest priority pending request
+    DependencyManager::get<ResouceCacheSharedItems>()->_loadingRequests.removeOne(resource);
+    updateRequests();
+}
+
+static Resource* takeHighestPriorityRequest(QList<QPointer<Resource> >& pendingRequests, float& highestPriority) {
     int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    for (int i = 0; i < sharedItems->_pendingRequests.size(); ) {
-        Resource* resource = sharedItems->_pendingRequests.at(i).data();
+    highestPriority = -FLT_MAX;
+    for (int i = 0; i < pendingRequests.size(); ) {
+        Resource* resource = pendingRequests.at(i).data();
         if (!resource) {
-            sharedItems->_pendingRequests.removeAt(i);
+            pendingRequests.removeAt(i);
             continue;
         }
         float priority = resource->getLoadPriority();
@@ -145,11 +161,85 @@ void ResourceCache::requestCompleted(Resource* resource) {
         }
         i++;
     }
-    if (highestIndex >= 0) {
-        attemptRequest(sharedItems->_pendingRequests.takeAt(highestIndex));
+    return (highestIndex >= 0) ? pendingRequests.takeAt(highestIndex).data() : nullptr;
+}
+
+void ResourceCache::updateRequests() {
+    auto sharedItems = DependencyManager::get<ResouceCacheSharedItems>();
+    tuneRequestLimit();
+    
+    // priorities change as the owners move, so the order is decided afresh each time
+    float highestPriority;
+    while (getFreeRequestSlots() > 0) {
+        Resource* resource = takeHighestPriorityRequest(sharedItems->_pendingRequests, highestPriority);
+        if (!resource) {
+            return;
+        }
+        attemptRequest(resource);
+    }
+    Resource* highest = takeHighestPriorityRequest(sharedItems->_pendingRequests, highestPriority);
+    if (!highest) {
+        return;
+    }
+    Resource* lowest = nullptr;
+    float lowestPriority = highestPriority;
+    foreach (Resource* resource, sharedItems->_loadingRequests) {
+        if (resource->getBytesReceived() < MAX_PREEMPTED_BYTES) {
+            float priority = resource->getLoadPriority();
+            if (priority < lowestPriority) {
+                lowestPriority = priority;
+                lowest = resource;
+            }
+        }
+    }
+    if (lowest) {
+        lowest->preemptRequest();
+        sharedItems->_loadingRequests.removeOne(lowest);
+        sharedItems->_pendingRequests.append(lowest);
+        attemptRequest(highest);
+    } else {
+        sharedItems->_pendingRequests.append(highest);
     }
 }
 
+const int MIN_REQUEST_LIMIT = 2;
+const int MAX_REQUEST_LIMIT = 16;
+const quint64 TUNING_INTERVAL_USECS = 2 * USECS_PER_SECOND;
+
+int ResourceCache::getFreeRequestSlots() {
+    int backgroundRequests = 0;
+    const QList<Resource*>& loadingRequests = getLoadingRequests();
+    foreach (Resource* resource, loadingRequests) {
+        if (resource->getBytesReceived() >= BACKGROUND_DOWNLOAD_BYTES) {
+            backgroundRequests++;
+        }
+    }
+    return _requestLimit - loadingRequests.size() + qMin(backgroundRequests, MAX_BACKGROUND_REQUESTS);
+}
+
+void ResourceCache::tuneRequestLimit() {
+    auto sharedItems = DependencyManager::get<ResouceCacheSharedItems>();
+    quint64 now = usecTimestampNow();
+    quint64 elapsed = now - sharedItems->_lastTuning;
+    if (elapsed < TUNING_INTERVAL_USECS) {
+        return;
+    }
+    qint64 throughput = sharedItems->_bytesReceivedSinceTuning * (qint64)USECS_PER_SECOND / (qint64)elapsed;
+    sharedItems->_bytesReceivedSinceTuning = 0;
+    sharedItems->_lastTuning = now;
+    
+    // the limit only holds throughput back while requests are waiting for it. keep stepping it the way that last
+    // helped, and turn back when a step didn't
+    if (!sharedItems->_pendingRequests.isEmpty()) {
+        const float IMPROVEMENT_PROPORTION = 1.05f;
+        if (throughput < sharedItems->_lastThroughput * IMPROVEMENT_PROPORTION) {
+            sharedItems->_lastLimitChange = -sharedItems->_lastLimitChange;
+        }
+        _requestLimit = clamp(_requestLimit + sharedItems->_lastLimitChange, MIN_REQUEST_LIMIT, MAX_REQUEST_LIMIT);
+    }
+    sharedItems->_lastThroughput = throughput;
+}
+
 const int DEFAULT_REQUEST_LIMIT = 10;
 int ResourceCache::_requestLimit = DEFAULT_REQUEST_LIMIT;
 
@@ -174,6 +264,7 @@ Resource::~Resource() {
         delete _reply;
         _reply = nullptr;
     }
+    setMemoryUsage(0, 0);
 }
 
 void Resource::ensureLoading() {
@@ -227,6 +318,7 @@ void Resource::refresh() {
         _reply = nullptr;
     }
     init();
+    setMemoryUsage(0, _gpuMemoryBytes);
     _request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
     if (!_startedLoading) {
         attemptRequest();
@@ -274,6 +366,7 @@ void Resource::attemptRequest() {
 void Resource::finishedLoading(bool success) {
     if (success) {
         _loaded = true;
+        setMemoryUsage(_bytesReceived, _gpuMemoryBytes);
         emit loaded();
     } else {
         _failedToLoad = true;
@@ -285,13 +378,32 @@ void Resource::reinsert() {
     _cache->_resources.insert(_url, _self);
 }
 
+void Resource::setMemoryUsage(qint64 cpuBytes, qint64 gpuBytes) {
+    if (!_memoryCounter) {
+        if (cpuBytes == 0 && gpuBytes == 0) {
+            return;
+        }
+        // counted by the kind of cache, so TextureCache, GeometryCache and so on each have one
+        _memoryCounter = &MemoryTracker::getInstance().getCounter(_cache ?
+            _cache->metaObject()->className() : metaObject()->className());
+    }
+    _memoryCounter->addCPUBytes(cpuBytes - _cpuMemoryBytes);
+    _memoryCounter->addGPUBytes(gpuBytes - _gpuMemoryBytes);
+    _cpuMemoryBytes = cpuBytes;
+    _gpuMemoryBytes = gpuBytes;
+}
+
 const int REPLY_TIMEOUT_MS = 5000;
 
 void Resource::handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal) {
+    if (bytesReceived > _bytesReceived) {
+        DependencyManager::get<ResouceCacheSharedItems>()->_bytesReceivedSinceTuning += bytesReceived - _bytesReceived;
+    }
     if (!_reply->isFinished()) {
         _bytesReceived = bytesReceived;
         _bytesTotal = bytesTotal;
         _replyTimer->start(REPLY_TIMEOUT_MS);
+        downloadReceived(_reply);
         return;
     }
     _reply->disconnect(this);
@@ -315,7 +427,7 @@ void Resource::handleReplyTimeout() {
 }
 
 void Resource::makeRequest() {
-    _reply = NetworkAccessManager::getInstance().get(_request);
+    _reply = NetworkAccessManager::get(_request);
     
     connect(_reply, SIGNAL(downloadProgress(qint64,qint64)), SLOT(handleDownloadProgress(qint64,qint64)));
     connect(_reply, SIGNAL(error(QNetworkReply::NetworkError)), SLOT(handleReplyError()));
@@ -328,6 +440,31 @@ void Resource::makeRequest() {
     _bytesReceived = _bytesTotal = 0;
 }
 
+void Resource::preemptRequest() {
+    _reply->disconnect(this);
+    _reply->abort();
+    _reply->deleteLater();
+    _reply = nullptr;
+    _replyTimer->disconnect(this);
+    _replyTimer->deleteLater();
+    _replyTimer = nullptr;
+    _bytesReceived = _bytesTotal = 0;
+}
+
+void Resource::abandonDownload() {
+    if (!_reply) {
+        return;
+    }
+    _reply->disconnect(this);
+    _reply->abort();
+    _reply->deleteLater();
+    _reply = nullptr;
+    _replyTimer->disconnect(this);
+    _replyTimer->deleteLater();
+    _replyTimer = nullptr;
+    ResourceCache::requestCompleted(this);
+}
+
 void Resource::handleReplyError(QNetworkReply::NetworkError error, QDebug debug) {
     _reply->disconnect(this);
     _reply->deleteLater();
@@ -364,6 +501,21 @@ void Resource::handleReplyError(QNetworkReply::NetworkError error, QDebug debug)
     }
 }
 
+QByteArray Resource::getContentValidator(QNetworkReply* reply) {
+    // an ETag changes whenever the content does, a modification time needs the length to go with it
+    if (reply->hasRawHeader("ETag")) {
+        return reply->rawHeader("ETag");
+    }
+    
+    QVariant lastModified = reply->header(QNetworkRequest::LastModifiedHeader);
+    if (lastModified.isValid()) {
+        return lastModified.toDateTime().toString(Qt::ISODate).toUtf8() + " "
+            + QByteArray::number(reply->header(QNetworkRequest::ContentLengthHeader).toLongLong());
+    }
+    
+    return QByteArray();
+}
+
 void Resource::handleReplyFinished() {
     qDebug() << "Got finished without download progress/error?" << _url;
     handleDownloadProgress(0, 0);
@@ -19,13 +19,14 @@
 #include <QObject>
 #include <QPointer>
 #include <QSharedPointer>
+#include <QTimer>
 #include <QUrl>
 #include <QWeakPointer>
 
 #include <DependencyManager.h>
 
 class QNetworkReply;
-class QTimer;
+class MemoryCounter;
 
 class Resource;
 
@@ -51,9 +52,16 @@ class ResouceCacheSharedItems : public Dependency  {
 public:
     QList<QPointer<Resource> > _pendingRequests;
     QList<Resource*> _loadingRequests;
+
+    // reorders the requests as priorities change and tunes the request limit to the measured throughput
+    QTimer* _scheduleTimer = nullptr;
+    qint64 _bytesReceivedSinceTuning = 0;
+    quint64 _lastTuning = 0;
+    qint64 _lastThroughput = 0;
+    int _lastLimitChange = 1;
 private:
     ResouceCacheSharedItems() { }
-    virtual ~ResouceCacheSharedItems() { }
+    virtual ~ResouceCacheSharedItems() { delete _scheduleTimer; }
 };
 
 
@@ -62,6 +70,8 @@ class ResourceCache : public QObject {
     Q_OBJECT
     
 public:
+    /// Sets the number of requests to load at once.  The limit is then tuned to the measured throughput, within
+    /// MIN_REQUEST_LIMIT and MAX_REQUEST_LIMIT.
     static void setRequestLimit(int limit) { _requestLimit = limit; }
     static int getRequestLimit() { return _requestLimit; }
     
@@ -102,12 +112,19 @@ protected:
     static void attemptRequest(Resource* resource);
     static void requestCompleted(Resource* resource);
 
+    /// Starts the highest priority pending requests while there are free slots, and lets a pending request take the
+    /// slot of a loading one with a lower priority that has barely started.
+    static void updateRequests();
+
 private:
     friend class Resource;
 
     QHash<QUrl, QWeakPointer<Resource> > _resources;
     int _lastLRUKey = 0;
     
+    static int getFreeRequestSlots();
+    static void tuneRequestLimit();
+    
     static int _requestLimit;
 };
 
@@ -161,6 +178,10 @@ public:
     
     const QUrl& getURL() const { return _url; }
 
+    /// Returns something that changes whenever the content behind the reply does, for keying what was derived from it:
+    /// the ETag, or else the modification time and length. Empty if the reply had neither.
+    static QByteArray getContentValidator(QNetworkReply* reply);
+
 signals:
 
     /// Fired when the resource has been loaded.
@@ -174,15 +195,31 @@ protected:
 
     virtual void init();
 
+    /// Called when part of the download has arrived, for resources that can start on it before it has all arrived.
+    /// The reply still belongs to the resource, the recipient should only read from it.
+    virtual void downloadReceived(QNetworkReply* reply) { }
+
     /// Called when the download has finished.  The recipient should delete the reply when done with it.
     virtual void downloadFinished(QNetworkReply* reply) = 0;
 
+    /// Stops the download in progress for good, for resources that have all they need before the end of it.  The reply
+    /// passed to downloadReceived is deleted later, and downloadFinished won't be called.
+    void abandonDownload();
+
     /// Should be called by subclasses when all the loading that will be done has been done.
     Q_INVOKABLE void finishedLoading(bool success);
 
     /// Reinserts this resource into the cache.
     virtual void reinsert();
 
+    /// Reports the memory the resource holds to its cache's counter in the MemoryTracker, in place of what it reported
+    /// before.  A resource that finishes loading is taken to hold as many bytes of CPU memory as it downloaded, until
+    /// it reports otherwise.
+    void setMemoryUsage(qint64 cpuBytes, qint64 gpuBytes);
+
+    qint64 getCPUMemoryBytes() const { return _cpuMemoryBytes; }
+    qint64 getGPUMemoryBytes() const { return _gpuMemoryBytes; }
+
     QUrl _url;
     QNetworkRequest _request;
     bool _startedLoading = false;
@@ -205,6 +242,9 @@ private:
     
     void makeRequest();
     
+    /// Abandons the request in progress, to be made again later.
+    void preemptRequest();
+    
     void handleReplyError(QNetworkReply::NetworkError error, QDebug debug);
     
     friend class ResourceCache;
@@ -215,6 +255,10 @@ private:
     qint64 _bytesReceived = 0;
     qint64 _bytesTotal = 0;
     int _attempts = 0;
+
+    MemoryCounter* _memoryCounter = nullptr; ///< kept, as the resource can outlive its cache
+    qint64 _cpuMemoryBytes = 0;
+    qint64 _gpuMemoryBytes = 0;
 };
 
 uint qHash(const QPointer<QObject>& value, uint seed = 0);
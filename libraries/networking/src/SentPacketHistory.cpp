@@ -8,7 +8,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <limits>
+#include <string.h>
 #include "SentPacketHistory.h"
 #include <qdebug.h>
 
@@ -19,6 +21,10 @@ SentPacketHistory::SentPacketHistory(int size)
 }
 
 void SentPacketHistory::packetSent(uint16_t sequenceNumber, const QByteArray& packet) {
+    packetSent(sequenceNumber, packet.constData(), packet.size());
+}
+
+void SentPacketHistory::packetSent(uint16_t sequenceNumber, const char* packet, int packetSize) {
 
     // check if given seq number has the expected value.  if not, something's wrong with
     // the code calling this function
@@ -28,7 +34,13 @@ void SentPacketHistory::packetSent(uint16_t sequenceNumber, const QByteArray& pa
             << "Expected:" << expectedSequenceNumber << "Actual:" << sequenceNumber;
     }
     _newestSequenceNumber = sequenceNumber;
-    _sentPackets.insert(packet);
+    
+    // with its capacity reserved, a buffer that isn't shared keeps it through a resize, so this only allocates for a
+    // larger packet than the entry has held
+    QByteArray& entry = _sentPackets.insertInPlace();
+    entry.reserve(std::max(packetSize, entry.capacity()));
+    entry.resize(packetSize);
+    memcpy(entry.data(), packet, packetSize);
 }
 
 const QByteArray* SentPacketHistory::getPacket(uint16_t sequenceNumber) const {
@@ -23,6 +23,10 @@ public:
     SentPacketHistory(int size = MAX_REASONABLE_SEQUENCE_GAP);
 
     void packetSent(uint16_t sequenceNumber, const QByteArray& packet);
+    
+    /// copies the packet into the storage of the one it replaces in the history, which allocates nothing once the
+    /// history has filled with packets at least as large
+    void packetSent(uint16_t sequenceNumber, const char* packet, int packetSize);
     const QByteArray* getPacket(uint16_t sequenceNumber) const;
 
 private:
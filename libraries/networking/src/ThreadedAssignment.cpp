@@ -10,18 +10,25 @@
 //
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include <HTTPConnection.h>
 #include <LogHandler.h>
+#include <MemoryTracker.h>
+#include <PerfStat.h>
 
 #include "ThreadedAssignment.h"
 
+const int METRICS_UPDATE_INTERVAL_MSECS = 1000;
+
 ThreadedAssignment::ThreadedAssignment(const QByteArray& packet) :
     Assignment(packet),
     _isFinished(false),
-    _datagramProcessingThread(NULL)
+    _datagramProcessingThread(NULL),
+    _metricsHTTPManager(NULL)
 {
     
 }
@@ -34,9 +41,18 @@ void ThreadedAssignment::setFinished(bool isFinished) {
         
         auto nodeList = DependencyManager::get<NodeList>();
         
+        // let the domain-server move our nodes on now, rather than once we've been silent long enough
+        nodeList->sendDomainServerDisconnect();
+        
         // if we have a datagram processing thread, quit it and wait on it to make sure that
         // the node socket is back on the same thread as the NodeList
         
+        foreach (QThread* shardThread, _receiveShardThreads) {
+            shardThread->quit();
+            shardThread->wait();
+        }
+        _receiveShardThreads.clear();
+        
         if (_datagramProcessingThread) {
             // tell the datagram processing thread to quit and wait until it is done, then return the node socket to the NodeList
             _datagramProcessingThread->quit();
@@ -71,6 +87,21 @@ void ThreadedAssignment::commonInit(const QString& targetName, NodeType_t nodeTy
     connect(silentNodeRemovalTimer, SIGNAL(timeout()), nodeList.data(), SLOT(removeSilentNodes()));
     silentNodeRemovalTimer->start(NODE_SILENCE_THRESHOLD_MSECS);
     
+    // the round trips of these are what the congestion controllers for our nodes go by
+    const int PING_INTERVAL_MSECS = 1000;
+    QTimer* pingTimer = new QTimer(this);
+    connect(pingTimer, &QTimer::timeout, this, &ThreadedAssignment::sendPingPackets);
+    pingTimer->start(PING_INTERVAL_MSECS);
+    
+    // any free port will do, since several assignments can share a machine, and the domain-server hears which
+    const quint16 METRICS_PORT = 0;
+    _metricsHTTPManager = new HTTPManager(METRICS_PORT, QString(), this, this);
+    qDebug() << "Serving packet metrics on port" << _metricsHTTPManager->serverPort();
+    
+    QTimer* metricsTimer = new QTimer(this);
+    connect(metricsTimer, &QTimer::timeout, this, &ThreadedAssignment::updateMetrics);
+    metricsTimer->start(METRICS_UPDATE_INTERVAL_MSECS);
+    
     if (shouldSendStats) {
         // send a stats packet every 1 second
         QTimer* statsTimer = new QTimer(this);
@@ -89,6 +120,11 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject &statsObje
     
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
+    statsObject["tracked_memory_bytes"] = (double)MemoryTracker::getInstance().getTotalCPUBytes();
+    
+    if (_metricsHTTPManager && _metricsHTTPManager->isListening()) {
+        statsObject["metrics_port"] = _metricsHTTPManager->serverPort();
+    }
     
     nodeList->sendStatsToDomainServer(statsObject);
 }
@@ -98,6 +134,28 @@ void ThreadedAssignment::sendStatsPacket() {
     addPacketStatsAndSendStatsPacket(statsObject);
 }
 
+bool ThreadedAssignment::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    if (connection->requestOperation() == QNetworkAccessManager::GetOperation && url.path() == "/metrics") {
+        QJsonObject metricsObject = DependencyManager::get<NodeList>()->getPacketMetrics().toJson();
+        metricsObject["stats"] = _stats.toJson();
+        metricsObject["memory"] = MemoryTracker::getInstance().toJson();
+        QJsonDocument metricsDocument(metricsObject);
+        QByteArray metricsJSON = metricsDocument.toJson();
+        connection->respond(HTTPConnection::StatusCode200, metricsJSON, "application/json");
+        
+        // the rates only change once an update, so the scrapes until the next are answered without coming to us
+        connection->parentManager()->publishSnapshot(url.path(), metricsJSON, "application/json",
+                                                     METRICS_UPDATE_INTERVAL_MSECS);
+        return true;
+        
+    } else if (connection->requestOperation() == QNetworkAccessManager::GetOperation && url.path() == "/trace") {
+        // the last few thousand timed scopes of each thread, to load into chrome://tracing
+        connection->respond(HTTPConnection::StatusCode200, PerformanceTimer::getChromeTrace(), "application/json");
+        return true;
+    }
+    return false;
+}
+
 void ThreadedAssignment::checkInWithDomainServerOrExit() {
     if (DependencyManager::get<NodeList>()->getNumNoReplyDomainCheckIns() == MAX_SILENT_DOMAIN_SERVER_CHECK_INS) {
         setFinished(true);
@@ -106,6 +164,22 @@ void ThreadedAssignment::checkInWithDomainServerOrExit() {
     }
 }
 
+void ThreadedAssignment::sendPingPackets() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    QByteArray pingPacket = nodeList->constructPingPacket();
+    nodeList->eachNode([&](const SharedNodePointer& node){
+        if (node->getActiveSocket()) {
+            nodeList->writeDatagram(pingPacket, node);
+        }
+    });
+}
+
+void ThreadedAssignment::updateMetrics() {
+    PacketMetrics& metrics = DependencyManager::get<NodeList>()->getPacketMetrics();
+    updateQueueDepths(metrics);
+    metrics.updateRates(usecTimestampNow());
+}
+
 bool ThreadedAssignment::readAvailableDatagram(QByteArray& destinationByteArray, HifiSockAddr& senderSockAddr) {
     auto nodeList = DependencyManager::get<NodeList>();
     
@@ -13,10 +13,15 @@
 #define hifi_ThreadedAssignment_h
 
 #include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include <HTTPManager.h>
+#include <StatsRegistry.h>
 
 #include "Assignment.h"
+#include "PacketMetrics.h"
 
-class ThreadedAssignment : public Assignment {
+class ThreadedAssignment : public Assignment, public HTTPRequestHandler {
     Q_OBJECT
 public:
     ThreadedAssignment(const QByteArray& packet);
@@ -24,6 +29,10 @@ public:
     void setFinished(bool isFinished);
     virtual void aboutToFinish() { };
     void addPacketStatsAndSendStatsPacket(QJsonObject& statsObject);
+    
+    /// Serves the node list's packet metrics and the totals of our stats as JSON at /metrics, on the port reported as
+    /// metrics_port in our stats.
+    virtual bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false);
 
 public slots:
     /// threaded run of assignment
@@ -36,11 +45,23 @@ signals:
 protected:
     bool readAvailableDatagram(QByteArray& destinationByteArray, HifiSockAddr& senderSockAddr);
     void commonInit(const QString& targetName, NodeType_t nodeType, bool shouldSendStats = true);
+    
+    /// called once a second, before the metrics' rates are updated, to set the depths of the assignment's queues
+    virtual void updateQueueDepths(PacketMetrics& metrics) { }
+    
+    /// The counters and histograms the assignment's threads add to, read for the stats packets and status pages, and
+    /// served with the packet metrics.
+    StatsRegistry _stats;
+    
     bool _isFinished;
     QThread* _datagramProcessingThread;
+    QVector<QThread*> _receiveShardThreads; // more datagram processing threads, each with its own receive socket
+    HTTPManager* _metricsHTTPManager;
     
 private slots:
     void checkInWithDomainServerOrExit();
+    void sendPingPackets();
+    void updateMetrics();
 
 };
 
@@ -9,13 +9,18 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <SharedUtil.h>
+
 #include "EditPacketBuffer.h"
 
 EditPacketBuffer::EditPacketBuffer() :
     _nodeUUID(),
     _currentType(PacketTypeUnknown),
     _currentSize(0),
-    _satoshiCost(0)
+    _satoshiCost(0),
+    _messageCount(0),
+    _firstMessageAt(0),
+    _isInteractive(false)
 {
     
 }
@@ -24,7 +29,10 @@ EditPacketBuffer::EditPacketBuffer(PacketType type, unsigned char* buffer, size_
     _nodeUUID(nodeUUID),
     _currentType(type),
     _currentSize(length),
-    _satoshiCost(satoshiCost)
+    _satoshiCost(satoshiCost),
+    _messageCount(1),
+    _firstMessageAt(usecTimestampNow()),
+    _isInteractive(false)
 {
     memcpy(_currentBuffer, buffer, length);
 }
\ No newline at end of file
@@ -29,6 +29,9 @@ public:
     unsigned char _currentBuffer[MAX_PACKET_SIZE];
     size_t _currentSize;
     qint64 _satoshiCost;
+    int _messageCount;
+    quint64 _firstMessageAt; // when the first message of this packet was queued
+    bool _isInteractive; // at least one message was from a user interaction, so this packet shouldn't wait
 };
 
 #endif // hifi_EditPacketBuffer_h
\ No newline at end of file
@@ -16,9 +16,13 @@
 
 #include <PacketHeaders.h>
 #include <OctalCode.h>
+#include <SharedUtil.h>
 
 #include "JurisdictionMap.h"
 
+// 16 levels down, a quarter meter voxel in a 16km domain
+static const float POINT_OCTAL_CODE_SCALE = 1.0f / (1 << 16);
+
 
 // standard assignment
 // copy assignment 
@@ -33,6 +37,7 @@ JurisdictionMap::JurisdictionMap(JurisdictionMap&& other) : _rootOctalCode(NULL)
     init(other._rootOctalCode, other._endNodes);
     other._rootOctalCode = NULL;
     other._endNodes.clear();
+    other.updateKeys();
 }
 
 // move assignment
@@ -40,6 +45,7 @@ JurisdictionMap& JurisdictionMap::operator=(JurisdictionMap&& other) {
     init(other._rootOctalCode, other._endNodes);
     other._rootOctalCode = NULL;
     other._endNodes.clear();
+    other.updateKeys();
     return *this;
 }
 #endif
@@ -93,6 +99,7 @@ void JurisdictionMap::clear() {
         }
     }
     _endNodes.clear();
+    updateKeys();
 }
 
 JurisdictionMap::JurisdictionMap(NodeType_t type) : _rootOctalCode(NULL) {
@@ -175,6 +182,7 @@ JurisdictionMap::JurisdictionMap(const char* rootHexCode, const char* endNodesHe
         myDebugPrintOctalCode(endNodeOctcode, true);
 
     }    
+    updateKeys();
 }
 
 
@@ -182,9 +190,37 @@ void JurisdictionMap::init(unsigned char* rootOctalCode, const std::vector<unsig
     clear(); // clean up our own memory
     _rootOctalCode = rootOctalCode;
     _endNodes = endNodes;
+    updateKeys();
+}
+
+void JurisdictionMap::updateKeys() {
+    _endNodeKeys.resize(_endNodes.size());
+    _hasKeys = MortonKey::fromOctalCode(_rootOctalCode, _rootKey);
+    for (size_t i = 0; i < _endNodes.size() && _hasKeys; i++) {
+        _hasKeys = MortonKey::fromOctalCode(_endNodes[i], _endNodeKeys[i]);
+    }
 }
 
 JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const {
+    // the same answer from the keys, without walking the codes section by section for each of the end nodes
+    MortonKey nodeKey;
+    if (_hasKeys && MortonKey::fromOctalCode(nodeOctalCode, nodeKey) &&
+            (childIndex == CHECK_NODE_ONLY || nodeKey.getLevels() < MortonKey::MAX_LEVELS)) {
+        if (nodeKey.isAncestorOf(_rootKey)) {
+            return ABOVE;
+        }
+        MortonKey nodeChildKey = (childIndex == CHECK_NODE_ONLY) ? nodeKey : nodeKey.getChild(childIndex);
+        if (!_rootKey.isAncestorOf(nodeChildKey)) {
+            return BELOW;
+        }
+        for (size_t i = 0; i < _endNodeKeys.size(); i++) {
+            if (_endNodeKeys[i].isAncestorOf(nodeKey)) {
+                return BELOW;
+            }
+        }
+        return WITHIN;
+    }
+
     // to be in our jurisdiction, we must be under the root...
 
     // if the node is an ancestor of my root, then we return ABOVE
@@ -207,6 +243,19 @@ JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const unsigned char* nod
     return isInJurisdiction ? WITHIN : BELOW;
 }
 
+JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const glm::vec3& point) const {
+    unsigned char* octalCode = octalCodeForPoint(point);
+    Area area = isMyJurisdiction(octalCode, CHECK_NODE_ONLY);
+    delete[] octalCode;
+    return area;
+}
+
+unsigned char* JurisdictionMap::octalCodeForPoint(const glm::vec3& point) {
+    // pointToOctalCode() wants a point inside the domain
+    glm::vec3 clamped = glm::clamp(point, 0.0f, 1.0f - POINT_OCTAL_CODE_SCALE);
+    return pointToOctalCode(clamped.x, clamped.y, clamped.z, POINT_OCTAL_CODE_SCALE);
+}
+
 
 bool JurisdictionMap::readFromFile(const char* filename) {
     QString settingsFile(filename);
@@ -231,6 +280,7 @@ bool JurisdictionMap::readFromFile(const char* filename) {
         _endNodes.push_back(octcode);
     }
     settings.endGroup();
+    updateKeys();
     return true;
 }
 
@@ -372,5 +422,7 @@ int JurisdictionMap::unpackFromMessage(const unsigned char* sourceBuffer, int av
         }
     }
     
+    updateKeys();
+
     return sourceBuffer - startPosition; // includes header!
 }
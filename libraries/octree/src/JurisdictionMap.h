@@ -20,7 +20,10 @@
 #include <QtCore/QUuid>
 #include <QReadWriteLock>
 
+#include <glm/glm.hpp>
+
 #include <Node.h>
+#include <OctalCode.h>
 
 class JurisdictionMap {
 public:
@@ -51,6 +54,13 @@ public:
 
     Area isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const;
 
+    /// the area of a point in domain units, the same answer the point's edit packets get
+    Area isMyJurisdiction(const glm::vec3& point) const;
+
+    /// The octal code edit packets carry for a point in domain units, deep enough to fall under the end nodes of any
+    /// jurisdiction we expect to be configured. You MUST delete[] it when you are done with it.
+    static unsigned char* octalCodeForPoint(const glm::vec3& point);
+
     bool writeToFile(const char* filename);
     bool readFromFile(const char* filename);
 
@@ -75,10 +85,16 @@ private:
     void copyContents(const JurisdictionMap& other); // use assignment instead
     void clear();
     void init(unsigned char* rootOctalCode, const std::vector<unsigned char*>& endNodes);
+    void updateKeys();
 
     unsigned char* _rootOctalCode;
     std::vector<unsigned char*> _endNodes;
     NodeType_t _nodeType;
+
+    // the codes as keys, when they all fit in them
+    bool _hasKeys = false;
+    MortonKey _rootKey;
+    std::vector<MortonKey> _endNodeKeys;
 };
 
 /// Map between node IDs and their reported JurisdictionMap. Typically used by classes that need to know which nodes are 
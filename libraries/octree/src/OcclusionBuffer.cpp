@@ -0,0 +1,141 @@
+//
+//  OcclusionBuffer.cpp
+//  libraries/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#include "ViewFrustum.h"
+
+#include "OcclusionBuffer.h"
+
+static const float HALF_SQRT_TWO = 0.70710678f;
+static const int CUBE_VERTEX_COUNT = 8;
+
+OcclusionBuffer::OcclusionBuffer() {
+    erase();
+}
+
+void OcclusionBuffer::erase() {
+    std::fill(_depths, _depths + RESOLUTION * RESOLUTION, FLT_MAX);
+    std::fill(_tileDepths, _tileDepths + TILES_PER_SIDE * TILES_PER_SIDE, FLT_MAX);
+    _occluderCount = 0;
+    _occludedCount = 0;
+}
+
+// pixel i covers [i, i + 1) of a RESOLUTION wide screen, with -1 to 1 across it
+static inline float toPixels(float coordinate) {
+    return (coordinate + 1.0f) * 0.5f * OcclusionBuffer::RESOLUTION;
+}
+
+void OcclusionBuffer::addOccluder(const ViewFrustum& viewFrustum, const glm::vec3& center, float radius) {
+    float depth = glm::dot(center - viewFrustum.getOffsetPosition(), viewFrustum.getOffsetDirection());
+    if (radius <= 0.0f || depth - radius <= viewFrustum.getNearClip()) {
+        return;
+    }
+
+    // the circle through the sphere's center facing the viewer projects to an ellipse the sphere surely covers,
+    // the square inside that ellipse is what gets drawn
+    bool inView;
+    glm::vec2 projectedCenter = viewFrustum.projectPoint(center, inView);
+    glm::vec2 projectedRight = viewFrustum.projectPoint(center + radius * viewFrustum.getOffsetRight(), inView);
+    glm::vec2 projectedUp = viewFrustum.projectPoint(center + radius * viewFrustum.getOffsetUp(), inView);
+    float halfWidth = fabsf(projectedRight.x - projectedCenter.x) * HALF_SQRT_TWO;
+    float halfHeight = fabsf(projectedUp.y - projectedCenter.y) * HALF_SQRT_TWO;
+
+    // only pixels wholly inside the square
+    Rect rect;
+    rect.left = std::max(0, (int)ceilf(toPixels(projectedCenter.x - halfWidth)));
+    rect.bottom = std::max(0, (int)ceilf(toPixels(projectedCenter.y - halfHeight)));
+    rect.right = std::min(RESOLUTION, (int)floorf(toPixels(projectedCenter.x + halfWidth))) - 1;
+    rect.top = std::min(RESOLUTION, (int)floorf(toPixels(projectedCenter.y + halfHeight))) - 1;
+    if (rect.left > rect.right || rect.bottom > rect.top) {
+        return;
+    }
+
+    // anything past the back of the sphere is hidden behind it
+    float farDepth = depth + radius;
+    for (int y = rect.bottom; y <= rect.top; y++) {
+        float* row = _depths + y * RESOLUTION;
+        for (int x = rect.left; x <= rect.right; x++) {
+            row[x] = std::min(row[x], farDepth);
+        }
+    }
+
+    // the tiles touched take the farthest of their pixels
+    for (int tileY = rect.bottom / TILE_SIZE; tileY <= rect.top / TILE_SIZE; tileY++) {
+        for (int tileX = rect.left / TILE_SIZE; tileX <= rect.right / TILE_SIZE; tileX++) {
+            float tileDepth = 0.0f;
+            for (int y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; y++) {
+                const float* row = _depths + y * RESOLUTION + tileX * TILE_SIZE;
+                tileDepth = std::max(tileDepth, *std::max_element(row, row + TILE_SIZE));
+            }
+            _tileDepths[tileY * TILES_PER_SIDE + tileX] = tileDepth;
+        }
+    }
+    _occluderCount++;
+}
+
+bool OcclusionBuffer::isOccluded(const ViewFrustum& viewFrustum, const AACube& cube) {
+    if (_occluderCount == 0) {
+        return false;
+    }
+
+    // the screen bounds and nearest depth of the corners bound the whole cube
+    glm::vec2 minimum(FLT_MAX);
+    glm::vec2 maximum(-FLT_MAX);
+    float nearestDepth = FLT_MAX;
+    for (int i = 0; i < CUBE_VERTEX_COUNT; i++) {
+        glm::vec3 vertex = cube.getVertex((BoxVertex)i);
+        float depth = glm::dot(vertex - viewFrustum.getOffsetPosition(), viewFrustum.getOffsetDirection());
+        if (depth <= viewFrustum.getNearClip()) {
+            // reaching past the near plane, so not on the screen as a whole
+            return false;
+        }
+        bool inView;
+        glm::vec2 projected = viewFrustum.projectPoint(vertex, inView);
+        minimum = glm::min(minimum, projected);
+        maximum = glm::max(maximum, projected);
+        nearestDepth = std::min(nearestDepth, depth);
+    }
+
+    // every pixel the cube touches
+    Rect rect;
+    rect.left = std::max(0, (int)floorf(toPixels(minimum.x)));
+    rect.bottom = std::max(0, (int)floorf(toPixels(minimum.y)));
+    rect.right = std::min(RESOLUTION - 1, (int)floorf(toPixels(maximum.x)));
+    rect.top = std::min(RESOLUTION - 1, (int)floorf(toPixels(maximum.y)));
+    if (rect.left > rect.right || rect.bottom > rect.top) {
+        return false;
+    }
+
+    for (int tileY = rect.bottom / TILE_SIZE; tileY <= rect.top / TILE_SIZE; tileY++) {
+        for (int tileX = rect.left / TILE_SIZE; tileX <= rect.right / TILE_SIZE; tileX++) {
+            if (_tileDepths[tileY * TILES_PER_SIDE + tileX] < nearestDepth) {
+                // the whole tile is hidden in front of the cube
+                continue;
+            }
+            int bottom = std::max(rect.bottom, tileY * TILE_SIZE);
+            int top = std::min(rect.top, (tileY + 1) * TILE_SIZE - 1);
+            int left = std::max(rect.left, tileX * TILE_SIZE);
+            int right = std::min(rect.right, (tileX + 1) * TILE_SIZE - 1);
+            for (int y = bottom; y <= top; y++) {
+                const float* row = _depths + y * RESOLUTION;
+                for (int x = left; x <= right; x++) {
+                    if (row[x] >= nearestDepth) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    _occludedCount++;
+    return true;
+}
@@ -0,0 +1,60 @@
+//
+//  OcclusionBuffer.h
+//  libraries/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OcclusionBuffer_h
+#define hifi_OcclusionBuffer_h
+
+#include <glm/glm.hpp>
+
+#include <AACube.h>
+
+class ViewFrustum;
+
+/// A small software depth buffer of a node's view, used by the server to skip sending what is hidden behind solid
+/// content already sent. Occluders are drawn as the largest screen rectangle they are sure to cover at the farthest
+/// depth they could be, and elements are tested with the smallest rectangle and nearest depth that holds them, so an
+/// element is only ever reported occluded when it really is.
+class OcclusionBuffer {
+public:
+    static const int RESOLUTION = 64;
+    static const int TILE_SIZE = 8;
+    static const int TILES_PER_SIDE = RESOLUTION / TILE_SIZE;
+
+    OcclusionBuffer();
+
+    /// clears the buffer, call this whenever the view it was drawn from has moved
+    void erase();
+
+    /// draws a solid sphere, in meters, into the buffer
+    void addOccluder(const ViewFrustum& viewFrustum, const glm::vec3& center, float radius);
+
+    /// returns true if the whole of the cube, in meters, is behind what has been drawn
+    bool isOccluded(const ViewFrustum& viewFrustum, const AACube& cube);
+
+    /// the number of occluders drawn since the last erase
+    int getOccluderCount() const { return _occluderCount; }
+
+    /// the number of cubes found occluded since the last erase
+    int getOccludedCount() const { return _occludedCount; }
+
+private:
+    class Rect {
+    public:
+        int left, bottom, right, top; // inclusive pixel bounds
+    };
+
+    // the nearest depth known to be hidden at each pixel, and the farthest of those in each tile
+    float _depths[RESOLUTION * RESOLUTION];
+    float _tileDepths[TILES_PER_SIDE * TILES_PER_SIDE];
+    int _occluderCount;
+    int _occludedCount;
+};
+
+#endif // hifi_OcclusionBuffer_h
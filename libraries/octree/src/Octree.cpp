@@ -19,6 +19,7 @@
 #include <fstream> // to load voxels from file
 
 #include <QDebug>
+#include <QFile>
 #include <QVector>
 
 #include <GeometryUtil.h>
@@ -29,7 +30,8 @@
 #include <Shape.h>
 #include <ShapeCollider.h>
 
-#include "CoverageMap.h"
+#include "OcclusionBuffer.h"
+#include "OctreeSentIndex.h"
 #include "OctreeConstants.h"
 #include "OctreeElementBag.h"
 #include "Octree.h"
@@ -66,26 +68,31 @@ void Octree::recurseTreeWithPostOperation(RecurseOctreeOperation operation, void
     recurseElementWithPostOperation(_rootElement, operation, extraData);
 }
 
+void Octree::warnDangerouslyDeepRecursion(const char* caller) {
+    static QString repeatedMessage
+        = LogHandler::getInstance().addRepeatedMessageRegex(".* reached DANGEROUSLY_DEEP_RECURSION, bailing!");
+
+    qDebug() << caller << "reached DANGEROUSLY_DEEP_RECURSION, bailing!";
+}
+
+class RecurseOctreeOperationVisitor {
+public:
+    RecurseOctreeOperationVisitor(RecurseOctreeOperation operation, void* extraData) :
+        _operation(operation),
+        _extraData(extraData) { }
+
+    bool operator()(OctreeElement* element) { return _operation(element, _extraData); }
+
+private:
+    RecurseOctreeOperation _operation;
+    void* _extraData;
+};
+
 // Recurses voxel element with an operation function
 void Octree::recurseElementWithOperation(OctreeElement* element, RecurseOctreeOperation operation, void* extraData,
                         int recursionCount) {
-    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
-        static QString repeatedMessage
-            = LogHandler::getInstance().addRepeatedMessageRegex(
-                    "Octree::recurseElementWithOperation\\(\\) reached DANGEROUSLY_DEEP_RECURSION, bailing!");
-
-        qDebug() << "Octree::recurseElementWithOperation() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
-        return;
-    }
-
-    if (operation(element, extraData)) {
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-            OctreeElement* child = element->getChildAtIndex(i);
-            if (child) {
-                recurseElementWithOperation(child, operation, extraData, recursionCount+1);
-            }
-        }
-    }
+    RecurseOctreeOperationVisitor visitor(operation, extraData);
+    visitElementDepthFirst(element, visitor, recursionCount);
 }
 
 // Recurses voxel element with an operation function
@@ -1059,7 +1066,9 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
     }
 
     // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
-    if (params.viewFrustum && !element->isInView(*params.viewFrustum)) {
+    ViewFrustum::location locationThisView = params.viewFrustum ? element->inFrustum(*params.viewFrustum) :
+        ViewFrustum::INSIDE;
+    if (locationThisView == ViewFrustum::OUTSIDE) {
         params.stopReason = EncodeBitstreamParams::OUT_OF_VIEW;
         return bytesWritten;
     }
@@ -1091,6 +1100,9 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
     
     bytesWritten += codeLength; // keep track of byte count
 
+    // anything this subtree records as sent is forgotten again if the subtree is discarded
+    int sentIndexMark = params.sentIndex ? params.sentIndex->getPendingCount() : 0;
+
     int currentEncodeLevel = 0;
 
     // record some stats, this is the one element that we won't record below in the recursion function, so we need to
@@ -1099,10 +1111,9 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
         params.stats->traversed(element);
     }
 
-    ViewFrustum::location parentLocationThisView = ViewFrustum::INTERSECT; // assume parent is in view, but not fully
-
+    // the planes that the element is fully inside of are found along with its children's
     int childBytesWritten = encodeTreeBitstreamRecursion(element, packetData, bag, params,
-                                                            currentEncodeLevel, parentLocationThisView);
+                                                            currentEncodeLevel, locationThisView, 0);
 
 
     // if childBytesWritten == 1 then something went wrong... that's not possible
@@ -1126,6 +1137,9 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
 
     if (bytesWritten == 0) {
         packetData->discardSubTree();
+        if (params.sentIndex) {
+            params.sentIndex->discardPending(sentIndexMark);
+        }
     } else {
         packetData->endSubTree();
     }
@@ -1136,7 +1150,8 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
 int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                                             OctreePacketData* packetData, OctreeElementBag& bag,
                                             EncodeBitstreamParams& params, int& currentEncodeLevel,
-                                            const ViewFrustum::location& parentLocationThisView) const {
+                                            const ViewFrustum::location& locationThisView,
+                                            int insidePlanesThisView) const {
 
 
     const bool wantDebug = false;
@@ -1144,6 +1159,9 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
     // The append state of this level/element.
     OctreeElement::AppendState elementAppendState = OctreeElement::COMPLETED; // assume the best
 
+    // where this level's pending sent items start, in case the level gets discarded
+    int sentIndexMark = params.sentIndex ? params.sentIndex->getPendingCount() : 0;
+
     // How many bytes have we written so far at this level;
     int bytesAtThisLevel = 0;
 
@@ -1175,7 +1193,8 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         }
     }
     
-    ViewFrustum::location nodeLocationThisView = ViewFrustum::INSIDE; // assume we're inside
+    // our parent classified us along with our siblings
+    ViewFrustum::location nodeLocationThisView = params.viewFrustum ? locationThisView : ViewFrustum::INSIDE;
 
     // caller can pass NULL as viewFrustum if they want everything
     if (params.viewFrustum) {
@@ -1192,13 +1211,6 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
             return bytesAtThisLevel;
         }
 
-        // if the parent isn't known to be INSIDE, then it must be INTERSECT, and we should double check to see
-        // if we are INSIDE, INTERSECT, or OUTSIDE
-        if (parentLocationThisView != ViewFrustum::INSIDE) {
-            assert(parentLocationThisView != ViewFrustum::OUTSIDE); // we shouldn't be here if our parent was OUTSIDE!
-            nodeLocationThisView = element->inFrustum(*params.viewFrustum);
-        }
-
         // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
         // although technically, we really shouldn't ever be here, because our callers shouldn't be calling us if
         // we're out of view
@@ -1264,26 +1276,14 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         // If the user also asked for occlusion culling, check if this element is occluded, but only if it's not a leaf.
         // leaf occlusion is handled down below when we check child nodes
         if (params.wantOcclusionCulling && !element->isLeaf()) {
-            AACube voxelBox = element->getAACube();
-            voxelBox.scale(TREE_SCALE);
-            OctreeProjectedPolygon* voxelPolygon = new OctreeProjectedPolygon(params.viewFrustum->getProjectedPolygon(voxelBox));
-
-            // In order to check occlusion culling, the shadow has to be "all in view" otherwise, we will ignore occlusion
-            // culling and proceed as normal
-            if (voxelPolygon->getAllInView()) {
-                CoverageMapStorageResult result = params.map->checkMap(voxelPolygon, false);
-                delete voxelPolygon; // cleanup
-                if (result == OCCLUDED) {
-                    if (params.stats) {
-                        params.stats->skippedOccluded(element);
-                    }
-                    params.stopReason = EncodeBitstreamParams::OCCLUDED;
-                    return bytesAtThisLevel;
+            AACube elementCube = element->getAACube();
+            elementCube.scale(TREE_SCALE);
+            if (params.occlusionBuffer->isOccluded(*params.viewFrustum, elementCube)) {
+                if (params.stats) {
+                    params.stats->skippedOccluded(element);
                 }
-            } else {
-                // If this shadow wasn't "all in view" then we ignored it for occlusion culling, but
-                // we do need to clean up memory and proceed as normal...
-                delete voxelPolygon;
+                params.stopReason = EncodeBitstreamParams::OCCLUDED;
+                return bytesAtThisLevel;
             }
         }
     }
@@ -1370,18 +1370,30 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         }
     }
 
+    // if we only intersect the view, classify the children all at once, skipping the planes we're fully inside of,
+    // otherwise we're fully in view and so are ALL of them
+    QVector<ViewFrustum::location> childLocations(currentCount, ViewFrustum::INSIDE);
+    QVector<int> childInsidePlanes(currentCount, ViewFrustum::ALL_PLANES_INSIDE);
+    if (params.viewFrustum && nodeLocationThisView == ViewFrustum::INTERSECT) {
+        QVector<AABox> childBoxes(currentCount);
+        for (int i = 0; i < currentCount; i++) {
+            if (sortedChildren[i]) {
+                AACube cube = sortedChildren[i]->getAACube();
+                cube.scale(TREE_SCALE);
+                childBoxes[i] = AABox(cube);
+            }
+        }
+        childInsidePlanes.fill(insidePlanesThisView);
+        params.viewFrustum->classifyBoxes(childBoxes, childLocations, childInsidePlanes);
+    }
+
     // for each child element in Distance sorted order..., check to see if they exist, are colored, and in view, and if so
     // add them to our distance ordered array of children
     for (int i = 0; i < currentCount; i++) {
         OctreeElement* childElement = sortedChildren[i];
         int originalIndex = indexOfChildren[i];
 
-        bool childIsInView  = (childElement && 
-                ( !params.viewFrustum || // no view frustum was given, everything is assumed in view
-                  (nodeLocationThisView == ViewFrustum::INSIDE) || // parent was fully in view, we can assume ALL children are
-                  (nodeLocationThisView == ViewFrustum::INTERSECT && 
-                        childElement->isInView(*params.viewFrustum)) // the parent intersects and the child is in view
-                ));
+        bool childIsInView = (childElement && childLocations.at(i) != ViewFrustum::OUTSIDE);
 
         if (!childIsInView) {
             // must check childElement here, because it could be we got here because there was no childElement
@@ -1413,35 +1425,13 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 
                 bool childIsOccluded = false; // assume it's not occluded
 
-                // If the user also asked for occlusion culling, check if this element is occluded
-                if (params.wantOcclusionCulling && childElement->isLeaf()) {
-                    // Don't check occlusion here, just add them to our distance ordered array...
-
-                    AACube voxelBox = childElement->getAACube();
-                    voxelBox.scale(TREE_SCALE);
-                    OctreeProjectedPolygon* voxelPolygon = new OctreeProjectedPolygon(
-                                params.viewFrustum->getProjectedPolygon(voxelBox));
-
-                    // In order to check occlusion culling, the shadow has to be "all in view" otherwise, we ignore occlusion
-                    // culling and proceed as normal
-                    if (voxelPolygon->getAllInView()) {
-                        CoverageMapStorageResult result = params.map->checkMap(voxelPolygon, true);
-
-                        // In all cases where the shadow wasn't stored, we need to free our own memory.
-                        // In the case where it is stored, the CoverageMap will free memory for us later.
-                        if (result != STORED) {
-                            delete voxelPolygon;
-                        }
-
-                        // If while attempting to add this voxel's shadow, we determined it was occluded, then
-                        // we don't need to process it further and we can exit early.
-                        if (result == OCCLUDED) {
-                            childIsOccluded = true;
-                        }
-                    } else {
-                        delete voxelPolygon;
-                    }
-                } // wants occlusion culling & isLeaf()
+                // If the user also asked for occlusion culling, the children come nearest first, so anything solid
+                // in the nearer ones is already in the buffer by the time the farther ones are checked
+                if (params.wantOcclusionCulling) {
+                    AACube childCube = childElement->getAACube();
+                    childCube.scale(TREE_SCALE);
+                    childIsOccluded = params.occlusionBuffer->isOccluded(*params.viewFrustum, childCube);
+                } // wants occlusion culling
 
 
                 bool shouldRender = !params.viewFrustum
@@ -1465,6 +1455,11 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                 if (shouldRender && !childIsOccluded) {
                     bool childWasInView = false;
 
+                    // whatever is solid in this child is on the client, either now or from before
+                    if (params.wantOcclusionCulling) {
+                        childElement->addOccluders(*params.viewFrustum, *params.occlusionBuffer);
+                    }
+
                     if (childElement && params.deltaViewFrustum && params.lastViewFrustum) {
                         ViewFrustum::location location = childElement->inFrustum(*params.lastViewFrustum);
 
@@ -1546,6 +1541,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                     // written, but that the childElement needs to be reprocessed in an additional pass or passes
                     // to be completed.
                     LevelDetails childDataLevelKey = packetData->startLevel();
+                    int childSentIndexMark = params.sentIndex ? params.sentIndex->getPendingCount() : 0;
                     
                     OctreeElement::AppendState childAppendState = childElement->appendElementData(packetData, params);
                     
@@ -1569,6 +1565,9 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                         continueThisLevel = packetData->endLevel(childDataLevelKey);
                     } else {
                         packetData->discardLevel(childDataLevelKey);
+                        if (params.sentIndex) {
+                            params.sentIndex->discardPending(childSentIndexMark);
+                        }
                         elementAppendState = OctreeElement::PARTIAL;
                         params.stopReason = EncodeBitstreamParams::DIDNT_FIT;
                     }
@@ -1699,7 +1698,8 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                     // will be true. But if the tree has already been encoded, we will skip this.
                     if (element->shouldRecurseChildTree(originalIndex, params)) {
                         childTreeBytesOut = encodeTreeBitstreamRecursion(childElement, packetData, bag, params,
-                                                                                thisLevel, nodeLocationThisView);
+                                                                         thisLevel, childLocations.at(i),
+                                                                         childInsidePlanes.at(i));
                     } else {
                         childTreeBytesOut = 0;
                     }
@@ -1811,6 +1811,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         packetData->releaseReservedBytes(minimumRequiredRootDataBytes());
 
         LevelDetails rootDataLevelKey = packetData->startLevel();
+        int rootSentIndexMark = params.sentIndex ? params.sentIndex->getPendingCount() : 0;
         OctreeElement::AppendState rootAppendState = element->appendElementData(packetData, params);
         bool partOfRootFit = (rootAppendState != OctreeElement::NONE);
         bool allOfRootFit = (rootAppendState == OctreeElement::COMPLETED);
@@ -1822,6 +1823,9 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
             }
         } else {
             packetData->discardLevel(rootDataLevelKey);
+            if (params.sentIndex) {
+                params.sentIndex->discardPending(rootSentIndexMark);
+            }
         }
         
         if (!allOfRootFit) {
@@ -1855,6 +1859,9 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         continueThisLevel = packetData->endLevel(thisLevelKey);
     } else {
         packetData->discardLevel(thisLevelKey);
+        if (params.sentIndex) {
+            params.sentIndex->discardPending(sentIndexMark);
+        }
         
         if (!mustIncludeAllChildData()) {
             qDebug() << "WARNING UNEXPECTED CASE: Something failed in attempting to pack this element";
@@ -1905,17 +1912,22 @@ bool Octree::readFromSVOFile(const char* fileName) {
     bool fileOk = false;
 
     PacketVersion gotVersion = 0;
-    std::ifstream file(fileName, std::ios::in|std::ios::binary|std::ios::ate);
+    QFile file(fileName);
 
-    if(file.is_open()) {
+    if (file.open(QIODevice::ReadOnly)) {
         emit importSize(1.0f, 1.0f, 1.0f);
         emit importProgress(0);
 
         qDebug("Loading file %s...", fileName);
 
-        // get file length....
-        unsigned long fileLength = file.tellg();
-        file.seekg( 0, std::ios::beg );
+        // the buffers are parsed straight out of the mapped file, nothing is copied before it is read into the tree
+        unsigned long fileLength = file.size();
+        const unsigned char* fileData = fileLength > 0 ? file.map(0, fileLength) : NULL;
+        if (!fileData) {
+            qDebug() << "Unable to map file" << fileName << ":" << file.errorString();
+            emit importProgress(100);
+            return false;
+        }
         
         unsigned long headerLength = 0; // bytes in the header
         
@@ -1930,38 +1942,35 @@ bool Octree::readFromSVOFile(const char* fileName) {
 
             // read just enough of the file to parse the header...
             const unsigned long HEADER_LENGTH = sizeof(PacketType) + sizeof(PacketVersion);
-            unsigned char fileHeader[HEADER_LENGTH];
-            file.read((char*)&fileHeader, HEADER_LENGTH);
-            
             headerLength = HEADER_LENGTH; // we need this later to skip to the data
 
-            unsigned char* dataAt = (unsigned char*)&fileHeader;
-            unsigned long  dataLength = HEADER_LENGTH;
+            if (fileLength >= HEADER_LENGTH) {
+                const unsigned char* dataAt = fileData;
 
-            // if so, read the first byte of the file and see if it matches the expected version code
-            PacketType gotType;
-            memcpy(&gotType, dataAt, sizeof(gotType));
+                // if so, read the first byte of the file and see if it matches the expected version code
+                PacketType gotType;
+                memcpy(&gotType, dataAt, sizeof(gotType));
 
-            dataAt += sizeof(expectedType);
-            dataLength -= sizeof(expectedType);
-            gotVersion = *dataAt;
-            
-            if (gotType == expectedType) {
-                if (canProcessVersion(gotVersion)) {
-                    dataAt += sizeof(gotVersion);
-                    dataLength -= sizeof(gotVersion);
-                    fileOk = true;
-                    qDebug("SVO file version match. Expected: %d Got: %d", 
-                                versionForPacketType(expectedDataPacketType()), gotVersion);
-
-                    hasBufferBreaks = versionHasSVOfileBreaks(gotVersion);
+                dataAt += sizeof(expectedType);
+                gotVersion = *dataAt;
+                
+                if (gotType == expectedType) {
+                    if (canProcessVersion(gotVersion)) {
+                        fileOk = true;
+                        qDebug("SVO file version match. Expected: %d Got: %d", 
+                                    versionForPacketType(expectedDataPacketType()), gotVersion);
+
+                        hasBufferBreaks = versionHasSVOfileBreaks(gotVersion);
+                    } else {
+                        qDebug("SVO file version mismatch. Expected: %d Got: %d", 
+                                    versionForPacketType(expectedDataPacketType()), gotVersion);
+                    }
                 } else {
-                    qDebug("SVO file version mismatch. Expected: %d Got: %d", 
-                                versionForPacketType(expectedDataPacketType()), gotVersion);
+                    qDebug() << "SVO file type mismatch. Expected: " << nameForPacketType(expectedType) 
+                                << " Got: " << nameForPacketType(gotType);
                 }
             } else {
-                qDebug() << "SVO file type mismatch. Expected: " << nameForPacketType(expectedType) 
-                            << " Got: " << nameForPacketType(gotType);
+                qDebug() << "SVO file too short to hold its type and version:" << fileLength;
             }
 
         } else {
@@ -1976,34 +1985,25 @@ bool Octree::readFromSVOFile(const char* fileName) {
         }
 
         if (fileOk) {
+            const unsigned char* dataAt = fileData + headerLength;
+            unsigned long dataLength = fileLength - headerLength;
         
             // if this version of the file does not include buffer breaks, then we need to load the entire file at once
             if (!hasBufferBreaks) {
-            
-                // read the entire file into a buffer, WHAT!? Why not.
-                unsigned long dataLength = fileLength - headerLength;
-                unsigned char* entireFileDataSection = new unsigned char[dataLength];
-                file.read((char*)entireFileDataSection, dataLength);
-                unsigned char* dataAt = entireFileDataSection;
-            
                 ReadBitstreamToTreeParams args(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, 
                                                     SharedNodePointer(), wantImportProgress, gotVersion);
 
                 readBitstreamToTree(dataAt, dataLength, args);
-                delete[] entireFileDataSection;
 
             } else {
-
-                
-                unsigned long dataLength = fileLength - headerLength;
                 unsigned long remainingLength = dataLength;
                 const unsigned long MAX_CHUNK_LENGTH = MAX_OCTREE_PACKET_SIZE * 2;
-                unsigned char* fileChunk = new unsigned char[MAX_CHUNK_LENGTH];
                 
-                while (remainingLength > 0) {
+                while (remainingLength >= sizeof(quint16)) {
                     quint16 chunkLength = 0;
 
-                    file.read((char*)&chunkLength, sizeof(chunkLength)); // read the chunk size from the file
+                    memcpy(&chunkLength, dataAt, sizeof(chunkLength)); // read the chunk size from the file
+                    dataAt += sizeof(chunkLength);
                     remainingLength -= sizeof(chunkLength);
                     
                     if (chunkLength > remainingLength) {
@@ -2017,112 +2017,124 @@ bool Octree::readFromSVOFile(const char* fileName) {
                                     << "greater than MAX_CHUNK_LENGTH:" << MAX_CHUNK_LENGTH;
                         break;
                     }
-                    
-                    file.read((char*)fileChunk, chunkLength); // read in a section of the file larger than the chunk;
-
-                    remainingLength -= chunkLength;
-        
-                    unsigned char* dataAt = fileChunk;
-                    unsigned long  dataLength = chunkLength;
             
                     ReadBitstreamToTreeParams args(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, 
                                                         SharedNodePointer(), wantImportProgress, gotVersion);
 
-                    readBitstreamToTree(dataAt, dataLength, args);
-                }
+                    readBitstreamToTree(dataAt, chunkLength, args);
 
-                delete[] fileChunk;
+                    dataAt += chunkLength;
+                    remainingLength -= chunkLength;
+                }
             }
         }
 
         emit importProgress(100);
 
+        file.unmap(const_cast<unsigned char*>(fileData));
         file.close();
     }
     
     return fileOk;
 }
 
-void Octree::writeToSVOFile(const char* fileName, OctreeElement* element) {
-    std::ofstream file(fileName, std::ios::out|std::ios::binary);
+bool Octree::writeToSVOFile(const char* fileName, OctreeElement* element) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Unable to open file" << fileName << ":" << file.errorString();
+        return false;
+    }
+    qDebug("Saving to file %s...", fileName);
+    return writeToSVOStream(file, element);
+}
 
-    if(file.is_open()) {
-        qDebug("Saving to file %s...", fileName);
+// writes a finished buffer out, preceded by its size if the file has buffer breaks
+static bool writeSVOBuffer(QIODevice& device, const OctreePacketData& packetData, bool hasBufferBreaks) {
+    if (hasBufferBreaks) {
+        quint16 bufferSize = packetData.getFinalizedSize();
+        if (device.write((const char*)&bufferSize, sizeof(bufferSize)) != sizeof(bufferSize)) {
+            return false;
+        }
+    }
+    return device.write((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize()) ==
+        packetData.getFinalizedSize();
+}
 
-        PacketType expectedType = expectedDataPacketType();
-        PacketVersion expectedVersion = versionForPacketType(expectedType);
-        bool hasBufferBreaks = versionHasSVOfileBreaks(expectedVersion);
+bool Octree::writeToSVOStream(QIODevice& device, OctreeElement* element) {
+    PacketType expectedType = expectedDataPacketType();
+    PacketVersion expectedVersion = versionForPacketType(expectedType);
+    bool hasBufferBreaks = versionHasSVOfileBreaks(expectedVersion);
+
+    // before writing the buffer, check to see if this version of the Octree supports file versions
+    if (getWantSVOfileVersions()) {
+        // if so, start the stream with the type and version code
+        if (device.write(reinterpret_cast<char*>(&expectedType), sizeof(expectedType)) != sizeof(expectedType) ||
+                device.write(reinterpret_cast<char*>(&expectedVersion), sizeof(expectedVersion)) !=
+                    sizeof(expectedVersion)) {
+            qDebug() << "Unable to write the SVO header:" << device.errorString();
+            return false;
+        }
+        qDebug() << "SVO file type: " << nameForPacketType(expectedType) << " version: " << (int)expectedVersion;
 
-        // before reading the file, check to see if this version of the Octree supports file versions
-        if (getWantSVOfileVersions()) {
-            // if so, read the first byte of the file and see if it matches the expected version code
-            file.write(reinterpret_cast<char*>(&expectedType), sizeof(expectedType));
-            file.write(&expectedVersion, sizeof(expectedVersion));
-            qDebug() << "SVO file type: " << nameForPacketType(expectedType) << " version: " << (int)expectedVersion;
+        hasBufferBreaks = versionHasSVOfileBreaks(expectedVersion);
+    }
+    if (hasBufferBreaks) {
+        qDebug() << "    this version includes buffer breaks";
+    } else {
+        qDebug() << "    this version does not include buffer breaks";
+    }
+    
 
-            hasBufferBreaks = versionHasSVOfileBreaks(expectedVersion);
-        }
-        if (hasBufferBreaks) {
-            qDebug() << "    this version includes buffer breaks";
-        } else {
-            qDebug() << "    this version does not include buffer breaks";
-        }
-        
+    OctreeElementBag elementBag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    // If we were given a specific element, start from there, otherwise start from root
+    if (element) {
+        elementBag.insert(element);
+    } else {
+        elementBag.insert(_rootElement);
+    }
 
-        OctreeElementBag elementBag;
-        OctreeElementExtraEncodeData extraEncodeData;
-        // If we were given a specific element, start from there, otherwise start from root
-        if (element) {
-            elementBag.insert(element);
-        } else {
-            elementBag.insert(_rootElement);
-        }
+    OctreePacketData packetData;
+    int bytesWritten = 0;
+    bool lastPacketWritten = false;
+    bool writeOk = true;
 
-        OctreePacketData packetData;
-        int bytesWritten = 0;
-        bool lastPacketWritten = false;
+    // each buffer goes out as soon as it's full, so only the one being encoded is held, and the device is written to
+    // outside the tree's lock
+    while (writeOk && !elementBag.isEmpty()) {
+        OctreeElement* subTree = elementBag.extract();
+        
+        lockForRead(); // do tree locking down here so that we have shorter slices and less thread contention
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, NO_EXISTS_BITS);
+        params.extraEncodeData = &extraEncodeData;
+        bytesWritten = encodeTreeBitstream(subTree, &packetData, elementBag, params);
+        unlock();
 
-        while (!elementBag.isEmpty()) {
-            OctreeElement* subTree = elementBag.extract();
-            
-            lockForRead(); // do tree locking down here so that we have shorter slices and less thread contention
-            EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, NO_EXISTS_BITS);
-            params.extraEncodeData = &extraEncodeData;
-            bytesWritten = encodeTreeBitstream(subTree, &packetData, elementBag, params);
-            unlock();
-
-            // if the subTree couldn't fit, and so we should reset the packet and reinsert the element in our bag and try again
-            if (bytesWritten == 0 && (params.stopReason == EncodeBitstreamParams::DIDNT_FIT)) {
-                if (packetData.hasContent()) {
-                    // if this type of SVO file should have buffer breaks, then we will write a buffer size before each
-                    // buffer to allow the reader to read this file in chunks.
-                    if (hasBufferBreaks) {
-                        quint16 bufferSize = packetData.getFinalizedSize();
-                        file.write((const char*)&bufferSize, sizeof(bufferSize));
-                    }
-                    file.write((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize());
-                    lastPacketWritten = true;
-                }
-                packetData.reset(); // is there a better way to do this? could we fit more?
-                elementBag.insert(subTree);
-            } else {
-                lastPacketWritten = false;
+        // if the subTree couldn't fit, and so we should reset the packet and reinsert the element in our bag and try again
+        if (bytesWritten == 0 && (params.stopReason == EncodeBitstreamParams::DIDNT_FIT)) {
+            if (packetData.hasContent()) {
+                // if this type of SVO file should have buffer breaks, then we will write a buffer size before each
+                // buffer to allow the reader to read this file in chunks.
+                writeOk = writeSVOBuffer(device, packetData, hasBufferBreaks);
+                lastPacketWritten = true;
             }
+            packetData.reset(); // is there a better way to do this? could we fit more?
+            elementBag.insert(subTree);
+        } else {
+            lastPacketWritten = false;
         }
+    }
 
-        if (!lastPacketWritten) {
-            // if this type of SVO file should have buffer breaks, then we will write a buffer size before each
-            // buffer to allow the reader to read this file in chunks.
-            if (hasBufferBreaks) {
-                quint16 bufferSize = packetData.getFinalizedSize();
-                file.write((const char*)&bufferSize, sizeof(bufferSize));
-            }
-            file.write((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize());
-        }
-        
-        releaseSceneEncodeData(&extraEncodeData);
+    if (writeOk && !lastPacketWritten) {
+        writeOk = writeSVOBuffer(device, packetData, hasBufferBreaks);
+    }
+    
+    releaseSceneEncodeData(&extraEncodeData);
+
+    if (!writeOk) {
+        qDebug() << "Unable to write the SVO data:" << device.errorString();
     }
-    file.close();
+    return writeOk;
 }
 
 unsigned long Octree::getOctreeElementsCount() {
@@ -2159,6 +2171,7 @@ void Octree::copySubTreeIntoNewTree(OctreeElement* startElement, Octree* destina
         ReadBitstreamToTreeParams args(WANT_COLOR, NO_EXISTS_BITS);
         destinationTree->readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
     }
+    releaseSceneEncodeData(&extraEncodeData);
 }
 
 void Octree::copyFromTreeIntoSubTree(Octree* sourceTree, OctreeElement* destinationElement) {
@@ -2186,6 +2199,7 @@ void Octree::copyFromTreeIntoSubTree(Octree* sourceTree, OctreeElement* destinat
                                             0, SharedNodePointer(), wantImportProgress);
         readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
     }
+    sourceTree->releaseSceneEncodeData(&extraEncodeData);
 }
 
 void Octree::cancelImport() {
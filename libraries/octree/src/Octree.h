@@ -15,13 +15,15 @@
 #include <set>
 #include <SimpleMovingAverage.h>
 
-class CoverageMap;
+class OcclusionBuffer;
+class OctreeSentIndex;
 class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
 class OctreeElementBag;
 class OctreePacketData;
 class Shape;
+class QIODevice;
 
 
 #include "JurisdictionMap.h"
@@ -64,7 +66,7 @@ const quint64 IGNORE_LAST_SENT  = 0;
 
 #define IGNORE_SCENE_STATS       NULL
 #define IGNORE_VIEW_FRUSTUM      NULL
-#define IGNORE_COVERAGE_MAP      NULL
+#define IGNORE_OCCLUSION_BUFFER  NULL
 #define IGNORE_JURISDICTION_MAP  NULL
 
 class EncodeBitstreamParams {
@@ -83,9 +85,10 @@ public:
     quint64 lastViewFrustumSent;
     bool forceSendScene;
     OctreeSceneStats* stats;
-    CoverageMap* map;
+    OcclusionBuffer* occlusionBuffer;
     JurisdictionMap* jurisdictionMap;
     OctreeElementExtraEncodeData* extraEncodeData;
+    OctreeSentIndex* sentIndex; // what the receiving client already has, NULL to encode everything
 
     // output hints from the encode process
     typedef enum {
@@ -111,14 +114,15 @@ public:
         bool deltaViewFrustum = false,
         const ViewFrustum* lastViewFrustum = IGNORE_VIEW_FRUSTUM,
         bool wantOcclusionCulling = NO_OCCLUSION_CULLING,
-        CoverageMap* map = IGNORE_COVERAGE_MAP,
+        OcclusionBuffer* occlusionBuffer = IGNORE_OCCLUSION_BUFFER,
         int boundaryLevelAdjust = NO_BOUNDARY_ADJUST,
         float octreeElementSizeScale = DEFAULT_OCTREE_SIZE_SCALE,
         quint64 lastViewFrustumSent = IGNORE_LAST_SENT,
         bool forceSendScene = true,
         OctreeSceneStats* stats = IGNORE_SCENE_STATS,
         JurisdictionMap* jurisdictionMap = IGNORE_JURISDICTION_MAP,
-        OctreeElementExtraEncodeData* extraEncodeData = NULL) :
+        OctreeElementExtraEncodeData* extraEncodeData = NULL,
+        OctreeSentIndex* sentIndex = NULL) :
             maxEncodeLevel(maxEncodeLevel),
             maxLevelReached(0),
             viewFrustum(viewFrustum),
@@ -133,9 +137,10 @@ public:
             lastViewFrustumSent(lastViewFrustumSent),
             forceSendScene(forceSendScene),
             stats(stats),
-            map(map),
+            occlusionBuffer(occlusionBuffer),
             jurisdictionMap(jurisdictionMap),
             extraEncodeData(extraEncodeData),
+            sentIndex(sentIndex),
             stopReason(UNKNOWN)
     {}
 
@@ -211,6 +216,12 @@ public:
     {}
 };
 
+/// An edit read out of an edit packet by Octree::decodeEditPacketData(), waiting to be applied to the tree
+class OctreeDecodedEdit {
+public:
+    virtual ~OctreeDecodedEdit() { }
+};
+
 class Octree : public QObject {
     Q_OBJECT
 public:
@@ -230,12 +241,35 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(PacketType packetType, const unsigned char* packetData, int packetLength,
                     const unsigned char* editData, int maxLength, const SharedNodePointer& sourceNode) { return 0; }
+
+    // Trees that can parse an edit without touching the tree implement these as well, so that the OctreeServer parses a
+    // packet's edits before it takes the tree's write lock and then holds the lock only while they are applied.
+    // decodeEditPacketData() returns false for the types it can't decode ahead, those go to processEditPacketData(),
+    // decodedEdit is left NULL for an edit that was read but has nothing to apply.
+    virtual bool decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                      int& processedBytes, OctreeDecodedEdit*& decodedEdit) { return false; }
+    virtual void applyDecodedEdit(const OctreeDecodedEdit* decodedEdit, const SharedNodePointer& senderNode) { }
+
+    // Every decoded edit is handed back here once it's been applied or superseded, a tree may keep it to decode a
+    // later edit into rather than allocating a new one.
+    virtual void releaseDecodedEdit(OctreeDecodedEdit* decodedEdit) { delete decodedEdit; }
+
+    // The OctreeServer applies the decoded edits of several packets together, edits to the same item are found by
+    // getDecodedEditItemID() and a later one that leaves nothing of an earlier one standing replaces it in the batch.
+    // A null ID means the edit is never coalesced.
+    virtual QUuid getDecodedEditItemID(const OctreeDecodedEdit* decodedEdit) const { return QUuid(); }
+    virtual bool decodedEditSupersedes(const OctreeDecodedEdit* laterEdit,
+                                       const OctreeDecodedEdit* earlierEdit) const { return false; }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
     virtual int minimumRequiredRootDataBytes() const { return 0; }
     virtual bool suppressEmptySubtrees() const { return true; }
     virtual void releaseSceneEncodeData(OctreeElementExtraEncodeData* extraEncodeData) const { }
+
+    /// Called by the server with the tree's read lock held before it starts encoding a full scene for a node, trees
+    /// that can do some of that work up front on several threads do it here.
+    virtual void prepareFullSceneEncode() { }
     virtual bool mustIncludeAllChildData() const { return true; }
     
     /// some versions of the SVO file will include breaks with buffer lengths between each buffer chunk in the SVO
@@ -275,6 +309,15 @@ public:
 
     void recurseTreeWithOperator(RecurseOctreeOperator* operatorObject);
 
+    /// Visits the tree depth first in the order recurseTreeWithOperation() does, with an explicit stack instead of
+    /// recursion. visitor is called with each OctreeElement* and returns true to have that element's children visited.
+    /// The visitor is a template parameter so it is called directly, without a function pointer or virtual per element.
+    template <typename Visitor>
+    void visitTreeDepthFirst(Visitor& visitor) { visitElementDepthFirst(_rootElement, visitor); }
+
+    template <typename Visitor>
+    static void visitElementDepthFirst(OctreeElement* element, Visitor& visitor, int depth = 0);
+
     int encodeTreeBitstream(OctreeElement* element, OctreePacketData* packetData, OctreeElementBag& bag,
                             EncodeBitstreamParams& params) ;
                             
@@ -320,7 +363,11 @@ public:
     void loadOctreeFile(const char* fileName, bool wantColorRandomizer);
 
     // these will read/write files that match the wireformat, excluding the 'V' leading
-    void writeToSVOFile(const char* filename, OctreeElement* element = NULL);
+    bool writeToSVOFile(const char* filename, OctreeElement* element = NULL);
+
+    /// Writes the same contents writeToSVOFile() does to the device, one buffer at a time as each is encoded, taking
+    /// the tree's read lock only for the encoding.  Returns false if the device couldn't take all of it.
+    bool writeToSVOStream(QIODevice& device, OctreeElement* element = NULL);
     bool readFromSVOFile(const char* filename);
     
 
@@ -347,6 +394,8 @@ public:
     bool getIsViewing() const { return _isViewing; } /// This tree is receiving inbound viewer datagrams.
     void setIsViewing(bool isViewing) { _isViewing = isViewing; }
 
+    static void warnDangerouslyDeepRecursion(const char* caller);
+
     bool getIsServer() const { return _isServer; } /// Is this a server based tree. Allows guards for certain operations
     void setIsServer(bool isServer) { _isServer = isServer; }
 
@@ -370,7 +419,7 @@ protected:
     int encodeTreeBitstreamRecursion(OctreeElement* element,
                                      OctreePacketData* packetData, OctreeElementBag& bag,
                                      EncodeBitstreamParams& params, int& currentEncodeLevel,
-                                     const ViewFrustum::location& parentLocationThisView) const;
+                                     const ViewFrustum::location& locationThisView, int insidePlanesThisView) const;
 
     static bool countOctreeElementsOperation(OctreeElement* element, void* extraData);
 
@@ -391,6 +440,51 @@ protected:
     bool _isServer;
 };
 
+template <typename Visitor>
+void Octree::visitElementDepthFirst(OctreeElement* element, Visitor& visitor, int depth) {
+    class StackEntry {
+    public:
+        OctreeElement* element;
+        int depth;
+    };
+
+    // children are pushed last to first so they come off in child order. Every level above the one being visited holds
+    // at most NUMBER_OF_CHILDREN - 1 siblings still waiting their turn.
+    const int MAX_STACK_ENTRIES = DANGEROUSLY_DEEP_RECURSION * (NUMBER_OF_CHILDREN - 1) + NUMBER_OF_CHILDREN + 1;
+    StackEntry stack[MAX_STACK_ENTRIES];
+    int stackSize = 0;
+
+    stack[stackSize].element = element;
+    stack[stackSize].depth = depth;
+    stackSize++;
+
+    while (stackSize > 0) {
+        stackSize--;
+        OctreeElement* current = stack[stackSize].element;
+        int currentDepth = stack[stackSize].depth;
+
+        if (!visitor(current)) {
+            continue;
+        }
+
+        if (currentDepth >= DANGEROUSLY_DEEP_RECURSION) {
+            if (current->getChildCount() > 0) {
+                warnDangerouslyDeepRecursion("Octree::visitElementDepthFirst()");
+            }
+            continue;
+        }
+
+        for (int i = NUMBER_OF_CHILDREN - 1; i >= 0; i--) {
+            OctreeElement* child = current->getChildAtIndex(i);
+            if (child) {
+                stack[stackSize].element = child;
+                stack[stackSize].depth = currentDepth + 1;
+                stackSize++;
+            }
+        }
+    }
+}
+
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale);
 
 #endif // hifi_Octree_h
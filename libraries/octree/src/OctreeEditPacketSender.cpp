@@ -19,6 +19,11 @@
 
 const int OctreeEditPacketSender::DEFAULT_MAX_PENDING_MESSAGES = PacketSender::DEFAULT_PACKETS_PER_SECOND;
 
+// a few frames of a script's edits, which is about what we'd send for them anyway at the default packets per second
+const quint64 OctreeEditPacketSender::DEFAULT_MAX_BATCH_DELAY_USECS = 50 * 1000;
+
+const int AVERAGE_BATCHING_TIME_SAMPLES = 100;
+
 
 OctreeEditPacketSender::OctreeEditPacketSender() :
     PacketSender(),
@@ -27,6 +32,8 @@ OctreeEditPacketSender::OctreeEditPacketSender() :
     _releaseQueuedMessagesPending(false),
     _serverJurisdictions(NULL),
     _maxPacketSize(MAX_PACKET_SIZE),
+    _maxBatchDelayUsecs(DEFAULT_MAX_BATCH_DELAY_USECS),
+    _averageBatchingTime(AVERAGE_BATCHING_TIME_SAMPLES),
     _destinationWalletUUID()
 {
     
@@ -82,7 +89,7 @@ bool OctreeEditPacketSender::serversExist() const {
 // This method is called when the edit packet layer has determined that it has a fully formed packet destined for
 // a known nodeID.
 void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, unsigned char* buffer,
-                                               size_t length, qint64 satoshiCost) {
+                                               size_t length, qint64 satoshiCost, bool highPriority) {
 
     bool wantDebug = false;
     DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node){
@@ -100,7 +107,7 @@ void OctreeEditPacketSender::queuePacketToNode(const QUuid& nodeUUID, unsigned c
             // send packet
             QByteArray packet(reinterpret_cast<const char*>(buffer), length);
             
-            queuePacketForSending(node, packet);
+            queuePacketForSending(node, packet, highPriority);
             
             if (hasDestinationWalletUUID() && satoshiCost > 0) {
                 // if we have a destination wallet UUID and a cost associated with this packet, signal that it
@@ -201,7 +208,7 @@ void OctreeEditPacketSender::queuePacketToNodes(unsigned char* buffer, size_t le
             // here we need to get the "pending packet" for this server
             _serverJurisdictions->lockForRead();
             const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-            isMyJurisdiction = (map.isMyJurisdiction(octCode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+            isMyJurisdiction = (map.isMyJurisdiction(octCode, CHECK_NODE_ONLY) != JurisdictionMap::BELOW);
             _serverJurisdictions->unlock();
             if (isMyJurisdiction) {
                 queuePacketToNode(nodeUUID, buffer, length, satoshiCost);
@@ -213,7 +220,7 @@ void OctreeEditPacketSender::queuePacketToNodes(unsigned char* buffer, size_t le
 
 // NOTE: editPacketBuffer - is JUST the octcode/color and does not contain the packet header!
 void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, unsigned char* editPacketBuffer,
-                                                    size_t length, qint64 satoshiCost) {
+                                                    size_t length, qint64 satoshiCost, bool isInteractive) {
 
     if (!_shouldSend) {
         return; // bail early
@@ -257,9 +264,10 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, unsigned ch
                 // we need to get the jurisdiction for this
                 // here we need to get the "pending packet" for this server
                 _serverJurisdictions->lockForRead();
+                // a message whose octcode is above the server's root may touch what the server has, so it goes too
                 if ((*_serverJurisdictions).find(nodeUUID) != (*_serverJurisdictions).end()) {
                     const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-                    isMyJurisdiction = (map.isMyJurisdiction(editPacketBuffer, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+                    isMyJurisdiction = (map.isMyJurisdiction(editPacketBuffer, CHECK_NODE_ONLY) != JurisdictionMap::BELOW);
                 } else {
                     isMyJurisdiction = false;
                 }
@@ -292,6 +300,10 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, unsigned ch
                 memcpy(&packetBuffer._currentBuffer[packetBuffer._currentSize], editPacketBuffer, length);
                 packetBuffer._currentSize += length;
                 packetBuffer._satoshiCost += satoshiCost;
+                if (packetBuffer._messageCount++ == 0) {
+                    packetBuffer._firstMessageAt = usecTimestampNow();
+                }
+                packetBuffer._isInteractive = packetBuffer._isInteractive || isInteractive;
             }
         }
     });
@@ -315,13 +327,46 @@ void OctreeEditPacketSender::releaseQueuedMessages() {
     }
 }
 
+void OctreeEditPacketSender::releaseStaleQueuedMessages() {
+    if (!serversExist()) {
+        // nothing can go anywhere yet, so this is no different from a full release
+        _releaseQueuedMessagesPending = true;
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    _packetsQueueLock.lock();
+    for (QHash<QUuid, EditPacketBuffer>::iterator i = _pendingEditPackets.begin(); i != _pendingEditPackets.end(); i++) {
+        EditPacketBuffer& packetBuffer = i.value();
+        if (packetBuffer._isInteractive || now - packetBuffer._firstMessageAt >= _maxBatchDelayUsecs) {
+            releaseQueuedPacket(packetBuffer);
+        }
+    }
+    _packetsQueueLock.unlock();
+}
+
+int OctreeEditPacketSender::getPendingEditMessageCount() {
+    int pendingMessages = 0;
+    _packetsQueueLock.lock();
+    foreach (const EditPacketBuffer& packetBuffer, _pendingEditPackets) {
+        pendingMessages += packetBuffer._messageCount;
+    }
+    _packetsQueueLock.unlock();
+    return pendingMessages;
+}
+
 void OctreeEditPacketSender::releaseQueuedPacket(EditPacketBuffer& packetBuffer) {
     _releaseQueuedPacketMutex.lock();
     if (packetBuffer._currentSize > 0 && packetBuffer._currentType != PacketTypeUnknown) {
+        if (packetBuffer._messageCount > 0) {
+            _averageBatchingTime.updateAverage(usecTimestampNow() - packetBuffer._firstMessageAt);
+        }
         queuePacketToNode(packetBuffer._nodeUUID, &packetBuffer._currentBuffer[0],
-                          packetBuffer._currentSize, packetBuffer._satoshiCost);
+                          packetBuffer._currentSize, packetBuffer._satoshiCost, packetBuffer._isInteractive);
         packetBuffer._currentSize = 0;
         packetBuffer._currentType = PacketTypeUnknown;
+        packetBuffer._messageCount = 0;
+        packetBuffer._isInteractive = false;
     }
     _releaseQueuedPacketMutex.unlock();
 }
@@ -342,6 +387,9 @@ void OctreeEditPacketSender::initializePacket(EditPacketBuffer& packetBuffer, Pa
     
     // reset cost for packet to 0
     packetBuffer._satoshiCost = 0;
+
+    packetBuffer._messageCount = 0;
+    packetBuffer._isInteractive = false;
 }
 
 bool OctreeEditPacketSender::process() {
@@ -29,8 +29,10 @@ public:
     
     /// Queues a single edit message. Will potentially send a pending multi-command packet. Determines which server
     /// node or nodes the packet should be sent to. Can be called even before servers are known, in which case up to 
-    /// MaxPendingMessages will be buffered and processed when servers are known.
-    void queueOctreeEditMessage(PacketType type, unsigned char* buffer, size_t length, qint64 satoshiCost = 0);
+    /// MaxPendingMessages will be buffered and processed when servers are known. An interactive message, like one
+    /// following the user's hand, doesn't wait for its packet to fill and goes ahead of the other packets to send.
+    void queueOctreeEditMessage(PacketType type, unsigned char* buffer, size_t length, qint64 satoshiCost = 0,
+                                bool isInteractive = false);
 
     /// Releases all queued messages even if those messages haven't filled an MTU packet. This will move the packed message 
     /// packets onto the send queue. If running in threaded mode, the caller does not need to do any further processing to
@@ -40,6 +42,25 @@ public:
     /// servers are known.
     void releaseQueuedMessages();
 
+    /// Releases the queued messages that have waited longer than the max batch delay, or that hold an interactive
+    /// message, and leaves the others to keep filling their packets. Meant to be called every frame by a caller making
+    /// many edits, which would otherwise send a small packet a frame. Like releaseQueuedMessages() this only
+    /// moves packets onto the send queue.
+    void releaseStaleQueuedMessages();
+
+    /// Sets how long releaseStaleQueuedMessages() lets a packet of messages wait to be filled, 0 releases them all
+    void setMaxBatchDelay(quint64 maxBatchDelayUsecs) { _maxBatchDelayUsecs = maxBatchDelayUsecs; }
+    quint64 getMaxBatchDelay() const { return _maxBatchDelayUsecs; }
+
+    // the default time a packet of edit messages may wait to be filled
+    static const quint64 DEFAULT_MAX_BATCH_DELAY_USECS;
+
+    /// how many edit messages are packed in packets that haven't been released to the send queue yet
+    int getPendingEditMessageCount();
+
+    /// returns the average time in usecs recent edit messages waited to be released, not counting the send queue
+    float getAverageBatchingUsecs() const { return _averageBatchingTime.getAverage(); }
+
     /// are we in sending mode. If we're not in sending mode then all packets and messages will be ignored and
     /// not queued and not sent
     bool getShouldSend() const { return _shouldSend; }
@@ -98,7 +119,8 @@ signals:
     
 protected:
     bool _shouldSend;
-    void queuePacketToNode(const QUuid& nodeID, unsigned char* buffer, size_t length, qint64 satoshiCost = 0);
+    void queuePacketToNode(const QUuid& nodeID, unsigned char* buffer, size_t length, qint64 satoshiCost = 0,
+                           bool highPriority = false);
     void queuePendingPacketToNodes(PacketType type, unsigned char* buffer, size_t length, qint64 satoshiCost = 0);
     void queuePacketToNodes(unsigned char* buffer, size_t length, qint64 satoshiCost = 0);
     void initializePacket(EditPacketBuffer& packetBuffer, PacketType type, int nodeClockSkew);
@@ -120,6 +142,8 @@ protected:
     NodeToJurisdictionMap* _serverJurisdictions;
     
     int _maxPacketSize;
+    quint64 _maxBatchDelayUsecs;
+    SimpleMovingAverage _averageBatchingTime;
 
     QMutex _releaseQueuedPacketMutex;
 
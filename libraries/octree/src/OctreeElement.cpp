@@ -29,9 +29,10 @@
 #include "Octree.h"
 #include "SharedUtil.h"
 
-quint64 OctreeElement::_octreeMemoryUsage = 0;
-quint64 OctreeElement::_octcodeMemoryUsage = 0;
-quint64 OctreeElement::_externalChildrenMemoryUsage = 0;
+MemoryCounter& OctreeElement::_octreeMemory = MemoryTracker::getInstance().getCounter("Octree elements");
+MemoryCounter& OctreeElement::_octcodeMemory = MemoryTracker::getInstance().getCounter("Octree octal codes");
+MemoryCounter& OctreeElement::_externalChildrenMemory =
+    MemoryTracker::getInstance().getCounter("Octree external children");
 quint64 OctreeElement::_voxelNodeCount = 0;
 quint64 OctreeElement::_voxelNodeLeafCount = 0;
 
@@ -59,7 +60,7 @@ void OctreeElement::init(unsigned char * octalCode) {
     if (octalCodeLength > sizeof(_octalCode)) {
         _octalCode.pointer = octalCode;
         _octcodePointer = true;
-        _octcodeMemoryUsage += octalCodeLength;
+        _octcodeMemory.addCPUBytes(octalCodeLength);
     } else {
         _octcodePointer = false;
         memcpy(_octalCode.buffer, octalCode, octalCodeLength);
@@ -109,7 +110,8 @@ OctreeElement::~OctreeElement() {
     }
 
     if (_octcodePointer) {
-        _octcodeMemoryUsage -= bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(getOctalCode()));
+        _octcodeMemory.removeCPUBytes(
+            bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(getOctalCode())));
         delete[] _octalCode.pointer;
     }
 
@@ -117,6 +119,14 @@ OctreeElement::~OctreeElement() {
     deleteAllChildren();
 }
 
+void* OctreeElement::operator new(size_t size) {
+    return SlabAllocator::allocate(size);
+}
+
+void OctreeElement::operator delete(void* element, size_t size) {
+    SlabAllocator::free(element, size);
+}
+
 void OctreeElement::markWithChangedTime() {
     _lastChanged = usecTimestampNow();
     notifyUpdateHooks(); // if the node has changed, notify our hooks
@@ -195,14 +205,10 @@ void OctreeElement::setShouldRender(bool shouldRender) {
 }
 
 void OctreeElement::calculateAACube() {
-    glm::vec3 corner;
-
-    // copy corner into cube
-    copyFirstVertexForCode(getOctalCode(),(float*)&corner);
-
-    // this tells you the "size" of the voxel
-    float voxelScale = 1 / powf(2, numberOfThreeBitSectionsInCode(getOctalCode()));
-    _cube.setBox(corner,voxelScale);
+    // the corner and the "size" of the voxel, in one pass over the code
+    VoxelPositionSize voxelDetails;
+    voxelDetailsForCode(getOctalCode(), voxelDetails);
+    _cube.setBox(glm::vec3(voxelDetails.x, voxelDetails.y, voxelDetails.z), voxelDetails.s);
 }
 
 void OctreeElement::deleteChildAtIndex(int childIndex) {
@@ -469,7 +475,7 @@ void OctreeElement::storeTwoChildren(OctreeElement* childOne, OctreeElement* chi
         if (_childrenExternal) {
             //assert(_children.external);
             const int previousChildCount = 2;
-            _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElement*);
+            _externalChildrenMemory.removeCPUBytes(previousChildCount * sizeof(OctreeElement*));
             delete[] _children.external;
             _children.external = NULL; // probably not needed!
             _childrenExternal = false;
@@ -487,7 +493,7 @@ void OctreeElement::storeTwoChildren(OctreeElement* childOne, OctreeElement* chi
         if (!_childrenExternal) {
             _childrenExternal = true;
             const int newChildCount = 2;
-            _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElement*);
+            _externalChildrenMemory.addCPUBytes(newChildCount * sizeof(OctreeElement*));
             _children.external = new OctreeElement*[newChildCount];
             memset(_children.external, 0, sizeof(OctreeElement*) * newChildCount);
         }
@@ -507,7 +513,7 @@ void OctreeElement::retrieveTwoChildren(OctreeElement*& childOne, OctreeElement*
         _childrenExternal = false;
         _twoChildrenExternalCount--;
         const int newChildCount = 2;
-        _externalChildrenMemoryUsage -= newChildCount * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(newChildCount * sizeof(OctreeElement*));
     } else {
         int64_t offsetOne = _children.offsetsTwoChildren[0];
         int64_t offsetTwo = _children.offsetsTwoChildren[1];
@@ -586,7 +592,7 @@ void OctreeElement::storeThreeChildren(OctreeElement* childOne, OctreeElement* c
             _children.external = NULL; // probably not needed!
             _childrenExternal = false;
             const int previousChildCount = 3;
-            _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElement*);
+            _externalChildrenMemory.removeCPUBytes(previousChildCount * sizeof(OctreeElement*));
         }
         // encode in union
         encodeThreeOffsets(offsetOne, offsetTwo, offsetThree);
@@ -598,7 +604,7 @@ void OctreeElement::storeThreeChildren(OctreeElement* childOne, OctreeElement* c
         if (!_childrenExternal) {
             _childrenExternal = true;
             const int newChildCount = 3;
-            _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElement*);
+            _externalChildrenMemory.addCPUBytes(newChildCount * sizeof(OctreeElement*));
             _children.external = new OctreeElement*[newChildCount];
             memset(_children.external, 0, sizeof(OctreeElement*) * newChildCount);
         }
@@ -619,7 +625,7 @@ void OctreeElement::retrieveThreeChildren(OctreeElement*& childOne, OctreeElemen
         _children.external = NULL; // probably not needed!
         _childrenExternal = false;
         _threeChildrenExternalCount--;
-        _externalChildrenMemoryUsage -= 3 * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(3 * sizeof(OctreeElement*));
     } else {
         int64_t offsetOne, offsetTwo, offsetThree;
         decodeThreeOffsets(offsetOne, offsetTwo, offsetThree);
@@ -665,7 +671,11 @@ void OctreeElement::deleteAllChildren() {
     
     if (_childrenExternal) {
         // if the children_t union represents _children.external we need to delete it here
+#ifdef SIMPLE_EXTERNAL_CHILDREN
+        SlabAllocator::free(_children.external, sizeof(OctreeElement*) * NUMBER_OF_CHILDREN);
+#else
         delete[] _children.external;
+#endif
     }
 
 #ifdef BLENDED_UNION_CHILDREN
@@ -760,24 +770,25 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         _children.single = child;
     } else if (previousChildCount == 1 && newChildCount == 2) {
         OctreeElement* previousChild = _children.single;
-        _children.external = new OctreeElement*[NUMBER_OF_CHILDREN];
+        _children.external = static_cast<OctreeElement**>(SlabAllocator::allocate(sizeof(OctreeElement*)
+                                                                                      * NUMBER_OF_CHILDREN));
         memset(_children.external, 0, sizeof(OctreeElement*) * NUMBER_OF_CHILDREN);
         _children.external[firstIndex] = previousChild;
         _children.external[childIndex] = child;
         
         _childrenExternal = true;
 
-        _externalChildrenMemoryUsage += NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
+        _externalChildrenMemory.addCPUBytes(NUMBER_OF_CHILDREN * sizeof(OctreeElement*));
 
     } else if (previousChildCount == 2 && newChildCount == 1) {
         assert(!child); // we are removing a child, so this must be true!
         OctreeElement* previousFirstChild = _children.external[firstIndex];
         OctreeElement* previousSecondChild = _children.external[secondIndex];
 
-        delete[] _children.external;
+        SlabAllocator::free(_children.external, sizeof(OctreeElement*) * NUMBER_OF_CHILDREN);
         _childrenExternal = false;
         
-        _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(NUMBER_OF_CHILDREN * sizeof(OctreeElement*));
         if (childIndex == firstIndex) {
             _children.single = previousSecondChild;
         } else {
@@ -997,7 +1008,7 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         _children.external = new OctreeElement*[newChildCount];
         memset(_children.external, 0, sizeof(OctreeElement*) * newChildCount);
 
-        _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElement*);
+        _externalChildrenMemory.addCPUBytes(newChildCount * sizeof(OctreeElement*));
 
         _children.external[0] = childOne;
         _children.external[1] = childTwo;
@@ -1040,7 +1051,7 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         delete[] _children.external;
         _children.external = NULL;
         _externalChildrenCount--;
-        _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(previousChildCount * sizeof(OctreeElement*));
         storeThreeChildren(childOne, childTwo, childThree);
     } else if (previousChildCount == newChildCount) {
         //assert(_children.external && _childrenExternal && previousChildCount >= 4);
@@ -1090,8 +1101,8 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         }
         delete[] _children.external;
         _children.external = newExternalList;
-        _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElement*);
-        _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(previousChildCount * sizeof(OctreeElement*));
+        _externalChildrenMemory.addCPUBytes(newChildCount * sizeof(OctreeElement*));
 
     } else if (previousChildCount > newChildCount) {
         //assert(_children.external && _childrenExternal && previousChildCount >= 4);
@@ -1116,8 +1127,8 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         }
         delete[] _children.external;
         _children.external = newExternalList;
-        _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElement*);
-        _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElement*);
+        _externalChildrenMemory.removeCPUBytes(previousChildCount * sizeof(OctreeElement*));
+        _externalChildrenMemory.addCPUBytes(newChildCount * sizeof(OctreeElement*));
     } else {
         //assert(false);
         qDebug("THIS SHOULD NOT HAPPEN previousChildCount == %d && newChildCount == %d",previousChildCount, newChildCount);
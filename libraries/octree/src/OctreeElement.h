@@ -18,8 +18,10 @@
 
 #include <QReadWriteLock>
 
+#include <MemoryTracker.h>
 #include <OctalCode.h>
 #include <SharedUtil.h>
+#include <SlabAllocator.h>
 
 #include "AACube.h"
 #include "ViewFrustum.h"
@@ -27,6 +29,7 @@
 
 class CollisionList;
 class EncodeBitstreamParams;
+class OcclusionBuffer;
 class Octree;
 class OctreeElement;
 class OctreeElementBag;
@@ -61,6 +64,10 @@ public:
     virtual void init(unsigned char * octalCode); /// Your subclass must call init on construction.
     virtual ~OctreeElement();
 
+    /// elements of every subclass come out of the SlabAllocator slabs
+    static void* operator new(size_t size);
+    static void operator delete(void* element, size_t size);
+
     // methods you can and should override to implement your tree functionality
     
     /// Adds a child to the current element. Override this if there is additional child initialization your class needs.
@@ -99,6 +106,10 @@ public:
     virtual void updateEncodedData(int childIndex, AppendState childAppendState, EncodeBitstreamParams& params) const { }
     virtual void elementEncodeComplete(EncodeBitstreamParams& params, OctreeElementBag* bag) const { }
 
+    /// Override to draw whatever content of this element is solid and in place into an occlusion buffer, nothing
+    /// behind it is sent to the viewer while occlusion culling
+    virtual void addOccluders(const ViewFrustum& viewFrustum, OcclusionBuffer& occlusionBuffer) const { }
+
     /// Override to serialize the state of this element. This is used for persistance and for transmission across the network.
     virtual AppendState appendElementData(OctreePacketData* packetData, EncodeBitstreamParams& params) const 
                                 { return COMPLETED; }
@@ -192,10 +203,12 @@ public:
     static unsigned long getInternalNodeCount() { return _voxelNodeCount - _voxelNodeLeafCount; }
     static unsigned long getLeafNodeCount() { return _voxelNodeLeafCount; }
 
-    static quint64 getOctreeMemoryUsage() { return _octreeMemoryUsage; }
-    static quint64 getOctcodeMemoryUsage() { return _octcodeMemoryUsage; }
-    static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemoryUsage; }
-    static quint64 getTotalMemoryUsage() { return _octreeMemoryUsage + _octcodeMemoryUsage + _externalChildrenMemoryUsage; }
+    static quint64 getOctreeMemoryUsage() { return _octreeMemory.getCPUBytes(); }
+    static quint64 getOctcodeMemoryUsage() { return _octcodeMemory.getCPUBytes(); }
+    static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemory.getCPUBytes(); }
+    static quint64 getTotalMemoryUsage() {
+        return getOctreeMemoryUsage() + getOctcodeMemoryUsage() + getExternalChildrenMemoryUsage();
+    }
 
     static quint64 getGetChildAtIndexTime() { return _getChildAtIndexTime; }
     static quint64 getGetChildAtIndexCalls() { return _getChildAtIndexCalls; }
@@ -334,9 +347,10 @@ protected:
     static quint64 _voxelNodeCount;
     static quint64 _voxelNodeLeafCount;
 
-    static quint64 _octreeMemoryUsage;
-    static quint64 _octcodeMemoryUsage;
-    static quint64 _externalChildrenMemoryUsage;
+    // the counters of the MemoryTracker, which the threads that build trees add to at once
+    static MemoryCounter& _octreeMemory;
+    static MemoryCounter& _octcodeMemory;
+    static MemoryCounter& _externalChildrenMemory;
 
     static quint64 _getChildAtIndexTime;
     static quint64 _getChildAtIndexCalls;
@@ -9,11 +9,27 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "OctreeElementBag.h"
 #include <OctalCode.h>
+#include <SharedUtil.h>
+
+// elements that changed within the last second are worth this many times their size to the viewer
+static const quint64 RECENTLY_CHANGED_USECS = USECS_PER_SECOND;
+static const float RECENTLY_CHANGED_BOOST = 2.0f;
+
+// elements outside the frustum are still sent, but only after everything in view
+static const float OUT_OF_VIEW_PENALTY = 0.01f;
+
+// keeps a distance of zero, the viewer standing inside the element, from dividing by zero
+static const float MIN_PRIORITY_DISTANCE = 0.001f;
 
 OctreeElementBag::OctreeElementBag() : 
-    _bagElements()
+    _bagElements(),
+    _heap(),
+    _nextStamp(0),
+    _viewFrustum(NULL)
 {
     OctreeElement::addDeleteHook(this);
     _hooked = true;
@@ -38,22 +54,54 @@ void OctreeElementBag::elementDeleted(OctreeElement* element) {
 
 void OctreeElementBag::deleteAll() {
     _bagElements.clear();
+    _heap.clear();
 }
 
+float OctreeElementBag::calculatePriority(const OctreeElement* element, quint64 now) const {
+    if (!_viewFrustum) {
+        return 0.0f;
+    }
+
+    // the size the element takes up on screen goes roughly as its size over its distance
+    float distance = std::max(element->distanceToCamera(*_viewFrustum), MIN_PRIORITY_DISTANCE);
+    float priority = element->getScale() * (float)TREE_SCALE / distance;
+
+    if (now - element->getLastChanged() < RECENTLY_CHANGED_USECS) {
+        priority *= RECENTLY_CHANGED_BOOST;
+    }
+    if (!element->isInView(*_viewFrustum)) {
+        priority *= OUT_OF_VIEW_PENALTY;
+    }
+    return priority;
+}
 
 void OctreeElementBag::insert(OctreeElement* element) {
-    _bagElements.insert(element);
+    if (_bagElements.contains(element)) {
+        return;
+    }
+    BagEntry entry;
+    entry.priority = calculatePriority(element, usecTimestampNow());
+    entry.stamp = _nextStamp++;
+    entry.element = element;
+
+    _bagElements.insert(element, entry.stamp);
+    _heap.push_back(entry);
+    std::push_heap(_heap.begin(), _heap.end());
 }
 
 OctreeElement* OctreeElementBag::extract() {
-    OctreeElement* result = NULL;
+    while (!_heap.empty()) {
+        std::pop_heap(_heap.begin(), _heap.end());
+        BagEntry entry = _heap.back();
+        _heap.pop_back();
 
-    if (_bagElements.size() > 0) {
-        QSet<OctreeElement*>::iterator front = _bagElements.begin();
-        result = *front;
-        _bagElements.erase(front);
+        QHash<OctreeElement*, quint32>::iterator live = _bagElements.find(entry.element);
+        if (live != _bagElements.end() && live.value() == entry.stamp) {
+            _bagElements.erase(live);
+            return entry.element;
+        }
     }
-    return result;
+    return NULL;
 }
 
 bool OctreeElementBag::contains(OctreeElement* element) {
@@ -61,5 +109,28 @@ bool OctreeElementBag::contains(OctreeElement* element) {
 }
 
 void OctreeElementBag::remove(OctreeElement* element) {
-    _bagElements.remove(element);
+    if (_bagElements.remove(element) > 0 && _heap.size() > 2 * (size_t)_bagElements.size() + 64) {
+        // don't let the entries of removed elements pile up in the heap
+        rebuildHeap();
+    }
+}
+
+void OctreeElementBag::reprioritize() {
+    rebuildHeap();
+}
+
+void OctreeElementBag::rebuildHeap() {
+    quint64 now = usecTimestampNow();
+    _heap.clear();
+    _heap.reserve(_bagElements.size());
+
+    QHash<OctreeElement*, quint32>::const_iterator i = _bagElements.constBegin();
+    for (; i != _bagElements.constEnd(); ++i) {
+        BagEntry entry;
+        entry.priority = calculatePriority(i.key(), now);
+        entry.stamp = i.value();
+        entry.element = i.key();
+        _heap.push_back(entry);
+    }
+    std::make_heap(_heap.begin(), _heap.end());
 }
@@ -8,6 +8,8 @@
 //  This class is used by the Octree:encodeTreeBitstream() functions to store elements and element data that need to be sent.
 //  It's a generic bag style storage mechanism. But It has the property that you can't put the same element into the bag
 //  more than once (in other words, it de-dupes automatically).
+//  Given a view frustum the bag hands elements out by priority: large and near elements in view come first,
+//  with a boost for elements that changed recently. Without one they come out in the order they went in.
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
@@ -16,6 +18,10 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
+#include <vector>
+
+#include <QHash>
+
 #include "OctreeElement.h"
 
 class OctreeElementBag : public OctreeElementDeleteHook {
@@ -25,7 +31,7 @@ public:
     ~OctreeElementBag();
     
     void insert(OctreeElement* element); // put a element into the bag
-    OctreeElement* extract(); // pull a element out of the bag (could come in any order)
+    OctreeElement* extract(); // pull the highest priority element out of the bag
     bool contains(OctreeElement* element); // is this element in the bag?
     void remove(OctreeElement* element); // remove a specific element from the bag
     bool isEmpty() const { return _bagElements.isEmpty(); }
@@ -36,8 +42,33 @@ public:
 
     void unhookNotifications();
 
+    /// elements are prioritized against this frustum as they are inserted, NULL orders them first in first out
+    void setViewFrustum(const ViewFrustum* viewFrustum) { _viewFrustum = viewFrustum; }
+
+    /// recalculates the priority of every element in the bag, call this when the view frustum moves
+    void reprioritize();
+
 private:
-    QSet<OctreeElement*> _bagElements;
+    class BagEntry {
+    public:
+        float priority;
+        quint32 stamp;
+        OctreeElement* element;
+
+        // lower priority sorts first so the heap's top is the highest priority, older entries win ties
+        bool operator<(const BagEntry& other) const {
+            return priority < other.priority || (priority == other.priority && stamp > other.stamp);
+        }
+    };
+
+    float calculatePriority(const OctreeElement* element, quint64 now) const;
+    void rebuildHeap();
+
+    // the stamp of each element's live entry in the heap, entries for removed elements are skipped when they surface
+    QHash<OctreeElement*, quint32> _bagElements;
+    std::vector<BagEntry> _heap;
+    quint32 _nextStamp;
+    const ViewFrustum* _viewFrustum;
     bool _hooked;
 };
 
@@ -13,8 +13,28 @@
 
 #include "OctreeHeadlessViewer.h"
 
+// with several regions, their queries are merged into one per frame
+const quint64 MIN_SHARED_QUERY_INTERVAL = USECS_PER_SECOND / 60;
+
+// the field of view of the frustum that holds every region
+const float SHARED_QUERY_FIELD_OF_VIEW_DEGREES = 90.0f;
+
+OctreeInterestRegion::OctreeInterestRegion(OctreeHeadlessViewer* viewer) :
+    QObject(viewer),
+    _viewer(viewer) {
+}
+
+void OctreeInterestRegion::queryOctree() {
+    _viewer->queryOctree();
+}
+
+unsigned OctreeInterestRegion::getOctreeElementsCount() const {
+    return _viewer->getOctreeElementsCount();
+}
+
 OctreeHeadlessViewer::OctreeHeadlessViewer() :
     OctreeRenderer(),
+    _lastQuery(0),
     _voxelSizeScale(DEFAULT_OCTREE_SIZE_SCALE),
     _boundaryLevelAdjust(0),
     _maxPacketsPerSecond(DEFAULT_MAX_OCTREE_PPS)
@@ -33,6 +53,38 @@ void OctreeHeadlessViewer::init() {
     setViewFrustum(&_viewFrustum);
 }
 
+OctreeInterestRegion* OctreeHeadlessViewer::addInterestRegion() {
+    OctreeInterestRegion* region = new OctreeInterestRegion(this);
+    _interestRegions.append(region);
+    return region;
+}
+
+ViewFrustum OctreeHeadlessViewer::getQueryFrustum() const {
+    ViewFrustum frustum = _viewFrustum;
+    if (_interestRegions.isEmpty()) {
+        return frustum;
+    }
+    glm::vec3 minimum = _viewFrustum.getPosition();
+    glm::vec3 maximum = minimum;
+    foreach (OctreeInterestRegion* region, _interestRegions) {
+        minimum = glm::min(minimum, region->getPosition());
+        maximum = glm::max(maximum, region->getPosition());
+    }
+    glm::vec3 center = (minimum + maximum) * 0.5f;
+    float radius = glm::distance(center, maximum);
+    if (radius > EPSILON) {
+        // look along our own direction at the sphere from where the wider field of view just takes it in; what each
+        // region sees beyond the sphere is only covered ahead of it
+        float distance = radius / sinf(glm::radians(SHARED_QUERY_FIELD_OF_VIEW_DEGREES * 0.5f));
+        frustum.setPosition(center - _viewFrustum.getDirection() * distance);
+        frustum.setFieldOfView(SHARED_QUERY_FIELD_OF_VIEW_DEGREES);
+        frustum.setAspectRatio(1.0f);
+        frustum.setFarClip(_viewFrustum.getFarClip() + distance + radius);
+    }
+    frustum.calculate();
+    return frustum;
+}
+
 void OctreeHeadlessViewer::queryOctree() {
     char serverType = getMyNodeType();
     PacketType packetType = getMyQueryMessageType();
@@ -40,6 +92,13 @@ void OctreeHeadlessViewer::queryOctree() {
 
     bool wantExtraDebugging = false;
 
+    quint64 now = usecTimestampNow();
+    if (!_interestRegions.isEmpty() && now - _lastQuery < MIN_SHARED_QUERY_INTERVAL) {
+        return;
+    }
+    _lastQuery = now;
+    ViewFrustum queryFrustum = getQueryFrustum();
+
     if (wantExtraDebugging) {
         qDebug() << "OctreeHeadlessViewer::queryOctree() _jurisdictionListener=" << _jurisdictionListener;
         qDebug() << "---------------";
@@ -59,14 +118,15 @@ void OctreeHeadlessViewer::queryOctree() {
     _octreeQuery.setWantDelta(true);
     _octreeQuery.setWantOcclusionCulling(false);
     _octreeQuery.setWantCompression(true); // TODO: should be on by default
+    _octreeQuery.setWantFastCompression(true);
 
-    _octreeQuery.setCameraPosition(_viewFrustum.getPosition());
-    _octreeQuery.setCameraOrientation(_viewFrustum.getOrientation());
-    _octreeQuery.setCameraFov(_viewFrustum.getFieldOfView());
-    _octreeQuery.setCameraAspectRatio(_viewFrustum.getAspectRatio());
-    _octreeQuery.setCameraNearClip(_viewFrustum.getNearClip());
-    _octreeQuery.setCameraFarClip(_viewFrustum.getFarClip());
-    _octreeQuery.setCameraEyeOffsetPosition(_viewFrustum.getEyeOffsetPosition());
+    _octreeQuery.setCameraPosition(queryFrustum.getPosition());
+    _octreeQuery.setCameraOrientation(queryFrustum.getOrientation());
+    _octreeQuery.setCameraFov(queryFrustum.getFieldOfView());
+    _octreeQuery.setCameraAspectRatio(queryFrustum.getAspectRatio());
+    _octreeQuery.setCameraNearClip(queryFrustum.getNearClip());
+    _octreeQuery.setCameraFarClip(queryFrustum.getFarClip());
+    _octreeQuery.setCameraEyeOffsetPosition(queryFrustum.getEyeOffsetPosition());
     _octreeQuery.setOctreeSizeScale(getVoxelSizeScale());
     _octreeQuery.setBoundaryLevelAdjust(getBoundaryLevelAdjust());
 
@@ -103,7 +163,7 @@ void OctreeHeadlessViewer::queryOctree() {
                     AACube serverBounds(glm::vec3(rootDetails.x, rootDetails.y, rootDetails.z), rootDetails.s);
                     serverBounds.scale(TREE_SCALE);
                     
-                    ViewFrustum::location serverFrustumLocation = _viewFrustum.cubeInFrustum(serverBounds);
+                    ViewFrustum::location serverFrustumLocation = queryFrustum.cubeInFrustum(serverBounds);
                     
                     if (serverFrustumLocation != ViewFrustum::OUTSIDE) {
                         inViewServers++;
@@ -172,7 +232,7 @@ void OctreeHeadlessViewer::queryOctree() {
                     AACube serverBounds(glm::vec3(rootDetails.x, rootDetails.y, rootDetails.z), rootDetails.s);
                     serverBounds.scale(TREE_SCALE);
                     
-                    ViewFrustum::location serverFrustumLocation = _viewFrustum.cubeInFrustum(serverBounds);
+                    ViewFrustum::location serverFrustumLocation = queryFrustum.cubeInFrustum(serverBounds);
                     if (serverFrustumLocation != ViewFrustum::OUTSIDE) {
                         inView = true;
                     } else {
@@ -12,6 +12,8 @@
 #ifndef hifi_OctreeHeadlessViewer_h
 #define hifi_OctreeHeadlessViewer_h
 
+#include <QList>
+
 #include <PacketHeaders.h>
 #include <SharedUtil.h>
 
@@ -24,6 +26,32 @@
 #include "Octree.h"
 #include "ViewFrustum.h"
 
+class OctreeHeadlessViewer;
+
+/// One script's view into a headless viewer's tree, for scripts that share the viewer.  The viewer sends one query that
+/// covers all of its regions and keeps one copy of the tree, which every region reads in place.
+class OctreeInterestRegion : public QObject {
+    Q_OBJECT
+public:
+    OctreeInterestRegion(OctreeHeadlessViewer* viewer);
+
+public slots:
+    void queryOctree();
+
+    void setPosition(const glm::vec3& position) { _position = position; }
+    void setOrientation(const glm::quat& orientation) { _orientation = orientation; }
+
+    const glm::vec3& getPosition() const { return _position; }
+    const glm::quat& getOrientation() const { return _orientation; }
+
+    unsigned getOctreeElementsCount() const;
+
+private:
+    OctreeHeadlessViewer* _viewer;
+    glm::vec3 _position;
+    glm::quat _orientation;
+};
+
 // Generic client side Octree renderer class.
 class OctreeHeadlessViewer : public OctreeRenderer {
     Q_OBJECT
@@ -38,6 +66,9 @@ public:
 
     void setJurisdictionListener(JurisdictionListener* jurisdictionListener) { _jurisdictionListener = jurisdictionListener; }
 
+    /// Adds a view for another script to steer, owned by this viewer.
+    OctreeInterestRegion* addInterestRegion();
+
     static int parseOctreeStats(const QByteArray& packet, const SharedNodePointer& sourceNode);
     static void trackIncomingOctreePacket(const QByteArray& packet, const SharedNodePointer& sendingNode, bool wasStatsPacket);
 
@@ -65,7 +96,13 @@ public slots:
     unsigned getOctreeElementsCount() const { return _tree->getOctreeElementsCount(); }
 
 private:
+    /// Returns the frustum to query with: our own when there are no other regions, otherwise one backed off from the
+    /// sphere around all of the regions' positions far enough to contain it.
+    ViewFrustum getQueryFrustum() const;
+
     ViewFrustum _viewFrustum;
+    QList<OctreeInterestRegion*> _interestRegions;
+    quint64 _lastQuery;
     JurisdictionListener* _jurisdictionListener;
     OctreeQuery _octreeQuery;
     float _voxelSizeScale;
@@ -10,6 +10,7 @@
 //
 
 #include <GLMHelpers.h>
+#include <LZCompression.h>
 #include <PerfStat.h>
 
 #include "OctreePacketData.h"
@@ -24,12 +25,13 @@ quint64 OctreePacketData::_totalBytesOfRawData = 0;
 
 
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
-    changeSettings(enableCompression, targetSize); // does reset...
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize, bool fastCompression) {
+    changeSettings(enableCompression, targetSize, fastCompression); // does reset...
 }
 
-void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
+void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize, bool fastCompression) {
     _enableCompression = enableCompression;
+    _fastCompression = fastCompression;
     _targetSize = std::min(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, targetSize);
     reset();
 }
@@ -456,13 +458,22 @@ bool OctreePacketData::compressContent() {
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
+    if (_fastCompression) {
+        int compressedSize = LZCompression::compress(uncompressedData, uncompressedSize,
+                                                     _compressed, MAX_OCTREE_PACKET_DATA_SIZE);
+        if (compressedSize >= 0) {
+            _compressedBytes = compressedSize;
+            _dirty = false;
+            success = true;
+        }
+        return success;
+    }
+
     QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
 
     if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
         _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
-        }
+        memcpy(_compressed, compressedData.constData(), _compressedBytes);
         _dirty = false;
         success = true;
     }
@@ -475,26 +486,29 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
 
     if (data && length > 0) {
 
-        if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
+        // no section is longer than a packet, don't copy past our buffers for one that claims to be
+        length = std::min(length, (int)sizeof(_compressed));
+
+        if (_enableCompression && _fastCompression) {
+            memcpy(_compressed, data, length);
+            _compressedBytes = length;
+            int uncompressedSize = LZCompression::decompress(data, length, _uncompressed, _bytesAvailable);
+            if (uncompressedSize >= 0) {
+                _bytesInUse = uncompressedSize;
+                _bytesAvailable -= uncompressedSize;
             }
+        } else if (_enableCompression) {
+            memcpy(_compressed, data, length);
             _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
+            QByteArray uncompressedData = qUncompress(data, length);
             if (uncompressedData.size() <= _bytesAvailable) {
                 _bytesInUse = uncompressedData.size();
                 _bytesAvailable -= uncompressedData.size();
-
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
-                }
+                memcpy(_uncompressed, uncompressedData.constData(), _bytesInUse);
             }
         } else {
-            for (int i = 0; i < length; i++) {
-                _uncompressed[i] = _compressed[i] = data[i];
-            }
+            memcpy(_uncompressed, data, length);
+            memcpy(_compressed, data, length);
             _bytesInUse = _compressedBytes = length;
         }
     } else {
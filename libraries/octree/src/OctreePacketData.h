@@ -50,6 +50,7 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_IS_FAST_COMPRESSED_BIT = 2; // the compressed sections use LZCompression instead of zlib
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
@@ -74,11 +75,13 @@ private:
 /// Handles packing of the data portion of PacketType_OCTREE_DATA messages. 
 class OctreePacketData {
 public:
-    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                     bool fastCompression = false);
     ~OctreePacketData();
 
     /// change compression and target size settings
-    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                        bool fastCompression = false);
 
     /// reset completely, all data is discarded
     void reset();
@@ -199,8 +202,11 @@ public:
     /// load finalized content to allow access to decoded content for parsing
     void loadFinalizedContent(const unsigned char* data, int length);
     
-    /// returns whether or not zlib compression enabled on finalization
+    /// returns whether or not compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// returns whether compression uses the fast LZ codec rather than zlib
+    bool isFastCompressed() const { return _enableCompression && _fastCompression; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -226,6 +232,7 @@ private:
 
     unsigned int _targetSize;
     bool _enableCompression;
+    bool _fastCompression;
     
     unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _bytesInUse;
@@ -20,6 +20,7 @@
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QSaveFile>
 
 #include <PerfStat.h>
 #include <SharedUtil.h>
@@ -213,6 +214,10 @@ void OctreePersistThread::persist() {
         }
         _tree->unlock();
 
+        // the snapshot is encoded a buffer at a time under the read lock, so edits carry on while we save. Those edits
+        // may or may not make it into this snapshot, clearing the dirty bit first means they are saved next time.
+        _tree->clearDirtyBit();
+
         backup(); // handle backup if requested        
 
 
@@ -224,10 +229,21 @@ void OctreePersistThread::persist() {
 
             qDebug() << "saving Octree to file " << _filename << "...";
             
-            _tree->writeToSVOFile(qPrintable(_filename));
-            time(&_lastPersistTime);
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qDebug() << "DONE saving Octree to file...";
+            // the snapshot streams out as it's encoded, so only a buffer of it is ever held, and replaces the old file
+            // only once all of it has been written
+            QSaveFile file(_filename);
+            bool written = false;
+            if (file.open(QIODevice::WriteOnly)) {
+                PerformanceWarning warn(true, "Writing Octree snapshot", true);
+                written = _tree->writeToSVOStream(file);
+            }
+            if (written && file.commit()) {
+                time(&_lastPersistTime);
+                qDebug() << "DONE saving Octree to file...";
+            } else {
+                qDebug() << "ERROR saving Octree to file" << _filename << ":" << file.errorString();
+                _tree->setDirtyBit(); // try again on the next persist
+            }
 
             lockFile.close();
             qDebug() << "saving Octree lock file closed:" << lockFileName;
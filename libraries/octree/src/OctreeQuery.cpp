@@ -55,6 +55,7 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
     if (_wantDelta)            { setAtBit(bitItems, WANT_DELTA_AT_BIT); }
     if (_wantOcclusionCulling) { setAtBit(bitItems, WANT_OCCLUSION_CULLING_BIT); }
     if (_wantCompression)      { setAtBit(bitItems, WANT_COMPRESSION); }
+    if (_wantFastCompression)  { setAtBit(bitItems, WANT_FAST_COMPRESSION); }
 
     *destinationBuffer++ = bitItems;
 
@@ -101,6 +102,7 @@ int OctreeQuery::parseData(const QByteArray& packet) {
     _wantDelta = oneAtBit(bitItems, WANT_DELTA_AT_BIT);
     _wantOcclusionCulling = oneAtBit(bitItems, WANT_OCCLUSION_CULLING_BIT);
     _wantCompression = oneAtBit(bitItems, WANT_COMPRESSION);
+    _wantFastCompression = oneAtBit(bitItems, WANT_FAST_COMPRESSION);
 
     // desired Max Octree PPS
     memcpy(&_maxOctreePPS, sourceBuffer, sizeof(_maxOctreePPS));
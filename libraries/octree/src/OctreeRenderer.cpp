@@ -46,104 +46,120 @@ void OctreeRenderer::setTree(Octree* newTree) {
 }
 
 void OctreeRenderer::processDatagram(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode) {
+    DecodedOctreePacket decodedPacket;
+    if (decodeDatagram(dataByteArray, sourceNode, decodedPacket)) {
+        applyDecodedPackets(QVector<DecodedOctreePacket>() << decodedPacket);
+    }
+}
+
+bool OctreeRenderer::decodeDatagram(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode,
+                                    DecodedOctreePacket& decodedPacket) const {
     bool extraDebugging = false;
     
     if (extraDebugging) {
-        qDebug() << "OctreeRenderer::processDatagram()";
-    }
-
-    if (!_tree) {
-        qDebug() << "OctreeRenderer::processDatagram() called before init, calling init()...";
-        this->init();
+        qDebug() << "OctreeRenderer::decodeDatagram()";
     }
 
     bool showTimingDetails = false; // Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
-    PerformanceWarning warn(showTimingDetails, "OctreeRenderer::processDatagram()",showTimingDetails);
+    PerformanceWarning warn(showTimingDetails, "OctreeRenderer::decodeDatagram()",showTimingDetails);
     
     unsigned int packetLength = dataByteArray.size();
     PacketType command = packetTypeForPacket(dataByteArray);
     unsigned int numBytesPacketHeader = numBytesForPacketHeader(dataByteArray);
-    QUuid sourceUUID = uuidFromPacketHeader(dataByteArray);
-    PacketType expectedType = getExpectedPacketType();
-    PacketVersion expectedVersion = _tree->expectedVersion(); // TODO: would be better to read this from the packet!
     
-    if(command == expectedType) {
-        PerformanceWarning warn(showTimingDetails, "OctreeRenderer::processDatagram expected PacketType", showTimingDetails);
-        // if we are getting inbound packets, then our tree is also viewing, and we should remember that fact.
-        _tree->setIsViewing(true);
+    if (command != getExpectedPacketType()) {
+        return false;
+    }
+    decodedPacket.sourceUUID = uuidFromPacketHeader(dataByteArray);
+    decodedPacket.sourceNode = sourceNode;
 
-        const unsigned char* dataAt = reinterpret_cast<const unsigned char*>(dataByteArray.data()) + numBytesPacketHeader;
+    const unsigned char* dataAt = reinterpret_cast<const unsigned char*>(dataByteArray.data()) + numBytesPacketHeader;
 
-        OCTREE_PACKET_FLAGS flags = (*(OCTREE_PACKET_FLAGS*)(dataAt));
-        dataAt += sizeof(OCTREE_PACKET_FLAGS);
-        OCTREE_PACKET_SEQUENCE sequence = (*(OCTREE_PACKET_SEQUENCE*)dataAt);
-        dataAt += sizeof(OCTREE_PACKET_SEQUENCE);
+    OCTREE_PACKET_FLAGS flags = (*(OCTREE_PACKET_FLAGS*)(dataAt));
+    dataAt += sizeof(OCTREE_PACKET_FLAGS);
+    OCTREE_PACKET_SEQUENCE sequence = (*(OCTREE_PACKET_SEQUENCE*)dataAt);
+    dataAt += sizeof(OCTREE_PACKET_SEQUENCE);
 
-        OCTREE_PACKET_SENT_TIME sentAt = (*(OCTREE_PACKET_SENT_TIME*)dataAt);
-        dataAt += sizeof(OCTREE_PACKET_SENT_TIME);
+    OCTREE_PACKET_SENT_TIME sentAt = (*(OCTREE_PACKET_SENT_TIME*)dataAt);
+    dataAt += sizeof(OCTREE_PACKET_SENT_TIME);
 
-        bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
-        bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
-        
-        OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
-        int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
-        int flightTime = arrivedAt - sentAt + clockSkew;
-
-        OCTREE_PACKET_INTERNAL_SECTION_SIZE sectionLength = 0;
-        unsigned int dataBytes = packetLength - (numBytesPacketHeader + OCTREE_PACKET_EXTRA_HEADERS_SIZE);
-
-        if (extraDebugging) {
-            qDebug("OctreeRenderer::processDatagram() ... Got Packet Section"
-                   " color:%s compressed:%s sequence: %u flight:%d usec size:%u data:%u",
-                   debug::valueOf(packetIsColored), debug::valueOf(packetIsCompressed),
-                   sequence, flightTime, packetLength, dataBytes);
-        }
-        
-        int subsection = 1;
-        while (dataBytes > 0) {
-            if (packetIsCompressed) {
-                if (dataBytes > sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE)) {
-                    sectionLength = (*(OCTREE_PACKET_INTERNAL_SECTION_SIZE*)dataAt);
-                    dataAt += sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
-                    dataBytes -= sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
-                } else {
-                    sectionLength = 0;
-                    dataBytes = 0; // stop looping something is wrong
-                }
+    decodedPacket.isColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
+    bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+    bool packetIsFastCompressed = oneAtBit(flags, PACKET_IS_FAST_COMPRESSED_BIT);
+    
+    OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
+    int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
+    int flightTime = arrivedAt - sentAt + clockSkew;
+
+    OCTREE_PACKET_INTERNAL_SECTION_SIZE sectionLength = 0;
+    unsigned int dataBytes = packetLength - (numBytesPacketHeader + OCTREE_PACKET_EXTRA_HEADERS_SIZE);
+
+    if (extraDebugging) {
+        qDebug("OctreeRenderer::decodeDatagram() ... Got Packet Section"
+               " color:%s compressed:%s sequence: %u flight:%d usec size:%u data:%u",
+               debug::valueOf(decodedPacket.isColored), debug::valueOf(packetIsCompressed),
+               sequence, flightTime, packetLength, dataBytes);
+    }
+    
+    while (dataBytes > 0) {
+        if (packetIsCompressed) {
+            if (dataBytes > sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE)) {
+                sectionLength = (*(OCTREE_PACKET_INTERNAL_SECTION_SIZE*)dataAt);
+                dataAt += sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+                dataBytes -= sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
             } else {
-                sectionLength = dataBytes;
+                sectionLength = 0;
+                dataBytes = 0; // stop looping something is wrong
             }
-            
-            if (sectionLength) {
-                // ask the VoxelTree to read the bitstream into the tree
-                ReadBitstreamToTreeParams args(packetIsColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL, 
-                                                sourceUUID, sourceNode, false, expectedVersion);
-                _tree->lockForWrite();
-                OctreePacketData packetData(packetIsCompressed);
-                packetData.loadFinalizedContent(dataAt, sectionLength);
-                if (extraDebugging) {
-                    qDebug("OctreeRenderer::processDatagram() ... Got Packet Section"
-                           " color:%s compressed:%s sequence: %u flight:%d usec size:%u data:%u"
-                           " subsection:%d sectionLength:%d uncompressed:%d",
-                           debug::valueOf(packetIsColored), debug::valueOf(packetIsCompressed),
-                           sequence, flightTime, packetLength, dataBytes, subsection, sectionLength,
-                           packetData.getUncompressedSize());
-                }
-                if (extraDebugging) {
-                    qDebug() << "OctreeRenderer::processDatagram() ******* START _tree->readBitstreamToTree()...";
-                }
-                _tree->readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
-                if (extraDebugging) {
-                    qDebug() << "OctreeRenderer::processDatagram() ******* END _tree->readBitstreamToTree()...";
-                }
-                _tree->unlock();
-            
-                dataBytes -= sectionLength;
-                dataAt += sectionLength;
+        } else {
+            sectionLength = dataBytes;
+        }
+        
+        if (sectionLength) {
+            // the decompression needs nothing of the tree, so it's done before we take the lock on it
+            OctreePacketData packetData(packetIsCompressed, MAX_OCTREE_PACKET_DATA_SIZE, packetIsFastCompressed);
+            packetData.loadFinalizedContent(dataAt, sectionLength);
+            if (extraDebugging) {
+                qDebug("OctreeRenderer::decodeDatagram() ... Got Packet Section"
+                       " color:%s compressed:%s sequence: %u flight:%d usec size:%u data:%u"
+                       " sectionLength:%d uncompressed:%d",
+                       debug::valueOf(decodedPacket.isColored), debug::valueOf(packetIsCompressed),
+                       sequence, flightTime, packetLength, dataBytes, sectionLength,
+                       packetData.getUncompressedSize());
             }
+            decodedPacket.sections.append(QByteArray(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                                                     packetData.getUncompressedSize()));
+            dataBytes -= sectionLength;
+            dataAt += sectionLength;
+        }
+    }
+    return true;
+}
+
+void OctreeRenderer::applyDecodedPackets(const QVector<DecodedOctreePacket>& decodedPackets) {
+    if (!_tree) {
+        qDebug() << "OctreeRenderer::applyDecodedPackets() called before init, calling init()...";
+        this->init();
+    }
+    if (decodedPackets.isEmpty()) {
+        return;
+    }
+    PacketVersion expectedVersion = _tree->expectedVersion(); // TODO: would be better to read this from the packet!
+
+    // if we are getting inbound packets, then our tree is also viewing, and we should remember that fact.
+    _tree->setIsViewing(true);
+
+    _tree->lockForWrite();
+    foreach (const DecodedOctreePacket& decodedPacket, decodedPackets) {
+        foreach (const QByteArray& section, decodedPacket.sections) {
+            // ask the tree to read the bitstream into itself
+            ReadBitstreamToTreeParams args(decodedPacket.isColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL,
+                                           decodedPacket.sourceUUID, decodedPacket.sourceNode, false, expectedVersion);
+            _tree->readBitstreamToTree(reinterpret_cast<const unsigned char*>(section.constData()), section.size(),
+                                       args);
         }
-        subsection++;
     }
+    _tree->unlock();
 }
 
 bool OctreeRenderer::renderOperation(OctreeElement* element, void* extraData) {
@@ -16,6 +16,7 @@
 #include <stdint.h>
 
 #include <QObject>
+#include <QVector>
 
 #include <PacketHeaders.h>
 #include <RenderArgs.h>
@@ -27,6 +28,16 @@
 
 class OctreeRenderer;
 
+/// A data packet's sections, decompressed and ready to be read into the tree.
+class DecodedOctreePacket {
+public:
+    DecodedOctreePacket() : isColored(false) { }
+
+    QUuid sourceUUID;
+    SharedNodePointer sourceNode;
+    bool isColored;
+    QVector<QByteArray> sections;
+};
 
 // Generic client side Octree renderer class.
 class OctreeRenderer : public QObject {
@@ -47,6 +58,14 @@ public:
     /// process incoming data
     virtual void processDatagram(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode);
 
+    /// Decompresses a data packet's sections without touching the tree, so that it can be done on any thread and for
+    /// many packets at once.  Returns false if the packet isn't of the type we expect.
+    bool decodeDatagram(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode,
+                        DecodedOctreePacket& decodedPacket) const;
+
+    /// Reads decoded packets into the tree, in order, under one write lock.
+    void applyDecodedPackets(const QVector<DecodedOctreePacket>& decodedPackets);
+
     /// initialize and GPU/rendering related resources
     virtual void init();
 
@@ -0,0 +1,44 @@
+//
+//  OctreeSentIndex.cpp
+//  libraries/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSentIndex.h"
+
+bool OctreeSentIndex::hasSent(const QUuid& id, quint64 version) const {
+    QHash<QUuid, quint64>::const_iterator sent = _sent.constFind(id);
+    return sent != _sent.constEnd() && sent.value() == version;
+}
+
+bool OctreeSentIndex::getSentVersion(const QUuid& id, quint64& version) const {
+    QHash<QUuid, quint64>::const_iterator sent = _sent.constFind(id);
+    if (sent == _sent.constEnd()) {
+        return false;
+    }
+    version = sent.value();
+    return true;
+}
+
+void OctreeSentIndex::commitPending() {
+    for (int i = 0; i < _pending.size(); i++) {
+        _sent.insert(_pending[i].first, _pending[i].second);
+    }
+    _pending.clear();
+}
+
+quint64 OctreeSentIndex::takeEarliestDeferred() {
+    quint64 earliest = _earliestDeferred;
+    _earliestDeferred = std::numeric_limits<quint64>::max();
+    return earliest;
+}
+
+void OctreeSentIndex::clear() {
+    _sent.clear();
+    _pending.clear();
+    _earliestDeferred = std::numeric_limits<quint64>::max();
+}
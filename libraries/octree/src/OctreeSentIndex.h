@@ -0,0 +1,62 @@
+//
+//  OctreeSentIndex.h
+//  libraries/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSentIndex_h
+#define hifi_OctreeSentIndex_h
+
+#include <limits>
+
+#include <QHash>
+#include <QPair>
+#include <QUuid>
+#include <QVector>
+
+/// Remembers, for one client, the version of each item the server has sent it, so an encode can leave out whatever
+/// the client already has no matter how the scene was restarted. Items are added as pending while they are encoded and
+/// only count as sent once the packet data holding them is written out, anything discarded before that is dropped.
+class OctreeSentIndex {
+public:
+    /// returns true if the client already has this version of the item
+    bool hasSent(const QUuid& id, quint64 version) const;
+
+    /// the version of the item the client has, returns false if it was never sent one
+    bool getSentVersion(const QUuid& id, quint64& version) const;
+
+    /// records an item encoded into packet data that hasn't been written out yet
+    void addPending(const QUuid& id, quint64 version) { _pending.append(qMakePair(id, version)); }
+
+    /// a mark to hand to discardPending() if what gets encoded after this point is thrown away
+    int getPendingCount() const { return _pending.size(); }
+
+    /// forgets the pending items recorded since the mark
+    void discardPending(int mark = 0) { _pending.resize(qMin(mark, _pending.size())); }
+
+    /// the packet data was written out, every pending item now counts as sent
+    void commitPending();
+
+    /// forgets an item, for one the client no longer has
+    void remove(const QUuid& id) { _sent.remove(id); }
+
+    /// records a change to an item that was held back from the client, so a later scene looks at it again
+    void defer(quint64 version) { _earliestDeferred = qMin(_earliestDeferred, version); }
+
+    /// the earliest change held back since the last call, or the largest version if there was none
+    quint64 takeEarliestDeferred();
+
+    void clear();
+    int size() const { return _sent.size(); }
+
+private:
+    QHash<QUuid, quint64> _sent;
+    QVector<QPair<QUuid, quint64> > _pending;
+    quint64 _earliestDeferred = std::numeric_limits<quint64>::max();
+};
+
+#endif // hifi_OctreeSentIndex_h
@@ -17,6 +17,14 @@
 
 #include <QtCore/QDebug>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HIFI_FRUSTUM_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define HIFI_FRUSTUM_NEON
+#include <arm_neon.h>
+#endif
+
 #include "GeometryUtil.h"
 #include "GLMHelpers.h"
 #include "SharedUtil.h"
@@ -404,6 +412,209 @@ ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box) const {
     return regularResult;
 }
 
+void ViewFrustum::cullBoxes(const QVector<AABox>& boxes, QVector<bool>& outside) const {
+    QVector<location> locations;
+    QVector<int> insideMasks;
+    classifyBoxes(boxes, locations, insideMasks);
+    outside.resize(boxes.size());
+    for (int i = 0; i < boxes.size(); i++) {
+        outside[i] = (locations.at(i) == OUTSIDE);
+    }
+}
+
+void ViewFrustum::classifyBoxes(const QVector<AABox>& boxes, QVector<location>& locations,
+        QVector<int>& insideMasks) const {
+    int count = boxes.size();
+    locations.resize(count);
+    insideMasks.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    // the boxes as rows of center and half extent components, padded out to a multiple of four
+    const int COMPONENTS = 6;
+    int stride = (count + 3) & ~3;
+    QVector<float> rows(stride * COMPONENTS, 0.0f);
+    float* centerX = rows.data();
+    float* centerY = centerX + stride;
+    float* centerZ = centerY + stride;
+    float* extentX = centerZ + stride;
+    float* extentY = extentX + stride;
+    float* extentZ = extentY + stride;
+    for (int i = 0; i < count; i++) {
+        const AABox& box = boxes.at(i);
+        glm::vec3 extent = box.getScale() * 0.5f;
+        glm::vec3 center = box.getCorner() + extent;
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        extentX[i] = extent.x;
+        extentY[i] = extent.y;
+        extentZ[i] = extent.z;
+    }
+    classifyRows(rows.constData(), stride, count, false, locations.data(), insideMasks.data());
+
+    // the keyhole is only worth checking for what isn't already fully inside
+    if (_keyholeRadius >= 0.0f) {
+        for (int i = 0; i < count; i++) {
+            if (locations.at(i) != INSIDE) {
+                location keyholeResult = boxInKeyhole(boxes.at(i));
+                if (keyholeResult == INSIDE || locations.at(i) == OUTSIDE) {
+                    locations[i] = keyholeResult;
+                }
+            }
+        }
+    }
+}
+
+void ViewFrustum::classifySpheres(const QVector<glm::vec3>& centers, const QVector<float>& radii,
+        QVector<location>& locations, QVector<int>& insideMasks) const {
+    int count = centers.size();
+    locations.resize(count);
+    insideMasks.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    // the spheres as rows of center components and radii, padded out to a multiple of four
+    const int COMPONENTS = 4;
+    int stride = (count + 3) & ~3;
+    QVector<float> rows(stride * COMPONENTS, 0.0f);
+    float* centerX = rows.data();
+    float* centerY = centerX + stride;
+    float* centerZ = centerY + stride;
+    float* radius = centerZ + stride;
+    for (int i = 0; i < count; i++) {
+        const glm::vec3& center = centers.at(i);
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        radius[i] = radii.at(i);
+    }
+    classifyRows(rows.constData(), stride, count, true, locations.data(), insideMasks.data());
+
+    if (_keyholeRadius >= 0.0f) {
+        for (int i = 0; i < count; i++) {
+            if (locations.at(i) != INSIDE) {
+                location keyholeResult = sphereInKeyhole(centers.at(i), radii.at(i));
+                if (keyholeResult == INSIDE || locations.at(i) == OUTSIDE) {
+                    locations[i] = keyholeResult;
+                }
+            }
+        }
+    }
+}
+
+void ViewFrustum::classifyRows(const float* rows, int stride, int count, bool spheres, location* locations,
+        int* insideMasks) const {
+    const float* centerX = rows;
+    const float* centerY = centerX + stride;
+    const float* centerZ = centerY + stride;
+    const float* extentX = centerZ + stride;
+    const float* extentY = extentX + stride;
+    const float* extentZ = extentY + stride;
+
+    // a shape is outside a plane when its center's distance plus its reach along the normal, which for a box is the
+    // extent along the absolute normal, is behind it, and inside when the distance less the reach isn't
+    const int PLANES = 6;
+    for (int i = 0; i < count; i += 4) {
+        int masks[4];
+        for (int lane = 0; lane < 4; lane++) {
+            masks[lane] = (i + lane < count) ? (insideMasks[i + lane] & ALL_PLANES_INSIDE) : ALL_PLANES_INSIDE;
+        }
+        int known = masks[0] & masks[1] & masks[2] & masks[3];
+        int outsideMask = 0;
+#if defined(HIFI_FRUSTUM_SSE)
+        __m128 cx = _mm_loadu_ps(centerX + i), cy = _mm_loadu_ps(centerY + i), cz = _mm_loadu_ps(centerZ + i);
+        __m128 ex = _mm_loadu_ps(extentX + i), ey = ex, ez = ex;
+        if (!spheres) {
+            ey = _mm_loadu_ps(extentY + i);
+            ez = _mm_loadu_ps(extentZ + i);
+        }
+        __m128 zero = _mm_setzero_ps();
+        for (int plane = 0; plane < PLANES; plane++) {
+            if (known & (1 << plane)) {
+                continue; // every lane's parent was fully inside this one
+            }
+            const glm::vec3& normal = _planes[plane].getNormal();
+            __m128 distance = _mm_set1_ps(_planes[plane].getDCoefficient());
+            distance = _mm_add_ps(distance, _mm_mul_ps(cx, _mm_set1_ps(normal.x)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(normal.y)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(normal.z)));
+            __m128 reach = ex;
+            if (!spheres) {
+                reach = _mm_mul_ps(ex, _mm_set1_ps(fabsf(normal.x)));
+                reach = _mm_add_ps(reach, _mm_mul_ps(ey, _mm_set1_ps(fabsf(normal.y))));
+                reach = _mm_add_ps(reach, _mm_mul_ps(ez, _mm_set1_ps(fabsf(normal.z))));
+            }
+            int behind = _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+            int inside = _mm_movemask_ps(_mm_cmpge_ps(_mm_sub_ps(distance, reach), zero));
+#elif defined(HIFI_FRUSTUM_NEON)
+        float32x4_t cx = vld1q_f32(centerX + i), cy = vld1q_f32(centerY + i), cz = vld1q_f32(centerZ + i);
+        float32x4_t ex = vld1q_f32(extentX + i), ey = ex, ez = ex;
+        if (!spheres) {
+            ey = vld1q_f32(extentY + i);
+            ez = vld1q_f32(extentZ + i);
+        }
+        float32x4_t zero = vdupq_n_f32(0.0f);
+        for (int plane = 0; plane < PLANES; plane++) {
+            if (known & (1 << plane)) {
+                continue; // every lane's parent was fully inside this one
+            }
+            const glm::vec3& normal = _planes[plane].getNormal();
+            float32x4_t distance = vdupq_n_f32(_planes[plane].getDCoefficient());
+            distance = vmlaq_n_f32(distance, cx, normal.x);
+            distance = vmlaq_n_f32(distance, cy, normal.y);
+            distance = vmlaq_n_f32(distance, cz, normal.z);
+            float32x4_t reach = ex;
+            if (!spheres) {
+                reach = vmulq_n_f32(ex, fabsf(normal.x));
+                reach = vmlaq_n_f32(reach, ey, fabsf(normal.y));
+                reach = vmlaq_n_f32(reach, ez, fabsf(normal.z));
+            }
+            uint32x4_t behindLanes = vcltq_f32(vaddq_f32(distance, reach), zero);
+            uint32x4_t insideLanes = vcgeq_f32(vsubq_f32(distance, reach), zero);
+            int behind = (vgetq_lane_u32(behindLanes, 0) & 1) | (vgetq_lane_u32(behindLanes, 1) & 2) |
+                (vgetq_lane_u32(behindLanes, 2) & 4) | (vgetq_lane_u32(behindLanes, 3) & 8);
+            int inside = (vgetq_lane_u32(insideLanes, 0) & 1) | (vgetq_lane_u32(insideLanes, 1) & 2) |
+                (vgetq_lane_u32(insideLanes, 2) & 4) | (vgetq_lane_u32(insideLanes, 3) & 8);
+#else
+        const float* radius = extentX;
+        for (int plane = 0; plane < PLANES; plane++) {
+            if (known & (1 << plane)) {
+                continue; // every lane's parent was fully inside this one
+            }
+            const glm::vec3& normal = _planes[plane].getNormal();
+            int behind = 0;
+            int inside = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                int shape = i + lane;
+                float distance = _planes[plane].getDCoefficient() + centerX[shape] * normal.x +
+                    centerY[shape] * normal.y + centerZ[shape] * normal.z;
+                float reach = spheres ? radius[shape] : extentX[shape] * fabsf(normal.x) +
+                    extentY[shape] * fabsf(normal.y) + extentZ[shape] * fabsf(normal.z);
+                behind |= (distance + reach < 0.0f) ? (1 << lane) : 0;
+                inside |= (distance - reach >= 0.0f) ? (1 << lane) : 0;
+            }
+#endif
+            // the lanes whose parents were fully inside the plane keep that, whatever the rounding says
+            for (int lane = 0; lane < 4; lane++) {
+                if (masks[lane] & (1 << plane)) {
+                    behind &= ~(1 << lane);
+                } else if (inside & (1 << lane)) {
+                    masks[lane] |= (1 << plane);
+                }
+            }
+            outsideMask |= behind;
+        }
+        for (int lane = 0; lane < 4 && i + lane < count; lane++) {
+            insideMasks[i + lane] = masks[lane];
+            locations[i + lane] = (outsideMask & (1 << lane)) ? OUTSIDE :
+                (masks[lane] == ALL_PLANES_INSIDE ? INSIDE : INTERSECT);
+        }
+    }
+}
+
 bool testMatches(glm::quat lhs, glm::quat rhs, float epsilon = EPSILON) {
     return (fabs(lhs.x - rhs.x) <= epsilon && fabs(lhs.y - rhs.y) <= epsilon && fabs(lhs.z - rhs.z) <= epsilon
             && fabs(lhs.w - rhs.w) <= epsilon);
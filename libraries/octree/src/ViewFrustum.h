@@ -17,6 +17,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <QtCore/QVector>
+
 #include <GLMHelpers.h>
 #include <RegisteredMetaTypes.h>
 
@@ -100,6 +102,23 @@ public:
     ViewFrustum::location cubeInFrustum(const AACube& cube) const;
     ViewFrustum::location boxInFrustum(const AABox& box) const;
 
+    /// The bits of the masks that classifyBoxes and classifySpheres keep, one for each plane the shape is fully inside.
+    static const int ALL_PLANES_INSIDE = 0x3F;
+
+    /// Tests many boxes at once, setting each of outside to whether boxInFrustum would have found its box OUTSIDE.  The
+    /// planes take the boxes four at a time where there's SIMD to do it with.
+    void cullBoxes(const QVector<AABox>& boxes, QVector<bool>& outside) const;
+
+    /// Classifies many boxes at once, setting each of locations to what boxInFrustum would have found for its box.
+    /// Each of insideMasks starts as the planes its box is known to be fully inside, such as those its parent was,
+    /// which are skipped, and ends as all those the box is, for its own children to start from.  New entries start as
+    /// none.
+    void classifyBoxes(const QVector<AABox>& boxes, QVector<location>& locations, QVector<int>& insideMasks) const;
+
+    /// Classifies many spheres at once as classifyBoxes does boxes, each as sphereInFrustum would have found it.
+    void classifySpheres(const QVector<glm::vec3>& centers, const QVector<float>& radii, QVector<location>& locations,
+        QVector<int>& insideMasks) const;
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
@@ -132,6 +151,10 @@ private:
     ViewFrustum::location boxInKeyhole(const AABox& box) const;
 
     void calculateOrthographic();
+
+    // classifies the shapes in rows of center components followed by either half extents or radii, against the planes
+    void classifyRows(const float* rows, int stride, int count, bool spheres, location* locations,
+        int* insideMasks) const;
     
     // camera location/orientation attributes
     glm::vec3 _position = glm::vec3(0.0f); // the position in TREE_SCALE
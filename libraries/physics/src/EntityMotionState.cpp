@@ -19,6 +19,7 @@
 
 
 QSet<EntityItem*>* _outgoingEntityList;
+MotionStateOutbox* _motionStateOutbox;
 
 // static 
 void EntityMotionState::setOutgoingEntityList(QSet<EntityItem*>* list) {
@@ -32,8 +33,15 @@ void EntityMotionState::enqueueOutgoingEntity(EntityItem* entity) {
     _outgoingEntityList->insert(entity);
 }
 
+// static 
+void EntityMotionState::setMotionStateOutbox(MotionStateOutbox* outbox) {
+    assert(outbox);
+    _motionStateOutbox = outbox;
+}
+
 EntityMotionState::EntityMotionState(EntityItem* entity) 
-    :   _entity(entity) {
+    :   _entity(entity),
+        _outboxIndex(-1) {
     _type = MOTION_STATE_TYPE_ENTITY;
     assert(entity != NULL);
 }
@@ -57,9 +65,8 @@ void EntityMotionState::updateKinematicState(uint32_t substep) {
 
 void EntityMotionState::stepKinematicSimulation(quint64 now) {
     assert(_isKinematic);
-    // NOTE: this is non-physical kinematic motion which steps to real run-time (now)
-    // which is different from physical kinematic motion (inside getWorldTransform())
-    // which steps in physics simulation time.
+    // NOTE: this is kinematic motion which steps to real run-time (now), for a body in the physics simulation
+    // as well as for non-physical kinematic motion, the simulation reads it back in getWorldTransform()
     _entity->simulate(now);
 }
 
@@ -68,37 +75,53 @@ void EntityMotionState::stepKinematicSimulation(quint64 now) {
 //     (irregardless of MotionType: STATIC, DYNAMIC, or KINEMATIC)
 // (2) at the beginning of each simulation frame for KINEMATIC RigidBody's --
 //     it is an opportunity for outside code to update the object's simulation position
+// The simulation steps on the PhysicsThread so a KINEMATIC entity is not moved here, the PhysicsEngine moves it
+// (see stepKinematicSimulation()) while the EntityTree is locked and the body picks up wherever it got to.
 void EntityMotionState::getWorldTransform(btTransform& worldTrans) const {
-    if (_isKinematic) {
-        // This is physical kinematic motion which steps strictly by the subframe count
-        // of the physics simulation.
-        uint32_t substep = PhysicsEngine::getNumSubsteps();
-        float dt = (substep - _lastKinematicSubstep) * PHYSICS_ENGINE_FIXED_SUBSTEP;
-        _entity->simulateKinematicMotion(dt);
-        _entity->setLastSimulated(usecTimestampNow());
-
-        // bypass const-ness so we can remember the substep
-        const_cast<EntityMotionState*>(this)->_lastKinematicSubstep = substep;
-    }
     worldTrans.setOrigin(glmToBullet(_entity->getPositionInMeters() - ObjectMotionState::getWorldOffset()));
     worldTrans.setRotation(glmToBullet(_entity->getRotation()));
 }
 
 // This callback is invoked by the physics simulation at the end of each simulation frame...
 // iff the corresponding RigidBody is DYNAMIC and has moved.
+// The EntityTree isn't locked here so the new state waits in the outbox, where a body that moves again
+// before the outbox is applied just overwrites its entry.
 void EntityMotionState::setWorldTransform(const btTransform& worldTrans) {
-    _entity->setPositionInMeters(bulletToGLM(worldTrans.getOrigin()) + ObjectMotionState::getWorldOffset());
-    _entity->setRotation(bulletToGLM(worldTrans.getRotation()));
+    assert(_motionStateOutbox);
+    if (_outboxIndex < 0) {
+        _outboxIndex = _motionStateOutbox->size();
+        _motionStateOutbox->push_back(MotionStateOutboxEntry());
+    }
+    MotionStateOutboxEntry& entry = (*_motionStateOutbox)[_outboxIndex];
+    entry.motionState = this;
+    entry.position = bulletToGLM(worldTrans.getOrigin()) + ObjectMotionState::getWorldOffset();
+    entry.rotation = bulletToGLM(worldTrans.getRotation());
+    getVelocity(entry.velocity);
+    getAngularVelocity(entry.angularVelocity);
+    entry.simulatedAt = usecTimestampNow();
+}
 
-    glm::vec3 v;
-    getVelocity(v);
-    _entity->setVelocityInMeters(v);
+void EntityMotionState::applyOutboxEntry(const MotionStateOutboxEntry& entry, const quint64& now) {
+    // The simulation steps at its own fixed rate, so the entity is carried forward from the end of the step to the
+    // time it is drawn at, though never by more than the substep that would have followed.
+    float dt = 0.0f;
+    if (now > entry.simulatedAt) {
+        dt = glm::min((float)(now - entry.simulatedAt) / (float)USECS_PER_SECOND, PHYSICS_ENGINE_FIXED_SUBSTEP);
+    }
+    glm::quat rotation = entry.rotation;
+    float angularSpeed = glm::length(entry.angularVelocity);
+    const float MIN_INTERPOLATED_ANGULAR_SPEED = 1.0e-4f;
+    if (angularSpeed > MIN_INTERPOLATED_ANGULAR_SPEED) {
+        rotation = glm::angleAxis(angularSpeed * dt, entry.angularVelocity / angularSpeed) * rotation;
+    }
+    _entity->setPositionInMeters(entry.position + dt * entry.velocity);
+    _entity->setRotation(rotation);
+    _entity->setVelocityInMeters(entry.velocity);
 
-    getAngularVelocity(v);
     // DANGER! EntityItem stores angularVelocity in degrees/sec!!!
-    _entity->setAngularVelocity(glm::degrees(v));
+    _entity->setAngularVelocity(glm::degrees(entry.angularVelocity));
 
-    _entity->setLastSimulated(usecTimestampNow());
+    _entity->setLastSimulated(entry.simulatedAt + (quint64)(dt * (float)USECS_PER_SECOND));
 
     _outgoingPacketFlags = DIRTY_PHYSICS_FLAGS;
     EntityMotionState::enqueueOutgoingEntity(_entity);
@@ -250,7 +273,9 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, uint32_
             #ifdef WANT_DEBUG
                 qDebug() << "EntityMotionState::sendUpdate()... calling queueEditEntityMessage()...";
             #endif
-            entityPacketSender->queueEditEntityMessage(PacketTypeEntityAddOrEdit, id, properties);
+            // we're simulating this entity for the user, others should see it move without our batching delay,
+            // while the updates for bodies that settled or are at rest wait to be coalesced with other edits
+            entityPacketSender->queueEditEntityMessage(PacketTypeEntityAddOrEdit, id, properties, _sentMoving);
         } else {
             #ifdef WANT_DEBUG
                 qDebug() << "EntityMotionState::sendUpdate()... NOT sending update as requested.";
@@ -264,6 +289,10 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, uint32_
     }
 }
 
+float EntityMotionState::getMaxPositionError() const {
+    return _entity->getMaxExtrapolationError();
+}
+
 uint32_t EntityMotionState::getIncomingDirtyFlags() const { 
     uint32_t dirtyFlags = _entity->getDirtyFlags(); 
 
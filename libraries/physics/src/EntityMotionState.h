@@ -12,11 +12,29 @@
 #ifndef hifi_EntityMotionState_h
 #define hifi_EntityMotionState_h
 
+#include <QVector>
+
+#include <glm/gtc/quaternion.hpp>
+
 #include <AACube.h>
 
 #include "ObjectMotionState.h"
 
 class EntityItem;
+class EntityMotionState;
+
+// What the physics simulation moved a dynamic body to, held until the EntitySimulation is at a point where it already
+// has the EntityTree locked and can hand it to the EntityItem.
+struct MotionStateOutboxEntry {
+    EntityMotionState* motionState; // NULL once the entity has left the simulation
+    glm::vec3 position; // meters, in the domain-frame
+    glm::quat rotation;
+    glm::vec3 velocity; // meters/sec
+    glm::vec3 angularVelocity; // radians/sec
+    quint64 simulatedAt;
+};
+
+typedef QVector<MotionStateOutboxEntry> MotionStateOutbox;
 
 // From the MotionState's perspective:
 //      Inside = physics simulation
@@ -31,6 +49,10 @@ public:
     static void setOutgoingEntityList(QSet<EntityItem*>* list);
     static void enqueueOutgoingEntity(EntityItem* entity);
 
+    // The MotionStateOutbox is a pointer to a QVector (owned by the PhysicsEngine) that setWorldTransform() fills
+    // in place of the EntityItem, so the simulation step never has to lock the EntityTree.
+    static void setMotionStateOutbox(MotionStateOutbox* outbox);
+
     EntityMotionState() = delete; // prevent compiler from making default ctor
     EntityMotionState(EntityItem* item);
     virtual ~EntityMotionState();
@@ -44,9 +66,17 @@ public:
     // this relays incoming position/rotation to the RigidBody
     void getWorldTransform(btTransform& worldTrans) const;
 
-    // this relays outgoing position/rotation to the EntityItem
+    // this records outgoing position/rotation in the MotionStateOutbox
     void setWorldTransform(const btTransform& worldTrans);
 
+    // this relays what setWorldTransform() recorded to the EntityItem, carried forward to now,
+    // the EntityTree must be locked for write
+    void applyOutboxEntry(const MotionStateOutboxEntry& entry, const quint64& now);
+
+    /// \return index of this MotionState's entry in the MotionStateOutbox, or -1 if it has none
+    int getOutboxIndex() const { return _outboxIndex; }
+    void clearOutboxIndex() { _outboxIndex = -1; }
+
     // these relay incoming values to the RigidBody
     void updateObjectEasy(uint32_t flags, uint32_t frame);
     void updateObjectVelocities();
@@ -56,6 +86,8 @@ public:
 
     void sendUpdate(OctreeEditPacketSender* packetSender, uint32_t frame);
 
+    float getMaxPositionError() const;
+
     uint32_t getIncomingDirtyFlags() const;
     void clearIncomingDirtyFlags(uint32_t flags) { _entity->clearDirtyFlags(flags); }
 
@@ -63,6 +95,7 @@ public:
 
 protected:
     EntityItem* _entity;
+    int _outboxIndex;
 };
 
 #endif // hifi_EntityMotionState_h
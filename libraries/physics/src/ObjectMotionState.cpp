@@ -102,8 +102,14 @@ bool ObjectMotionState::doesNotNeedToSendUpdate() const {
     return !_body->isActive() && _numNonMovingUpdates > MAX_NUM_NON_MOVING_UPDATES;
 }
 
+// an object that just came to rest ranks with one twice over the error limit, so its final position goes out
+// ahead of most corrections, while the resends for objects at rest rank just at the limit
+const float SETTLED_SEND_PRIORITY = 2.0f;
+const float NON_MOVING_RESEND_PRIORITY = 1.0f;
+
 bool ObjectMotionState::shouldSendUpdate(uint32_t simulationFrame) {
     assert(_body);
+    _sendPriority = 0.0f;
     // if we've never checked before, our _sentFrame will be 0, and we need to initialize our state
     if (_sentFrame == 0) {
         _sentPosition = bulletToGLM(_body->getWorldTransform().getOrigin());
@@ -128,12 +134,14 @@ bool ObjectMotionState::shouldSendUpdate(uint32_t simulationFrame) {
     if (!isActive) {
         if (_sentMoving) { 
             // this object just went inactive so send an update immediately
+            _sendPriority = SETTLED_SEND_PRIORITY;
             return true;
         } else {
             const float NON_MOVING_UPDATE_PERIOD = 1.0f;
             if (dt > NON_MOVING_UPDATE_PERIOD && _numNonMovingUpdates < MAX_NUM_NON_MOVING_UPDATES) {
                 // RELIABLE_SEND_HACK: since we're not yet using a reliable method for non-moving update packets we repeat these
                 // at a faster rate than the MAX period above, and only send a limited number of them.
+                _sendPriority = NON_MOVING_RESEND_PRIORITY;
                 return true;
             }
         }
@@ -157,11 +165,13 @@ bool ObjectMotionState::shouldSendUpdate(uint32_t simulationFrame) {
     
     float dx2 = glm::distance2(position, _sentPosition);
 
-    const float MAX_POSITION_ERROR_SQUARED = 0.001f; // 0.001 m^2 ~~> 0.03 m
-    if (dx2 > MAX_POSITION_ERROR_SQUARED) {
+    float maxPositionError = getMaxPositionError();
+    float maxPositionErrorSquared = maxPositionError * maxPositionError;
+    _sendPriority = dx2 / maxPositionErrorSquared;
+    if (dx2 > maxPositionErrorSquared) {
 
         #ifdef WANT_DEBUG
-            qDebug() << ".... (dx2 > MAX_POSITION_ERROR_SQUARED) ....";
+            qDebug() << ".... (dx2 > maxPositionErrorSquared) ....";
             qDebug() << "wasPosition:" << wasPosition;
             qDebug() << "bullet position:" << position;
             qDebug() << "_sentPosition:" << _sentPosition;
@@ -201,7 +211,9 @@ bool ObjectMotionState::shouldSendUpdate(uint32_t simulationFrame) {
         }
     #endif
 
-    return (fabsf(glm::dot(actualRotation, _sentRotation)) < MIN_ROTATION_DOT);
+    float rotationDot = fabsf(glm::dot(actualRotation, _sentRotation));
+    _sendPriority = glm::max(_sendPriority, (1.0f - rotationDot) / (1.0f - MIN_ROTATION_DOT));
+    return (rotationDot < MIN_ROTATION_DOT);
 }
 
 void ObjectMotionState::setRigidBody(btRigidBody* body) {
@@ -87,7 +87,17 @@ public:
     void clearOutgoingPacketFlags(uint32_t flags) { _outgoingPacketFlags &= ~flags; }
 
     bool doesNotNeedToSendUpdate() const;
+
+    /// \return true if the object has strayed far enough from what the last update sent would extrapolate to,
+    /// how far is ranked by getSendPriority()
     virtual bool shouldSendUpdate(uint32_t simulationFrame);
+
+    /// \return how far, in meters, the object may stray from what the last update sent extrapolates to
+    virtual float getMaxPositionError() const { return DEFAULT_MAX_EXTRAPOLATION_ERROR; }
+
+    /// \return how badly the last shouldSendUpdate() found the object needs an update, 1.0 is an error right at
+    /// the limit and bigger is worse
+    float getSendPriority() const { return _sendPriority; }
     virtual void sendUpdate(OctreeEditPacketSender* packetSender, uint32_t frame) = 0;
 
     virtual MotionType computeMotionType() const = 0;
@@ -125,6 +135,7 @@ protected:
 
     uint32_t _outgoingPacketFlags;
     uint32_t _sentFrame;
+    float _sendPriority = 0.0f;
     glm::vec3 _sentPosition;    // in simulation-frame (not world-frame)
     glm::quat _sentRotation;;
     glm::vec3 _sentVelocity;
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "PhysicsEngine.h"
 #include "ShapeInfoUtil.h"
 #include "PhysicsHelpers.h"
@@ -30,31 +32,73 @@ PhysicsEngine::~PhysicsEngine() {
 
 // begin EntitySimulation overrides
 void PhysicsEngine::updateEntitiesInternal(const quint64& now) {
+    // NOTE: the grand order of operations is:
+    // (1) relay incoming changes
+    // (2) step simulation
+    // (3) synchronize outgoing motion states
+    // (4) send outgoing packets
+    //
+    // Step (2) runs on the PhysicsThread and (3) only fills the MotionStateOutbox, everything that reads or
+    // writes an EntityItem happens here where the EntityTree is locked for write while it updates its simulation.
+
+    // this is step (1)
+    relayIncomingChangesToSimulation();
+    stepKinematicObjects(now);
+
+    // the motion states the simulation synchronized in step (3) are handed to the entities,
+    // which puts them in _entitiesToBeSorted
+    applyMotionStateOutbox(now);
+
     // no need to send updates unless the physics simulation has actually stepped
     if (_lastNumSubstepsAtUpdateInternal != _numSubsteps) {
         _lastNumSubstepsAtUpdateInternal = _numSubsteps;
-        // NOTE: the grand order of operations is:
-        // (1) relay incoming changes
-        // (2) step simulation
-        // (3) synchronize outgoing motion states
-        // (4) send outgoing packets
+        computeCollisionEvents();
     
         // this is step (4)
+        QVector<OutgoingUpdate> candidates;
         QSet<ObjectMotionState*>::iterator stateItr = _outgoingPackets.begin();
         while (stateItr != _outgoingPackets.end()) {
             ObjectMotionState* state = *stateItr;
             if (state->doesNotNeedToSendUpdate()) {
                 stateItr = _outgoingPackets.erase(stateItr);
-            } else if (state->shouldSendUpdate(_numSubsteps)) {
-                state->sendUpdate(_entityPacketSender, _numSubsteps);
-                ++stateItr;
             } else {
+                if (state->shouldSendUpdate(_numSubsteps)) {
+                    OutgoingUpdate candidate = { state->getSendPriority(), state };
+                    candidates.push_back(candidate);
+                }
                 ++stateItr;
             }
         }
+        sendOutgoingUpdates(candidates, now);
     }
 }
 
+void PhysicsEngine::sendOutgoingUpdates(QVector<OutgoingUpdate>& candidates, const quint64& now) {
+    // the budget refills with time and keeps what goes unspent up to a burst
+    if (_lastOutgoingUpdateRefill > 0 && now > _lastOutgoingUpdateRefill) {
+        float elapsed = (float)(now - _lastOutgoingUpdateRefill) / (float)USECS_PER_SECOND;
+        _outgoingUpdateBudget = glm::min(_outgoingUpdateBudget + elapsed * _maxOutgoingUpdatesPerSecond,
+                                         (float)_maxOutgoingUpdateBurst);
+    }
+    _lastOutgoingUpdateRefill = now;
+
+    int numToSend = glm::min(candidates.size(), (int)_outgoingUpdateBudget);
+    if (numToSend < candidates.size()) {
+        // the ones furthest from what the server last heard go first, the rest are checked again next frame
+        // and rank higher the longer they wait
+        std::partial_sort(candidates.begin(), candidates.begin() + numToSend, candidates.end());
+    }
+    for (int i = 0; i < numToSend; ++i) {
+        candidates[i].state->sendUpdate(_entityPacketSender, _numSubsteps);
+    }
+    _outgoingUpdateBudget -= (float)numToSend;
+}
+
+void PhysicsEngine::setMaxOutgoingUpdatesPerSecond(int maxUpdatesPerSecond) {
+    _maxOutgoingUpdatesPerSecond = glm::max(maxUpdatesPerSecond, 1);
+    _maxOutgoingUpdateBurst = glm::max(_maxOutgoingUpdatesPerSecond / OUTGOING_UPDATE_BURSTS_PER_SECOND, 1);
+}
+
 void PhysicsEngine::addEntityInternal(EntityItem* entity) {
     assert(entity);
     void* physicsInfo = entity->getPhysicsInfo();
@@ -94,6 +138,9 @@ void PhysicsEngine::removeEntityInternal(EntityItem* entity) {
         _entityMotionStates.remove(motionState);
         _incomingChanges.remove(motionState);
         _outgoingPackets.remove(motionState);
+        if (motionState->getOutboxIndex() >= 0) {
+            _motionStateOutbox[motionState->getOutboxIndex()].motionState = NULL;
+        }
         // NOTE: EntityMotionState dtor will remove its backpointer from EntityItem
         delete motionState;
     }
@@ -137,6 +184,7 @@ void PhysicsEngine::clearEntitiesInternal() {
     _nonPhysicalKinematicObjects.clear();
     _incomingChanges.clear();
     _outgoingPackets.clear();
+    _motionStateOutbox.resize(0);
 }
 // end EntitySimulation overrides
 
@@ -212,7 +260,11 @@ void PhysicsEngine::relayIncomingChangesToSimulation() {
             // if we get here then there is no need to keep this motionState around (no physics or kinematics)
             _outgoingPackets.remove(motionState);
             if (motionState->getType() == MOTION_STATE_TYPE_ENTITY) {
-                _entityMotionStates.remove(static_cast<EntityMotionState*>(motionState));
+                EntityMotionState* entityMotionState = static_cast<EntityMotionState*>(motionState);
+                _entityMotionStates.remove(entityMotionState);
+                if (entityMotionState->getOutboxIndex() >= 0) {
+                    _motionStateOutbox[entityMotionState->getOutboxIndex()].motionState = NULL;
+                }
             }
             // NOTE: motionState will clean up its own backpointers in the Object
             delete motionState;
@@ -258,6 +310,7 @@ void PhysicsEngine::init(EntityEditPacketSender* packetSender) {
         _broadphaseFilter = new btDbvtBroadphase();
         _constraintSolver = new btSequentialImpulseConstraintSolver;
         _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver, _collisionConfig);
+        _dynamicsWorld->setNumSolverThreads(_numSolverThreads);
 
         // default gravity of the world is zero, so each object must specify its own gravity
         // TODO: set up gravity zones
@@ -267,19 +320,14 @@ void PhysicsEngine::init(EntityEditPacketSender* packetSender) {
     assert(packetSender);
     _entityPacketSender = packetSender;
     EntityMotionState::setOutgoingEntityList(&_entitiesToBeSorted);
+    EntityMotionState::setMotionStateOutbox(&_motionStateOutbox);
 }
 
 void PhysicsEngine::stepSimulation() {
     lock();
-    // NOTE: the grand order of operations is:
-    // (1) relay incoming changes
-    // (2) step simulation
-    // (3) synchronize outgoing motion states
-    // (4) send outgoing packets
-
-    // This is step (1).
-    relayIncomingChangesToSimulation();
+    // NOTE: steps (1) and (4) of the grand order of operations happen in updateEntitiesInternal()
 
+    // a step that falls further behind than this drops the difference rather than spiralling into ever longer steps
     const int MAX_NUM_SUBSTEPS = 4;
     const float MAX_TIMESTEP = (float)MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
     float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
@@ -287,42 +335,64 @@ void PhysicsEngine::stepSimulation() {
     float timeStep = btMin(dt, MAX_TIMESTEP);
 
     // This is step (2).
+    quint64 stepStart = usecTimestampNow();
     int numSubsteps = _dynamicsWorld->stepSimulation(timeStep, MAX_NUM_SUBSTEPS, PHYSICS_ENGINE_FIXED_SUBSTEP);
     _numSubsteps += (uint32_t)numSubsteps;
-    stepNonPhysicalKinematics(usecTimestampNow());
-    unlock();
+    if (numSubsteps > 0) {
+        int numSubstepsTaken = glm::min(numSubsteps, MAX_NUM_SUBSTEPS);
+        _substepUsecs.updateAverage((float)(usecTimestampNow() - stepStart) / (float)numSubstepsTaken);
+        _solveUsecs.updateAverage((float)_dynamicsWorld->getLastSolveUsecs());
+    }
 
     if (numSubsteps > 0) {
-        // This is step (3) which is done outside of stepSimulation() so we can lock _entityTree.
-        //
-        // Unfortunately we have to unlock the simulation (above) before we try to lock the _entityTree
-        // to avoid deadlock -- the _entityTree may try to lock its EntitySimulation (from which this 
-        // PhysicsEngine derives) when updating/adding/deleting entities so we need to wait for our own
-        // lock on the tree before we re-lock ourselves.
-        //
-        // TODO: untangle these lock sequences.
-        _entityTree->lockForWrite();
-        lock();
+        // This is step (3) which is done outside of stepSimulation() so the motion states are only synchronized once.
+        // It only fills the MotionStateOutbox, the _entityTree is never locked here and the entities get their new
+        // state the next time the tree updates its simulation (see applyMotionStateOutbox()).
         _dynamicsWorld->synchronizeMotionStates();
-        unlock();
-        _entityTree->unlock();
-    
-        computeCollisionEvents();
+        updateContacts();
+    }
+    unlock();
+}
+
+void PhysicsEngine::setNumSolverThreads(int numThreads) {
+    lock();
+    _numSolverThreads = glm::max(numThreads, 1);
+    if (_dynamicsWorld) {
+        _dynamicsWorld->setNumSolverThreads(_numSolverThreads);
     }
+    unlock();
 }
 
-void PhysicsEngine::stepNonPhysicalKinematics(const quint64& now) {
-    QSet<ObjectMotionState*>::iterator stateItr = _nonPhysicalKinematicObjects.begin();
-    while (stateItr != _nonPhysicalKinematicObjects.end()) {
-        ObjectMotionState* motionState = *stateItr;
-        motionState->stepKinematicSimulation(now);
+void PhysicsEngine::applyMotionStateOutbox(const quint64& now) {
+    if (_motionStateOutbox.isEmpty()) {
+        return;
+    }
+    _appliedMotionStates.swap(_motionStateOutbox);
+    for (int i = 0; i < _appliedMotionStates.size(); ++i) {
+        const MotionStateOutboxEntry& entry = _appliedMotionStates[i];
+        if (entry.motionState) {
+            entry.motionState->clearOutboxIndex();
+            entry.motionState->applyOutboxEntry(entry, now);
+        }
+    }
+    _appliedMotionStates.resize(0);
+}
+
+void PhysicsEngine::stepKinematicObjects(const quint64& now) {
+    // kinematic bodies in the dynamics world are moved here too, getWorldTransform() only reads them
+    QSet<EntityMotionState*>::iterator stateItr = _entityMotionStates.begin();
+    while (stateItr != _entityMotionStates.end()) {
+        EntityMotionState* motionState = *stateItr;
+        if (motionState->isKinematic()) {
+            motionState->stepKinematicSimulation(now);
+        }
         ++stateItr;
     }
 }
 
 // TODO?: need to occasionally scan for stopped non-physical kinematics objects
 
-void PhysicsEngine::computeCollisionEvents() {
+void PhysicsEngine::updateContacts() {
     // update all contacts every frame
     int numManifolds = _collisionDispatcher->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i) {
@@ -347,7 +417,9 @@ void PhysicsEngine::computeCollisionEvents() {
             }
         }
     }
-    
+}
+
+void PhysicsEngine::computeCollisionEvents() {
     // We harvest collision callbacks every few frames, which contributes the following effects:
     //
     // (1) There is a maximum collision callback rate per pair:  substep_rate / SUBSTEPS_PER_COLLIION_FRAME
@@ -370,20 +442,27 @@ void PhysicsEngine::computeCollisionEvents() {
         ObjectMotionState* A = static_cast<ObjectMotionState*>(contactItr->first._a);
         ObjectMotionState* B = static_cast<ObjectMotionState*>(contactItr->first._b);
 
+        // manifolds of the same pair with its bodies in either order are one collision
+        bool duplicate = A > B && _contactMap.find(ContactKey(B, A)) != _contactMap.end();
+
         // TODO: make triggering these events clean and efficient.  The code at this context shouldn't 
         // have to figure out what kind of object (entity, avatar, etc) these are in order to properly 
         // emit a collision event.
-        if (A && A->getType() == MOTION_STATE_TYPE_ENTITY) {
-            EntityItemID idA = static_cast<EntityMotionState*>(A)->getEntity()->getEntityItemID();
-            EntityItemID idB;
+        if (duplicate) {
+            // already reported under the key that sorts first
+        } else if (A && A->getType() == MOTION_STATE_TYPE_ENTITY) {
+            EntityCollision event;
+            event.idA = static_cast<EntityMotionState*>(A)->getEntity()->getEntityItemID();
             if (B && B->getType() == MOTION_STATE_TYPE_ENTITY) {
-                idB = static_cast<EntityMotionState*>(B)->getEntity()->getEntityItemID();
+                event.idB = static_cast<EntityMotionState*>(B)->getEntity()->getEntityItemID();
             }
-            emit entityCollisionWithEntity(idA, idB, contactItr->second);
+            event.collision = contactItr->second;
+            _collisionEvents.push_back(event);
         } else if (B && B->getType() == MOTION_STATE_TYPE_ENTITY) {
-            EntityItemID idA;
-            EntityItemID idB = static_cast<EntityMotionState*>(B)->getEntity()->getEntityItemID();
-            emit entityCollisionWithEntity(idA, idB, contactItr->second);
+            EntityCollision event;
+            event.idB = static_cast<EntityMotionState*>(B)->getEntity()->getEntityItemID();
+            event.collision = contactItr->second;
+            _collisionEvents.push_back(event);
         }
 
         // TODO: enable scripts to filter based on contact event type
@@ -398,6 +477,17 @@ void PhysicsEngine::computeCollisionEvents() {
     }
 }
 
+void PhysicsEngine::dispatchCollisionEvents() {
+    EntityCollisions events;
+    lock();
+    events.swap(_collisionEvents);
+    unlock();
+
+    if (!events.isEmpty()) {
+        emit entityCollisions(events);
+    }
+}
+
 // Bullet collision flags are as follows:
 // CF_STATIC_OBJECT= 1,
 // CF_KINEMATIC_OBJECT= 2,
@@ -463,10 +553,8 @@ void PhysicsEngine::removeObjectFromBullet(ObjectMotionState* motionState) {
     btRigidBody* body = motionState->getRigidBody();
     if (body) {
         const btCollisionShape* shape = body->getCollisionShape();
-        ShapeInfo shapeInfo;
-        ShapeInfoUtil::collectInfoFromShape(shape, shapeInfo);
         _dynamicsWorld->removeRigidBody(body);
-        _shapeManager.releaseShape(shapeInfo);
+        _shapeManager.releaseShape(shape);
         // NOTE: setRigidBody() modifies body->m_userPointer so we should clear the MotionState's body BEFORE deleting it.
         motionState->setRigidBody(NULL);
         delete body;
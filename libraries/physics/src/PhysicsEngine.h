@@ -15,10 +15,12 @@
 #include <stdint.h>
 
 #include <QSet>
+#include <QVector>
 #include <btBulletDynamicsCommon.h>
 
 #include <EntityItem.h>
 #include <EntitySimulation.h>
+#include <SimpleMovingAverage.h>
 
 #include "BulletUtil.h"
 #include "ContactInfo.h"
@@ -44,6 +46,21 @@ public:
 typedef std::map<ContactKey, ContactInfo> ContactMap;
 typedef std::pair<ContactKey, ContactInfo> ContactMapElement;
 
+// the physics sends at most this many entity updates a second, however many bodies are moving
+const int DEFAULT_MAX_OUTGOING_UPDATES_PER_SECOND = 200;
+
+// the budget can save up a quarter second of updates for the frames where many objects move or settle at once
+const int OUTGOING_UPDATE_BURSTS_PER_SECOND = 4;
+
+class OutgoingUpdate {
+public:
+    // highest priority first
+    bool operator<(const OutgoingUpdate& other) const { return priority > other.priority; }
+
+    float priority;
+    ObjectMotionState* state;
+};
+
 class PhysicsEngine : public EntitySimulation {
 public:
     // TODO: find a good way to make this a non-static method
@@ -64,11 +81,23 @@ public:
 
     virtual void init(EntityEditPacketSender* packetSender);
 
+    /// steps the dynamics world by the real time since the last call, in PHYSICS_ENGINE_FIXED_SUBSTEP substeps,
+    /// this is called by the PhysicsThread and never touches an EntityItem
     void stepSimulation();
-    void stepNonPhysicalKinematics(const quint64& now);
 
+    /// moves kinematic objects (in and out of the dynamics world) to real run-time
+    void stepKinematicObjects(const quint64& now);
+
+    /// updates the contacts with what the last step found, called by stepSimulation()
+    void updateContacts();
+
+    /// turns contacts into collision events for dispatchCollisionEvents(), the EntityTree must be locked
     void computeCollisionEvents();
 
+    /// emits the collision events computed since the last call, called from the thread the EntityTree is updated on
+    /// without the tree or simulation locked so handlers are free to use either
+    void dispatchCollisionEvents();
+
     /// \param offset position of simulation origin in domain-frame
     void setOriginOffset(const glm::vec3& offset) { _originOffset = offset; }
 
@@ -82,12 +111,31 @@ public:
     /// process queue of changed from external sources
     void relayIncomingChangesToSimulation();
 
+    /// \param numThreads number of threads the simulation islands may be solved on, 1 solves them all on the thread
+    /// that steps the simulation
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const { return _numSolverThreads; }
+
+    /// \return average microseconds a substep of the simulation takes, and how much of that is solving its islands
+    float getAverageSubstepUsecs() const { return _substepUsecs.getAverage(); }
+    float getAverageSolveUsecs() const { return _solveUsecs.getAverage(); }
+
+    /// bounds how many entity updates a second the simulation sends, whatever the number of moving bodies
+    void setMaxOutgoingUpdatesPerSecond(int maxUpdatesPerSecond);
+    int getMaxOutgoingUpdatesPerSecond() const { return _maxOutgoingUpdatesPerSecond; }
+
+    /// hands what the simulation steps moved to their EntityItems, the EntityTree must be locked for write
+    void applyMotionStateOutbox(const quint64& now);
+
 private:
     /// \param motionState pointer to Object's MotionState
     void removeObjectFromBullet(ObjectMotionState* motionState);
 
     void removeContacts(ObjectMotionState* motionState);
 
+    /// sends as many of the candidates as the budget allows, those that strayed furthest first
+    void sendOutgoingUpdates(QVector<OutgoingUpdate>& candidates, const quint64& now);
+
     // return 'true' of update was successful
     bool updateObjectHard(btRigidBody* body, ObjectMotionState* motionState, uint32_t flags);
     void updateObjectEasy(btRigidBody* body, ObjectMotionState* motionState, uint32_t flags);
@@ -107,12 +155,24 @@ private:
     QSet<ObjectMotionState*> _nonPhysicalKinematicObjects; // not in physics simulation, but still need kinematic simulation
     QSet<ObjectMotionState*> _incomingChanges; // entities with pending physics changes by script or packet
     QSet<ObjectMotionState*> _outgoingPackets; // MotionStates with pending changes that need to be sent over wire
+    MotionStateOutbox _motionStateOutbox; // filled by synchronizeMotionStates() without the EntityTree locked
+    MotionStateOutbox _appliedMotionStates; // swapped with the above when applied, so both keep their capacity
 
     EntityEditPacketSender* _entityPacketSender = NULL;
 
     ContactMap _contactMap;
+    EntityCollisions _collisionEvents; // computed, waiting for dispatchCollisionEvents()
     uint32_t _numContactFrames = 0;
     uint32_t _lastNumSubstepsAtUpdateInternal = 0;
+
+    int _numSolverThreads = 1;
+
+    int _maxOutgoingUpdatesPerSecond = DEFAULT_MAX_OUTGOING_UPDATES_PER_SECOND;
+    int _maxOutgoingUpdateBurst = DEFAULT_MAX_OUTGOING_UPDATES_PER_SECOND / OUTGOING_UPDATE_BURSTS_PER_SECOND;
+    float _outgoingUpdateBudget = (float)(DEFAULT_MAX_OUTGOING_UPDATES_PER_SECOND / OUTGOING_UPDATE_BURSTS_PER_SECOND);
+    quint64 _lastOutgoingUpdateRefill = 0;
+    SimpleMovingAverage _substepUsecs;
+    SimpleMovingAverage _solveUsecs;
 };
 
 #endif // hifi_PhysicsEngine_h
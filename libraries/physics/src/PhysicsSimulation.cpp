@@ -11,6 +11,8 @@
 
 #include <glm/glm.hpp>
 
+#include <QRunnable>
+
 #include <PerfStat.h>
 #include <SharedUtil.h>
 
@@ -24,6 +26,59 @@ int MAX_DOLLS_PER_SIMULATION = 16;
 int MAX_ENTITIES_PER_SIMULATION = 64;
 int MAX_COLLISIONS_PER_SIMULATION = 256;
 
+// fewer ragdolls than this per job aren't worth handing to another thread
+static const int MIN_RAGDOLLS_PER_JOB = 4;
+
+/// Steps forward or relaxes a run of ragdolls, each of which only touches its own VerletPoints.
+class RagdollJob : public QRunnable {
+public:
+    RagdollJob(Ragdoll* const* ragdolls, int numRagdolls, float deltaTime, float* maxError) :
+        _ragdolls(ragdolls),
+        _numRagdolls(numRagdolls),
+        _deltaTime(deltaTime),
+        _maxError(maxError) { }
+
+    virtual void run() {
+        if (_maxError) {
+            float error = 0.0f;
+            for (int i = 0; i < _numRagdolls; ++i) {
+                error = glm::max(error, _ragdolls[i]->enforceConstraints());
+            }
+            *_maxError = error;
+        } else {
+            for (int i = 0; i < _numRagdolls; ++i) {
+                _ragdolls[i]->stepForward(_deltaTime);
+            }
+        }
+    }
+
+private:
+    Ragdoll* const* _ragdolls;
+    int _numRagdolls;
+    float _deltaTime;
+    float* _maxError; // NULL to step forward
+};
+
+/// runs the job over all ragdolls, the calling thread taking the first run while the pool takes the rest
+static void runRagdollJobs(QThreadPool& pool, const QVector<Ragdoll*>& ragdolls, float deltaTime,
+                           QVector<float>* errors) {
+    int numRagdolls = ragdolls.size();
+    int numJobs = glm::clamp(numRagdolls / MIN_RAGDOLLS_PER_JOB, 1, pool.maxThreadCount() + 1);
+    if (errors) {
+        errors->fill(0.0f, numJobs);
+    }
+    int ragdollsPerJob = (numRagdolls + numJobs - 1) / numJobs;
+    for (int i = 1; i < numJobs; ++i) {
+        int first = i * ragdollsPerJob;
+        RagdollJob* job = new RagdollJob(ragdolls.constData() + first, glm::min(ragdollsPerJob, numRagdolls - first),
+                                         deltaTime, errors ? errors->data() + i : NULL);
+        job->setAutoDelete(true);
+        pool.start(job);
+    }
+    RagdollJob(ragdolls.constData(), glm::min(ragdollsPerJob, numRagdolls), deltaTime,
+               errors ? errors->data() : NULL).run();
+    pool.waitForDone();
+}
 
 PhysicsSimulation::PhysicsSimulation() : _translation(0.0f), _frameCount(0), _entity(NULL), _ragdoll(NULL), 
         _collisions(MAX_COLLISIONS_PER_SIMULATION) {
@@ -47,6 +102,7 @@ void PhysicsSimulation::clear() {
     // but Ragdolls do not
     _ragdoll = NULL;
     _otherRagdolls.clear();
+    _allRagdolls.clear();
 
     // contacts have backpointers to shapes so we clear them
     _contacts.clear();
@@ -213,16 +269,7 @@ void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIter
 
     integrate(deltaTime);
     enforceContacts();
-    int numDolls = _otherRagdolls.size();
-    {
-        PerformanceTimer perfTimer("enforce");
-        if (_ragdoll) {
-            _ragdoll->enforceConstraints();
-        }
-        for (int i = 0; i < numDolls; ++i) {
-            _otherRagdolls[i]->enforceConstraints();
-        }
-    }
+    enforceRagdollConstraints();
 
     bool collidedWithOtherRagdoll = false;
     int iterations = 0;
@@ -232,15 +279,7 @@ void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIter
         updateContacts();
         resolveCollisions();
 
-        { // enforce constraints
-            PerformanceTimer perfTimer("enforce");
-            if (_ragdoll) {
-                error = _ragdoll->enforceConstraints();
-            }
-            for (int i = 0; i < numDolls; ++i) {
-                error = glm::max(error, _otherRagdolls[i]->enforceConstraints());
-            }
-        }
+        error = enforceRagdollConstraints();
         applyContactFriction();
         ++iterations;
 
@@ -255,6 +294,7 @@ void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIter
     }
 
     // also remove any offsets from the other ragdolls
+    int numDolls = _otherRagdolls.size();
     for (int i = 0; i < numDolls; ++i) {
         _otherRagdolls[i]->removeRootOffset(false);
     }
@@ -288,22 +328,37 @@ bool PhysicsSimulation::getShapeCollisions(const Shape* shape, CollisionList& co
 }
 
 void PhysicsSimulation::integrate(float deltaTime) {
-    PerformanceTimer perfTimer("integrate");
+    PERFORMANCE_TIMER("integrate");
     int numEntities = _otherEntities.size();
     for (int i = 0; i < numEntities; ++i) {
         _otherEntities[i]->stepForward(deltaTime);
     }
+
+    _allRagdolls.clear();
     if (_ragdoll) {
-        _ragdoll->stepForward(deltaTime);
+        _allRagdolls.push_back(_ragdoll);
     }
-    int numDolls = _otherRagdolls.size();
-    for (int i = 0; i < numDolls; ++i) {
-        _otherRagdolls[i]->stepForward(deltaTime);
+    _allRagdolls += _otherRagdolls;
+    if (!_allRagdolls.isEmpty()) {
+        runRagdollJobs(_ragdollPool, _allRagdolls, deltaTime, NULL);
+    }
+}
+
+float PhysicsSimulation::enforceRagdollConstraints() {
+    PERFORMANCE_TIMER("enforce");
+    if (_allRagdolls.isEmpty()) {
+        return 0.0f;
+    }
+    runRagdollJobs(_ragdollPool, _allRagdolls, 0.0f, &_ragdollErrors);
+    float maxError = 0.0f;
+    foreach (float error, _ragdollErrors) {
+        maxError = glm::max(maxError, error);
     }
+    return maxError;
 }
 
 bool PhysicsSimulation::computeCollisions() {
-    PerformanceTimer perfTimer("collide");
+    PERFORMANCE_TIMER("collide");
     _collisions.clear();
 
     const QVector<Shape*> shapes = _entity->getShapes();
@@ -333,7 +388,7 @@ bool PhysicsSimulation::computeCollisions() {
 }
 
 void PhysicsSimulation::resolveCollisions() {
-    PerformanceTimer perfTimer("resolve");
+    PERFORMANCE_TIMER("resolve");
     // walk all collisions, accumulate movement on shapes, and build a list of affected shapes
     QSet<Shape*> shapes;
     int numCollisions = _collisions.size();
@@ -356,7 +411,7 @@ void PhysicsSimulation::resolveCollisions() {
 }
 
 void PhysicsSimulation::enforceContacts() {
-    PerformanceTimer perfTimer("contacts");
+    PERFORMANCE_TIMER("contacts");
     QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
     while (itr != _contacts.end()) {
         itr.value().enforce();
@@ -365,7 +420,7 @@ void PhysicsSimulation::enforceContacts() {
 }
 
 void PhysicsSimulation::applyContactFriction() {
-    PerformanceTimer perfTimer("contacts");
+    PERFORMANCE_TIMER("contacts");
     QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
     while (itr != _contacts.end()) {
         itr.value().applyFriction();
@@ -374,7 +429,7 @@ void PhysicsSimulation::applyContactFriction() {
 }
 
 void PhysicsSimulation::updateContacts() {
-    PerformanceTimer perfTimer("contacts");
+    PERFORMANCE_TIMER("contacts");
     int numCollisions = _collisions.size();
     for (int i = 0; i < numCollisions; ++i) {
         CollisionInfo* collision = _collisions.getCollision(i);
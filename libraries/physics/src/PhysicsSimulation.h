@@ -14,6 +14,7 @@
 
 #include <QtGlobal>
 #include <QMap>
+#include <QThreadPool>
 #include <QVector>
 
 #include "CollisionInfo.h"
@@ -64,6 +65,10 @@ public:
 protected:
     void integrate(float deltaTime);
 
+    /// enforces the constraints of every ragdoll, spread over the ragdoll pool when there are enough of them
+    /// \return max distance of point movement
+    float enforceRagdollConstraints();
+
     /// \return true if main ragdoll collides with other avatar
     bool computeCollisions();
 
@@ -85,6 +90,11 @@ private:
     QVector<PhysicsEntity*> _otherEntities;
     CollisionList _collisions;
     QMap<quint64, ContactPoint> _contacts;
+
+    // every ragdoll moves only its own points, so they're stepped and relaxed side by side
+    QThreadPool _ragdollPool;
+    QVector<Ragdoll*> _allRagdolls; // scratch, _ragdoll followed by _otherRagdolls
+    QVector<float> _ragdollErrors; // scratch, max movement per ragdoll job
 };
 
 #endif // hifi_PhysicsSimulation_h
@@ -0,0 +1,37 @@
+//
+//  PhysicsThread.cpp
+//  libraries/physics/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <PhysicsHelpers.h>
+#include <SharedUtil.h>
+
+#include "PhysicsEngine.h"
+
+#include "PhysicsThread.h"
+
+static const quint64 USECS_PER_SUBSTEP = (quint64)(PHYSICS_ENGINE_FIXED_SUBSTEP * (float)USECS_PER_SECOND);
+
+PhysicsThread::PhysicsThread(PhysicsEngine* engine) :
+    _engine(engine)
+{
+}
+
+bool PhysicsThread::process() {
+    quint64 start = usecTimestampNow();
+    _engine->stepSimulation();
+
+    if (isThreaded()) {
+        // sleep out the rest of the substep, a step that ran long is caught up by the next one
+        quint64 elapsed = usecTimestampNow() - start;
+        if (elapsed < USECS_PER_SUBSTEP) {
+            usleep(USECS_PER_SUBSTEP - elapsed);
+        }
+    }
+    return isStillRunning();
+}
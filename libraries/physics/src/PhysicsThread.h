@@ -0,0 +1,32 @@
+//
+//  PhysicsThread.h
+//  libraries/physics/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsThread_h
+#define hifi_PhysicsThread_h
+
+#include <GenericThread.h>
+
+class PhysicsEngine;
+
+/// Steps a PhysicsEngine at PHYSICS_ENGINE_FIXED_SUBSTEP on its own thread, so the cost of the simulation doesn't come
+/// out of the frame and a slow frame doesn't hold the simulation back. The entities only see the results when their
+/// EntityTree next updates its simulation.
+class PhysicsThread : public GenericThread {
+    Q_OBJECT
+public:
+    PhysicsThread(PhysicsEngine* engine);
+
+    virtual bool process();
+
+private:
+    PhysicsEngine* _engine;
+};
+
+#endif // hifi_PhysicsThread_h
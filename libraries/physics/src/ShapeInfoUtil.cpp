@@ -30,6 +30,9 @@ int ShapeInfoUtil::toBulletShapeType(int shapeInfoType) {
         case CYLINDER_SHAPE:
             bulletShapeType = CYLINDER_SHAPE_PROXYTYPE;
             break;
+        case COMPOUND_SHAPE:
+            bulletShapeType = COMPOUND_SHAPE_PROXYTYPE;
+            break;
     }
     return bulletShapeType;
 }
@@ -49,6 +52,9 @@ int ShapeInfoUtil::fromBulletShapeType(int bulletShapeType) {
         case CYLINDER_SHAPE_PROXYTYPE:
             shapeInfoType = CYLINDER_SHAPE;
             break;
+        case COMPOUND_SHAPE_PROXYTYPE:
+            shapeInfoType = COMPOUND_SHAPE;
+            break;
     }
     return shapeInfoType;
 }
@@ -115,6 +121,22 @@ btCollisionShape* ShapeInfoUtil::createShapeFromInfo(const ShapeInfo& info) {
             shape = new btCapsuleShape(radius, height);
         }
         break;
+        case COMPOUND_SHAPE: {
+            const QVector<QVector<glm::vec3> >& hulls = info.getConvexHulls();
+            btCompoundShape* compound = new btCompoundShape();
+            btTransform identity;
+            identity.setIdentity();
+            foreach (const QVector<glm::vec3>& hull, hulls) {
+                btConvexHullShape* hullShape = new btConvexHullShape();
+                foreach (const glm::vec3& point, hull) {
+                    hullShape->addPoint(glmToBullet(point), false);
+                }
+                hullShape->recalcLocalAabb();
+                compound->addChildShape(identity, hullShape);
+            }
+            shape = compound;
+        }
+        break;
     }
     return shape;
 }
@@ -140,6 +162,10 @@ DoubleHashKey ShapeInfoUtil::computeHash(const ShapeInfo& info) {
             hash ^= floatHash;
         }
     }
+    if (!info.getURL().isEmpty()) {
+        // hulls the same size but from different models
+        hash ^= DoubleHashKey::hashFunction((unsigned int)qHash(info.getURL()), primeIndex++);
+    }
     key._hash = (int)hash;
 
     // compute hash2
@@ -162,6 +188,11 @@ DoubleHashKey ShapeInfoUtil::computeHash(const ShapeInfo& info) {
             hash = (hash << 16) | (hash >> 16);
         }
     }
+    if (!info.getURL().isEmpty()) {
+        unsigned int urlHash = DoubleHashKey::hashFunction2((unsigned int)qHash(info.getURL()));
+        hash += ~(urlHash << 17);
+        hash ^=  (urlHash >> 11);
+    }
     key._hash2 = (int)hash;
     return key;
 }
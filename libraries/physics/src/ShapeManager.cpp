@@ -14,6 +14,17 @@
 #include "ShapeInfoUtil.h"
 #include "ShapeManager.h"
 
+// a compound doesn't own its children, the hulls ShapeInfoUtil made for it go with it
+static void deleteShape(btCollisionShape* shape) {
+    if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) {
+        btCompoundShape* compound = static_cast<btCompoundShape*>(shape);
+        for (int i = compound->getNumChildShapes() - 1; i >= 0; --i) {
+            delete compound->getChildShape(i);
+        }
+    }
+    delete shape;
+}
+
 ShapeManager::ShapeManager() {
 }
 
@@ -21,9 +32,10 @@ ShapeManager::~ShapeManager() {
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
-        delete shapeRef->_shape;
+        deleteShape(shapeRef->_shape);
     }
     _shapeMap.clear();
+    _shapeKeys.clear();
 }
 
 btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
@@ -46,12 +58,16 @@ btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         newRef._refCount = 1;
         newRef._shape = shape;
         _shapeMap.insert(key, newRef);
+        _shapeKeys.insert(btHashPtr(shape), key);
     }
     return shape;
 }
 
 bool ShapeManager::releaseShape(const ShapeInfo& info) {
-    DoubleHashKey key = ShapeInfoUtil::computeHash(info);
+    return releaseShape(ShapeInfoUtil::computeHash(info));
+}
+
+bool ShapeManager::releaseShape(const DoubleHashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
     if (shapeRef) {
         if (shapeRef->_refCount > 0) {
@@ -76,9 +92,13 @@ bool ShapeManager::releaseShape(const ShapeInfo& info) {
 }
 
 bool ShapeManager::releaseShape(const btCollisionShape* shape) {
-    ShapeInfo info;
-    ShapeInfoUtil::collectInfoFromShape(shape, info);
-    return releaseShape(info);
+    const DoubleHashKey* key = _shapeKeys.find(btHashPtr(shape));
+    if (key) {
+        return releaseShape(*key);
+    }
+    // attempt to remove unmanaged shape
+    assert(false);
+    return false;
 }
 
 void ShapeManager::collectGarbage() {
@@ -87,7 +107,8 @@ void ShapeManager::collectGarbage() {
         DoubleHashKey& key = _pendingGarbage[i];
         ShapeReference* shapeRef = _shapeMap.find(key);
         if (shapeRef && shapeRef->_refCount == 0) {
-            delete shapeRef->_shape;
+            _shapeKeys.remove(btHashPtr(shapeRef->_shape));
+            deleteShape(shapeRef->_shape);
             _shapeMap.remove(key);
         }
     }
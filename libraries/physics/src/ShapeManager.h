@@ -40,6 +40,8 @@ public:
     int getNumReferences(const ShapeInfo& info) const;
 
 private:
+    bool releaseShape(const DoubleHashKey& key);
+
     struct ShapeReference {
         int _refCount;
         btCollisionShape* _shape;
@@ -47,6 +49,7 @@ private:
     };
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
+    btHashMap<btHashPtr, DoubleHashKey> _shapeKeys; // so a shape is released without rebuilding its ShapeInfo
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
 };
 
@@ -15,14 +15,178 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <algorithm>
+
+#include <QRunnable>
+
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
+
+#include <SharedUtil.h>
+
 #include "ThreadSafeDynamicsWorld.h"
 
+// the bodies and contacts of the islands one solver works through, islands never share a dynamic body so any
+// number of them can be solved together in one solveGroup() call
+class IslandBatch {
+public:
+    IslandBatch() : cost(0) { }
+
+    void add(btCollisionObject* const* islandBodies, int numBodies, btPersistentManifold* const* islandManifolds,
+             int numManifolds) {
+        for (int i = 0; i < numBodies; ++i) {
+            bodies.push_back(islandBodies[i]);
+        }
+        for (int i = 0; i < numManifolds; ++i) {
+            manifolds.push_back(islandManifolds[i]);
+        }
+        cost += numBodies + numManifolds;
+    }
+
+    void solve(btConstraintSolver* solver, const btContactSolverInfo& solverInfo, btIDebugDraw* debugDrawer,
+               btDispatcher* dispatcher) {
+        if (!bodies.isEmpty() || !manifolds.isEmpty()) {
+            solver->solveGroup(bodies.isEmpty() ? NULL : bodies.data(), bodies.size(),
+                               manifolds.isEmpty() ? NULL : manifolds.data(), manifolds.size(), NULL, 0,
+                               solverInfo, debugDrawer, dispatcher);
+        }
+    }
+
+    QVector<btCollisionObject*> bodies;
+    QVector<btPersistentManifold*> manifolds;
+    int cost;
+};
+
+class Island {
+public:
+    QVector<btCollisionObject*> bodies;
+    QVector<btPersistentManifold*> manifolds;
+
+    bool operator<(const Island& other) const {
+        return bodies.size() + manifolds.size() > other.bodies.size() + other.manifolds.size();
+    }
+};
+
+// collects the islands btSimulationIslandManager finds, which reuses its body array from one island to the next
+class IslandCollector : public btSimulationIslandManager::IslandCallback {
+public:
+    virtual void processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds,
+                               int numManifolds, int islandId) {
+        // a kinematic body is not part of any island, so islands that touch one may share it and have to be
+        // solved on the same thread
+        bool touchesKinematic = false;
+        for (int i = 0; i < numManifolds && !touchesKinematic; ++i) {
+            touchesKinematic = manifolds[i]->getBody0()->isKinematicObject()
+                || manifolds[i]->getBody1()->isKinematicObject();
+        }
+        if (touchesKinematic) {
+            kinematicIslands.add(bodies, numBodies, manifolds, numManifolds);
+        } else {
+            Island island;
+            island.bodies.resize(numBodies);
+            std::copy(bodies, bodies + numBodies, island.bodies.begin());
+            island.manifolds.resize(numManifolds);
+            std::copy(manifolds, manifolds + numManifolds, island.manifolds.begin());
+            islands.push_back(island);
+        }
+    }
+
+    QVector<Island> islands;
+    IslandBatch kinematicIslands;
+};
+
+class IslandBatchSolver : public QRunnable {
+public:
+    IslandBatchSolver(IslandBatch* batch, btConstraintSolver* solver, const btContactSolverInfo* solverInfo,
+                      btIDebugDraw* debugDrawer, btDispatcher* dispatcher) :
+        _batch(batch),
+        _solver(solver),
+        _solverInfo(solverInfo),
+        _debugDrawer(debugDrawer),
+        _dispatcher(dispatcher) {
+    }
+
+    virtual void run() {
+        _batch->solve(_solver, *_solverInfo, _debugDrawer, _dispatcher);
+    }
+
+private:
+    IslandBatch* _batch;
+    btConstraintSolver* _solver;
+    const btContactSolverInfo* _solverInfo;
+    btIDebugDraw* _debugDrawer;
+    btDispatcher* _dispatcher;
+};
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
         btConstraintSolver* constraintSolver,
         btCollisionConfiguration* collisionConfiguration)
-    :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
+    :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+        _numSolverThreads(1),
+        _lastSolveUsecs(0) {
+}
+
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+    _solverPool.waitForDone();
+    foreach (btSequentialImpulseConstraintSolver* solver, _islandSolvers) {
+        delete solver;
+    }
+}
+
+void ThreadSafeDynamicsWorld::setNumSolverThreads(int numThreads) {
+    _numSolverThreads = qMax(numThreads, 1);
+    _solverPool.setMaxThreadCount(_numSolverThreads - 1);
+    while (_islandSolvers.size() < _numSolverThreads) {
+        _islandSolvers.push_back(new btSequentialImpulseConstraintSolver());
+    }
+}
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    quint64 start = usecTimestampNow();
+    if (_numSolverThreads <= 1 || getNumConstraints() > 0) {
+        // typed constraints are sorted into islands by btDiscreteDynamicsWorld, so worlds with any are solved its way
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        _lastSolveUsecs = usecTimestampNow() - start;
+        return;
+    }
+    BT_PROFILE("solveConstraints");
+
+    IslandCollector collector;
+    m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &collector);
+
+    // biggest islands first, each to the batch with the least work so far
+    std::sort(collector.islands.begin(), collector.islands.end());
+    QVector<IslandBatch> batches(_numSolverThreads);
+    foreach (const Island& island, collector.islands) {
+        IslandBatch* cheapest = &batches[0];
+        for (int i = 1; i < batches.size(); ++i) {
+            if (batches[i].cost < cheapest->cost) {
+                cheapest = &batches[i];
+            }
+        }
+        cheapest->add(island.bodies.constData(), island.bodies.size(),
+                      island.manifolds.constData(), island.manifolds.size());
+    }
+
+    btDispatcher* dispatcher = getCollisionWorld()->getDispatcher();
+    for (int i = 1; i < batches.size(); ++i) {
+        if (batches[i].cost > 0) {
+            IslandBatchSolver* batchSolver = new IslandBatchSolver(&batches[i], _islandSolvers[i], &solverInfo,
+                                                                   m_debugDrawer, dispatcher);
+            batchSolver->setAutoDelete(true);
+            _solverPool.start(batchSolver);
+        }
+    }
+
+    // this thread takes the islands that touch kinematic bodies and the first batch while the others run
+    m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), dispatcher->getNumManifolds());
+    collector.kinematicIslands.solve(m_constraintSolver, solverInfo, m_debugDrawer, dispatcher);
+    m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+    batches[0].solve(_islandSolvers[0], solverInfo, m_debugDrawer, dispatcher);
+
+    _solverPool.waitForDone();
+    _lastSolveUsecs = usecTimestampNow() - start;
 }
 
 int	ThreadSafeDynamicsWorld::stepSimulation( btScalar timeStep, int maxSubSteps, btScalar fixedTimeStep) {
@@ -18,6 +18,10 @@
 #ifndef hifi_ThreadSafeDynamicsWorld_h
 #define hifi_ThreadSafeDynamicsWorld_h
 
+#include <QThreadPool>
+#include <QVector>
+
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
 ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorld {
@@ -29,14 +33,34 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    ~ThreadSafeDynamicsWorld();
 
     // virtual overrides from btDiscreteDynamicsWorld
     int stepSimulation( btScalar timeStep, int maxSubSteps=1, btScalar fixedTimeStep=btScalar(1.)/btScalar(60.));
 
+    /// Islands of bodies that touch nothing kinematic are spread over numThreads solvers, each on its own thread
+    /// (the stepping thread being one of them).  With 1 every island is solved by the world's own solver, the way
+    /// btDiscreteDynamicsWorld does.
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const { return _numSolverThreads; }
+
+    /// \return microseconds spent solving the islands of the last substep
+    quint64 getLastSolveUsecs() const { return _lastSolveUsecs; }
+
     // btDiscreteDynamicsWorld::m_localTime is the portion of real-time that has not yet been simulated
     // but is used for MotionState::setWorldTransform() extrapolation (a feature that Bullet uses to provide 
     // smoother rendering of objects when the physics simulation loop is ansynchronous to the render loop).
     float getLocalTimeAccumulation() const { return m_localTime; }
+
+protected:
+    // virtual override from btDiscreteDynamicsWorld
+    void solveConstraints(btContactSolverInfo& solverInfo);
+
+private:
+    QThreadPool _solverPool;
+    QVector<btSequentialImpulseConstraintSolver*> _islandSolvers; // one per solver thread
+    int _numSolverThreads;
+    quint64 _lastSolveUsecs;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -18,6 +18,7 @@
 
 #include <PathUtils.h>
 #include <SharedUtil.h>
+#include <Transform.h>
 
 #include "AbstractViewStateInterface.h"
 #include "AmbientOcclusionEffect.h"
@@ -28,6 +29,15 @@
 
 const int ROTATION_WIDTH = 4;
 const int ROTATION_HEIGHT = 4;
+
+// how much of each frame's occlusion goes into the accumulated one, and the relative difference in depth beyond which
+// what was accumulated is taken to be of another surface
+const float CURRENT_FRAME_WEIGHT = 0.2f;
+const float HISTORY_DEPTH_TOLERANCE = 0.05f;
+
+AmbientOcclusionEffect::~AmbientOcclusionEffect() {
+    clearFramebufferObjects();
+}
     
 void AmbientOcclusionEffect::init(AbstractViewStateInterface* viewState) {
     _viewState = viewState; // we will use this for view state services
@@ -66,6 +76,7 @@ void AmbientOcclusionEffect::init(AbstractViewStateInterface* viewState) {
     _noiseScaleLocation = _occlusionProgram->uniformLocation("noiseScale");
     _texCoordOffsetLocation = _occlusionProgram->uniformLocation("texCoordOffset");
     _texCoordScaleLocation = _occlusionProgram->uniformLocation("texCoordScale");
+    _noiseOffsetLocation = _occlusionProgram->uniformLocation("noiseOffset");
     
     // generate the random rotation texture
     glGenTextures(1, &_rotationTextureID);
@@ -84,16 +95,63 @@ void AmbientOcclusionEffect::init(AbstractViewStateInterface* viewState) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glBindTexture(GL_TEXTURE_2D, 0);
     
-    _blurProgram = new ProgramObject();
-    _blurProgram->addShaderFromSourceFile(QGLShader::Vertex, PathUtils::resourcesPath() + "shaders/ambient_occlusion.vert");
-    _blurProgram->addShaderFromSourceFile(QGLShader::Fragment, PathUtils::resourcesPath() + "shaders/occlusion_blur.frag");
-    _blurProgram->link();
+    _accumulateProgram = new ProgramObject();
+    _accumulateProgram->addShaderFromSourceFile(QGLShader::Vertex, PathUtils::resourcesPath()
+                                                + "shaders/ambient_occlusion.vert");
+    _accumulateProgram->addShaderFromSourceFile(QGLShader::Fragment, PathUtils::resourcesPath()
+                                                + "shaders/occlusion_accumulate.frag");
+    _accumulateProgram->link();
+    
+    _accumulateProgram->bind();
+    _accumulateProgram->setUniformValue("currentTexture", 0);
+    _accumulateProgram->setUniformValue("historyTexture", 1);
+    _accumulateProgram->setUniformValue("depthTolerance", HISTORY_DEPTH_TOLERANCE);
+    _accumulateProgram->release();
     
-    _blurProgram->bind();
-    _blurProgram->setUniformValue("originalTexture", 0);
-    _blurProgram->release();
+    _accumulateNearLocation = _accumulateProgram->uniformLocation("near");
+    _accumulateFarLocation = _accumulateProgram->uniformLocation("far");
+    _accumulateLeftBottomLocation = _accumulateProgram->uniformLocation("leftBottom");
+    _accumulateRightTopLocation = _accumulateProgram->uniformLocation("rightTop");
+    _previousLeftBottomLocation = _accumulateProgram->uniformLocation("previousLeftBottom");
+    _previousRightTopLocation = _accumulateProgram->uniformLocation("previousRightTop");
+    _reprojectionLocation = _accumulateProgram->uniformLocation("reprojection");
+    _accumulateTexCoordOffsetLocation = _accumulateProgram->uniformLocation("texCoordOffset");
+    _accumulateTexCoordScaleLocation = _accumulateProgram->uniformLocation("texCoordScale");
+    _currentWeightLocation = _accumulateProgram->uniformLocation("currentWeight");
+    _accumulateOcclusionScaleLocation = _accumulateProgram->uniformLocation("occlusionScale");
     
-    _blurScaleLocation = _blurProgram->uniformLocation("blurScale");
+    _upsampleProgram = new ProgramObject();
+    _upsampleProgram->addShaderFromSourceFile(QGLShader::Vertex, PathUtils::resourcesPath()
+                                              + "shaders/ambient_occlusion.vert");
+    _upsampleProgram->addShaderFromSourceFile(QGLShader::Fragment, PathUtils::resourcesPath()
+                                              + "shaders/occlusion_upsample.frag");
+    _upsampleProgram->link();
+    
+    _upsampleProgram->bind();
+    _upsampleProgram->setUniformValue("occlusionTexture", 0);
+    _upsampleProgram->setUniformValue("depthTexture", 1);
+    _upsampleProgram->release();
+    
+    _upsampleNearLocation = _upsampleProgram->uniformLocation("near");
+    _upsampleFarLocation = _upsampleProgram->uniformLocation("far");
+    _texelSizeLocation = _upsampleProgram->uniformLocation("texelSize");
+    _upsampleOcclusionScaleLocation = _upsampleProgram->uniformLocation("occlusionScale");
+}
+
+void AmbientOcclusionEffect::setResolutionDivider(int divider) {
+    const int MAX_RESOLUTION_DIVIDER = 4;
+    divider = glm::clamp(divider, 1, MAX_RESOLUTION_DIVIDER);
+    if (_resolutionDivider != divider) {
+        _resolutionDivider = divider;
+        clearFramebufferObjects();
+    }
+}
+
+void AmbientOcclusionEffect::setTemporalAccumulationEnabled(bool enabled) {
+    if (_temporalAccumulationEnabled != enabled) {
+        _temporalAccumulationEnabled = enabled;
+        _previousViews.clear();
+    }
 }
 
 void AmbientOcclusionEffect::render() {
@@ -101,14 +159,8 @@ void AmbientOcclusionEffect::render() {
     glDisable(GL_DEPTH_TEST);
     glDepthMask(GL_FALSE);
     
-    glBindTexture(GL_TEXTURE_2D, DependencyManager::get<TextureCache>()->getPrimaryDepthTextureID());
-    
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, _rotationTextureID);
-    
-    // render with the occlusion shader to the secondary/tertiary buffer
-    QOpenGLFramebufferObject* freeFBO = DependencyManager::get<GlowEffect>()->getFreeFramebufferObject();
-    freeFBO->bind();
+    QOpenGLFramebufferObject* primaryFBO = DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject();
+    updateFramebufferObjects(primaryFBO->width(), primaryFBO->height());
     
     float left, right, bottom, top, nearVal, farVal;
     glm::vec4 nearClipPlane, farClipPlane;
@@ -117,18 +169,49 @@ void AmbientOcclusionEffect::render() {
     int viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
     const int VIEWPORT_X_INDEX = 0;
+    const int VIEWPORT_Y_INDEX = 1;
     const int VIEWPORT_WIDTH_INDEX = 2;
-    QOpenGLFramebufferObject* primaryFBO = DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject();
+    const int VIEWPORT_HEIGHT_INDEX = 3;
     float sMin = viewport[VIEWPORT_X_INDEX] / (float)primaryFBO->width();
     float sWidth = viewport[VIEWPORT_WIDTH_INDEX] / (float)primaryFBO->width();
     
+    // the occlusion is computed over the same part of its smaller buffers as the viewport covers of the primary one
+    int occlusionWidth = _occlusionFramebufferObject->width();
+    int occlusionHeight = _occlusionFramebufferObject->height();
+    float occlusionScaleS = primaryFBO->width() / (float)(occlusionWidth * _resolutionDivider);
+    float occlusionScaleT = primaryFBO->height() / (float)(occlusionHeight * _resolutionDivider);
+    int occlusionX = viewport[VIEWPORT_X_INDEX] / _resolutionDivider;
+    int occlusionY = viewport[VIEWPORT_Y_INDEX] / _resolutionDivider;
+    glViewport(occlusionX, occlusionY,
+        (viewport[VIEWPORT_X_INDEX] + viewport[VIEWPORT_WIDTH_INDEX]) / _resolutionDivider - occlusionX,
+        (viewport[VIEWPORT_Y_INDEX] + viewport[VIEWPORT_HEIGHT_INDEX]) / _resolutionDivider - occlusionY);
+    
+    glBindTexture(GL_TEXTURE_2D, DependencyManager::get<TextureCache>()->getPrimaryDepthTextureID());
+    
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, _rotationTextureID);
+    
+    // render with the occlusion shader to the occlusion buffer
+    _occlusionFramebufferObject->bind();
+    
+    // when the frames are accumulated, each samples with the rotations moved a texel on, so that together they
+    // sample with all of them
+    glm::vec2 noiseOffset;
+    if (_temporalAccumulationEnabled) {
+        int rotationIndex = _frameCount++ % (ROTATION_WIDTH * ROTATION_HEIGHT);
+        noiseOffset = glm::vec2((rotationIndex % ROTATION_WIDTH) / (float)ROTATION_WIDTH,
+            (rotationIndex / ROTATION_WIDTH) / (float)ROTATION_HEIGHT);
+    }
+    
     _occlusionProgram->bind();
     _occlusionProgram->setUniformValue(_nearLocation, nearVal);
     _occlusionProgram->setUniformValue(_farLocation, farVal);
     _occlusionProgram->setUniformValue(_leftBottomLocation, left, bottom);
     _occlusionProgram->setUniformValue(_rightTopLocation, right, top);
-    _occlusionProgram->setUniformValue(_noiseScaleLocation, viewport[VIEWPORT_WIDTH_INDEX] / (float)ROTATION_WIDTH,
-        primaryFBO->height() / (float)ROTATION_HEIGHT);
+    _occlusionProgram->setUniformValue(_noiseScaleLocation,
+        viewport[VIEWPORT_WIDTH_INDEX] / (float)(ROTATION_WIDTH * _resolutionDivider),
+        occlusionHeight / (float)ROTATION_HEIGHT);
+    _occlusionProgram->setUniform(_noiseOffsetLocation, noiseOffset);
     _occlusionProgram->setUniformValue(_texCoordOffsetLocation, sMin, 0.0f);
     _occlusionProgram->setUniformValue(_texCoordScaleLocation, sWidth, 1.0f);
     
@@ -136,30 +219,142 @@ void AmbientOcclusionEffect::render() {
     
     _occlusionProgram->release();
     
-    freeFBO->release();
+    _occlusionFramebufferObject->release();
     
     glBindTexture(GL_TEXTURE_2D, 0);
     
     glActiveTexture(GL_TEXTURE0);
     
-    // now render secondary to primary with 4x4 blur
-    DependencyManager::get<TextureCache>()->getPrimaryFramebufferObject()->bind();
+    QOpenGLFramebufferObject* occlusionFBO = _occlusionFramebufferObject;
+    if (_temporalAccumulationEnabled) {
+        Transform::Mat4 viewMatrix, inverseViewMatrix;
+        _viewState->getViewTransform().getMatrix(viewMatrix);
+        _viewState->getViewTransform().getInverseMatrix(inverseViewMatrix);
+        
+        // the views are told apart by where they're rendered, as with the eyes of a stereo display, and each keeps
+        // to its part of the history buffers
+        int viewKey = viewport[VIEWPORT_X_INDEX];
+        float currentWeight = CURRENT_FRAME_WEIGHT;
+        QHash<int, PreviousView>::iterator previousView = _previousViews.find(viewKey);
+        if (previousView == _previousViews.end()) {
+            // nothing to accumulate with yet, so the history starts over as this frame, reprojected to itself
+            PreviousView view = { inverseViewMatrix, glm::vec2(left, bottom), glm::vec2(right, top), 0 };
+            previousView = _previousViews.insert(viewKey, view);
+            currentWeight = 1.0f;
+        }
+        QOpenGLFramebufferObject* historyFBO = _historyFramebufferObjects[previousView->historyIndex];
+        previousView->historyIndex = 1 - previousView->historyIndex;
+        occlusionFBO = _historyFramebufferObjects[previousView->historyIndex];
+        
+        // from this frame's view space to the world, and from there to the previous frame's view space
+        glm::mat4 reprojection = previousView->inverseViewMatrix * viewMatrix;
+        
+        occlusionFBO->bind();
+        
+        glBindTexture(GL_TEXTURE_2D, _occlusionFramebufferObject->texture());
+        
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, historyFBO->texture());
+        
+        _accumulateProgram->bind();
+        _accumulateProgram->setUniformValue(_accumulateNearLocation, nearVal);
+        _accumulateProgram->setUniformValue(_accumulateFarLocation, farVal);
+        _accumulateProgram->setUniformValue(_accumulateLeftBottomLocation, left, bottom);
+        _accumulateProgram->setUniformValue(_accumulateRightTopLocation, right, top);
+        _accumulateProgram->setUniform(_previousLeftBottomLocation, previousView->leftBottom);
+        _accumulateProgram->setUniform(_previousRightTopLocation, previousView->rightTop);
+        glUniformMatrix4fv(_reprojectionLocation, 1, GL_FALSE, (const float*)&reprojection);
+        _accumulateProgram->setUniformValue(_accumulateTexCoordOffsetLocation, sMin, 0.0f);
+        _accumulateProgram->setUniformValue(_accumulateTexCoordScaleLocation, sWidth, 1.0f);
+        _accumulateProgram->setUniformValue(_currentWeightLocation, currentWeight);
+        _accumulateProgram->setUniformValue(_accumulateOcclusionScaleLocation, occlusionScaleS, occlusionScaleT);
+        
+        renderFullscreenQuad();
+        
+        _accumulateProgram->release();
+        
+        occlusionFBO->release();
+        
+        glBindTexture(GL_TEXTURE_2D, 0);
+        
+        glActiveTexture(GL_TEXTURE0);
+        
+        previousView->inverseViewMatrix = inverseViewMatrix;
+        previousView->leftBottom = glm::vec2(left, bottom);
+        previousView->rightTop = glm::vec2(right, top);
+    }
+    
+    glViewport(viewport[VIEWPORT_X_INDEX], viewport[VIEWPORT_Y_INDEX],
+        viewport[VIEWPORT_WIDTH_INDEX], viewport[VIEWPORT_HEIGHT_INDEX]);
+    
+    // now upsample to primary, weighting each occlusion texel by how near its depth is to that of the pixel
+    primaryFBO->bind();
     
     glEnable(GL_BLEND);
     glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
     
-    glBindTexture(GL_TEXTURE_2D, freeFBO->texture());
+    glBindTexture(GL_TEXTURE_2D, occlusionFBO->texture());
     
-    _blurProgram->bind();
-    _blurProgram->setUniformValue(_blurScaleLocation, 1.0f / primaryFBO->width(), 1.0f / primaryFBO->height());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, DependencyManager::get<TextureCache>()->getPrimaryDepthTextureID());
+    
+    _upsampleProgram->bind();
+    _upsampleProgram->setUniformValue(_upsampleNearLocation, nearVal);
+    _upsampleProgram->setUniformValue(_upsampleFarLocation, farVal);
+    _upsampleProgram->setUniformValue(_texelSizeLocation, 1.0f / occlusionWidth, 1.0f / occlusionHeight);
+    _upsampleProgram->setUniformValue(_upsampleOcclusionScaleLocation, occlusionScaleS, occlusionScaleT);
     
     renderFullscreenQuad(sMin, sMin + sWidth);
     
-    _blurProgram->release();
+    _upsampleProgram->release();
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
     
+    glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
     
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_CONSTANT_ALPHA, GL_ONE);
     glEnable(GL_DEPTH_TEST);
     glDepthMask(GL_TRUE);
 }
+
+static QOpenGLFramebufferObject* createOcclusionFramebufferObject(int width, int height) {
+    QOpenGLFramebufferObject* fbo = new QOpenGLFramebufferObject(width, height,
+        QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, GL_RGBA);
+    
+    // the depth packed in the texels can't be filtered, so each is read on its own
+    glBindTexture(GL_TEXTURE_2D, fbo->texture());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    return fbo;
+}
+
+void AmbientOcclusionEffect::updateFramebufferObjects(int width, int height) {
+    // rounded up, so that nothing of the framebuffer is left out
+    QSize size((width + _resolutionDivider - 1) / _resolutionDivider,
+        (height + _resolutionDivider - 1) / _resolutionDivider);
+    if (_occlusionFramebufferObject && _occlusionFramebufferObject->size() == size) {
+        return;
+    }
+    clearFramebufferObjects();
+    _occlusionFramebufferObject = createOcclusionFramebufferObject(size.width(), size.height());
+    for (int i = 0; i < 2; i++) {
+        _historyFramebufferObjects[i] = createOcclusionFramebufferObject(size.width(), size.height());
+    }
+}
+
+void AmbientOcclusionEffect::clearFramebufferObjects() {
+    delete _occlusionFramebufferObject;
+    _occlusionFramebufferObject = nullptr;
+    for (int i = 0; i < 2; i++) {
+        delete _historyFramebufferObjects[i];
+        _historyFramebufferObjects[i] = nullptr;
+    }
+    
+    // what was accumulated went with the buffers
+    _previousViews.clear();
+}
@@ -12,13 +12,20 @@
 #ifndef hifi_AmbientOcclusionEffect_h
 #define hifi_AmbientOcclusionEffect_h
 
+#include <QHash>
+
+#include <glm/glm.hpp>
+
 #include <DependencyManager.h>
 
 class AbstractViewStateInterface;
 class ProgramObject;
+class QOpenGLFramebufferObject;
 
 /// A screen space ambient occlusion effect.  See John Chapman's tutorial at
-/// http://john-chapman-graphics.blogspot.co.uk/2013/01/ssao-tutorial.html for reference.
+/// http://john-chapman-graphics.blogspot.co.uk/2013/01/ssao-tutorial.html for reference.  The occlusion can be
+/// computed at a fraction of the framebuffer's resolution and upsampled with the depth kept in mind, and blended with
+/// that of the earlier frames, reprojected to the current view, to make up for the samples it takes fewer of.
 class AmbientOcclusionEffect : public Dependency {
     SINGLETON_DEPENDENCY
     
@@ -27,9 +34,30 @@ public:
     void init(AbstractViewStateInterface* viewState);
     void render();
     
+    /// Sets how many times fewer pixels across and down the occlusion is computed at than the framebuffer has: 1, 2
+    /// or 4.
+    void setResolutionDivider(int divider);
+    int getResolutionDivider() const { return _resolutionDivider; }
+    
+    /// Sets whether the occlusion of each frame is blended with that of the frames before it.
+    void setTemporalAccumulationEnabled(bool enabled);
+    bool isTemporalAccumulationEnabled() const { return _temporalAccumulationEnabled; }
+    
 private:
     AmbientOcclusionEffect() {}
-    virtual ~AmbientOcclusionEffect() {}
+    virtual ~AmbientOcclusionEffect();
+    
+    /// What the accumulated occlusion of a view, told apart by its viewport, was last rendered with.
+    class PreviousView {
+    public:
+        glm::mat4 inverseViewMatrix;
+        glm::vec2 leftBottom;
+        glm::vec2 rightTop;
+        int historyIndex;
+    };
+    
+    void updateFramebufferObjects(int width, int height);
+    void clearFramebufferObjects();
 
     ProgramObject* _occlusionProgram;
     int _nearLocation;
@@ -40,11 +68,39 @@ private:
     int _texCoordOffsetLocation;
     int _texCoordScaleLocation;
     
-    ProgramObject* _blurProgram;
-    int _blurScaleLocation;
+    int _noiseOffsetLocation;
+    
+    ProgramObject* _accumulateProgram;
+    int _accumulateNearLocation;
+    int _accumulateFarLocation;
+    int _accumulateLeftBottomLocation;
+    int _accumulateRightTopLocation;
+    int _previousLeftBottomLocation;
+    int _previousRightTopLocation;
+    int _reprojectionLocation;
+    int _accumulateTexCoordOffsetLocation;
+    int _accumulateTexCoordScaleLocation;
+    int _currentWeightLocation;
+    int _accumulateOcclusionScaleLocation;
+    
+    ProgramObject* _upsampleProgram;
+    int _upsampleNearLocation;
+    int _upsampleFarLocation;
+    int _texelSizeLocation;
+    int _upsampleOcclusionScaleLocation;
     
     GLuint _rotationTextureID;
     AbstractViewStateInterface* _viewState;
+    
+    int _resolutionDivider = 2;
+    bool _temporalAccumulationEnabled = true;
+    
+    // the occlusion of the frame, and the two that the accumulated one goes back and forth between
+    QOpenGLFramebufferObject* _occlusionFramebufferObject = nullptr;
+    QOpenGLFramebufferObject* _historyFramebufferObjects[2] = { nullptr, nullptr };
+    
+    int _frameCount = 0;
+    QHash<int, PreviousView> _previousViews;
 };
 
 #endif // hifi_AmbientOcclusionEffect_h
@@ -133,14 +133,14 @@ void AnimationHandle::simulate(float deltaTime) {
         }
     }
     
-    const FBXGeometry& animationGeometry = _animation->getGeometry();
-    if (animationGeometry.animationFrames.isEmpty()) {
+    AnimationClipPointer clip = _animation->getClip();
+    if (!clip || clip->getFrameCount() == 0) {
         stop();
         return;
     }
     
-    if (_animationLoop.getMaxFrameIndexHint() != animationGeometry.animationFrames.size()) {
-        _animationLoop.setMaxFrameIndexHint(animationGeometry.animationFrames.size());
+    if (_animationLoop.getMaxFrameIndexHint() != clip->getFrameCount()) {
+        _animationLoop.setMaxFrameIndexHint(clip->getFrameCount());
     }
         
     // blend between the closest two frames
@@ -148,16 +148,17 @@ void AnimationHandle::simulate(float deltaTime) {
 }
 
 void AnimationHandle::applyFrame(float frameIndex) {
-    const FBXGeometry& animationGeometry = _animation->getGeometry();
-    int frameCount = animationGeometry.animationFrames.size();
-    const FBXAnimationFrame& floorFrame = animationGeometry.animationFrames.at((int)glm::floor(frameIndex) % frameCount);
-    const FBXAnimationFrame& ceilFrame = animationGeometry.animationFrames.at((int)glm::ceil(frameIndex) % frameCount);
-    float frameFraction = glm::fract(frameIndex);
-    for (int i = 0; i < _jointMappings.size(); i++) {
+    AnimationClipPointer clip = _animation->getClip();
+    if (!clip || clip->getFrameCount() == 0) {
+        return;
+    }
+    int jointCount = qMin(_jointMappings.size(), clip->getJointCount());
+    _clipCursors.resize(jointCount);
+    for (int i = 0; i < jointCount; i++) {
         int mapping = _jointMappings.at(i);
         if (mapping != -1) {
             JointState& state = _model->_jointStates[mapping];
-            state.setRotationInConstrainedFrame(safeMix(floorFrame.rotations.at(i), ceilFrame.rotations.at(i), frameFraction), _priority);
+            state.setRotationInConstrainedFrame(clip->sample(i, frameIndex, _clipCursors[i]), _priority);
         }
     }
 }
@@ -103,6 +103,7 @@ private:
 
     QStringList _maskedJoints;
     QVector<int> _jointMappings;
+    QVector<int> _clipCursors;
     
     AnimationLoop _animationLoop;
 };
@@ -14,6 +14,8 @@
 
 #include <QOpenGLFramebufferObject>
 
+#include <float.h>
+
 #include <GLMHelpers.h>
 #include <PathUtils.h>
 #include <ViewFrustum.h>
@@ -29,7 +31,6 @@
 #include "simple_frag.h"
 
 #include "deferred_light_vert.h"
-#include "deferred_light_limited_vert.h"
 
 #include "directional_light_frag.h"
 #include "directional_light_shadow_map_frag.h"
@@ -39,8 +40,13 @@
 #include "directional_ambient_light_shadow_map_frag.h"
 #include "directional_ambient_light_cascaded_shadow_map_frag.h"
 
-#include "point_light_frag.h"
-#include "spot_light_frag.h"
+#include "tiled_light_frag.h"
+
+// the size in pixels of the screen tiles the point and spot lights are binned into
+static const int LIGHT_TILE_SIZE = 32;
+
+// the most lights tiled_light.slf shades in a pass, a tile reached by more is drawn again for the rest
+static const int MAX_LIGHTS_PER_PASS = 16;
 
 class SphericalHarmonics {
 public:
@@ -184,28 +190,34 @@ public:
 
 void DeferredLightingEffect::init(AbstractViewStateInterface* viewState) {
     _viewState = viewState;
-    _simpleProgram.addShaderFromSourceCode(QGLShader::Vertex, simple_vert);
-    _simpleProgram.addShaderFromSourceCode(QGLShader::Fragment, simple_frag);
+    _simpleProgram.addShadersFromSourceCode(simple_vert, simple_frag);
     _simpleProgram.link();
     
     _simpleProgram.bind();
     _glowIntensityLocation = _simpleProgram.uniformLocation("glowIntensity");
     _simpleProgram.release();
     
-    loadLightProgram(directional_light_frag, false, _directionalLight, _directionalLightLocations);
-    loadLightProgram(directional_light_shadow_map_frag, false, _directionalLightShadowMap,
+    loadLightProgram(directional_light_frag, _directionalLight, _directionalLightLocations);
+    loadLightProgram(directional_light_shadow_map_frag, _directionalLightShadowMap,
         _directionalLightShadowMapLocations);
-    loadLightProgram(directional_light_cascaded_shadow_map_frag, false, _directionalLightCascadedShadowMap,
+    loadLightProgram(directional_light_cascaded_shadow_map_frag, _directionalLightCascadedShadowMap,
         _directionalLightCascadedShadowMapLocations);
 
-    loadLightProgram(directional_ambient_light_frag, false, _directionalAmbientSphereLight, _directionalAmbientSphereLightLocations);
-    loadLightProgram(directional_ambient_light_shadow_map_frag, false, _directionalAmbientSphereLightShadowMap,
+    loadLightProgram(directional_ambient_light_frag, _directionalAmbientSphereLight, _directionalAmbientSphereLightLocations);
+    loadLightProgram(directional_ambient_light_shadow_map_frag, _directionalAmbientSphereLightShadowMap,
         _directionalAmbientSphereLightShadowMapLocations);
-    loadLightProgram(directional_ambient_light_cascaded_shadow_map_frag, false, _directionalAmbientSphereLightCascadedShadowMap,
+    loadLightProgram(directional_ambient_light_cascaded_shadow_map_frag, _directionalAmbientSphereLightCascadedShadowMap,
         _directionalAmbientSphereLightCascadedShadowMapLocations);
 
-    loadLightProgram(point_light_frag, true, _pointLight, _pointLightLocations);
-    loadLightProgram(spot_light_frag, true, _spotLight, _spotLightLocations);
+    loadLightProgram(tiled_light_frag, _tiledLight, _tiledLightLocations);
+    _tiledLight.bind();
+    _tiledLightArrayLocations.lightCount = _tiledLight.uniformLocation("lightCount");
+    _tiledLightArrayLocations.lightPositions = _tiledLight.uniformLocation("lightPositions");
+    _tiledLightArrayLocations.lightAmbients = _tiledLight.uniformLocation("lightAmbients");
+    _tiledLightArrayLocations.lightDiffuses = _tiledLight.uniformLocation("lightDiffuses");
+    _tiledLightArrayLocations.lightAttenuations = _tiledLight.uniformLocation("lightAttenuations");
+    _tiledLightArrayLocations.lightSpotDirections = _tiledLight.uniformLocation("lightSpotDirections");
+    _tiledLight.release();
 }
 
 void DeferredLightingEffect::bindSimpleProgram() {
@@ -269,6 +281,7 @@ void DeferredLightingEffect::addSpotLight(const glm::vec3& position, float radiu
         light.specular = glm::vec4(specular, 1.0f);
         light.constantAttenuation = constantAttenuation;
         light.linearAttenuation = linearAttenuation;
+        light.quadraticAttenuation = quadraticAttenuation;
         _pointLights.append(light);
         
     } else {
@@ -280,6 +293,7 @@ void DeferredLightingEffect::addSpotLight(const glm::vec3& position, float radiu
         light.specular = glm::vec4(specular, 1.0f);
         light.constantAttenuation = constantAttenuation;
         light.linearAttenuation = linearAttenuation;
+        light.quadraticAttenuation = quadraticAttenuation;
         light.direction = direction;
         light.exponent = exponent;
         light.cutoff = cutoff;
@@ -314,7 +328,7 @@ void DeferredLightingEffect::render() {
     QOpenGLFramebufferObject* primaryFBO = textureCache->getPrimaryFramebufferObject();
     primaryFBO->release();
     
-    QOpenGLFramebufferObject* freeFBO = DependencyManager::get<GlowEffect>()->getFreeFramebufferObject();
+    QOpenGLFramebufferObject* freeFBO = textureCache->acquireFramebufferObject();
     freeFBO->bind();
     glClear(GL_COLOR_BUFFER_BIT);
     glEnable(GL_FRAMEBUFFER_SRGB);
@@ -419,118 +433,20 @@ void DeferredLightingEffect::render() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
     
-    glEnable(GL_CULL_FACE);
-    
-    glm::vec4 sCoefficients(sWidth / 2.0f, 0.0f, 0.0f, sMin + sWidth / 2.0f);
-    glm::vec4 tCoefficients(0.0f, tHeight / 2.0f, 0.0f, tMin + tHeight / 2.0f);
-    glTexGenfv(GL_S, GL_OBJECT_PLANE, (const GLfloat*)&sCoefficients);
-    glTexGenfv(GL_T, GL_OBJECT_PLANE, (const GLfloat*)&tCoefficients);
-    
-    // enlarge the scales slightly to account for tesselation
-    const float SCALE_EXPANSION = 0.05f;
-    
-    const glm::vec3& eyePoint = _viewState->getCurrentViewFrustum()->getPosition();
-    float nearRadius = glm::distance(eyePoint, _viewState->getCurrentViewFrustum()->getNearTopLeft());
-
-    auto geometryCache = DependencyManager::get<GeometryCache>();
-    
-    if (!_pointLights.isEmpty()) {
-        _pointLight.bind();
-        _pointLight.setUniformValue(_pointLightLocations.nearLocation, nearVal);
-        _pointLight.setUniformValue(_pointLightLocations.depthScale, depthScale);
-        _pointLight.setUniformValue(_pointLightLocations.depthTexCoordOffset, depthTexCoordOffsetS, depthTexCoordOffsetT);
-        _pointLight.setUniformValue(_pointLightLocations.depthTexCoordScale, depthTexCoordScaleS, depthTexCoordScaleT);
-
-        foreach (const PointLight& light, _pointLights) {
-            _pointLight.setUniformValue(_pointLightLocations.radius, light.radius);
-            glLightfv(GL_LIGHT1, GL_AMBIENT, (const GLfloat*)&light.ambient);
-            glLightfv(GL_LIGHT1, GL_DIFFUSE, (const GLfloat*)&light.diffuse);
-            glLightfv(GL_LIGHT1, GL_SPECULAR, (const GLfloat*)&light.specular);
-            glLightfv(GL_LIGHT1, GL_POSITION, (const GLfloat*)&light.position);
-            glLightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, (light.constantAttenuation > 0.0f ? light.constantAttenuation : 0.0f));
-            glLightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, (light.linearAttenuation > 0.0f ? light.linearAttenuation : 0.0f));
-            glLightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, (light.quadraticAttenuation > 0.0f ? light.quadraticAttenuation : 0.0f));
-         
-            glPushMatrix();
-            
-            float expandedRadius = light.radius * (1.0f + SCALE_EXPANSION);
-            if (glm::distance(eyePoint, glm::vec3(light.position)) < expandedRadius + nearRadius) {
-                glLoadIdentity();
-                glTranslatef(0.0f, 0.0f, -1.0f);
-                
-                glMatrixMode(GL_PROJECTION);
-                glPushMatrix();
-                glLoadIdentity();
-                
-                renderFullscreenQuad();
-            
-                glPopMatrix();
-                glMatrixMode(GL_MODELVIEW);
-                
-            } else {
-                glTranslatef(light.position.x, light.position.y, light.position.z);   
-                geometryCache->renderSphere(expandedRadius, 32, 32, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-            }
-            
-            glPopMatrix();
-        }
-        _pointLights.clear();
-        
-        _pointLight.release();
-    }
-    
-    if (!_spotLights.isEmpty()) {
-        _spotLight.bind();
-        _spotLight.setUniformValue(_spotLightLocations.nearLocation, nearVal);
-        _spotLight.setUniformValue(_spotLightLocations.depthScale, depthScale);
-        _spotLight.setUniformValue(_spotLightLocations.depthTexCoordOffset, depthTexCoordOffsetS, depthTexCoordOffsetT);
-        _spotLight.setUniformValue(_spotLightLocations.depthTexCoordScale, depthTexCoordScaleS, depthTexCoordScaleT);
+    if (!_pointLights.isEmpty() || !_spotLights.isEmpty()) {
+        _tiledLight.bind();
+        _tiledLight.setUniformValue(_tiledLightLocations.nearLocation, nearVal);
+        _tiledLight.setUniformValue(_tiledLightLocations.depthScale, depthScale);
+        _tiledLight.setUniformValue(_tiledLightLocations.depthTexCoordOffset,
+            depthTexCoordOffsetS, depthTexCoordOffsetT);
+        _tiledLight.setUniformValue(_tiledLightLocations.depthTexCoordScale, depthTexCoordScaleS, depthTexCoordScaleT);
         
-        foreach (const SpotLight& light, _spotLights) {
-            _spotLight.setUniformValue(_spotLightLocations.radius, light.radius);
-            glLightfv(GL_LIGHT1, GL_AMBIENT, (const GLfloat*)&light.ambient);
-            glLightfv(GL_LIGHT1, GL_DIFFUSE, (const GLfloat*)&light.diffuse);
-            glLightfv(GL_LIGHT1, GL_SPECULAR, (const GLfloat*)&light.specular);
-            glLightfv(GL_LIGHT1, GL_POSITION, (const GLfloat*)&light.position);
-            glLightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, (light.constantAttenuation > 0.0f ? light.constantAttenuation : 0.0f));
-            glLightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, (light.linearAttenuation > 0.0f ? light.linearAttenuation : 0.0f));
-            glLightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, (light.quadraticAttenuation > 0.0f ? light.quadraticAttenuation : 0.0f));
-            glLightfv(GL_LIGHT1, GL_SPOT_DIRECTION, (const GLfloat*)&light.direction);
-            glLightf(GL_LIGHT1, GL_SPOT_EXPONENT, light.exponent);
-            glLightf(GL_LIGHT1, GL_SPOT_CUTOFF, glm::degrees(light.cutoff));
-            
-            glPushMatrix();
-            
-            float expandedRadius = light.radius * (1.0f + SCALE_EXPANSION);
-            float edgeRadius = expandedRadius / glm::cos(light.cutoff);
-            if (glm::distance(eyePoint, glm::vec3(light.position)) < edgeRadius + nearRadius) {
-                glLoadIdentity();
-                glTranslatef(0.0f, 0.0f, -1.0f);
-                
-                glMatrixMode(GL_PROJECTION);
-                glPushMatrix();
-                glLoadIdentity();
-                
-                renderFullscreenQuad();
-                
-                glPopMatrix();
-                glMatrixMode(GL_MODELVIEW);
-                
-            } else {
-                glTranslatef(light.position.x, light.position.y, light.position.z);
-                glm::quat spotRotation = rotationBetween(glm::vec3(0.0f, 0.0f, -1.0f), light.direction);
-                glm::vec3 axis = glm::axis(spotRotation);
-                glRotatef(glm::degrees(glm::angle(spotRotation)), axis.x, axis.y, axis.z);   
-                glTranslatef(0.0f, 0.0f, -light.radius * (1.0f + SCALE_EXPANSION * 0.5f));  
-                geometryCache->renderCone(expandedRadius * glm::tan(light.cutoff),
-                    expandedRadius, 32, 1);
-            }
-            
-            glPopMatrix();
-        }
+        renderLocalLights(viewport[VIEWPORT_WIDTH_INDEX], viewport[VIEWPORT_HEIGHT_INDEX], sMin, sWidth, tMin, tHeight,
+            nearVal);
+        _pointLights.clear();
         _spotLights.clear();
         
-        _spotLight.release();
+        _tiledLight.release();
     }
     
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -547,8 +463,6 @@ void DeferredLightingEffect::render() {
     freeFBO->release();
     glDisable(GL_FRAMEBUFFER_SRGB);
     
-    glDisable(GL_CULL_FACE);
-    
     // now transfer the lit region to the primary fbo
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_CONSTANT_ALPHA, GL_ONE);
     glColorMask(true, true, true, false);
@@ -570,6 +484,8 @@ void DeferredLightingEffect::render() {
     glBindTexture(GL_TEXTURE_2D, 0);
     glDisable(GL_TEXTURE_2D);
     
+    textureCache->releaseFramebufferObject(freeFBO);
+    
     glColorMask(true, true, true, true);
     glEnable(GL_LIGHTING);
     glEnable(GL_COLOR_MATERIAL);
@@ -588,9 +504,159 @@ void DeferredLightingEffect::render() {
     _postLightingRenderables.clear();
 }
 
-void DeferredLightingEffect::loadLightProgram(const char* fragSource, bool limited, ProgramObject& program, LightLocations& locations) {
-    program.addShaderFromSourceCode(QGLShader::Vertex, (limited ? deferred_light_limited_vert : deferred_light_vert));
-    program.addShaderFromSourceCode(QGLShader::Fragment, fragSource);
+static int tileCoordinate(float screenCoordinate, int viewportSize, int tiles) {
+    int pixel = (int)((screenCoordinate + 1.0f) * 0.5f * viewportSize);
+    return glm::clamp(pixel / LIGHT_TILE_SIZE, 0, tiles - 1);
+}
+
+void DeferredLightingEffect::renderLocalLights(int viewportWidth, int viewportHeight, float sMin, float sWidth,
+        float tMin, float tHeight, float nearVal) {
+    glm::mat4 modelview, projection;
+    glGetFloatv(GL_MODELVIEW_MATRIX, (GLfloat*)&modelview);
+    glGetFloatv(GL_PROJECTION_MATRIX, (GLfloat*)&projection);
+    
+    // the lights are shaded with the fixed function light products, their colors times the current material's
+    glm::vec4 materialAmbient, materialDiffuse;
+    glGetMaterialfv(GL_FRONT, GL_AMBIENT, (GLfloat*)&materialAmbient);
+    glGetMaterialfv(GL_FRONT, GL_DIFFUSE, (GLfloat*)&materialDiffuse);
+    
+    // put the lights in eye space and find the part of the screen each may reach
+    _localLights.resize(0);
+    int numberOfPointLights = _pointLights.size();
+    int numberOfLights = numberOfPointLights + _spotLights.size();
+    for (int i = 0; i < numberOfLights; i++) {
+        bool spot = (i >= numberOfPointLights);
+        const PointLight& light = spot ? _spotLights.at(i - numberOfPointLights) : _pointLights.at(i);
+        glm::vec3 position(modelview * light.position);
+        if (position.z - light.radius > -nearVal) {
+            continue; // entirely on the near side of the near clip plane
+        }
+        LocalLight localLight;
+        localLight.positionRadius = glm::vec4(position, light.radius);
+        localLight.ambient = glm::vec3(light.ambient * materialAmbient);
+        localLight.diffuse = glm::vec3(light.diffuse * materialDiffuse);
+        localLight.attenuation = glm::vec4(glm::max(light.constantAttenuation, 0.0f),
+            glm::max(light.linearAttenuation, 0.0f), glm::max(light.quadraticAttenuation, 0.0f), -1.0f);
+        localLight.spotDirection = glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
+        if (spot) {
+            const SpotLight& spotLight = _spotLights.at(i - numberOfPointLights);
+            localLight.attenuation.w = glm::cos(spotLight.cutoff);
+            localLight.spotDirection = glm::vec4(glm::normalize(glm::mat3(modelview) * spotLight.direction),
+                spotLight.exponent);
+        }
+        
+        if (position.z + light.radius > -nearVal) {
+            // the light reaches the near clip plane, so it may reach anywhere on the screen
+            localLight.screenMinimum = glm::vec2(-1.0f, -1.0f);
+            localLight.screenMaximum = glm::vec2(1.0f, 1.0f);
+            
+        } else {
+            // the light's bounding box is all beyond the near clip plane, and its projection holds the light's
+            localLight.screenMinimum = glm::vec2(FLT_MAX, FLT_MAX);
+            localLight.screenMaximum = glm::vec2(-FLT_MAX, -FLT_MAX);
+            for (int corner = 0; corner < 8; corner++) {
+                glm::vec3 offset((corner & 1) ? light.radius : -light.radius,
+                    (corner & 2) ? light.radius : -light.radius, (corner & 4) ? light.radius : -light.radius);
+                glm::vec4 projected = projection * glm::vec4(position + offset, 1.0f);
+                glm::vec2 screen = glm::vec2(projected) / projected.w;
+                localLight.screenMinimum = glm::min(localLight.screenMinimum, screen);
+                localLight.screenMaximum = glm::max(localLight.screenMaximum, screen);
+            }
+            if (localLight.screenMinimum.x > 1.0f || localLight.screenMinimum.y > 1.0f ||
+                    localLight.screenMaximum.x < -1.0f || localLight.screenMaximum.y < -1.0f) {
+                continue; // off screen
+            }
+        }
+        _localLights.append(localLight);
+    }
+    if (_localLights.isEmpty()) {
+        return;
+    }
+    
+    // bin the lights into the tiles they may reach
+    int tilesWide = (viewportWidth + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    int tilesHigh = (viewportHeight + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    _tileLights.resize(tilesWide * tilesHigh);
+    for (int i = 0; i < _tileLights.size(); i++) {
+        _tileLights[i].resize(0);
+    }
+    for (int i = 0; i < _localLights.size(); i++) {
+        const LocalLight& localLight = _localLights.at(i);
+        int minimumX = tileCoordinate(localLight.screenMinimum.x, viewportWidth, tilesWide);
+        int minimumY = tileCoordinate(localLight.screenMinimum.y, viewportHeight, tilesHigh);
+        int maximumX = tileCoordinate(localLight.screenMaximum.x, viewportWidth, tilesWide);
+        int maximumY = tileCoordinate(localLight.screenMaximum.y, viewportHeight, tilesHigh);
+        for (int y = minimumY; y <= maximumY; y++) {
+            for (int x = minimumX; x <= maximumX; x++) {
+                _tileLights[y * tilesWide + x].append(i);
+            }
+        }
+    }
+    
+    // draw each run of tiles in a row that shares the same lights as one quad, a pass per MAX_LIGHTS_PER_PASS lights
+    glm::vec4 positions[MAX_LIGHTS_PER_PASS];
+    glm::vec3 ambients[MAX_LIGHTS_PER_PASS];
+    glm::vec3 diffuses[MAX_LIGHTS_PER_PASS];
+    glm::vec4 attenuations[MAX_LIGHTS_PER_PASS];
+    glm::vec4 spotDirections[MAX_LIGHTS_PER_PASS];
+    const QVector<int>* uploadedLights = NULL;
+    auto geometryCache = DependencyManager::get<GeometryCache>();
+    const glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+    
+    for (int y = 0; y < tilesHigh; y++) {
+        const QVector<int>* row = _tileLights.constData() + y * tilesWide;
+        for (int x = 0; x < tilesWide; ) {
+            const QVector<int>& lights = row[x];
+            int end = x + 1;
+            while (end < tilesWide && row[end] == lights) {
+                end++;
+            }
+            if (!lights.isEmpty()) {
+                glm::vec2 minimum(2.0f * x * LIGHT_TILE_SIZE / viewportWidth - 1.0f,
+                    2.0f * y * LIGHT_TILE_SIZE / viewportHeight - 1.0f);
+                glm::vec2 maximum(2.0f * qMin(end * LIGHT_TILE_SIZE, viewportWidth) / viewportWidth - 1.0f,
+                    2.0f * qMin((y + 1) * LIGHT_TILE_SIZE, viewportHeight) / viewportHeight - 1.0f);
+                glm::vec2 texCoordMinimum(sMin + sWidth * (minimum.x + 1.0f) * 0.5f,
+                    tMin + tHeight * (minimum.y + 1.0f) * 0.5f);
+                glm::vec2 texCoordMaximum(sMin + sWidth * (maximum.x + 1.0f) * 0.5f,
+                    tMin + tHeight * (maximum.y + 1.0f) * 0.5f);
+                
+                for (int first = 0; first < lights.size(); first += MAX_LIGHTS_PER_PASS) {
+                    int count = qMin(lights.size() - first, MAX_LIGHTS_PER_PASS);
+                    
+                    // the runs above and below often have the same lights, which are then already uploaded
+                    if (!(count == lights.size() && uploadedLights && *uploadedLights == lights)) {
+                        for (int i = 0; i < count; i++) {
+                            const LocalLight& localLight = _localLights.at(lights.at(first + i));
+                            positions[i] = localLight.positionRadius;
+                            ambients[i] = localLight.ambient;
+                            diffuses[i] = localLight.diffuse;
+                            attenuations[i] = localLight.attenuation;
+                            spotDirections[i] = localLight.spotDirection;
+                        }
+                        _tiledLight.setUniformValue(_tiledLightArrayLocations.lightCount, count);
+                        _tiledLight.setUniformValueArray(_tiledLightArrayLocations.lightPositions,
+                            (const GLfloat*)positions, count, 4);
+                        _tiledLight.setUniformValueArray(_tiledLightArrayLocations.lightAmbients,
+                            (const GLfloat*)ambients, count, 3);
+                        _tiledLight.setUniformValueArray(_tiledLightArrayLocations.lightDiffuses,
+                            (const GLfloat*)diffuses, count, 3);
+                        _tiledLight.setUniformValueArray(_tiledLightArrayLocations.lightAttenuations,
+                            (const GLfloat*)attenuations, count, 4);
+                        _tiledLight.setUniformValueArray(_tiledLightArrayLocations.lightSpotDirections,
+                            (const GLfloat*)spotDirections, count, 4);
+                        uploadedLights = (count == lights.size()) ? &lights : NULL;
+                    }
+                    geometryCache->renderQuad(minimum, maximum, texCoordMinimum, texCoordMaximum, color);
+                }
+            }
+            x = end;
+        }
+    }
+}
+
+void DeferredLightingEffect::loadLightProgram(const char* fragSource, ProgramObject& program, LightLocations& locations) {
+    program.addShadersFromSourceCode(deferred_light_vert, fragSource);
     program.link();
     
     program.bind();
@@ -605,7 +671,6 @@ void DeferredLightingEffect::loadLightProgram(const char* fragSource, bool limit
     locations.depthScale = program.uniformLocation("depthScale");
     locations.depthTexCoordOffset = program.uniformLocation("depthTexCoordOffset");
     locations.depthTexCoordScale = program.uniformLocation("depthTexCoordScale");
-    locations.radius = program.uniformLocation("radius");
     locations.ambientSphere = program.uniformLocation("ambientSphere.L00");
     program.release();
 }
@@ -100,11 +100,20 @@ private:
         int depthScale;
         int depthTexCoordOffset;
         int depthTexCoordScale;
-        int radius;
         int ambientSphere;
     };
     
-    static void loadLightProgram(const char* fragSource, bool limited, ProgramObject& program, LightLocations& locations);
+    class TiledLightLocations {
+    public:
+        int lightCount;
+        int lightPositions;
+        int lightAmbients;
+        int lightDiffuses;
+        int lightAttenuations;
+        int lightSpotDirections;
+    };
+    
+    static void loadLightProgram(const char* fragSource, ProgramObject& program, LightLocations& locations);
    
     ProgramObject _simpleProgram;
     int _glowIntensityLocation;
@@ -123,10 +132,9 @@ private:
     ProgramObject _directionalLightCascadedShadowMap;
     LightLocations _directionalLightCascadedShadowMapLocations;
 
-    ProgramObject _pointLight;
-    LightLocations _pointLightLocations;
-    ProgramObject _spotLight;
-    LightLocations _spotLightLocations;
+    ProgramObject _tiledLight;
+    LightLocations _tiledLightLocations;
+    TiledLightLocations _tiledLightArrayLocations;
     
     class PointLight {
     public:
@@ -147,8 +155,28 @@ private:
         float cutoff;
     };
     
+    /// A point or spot light in eye space, packed the way tiled_light.slf reads it, with the part of the screen it
+    /// may reach.
+    class LocalLight {
+    public:
+        glm::vec4 positionRadius;
+        glm::vec3 ambient;
+        glm::vec3 diffuse;
+        glm::vec4 attenuation; // constant, linear, quadratic and the cosine of the spot cutoff, -1 for point lights
+        glm::vec4 spotDirection; // direction and exponent
+        glm::vec2 screenMinimum; // normalized device coordinates
+        glm::vec2 screenMaximum;
+    };
+    
+    /// Shades the point and spot lights of this frame by binning them into screen tiles and drawing each run of tiles
+    /// that shares the same lights once, shading all of its lights in one pass over the deferred buffers.
+    void renderLocalLights(int viewportWidth, int viewportHeight, float sMin, float sWidth, float tMin, float tHeight,
+        float nearVal);
+    
     QVector<PointLight> _pointLights;
     QVector<SpotLight> _spotLights;
+    QVector<LocalLight> _localLights;
+    QVector<QVector<int> > _tileLights;
     QVector<PostLightingRenderable*> _postLightingRenderables;
     
     AbstractViewStateInterface* _viewState;
@@ -14,13 +14,19 @@
 
 #include <cmath>
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
 #include <QNetworkReply>
 #include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 
 #include <gpu/Batch.h>
 #include <gpu/GLBackend.h>
 
+#include <MeshSimplifier.h>
 #include <SharedUtil.h>
 
 #include "TextureCache.h"
@@ -31,17 +37,112 @@
 const int GeometryCache::UNKNOWN_ID = -1;
 
 GeometryCache::GeometryCache() :
-    _nextID(0)
+    _nextID(0),
+    _streamingOffset(0)
 {
     const qint64 GEOMETRY_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(GEOMETRY_DEFAULT_UNUSED_MAX_SIZE);
+
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    _cachedGeometryDirectory = QDir((!cachePath.isEmpty() ? cachePath : "geometryCache") + "/cachedGeometry")
+        .absolutePath();
+    QDir().mkpath(_cachedGeometryDirectory);
+}
+
+const qint64 CACHED_GEOMETRY_MAX_DIRECTORY_SIZE = 512 * 1024 * 1024;
+
+// a QVariantHash iterates in an order that changes from run to run, maps of the same keys always write the same bytes
+static QVariant sortedMapping(const QVariant& value) {
+    if (value.type() != QVariant::Hash && value.type() != QVariant::Map) {
+        return value;
+    }
+    QVariantMap sorted;
+    QVariantHash hash = value.toHash();
+    for (QVariantHash::const_iterator it = hash.constBegin(); it != hash.constEnd(); it++) {
+        sorted.insert(it.key(), sortedMapping(it.value()));
+    }
+    return sorted;
+}
+
+QString GeometryCache::cachedGeometryPath(const QUrl& url, const QVariantHash& mapping,
+        const QByteArray& validator) const {
+    QByteArray key;
+    QDataStream out(&key, QIODevice::WriteOnly);
+    out << url << sortedMapping(mapping) << validator;
+    return _cachedGeometryDirectory + "/" + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".fbxc";
+}
+
+bool GeometryCache::findCachedGeometry(const QUrl& url, const QVariantHash& mapping, const QByteArray& validator,
+        FBXGeometry& geometry) {
+    if (validator.isEmpty()) {
+        return false;
+    }
+    QFile file(cachedGeometryPath(url, mapping, validator));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // read straight out of the mapped file, the geometry's arrays are the only copy made
+    uchar* mapped = file.map(0, file.size());
+    if (!mapped) {
+        return false;
+    }
+    bool found = true;
+    try {
+        geometry = readCachedFBX(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size()));
+
+    } catch (const QString& error) {
+        qDebug() << "Could not read cached geometry for" << url << ":" << error;
+        found = false;
+    }
+    file.unmap(mapped);
+    return found;
+}
+
+void GeometryCache::storeCachedGeometry(const QUrl& url, const QVariantHash& mapping, const QByteArray& validator,
+        const FBXGeometry& geometry) {
+    if (validator.isEmpty()) {
+        return;
+    }
+
+    // write to the side and rename, so a half written file is never found
+    QString path = cachedGeometryPath(url, mapping, validator);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Could not store cached geometry for" << url << "at" << path;
+        return;
+    }
+    file.write(writeCachedFBX(geometry));
+
+    if (file.commit()) {
+        trimCachedGeometryDirectory();
+    } else {
+        qDebug() << "Could not store cached geometry for" << url << "at" << path;
+    }
+}
+
+void GeometryCache::trimCachedGeometryDirectory() {
+    QMutexLocker locker(&_cachedGeometryDirectoryMutex);
+    QDir directory(_cachedGeometryDirectory);
+    QFileInfoList files = directory.entryInfoList(QStringList("*.fbxc"), QDir::Files, QDir::Time);
+
+    qint64 totalSize = 0;
+    foreach (const QFileInfo& fileInfo, files) {
+        totalSize += fileInfo.size();
+    }
+
+    // the list is newest first, so drop from the back until the directory fits again
+    for (int i = files.size() - 1; i >= 0 && totalSize > CACHED_GEOMETRY_MAX_DIRECTORY_SIZE; i--) {
+        if (directory.remove(files[i].fileName())) {
+            totalSize -= files[i].size();
+        }
+    }
 }
 
 GeometryCache::~GeometryCache() {
     #ifdef WANT_DEBUG
         qDebug() << "GeometryCache::~GeometryCache()... ";
         qDebug() << "    _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
-        qDebug() << "    _line3DVBOs.size():" << _line3DVBOs.size();
         qDebug() << "    BatchItemDetails... population:" << GeometryCache::BatchItemDetails::population;
     #endif //def WANT_DEBUG
 }
@@ -53,11 +154,9 @@ const int NUM_COORDS_PER_VERTEX = 3;
 const int NUM_BYTES_PER_VERTEX = NUM_COORDS_PER_VERTEX * sizeof(GLfloat);
 const int NUM_BYTES_PER_INDEX = sizeof(GLushort);
 
-void GeometryCache::renderSphere(float radius, int slices, int stacks, const glm::vec4& color, bool solid) {
-
+void GeometryCache::prepareSphere(float radius, int slices, int stacks) {
     Vec2Pair radiusKey(glm::vec2(radius, slices), glm::vec2(stacks, 0));
     IntPair slicesStacksKey(slices, stacks);
-    Vec3Pair colorKey(glm::vec3(color.x, color.y, slices), glm::vec3(color.z, color.y, stacks));
 
     int vertices = slices * (stacks - 1) + 2;    
     int indices = slices * (stacks - 1) * NUM_VERTICES_PER_TRIANGULATED_QUAD;
@@ -173,6 +272,18 @@ void GeometryCache::renderSphere(float radius, int slices, int stacks, const glm
             qDebug() << "    _sphereIndices.size():" << _sphereIndices.size();
         #endif
     }
+}
+
+void GeometryCache::renderSphere(float radius, int slices, int stacks, const glm::vec4& color, bool solid) {
+
+    Vec2Pair radiusKey(glm::vec2(radius, slices), glm::vec2(stacks, 0));
+    IntPair slicesStacksKey(slices, stacks);
+    Vec3Pair colorKey(glm::vec3(color.x, color.y, slices), glm::vec3(color.z, color.y, stacks));
+
+    int vertices = slices * (stacks - 1) + 2;    
+    int indices = slices * (stacks - 1) * NUM_VERTICES_PER_TRIANGULATED_QUAD;
+    
+    prepareSphere(radius, slices, stacks);
 
     if (!_sphereColors.contains(colorKey)) {
         gpu::BufferPointer colorBuffer(new gpu::Buffer());
@@ -679,8 +790,7 @@ void GeometryCache::renderVertices(gpu::Primitive primitiveType, int id) {
     }
 }
 
-void GeometryCache::renderSolidCube(float size, const glm::vec4& color) {
-    Vec2Pair colorKey(glm::vec2(color.x, color.y), glm::vec2(color.z, color.y));
+void GeometryCache::prepareSolidCube(float size) {
     const int FLOATS_PER_VERTEX = 3;
     const int VERTICES_PER_FACE = 4;
     const int NUMBER_OF_FACES = 6;
@@ -689,8 +799,6 @@ void GeometryCache::renderSolidCube(float size, const glm::vec4& color) {
     const int vertices = NUMBER_OF_FACES * VERTICES_PER_FACE;
     const int indices = NUMBER_OF_FACES * TRIANGLES_PER_FACE * VERTICES_PER_TRIANGLE;
     const int vertexPoints = vertices * FLOATS_PER_VERTEX;
-    const int VERTEX_STRIDE = sizeof(GLfloat) * FLOATS_PER_VERTEX * 2; // vertices and normals
-    const int NORMALS_OFFSET = sizeof(GLfloat) * FLOATS_PER_VERTEX;
 
     if (!_solidCubeVerticies.contains(size)) {
         gpu::BufferPointer verticesBuffer(new gpu::Buffer());
@@ -750,6 +858,20 @@ void GeometryCache::renderSolidCube(float size, const glm::vec4& color) {
     
         _solidCubeIndexBuffer->append(sizeof(cannonicalIndices), (gpu::Buffer::Byte*) cannonicalIndices);
     }
+}
+
+void GeometryCache::renderSolidCube(float size, const glm::vec4& color) {
+    Vec2Pair colorKey(glm::vec2(color.x, color.y), glm::vec2(color.z, color.y));
+    const int FLOATS_PER_VERTEX = 3;
+    const int VERTICES_PER_FACE = 4;
+    const int NUMBER_OF_FACES = 6;
+    const int TRIANGLES_PER_FACE = 2;
+    const int VERTICES_PER_TRIANGLE = 3;
+    const int indices = NUMBER_OF_FACES * TRIANGLES_PER_FACE * VERTICES_PER_TRIANGLE;
+    const int VERTEX_STRIDE = sizeof(GLfloat) * FLOATS_PER_VERTEX * 2; // vertices and normals
+    const int NORMALS_OFFSET = sizeof(GLfloat) * FLOATS_PER_VERTEX;
+
+    prepareSolidCube(size);
 
     if (!_solidCubeColors.contains(colorKey)) {
         gpu::BufferPointer colorBuffer(new gpu::Buffer());
@@ -803,6 +925,71 @@ void GeometryCache::renderSolidCube(float size, const glm::vec4& color) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void GeometryCache::renderSolidCubeInstances(gpu::Batch& batch, const QVector<Transform>& transforms,
+                                             const QVector<glm::vec4>& colors) {
+    const int FLOATS_PER_VERTEX = 3;
+    const int INDICES = 36;
+    const int VERTEX_STRIDE = sizeof(GLfloat) * FLOATS_PER_VERTEX * 2; // vertices and normals
+    const int NORMALS_OFFSET = sizeof(GLfloat) * FLOATS_PER_VERTEX;
+    const float UNIT_SIZE = 1.0f;
+    if (transforms.isEmpty()) {
+        return;
+    }
+    prepareSolidCube(UNIT_SIZE);
+    gpu::BufferPointer verticesBuffer = _solidCubeVerticies[UNIT_SIZE];
+
+    // with no color stream, each cube takes the color set before it
+    const int VERTICES_SLOT = 0;
+    const int NORMALS_SLOT = 1;
+    gpu::Stream::FormatPointer streamFormat(new gpu::Stream::Format());
+    streamFormat->setAttribute(gpu::Stream::POSITION, VERTICES_SLOT, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ), 0);
+    streamFormat->setAttribute(gpu::Stream::NORMAL, NORMALS_SLOT, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+
+    batch.setInputFormat(streamFormat);
+    batch.setInputBuffer(VERTICES_SLOT, gpu::BufferView(verticesBuffer, 0, verticesBuffer->getSize(), VERTEX_STRIDE,
+        streamFormat->getAttributes().at(gpu::Stream::POSITION)._element));
+    batch.setInputBuffer(NORMALS_SLOT, gpu::BufferView(verticesBuffer, NORMALS_OFFSET, verticesBuffer->getSize(),
+        VERTEX_STRIDE, streamFormat->getAttributes().at(gpu::Stream::NORMAL)._element));
+    batch.setIndexBuffer(gpu::UINT8, _solidCubeIndexBuffer, 0);
+    for (int i = 0; i < transforms.size(); i++) {
+        const glm::vec4& color = colors.at(i);
+        batch._glColor4f(color.r, color.g, color.b, color.a);
+        batch.setModelTransform(transforms.at(i));
+        batch.drawIndexed(gpu::TRIANGLES, INDICES);
+    }
+}
+
+void GeometryCache::renderSphereInstances(gpu::Batch& batch, float radius, int slices, int stacks,
+                                          const QVector<Transform>& transforms, const QVector<glm::vec4>& colors) {
+    if (transforms.isEmpty()) {
+        return;
+    }
+    prepareSphere(radius, slices, stacks);
+    gpu::BufferPointer verticesBuffer = _sphereVertices[Vec2Pair(glm::vec2(radius, slices), glm::vec2(stacks, 0))];
+    gpu::BufferPointer indicesBuffer = _sphereIndices[IntPair(slices, stacks)];
+    int indices = slices * (stacks - 1) * NUM_VERTICES_PER_TRIANGULATED_QUAD;
+
+    // the vertices are their own normals, and with no color stream, each sphere takes the color set before it
+    const int VERTICES_SLOT = 0;
+    const int NORMALS_SLOT = 1;
+    gpu::Stream::FormatPointer streamFormat(new gpu::Stream::Format());
+    streamFormat->setAttribute(gpu::Stream::POSITION, VERTICES_SLOT, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ), 0);
+    streamFormat->setAttribute(gpu::Stream::NORMAL, NORMALS_SLOT, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+
+    batch.setInputFormat(streamFormat);
+    batch.setInputBuffer(VERTICES_SLOT, gpu::BufferView(verticesBuffer,
+        streamFormat->getAttributes().at(gpu::Stream::POSITION)._element));
+    batch.setInputBuffer(NORMALS_SLOT, gpu::BufferView(verticesBuffer,
+        streamFormat->getAttributes().at(gpu::Stream::NORMAL)._element));
+    batch.setIndexBuffer(gpu::UINT16, indicesBuffer, 0);
+    for (int i = 0; i < transforms.size(); i++) {
+        const glm::vec4& color = colors.at(i);
+        batch._glColor4f(color.r, color.g, color.b, color.a);
+        batch.setModelTransform(transforms.at(i));
+        batch.drawIndexed(gpu::TRIANGLES, indices);
+    }
+}
+
 void GeometryCache::renderWireCube(float size, const glm::vec4& color) {
     Vec2Pair colorKey(glm::vec2(color.x, color.y),glm::vec2(color.z, color.y));
     const int FLOATS_PER_VERTEX = 3;
@@ -998,9 +1185,30 @@ void GeometryCache::renderBevelCornersRect(int x, int y, int width, int height,
 }
 
 void GeometryCache::renderQuad(const glm::vec2& minCorner, const glm::vec2& maxCorner, const glm::vec4& color, int id) {
+    const int FLOATS_PER_VERTEX = 2; // vertices
+    const int vertices = 4;
+
+    float vertexBuffer[vertices * FLOATS_PER_VERTEX] = {    
+                        minCorner.x, minCorner.y,
+                        maxCorner.x, minCorner.y,
+                        maxCorner.x, maxCorner.y,
+                        minCorner.x, maxCorner.y };
+
+    const int NUM_COLOR_SCALARS_PER_QUAD = 4;
+    int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
+                        ((int(color.y * 255.0f) & 0xFF) << 8) |
+                        ((int(color.z * 255.0f) & 0xFF) << 16) |
+                        ((int(color.w * 255.0f) & 0xFF) << 24);
+    int colors[NUM_COLOR_SCALARS_PER_QUAD] = { compactColor, compactColor, compactColor, compactColor };
+
     bool registered = (id != UNKNOWN_ID);
+    if (!registered) {
+        renderStreamed(gpu::QUADS, vertices, FLOATS_PER_VERTEX, vertexBuffer, colors);
+        return;
+    }
+
     Vec4Pair key(glm::vec4(minCorner.x, minCorner.y, maxCorner.x, maxCorner.y), color);
-    BatchItemDetails& details = registered ? _registeredQuad2D[id] : _quad2D[key];
+    BatchItemDetails& details = _registeredQuad2D[id];
 
     // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
     if (registered && details.isCreated) {
@@ -1019,9 +1227,6 @@ void GeometryCache::renderQuad(const glm::vec2& minCorner, const glm::vec2& maxC
         #endif // def WANT_DEBUG
     }
 
-    const int FLOATS_PER_VERTEX = 2; // vertices
-    const int vertices = 4;
-
     if (!details.isCreated) {
 
         details.isCreated = true;
@@ -1044,21 +1249,6 @@ void GeometryCache::renderQuad(const glm::vec2& minCorner, const glm::vec2& maxC
         details.stream->addBuffer(details.verticesBuffer, 0, details.streamFormat->getChannels().at(0)._stride);
         details.stream->addBuffer(details.colorBuffer, 0, details.streamFormat->getChannels().at(1)._stride);
 
-
-        float vertexBuffer[vertices * FLOATS_PER_VERTEX] = {    
-                            minCorner.x, minCorner.y,
-                            maxCorner.x, minCorner.y,
-                            maxCorner.x, maxCorner.y,
-                            minCorner.x, maxCorner.y };
-
-        const int NUM_COLOR_SCALARS_PER_QUAD = 4;
-        int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
-                            ((int(color.y * 255.0f) & 0xFF) << 8) |
-                            ((int(color.z * 255.0f) & 0xFF) << 16) |
-                            ((int(color.w * 255.0f) & 0xFF) << 24);
-        int colors[NUM_COLOR_SCALARS_PER_QUAD] = { compactColor, compactColor, compactColor, compactColor };
-
-
         details.verticesBuffer->append(sizeof(vertexBuffer), (gpu::Buffer::Byte*) vertexBuffer);
         details.colorBuffer->append(sizeof(colors), (gpu::Buffer::Byte*) colors);
     }
@@ -1173,9 +1363,30 @@ void GeometryCache::renderQuad(const glm::vec2& minCorner, const glm::vec2& maxC
 }
 
 void GeometryCache::renderQuad(const glm::vec3& minCorner, const glm::vec3& maxCorner, const glm::vec4& color, int id) {
+    const int FLOATS_PER_VERTEX = 3; // vertices
+    const int vertices = 4;
+
+    float vertexBuffer[vertices * FLOATS_PER_VERTEX] = {    
+                        minCorner.x, minCorner.y, minCorner.z,
+                        maxCorner.x, minCorner.y, minCorner.z,
+                        maxCorner.x, maxCorner.y, maxCorner.z,
+                        minCorner.x, maxCorner.y, maxCorner.z };
+
+    const int NUM_COLOR_SCALARS_PER_QUAD = 4;
+    int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
+                        ((int(color.y * 255.0f) & 0xFF) << 8) |
+                        ((int(color.z * 255.0f) & 0xFF) << 16) |
+                        ((int(color.w * 255.0f) & 0xFF) << 24);
+    int colors[NUM_COLOR_SCALARS_PER_QUAD] = { compactColor, compactColor, compactColor, compactColor };
+
     bool registered = (id != UNKNOWN_ID);
+    if (!registered) {
+        renderStreamed(gpu::QUADS, vertices, FLOATS_PER_VERTEX, vertexBuffer, colors);
+        return;
+    }
+
     Vec3PairVec4 key(Vec3Pair(minCorner, maxCorner), color);
-    BatchItemDetails& details = registered ? _registeredQuad3D[id] : _quad3D[key];
+    BatchItemDetails& details = _registeredQuad3D[id];
 
     // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
     if (registered && details.isCreated) {
@@ -1194,9 +1405,6 @@ void GeometryCache::renderQuad(const glm::vec3& minCorner, const glm::vec3& maxC
         #endif // def WANT_DEBUG
     }
 
-    const int FLOATS_PER_VERTEX = 3; // vertices
-    const int vertices = 4;
-
     if (!details.isCreated) {
 
         details.isCreated = true;
@@ -1219,21 +1427,6 @@ void GeometryCache::renderQuad(const glm::vec3& minCorner, const glm::vec3& maxC
         details.stream->addBuffer(details.verticesBuffer, 0, details.streamFormat->getChannels().at(0)._stride);
         details.stream->addBuffer(details.colorBuffer, 0, details.streamFormat->getChannels().at(1)._stride);
 
-
-        float vertexBuffer[vertices * FLOATS_PER_VERTEX] = {    
-                            minCorner.x, minCorner.y, minCorner.z,
-                            maxCorner.x, minCorner.y, minCorner.z,
-                            maxCorner.x, maxCorner.y, maxCorner.z,
-                            minCorner.x, maxCorner.y, maxCorner.z };
-
-        const int NUM_COLOR_SCALARS_PER_QUAD = 4;
-        int compactColor = ((int(color.x * 255.0f) & 0xFF)) |
-                            ((int(color.y * 255.0f) & 0xFF) << 8) |
-                            ((int(color.z * 255.0f) & 0xFF) << 16) |
-                            ((int(color.w * 255.0f) & 0xFF) << 24);
-        int colors[NUM_COLOR_SCALARS_PER_QUAD] = { compactColor, compactColor, compactColor, compactColor };
-
-
         details.verticesBuffer->append(sizeof(vertexBuffer), (gpu::Buffer::Byte*) vertexBuffer);
         details.colorBuffer->append(sizeof(colors), (gpu::Buffer::Byte*) colors);
     }
@@ -1530,11 +1723,6 @@ void GeometryCache::BatchItemDetails::clear() {
 void GeometryCache::renderLine(const glm::vec3& p1, const glm::vec3& p2, 
                                const glm::vec4& color1, const glm::vec4& color2, int id) {
                                
-    bool registered = (id != UNKNOWN_ID);
-    Vec3Pair key(p1, p2);
-
-    BatchItemDetails& details = registered ? _registeredLine3DVBOs[id] : _line3DVBOs[key];
-
     int compactColor1 = ((int(color1.x * 255.0f) & 0xFF)) |
                         ((int(color1.y * 255.0f) & 0xFF) << 8) |
                         ((int(color1.z * 255.0f) & 0xFF) << 16) |
@@ -1545,6 +1733,21 @@ void GeometryCache::renderLine(const glm::vec3& p1, const glm::vec3& p2,
                         ((int(color2.z * 255.0f) & 0xFF) << 16) |
                         ((int(color2.w * 255.0f) & 0xFF) << 24);
 
+    const int FLOATS_PER_VERTEX = 3;
+    const int vertices = 2;
+    float vertexBuffer[vertices * FLOATS_PER_VERTEX] = { p1.x, p1.y, p1.z, p2.x, p2.y, p2.z };
+
+    const int NUM_COLOR_SCALARS = 2;
+    int colors[NUM_COLOR_SCALARS] = { compactColor1, compactColor2 };
+
+    bool registered = (id != UNKNOWN_ID);
+    if (!registered) {
+        renderStreamed(gpu::LINES, vertices, FLOATS_PER_VERTEX, vertexBuffer, colors);
+        return;
+    }
+
+    Vec3Pair key(p1, p2);
+    BatchItemDetails& details = _registeredLine3DVBOs[id];
 
     // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
     if (registered && details.isCreated) {
@@ -1563,8 +1766,6 @@ void GeometryCache::renderLine(const glm::vec3& p1, const glm::vec3& p2,
         #endif // def WANT_DEBUG
     }
 
-    const int FLOATS_PER_VERTEX = 3;
-    const int vertices = 2;
     if (!details.isCreated) {
 
         details.isCreated = true;
@@ -1587,21 +1788,11 @@ void GeometryCache::renderLine(const glm::vec3& p1, const glm::vec3& p2,
         details.stream->addBuffer(details.verticesBuffer, 0, details.streamFormat->getChannels().at(0)._stride);
         details.stream->addBuffer(details.colorBuffer, 0, details.streamFormat->getChannels().at(1)._stride);
 
-
-        float vertexBuffer[vertices * FLOATS_PER_VERTEX] = { p1.x, p1.y, p1.z, p2.x, p2.y, p2.z };
-
-        const int NUM_COLOR_SCALARS = 2;
-        int colors[NUM_COLOR_SCALARS] = { compactColor1, compactColor2 };
-
         details.verticesBuffer->append(sizeof(vertexBuffer), (gpu::Buffer::Byte*) vertexBuffer);
         details.colorBuffer->append(sizeof(colors), (gpu::Buffer::Byte*) colors);
 
         #ifdef WANT_DEBUG
-            if (id == UNKNOWN_ID) {
-                qDebug() << "new renderLine() 3D VBO made -- _line3DVBOs.size():" << _line3DVBOs.size();
-            } else {
-                qDebug() << "new registered renderLine() 3D VBO made -- _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
-            }
+            qDebug() << "new registered renderLine() 3D VBO made -- _registeredLine3DVBOs.size():" << _registeredLine3DVBOs.size();
         #endif
     }
 
@@ -1622,11 +1813,6 @@ void GeometryCache::renderLine(const glm::vec3& p1, const glm::vec3& p2,
 void GeometryCache::renderLine(const glm::vec2& p1, const glm::vec2& p2,                                
                                 const glm::vec4& color1, const glm::vec4& color2, int id) {
                                
-    bool registered = (id != UNKNOWN_ID);
-    Vec2Pair key(p1, p2);
-
-    BatchItemDetails& details = registered ? _registeredLine2DVBOs[id] : _line2DVBOs[key];
-
     int compactColor1 = ((int(color1.x * 255.0f) & 0xFF)) |
                         ((int(color1.y * 255.0f) & 0xFF) << 8) |
                         ((int(color1.z * 255.0f) & 0xFF) << 16) |
@@ -1637,6 +1823,21 @@ void GeometryCache::renderLine(const glm::vec2& p1, const glm::vec2& p2,
                         ((int(color2.z * 255.0f) & 0xFF) << 16) |
                         ((int(color2.w * 255.0f) & 0xFF) << 24);
 
+    const int FLOATS_PER_VERTEX = 2;
+    const int vertices = 2;
+    float vertexBuffer[vertices * FLOATS_PER_VERTEX] = { p1.x, p1.y, p2.x, p2.y };
+
+    const int NUM_COLOR_SCALARS = 2;
+    int colors[NUM_COLOR_SCALARS] = { compactColor1, compactColor2 };
+
+    bool registered = (id != UNKNOWN_ID);
+    if (!registered) {
+        renderStreamed(gpu::LINES, vertices, FLOATS_PER_VERTEX, vertexBuffer, colors);
+        return;
+    }
+
+    Vec2Pair key(p1, p2);
+    BatchItemDetails& details = _registeredLine2DVBOs[id];
 
     // if this is a registered quad, and we have buffers, then check to see if the geometry changed and rebuild if needed
     if (registered && details.isCreated) {
@@ -1655,8 +1856,6 @@ void GeometryCache::renderLine(const glm::vec2& p1, const glm::vec2& p2,
         #endif // def WANT_DEBUG
     }
 
-    const int FLOATS_PER_VERTEX = 2;
-    const int vertices = 2;
     if (!details.isCreated) {
 
         details.isCreated = true;
@@ -1679,21 +1878,11 @@ void GeometryCache::renderLine(const glm::vec2& p1, const glm::vec2& p2,
         details.stream->addBuffer(details.verticesBuffer, 0, details.streamFormat->getChannels().at(0)._stride);
         details.stream->addBuffer(details.colorBuffer, 0, details.streamFormat->getChannels().at(1)._stride);
 
-
-        float vertexBuffer[vertices * FLOATS_PER_VERTEX] = { p1.x, p1.y, p2.x, p2.y };
-
-        const int NUM_COLOR_SCALARS = 2;
-        int colors[NUM_COLOR_SCALARS] = { compactColor1, compactColor2 };
-
         details.verticesBuffer->append(sizeof(vertexBuffer), (gpu::Buffer::Byte*) vertexBuffer);
         details.colorBuffer->append(sizeof(colors), (gpu::Buffer::Byte*) colors);
 
         #ifdef WANT_DEBUG
-            if (id == UNKNOWN_ID) {
-                qDebug() << "new renderLine() 2D VBO made -- _line3DVBOs.size():" << _line2DVBOs.size();
-            } else {
-                qDebug() << "new registered renderLine() 2D VBO made -- _registeredLine2DVBOs.size():" << _registeredLine2DVBOs.size();
-            }
+            qDebug() << "new registered renderLine() 2D VBO made -- _registeredLine2DVBOs.size():" << _registeredLine2DVBOs.size();
         #endif
     }
 
@@ -1711,6 +1900,50 @@ void GeometryCache::renderLine(const glm::vec2& p1, const glm::vec2& p2,
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+// transient geometry is streamed into a buffer this big, and starts over from the front when it fills up
+static const gpu::Buffer::Size STREAMING_BUFFER_SIZE = 256 * 1024;
+
+void GeometryCache::renderStreamed(gpu::Primitive primitiveType, int vertices, int floatsPerVertex,
+                                   const float* positions, const int* colors) {
+    gpu::Stream::FormatPointer& streamFormat = (floatsPerVertex == 2) ? _streamingFormat2D : _streamingFormat3D;
+    if (!streamFormat) {
+        streamFormat = gpu::Stream::FormatPointer(new gpu::Stream::Format());
+        gpu::Dimension dimension = (floatsPerVertex == 2) ? gpu::VEC2 : gpu::VEC3;
+        streamFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element(dimension, gpu::FLOAT, gpu::XYZ), 0);
+        streamFormat->setAttribute(gpu::Stream::COLOR, 1, gpu::Element(gpu::VEC4, gpu::UINT8, gpu::RGBA));
+    }
+    if (!_streamingBuffer) {
+        _streamingBuffer = gpu::BufferPointer(new gpu::Buffer());
+        _streamingBuffer->resize(STREAMING_BUFFER_SIZE);
+    }
+
+    gpu::Buffer::Size positionsSize = vertices * floatsPerVertex * sizeof(float);
+    gpu::Buffer::Size colorsSize = vertices * sizeof(int);
+    if (_streamingOffset + positionsSize + colorsSize > STREAMING_BUFFER_SIZE) {
+        _streamingOffset = 0;
+    }
+    gpu::Buffer::Size positionsOffset = _streamingOffset;
+    gpu::Buffer::Size colorsOffset = positionsOffset + positionsSize;
+    _streamingBuffer->streamSubData(positionsOffset, positionsSize, (const gpu::Buffer::Byte*) positions);
+    _streamingBuffer->streamSubData(colorsOffset, colorsSize, (const gpu::Buffer::Byte*) colors);
+    _streamingOffset = colorsOffset + colorsSize;
+
+    gpu::BufferStream stream;
+    stream.addBuffer(_streamingBuffer, positionsOffset, streamFormat->getChannels().at(0)._stride);
+    stream.addBuffer(_streamingBuffer, colorsOffset, streamFormat->getChannels().at(1)._stride);
+
+    gpu::Batch batch;
+
+    batch.setInputFormat(streamFormat);
+    batch.setInputStream(0, stream);
+    batch.draw(primitiveType, vertices, 0);
+
+    gpu::GLBackend::renderBatch(batch);
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
 QSharedPointer<NetworkGeometry> GeometryCache::getGeometry(const QUrl& url, const QUrl& fallback, bool delayLoad) {
     return getResource(url, fallback, delayLoad).staticCast<NetworkGeometry>();
@@ -1986,6 +2219,17 @@ void NetworkGeometry::replaceTexturesWithPendingChanges() {
     }
 }
 
+// geometry with fewer triangles than this isn't worth simplifying
+static const int MIN_TRIANGLES_FOR_GENERATED_LODS = 2000;
+
+// each generated LOD keeps half the triangles of the one before it, and is used from the given distance on
+static const int GENERATED_LOD_COUNT = 3;
+static const float GENERATED_LOD_RATIO = 0.5f;
+static const float GENERATED_LOD_DISTANCES[GENERATED_LOD_COUNT] = { 10.0f, 20.0f, 30.0f };
+
+// a level that couldn't lose at least a fifth of the triangles before it ends the chain
+static const float MAX_GENERATED_LOD_PROPORTION = 0.8f;
+
 /// Reads geometry in a worker thread.
 class GeometryReader : public QRunnable {
 public:
@@ -2042,9 +2286,43 @@ void GeometryReader::run() {
                 } else if (_url.path().toLower().endsWith("palaceoforinthilian4.fbx")) {
                     lightmapLevel = 3.5f;
                 }
-                fbxgeo = readFBX(_reply, _mapping, grabLightmaps, lightmapLevel);
+
+                // we've read this exact model with this mapping before
+                auto geometryCache = DependencyManager::get<GeometryCache>();
+                QByteArray validator = Resource::getContentValidator(_reply);
+                if (!geometryCache->findCachedGeometry(_url, _mapping, validator, fbxgeo)) {
+                    fbxgeo = readFBX(_reply, _mapping, grabLightmaps, lightmapLevel);
+                    geometryCache->storeCachedGeometry(_url, _mapping, validator, fbxgeo);
+                }
             }
             QMetaObject::invokeMethod(geometry.data(), "setGeometry", Q_ARG(const FBXGeometry&, fbxgeo));
+
+            // models that don't come with LODs of their own get simplified ones once the full one is showing
+            if (_url.path().toLower().endsWith(".fbx") && !_mapping.contains("lod") &&
+                    getFBXTriangleCount(fbxgeo) >= MIN_TRIANGLES_FOR_GENERATED_LODS) {
+                auto geometryCache = DependencyManager::get<GeometryCache>();
+                QByteArray validator = Resource::getContentValidator(_reply);
+                FBXGeometry lod = fbxgeo;
+                int lodTriangleCount = getFBXTriangleCount(lod);
+                for (int i = 0; i < GENERATED_LOD_COUNT; i++) {
+                    // each level is simplified from the one before it, and cached alongside the full geometry
+                    QVariantHash lodMapping = _mapping;
+                    lodMapping.insert("generatedLOD", i + 1);
+                    FBXGeometry simplified;
+                    if (!geometryCache->findCachedGeometry(_url, lodMapping, validator, simplified)) {
+                        simplified = simplifyFBXGeometry(lod, GENERATED_LOD_RATIO);
+                        geometryCache->storeCachedGeometry(_url, lodMapping, validator, simplified);
+                    }
+                    int simplifiedTriangleCount = getFBXTriangleCount(simplified);
+                    if (simplifiedTriangleCount > lodTriangleCount * MAX_GENERATED_LOD_PROPORTION) {
+                        break; // mostly seams and borders, which stay put
+                    }
+                    lod = simplified;
+                    lodTriangleCount = simplifiedTriangleCount;
+                    QMetaObject::invokeMethod(geometry.data(), "addGeneratedLOD", Q_ARG(const FBXGeometry&, lod),
+                        Q_ARG(float, GENERATED_LOD_DISTANCES[i]));
+                }
+            }
         } else {
             throw QString("url is invalid");
         }
@@ -2117,10 +2395,105 @@ void NetworkGeometry::reinsert() {
     }
 }
 
+void NetworkGeometry::addGeneratedLOD(const FBXGeometry& geometry, float distance) {
+    // with no URL of its own, the LOD counts as loaded from the start and never makes a request
+    QSharedPointer<NetworkGeometry> lod(new NetworkGeometry(QUrl(), QSharedPointer<NetworkGeometry>(), true,
+        _mapping, _textureBase));
+    lod->setSelf(lod.staticCast<Resource>());
+    lod->setLODParent(_lodParent);
+    lod->setGeometry(geometry);
+    _lods.insert(distance, lod);
+}
+
+// cluster indices are packed into bytes only when they fit
+static const int MAX_PACKED_CLUSTERS = 256;
+
+static const int PACKED_DIRECTION_SIZE = 4 * sizeof(qint16);
+static const int PACKED_COLOR_SIZE = 4 * sizeof(quint8);
+static const int PACKED_CLUSTER_SIZE = 4 * sizeof(quint8);
+
+static const float PACKED_DIRECTION_SCALE = 32767.0f;
+static const int PACKED_UNIT_MAX = 255;
+
+template<class T> static QByteArray getRawData(const QVector<T>& values) {
+    return QByteArray::fromRawData((const char*)values.constData(), values.size() * sizeof(T));
+}
+
+static QByteArray packDirections(const QVector<glm::vec3>& directions) {
+    QByteArray packed(directions.size() * PACKED_DIRECTION_SIZE, 0);
+    qint16* data = (qint16*)packed.data();
+    foreach (const glm::vec3& direction, directions) {
+        // tangents come in as sums, only their direction matters
+        float length = glm::length(direction);
+        glm::vec3 normalized = (length > EPSILON) ? direction / length : glm::vec3();
+        *data++ = (qint16)glm::round(normalized.x * PACKED_DIRECTION_SCALE);
+        *data++ = (qint16)glm::round(normalized.y * PACKED_DIRECTION_SCALE);
+        *data++ = (qint16)glm::round(normalized.z * PACKED_DIRECTION_SCALE);
+        *data++ = 0;
+    }
+    return packed;
+}
+
+static quint8 packUnit(float value) {
+    return (quint8)glm::round(glm::clamp(value, 0.0f, 1.0f) * PACKED_UNIT_MAX);
+}
+
+static QByteArray packColors(const QVector<glm::vec3>& colors) {
+    QByteArray packed(colors.size() * PACKED_COLOR_SIZE, 0);
+    quint8* data = (quint8*)packed.data();
+    foreach (const glm::vec3& color, colors) {
+        *data++ = packUnit(color.r);
+        *data++ = packUnit(color.g);
+        *data++ = packUnit(color.b);
+        *data++ = PACKED_UNIT_MAX;
+    }
+    return packed;
+}
+
+static QByteArray packClusterIndices(const QVector<glm::vec4>& clusterIndices) {
+    QByteArray packed(clusterIndices.size() * PACKED_CLUSTER_SIZE, 0);
+    quint8* data = (quint8*)packed.data();
+    foreach (const glm::vec4& indices, clusterIndices) {
+        for (int i = 0; i < 4; i++) {
+            *data++ = (quint8)glm::clamp((int)indices[i], 0, MAX_PACKED_CLUSTERS - 1);
+        }
+    }
+    return packed;
+}
+
+static QByteArray packClusterWeights(const QVector<glm::vec4>& clusterWeights) {
+    QByteArray packed(clusterWeights.size() * PACKED_CLUSTER_SIZE, 0);
+    quint8* data = (quint8*)packed.data();
+    foreach (const glm::vec4& weights, clusterWeights) {
+        // the rounding error goes to the heaviest weight, so that the weights still add up to one
+        int total = 0;
+        int heaviest = 0;
+        for (int i = 0; i < 4; i++) {
+            data[i] = packUnit(weights[i]);
+            total += data[i];
+            if (data[i] > data[heaviest]) {
+                heaviest = i;
+            }
+        }
+        if (total > 0) {
+            data[heaviest] = (quint8)glm::clamp(data[heaviest] + PACKED_UNIT_MAX - total, 0, PACKED_UNIT_MAX);
+        }
+        data += 4;
+    }
+    return packed;
+}
+
+// the hash the uploader listed for the texture's content, if the model was uploaded with them
+static QByteArray getTextureHash(const QVariantHash& textureHashes, const FBXTexture& texture) {
+    return QByteArray::fromHex(textureHashes.value(texture.filename).toByteArray());
+}
+
 void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
     _geometry = geometry;
 
     auto textureCache = DependencyManager::get<TextureCache>();
+    QVariantHash textureHashes = _mapping.value("texhash").toHash();
+    bool packVertices = DependencyManager::get<GeometryCache>()->getPackVertices();
     
     foreach (const FBXMesh& mesh, _geometry.meshes) {
         NetworkMesh networkMesh;
@@ -2132,28 +2505,28 @@ void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
             if (!part.diffuseTexture.filename.isEmpty()) {
                 networkPart.diffuseTexture = textureCache->getTexture(
                     _textureBase.resolved(QUrl(part.diffuseTexture.filename)), DEFAULT_TEXTURE,
-                    mesh.isEye, part.diffuseTexture.content);
+                    mesh.isEye, part.diffuseTexture.content, getTextureHash(textureHashes, part.diffuseTexture));
                 networkPart.diffuseTextureName = part.diffuseTexture.name;
                 networkPart.diffuseTexture->setLoadPriorities(_loadPriorities);
             }
             if (!part.normalTexture.filename.isEmpty()) {
                 networkPart.normalTexture = textureCache->getTexture(
                     _textureBase.resolved(QUrl(part.normalTexture.filename)), NORMAL_TEXTURE,
-                    false, part.normalTexture.content);
+                    false, part.normalTexture.content, getTextureHash(textureHashes, part.normalTexture));
                 networkPart.normalTextureName = part.normalTexture.name;
                 networkPart.normalTexture->setLoadPriorities(_loadPriorities);
             }
             if (!part.specularTexture.filename.isEmpty()) {
                 networkPart.specularTexture = textureCache->getTexture(
                     _textureBase.resolved(QUrl(part.specularTexture.filename)), SPECULAR_TEXTURE,
-                    false, part.specularTexture.content);
+                    false, part.specularTexture.content, getTextureHash(textureHashes, part.specularTexture));
                 networkPart.specularTextureName = part.specularTexture.name;
                 networkPart.specularTexture->setLoadPriorities(_loadPriorities);
             }
             if (!part.emissiveTexture.filename.isEmpty()) {
                 networkPart.emissiveTexture = textureCache->getTexture(
                     _textureBase.resolved(QUrl(part.emissiveTexture.filename)), EMISSIVE_TEXTURE,
-                    false, part.emissiveTexture.content);
+                    false, part.emissiveTexture.content, getTextureHash(textureHashes, part.emissiveTexture));
                 networkPart.emissiveTextureName = part.emissiveTexture.name;
                 networkPart.emissiveTexture->setLoadPriorities(_loadPriorities);
                 checkForTexcoordLightmap = true;
@@ -2165,6 +2538,7 @@ void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
 
         {
             networkMesh._indexBuffer = gpu::BufferPointer(new gpu::Buffer());
+            networkMesh._indexBuffer->setGPUResident(true);
             networkMesh._indexBuffer->resize(totalIndices * sizeof(int));
             int offset = 0;
             foreach(const FBXMeshPart& part, mesh.parts) {
@@ -2179,49 +2553,77 @@ void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
 
         {
             networkMesh._vertexBuffer = gpu::BufferPointer(new gpu::Buffer());
+            networkMesh._vertexBuffer->setGPUResident(true);
+            networkMesh.hasTangents = !mesh.tangents.isEmpty();
+            networkMesh.hasColors = !mesh.colors.isEmpty();
+
+            // packed, the normals and tangents are snorm shorts, the colors and cluster weights unorm bytes and the
+            // cluster indices plain bytes, each padded out to four components to keep the attributes aligned
+            bool packed = packVertices && mesh.clusters.size() <= MAX_PACKED_CLUSTERS;
+            QByteArray normals = packed ? packDirections(mesh.normals) : getRawData(mesh.normals);
+            QByteArray tangents = packed ? packDirections(mesh.tangents) : getRawData(mesh.tangents);
+            QByteArray colors = packed ? packColors(mesh.colors) : getRawData(mesh.colors);
+            QByteArray clusterIndices = packed ? packClusterIndices(mesh.clusterIndices) :
+                getRawData(mesh.clusterIndices);
+            QByteArray clusterWeights = packed ? packClusterWeights(mesh.clusterWeights) :
+                getRawData(mesh.clusterWeights);
+            int directionStride = packed ? PACKED_DIRECTION_SIZE : sizeof(glm::vec3);
+            int colorStride = packed ? PACKED_COLOR_SIZE : sizeof(glm::vec3);
+            int clusterStride = packed ? PACKED_CLUSTER_SIZE : sizeof(glm::vec4);
+            gpu::Element directionElement = packed ? gpu::Element(gpu::VEC3, gpu::NINT16, gpu::XYZ) :
+                gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ);
+            gpu::Element colorElement = packed ? gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA) :
+                gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::RGB);
+            gpu::Element clusterIndexElement = packed ? gpu::Element(gpu::VEC4, gpu::UINT8, gpu::XYZW) :
+                gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW);
+            gpu::Element clusterWeightElement = packed ? gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::XYZW) :
+                gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW);
+
             // if we don't need to do any blending, the positions/normals can be static
             if (mesh.blendshapes.isEmpty()) {
                 int normalsOffset = mesh.vertices.size() * sizeof(glm::vec3);
-                int tangentsOffset = normalsOffset + mesh.normals.size() * sizeof(glm::vec3);
-                int colorsOffset = tangentsOffset + mesh.tangents.size() * sizeof(glm::vec3);
-                int texCoordsOffset = colorsOffset + mesh.colors.size() * sizeof(glm::vec3);
+                int tangentsOffset = normalsOffset + normals.size();
+                int colorsOffset = tangentsOffset + tangents.size();
+                int texCoordsOffset = colorsOffset + colors.size();
                 int texCoords1Offset = texCoordsOffset + mesh.texCoords.size() * sizeof(glm::vec2);
                 int clusterIndicesOffset = texCoords1Offset + mesh.texCoords1.size() * sizeof(glm::vec2);
-                int clusterWeightsOffset = clusterIndicesOffset + mesh.clusterIndices.size() * sizeof(glm::vec4);
+                int clusterWeightsOffset = clusterIndicesOffset + clusterIndices.size();
 
-                networkMesh._vertexBuffer->resize(clusterWeightsOffset + mesh.clusterWeights.size() * sizeof(glm::vec4));
+                networkMesh._vertexBuffer->resize(clusterWeightsOffset + clusterWeights.size());
 
                 networkMesh._vertexBuffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.vertices.constData());
-                networkMesh._vertexBuffer->setSubData(normalsOffset, mesh.normals.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.normals.constData());
+                networkMesh._vertexBuffer->setSubData(normalsOffset,
+                    normals.size(), (gpu::Resource::Byte*) normals.constData());
                 networkMesh._vertexBuffer->setSubData(tangentsOffset,
-                    mesh.tangents.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.tangents.constData());
-                networkMesh._vertexBuffer->setSubData(colorsOffset, mesh.colors.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.colors.constData());
+                    tangents.size(), (gpu::Resource::Byte*) tangents.constData());
+                networkMesh._vertexBuffer->setSubData(colorsOffset,
+                    colors.size(), (gpu::Resource::Byte*) colors.constData());
                 networkMesh._vertexBuffer->setSubData(texCoordsOffset,
                     mesh.texCoords.size() * sizeof(glm::vec2), (gpu::Resource::Byte*) mesh.texCoords.constData());
                 networkMesh._vertexBuffer->setSubData(texCoords1Offset,
                     mesh.texCoords1.size() * sizeof(glm::vec2), (gpu::Resource::Byte*) mesh.texCoords1.constData());
                 networkMesh._vertexBuffer->setSubData(clusterIndicesOffset,
-                    mesh.clusterIndices.size() * sizeof(glm::vec4), (gpu::Resource::Byte*) mesh.clusterIndices.constData());
+                    clusterIndices.size(), (gpu::Resource::Byte*) clusterIndices.constData());
                 networkMesh._vertexBuffer->setSubData(clusterWeightsOffset,
-                    mesh.clusterWeights.size() * sizeof(glm::vec4), (gpu::Resource::Byte*) mesh.clusterWeights.constData());
+                    clusterWeights.size(), (gpu::Resource::Byte*) clusterWeights.constData());
 
                 // otherwise, at least the cluster indices/weights can be static
                 networkMesh._vertexStream = gpu::BufferStreamPointer(new gpu::BufferStream());
                 networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, 0, sizeof(glm::vec3));
-                if (mesh.normals.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, normalsOffset, sizeof(glm::vec3));
-                if (mesh.tangents.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, tangentsOffset, sizeof(glm::vec3));
-                if (mesh.colors.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, colorsOffset, sizeof(glm::vec3));
+                if (mesh.normals.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, normalsOffset, directionStride);
+                if (mesh.tangents.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, tangentsOffset, directionStride);
+                if (mesh.colors.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, colorsOffset, colorStride);
                 if (mesh.texCoords.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, texCoordsOffset, sizeof(glm::vec2));
                 if (mesh.texCoords1.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, texCoords1Offset, sizeof(glm::vec2));
-                if (mesh.clusterIndices.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterIndicesOffset, sizeof(glm::vec4));
-                if (mesh.clusterWeights.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterWeightsOffset, sizeof(glm::vec4));
+                if (mesh.clusterIndices.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterIndicesOffset, clusterStride);
+                if (mesh.clusterWeights.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterWeightsOffset, clusterStride);
 
                 int channelNum = 0;
                 networkMesh._vertexFormat = gpu::Stream::FormatPointer(new gpu::Stream::Format());
                 networkMesh._vertexFormat->setAttribute(gpu::Stream::POSITION, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ), 0);
-                if (mesh.normals.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::NORMAL, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-                if (mesh.tangents.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TANGENT, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-                if (mesh.colors.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::COLOR, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::RGB));
+                if (mesh.normals.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::NORMAL, channelNum++, directionElement);
+                if (mesh.tangents.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TANGENT, channelNum++, directionElement);
+                if (mesh.colors.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::COLOR, channelNum++, colorElement);
                 if (mesh.texCoords.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TEXCOORD, channelNum++, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV));
                 if (mesh.texCoords1.size()) {
                     networkMesh._vertexFormat->setAttribute(gpu::Stream::TEXCOORD1, channelNum++, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV));
@@ -2229,41 +2631,43 @@ void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
                     // need lightmap texcoord UV but doesn't have uv#1 so just reuse the same channel
                     networkMesh._vertexFormat->setAttribute(gpu::Stream::TEXCOORD1, channelNum - 1, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV));
                 }
-                if (mesh.clusterIndices.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_INDEX, channelNum++, gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW));
-                if (mesh.clusterWeights.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_WEIGHT, channelNum++, gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW));
+                if (mesh.clusterIndices.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_INDEX, channelNum++, clusterIndexElement);
+                if (mesh.clusterWeights.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_WEIGHT, channelNum++, clusterWeightElement);
             }
             else {
-                int colorsOffset = mesh.tangents.size() * sizeof(glm::vec3);
-                int texCoordsOffset = colorsOffset + mesh.colors.size() * sizeof(glm::vec3);
+                // the blended positions and normals come in as floats from the model's own buffers
+                int colorsOffset = tangents.size();
+                int texCoordsOffset = colorsOffset + colors.size();
                 int clusterIndicesOffset = texCoordsOffset + mesh.texCoords.size() * sizeof(glm::vec2);
-                int clusterWeightsOffset = clusterIndicesOffset + mesh.clusterIndices.size() * sizeof(glm::vec4);
+                int clusterWeightsOffset = clusterIndicesOffset + clusterIndices.size();
 
-                networkMesh._vertexBuffer->resize(clusterWeightsOffset + mesh.clusterWeights.size() * sizeof(glm::vec4));
-                networkMesh._vertexBuffer->setSubData(0, mesh.tangents.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.tangents.constData());
-                networkMesh._vertexBuffer->setSubData(colorsOffset, mesh.colors.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.colors.constData());
+                networkMesh._vertexBuffer->resize(clusterWeightsOffset + clusterWeights.size());
+                networkMesh._vertexBuffer->setSubData(0, tangents.size(), (gpu::Resource::Byte*) tangents.constData());
+                networkMesh._vertexBuffer->setSubData(colorsOffset,
+                    colors.size(), (gpu::Resource::Byte*) colors.constData());
                 networkMesh._vertexBuffer->setSubData(texCoordsOffset,
                     mesh.texCoords.size() * sizeof(glm::vec2), (gpu::Resource::Byte*) mesh.texCoords.constData());
                 networkMesh._vertexBuffer->setSubData(clusterIndicesOffset,
-                    mesh.clusterIndices.size() * sizeof(glm::vec4), (gpu::Resource::Byte*) mesh.clusterIndices.constData());
+                    clusterIndices.size(), (gpu::Resource::Byte*) clusterIndices.constData());
                 networkMesh._vertexBuffer->setSubData(clusterWeightsOffset,
-                    mesh.clusterWeights.size() * sizeof(glm::vec4), (gpu::Resource::Byte*) mesh.clusterWeights.constData());
+                    clusterWeights.size(), (gpu::Resource::Byte*) clusterWeights.constData());
 
                 networkMesh._vertexStream = gpu::BufferStreamPointer(new gpu::BufferStream());
-                if (mesh.tangents.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, 0, sizeof(glm::vec3));
-                if (mesh.colors.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, colorsOffset, sizeof(glm::vec3));
+                if (mesh.tangents.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, 0, directionStride);
+                if (mesh.colors.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, colorsOffset, colorStride);
                 if (mesh.texCoords.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, texCoordsOffset, sizeof(glm::vec2));
-                if (mesh.clusterIndices.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterIndicesOffset, sizeof(glm::vec4));
-                if (mesh.clusterWeights.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterWeightsOffset, sizeof(glm::vec4));
+                if (mesh.clusterIndices.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterIndicesOffset, clusterStride);
+                if (mesh.clusterWeights.size()) networkMesh._vertexStream->addBuffer(networkMesh._vertexBuffer, clusterWeightsOffset, clusterStride);
 
                 int channelNum = 0;
                 networkMesh._vertexFormat = gpu::Stream::FormatPointer(new gpu::Stream::Format());
                 networkMesh._vertexFormat->setAttribute(gpu::Stream::POSITION, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
                 if (mesh.normals.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::NORMAL, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-                if (mesh.tangents.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TANGENT, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-                if (mesh.colors.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::COLOR, channelNum++, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::RGB));
+                if (mesh.tangents.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TANGENT, channelNum++, directionElement);
+                if (mesh.colors.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::COLOR, channelNum++, colorElement);
                 if (mesh.texCoords.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::TEXCOORD, channelNum++, gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV));
-                if (mesh.clusterIndices.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_INDEX, channelNum++, gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW));
-                if (mesh.clusterWeights.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_WEIGHT, channelNum++, gpu::Element(gpu::VEC4, gpu::NFLOAT, gpu::XYZW));
+                if (mesh.clusterIndices.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_INDEX, channelNum++, clusterIndexElement);
+                if (mesh.clusterWeights.size()) networkMesh._vertexFormat->setAttribute(gpu::Stream::SKIN_CLUSTER_WEIGHT, channelNum++, clusterWeightElement);
 
             }
         }
@@ -2271,6 +2675,18 @@ void NetworkGeometry::setGeometry(const FBXGeometry& geometry) {
         _meshes.append(networkMesh);
     }
     
+    // the mesh buffers now hold the only copy of what just the shaders read; the positions, normals and part indices
+    // stay for blending, picking and collision shapes
+    for (int i = 0; i < _geometry.meshes.size(); i++) {
+        FBXMesh& mesh = _geometry.meshes[i];
+        QVector<glm::vec3>().swap(mesh.tangents);
+        QVector<glm::vec3>().swap(mesh.colors);
+        QVector<glm::vec2>().swap(mesh.texCoords);
+        QVector<glm::vec2>().swap(mesh.texCoords1);
+        QVector<glm::vec4>().swap(mesh.clusterIndices);
+        QVector<glm::vec4>().swap(mesh.clusterWeights);
+    }
+    
     finishedLoading(true);
 }
 
@@ -16,6 +16,7 @@
 #include <gpu/GPUConfig.h>
 
 #include <QMap>
+#include <QMutex>
 #include <QOpenGLBuffer>
 
 #include <DependencyManager.h>
@@ -141,6 +142,16 @@ public:
     void renderGrid(int xDivisions, int yDivisions, const glm::vec4& color);
     void renderGrid(int x, int y, int width, int height, int rows, int cols, const glm::vec4& color, int id = UNKNOWN_ID);
     void renderSolidCube(float size, const glm::vec4& color);
+
+    /// Records a solid unit cube for each transform, in its color, into a batch, with the buffers set up once for all
+    /// of them.  The batch's view transform should already be set.
+    void renderSolidCubeInstances(gpu::Batch& batch, const QVector<Transform>& transforms,
+                                  const QVector<glm::vec4>& colors);
+
+    /// Records a solid sphere for each transform, in its color, into a batch, with the buffers set up once for all of
+    /// them.  The batch's view transform should already be set.
+    void renderSphereInstances(gpu::Batch& batch, float radius, int slices, int stacks,
+                               const QVector<Transform>& transforms, const QVector<glm::vec4>& colors);
     void renderWireCube(float size, const glm::vec4& color);
     void renderBevelCornersRect(int x, int y, int width, int height, int bevelDistance, const glm::vec4& color, int id = UNKNOWN_ID);
 
@@ -204,6 +215,21 @@ public:
     /// \param delayLoad if true, don't load the geometry immediately; wait until load is first requested
     QSharedPointer<NetworkGeometry> getGeometry(const QUrl& url, const QUrl& fallback = QUrl(), bool delayLoad = false);
 
+    /// Sets whether meshes loaded from now on store their normals, tangents, colors and skinning in packed integer
+    /// formats rather than floats, which roughly halves their vertex memory.
+    void setPackVertices(bool packVertices) { _packVertices = packVertices; }
+    bool getPackVertices() const { return _packVertices; }
+
+    /// Finds the geometry a model read to the last time it was downloaded under this URL and validator (ETag or
+    /// Last-Modified) with this mapping. Returns false on a miss. Safe to call from the thread pool.
+    bool findCachedGeometry(const QUrl& url, const QVariantHash& mapping, const QByteArray& validator,
+        FBXGeometry& geometry);
+
+    /// Stores read geometry on disk so the next time the model is downloaded with the same validator and mapping it
+    /// doesn't need reading. Safe to call from the thread pool.
+    void storeCachedGeometry(const QUrl& url, const QVariantHash& mapping, const QByteArray& validator,
+        const FBXGeometry& geometry);
+
 protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url,
@@ -213,6 +239,14 @@ private:
     GeometryCache();
     virtual ~GeometryCache();
     
+    QString cachedGeometryPath(const QUrl& url, const QVariantHash& mapping, const QByteArray& validator) const;
+    void trimCachedGeometryDirectory();
+    
+    QString _cachedGeometryDirectory;
+    QMutex _cachedGeometryDirectoryMutex; // held while trimming, readers store from many threads
+
+    bool _packVertices = true;
+    
     typedef QPair<int, int> IntPair;
     typedef QPair<GLuint, GLuint> VerticesIndices;
     struct BufferDetails {
@@ -225,6 +259,9 @@ private:
     QHash<Vec2Pair, gpu::BufferPointer> _cubeColors;
     gpu::BufferPointer _wireCubeIndexBuffer;
 
+    void prepareSolidCube(float size);
+    void prepareSphere(float radius, int slices, int stacks);
+
     QHash<float, gpu::BufferPointer> _solidCubeVerticies;
     QHash<Vec2Pair, gpu::BufferPointer> _solidCubeColors;
     gpu::BufferPointer _solidCubeIndexBuffer;
@@ -259,11 +296,9 @@ private:
     QHash<int, BatchItemDetails> _registeredQuad2DTextures;
 
     QHash<int, Vec3PairVec4> _lastRegisteredQuad3D;
-    QHash<Vec3PairVec4, BatchItemDetails> _quad3D;
     QHash<int, BatchItemDetails> _registeredQuad3D;
 
     QHash<int, Vec4Pair> _lastRegisteredQuad2D;
-    QHash<Vec4Pair, BatchItemDetails> _quad2D;
     QHash<int, BatchItemDetails> _registeredQuad2D;
 
     QHash<int, Vec3Pair> _lastRegisteredBevelRects;
@@ -271,15 +306,23 @@ private:
     QHash<int, BatchItemDetails> _registeredBevelRects;
 
     QHash<int, Vec3Pair> _lastRegisteredLine3D;
-    QHash<Vec3Pair, BatchItemDetails> _line3DVBOs;
     QHash<int, BatchItemDetails> _registeredLine3DVBOs;
 
     QHash<int, Vec2Pair> _lastRegisteredLine2D;
-    QHash<Vec2Pair, BatchItemDetails> _line2DVBOs;
     QHash<int, BatchItemDetails> _registeredLine2DVBOs;
     
     QHash<int, BatchItemDetails> _registeredVertices;
 
+    /// Quads and lines drawn without an id are only wanted this once, rather than a buffer each they're written one
+    /// after the other into a buffer that only uploads what was just written, and draw from where they landed
+    void renderStreamed(gpu::Primitive primitiveType, int vertices, int floatsPerVertex,
+                        const float* positions, const int* colors);
+
+    gpu::BufferPointer _streamingBuffer;
+    gpu::Buffer::Size _streamingOffset;
+    gpu::Stream::FormatPointer _streamingFormat2D;
+    gpu::Stream::FormatPointer _streamingFormat3D;
+
     QHash<int, Vec3PairVec2Pair> _lastRegisteredDashedLines;
     QHash<Vec3PairVec2Pair, BatchItemDetails> _dashedLines;
     QHash<int, BatchItemDetails> _registeredDashedLines;
@@ -335,6 +378,9 @@ protected:
     virtual void reinsert();
     
     Q_INVOKABLE void setGeometry(const FBXGeometry& geometry);
+
+    /// Adds a LOD simplified from this geometry, to be used from the given distance on.
+    Q_INVOKABLE void addGeneratedLOD(const FBXGeometry& geometry, float distance);
     
 private slots:
     void replaceTexturesWithPendingChanges();
@@ -387,6 +433,10 @@ public:
 
     gpu::Stream::FormatPointer _vertexFormat;
     
+    // the attributes only the gpu reads are dropped from the FBXMesh once uploaded, so whether it had them is kept here
+    bool hasTangents = false;
+    bool hasColors = false;
+    
     QVector<NetworkMeshPart> parts;
     
     int getTranslucentPartCount(const FBXMesh& fbxMesh) const;
@@ -26,8 +26,7 @@
 
 GlowEffect::GlowEffect()
     : _initialized(false),
-      _isOddFrame(false),
-      _isFirstFrame(true),
+      _diffusedFramebufferObject(NULL),
       _intensity(0.0f),
       _widget(NULL),
       _enabled(false) {
@@ -42,12 +41,7 @@ GlowEffect::~GlowEffect() {
         delete _addSeparateProgram;
         delete _diffuseProgram;
     }
-}
-
-QOpenGLFramebufferObject* GlowEffect::getFreeFramebufferObject() const {
-    return (_isOddFrame ?
-                DependencyManager::get<TextureCache>()->getSecondaryFramebufferObject():
-                DependencyManager::get<TextureCache>()->getTertiaryFramebufferObject());
+    delete _diffusedFramebufferObject;
 }
 
 static ProgramObject* createProgram(const QString& name) {
@@ -108,7 +102,6 @@ void GlowEffect::prepare() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     _isEmpty = true;
-    _isOddFrame = !_isOddFrame;
 }
 
 void GlowEffect::begin(float intensity) {
@@ -136,7 +129,7 @@ static void maybeRelease(QOpenGLFramebufferObject* fbo) {
 }
 
 QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
-    PerformanceTimer perfTimer("glowEffect");
+    PERFORMANCE_TIMER("glowEffect");
 
     auto textureCache = DependencyManager::get<TextureCache>();
     QOpenGLFramebufferObject* primaryFBO = textureCache->getPrimaryFramebufferObject();
@@ -154,36 +147,32 @@ QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
     glDisable(GL_DEPTH_TEST);
     glDepthMask(GL_FALSE);
 
-    QOpenGLFramebufferObject* destFBO = toTexture ?
-        textureCache->getSecondaryFramebufferObject() : NULL;
+    QOpenGLFramebufferObject* destFBO = NULL;
     if (!_enabled || _isEmpty) {
-        // copy the primary to the screen
-        if (destFBO && QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
-            QOpenGLFramebufferObject::blitFramebuffer(destFBO, primaryFBO);
+        // nothing diffused is kept while there's nothing glowing
+        textureCache->releaseFramebufferObject(_diffusedFramebufferObject);
+        _diffusedFramebufferObject = NULL;
+        
+        if (toTexture) {
+            // the primary is the texture as it is, with nothing to add to it
+            destFBO = primaryFBO;
+            
         } else {
-            maybeBind(destFBO);
-            if (!destFBO) {
-                glViewport(0, 0, getDeviceWidth(), getDeviceHeight());
-            }
+            // copy the primary to the screen
+            glViewport(0, 0, getDeviceWidth(), getDeviceHeight());
             glEnable(GL_TEXTURE_2D);
             glDisable(GL_LIGHTING);
             renderFullscreenQuad();
             glDisable(GL_TEXTURE_2D);
             glEnable(GL_LIGHTING);
-            maybeRelease(destFBO);
         }
     } else {
-        // diffuse into the secondary/tertiary (alternating between frames)
-        QOpenGLFramebufferObject* oldDiffusedFBO =
-            textureCache->getSecondaryFramebufferObject();
-        QOpenGLFramebufferObject* newDiffusedFBO =
-            textureCache->getTertiaryFramebufferObject();
-        if (_isOddFrame) {
-            qSwap(oldDiffusedFBO, newDiffusedFBO);
-        }
+        // diffuse what was diffused last frame into a new target, which is kept for the next
+        QOpenGLFramebufferObject* oldDiffusedFBO = _diffusedFramebufferObject;
+        QOpenGLFramebufferObject* newDiffusedFBO = textureCache->acquireFramebufferObject();
         newDiffusedFBO->bind();
         
-        if (_isFirstFrame) {
+        if (!oldDiffusedFBO) {
             glClear(GL_COLOR_BUFFER_BIT);    
             
         } else {
@@ -205,7 +194,8 @@ QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
         glBindTexture(GL_TEXTURE_2D, newDiffusedFBO->texture());
         
         if (toTexture) {
-            destFBO = oldDiffusedFBO;
+            // the old diffusion is no longer wanted, so the sum can go there
+            destFBO = oldDiffusedFBO ? oldDiffusedFBO : textureCache->acquireFramebufferObject();
         }
         maybeBind(destFBO);
         if (!destFBO) {
@@ -219,6 +209,9 @@ QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
         glBindTexture(GL_TEXTURE_2D, 0);
         glActiveTexture(GL_TEXTURE0);
         
+        // handed back for the passes of the next frame, the returned texture being read before those
+        textureCache->releaseFramebufferObject(destFBO ? destFBO : oldDiffusedFBO);
+        _diffusedFramebufferObject = newDiffusedFBO;
     }
     
     glPopMatrix();
@@ -231,8 +224,6 @@ QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
     glDepthMask(GL_TRUE);
     glBindTexture(GL_TEXTURE_2D, 0);
     
-    _isFirstFrame = false;
-    
     return destFBO;
 }
 
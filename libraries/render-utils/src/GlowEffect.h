@@ -31,10 +31,6 @@ class GlowEffect : public QObject, public Dependency  {
     
 public:
    
-    /// Returns a pointer to the framebuffer object that the glow effect is *not* using for persistent state
-    /// (either the secondary or the tertiary).
-    QOpenGLFramebufferObject* getFreeFramebufferObject() const;
-    
     void init(QGLWidget* widget, bool enabled);
     
     /// Prepares the glow effect for rendering the current frame.  To be called before rendering the scene.
@@ -52,7 +48,8 @@ public:
     
     /// Renders the glow effect.  To be called after rendering the scene.
     /// \param toTexture whether to render to a texture, rather than to the frame buffer
-    /// \return the framebuffer object to which we rendered, or NULL if to the frame buffer
+    /// \return the framebuffer object to which we rendered, or NULL if to the frame buffer.  It may be the primary,
+    /// when there's nothing to add to it, and is to be read before the next frame's passes render to it
     QOpenGLFramebufferObject* render(bool toTexture = false);
 
 public slots:
@@ -76,8 +73,9 @@ private:
     int _diffusionScaleLocation;
     
     bool _isEmpty; ///< set when nothing in the scene is currently glowing
-    bool _isOddFrame; ///< controls the alternation between texture targets in diffuse add mode
-    bool _isFirstFrame; ///< for persistent modes, notes whether this is the first frame rendered
+    
+    /// what was diffused last frame, for the next to diffuse further, or NULL if nothing was glowing
+    QOpenGLFramebufferObject* _diffusedFramebufferObject;
     
     float _intensity;
     QStack<float> _intensityStack;
@@ -14,6 +14,7 @@
 #include <QThreadPool>
 
 #include <AngularConstraint.h>
+#include <MatrixKernel.h>
 #include <SharedUtil.h>
 
 #include "JointState.h"
@@ -38,6 +39,7 @@ JointState::JointState(const JointState& other) : _constraint(NULL) {
     _distanceToParent = other._distanceToParent;
     _animationPriority = other._animationPriority;
     _fbxJoint = other._fbxJoint;
+    _translatedPreTransform = other._translatedPreTransform;
     // DO NOT copy _constraint
 }
 
@@ -67,6 +69,7 @@ void JointState::setFBXJoint(const FBXJoint* joint) {
     
     // NOTE: JointState does not own the FBXJoint to which it points.
     _fbxJoint = joint;
+    _translatedPreTransform = glm::translate(joint->translation) * joint->preTransform;
     if (_constraint) {
         delete _constraint;
         _constraint = NULL;
@@ -113,8 +116,9 @@ void JointState::computeTransform(const glm::mat4& parentTransform, bool parentT
     }
     
     glm::quat rotationInParentFrame = _fbxJoint->preRotation * _rotationInConstrainedFrame * _fbxJoint->postRotation;
-    glm::mat4 transformInParentFrame = _fbxJoint->preTransform * glm::mat4_cast(rotationInParentFrame) * _fbxJoint->postTransform;
-    glm::mat4 newTransform = parentTransform * glm::translate(_fbxJoint->translation) * transformInParentFrame;
+    glm::mat4 newTransform = MatrixKernel::multiply(parentTransform, _translatedPreTransform);
+    MatrixKernel::multiply(newTransform, newTransform, glm::mat4_cast(rotationInParentFrame));
+    MatrixKernel::multiply(newTransform, newTransform, _fbxJoint->postTransform);
     
     if (newTransform != _transform) {
         _transform = newTransform;
@@ -125,8 +129,9 @@ void JointState::computeTransform(const glm::mat4& parentTransform, bool parentT
 
 void JointState::computeVisibleTransform(const glm::mat4& parentTransform) {
     glm::quat rotationInParentFrame = _fbxJoint->preRotation * _visibleRotationInConstrainedFrame * _fbxJoint->postRotation;
-    glm::mat4 transformInParentFrame = _fbxJoint->preTransform * glm::mat4_cast(rotationInParentFrame) * _fbxJoint->postTransform;
-    _visibleTransform = parentTransform * glm::translate(_fbxJoint->translation) * transformInParentFrame;
+    MatrixKernel::multiply(_visibleTransform, parentTransform, _translatedPreTransform);
+    MatrixKernel::multiply(_visibleTransform, _visibleTransform, glm::mat4_cast(rotationInParentFrame));
+    MatrixKernel::multiply(_visibleTransform, _visibleTransform, _fbxJoint->postTransform);
     _visibleRotation = extractRotation(_visibleTransform);
 }
 
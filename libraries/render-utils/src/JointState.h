@@ -123,6 +123,7 @@ private:
     glm::quat _visibleRotationInConstrainedFrame;
 
     const FBXJoint* _fbxJoint; // JointState does NOT own its FBXJoint
+    glm::mat4 _translatedPreTransform; // the joint's translation and pre-transform, which never change
     AngularConstraint* _constraint; // JointState owns its AngularConstraint
 };
 
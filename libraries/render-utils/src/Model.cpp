@@ -11,6 +11,8 @@
 
 #include <gpu/GPUConfig.h>
 
+#include <atomic>
+
 #include <QMetaType>
 #include <QRunnable>
 #include <QThreadPool>
@@ -22,6 +24,7 @@
 #include <GeometryUtil.h>
 #include <gpu/Batch.h>
 #include <gpu/GLBackend.h>
+#include <MatrixKernel.h>
 #include <PathUtils.h>
 #include <PerfStat.h>
 #include <PhysicsEntity.h>
@@ -81,7 +84,6 @@ Model::Model(QObject* parent) :
     _blendNumber(0),
     _appliedBlendNumber(0),
     _calculatedMeshBoxesValid(false),
-    _calculatedMeshTrianglesValid(false),
     _meshGroupsKnown(false) {
     
     // we may have been created in the network thread, but we live in the main thread
@@ -230,6 +232,18 @@ void Model::initProgram(ProgramObject& program, Model::Locations& locations, boo
     program.release();
 }
 
+// the skinning matrices are kept in a uniform buffer where the skin programs have a uniform block for them, and
+// uploaded per draw elsewhere
+#if defined(Q_OS_WIN)
+static const bool USE_SKIN_CLUSTER_BUFFER = true;
+#else
+static const bool USE_SKIN_CLUSTER_BUFFER = false;
+#endif
+
+// must match MAX_CLUSTERS in Skinning.slh
+static const int MAX_SKIN_CLUSTERS = 128;
+static const int SKIN_CLUSTER_BUFFER_BINDING = 2;
+
 void Model::initSkinProgram(ProgramObject& program, Model::SkinLocations& locations) {
     program.bindAttributeLocation("tangent", gpu::Stream::TANGENT);
     program.bindAttributeLocation("texcoord1", gpu::Stream::TEXCOORD1);
@@ -241,7 +255,20 @@ void Model::initSkinProgram(ProgramObject& program, Model::SkinLocations& locati
 
     program.bind();
 
-    locations.clusterMatrices = program.uniformLocation("clusterMatrices");    
+    // bindable uniform version, as for the material buffer
+#if defined(Q_OS_WIN)
+    int loc = glGetUniformBlockIndex(program.programId(), "skinClusterBuffer");
+    if (loc >= 0) {
+        glUniformBlockBinding(program.programId(), loc, SKIN_CLUSTER_BUFFER_BINDING);
+        locations.clusterBufferUnit = SKIN_CLUSTER_BUFFER_BINDING;
+    } else {
+        locations.clusterBufferUnit = -1;
+    }
+    locations.clusterMatrices = -1;
+#else
+    locations.clusterBufferUnit = -1;
+    locations.clusterMatrices = program.uniformLocation("clusterMatrices");
+#endif
     locations.clusterIndices = program.attributeLocation("clusterIndices");
     locations.clusterWeights = program.attributeLocation("clusterWeights");
 
@@ -282,71 +309,56 @@ void Model::initJointTransforms() {
 
 void Model::init() {
     if (!_program.isLinked()) {
-        _program.addShaderFromSourceCode(QGLShader::Vertex, model_vert);
-        _program.addShaderFromSourceCode(QGLShader::Fragment, model_frag);
+        _program.addShadersFromSourceCode(model_vert, model_frag);
         initProgram(_program, _locations);
         
-        _normalMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_normal_map_vert);
-        _normalMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_normal_map_frag);
+        _normalMapProgram.addShadersFromSourceCode(model_normal_map_vert, model_normal_map_frag);
         initProgram(_normalMapProgram, _normalMapLocations);
         
-        _specularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_vert);
-        _specularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_specular_map_frag);
+        _specularMapProgram.addShadersFromSourceCode(model_vert, model_specular_map_frag);
         initProgram(_specularMapProgram, _specularMapLocations);
         
-        _normalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_normal_map_vert);
-        _normalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_normal_specular_map_frag);
+        _normalSpecularMapProgram.addShadersFromSourceCode(model_normal_map_vert, model_normal_specular_map_frag);
         initProgram(_normalSpecularMapProgram, _normalSpecularMapLocations);
         
-        _translucentProgram.addShaderFromSourceCode(QGLShader::Vertex, model_vert);
-        _translucentProgram.addShaderFromSourceCode(QGLShader::Fragment, model_translucent_frag);
+        _translucentProgram.addShadersFromSourceCode(model_vert, model_translucent_frag);
         initProgram(_translucentProgram, _translucentLocations);
 
         // Lightmap
-        _lightmapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_lightmap_vert);
-        _lightmapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_lightmap_frag);
+        _lightmapProgram.addShadersFromSourceCode(model_lightmap_vert, model_lightmap_frag);
         initProgram(_lightmapProgram, _lightmapLocations);
 
-        _lightmapNormalMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_lightmap_normal_map_vert);
-        _lightmapNormalMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_lightmap_normal_map_frag);
+        _lightmapNormalMapProgram.addShadersFromSourceCode(model_lightmap_normal_map_vert, model_lightmap_normal_map_frag);
         initProgram(_lightmapNormalMapProgram, _lightmapNormalMapLocations);
         
-        _lightmapSpecularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_lightmap_vert);
-        _lightmapSpecularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_lightmap_specular_map_frag);
+        _lightmapSpecularMapProgram.addShadersFromSourceCode(model_lightmap_vert, model_lightmap_specular_map_frag);
         initProgram(_lightmapSpecularMapProgram, _lightmapSpecularMapLocations);
         
-        _lightmapNormalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_lightmap_normal_map_vert);
-        _lightmapNormalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_lightmap_normal_specular_map_frag);
+        _lightmapNormalSpecularMapProgram.addShadersFromSourceCode(model_lightmap_normal_map_vert, model_lightmap_normal_specular_map_frag);
         initProgram(_lightmapNormalSpecularMapProgram, _lightmapNormalSpecularMapLocations);
         // end lightmap
 
         
-        _shadowProgram.addShaderFromSourceCode(QGLShader::Vertex, model_shadow_vert);
-        _shadowProgram.addShaderFromSourceCode(QGLShader::Fragment, model_shadow_frag);
+        _shadowProgram.addShadersFromSourceCode(model_shadow_vert, model_shadow_frag);
+        _shadowProgram.link();
 
-        _skinProgram.addShaderFromSourceCode(QGLShader::Vertex, skin_model_vert);
-        _skinProgram.addShaderFromSourceCode(QGLShader::Fragment, model_frag);
+        _skinProgram.addShadersFromSourceCode(skin_model_vert, model_frag, "skin");
         initSkinProgram(_skinProgram, _skinLocations);
         
-        _skinNormalMapProgram.addShaderFromSourceCode(QGLShader::Vertex, skin_model_normal_map_vert);
-        _skinNormalMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_normal_map_frag);
+        _skinNormalMapProgram.addShadersFromSourceCode(skin_model_normal_map_vert, model_normal_map_frag, "skin");
         initSkinProgram(_skinNormalMapProgram, _skinNormalMapLocations);
         
-        _skinSpecularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, model_vert);
-        _skinSpecularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_specular_map_frag);
+        _skinSpecularMapProgram.addShadersFromSourceCode(model_vert, model_specular_map_frag, "skin");
         initSkinProgram(_skinSpecularMapProgram, _skinSpecularMapLocations);
         
-        _skinNormalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Vertex, skin_model_normal_map_vert);
-        _skinNormalSpecularMapProgram.addShaderFromSourceCode(QGLShader::Fragment, model_normal_specular_map_frag);
+        _skinNormalSpecularMapProgram.addShadersFromSourceCode(skin_model_normal_map_vert, model_normal_specular_map_frag, "skin");
         initSkinProgram(_skinNormalSpecularMapProgram, _skinNormalSpecularMapLocations);
         
-        _skinShadowProgram.addShaderFromSourceCode(QGLShader::Vertex, skin_model_shadow_vert);
-        _skinShadowProgram.addShaderFromSourceCode(QGLShader::Fragment, model_shadow_frag);
+        _skinShadowProgram.addShadersFromSourceCode(skin_model_shadow_vert, model_shadow_frag, "skin");
         initSkinProgram(_skinShadowProgram, _skinShadowLocations);
         
 
-        _skinTranslucentProgram.addShaderFromSourceCode(QGLShader::Vertex, skin_model_vert);
-        _skinTranslucentProgram.addShaderFromSourceCode(QGLShader::Fragment, model_translucent_frag);
+        _skinTranslucentProgram.addShadersFromSourceCode(skin_model_vert, model_translucent_frag, "skin");
         initSkinProgram(_skinTranslucentProgram, _skinTranslucentLocations);
     }
 }
@@ -366,7 +378,16 @@ void Model::reset() {
     _meshGroupsKnown = false;
 }
 
+void Model::prepareGeometry() {
+    _preparedGeometryNeedsFullUpdate = updateGeometry();
+    _geometryPrepared = true;
+}
+
 bool Model::updateGeometry() {
+    if (_geometryPrepared) {
+        _geometryPrepared = false;
+        return _preparedGeometryNeedsFullUpdate;
+    }
     // NOTE: this is a recursive call that walks all attachments, and their attachments
     bool needFullUpdate = false;
     for (int i = 0; i < _attachments.size(); i++) {
@@ -379,7 +400,7 @@ bool Model::updateGeometry() {
     bool needToRebuild = false;
     if (_nextGeometry) {
         _nextGeometry = _nextGeometry->getLODOrFallback(_lodDistance, _nextLODHysteresis);
-        _nextGeometry->setLoadPriority(this, -_lodDistance);
+        _nextGeometry->setLoadPriority(this, getScreenSpaceLoadPriority());
         _nextGeometry->ensureLoading();
         if (_nextGeometry->isLoaded()) {
             applyNextGeometry();
@@ -426,25 +447,50 @@ bool Model::updateGeometry() {
         deleteGeometry();
         _dilatedTextures.clear();
     }
-    _geometry->setLoadPriority(this, -_lodDistance);
+    _geometry->setLoadPriority(this, getScreenSpaceLoadPriority());
     _geometry->ensureLoading();
    
     if (needToRebuild) {
         const FBXGeometry& fbxGeometry = geometry->getFBXGeometry();
+        // each skinned mesh gets a whole block's worth of matrices, so every offset it is bound at is aligned
+        int clusterBufferSize = 0;
         foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
             MeshState state;
             state.clusterMatrices.resize(mesh.clusters.size());
+            state.clusterBufferOffset = clusterBufferSize;
+            if (USE_SKIN_CLUSTER_BUFFER && mesh.clusters.size() > 1) {
+                clusterBufferSize += MAX_SKIN_CLUSTERS * sizeof(glm::mat4);
+            }
             _meshStates.append(state);    
 
             gpu::BufferPointer buffer(new gpu::Buffer());
+            gpu::BufferPointer normalBuffer(new gpu::Buffer());
+            QPair<int, int> blendedRange(0, 0);
             if (!mesh.blendshapes.isEmpty()) {
-                buffer->resize((mesh.vertices.size() + mesh.normals.size()) * sizeof(glm::vec3));
-                buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.vertices.constData());
-                buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
-                    mesh.normals.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) mesh.normals.constData());
+                buffer->setData(mesh.vertices.size() * sizeof(glm::vec3),
+                    (gpu::Resource::Byte*) mesh.vertices.constData());
+                normalBuffer->setData(mesh.normals.size() * sizeof(glm::vec3),
+                    (gpu::Resource::Byte*) mesh.normals.constData());
+                
+                // only the vertices between the first and last any blendshape moves are blended and uploaded
+                int first = mesh.vertices.size();
+                int last = -1;
+                foreach (const FBXBlendshape& blendshape, mesh.blendshapes) {
+                    foreach (int index, blendshape.indices) {
+                        first = qMin(first, index);
+                        last = qMax(last, index);
+                    }
+                }
+                if (last >= first) {
+                    blendedRange = qMakePair(first, last - first + 1);
+                }
             }
             _blendedVertexBuffers.push_back(buffer);
+            _blendedNormalBuffers.push_back(normalBuffer);
+            _blendedRanges.append(blendedRange);
         }
+        _clusterBuffer.reset(new gpu::Buffer());
+        _clusterBuffer->resize(clusterBufferSize);
         foreach (const FBXAttachment& attachment, fbxGeometry.attachments) {
             Model* model = new Model(this);
             model->init();
@@ -457,6 +503,17 @@ bool Model::updateGeometry() {
 }
 
 // virtual
+float Model::getScreenSpaceLoadPriority() const {
+    // until the geometry arrives, the scale (or the dimensions it will be fit to) is the best guess at its size
+    float size = _scaleToFit ? glm::length(_scaleToFitDimensions) : glm::length(_scale);
+    float distance = _lodDistance;
+    if (_viewState && _viewState->getCurrentViewFrustum()) {
+        distance = glm::distance(_viewState->getCurrentViewFrustum()->getPosition(), _translation);
+    }
+    const float MIN_PRIORITY_DISTANCE = 0.1f;
+    return size / glm::max(distance, MIN_PRIORITY_DISTANCE);
+}
+
 void Model::setJointStates(QVector<JointState> states) {
     _jointStates = states;
     initJointTransforms();
@@ -513,34 +570,31 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
         int subMeshIndex = 0;
 
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
+        
+        // the triangles are picked in the frame of the geometry, into which the ray goes by undoing what
+        // calculateScaledOffsetPoint does.  That's affine, so the distances along the ray stay the same
+        const QVector<TriangleBVH>* meshBVHs = pickAgainstTriangles ? getMeshTriangleBVHs() : NULL;
+        glm::quat inverseRotation = glm::inverse(_rotation);
+        glm::vec3 geometryFrameOrigin = (inverseRotation * (origin - _translation)) / _scale - _offset;
+        glm::vec3 geometryFrameDirection = (inverseRotation * direction) / _scale;
 
         // If we hit the models box, then consider the submeshes...
         foreach(const AABox& subMeshBox, _calculatedMeshBoxes) {
 
             if (subMeshBox.findRayIntersection(origin, direction, distanceToSubMesh, subMeshFace)) {
                 if (distanceToSubMesh < bestDistance) {
-                    if (pickAgainstTriangles) {
-                        if (!_calculatedMeshTrianglesValid) {
-                            recalculateMeshBoxes(pickAgainstTriangles);
-                        }
+                    if (meshBVHs) {
                         // check our triangles here....
-                        const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                        int t = 0;
-                        foreach (const Triangle& triangle, meshTriangles) {
-                            t++;
-                        
-                            float thisTriangleDistance;
-                            if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance)) {
-                                if (thisTriangleDistance < bestDistance) {
-                                    bestDistance = thisTriangleDistance;
-                                    intersectedSomething = true;
-                                    face = subMeshFace;
-                                    extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
-                                }
-                            }
+                        float triangleDistance;
+                        if (meshBVHs->at(subMeshIndex).findRayIntersection(geometryFrameOrigin,
+                                geometryFrameDirection, triangleDistance, bestDistance)) {
+                            bestDistance = triangleDistance;
+                            intersectedSomething = true;
+                            face = subMeshFace;
+                            extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
                         }
                     } else {
-                        // this is the non-triangle picking case...
+                        // this is the non-triangle picking case, and that of the triangles not being ready yet...
                         bestDistance = distanceToSubMesh;
                         intersectedSomething = true;
                         face = subMeshFace;
@@ -562,80 +616,100 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
 }
 
 // TODO: we seem to call this too often when things haven't actually changed... look into optimizing this
-void Model::recalculateMeshBoxes(bool pickAgainstTriangles) {
-    bool calculatedMeshTrianglesNeeded = pickAgainstTriangles && !_calculatedMeshTrianglesValid;
-
-    if (!_calculatedMeshBoxesValid || calculatedMeshTrianglesNeeded) {
+void Model::recalculateMeshBoxes() {
+    if (!_calculatedMeshBoxesValid) {
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
         int numberOfMeshes = geometry.meshes.size();
         _calculatedMeshBoxes.resize(numberOfMeshes);
-        _calculatedMeshTriangles.clear();
-        _calculatedMeshTriangles.resize(numberOfMeshes);
         for (int i = 0; i < numberOfMeshes; i++) {
             const FBXMesh& mesh = geometry.meshes.at(i);
             Extents scaledMeshExtents = calculateScaledOffsetExtents(mesh.meshExtents);
 
             _calculatedMeshBoxes[i] = AABox(scaledMeshExtents);
+        }
+        _calculatedMeshBoxesValid = true;
+    }
+}
 
-            if (pickAgainstTriangles) {
-                QVector<Triangle> thisMeshTriangles;
-                for (int j = 0; j < mesh.parts.size(); j++) {
-                    const FBXMeshPart& part = mesh.parts.at(j);
-
-                    const int INDICES_PER_TRIANGLE = 3;
-                    const int INDICES_PER_QUAD = 4;
-
-                    if (part.quadIndices.size() > 0) {
-                        int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
-                        int vIndex = 0;
-                        for (int q = 0; q < numberOfQuads; q++) {
-                            int i0 = part.quadIndices[vIndex++];
-                            int i1 = part.quadIndices[vIndex++];
-                            int i2 = part.quadIndices[vIndex++];
-                            int i3 = part.quadIndices[vIndex++];
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f)));
-                            glm::vec3 v1 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f)));
-                            glm::vec3 v2 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f)));
-                            glm::vec3 v3 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i3], 1.0f)));
-                        
-                            // Sam's recommended triangle slices
-                            Triangle tri1 = { v0, v1, v3 };
-                            Triangle tri2 = { v1, v2, v3 };
-                        
-                            // NOTE: Random guy on the internet's recommended triangle slices
-                            //Triangle tri1 = { v0, v1, v2 };
-                            //Triangle tri2 = { v2, v3, v0 };
-                        
-                            thisMeshTriangles.push_back(tri1);
-                            thisMeshTriangles.push_back(tri2);
-                        }
-                    }
+/// The triangle hierarchies of a geometry's meshes, which a worker thread builds.  They're read only once finished.
+class MeshTriangleBVHs {
+public:
+    QWeakPointer<NetworkGeometry> geometry;
+    QVector<TriangleBVH> meshes;
+    std::atomic<bool> finished;
+    
+    MeshTriangleBVHs(const QWeakPointer<NetworkGeometry>& geometry) : geometry(geometry), finished(false) { }
+};
 
-                    if (part.triangleIndices.size() > 0) {
-                        int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
-                        int vIndex = 0;
-                        for (int t = 0; t < numberOfTris; t++) {
-                            int i0 = part.triangleIndices[vIndex++];
-                            int i1 = part.triangleIndices[vIndex++];
-                            int i2 = part.triangleIndices[vIndex++];
+class MeshTriangleBVHBuilder : public QRunnable {
+public:
+    
+    MeshTriangleBVHBuilder(const QSharedPointer<MeshTriangleBVHs>& bvhs, const QVector<FBXMesh>& meshes,
+        const glm::mat4& offset) : _bvhs(bvhs), _meshes(meshes), _offset(offset) { }
+    
+    virtual void run();
 
-                            glm::vec3 v0 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f)));
-                            glm::vec3 v1 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f)));
-                            glm::vec3 v2 = calculateScaledOffsetPoint(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f)));
+private:
+    
+    QSharedPointer<MeshTriangleBVHs> _bvhs;
+    QVector<FBXMesh> _meshes;
+    glm::mat4 _offset;
+};
 
-                            Triangle tri = { v0, v1, v2 };
+void MeshTriangleBVHBuilder::run() {
+    QVector<TriangleBVH> meshBVHs;
+    meshBVHs.reserve(_meshes.size());
+    foreach (const FBXMesh& mesh, _meshes) {
+        glm::mat4 transform = _offset * mesh.modelTransform;
+        QVector<Triangle> meshTriangles;
+        for (int j = 0; j < mesh.parts.size(); j++) {
+            const FBXMeshPart& part = mesh.parts.at(j);
 
-                            thisMeshTriangles.push_back(tri);
-                        }
-                    }
-                }
-                _calculatedMeshTriangles[i] = thisMeshTriangles;
+            const int INDICES_PER_TRIANGLE = 3;
+            const int INDICES_PER_QUAD = 4;
+
+            const QVector<int>& quadIndices = part.quadIndices;
+            int numberOfQuads = quadIndices.size() / INDICES_PER_QUAD;
+            for (int q = 0, vIndex = 0; q < numberOfQuads; q++) {
+                glm::vec3 v0 = glm::vec3(transform * glm::vec4(mesh.vertices.at(quadIndices.at(vIndex++)), 1.0f));
+                glm::vec3 v1 = glm::vec3(transform * glm::vec4(mesh.vertices.at(quadIndices.at(vIndex++)), 1.0f));
+                glm::vec3 v2 = glm::vec3(transform * glm::vec4(mesh.vertices.at(quadIndices.at(vIndex++)), 1.0f));
+                glm::vec3 v3 = glm::vec3(transform * glm::vec4(mesh.vertices.at(quadIndices.at(vIndex++)), 1.0f));
+                
+                // Sam's recommended triangle slices
+                Triangle tri1 = { v0, v1, v3 };
+                Triangle tri2 = { v1, v2, v3 };
+                meshTriangles.append(tri1);
+                meshTriangles.append(tri2);
+            }
+
+            const QVector<int>& triangleIndices = part.triangleIndices;
+            int numberOfTris = triangleIndices.size() / INDICES_PER_TRIANGLE;
+            for (int t = 0, vIndex = 0; t < numberOfTris; t++) {
+                glm::vec3 v0 = glm::vec3(transform * glm::vec4(mesh.vertices.at(triangleIndices.at(vIndex++)), 1.0f));
+                glm::vec3 v1 = glm::vec3(transform * glm::vec4(mesh.vertices.at(triangleIndices.at(vIndex++)), 1.0f));
+                glm::vec3 v2 = glm::vec3(transform * glm::vec4(mesh.vertices.at(triangleIndices.at(vIndex++)), 1.0f));
+
+                Triangle tri = { v0, v1, v2 };
+                meshTriangles.append(tri);
             }
         }
-        _calculatedMeshBoxesValid = true;
-        _calculatedMeshTrianglesValid = pickAgainstTriangles;
+        meshBVHs.append(TriangleBVH(meshTriangles));
+    }
+    _bvhs->meshes = meshBVHs;
+    _bvhs->finished.store(true, std::memory_order_release);
+}
+
+const QVector<TriangleBVH>* Model::getMeshTriangleBVHs() {
+    if (!_meshTriangleBVHs || _meshTriangleBVHs->geometry.toStrongRef() != _geometry) {
+        // the meshes are implicitly shared, so the builder doesn't read them from under a geometry that changes
+        const FBXGeometry& geometry = _geometry->getFBXGeometry();
+        _meshTriangleBVHs = QSharedPointer<MeshTriangleBVHs>(new MeshTriangleBVHs(_geometry));
+        QThreadPool::globalInstance()->start(new MeshTriangleBVHBuilder(_meshTriangleBVHs, geometry.meshes,
+            geometry.offset));
+        return NULL;
     }
+    return _meshTriangleBVHs->finished.load(std::memory_order_acquire) ? &_meshTriangleBVHs->meshes : NULL;
 }
 
 void Model::renderSetup(RenderArgs* args) {
@@ -1084,7 +1158,8 @@ class Blender : public QRunnable {
 public:
 
     Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients);
+        const QVector<FBXMesh>& meshes, const QVector<QPair<int, int> >& blendedRanges,
+        const QVector<float>& blendshapeCoefficients);
     
     virtual void run();
 
@@ -1094,31 +1169,45 @@ private:
     int _blendNumber;
     QWeakPointer<NetworkGeometry> _geometry;
     QVector<FBXMesh> _meshes;
+    QVector<QPair<int, int> > _blendedRanges;
     QVector<float> _blendshapeCoefficients;
 };
 
 Blender::Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients) :
+        const QVector<FBXMesh>& meshes, const QVector<QPair<int, int> >& blendedRanges,
+        const QVector<float>& blendshapeCoefficients) :
     _model(model),
     _blendNumber(blendNumber),
     _geometry(geometry),
     _meshes(meshes),
+    _blendedRanges(blendedRanges),
     _blendshapeCoefficients(blendshapeCoefficients) {
 }
 
 void Blender::run() {
     QVector<glm::vec3> vertices, normals;
     if (!_model.isNull()) {
+        // only the range of each mesh its blendshapes move is blended, and sent back packed one after another
+        int blendedVertexCount = 0;
+        for (int i = 0; i < _meshes.size(); i++) {
+            blendedVertexCount += _meshes.at(i).blendshapes.isEmpty() ? 0 : _blendedRanges.at(i).second;
+        }
+        vertices.resize(blendedVertexCount);
+        normals.resize(blendedVertexCount);
+        
         int offset = 0;
-        foreach (const FBXMesh& mesh, _meshes) {
+        for (int meshIndex = 0; meshIndex < _meshes.size(); meshIndex++) {
+            const FBXMesh& mesh = _meshes.at(meshIndex);
             if (mesh.blendshapes.isEmpty()) {
                 continue;
             }
-            vertices += mesh.vertices;
-            normals += mesh.normals;
+            int first = _blendedRanges.at(meshIndex).first;
+            int count = _blendedRanges.at(meshIndex).second;
             glm::vec3* meshVertices = vertices.data() + offset;
             glm::vec3* meshNormals = normals.data() + offset;
-            offset += mesh.vertices.size();
+            memcpy(meshVertices, mesh.vertices.constData() + first, count * sizeof(glm::vec3));
+            memcpy(meshNormals, mesh.normals.constData() + first, count * sizeof(glm::vec3));
+            offset += count;
             const float NORMAL_COEFFICIENT_SCALE = 0.01f;
             for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
                 float vertexCoefficient = _blendshapeCoefficients.at(i);
@@ -1128,7 +1217,7 @@ void Blender::run() {
                 float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
                 const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
                 for (int j = 0; j < blendshape.indices.size(); j++) {
-                    int index = blendshape.indices.at(j);
+                    int index = blendshape.indices.at(j) - first;
                     meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
                     meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
                 }
@@ -1223,7 +1312,6 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
                     
     if (isActive() && fullUpdate) {
         _calculatedMeshBoxesValid = false; // if we have to simulate, we need to assume our mesh boxes are all invalid
-        _calculatedMeshTrianglesValid = false;
 
         // check for scale to fit
         if (_scaleToFit && !_scaledToFit) {
@@ -1279,20 +1367,30 @@ void Model::simulateInternal(float deltaTime) {
         }
     }
     
+    // a joint's world transform is shared by every cluster bound to it, in any of the meshes
     glm::mat4 modelToWorld = glm::mat4_cast(_rotation);
+    _jointWorldTransforms.resize(_jointStates.size());
+    glm::mat4* jointWorldTransforms = _jointWorldTransforms.data();
+    for (int i = 0; i < _jointStates.size(); i++) {
+        const JointState& jointState = _jointStates.at(i);
+        MatrixKernel::multiply(jointWorldTransforms[i], modelToWorld,
+            _showTrueJointTransforms ? jointState.getTransform() : jointState.getVisibleTransform());
+    }
+
+    // the cluster matrices are computed into the mesh states, then copied once into the skeleton's uniform buffer
     for (int i = 0; i < _meshStates.size(); i++) {
         MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
-        if (_showTrueJointTransforms) {
-            for (int j = 0; j < mesh.clusters.size(); j++) {
-                const FBXCluster& cluster = mesh.clusters.at(j);
-                state.clusterMatrices[j] = modelToWorld * _jointStates[cluster.jointIndex].getTransform() * cluster.inverseBindMatrix;
-            }
-        } else {
-            for (int j = 0; j < mesh.clusters.size(); j++) {
-                const FBXCluster& cluster = mesh.clusters.at(j);
-                state.clusterMatrices[j] = modelToWorld * _jointStates[cluster.jointIndex].getVisibleTransform() * cluster.inverseBindMatrix;
-            }
+        glm::mat4* clusterMatrices = state.clusterMatrices.data();
+        for (int j = 0; j < mesh.clusters.size(); j++) {
+            const FBXCluster& cluster = mesh.clusters.at(j);
+            MatrixKernel::multiply(clusterMatrices[j], jointWorldTransforms[cluster.jointIndex],
+                cluster.inverseBindMatrix);
+        }
+        if (USE_SKIN_CLUSTER_BUFFER && mesh.clusters.size() > 1) {
+            int clusterCount = qMin(mesh.clusters.size(), MAX_SKIN_CLUSTERS);
+            _clusterBuffer->updateSubData(state.clusterBufferOffset, clusterCount * sizeof(glm::mat4),
+                (const gpu::Resource::Byte*)clusterMatrices);
         }
     }
     
@@ -1566,7 +1664,7 @@ bool Model::maybeStartBlender() {
     const FBXGeometry& fbxGeometry = _geometry->getFBXGeometry();
     if (fbxGeometry.hasBlendedMeshes()) {
         QThreadPool::globalInstance()->start(new Blender(this, ++_blendNumber, _geometry,
-            fbxGeometry.meshes, _blendshapeCoefficients));
+            fbxGeometry.meshes, _blendedRanges, _blendshapeCoefficients));
         return true;
     }
     return false;
@@ -1586,12 +1684,14 @@ void Model::setBlendedVertices(int blendNumber, const QWeakPointer<NetworkGeomet
             continue;
         }
 
-        gpu::BufferPointer& buffer = _blendedVertexBuffers[i];
-        buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) vertices.constData() + index*sizeof(glm::vec3));
-        buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
-            mesh.normals.size() * sizeof(glm::vec3), (gpu::Resource::Byte*) normals.constData() + index*sizeof(glm::vec3));
+        // rewrite just the blended range, which is all the backend uploads
+        const QPair<int, int>& range = _blendedRanges.at(i);
+        _blendedVertexBuffers[i]->updateSubData(range.first * sizeof(glm::vec3), range.second * sizeof(glm::vec3),
+            (gpu::Resource::Byte*) (vertices.constData() + index));
+        _blendedNormalBuffers[i]->updateSubData(range.first * sizeof(glm::vec3), range.second * sizeof(glm::vec3),
+            (gpu::Resource::Byte*) (normals.constData() + index));
 
-        index += mesh.vertices.size();
+        index += range.second;
     }
 }
 
@@ -1615,8 +1715,11 @@ void Model::deleteGeometry() {
     }
     _attachments.clear();
     _blendedVertexBuffers.clear();
+    _blendedNormalBuffers.clear();
+    _blendedRanges.clear();
     _jointStates.clear();
     _meshStates.clear();
+    _clusterBuffer.reset();
     clearShapes();
     
     for (QSet<WeakAnimationHandlePointer>::iterator it = _animationHandles.begin(); it != _animationHandles.end(); ) {
@@ -1638,38 +1741,76 @@ void Model::deleteGeometry() {
 
 // Scene rendering support
 QVector<Model*> Model::_modelsInScene;
-gpu::Batch Model::_sceneRenderBatch;
+gpu::Batch Model::_sceneRenderBatches[SCENE_PASSES];
+Transform Model::_sceneRecordedViewTransform;
+QThreadPool Model::_scenePassPool;
+QVector<Model::RenderItem> Model::_renderQueue;
+
+// the sort key of a queued mesh, from the most significant bits down: the pass that draws it, its program, a hash of
+// its geometry and first material, and its distance from the camera
+static const int QUEUE_STAGE_SHIFT = 62;
+static const int QUEUE_PROGRAM_SHIFT = 58;
+static const int QUEUE_MATERIAL_SHIFT = 32;
+static const quint64 QUEUE_MATERIAL_MASK = (1 << 26) - 1;
+
+enum {
+    SKINNED_QUEUE_PROGRAM = 1,
+    SPECULAR_QUEUE_PROGRAM = 2,
+    TANGENTS_QUEUE_PROGRAM = 4,
+    LIGHTMAP_QUEUE_PROGRAM = 8,
+    QUEUE_PROGRAMS = 16
+};
+
 void Model::startScene(RenderArgs::RenderSide renderSide) {
     if (renderSide != RenderArgs::STEREO_RIGHT) {
         _modelsInScene.clear();
     }
 }
 
-void Model::setupBatchTransform(gpu::Batch& batch) {
-    
+void Model::captureViewTransform() {
     // Capture the view matrix once for the rendering of this model
     if (_transforms.empty()) {
         _transforms.push_back(Transform());
     }
     _transforms[0] = _viewState->getViewTransform();
     _transforms[0].preTranslate(-_translation);
+}
+
+void Model::setupBatchTransform(gpu::Batch& batch) {
+    captureViewTransform();
     batch.setViewTransform(_transforms[0]);
 }
 
-void Model::endScene(RenderMode mode, RenderArgs* args) {
-    PROFILE_RANGE(__FUNCTION__);
+// records one of the scene passes into its own batch, so the passes can be recorded at the same time
+class ScenePassJob : public QRunnable {
+public:
+    ScenePassJob(int stage, Model::RenderMode mode, RenderArgs* args, int* meshPartsRendered) :
+        _stage(stage),
+        _mode(mode),
+        _args(args),
+        _meshPartsRendered(meshPartsRendered) {
+    }
 
-    RenderArgs::RenderSide renderSide = RenderArgs::MONO;
-    if (args) {
-        renderSide = args->_renderSide;
+    virtual void run() {
+        *_meshPartsRendered = Model::recordScenePass(_stage, _mode, _args);
     }
 
-    // Do the rendering batch creation for mono or left eye, not for right eye
-    if (renderSide != RenderArgs::STEREO_RIGHT) {
-        // Let's introduce a gpu::Batch to capture all the calls to the graphics api
-        _sceneRenderBatch.clear();
-        gpu::Batch& batch = _sceneRenderBatch;
+private:
+    int _stage;
+    Model::RenderMode _mode;
+    RenderArgs* _args;
+    int* _meshPartsRendered;
+};
+
+int Model::recordScenePass(int stage, RenderMode mode, RenderArgs* args) {
+    PROFILE_RANGE(__FUNCTION__);
 
+    gpu::Batch& batch = _sceneRenderBatches[stage];
+    batch.clear();
+
+    // the passes are drawn in order, each one picks up the gl state the one before left
+    int meshPartsRendered = 0;
+    if (stage == OPAQUE_QUEUE_STAGE) {
         GLBATCH(glDisable)(GL_COLOR_MATERIAL);
     
         if (mode == DIFFUSE_RENDER_MODE || mode == NORMAL_RENDER_MODE) {
@@ -1712,24 +1853,9 @@ void Model::endScene(RenderMode mode, RenderArgs* args) {
         }
 
         const float DEFAULT_ALPHA_THRESHOLD = 0.5f;
+        meshPartsRendered = renderQueuedMeshes(batch, mode, OPAQUE_QUEUE_STAGE, DEFAULT_ALPHA_THRESHOLD, args);
 
-        int opaqueMeshPartsRendered = 0;
-
-        // now, for each model in the scene, render the mesh portions
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, false, false, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, false, false, true, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, false, true, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, false, true, true, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, true, false, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, true, false, true, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, true, true, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, false, true, true, true, args);
-
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, true, false, false, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, true, false, true, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, true, true, false, false, args);
-        opaqueMeshPartsRendered += renderMeshesForModelsInScene(batch, mode, false, DEFAULT_ALPHA_THRESHOLD, true, true, true, false, args);
-
+    } else if (stage == MOSTLY_OPAQUE_QUEUE_STAGE) {
         // render translucent meshes afterwards
         //DependencyManager::get<TextureCache>()->setPrimaryDrawBuffers(false, true, true);
         {
@@ -1740,17 +1866,10 @@ void Model::endScene(RenderMode mode, RenderArgs* args) {
             GLBATCH(glDrawBuffers)(bufferCount, buffers);
         }
 
-        int translucentParts = 0;
         const float MOSTLY_OPAQUE_THRESHOLD = 0.75f;
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, false, false, false, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, false, false, true, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, false, true, false, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, false, true, true, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, true, false, false, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, true, false, true, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, true, true, false, args);
-        translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_OPAQUE_THRESHOLD, false, true, true, true, args);
+        meshPartsRendered = renderQueuedMeshes(batch, mode, MOSTLY_OPAQUE_QUEUE_STAGE, MOSTLY_OPAQUE_THRESHOLD, args);
 
+    } else {
         GLBATCH(glDisable)(GL_ALPHA_TEST);
         GLBATCH(glEnable)(GL_BLEND);
         GLBATCH(glDepthMask)(false);
@@ -1766,14 +1885,8 @@ void Model::endScene(RenderMode mode, RenderArgs* args) {
     
         if (mode == DEFAULT_RENDER_MODE || mode == DIFFUSE_RENDER_MODE) {
             const float MOSTLY_TRANSPARENT_THRESHOLD = 0.0f;
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, false, false, false, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, false, false, true, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, false, true, false, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, false, true, true, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, true, false, false, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, true, false, true, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, true, true, false, args);
-            translucentParts += renderMeshesForModelsInScene(batch, mode, true, MOSTLY_TRANSPARENT_THRESHOLD, false, true, true, true, args);
+            meshPartsRendered = renderQueuedMeshes(batch, mode, TRANSPARENT_QUEUE_STAGE, MOSTLY_TRANSPARENT_THRESHOLD,
+                                                   args);
         }
 
         GLBATCH(glDepthMask)(true);
@@ -1808,11 +1921,59 @@ void Model::endScene(RenderMode mode, RenderArgs* args) {
         GLBATCH(glBindBuffer)(GL_ARRAY_BUFFER, 0);
         GLBATCH(glBindBuffer)(GL_ELEMENT_ARRAY_BUFFER, 0);
         GLBATCH(glBindTexture)(GL_TEXTURE_2D, 0);
+    }
+    return meshPartsRendered;
+}
+
+void Model::endScene(RenderMode mode, RenderArgs* args) {
+    PROFILE_RANGE(__FUNCTION__);
+
+    RenderArgs::RenderSide renderSide = RenderArgs::MONO;
     if (args) {
-        args->_translucentMeshPartsRendered = translucentParts;
-        args->_opaqueMeshPartsRendered = opaqueMeshPartsRendered;
+        renderSide = args->_renderSide;
     }
 
+    // Do the rendering batch creation for mono or left eye, not for right eye
+    if (renderSide != RenderArgs::STEREO_RIGHT) {
+        // every mesh to draw this frame, sorted by pass, program, material and depth
+        buildRenderQueue(mode, args);
+        _sceneRecordedViewTransform = _viewState->getViewTransform();
+
+        // whatever recording would create lazily is made here, before the passes share it
+        DependencyManager::get<TextureCache>()->getWhiteTexture();
+        DependencyManager::get<TextureCache>()->getBlueTexture();
+
+        // each pass counts what it draws in its own copy of the args
+        RenderArgs passArgs[SCENE_PASSES];
+        int meshPartsRendered[SCENE_PASSES];
+        for (int i = 0; i < SCENE_PASSES; i++) {
+            if (args) {
+                passArgs[i] = *args;
+                passArgs[i]._materialSwitches = 0;
+                passArgs[i]._trianglesRendered = 0;
+                passArgs[i]._quadsRendered = 0;
+            }
+        }
+
+        // the first pass is recorded here while the pool records the others
+        for (int i = 1; i < SCENE_PASSES; i++) {
+            ScenePassJob* job = new ScenePassJob(i, mode, args ? &passArgs[i] : NULL, &meshPartsRendered[i]);
+            job->setAutoDelete(true);
+            _scenePassPool.start(job);
+        }
+        meshPartsRendered[0] = recordScenePass(0, mode, args ? &passArgs[0] : NULL);
+        _scenePassPool.waitForDone();
+
+        if (args) {
+            for (int i = 0; i < SCENE_PASSES; i++) {
+                args->_materialSwitches += passArgs[i]._materialSwitches;
+                args->_trianglesRendered += passArgs[i]._trianglesRendered;
+                args->_quadsRendered += passArgs[i]._quadsRendered;
+            }
+            args->_opaqueMeshPartsRendered = meshPartsRendered[OPAQUE_QUEUE_STAGE];
+            args->_translucentMeshPartsRendered = meshPartsRendered[MOSTLY_OPAQUE_QUEUE_STAGE] +
+                meshPartsRendered[TRANSPARENT_QUEUE_STAGE];
+        }
     }
 
     // Render!
@@ -1823,7 +1984,18 @@ void Model::endScene(RenderMode mode, RenderArgs* args) {
             glPushMatrix();
         #endif
 
-        ::gpu::GLBackend::renderBatch(_sceneRenderBatch);
+        if (renderSide == RenderArgs::STEREO_RIGHT) {
+            // the right eye draws what was recorded for the left, moved over to its own view
+            Transform viewCorrection;
+            Transform::inverseMult(viewCorrection, _sceneRecordedViewTransform, _viewState->getViewTransform());
+            for (int i = 0; i < SCENE_PASSES; i++) {
+                ::gpu::GLBackend::renderBatch(_sceneRenderBatches[i], viewCorrection);
+            }
+        } else {
+            for (int i = 0; i < SCENE_PASSES; i++) {
+                ::gpu::GLBackend::renderBatch(_sceneRenderBatches[i]);
+            }
+        }
 
         #if defined(ANDROID)
         #else
@@ -1911,7 +2083,7 @@ void Model::segregateMeshGroups() {
         const MeshState& state = _meshStates.at(i);
 
         bool translucentMesh = networkMesh.getTranslucentPartCount(mesh) == networkMesh.parts.size();
-        bool hasTangents = !mesh.tangents.isEmpty();
+        bool hasTangents = networkMesh.hasTangents;
         bool hasSpecular = mesh.hasSpecularTexture();
         bool hasLightmap = mesh.hasEmissiveTexture();
         bool isSkinned = state.clusterMatrices.size() > 1;
@@ -2267,32 +2439,128 @@ void Model::pickPrograms(gpu::Batch& batch, RenderMode mode, bool translucent, f
     }
 }
 
-int Model::renderMeshesForModelsInScene(gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
-                            bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, RenderArgs* args) {
+void Model::buildRenderQueue(RenderMode mode, RenderArgs* args) {
+    PROFILE_RANGE(__FUNCTION__);
+
+    _renderQueue.clear();
+    // only the default and diffuse modes have a transparent pass
+    int lastTranslucentStage = (mode == DEFAULT_RENDER_MODE || mode == DIFFUSE_RENDER_MODE) ?
+        TRANSPARENT_QUEUE_STAGE : MOSTLY_OPAQUE_QUEUE_STAGE;
+    foreach (Model* model, _modelsInScene) {
+        model->updateVisibleJointStates();
+        model->captureViewTransform();
+        for (int program = 0; program < QUEUE_PROGRAMS; program++) {
+            bool hasLightmap = (program & LIGHTMAP_QUEUE_PROGRAM) != 0;
+            bool hasTangents = (program & TANGENTS_QUEUE_PROGRAM) != 0;
+            bool hasSpecular = (program & SPECULAR_QUEUE_PROGRAM) != 0;
+            bool isSkinned = (program & SKINNED_QUEUE_PROGRAM) != 0;
+
+            // there are no skinned lightmap programs, and translucent meshes are never lightmapped
+            if (!(hasLightmap && isSkinned)) {
+                model->queueMeshes(model->pickMeshList(false, 0.0f, hasLightmap, hasTangents, hasSpecular, isSkinned),
+                                   OPAQUE_QUEUE_STAGE, OPAQUE_QUEUE_STAGE, program, args);
+            }
+            if (!hasLightmap) {
+                model->queueMeshes(model->pickMeshList(true, 0.0f, false, hasTangents, hasSpecular, isSkinned),
+                                   MOSTLY_OPAQUE_QUEUE_STAGE, lastTranslucentStage, program, args);
+            }
+        }
+    }
+    qSort(_renderQueue);
+}
+
+static void noteScreenSize(const QSharedPointer<NetworkTexture>& texture, float pixels) {
+    if (texture) {
+        texture->noteScreenSize(pixels);
+    }
+}
+
+void Model::queueMeshes(const QVector<int>* list, int firstStage, int lastStage, int program, RenderArgs* args) {
+    if (!list) {
+        return;
+    }
+    const FBXGeometry& geometry = _geometry->getFBXGeometry();
+    quint64 geometryKey = qHash(_geometry.data());
 
+    // the pixels across a unit at a unit's distance, for telling the textures how big the view draws them
+    float screenScale = 0.0f;
+    if (args && args->_viewFrustum && args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        screenScale = DependencyManager::get<TextureCache>()->getFrameBufferSize().height() * 0.5f /
+            tanf(glm::radians(args->_viewFrustum->getFieldOfView()) * 0.5f);
+    }
+    foreach (int i, *list) {
+        if (!shouldRenderMesh(i, args)) {
+            continue;
+        }
+        dilateEyeTextures(i);
+
+        // material ids are only unique within a geometry
+        const FBXMesh& mesh = geometry.meshes.at(i);
+        quint64 materialKey = mesh.parts.isEmpty() ? geometryKey : geometryKey ^ qHash(mesh.parts.at(0).materialID);
+
+        // a non negative float keeps its order when its bits are read as an integer
+        float distance = (args && args->_viewFrustum) ?
+            args->_viewFrustum->distanceToCamera(_calculatedMeshBoxes.at(i).calcCenter()) : 0.0f;
+        quint32 depthKey;
+        memcpy(&depthKey, &distance, sizeof(depthKey));
+
+        if (screenScale > 0.0f && distance > 0.0f) {
+            // no texture on the mesh can show more detail than the pixels the mesh covers
+            float pixels = _calculatedMeshBoxes.at(i).getLargestDimension() / distance * screenScale;
+            foreach (const NetworkMeshPart& part, _geometry->getMeshes().at(i).parts) {
+                noteScreenSize(part.diffuseTexture, pixels);
+                noteScreenSize(part.normalTexture, pixels);
+                noteScreenSize(part.specularTexture, pixels);
+                noteScreenSize(part.emissiveTexture, pixels);
+            }
+        }
+
+        RenderItem item = { 0, this, i };
+        for (int stage = firstStage; stage <= lastStage; stage++) {
+            // opaque meshes go front to back so the depth test rejects what they hide, translucent ones back to front
+            item.key = ((quint64)stage << QUEUE_STAGE_SHIFT) | ((quint64)program << QUEUE_PROGRAM_SHIFT) |
+                ((materialKey & QUEUE_MATERIAL_MASK) << QUEUE_MATERIAL_SHIFT) |
+                (stage == OPAQUE_QUEUE_STAGE ? depthKey : ~depthKey);
+            _renderQueue.append(item);
+        }
+    }
+}
+
+int Model::renderQueuedMeshes(gpu::Batch& batch, RenderMode mode, int stage, float alphaThreshold, RenderArgs* args) {
     PROFILE_RANGE(__FUNCTION__);
-    int meshPartsRendered = 0;
 
-    bool pickProgramsNeeded = true;
+    bool translucent = (stage != OPAQUE_QUEUE_STAGE);
+    int meshPartsRendered = 0;
+    int currentProgram = -1;
+    Model* currentModel = NULL;
     Locations* locations;
     SkinLocations* skinLocations;
-    
-    foreach(Model* model, _modelsInScene) {
-        QVector<int>* whichList = model->pickMeshList(translucent, alphaThreshold, hasLightmap, hasTangents, hasSpecular, isSkinned);
-        if (whichList) {
-            QVector<int>& list = *whichList;
-            if (list.size() > 0) {
-                if (pickProgramsNeeded) {
-                    pickPrograms(batch, mode, translucent, alphaThreshold, hasLightmap, hasTangents, hasSpecular, isSkinned, args, locations, skinLocations);
-                    pickProgramsNeeded = false;
-                }
-                model->setupBatchTransform(batch);
-                meshPartsRendered += model->renderMeshesFromList(list, batch, mode, translucent, alphaThreshold, args, locations, skinLocations);
-            }
+    MeshBindings bindings;
+
+    // the queue is sorted by stage first, so the meshes of this one follow each other
+    RenderItem first = { (quint64)stage << QUEUE_STAGE_SHIFT, NULL, 0 };
+    for (QVector<RenderItem>::const_iterator item = qLowerBound(_renderQueue.constBegin(), _renderQueue.constEnd(),
+            first); item != _renderQueue.constEnd() && (int)(item->key >> QUEUE_STAGE_SHIFT) == stage; item++) {
+        int program = (item->key >> QUEUE_PROGRAM_SHIFT) & (QUEUE_PROGRAMS - 1);
+        if (program != currentProgram) {
+            pickPrograms(batch, mode, translucent, alphaThreshold, (program & LIGHTMAP_QUEUE_PROGRAM) != 0,
+                (program & TANGENTS_QUEUE_PROGRAM) != 0, (program & SPECULAR_QUEUE_PROGRAM) != 0,
+                (program & SKINNED_QUEUE_PROGRAM) != 0, args, locations, skinLocations);
+            currentProgram = program;
+            currentModel = NULL;
+            bindings = MeshBindings();
+        }
+        if (item->model != currentModel) {
+            // the material uniforms were set for the last program and geometry
+            currentModel = item->model;
+            batch.setViewTransform(currentModel->_transforms[0]);
+            bindings.materialID.clear();
         }
+        meshPartsRendered += currentModel->renderMesh(item->meshIndex, batch, mode, translucent, alphaThreshold, args,
+                                                      locations, skinLocations, bindings);
     }
     // if we selected a program, then unselect it
-    if (!pickProgramsNeeded) {
+    if (currentProgram != -1) {
         GLBATCH(glUseProgram)(0);
     }
     return meshPartsRendered;
@@ -2331,196 +2599,240 @@ int Model::renderMeshesFromList(QVector<int>& list, gpu::Batch& batch, RenderMod
                                         Locations* locations, SkinLocations* skinLocations) {
     PROFILE_RANGE(__FUNCTION__);
 
-    auto textureCache = DependencyManager::get<TextureCache>();
-    auto glowEffect = DependencyManager::get<GlowEffect>();
-    QString lastMaterialID;
+    MeshBindings bindings;
     int meshPartsRendered = 0;
     updateVisibleJointStates();
-    const FBXGeometry& geometry = _geometry->getFBXGeometry();
-    const QVector<NetworkMesh>& networkMeshes = _geometry->getMeshes();
 
     // i is the "index" from the original networkMeshes QVector...
     foreach (int i, list) {
-    
-        // if our index is ever out of range for either meshes or networkMeshes, then skip it, and set our _meshGroupsKnown
-        // to false to rebuild out mesh groups.
-        
-        if (i < 0 || i >= networkMeshes.size() || i > geometry.meshes.size()) {
-            _meshGroupsKnown = false; // regenerate these lists next time around.
-            continue;
+        if (shouldRenderMesh(i, args)) {
+            dilateEyeTextures(i);
+            meshPartsRendered += renderMesh(i, batch, mode, translucent, alphaThreshold, args, locations, skinLocations,
+                                            bindings);
         }
-        
-        // exit early if the translucency doesn't match what we're drawing
-        const NetworkMesh& networkMesh = networkMeshes.at(i);
-        const FBXMesh& mesh = geometry.meshes.at(i);    
+    }
 
-        batch.setIndexBuffer(gpu::UINT32, (networkMesh._indexBuffer), 0);
-        int vertexCount = mesh.vertices.size();
-        if (vertexCount == 0) {
-            // sanity check
-            continue;
-        }
-        
-        // if we got here, then check to see if this mesh is in view
-        if (args) {
-            bool shouldRender = true;
-            args->_meshesConsidered++;
-
-            if (args->_viewFrustum) {
-                shouldRender = args->_viewFrustum->boxInFrustum(_calculatedMeshBoxes.at(i)) != ViewFrustum::OUTSIDE;
-                if (shouldRender) {
-                    float distance = args->_viewFrustum->distanceToCamera(_calculatedMeshBoxes.at(i).calcCenter());
-                    shouldRender = !_viewState ? false : _viewState->shouldRenderMesh(_calculatedMeshBoxes.at(i).getLargestDimension(),
-                                                                            distance);
-                    if (!shouldRender) {
-                        args->_meshesTooSmall++;
-                    }
-                } else {
-                    args->_meshesOutOfView++;
-                }
-            }
+    return meshPartsRendered;
+}
+
+bool Model::shouldRenderMesh(int i, RenderArgs* args) {
+    const FBXGeometry& geometry = _geometry->getFBXGeometry();
+    const QVector<NetworkMesh>& networkMeshes = _geometry->getMeshes();
+
+    // if our index is ever out of range for either meshes or networkMeshes, then skip it, and set our _meshGroupsKnown
+    // to false to rebuild out mesh groups.
+    if (i < 0 || i >= networkMeshes.size() || i > geometry.meshes.size()) {
+        _meshGroupsKnown = false; // regenerate these lists next time around.
+        return false;
+    }
+
+    if (geometry.meshes.at(i).vertices.isEmpty()) {
+        // sanity check
+        return false;
+    }
+
+    // if we got here, then check to see if this mesh is in view
+    if (args) {
+        bool shouldRender = true;
+        args->_meshesConsidered++;
 
+        if (args->_viewFrustum) {
+            shouldRender = args->_viewFrustum->boxInFrustum(_calculatedMeshBoxes.at(i)) != ViewFrustum::OUTSIDE;
             if (shouldRender) {
-                args->_meshesRendered++;
+                float distance = args->_viewFrustum->distanceToCamera(_calculatedMeshBoxes.at(i).calcCenter());
+                shouldRender = !_viewState ? false : _viewState->shouldRenderMesh(_calculatedMeshBoxes.at(i).getLargestDimension(),
+                                                                        distance);
+                if (!shouldRender) {
+                    args->_meshesTooSmall++;
+                }
             } else {
-                continue; // skip this mesh
+                args->_meshesOutOfView++;
             }
         }
 
-        const MeshState& state = _meshStates.at(i);
-        if (state.clusterMatrices.size() > 1) {
+        if (shouldRender) {
+            args->_meshesRendered++;
+        } else {
+            return false; // skip this mesh
+        }
+    }
+
+    return true;
+}
+
+void Model::dilateEyeTextures(int i) {
+    if (!_geometry->getFBXGeometry().meshes.at(i).isEye) {
+        return;
+    }
+    const NetworkMesh& networkMesh = _geometry->getMeshes().at(i);
+    for (int j = 0; j < networkMesh.parts.size(); j++) {
+        Texture* diffuseMap = networkMesh.parts.at(j).diffuseTexture.data();
+        if (diffuseMap) {
+            _dilatedTextures[i][j] =
+                static_cast<DilatableNetworkTexture*>(diffuseMap)->getDilatedTexture(_pupilDilation);
+        }
+    }
+}
+
+int Model::renderMesh(int i, gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
+                      RenderArgs* args, Locations* locations, SkinLocations* skinLocations, MeshBindings& bindings) {
+    auto textureCache = DependencyManager::get<TextureCache>();
+    auto glowEffect = DependencyManager::get<GlowEffect>();
+    int meshPartsRendered = 0;
+    const FBXGeometry& geometry = _geometry->getFBXGeometry();
+    const NetworkMesh& networkMesh = _geometry->getMeshes().at(i);
+    const FBXMesh& mesh = geometry.meshes.at(i);
+
+    const MeshState& state = _meshStates.at(i);
+    if (state.clusterMatrices.size() > 1) {
+        if (skinLocations->clusterBufferUnit >= 0) {
+            // a uniform block has to be backed by its whole size
+            batch.setUniformBuffer(skinLocations->clusterBufferUnit, _clusterBuffer, state.clusterBufferOffset,
+                MAX_SKIN_CLUSTERS * sizeof(glm::mat4));
+        } else {
             GLBATCH(glUniformMatrix4fv)(skinLocations->clusterMatrices, state.clusterMatrices.size(), false,
                 (const float*)state.clusterMatrices.constData());
-            batch.setModelTransform(Transform());
-        } else {
-            batch.setModelTransform(Transform(state.clusterMatrices[0]));
         }
+        batch.setModelTransform(Transform());
+    } else {
+        batch.setModelTransform(Transform(state.clusterMatrices[0]));
+    }
 
-        if (mesh.blendshapes.isEmpty()) {
+    if (mesh.blendshapes.isEmpty()) {
+        // another instance of our geometry may have just drawn this mesh
+        if (bindings.mesh != &networkMesh) {
+            batch.setIndexBuffer(gpu::UINT32, (networkMesh._indexBuffer), 0);
             batch.setInputFormat(networkMesh._vertexFormat);
             batch.setInputStream(0, *networkMesh._vertexStream);
-        } else {
-            batch.setInputFormat(networkMesh._vertexFormat);
-            batch.setInputBuffer(0, _blendedVertexBuffers[i], 0, sizeof(glm::vec3));
-            batch.setInputBuffer(1, _blendedVertexBuffers[i], vertexCount * sizeof(glm::vec3), sizeof(glm::vec3));
-            batch.setInputStream(2, *networkMesh._vertexStream);
+            bindings.mesh = &networkMesh;
         }
+    } else {
+        // the blended vertices are our own
+        bindings.mesh = NULL;
+        batch.setIndexBuffer(gpu::UINT32, (networkMesh._indexBuffer), 0);
+        batch.setInputFormat(networkMesh._vertexFormat);
+        batch.setInputBuffer(0, _blendedVertexBuffers[i], 0, sizeof(glm::vec3));
+        batch.setInputBuffer(1, _blendedNormalBuffers[i], 0, sizeof(glm::vec3));
+        batch.setInputStream(2, *networkMesh._vertexStream);
+    }
 
-        if (mesh.colors.isEmpty()) {
-            GLBATCH(glColor4f)(1.0f, 1.0f, 1.0f, 1.0f);
-        }
+    if (!networkMesh.hasColors) {
+        GLBATCH(glColor4f)(1.0f, 1.0f, 1.0f, 1.0f);
+    }
 
-        qint64 offset = 0;
-        for (int j = 0; j < networkMesh.parts.size(); j++) {
-            const NetworkMeshPart& networkPart = networkMesh.parts.at(j);
-            const FBXMeshPart& part = mesh.parts.at(j);
-            model::MaterialPointer material = part._material;
-            if ((networkPart.isTranslucent() || part.opacity != 1.0f) != translucent) {
-                offset += (part.quadIndices.size() + part.triangleIndices.size()) * sizeof(int);
-                continue;
-            }
+    qint64 offset = 0;
+    for (int j = 0; j < networkMesh.parts.size(); j++) {
+        const NetworkMeshPart& networkPart = networkMesh.parts.at(j);
+        const FBXMeshPart& part = mesh.parts.at(j);
+        model::MaterialPointer material = part._material;
+        if ((networkPart.isTranslucent() || part.opacity != 1.0f) != translucent) {
+            offset += (part.quadIndices.size() + part.triangleIndices.size()) * sizeof(int);
+            continue;
+        }
 
-            // apply material properties
-            if (mode == SHADOW_RENDER_MODE) {
-             ///   GLBATCH(glBindTexture)(GL_TEXTURE_2D, 0);
-                
-            } else {
-                if (lastMaterialID != part.materialID) {
-                    const bool wantDebug = false;
-                    if (wantDebug) {
-                        qDebug() << "Material Changed ---------------------------------------------";
-                        qDebug() << "part INDEX:" << j;
-                        qDebug() << "NEW part.materialID:" << part.materialID;
-                    }
+        // apply material properties
+        if (mode == SHADOW_RENDER_MODE) {
+         ///   GLBATCH(glBindTexture)(GL_TEXTURE_2D, 0);
+            
+        } else {
+            // an eye's diffuse texture is dilated for this model alone
+            bool partBound = bindings.part == &networkPart && !mesh.isEye;
+            if (bindings.materialID != part.materialID && !partBound) {
+                const bool wantDebug = false;
+                if (wantDebug) {
+                    qDebug() << "Material Changed ---------------------------------------------";
+                    qDebug() << "part INDEX:" << j;
+                    qDebug() << "NEW part.materialID:" << part.materialID;
+                }
 
-                    if (locations->glowIntensity >= 0) {
-                        GLBATCH(glUniform1f)(locations->glowIntensity, glowEffect->getIntensity());
-                    }
-                    if (!(translucent && alphaThreshold == 0.0f)) {
-                        GLBATCH(glAlphaFunc)(GL_EQUAL, glowEffect->getIntensity());
-                    }
+                if (locations->glowIntensity >= 0) {
+                    GLBATCH(glUniform1f)(locations->glowIntensity, glowEffect->getIntensity());
+                }
+                if (!(translucent && alphaThreshold == 0.0f)) {
+                    GLBATCH(glAlphaFunc)(GL_EQUAL, glowEffect->getIntensity());
+                }
 
-                    if (locations->materialBufferUnit >= 0) {
-                        batch.setUniformBuffer(locations->materialBufferUnit, material->getSchemaBuffer());
-                    }
-
-                    Texture* diffuseMap = networkPart.diffuseTexture.data();
-                    if (mesh.isEye && diffuseMap) {
-                        diffuseMap = (_dilatedTextures[i][j] =
-                            static_cast<DilatableNetworkTexture*>(diffuseMap)->getDilatedTexture(_pupilDilation)).data();
-                    }
-                    static bool showDiffuse = true;
-                    if (showDiffuse && diffuseMap) {
-                        batch.setUniformTexture(0, diffuseMap->getGPUTexture());
-                        
-                    } else {
-                        batch.setUniformTexture(0, textureCache->getWhiteTexture());
-                    }
-
-                    if (locations->texcoordMatrices >= 0) {
-                        glm::mat4 texcoordTransform[2];
-                        if (!part.diffuseTexture.transform.isIdentity()) {
-                            part.diffuseTexture.transform.getMatrix(texcoordTransform[0]);
-                        }
-                        if (!part.emissiveTexture.transform.isIdentity()) {
-                            part.emissiveTexture.transform.getMatrix(texcoordTransform[1]);
-                        }
-                        GLBATCH(glUniformMatrix4fv)(locations->texcoordMatrices, 2, false, (const float*) &texcoordTransform);
-                    }
+                if (locations->materialBufferUnit >= 0) {
+                    batch.setUniformBuffer(locations->materialBufferUnit, material->getSchemaBuffer());
+                }
 
-                    if (!mesh.tangents.isEmpty()) {                 
-                        Texture* normalMap = networkPart.normalTexture.data();
-                        batch.setUniformTexture(1, !normalMap ?
-                            textureCache->getBlueTexture() : normalMap->getGPUTexture());
+                Texture* diffuseMap = networkPart.diffuseTexture.data();
+                if (mesh.isEye && diffuseMap) {
+                    // dilated before the mesh was queued
+                    diffuseMap = _dilatedTextures[i][j].data();
+                }
+                static bool showDiffuse = true;
+                if (showDiffuse && diffuseMap) {
+                    batch.setUniformTexture(0, diffuseMap->getGPUTexture());
+                    
+                } else {
+                    batch.setUniformTexture(0, textureCache->getWhiteTexture());
+                }
 
+                if (locations->texcoordMatrices >= 0) {
+                    glm::mat4 texcoordTransform[2];
+                    if (!part.diffuseTexture.transform.isIdentity()) {
+                        part.diffuseTexture.transform.getMatrix(texcoordTransform[0]);
                     }
-                
-                    if (locations->specularTextureUnit >= 0) {
-                        Texture* specularMap = networkPart.specularTexture.data();
-                        batch.setUniformTexture(locations->specularTextureUnit, !specularMap ?
-                                                    textureCache->getWhiteTexture() : specularMap->getGPUTexture());
+                    if (!part.emissiveTexture.transform.isIdentity()) {
+                        part.emissiveTexture.transform.getMatrix(texcoordTransform[1]);
                     }
+                    GLBATCH(glUniformMatrix4fv)(locations->texcoordMatrices, 2, false, (const float*) &texcoordTransform);
+                }
 
-                    if (args) {
-                        args->_materialSwitches++;
-                    }
+                if (networkMesh.hasTangents) {                 
+                    Texture* normalMap = networkPart.normalTexture.data();
+                    batch.setUniformTexture(1, !normalMap ?
+                        textureCache->getBlueTexture() : normalMap->getGPUTexture());
 
                 }
+            
+                if (locations->specularTextureUnit >= 0) {
+                    Texture* specularMap = networkPart.specularTexture.data();
+                    batch.setUniformTexture(locations->specularTextureUnit, !specularMap ?
+                                                textureCache->getWhiteTexture() : specularMap->getGPUTexture());
+                }
 
-                // HACK: For unkwon reason (yet!) this code that should be assigned only if the material changes need to be called for every
-                // drawcall with an emissive, so let's do it for now.
-                if (locations->emissiveTextureUnit >= 0) {
-                    //  assert(locations->emissiveParams >= 0); // we should have the emissiveParams defined in the shader
-                    float emissiveOffset = part.emissiveParams.x;
-                    float emissiveScale = part.emissiveParams.y;
-                    GLBATCH(glUniform2f)(locations->emissiveParams, emissiveOffset, emissiveScale);
-
-                    Texture* emissiveMap = networkPart.emissiveTexture.data();
-                        batch.setUniformTexture(locations->emissiveTextureUnit, !emissiveMap ?
-                                                    textureCache->getWhiteTexture() : emissiveMap->getGPUTexture());
+                if (args) {
+                    args->_materialSwitches++;
                 }
 
-                lastMaterialID = part.materialID;
-            }
-            
-            meshPartsRendered++;
-            
-            if (part.quadIndices.size() > 0) {
-                batch.drawIndexed(gpu::QUADS, part.quadIndices.size(), offset);
-                offset += part.quadIndices.size() * sizeof(int);
             }
 
-            if (part.triangleIndices.size() > 0) {
-                batch.drawIndexed(gpu::TRIANGLES, part.triangleIndices.size(), offset);
-                offset += part.triangleIndices.size() * sizeof(int);
+            // HACK: For unkwon reason (yet!) this code that should be assigned only if the material changes need to be called for every
+            // drawcall with an emissive, so let's do it for now.
+            if (locations->emissiveTextureUnit >= 0) {
+                //  assert(locations->emissiveParams >= 0); // we should have the emissiveParams defined in the shader
+                float emissiveOffset = part.emissiveParams.x;
+                float emissiveScale = part.emissiveParams.y;
+                GLBATCH(glUniform2f)(locations->emissiveParams, emissiveOffset, emissiveScale);
+
+                Texture* emissiveMap = networkPart.emissiveTexture.data();
+                    batch.setUniformTexture(locations->emissiveTextureUnit, !emissiveMap ?
+                                                textureCache->getWhiteTexture() : emissiveMap->getGPUTexture());
             }
 
-            if (args) {
-                const int INDICES_PER_TRIANGLE = 3;
-                const int INDICES_PER_QUAD = 4;
-                args->_trianglesRendered += part.triangleIndices.size() / INDICES_PER_TRIANGLE;
-                args->_quadsRendered += part.quadIndices.size() / INDICES_PER_QUAD;
-            }
+            bindings.materialID = part.materialID;
+            bindings.part = &networkPart;
+        }
+        
+        meshPartsRendered++;
+        
+        if (part.quadIndices.size() > 0) {
+            batch.drawIndexed(gpu::QUADS, part.quadIndices.size(), offset);
+            offset += part.quadIndices.size() * sizeof(int);
+        }
+
+        if (part.triangleIndices.size() > 0) {
+            batch.drawIndexed(gpu::TRIANGLES, part.triangleIndices.size(), offset);
+            offset += part.triangleIndices.size() * sizeof(int);
+        }
+
+        if (args) {
+            const int INDICES_PER_TRIANGLE = 3;
+            const int INDICES_PER_QUAD = 4;
+            args->_trianglesRendered += part.triangleIndices.size() / INDICES_PER_TRIANGLE;
+            args->_quadsRendered += part.quadIndices.size() / INDICES_PER_QUAD;
         }
     }
 
@@ -2535,6 +2847,7 @@ ModelBlender::~ModelBlender() {
 }
 
 void ModelBlender::noteRequiresBlend(Model* model) {
+    QMutexLocker locker(&_mutex);
     if (_pendingBlenders < QThread::idealThreadCount()) {
         if (model->maybeStartBlender()) {
             _pendingBlenders++;
@@ -2551,6 +2864,7 @@ void ModelBlender::setBlendedVertices(const QPointer<Model>& model, int blendNum
     if (!model.isNull()) {
         model->setBlendedVertices(blendNumber, geometry, vertices, normals);
     }
+    QMutexLocker locker(&_mutex);
     _pendingBlenders--;
     while (!_modelsRequiringBlends.isEmpty()) {
         Model* nextModel = _modelsRequiringBlends.takeFirst();
@@ -15,7 +15,9 @@
 #include <gpu/GPUConfig.h>
 
 #include <QBitArray>
+#include <QMutex>
 #include <QObject>
+#include <QThreadPool>
 #include <QUrl>
 
 #include <AABox.h>
@@ -26,6 +28,7 @@
 #include <gpu/Batch.h>
 #include <PhysicsEntity.h>
 #include <Transform.h>
+#include <TriangleBVH.h>
 
 #include "AnimationHandle.h"
 #include "GeometryCache.h"
@@ -34,6 +37,7 @@
 #include "TextureCache.h"
 
 class AbstractViewStateInterface;
+class MeshTriangleBVHs;
 class QScriptEngine;
 
 class Shape;
@@ -90,6 +94,10 @@ public:
     void init();
     void reset();
     virtual void simulate(float deltaTime, bool fullUpdate = true);
+
+    /// Brings the geometry up to date ahead of a simulate() that may run off the main thread, since switching
+    /// geometry touches resources and GL objects.  The next simulate() uses the result instead of updating again.
+    void prepareGeometry();
     
     enum RenderMode { DEFAULT_RENDER_MODE, SHADOW_RENDER_MODE, DIFFUSE_RENDER_MODE, NORMAL_RENDER_MODE };
     
@@ -227,13 +235,22 @@ protected:
     class MeshState {
     public:
         QVector<glm::mat4> clusterMatrices;
+        int clusterBufferOffset; // where a skinned mesh's matrices start in _clusterBuffer
     };
     
     QVector<MeshState> _meshStates;
+    QVector<glm::mat4> _jointWorldTransforms; // scratch for simulateInternal()
     
     // returns 'true' if needs fullUpdate after geometry change
     bool updateGeometry();
 
+    /// Returns the priority to load the geometry and its textures at: the model's apparent size, so that what looms
+    /// largest on screen arrives first.
+    float getScreenSpaceLoadPriority() const;
+
+    bool _geometryPrepared = false;
+    bool _preparedGeometryNeedsFullUpdate = false;
+
     virtual void setJointStates(QVector<JointState> states);
     
     void setScaleInternal(const glm::vec3& scale);
@@ -290,7 +307,10 @@ private:
     
     QUrl _url;
 
+    gpu::BufferPointer _clusterBuffer; // the cluster matrices of all skinned meshes, where the skin programs read a buffer
     gpu::Buffers _blendedVertexBuffers;
+    gpu::Buffers _blendedNormalBuffers;
+    QVector<QPair<int, int> > _blendedRanges; // the first vertex and vertex count each mesh's blendshapes move
     std::vector<Transform> _transforms;
     gpu::Batch _renderBatch;
 
@@ -358,6 +378,7 @@ private:
     class SkinLocations : public Locations {
     public:
         int clusterMatrices;
+        int clusterBufferUnit;
         int clusterIndices;
         int clusterWeights;
     };
@@ -374,10 +395,14 @@ private:
     QVector<AABox> _calculatedMeshBoxes; // world coordinate AABoxes for all sub mesh boxes
     bool _calculatedMeshBoxesValid;
     
-    QVector< QVector<Triangle> > _calculatedMeshTriangles; // world coordinate triangles for all sub meshes
-    bool _calculatedMeshTrianglesValid;
+    // triangle hierarchies for each sub mesh, in the frame of the geometry rather than the world, so that they hold as
+    // long as the geometry does
+    QSharedPointer<MeshTriangleBVHs> _meshTriangleBVHs;
+    
+    /// Returns the meshes' triangle hierarchies if they've been built, starting to build them if they haven't.
+    const QVector<TriangleBVH>* getMeshTriangleBVHs();
 
-    void recalculateMeshBoxes(bool pickAgainstTriangles = false);
+    void recalculateMeshBoxes();
 
     void segregateMeshGroups(); // used to calculate our list of translucent vs opaque meshes
 
@@ -436,7 +461,37 @@ private:
 
     // Scene rendering support
     static QVector<Model*> _modelsInScene;
-    static gpu::Batch _sceneRenderBatch;
+
+    /// a mesh of a model in the scene, queued to be drawn in the order of its key
+    class RenderItem {
+    public:
+        quint64 key;
+        Model* model;
+        int meshIndex;
+
+        bool operator<(const RenderItem& other) const { return key < other.key; }
+    };
+    static QVector<RenderItem> _renderQueue;
+
+    enum { OPAQUE_QUEUE_STAGE, MOSTLY_OPAQUE_QUEUE_STAGE, TRANSPARENT_QUEUE_STAGE, SCENE_PASSES };
+
+    // each pass of the scene is recorded into its own batch on the pool, then they are all drawn in order
+    static gpu::Batch _sceneRenderBatches[SCENE_PASSES];
+    static Transform _sceneRecordedViewTransform; ///< the view the batches were recorded from
+    static QThreadPool _scenePassPool;
+    static int recordScenePass(int stage, RenderMode mode, RenderArgs* args);
+    friend class ScenePassJob;
+
+    /// what the meshes drawn so far left bound in a batch, so instances of one geometry drawn back to back skip
+    /// binding it again
+    class MeshBindings {
+    public:
+        MeshBindings() : mesh(NULL), part(NULL) { }
+
+        const NetworkMesh* mesh;
+        const NetworkMeshPart* part;
+        QString materialID;
+    };
 
     static void endSceneSimple(RenderMode mode = DEFAULT_RENDER_MODE, RenderArgs* args = NULL);
     static void endSceneSplitPass(RenderMode mode = DEFAULT_RENDER_MODE, RenderArgs* args = NULL);
@@ -446,18 +501,29 @@ private:
     bool renderCore(float alpha, RenderMode mode, RenderArgs* args);
     int renderMeshes(gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold, 
                         bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, RenderArgs* args = NULL);
+    void captureViewTransform();
     void setupBatchTransform(gpu::Batch& batch);
     QVector<int>* pickMeshList(bool translucent, float alphaThreshold, bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned);
 
     int renderMeshesFromList(QVector<int>& list, gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
                                         RenderArgs* args, Locations* locations, SkinLocations* skinLocations);
 
+    /// culls a mesh against the view, counting it in the args
+    bool shouldRenderMesh(int i, RenderArgs* args);
+    void dilateEyeTextures(int i);
+    int renderMesh(int i, gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
+                   RenderArgs* args, Locations* locations, SkinLocations* skinLocations, MeshBindings& bindings);
+
+    /// queues the visible meshes of a list once for each pass from firstStage to lastStage
+    void queueMeshes(const QVector<int>* list, int firstStage, int lastStage, int program, RenderArgs* args);
+
     static void pickPrograms(gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
                             bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, RenderArgs* args,
                             Locations*& locations, SkinLocations*& skinLocations);
 
-    static int renderMeshesForModelsInScene(gpu::Batch& batch, RenderMode mode, bool translucent, float alphaThreshold,
-                            bool hasLightmap, bool hasTangents, bool hasSpecular, bool isSkinned, RenderArgs* args);
+    static void buildRenderQueue(RenderMode mode, RenderArgs* args);
+    static int renderQueuedMeshes(gpu::Batch& batch, RenderMode mode, int stage, float alphaThreshold,
+                                  RenderArgs* args);
 
 
     static AbstractViewStateInterface* _viewState;
@@ -488,6 +554,7 @@ private:
 
     QList<QPointer<Model> > _modelsRequiringBlends;
     int _pendingBlenders;
+    QMutex _mutex; // models note their blends from the avatar simulation pool
 };
 
 
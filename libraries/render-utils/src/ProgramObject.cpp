@@ -9,11 +9,153 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <gpu/GPUConfig.h>
+
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QtDebug>
+
 #include <glm/gtc/type_ptr.hpp>
 
 #include "ProgramObject.h"
 
-ProgramObject::ProgramObject(QObject* parent) : QGLShaderProgram(parent) {
+// cached binaries are stored after this header, whose version goes up whenever the format changes
+static const char PROGRAM_CACHE_ID[] = "HFPB";
+static const quint8 PROGRAM_CACHE_VERSION = 1;
+
+ProgramObject::ProgramObject(QObject* parent) :
+    QGLShaderProgram(parent),
+    _isFromProgramCache(false) {
+}
+
+QString ProgramObject::getProgramCacheDirectory() {
+    static QString directory;
+    if (directory.isEmpty()) {
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        directory = QDir((!cachePath.isEmpty() ? cachePath : "programCache") + "/programBinaries").absolutePath();
+        QDir().mkpath(directory);
+    }
+    return directory;
+}
+
+static bool supportsProgramBinaries() {
+#ifdef GL_ARB_get_program_binary
+    static int formatCount = -1;
+    if (formatCount == -1) {
+        formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    return formatCount > 0;
+#else
+    return false;
+#endif
+}
+
+void ProgramObject::addShadersFromSourceCode(const char* vertexSource, const char* fragmentSource,
+        const QString& variant) {
+    _isFromProgramCache = false;
+    _programCacheFilename.clear();
+    
+    if (supportsProgramBinaries()) {
+        // binaries are only valid for the driver that produced them, so its identity is part of the key
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+        hash.addData(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+        hash.addData(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+        hash.addData(variant.toUtf8());
+        hash.addData(vertexSource);
+        hash.addData(fragmentSource);
+        _programCacheFilename = getProgramCacheDirectory() + "/" + hash.result().toHex() + ".bin";
+        
+        if (loadProgramBinary()) {
+            _isFromProgramCache = true;
+            return;
+        }
+    }
+    addShaderFromSourceCode(QGLShader::Vertex, vertexSource);
+    addShaderFromSourceCode(QGLShader::Fragment, fragmentSource);
+}
+
+bool ProgramObject::link() {
+    if (_isFromProgramCache) {
+        // with no shaders attached, QGLShaderProgram checks the link status of the loaded binary
+        return QGLShaderProgram::link();
+    }
+#ifdef GL_ARB_get_program_binary
+    if (!_programCacheFilename.isEmpty()) {
+        glProgramParameteri(programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+    if (!QGLShaderProgram::link()) {
+        return false;
+    }
+    if (!_programCacheFilename.isEmpty()) {
+        saveProgramBinary();
+    }
+    return true;
+}
+
+bool ProgramObject::loadProgramBinary() {
+#ifdef GL_ARB_get_program_binary
+    QFile file(_programCacheFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    char id[sizeof(PROGRAM_CACHE_ID) - 1];
+    quint8 version;
+    quint32 format;
+    QByteArray binary;
+    if (in.readRawData(id, sizeof(id)) != (int)sizeof(id) || memcmp(id, PROGRAM_CACHE_ID, sizeof(id)) != 0) {
+        return false;
+    }
+    in >> version >> format >> binary;
+    if (in.status() != QDataStream::Ok || version != PROGRAM_CACHE_VERSION || binary.isEmpty()) {
+        return false;
+    }
+    file.close();
+    
+    glProgramBinary(programId(), format, binary.constData(), binary.size());
+    GLint linked = 0;
+    glGetProgramiv(programId(), GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // drivers may reject binaries after an update that doesn't change the version string
+        qDebug() << "Discarding stale program binary" << _programCacheFilename;
+        QFile::remove(_programCacheFilename);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProgramObject::saveProgramBinary() {
+#ifdef GL_ARB_get_program_binary
+    GLint length = 0;
+    glGetProgramiv(programId(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    QByteArray binary(length, 0);
+    GLenum format = 0;
+    glGetProgramBinary(programId(), length, &length, &format, binary.data());
+    binary.resize(length);
+    
+    QFile file(_programCacheFilename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Failed to write program binary" << _programCacheFilename;
+        return;
+    }
+    QDataStream out(&file);
+    out.writeRawData(PROGRAM_CACHE_ID, sizeof(PROGRAM_CACHE_ID) - 1);
+    out << PROGRAM_CACHE_VERSION << (quint32)format << binary;
+#endif
 }
 
 void ProgramObject::setUniform(int location, const glm::vec2& value) {
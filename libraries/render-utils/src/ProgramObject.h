@@ -21,6 +21,22 @@ public:
     
     ProgramObject(QObject* parent = 0);
     
+    /// Adds a vertex and fragment shader pair.  If the program cache holds a binary linked from the same sources (and
+    /// variant name) by the current driver, that binary is loaded instead and nothing is compiled; otherwise the
+    /// sources are compiled and the binary is cached when the program is linked.  The variant name distinguishes
+    /// programs that share sources but bind different attribute locations.
+    void addShadersFromSourceCode(const char* vertexSource, const char* fragmentSource,
+        const QString& variant = QString());
+    
+    /// Links the program, or adopts the binary loaded from the program cache.
+    virtual bool link();
+    
+    /// Returns true if the program was loaded from the program cache rather than compiled.
+    bool isFromProgramCache() const { return _isFromProgramCache; }
+    
+    /// Returns the directory in which linked program binaries are cached.
+    static QString getProgramCacheDirectory();
+    
     void setUniform(int location, const glm::vec2& value);
     void setUniform(const char* name, const glm::vec2& value);
     void setUniform(int location, const glm::vec3& value);
@@ -28,6 +44,14 @@ public:
     void setUniform(int location, const glm::vec4& value);
     void setUniform(const char* name, const glm::vec4& value);
     void setUniformArray(const char* name, const glm::vec3* values, int count); 
+
+private:
+    
+    bool loadProgramBinary();
+    void saveProgramBinary();
+    
+    QString _programCacheFilename;
+    bool _isFromProgramCache;
 };
 
 #endif // hifi_ProgramObject_h
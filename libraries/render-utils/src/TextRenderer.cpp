@@ -86,6 +86,11 @@ void Glyph::read(QIODevice & in) {
 
 const float DEFAULT_POINT_SIZE = 12;
 
+// once this many strings are drawn without drawing a laid out one again, it's dropped
+const int MAX_STRING_LAYOUTS = 512;
+
+struct TextureVertex;
+
 class Font {
 public:
     
@@ -96,6 +101,16 @@ public:
     using ProgramPtr = QSharedPointer < QOpenGLShaderProgram >;
     using BufferPtr = QSharedPointer < QOpenGLBuffer >;
 
+    // a string laid out into the quads of its glyphs, which draws in a single call until the text or bounds change
+    struct StringLayout {
+        BufferPtr vertices;
+        VertexArrayPtr vao;
+        GLsizei vertexCount { 0 };
+        glm::vec2 bounds;
+        glm::vec2 advance;
+        quint64 lastDrawn { 0 };
+    };
+
     // maps characters to cached glyph info
     // HACK... the operator[] const for QHash returns a 
     // copy of the value, not a const value reference, so
@@ -125,6 +140,10 @@ public:
     QImage _image;
     ProgramPtr _program;
 
+    // the strings drawn lately, by their text
+    mutable QHash<QString, StringLayout> _layouts;
+    mutable quint64 _drawCount { 0 };
+
     const Glyph & getGlyph(const QChar & c) const;
     void read(QIODevice& path);
     // Initialize the OpenGL structures
@@ -140,6 +159,9 @@ public:
 
 private:
     QStringList tokenizeForWrapping(const QString & str) const;
+
+    const StringLayout& getLayout(const QString& str, const glm::vec2& bounds) const;
+    glm::vec2 layoutString(const QString& str, const glm::vec2& bounds, std::vector<TextureVertex>& vertices) const;
 };
 
 static QHash<QString, Font*> LOADED_FONTS;
@@ -409,34 +431,19 @@ glm::vec2 Font::computeExtent(const QString & str) const {
 
 // FIXME support the maxWidth parameter and allow the text to automatically wrap
 // even without explicit line feeds.
-glm::vec2 Font::drawString(float x, float y, const QString & str,
-        const glm::vec4& color, TextRenderer::EffectType effectType,
-        const glm::vec2& bounds) const {
+glm::vec2 Font::layoutString(const QString& str, const glm::vec2& bounds,
+        std::vector<TextureVertex>& vertices) const {
 
     // Stores how far we've moved from the start of the string, in DTP units
     glm::vec2 advance(0, -_rowHeight - _descent);
 
-    _program->bind();
-    _program->setUniformValue("Color", color.r, color.g, color.b, color.a);
-    _program->setUniformValue("Projection",
-            fromGlm(MatrixStack::projection().top()));
-    if (effectType == TextRenderer::OUTLINE_EFFECT) {
-        _program->setUniformValue("Outline", true);
-    }
-    // Needed?
-    glEnable(GL_TEXTURE_2D);
-    _texture->bind();
-    _vao->bind();
-
-    MatrixStack & mv = MatrixStack::modelview();
-    // scale the modelview into font units
-    mv.translate(glm::vec3(0, _ascent, 0));
+    glm::vec2 imageSize = toGlm(_image.size());
     foreach(const QString & token, tokenizeForWrapping(str)) {
         if (token == "\n") {
             advance.x = 0.0f;
             advance.y -= _rowHeight;
             // If we've wrapped right out of the bounds, then we're 
-            // done with rendering the tokens
+            // done with laying out the tokens
             if (bounds.y > 0 && abs(advance.y) > bounds.y) {
                 break;
             }
@@ -451,7 +458,7 @@ glm::vec2 Font::drawString(float x, float y, const QString & str,
                 advance.x = 0.0f;
                 advance.y -= _rowHeight;
                 // If we've wrapped right out of the bounds, then we're 
-                // done with rendering the tokens
+                // done with laying out the tokens
                 if (bounds.y > 0 && abs(advance.y) > bounds.y) {
                     break;
                 }
@@ -466,25 +473,107 @@ glm::vec2 Font::drawString(float x, float y, const QString & str,
             // coordinates
             glm::vec2 offset(advance);
             offset.y -= m.size.y;
-            // Bind the new position
-            mv.withPush([&] {
-                        mv.translate(offset);
-                        // FIXME find a better (and GL ES 3.1 compatible) way of rendering the text
-                        // that doesn't involve a single GL call per character.
-                        // Most likely an 'indirect' call or an 'instanced' call.
-                        _program->setUniformValue("ModelView", fromGlm(mv.top()));
-                        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(m.indexOffset));
-                    });
+            QuadBuilder qb(m.bounds().translated(offset.x, offset.y), m.textureBounds(imageSize));
+            vertices.push_back(qb.vertices[0]);
+            vertices.push_back(qb.vertices[1]);
+            vertices.push_back(qb.vertices[2]);
+            vertices.push_back(qb.vertices[0]);
+            vertices.push_back(qb.vertices[2]);
+            vertices.push_back(qb.vertices[3]);
             advance.x += m.d;
         }
         advance.x += _spaceWidth;
     }
+    return advance;
+}
+
+const Font::StringLayout& Font::getLayout(const QString& str, const glm::vec2& bounds) const {
+    _drawCount++;
+    QHash<QString, StringLayout>::iterator layout = _layouts.find(str);
+    if (layout != _layouts.end() && layout->bounds == bounds) {
+        layout->lastDrawn = _drawCount;
+        return *layout;
+    }
+
+    // forget the strings that have stopped being drawn before making room for another
+    if (_layouts.size() >= MAX_STRING_LAYOUTS) {
+        for (QHash<QString, StringLayout>::iterator it = _layouts.begin(); it != _layouts.end(); ) {
+            if (_drawCount - it->lastDrawn > (quint64)MAX_STRING_LAYOUTS) {
+                it = _layouts.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+    StringLayout& newLayout = _layouts[str];
+    std::vector<TextureVertex> vertexData;
+    newLayout.advance = layoutString(str, bounds, vertexData);
+    newLayout.bounds = bounds;
+    newLayout.vertexCount = (GLsizei)vertexData.size();
+    newLayout.lastDrawn = _drawCount;
+    if (vertexData.empty()) {
+        newLayout.vertices.clear();
+        newLayout.vao.clear();
+        return newLayout;
+    }
+    if (!newLayout.vao) {
+        newLayout.vao = VertexArrayPtr(new QOpenGLVertexArrayObject());
+        newLayout.vao->create();
+        newLayout.vertices = BufferPtr(new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer));
+        newLayout.vertices->create();
+        newLayout.vao->bind();
+        newLayout.vertices->bind();
+
+        GLsizei stride = (GLsizei) sizeof(TextureVertex);
+        void* offset = (void*) offsetof(TextureVertex, tex);
+        int posLoc = _program->attributeLocation("Position");
+        int texLoc = _program->attributeLocation("TexCoord");
+        glEnableVertexAttribArray(posLoc);
+        glVertexAttribPointer(posLoc, 2, GL_FLOAT, false, stride, nullptr);
+        glEnableVertexAttribArray(texLoc);
+        glVertexAttribPointer(texLoc, 2, GL_FLOAT, false, stride, offset);
+    } else {
+        newLayout.vao->bind();
+        newLayout.vertices->bind();
+    }
+    newLayout.vertices->allocate(&vertexData[0], sizeof(TextureVertex) * vertexData.size());
+    newLayout.vao->release();
+    newLayout.vertices->release();
+    return newLayout;
+}
+
+glm::vec2 Font::drawString(float x, float y, const QString & str,
+        const glm::vec4& color, TextRenderer::EffectType effectType,
+        const glm::vec2& bounds) const {
+
+    const StringLayout& layout = getLayout(str, bounds);
+    if (layout.vertexCount == 0) {
+        return layout.advance;
+    }
+
+    _program->bind();
+    _program->setUniformValue("Color", color.r, color.g, color.b, color.a);
+    _program->setUniformValue("Projection",
+            fromGlm(MatrixStack::projection().top()));
+    _program->setUniformValue("Outline", effectType == TextRenderer::OUTLINE_EFFECT);
+    // Needed?
+    glEnable(GL_TEXTURE_2D);
+    _texture->bind();
+
+    MatrixStack & mv = MatrixStack::modelview();
+    // scale the modelview into font units
+    mv.translate(glm::vec3(0, _ascent, 0));
+    _program->setUniformValue("ModelView", fromGlm(mv.top()));
+
+    // the glyphs are already placed, so the whole string is the one call
+    layout.vao->bind();
+    glDrawArrays(GL_TRIANGLES, 0, layout.vertexCount);
+    layout.vao->release();
 
-    _vao->release();
     _program->release();
     // FIXME, needed?
     // glDisable(GL_TEXTURE_2D);
-    return advance;
+    return layout.advance;
 }
 
 TextRenderer* TextRenderer::getInstance(const char* family, float pointSize,
@@ -493,8 +582,15 @@ TextRenderer* TextRenderer::getInstance(const char* family, float pointSize,
     if (pointSize < 0) {
         pointSize = DEFAULT_POINT_SIZE;
     }
-    return new TextRenderer(family, pointSize, weight, italic, effect,
-            effectThickness, color);
+    // the renderers are asked for each frame, so they're shared, along with the strings they've laid out
+    static QHash<QString, TextRenderer*> instances;
+    QString key = QString("%1:%2:%3:%4:%5:%6:%7").arg(family).arg(pointSize).arg(weight).arg(italic).arg(effect)
+        .arg(effectThickness).arg(color.rgba());
+    TextRenderer*& instance = instances[key];
+    if (!instance) {
+        instance = new TextRenderer(family, pointSize, weight, italic, effect, effectThickness, color);
+    }
+    return instance;
 }
 
 TextRenderer::TextRenderer(const char* family, float pointSize, int weight,
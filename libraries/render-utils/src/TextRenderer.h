@@ -49,11 +49,13 @@ const char SOLID_BLOCK_CHAR = 127;
 class Font;
 
 // TextRenderer is actually a fairly thin wrapper around a Font class
-// defined in the cpp file.  
+// defined in the cpp file.  The fonts keep the strings they draw laid out
+// in vertex buffers, so a string that's drawn again costs a single call.
 class TextRenderer {
 public:
     enum EffectType { NO_EFFECT, SHADOW_EFFECT, OUTLINE_EFFECT };
 
+    /// Returns the renderer shared by everyone that asks for the same font and effect.
     static TextRenderer* getInstance(const char* family, float pointSize = -1, int weight = -1, bool italic = false,
         EffectType effect = NO_EFFECT, int effectThickness = 1, const QColor& color = QColor(255, 255, 255));
 
@@ -12,21 +12,34 @@
 // include this before QGLWidget, which includes an earlier version of OpenGL
 #include <gpu/GPUConfig.h>
 
+#include <string.h>
+
+#include <QCryptographicHash>
+#include <QDir>
 #include <QEvent>
 #include <QGLWidget>
 #include <QNetworkReply>
 #include <QOpenGLFramebufferObject>
 #include <QResizeEvent>
 #include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThreadPool>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/random.hpp>
 
+#include <NetworkAccessManager.h>
+#include <SettingHandle.h>
+
 #include "TextureCache.h"
 
 #include "gpu/GLBackend.h"
 
+const int DEFAULT_TEXTURE_MEMORY_BUDGET_MEGABYTES = 1024;
+
+Setting::Handle<int> textureMemoryBudgetMegabytes("textureMemoryBudgetMB", DEFAULT_TEXTURE_MEMORY_BUDGET_MEGABYTES);
+
 TextureCache::TextureCache() :
     _permutationNormalTexture(0),
     _whiteTexture(0),
@@ -35,14 +48,194 @@ TextureCache::TextureCache() :
     _primaryNormalTextureID(0),
     _primarySpecularTextureID(0),
     _primaryFramebufferObject(NULL),
-    _secondaryFramebufferObject(NULL),
-    _tertiaryFramebufferObject(NULL),
     _shadowFramebufferObject(NULL),
     _frameBufferSize(100, 100),
-    _associatedWidget(NULL)
+    _associatedWidget(NULL),
+    _textureMemoryBudget(textureMemoryBudgetMegabytes.get() * BYTES_PER_MEGABYTES)
 {
     const qint64 TEXTURE_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(TEXTURE_DEFAULT_UNUSED_MAX_SIZE);
+
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    _decodedTextureDirectory = QDir((!cachePath.isEmpty() ? cachePath : "textureCache") + "/decodedTextures")
+        .absolutePath();
+    QDir().mkpath(_decodedTextureDirectory);
+}
+
+// decoded textures are stored after this header, whose version goes up whenever the decoding changes
+struct DecodedTextureHeader {
+    char id[4];                 // "HFDT"
+    quint8 version;
+    quint8 translucent;
+    quint16 format;             // QImage::Format
+    quint32 width;
+    quint32 height;
+    quint32 originalWidth;
+    quint32 originalHeight;
+    quint32 averageColor;       // QRgb
+};
+
+const char DECODED_TEXTURE_ID[4] = { 'H', 'F', 'D', 'T' };
+const quint8 DECODED_TEXTURE_VERSION = 1;
+
+const qint64 DECODED_TEXTURE_MAX_DIRECTORY_SIZE = 512 * 1024 * 1024;
+
+// decoding depends only on the content, so the same image under any number of URLs is decoded and stored once
+QString TextureCache::decodedTexturePath(const QByteArray& contentHash) const {
+    return _decodedTextureDirectory + "/" + contentHash.toHex() + ".tex";
+}
+
+bool TextureCache::findDecodedTexture(const QByteArray& contentHash, DecodedTexture& decoded) {
+    if (contentHash.isEmpty()) {
+        return false;
+    }
+
+    QFile file(decodedTexturePath(contentHash));
+    DecodedTextureHeader header;
+    if (!file.open(QIODevice::ReadOnly)
+            || file.read(reinterpret_cast<char*>(&header), sizeof(header)) != (qint64)sizeof(header)
+            || memcmp(header.id, DECODED_TEXTURE_ID, sizeof(DECODED_TEXTURE_ID)) != 0
+            || header.version != DECODED_TEXTURE_VERSION) {
+        return false;
+    }
+
+    QImage image(header.width, header.height, (QImage::Format)header.format);
+    if (image.isNull() || file.size() - (qint64)sizeof(header) != image.byteCount()
+            || file.read(reinterpret_cast<char*>(image.bits()), image.byteCount()) != image.byteCount()) {
+        return false;
+    }
+
+    decoded.image = image;
+    decoded.translucent = header.translucent;
+    decoded.averageColor = QColor::fromRgba(header.averageColor);
+    decoded.originalWidth = header.originalWidth;
+    decoded.originalHeight = header.originalHeight;
+    return true;
+}
+
+void TextureCache::storeDecodedTexture(const QByteArray& contentHash, const DecodedTexture& decoded) {
+    if (contentHash.isEmpty() || decoded.image.isNull()) {
+        return;
+    }
+
+    DecodedTextureHeader header;
+    memcpy(header.id, DECODED_TEXTURE_ID, sizeof(DECODED_TEXTURE_ID));
+    header.version = DECODED_TEXTURE_VERSION;
+    header.translucent = decoded.translucent;
+    header.format = decoded.image.format();
+    header.width = decoded.image.width();
+    header.height = decoded.image.height();
+    header.originalWidth = decoded.originalWidth;
+    header.originalHeight = decoded.originalHeight;
+    header.averageColor = decoded.averageColor.rgba();
+
+    // write to the side and rename, so a half written file is never found
+    QString path = decodedTexturePath(contentHash);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Could not store decoded texture at" << path;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(decoded.image.constBits()), decoded.image.byteCount());
+
+    if (file.commit()) {
+        trimDecodedTextureDirectory();
+    } else {
+        qDebug() << "Could not store decoded texture for" << url << "at" << path;
+    }
+}
+
+void TextureCache::trimDecodedTextureDirectory() {
+    QMutexLocker locker(&_decodedTextureDirectoryMutex);
+    QDir directory(_decodedTextureDirectory);
+    QFileInfoList files = directory.entryInfoList(QStringList("*.tex"), QDir::Files, QDir::Time);
+
+    qint64 totalSize = 0;
+    foreach (const QFileInfo& fileInfo, files) {
+        totalSize += fileInfo.size();
+    }
+
+    // the list is newest first, so drop from the back until the directory fits again
+    for (int i = files.size() - 1; i >= 0 && totalSize > DECODED_TEXTURE_MAX_DIRECTORY_SIZE; i--) {
+        if (directory.remove(files[i].fileName())) {
+            totalSize -= files[i].size();
+        }
+    }
+}
+
+// a 1024x1024 RGBA texture a frame, a bigger one still goes up by itself
+static const int TEXTURE_UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;
+
+void TextureCache::uploadPendingTextures() {
+    int bytesUploaded = 0;
+    while (!_pendingUploads.isEmpty() && bytesUploaded < TEXTURE_UPLOAD_BYTES_PER_FRAME) {
+        NetworkTexturePointer texture = _pendingUploads.takeFirst().toStrongRef();
+        if (texture) {
+            bytesUploaded += texture->upload();
+            _residentTextures.insert(texture.data(), texture);
+        }
+    }
+}
+
+void TextureCache::setTextureMemoryBudget(qint64 budget) {
+    if (budget != _textureMemoryBudget) {
+        _textureMemoryBudget = budget;
+        textureMemoryBudgetMegabytes.set(budget / BYTES_PER_MEGABYTES);
+    }
+}
+
+static bool moreExcessDetail(const QPair<float, NetworkTexture*>& first, const QPair<float, NetworkTexture*>& second) {
+    return first.first > second.first;
+}
+
+void TextureCache::enforceTextureMemoryBudget() {
+    // what a texture wants fades over a second or so once it stops being drawn
+    const float WANTED_SIZE_DECAY = 0.99f;
+    const int MINIMUM_RESIDENT_SIZE = 64;
+    const int MAX_SHRINKS_PER_FRAME = 2;
+
+    bool overBudget = (qint64)gpu::GLBackend::getTextureMemory() > _textureMemoryBudget;
+    bool restored = false;
+    QVector<QPair<float, NetworkTexture*> > candidates;
+    for (QHash<NetworkTexture*, QWeakPointer<NetworkTexture> >::iterator it = _residentTextures.begin();
+            it != _residentTextures.end(); ) {
+        NetworkTexturePointer texture = it.value().toStrongRef();
+        if (!texture || !texture->getGPUTexture()) {
+            it = _residentTextures.erase(it);
+            continue;
+        }
+        it++;
+        texture->_wantedSize = qMax(texture->_screenSize, texture->_wantedSize * WANTED_SIZE_DECAY);
+        texture->_screenSize = 0.0f;
+
+        int residentSize = texture->getResidentSize();
+        if (overBudget) {
+            if (residentSize > MINIMUM_RESIDENT_SIZE) {
+                candidates.append(qMakePair(residentSize / qMax(texture->_wantedSize, 1.0f), texture.data()));
+            }
+        } else if (!restored && texture->_shrinks > 0 && !texture->_restoreReply
+                && residentSize < texture->_wantedSize) {
+            // the whole texture takes four times what it does now for every time it was shrunk
+            qint64 restoredMemory = (qint64)residentSize * residentSize * (4 << (2 * texture->_shrinks));
+            if ((qint64)gpu::GLBackend::getTextureMemory() + restoredMemory < _textureMemoryBudget) {
+                texture->restore();
+                restored = true;
+            }
+        }
+    }
+
+    // the textures with the most texels for the pixels they cover go first, only a couple a frame as each reads back
+    qSort(candidates.begin(), candidates.end(), moreExcessDetail);
+    for (int i = 0; i < candidates.size() && i < MAX_SHRINKS_PER_FRAME
+            && (qint64)gpu::GLBackend::getTextureMemory() > _textureMemoryBudget; i++) {
+        NetworkTexture* texture = candidates.at(i).second;
+        qint64 freed = gpu::GLBackend::shrinkTexture(*texture->getGPUTexture(), MINIMUM_RESIDENT_SIZE);
+        if (freed > 0) {
+            texture->_shrinks++;
+            texture->setMemoryUsage(texture->getCPUMemoryBytes(), texture->getGPUMemoryBytes() - freed);
+        }
+    }
 }
 
 TextureCache::~TextureCache() {
@@ -57,13 +250,7 @@ TextureCache::~TextureCache() {
         delete _primaryFramebufferObject;
     }
 
-    if (_secondaryFramebufferObject) {
-        delete _secondaryFramebufferObject;
-    }
-
-    if (_tertiaryFramebufferObject) {
-        delete _tertiaryFramebufferObject;
-    }
+    clearFreeFramebufferObjects();
 }
 
 void TextureCache::setFrameBufferSize(QSize frameBufferSize) {
@@ -82,15 +269,7 @@ void TextureCache::setFrameBufferSize(QSize frameBufferSize) {
             _primarySpecularTextureID = 0;
         }
 
-        if (_secondaryFramebufferObject) {
-            delete _secondaryFramebufferObject;
-            _secondaryFramebufferObject = NULL;
-        }
-
-        if (_tertiaryFramebufferObject) {
-            delete _tertiaryFramebufferObject;
-            _tertiaryFramebufferObject = NULL;
-        }
+        clearFreeFramebufferObjects();
     }
 }
 
@@ -188,10 +367,27 @@ public:
     const QByteArray& content;
 };
 
-NetworkTexturePointer TextureCache::getTexture(const QUrl& url, TextureType type, bool dilatable, const QByteArray& content) {
+NetworkTexturePointer TextureCache::getTexture(const QUrl& url, TextureType type, bool dilatable,
+        const QByteArray& content, const QByteArray& contentHash) {
     if (!dilatable) {
+        QByteArray contentKey;
+        if (!contentHash.isEmpty()) {
+            // the same image uploaded with another model is already here
+            contentKey = contentHash + '\n' + QByteArray::number(type);
+            NetworkTexturePointer texture = _texturesByContent.value(contentKey);
+            if (!texture.isNull()) {
+                removeUnusedResource(texture);
+                return texture;
+            }
+        }
         TextureExtra extra = { type, content };
-        return ResourceCache::getResource(url, QUrl(), false, &extra).staticCast<NetworkTexture>();
+        NetworkTexturePointer texture = ResourceCache::getResource(url, QUrl(), false, &extra)
+            .staticCast<NetworkTexture>();
+        if (!contentKey.isEmpty() && texture) {
+            texture->_contentKey = contentKey;
+            _texturesByContent.insert(contentKey, texture);
+        }
+        return texture;
     }
     NetworkTexturePointer texture = _dilatableNetworkTextures.value(url);
     if (texture.isNull()) {
@@ -274,18 +470,24 @@ void TextureCache::setPrimaryDrawBuffers(bool color, bool normal, bool specular)
     glDrawBuffers(bufferCount, buffers);
 }
 
-QOpenGLFramebufferObject* TextureCache::getSecondaryFramebufferObject() {
-    if (!_secondaryFramebufferObject) {
-        _secondaryFramebufferObject = createFramebufferObject();
+QOpenGLFramebufferObject* TextureCache::acquireFramebufferObject() {
+    // the most recently handed back first, as the likeliest to still be resident
+    if (!_freeFramebufferObjects.isEmpty()) {
+        return _freeFramebufferObjects.takeLast();
     }
-    return _secondaryFramebufferObject;
+    return createFramebufferObject();
 }
 
-QOpenGLFramebufferObject* TextureCache::getTertiaryFramebufferObject() {
-    if (!_tertiaryFramebufferObject) {
-        _tertiaryFramebufferObject = createFramebufferObject();
+void TextureCache::releaseFramebufferObject(QOpenGLFramebufferObject* fbo) {
+    if (!fbo) {
+        return;
+    }
+    // one acquired before the frame buffer was resized goes rather than being handed out again
+    if (fbo->size() != _frameBufferSize) {
+        delete fbo;
+        return;
     }
-    return _tertiaryFramebufferObject;
+    _freeFramebufferObjects.append(fbo);
 }
 
 QOpenGLFramebufferObject* TextureCache::getShadowFramebufferObject() {
@@ -331,13 +533,8 @@ bool TextureCache::eventFilter(QObject* watched, QEvent* event) {
             glDeleteTextures(1, &_primaryNormalTextureID);
             glDeleteTextures(1, &_primarySpecularTextureID);
         }
-        if (_secondaryFramebufferObject && _secondaryFramebufferObject->size() != size) {
-            delete _secondaryFramebufferObject;
-            _secondaryFramebufferObject = NULL;
-        }
-        if (_tertiaryFramebufferObject && _tertiaryFramebufferObject->size() != size) {
-            delete _tertiaryFramebufferObject;
-            _tertiaryFramebufferObject = NULL;
+        if (!_freeFramebufferObjects.isEmpty() && _freeFramebufferObjects.first()->size() != size) {
+            clearFreeFramebufferObjects();
         }
     }
     return false;
@@ -369,6 +566,11 @@ QOpenGLFramebufferObject* TextureCache::createFramebufferObject() {
     return fbo;
 }
 
+void TextureCache::clearFreeFramebufferObjects() {
+    qDeleteAll(_freeFramebufferObjects);
+    _freeFramebufferObjects.clear();
+}
+
 Texture::Texture() {
 }
 
@@ -384,7 +586,11 @@ NetworkTexture::NetworkTexture(const QUrl& url, TextureType type, const QByteArr
     _type(type),
     _translucent(false),
     _width(0),
-    _height(0) {
+    _height(0),
+    _screenSize(0.0f),
+    _wantedSize(0.0f),
+    _shrinks(0),
+    _restoreReply(NULL) {
     
     if (!url.isValid()) {
         _loaded = true;
@@ -442,6 +648,12 @@ ImageReader::ImageReader(const QWeakPointer<Resource>& texture, QNetworkReply* r
     _content(content) {
 }
 
+static void sendDecodedTexture(Resource* texture, const DecodedTexture& decoded) {
+    QMetaObject::invokeMethod(texture, "setImage", Q_ARG(const QImage&, decoded.image),
+        Q_ARG(bool, decoded.translucent), Q_ARG(const QColor&, decoded.averageColor),
+        Q_ARG(int, decoded.originalWidth), Q_ARG(int, decoded.originalHeight));
+}
+
 void ImageReader::run() {
     QSharedPointer<Resource> texture = _texture.toStrongRef();
     if (texture.isNull()) {
@@ -455,6 +667,16 @@ void ImageReader::run() {
         _content = _reply->readAll();
         _reply->deleteLater();
     }
+
+    // we've decoded this exact image before, under this URL or another
+    QByteArray contentHash = QCryptographicHash::hash(_content, QCryptographicHash::Sha256);
+    auto textureCache = DependencyManager::get<TextureCache>();
+    DecodedTexture decoded;
+    if (textureCache->findDecodedTexture(contentHash, decoded)) {
+        sendDecodedTexture(texture.data(), decoded);
+        return;
+    }
+
     QImage image = QImage::fromData(_content);
 
     int originalWidth = image.width();
@@ -491,8 +713,13 @@ void ImageReader::run() {
         if (imageArea > 0) {
             averageColor.setRgb(redTotal / imageArea, greenTotal / imageArea, blueTotal / imageArea);
         }
-        QMetaObject::invokeMethod(texture.data(), "setImage", Q_ARG(const QImage&, image), Q_ARG(bool, false),
-            Q_ARG(const QColor&, averageColor), Q_ARG(int, originalWidth), Q_ARG(int, originalHeight));
+        decoded.image = image;
+        decoded.translucent = false;
+        decoded.averageColor = averageColor;
+        decoded.originalWidth = originalWidth;
+        decoded.originalHeight = originalHeight;
+        textureCache->storeDecodedTexture(contentHash, decoded);
+        sendDecodedTexture(texture.data(), decoded);
         return;
     }
     if (image.format() != QImage::Format_ARGB32) {
@@ -522,10 +749,14 @@ void ImageReader::run() {
         qDebug() << "Image with alpha channel is completely opaque:" << _url;
         image = image.convertToFormat(QImage::Format_RGB888);
     }
-    QMetaObject::invokeMethod(texture.data(), "setImage", Q_ARG(const QImage&, image),
-        Q_ARG(bool, translucentPixels >= imageArea / 2), Q_ARG(const QColor&, QColor(redTotal / imageArea,
-            greenTotal / imageArea, blueTotal / imageArea, alphaTotal / imageArea)),
-        Q_ARG(int, originalWidth), Q_ARG(int, originalHeight));
+    decoded.image = image;
+    decoded.translucent = translucentPixels >= imageArea / 2;
+    decoded.averageColor = QColor(redTotal / imageArea, greenTotal / imageArea, blueTotal / imageArea,
+        alphaTotal / imageArea);
+    decoded.originalWidth = originalWidth;
+    decoded.originalHeight = originalHeight;
+    textureCache->storeDecodedTexture(contentHash, decoded);
+    sendDecodedTexture(texture.data(), decoded);
 }
 
 void NetworkTexture::downloadFinished(QNetworkReply* reply) {
@@ -545,9 +776,23 @@ void NetworkTexture::setImage(const QImage& image, bool translucent, const QColo
     _originalHeight = originalHeight;
     _width = image.width();
     _height = image.height();
-    
+    _pendingImage = image;
+
+    // a domain can finish decoding a lot of textures at once, the cache uploads them over the next frames
+    TextureCache* cache = static_cast<TextureCache*>(_cache.data());
+    if (cache) {
+        cache->_pendingUploads.append(qWeakPointerCast<NetworkTexture, Resource>(_self));
+    } else {
+        upload();
+    }
+}
+
+int NetworkTexture::upload() {
+    QImage image = _pendingImage;
+    _pendingImage = QImage();
+    _shrinks = 0;
+
     finishedLoading(true);
-    imageLoaded(image);
 
     if ((_width > 0) && (_height > 0)) {
         bool isLinearRGB = true; //(_type == NORMAL_TEXTURE) || (_type == EMISSIVE_TEXTURE);
@@ -561,7 +806,31 @@ void NetworkTexture::setImage(const QImage& image, bool translucent, const QColo
         _gpuTexture = gpu::TexturePointer(gpu::Texture::create2D(formatGPU, image.width(), image.height()));
         _gpuTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
         _gpuTexture->autoGenerateMips(-1);
+
+        // upload now rather than when something first draws with it, so the frame budget is what decides
+        gpu::GLBackend::getTextureID(_gpuTexture);
+    }
+
+    // what was downloaded and decoded is let go once it's in gl
+    setMemoryUsage(0, _gpuTexture ? gpu::GLBackend::getTextureSize(*_gpuTexture) : 0);
+    imageLoaded(image);
+    return image.byteCount();
+}
+
+void NetworkTexture::restore() {
+    _restoreReply = NetworkAccessManager::get(_request);
+    connect(_restoreReply, SIGNAL(finished()), SLOT(restoreFinished()));
+}
+
+void NetworkTexture::restoreFinished() {
+    QNetworkReply* reply = _restoreReply;
+    _restoreReply = NULL;
+    if (reply->error() != QNetworkReply::NoError) {
+        // keep the shrunk one, it'll be tried again the next time it's wanted bigger
+        reply->deleteLater();
+        return;
     }
+    downloadFinished(reply);
 }
 
 void NetworkTexture::imageLoaded(const QImage& image) {
@@ -610,6 +879,7 @@ QSharedPointer<Texture> DilatableNetworkTexture::getDilatedTexture(float dilatio
 
 void DilatableNetworkTexture::imageLoaded(const QImage& image) {
     _image = image;
+    setMemoryUsage(image.byteCount(), getGPUMemoryBytes());
     
     // scan out from the center to find inner and outer radii
     int halfWidth = image.width() / 2;
@@ -628,6 +898,14 @@ void DilatableNetworkTexture::imageLoaded(const QImage& image) {
     _dilatedTextures.clear();
 }
 
+void NetworkTexture::reinsert() {
+    Resource::reinsert();
+    if (!_contentKey.isEmpty()) {
+        static_cast<TextureCache*>(_cache.data())->_texturesByContent.insert(_contentKey,
+            qWeakPointerCast<NetworkTexture, Resource>(_self));
+    }
+}
+
 void DilatableNetworkTexture::reinsert() {
     static_cast<TextureCache*>(_cache.data())->_dilatableNetworkTextures.insert(_url,
         qWeakPointerCast<NetworkTexture, Resource>(_self));    
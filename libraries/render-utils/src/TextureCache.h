@@ -17,6 +17,7 @@
 
 #include <QImage>
 #include <QMap>
+#include <QMutex>
 #include <QGLWidget>
 
 #include <DependencyManager.h>
@@ -28,6 +29,15 @@ class NetworkTexture;
 
 typedef QSharedPointer<NetworkTexture> NetworkTexturePointer;
 
+/// What a downloaded image decodes to, scaled and converted so it is ready to upload.
+struct DecodedTexture {
+    QImage image;
+    bool translucent;
+    QColor averageColor;
+    int originalWidth;
+    int originalHeight;
+};
+
 enum TextureType { DEFAULT_TEXTURE, NORMAL_TEXTURE, SPECULAR_TEXTURE, EMISSIVE_TEXTURE, SPLAT_TEXTURE };
 
 /// Stores cached textures, including render-to-texture targets.
@@ -55,8 +65,10 @@ public:
     const gpu::TexturePointer& getBlueTexture();
 
     /// Loads a texture from the specified URL.
+    /// \param contentHash the hash of the texture's content, if known, as the models list it: a texture with the same
+    /// hash and type already loaded under another URL is shared rather than downloaded and uploaded again
     NetworkTexturePointer getTexture(const QUrl& url, TextureType type = DEFAULT_TEXTURE, bool dilatable = false,
-        const QByteArray& content = QByteArray());
+        const QByteArray& content = QByteArray(), const QByteArray& contentHash = QByteArray());
 
     /// Returns a pointer to the primary framebuffer object.  This render target includes a depth component, and is
     /// used for scene rendering.
@@ -74,13 +86,14 @@ public:
     /// Enables or disables draw buffers on the primary framebuffer.  Note: the primary framebuffer must be bound.
     void setPrimaryDrawBuffers(bool color, bool normal = false, bool specular = false);
     
-    /// Returns a pointer to the secondary framebuffer object, used as an additional render target when performing full
-    /// screen effects.
-    QOpenGLFramebufferObject* getSecondaryFramebufferObject();
+    /// Returns a framebuffer object of the frame buffer's size for a full screen effect to render to, to be handed back
+    /// with releaseFramebufferObject once nothing is to read from it.  Those handed back go to the next effects that
+    /// ask, so the passes whose targets aren't wanted at the same time share the same memory.
+    QOpenGLFramebufferObject* acquireFramebufferObject();
     
-    /// Returns a pointer to the tertiary framebuffer object, used as an additional render target when performing full
-    /// screen effects.
-    QOpenGLFramebufferObject* getTertiaryFramebufferObject();
+    /// Hands back a framebuffer object from acquireFramebufferObject.  What was rendered to it stays there until
+    /// another acquires it.
+    void releaseFramebufferObject(QOpenGLFramebufferObject* fbo);
     
     /// Returns a pointer to the framebuffer object used to render shadow maps.
     QOpenGLFramebufferObject* getShadowFramebufferObject();
@@ -90,6 +103,26 @@ public:
     
     virtual bool eventFilter(QObject* watched, QEvent* event);
 
+    /// Uploads the textures that finished decoding since the last frame, as many as fit in the frame's upload budget
+    /// and at least one. Should be called once a frame with the GL context current.
+    void uploadPendingTextures();
+
+    /// Finds what an image with content of this hash decoded to the last time it was downloaded, under whichever URL.
+    /// Returns false on a miss. Safe to call from the thread pool.
+    bool findDecodedTexture(const QByteArray& contentHash, DecodedTexture& decoded);
+
+    /// Stores a decoded texture on disk so the next time the same content is downloaded it doesn't need decoding.
+    /// Safe to call from the thread pool.
+    void storeDecodedTexture(const QByteArray& contentHash, const DecodedTexture& decoded);
+
+    /// Keeps the texture memory the network textures take up within the budget, shrinking the ones drawn smallest
+    /// compared to their size and bringing shrunk ones back whole when they're drawn big again and there's room.
+    /// Should be called once a frame with the GL context current.
+    void enforceTextureMemoryBudget();
+
+    void setTextureMemoryBudget(qint64 budget);
+    qint64 getTextureMemoryBudget() const { return _textureMemoryBudget; }
+
 protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url,
@@ -99,21 +132,32 @@ private:
     TextureCache();
     virtual ~TextureCache();
     friend class DilatableNetworkTexture;
+    friend class NetworkTexture;
     
     QOpenGLFramebufferObject* createFramebufferObject();
+    void clearFreeFramebufferObjects();
+
+    QString decodedTexturePath(const QByteArray& contentHash) const;
+    void trimDecodedTextureDirectory();
  
     gpu::TexturePointer _permutationNormalTexture;
     gpu::TexturePointer _whiteTexture;
     gpu::TexturePointer _blueTexture;
     
     QHash<QUrl, QWeakPointer<NetworkTexture> > _dilatableNetworkTextures;
+    QHash<QByteArray, QWeakPointer<NetworkTexture> > _texturesByContent; // by content hash and type
+    QList<QWeakPointer<NetworkTexture> > _pendingUploads;
+    QHash<NetworkTexture*, QWeakPointer<NetworkTexture> > _residentTextures;
+    qint64 _textureMemoryBudget;
+
+    QString _decodedTextureDirectory;
+    QMutex _decodedTextureDirectoryMutex; // held while trimming, readers store from many threads
     
     GLuint _primaryDepthTextureID;
     GLuint _primaryNormalTextureID;
     GLuint _primarySpecularTextureID;
     QOpenGLFramebufferObject* _primaryFramebufferObject;
-    QOpenGLFramebufferObject* _secondaryFramebufferObject;
-    QOpenGLFramebufferObject* _tertiaryFramebufferObject;
+    QList<QOpenGLFramebufferObject*> _freeFramebufferObjects; ///< handed back, ready for the next to acquire
     
     QOpenGLFramebufferObject* _shadowFramebufferObject;
     GLuint _shadowDepthTextureID;
@@ -160,6 +204,10 @@ public:
     int getWidth() const { return _width; }
     int getHeight() const { return _height; }
 
+    /// Tells the texture how many pixels across it was just drawn at. The largest it was drawn at recently decides
+    /// how much of it stays resident when texture memory runs short.
+    void noteScreenSize(float pixels) { _screenSize = qMax(_screenSize, pixels); }
+
 protected:
 
     virtual void downloadFinished(QNetworkReply* reply);
@@ -170,15 +218,37 @@ protected:
 
     virtual void imageLoaded(const QImage& image);
 
+    virtual void reinsert();
+
     TextureType _type;
 
 private:
+    friend class TextureCache;
+
+    /// creates the gpu texture from the decoded image and uploads it, returning the number of bytes uploaded
+    int upload();
+
+    /// downloads and decodes the texture again, to replace a shrunk one with the whole thing
+    void restore();
+
+    int getResidentSize() const { return qMax(_width, _height) >> _shrinks; }
+
+    float _screenSize; // the most pixels across it was drawn at since the cache last looked
+    float _wantedSize;
+    int _shrinks; // how many times its largest mip was dropped
+    QNetworkReply* _restoreReply;
+    QByteArray _contentKey; // what it's listed under in the cache's textures by content, if anything
+
+    QImage _pendingImage;
     bool _translucent;
     QColor _averageColor;
     int _originalWidth;
     int _originalHeight;
     int _width;
     int _height;
+
+private slots:
+    void restoreFinished();
 };
 
 /// Caches derived, dilated textures.
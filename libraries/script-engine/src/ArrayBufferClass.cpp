@@ -150,6 +150,17 @@ QScriptValue ArrayBufferClass::toScriptValue(QScriptEngine* engine, const QByteA
 }
 
 void ArrayBufferClass::fromScriptValue(const QScriptValue& obj, QByteArray& ba) {
-    ba = qvariant_cast<QByteArray>(obj.data().toVariant());
+    // typed arrays and data views pass their buffer, which is shared as it is when they cover all of it
+    QScriptValue buffer = obj.property(BUFFER_PROPERTY_NAME);
+    if (!buffer.isObject()) {
+        ba = qvariant_cast<QByteArray>(obj.data().toVariant());
+        return;
+    }
+    ba = qvariant_cast<QByteArray>(buffer.data().toVariant());
+    int byteOffset = obj.property(BYTE_OFFSET_PROPERTY_NAME).toInt32();
+    int byteLength = obj.property(BYTE_LENGTH_PROPERTY_NAME).toInt32();
+    if (byteOffset != 0 || byteLength != ba.size()) {
+        ba = ba.mid(byteOffset, byteLength);
+    }
 }
 
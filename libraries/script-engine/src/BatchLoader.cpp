@@ -17,6 +17,8 @@
 #include <NetworkAccessManager.h>
 #include <SharedUtil.h>
 
+#include "ScriptSourceCache.h"
+
 BatchLoader::BatchLoader(const QList<QUrl>& urls) 
     : QObject(),
       _started(false),
@@ -31,12 +33,15 @@ void BatchLoader::start() {
     }
 
     _started = true;
-    QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
     for (QUrl url : _urls) {
-        if (url.scheme() == "http" || url.scheme() == "https" || url.scheme() == "ftp") {
+        QString cachedSource = ScriptSourceCache::getInstance().getSource(url);
+        if (!cachedSource.isNull()) {
+            _data.insert(url, cachedSource);
+
+        } else if (url.scheme() == "http" || url.scheme() == "https" || url.scheme() == "ftp") {
             QNetworkRequest request = QNetworkRequest(url);
             request.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
-            QNetworkReply* reply = networkAccessManager.get(request);
+            QNetworkReply* reply = NetworkAccessManager::get(request);
 
             qDebug() << "Downloading file at" << url;
 
@@ -44,7 +49,9 @@ void BatchLoader::start() {
                 if (reply->error()) {
                     _data.insert(url, QString());
                 } else {
-                    _data.insert(url, reply->readAll());
+                    QString source = reply->readAll();
+                    ScriptSourceCache::getInstance().setSource(url, source);
+                    _data.insert(url, source);
                 }
                 reply->deleteLater();
                 checkFinished();
@@ -15,76 +15,148 @@
 
 #include <OctreeConstants.h>
 #include <GLMHelpers.h>
+
 #include "Quat.h"
+#include "ScriptMath.h"
 
+static QScriptValue multiply(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(math.toQuat(context->argument(0)) * math.toQuat(context->argument(1)));
+}
 
-glm::quat Quat::multiply(const glm::quat& q1, const glm::quat& q2) { 
-    return q1 * q2; 
+static QScriptValue fromVec3Degrees(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::quat(glm::radians(math.toVec3(context->argument(0)))));
 }
 
-glm::quat Quat::fromVec3Degrees(const glm::vec3& eulerAngles) { 
-    return glm::quat(glm::radians(eulerAngles)); 
+static QScriptValue fromVec3Radians(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::quat(math.toVec3(context->argument(0))));
 }
 
-glm::quat Quat::fromVec3Radians(const glm::vec3& eulerAngles) { 
-    return glm::quat(eulerAngles); 
+static glm::vec3 toPitchYawRoll(QScriptContext* context) {
+    return glm::vec3(context->argument(0).toNumber(), context->argument(1).toNumber(),
+        context->argument(2).toNumber());
 }
 
-glm::quat Quat::fromPitchYawRollDegrees(float pitch, float yaw, float roll) { 
-    return glm::quat(glm::radians(glm::vec3(pitch, yaw, roll)));
+static QScriptValue fromPitchYawRollDegrees(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    return getScriptMath(arg).fromQuat(glm::quat(glm::radians(toPitchYawRoll(context))));
 }
 
-glm::quat Quat::fromPitchYawRollRadians(float pitch, float yaw, float roll) { 
-    return glm::quat(glm::vec3(pitch, yaw, roll));
+static QScriptValue fromPitchYawRollRadians(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    return getScriptMath(arg).fromQuat(glm::quat(toPitchYawRoll(context)));
 }
 
-glm::quat Quat::inverse(const glm::quat& q) {
-    return glm::inverse(q);
+static QScriptValue inverse(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::inverse(math.toQuat(context->argument(0))));
 }
 
-glm::vec3 Quat::getFront(const glm::quat& orientation) {
-    return orientation * IDENTITY_FRONT;
+static QScriptValue getFront(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toQuat(context->argument(0)) * IDENTITY_FRONT);
 }
 
-glm::vec3 Quat::getRight(const glm::quat& orientation) {
-    return orientation * IDENTITY_RIGHT;
+static QScriptValue getRight(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toQuat(context->argument(0)) * IDENTITY_RIGHT);
 }
 
-glm::vec3 Quat::getUp(const glm::quat& orientation) {
-    return orientation * IDENTITY_UP;
+static QScriptValue getUp(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toQuat(context->argument(0)) * IDENTITY_UP);
 }
 
-glm::vec3 Quat::safeEulerAngles(const glm::quat& orientation) {
-    return glm::degrees(::safeEulerAngles(orientation));
+static QScriptValue safeEulerAnglesDegrees(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(glm::degrees(safeEulerAngles(math.toQuat(context->argument(0)))));
 }
 
-glm::quat Quat::angleAxis(float angle, const glm::vec3& v) {
-    return glm::angleAxis(glm::radians(angle), v);
+static QScriptValue angleAxis(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::angleAxis(glm::radians((float)context->argument(0).toNumber()),
+        math.toVec3(context->argument(1))));
 }
 
-glm::quat Quat::mix(const glm::quat& q1, const glm::quat& q2, float alpha) {
-    return safeMix(q1, q2, alpha);
+static QScriptValue mix(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(safeMix(math.toQuat(context->argument(0)), math.toQuat(context->argument(1)),
+        (float)context->argument(2).toNumber()));
 }
 
 /// Spherical Linear Interpolation
-glm::quat Quat::slerp(const glm::quat& q1, const glm::quat& q2, float alpha) {
-    return glm::slerp(q1, q2, alpha);
+static QScriptValue slerp(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::slerp(math.toQuat(context->argument(0)), math.toQuat(context->argument(1)),
+        (float)context->argument(2).toNumber()));
 }
 
 // Spherical Quadratic Interpolation
-glm::quat Quat::squad(const glm::quat& q1, const glm::quat& q2, const glm::quat& s1, const glm::quat& s2, float h) {
-    return glm::squad(q1, q2, s1, s2, h);
+static QScriptValue squad(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromQuat(glm::squad(math.toQuat(context->argument(0)), math.toQuat(context->argument(1)),
+        math.toQuat(context->argument(2)), math.toQuat(context->argument(3)), (float)context->argument(4).toNumber()));
+}
+
+static QScriptValue dot(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return glm::dot(math.toQuat(context->argument(0)), math.toQuat(context->argument(1)));
+}
+
+static QScriptValue print(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    glm::quat q = getScriptMath(arg).toQuat(context->argument(1));
+    qDebug() << qPrintable(context->argument(0).toString()) << q.x << "," << q.y << "," << q.z << "," << q.w;
+    return QScriptValue();
+}
+
+static QScriptValue equal(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.toQuat(context->argument(0)) == math.toQuat(context->argument(1));
+}
+
+static QScriptValue multiplyArray(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    glm::quat rotation = math.toQuat(context->argument(0));
+    QVector<glm::quat> quats = math.toQuatArray(context->argument(1));
+    for (int i = 0; i < quats.size(); i++) {
+        quats[i] = rotation * quats.at(i);
+    }
+    return math.fromQuatArray(quats);
+}
+
+static QScriptValue mixArrays(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    QVector<glm::quat> quats = math.toQuatArray(context->argument(0));
+    QVector<glm::quat> others = math.toQuatArray(context->argument(1));
+    float alpha = context->argument(2).toNumber();
+    quats.resize(qMin(quats.size(), others.size()));
+    for (int i = 0; i < quats.size(); i++) {
+        quats[i] = safeMix(quats.at(i), others.at(i), alpha);
+    }
+    return math.fromQuatArray(quats);
+}
+
+QScriptValue Quat::createObject(ScriptMath& math) {
+    QScriptValue object = math.getEngine()->newObject();
+    math.addFunction(object, "multiply", multiply);
+    math.addFunction(object, "fromVec3Degrees", fromVec3Degrees);
+    math.addFunction(object, "fromVec3Radians", fromVec3Radians);
+    math.addFunction(object, "fromPitchYawRollDegrees", fromPitchYawRollDegrees);
+    math.addFunction(object, "fromPitchYawRollRadians", fromPitchYawRollRadians);
+    math.addFunction(object, "inverse", inverse);
+    math.addFunction(object, "getFront", getFront);
+    math.addFunction(object, "getRight", getRight);
+    math.addFunction(object, "getUp", getUp);
+    math.addFunction(object, "safeEulerAngles", safeEulerAnglesDegrees);
+    math.addFunction(object, "angleAxis", angleAxis);
+    math.addFunction(object, "mix", mix);
+    math.addFunction(object, "slerp", slerp);
+    math.addFunction(object, "squad", squad);
+    math.addFunction(object, "dot", dot);
+    math.addFunction(object, "print", print);
+    math.addFunction(object, "equal", equal);
+
+    math.addFunction(object, "multiplyArray", multiplyArray);
+    math.addFunction(object, "mixArrays", mixArrays);
+    return object;
 }
-
-float Quat::dot(const glm::quat& q1, const glm::quat& q2) {
-    return glm::dot(q1, q2);
-}
-
-void Quat::print(const QString& lable, const glm::quat& q) {
-    qDebug() << qPrintable(lable) << q.x << "," << q.y << "," << q.z << "," << q.w;
-}
-
-bool Quat::equal(const glm::vec3& q1, const glm::vec3& q2) {
-    return q1 == q2;
-}
-
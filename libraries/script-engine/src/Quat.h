@@ -14,33 +14,25 @@
 #ifndef hifi_Quat_h
 #define hifi_Quat_h
 
-#include <glm/gtc/quaternion.hpp>
+#include <QtScript/QScriptValue>
 
-#include <QObject>
-#include <QString>
+class ScriptMath;
 
-/// Scriptable interface a Quaternion helper class object. Used exclusively in the JavaScript API
-class Quat : public QObject {
-    Q_OBJECT
+/// Scriptable interface to the quaternion helper functions. Used exclusively in the JavaScript API.  Like Vec3's, the
+/// functions are native:
+///
+///     multiply(q1, q2), fromVec3Degrees(v), fromVec3Radians(v), fromPitchYawRollDegrees(pitch, yaw, roll),
+///     fromPitchYawRollRadians(pitch, yaw, roll), inverse(q), getFront(q), getRight(q), getUp(q), safeEulerAngles(q),
+///     angleAxis(degrees, v), mix(q1, q2, alpha), slerp(q1, q2, alpha), squad(q1, q2, s1, s2, h), dot(q1, q2),
+///     print(label, q), equal(q1, q2)
+///
+///     multiplyArray(q, quats): q times each of the quaternions
+///     mixArrays(quats1, quats2, alpha): each pair of quaternions mixed, up to the length of the shorter array
+class Quat {
+public:
 
-public slots:
-    glm::quat multiply(const glm::quat& q1, const glm::quat& q2);
-    glm::quat fromVec3Degrees(const glm::vec3& vec3); // degrees
-    glm::quat fromVec3Radians(const glm::vec3& vec3); // radians
-    glm::quat fromPitchYawRollDegrees(float pitch, float yaw, float roll); // degrees
-    glm::quat fromPitchYawRollRadians(float pitch, float yaw, float roll); // radians
-    glm::quat inverse(const glm::quat& q);
-    glm::vec3 getFront(const glm::quat& orientation);
-    glm::vec3 getRight(const glm::quat& orientation);
-    glm::vec3 getUp(const glm::quat& orientation);
-    glm::vec3 safeEulerAngles(const glm::quat& orientation); // degrees
-    glm::quat angleAxis(float angle, const glm::vec3& v);   // degrees
-    glm::quat mix(const glm::quat& q1, const glm::quat& q2, float alpha);
-    glm::quat slerp(const glm::quat& q1, const glm::quat& q2, float alpha);
-    glm::quat squad(const glm::quat& q1, const glm::quat& q2, const glm::quat& s1, const glm::quat& s2, float h);
-    float dot(const glm::quat& q1, const glm::quat& q2);
-    void print(const QString& lable, const glm::quat& q);
-    bool equal(const glm::vec3& q1, const glm::vec3& q2);
+    /// Creates the Quat object, whose functions read and make their values through the given math.
+    static QScriptValue createObject(ScriptMath& math);
 };
 
 #endif // hifi_Quat_h
@@ -17,6 +17,7 @@
 #include <QtNetwork/QNetworkReply>
 #include <QScriptEngine>
 
+#include <AudioCodec.h>
 #include <AudioConstants.h>
 #include <AudioEffectOptions.h>
 #include <AudioInjector.h>
@@ -36,6 +37,7 @@
 #include "EventTypes.h"
 #include "MenuItemProperties.h"
 #include "ScriptEngine.h"
+#include "ScriptSourceCache.h"
 #include "TypedArrays.h"
 #include "XMLHttpRequestClass.h"
 
@@ -43,6 +45,17 @@
 
 EntityScriptingInterface ScriptEngine::_entityScriptingInterface;
 
+// the wheel turns once a second in millisecond ticks; the timers fire at the resolution of whatever advances it
+const quint64 TIMER_WHEEL_TICK_USECS = USECS_PER_MSEC;
+const int TIMER_WHEEL_SLOT_COUNT = 1024;
+const int TIMER_WHEEL_TIMER_INTERVAL_MSECS = 10;
+
+// an unchanged avatar sends its data this often, well within the time the mixers wait before dropping a silent node
+const quint64 AVATAR_KEEP_ALIVE_USECS = USECS_PER_SECOND;
+
+// past this many parsed programs, an engine starts its cache over
+const int MAX_CACHED_PROGRAMS = 256;
+
 static QScriptValue debugPrint(QScriptContext* context, QScriptEngine* engine){
     qDebug() << "script:print()<<" << context->argument(0).toString();
     QString message = context->argument(0).toString()
@@ -80,19 +93,24 @@ ScriptEngine::ScriptEngine(const QString& scriptContents, const QString& fileNam
     _isAvatar(false),
     _avatarIdentityTimer(NULL),
     _avatarBillboardTimer(NULL),
-    _timerFunctionMap(),
+    _timers(),
+    _timerWheel(TIMER_WHEEL_TICK_USECS, TIMER_WHEEL_SLOT_COUNT),
+    _nextTimerID(1),
+    _timerWheelTimer(NULL),
     _isListeningToAudioStream(false),
     _avatarSound(NULL),
     _numAvatarSoundSentBytes(0),
+    _lastAvatarPacketSent(0),
     _controllerScriptingInterface(controllerScriptingInterface),
     _avatarData(NULL),
     _scriptName(),
     _fileNameString(fileNameString),
-    _quatLibrary(),
-    _vec3Library(),
+    _lastUpdate(0),
+    _math(this),
     _uuidLibrary(),
     _isUserLoaded(false),
-    _arrayBufferClass(new ArrayBufferClass(this))
+    _arrayBufferClass(new ArrayBufferClass(this)),
+    _profileAgent(NULL)
 {
 }
 
@@ -178,10 +196,16 @@ void ScriptEngine::loadURL(const QUrl& scriptURL) {
                 emit errorLoadingScript(_fileNameString);
             }
         } else {
-            QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
+            // another engine may have downloaded it already
+            QString cachedSource = ScriptSourceCache::getInstance().getSource(url);
+            if (!cachedSource.isNull()) {
+                _scriptContents = cachedSource;
+                emit scriptLoaded(_fileNameString);
+                return;
+            }
             QNetworkRequest networkRequest = QNetworkRequest(url);
             networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
-            QNetworkReply* reply = networkAccessManager.get(networkRequest);
+            QNetworkReply* reply = NetworkAccessManager::get(networkRequest);
             connect(reply, &QNetworkReply::finished, this, &ScriptEngine::handleScriptDownload);
         }
     }
@@ -192,6 +216,7 @@ void ScriptEngine::handleScriptDownload() {
     
     if (reply->error() == QNetworkReply::NoError && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) == 200) {
         _scriptContents = reply->readAll();
+        ScriptSourceCache::getInstance().setSource(reply->url(), _scriptContents);
         emit scriptLoaded(_fileNameString);
     } else {
         qDebug() << "ERROR Loading file:" << reply->url().toString();
@@ -224,6 +249,7 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, EntityItemIDtoScriptValue, EntityItemIDfromScriptValue);
     qScriptRegisterMetaType(this, RayToEntityIntersectionResultToScriptValue, RayToEntityIntersectionResultFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID> >(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties> >(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -247,8 +273,8 @@ void ScriptEngine::init() {
     registerGlobalObject("Audio", &AudioScriptingInterface::getInstance());
     registerGlobalObject("Controller", _controllerScriptingInterface);
     registerGlobalObject("Entities", &_entityScriptingInterface);
-    registerGlobalObject("Quat", &_quatLibrary);
-    registerGlobalObject("Vec3", &_vec3Library);
+    globalObject().setProperty("Quat", Quat::createObject(_math));
+    globalObject().setProperty("Vec3", Vec3::createObject(_math));
     registerGlobalObject("Uuid", &_uuidLibrary);
     registerGlobalObject("AnimationCache", DependencyManager::get<AnimationCache>().data());
 
@@ -295,7 +321,11 @@ void ScriptEngine::evaluate() {
         init();
     }
 
-    QScriptValue result = evaluate(_scriptContents);
+    QScriptValue result;
+    {
+        ScriptCallbackTimer timer(_profile, "load");
+        result = evaluate(_scriptContents);
+    }
 
     if (hasUncaughtException()) {
         int line = uncaughtExceptionLineNumber();
@@ -305,6 +335,30 @@ void ScriptEngine::evaluate() {
     }
 }
 
+QScriptValue ScriptEngine::evaluateProgram(const QString& contents, const QString& fileName) {
+    QPair<QString, QString> key(fileName, contents);
+    QHash<QPair<QString, QString>, QScriptProgram>::const_iterator program = _programs.constFind(key);
+    if (program == _programs.constEnd()) {
+        if (_programs.size() >= MAX_CACHED_PROGRAMS) {
+            _programs.clear();
+        }
+        program = _programs.insert(key, QScriptProgram(contents, fileName));
+    }
+    QScriptValue result = QScriptEngine::evaluate(program.value());
+    if (hasUncaughtException()) {
+        int line = uncaughtExceptionLineNumber();
+        qDebug() << "Uncaught exception at (" << _fileNameString << " : " << fileName << ") line" << line << ": "
+            << result.toString();
+    }
+    emit evaluationFinished(result, hasUncaughtException());
+    clearExceptions();
+    return result;
+}
+
+bool ScriptEngine::hasProgram(const QString& contents, const QString& fileName) const {
+    return _programs.contains(QPair<QString, QString>(fileName, contents));
+}
+
 QScriptValue ScriptEngine::evaluate(const QString& program, const QString& fileName, int lineNumber) {
     QScriptValue result = QScriptEngine::evaluate(program, fileName, lineNumber);
     if (hasUncaughtException()) {
@@ -329,19 +383,21 @@ void ScriptEngine::sendAvatarBillboardPacket() {
 }
 
 void ScriptEngine::run() {
-    if (!_isInitialized) {
-        init();
+    QList<ScriptEngine*> engines;
+    engines.append(this);
+    runTogether(engines);
+
+    // If we were on a thread, then wait till it's done
+    if (thread()) {
+        thread()->quit();
     }
-    _isRunning = true;
-    _isFinished = false;
-    emit runningStateChanged();
+}
 
-    QScriptValue result = evaluate(_scriptContents);
-    if (hasUncaughtException()) {
-        int line = uncaughtExceptionLineNumber();
-        qDebug() << "Uncaught exception at (" << _fileNameString << ") line" << line << ":" << result.toString();
-        emit errorMessage("Uncaught exception at (" + _fileNameString + ") line" + QString::number(line) + ":" + result.toString());
-        clearExceptions();
+void ScriptEngine::runTogether(const QList<ScriptEngine*>& engines) {
+    QList<ScriptEngine*> running;
+    foreach (ScriptEngine* engine, engines) {
+        engine->startRunning();
+        running.append(engine);
     }
 
     QElapsedTimer startTime;
@@ -349,29 +405,17 @@ void ScriptEngine::run() {
 
     int thisFrame = 0;
 
-    auto nodeList = DependencyManager::get<NodeList>();
-
-    qint64 lastUpdate = usecTimestampNow();
-
-    while (!_isFinished) {
+    while (!running.isEmpty()) {
         int usecToSleep = (thisFrame++ * SCRIPT_DATA_CALLBACK_USECS) - startTime.nsecsElapsed() / 1000; // nsec to usec
         if (usecToSleep > 0) {
             usleep(usecToSleep);
         }
 
-        if (_isFinished) {
-            break;
-        }
-
         QCoreApplication::processEvents();
 
-        if (_isFinished) {
-            break;
-        }
-
         if (_entityScriptingInterface.getEntityPacketSender()->serversExist()) {
-            // release the queue of edit entity messages.
-            _entityScriptingInterface.getEntityPacketSender()->releaseQueuedMessages();
+            // release the edit entity messages that have waited long enough, the rest keep filling their packets
+            _entityScriptingInterface.getEntityPacketSender()->releaseStaleQueuedMessages();
 
             // since we're in non-threaded mode, call process so that the packets are sent
             if (!_entityScriptingInterface.getEntityPacketSender()->isThreaded()) {
@@ -379,121 +423,195 @@ void ScriptEngine::run() {
             }
         }
 
-        if (_isAvatar && _avatarData) {
+        // the engines share the frame in turn, each one that has been stopped wrapping up in its place
+        for (QList<ScriptEngine*>::iterator it = running.begin(); it != running.end(); ) {
+            ScriptEngine* engine = *it;
+            if (engine->_isFinished) {
+                engine->finishRunning();
+                it = running.erase(it);
+            } else {
+                engine->runFrame();
+                it++;
+            }
+        }
+    }
+}
 
-            const int SCRIPT_AUDIO_BUFFER_SAMPLES = floor(((SCRIPT_DATA_CALLBACK_USECS * AudioConstants::SAMPLE_RATE)
-                                                           / (1000 * 1000)) + 0.5);
-            const int SCRIPT_AUDIO_BUFFER_BYTES = SCRIPT_AUDIO_BUFFER_SAMPLES * sizeof(int16_t);
+void ScriptEngine::startRunning() {
+    if (!_isInitialized) {
+        init();
+    }
+    _isRunning = true;
+    _isFinished = false;
+    emit runningStateChanged();
+
+    QScriptValue result;
+    {
+        ScriptCallbackTimer timer(_profile, "load");
+        result = evaluate(_scriptContents);
+    }
+    if (hasUncaughtException()) {
+        int line = uncaughtExceptionLineNumber();
+        qDebug() << "Uncaught exception at (" << _fileNameString << ") line" << line << ":" << result.toString();
+        emit errorMessage("Uncaught exception at (" + _fileNameString + ") line" + QString::number(line) + ":" + result.toString());
+        clearExceptions();
+    }
 
-            QByteArray avatarPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarData);
-            avatarPacket.append(_avatarData->toByteArray());
+    _lastUpdate = usecTimestampNow();
 
-            nodeList->broadcastToNodes(avatarPacket, NodeSet() << NodeType::AvatarMixer);
+    // the frame loop fires the timers from here on
+    if (_timerWheelTimer) {
+        _timerWheelTimer->stop();
+    }
+}
 
-            if (_isListeningToAudioStream || _avatarSound) {
-                // if we have an avatar audio stream then send it out to our audio-mixer
-                bool silentFrame = true;
+void ScriptEngine::runFrame() {
+    if (_isAvatar && _avatarData) {
+        sendAvatarFrame();
+    }
 
-                int16_t numAvailableSamples = SCRIPT_AUDIO_BUFFER_SAMPLES;
-                const int16_t* nextSoundOutput = NULL;
+    fireTimers();
 
-                if (_avatarSound) {
+    qint64 now = usecTimestampNow();
+    float deltaTime = (float) (now - _lastUpdate) / (float) USECS_PER_SECOND;
 
-                    const QByteArray& soundByteArray = _avatarSound->getByteArray();
-                    nextSoundOutput = reinterpret_cast<const int16_t*>(soundByteArray.data()
-                                                                       + _numAvatarSoundSentBytes);
+    if (hasUncaughtException()) {
+        int line = uncaughtExceptionLineNumber();
+        qDebug() << "Uncaught exception at (" << _fileNameString << ") line" << line << ":" << uncaughtException().toString();
+        emit errorMessage("Uncaught exception at (" + _fileNameString + ") line" + QString::number(line) + ":" + uncaughtException().toString());
+        clearExceptions();
+    }
 
-                    int numAvailableBytes = (soundByteArray.size() - _numAvatarSoundSentBytes) > SCRIPT_AUDIO_BUFFER_BYTES
-                        ? SCRIPT_AUDIO_BUFFER_BYTES
-                        : soundByteArray.size() - _numAvatarSoundSentBytes;
-                    numAvailableSamples = numAvailableBytes / sizeof(int16_t);
+    {
+        ScriptCallbackTimer timer(_profile, "update");
+        emit update(deltaTime);
+    }
+    _lastUpdate = now;
+}
 
+void ScriptEngine::sendAvatarFrame() {
+    auto nodeList = DependencyManager::get<NodeList>();
 
-                    // check if the all of the _numAvatarAudioBufferSamples to be sent are silence
-                    for (int i = 0; i < numAvailableSamples; ++i) {
-                        if (nextSoundOutput[i] != 0) {
-                            silentFrame = false;
-                            break;
-                        }
-                    }
+    const int SCRIPT_AUDIO_BUFFER_SAMPLES = floor(((SCRIPT_DATA_CALLBACK_USECS * AudioConstants::SAMPLE_RATE)
+                                                   / (1000 * 1000)) + 0.5);
+    const int SCRIPT_AUDIO_BUFFER_BYTES = SCRIPT_AUDIO_BUFFER_SAMPLES * sizeof(int16_t);
 
-                    _numAvatarSoundSentBytes += numAvailableBytes;
-                    if (_numAvatarSoundSentBytes == soundByteArray.size()) {
-                        // we're done with this sound object - so set our pointer back to NULL
-                        // and our sent bytes back to zero
-                        _avatarSound = NULL;
-                        _numAvatarSoundSentBytes = 0;
-                    }
-                }
-                
-                QByteArray audioPacket = byteArrayWithPopulatedHeader(silentFrame
-                                                                      ? PacketTypeSilentAudioFrame
-                                                                      : PacketTypeMicrophoneAudioNoEcho);
+    // the packets are built in buffers we keep, which hold on to their capacity between frames
+    if (_avatarPacket.capacity() < MAX_PACKET_SIZE) {
+        _avatarPacket.reserve(MAX_PACKET_SIZE);
+        _audioPacket.reserve(MAX_PACKET_SIZE);
+    }
 
-                QDataStream packetStream(&audioPacket, QIODevice::Append);
+    // an avatar that hasn't changed since its last packet only sends it again now and then, to keep the mixer's copy
+    // from going stale
+    QByteArray avatarByteArray = _avatarData->toByteArray();
+    int avatarHeaderBytes = numBytesForPacketHeaderGivenPacketType(PacketTypeAvatarData);
+    bool avatarChanged = _avatarPacket.size() != avatarHeaderBytes + avatarByteArray.size() ||
+        memcmp(_avatarPacket.constData() + avatarHeaderBytes, avatarByteArray.constData(), avatarByteArray.size()) != 0;
+    quint64 now = usecTimestampNow();
+    if (avatarChanged || now - _lastAvatarPacketSent >= AVATAR_KEEP_ALIVE_USECS) {
+        _avatarPacket.resize(populatePacketHeader(_avatarPacket, PacketTypeAvatarData));
+        _avatarPacket.append(avatarByteArray);
+
+        nodeList->broadcastToNodes(_avatarPacket, NodeSet() << NodeType::AvatarMixer);
+        _lastAvatarPacketSent = now;
+    }
 
-                // pack a placeholder value for sequence number for now, will be packed when destination node is known
-                int numPreSequenceNumberBytes = audioPacket.size();
-                packetStream << (quint16) 0;
+    if (_isListeningToAudioStream || _avatarSound) {
+        // if we have an avatar audio stream then send it out to our audio-mixer
+        bool silentFrame = true;
 
-                if (silentFrame) {
-                    if (!_isListeningToAudioStream) {
-                        // if we have a silent frame and we're not listening then just send nothing and break out of here
-                        break;
-                    }
+        int16_t numAvailableSamples = SCRIPT_AUDIO_BUFFER_SAMPLES;
+        const int16_t* nextSoundOutput = NULL;
 
-                    // write the number of silent samples so the audio-mixer can uphold timing
-                    packetStream.writeRawData(reinterpret_cast<const char*>(&SCRIPT_AUDIO_BUFFER_SAMPLES), sizeof(int16_t));
+        if (_avatarSound) {
 
-                    // use the orientation and position of this avatar for the source of this audio
-                    packetStream.writeRawData(reinterpret_cast<const char*>(&_avatarData->getPosition()), sizeof(glm::vec3));
-                    glm::quat headOrientation = _avatarData->getHeadOrientation();
-                    packetStream.writeRawData(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
+            const QByteArray& soundByteArray = _avatarSound->getByteArray();
+            nextSoundOutput = reinterpret_cast<const int16_t*>(soundByteArray.data()
+                                                               + _numAvatarSoundSentBytes);
 
-                } else if (nextSoundOutput) {
-                    // assume scripted avatar audio is mono and set channel flag to zero
-                    packetStream << (quint8)0;
+            int numAvailableBytes = (soundByteArray.size() - _numAvatarSoundSentBytes) > SCRIPT_AUDIO_BUFFER_BYTES
+                ? SCRIPT_AUDIO_BUFFER_BYTES
+                : soundByteArray.size() - _numAvatarSoundSentBytes;
+            numAvailableSamples = numAvailableBytes / sizeof(int16_t);
 
-                    // use the orientation and position of this avatar for the source of this audio
-                    packetStream.writeRawData(reinterpret_cast<const char*>(&_avatarData->getPosition()), sizeof(glm::vec3));
-                    glm::quat headOrientation = _avatarData->getHeadOrientation();
-                    packetStream.writeRawData(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
 
-                    // write the raw audio data
-                    packetStream.writeRawData(reinterpret_cast<const char*>(nextSoundOutput), numAvailableSamples * sizeof(int16_t));
+            // check if the all of the _numAvatarAudioBufferSamples to be sent are silence
+            for (int i = 0; i < numAvailableSamples; ++i) {
+                if (nextSoundOutput[i] != 0) {
+                    silentFrame = false;
+                    break;
                 }
-                
-                // write audio packet to AudioMixer nodes
-                auto nodeList = DependencyManager::get<NodeList>();
-                nodeList->eachNode([this, &nodeList, &audioPacket, &numPreSequenceNumberBytes](const SharedNodePointer& node){
-                    // only send to nodes of type AudioMixer
-                    if (node->getType() == NodeType::AudioMixer) {
-                        // pack sequence number
-                        quint16 sequence = _outgoingScriptAudioSequenceNumbers[node->getUUID()]++;
-                        memcpy(audioPacket.data() + numPreSequenceNumberBytes, &sequence, sizeof(quint16));
-                        
-                        // send audio packet
-                        nodeList->writeDatagram(audioPacket, node);
-                    }
-                });
             }
-        }
 
-        qint64 now = usecTimestampNow();
-        float deltaTime = (float) (now - lastUpdate) / (float) USECS_PER_SECOND;
+            _numAvatarSoundSentBytes += numAvailableBytes;
+            if (_numAvatarSoundSentBytes == soundByteArray.size()) {
+                // we're done with this sound object - so set our pointer back to NULL
+                // and our sent bytes back to zero
+                _avatarSound = NULL;
+                _numAvatarSoundSentBytes = 0;
+            }
+        }
 
-        if (hasUncaughtException()) {
-            int line = uncaughtExceptionLineNumber();
-            qDebug() << "Uncaught exception at (" << _fileNameString << ") line" << line << ":" << uncaughtException().toString();
-            emit errorMessage("Uncaught exception at (" + _fileNameString + ") line" + QString::number(line) + ":" + uncaughtException().toString());
-            clearExceptions();
+        if (silentFrame && !_isListeningToAudioStream) {
+            // if we have a silent frame and we're not listening then just send nothing this frame
+            return;
         }
 
-        emit update(deltaTime);
-        lastUpdate = now;
+        _audioPacket.resize(populatePacketHeader(_audioPacket, silentFrame
+                                                 ? PacketTypeSilentAudioFrame
+                                                 : PacketTypeMicrophoneAudioNoEcho));
+
+        // pack a placeholder value for sequence number for now, will be packed when destination node is known
+        int numPreSequenceNumberBytes = _audioPacket.size();
+        quint16 sequencePlaceholder = 0;
+        _audioPacket.append(reinterpret_cast<const char*>(&sequencePlaceholder), sizeof(quint16));
+
+        glm::quat headOrientation = _avatarData->getHeadOrientation();
+        if (silentFrame) {
+            // write the number of silent samples so the audio-mixer can uphold timing
+            _audioPacket.append(reinterpret_cast<const char*>(&SCRIPT_AUDIO_BUFFER_SAMPLES), sizeof(int16_t));
+
+            // use the orientation and position of this avatar for the source of this audio
+            _audioPacket.append(reinterpret_cast<const char*>(&_avatarData->getPosition()), sizeof(glm::vec3));
+            _audioPacket.append(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
+
+        } else {
+            // assume scripted avatar audio is mono and set channel flag to zero
+            _audioPacket.append((char)0);
+
+            // scripted avatar audio is sent raw, the last buffer of a sound can have an odd number of samples
+            _audioPacket.append((char)AudioCodec::PCM);
+
+            // use the orientation and position of this avatar for the source of this audio
+            _audioPacket.append(reinterpret_cast<const char*>(&_avatarData->getPosition()), sizeof(glm::vec3));
+            _audioPacket.append(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
+
+            // write the raw audio data
+            _audioPacket.append(reinterpret_cast<const char*>(nextSoundOutput), numAvailableSamples * sizeof(int16_t));
+        }
+        
+        // write audio packet to AudioMixer nodes
+        nodeList->eachNode([this, &nodeList, &numPreSequenceNumberBytes](const SharedNodePointer& node){
+            // only send to nodes of type AudioMixer
+            if (node->getType() == NodeType::AudioMixer) {
+                // pack sequence number
+                quint16 sequence = _outgoingScriptAudioSequenceNumbers[node->getUUID()]++;
+                memcpy(_audioPacket.data() + numPreSequenceNumberBytes, &sequence, sizeof(quint16));
+                
+                // send audio packet, hashing it for the mixer in our own buffer
+                nodeList->writeDatagramInPlace(_audioPacket, node);
+            }
+        });
     }
+}
+
+void ScriptEngine::finishRunning() {
     emit scriptEnding();
 
+    // the timers stop with the script
+    _timers.clear();
+
     // kill the avatar identity timer
     delete _avatarIdentityTimer;
 
@@ -507,11 +625,6 @@ void ScriptEngine::run() {
         }
     }
 
-    // If we were on a thread, then wait till it's done
-    if (thread()) {
-        thread()->quit();
-    }
-
     emit finished(_fileNameString);
 
     _isRunning = false;
@@ -523,51 +636,80 @@ void ScriptEngine::stop() {
     emit runningStateChanged();
 }
 
-void ScriptEngine::timerFired() {
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    QScriptValue timerFunction = _timerFunctionMap.value(callingTimer);
-    
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
+void ScriptEngine::fireTimers() {
+    quint64 now = usecTimestampNow();
+    QVector<int> dueTimerIDs;
+    _timerWheel.advance(now, dueTimerIDs);
+
+    foreach (int timerID, dueTimerIDs) {
+        QHash<int, ScriptTimer>::iterator timer = _timers.find(timerID);
+        if (timer == _timers.end()) {
+            continue; // cleared since it was scheduled
+        }
+        QScriptValue function = timer.value().function;
+        if (timer.value().isSingleShot) {
+            _timers.erase(timer);
+        } else {
+            // keep to the interval's schedule, unless we've fallen a whole interval behind it
+            timer.value().due = qMax(timer.value().due + timer.value().intervalUsecs, now + 1);
+            _timerWheel.schedule(timerID, timer.value().due);
+        }
+        // the function may set and clear timers of its own, so it's called once we're done with the iterator
+        if (function.isValid()) {
+            ScriptCallbackTimer timer(_profile, "timer");
+            function.call();
+        }
     }
-    
-    // call the associated JS function, if it exists
-    if (timerFunction.isValid()) {
-        timerFunction.call();
+
+    if (_timers.isEmpty() && _timerWheelTimer) {
+        _timerWheelTimer->stop();
     }
 }
 
-QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
-
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+int ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
+    int timerID = _nextTimerID++;
+    ScriptTimer timer = { function, (quint64)qMax(intervalMS, 0) * USECS_PER_MSEC, isSingleShot, 0 };
+    timer.due = usecTimestampNow() + timer.intervalUsecs;
+    _timers.insert(timerID, timer);
+    _timerWheel.schedule(timerID, timer.due);
 
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
-
-    _timerFunctionMap.insert(newTimer, function);
-
-    newTimer->start(intervalMS);
-    return newTimer;
+    // without a frame loop to fire them, the timers are driven by one timer of our own
+    if (!_isRunning) {
+        if (!_timerWheelTimer) {
+            _timerWheelTimer = new QTimer(this);
+            connect(_timerWheelTimer, &QTimer::timeout, this, &ScriptEngine::fireTimers);
+        }
+        if (!_timerWheelTimer->isActive()) {
+            _timerWheelTimer->start(TIMER_WHEEL_TIMER_INTERVAL_MSECS);
+        }
+    }
+    return timerID;
 }
 
-QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
+int ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
     return setupTimerWithInterval(function, intervalMS, false);
 }
 
-QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
+int ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
-        delete timer;
+void ScriptEngine::stopTimer(int timerID) {
+    // its entry stays in the wheel until it comes due, and is skipped then
+    _timers.remove(timerID);
+}
+
+void ScriptEngine::setProfilingNativeCalls(bool profiling) {
+    if (profiling == (_profileAgent != NULL)) {
+        return;
+    }
+    if (profiling) {
+        _profileAgent = new ScriptProfileAgent(this, _profile);
+        setAgent(_profileAgent);
+    } else {
+        setAgent(NULL);
+        delete _profileAgent;
+        _profileAgent = NULL;
     }
 }
 
@@ -620,7 +762,7 @@ void ScriptEngine::include(const QStringList& includeFiles, QScriptValue callbac
             if (contents.isNull()) {
                 qDebug() << "Error loading file: " << url;
             } else {
-                QScriptValue result = evaluate(contents, url.toString());
+                QScriptValue result = evaluateProgram(contents, url.toString());
             }
         }
 
@@ -15,18 +15,23 @@
 #include <vector>
 
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QUrl>
 #include <QtScript/QScriptEngine>
+#include <QtScript/QScriptProgram>
 
 #include <AnimationCache.h>
 #include <AudioScriptingInterface.h>
 #include <AvatarData.h>
 #include <AvatarHashMap.h>
 #include <LimitedNodeList.h>
+#include <TimerWheel.h>
 
 #include "AbstractControllerScriptingInterface.h"
 #include "ArrayBufferClass.h"
 #include "Quat.h"
+#include "ScriptMath.h"
+#include "ScriptProfile.h"
 #include "ScriptUUID.h"
 #include "Vec3.h"
 
@@ -52,6 +57,7 @@ public:
     bool setScriptContents(const QString& scriptContents, const QString& fileNameString = QString(""));
 
     const QString& getScriptName() const { return _scriptName; }
+    const QString& getFileName() const { return _fileNameString; }
     void cleanupMenuItems();
 
     QScriptValue registerGlobalObject(const QString& name, QObject* object); /// registers a global object by name
@@ -73,9 +79,19 @@ public:
 
     void init();
     void run(); /// runs continuously until Agent.stop() is called
+
+    /// Runs the engines on the calling thread until all of them have been stopped, sharing one frame timer between
+    /// them: each frame, every engine sends its avatar data and gets its update in turn.  The engines' timers and
+    /// callbacks fire from the event processing between frames.
+    static void runTogether(const QList<ScriptEngine*>& engines);
     void evaluate(); /// initializes the engine, and evaluates the script, but then returns control to caller
 
-    void timerFired();
+    /// Evaluates script contents through this engine's cache of parsed programs, so that contents evaluated again,
+    /// like an entity script that many entities share, aren't parsed again.
+    QScriptValue evaluateProgram(const QString& contents, const QString& fileName = QString());
+
+    /// Checks whether the contents have been parsed by evaluateProgram.
+    bool hasProgram(const QString& contents, const QString& fileName = QString()) const;
 
     bool hasScript() const { return !_scriptContents.isEmpty(); }
 
@@ -87,21 +103,27 @@ public:
 
     void setParentURL(const QString& parentURL) { _parentURL = parentURL;  }
 
+    /// The time spent in the script's update, timer and entity script callbacks.
+    ScriptProfile& getProfile() { return _profile; }
+
 public slots:
     void loadURL(const QUrl& scriptURL);
     void stop();
 
     QScriptValue evaluate(const QString& program, const QString& fileName = QString(), int lineNumber = 1);
-    QObject* setInterval(const QScriptValue& function, int intervalMS);
-    QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    int setInterval(const QScriptValue& function, int intervalMS);
+    int setTimeout(const QScriptValue& function, int timeoutMS);
+    void clearInterval(int timerID) { stopTimer(timerID); }
+    void clearTimeout(int timerID) { stopTimer(timerID); }
     void include(const QStringList& includeFiles, QScriptValue callback = QScriptValue());
     void include(const QString& includeFile, QScriptValue callback = QScriptValue());
     void load(const QString& loadfile);
     void print(const QString& message);
     QUrl resolvePath(const QString& path) const;
 
+    /// Starts or stops counting the script's calls into native functions, which slows the script while it's on.
+    void setProfilingNativeCalls(bool profiling);
+
     void nodeKilled(SharedNodePointer node);
 
 signals:
@@ -126,17 +148,40 @@ protected:
     bool _isAvatar;
     QTimer* _avatarIdentityTimer;
     QTimer* _avatarBillboardTimer;
-    QHash<QTimer*, QScriptValue> _timerFunctionMap;
+
+    class ScriptTimer {
+    public:
+        QScriptValue function;
+        quint64 intervalUsecs;
+        bool isSingleShot;
+        quint64 due;
+    };
+
+    /// the script's timers, which come due in the wheel and fire from the frame loop, or from _timerWheelTimer when
+    /// the engine only evaluates and has no frame loop
+    QHash<int, ScriptTimer> _timers;
+    TimerWheel _timerWheel;
+    int _nextTimerID;
+    QTimer* _timerWheelTimer;
     bool _isListeningToAudioStream;
     Sound* _avatarSound;
     int _numAvatarSoundSentBytes;
+    QByteArray _avatarPacket; ///< the last avatar data packet sent, whose buffer the next one is built in
+    quint64 _lastAvatarPacketSent;
+    QByteArray _audioPacket;
 
 private:
+    void startRunning();
+    void runFrame();
+    void sendAvatarFrame();
+    void finishRunning();
+
     void sendAvatarIdentityPacket();
     void sendAvatarBillboardPacket();
 
-    QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    int setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
+    void stopTimer(int timerID);
+    void fireTimers();
 
     static EntityScriptingInterface _entityScriptingInterface;
 
@@ -144,14 +189,21 @@ private:
     AvatarData* _avatarData;
     QString _scriptName;
     QString _fileNameString;
-    Quat _quatLibrary;
-    Vec3 _vec3Library;
+    qint64 _lastUpdate;
+    ScriptMath _math; ///< what the native Quat and Vec3 functions read and make their values with
     ScriptUUID _uuidLibrary;
     bool _isUserLoaded;
 
     ArrayBufferClass* _arrayBufferClass;
 
     QHash<QUuid, quint16> _outgoingScriptAudioSequenceNumbers;
+
+    /// parsed programs by file name and contents; a program is tied to the engine that first runs it, so each engine
+    /// keeps its own
+    QHash<QPair<QString, QString>, QScriptProgram> _programs;
+
+    ScriptProfile _profile;
+    ScriptProfileAgent* _profileAgent;
 private slots:
     void handleScriptDownload();
 };
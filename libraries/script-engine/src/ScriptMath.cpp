@@ -0,0 +1,90 @@
+//
+//  ScriptMath.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QVariant>
+
+#include "ScriptMath.h"
+
+static float toComponent(const QScriptValue& value) {
+    return value.isNumber() ? (float)value.toNumber() : value.toVariant().toFloat();
+}
+
+ScriptMath::ScriptMath(QScriptEngine* engine) :
+    _engine(engine),
+    _x(engine->toStringHandle("x")),
+    _y(engine->toStringHandle("y")),
+    _z(engine->toStringHandle("z")),
+    _w(engine->toStringHandle("w")),
+    _length(engine->toStringHandle("length")) {
+}
+
+glm::vec3 ScriptMath::toVec3(const QScriptValue& value) const {
+    return glm::vec3(toComponent(value.property(_x)), toComponent(value.property(_y)),
+        toComponent(value.property(_z)));
+}
+
+glm::quat ScriptMath::toQuat(const QScriptValue& value) const {
+    return glm::quat(toComponent(value.property(_w)), toComponent(value.property(_x)),
+        toComponent(value.property(_y)), toComponent(value.property(_z)));
+}
+
+QScriptValue ScriptMath::fromVec3(const glm::vec3& vec3) const {
+    QScriptValue object = _engine->newObject();
+    object.setProperty(_x, vec3.x);
+    object.setProperty(_y, vec3.y);
+    object.setProperty(_z, vec3.z);
+    return object;
+}
+
+QScriptValue ScriptMath::fromQuat(const glm::quat& quat) const {
+    QScriptValue object = _engine->newObject();
+    object.setProperty(_x, quat.x);
+    object.setProperty(_y, quat.y);
+    object.setProperty(_z, quat.z);
+    object.setProperty(_w, quat.w);
+    return object;
+}
+
+QVector<glm::vec3> ScriptMath::toVec3Array(const QScriptValue& value) const {
+    QVector<glm::vec3> vectors(value.property(_length).toInt32());
+    for (int i = 0; i < vectors.size(); i++) {
+        vectors[i] = toVec3(value.property(i));
+    }
+    return vectors;
+}
+
+QVector<glm::quat> ScriptMath::toQuatArray(const QScriptValue& value) const {
+    QVector<glm::quat> quats(value.property(_length).toInt32());
+    for (int i = 0; i < quats.size(); i++) {
+        quats[i] = toQuat(value.property(i));
+    }
+    return quats;
+}
+
+QScriptValue ScriptMath::fromVec3Array(const QVector<glm::vec3>& vectors) const {
+    QScriptValue array = _engine->newArray(vectors.size());
+    for (int i = 0; i < vectors.size(); i++) {
+        array.setProperty(i, fromVec3(vectors.at(i)));
+    }
+    return array;
+}
+
+QScriptValue ScriptMath::fromQuatArray(const QVector<glm::quat>& quats) const {
+    QScriptValue array = _engine->newArray(quats.size());
+    for (int i = 0; i < quats.size(); i++) {
+        array.setProperty(i, fromQuat(quats.at(i)));
+    }
+    return array;
+}
+
+void ScriptMath::addFunction(QScriptValue object, const QString& name,
+        QScriptEngine::FunctionWithArgSignature function) {
+    object.setProperty(name, _engine->newFunction(function, this));
+}
@@ -0,0 +1,62 @@
+//
+//  ScriptMath.h
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptMath_h
+#define hifi_ScriptMath_h
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <QVector>
+#include <QtScript/QScriptContext>
+#include <QtScript/QScriptEngine>
+#include <QtScript/QScriptString>
+#include <QtScript/QScriptValue>
+
+/// Unpacks and packs the script values of vectors and quaternions for the Vec3 and Quat native functions.  The
+/// component names are looked up once per engine, and numeric components are read as they are, where the registered
+/// meta types look up each name and go through a QVariant for each component.  Components that are missing, or
+/// aren't numbers, convert as they do through the meta types.
+class ScriptMath {
+public:
+    ScriptMath(QScriptEngine* engine);
+
+    QScriptEngine* getEngine() const { return _engine; }
+
+    glm::vec3 toVec3(const QScriptValue& value) const;
+    glm::quat toQuat(const QScriptValue& value) const;
+
+    QScriptValue fromVec3(const glm::vec3& vec3) const;
+    QScriptValue fromQuat(const glm::quat& quat) const;
+
+    /// Reads an array of vectors, or of quaternions.
+    QVector<glm::vec3> toVec3Array(const QScriptValue& value) const;
+    QVector<glm::quat> toQuatArray(const QScriptValue& value) const;
+
+    QScriptValue fromVec3Array(const QVector<glm::vec3>& vectors) const;
+    QScriptValue fromQuatArray(const QVector<glm::quat>& quats) const;
+
+    /// Adds a native function to an object, which it's called with this as its argument.
+    void addFunction(QScriptValue object, const QString& name, QScriptEngine::FunctionWithArgSignature function);
+
+private:
+
+    QScriptEngine* _engine;
+    QScriptString _x;
+    QScriptString _y;
+    QScriptString _z;
+    QScriptString _w;
+    QScriptString _length;
+};
+
+/// Gets the ScriptMath a native function was added with.
+inline const ScriptMath& getScriptMath(void* arg) { return *static_cast<const ScriptMath*>(arg); }
+
+#endif // hifi_ScriptMath_h
@@ -0,0 +1,118 @@
+//
+//  ScriptProfile.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QMutexLocker>
+#include <QPair>
+#include <QStringList>
+#include <QtAlgorithms>
+
+#include "ScriptProfile.h"
+
+ScriptProfile::ScriptProfile() :
+    _startTime(usecTimestampNow()) {
+}
+
+void ScriptProfile::record(const QString& callback, quint64 usecs) {
+    QMutexLocker locker(&_mutex);
+    CallbackStats& stats = _callbackStats[callback];
+    stats.calls++;
+    stats.totalUsecs += usecs;
+    stats.maxUsecs = qMax(stats.maxUsecs, usecs);
+}
+
+QHash<QString, ScriptProfile::CallbackStats> ScriptProfile::getCallbackStats() const {
+    QMutexLocker locker(&_mutex);
+    return _callbackStats;
+}
+
+quint64 ScriptProfile::getStartTime() const {
+    QMutexLocker locker(&_mutex);
+    return _startTime;
+}
+
+quint64 ScriptProfile::getTotalUsecs() const {
+    QMutexLocker locker(&_mutex);
+    quint64 totalUsecs = 0;
+    foreach (const CallbackStats& stats, _callbackStats) {
+        totalUsecs += stats.totalUsecs;
+    }
+    return totalUsecs;
+}
+
+static bool isBusier(const QPair<quint64, QString>& first, const QPair<quint64, QString>& second) {
+    return first.first > second.first;
+}
+
+QString ScriptProfile::getSummary(int maxCallbacks) const {
+    QMutexLocker locker(&_mutex);
+    float elapsedUsecs = qMax(usecTimestampNow() - _startTime, (quint64)1);
+    QList<QPair<quint64, QString> > busiest;
+    quint64 totalUsecs = 0;
+    for (QHash<QString, CallbackStats>::const_iterator it = _callbackStats.constBegin();
+            it != _callbackStats.constEnd(); it++) {
+        busiest.append(qMakePair(it.value().totalUsecs, it.key()));
+        totalUsecs += it.value().totalUsecs;
+    }
+    qSort(busiest.begin(), busiest.end(), isBusier);
+
+    const float PERCENT = 100.0f;
+    QString summary = QString("%1%").arg(totalUsecs * PERCENT / elapsedUsecs, 0, 'f', 1);
+    QStringList callbacks;
+    for (int i = 0; i < qMin(maxCallbacks, busiest.size()); i++) {
+        callbacks.append(QString("%1 %2%").arg(busiest.at(i).second)
+            .arg(busiest.at(i).first * PERCENT / elapsedUsecs, 0, 'f', 1));
+    }
+    if (!callbacks.isEmpty()) {
+        summary += " (" + callbacks.join(", ") + ")";
+    }
+    int nativeCalls = _nativeCalls.load();
+    if (nativeCalls > 0) {
+        summary += QString(", %1 native calls").arg(nativeCalls);
+    }
+    return summary;
+}
+
+QJsonObject ScriptProfile::toJson() const {
+    QMutexLocker locker(&_mutex);
+    QJsonObject callbacks;
+    for (QHash<QString, CallbackStats>::const_iterator it = _callbackStats.constBegin();
+            it != _callbackStats.constEnd(); it++) {
+        QJsonObject stats;
+        stats["calls"] = it.value().calls;
+        stats["total_usecs"] = (double)it.value().totalUsecs;
+        stats["max_usecs"] = (double)it.value().maxUsecs;
+        callbacks[it.key()] = stats;
+    }
+    QJsonObject profile;
+    profile["elapsed_usecs"] = (double)(usecTimestampNow() - _startTime);
+    profile["callbacks"] = callbacks;
+    profile["native_calls"] = _nativeCalls.load();
+    return profile;
+}
+
+void ScriptProfile::reset() {
+    QMutexLocker locker(&_mutex);
+    _callbackStats.clear();
+    _nativeCalls.store(0);
+    _startTime = usecTimestampNow();
+}
+
+ScriptProfileAgent::ScriptProfileAgent(QScriptEngine* engine, ScriptProfile& profile) :
+    QScriptEngineAgent(engine),
+    _profile(profile) {
+}
+
+void ScriptProfileAgent::functionEntry(qint64 scriptId) {
+    // native functions have no script of their own
+    const qint64 NATIVE_SCRIPT_ID = -1;
+    if (scriptId == NATIVE_SCRIPT_ID) {
+        _profile.countNativeCall();
+    }
+}
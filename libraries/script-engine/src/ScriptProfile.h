@@ -0,0 +1,97 @@
+//
+//  ScriptProfile.h
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfile_h
+#define hifi_ScriptProfile_h
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QtScript/QScriptEngineAgent>
+
+#include <SharedUtil.h>
+
+/// The wall time a script has spent in each of its callbacks, by name.  The script's thread records, and any thread
+/// may read.
+class ScriptProfile {
+public:
+
+    class CallbackStats {
+    public:
+        CallbackStats() : calls(0), totalUsecs(0), maxUsecs(0) { }
+
+        int calls;
+        quint64 totalUsecs;
+        quint64 maxUsecs;
+    };
+
+    ScriptProfile();
+
+    void record(const QString& callback, quint64 usecs);
+
+    /// Counts a call from the script into a native function, which the ScriptProfileAgent makes when installed.
+    void countNativeCall() { _nativeCalls.ref(); }
+
+    QHash<QString, CallbackStats> getCallbackStats() const;
+    int getNativeCallCount() const { return _nativeCalls.load(); }
+
+    /// Returns when the profile started, or was last reset.
+    quint64 getStartTime() const;
+
+    /// Returns the time spent in all the callbacks.
+    quint64 getTotalUsecs() const;
+
+    /// Returns one line of the busiest callbacks' share of the time since the profile started.
+    QString getSummary(int maxCallbacks = 3) const;
+
+    /// Returns the callbacks' stats, with the time since the profile started, for a stats packet.
+    QJsonObject toJson() const;
+
+    void reset();
+
+private:
+
+    mutable QMutex _mutex;
+    QHash<QString, CallbackStats> _callbackStats;
+    QAtomicInt _nativeCalls;
+    quint64 _startTime;
+};
+
+/// Records the time from its construction to its destruction as a call of a callback.
+class ScriptCallbackTimer {
+public:
+    ScriptCallbackTimer(ScriptProfile& profile, const QString& callback) :
+        _profile(profile),
+        _callback(callback),
+        _start(usecTimestampNow()) { }
+
+    ~ScriptCallbackTimer() { _profile.record(_callback, usecTimestampNow() - _start); }
+
+private:
+    ScriptProfile& _profile;
+    QString _callback;
+    quint64 _start;
+};
+
+/// Counts a script's calls into native functions.  Installing an agent keeps the engine from compiling its scripts
+/// to native code, so the count is kept only on request.
+class ScriptProfileAgent : public QScriptEngineAgent {
+public:
+    ScriptProfileAgent(QScriptEngine* engine, ScriptProfile& profile);
+
+    virtual void functionEntry(qint64 scriptId);
+
+private:
+    ScriptProfile& _profile;
+};
+
+#endif // hifi_ScriptProfile_h
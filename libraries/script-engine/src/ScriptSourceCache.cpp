@@ -0,0 +1,78 @@
+//
+//  ScriptSourceCache.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QEventLoop>
+#include <QFile>
+#include <QMutexLocker>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTextStream>
+#include <QtDebug>
+
+#include <NetworkAccessManager.h>
+#include <SharedUtil.h>
+
+#include "ScriptSourceCache.h"
+
+ScriptSourceCache& ScriptSourceCache::getInstance() {
+    static ScriptSourceCache staticInstance;
+    return staticInstance;
+}
+
+QString ScriptSourceCache::getSource(const QUrl& url) const {
+    QMutexLocker locker(&_mutex);
+    return _sources.value(url);
+}
+
+void ScriptSourceCache::setSource(const QUrl& url, const QString& source) {
+    if (source.isNull()) {
+        return;
+    }
+    QMutexLocker locker(&_mutex);
+    _sources.insert(url, source);
+}
+
+QString ScriptSourceCache::loadSource(const QUrl& url) {
+    // local files are cheap to read and may be being edited, so they're read afresh
+    if (url.scheme() == "file") {
+        QFile scriptFile(url.toLocalFile());
+        if (!scriptFile.open(QFile::ReadOnly | QFile::Text)) {
+            qDebug() << "ERROR Loading file:" << url.toLocalFile();
+            return QString();
+        }
+        qDebug() << "Loading file:" << url.toLocalFile();
+        QTextStream in(&scriptFile);
+        return in.readAll();
+    }
+    QString source = getSource(url);
+    if (source.isNull()) {
+        QNetworkRequest networkRequest = QNetworkRequest(url);
+        networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
+        QNetworkReply* reply = NetworkAccessManager::get(networkRequest);
+        qDebug() << "Downloading script at" << url;
+        QEventLoop loop;
+        QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+        loop.exec();
+        if (reply->error() == QNetworkReply::NoError &&
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) == 200) {
+            source = reply->readAll();
+        } else {
+            qDebug() << "ERROR Loading file:" << url.toString();
+        }
+        delete reply;
+        setSource(url, source);
+    }
+    return source;
+}
+
+void ScriptSourceCache::clear() {
+    QMutexLocker locker(&_mutex);
+    _sources.clear();
+}
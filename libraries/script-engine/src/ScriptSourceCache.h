@@ -0,0 +1,46 @@
+//
+//  ScriptSourceCache.h
+//  libraries/script-engine/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptSourceCache_h
+#define hifi_ScriptSourceCache_h
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+
+/// The sources of the scripts downloaded so far, shared by every script engine in the process, so that a script run by
+/// many engines or on many entities is fetched once.  Downloads go through the shared network access manager, whose
+/// disk cache revalidates them with the server from one run to the next.
+class ScriptSourceCache {
+public:
+
+    static ScriptSourceCache& getInstance();
+
+    /// Returns the cached source of the script at the URL, or a null string if there is none.
+    QString getSource(const QUrl& url) const;
+
+    void setSource(const QUrl& url, const QString& source);
+
+    /// Returns the source of the script at the URL, reading or downloading it if it isn't cached and blocking until
+    /// it has been.
+    /// \return the source, or a null string if it couldn't be loaded
+    QString loadSource(const QUrl& url);
+
+    /// Forgets every source, for when the scripts are reloaded.
+    void clear();
+
+private:
+
+    mutable QMutex _mutex;
+    QHash<QUrl, QString> _sources;
+};
+
+#endif // hifi_ScriptSourceCache_h
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <string.h>
+
 #include <glm/glm.hpp>
 
 #include "ScriptEngine.h"
@@ -196,18 +198,16 @@ void TypedArray::setBytesPerElement(quint32 bytesPerElement) {
 }
 
 // templated helper functions
-// don't work for floats as they require single precision settings
+// elements are copied straight to and from the buffer in the platform's byte order, as typed arrays specify, so a
+// view over native data (decoded audio, a downloaded file) reads it in place; writing detaches a shared buffer first
 template<class T>
 QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
     bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        
+    if (ok && arrayBuffer && id + sizeof(T) <= (uint)arrayBuffer->size()) {
         T result;
-        stream >> result;
+        memcpy(&result, arrayBuffer->constData() + id, sizeof(T));
         return result;
     }
     return QScriptValue();
@@ -215,11 +215,9 @@ QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString&
 
 template<class T>
 void setPropertyHelper(QByteArray* arrayBuffer, const QScriptString& name, uint id, const QScriptValue& value) {
-    if (arrayBuffer && value.isNumber()) {
-        QDataStream stream(arrayBuffer, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        
-        stream << (T)value.toNumber();
+    if (arrayBuffer && value.isNumber() && id + sizeof(T) <= (uint)arrayBuffer->size()) {
+        T converted = (T)value.toNumber();
+        memcpy(arrayBuffer->data() + id, &converted, sizeof(T));
     }
 }
 
@@ -268,16 +266,8 @@ QScriptValue Uint8ClampedArrayClass::property(const QScriptValue& object, const
 void Uint8ClampedArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        if (value.toNumber() > 255) {
-            stream << (quint8)255;
-        } else if (value.toNumber() < 0) {
-            stream << (quint8)0;
-        } else {
-            stream << (quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
-        }
+    if (value.isNumber()) {
+        setPropertyHelper<quint8>(ba, name, id, QScriptValue(glm::clamp(qRound(value.toNumber()), 0, 255)));
     }
 }
 
@@ -351,20 +341,10 @@ Float32ArrayClass::Float32ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
-    name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        float result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    QScriptValue result = propertyHelper<float>(arrayBuffer, name, id);
+    if (result.isValid()) {
+        return isNaN(result.toNumber()) ? QScriptValue() : result;
     }
     return TypedArray::property(object, name, id);
 }
@@ -372,13 +352,7 @@ QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScri
 void Float32ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        stream << (float)value.toNumber();
-    }
+    setPropertyHelper<float>(ba, name, id, value);
 }
 
 Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(scriptEngine, FLOAT_64_ARRAY_CLASS_NAME) {
@@ -386,20 +360,10 @@ Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
-    name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        double result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    QScriptValue result = propertyHelper<double>(arrayBuffer, name, id);
+    if (result.isValid()) {
+        return isNaN(result.toNumber()) ? QScriptValue() : result;
     }
     return TypedArray::property(object, name, id);
 }
@@ -407,12 +371,6 @@ QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScri
 void Float64ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        stream << (double)value.toNumber();
-    }
+    setPropertyHelper<double>(ba, name, id, value);
 }
 
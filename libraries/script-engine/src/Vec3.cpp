@@ -13,62 +13,136 @@
 
 #include <QDebug>
 
+#include "ScriptMath.h"
 #include "Vec3.h"
 
-glm::vec3 Vec3::reflect(const glm::vec3& v1, const glm::vec3& v2) {
-    return glm::reflect(v1, v2);
+static QScriptValue reflect(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(glm::reflect(math.toVec3(context->argument(0)), math.toVec3(context->argument(1))));
 }
-glm::vec3 Vec3::cross(const glm::vec3& v1, const glm::vec3& v2) {
-    return glm::cross(v1,v2);
+
+static QScriptValue cross(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(glm::cross(math.toVec3(context->argument(0)), math.toVec3(context->argument(1))));
 }
 
-float Vec3::dot(const glm::vec3& v1, const glm::vec3& v2) {
-    return glm::dot(v1,v2);
+static QScriptValue dot(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return glm::dot(math.toVec3(context->argument(0)), math.toVec3(context->argument(1)));
 }
 
-glm::vec3 Vec3::multiply(const glm::vec3& v1, float f) {
-    return v1 * f;
+static QScriptValue multiply(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+
+    // the scale may come first or second
+    if (context->argument(0).isNumber()) {
+        return math.fromVec3(math.toVec3(context->argument(1)) * (float)context->argument(0).toNumber());
+    }
+    return math.fromVec3(math.toVec3(context->argument(0)) * (float)context->argument(1).toNumber());
 }
 
-glm::vec3 Vec3::multiply(float f, const glm::vec3& v1) {
-    return v1 * f;
+static QScriptValue multiplyQbyV(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toQuat(context->argument(0)) * math.toVec3(context->argument(1)));
 }
 
-glm::vec3 Vec3::multiplyQbyV(const glm::quat& q, const glm::vec3& v) {
-    return q * v;
+static QScriptValue sum(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toVec3(context->argument(0)) + math.toVec3(context->argument(1)));
 }
 
-glm::vec3 Vec3::sum(const glm::vec3& v1, const glm::vec3& v2) { 
-    return v1 + v2;
+static QScriptValue subtract(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(math.toVec3(context->argument(0)) - math.toVec3(context->argument(1)));
 }
-glm::vec3 Vec3::subtract(const glm::vec3& v1, const glm::vec3& v2) {
-    return v1 - v2;
+
+static QScriptValue length(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    return glm::length(getScriptMath(arg).toVec3(context->argument(0)));
+}
+
+static QScriptValue distance(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return glm::distance(math.toVec3(context->argument(0)), math.toVec3(context->argument(1)));
+}
+
+static QScriptValue orientedAngle(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return glm::degrees(glm::orientedAngle(glm::normalize(math.toVec3(context->argument(0))),
+        glm::normalize(math.toVec3(context->argument(1))), glm::normalize(math.toVec3(context->argument(2)))));
+}
+
+static QScriptValue normalize(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(glm::normalize(math.toVec3(context->argument(0))));
 }
 
-float Vec3::length(const glm::vec3& v) {
-    return glm::length(v);
+static QScriptValue mix(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.fromVec3(glm::mix(math.toVec3(context->argument(0)), math.toVec3(context->argument(1)),
+        (float)context->argument(2).toNumber()));
 }
 
-float Vec3::distance(const glm::vec3& v1, const glm::vec3& v2) {
-    return glm::distance(v1, v2);
+static QScriptValue print(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    glm::vec3 v = getScriptMath(arg).toVec3(context->argument(1));
+    qDebug() << qPrintable(context->argument(0).toString()) << v.x << "," << v.y << "," << v.z;
+    return QScriptValue();
 }
 
-float Vec3::orientedAngle(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3) {
-    return glm::degrees(glm::orientedAngle(glm::normalize(v1), glm::normalize(v2), glm::normalize(v3)));
+static QScriptValue equal(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    return math.toVec3(context->argument(0)) == math.toVec3(context->argument(1));
 }
 
-glm::vec3 Vec3::normalize(const glm::vec3& v) {
-    return glm::normalize(v);
+static QScriptValue sumArray(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    glm::vec3 total;
+    foreach (const glm::vec3& vector, math.toVec3Array(context->argument(0))) {
+        total += vector;
+    }
+    return math.fromVec3(total);
 }
 
-glm::vec3 Vec3::mix(const glm::vec3& v1, const glm::vec3& v2, float m) {
-    return glm::mix(v1, v2, m);
+static QScriptValue multiplyQbyVArray(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    glm::quat rotation = math.toQuat(context->argument(0));
+    QVector<glm::vec3> vectors = math.toVec3Array(context->argument(1));
+    for (int i = 0; i < vectors.size(); i++) {
+        vectors[i] = rotation * vectors.at(i);
+    }
+    return math.fromVec3Array(vectors);
 }
 
-void Vec3::print(const QString& lable, const glm::vec3& v) {
-    qDebug() << qPrintable(lable) << v.x << "," << v.y << "," << v.z;
+static QScriptValue mixArrays(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    const ScriptMath& math = getScriptMath(arg);
+    QVector<glm::vec3> vectors = math.toVec3Array(context->argument(0));
+    QVector<glm::vec3> others = math.toVec3Array(context->argument(1));
+    float m = context->argument(2).toNumber();
+    vectors.resize(qMin(vectors.size(), others.size()));
+    for (int i = 0; i < vectors.size(); i++) {
+        vectors[i] = glm::mix(vectors.at(i), others.at(i), m);
+    }
+    return math.fromVec3Array(vectors);
 }
 
-bool Vec3::equal(const glm::vec3& v1, const glm::vec3& v2) {
-    return v1 == v2;
+QScriptValue Vec3::createObject(ScriptMath& math) {
+    QScriptValue object = math.getEngine()->newObject();
+    math.addFunction(object, "reflect", reflect);
+    math.addFunction(object, "cross", cross);
+    math.addFunction(object, "dot", dot);
+    math.addFunction(object, "multiply", multiply);
+    math.addFunction(object, "multiplyQbyV", multiplyQbyV);
+    math.addFunction(object, "sum", sum);
+    math.addFunction(object, "subtract", subtract);
+    math.addFunction(object, "length", length);
+    math.addFunction(object, "distance", distance);
+    math.addFunction(object, "orientedAngle", orientedAngle);
+    math.addFunction(object, "normalize", normalize);
+    math.addFunction(object, "mix", mix);
+    math.addFunction(object, "print", print);
+    math.addFunction(object, "equal", equal);
+
+    math.addFunction(object, "sumArray", sumArray);
+    math.addFunction(object, "multiplyQbyVArray", multiplyQbyVArray);
+    math.addFunction(object, "mixArrays", mixArrays);
+    return object;
 }
@@ -14,34 +14,26 @@
 #ifndef hifi_Vec3_h
 #define hifi_Vec3_h
 
-#include <glm/glm.hpp>
-#include <glm/gtc/quaternion.hpp>
-
-#include <QObject>
-#include <QString>
-
-/// Scriptable interface a Vec3ernion helper class object. Used exclusively in the JavaScript API
-class Vec3 : public QObject {
-    Q_OBJECT
-
-public slots:
-    glm::vec3 reflect(const glm::vec3& v1, const glm::vec3& v2);
-    glm::vec3 cross(const glm::vec3& v1, const glm::vec3& v2);
-    float dot(const glm::vec3& v1, const glm::vec3& v2);
-    glm::vec3 multiply(const glm::vec3& v1, float f);
-    glm::vec3 multiply(float, const glm::vec3& v1);
-    glm::vec3 multiplyQbyV(const glm::quat& q, const glm::vec3& v);
-    glm::vec3 sum(const glm::vec3& v1, const glm::vec3& v2);
-    glm::vec3 subtract(const glm::vec3& v1, const glm::vec3& v2);
-    float length(const glm::vec3& v);
-    float distance(const glm::vec3& v1, const glm::vec3& v2);
-    float orientedAngle(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3);
-    glm::vec3 normalize(const glm::vec3& v);
-    glm::vec3 mix(const glm::vec3& v1, const glm::vec3& v2, float m);
-    void print(const QString& lable, const glm::vec3& v);
-    bool equal(const glm::vec3& v1, const glm::vec3& v2);
+#include <QtScript/QScriptValue>
+
+class ScriptMath;
+
+/// Scriptable interface to the vector helper functions. Used exclusively in the JavaScript API.  The functions are
+/// native, so that a call unpacks its arguments itself rather than going through a meta-call and the registered meta
+/// types, and the array ones do the work for a whole array in one call:
+///
+///     reflect(v1, v2), cross(v1, v2), dot(v1, v2), multiply(v, f) or multiply(f, v), multiplyQbyV(q, v), sum(v1, v2),
+///     subtract(v1, v2), length(v), distance(v1, v2), orientedAngle(v1, v2, v3), normalize(v), mix(v1, v2, m),
+///     print(label, v), equal(v1, v2)
+///
+///     sumArray(vectors): the sum of the vectors
+///     multiplyQbyVArray(q, vectors): each vector rotated by q
+///     mixArrays(vectors1, vectors2, m): each pair of vectors mixed, up to the length of the shorter array
+class Vec3 {
+public:
+
+    /// Creates the Vec3 object, whose functions read and make their values through the given math.
+    static QScriptValue createObject(ScriptMath& math);
 };
 
-
-
 #endif // hifi_Vec3_h
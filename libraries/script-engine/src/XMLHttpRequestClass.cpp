@@ -263,7 +263,11 @@ void XMLHttpRequestClass::send(const QScriptValue& data) {
 void XMLHttpRequestClass::doSend() {
     
     if (!_url.isLocalFile()) {
-        _reply = NetworkAccessManager::getInstance().sendCustomRequest(_request, _method.toLatin1(), _sendData);
+        if (_method.toUpper() == "GET") {
+            _reply = NetworkAccessManager::get(_request);
+        } else {
+            _reply = NetworkAccessManager::getInstance().sendCustomRequest(_request, _method.toLatin1(), _sendData);
+        }
         connectToReply(_reply);
     }
 
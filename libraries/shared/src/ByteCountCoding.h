@@ -20,8 +20,8 @@
 #include <cassert>
 #include <climits>
 #include <limits>
+#include <string.h>
 
-#include <QBitArray>
 #include <QByteArray>
 
 #include "SharedUtil.h"
@@ -39,6 +39,16 @@ public:
     QByteArray encode() const;
     void decode(const QByteArray& fromEncoded);
 
+    /// The most bytes that encode() can write for a value of this type.
+    static const int MAX_ENCODED_BYTES = sizeof(T) * BITS_IN_BYTE / (BITS_IN_BYTE - 1) + 1;
+
+    /// Encodes into a buffer of at least MAX_ENCODED_BYTES, returning the number of bytes written.
+    int encode(unsigned char* destination) const;
+
+    /// Decodes from the front of a buffer of the given length, returning the number of bytes the encoding takes up,
+    /// which may be more than the buffer holds if it was cut short, in which case the value is left zero.
+    int decode(const unsigned char* encodedBytes, int length);
+
     bool operator==(const ByteCountCoded& other) const { return data == other.data; }
     bool operator!=(const ByteCountCoded& other) const { return data != other.data; }
     bool operator!() const { return data == 0; }
@@ -56,106 +66,68 @@ template<typename T> inline QByteArray& operator>>(QByteArray& in, ByteCountCode
     return in;
 }
 
-template<typename T> inline QByteArray ByteCountCoded<T>::encode() const {
-    QByteArray output;
-
-    int totalBits = sizeof(data) * BITS_IN_BYTE;
-    int valueBits = totalBits;
-    bool firstValueFound = false;
-    T temp = data;
-    T lastBitMask = (T)(1) << (totalBits - 1);
-
+template<typename T> inline int ByteCountCoded<T>::encode(unsigned char* destination) const {
     // determine the number of bits that the value takes
-    for (int bitAt = 0; bitAt < totalBits; bitAt++) {
-        T bitValue = (temp & lastBitMask) == lastBitMask;
-        if (!firstValueFound) {
-            if (bitValue == 0) {
-                valueBits--;
-            } else {
-                firstValueFound = true;
-            }
-        }
-        temp = temp << 1;
+    int valueBits = 0;
+    for (T temp = data; temp != 0; temp = temp >> 1) {
+        valueBits++;
     }
-    
+
     // calculate the number of total bytes, including our header
     // BITS_IN_BYTE-1 because we need to code the number of bytes in the header
     // + 1 because we always take at least 1 byte, even if number of bits is less than a bytes worth
-    int numberOfBytes = (valueBits / (BITS_IN_BYTE - 1)) + 1; 
-
-    output.fill(0, numberOfBytes);
+    int numberOfBytes = (valueBits / (BITS_IN_BYTE - 1)) + 1;
+    memset(destination, 0, numberOfBytes);
 
     // next pack the number of header bits in, the first N-1 to be set to 1, the last to be set to 0
-    for(int i = 0; i < numberOfBytes; i++) {
-        int outputIndex = i;
-        T bitValue = (i < (numberOfBytes - 1)  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_IN_BYTE);
-        int shiftBy = BITS_IN_BYTE - ((outputIndex % BITS_IN_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_IN_BYTE] = (original | thisBit);
+    for (int i = 0; i < numberOfBytes - 1; i++) {
+        destination[i / BITS_IN_BYTE] |= (0x80 >> (i % BITS_IN_BYTE));
     }
 
-    // finally pack the the actual bits from the bit array
-    temp = data;
-    for(int i = numberOfBytes; i < (numberOfBytes + valueBits); i++) {
-        int outputIndex = i;
-        T bitValue = (temp & 1);
-        char original = output.at(outputIndex / BITS_IN_BYTE);
-        int shiftBy = BITS_IN_BYTE - ((outputIndex % BITS_IN_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_IN_BYTE] = (original | thisBit);
-
+    // finally pack the the actual bits of the value, lowest first
+    T temp = data;
+    for (int i = numberOfBytes; i < (numberOfBytes + valueBits); i++) {
+        if (temp & 1) {
+            destination[i / BITS_IN_BYTE] |= (0x80 >> (i % BITS_IN_BYTE));
+        }
         temp = temp >> 1;
     }
-    return output;
+    return numberOfBytes;
 }
 
-template<typename T> inline void ByteCountCoded<T>::decode(const QByteArray& fromEncodedBytes) {
-
-    // first convert the ByteArray into a BitArray...
-    QBitArray encodedBits;
-    int bitCount = BITS_IN_BYTE * fromEncodedBytes.count();
-    encodedBits.resize(bitCount);
-    
-    for(int byte = 0; byte < fromEncodedBytes.count(); byte++) {
-        char originalByte = fromEncodedBytes.at(byte);
-        for(int bit = 0; bit < BITS_IN_BYTE; bit++) {
-            int shiftBy = BITS_IN_BYTE - (bit + 1);
-            char maskBit = ( 1 << shiftBy);
-            bool bitValue = originalByte & maskBit;
-            encodedBits.setBit(byte * BITS_IN_BYTE + bit, bitValue);
-        }
+template<typename T> inline int ByteCountCoded<T>::decode(const unsigned char* encodedBytes, int length) {
+    // read the leading bits to determine the correct number of bytes to decode (may be fewer than we were given)
+    int bitCount = length * BITS_IN_BYTE;
+    int leadingOnes = 0;
+    while (leadingOnes < bitCount &&
+            (encodedBytes[leadingOnes / BITS_IN_BYTE] & (0x80 >> (leadingOnes % BITS_IN_BYTE)))) {
+        leadingOnes++;
     }
-    
-    // next, read the leading bits to determine the correct number of bytes to decode (may not match the QByteArray)
-    int encodedByteCount = 0;
-    int leadBits = 1;
-    int bitAt;
-    for (bitAt = 0; bitAt < bitCount; bitAt++) {
-        if (encodedBits.at(bitAt)) {
-            encodedByteCount++;
-            leadBits++;
-        } else {
-            break;
-        }
-    }
-    encodedByteCount++; // always at least one byte
-    int expectedBitCount = encodedByteCount * BITS_IN_BYTE;
+    int encodedByteCount = leadingOnes + 1; // always at least one byte
 
     T value = 0;
-    
-    if (expectedBitCount <= (encodedBits.size() - leadBits)) {
-        // Now, keep reading...
-        int valueStartsAt = bitAt + 1; 
-        T bitValue = 1;
-        for (bitAt = valueStartsAt; bitAt < expectedBitCount; bitAt++) {
-            if(encodedBits.at(bitAt)) {
-                value += bitValue;
+    if (encodedByteCount <= length) {
+        // the value follows the zero that ends the header, and any bits past the width of the type are dropped
+        int valueStartsAt = encodedByteCount;
+        int valueEndsAt = std::min(encodedByteCount * BITS_IN_BYTE, valueStartsAt + (int)sizeof(T) * BITS_IN_BYTE);
+        for (int bitAt = valueStartsAt; bitAt < valueEndsAt; bitAt++) {
+            if (encodedBytes[bitAt / BITS_IN_BYTE] & (0x80 >> (bitAt % BITS_IN_BYTE))) {
+                value |= (T)1 << (bitAt - valueStartsAt);
             }
-            bitValue *= 2;
         }
     }
     data = value;
+    return encodedByteCount;
 }
+
+template<typename T> inline QByteArray ByteCountCoded<T>::encode() const {
+    unsigned char buffer[MAX_ENCODED_BYTES];
+    return QByteArray((const char*)buffer, encode(buffer));
+}
+
+template<typename T> inline void ByteCountCoded<T>::decode(const QByteArray& fromEncodedBytes) {
+    decode((const unsigned char*)fromEncodedBytes.constData(), fromEncodedBytes.size());
+}
+
 #endif // hifi_ByteCountCoding_h
 
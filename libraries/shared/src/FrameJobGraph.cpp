@@ -0,0 +1,95 @@
+//
+//  FrameJobGraph.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PerfStat.h"
+#include "SharedUtil.h"
+
+#include "FrameJobGraph.h"
+
+FrameJobGraph::FrameJobGraph() :
+    _criticalPathUsecs(0),
+    _runUsecs(0) {
+}
+
+int FrameJobGraph::addJob(const char* name, const Job& job, const QVector<int>& dependencies) {
+    int id = _nodes.size();
+    Node node;
+    node.name = name;
+    node.scope = PerformanceTimer::registerScope(name);
+    node.job = job;
+    node.dependencies = dependencies;
+    node.usecs = 0;
+
+    for (int i = 0; i < dependencies.size(); i++) {
+        Q_ASSERT(dependencies.at(i) >= 0 && dependencies.at(i) < id);
+    }
+    _nodes.append(node);
+    return id;
+}
+
+void FrameJobGraph::run(float deltaTime) {
+    quint64 runStart = usecTimestampNow();
+    for (int i = 0; i < _nodes.size(); i++) {
+        Node& node = _nodes[i];
+        quint64 start = usecTimestampNow();
+        {
+            PerformanceTimer perfTimer(node.scope);
+            node.job(deltaTime);
+        }
+        node.usecs = usecTimestampNow() - start;
+    }
+    _runUsecs = usecTimestampNow() - runStart;
+    findCriticalPath();
+}
+
+QString FrameJobGraph::getCriticalPathDescription() const {
+    QString description;
+    foreach (int id, _criticalPath) {
+        if (!description.isEmpty()) {
+            description += " > ";
+        }
+        description += QString("%1 %2").arg(_nodes.at(id).name).arg(getJobUsecs(id) / (float)USECS_PER_MSEC, 0, 'f', 3);
+    }
+    return description + QString(" (%1 of %2 msecs)").arg(_criticalPathUsecs / (float)USECS_PER_MSEC, 0, 'f', 3)
+        .arg(_runUsecs / (float)USECS_PER_MSEC, 0, 'f', 3);
+}
+
+void FrameJobGraph::findCriticalPath() {
+    _criticalPath.clear();
+    _criticalPathUsecs = 0;
+    if (_nodes.isEmpty()) {
+        return;
+    }
+
+    // jobs only depend on ones added before them, so one pass in order finds the longest chain ending at each
+    QVector<quint64> chainUsecs(_nodes.size());
+    QVector<int> previous(_nodes.size());
+    int last = 0;
+    for (int i = 0; i < _nodes.size(); i++) {
+        const Node& node = _nodes.at(i);
+        previous[i] = -1;
+        chainUsecs[i] = 0;
+        foreach (int dependency, node.dependencies) {
+            if (previous.at(i) == -1 || chainUsecs.at(dependency) > chainUsecs.at(i)) {
+                chainUsecs[i] = chainUsecs.at(dependency);
+                previous[i] = dependency;
+            }
+        }
+        chainUsecs[i] += node.usecs;
+        if (chainUsecs.at(i) > chainUsecs.at(last)) {
+            last = i;
+        }
+    }
+    _criticalPathUsecs = chainUsecs.at(last);
+
+    for (int id = last; id != -1; id = previous.at(id)) {
+        _criticalPath.prepend(id);
+    }
+}
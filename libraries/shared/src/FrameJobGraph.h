@@ -0,0 +1,75 @@
+//
+//  FrameJobGraph.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameJobGraph_h
+#define hifi_FrameJobGraph_h
+
+#include <functional>
+
+#include <QString>
+#include <QVector>
+
+/// The jobs of a frame and what each depends on.  The jobs run one after another on the calling thread, in the order
+/// they were added, each under a PerformanceTimer of its own name.  After a run the graph has the longest chain of jobs
+/// through their dependencies, which is as short as the frame could get with everything off that chain running
+/// alongside it.
+class FrameJobGraph {
+public:
+
+    typedef std::function<void(float)> Job;
+
+    FrameJobGraph();
+
+    /// Adds a job that runs after the jobs in its dependencies, which have to have been added before it, and returns its
+    /// ID.  The name has to outlive the graph, it's registered as the job's PerformanceTimer scope.
+    int addJob(const char* name, const Job& job, const QVector<int>& dependencies = QVector<int>());
+
+    bool isEmpty() const { return _nodes.isEmpty(); }
+
+    /// Runs every job in the order they were added.
+    void run(float deltaTime);
+
+    /// Returns the jobs of the last run's critical path, first to last.
+    const QVector<int>& getCriticalPath() const { return _criticalPath; }
+
+    /// Returns the time the jobs of the last run's critical path took together, in microseconds.
+    quint64 getCriticalPathUsecs() const { return _criticalPathUsecs; }
+
+    /// Returns the time the whole of the last run took, in microseconds.
+    quint64 getRunUsecs() const { return _runUsecs; }
+
+    /// Returns the critical path as the jobs' names and times, like "threads 0.120 > entities 0.810 (0.930 of 1.203
+    /// msecs)".
+    QString getCriticalPathDescription() const;
+
+    const char* getJobName(int id) const { return _nodes.at(id).name; }
+    quint64 getJobUsecs(int id) const { return _nodes.at(id).usecs; }
+
+private:
+    Q_DISABLE_COPY(FrameJobGraph)
+
+    struct Node {
+        const char* name;
+        int scope;
+        Job job;
+        QVector<int> dependencies;
+        quint64 usecs;
+    };
+
+    void findCriticalPath();
+
+    QVector<Node> _nodes;
+
+    QVector<int> _criticalPath;
+    quint64 _criticalPathUsecs;
+    quint64 _runUsecs;
+};
+
+#endif // hifi_FrameJobGraph_h
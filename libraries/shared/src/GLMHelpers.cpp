@@ -110,6 +110,70 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+const float SMALLEST_THREE_RANGE = 0.70710678f; // 1 / sqrt(2)
+const int SMALLEST_THREE_MAX_PART = 0x7fff;
+const int SMALLEST_THREE_INDEX_BIT = 0x8000;
+
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+    
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+    
+    // q and -q are the same rotation, so the dropped component can always be made positive
+    float sign = (components[largestIndex] < 0.0f) ? -1.0f : 1.0f;
+    
+    uint16_t quatParts[3];
+    int part = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float ratio = (sign * components[i] / SMALLEST_THREE_RANGE + 1.0f) * 0.5f;
+            int quantized = (int)roundf(ratio * SMALLEST_THREE_MAX_PART);
+            quatParts[part++] = (uint16_t)glm::clamp(quantized, 0, SMALLEST_THREE_MAX_PART);
+        }
+    }
+    
+    // the index of the dropped component is kept in the top bits of the first two parts
+    if (largestIndex & 1) {
+        quatParts[0] |= SMALLEST_THREE_INDEX_BIT;
+    }
+    if (largestIndex & 2) {
+        quatParts[1] |= SMALLEST_THREE_INDEX_BIT;
+    }
+    
+    memcpy(buffer, &quatParts, sizeof(quatParts));
+    return sizeof(quatParts);
+}
+
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput) {
+    uint16_t quatParts[3];
+    memcpy(&quatParts, buffer, sizeof(quatParts));
+    
+    int largestIndex = ((quatParts[0] & SMALLEST_THREE_INDEX_BIT) ? 1 : 0)
+        | ((quatParts[1] & SMALLEST_THREE_INDEX_BIT) ? 2 : 0);
+    
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int part = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float ratio = (quatParts[part++] & SMALLEST_THREE_MAX_PART) / (float)SMALLEST_THREE_MAX_PART;
+            components[i] = (ratio * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+            sumOfSquares += components[i] * components[i];
+        }
+    }
+    components[largestIndex] = sqrtf(glm::max(1.0f - sumOfSquares, 0.0f));
+    
+    quatOutput = glm::quat(components[3], components[0], components[1], components[2]);
+    
+    return sizeof(quatParts);
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
@@ -0,0 +1,90 @@
+//
+//  InternedString.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "InternedString.h"
+
+InternedStringTable& InternedStringTable::getInstance() {
+    // never destroyed, so strings held by other statics can still be released while the program exits
+    static InternedStringTable* staticInstance = new InternedStringTable();
+    return *staticInstance;
+}
+
+InternedStringTable::InternedStringTable() {
+    Entry empty = { QString(), 0 };
+    _entries.append(empty);
+}
+
+InternedStringTable::Handle InternedStringTable::acquire(const QString& string) {
+    if (string.isEmpty()) {
+        return EMPTY_STRING;
+    }
+    QWriteLocker locker(&_lock);
+    QHash<QString, Handle>::const_iterator existing = _handles.constFind(string);
+    if (existing != _handles.constEnd()) {
+        _entries[existing.value()].references++;
+        return existing.value();
+    }
+
+    Entry entry = { string, 1 };
+    Handle handle;
+    if (_freeHandles.isEmpty()) {
+        handle = _entries.size();
+        _entries.append(entry);
+    } else {
+        handle = _freeHandles.last();
+        _freeHandles.removeLast();
+        _entries[handle] = entry;
+    }
+    _handles.insert(string, handle);
+    return handle;
+}
+
+void InternedStringTable::retain(Handle handle) {
+    if (handle != EMPTY_STRING) {
+        QWriteLocker locker(&_lock);
+        _entries[handle].references++;
+    }
+}
+
+void InternedStringTable::release(Handle handle) {
+    if (handle == EMPTY_STRING) {
+        return;
+    }
+    QWriteLocker locker(&_lock);
+    Entry& entry = _entries[handle];
+    if (--entry.references == 0) {
+        _handles.remove(entry.string);
+        entry.string = QString();
+        _freeHandles.append(handle);
+    }
+}
+
+QString InternedStringTable::lookup(Handle handle) const {
+    if (handle == EMPTY_STRING) {
+        return QString();
+    }
+    QReadLocker locker(&_lock);
+    return _entries[handle].string;
+}
+
+int InternedStringTable::size() const {
+    QReadLocker locker(&_lock);
+    return _handles.size();
+}
+
+InternedString& InternedString::operator=(const InternedString& other) {
+    if (_handle != other._handle) {
+        InternedStringTable& table = InternedStringTable::getInstance();
+        table.retain(other._handle);
+        table.release(_handle);
+        _handle = other._handle;
+    }
+    return *this;
+}
@@ -0,0 +1,83 @@
+//
+//  InternedString.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_InternedString_h
+#define hifi_InternedString_h
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/// One copy of each string that many objects hold, like the model and animation URLs thousands of entities share.
+/// Every string gets an integer handle that stays its own while anything references it, so holders compare and hash
+/// handles instead of strings, and every string looked up shares its data with the others.
+class InternedStringTable {
+public:
+    typedef quint32 Handle;
+    static const Handle EMPTY_STRING = 0; // always in the table, never counted
+
+    static InternedStringTable& getInstance();
+
+    /// the handle of the table's copy of string, taking a reference that has to be given back with release()
+    Handle acquire(const QString& string);
+
+    /// takes another reference to a string already in the table
+    void retain(Handle handle);
+    void release(Handle handle);
+
+    /// the string sharing its data with every other copy looked up from the table
+    QString lookup(Handle handle) const;
+
+    /// the number of strings in the table, not counting the empty string
+    int size() const;
+
+private:
+    InternedStringTable();
+
+    struct Entry {
+        QString string;
+        int references;
+    };
+
+    mutable QReadWriteLock _lock;
+    QVector<Entry> _entries; // indexed by handle
+    QHash<QString, Handle> _handles;
+    QVector<Handle> _freeHandles;
+};
+
+/// A string held by handle in the InternedStringTable, cheap to copy and compare.
+class InternedString {
+public:
+    InternedString() : _handle(InternedStringTable::EMPTY_STRING) { }
+    InternedString(const QString& string) : _handle(InternedStringTable::getInstance().acquire(string)) { }
+    InternedString(const InternedString& other) : _handle(other._handle) {
+        InternedStringTable::getInstance().retain(_handle);
+    }
+    ~InternedString() { InternedStringTable::getInstance().release(_handle); }
+
+    InternedString& operator=(const InternedString& other);
+
+    bool operator==(const InternedString& other) const { return _handle == other._handle; }
+    bool operator!=(const InternedString& other) const { return _handle != other._handle; }
+
+    bool isEmpty() const { return _handle == InternedStringTable::EMPTY_STRING; }
+    InternedStringTable::Handle getHandle() const { return _handle; }
+    QString toString() const { return InternedStringTable::getInstance().lookup(_handle); }
+
+private:
+    InternedStringTable::Handle _handle;
+};
+
+inline uint qHash(const InternedString& string, uint seed = 0) {
+    return qHash(string.getHandle(), seed);
+}
+
+#endif // hifi_InternedString_h
@@ -0,0 +1,206 @@
+//
+//  LZCompression.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include "LZCompression.h"
+
+// a sequence is a token byte, its literals, a two byte offset back to the match and the match, the token holds
+// four bits each of the literal length and the match length, longer lengths carry on in bytes of 255
+static const int MIN_MATCH = 4;
+static const int TOKEN_LENGTH_MASK = 15;
+static const int MAX_OFFSET = 65535;
+
+// the format ends every block on literals, so a match has to start this far before the end
+// and stop short of the last bytes
+static const int LAST_LITERALS = 5;
+static const int MATCH_FIND_LIMIT = 12;
+
+static const int HASH_BITS = 12;
+static const int HASH_TABLE_SIZE = 1 << HASH_BITS;
+
+static inline quint32 readSequence(const uchar* at) {
+    quint32 sequence;
+    memcpy(&sequence, at, sizeof(sequence));
+    return sequence;
+}
+
+static inline int hashSequence(quint32 sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static inline int extraLengthBytes(int length) {
+    return length >= TOKEN_LENGTH_MASK ? (length - TOKEN_LENGTH_MASK) / 255 + 1 : 0;
+}
+
+static inline uchar* writeExtraLength(uchar* outputAt, int length) {
+    for (length -= TOKEN_LENGTH_MASK; length >= 255; length -= 255) {
+        *outputAt++ = 255;
+    }
+    *outputAt++ = (uchar)length;
+    return outputAt;
+}
+
+// writes literals and then, if matchOffset isn't zero, a match, returns NULL if that doesn't fit before outputEnd
+static uchar* writeSequence(uchar* outputAt, const uchar* outputEnd, const uchar* literals, int literalLength,
+                            int matchOffset, int matchLength) {
+    int size = 1 + extraLengthBytes(literalLength) + literalLength;
+    if (matchOffset > 0) {
+        size += sizeof(quint16) + extraLengthBytes(matchLength);
+    }
+    if (size > outputEnd - outputAt) {
+        return NULL;
+    }
+
+    uchar* token = outputAt++;
+    *token = (uchar)(qMin(literalLength, TOKEN_LENGTH_MASK) << 4);
+    if (literalLength >= TOKEN_LENGTH_MASK) {
+        outputAt = writeExtraLength(outputAt, literalLength);
+    }
+    memcpy(outputAt, literals, literalLength);
+    outputAt += literalLength;
+
+    if (matchOffset > 0) {
+        *outputAt++ = (uchar)(matchOffset & 0xff);
+        *outputAt++ = (uchar)(matchOffset >> 8);
+        *token |= (uchar)qMin(matchLength, TOKEN_LENGTH_MASK);
+        if (matchLength >= TOKEN_LENGTH_MASK) {
+            outputAt = writeExtraLength(outputAt, matchLength);
+        }
+    }
+    return outputAt;
+}
+
+int LZCompression::maxCompressedSize(int sourceLength) {
+    return sourceLength + sourceLength / 255 + 16;
+}
+
+int LZCompression::compress(const uchar* source, int sourceLength, uchar* destination, int destinationCapacity) {
+    const uchar* sourceEnd = source + sourceLength;
+    const uchar* anchor = source;
+    uchar* outputAt = destination;
+    const uchar* outputEnd = destination + destinationCapacity;
+
+    if (sourceLength >= MATCH_FIND_LIMIT) {
+        const uchar* matchFindLimit = sourceEnd - MATCH_FIND_LIMIT;
+        const uchar* matchLimit = sourceEnd - LAST_LITERALS;
+
+        // the last position each hashed sequence was seen at
+        int positions[HASH_TABLE_SIZE];
+        memset(positions, -1, sizeof(positions));
+
+        const uchar* inputAt = source;
+        while (inputAt < matchFindLimit) {
+            quint32 sequence = readSequence(inputAt);
+            int hash = hashSequence(sequence);
+            int candidate = positions[hash];
+            positions[hash] = inputAt - source;
+
+            if (candidate < 0 || (inputAt - source) - candidate > MAX_OFFSET
+                    || readSequence(source + candidate) != sequence) {
+                inputAt++;
+                continue;
+            }
+
+            // grow the match back over the literals before it and on for as long as it keeps matching
+            const uchar* match = source + candidate;
+            while (inputAt > anchor && match > source && inputAt[-1] == match[-1]) {
+                inputAt--;
+                match--;
+            }
+            const uchar* matchEnd = inputAt + MIN_MATCH;
+            const uchar* reference = match + MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *reference) {
+                matchEnd++;
+                reference++;
+            }
+
+            outputAt = writeSequence(outputAt, outputEnd, anchor, inputAt - anchor, inputAt - match,
+                                     matchEnd - inputAt - MIN_MATCH);
+            if (!outputAt) {
+                return -1;
+            }
+            inputAt = anchor = matchEnd;
+        }
+    }
+
+    outputAt = writeSequence(outputAt, outputEnd, anchor, sourceEnd - anchor, 0, 0);
+    return outputAt ? outputAt - destination : -1;
+}
+
+// reads the bytes of 255 that carry on a length of 15 from the token, returns false if the source runs out first
+static inline bool readExtraLength(const uchar*& inputAt, const uchar* inputEnd, int& length) {
+    if (length != TOKEN_LENGTH_MASK) {
+        return true;
+    }
+    uchar extra;
+    do {
+        if (inputAt >= inputEnd) {
+            return false;
+        }
+        extra = *inputAt++;
+        length += extra;
+    } while (extra == 255);
+    return true;
+}
+
+int LZCompression::decompress(const uchar* source, int sourceLength, uchar* destination, int destinationCapacity) {
+    const uchar* inputAt = source;
+    const uchar* inputEnd = source + sourceLength;
+    uchar* outputAt = destination;
+    uchar* outputEnd = destination + destinationCapacity;
+
+    while (inputAt < inputEnd) {
+        uchar token = *inputAt++;
+
+        int literalLength = token >> 4;
+        if (!readExtraLength(inputAt, inputEnd, literalLength)
+                || literalLength > inputEnd - inputAt || literalLength > outputEnd - outputAt) {
+            return -1;
+        }
+        memcpy(outputAt, inputAt, literalLength);
+        inputAt += literalLength;
+        outputAt += literalLength;
+
+        if (inputAt == inputEnd) {
+            // the block always ends on literals
+            break;
+        }
+
+        if (inputEnd - inputAt < (int)sizeof(quint16)) {
+            return -1;
+        }
+        int matchOffset = inputAt[0] | (inputAt[1] << 8);
+        inputAt += sizeof(quint16);
+
+        int matchLength = token & TOKEN_LENGTH_MASK;
+        if (!readExtraLength(inputAt, inputEnd, matchLength)) {
+            return -1;
+        }
+        matchLength += MIN_MATCH;
+
+        if (matchOffset == 0 || matchOffset > outputAt - destination || matchLength > outputEnd - outputAt) {
+            return -1;
+        }
+
+        // a match can overlap the bytes it is writing, which is how runs get encoded
+        const uchar* reference = outputAt - matchOffset;
+        if (matchOffset >= matchLength) {
+            memcpy(outputAt, reference, matchLength);
+            outputAt += matchLength;
+        } else {
+            for (int i = 0; i < matchLength; i++) {
+                *outputAt++ = *reference++;
+            }
+        }
+    }
+
+    return outputAt - destination;
+}
@@ -0,0 +1,29 @@
+//
+//  LZCompression.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LZCompression_h
+#define hifi_LZCompression_h
+
+#include <QtGlobal>
+
+/// A fast LZ77 codec for small buffers like a packet's payload. It writes the LZ4 block format, trading some ratio
+/// against zlib for many times the speed in both directions.
+namespace LZCompression {
+    /// the most a buffer of sourceLength bytes can grow to when it doesn't compress at all
+    int maxCompressedSize(int sourceLength);
+
+    /// compresses sourceLength bytes into destination, returns the compressed size or -1 if it doesn't fit
+    int compress(const uchar* source, int sourceLength, uchar* destination, int destinationCapacity);
+
+    /// decompresses into destination, returns the decompressed size or -1 if the source is malformed or too big to fit
+    int decompress(const uchar* source, int sourceLength, uchar* destination, int destinationCapacity);
+}
+
+#endif // hifi_LZCompression_h
@@ -14,26 +14,173 @@
 
 #include <qdatetime.h>
 #include <qdebug.h>
-#include <qtimer.h>
+#include <qthread.h>
 
 #include "LogHandler.h"
 
+const char* LOG_FILE_PARAMETER = "--logFile";
+
+// how long the handler's thread waits for more messages once it finds the queue empty
+const unsigned long DRAIN_INTERVAL_MSECS = 10;
+
+const int INITIAL_BATCH_BYTES = 64 * 1024;
+
+class LogHandler::DrainThread : public QThread {
+public:
+    DrainThread(LogHandler* handler) : _handler(handler), _stopping(false) { }
+
+    void stop() { _stopping.store(true); wait(); }
+
+protected:
+    virtual void run() {
+        while (!_stopping.load()) {
+            if (!_handler->drain()) {
+                msleep(DRAIN_INTERVAL_MSECS);
+            }
+        }
+    }
+
+private:
+    LogHandler* _handler;
+    std::atomic<bool> _stopping;
+};
+
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
     return staticInstance;
 }
 
 LogHandler::LogHandler() :
-    _shouldOutputPID(false)
+    _enqueuePosition(0),
+    _droppedCount(0),
+    _dequeuePosition(0),
+    _drainingThreadID(nullptr),
+    _shouldOutputPID(false),
+    _maxFileBytes(DEFAULT_MAX_LOG_FILE_BYTES),
+    _keptFileCount(DEFAULT_KEPT_LOG_FILES),
+    _lastRepeatFlush(QDateTime::currentMSecsSinceEpoch()),
+    _lastTimestampSecond(-1)
 {
-    // setup our timer to flush the verbose logs every 5 seconds
-    QTimer* logFlushTimer = new QTimer(this);
-    connect(logFlushTimer, &QTimer::timeout, this, &LogHandler::flushRepeatedMessages);
-    logFlushTimer->start(VERBOSE_LOG_INTERVAL_SECONDS * 1000);
-    
+    // with the capacity reserved, emptying the batch keeps its buffer for the next
+    _batch.reserve(INITIAL_BATCH_BYTES);
+
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+        _queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
     // when the log handler is first setup we should print our timezone
     QString timezoneString = "Time zone: " + QDateTime::currentDateTime().toString("t");
     printf("%s\n", qPrintable(timezoneString));
+
+    _drainThread = new DrainThread(this);
+    _drainThread->start();
+}
+
+LogHandler::~LogHandler() {
+    _drainThread->stop();
+    delete _drainThread;
+    flush();
+}
+
+void LogHandler::setTargetName(const QString& targetName) {
+    QMutexLocker locker(&_drainMutex);
+    _targetName = targetName;
+}
+
+void LogHandler::setShouldOutputPID(bool shouldOutputPID) {
+    QMutexLocker locker(&_drainMutex);
+    _shouldOutputPID = shouldOutputPID;
+    _pidString = QString::number(QCoreApplication::applicationPid());
+}
+
+void LogHandler::setOutputFile(const QString& fileName, qint64 maxFileBytes, int keptFileCount) {
+    QMutexLocker locker(&_drainMutex);
+    _outputFile.close();
+    _outputFileName = fileName;
+    _maxFileBytes = maxFileBytes;
+    _keptFileCount = keptFileCount;
+    if (!fileName.isEmpty()) {
+        _outputFile.setFileName(fileName);
+        if (!_outputFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            fprintf(stderr, "Could not open log file %s\n", qPrintable(fileName));
+        }
+    }
+}
+
+bool LogHandler::queueMessage(LogMsgType type, const QString& message) {
+    quint32 position;
+    return message.isEmpty() || queueMessage(type, message, position);
+}
+
+bool LogHandler::queueMessage(LogMsgType type, const QString& message, quint32& position) {
+    // claim the next slot whose last message has been taken, as in Vyukov's bounded queue
+    position = _enqueuePosition.load(std::memory_order_relaxed);
+    QueuedMessage* queued;
+    forever {
+        queued = &_queue[position % QUEUE_SIZE];
+        qint32 difference = (qint32)(queued->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0) {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // the queue is full, and the hot threads never wait on the log
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+    queued->type = type;
+    queued->msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    queued->message = message;
+    queued->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void LogHandler::flush() {
+    while (drain());
+}
+
+void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (message.isEmpty()) {
+        return;
+    }
+    LogHandler& handler = getInstance();
+    quint32 position;
+    bool printed = handler.queueMessage((LogMsgType) type, message, position);
+
+    // Qt aborts once we return from a fatal message, so that one has to be out first
+    if (type == QtFatalMsg) {
+        // raised while draining, flushing would wait on the lock this thread holds
+        if (printed && handler._drainingThreadID.load() != QThread::currentThreadId()) {
+            handler.flush();
+
+            // the flush stops short at a slot another thread has claimed but not filled in yet
+            QMutexLocker locker(&handler._drainMutex);
+            printed = (qint32)(handler._dequeuePosition - position) > 0;
+        } else {
+            printed = false;
+        }
+        if (!printed) {
+            // dropped, stuck behind an unfinished message, or raised while draining. straight out it goes
+            fprintf(stderr, "%s\n", qPrintable(message));
+        }
+    }
+}
+
+const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
+    QMutexLocker locker(&_drainMutex);
+    QSet<QString>::const_iterator existing = _repeatedMessageRegexes.constFind(regexString);
+    if (existing != _repeatedMessageRegexes.constEnd()) {
+        return *existing;
+    }
+    RepeatedMessage repeatedMessage;
+    repeatedMessage.regexString = regexString;
+    repeatedMessage.regex = QRegExp(regexString);
+    repeatedMessage.count = -1;
+    _repeatedMessages.append(repeatedMessage);
+    return *_repeatedMessageRegexes.insert(regexString);
 }
 
 const char* stringForLogType(LogMsgType msgType) {
@@ -56,74 +203,137 @@ const char* stringForLogType(LogMsgType msgType) {
 // the following will produce 11/18 13:55:36
 const QString DATE_STRING_FORMAT = "MM/dd hh:mm:ss";
 
-void LogHandler::flushRepeatedMessages() {
-    QHash<QString, int>::iterator message = _repeatMessageCountHash.begin();
-    while (message != _repeatMessageCountHash.end()) {
-        
-        if (message.value() > 0) {
-            QString repeatMessage = QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
-            .arg(message.value()).arg(message.key()).arg(_lastRepeatedMessage.value(message.key()));
-            
-            QMessageLogContext emptyContext;
-            printMessage(LogSuppressed, emptyContext, repeatMessage);
+bool LogHandler::drain() {
+    QMutexLocker locker(&_drainMutex);
+    _drainingThreadID.store(QThread::currentThreadId());
+    int messageCount = 0;
+    while (messageCount < MAX_BATCH_MESSAGES) {
+        QueuedMessage& queued = _queue[_dequeuePosition % QUEUE_SIZE];
+        if ((qint32)(queued.sequence.load(std::memory_order_acquire) - (_dequeuePosition + 1)) < 0) {
+            break;
+        }
+        LogMsgType type = queued.type;
+        qint64 msecsSinceEpoch = queued.msecsSinceEpoch;
+        QString message = queued.message;
+        queued.message = QString();
+        queued.sequence.store(_dequeuePosition + QUEUE_SIZE, std::memory_order_release);
+        _dequeuePosition++;
+        messageCount++;
+
+        if (type != LogDebug || !isSuppressed(message)) {
+            appendMessage(type, msecsSinceEpoch, message);
         }
-        
-        _lastRepeatedMessage.remove(message.key());
-        message = _repeatMessageCountHash.erase(message);
     }
+
+    int droppedCount = _droppedCount.exchange(0, std::memory_order_relaxed);
+    if (droppedCount > 0) {
+        appendMessage(LogSuppressed, QDateTime::currentMSecsSinceEpoch(),
+            QString("%1 log entries dropped - the log queue was full").arg(droppedCount));
+    }
+
+    if (QDateTime::currentMSecsSinceEpoch() - _lastRepeatFlush >= VERBOSE_LOG_INTERVAL_SECONDS * 1000) {
+        flushRepeatedMessages();
+    }
+
+    writeBatch();
+    _drainingThreadID.store(nullptr);
+    return messageCount > 0;
 }
 
-QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
-    
-    if (message.isEmpty()) {
-        return QString();
-    }
-    
-    if (type == LogDebug) {
-        // for debug messages, check if this matches any of our regexes for repeated log messages
-        foreach(const QString& regexString, getInstance()._repeatedMessageRegexes) {
-            QRegExp repeatRegex(regexString);
-            if (repeatRegex.indexIn(message) != -1) {
-                
-                if (!_repeatMessageCountHash.contains(regexString)) {
-                    // we have a match but didn't have this yet - output the first one
-                    _repeatMessageCountHash[regexString] = 0;
-                    
-                    // break the foreach so we output the first match
-                    break;
-                } else {
-                    // we have a match - add 1 to the count of repeats for this message and set this as the last repeated message
-                    _repeatMessageCountHash[regexString] += 1;
-                    _lastRepeatedMessage[regexString] = message;
-                    
-                    // return out, we're not printing this one
-                    return QString();
-                }
+bool LogHandler::isSuppressed(const QString& message) {
+    // check if this matches any of our regexes for repeated log messages
+    for (QList<RepeatedMessage>::iterator repeated = _repeatedMessages.begin();
+            repeated != _repeatedMessages.end(); repeated++) {
+        if (repeated->regex.indexIn(message) != -1) {
+            if (repeated->count == -1) {
+                // we have a match but didn't have this yet - output the first one
+                repeated->count = 0;
+                return false;
             }
+            // we have a match - add 1 to the count of repeats and set this as the last repeated message
+            repeated->count++;
+            repeated->lastMessage = message;
+
+            // we're not printing this one
+            return true;
+        }
+    }
+    return false;
+}
+
+void LogHandler::flushRepeatedMessages() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    _lastRepeatFlush = now;
+    for (QList<RepeatedMessage>::iterator repeated = _repeatedMessages.begin();
+            repeated != _repeatedMessages.end(); repeated++) {
+        if (repeated->count > 0) {
+            QString repeatMessage = QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
+            .arg(repeated->count).arg(repeated->regexString).arg(repeated->lastMessage);
+            appendMessage(LogSuppressed, now, repeatMessage);
         }
+        repeated->count = -1;
+        repeated->lastMessage = QString();
     }
-    
+}
+
+void LogHandler::appendMessage(LogMsgType type, qint64 msecsSinceEpoch, const QString& message) {
     // log prefix is in the following format
     // [DEBUG] [TIMESTAMP] [PID] [TARGET] logged string
-    
-    QString prefixString = QString("[%1]").arg(stringForLogType(type));
-    
-    prefixString.append(QString(" [%1]").arg(QDateTime::currentDateTime().toString(DATE_STRING_FORMAT)));
-    
+
+    // the messages in a batch mostly share their second, so it's formatted once for them
+    qint64 second = msecsSinceEpoch / 1000;
+    if (second != _lastTimestampSecond) {
+        _lastTimestampSecond = second;
+        _lastTimestamp = QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch).toString(DATE_STRING_FORMAT);
+    }
+
+    QString prefixString = QString("[%1] [%2]").arg(stringForLogType(type), _lastTimestamp);
+
     if (_shouldOutputPID) {
-        prefixString.append(QString(" [%1]").arg(QCoreApplication::instance()->applicationPid()));
-        
+        prefixString.append(QString(" [%1]").arg(_pidString));
     }
-    
+
     if (!_targetName.isEmpty()) {
         prefixString.append(QString(" [%1]").arg(_targetName));
     }
-    
-    QString logMessage = QString("%1 %2").arg(prefixString, message);
-    fprintf(stdout, "%s\n", qPrintable(logMessage));
-    return logMessage;
+
+    QString logMessage = QString("%1 %2\n").arg(prefixString, message);
+    _batch.append(logMessage.toLocal8Bit());
+    emit messagePrinted(logMessage);
 }
 
-void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
-    getInstance().printMessage((LogMsgType) type, context, message);
+void LogHandler::writeBatch() {
+    if (_batch.isEmpty()) {
+        return;
+    }
+    fwrite(_batch.constData(), 1, _batch.size(), stdout);
+    fflush(stdout);
+
+    if (_outputFile.isOpen()) {
+        if (_outputFile.size() + _batch.size() > _maxFileBytes) {
+            rotateOutputFile();
+        }
+        _outputFile.write(_batch);
+        _outputFile.flush();
+    }
+    _batch.resize(0);
+}
+
+void LogHandler::rotateOutputFile() {
+    _outputFile.close();
+
+    // shift the kept files back by one, the oldest falling off the end
+    QFile::remove(QString("%1.%2").arg(_outputFileName).arg(_keptFileCount));
+    for (int i = _keptFileCount - 1; i > 0; i--) {
+        QFile::rename(QString("%1.%2").arg(_outputFileName).arg(i), QString("%1.%2").arg(_outputFileName).arg(i + 1));
+    }
+    if (_keptFileCount > 0) {
+        QFile::rename(_outputFileName, _outputFileName + ".1");
+    } else {
+        QFile::remove(_outputFileName);
+    }
+
+    if (!_outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fprintf(stderr, "Could not reopen log file %s\n", qPrintable(_outputFileName));
+    }
 }
@@ -13,7 +13,11 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
-#include <qhash.h>
+#include <atomic>
+
+#include <qfile.h>
+#include <qlist.h>
+#include <qmutex.h>
 #include <qobject.h>
 #include <qregexp.h>
 #include <qset.h>
@@ -21,6 +25,12 @@
 
 const int VERBOSE_LOG_INTERVAL_SECONDS = 5;
 
+const qint64 DEFAULT_MAX_LOG_FILE_BYTES = 16 * 1024 * 1024;
+const int DEFAULT_KEPT_LOG_FILES = 4;
+
+/// the option the servers take the file to log to from, alongside stdout
+extern const char* LOG_FILE_PARAMETER;
+
 enum LogMsgType {
     LogDebug,
     LogWarning,
@@ -29,35 +39,102 @@ enum LogMsgType {
     LogSuppressed
 };
 
-/// Handles custom message handling and sending of stats/logs to Logstash instance
+/// Handles custom message handling and sending of stats/logs to Logstash instance.  The threads that log only queue
+/// their messages, without locking or formatting, and a thread of the handler's own formats them, suppresses the
+/// repeats and writes them out in batches.  When the queue is full, the messages are dropped and counted rather than
+/// waited on.
 class LogHandler : public QObject {
     Q_OBJECT
 public:
     static LogHandler& getInstance();
-    
+
     /// sets the target name to output via the verboseMessageHandler, called once before logging begins
     /// \param targetName the desired target name to output in logs
-    void setTargetName(const QString& targetName) { _targetName = targetName; }
-    
-    void setShouldOutputPID(bool shouldOutputPID) { _shouldOutputPID = shouldOutputPID; }
-    
-    QString printMessage(LogMsgType type, const QMessageLogContext& context, const QString &message);
-    
+    void setTargetName(const QString& targetName);
+
+    void setShouldOutputPID(bool shouldOutputPID);
+
+    /// Writes the log to a file as well as stdout, starting the file over once it reaches the given size, and keeping
+    /// that many of the last ones as fileName.1 and up.  An empty name stops the file output.
+    void setOutputFile(const QString& fileName, qint64 maxFileBytes = DEFAULT_MAX_LOG_FILE_BYTES,
+        int keptFileCount = DEFAULT_KEPT_LOG_FILES);
+
+    /// Queues a message to be printed, returning false if the queue was full and it was dropped.
+    bool queueMessage(LogMsgType type, const QString& message);
+
+    /// Prints the queued messages on the calling thread, returning once they're out.
+    void flush();
+
     /// a qtMessageHandler that can be hooked up to a target that links to Qt
     /// prints various process, message type, and time information
     static void verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString &message);
-    
-    const QString& addRepeatedMessageRegex(const QString& regexString) { return *_repeatedMessageRegexes.insert(regexString); }
+
+    const QString& addRepeatedMessageRegex(const QString& regexString);
+
+signals:
+
+    /// Emitted on the handler's thread for each message printed, with its prefix and a trailing newline.
+    void messagePrinted(const QString& logMessage);
+
 private:
     LogHandler();
-    
+    ~LogHandler();
+
+    class DrainThread;
+
+    class QueuedMessage {
+    public:
+        std::atomic<quint32> sequence;
+        LogMsgType type;
+        qint64 msecsSinceEpoch;
+        QString message;
+    };
+
+    class RepeatedMessage {
+    public:
+        QString regexString;
+        QRegExp regex;
+        int count;
+        QString lastMessage;
+    };
+
+    static const int QUEUE_SIZE = 4096; ///< a power of two, so the positions wrap around it
+    static const int MAX_BATCH_MESSAGES = 256;
+
+    /// Queues a message as queueMessage does, setting position to the slot it went in.
+    bool queueMessage(LogMsgType type, const QString& message, quint32& position);
+    bool drain();
+    bool isSuppressed(const QString& message);
     void flushRepeatedMessages();
-    
+    void appendMessage(LogMsgType type, qint64 msecsSinceEpoch, const QString& message);
+    void writeBatch();
+    void rotateOutputFile();
+
+    QueuedMessage _queue[QUEUE_SIZE];
+    std::atomic<quint32> _enqueuePosition;
+    std::atomic<int> _droppedCount;
+    quint32 _dequeuePosition;
+
+    QMutex _drainMutex; ///< held by whichever thread drains, and guards everything below
+    std::atomic<Qt::HANDLE> _drainingThreadID; ///< the thread inside drain(), which must not wait on itself to flush
+    DrainThread* _drainThread;
+
     QString _targetName;
     bool _shouldOutputPID;
+    QString _pidString; ///< formatted once, since the PID doesn't change
+
+    QString _outputFileName;
+    qint64 _maxFileBytes;
+    int _keptFileCount;
+    QFile _outputFile;
+
     QSet<QString> _repeatedMessageRegexes;
-    QHash<QString, int> _repeatMessageCountHash;
-    QHash<QString, QString> _lastRepeatedMessage;
+    QList<RepeatedMessage> _repeatedMessages; ///< compiled once, as they're added
+    qint64 _lastRepeatFlush;
+
+    qint64 _lastTimestampSecond;
+    QString _lastTimestamp;
+    QByteArray _batch;
 };
 
-#endif // hifi_LogHandler_h
\ No newline at end of file
+#endif // hifi_LogHandler_h
@@ -0,0 +1,85 @@
+//
+//  MatrixKernel.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MatrixKernel_h
+#define hifi_MatrixKernel_h
+
+#include <string.h>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HIFI_MATRIX_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define HIFI_MATRIX_NEON
+#include <arm_neon.h>
+#endif
+
+//
+// 4x4 matrix kernels for the joint and cluster transforms Model recomputes every frame.
+//
+// Matrices are column major, the way glm stores them. Each result column is the left matrix's columns weighted by the
+// right matrix's column, which the SIMD paths compute four rows at a time. The left matrix is loaded up front, so the
+// result may be either operand.
+//
+namespace MatrixKernel {
+
+/// result = left * right
+inline void multiply(float* result, const float* left, const float* right) {
+#if defined(HIFI_MATRIX_SSE)
+    __m128 left0 = _mm_loadu_ps(left);
+    __m128 left1 = _mm_loadu_ps(left + 4);
+    __m128 left2 = _mm_loadu_ps(left + 8);
+    __m128 left3 = _mm_loadu_ps(left + 12);
+    for (int i = 0; i < 16; i += 4) {
+        __m128 column = _mm_mul_ps(left0, _mm_set1_ps(right[i]));
+        column = _mm_add_ps(column, _mm_mul_ps(left1, _mm_set1_ps(right[i + 1])));
+        column = _mm_add_ps(column, _mm_mul_ps(left2, _mm_set1_ps(right[i + 2])));
+        column = _mm_add_ps(column, _mm_mul_ps(left3, _mm_set1_ps(right[i + 3])));
+        _mm_storeu_ps(result + i, column);
+    }
+#elif defined(HIFI_MATRIX_NEON)
+    float32x4_t left0 = vld1q_f32(left);
+    float32x4_t left1 = vld1q_f32(left + 4);
+    float32x4_t left2 = vld1q_f32(left + 8);
+    float32x4_t left3 = vld1q_f32(left + 12);
+    for (int i = 0; i < 16; i += 4) {
+        float32x4_t column = vmulq_n_f32(left0, right[i]);
+        column = vmlaq_n_f32(column, left1, right[i + 1]);
+        column = vmlaq_n_f32(column, left2, right[i + 2]);
+        column = vmlaq_n_f32(column, left3, right[i + 3]);
+        vst1q_f32(result + i, column);
+    }
+#else
+    float product[16];
+    for (int i = 0; i < 16; i += 4) {
+        for (int row = 0; row < 4; row++) {
+            product[i + row] = left[row] * right[i] + left[row + 4] * right[i + 1] +
+                left[row + 8] * right[i + 2] + left[row + 12] * right[i + 3];
+        }
+    }
+    memcpy(result, product, sizeof(product));
+#endif
+}
+
+inline void multiply(glm::mat4& result, const glm::mat4& left, const glm::mat4& right) {
+    multiply(&result[0][0], &left[0][0], &right[0][0]);
+}
+
+inline glm::mat4 multiply(const glm::mat4& left, const glm::mat4& right) {
+    glm::mat4 result;
+    multiply(&result[0][0], &left[0][0], &right[0][0]);
+    return result;
+}
+
+}
+
+#endif // hifi_MatrixKernel_h
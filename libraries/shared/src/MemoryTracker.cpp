@@ -0,0 +1,72 @@
+//
+//  MemoryTracker.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MemoryTracker.h"
+
+MemoryTracker& MemoryTracker::getInstance() {
+    static MemoryTracker staticInstance;
+    return staticInstance;
+}
+
+MemoryCounter& MemoryTracker::getCounter(const QString& subsystem) {
+    QMutexLocker locker(&_mutex);
+    foreach (MemoryCounter* counter, _counters) {
+        if (counter->getName() == subsystem) {
+            return *counter;
+        }
+    }
+    // never deleted, as what's destroyed at exit still removes its bytes
+    MemoryCounter* counter = new MemoryCounter(subsystem);
+    _counters.append(counter);
+    return *counter;
+}
+
+QList<MemoryCounter*> MemoryTracker::getCounters() const {
+    QMutexLocker locker(&_mutex);
+    return _counters;
+}
+
+qint64 MemoryTracker::getTotalCPUBytes() const {
+    QMutexLocker locker(&_mutex);
+    qint64 total = 0;
+    foreach (MemoryCounter* counter, _counters) {
+        total += counter->getCPUBytes();
+    }
+    return total;
+}
+
+qint64 MemoryTracker::getTotalGPUBytes() const {
+    QMutexLocker locker(&_mutex);
+    qint64 total = 0;
+    foreach (MemoryCounter* counter, _counters) {
+        total += counter->getGPUBytes();
+    }
+    return total;
+}
+
+QJsonObject MemoryTracker::toJson() const {
+    QMutexLocker locker(&_mutex);
+    QJsonObject memoryObject;
+    qint64 totalCPUBytes = 0;
+    qint64 totalGPUBytes = 0;
+    foreach (MemoryCounter* counter, _counters) {
+        QJsonObject counterObject;
+        qint64 cpuBytes = counter->getCPUBytes();
+        qint64 gpuBytes = counter->getGPUBytes();
+        counterObject["cpu_bytes"] = (double)cpuBytes;
+        counterObject["gpu_bytes"] = (double)gpuBytes;
+        memoryObject[counter->getName()] = counterObject;
+        totalCPUBytes += cpuBytes;
+        totalGPUBytes += gpuBytes;
+    }
+    memoryObject["total_cpu_bytes"] = (double)totalCPUBytes;
+    memoryObject["total_gpu_bytes"] = (double)totalGPUBytes;
+    return memoryObject;
+}
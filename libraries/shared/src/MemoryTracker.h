@@ -0,0 +1,72 @@
+//
+//  MemoryTracker.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MemoryTracker_h
+#define hifi_MemoryTracker_h
+
+#include <atomic>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+/// The bytes of CPU and GPU memory that a subsystem holds, as it reports them.  Any thread can add to and remove from
+/// it.
+class MemoryCounter {
+public:
+    MemoryCounter(const QString& name) : _name(name), _cpuBytes(0), _gpuBytes(0) { }
+
+    const QString& getName() const { return _name; }
+
+    void addCPUBytes(qint64 bytes) { _cpuBytes.fetch_add(bytes, std::memory_order_relaxed); }
+    void removeCPUBytes(qint64 bytes) { _cpuBytes.fetch_sub(bytes, std::memory_order_relaxed); }
+
+    void addGPUBytes(qint64 bytes) { _gpuBytes.fetch_add(bytes, std::memory_order_relaxed); }
+    void removeGPUBytes(qint64 bytes) { _gpuBytes.fetch_sub(bytes, std::memory_order_relaxed); }
+
+    qint64 getCPUBytes() const { return _cpuBytes.load(std::memory_order_relaxed); }
+    qint64 getGPUBytes() const { return _gpuBytes.load(std::memory_order_relaxed); }
+
+private:
+    Q_DISABLE_COPY(MemoryCounter)
+
+    QString _name;
+    std::atomic<qint64> _cpuBytes;
+    std::atomic<qint64> _gpuBytes;
+};
+
+/// The memory counters of the subsystems, by name, for the stats displays and status pages to read.  The counters
+/// live as long as the process, so a subsystem can keep the one it gets for good.
+class MemoryTracker {
+public:
+    static MemoryTracker& getInstance();
+
+    /// Returns the counter for a subsystem, making it the first time the name is asked for.
+    MemoryCounter& getCounter(const QString& subsystem);
+
+    /// Returns the counters in the order they were made.
+    QList<MemoryCounter*> getCounters() const;
+
+    qint64 getTotalCPUBytes() const;
+    qint64 getTotalGPUBytes() const;
+
+    /// The CPU and GPU bytes of each subsystem by name, and the totals of them.
+    QJsonObject toJson() const;
+
+private:
+    MemoryTracker() { }
+    Q_DISABLE_COPY(MemoryTracker)
+
+    mutable QMutex _mutex;
+    QList<MemoryCounter*> _counters;
+};
+
+#endif // hifi_MemoryTracker_h
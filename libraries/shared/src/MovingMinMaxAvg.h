@@ -13,6 +13,7 @@
 #define hifi_MovingMinMaxAvg_h
 
 #include <cassert>
+#include <deque>
 #include <limits>
 
 #include "RingBufferHistory.h"
@@ -64,6 +65,15 @@ public:
         _samples += other._samples;
     }
 
+    /// sets the stats outright, for stats combined some other way than with update()
+    void set(T min, T max, double average, int samples) {
+        _min = min;
+        _max = max;
+        _average = average;
+        _samples = samples;
+        _last = 0;
+    }
+
     T getMin() const { return _min; }
     T getMax() const { return _max; }
     double getAverage() const { return _average; }
@@ -89,6 +99,8 @@ public:
     // For example, if you want a moving avg of the past 5000 samples updated every 100 samples, you would instantiate
     // this class with MovingMinMaxAvg(100, 50).  If you want a moving min of the past 100 samples updated on every
     // new sample, instantiate this class with MovingMinMaxAvg(1, 100).
+    // Completing an interval costs the same however many intervals the window holds: the window's sum is kept running,
+    // and its min and max come from queues of the intervals that could still be the window's min or max.
     
 
     /// use intervalLength = 0 to use in manual mode, where the currentIntervalComplete() function must
@@ -100,7 +112,10 @@ public:
         _windowStats(),
         _currentIntervalStats(),
         _intervalStats(windowIntervals),
-        _newStatsAvailable(false)
+        _newStatsAvailable(false),
+        _intervalsCompleted(0),
+        _windowSum(0.0),
+        _windowSamples(0)
     {}
     
     void reset() {
@@ -109,6 +124,7 @@ public:
         _currentIntervalStats.reset();
         _intervalStats.clear();
         _newStatsAvailable = false;
+        resetWindow();
     }
 
     void setWindowIntervals(int windowIntervals) {
@@ -118,6 +134,7 @@ public:
         _currentIntervalStats.reset();
         _intervalStats.setCapacity(_windowIntervals);
         _newStatsAvailable = false;
+        resetWindow();
     }
 
     void update(T newSample) {
@@ -137,19 +154,51 @@ public:
     /// This function can be called to manually control when each interval ends.  For example, if each interval
     /// needs to last T seconds as opposed to N samples, this function should be called every T seconds.
     void currentIntervalComplete() {
+        // the oldest interval leaves the window's sum as this one comes in
+        if (_intervalStats.isFilled()) {
+            const MinMaxAvg<T>* oldest = _intervalStats.get(_intervalStats.getNumEntries() - 1);
+            _windowSum -= oldest->getSum();
+            _windowSamples -= oldest->getSamples();
+        }
+        _windowSum += _currentIntervalStats.getSum();
+        _windowSamples += _currentIntervalStats.getSamples();
+
+        // an interval is dropped from the min queue once a newer one has a min at least as low, it can never be the
+        // window's min again, which leaves the queue ascending from oldest to newest, and the max queue likewise
+        quint64 interval = _intervalsCompleted++;
+        while (!_windowMins.empty() && _windowMins.back().value >= _currentIntervalStats.getMin()) {
+            _windowMins.pop_back();
+        }
+        _windowMins.push_back(IntervalExtreme(interval, _currentIntervalStats.getMin()));
+        while (!_windowMaxes.empty() && _windowMaxes.back().value <= _currentIntervalStats.getMax()) {
+            _windowMaxes.pop_back();
+        }
+        _windowMaxes.push_back(IntervalExtreme(interval, _currentIntervalStats.getMax()));
+        while (_windowMins.front().interval + _windowIntervals <= interval) {
+            _windowMins.pop_front();
+        }
+        while (_windowMaxes.front().interval + _windowIntervals <= interval) {
+            _windowMaxes.pop_front();
+        }
+
         // record current interval's stats, then reset them
         _intervalStats.insert(_currentIntervalStats);
         _currentIntervalStats.reset();
 
-        // update the window's stats by combining the intervals' stats
-        typename RingBufferHistory< MinMaxAvg<T> >::Iterator i = _intervalStats.begin();
-        typename RingBufferHistory< MinMaxAvg<T> >::Iterator end = _intervalStats.end();
-        _windowStats.reset();
-        while (i != end) {
-            _windowStats.update(*i);
-            ++i;
+        // once per window the sum is taken again from the intervals, so rounding in it never builds up
+        if (_intervalsCompleted % _windowIntervals == 0) {
+            _windowSum = 0.0;
+            _windowSamples = 0;
+            for (int i = 0; i < _intervalStats.getNumEntries(); i++) {
+                const MinMaxAvg<T>* stats = _intervalStats.get(i);
+                _windowSum += stats->getSum();
+                _windowSamples += stats->getSamples();
+            }
         }
 
+        _windowStats.set(_windowMins.front().value, _windowMaxes.front().value,
+            _windowSamples > 0 ? _windowSum / _windowSamples : 0.0, _windowSamples);
+
         _newStatsAvailable = true;
     }
 
@@ -188,6 +237,22 @@ public:
     bool isWindowFilled() const { return _intervalStats.isFilled(); }
 
 private:
+    class IntervalExtreme {
+    public:
+        IntervalExtreme(quint64 interval, T value) : interval(interval), value(value) {}
+
+        quint64 interval; // how many intervals had been completed before this one
+        T value;
+    };
+
+    void resetWindow() {
+        _intervalsCompleted = 0;
+        _windowMins.clear();
+        _windowMaxes.clear();
+        _windowSum = 0.0;
+        _windowSamples = 0;
+    }
+
     int _intervalLength;
     int _windowIntervals;
 
@@ -204,6 +269,13 @@ private:
     RingBufferHistory< MinMaxAvg<T> > _intervalStats;
 
     bool _newStatsAvailable;
+
+    // the window's intervals that could still be its min or max, oldest first, and its running sum
+    quint64 _intervalsCompleted;
+    std::deque<IntervalExtreme> _windowMins;
+    std::deque<IntervalExtreme> _windowMaxes;
+    double _windowSum;
+    int _windowSamples;
 };
 
 #endif // hifi_MovingMinMaxAvg_h
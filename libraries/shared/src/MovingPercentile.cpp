@@ -8,54 +8,74 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "MovingPercentile.h"
 
 MovingPercentile::MovingPercentile(int numSamples, float percentile)
     : _numSamples(numSamples),
     _percentile(percentile),
+    _samples(),
     _samplesSorted(),
-    _sampleIds(),
-    _newSampleId(0),
+    _oldestSampleIndex(0),
     _indexOfPercentile(0),
     _valueAtPercentile(0.0f)
 {
+    _samples.reserve(numSamples);
+    _samplesSorted.reserve(numSamples);
 }
 
 void MovingPercentile::updatePercentile(float sample) {
+    float* sorted = _samplesSorted.data();
 
-    // insert the new sample into _samplesSorted
-    int newSampleIndex;
     if (_samplesSorted.size() < _numSamples) {
-        // if not all samples have been filled yet, simply append it
-        newSampleIndex = _samplesSorted.size();
-        _samplesSorted.append(sample);
-        _sampleIds.append(_newSampleId);
-
-        // update _indexOfPercentile
-        float index = _percentile * (float)(_samplesSorted.size() - 1);
-        _indexOfPercentile = (int)(index + 0.5f);   // round to int
-    } else {
-        // find index of sample with id = _newSampleId and replace it with new sample
-        newSampleIndex = _sampleIds.indexOf(_newSampleId);
-        _samplesSorted[newSampleIndex] = sample;
-    }
+        // if not all samples have been filled yet, simply insert it
+        _samples.append(sample);
+        int newSampleIndex = std::upper_bound(sorted, sorted + _samplesSorted.size(), sample) - sorted;
+        _samplesSorted.insert(newSampleIndex, sample);
 
-    // increment _newSampleId.  cycles from 0 thru N-1
-    _newSampleId = (_newSampleId == _numSamples - 1) ? 0 : _newSampleId + 1;
+        updateIndexOfPercentile();
+    } else {
+        // the new sample takes the oldest one's place
+        float oldestSample = _samples[_oldestSampleIndex];
+        _samples[_oldestSampleIndex] = sample;
+        _oldestSampleIndex = (_oldestSampleIndex == _numSamples - 1) ? 0 : _oldestSampleIndex + 1;
 
-    // swap new sample with neighbors in _samplesSorted until it's in sorted order
-    // try swapping up first, then down.  element will only be swapped one direction.
-    while (newSampleIndex < _samplesSorted.size() - 1 && sample > _samplesSorted[newSampleIndex + 1]) {
-        _samplesSorted.swap(newSampleIndex, newSampleIndex + 1);
-        _sampleIds.swap(newSampleIndex, newSampleIndex + 1);
-        newSampleIndex++;
-    }
-    while (newSampleIndex > 0 && sample < _samplesSorted[newSampleIndex - 1]) {
-        _samplesSorted.swap(newSampleIndex, newSampleIndex - 1);
-        _sampleIds.swap(newSampleIndex, newSampleIndex - 1);
-        newSampleIndex--;
+        // shift the samples between where the oldest was and where the new one goes over by one, into the gap
+        float* sortedEnd = sorted + _samplesSorted.size();
+        float* oldestAt = std::lower_bound(sorted, sortedEnd, oldestSample);
+        if (sample > oldestSample) {
+            float* newSampleAt = std::upper_bound(oldestAt + 1, sortedEnd, sample);
+            std::copy(oldestAt + 1, newSampleAt, oldestAt);
+            *(newSampleAt - 1) = sample;
+        } else {
+            float* newSampleAt = std::upper_bound(sorted, oldestAt, sample);
+            std::copy_backward(newSampleAt, oldestAt, oldestAt + 1);
+            *newSampleAt = sample;
+        }
     }
 
     // find new value at percentile
     _valueAtPercentile = _samplesSorted[_indexOfPercentile];
 }
+
+void MovingPercentile::setPercentile(float percentile) {
+    _percentile = percentile;
+    if (!_samplesSorted.isEmpty()) {
+        updateIndexOfPercentile();
+        _valueAtPercentile = _samplesSorted[_indexOfPercentile];
+    }
+}
+
+void MovingPercentile::reset() {
+    _samples.clear();
+    _samplesSorted.clear();
+    _oldestSampleIndex = 0;
+    _indexOfPercentile = 0;
+    _valueAtPercentile = 0.0f;
+}
+
+void MovingPercentile::updateIndexOfPercentile() {
+    float index = _percentile * (float)(_samplesSorted.size() - 1);
+    _indexOfPercentile = (int)(index + 0.5f);   // round to int
+}
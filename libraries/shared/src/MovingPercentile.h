@@ -11,8 +11,11 @@
 #ifndef hifi_MovingPercentile_h
 #define hifi_MovingPercentile_h
 
-#include <qlist.h>
+#include <qvector.h>
 
+/// The exact value at a percentile of the last numSamples samples. A new sample replaces the oldest in a sorted copy of
+/// the window found by binary search, moving only the samples between the two, see PercentileEstimator for a constant
+/// time estimate where being exact doesn't matter.
 class MovingPercentile {
 
 public:
@@ -21,13 +24,23 @@ public:
     void updatePercentile(float sample);
     float getValueAtPercentile() const { return _valueAtPercentile; }
 
+    /// keeps the samples, the value is picked from them again at the new percentile
+    void setPercentile(float percentile);
+    float getPercentile() const { return _percentile; }
+
+    int getNumSamples() const { return _samplesSorted.size(); }
+
+    void reset();
+
 private:
+    void updateIndexOfPercentile();
+
     const int _numSamples;
-    const float _percentile;
+    float _percentile;
 
-    QList<float> _samplesSorted;
-    QList<int> _sampleIds;      // incrementally assigned, is cyclic
-    int _newSampleId;
+    QVector<float> _samples;        // in the order they came, the oldest at _oldestSampleIndex once full
+    QVector<float> _samplesSorted;
+    int _oldestSampleIndex;
 
     int _indexOfPercentile;
     float _valueAtPercentile;
@@ -16,6 +16,12 @@
 
 #include <QtCore/QDebug>
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 #include "SharedUtil.h"
 #include "OctalCode.h"
 
@@ -73,7 +79,15 @@ int branchIndexWithDescendant(const unsigned char* ancestorOctalCode, const unsi
 }
 
 unsigned char* childOctalCode(const unsigned char* parentOctalCode, char childNumber) {
-    
+    MortonKey parentKey;
+    if ((!parentOctalCode || MortonKey::fromOctalCode(parentOctalCode, parentKey)) &&
+            parentKey.getLevels() < MortonKey::MAX_LEVELS) {
+        MortonKey childKey = parentKey.getChild(childNumber);
+        unsigned char* newCode = new unsigned char[bytesRequiredForCodeLength(childKey.getLevels())];
+        childKey.toOctalCode(newCode);
+        return newCode;
+    }
+
     // find the length (in number of three bit code sequences)
     // in the parent
     int parentCodeSections = parentOctalCode
@@ -127,6 +141,11 @@ unsigned char* childOctalCode(const unsigned char* parentOctalCode, char childNu
 }
 
 void voxelDetailsForCode(const unsigned char* octalCode, VoxelPositionSize& voxelPositionSize) {
+    MortonKey key;
+    if (!octalCode || MortonKey::fromOctalCode(octalCode, key)) {
+        key.getVoxelDetails(voxelPositionSize);
+        return;
+    }
     float output[3];
     memset(&output[0], 0, 3 * sizeof(float));
     float currentScale = 1.0;
@@ -150,6 +169,15 @@ void voxelDetailsForCode(const unsigned char* octalCode, VoxelPositionSize& voxe
 }
 
 void copyFirstVertexForCode(const unsigned char* octalCode, float* output) {
+    MortonKey key;
+    if (MortonKey::fromOctalCode(octalCode, key)) {
+        VoxelPositionSize voxelPositionSize;
+        key.getVoxelDetails(voxelPositionSize);
+        output[0] = voxelPositionSize.x;
+        output[1] = voxelPositionSize.y;
+        output[2] = voxelPositionSize.z;
+        return;
+    }
     memset(output, 0, 3 * sizeof(float));
     
     float currentScale = 0.5;
@@ -298,6 +326,16 @@ bool isAncestorOf(const unsigned char* possibleAncestor, const unsigned char* po
         return false;
     }
 
+    MortonKey ancestorKey, descendentKey;
+    if (MortonKey::fromOctalCode(possibleAncestor, ancestorKey) &&
+            MortonKey::fromOctalCode(possibleDescendent, descendentKey) &&
+            (descendentsChild == CHECK_NODE_ONLY || descendentKey.getLevels() < MortonKey::MAX_LEVELS)) {
+        if (descendentsChild != CHECK_NODE_ONLY) {
+            descendentKey = descendentKey.getChild(descendentsChild);
+        }
+        return ancestorKey.isAncestorOf(descendentKey);
+    }
+
     int ancestorCodeLength = numberOfThreeBitSectionsInCode(possibleAncestor);
     if (ancestorCodeLength == 0) {
         return true; // this is the root, it's the anscestor of all
@@ -377,3 +415,83 @@ QString octalCodeToHexString(const unsigned char* octalCode) {
     return output;
 }
 
+// the bits of the sections' bottom bits, which are the z components; the y and x are one and two above
+const quint64 EVERY_THIRD_BIT = 0x1249249249249249ULL;
+
+// gathers every third bit into the bottom bits, in a single instruction where there's BMI2 to do it with
+static quint64 compactEveryThirdBit(quint64 bits) {
+#if defined(__BMI2__)
+    return _pext_u64(bits, EVERY_THIRD_BIT);
+#else
+    bits &= EVERY_THIRD_BIT;
+    bits = (bits ^ (bits >> 2)) & 0x10C30C30C30C30C3ULL;
+    bits = (bits ^ (bits >> 4)) & 0x100F00F00F00F00FULL;
+    bits = (bits ^ (bits >> 8)) & 0x001F0000FF0000FFULL;
+    bits = (bits ^ (bits >> 16)) & 0x001F00000000FFFFULL;
+    bits = (bits ^ (bits >> 32)) & 0x00000000001FFFFFULL;
+    return bits;
+#endif
+}
+
+static int bytesForSections(int levels) {
+    return (levels * BITS_IN_OCTAL + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+}
+
+bool MortonKey::fromOctalCode(const unsigned char* octalCode, MortonKey& key) {
+    // a code long enough to need the multi-byte length is well past what fits
+    if (!octalCode || *octalCode > MAX_LEVELS) {
+        return false;
+    }
+    int levels = *octalCode;
+    int bytes = bytesForSections(levels);
+    quint64 sections = 0;
+    for (int i = 1; i <= bytes; i++) {
+        sections = (sections << BITS_IN_BYTE) | octalCode[i];
+    }
+    key._bits = (1ULL << (levels * BITS_IN_OCTAL)) | (sections >> (bytes * BITS_IN_BYTE - levels * BITS_IN_OCTAL));
+    return true;
+}
+
+void MortonKey::toOctalCode(unsigned char* octalCode) const {
+    int levels = getLevels();
+    int bytes = bytesForSections(levels);
+    quint64 sections = (_bits ^ (1ULL << (levels * BITS_IN_OCTAL))) << (bytes * BITS_IN_BYTE - levels * BITS_IN_OCTAL);
+    octalCode[0] = levels;
+    for (int i = bytes; i >= 1; i--) {
+        octalCode[i] = (unsigned char)sections;
+        sections >>= BITS_IN_BYTE;
+    }
+}
+
+int MortonKey::getLevels() const {
+#if defined(__GNUC__)
+    return (63 - __builtin_clzll(_bits)) / BITS_IN_OCTAL;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long leadingBit;
+    _BitScanReverse64(&leadingBit, _bits);
+    return leadingBit / BITS_IN_OCTAL;
+#else
+    int levels = 0;
+    for (quint64 bits = _bits >> BITS_IN_OCTAL; bits != 0; bits >>= BITS_IN_OCTAL) {
+        levels++;
+    }
+    return levels;
+#endif
+}
+
+bool MortonKey::isAncestorOf(const MortonKey& descendant) const {
+    int levelsBelow = descendant.getLevels() - getLevels();
+    return levelsBelow >= 0 && (descendant._bits >> (levelsBelow * BITS_IN_OCTAL)) == _bits;
+}
+
+void MortonKey::getVoxelDetails(VoxelPositionSize& voxelPositionSize) const {
+    int levels = getLevels();
+    quint64 sections = _bits ^ (1ULL << (levels * BITS_IN_OCTAL));
+
+    // each coordinate is a fixed point fraction with a bit for each level, which a float holds exactly
+    float scale = ldexpf(1.0f, -levels);
+    voxelPositionSize.x = compactEveryThirdBit(sections >> 2) * scale;
+    voxelPositionSize.y = compactEveryThirdBit(sections >> 1) * scale;
+    voxelPositionSize.z = compactEveryThirdBit(sections) * scale;
+    voxelPositionSize.s = scale;
+}
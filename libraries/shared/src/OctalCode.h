@@ -65,4 +65,42 @@ OctalCodeComparison compareOctalCodes(const unsigned char* code1, const unsigned
 QString octalCodeToHexString(const unsigned char* octalCode);
 unsigned char* hexStringToOctalCode(const QString& input);
 
+/// An octal code of up to MAX_LEVELS sections packed into a 64-bit Morton key: a leading one bit followed by the
+/// sections from the top level down, three bits each.  A child's key is its parent's shifted up with the child's
+/// index in the bottom bits, so an ancestor's is a descendant's shifted down.  The byte strings stay the wire format,
+/// and the functions above take this path for the codes that fit.
+class MortonKey {
+public:
+    static const int MAX_LEVELS = 21;
+
+    /// The root's key.
+    MortonKey() : _bits(1) { }
+
+    /// Packs an octal code, returning false, and leaving the key alone, if it's null or has more than MAX_LEVELS
+    /// sections.
+    static bool fromOctalCode(const unsigned char* octalCode, MortonKey& key);
+
+    /// Writes the key out as an octal code, which takes bytesRequiredForCodeLength(getLevels()) bytes.
+    void toOctalCode(unsigned char* octalCode) const;
+
+    quint64 getBits() const { return _bits; }
+    int getLevels() const;
+
+    /// Only for keys with fewer than MAX_LEVELS sections.
+    MortonKey getChild(int childIndex) const { return MortonKey((_bits << BITS_IN_OCTAL) | childIndex); }
+
+    /// Whether this is the key of the descendant or one of its ancestors.
+    bool isAncestorOf(const MortonKey& descendant) const;
+
+    void getVoxelDetails(VoxelPositionSize& voxelPositionSize) const;
+
+    bool operator==(const MortonKey& other) const { return _bits == other._bits; }
+    bool operator!=(const MortonKey& other) const { return _bits != other._bits; }
+
+private:
+    explicit MortonKey(quint64 bits) : _bits(bits) { }
+
+    quint64 _bits;
+};
+
 #endif // hifi_OctalCode_h
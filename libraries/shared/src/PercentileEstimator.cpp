@@ -0,0 +1,125 @@
+//
+//  PercentileEstimator.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PercentileEstimator.h"
+
+PercentileEstimator::PercentileEstimator(int windowSamples, float percentile) :
+    _windowSamples(windowSamples > NUM_MARKERS ? windowSamples : NUM_MARKERS),
+    _percentile(percentile)
+{
+    reset();
+}
+
+void PercentileEstimator::reset() {
+    _hasLastWindow = false;
+    _lastWindowValue = 0.0f;
+    restartWindow();
+}
+
+void PercentileEstimator::restartWindow() {
+    _samples = 0;
+    _desiredIncrements[0] = 0.0f;
+    _desiredIncrements[1] = _percentile / 2.0f;
+    _desiredIncrements[2] = _percentile;
+    _desiredIncrements[3] = (1.0f + _percentile) / 2.0f;
+    _desiredIncrements[4] = 1.0f;
+    for (int i = 0; i < NUM_MARKERS; i++) {
+        _positions[i] = i;
+        _desiredPositions[i] = _desiredIncrements[i] * (NUM_MARKERS - 1);
+    }
+}
+
+void PercentileEstimator::updatePercentile(float sample) {
+    if (_samples == _windowSamples) {
+        _lastWindowValue = getValueAtPercentile();
+        _hasLastWindow = true;
+        restartWindow();
+    }
+
+    if (_samples < NUM_MARKERS) {
+        // the first few samples are the markers, kept sorted
+        int i = _samples++;
+        while (i > 0 && _heights[i - 1] > sample) {
+            _heights[i] = _heights[i - 1];
+            i--;
+        }
+        _heights[i] = sample;
+        return;
+    }
+    _samples++;
+
+    // find the cell the sample falls in, stretching the outer markers to take it if need be
+    int cell;
+    if (sample < _heights[0]) {
+        _heights[0] = sample;
+        cell = 0;
+    } else if (sample >= _heights[NUM_MARKERS - 1]) {
+        _heights[NUM_MARKERS - 1] = sample;
+        cell = NUM_MARKERS - 2;
+    } else {
+        cell = 0;
+        while (sample >= _heights[cell + 1]) {
+            cell++;
+        }
+    }
+    for (int i = cell + 1; i < NUM_MARKERS; i++) {
+        _positions[i]++;
+    }
+    for (int i = 0; i < NUM_MARKERS; i++) {
+        _desiredPositions[i] += _desiredIncrements[i];
+    }
+
+    // move the middle markers a step toward where they should be if they've fallen a whole position behind
+    for (int i = 1; i < NUM_MARKERS - 1; i++) {
+        float offset = _desiredPositions[i] - _positions[i];
+        if ((offset >= 1.0f && _positions[i + 1] - _positions[i] > 1) ||
+                (offset <= -1.0f && _positions[i - 1] - _positions[i] < -1)) {
+            int direction = offset > 0.0f ? 1 : -1;
+            float height = parabolicHeight(i, direction);
+            if (_heights[i - 1] < height && height < _heights[i + 1]) {
+                _heights[i] = height;
+            } else {
+                _heights[i] = linearHeight(i, direction);
+            }
+            _positions[i] += direction;
+        }
+    }
+}
+
+float PercentileEstimator::parabolicHeight(int marker, int direction) const {
+    float below = (float)(_positions[marker] - _positions[marker - 1]);
+    float above = (float)(_positions[marker + 1] - _positions[marker]);
+    return _heights[marker] + direction / (below + above) *
+        ((below + direction) * (_heights[marker + 1] - _heights[marker]) / above +
+        (above - direction) * (_heights[marker] - _heights[marker - 1]) / below);
+}
+
+float PercentileEstimator::linearHeight(int marker, int direction) const {
+    return _heights[marker] + direction * (_heights[marker + direction] - _heights[marker]) /
+        (_positions[marker + direction] - _positions[marker]);
+}
+
+float PercentileEstimator::getValueAtPercentile() const {
+    if (_hasLastWindow && _samples < _windowSamples / 2) {
+        return _lastWindowValue;
+    }
+    if (_samples == 0) {
+        return 0.0f;
+    }
+    if (_samples < NUM_MARKERS) {
+        // too few for the markers to mean anything, the samples themselves are sorted
+        return _heights[(int)(_percentile * (_samples - 1) + 0.5f)];
+    }
+    return _heights[NUM_MARKERS / 2];
+}
+
+int PercentileEstimator::getNumSamples() const {
+    return (_hasLastWindow && _samples < _windowSamples / 2) ? _windowSamples : _samples;
+}
@@ -0,0 +1,52 @@
+//
+//  PercentileEstimator.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PercentileEstimator_h
+#define hifi_PercentileEstimator_h
+
+/// An estimate of the value at a percentile of recent samples in constant time and space, using the P-squared algorithm
+/// (Jain and Chlamtac), which keeps five markers whose heights are nudged toward the percentile as samples come in.
+/// The estimate starts over every windowSamples samples, and the last complete window's estimate is given until the new
+/// window has seen half as many. Use MovingPercentile where the exact value is needed.
+class PercentileEstimator {
+public:
+    PercentileEstimator(int windowSamples, float percentile = 0.5f);
+
+    void updatePercentile(float sample);
+    float getValueAtPercentile() const;
+
+    float getPercentile() const { return _percentile; }
+
+    /// the number of samples the value is estimated from
+    int getNumSamples() const;
+
+    void reset();
+
+private:
+    static const int NUM_MARKERS = 5;
+
+    void restartWindow();
+    float parabolicHeight(int marker, int direction) const;
+    float linearHeight(int marker, int direction) const;
+
+    const int _windowSamples;
+    const float _percentile;
+
+    int _samples;
+    float _heights[NUM_MARKERS];        // sorted samples until there are NUM_MARKERS of them
+    int _positions[NUM_MARKERS];
+    float _desiredPositions[NUM_MARKERS];
+    float _desiredIncrements[NUM_MARKERS];
+
+    bool _hasLastWindow;
+    float _lastWindowValue;
+};
+
+#endif // hifi_PercentileEstimator_h
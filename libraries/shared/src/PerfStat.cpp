@@ -9,12 +9,22 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <map>
 #include <string>
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
 #include <QThread>
+#include <QThreadStorage>
+#include <QVector>
 
 #include "PerfStat.h"
 
@@ -78,30 +88,208 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // PerformanceTimer
 // ----------------------------------------------------------------------------
 
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
-QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
+const int MAX_PERFORMANCE_TIMER_SCOPES = 1024;
+const int MAX_PERFORMANCE_TIMER_PATHS = 1024; // per thread
+const int TRACE_EVENTS_PER_THREAD = 8192;
+
+// usecTimestampNow() checks itself against the wall clock each time, which is too slow for a scope timer
+static quint64 steadyUsecsNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
+class PerformanceTimer::ThreadProfile {
+public:
+    /// A scope under the path of those around it, which the thread adds its times to, and the tally reads from.
+    class PathNode {
+    public:
+        int scope;
+        int parent;
+        std::atomic<quint64> totalUsecs;
+        std::atomic<quint64> count;
+        quint64 talliedUsecs;
+        quint64 talliedCount;
+        QString path;
+    };
+    
+    class TraceEvent {
+    public:
+        int scope;
+        quint64 start;
+        quint64 duration;
+    };
+    
+    ThreadProfile(int threadID);
+    
+    int getChild(int parent, int scope);
+    void addTime(int node, int scope, quint64 start, quint64 duration);
+    
+    int threadID;
+    QString threadName;
+    int currentNode;
+    
+    PathNode nodes[MAX_PERFORMANCE_TIMER_PATHS]; ///< the root first, then each node after its parent
+    std::atomic<int> nodeCount;
+    QHash<quint64, int> children; ///< by parent and scope, which only the thread looks in
+    
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+    std::atomic<quint64> eventCount;
+};
+
+/// Holds a profile for a thread, and hands it back for another thread to take over when the thread finishes.
+class ProfileLease {
+public:
+    ProfileLease(PerformanceTimer::ThreadProfile* profile) : profile(profile) { }
+    ~ProfileLease();
+    
+    PerformanceTimer::ThreadProfile* profile;
+};
 
-PerformanceTimer::PerformanceTimer(const QString& name) :
-    _start(0),
-    _name(name) 
+static QMutex profilesMutex;
+static QVector<PerformanceTimer::ThreadProfile*> threadProfiles;
+static QVector<PerformanceTimer::ThreadProfile*> freeThreadProfiles;
+static const char* scopeNames[MAX_PERFORMANCE_TIMER_SCOPES];
+static int scopeCount = 0;
+static QThreadStorage<ProfileLease*> profileLeases;
+
+ProfileLease::~ProfileLease() {
+    // the profile keeps its paths and times, which the next thread to take it over adds to
+    QMutexLocker locker(&profilesMutex);
+    freeThreadProfiles.append(profile);
+}
+
+PerformanceTimer::ThreadProfile::ThreadProfile(int threadID) :
+    threadID(threadID),
+    currentNode(0),
+    nodeCount(1),
+    eventCount(0)
 {
-    QString& fullName = _fullNames[QThread::currentThread()];
-    fullName.append("/");
-    fullName.append(_name);
-    _start = usecTimestampNow();
+    nodes[0].scope = -1;
+    nodes[0].parent = -1;
+    nodes[0].totalUsecs.store(0, std::memory_order_relaxed);
+    nodes[0].count.store(0, std::memory_order_relaxed);
+}
+
+int PerformanceTimer::ThreadProfile::getChild(int parent, int scope) {
+    quint64 key = ((quint64)parent << 32) | (quint32)scope;
+    QHash<quint64, int>::const_iterator child = children.constFind(key);
+    if (child != children.constEnd()) {
+        return child.value();
+    }
+    int index = nodeCount.load(std::memory_order_relaxed);
+    if (index == MAX_PERFORMANCE_TIMER_PATHS) {
+        // out of paths, so the time goes to the root, which isn't tallied
+        return 0;
+    }
+    PathNode& node = nodes[index];
+    node.scope = scope;
+    node.parent = parent;
+    node.totalUsecs.store(0, std::memory_order_relaxed);
+    node.count.store(0, std::memory_order_relaxed);
+    node.talliedUsecs = 0;
+    node.talliedCount = 0;
+    
+    // the tally only looks at the nodes up to the count, so the node has to be filled in first
+    nodeCount.store(index + 1, std::memory_order_release);
+    children.insert(key, index);
+    return index;
+}
+
+void PerformanceTimer::ThreadProfile::addTime(int node, int scope, quint64 start, quint64 duration) {
+    // we're the only writer of our profile, so there's no need for the cost of atomic adds
+    PathNode& pathNode = nodes[node];
+    quint64 totalUsecs = pathNode.totalUsecs.load(std::memory_order_relaxed) + duration;
+    pathNode.totalUsecs.store(totalUsecs, std::memory_order_relaxed);
+    pathNode.count.store(pathNode.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    
+    quint64 index = eventCount.load(std::memory_order_relaxed);
+    TraceEvent& event = events[index % TRACE_EVENTS_PER_THREAD];
+    event.scope = scope;
+    event.start = start;
+    event.duration = duration;
+    eventCount.store(index + 1, std::memory_order_release);
+}
+
+static PerformanceTimer::ThreadProfile* getThreadProfile() {
+    if (profileLeases.hasLocalData()) {
+        return profileLeases.localData()->profile;
+    }
+    QThread* thread = QThread::currentThread();
+    QString threadName = thread->objectName().isEmpty()
+        ? QString("thread %1").arg((quintptr)thread, 0, 16) : thread->objectName();
+    
+    PerformanceTimer::ThreadProfile* profile;
+    {
+        QMutexLocker locker(&profilesMutex);
+        if (freeThreadProfiles.isEmpty()) {
+            profile = new PerformanceTimer::ThreadProfile(threadProfiles.size());
+            threadProfiles.append(profile);
+        } else {
+            profile = freeThreadProfiles.takeLast();
+            profile->currentNode = 0;
+        }
+        profile->threadName = threadName;
+    }
+    profileLeases.setLocalData(new ProfileLease(profile));
+    return profile;
+}
+
+QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
+QMutex PerformanceTimer::_mutex;
+
+PerformanceTimer::PerformanceTimer(int scope) :
+    _profile(getThreadProfile()),
+    _parentNode(_profile->currentNode),
+    _scope(scope)
+{
+    _profile->currentNode = _profile->getChild(_parentNode, scope);
+    _start = steadyUsecsNow();
 }
 
 PerformanceTimer::~PerformanceTimer() {
-    quint64 elapsedusec = (usecTimestampNow() - _start);
-    QString& fullName = _fullNames[QThread::currentThread()];
-    PerformanceTimerRecord& namedRecord = _records[fullName];
-    namedRecord.accumulateResult(elapsedusec);
-    fullName.resize(fullName.size() - (_name.size() + 1));
+    quint64 elapsedusec = steadyUsecsNow() - _start;
+    _profile->addTime(_profile->currentNode, _scope, _start, elapsedusec);
+    _profile->currentNode = _parentNode;
+}
+
+int PerformanceTimer::registerScope(const char* name) {
+    QMutexLocker locker(&profilesMutex);
+    for (int scope = 0; scope < scopeCount; scope++) {
+        if (strcmp(scopeNames[scope], name) == 0) {
+            return scope;
+        }
+    }
+    if (scopeCount == MAX_PERFORMANCE_TIMER_SCOPES) {
+        qWarning() << "PerformanceTimer is out of scopes, so" << name << "is timed as" << scopeNames[0];
+        return 0;
+    }
+    scopeNames[scopeCount] = name;
+    return scopeCount++;
 }
 
 // static 
 void PerformanceTimer::tallyAllTimerRecords() {
+    QMutexLocker locker(&_mutex);
+    {
+        // add what each path has taken since the last tally to its record
+        QMutexLocker profilesLocker(&profilesMutex);
+        foreach (ThreadProfile* profile, threadProfiles) {
+            int nodeCount = profile->nodeCount.load(std::memory_order_acquire);
+            for (int index = 1; index < nodeCount; index++) {
+                ThreadProfile::PathNode& node = profile->nodes[index];
+                if (node.path.isEmpty()) {
+                    node.path = profile->nodes[node.parent].path + "/" + scopeNames[node.scope];
+                }
+                quint64 totalUsecs = node.totalUsecs.load(std::memory_order_relaxed);
+                quint64 count = node.count.load(std::memory_order_relaxed);
+                if (count != node.talliedCount) {
+                    _records[node.path].accumulateResult(totalUsecs - node.talliedUsecs);
+                    node.talliedUsecs = totalUsecs;
+                    node.talliedCount = count;
+                }
+            }
+        }
+    }
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
@@ -117,6 +305,7 @@ void PerformanceTimer::tallyAllTimerRecords() {
 }
 
 void PerformanceTimer::dumpAllTimerRecords() {
+    QMutexLocker locker(&_mutex);
     QMapIterator<QString, PerformanceTimerRecord> i(_records);
     while (i.hasNext()) {
         i.next();
@@ -125,3 +314,47 @@ void PerformanceTimer::dumpAllTimerRecords() {
             << "usecs over" << i.value().getCount() << "calls";
     }
 }
+
+QByteArray PerformanceTimer::getChromeTrace() {
+    QJsonArray eventsArray;
+    double pid = QCoreApplication::applicationPid();
+    
+    QMutexLocker locker(&profilesMutex);
+    foreach (ThreadProfile* profile, threadProfiles) {
+        QJsonObject threadNameObject;
+        threadNameObject["name"] = QString("thread_name");
+        threadNameObject["ph"] = QString("M");
+        threadNameObject["pid"] = pid;
+        threadNameObject["tid"] = profile->threadID;
+        QJsonObject threadNameArgs;
+        threadNameArgs["name"] = profile->threadName;
+        threadNameObject["args"] = threadNameArgs;
+        eventsArray.append(threadNameObject);
+        
+        quint64 end = profile->eventCount.load(std::memory_order_acquire);
+        quint64 begin = (end > TRACE_EVENTS_PER_THREAD) ? end - TRACE_EVENTS_PER_THREAD : 0;
+        QVector<ThreadProfile::TraceEvent> events;
+        events.reserve(end - begin);
+        for (quint64 index = begin; index < end; index++) {
+            events.append(profile->events[index % TRACE_EVENTS_PER_THREAD]);
+        }
+        
+        // the thread keeps going while we copy, so skip those it may have written over since
+        quint64 after = profile->eventCount.load(std::memory_order_acquire);
+        quint64 firstIntact = (after > TRACE_EVENTS_PER_THREAD) ? after - TRACE_EVENTS_PER_THREAD : 0;
+        for (quint64 index = qMax(begin, firstIntact); index < end; index++) {
+            const ThreadProfile::TraceEvent& event = events.at(index - begin);
+            QJsonObject eventObject;
+            eventObject["name"] = QString(scopeNames[event.scope]);
+            eventObject["ph"] = QString("X");
+            eventObject["ts"] = (double)event.start;
+            eventObject["dur"] = (double)event.duration;
+            eventObject["pid"] = pid;
+            eventObject["tid"] = profile->threadID;
+            eventsArray.append(eventObject);
+        }
+    }
+    QJsonObject traceObject;
+    traceObject["traceEvents"] = eventsArray;
+    return QJsonDocument(traceObject).toJson(QJsonDocument::Compact);
+}
@@ -23,6 +23,11 @@
 #include <string>
 #include <map>
 
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
 class PerformanceWarning {
 private:
     quint64 _start;
@@ -70,23 +75,42 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
+/// Times a scope through PERFORMANCE_TIMER("name"), which registers the name once for the call site.  The time goes to
+/// the scope's path through the scopes timed around it on the thread, like "/idle/update/myAvatar", which the records
+/// are tallied under.  When and for how long the scope ran also goes to a ring buffer of the thread's, for a trace
+/// of the last few thousand scopes.  Timing takes two reads of the steady clock and a few stores to memory that only
+/// the thread writes to, with no strings or locks; the work of naming the paths is left to whoever reads them.
 class PerformanceTimer {
 public:
 
-    PerformanceTimer(const QString& name);
+    PerformanceTimer(int scope);
     ~PerformanceTimer();
     
+    /// Returns the ID to time the named scope by.  Registering a name again returns the same ID.
+    static int registerScope(const char* name);
+    
     static const PerformanceTimerRecord& getTimerRecord(const QString& name) { return _records[name]; };
     static const QMap<QString, PerformanceTimerRecord>& getAllTimerRecords() { return _records; };
     static void tallyAllTimerRecords();
     static void dumpAllTimerRecords();
+    
+    /// Returns the scopes still in the threads' ring buffers in Chrome's trace event format, for chrome://tracing.
+    static QByteArray getChromeTrace();
+
+    class ThreadProfile;
 
 private:
+    ThreadProfile* _profile;
+    int _parentNode;
+    int _scope;
     quint64 _start;
-    QString _name;
-    static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
+    static QMutex _mutex; // timers run on the worker pools as well as the main thread
 };
 
+#define PERFORMANCE_TIMER(name) \
+    static const int perfTimerScope = PerformanceTimer::registerScope(name); \
+    PerformanceTimer perfTimer(perfTimerScope)
+
 
 #endif // hifi_PerfStat_h
@@ -21,29 +21,36 @@
 
 #include <algorithm>
 #include <climits>
+#include <string.h>
 
-#include <QBitArray>
 #include <QByteArray>
 
 #include <SharedUtil.h>
 
-template<typename Enum>class PropertyFlags {
+const int BITS_PER_BYTE = 8;
+
+/// A set of the properties of an enum, kept inline in as many words as the given number of flags needs, so that
+/// neither the set nor its encoding allocate.  Flags at or past MaxFlags are never set.
+template<typename Enum, int MaxFlags = 64> class PropertyFlags {
 public:
     typedef Enum enum_type;
     inline PropertyFlags() : 
-            _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) { };
+            _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) { clearBits(); };
 
     inline PropertyFlags(const PropertyFlags& other) : 
-            _flags(other._flags), _maxFlag(other._maxFlag), _minFlag(other._minFlag), 
-            _trailingFlipped(other._trailingFlipped), _encodedLength(0) {}
+            _maxFlag(other._maxFlag), _minFlag(other._minFlag), 
+            _trailingFlipped(other._trailingFlipped), _encodedLength(0) { copyBits(other); }
 
     inline PropertyFlags(Enum flag) : 
-            _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) { setHasProperty(flag); }
+            _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) {
+        clearBits();
+        setHasProperty(flag);
+    }
 
     inline PropertyFlags(const QByteArray& fromEncoded) : 
             _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) { decode(fromEncoded); }
 
-    void clear() { _flags.clear(); _maxFlag = INT_MIN; _minFlag = INT_MAX; _trailingFlipped = false; _encodedLength = 0; }
+    void clear() { clearBits(); _maxFlag = INT_MIN; _minFlag = INT_MAX; _trailingFlipped = false; _encodedLength = 0; }
 
     Enum firstFlag() const { return (Enum)_minFlag; }
     Enum lastFlag() const { return (Enum)_maxFlag; }
@@ -53,11 +60,21 @@ public:
     QByteArray encode();
     void decode(const QByteArray& fromEncoded);
 
+    /// The most bytes that encode() can write.
+    static const int MAX_ENCODED_BYTES = (MaxFlags - 1) / (BITS_PER_BYTE - 1) + 1;
+
+    /// Encodes into a buffer of at least MAX_ENCODED_BYTES, returning the number of bytes written.
+    int encode(unsigned char* destination) const;
+
+    /// Decodes from the front of a buffer of the given length, returning the number of bytes the encoding takes up,
+    /// which may be more than the buffer holds if it was cut short, in which case no flags are set.
+    int decode(const unsigned char* encodedBytes, int length);
+
     operator QByteArray() { return encode(); };
 
-    bool operator==(const PropertyFlags& other) const { return _flags == other._flags; }
-    bool operator!=(const PropertyFlags& other) const { return _flags != other._flags; }
-    bool operator!() const { return _flags.size() == 0; }
+    bool operator==(const PropertyFlags& other) const { return memcmp(_flags, other._flags, sizeof(_flags)) == 0; }
+    bool operator!=(const PropertyFlags& other) const { return !(*this == other); }
+    bool operator!() const;
 
     PropertyFlags& operator=(const PropertyFlags& other);
 
@@ -106,25 +123,38 @@ public:
 
 
 private:
+    static const int BITS_PER_WORD = sizeof(quint64) * BITS_PER_BYTE;
+    static const int FLAG_WORDS = (MaxFlags + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
     void shrinkIfNeeded();
 
-    QBitArray _flags;
+    bool testBit(int flag) const { return (_flags[flag / BITS_PER_WORD] >> (flag % BITS_PER_WORD)) & 1; }
+    void clearBits() { memset(_flags, 0, sizeof(_flags)); }
+    void copyBits(const PropertyFlags& other) { memcpy(_flags, other._flags, sizeof(_flags)); }
+
+    quint64 _flags[FLAG_WORDS]; /// the bits past _maxFlag are always clear
     int _maxFlag;
     int _minFlag;
     bool _trailingFlipped; /// are the trailing properties flipping in their state (e.g. assumed true, instead of false)
     int _encodedLength;
 };
 
-template<typename Enum> PropertyFlags<Enum>& operator<<(PropertyFlags<Enum>& out, const PropertyFlags<Enum>& other) {
+template<typename Enum, int MaxFlags>
+PropertyFlags<Enum, MaxFlags>& operator<<(PropertyFlags<Enum, MaxFlags>& out,
+        const PropertyFlags<Enum, MaxFlags>& other) {
     return out <<= other;
 }
 
-template<typename Enum> PropertyFlags<Enum>& operator<<(PropertyFlags<Enum>& out, Enum flag) {
+template<typename Enum, int MaxFlags>
+PropertyFlags<Enum, MaxFlags>& operator<<(PropertyFlags<Enum, MaxFlags>& out, Enum flag) {
     return out <<= flag;
 }
 
-
-template<typename Enum> inline void PropertyFlags<Enum>::setHasProperty(Enum flag, bool value) {
+template<typename Enum, int MaxFlags>
+inline void PropertyFlags<Enum, MaxFlags>::setHasProperty(Enum flag, bool value) {
+    if (flag < 0 || flag >= MaxFlags) {
+        return; // there's no room for it
+    }
     // keep track of our min flag
     if (flag < _minFlag) {
         if (value) {
@@ -134,171 +164,168 @@ template<typename Enum> inline void PropertyFlags<Enum>::setHasProperty(Enum fla
     if (flag > _maxFlag) {
         if (value) {
             _maxFlag = flag;
-            _flags.resize(_maxFlag + 1);
         } else {
             return; // bail early, we're setting a flag outside of our current _maxFlag to false, which is already the default
         }
     }
-    _flags.setBit(flag, value);
+    quint64 bit = (quint64)1 << (flag % BITS_PER_WORD);
+    if (value) {
+        _flags[flag / BITS_PER_WORD] |= bit;
+    } else {
+        _flags[flag / BITS_PER_WORD] &= ~bit;
+    }
     
     if (flag == _maxFlag && !value) {
         shrinkIfNeeded();
     }
 }
 
-template<typename Enum> inline bool PropertyFlags<Enum>::getHasProperty(Enum flag) const {
+template<typename Enum, int MaxFlags>
+inline bool PropertyFlags<Enum, MaxFlags>::getHasProperty(Enum flag) const {
     if (flag > _maxFlag) {
         return _trailingFlipped; // usually false
     }
-    return _flags.testBit(flag);
+    return flag >= 0 && testBit(flag);
 }
 
-const int BITS_PER_BYTE = 8;
-
-template<typename Enum> inline QByteArray PropertyFlags<Enum>::encode() {
-    QByteArray output;
-    
+template<typename Enum, int MaxFlags>
+inline int PropertyFlags<Enum, MaxFlags>::encode(unsigned char* destination) const {
     if (_maxFlag < _minFlag) {
-        output.fill(0, 1);
-        return output; // no flags... nothing to encode
+        destination[0] = 0;
+        return 1; // no flags... nothing to encode
     }
 
     // we should size the array to the correct size.
     int lengthInBytes = (_maxFlag / (BITS_PER_BYTE - 1)) + 1;
-
-    output.fill(0, lengthInBytes);
+    memset(destination, 0, lengthInBytes);
 
     // next pack the number of header bits in, the first N-1 to be set to 1, the last to be set to 0
-    for(int i = 0; i < lengthInBytes; i++) {
-        int outputIndex = i;
-        int bitValue = (i < (lengthInBytes - 1)  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
-        int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+    for (int i = 0; i < lengthInBytes - 1; i++) {
+        destination[i / BITS_PER_BYTE] |= (0x80 >> (i % BITS_PER_BYTE));
     }
 
-    // finally pack the the actual bits from the bit array
-    for(int i = lengthInBytes; i < (lengthInBytes + _maxFlag + 1); i++) {
-        int flagIndex = i - lengthInBytes;
-        int outputIndex = i;
-        int bitValue = ( _flags[flagIndex]  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
-        int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+    // finally pack the the actual bits of the flags
+    for (int flag = 0; flag <= _maxFlag; flag++) {
+        if (testBit(flag)) {
+            int outputIndex = lengthInBytes + flag;
+            destination[outputIndex / BITS_PER_BYTE] |= (0x80 >> (outputIndex % BITS_PER_BYTE));
+        }
     }
-    
-    _encodedLength = lengthInBytes;
-    return output;
+    return lengthInBytes;
 }
 
-template<typename Enum> inline void PropertyFlags<Enum>::decode(const QByteArray& fromEncodedBytes) {
-
+template<typename Enum, int MaxFlags>
+inline int PropertyFlags<Enum, MaxFlags>::decode(const unsigned char* encodedBytes, int length) {
     clear(); // we are cleared out!
 
-    // first convert the ByteArray into a BitArray...
-    QBitArray encodedBits;
-    int bitCount = BITS_PER_BYTE * fromEncodedBytes.count();
-    encodedBits.resize(bitCount);
-    
-    for(int byte = 0; byte < fromEncodedBytes.count(); byte++) {
-        char originalByte = fromEncodedBytes.at(byte);
-        for(int bit = 0; bit < BITS_PER_BYTE; bit++) {
-            int shiftBy = BITS_PER_BYTE - (bit + 1);
-            char maskBit = ( 1 << shiftBy);
-            bool bitValue = originalByte & maskBit;
-            encodedBits.setBit(byte * BITS_PER_BYTE + bit, bitValue);
-        }
-    }
-    
-    // next, read the leading bits to determine the correct number of bytes to decode (may not match the QByteArray)
-    int encodedByteCount = 0;
-    int leadBits = 1;
-    int bitAt;
-    for (bitAt = 0; bitAt < bitCount; bitAt++) {
-        if (encodedBits.at(bitAt)) {
-            encodedByteCount++;
-            leadBits++;
-        } else {
-            break;
-        }
+    // read the leading bits to determine the correct number of bytes to decode (may be fewer than we were given)
+    int bitCount = length * BITS_PER_BYTE;
+    int leadingOnes = 0;
+    while (leadingOnes < bitCount &&
+            (encodedBytes[leadingOnes / BITS_PER_BYTE] & (0x80 >> (leadingOnes % BITS_PER_BYTE)))) {
+        leadingOnes++;
     }
-    encodedByteCount++; // always at least one byte
+    int encodedByteCount = leadingOnes + 1; // always at least one byte
     _encodedLength = encodedByteCount;
 
-    int expectedBitCount = encodedByteCount * BITS_PER_BYTE;
-    
-    // Now, keep reading...
-    if (expectedBitCount <= (encodedBits.size() - leadBits)) {
-        int flagsStartAt = bitAt + 1; 
-        for (bitAt = flagsStartAt; bitAt < expectedBitCount; bitAt++) {
-            if (encodedBits.at(bitAt)) {
+    // the flags follow the zero that ends the header
+    if (encodedByteCount <= length) {
+        int flagsStartAt = encodedByteCount;
+        for (int bitAt = flagsStartAt; bitAt < encodedByteCount * BITS_PER_BYTE; bitAt++) {
+            if (encodedBytes[bitAt / BITS_PER_BYTE] & (0x80 >> (bitAt % BITS_PER_BYTE))) {
                 setHasProperty((Enum)(bitAt - flagsStartAt));
             }
         }
     }
+    return encodedByteCount;
+}
+
+template<typename Enum, int MaxFlags>
+inline QByteArray PropertyFlags<Enum, MaxFlags>::encode() {
+    unsigned char buffer[MAX_ENCODED_BYTES];
+    _encodedLength = encode(buffer);
+    return QByteArray((const char*)buffer, _encodedLength);
 }
 
-template<typename Enum> inline void PropertyFlags<Enum>::debugDumpBits() {
+template<typename Enum, int MaxFlags>
+inline void PropertyFlags<Enum, MaxFlags>::decode(const QByteArray& fromEncodedBytes) {
+    decode((const unsigned char*)fromEncodedBytes.constData(), fromEncodedBytes.size());
+}
+
+template<typename Enum, int MaxFlags>
+inline void PropertyFlags<Enum, MaxFlags>::debugDumpBits() {
     qDebug() << "_minFlag=" << _minFlag;
     qDebug() << "_maxFlag=" << _maxFlag;
     qDebug() << "_trailingFlipped=" << _trailingFlipped;
-    for(int i = 0; i < _flags.size(); i++) {
-        qDebug() << "bit[" << i << "]=" << _flags.at(i);
+    for(int i = 0; i <= _maxFlag; i++) {
+        qDebug() << "bit[" << i << "]=" << testBit(i);
     }
 }
 
+template<typename Enum, int MaxFlags>
+inline bool PropertyFlags<Enum, MaxFlags>::operator!() const {
+    for (int i = 0; i < FLAG_WORDS; i++) {
+        if (_flags[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator=(const PropertyFlags& other) {
-    _flags = other._flags; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator=(const PropertyFlags& other) {
+    copyBits(other);
     _maxFlag = other._maxFlag; 
     _minFlag = other._minFlag; 
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator|=(const PropertyFlags& other) {
-    _flags |= other._flags; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator|=(const PropertyFlags& other) {
+    for (int i = 0; i < FLAG_WORDS; i++) {
+        _flags[i] |= other._flags[i];
+    }
     _maxFlag = std::max(_maxFlag, other._maxFlag); 
     _minFlag = std::min(_minFlag, other._minFlag); 
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator|=(Enum flag) {
-    PropertyFlags other(flag); 
-    _flags |= other._flags; 
-    _maxFlag = std::max(_maxFlag, other._maxFlag); 
-    _minFlag = std::min(_minFlag, other._minFlag); 
-    return *this; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator|=(Enum flag) {
+    return *this |= PropertyFlags(flag);
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator&=(const PropertyFlags& other) {
-    _flags &= other._flags; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator&=(const PropertyFlags& other) {
+    for (int i = 0; i < FLAG_WORDS; i++) {
+        _flags[i] &= other._flags[i];
+    }
     shrinkIfNeeded(); 
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator&=(Enum flag) {
-    PropertyFlags other(flag); 
-    _flags &= other._flags; 
-    shrinkIfNeeded(); 
-    return *this; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator&=(Enum flag) {
+    return *this &= PropertyFlags(flag);
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator^=(const PropertyFlags& other) {
-    _flags ^= other._flags; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator^=(const PropertyFlags& other) {
+    for (int i = 0; i < FLAG_WORDS; i++) {
+        _flags[i] ^= other._flags[i];
+    }
+    _maxFlag = std::max(_maxFlag, other._maxFlag);
     shrinkIfNeeded(); 
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator^=(Enum flag) {
-    PropertyFlags other(flag); 
-    _flags ^= other._flags; 
-    shrinkIfNeeded(); 
-    return *this; 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator^=(Enum flag) {
+    return *this ^= PropertyFlags(flag);
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator+=(const PropertyFlags& other) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator+=(const PropertyFlags& other) {
     for(int flag = (int)other.firstFlag(); flag <= (int)other.lastFlag(); flag++) {
         if (other.getHasProperty((Enum)flag)) {
             setHasProperty((Enum)flag, true);
@@ -307,12 +334,14 @@ template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operato
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator+=(Enum flag) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator+=(Enum flag) {
     setHasProperty(flag, true);
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator-=(const PropertyFlags& other) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator-=(const PropertyFlags& other) {
     for(int flag = (int)other.firstFlag(); flag <= (int)other.lastFlag(); flag++) {
         if (other.getHasProperty((Enum)flag)) {
             setHasProperty((Enum)flag, false);
@@ -321,12 +350,14 @@ template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operato
     return *this;
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator-=(Enum flag) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator-=(Enum flag) {
     setHasProperty(flag, false);
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator<<=(const PropertyFlags& other) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator<<=(const PropertyFlags& other) {
     for(int flag = (int)other.firstFlag(); flag <= (int)other.lastFlag(); flag++) {
         if (other.getHasProperty((Enum)flag)) {
             setHasProperty((Enum)flag, true);
@@ -335,111 +366,123 @@ template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operato
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum>& PropertyFlags<Enum>::operator<<=(Enum flag) {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags>& PropertyFlags<Enum, MaxFlags>::operator<<=(Enum flag) {
     setHasProperty(flag, true);
     return *this; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator|(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator|(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result |= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator|(Enum flag) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator|(Enum flag) const {
     PropertyFlags result(*this); 
     PropertyFlags other(flag); 
     result |= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator&(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator&(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result &= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator&(Enum flag) const { 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator&(Enum flag) const { 
     PropertyFlags result(*this); 
     PropertyFlags other(flag); 
     result &= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator^(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator^(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result ^= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator^(Enum flag) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator^(Enum flag) const {
     PropertyFlags result(*this); 
     PropertyFlags other(flag); 
     result ^= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator+(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator+(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result += other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator+(Enum flag) const { 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator+(Enum flag) const { 
     PropertyFlags result(*this); 
     result.setHasProperty(flag, true);
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator-(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator-(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result -= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator-(Enum flag) const { 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator-(Enum flag) const { 
     PropertyFlags result(*this); 
     result.setHasProperty(flag, false);
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator<<(const PropertyFlags& other) const {
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator<<(const PropertyFlags& other) const {
     PropertyFlags result(*this); 
     result <<= other; 
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator<<(Enum flag) const { 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator<<(Enum flag) const { 
     PropertyFlags result(*this); 
     result.setHasProperty(flag, true);
     return result; 
 }
 
-template<typename Enum> inline PropertyFlags<Enum> PropertyFlags<Enum>::operator~() const { 
+template<typename Enum, int MaxFlags>
+inline PropertyFlags<Enum, MaxFlags> PropertyFlags<Enum, MaxFlags>::operator~() const { 
     PropertyFlags result(*this); 
-    result._flags = ~_flags;
+    for (int flag = 0; flag <= _maxFlag; flag++) {
+        result._flags[flag / BITS_PER_WORD] ^= (quint64)1 << (flag % BITS_PER_WORD);
+    }
     result._trailingFlipped = !_trailingFlipped;
     return result; 
 }
 
-template<typename Enum> inline void PropertyFlags<Enum>::shrinkIfNeeded() {
-    int maxFlagWas = _maxFlag;
-    while (_maxFlag >= 0) {
-        if (_flags.testBit(_maxFlag)) {
-            break;
-        }
+template<typename Enum, int MaxFlags>
+inline void PropertyFlags<Enum, MaxFlags>::shrinkIfNeeded() {
+    while (_maxFlag >= 0 && !testBit(_maxFlag)) {
         _maxFlag--;
     }
-    if (maxFlagWas != _maxFlag) {
-        _flags.resize(_maxFlag + 1);
-    }
 }
 
-template<typename Enum> inline QByteArray& operator<<(QByteArray& out, PropertyFlags<Enum>& value) {
+template<typename Enum, int MaxFlags>
+inline QByteArray& operator<<(QByteArray& out, PropertyFlags<Enum, MaxFlags>& value) {
     return out = value;
 }
 
-template<typename Enum> inline QByteArray& operator>>(QByteArray& in, PropertyFlags<Enum>& value) {
+template<typename Enum, int MaxFlags>
+inline QByteArray& operator>>(QByteArray& in, PropertyFlags<Enum, MaxFlags>& value) {
     value.decode(in);
     return in;
 }
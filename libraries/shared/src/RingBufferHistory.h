@@ -44,14 +44,19 @@ public:
     }
 
     void insert(const T& entry) {
+        insertInPlace() = entry;
+    }
+
+    // makes room for a new entry and returns it, still holding the entry it replaces, to be overwritten in place so
+    // that an entry that owns storage can reuse it
+    T& insertInPlace() {
         // increment newest entry index cyclically
         _newestEntryAtIndex = (_newestEntryAtIndex == _size - 1) ? 0 : _newestEntryAtIndex + 1;
 
-        // insert new entry
-        _buffer[_newestEntryAtIndex] = entry;
         if (_numEntries < _capacity) {
             _numEntries++;
         }
+        return _buffer[_newestEntryAtIndex];
     }
 
     // 0 retrieves the most recent entry, _numEntries - 1 retrieves the oldest.
@@ -35,18 +35,17 @@ namespace Setting {
         Handle(const QString& key, const T& defaultValue) : Interface(key), _defaultValue(defaultValue) {}
         Handle(const QStringList& path, const T& defaultValue) : Handle(path.join("/"), defaultValue) {}
         
-        virtual ~Handle() { save(); }
-        
         // Returns setting value, returns its default value if not found
         T get() { return get(_defaultValue); }
         // Returns setting value, returns other if not found
         T get(const T& other) { maybeInit(); return (_isSet) ? _value : other; }
         T getDefault() const { return _defaultValue; }
         
-        void set(const T& value) { maybeInit(); _value = value; _isSet = true; }
+        // The value is queued for the settings thread to write out, so setting it is cheap.
+        void set(const T& value) { maybeInit(); _value = value; _isSet = true; save(); }
         void reset() { set(_defaultValue); }
         
-        void remove() { maybeInit(); _isSet = false; }
+        void remove() { maybeInit(); _isSet = false; save(); }
         
     protected:
         virtual void setVariant(const QVariant& variant);
@@ -59,8 +58,10 @@ namespace Setting {
     
     template <typename T>
     void Handle<T>::setVariant(const QVariant& variant) {
+        // loaded from the manager, so there's nothing to save
         if (variant.canConvert<T>() || std::is_same<T, QVariant>::value) {
-            set(variant.value<T>());
+            _value = variant.value<T>();
+            _isSet = true;
         }
     }
 }
@@ -22,7 +22,6 @@ namespace Setting {
         
         // Save all settings before exit
         saveAll();
-        sync();
     }
     
     void Manager::registerHandle(Setting::Interface* handle) {
@@ -38,15 +37,45 @@ namespace Setting {
     }
     
     void Manager::loadSetting(Interface* handle) {
-        handle->setVariant(value(handle->getKey()));
+        QString key = handle->getKey();
+        QVariant variant;
+        bool cached = false;
+        {
+            QMutexLocker locker(&_valuesMutex);
+            QHash<QString, QVariant>::const_iterator it = _values.constFind(key);
+            if (it != _values.constEnd()) {
+                variant = it.value();
+                cached = true;
+            }
+        }
+        if (!cached) {
+            {
+                QMutexLocker settingsLocker(&_settingsMutex);
+                variant = value(key);
+            }
+            QMutexLocker locker(&_valuesMutex);
+            QHash<QString, QVariant>::const_iterator it = _values.constFind(key);
+            if (it != _values.constEnd()) {
+                // set while we were reading, which is newer
+                variant = it.value();
+            } else {
+                _values.insert(key, variant);
+            }
+        }
+        handle->setVariant(variant);
     }
     
     void Manager::saveSetting(Interface* handle) {
-        if (handle->isSet()) {
-            setValue(handle->getKey(), handle->getVariant());
-        } else {
-            remove(handle->getKey());
+        QString key = handle->getKey();
+        QVariant variant = handle->isSet() ? handle->getVariant() : QVariant();
+        
+        QMutexLocker locker(&_valuesMutex);
+        QHash<QString, QVariant>::iterator it = _values.find(key);
+        if (it != _values.end() && it.value() == variant) {
+            return;
         }
+        _values.insert(key, variant);
+        _pendingChanges.insert(key, variant);
     }
     
     static const int SAVE_INTERVAL_MSEC = 5 * 1000; // 5 sec
@@ -68,8 +97,22 @@ namespace Setting {
     }
     
     void Manager::saveAll() {
-        for (auto handle : _handles) {
-            saveSetting(handle);
+        QHash<QString, QVariant> changes;
+        {
+            QMutexLocker locker(&_valuesMutex);
+            changes.swap(_pendingChanges);
+        }
+        if (!changes.isEmpty()) {
+            // only what changed since the last save goes out, inside one sync
+            QMutexLocker settingsLocker(&_settingsMutex);
+            for (QHash<QString, QVariant>::const_iterator it = changes.constBegin(); it != changes.constEnd(); it++) {
+                if (it.value().isValid()) {
+                    setValue(it.key(), it.value());
+                } else {
+                    remove(it.key());
+                }
+            }
+            sync();
         }
         
         // Restart timer
@@ -12,6 +12,8 @@
 #ifndef hifi_SettingManager_h
 #define hifi_SettingManager_h
 
+#include <QHash>
+#include <QMutex>
 #include <QPointer>
 #include <QSettings>
 #include <QTimer>
@@ -19,6 +21,8 @@
 namespace Setting {
     class Interface;
     
+    /// Keeps the settings in memory for the handles to read, and writes the ones that changed out on a thread of its
+    /// own, so that neither reading nor saving them waits on the disk or the registry.
     class Manager : public QSettings {
         Q_OBJECT
     protected:
@@ -26,7 +30,10 @@ namespace Setting {
         void registerHandle(Interface* handle);
         void removeHandle(const QString& key);
         
+        /// Gives the handle its value, from memory if it was read or set before.
         void loadSetting(Interface* handle);
+        
+        /// Queues the handle's value to be written out, if it changed.
         void saveSetting(Interface* handle);
         
     private slots:
@@ -39,6 +46,11 @@ namespace Setting {
         QHash<QString, Interface*> _handles;
         QPointer<QTimer> _saveTimer = nullptr;
         
+        QMutex _valuesMutex; // guards the values and changes, which the handles' threads and this one share
+        QHash<QString, QVariant> _values; // as read or last set, an invalid variant for a key that isn't stored
+        QHash<QString, QVariant> _pendingChanges; // to be written on the next save, an invalid variant to remove
+        QMutex _settingsMutex; // held while the settings themselves are read or written
+        
         friend class Interface;
         friend void cleanupPrivateInstance();
         friend void setupPrivateInstance();
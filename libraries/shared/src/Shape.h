@@ -38,6 +38,7 @@ const quint8 INVALID_SHAPE = 5;
 // new shapes to be supported by Bullet
 const quint8 BOX_SHAPE = 7;
 const quint8 CYLINDER_SHAPE = 8;
+const quint8 COMPOUND_SHAPE = 9;
 
 class Shape {
 public:
@@ -9,6 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <float.h>
+#include <string.h>
+
 #include <glm/gtx/norm.hpp>
 
 #include "AACubeShape.h"
@@ -108,15 +111,89 @@ bool collideShapeWithShapes(const Shape* shapeA, const QVector<Shape*>& shapes,
     return collided;
 }
 
+static ShapeBatch tempBatch;
+
 bool collideShapesWithShapes(const QVector<Shape*>& shapesA, const QVector<Shape*>& shapesB, CollisionList& collisions) {
     bool collided = false;
+    tempBatch.clear();
+    tempBatch.add(shapesB);
     int numShapesA = shapesA.size();
     for (int i = 0; i < numShapesA; ++i) {
         Shape* shapeA = shapesA.at(i);
         if (!shapeA) {
             continue;
         }
-        if (collideShapeWithShapes(shapeA, shapesB, 0, collisions)) {
+        if (collideShapeWithBatch(shapeA, tempBatch, collisions)) {
+            collided = true;
+            if (collisions.isFull()) {
+                break;
+            }
+        }
+    }
+    return collided;
+}
+
+// the bounding radius of a sphere or capsule is around its translation, the others don't keep a meaningful one
+static bool hasBoundingSphere(Shape::Type type) {
+    return type == SPHERE_SHAPE || type == CAPSULE_SHAPE;
+}
+
+void ShapeBatch::clear() {
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _radius.clear();
+    _shapes.clear();
+}
+
+void ShapeBatch::add(const Shape* shape) {
+    if (!shape) {
+        return;
+    }
+    const glm::vec3& translation = shape->getTranslation();
+    _x.push_back(translation.x);
+    _y.push_back(translation.y);
+    _z.push_back(translation.z);
+    // a shape we can't bound always passes the cull
+    _radius.push_back(hasBoundingSphere(shape->getType()) ? shape->getBoundingRadius() : FLT_MAX);
+    _shapes.push_back(shape);
+}
+
+void ShapeBatch::add(const QVector<Shape*>& shapes, int startIndex) {
+    int numShapes = shapes.size();
+    for (int i = startIndex; i < numShapes; ++i) {
+        add(shapes.at(i));
+    }
+}
+
+bool collideShapeWithBatch(const Shape* shapeA, const ShapeBatch& batch, CollisionList& collisions) {
+    int numShapes = batch._shapes.size();
+    if (!shapeA || numShapes == 0) {
+        return false;
+    }
+    batch._overlaps.resize(numShapes);
+    char* overlaps = batch._overlaps.data();
+    if (hasBoundingSphere(shapeA->getType())) {
+        const glm::vec3& center = shapeA->getTranslation();
+        float radiusA = shapeA->getBoundingRadius();
+        const float* x = batch._x.constData();
+        const float* y = batch._y.constData();
+        const float* z = batch._z.constData();
+        const float* radius = batch._radius.constData();
+        for (int i = 0; i < numShapes; ++i) {
+            float dx = x[i] - center.x;
+            float dy = y[i] - center.y;
+            float dz = z[i] - center.z;
+            float reach = radiusA + radius[i];
+            overlaps[i] = (dx * dx + dy * dy + dz * dz <= reach * reach);
+        }
+    } else {
+        memset(overlaps, 1, numShapes);
+    }
+
+    bool collided = false;
+    for (int i = 0; i < numShapes; ++i) {
+        if (overlaps[i] && collideShapes(shapeA, batch._shapes[i], collisions)) {
             collided = true;
             if (collisions.isFull()) {
                 break;
@@ -25,6 +25,8 @@ class CapsuleShape;
 
 namespace ShapeCollider {
 
+    class ShapeBatch;
+
     /// MUST CALL this FIRST before using the ShapeCollider
     void initDispatchTable();
 
@@ -37,6 +39,34 @@ namespace ShapeCollider {
     bool collideShapeWithShapes(const Shape* shapeA, const QVector<Shape*>& shapes, int startIndex, CollisionList& collisions);
     bool collideShapesWithShapes(const QVector<Shape*>& shapesA, const QVector<Shape*>& shapesB, CollisionList& collisions);
 
+    /// \param shapeA pointer to a shape (may be NULL)
+    /// \param batch the shapes to collide against
+    /// \param[out] collisions where to append collision details, in the order the shapes were added to the batch
+    /// \return true if shapeA collides with any shape of the batch
+    bool collideShapeWithBatch(const Shape* shapeA, const ShapeBatch& batch, CollisionList& collisions);
+
+    /// The bounding spheres of a list of shapes in arrays. A sphere or capsule is culled against all of them in one
+    /// pass over contiguous floats the compiler vectorizes, and only the shapes it may touch go through the dispatch
+    /// table. Shapes of other types have no bounding sphere to cull with and are always dispatched.
+    class ShapeBatch {
+    public:
+        void clear();
+        void add(const Shape* shape);
+        void add(const QVector<Shape*>& shapes, int startIndex = 0);
+
+        int size() const { return _shapes.size(); }
+
+    private:
+        QVector<float> _x;
+        QVector<float> _y;
+        QVector<float> _z;
+        QVector<float> _radius;
+        QVector<const Shape*> _shapes;
+        mutable QVector<char> _overlaps; // scratch for collideShapeWithBatch()
+
+        friend bool collideShapeWithBatch(const Shape* shapeA, const ShapeBatch& batch, CollisionList& collisions);
+    };
+
     /// \param shapeA a pointer to a shape (cannot be NULL)
     /// \param cubeCenter center of cube
     /// \param cubeSide lenght of side of cube
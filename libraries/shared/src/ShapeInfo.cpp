@@ -19,6 +19,8 @@
 void ShapeInfo::clear() {
     _type = INVALID_SHAPE;
     _data.clear();
+    _convexHulls.clear();
+    _url.clear();
 }
 
 void ShapeInfo::setBox(const glm::vec3& halfExtents) {
@@ -50,12 +52,23 @@ void ShapeInfo::setCapsule(float radius, float halfHeight) {
     _data.push_back(glm::vec3(radius, halfHeight, radius));
 }
 
+void ShapeInfo::setConvexHulls(const glm::vec3& halfExtents, const QVector<QVector<glm::vec3> >& hulls,
+                               const QString& url) {
+    _type = COMPOUND_SHAPE;
+    _data.clear();
+    // _data[0] = < halfX, halfY, halfZ > of the box the hulls fill
+    _data.push_back(halfExtents);
+    _convexHulls = hulls;
+    _url = url;
+}
+
 glm::vec3 ShapeInfo::getBoundingBoxDiagonal() const {
     switch(_type) {
         case BOX_SHAPE:
         case SPHERE_SHAPE:
         case CYLINDER_SHAPE:
         case CAPSULE_SHAPE:
+        case COMPOUND_SHAPE:
             return 2.0f * _data[0];
         default:
             break;
@@ -67,8 +80,10 @@ float ShapeInfo::computeVolume() const {
     const float DEFAULT_VOLUME = 1.0f;
     float volume = DEFAULT_VOLUME;
     switch(_type) {
-        case BOX_SHAPE: {
+        case BOX_SHAPE:
+        case COMPOUND_SHAPE: {
             // factor of 8.0 because the components of _data[0] are all halfExtents
+            // NOTE: the hulls of a compound fill at most their box, so this overestimates its volume
             volume = 8.0f * _data[0].x * _data[0].y * _data[0].z;
             break;
         }
@@ -12,6 +12,7 @@
 #ifndef hifi_ShapeInfo_h
 #define hifi_ShapeInfo_h
 
+#include <QString>
 #include <QVector>
 #include <glm/glm.hpp>
 
@@ -28,8 +29,14 @@ public:
     void setCylinder(float radius, float halfHeight);
     void setCapsule(float radius, float halfHeight);
 
+    /// a compound of convex hulls whose points are in meters relative to the center of a box of halfExtents,
+    /// the url of the model they were built from tells the hulls of different models the same size apart
+    void setConvexHulls(const glm::vec3& halfExtents, const QVector<QVector<glm::vec3> >& hulls, const QString& url);
+
     const int getType() const { return _type; }
     const QVector<glm::vec3>& getData() const { return _data; }
+    const QVector<QVector<glm::vec3> >& getConvexHulls() const { return _convexHulls; }
+    const QString& getURL() const { return _url; }
 
     glm::vec3 getBoundingBoxDiagonal() const;
     float computeVolume() const;
@@ -37,6 +44,8 @@ public:
 protected:
     int _type;
     QVector<glm::vec3> _data;
+    QVector<QVector<glm::vec3> > _convexHulls;
+    QString _url;
 };
 
 #endif // hifi_ShapeInfo_h
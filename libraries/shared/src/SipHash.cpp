@@ -0,0 +1,89 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+// the byte order is fixed by the algorithm, so words are assembled a byte at a time rather than loaded
+static inline quint64 readLittleEndian(const uchar* source) {
+    quint64 word = 0;
+    for (int i = 7; i >= 0; i--) {
+        word = (word << 8) | source[i];
+    }
+    return word;
+}
+
+static inline void writeLittleEndian(quint64 word, uchar* destination) {
+    for (int i = 0; i < 8; i++) {
+        destination[i] = (uchar)(word >> (i * 8));
+    }
+}
+
+static inline quint64 rotateLeft(quint64 word, int bits) {
+    return (word << bits) | (word >> (64 - bits));
+}
+
+static inline void sipRound(quint64& v0, quint64& v1, quint64& v2, quint64& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+void SipHash::hash128(const uchar* key, const uchar* data, int length, uchar* hash) {
+    quint64 k0 = readLittleEndian(key);
+    quint64 k1 = readLittleEndian(key + 8);
+    quint64 v0 = k0 ^ 0x736f6d6570736575ULL;
+    quint64 v1 = k1 ^ 0x646f72616e646f6dULL ^ 0xee;
+    quint64 v2 = k0 ^ 0x6c7967656e657261ULL;
+    quint64 v3 = k1 ^ 0x7465646279746573ULL;
+
+    // two rounds for each whole word
+    const uchar* end = data + (length & ~7);
+    for (const uchar* word = data; word != end; word += 8) {
+        quint64 message = readLittleEndian(word);
+        v3 ^= message;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= message;
+    }
+
+    // the last word holds the leftover bytes and the low byte of the length
+    quint64 last = (quint64)length << 56;
+    for (int i = (length & 7) - 1; i >= 0; i--) {
+        last |= (quint64)end[i] << (i * 8);
+    }
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    // four rounds for each half of the result
+    v2 ^= 0xee;
+    for (int i = 0; i < 4; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, hash);
+
+    v1 ^= 0xdd;
+    for (int i = 0; i < 4; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, hash + 8);
+}
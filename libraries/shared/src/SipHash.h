@@ -0,0 +1,26 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <QtGlobal>
+
+/// SipHash-2-4, a keyed hash built to authenticate short messages.  It takes a few cycles a byte where MD5 takes
+/// several times that, and a forged message can't be made to match without the key.
+namespace SipHash {
+    const int KEY_BYTES = 16;
+    const int HASH_BYTES = 16;
+
+    /// hashes length bytes of data under the key, writing the 128 bit variant's HASH_BYTES to hash
+    void hash128(const uchar* key, const uchar* data, int length, uchar* hash);
+}
+
+#endif // hifi_SipHash_h
@@ -0,0 +1,93 @@
+//
+//  SlabAllocator.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <new>
+
+#include <QtCore/QMutex>
+
+#include "SlabAllocator.h"
+
+static const size_t SIZE_CLASS_GRANULARITY = 16;
+static const size_t NUM_SIZE_CLASSES = SlabAllocator::MAX_POOLED_SIZE / SIZE_CLASS_GRANULARITY;
+static const size_t SLAB_BYTES = 64 * 1024;
+
+class SlabPool {
+public:
+    SlabPool() : freeList(NULL), slabBytes(0) { }
+
+    QMutex mutex;
+    void* freeList; // each free block starts with the pointer to the next one
+    quint64 slabBytes;
+};
+
+static SlabPool& poolForSizeClass(size_t sizeClass) {
+    // function local so that elements can be allocated during static initialization
+    static SlabPool pools[NUM_SIZE_CLASSES];
+    return pools[sizeClass];
+}
+
+static size_t sizeClassForSize(size_t size) {
+    return size == 0 ? 0 : (size - 1) / SIZE_CLASS_GRANULARITY;
+}
+
+void* SlabAllocator::allocate(size_t size) {
+    if (size > MAX_POOLED_SIZE) {
+        return ::operator new(size);
+    }
+
+    size_t sizeClass = sizeClassForSize(size);
+    SlabPool& pool = poolForSizeClass(sizeClass);
+
+    QMutexLocker locker(&pool.mutex);
+    if (!pool.freeList) {
+        // thread the new slab's blocks onto the free list in address order, so they are handed out front to back
+        size_t blockSize = (sizeClass + 1) * SIZE_CLASS_GRANULARITY;
+        size_t numBlocks = SLAB_BYTES / blockSize;
+        char* slab = static_cast<char*>(::operator new(numBlocks * blockSize));
+        pool.slabBytes += numBlocks * blockSize;
+
+        for (size_t i = 0; i < numBlocks; i++) {
+            char* block = slab + i * blockSize;
+            *reinterpret_cast<void**>(block) = (i + 1 < numBlocks) ? block + blockSize : NULL;
+        }
+        pool.freeList = slab;
+    }
+
+    void* block = pool.freeList;
+    pool.freeList = *reinterpret_cast<void**>(block);
+    return block;
+}
+
+void SlabAllocator::free(void* block, size_t size) {
+    if (!block) {
+        return;
+    }
+
+    if (size > MAX_POOLED_SIZE) {
+        ::operator delete(block);
+        return;
+    }
+
+    SlabPool& pool = poolForSizeClass(sizeClassForSize(size));
+
+    QMutexLocker locker(&pool.mutex);
+    *reinterpret_cast<void**>(block) = pool.freeList;
+    pool.freeList = block;
+}
+
+quint64 SlabAllocator::getSlabMemoryUsage() {
+    quint64 slabMemoryUsage = 0;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        SlabPool& pool = poolForSizeClass(i);
+        QMutexLocker locker(&pool.mutex);
+        slabMemoryUsage += pool.slabBytes;
+    }
+    return slabMemoryUsage;
+}
@@ -0,0 +1,36 @@
+//
+//  SlabAllocator.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SlabAllocator_h
+#define hifi_SlabAllocator_h
+
+#include <stddef.h>
+
+#include <QtCore/QtGlobal>
+
+/// Hands out the memory for small objects created by the million: octree elements and their child arrays, metavoxel
+/// nodes and shared objects. Blocks of the same size class are carved in order out of large slabs, so objects created
+/// together (the children of an element, a subtree read from a packet) end up next to each other in memory without the
+/// heap's per-block header. Freed blocks go on a free list for their size class and are never given back to the
+/// system, a tree that shrinks keeps its slabs for the objects it grows next.
+class SlabAllocator {
+public:
+    /// returns a block of at least size bytes, sizes above MAX_POOLED_SIZE come straight from the heap
+    static void* allocate(size_t size);
+
+    /// size must be the size the block was allocated with
+    static void free(void* block, size_t size);
+
+    static quint64 getSlabMemoryUsage();
+
+    static const size_t MAX_POOLED_SIZE = 1024;
+};
+
+#endif // hifi_SlabAllocator_h
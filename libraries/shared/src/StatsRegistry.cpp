@@ -0,0 +1,178 @@
+//
+//  StatsRegistry.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+
+#include "StatsRegistry.h"
+
+StatsRegistry::BlockLease::~BlockLease() {
+    // the block keeps its counts, which the next thread to take it over adds to
+    QMutexLocker locker(&registry->_mutex);
+    registry->_freeBlocks.append(block);
+}
+
+StatsRegistry::StatsRegistry() :
+    _slotCount(0)
+{
+    memset(_baselines, 0, sizeof(_baselines));
+}
+
+StatsRegistry::~StatsRegistry() {
+    // the leases of the other threads still running are left to them, and are never used again
+    if (_threadBlocks.hasLocalData()) {
+        _threadBlocks.setLocalData(NULL);
+    }
+    foreach (ThreadBlock* block, _blocks) {
+        delete block;
+    }
+}
+
+int StatsRegistry::registerCounter(const QString& name) {
+    return registerStat(name, false, QVector<quint64>());
+}
+
+int StatsRegistry::registerHistogram(const QString& name, const QVector<quint64>& bucketLimits) {
+    return registerStat(name, true, bucketLimits);
+}
+
+void StatsRegistry::add(int counter, quint64 amount) {
+    addToSlot(getThreadBlock(), counter, amount);
+}
+
+void StatsRegistry::record(int histogram, quint64 sample) {
+    const QVector<quint64>& bucketLimits = _stats[histogram].bucketLimits;
+    int bucket = 0;
+    while (bucket < bucketLimits.size() && sample > bucketLimits.at(bucket)) {
+        bucket++;
+    }
+    ThreadBlock* block = getThreadBlock();
+    addToSlot(block, histogram + bucket * 2, 1);
+    addToSlot(block, histogram + bucket * 2 + 1, sample);
+}
+
+quint64 StatsRegistry::getCount(int counter) const {
+    QMutexLocker locker(&_mutex);
+    return sumSlot(counter) - _baselines[counter];
+}
+
+QVector<StatsRegistry::Bucket> StatsRegistry::getHistogram(int histogram) const {
+    QMutexLocker locker(&_mutex);
+    QVector<Bucket> buckets(_stats[histogram].bucketLimits.size() + 2);
+    Bucket& whole = buckets.last();
+    for (int bucket = 0; bucket < buckets.size() - 1; bucket++) {
+        int slot = histogram + bucket * 2;
+        buckets[bucket].count = sumSlot(slot) - _baselines[slot];
+        buckets[bucket].sum = sumSlot(slot + 1) - _baselines[slot + 1];
+        whole.count += buckets.at(bucket).count;
+        whole.sum += buckets.at(bucket).sum;
+    }
+    return buckets;
+}
+
+void StatsRegistry::reset() {
+    QMutexLocker locker(&_mutex);
+    for (int slot = 0; slot < _slotCount; slot++) {
+        _baselines[slot] = sumSlot(slot);
+    }
+}
+
+QJsonObject StatsRegistry::toJson() const {
+    QMutexLocker locker(&_mutex);
+    QJsonObject statsObject;
+    for (int id = 0; id < _slotCount; ) {
+        const Stat& stat = _stats[id];
+        if (!stat.isHistogram) {
+            statsObject[stat.name] = (double)sumSlot(id);
+            id++;
+            continue;
+        }
+        QJsonArray bucketsArray;
+        quint64 count = 0;
+        quint64 sum = 0;
+        for (int bucket = 0; bucket <= stat.bucketLimits.size(); bucket++) {
+            QJsonObject bucketObject;
+            if (bucket < stat.bucketLimits.size()) {
+                bucketObject["limit"] = (double)stat.bucketLimits.at(bucket);
+            }
+            quint64 bucketCount = sumSlot(id + bucket * 2);
+            quint64 bucketSum = sumSlot(id + bucket * 2 + 1);
+            bucketObject["count"] = (double)bucketCount;
+            bucketObject["sum"] = (double)bucketSum;
+            bucketsArray.append(bucketObject);
+            count += bucketCount;
+            sum += bucketSum;
+        }
+        QJsonObject histogramObject;
+        histogramObject["count"] = (double)count;
+        histogramObject["sum"] = (double)sum;
+        histogramObject["buckets"] = bucketsArray;
+        statsObject[stat.name] = histogramObject;
+        id += (stat.bucketLimits.size() + 1) * 2;
+    }
+    return statsObject;
+}
+
+int StatsRegistry::registerStat(const QString& name, bool isHistogram, const QVector<quint64>& bucketLimits) {
+    QMutexLocker locker(&_mutex);
+    QHash<QString, int>::const_iterator existing = _statIDs.constFind(name);
+    if (existing != _statIDs.constEnd()) {
+        return existing.value();
+    }
+    int slotCount = isHistogram ? (bucketLimits.size() + 1) * 2 : 1;
+    if (_slotCount + slotCount > MAX_SLOTS) {
+        qWarning() << "StatsRegistry is out of slots, so" << name << "shares the first stat's.";
+        return 0;
+    }
+    int id = _slotCount;
+    _slotCount += slotCount;
+    _stats[id].name = name;
+    _stats[id].isHistogram = isHistogram;
+    _stats[id].bucketLimits = bucketLimits;
+    _statIDs.insert(name, id);
+    return id;
+}
+
+StatsRegistry::ThreadBlock* StatsRegistry::getThreadBlock() {
+    if (_threadBlocks.hasLocalData()) {
+        return _threadBlocks.localData()->block;
+    }
+    ThreadBlock* block;
+    {
+        QMutexLocker locker(&_mutex);
+        if (_freeBlocks.isEmpty()) {
+            block = new ThreadBlock();
+            for (int slot = 0; slot < MAX_SLOTS; slot++) {
+                block->slots[slot].store(0, std::memory_order_relaxed);
+            }
+            _blocks.append(block);
+        } else {
+            block = _freeBlocks.takeLast();
+        }
+    }
+    _threadBlocks.setLocalData(new BlockLease(this, block));
+    return block;
+}
+
+void StatsRegistry::addToSlot(ThreadBlock* block, int slot, quint64 amount) {
+    // we're the only writer of our block, so there's no need for the cost of an atomic add
+    std::atomic<quint64>& value = block->slots[slot];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+quint64 StatsRegistry::sumSlot(int slot) const {
+    quint64 sum = 0;
+    foreach (ThreadBlock* block, _blocks) {
+        sum += block->slots[slot].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
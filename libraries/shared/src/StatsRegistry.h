@@ -0,0 +1,119 @@
+//
+//  StatsRegistry.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_StatsRegistry_h
+#define hifi_StatsRegistry_h
+
+#include <atomic>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+/// Named counters and histograms that any number of threads add to.  Each thread adds into a block of its own, padded
+/// so that no two threads share a cache line, and only the thread that owns a block writes to it, so adding is a plain
+/// load and store.  The blocks are summed when the stats are read, which is where the cost goes.  Resets only move the
+/// baseline that reads are taken from, and never touch the blocks.
+class StatsRegistry {
+public:
+
+    /// The count and sum of the samples in a bucket of a histogram.
+    class Bucket {
+    public:
+        Bucket() : count(0), sum(0) { }
+
+        quint64 count;
+        quint64 sum;
+    };
+
+    StatsRegistry();
+    ~StatsRegistry();
+
+    /// Registers a counter, returning the ID to add to it by.  Registering a name again returns the same ID.  The stats
+    /// should be registered before the threads that add to them start.
+    int registerCounter(const QString& name);
+
+    /// Registers a histogram with a bucket for the samples up to and including each limit, and one for those past the
+    /// last, returning the ID to record samples in it by.  With no limits, it keeps just the count and sum of them.
+    int registerHistogram(const QString& name, const QVector<quint64>& bucketLimits = QVector<quint64>());
+
+    /// Adds to a counter, in the calling thread's block.
+    void add(int counter, quint64 amount = 1);
+
+    /// Records a sample in a histogram, in the calling thread's block.
+    void record(int histogram, quint64 sample);
+
+    /// Returns a counter summed over the threads since the last reset.
+    quint64 getCount(int counter) const;
+
+    /// Returns a histogram's buckets summed over the threads since the last reset, followed by the whole of it.
+    QVector<Bucket> getHistogram(int histogram) const;
+
+    /// Starts the counts read from over.
+    void reset();
+
+    /// The totals since the registry was made, the counters by name and the histograms as their counts, sums and
+    /// buckets.
+    QJsonObject toJson() const;
+
+    /// The most slots that the counters, and the two for each bucket of the histograms, can take up.
+    static const int MAX_SLOTS = 256;
+
+private:
+    Q_DISABLE_COPY(StatsRegistry)
+
+    static const int CACHE_LINE_BYTES = 64;
+
+    class ThreadBlock {
+    public:
+        char leadingPadding[CACHE_LINE_BYTES];
+        std::atomic<quint64> slots[MAX_SLOTS];
+        char trailingPadding[CACHE_LINE_BYTES];
+    };
+
+    /// Holds a block for a thread, and hands it back for another thread to take over when the thread finishes.
+    class BlockLease {
+    public:
+        BlockLease(StatsRegistry* registry, ThreadBlock* block) : registry(registry), block(block) { }
+        ~BlockLease();
+
+        StatsRegistry* registry;
+        ThreadBlock* block;
+    };
+
+    class Stat {
+    public:
+        Stat() : isHistogram(false) { }
+
+        QString name;
+        bool isHistogram;
+        QVector<quint64> bucketLimits;
+    };
+
+    int registerStat(const QString& name, bool isHistogram, const QVector<quint64>& bucketLimits);
+    ThreadBlock* getThreadBlock();
+    static void addToSlot(ThreadBlock* block, int slot, quint64 amount);
+    quint64 sumSlot(int slot) const;
+
+    QThreadStorage<BlockLease*> _threadBlocks;
+
+    mutable QMutex _mutex;
+    QVector<ThreadBlock*> _blocks;
+    QVector<ThreadBlock*> _freeBlocks;
+    QHash<QString, int> _statIDs;
+    Stat _stats[MAX_SLOTS]; ///< by the first slot of each, which is its ID
+    int _slotCount;
+    quint64 _baselines[MAX_SLOTS];
+};
+
+#endif // hifi_StatsRegistry_h
@@ -0,0 +1,56 @@
+//
+//  TimerWheel.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtAlgorithms>
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(quint64 tickUsecs, int slotCount) :
+    _tickUsecs(tickUsecs),
+    _slots(slotCount),
+    _currentTick(0),
+    _scheduledCount(0) {
+}
+
+void TimerWheel::schedule(int id, quint64 due) {
+    // a timer that is already due goes in the current slot, which the next advance visits first
+    quint64 tick = qMax(due / _tickUsecs, _currentTick);
+    Entry entry = { due, id };
+    _slots[tick % _slots.size()].append(entry);
+    _scheduledCount++;
+}
+
+void TimerWheel::advance(quint64 now, QVector<int>& dueIDs) {
+    quint64 nowTick = now / _tickUsecs;
+
+    // the current tick's slot is visited again next time, for the timers due later in the tick; after a long pause,
+    // one turn of the wheel visits every slot
+    quint64 tickCount = (nowTick >= _currentTick) ? qMin(nowTick - _currentTick + 1, (quint64)_slots.size()) : 1;
+    for (quint64 i = 0; i < tickCount; i++) {
+        QVector<Entry>& slot = _slots[(_currentTick + i) % _slots.size()];
+        for (int j = 0; j < slot.size(); ) {
+            if (slot.at(j).due <= now) {
+                _dueEntries.append(slot.at(j));
+                slot[j] = slot.last();
+                slot.removeLast();
+            } else {
+                j++;
+            }
+        }
+    }
+    _currentTick = qMax(nowTick, _currentTick);
+
+    qSort(_dueEntries);
+    foreach (const Entry& entry, _dueEntries) {
+        dueIDs.append(entry.id);
+    }
+    _scheduledCount -= _dueEntries.size();
+    _dueEntries.resize(0);
+}
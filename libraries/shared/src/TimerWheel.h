@@ -0,0 +1,52 @@
+//
+//  TimerWheel.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <QVector>
+
+/// A hashed wheel of timers, for keeping thousands of them without a system timer each.  A timer goes in the slot of
+/// the tick it comes due in, so scheduling one takes constant time, and each advance visits only the slots of the ticks
+/// that have gone by; a timer due more than a turn of the wheel ahead waits in its slot for the turns to pass.  The
+/// wheel knows timers only by id, so the owner cancels one in constant time by forgetting the id and ignoring it when
+/// it comes due.
+class TimerWheel {
+public:
+
+    TimerWheel(quint64 tickUsecs, int slotCount);
+
+    /// Schedules the timer with the given id to come due at the given time, in microseconds.
+    void schedule(int id, quint64 due);
+
+    /// Removes the timers that are due by the given time and appends their ids to the list, soonest first.
+    void advance(quint64 now, QVector<int>& dueIDs);
+
+    /// Returns the number of timers in the wheel, counting any that their owner has since forgotten.
+    int getScheduledCount() const { return _scheduledCount; }
+
+private:
+
+    class Entry {
+    public:
+        quint64 due;
+        int id;
+
+        bool operator<(const Entry& other) const { return due < other.due || (due == other.due && id < other.id); }
+    };
+
+    quint64 _tickUsecs;
+    QVector<QVector<Entry> > _slots;
+    quint64 _currentTick;
+    int _scheduledCount;
+    QVector<Entry> _dueEntries;
+};
+
+#endif // hifi_TimerWheel_h
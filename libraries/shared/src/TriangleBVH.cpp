@@ -0,0 +1,178 @@
+//
+//  TriangleBVH.cpp
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "TriangleBVH.h"
+
+// the traversal stack grows by at most one for each level, and median splits of as many triangles as an int counts
+// make fewer than 32 of those
+const int MAX_TRAVERSAL_DEPTH = 64;
+
+static glm::vec3 getCentroid(const Triangle& triangle) {
+    return (triangle.v0 + triangle.v1 + triangle.v2) / 3.0f;
+}
+
+TriangleBVH::TriangleBVH(const QVector<Triangle>& triangles) :
+    _triangles(triangles) {
+    
+    if (_triangles.isEmpty()) {
+        return;
+    }
+    
+    // a median split halves the triangles at each level, so there are fewer than twice as many nodes as leaves
+    _nodes.reserve(2 * (_triangles.size() / MAX_LEAF_TRIANGLES + 1));
+    
+    // the ranges of triangles still to be split, each with the node to be made for it
+    class Range {
+    public:
+        int first;
+        int count;
+        int node;
+    };
+    QVector<Range> ranges;
+    Node root = { glm::vec3(), glm::vec3(), 0, 0 };
+    _nodes.append(root);
+    Range rootRange = { 0, _triangles.size(), 0 };
+    ranges.append(rootRange);
+    
+    while (!ranges.isEmpty()) {
+        Range range = ranges.takeLast();
+        Triangle* first = _triangles.data() + range.first;
+        Triangle* last = first + range.count;
+        
+        glm::vec3 minimum = glm::min(glm::min(first->v0, first->v1), first->v2);
+        glm::vec3 maximum = glm::max(glm::max(first->v0, first->v1), first->v2);
+        glm::vec3 minimumCentroid = getCentroid(*first);
+        glm::vec3 maximumCentroid = minimumCentroid;
+        for (const Triangle* triangle = first + 1; triangle != last; triangle++) {
+            minimum = glm::min(minimum, glm::min(glm::min(triangle->v0, triangle->v1), triangle->v2));
+            maximum = glm::max(maximum, glm::max(glm::max(triangle->v0, triangle->v1), triangle->v2));
+            glm::vec3 centroid = getCentroid(*triangle);
+            minimumCentroid = glm::min(minimumCentroid, centroid);
+            maximumCentroid = glm::max(maximumCentroid, centroid);
+        }
+        Node& node = _nodes[range.node];
+        node.minimum = minimum;
+        node.maximum = maximum;
+        
+        if (range.count <= MAX_LEAF_TRIANGLES) {
+            node.index = range.first;
+            node.triangleCount = range.count;
+            continue;
+        }
+        
+        // split at the median along the axis the centroids spread furthest on
+        glm::vec3 spread = maximumCentroid - minimumCentroid;
+        int axis = (spread.x > spread.y) ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+        Triangle* median = first + range.count / 2;
+        std::nth_element(first, median, last, [axis](const Triangle& a, const Triangle& b) {
+            return getCentroid(a)[axis] < getCentroid(b)[axis];
+        });
+        
+        // the children go next to each other, so that a branch needs only the index of the first
+        int firstCount = range.count / 2;
+        int firstChild = _nodes.size();
+        Node child = { glm::vec3(), glm::vec3(), 0, 0 };
+        _nodes.append(child);
+        _nodes.append(child);
+        _nodes[range.node].index = firstChild;
+        
+        Range firstRange = { range.first, firstCount, firstChild };
+        Range secondRange = { range.first + firstCount, range.count - firstCount, firstChild + 1 };
+        ranges.append(secondRange);
+        ranges.append(firstRange);
+    }
+}
+
+// the distance along the ray at which it enters the box, if it does so nearer than maxDistance
+static bool findRayBoxEntry(const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& minimum,
+        const glm::vec3& maximum, float maxDistance, float& entry) {
+    glm::vec3 first = (minimum - origin) * inverseDirection;
+    glm::vec3 second = (maximum - origin) * inverseDirection;
+    glm::vec3 nearest = glm::min(first, second);
+    glm::vec3 furthest = glm::max(first, second);
+    entry = glm::max(glm::max(nearest.x, nearest.y), glm::max(nearest.z, 0.0f));
+    float exit = glm::min(glm::min(furthest.x, furthest.y), glm::min(furthest.z, maxDistance));
+    return entry <= exit;
+}
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+        float maxDistance) const {
+    if (_nodes.isEmpty()) {
+        return false;
+    }
+    // a zero component divides to infinity, for which the slabs still come out right
+    glm::vec3 inverseDirection = 1.0f / direction;
+    float bestDistance = maxDistance;
+    bool intersected = false;
+    
+    float rootEntry;
+    if (!findRayBoxEntry(origin, inverseDirection, _nodes.at(0).minimum, _nodes.at(0).maximum, bestDistance,
+            rootEntry)) {
+        return false;
+    }
+    
+    // the nodes still to visit, with the distances at which the ray enters them
+    int stack[MAX_TRAVERSAL_DEPTH];
+    float entries[MAX_TRAVERSAL_DEPTH];
+    int stackSize = 0;
+    stack[stackSize] = 0;
+    entries[stackSize++] = rootEntry;
+    
+    while (stackSize > 0) {
+        stackSize--;
+        if (entries[stackSize] > bestDistance) {
+            continue; // something nearer was hit since the node was pushed
+        }
+        const Node& node = _nodes.at(stack[stackSize]);
+        if (node.triangleCount > 0) {
+            for (int i = node.index, end = node.index + node.triangleCount; i < end; i++) {
+                float triangleDistance;
+                if (findRayTriangleIntersection(origin, direction, _triangles.at(i), triangleDistance) &&
+                        triangleDistance < bestDistance) {
+                    bestDistance = triangleDistance;
+                    intersected = true;
+                }
+            }
+            continue;
+        }
+        int firstChild = node.index;
+        int secondChild = node.index + 1;
+        const Node& first = _nodes.at(firstChild);
+        const Node& second = _nodes.at(secondChild);
+        float firstEntry, secondEntry;
+        bool enteredFirst = findRayBoxEntry(origin, inverseDirection, first.minimum, first.maximum, bestDistance,
+            firstEntry);
+        bool enteredSecond = findRayBoxEntry(origin, inverseDirection, second.minimum, second.maximum, bestDistance,
+            secondEntry);
+        
+        // the nearer child goes on top, to be visited first and to cut short the search of the further one
+        if (enteredFirst && enteredSecond) {
+            bool firstIsNearer = firstEntry <= secondEntry;
+            stack[stackSize] = firstIsNearer ? secondChild : firstChild;
+            entries[stackSize++] = firstIsNearer ? secondEntry : firstEntry;
+            stack[stackSize] = firstIsNearer ? firstChild : secondChild;
+            entries[stackSize++] = firstIsNearer ? firstEntry : secondEntry;
+            
+        } else if (enteredFirst) {
+            stack[stackSize] = firstChild;
+            entries[stackSize++] = firstEntry;
+            
+        } else if (enteredSecond) {
+            stack[stackSize] = secondChild;
+            entries[stackSize++] = secondEntry;
+        }
+    }
+    if (intersected) {
+        distance = bestDistance;
+    }
+    return intersected;
+}
@@ -0,0 +1,60 @@
+//
+//  TriangleBVH.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleBVH_h
+#define hifi_TriangleBVH_h
+
+#include <cfloat>
+
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+#include "GeometryUtil.h"
+
+/// A bounding volume hierarchy over a set of triangles, for finding the nearest one a ray hits without testing them
+/// all.  It doesn't change once built, so any number of threads can query it.
+class TriangleBVH {
+public:
+    
+    /// the most triangles a leaf of the hierarchy holds
+    static const int MAX_LEAF_TRIANGLES = 4;
+    
+    TriangleBVH() { }
+    
+    /// Builds the hierarchy over the triangles, which it keeps a copy of, ordered by where they are.
+    TriangleBVH(const QVector<Triangle>& triangles);
+    
+    bool isEmpty() const { return _triangles.isEmpty(); }
+    int getTriangleCount() const { return _triangles.size(); }
+    
+    /// Finds the nearest triangle that the ray hits the front of, as findRayTriangleIntersection does.
+    /// \param distance set to the distance along the ray to the hit, in units of the direction's length
+    /// \param maxDistance how far along the ray to look, as when something nearer was hit already
+    /// \return true if a triangle nearer than maxDistance was hit
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+        float maxDistance = FLT_MAX) const;
+
+private:
+    
+    /// A box around triangles or around two other nodes, which are next to each other.
+    class Node {
+    public:
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int index; ///< of the first child for a branch, or of the first triangle for a leaf
+        int triangleCount; ///< zero for a branch
+    };
+    
+    QVector<Triangle> _triangles;
+    QVector<Node> _nodes;
+};
+
+#endif // hifi_TriangleBVH_h
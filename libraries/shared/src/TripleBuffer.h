@@ -0,0 +1,54 @@
+//
+//  TripleBuffer.h
+//  libraries/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TripleBuffer_h
+#define hifi_TripleBuffer_h
+
+#include <atomic>
+
+/// Hands the latest of a stream of values from one writing thread to one reading thread without locking or waiting
+/// on either side.  The writer fills its buffer and publishes it, the reader takes whatever was published last, and
+/// the values published in between are dropped.
+template<typename T> class TripleBuffer {
+public:
+    TripleBuffer() : _writeIndex(0), _readIndex(1), _middle(2) { }
+
+    /// The buffer the writer fills in before publishing.  It holds whatever was published two times before, not the
+    /// last value, so the writer sets all of it.  Only the writing thread may touch it.
+    T& getWriteBuffer() { return _buffers[_writeIndex]; }
+
+    /// Makes what was written the latest value, and gives the writer another buffer to fill.
+    void publish() {
+        _writeIndex = _middle.exchange(_writeIndex | NEW_VALUE, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /// Takes the latest value published, if one was since the last time.  Returns whether one was.
+    bool update() {
+        if (!(_middle.load(std::memory_order_relaxed) & NEW_VALUE)) {
+            return false;
+        }
+        _readIndex = _middle.exchange(_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /// The value the reader last took.  Only the reading thread may touch it.
+    const T& getReadBuffer() const { return _buffers[_readIndex]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int NEW_VALUE = 4;
+
+    T _buffers[3];
+    int _writeIndex;
+    int _readIndex;
+    std::atomic<int> _middle; ///< the index of the buffer between the two, and whether the writer left a new value
+};
+
+#endif // hifi_TripleBuffer_h
@@ -0,0 +1,271 @@
+//
+//  AudioMixerBenchmark.cpp
+//  tests/audio-mixer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <Assignment.h>
+#include <AudioCodec.h>
+#include <AudioConstants.h>
+#include <PacketHeaders.h>
+#include <SharedUtil.h>
+
+#include "AudioMixer.h"
+#include "AudioMixerClientData.h"
+
+#include "AudioMixerBenchmark.h"
+
+AudioMixerBenchmark::Settings::Settings() :
+    numAvatars(100),
+    numInjectors(0),
+    silentRatio(0.5f),
+    worldSize(100.0f),
+    numZones(0),
+    zoneCoefficient(0.5f),
+    loudness(0.25f),
+    numFrames(3000),
+    numWarmupFrames(100),
+    numMixThreads(1),
+    distantMixRadius(0.0f),
+    listenerClusterRadius(0.0f)
+{
+}
+
+AudioMixerBenchmark::AudioMixerBenchmark(const Settings& settings) :
+    _settings(settings),
+    _mixer(NULL)
+{
+    // the AudioMixer only needs an assignment to be constructed, it never talks to a domain here
+    Assignment assignment(Assignment::CreateCommand, Assignment::AudioMixerType);
+    QByteArray assignmentPacket = byteArrayWithPopulatedHeader(PacketTypeCreateAssignment, QUuid::createUuid());
+    QDataStream assignmentStream(&assignmentPacket, QIODevice::Append);
+    assignmentStream << assignment;
+
+    _mixer = new AudioMixer(assignmentPacket);
+    _mixer->parseSettingsObject(settingsObject());
+
+    addSources();
+}
+
+AudioMixerBenchmark::~AudioMixerBenchmark() {
+    _sources.clear();
+    _nodes.clear();
+    delete _mixer;
+}
+
+QJsonObject AudioMixerBenchmark::settingsObject() const {
+    // a fixed jitter buffer of one frame, the streams are fed exactly one frame per mix
+    QJsonObject audioBuffer;
+    audioBuffer["dynamic_jitter_buffer"] = false;
+    audioBuffer["static_desired_jitter_buffer_frames"] = QString("1");
+    audioBuffer["repetition_with_fade"] = true;
+
+    QJsonObject audioEnv;
+    audioEnv["num_mix_threads"] = QString::number(_settings.numMixThreads);
+    audioEnv["distant_mix_radius"] = QString::number(_settings.distantMixRadius);
+    audioEnv["listener_cluster_radius"] = QString::number(_settings.listenerClusterRadius);
+
+    if (_settings.numZones > 0) {
+        // zone ranges are "min-max" strings, which is why the world starts at the origin
+        QJsonObject zones;
+        QJsonArray coefficients;
+        float zoneWidth = _settings.worldSize / _settings.numZones;
+        QString fullRange = QString("0-%1").arg(_settings.worldSize);
+
+        for (int i = 0; i < _settings.numZones; i++) {
+            QJsonObject zone;
+            zone["x_range"] = QString("%1-%2").arg(i * zoneWidth).arg((i + 1) * zoneWidth);
+            zone["y_range"] = fullRange;
+            zone["z_range"] = fullRange;
+            zones[QString("zone%1").arg(i)] = zone;
+
+            for (int j = 0; j < _settings.numZones; j++) {
+                if (i != j) {
+                    QJsonObject coefficient;
+                    coefficient["source"] = QString("zone%1").arg(i);
+                    coefficient["listener"] = QString("zone%1").arg(j);
+                    coefficient["coefficient"] = QString::number(_settings.zoneCoefficient);
+                    coefficients.append(coefficient);
+                }
+            }
+        }
+
+        audioEnv["zones"] = zones;
+        audioEnv["attenuation_coefficients"] = coefficients;
+    }
+
+    QJsonObject settings;
+    settings["audio_buffer"] = audioBuffer;
+    settings["audio_env"] = audioEnv;
+    return settings;
+}
+
+static const quint64 NSECS_PER_USEC = 1000;
+
+static glm::vec3 randomPositionInWorld(float worldSize) {
+    return glm::vec3(randFloat() * worldSize, 0.0f, randFloat() * worldSize);
+}
+
+void AudioMixerBenchmark::addSources() {
+    srand(0);
+
+    int numSilentAvatars = (int)(_settings.numAvatars * _settings.silentRatio);
+
+    for (int i = 0; i < _settings.numAvatars; i++) {
+        SharedNodePointer node(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), false));
+        node->setLinkedData(new AudioMixerClientData());
+        _nodes.append(node);
+
+        FakeSource source;
+        source.node = node;
+        source.position = randomPositionInWorld(_settings.worldSize);
+        source.frequency = randFloatInRange(110.0f, 880.0f);
+        source.isSilent = i < numSilentAvatars;
+        _sources.append(source);
+    }
+
+    if (_settings.numInjectors > 0) {
+        // every injected stream hangs off the one node, which is not a listener
+        SharedNodePointer node(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), false));
+        node->setLinkedData(new AudioMixerClientData());
+        _nodes.append(node);
+
+        for (int i = 0; i < _settings.numInjectors; i++) {
+            FakeSource source;
+            source.node = node;
+            source.streamIdentifier = QUuid::createUuid();
+            source.position = randomPositionInWorld(_settings.worldSize);
+            source.frequency = randFloatInRange(110.0f, 880.0f);
+            source.isSilent = false;
+            _sources.append(source);
+        }
+    }
+}
+
+QByteArray AudioMixerBenchmark::packetForSource(const FakeSource& source, int frame) const {
+    PacketType packetType;
+    if (!source.streamIdentifier.isNull()) {
+        packetType = PacketTypeInjectAudio;
+    } else {
+        packetType = source.isSilent ? PacketTypeSilentAudioFrame : PacketTypeMicrophoneAudioNoEcho;
+    }
+
+    QByteArray packet = byteArrayWithPopulatedHeader(packetType, source.node->getUUID());
+    QDataStream packetStream(&packet, QIODevice::Append);
+    packetStream.setByteOrder(QDataStream::LittleEndian);
+
+    packetStream << (quint16)frame;
+
+    glm::quat orientation;
+    if (packetType == PacketTypeSilentAudioFrame) {
+        packetStream << (quint16)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        packetStream.writeRawData(reinterpret_cast<const char*>(&source.position), sizeof(glm::vec3));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&orientation), sizeof(glm::quat));
+        return packet;
+    }
+
+    if (packetType == PacketTypeInjectAudio) {
+        // the injected stream properties are written the way the AudioInjector writes them
+        packetStream.setByteOrder(QDataStream::BigEndian);
+        packetStream << source.streamIdentifier;
+        packetStream << false; // stereo
+        packetStream << (uchar)0; // loopback
+        packetStream.writeRawData(reinterpret_cast<const char*>(&source.position), sizeof(glm::vec3));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&orientation), sizeof(glm::quat));
+        packetStream << 0.0f; // radius
+        packetStream << (quint8)255; // volume
+        packetStream << false; // ignore penumbra
+    } else {
+        packetStream << (quint8)0; // mono
+        packetStream << (quint8)AudioCodec::PCM;
+        packetStream.writeRawData(reinterpret_cast<const char*>(&source.position), sizeof(glm::vec3));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&orientation), sizeof(glm::quat));
+    }
+
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    float amplitude = _settings.loudness * AudioConstants::MAX_SAMPLE_VALUE;
+    float phasePerSample = 2.0f * PI * source.frequency / AudioConstants::SAMPLE_RATE;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        int sampleIndex = frame * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL + i;
+        samples[i] = (int16_t)(amplitude * sinf(phasePerSample * sampleIndex));
+    }
+    packetStream.writeRawData(reinterpret_cast<const char*>(samples), sizeof(samples));
+
+    return packet;
+}
+
+void AudioMixerBenchmark::parseFrame(int frame) {
+    foreach (const FakeSource& source, _sources) {
+        source.node->getLinkedData()->parseData(packetForSource(source, frame));
+    }
+}
+
+void AudioMixerBenchmark::run() {
+    QVector<quint64> frameUsecs;
+    frameUsecs.reserve(_settings.numFrames);
+
+    QElapsedTimer timer;
+    quint64 totalNsecs = 0;
+
+    for (int frame = 0; frame < _settings.numWarmupFrames + _settings.numFrames; frame++) {
+        // packet parsing happens on the datagram processing thread in the real mixer, keep it out of the timing
+        parseFrame(frame);
+
+        if (frame == _settings.numWarmupFrames) {
+            _mixer->_stats.reset();
+        }
+
+        timer.start();
+
+        foreach (const SharedNodePointer& node, _nodes) {
+            AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+            _mixer->addNodeToFrame(node, nodeData->getAvatarAudioStream() != NULL);
+        }
+        _mixer->mixFrame();
+        _mixer->clearFrame();
+
+        quint64 nsecs = timer.nsecsElapsed();
+
+        if (frame >= _settings.numWarmupFrames) {
+            frameUsecs.append(nsecs / NSECS_PER_USEC);
+            totalNsecs += nsecs;
+        }
+    }
+
+    if (frameUsecs.isEmpty()) {
+        return;
+    }
+
+    std::sort(frameUsecs.begin(), frameUsecs.end());
+
+    quint64 p50 = frameUsecs[frameUsecs.size() / 2];
+    quint64 p99 = frameUsecs[qMin(frameUsecs.size() - 1, (int)(frameUsecs.size() * 0.99f))];
+    quint64 max = frameUsecs.last();
+    quint64 sumMixes = _mixer->_stats.getCount(_mixer->_mixesStatID);
+    float mixesPerSecond = sumMixes / ((float)totalNsecs / (NSECS_PER_USEC * USECS_PER_SECOND));
+
+    printf("avatars: %d (%d%% silent) injectors: %d zones: %d threads: %d distant mix radius: %g"
+           " listener cluster radius: %g\n",
+           _settings.numAvatars, (int)(_settings.silentRatio * 100.0f), _settings.numInjectors, _settings.numZones,
+           _settings.numMixThreads, _settings.distantMixRadius, _settings.listenerClusterRadius);
+    printf("frames: %d p50: %llu usecs p99: %llu usecs max: %llu usecs (budget %u usecs)\n", frameUsecs.size(),
+           (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)max,
+           AudioConstants::NETWORK_FRAME_USECS);
+    printf("mixes: %llu mixes per second: %.0f listener clusters per frame: %.1f\n", (unsigned long long)sumMixes,
+           mixesPerSecond, (float)_mixer->_stats.getCount(_mixer->_listenerClustersStatID) / frameUsecs.size());
+}
@@ -0,0 +1,73 @@
+//
+//  AudioMixerBenchmark.h
+//  tests/audio-mixer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerBenchmark_h
+#define hifi_AudioMixerBenchmark_h
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <Node.h>
+
+class AudioMixer;
+
+/// Feeds fake avatars and injectors straight into an AudioMixer's streams and times the frame mix without any network
+class AudioMixerBenchmark {
+public:
+    struct Settings {
+        Settings();
+
+        int numAvatars;         // every avatar listens, the ones that aren't silent are sources too
+        int numInjectors;       // injected sources that nobody owns as a listener
+        float silentRatio;      // the share of avatars only listening, sending silent frames
+        float worldSize;        // sources and listeners are spread over a worldSize by worldSize square
+        int numZones;           // strips of the world along x, each pair of zones attenuates with zoneCoefficient
+        float zoneCoefficient;
+        float loudness;         // peak amplitude of the sources as a ratio of the max sample value
+        int numFrames;
+        int numWarmupFrames;    // mixed but not timed, lets the jitter buffers fill
+        int numMixThreads;
+        float distantMixRadius;
+        float listenerClusterRadius;
+    };
+
+    AudioMixerBenchmark(const Settings& settings);
+    ~AudioMixerBenchmark();
+
+    /// mixes settings.numFrames frames and prints the per-frame cost
+    void run();
+
+private:
+    struct FakeSource {
+        SharedNodePointer node;
+        QUuid streamIdentifier;     // null for an avatar's microphone stream
+        glm::vec3 position;
+        float frequency;
+        bool isSilent;
+    };
+
+    QJsonObject settingsObject() const;
+    void addSources();
+
+    /// writes one network frame for each source into its stream on the mixer
+    void parseFrame(int frame);
+
+    QByteArray packetForSource(const FakeSource& source, int frame) const;
+
+    Settings _settings;
+    AudioMixer* _mixer;
+    QVector<FakeSource> _sources;
+    QVector<SharedNodePointer> _nodes;
+};
+
+#endif // hifi_AudioMixerBenchmark_h
@@ -0,0 +1,71 @@
+//
+//  main.cpp
+//  tests/audio-mixer/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+
+#include "AudioMixerBenchmark.h"
+
+static void printUsage() {
+    printf("usage: audio-mixer-benchmark [--avatars N] [--injectors N] [--silent RATIO] [--world-size METERS]\n"
+           "                             [--zones N] [--zone-coefficient C] [--frames N] [--warmup-frames N]\n"
+           "                             [--threads N] [--distant-mix-radius METERS]\n"
+           "                             [--cluster-radius METERS]\n");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    AudioMixerBenchmark::Settings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (strcmp(option, "--avatars") == 0) {
+            settings.numAvatars = atoi(value);
+        } else if (strcmp(option, "--injectors") == 0) {
+            settings.numInjectors = atoi(value);
+        } else if (strcmp(option, "--silent") == 0) {
+            settings.silentRatio = atof(value);
+        } else if (strcmp(option, "--world-size") == 0) {
+            settings.worldSize = atof(value);
+        } else if (strcmp(option, "--zones") == 0) {
+            settings.numZones = atoi(value);
+        } else if (strcmp(option, "--zone-coefficient") == 0) {
+            settings.zoneCoefficient = atof(value);
+        } else if (strcmp(option, "--frames") == 0) {
+            settings.numFrames = atoi(value);
+        } else if (strcmp(option, "--warmup-frames") == 0) {
+            settings.numWarmupFrames = atoi(value);
+        } else if (strcmp(option, "--threads") == 0) {
+            settings.numMixThreads = atoi(value);
+        } else if (strcmp(option, "--distant-mix-radius") == 0) {
+            settings.distantMixRadius = atof(value);
+        } else if (strcmp(option, "--cluster-radius") == 0) {
+            settings.listenerClusterRadius = atof(value);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    AudioMixerBenchmark benchmark(settings);
+    benchmark.run();
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include "AudioCodec.h"
+
+#include "AudioCodecTests.h"
+
+const int NUM_TEST_FRAMES = 240;
+const int NUM_TEST_PACKETS = 8;
+
+// the quantization error of IMA ADPCM on a smooth signal, well under 1% of full scale
+const int MAX_SAMPLE_ERROR = 256;
+
+static bool testRoundTrip(int numChannels) {
+    const int numSamples = NUM_TEST_FRAMES * numChannels;
+
+    AudioCodec encoder(numChannels);
+    int16_t samples[NUM_TEST_FRAMES * 2];
+
+    for (int packet = 0; packet < NUM_TEST_PACKETS; packet++) {
+        for (int i = 0; i < numSamples; i++) {
+            int frame = packet * NUM_TEST_FRAMES + i / numChannels;
+            float frequency = (i % numChannels == 0) ? 0.031f : 0.017f;
+            samples[i] = (int16_t)(8000.0f * sinf(frame * frequency));
+        }
+
+        QByteArray encoded;
+        encoder.encode(samples, numSamples, encoded);
+
+        if (encoded.size() != AudioCodec::numEncodedBytesForSamples(numSamples, numChannels)) {
+            qDebug("codec: %d channel packet %d has the wrong size! Expected: %d Actual: %d", numChannels, packet,
+                   AudioCodec::numEncodedBytesForSamples(numSamples, numChannels), encoded.size());
+            return false;
+        }
+
+        if (AudioCodec::numSamplesForEncodedBytes(encoded.constData(), encoded.size()) != numSamples) {
+            qDebug("codec: %d channel packet %d reports the wrong number of samples!", numChannels, packet);
+            return false;
+        }
+
+        // every packet must decode on its own, without the ones before it
+        QByteArray decoded;
+        int numDecoded = AudioCodec::decode(encoded.constData(), encoded.size(), decoded);
+        if (numDecoded != numSamples || decoded.size() != numSamples * (int)sizeof(int16_t)) {
+            qDebug("codec: %d channel packet %d decoded %d samples, expected %d", numChannels, packet,
+                   numDecoded, numSamples);
+            return false;
+        }
+
+        const int16_t* decodedSamples = reinterpret_cast<const int16_t*>(decoded.constData());
+
+        // the predictor needs a few samples to catch up at the very start of the stream
+        int firstCheckedSample = (packet == 0) ? 16 * numChannels : 0;
+        for (int i = firstCheckedSample; i < numSamples; i++) {
+            if (abs(decodedSamples[i] - samples[i]) > MAX_SAMPLE_ERROR) {
+                qDebug("codec: %d channel packet %d sample %d incorrect! Expected: %d Actual: %d", numChannels,
+                       packet, i, samples[i], decodedSamples[i]);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void AudioCodecTests::runAllTests() {
+    if (!testRoundTrip(1) || !testRoundTrip(2)) {
+        return;
+    }
+
+    // a malformed payload should decode to nothing
+    char badChannels[] = { 3, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    QByteArray decoded;
+    if (AudioCodec::decode(badChannels, sizeof(badChannels), decoded) != 0 || decoded.size() != 0) {
+        qDebug("codec: payload with a bad channel count was decoded!");
+        return;
+    }
+
+    char badStepIndex[] = { 1, 0, 0, 100, 0x12, 0x34 };
+    if (AudioCodec::decode(badStepIndex, sizeof(badStepIndex), decoded) != 0 || decoded.size() != 0) {
+        qDebug("codec: payload with a bad step index was decoded!");
+        return;
+    }
+
+    char truncated[] = { 2, 0, 0 };
+    if (AudioCodec::decode(truncated, sizeof(truncated), decoded) != 0) {
+        qDebug("codec: truncated payload was decoded!");
+        return;
+    }
+
+    qDebug() << "PASSED";
+}
@@ -0,0 +1,163 @@
+//
+//  AudioMixKernelTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QDebug>
+
+#include <SharedUtil.h>
+
+#include "AudioFormat.h"
+#include "AudioFilter.h"
+#include "AudioMixKernel.h"
+
+#include "AudioMixKernelTests.h"
+
+// odd so that both the SIMD and the scalar tail of each kernel are exercised
+const int NUM_TEST_SAMPLES = 1027;
+
+void AudioMixKernelTests::runAllTests() {
+    int16_t source[NUM_TEST_SAMPLES];
+    int16_t other[NUM_TEST_SAMPLES];
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        source[i] = (int16_t)((rand() % 65536) - 32768);
+        other[i] = (int16_t)((rand() % 65536) - 32768);
+    }
+    
+    const float GAIN = 0.37f;
+    const float OTHER_GAIN = 0.81f;
+    
+    // scale should match a truncating scalar multiply
+    int16_t scaled[NUM_TEST_SAMPLES];
+    AudioMixKernel::scale(scaled, source, GAIN, NUM_TEST_SAMPLES);
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        int16_t expected = (int16_t)(source[i] * GAIN);
+        if (scaled[i] != expected) {
+            qDebug("scale: sample %d incorrect! Expected: %d Actual: %d", i, expected, scaled[i]);
+            return;
+        }
+    }
+    
+    // interleave should produce left/right pairs
+    int16_t stereo[NUM_TEST_SAMPLES * 2];
+    AudioMixKernel::interleave(stereo, source, GAIN, other, OTHER_GAIN, NUM_TEST_SAMPLES);
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        int16_t expectedLeft = (int16_t)(source[i] * GAIN);
+        int16_t expectedRight = (int16_t)(other[i] * OTHER_GAIN);
+        if (stereo[2 * i] != expectedLeft || stereo[2 * i + 1] != expectedRight) {
+            qDebug("interleave: frame %d incorrect! Expected: %d %d Actual: %d %d", i,
+                   expectedLeft, expectedRight, stereo[2 * i], stereo[2 * i + 1]);
+            return;
+        }
+    }
+    
+    // accumulate must not clamp, saturate must clamp once at the end
+    int32_t accumulator[NUM_TEST_SAMPLES];
+    memset(accumulator, 0, sizeof(accumulator));
+    AudioMixKernel::accumulate(accumulator, source, NUM_TEST_SAMPLES);
+    AudioMixKernel::accumulate(accumulator, source, NUM_TEST_SAMPLES);
+    AudioMixKernel::accumulate(accumulator, other, NUM_TEST_SAMPLES);
+    
+    int16_t mixed[NUM_TEST_SAMPLES];
+    AudioMixKernel::saturate(mixed, accumulator, NUM_TEST_SAMPLES);
+    
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        int32_t sum = 2 * source[i] + other[i];
+        if (accumulator[i] != sum) {
+            qDebug("accumulate: sample %d incorrect! Expected: %d Actual: %d", i, sum, accumulator[i]);
+            return;
+        }
+        
+        int16_t expected = (int16_t)(sum < -32768 ? -32768 : (sum > 32767 ? 32767 : sum));
+        if (mixed[i] != expected) {
+            qDebug("saturate: sample %d incorrect! Expected: %d Actual: %d", i, expected, mixed[i]);
+            return;
+        }
+    }
+    
+    // multiply should match a scalar multiply exactly
+    float floats[NUM_TEST_SAMPLES];
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        floats[i] = source[i] / 32768.0f;
+    }
+    AudioMixKernel::multiply(floats, GAIN, NUM_TEST_SAMPLES);
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        float expected = (source[i] / 32768.0f) * GAIN;
+        if (floats[i] != expected) {
+            qDebug("multiply: sample %d incorrect! Expected: %f Actual: %f", i, expected, floats[i]);
+            return;
+        }
+    }
+    
+    // the cascade runs each channel in its own lane, it should track two scalar stages per channel
+    const int NUM_STAGES = 2;
+    const int NUM_CHANNELS = 2;
+    
+    AudioFilterPEQ filters[NUM_STAGES][NUM_CHANNELS];
+    filters[0][0].setParameters(AudioConstants::SAMPLE_RATE, 300.0f, 1.5f, 0.71f);
+    filters[0][1].setParameters(AudioConstants::SAMPLE_RATE, 1000.0f, 0.5f, 1.0f);
+    filters[1][0].setParameters(AudioConstants::SAMPLE_RATE, 4000.0f, 0.1f, 1.0f);
+    filters[1][1].setParameters(AudioConstants::SAMPLE_RATE, 4000.0f, 1.5f, 0.71f);
+    
+    AudioMixKernel::BiquadStage stages[NUM_STAGES];
+    memset(stages, 0, sizeof(stages));
+    for (int k = 0; k < NUM_STAGES; k++) {
+        for (int j = 0; j < NUM_CHANNELS; j++) {
+            filters[k][j].getKernel().getParameters(stages[k].a0[j], stages[k].a1[j], stages[k].a2[j],
+                                                    stages[k].b1[j], stages[k].b2[j]);
+        }
+    }
+    
+    float left[NUM_TEST_SAMPLES];
+    float right[NUM_TEST_SAMPLES];
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        left[i] = source[i] / 32768.0f;
+        right[i] = other[i] / 32768.0f;
+    }
+    
+    float expectedLeft[NUM_TEST_SAMPLES];
+    float expectedRight[NUM_TEST_SAMPLES];
+    filters[0][0].render(left, expectedLeft, NUM_TEST_SAMPLES);
+    filters[1][0].render(expectedLeft, expectedLeft, NUM_TEST_SAMPLES);
+    filters[0][1].render(right, expectedRight, NUM_TEST_SAMPLES);
+    filters[1][1].render(expectedRight, expectedRight, NUM_TEST_SAMPLES);
+    
+    float* channels[NUM_CHANNELS] = { left, right };
+    AudioMixKernel::biquadCascade<NUM_STAGES>(stages, channels, NUM_TEST_SAMPLES, NUM_CHANNELS);
+    
+    const float BIQUAD_TOLERANCE = 0.0001f;
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        if (fabsf(left[i] - expectedLeft[i]) > BIQUAD_TOLERANCE || fabsf(right[i] - expectedRight[i]) > BIQUAD_TOLERANCE) {
+            qDebug("biquadCascade: frame %d incorrect! Expected: %f %f Actual: %f %f", i,
+                   expectedLeft[i], expectedRight[i], left[i], right[i]);
+            return;
+        }
+    }
+    
+    // the state carried out of the kernel must be the state the scalar stages finished with
+    for (int k = 0; k < NUM_STAGES; k++) {
+        for (int j = 0; j < NUM_CHANNELS; j++) {
+            float s1;
+            float s2;
+            filters[k][j].getKernel().getState(s1, s2);
+            if (fabsf(s1 - stages[k].s1[j]) > BIQUAD_TOLERANCE || fabsf(s2 - stages[k].s2[j]) > BIQUAD_TOLERANCE) {
+                qDebug("biquadCascade: state of stage %d channel %d incorrect! Expected: %f %f Actual: %f %f", k, j,
+                       s1, s2, stages[k].s1[j], stages[k].s2[j]);
+                return;
+            }
+        }
+    }
+    
+    qDebug() << "PASSED";
+}
@@ -0,0 +1,19 @@
+//
+//  AudioMixKernelTests.h
+//  tests/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelTests_h
+#define hifi_AudioMixKernelTests_h
+
+namespace AudioMixKernelTests {
+
+    void runAllTests();
+};
+
+#endif // hifi_AudioMixKernelTests_h
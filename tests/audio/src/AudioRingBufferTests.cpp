@@ -141,5 +141,67 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 
+    if (!runLockFreeTests()) {
+        return;
+    }
+
     qDebug() << "PASSED";
 }
+
+bool AudioRingBufferTests::runLockFreeTests() {
+    int16_t writeData[200];
+    for (int i = 0; i < 200; i++) { writeData[i] = i; }
+
+    int16_t readData[200];
+
+    AudioRingBuffer ringBuffer(10, false, 10); // makes buffer of 100 int16_t samples
+    ringBuffer.setIsLockFree(true);
+
+    // write 90 samples, pop 20 through nextOutput, 70 samples in buffer
+    ringBuffer.writeSamples(writeData, 90);
+    AudioRingBuffer::ConstIterator popped = ringBuffer.nextOutput();
+    ringBuffer.shiftReadPosition(20);
+    assertBufferSize(ringBuffer, 70);
+
+    // the popped samples are still reserved, so only 10 of these 40 samples fit and the rest are dropped
+    int samplesWritten = ringBuffer.writeSamples(&writeData[90], 40);
+    if (samplesWritten != 10) {
+        qDebug("lock-free writeSamples(40) incorrect!  Expected: 10  Actual: %d", samplesWritten);
+        return false;
+    }
+    popped.readSamples(readData, 20);
+    for (int i = 0; i < 20; i++) {
+        if (readData[i] != i) {
+            qDebug("lock-free popped readData[%d] overwritten!  Expected: %d  Actual: %d", i, i, readData[i]);
+            return false;
+        }
+    }
+    assertBufferSize(ringBuffer, 80);
+
+    // the writer discards 30 samples, the reader skips them on its next read
+    ringBuffer.discardOldestSamples(30);
+    assertBufferSize(ringBuffer, 50);
+    ringBuffer.readSamples(readData, 50);
+    for (int i = 0; i < 50; i++) {
+        if (readData[i] != i + 50) {
+            qDebug("lock-free readData[%d] incorrect!  Expected: %d  Actual: %d", i, i + 50, readData[i]);
+            return false;
+        }
+    }
+    assertBufferSize(ringBuffer, 0);
+
+    // a discard across the end of the ring
+    ringBuffer.writeSamples(writeData, 20);
+    ringBuffer.discardOldestSamples(5);
+    assertBufferSize(ringBuffer, 15);
+    ringBuffer.readSamples(readData, 15);
+    for (int i = 0; i < 15; i++) {
+        if (readData[i] != i + 5) {
+            qDebug("lock-free wrapped readData[%d] incorrect!  Expected: %d  Actual: %d", i, i + 5, readData[i]);
+            return false;
+        }
+    }
+    assertBufferSize(ringBuffer, 0);
+
+    return true;
+}
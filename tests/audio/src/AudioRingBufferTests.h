@@ -19,6 +19,8 @@ namespace AudioRingBufferTests {
 
     void runAllTests();
 
+    bool runLockFreeTests();
+
     void assertBufferSize(const AudioRingBuffer& buffer, int samples);
 };
 
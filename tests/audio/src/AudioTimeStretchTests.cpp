@@ -0,0 +1,92 @@
+//
+//  AudioTimeStretchTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include "AudioTimeStretch.h"
+
+#include "AudioTimeStretchTests.h"
+
+const int NUM_TEST_FRAMES = 240;
+
+// a 100 sample period, comfortably between the shortest and longest period a frame can have cut or repeated
+const float TEST_PERIOD = 100.0f;
+
+static void fillSine(int16_t* samples, int numChannels) {
+    for (int i = 0; i < NUM_TEST_FRAMES * numChannels; i++) {
+        samples[i] = (int16_t)(8000.0f * sinf(2.0f * 3.14159265f * (i / numChannels) / TEST_PERIOD));
+    }
+}
+
+static bool testStretch(int numChannels) {
+    int16_t samples[NUM_TEST_FRAMES * 2];
+    fillSine(samples, numChannels);
+
+    QByteArray compressed;
+    int removed = AudioTimeStretch::compress(samples, NUM_TEST_FRAMES, numChannels, compressed);
+    if (removed <= 0 || compressed.size() != (NUM_TEST_FRAMES - removed) * numChannels * (int)sizeof(int16_t)) {
+        qDebug("time stretch: %d channel compress removed %d frames into %d bytes", numChannels, removed,
+               compressed.size());
+        return false;
+    }
+
+    QByteArray expanded;
+    int added = AudioTimeStretch::expand(samples, NUM_TEST_FRAMES, numChannels, expanded);
+    if (added <= 0 || expanded.size() != (NUM_TEST_FRAMES + added) * numChannels * (int)sizeof(int16_t)) {
+        qDebug("time stretch: %d channel expand added %d frames into %d bytes", numChannels, added, expanded.size());
+        return false;
+    }
+
+    // a sine cut or repeated by a whole number of its periods stays a sine, so the seam should be inaudible
+    if (removed % (int)TEST_PERIOD != 0 || added % (int)TEST_PERIOD != 0) {
+        qDebug("time stretch: %d channel stretch picked periods %d and %d, expected a multiple of %d", numChannels,
+               removed, added, (int)TEST_PERIOD);
+        return false;
+    }
+
+    // both ends of the frame are kept so it still joins up with its neighbours
+    const int16_t* expandedSamples = reinterpret_cast<const int16_t*>(expanded.constData());
+    const int16_t* compressedSamples = reinterpret_cast<const int16_t*>(compressed.constData());
+    int lastSample = NUM_TEST_FRAMES * numChannels - 1;
+    if (expandedSamples[0] != samples[0]
+        || expandedSamples[(NUM_TEST_FRAMES + added) * numChannels - 1] != samples[lastSample]
+        || compressedSamples[(NUM_TEST_FRAMES - removed) * numChannels - 1] != samples[lastSample]) {
+        qDebug("time stretch: %d channel stretch changed the ends of the frame!", numChannels);
+        return false;
+    }
+
+    return true;
+}
+
+void AudioTimeStretchTests::runAllTests() {
+    if (!testStretch(1) || !testStretch(2)) {
+        return;
+    }
+
+    // loud noise has no period, so the frame should be left alone
+    int16_t noise[NUM_TEST_FRAMES];
+    srand(0);
+    for (int i = 0; i < NUM_TEST_FRAMES; i++) {
+        noise[i] = (int16_t)((rand() % 16001) - 8000);
+    }
+
+    QByteArray stretched;
+    if (AudioTimeStretch::compress(noise, NUM_TEST_FRAMES, 1, stretched) != 0
+        || AudioTimeStretch::expand(noise, NUM_TEST_FRAMES, 1, stretched) != 0 || stretched.size() != 0) {
+        qDebug("time stretch: noise was stretched!");
+        return;
+    }
+
+    qDebug() << "PASSED";
+}
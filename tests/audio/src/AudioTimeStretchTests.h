@@ -0,0 +1,19 @@
+//
+//  AudioTimeStretchTests.h
+//  tests/audio/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretchTests_h
+#define hifi_AudioTimeStretchTests_h
+
+namespace AudioTimeStretchTests {
+
+    void runAllTests();
+};
+
+#endif // hifi_AudioTimeStretchTests_h
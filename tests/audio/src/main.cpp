@@ -8,11 +8,17 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "AudioCodecTests.h"
+#include "AudioMixKernelTests.h"
 #include "AudioRingBufferTests.h"
+#include "AudioTimeStretchTests.h"
 #include <stdio.h>
 
 int main(int argc, char** argv) {
     AudioRingBufferTests::runAllTests();
+    AudioMixKernelTests::runAllTests();
+    AudioCodecTests::runAllTests();
+    AudioTimeStretchTests::runAllTests();
     printf("all tests passed.  press enter to exit\n");
     getchar();
     return 0;
@@ -9,13 +9,21 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QScriptValueIterator>
 
 #include <SharedUtil.h>
 
 #include <MetavoxelMessages.h>
+#include <Spanner.h>
 
 #include "MetavoxelTests.h"
 
@@ -261,6 +269,230 @@ static TestMessageC createRandomMessageC(bool ensureHashOrder = false) {
     return message;
 }
 
+static bool testBulkStreaming() {
+    for (int leadingBits = 0; leadingBits < BITS_IN_BYTE; leadingBits++) {
+        QByteArray bytesWritten = createRandomBytes(0, 1000);
+        QVector<float> floatsWritten;
+        for (int i = randIntInRange(0, 100); i > 0; i--) {
+            floatsWritten.append(randFloat());
+        }
+        
+        // the bulk paths must write just what streaming each bit would have
+        QByteArray bulkArray, bitArray;
+        QDataStream bulkStream(&bulkArray, QIODevice::WriteOnly), bitStream(&bitArray, QIODevice::WriteOnly);
+        Bitstream bulkOut(bulkStream), bitOut(bitStream);
+        for (int i = 0; i < leadingBits; i++) {
+            bulkOut << true;
+            bitOut << true;
+        }
+        bulkOut << bytesWritten << floatsWritten;
+        bitOut << bytesWritten.size();
+        for (int i = 0; i < bytesWritten.size() * BITS_IN_BYTE; i++) {
+            bitOut << (bool)(bytesWritten.at(i / BITS_IN_BYTE) & (1 << (i % BITS_IN_BYTE)));
+        }
+        bitOut << floatsWritten.size();
+        foreach (float value, floatsWritten) {
+            bitOut << value;
+        }
+        bulkOut.flush();
+        bitOut.flush();
+        if (bulkArray != bitArray) {
+            qDebug() << "Bulk write differs from bit by bit after" << leadingBits << "bits.";
+            return true;
+        }
+        
+        QDataStream inStream(bulkArray);
+        Bitstream in(inStream);
+        for (int i = 0; i < leadingBits; i++) {
+            bool bit;
+            in >> bit;
+        }
+        QByteArray bytesRead;
+        QVector<float> floatsRead;
+        in >> bytesRead >> floatsRead;
+        if (bytesRead != bytesWritten || floatsRead != floatsWritten) {
+            qDebug() << "Bulk read mismatch after" << leadingBits << "bits.";
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool testPropertyAccessors() {
+    Cuboid* reference = new Cuboid();
+    SharedObjectPointer referencePointer = reference;
+    Cuboid* cuboid = new Cuboid();
+    SharedObjectPointer cuboidPointer = cuboid;
+    cuboid->setTranslation(glm::vec3(randFloat(), randFloat(), randFloat()));
+    cuboid->setRotation(glm::quat(randFloat(), randFloat(), randFloat(), randFloat()));
+    cuboid->setScale(randFloat());
+    cuboid->setColor(QColor(randIntInRange(0, 255), randIntInRange(0, 255), randIntInRange(0, 255)));
+    cuboid->setAspectY(randFloat());
+    cuboid->setAspectZ(randFloat());
+    cuboid->setPlacementGranularity(randFloat());
+    cuboid->setWillBeVoxelized(true);
+    
+    // the accessors must write just what reflection would have
+    const ObjectStreamer* streamer = Bitstream::getObjectStreamer(&Cuboid::staticMetaObject);
+    SharedObjectStreamer reflectionStreamer(&Cuboid::staticMetaObject, streamer->getProperties());
+    QByteArray accessorArray, reflectionArray;
+    QDataStream accessorStream(&accessorArray, QIODevice::WriteOnly);
+    QDataStream reflectionStream(&reflectionArray, QIODevice::WriteOnly);
+    Bitstream accessorOut(accessorStream), reflectionOut(reflectionStream);
+    streamer->write(accessorOut, cuboid);
+    streamer->writeRawDelta(accessorOut, cuboid, reference);
+    reflectionStreamer.write(reflectionOut, cuboid);
+    reflectionStreamer.writeRawDelta(reflectionOut, cuboid, reference);
+    accessorOut.flush();
+    reflectionOut.flush();
+    if (accessorArray != reflectionArray) {
+        qDebug() << "Accessor write differs from reflection.";
+        return true;
+    }
+    
+    QDataStream inStream(accessorArray);
+    Bitstream in(inStream);
+    SharedObjectPointer objectRead = static_cast<SharedObject*>(streamer->read(in));
+    SharedObjectPointer deltaRead = static_cast<SharedObject*>(streamer->readRawDelta(in, reference));
+    if (!objectRead->equals(cuboid) || !deltaRead->equals(cuboid)) {
+        qDebug() << "Accessor read mismatch.";
+        return true;
+    }
+    return false;
+}
+
+/// Fills the test attribute with random values down to a random depth.
+class FillVisitor : public MetavoxelVisitor {
+public:
+    
+    FillVisitor();
+    
+    virtual int visit(MetavoxelInfo& info);
+};
+
+FillVisitor::FillVisitor() :
+    MetavoxelVisitor(QVector<AttributePointer>(), QVector<AttributePointer>() <<
+        AttributeRegistry::getInstance()->getAttribute("testAttribute")) {
+}
+
+const float MINIMUM_FILL_SIZE = 1.0f / 32.0f;
+
+int FillVisitor::visit(MetavoxelInfo& info) {
+    if (info.size > MINIMUM_FILL_SIZE && (info.size > 0.25f || randomBoolean())) {
+        return DEFAULT_ORDER;
+    }
+    info.outputValues[0] = OwnedAttributeValue(_outputs.at(0), encodeInline<float>(randFloat()));
+    return STOP_RECURSION;
+}
+
+/// Counts and sums the leaves of the test attribute, optionally splitting the tour among threads.
+class SumVisitor : public MetavoxelVisitor {
+public:
+    
+    int leafCount;
+    float sum;
+    
+    SumVisitor(bool parallel);
+    
+    virtual int visit(MetavoxelInfo& info);
+    virtual MetavoxelVisitor* createParallelCopy() const;
+    virtual void mergeParallelCopy(MetavoxelVisitor* copy);
+
+private:
+    
+    bool _parallel;
+};
+
+SumVisitor::SumVisitor(bool parallel) :
+    MetavoxelVisitor(QVector<AttributePointer>() << AttributeRegistry::getInstance()->getAttribute("testAttribute")),
+    leafCount(0),
+    sum(0.0f),
+    _parallel(parallel) {
+}
+
+int SumVisitor::visit(MetavoxelInfo& info) {
+    if (!info.isLeaf) {
+        return DEFAULT_ORDER;
+    }
+    leafCount++;
+    sum += info.inputValues.at(0).getInlineValue<float>();
+    return STOP_RECURSION;
+}
+
+MetavoxelVisitor* SumVisitor::createParallelCopy() const {
+    return _parallel ? new SumVisitor(true) : NULL;
+}
+
+void SumVisitor::mergeParallelCopy(MetavoxelVisitor* copy) {
+    SumVisitor* sumCopy = static_cast<SumVisitor*>(copy);
+    leafCount += sumCopy->leafCount;
+    sum += sumCopy->sum;
+}
+
+static bool testParallelTour() {
+    MetavoxelData data;
+    FillVisitor fillVisitor;
+    data.guide(fillVisitor);
+    
+    // the parallel tours must find the same leaves as the serial ones, whole or compared against empty data
+    MetavoxelData emptyData;
+    for (int different = 0; different < 2; different++) {
+        SumVisitor serialVisitor(false), parallelVisitor(true);
+        if (different) {
+            data.guideToDifferent(emptyData, serialVisitor);
+            data.guideToDifferent(emptyData, parallelVisitor);
+        } else {
+            data.guide(serialVisitor);
+            data.guide(parallelVisitor);
+        }
+        const float SUM_TOLERANCE = 0.001f;
+        if (serialVisitor.leafCount == 0 || parallelVisitor.leafCount != serialVisitor.leafCount ||
+                fabsf(parallelVisitor.sum - serialVisitor.sum) > SUM_TOLERANCE * serialVisitor.leafCount) {
+            qDebug() << "Parallel tour mismatch:" << parallelVisitor.leafCount << parallelVisitor.sum <<
+                "vs" << serialVisitor.leafCount << serialVisitor.sum;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool testDeltaRecording() {
+    MetavoxelData data;
+    FillVisitor fillVisitor;
+    data.guide(fillVisitor);
+    MetavoxelLOD lod(glm::vec3(randFloat(), randFloat(), randFloat()), randFloat());
+    SharedObjectPointer object = new Cuboid();
+    
+    MetavoxelDeltaRecording recording(MetavoxelLOD(), lod);
+    data.writeDelta(MetavoxelData(), MetavoxelLOD(), recording.getStream(), lod);
+    recording.getStream() << object;
+    recording.finish();
+    if (!recording.isReplayable()) {
+        qDebug() << "Delta recording not replayable.";
+        return true;
+    }
+    
+    // replaying twice must match writing twice, the second time around with the attribute and object already sent
+    QByteArray directArray, replayedArray;
+    QDataStream directStream(&directArray, QIODevice::WriteOnly);
+    QDataStream replayedStream(&replayedArray, QIODevice::WriteOnly);
+    Bitstream directOut(directStream), replayedOut(replayedStream);
+    for (int i = 0; i < 2; i++) {
+        directOut << (i == 0);
+        data.writeDelta(MetavoxelData(), MetavoxelLOD(), directOut, lod);
+        directOut << object;
+        replayedOut << (i == 0);
+        replayedOut.writeRecording(recording);
+    }
+    directOut.flush();
+    replayedOut.flush();
+    if (directArray != replayedArray) {
+        qDebug() << "Replayed delta differs from direct write.";
+        return true;
+    }
+    return false;
+}
+
 static bool testSerialization(Bitstream::MetadataType metadataType) {
     QByteArray array;
     QDataStream outStream(&array, QIODevice::WriteOnly);
@@ -439,6 +671,261 @@ static bool testSerialization(Bitstream::MetadataType metadataType) {
     return false;
 }
 
+/// Returns the rate at which the bytes went by, in megabytes per second.
+static double getMegabytesPerSecond(int bytes, qint64 nsecs) {
+    return (nsecs == 0) ? 0.0 : bytes * 1000.0 / nsecs;
+}
+
+/// Times writing the values to a fresh stream and reading them back.
+template<class T> static QJsonObject benchmarkStreaming(const QVector<T>& values) {
+    QByteArray array;
+    QDataStream outStream(&array, QIODevice::WriteOnly);
+    Bitstream out(outStream);
+    QElapsedTimer timer;
+    timer.start();
+    foreach (const T& value, values) {
+        out << value;
+    }
+    out.flush();
+    qint64 writeNsecs = timer.nsecsElapsed();
+    
+    QDataStream inStream(array);
+    Bitstream in(inStream);
+    T value;
+    timer.start();
+    for (int i = 0; i < values.size(); i++) {
+        in >> value;
+    }
+    qint64 readNsecs = timer.nsecsElapsed();
+    
+    QJsonObject result;
+    result["values"] = values.size();
+    result["bytes"] = array.size();
+    result["write_ns_per_value"] = (double)writeNsecs / values.size();
+    result["read_ns_per_value"] = (double)readNsecs / values.size();
+    result["write_mb_per_second"] = getMegabytesPerSecond(array.size(), writeNsecs);
+    result["read_mb_per_second"] = getMegabytesPerSecond(array.size(), readNsecs);
+    return result;
+}
+
+static QJsonObject benchmarkBitstream() {
+    const int VALUE_COUNT = 100000;
+    QVector<int> ints;
+    QVector<float> floats;
+    QVector<glm::vec3> vectors;
+    QVector<glm::quat> rotations;
+    QVector<QByteArray> byteArrays;
+    QVector<QString> strings;
+    QVector<QVariant> messages;
+    QVector<SharedObjectPointer> objects;
+    for (int i = 0; i < VALUE_COUNT; i++) {
+        ints.append(rand());
+        floats.append(randFloat());
+        vectors.append(glm::vec3(randFloat(), randFloat(), randFloat()));
+        rotations.append(glm::normalize(glm::quat(randFloat(), randFloat(), randFloat(), randFloat())));
+        byteArrays.append(createRandomBytes());
+        strings.append(QString::number(rand()));
+    }
+    const int COMPLEX_VALUE_COUNT = 10000;
+    for (int i = 0; i < COMPLEX_VALUE_COUNT; i++) {
+        messages.append(QVariant::fromValue(createRandomMessageC()));
+        objects.append(new TestSharedObjectA(randFloat(), getRandomTestEnum(), getRandomTestFlags()));
+    }
+    QJsonObject results;
+    results["int"] = benchmarkStreaming(ints);
+    results["float"] = benchmarkStreaming(floats);
+    results["vec3"] = benchmarkStreaming(vectors);
+    results["quat"] = benchmarkStreaming(rotations);
+    results["QByteArray"] = benchmarkStreaming(byteArrays);
+    results["QString"] = benchmarkStreaming(strings);
+    results["QVariant"] = benchmarkStreaming(messages);
+    results["SharedObjectPointer"] = benchmarkStreaming(objects);
+    return results;
+}
+
+static float getTerrainHeight(float x, float z) {
+    return 0.5f + 0.25f * sinf(x * PI * 4.0f) * cosf(z * PI * 6.0f);
+}
+
+/// Fills the test attribute with a rolling surface, subdividing only the voxels that the surface passes through.
+class TerrainFillVisitor : public MetavoxelVisitor {
+public:
+    
+    int leafCount;
+    
+    TerrainFillVisitor(float minimumSize);
+    
+    virtual int visit(MetavoxelInfo& info);
+
+private:
+    
+    float _minimumSize;
+};
+
+TerrainFillVisitor::TerrainFillVisitor(float minimumSize) :
+    MetavoxelVisitor(QVector<AttributePointer>(), QVector<AttributePointer>() <<
+        AttributeRegistry::getInstance()->getAttribute("testAttribute")),
+    leafCount(0),
+    _minimumSize(minimumSize) {
+}
+
+int TerrainFillVisitor::visit(MetavoxelInfo& info) {
+    // sample the surface at the corners and center of the voxel's footprint to see whether it passes through
+    float minimumHeight = FLT_MAX, maximumHeight = -FLT_MAX;
+    const int SAMPLE_COUNT = 5;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        float x = (i == SAMPLE_COUNT - 1) ? 0.5f : (i & 1);
+        float z = (i == SAMPLE_COUNT - 1) ? 0.5f : (i >> 1);
+        float height = getTerrainHeight(info.minimum.x + x * info.size, info.minimum.z + z * info.size);
+        minimumHeight = qMin(minimumHeight, height);
+        maximumHeight = qMax(maximumHeight, height);
+    }
+    if (info.size > _minimumSize && maximumHeight >= info.minimum.y && minimumHeight <= info.minimum.y + info.size) {
+        return DEFAULT_ORDER;
+    }
+    glm::vec3 center = info.getCenter();
+    float filled = glm::clamp((getTerrainHeight(center.x, center.z) - info.minimum.y) / info.size, 0.0f, 1.0f);
+    info.outputValues[0] = OwnedAttributeValue(_outputs.at(0), encodeInline<float>(filled));
+    leafCount++;
+    return STOP_RECURSION;
+}
+
+/// Creates a heightfield spanner covering the unit square with the rolling surface at the given resolution.
+static SharedObjectPointer createTerrainHeightfield(int innerWidth) {
+    int heightWidth = innerWidth + HeightfieldHeight::HEIGHT_EXTENSION;
+    QVector<quint16> heights(heightWidth * heightWidth);
+    quint16* height = heights.data();
+    const float MAX_HEIGHT_VALUE = 65534.0f; // zero is reserved for holes
+    for (int z = 0; z < heightWidth; z++) {
+        for (int x = 0; x < heightWidth; x++) {
+            float sample = getTerrainHeight((float)x / innerWidth, (float)z / innerWidth);
+            *height++ = 1 + (quint16)(sample * MAX_HEIGHT_VALUE);
+        }
+    }
+    int colorWidth = innerWidth + HeightfieldData::SHARED_EDGE;
+    QByteArray colors = createRandomBytes(colorWidth * colorWidth * DataBlock::COLOR_BYTES,
+        colorWidth * colorWidth * DataBlock::COLOR_BYTES);
+    
+    Heightfield* heightfield = new Heightfield();
+    heightfield->setHeight(HeightfieldHeightPointer(new HeightfieldHeight(heightWidth, heights)));
+    heightfield->setColor(HeightfieldColorPointer(new HeightfieldColor(colorWidth, colors)));
+    heightfield->setScale(1.0f);
+    return heightfield;
+}
+
+/// Times persisting and loading the data, and the deltas sent as the viewer moves.
+static void benchmarkStreamingData(const MetavoxelData& data, QJsonObject& results) {
+    QElapsedTimer timer;
+    QByteArray array;
+    {
+        QDataStream outStream(&array, QIODevice::WriteOnly);
+        Bitstream out(outStream);
+        timer.start();
+        data.write(out);
+        out.flush();
+        results["persist_ms"] = timer.nsecsElapsed() / 1000000.0;
+        results["persist_bytes"] = array.size();
+    }
+    {
+        QDataStream inStream(array);
+        Bitstream in(inStream);
+        MetavoxelData loaded;
+        timer.start();
+        loaded.read(in);
+        results["load_ms"] = timer.nsecsElapsed() / 1000000.0;
+    }
+    
+    // step the viewer across the data, sending each time the delta from what it had at the last position
+    const float LOD_THRESHOLD = 0.01f;
+    const int LOD_MOVES = 8;
+    MetavoxelLOD lastLOD(glm::vec3(0.0f, 0.5f, 0.0f), LOD_THRESHOLD);
+    qint64 writeNsecs = 0, readNsecs = 0;
+    int deltaBytes = 0;
+    for (int i = 1; i <= LOD_MOVES; i++) {
+        float progress = (float)i / LOD_MOVES;
+        MetavoxelLOD lod(glm::vec3(progress, 0.5f, progress), LOD_THRESHOLD);
+        QByteArray deltaArray;
+        QDataStream outStream(&deltaArray, QIODevice::WriteOnly);
+        Bitstream out(outStream);
+        timer.start();
+        data.writeDelta(data, lastLOD, out, lod);
+        out.flush();
+        writeNsecs += timer.nsecsElapsed();
+        deltaBytes += deltaArray.size();
+        
+        QDataStream inStream(deltaArray);
+        Bitstream in(inStream);
+        MetavoxelData received = data;
+        timer.start();
+        received.readDelta(data, lastLOD, in, lod);
+        readNsecs += timer.nsecsElapsed();
+        lastLOD = lod;
+    }
+    results["lod_move_delta_bytes"] = (double)deltaBytes / LOD_MOVES;
+    results["lod_move_write_ms"] = writeNsecs / (1000000.0 * LOD_MOVES);
+    results["lod_move_read_ms"] = readNsecs / (1000000.0 * LOD_MOVES);
+}
+
+static QJsonArray benchmarkVoxelWorlds() {
+    QJsonArray results;
+    const int MIN_DEPTH = 5;
+    const int MAX_DEPTH = 7;
+    for (int depth = MIN_DEPTH; depth <= MAX_DEPTH; depth++) {
+        QJsonObject result;
+        result["depth"] = depth;
+        
+        QElapsedTimer timer;
+        MetavoxelData data;
+        TerrainFillVisitor fillVisitor(1.0f / (1 << depth));
+        timer.start();
+        data.guide(fillVisitor);
+        result["fill_ms"] = timer.nsecsElapsed() / 1000000.0;
+        result["leaves"] = fillVisitor.leafCount;
+        
+        for (int parallel = 0; parallel < 2; parallel++) {
+            SumVisitor sumVisitor(parallel);
+            timer.start();
+            data.guide(sumVisitor);
+            result[parallel ? "parallel_guide_ms" : "serial_guide_ms"] = timer.nsecsElapsed() / 1000000.0;
+        }
+        benchmarkStreamingData(data, result);
+        results.append(result);
+    }
+    return results;
+}
+
+static QJsonArray benchmarkHeightfieldWorlds() {
+    QJsonArray results;
+    const int MIN_INNER_WIDTH = 128;
+    const int MAX_INNER_WIDTH = 1024;
+    for (int innerWidth = MIN_INNER_WIDTH; innerWidth <= MAX_INNER_WIDTH; innerWidth *= 2) {
+        QJsonObject result;
+        result["width"] = innerWidth;
+        
+        QElapsedTimer timer;
+        timer.start();
+        SharedObjectPointer heightfield = createTerrainHeightfield(innerWidth);
+        result["build_ms"] = timer.nsecsElapsed() / 1000000.0;
+        
+        MetavoxelData data;
+        data.insert(AttributeRegistry::getInstance()->getSpannersAttribute(), heightfield);
+        benchmarkStreamingData(data, result);
+        results.append(result);
+    }
+    return results;
+}
+
+/// Times the library's hot paths and prints the results to standard output as JSON, to be compared across builds.
+static void runBenchmarks() {
+    QJsonObject results;
+    results["bitstream"] = benchmarkBitstream();
+    results["voxel_worlds"] = benchmarkVoxelWorlds();
+    results["heightfield_worlds"] = benchmarkHeightfieldWorlds();
+    
+    fputs(QJsonDocument(results).toJson().constData(), stdout);
+    fflush(stdout);
+}
+
 bool MetavoxelTests::run() {
     DependencyManager::set<LimitedNodeList>();
 
@@ -448,8 +935,12 @@ bool MetavoxelTests::run() {
     // register our test attribute
     AttributePointer testAttribute = AttributeRegistry::getInstance()->registerAttribute(new FloatAttribute("testAttribute"));
 
-    // check for an optional command line argument specifying a single test
+    // check for an optional command line argument specifying a single test, or that we should time rather than test
     QStringList arguments = this->arguments();
+    if (arguments.contains("--benchmark")) {
+        runBenchmarks();
+        return false;
+    }
     int test = (arguments.size() > 1) ? arguments.at(1).toInt() : 0;
 
     if (test == 0 || test == 1) {
@@ -561,6 +1052,42 @@ bool MetavoxelTests::run() {
             "spanner mutations";
     }
     
+    if (test == 0 || test == 6) {
+        qDebug() << "Running bulk streaming test...";
+        qDebug();
+        
+        if (testBulkStreaming()) {
+            return true;
+        }
+    }
+    
+    if (test == 0 || test == 7) {
+        qDebug() << "Running property accessor test...";
+        qDebug();
+        
+        if (testPropertyAccessors()) {
+            return true;
+        }
+    }
+    
+    if (test == 0 || test == 8) {
+        qDebug() << "Running parallel tour test...";
+        qDebug();
+        
+        if (testParallelTour()) {
+            return true;
+        }
+    }
+    
+    if (test == 0 || test == 9) {
+        qDebug() << "Running delta recording test...";
+        qDebug();
+        
+        if (testDeltaRecording()) {
+            return true;
+        }
+    }
+    
     qDebug() << "All tests passed!";
     
     return false;
@@ -28,7 +28,8 @@ public:
     
     MetavoxelTests(int& argc, char** argv);
     
-    /// Performs our various tests.
+    /// Performs our various tests, or, given --benchmark, times streaming, tours and persistence and prints the results as
+    /// JSON.
     /// \return true if any of the tests failed.
     bool run();
 };
@@ -0,0 +1,183 @@
+//
+//  NetworkBenchmark.cpp
+//  tests/network-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <climits>
+#include <math.h>
+#include <stdio.h>
+
+#include <AudioConstants.h>
+#include <InboundAudioStream.h>
+#include <LimitedNodeList.h>
+#include <SharedUtil.h>
+
+#include "NetworkBenchmark.h"
+
+static const char* STREAM_NAMES[] = { "audio", "avatars", "octree" };
+
+// a mixed stereo frame and its header
+static const int AUDIO_BYTES = AudioConstants::NETWORK_FRAME_BYTES_STEREO + 32;
+
+NetworkBenchmark::Settings::Settings() :
+    profiles(QStringList() << "none" << NetworkImpairment::getProfileNames()),
+    seconds(60),
+    avatarBytes(1200),
+    avatarRate(60),
+    octreeRate(1000),
+    jitterBufferFrames(DEFAULT_STATIC_DESIRED_JITTER_BUFFER_FRAMES),
+    seed(1)
+{
+}
+
+NetworkBenchmark::NetworkBenchmark(const Settings& settings) :
+    _settings(settings)
+{
+}
+
+bool NetworkBenchmark::run() {
+    QVector<NetworkImpairment::Settings> impairments;
+    foreach (const QString& profile, _settings.profiles) {
+        NetworkImpairment::Settings impairment;
+        if (!NetworkImpairment::parseSettings(profile, impairment)) {
+            printf("unreadable profile: %s\n", profile.toLocal8Bit().constData());
+            return false;
+        }
+        impairments << impairment;
+    }
+
+    printf("%d s of audio at %d ms a frame, %d B avatar packets at %d Hz and %d kbps of octree packets\n",
+           _settings.seconds, AudioConstants::NETWORK_FRAME_USECS / (int)USECS_PER_MSEC, _settings.avatarBytes,
+           _settings.avatarRate, _settings.octreeRate);
+    for (int i = 0; i < impairments.size(); i++) {
+        runProfile(_settings.profiles.at(i), impairments.at(i));
+    }
+    return true;
+}
+
+QVector<NetworkBenchmark::Datagram> NetworkBenchmark::scheduleDatagrams() const {
+    quint64 duration = (quint64)_settings.seconds * USECS_PER_SECOND;
+    quint64 intervals[NUM_STREAMS] = {
+        AudioConstants::NETWORK_FRAME_USECS,
+        _settings.avatarRate > 0 ? USECS_PER_SECOND / _settings.avatarRate : 0,
+        _settings.octreeRate > 0 ? (quint64)MAX_PACKET_SIZE * BITS_IN_BYTE * USECS_PER_MSEC / _settings.octreeRate : 0
+    };
+
+    QVector<Datagram> datagrams;
+    for (int stream = 0; stream < NUM_STREAMS; stream++) {
+        if (intervals[stream] == 0) {
+            continue;
+        }
+        int sequence = 0;
+        // the streams start out of phase with each other, the way the mixers and servers do
+        for (quint64 time = stream * USECS_PER_MSEC; time < duration; time += intervals[stream]) {
+            Datagram datagram = { time, 0, stream, sequence++, false };
+            datagrams << datagram;
+        }
+    }
+    std::stable_sort(datagrams.begin(), datagrams.end(), [](const Datagram& a, const Datagram& b) {
+        return a.sendTime < b.sendTime;
+    });
+    return datagrams;
+}
+
+static quint64 percentile(QVector<quint64>& values, float fraction) {
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[qMin(values.size() - 1, (int)(values.size() * fraction))];
+}
+
+void NetworkBenchmark::runProfile(const QString& name, const NetworkImpairment::Settings& impairmentSettings) {
+    NetworkImpairment impairment(_settings.seed);
+    impairment.setSettings(impairmentSettings);
+
+    const int sizes[NUM_STREAMS] = { AUDIO_BYTES, _settings.avatarBytes, MAX_PACKET_SIZE };
+    QVector<Datagram> datagrams = scheduleDatagrams();
+    for (int i = 0; i < datagrams.size(); i++) {
+        Datagram& datagram = datagrams[i];
+        datagram.arrived = impairment.admit(sizes[datagram.stream], datagram.sendTime, datagram.arrivalTime);
+    }
+
+    printf("\nprofile: %s (%.0f ms latency, %.0f ms jitter, %.1f%% loss, %.1f%% reordering, %d kbps)\n",
+           name.toLocal8Bit().constData(), impairmentSettings.latency, impairmentSettings.jitter,
+           impairmentSettings.lossRate * 100.0f, impairmentSettings.reorderRate * 100.0f, impairmentSettings.bandwidth);
+
+    for (int stream = 0; stream < NUM_STREAMS; stream++) {
+        QVector<Datagram> arrivals;
+        int numSent = 0;
+        foreach (const Datagram& datagram, datagrams) {
+            if (datagram.stream == stream) {
+                numSent++;
+                if (datagram.arrived) {
+                    arrivals << datagram;
+                }
+            }
+        }
+        if (numSent == 0) {
+            continue;
+        }
+
+        QVector<quint64> latencies;
+        foreach (const Datagram& datagram, arrivals) {
+            latencies << datagram.arrivalTime - datagram.sendTime;
+        }
+
+        // out of order is arriving after one sent later than it
+        std::stable_sort(arrivals.begin(), arrivals.end(), [](const Datagram& a, const Datagram& b) {
+            return a.arrivalTime < b.arrivalTime;
+        });
+        int outOfOrder = 0;
+        int highestSequence = -1;
+        foreach (const Datagram& datagram, arrivals) {
+            if (datagram.sequence < highestSequence) {
+                outOfOrder++;
+            }
+            highestSequence = qMax(highestSequence, datagram.sequence);
+        }
+
+        printf("  %-8s delivered: %6.2f%% latency p50: %6.1f ms p99: %6.1f ms max: %6.1f ms out of order: %5.2f%%\n",
+               STREAM_NAMES[stream], 100.0f * arrivals.size() / numSent,
+               (float)percentile(latencies, 0.5f) / USECS_PER_MSEC, (float)percentile(latencies, 0.99f) / USECS_PER_MSEC,
+               (float)percentile(latencies, 1.0f) / USECS_PER_MSEC, 100.0f * outOfOrder / qMax(arrivals.size(), 1));
+
+        if (stream != AUDIO || arrivals.isEmpty()) {
+            continue;
+        }
+
+        // frames play back at the rate they were sent from the earliest any of them could, how far each one arrives
+        // behind that is the buffering it needs to be on time
+        quint64 frameUsecs = AudioConstants::NETWORK_FRAME_USECS;
+        quint64 playbackStart = ULLONG_MAX;
+        foreach (const Datagram& frame, arrivals) {
+            playbackStart = qMin(playbackStart, frame.arrivalTime - frame.sequence * frameUsecs);
+        }
+        QVector<quint64> needed;
+        int late = 0;
+        quint64 buffered = _settings.jitterBufferFrames * frameUsecs;
+        foreach (const Datagram& frame, arrivals) {
+            quint64 behind = frame.arrivalTime - frame.sequence * frameUsecs - playbackStart;
+            needed << behind;
+            if (behind > buffered) {
+                late++;
+            }
+        }
+        int framesFor99 = (int)ceil((double)percentile(needed, 0.99f) / frameUsecs);
+        int framesFor999 = (int)ceil((double)percentile(needed, 0.999f) / frameUsecs);
+        printf("  %-8s jitter buffer frames for 99%%: %d for 99.9%%: %d, late with %d: %.2f%% silent: %.2f%%\n",
+               "", framesFor99, framesFor999, _settings.jitterBufferFrames, 100.0f * late / numSent,
+               100.0f * (numSent - arrivals.size() + late) / numSent);
+    }
+
+    NetworkImpairment::Stats stats = impairment.getStats();
+    printf("  link: %llu sent %llu lost %llu dropped by the bandwidth cap %llu reordered\n",
+           (unsigned long long)stats.sent, (unsigned long long)stats.lost, (unsigned long long)stats.overflowed,
+           (unsigned long long)stats.reordered);
+}
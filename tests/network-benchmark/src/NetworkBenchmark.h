@@ -0,0 +1,66 @@
+//
+//  NetworkBenchmark.h
+//  tests/network-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkBenchmark_h
+#define hifi_NetworkBenchmark_h
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <NetworkImpairment.h>
+
+/// Sends what a client receives from its mixers and servers, the mixed audio, the bulk avatar data and octree packets,
+/// through a NetworkImpairment under each of a list of profiles in simulated time, and reports what each stream gets:
+/// how much arrives, how late, how much out of order, and for the audio how deep a jitter buffer it takes to play it.
+class NetworkBenchmark {
+public:
+    struct Settings {
+        Settings();
+
+        QStringList profiles;   // names or descriptions NetworkImpairment::parseSettings() reads
+        int seconds;
+        int avatarBytes;        // of each bulk avatar packet
+        int avatarRate;         // packets per second
+        int octreeRate;         // kbits per second of octree packets
+        int jitterBufferFrames; // the audio buffer the late frames are counted against
+        unsigned int seed;
+    };
+
+    NetworkBenchmark(const Settings& settings);
+
+    /// \return false if one of the profiles couldn't be read
+    bool run();
+
+private:
+    enum Stream {
+        AUDIO,
+        AVATARS,
+        OCTREE,
+        NUM_STREAMS
+    };
+
+    struct Datagram {
+        quint64 sendTime;
+        quint64 arrivalTime;
+        int stream;
+        int sequence;
+        bool arrived;
+    };
+
+    void runProfile(const QString& name, const NetworkImpairment::Settings& impairmentSettings);
+
+    /// every datagram the streams send over the run, in the order they're sent
+    QVector<Datagram> scheduleDatagrams() const;
+
+    Settings _settings;
+};
+
+#endif // hifi_NetworkBenchmark_h
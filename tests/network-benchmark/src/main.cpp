@@ -0,0 +1,69 @@
+//
+//  main.cpp
+//  tests/network-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+
+#include "NetworkBenchmark.h"
+
+static void printUsage() {
+    printf("usage: network-benchmark [--profile NAME[,key=value...]]... [--seconds N] [--avatar-bytes N]\n"
+           "                         [--avatar-rate HZ] [--octree-rate KBPS] [--jitter-frames N] [--seed N]\n"
+           "profiles: none %s, keys: latency jitter loss reorder bandwidth queue\n",
+           NetworkImpairment::getProfileNames().join(" ").toLocal8Bit().constData());
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    NetworkBenchmark::Settings settings;
+    QStringList profiles;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (strcmp(option, "--profile") == 0) {
+            profiles << value;
+        } else if (strcmp(option, "--seconds") == 0) {
+            settings.seconds = atoi(value);
+        } else if (strcmp(option, "--avatar-bytes") == 0) {
+            settings.avatarBytes = atoi(value);
+        } else if (strcmp(option, "--avatar-rate") == 0) {
+            settings.avatarRate = atoi(value);
+        } else if (strcmp(option, "--octree-rate") == 0) {
+            settings.octreeRate = atoi(value);
+        } else if (strcmp(option, "--jitter-frames") == 0) {
+            settings.jitterBufferFrames = atoi(value);
+        } else if (strcmp(option, "--seed") == 0) {
+            settings.seed = (unsigned int)atoi(value);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (!profiles.isEmpty()) {
+        settings.profiles = profiles;
+    }
+
+    NetworkBenchmark benchmark(settings);
+    if (!benchmark.run()) {
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+//
+//  CoalescedNetworkReplyTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include <QEventLoop>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QUrl>
+
+#include "CoalescedNetworkReplyTests.h"
+
+static const QByteArray CONTENTS = QByteArray(100000, 'x') + "the end";
+
+static QUrl writeContents(QTemporaryFile& file) {
+    bool opened = file.open();
+    assert(opened);
+    file.write(CONTENTS);
+    file.flush();
+    return QUrl::fromLocalFile(file.fileName());
+}
+
+static void waitFor(QNetworkReply* reply) {
+    if (reply->isFinished()) {
+        return;
+    }
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    QTimer::singleShot(5000, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+void CoalescedNetworkReplyTests::runAllTests() {
+    sharedDownloadTest();
+    abortTest();
+}
+
+void CoalescedNetworkReplyTests::sharedDownloadTest() {
+    QTemporaryFile file;
+    QNetworkRequest request(writeContents(file));
+
+    // the second joins the first's download, and both get all of it
+    QNetworkReply* first = CoalescedNetworkReply::get(request);
+    QNetworkReply* second = CoalescedNetworkReply::get(request);
+    waitFor(first);
+    waitFor(second);
+    assert(first->isFinished() && second->isFinished());
+    assert(first->error() == QNetworkReply::NoError && second->error() == QNetworkReply::NoError);
+    assert(first->readAll() == CONTENTS);
+    assert(second->readAll() == CONTENTS);
+    delete first;
+    delete second;
+
+    // once done, the same request starts over rather than joining what finished
+    QNetworkReply* third = CoalescedNetworkReply::get(request);
+    waitFor(third);
+    assert(third->readAll() == CONTENTS);
+    delete third;
+}
+
+void CoalescedNetworkReplyTests::abortTest() {
+    QTemporaryFile file;
+    QNetworkRequest request(writeContents(file));
+
+    // aborting one of the followers leaves the download to the other
+    QNetworkReply* aborted = CoalescedNetworkReply::get(request);
+    QNetworkReply* kept = CoalescedNetworkReply::get(request);
+    aborted->abort();
+    assert(aborted->isFinished() && aborted->error() == QNetworkReply::OperationCanceledError);
+    waitFor(kept);
+    assert(kept->error() == QNetworkReply::NoError);
+    assert(kept->readAll() == CONTENTS);
+    delete aborted;
+    delete kept;
+}
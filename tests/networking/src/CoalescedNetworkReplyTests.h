@@ -0,0 +1,24 @@
+//
+//  CoalescedNetworkReplyTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CoalescedNetworkReplyTests_h
+#define hifi_CoalescedNetworkReplyTests_h
+
+#include "CoalescedNetworkReply.h"
+
+namespace CoalescedNetworkReplyTests {
+
+    void runAllTests();
+
+    void sharedDownloadTest();
+    void abortTest();
+};
+
+#endif // hifi_CoalescedNetworkReplyTests_h
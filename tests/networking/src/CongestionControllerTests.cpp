@@ -0,0 +1,107 @@
+//
+//  CongestionControllerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include <SharedUtil.h>
+
+#include "CongestionControllerTests.h"
+
+void CongestionControllerTests::runAllTests() {
+    pacingTest();
+    delayTest();
+    applicationLimitedTest();
+    lossTest();
+}
+
+const int PACKET_BYTES = 1000;
+const quint64 BASE_ROUND_TRIP = 20 * USECS_PER_MSEC;
+
+// sends as much as the pacer allows, a millisecond at a time, and returns how many bytes went
+static int sendPaced(CongestionController& controller, quint64 start, quint64 duration) {
+    int bytesSent = 0;
+    for (quint64 now = start; now < start + duration; now += USECS_PER_MSEC) {
+        while (controller.canSend(PACKET_BYTES, now)) {
+            controller.packetSent(PACKET_BYTES, now);
+            bytesSent += PACKET_BYTES;
+        }
+    }
+    return bytesSent;
+}
+
+void CongestionControllerTests::pacingTest() {
+    CongestionController controller;
+    
+    // over a second the pacer lets out about the rate, give or take the burst it starts with
+    int bytesSent = sendPaced(controller, USECS_PER_SECOND, USECS_PER_SECOND);
+    int rate = controller.getSendRate();
+    assert(bytesSent > rate * 0.9f && bytesSent < rate * 1.1f);
+    
+    // a real time stream that runs over shuts out the bulk traffic until it's paid back
+    quint64 now = 2 * USECS_PER_SECOND;
+    controller.packetSent(rate / 10, now);
+    assert(!controller.canSend(PACKET_BYTES, now + USECS_PER_SECOND / 20));
+    assert(controller.canSend(PACKET_BYTES, now + USECS_PER_SECOND / 5));
+}
+
+void CongestionControllerTests::delayTest() {
+    CongestionController controller;
+    int initialRate = controller.getSendRate();
+    
+    // round trips at the base while we use the rate let it grow
+    quint64 now = USECS_PER_SECOND;
+    controller.roundTripSampled(BASE_ROUND_TRIP, now);
+    for (int i = 0; i < 5; i++) {
+        sendPaced(controller, now, USECS_PER_SECOND);
+        now += USECS_PER_SECOND;
+        controller.roundTripSampled(BASE_ROUND_TRIP, now);
+    }
+    int grownRate = controller.getSendRate();
+    assert(grownRate > initialRate);
+    assert(controller.getBaseRoundTrip() == BASE_ROUND_TRIP);
+    assert(controller.getQueuingDelay() == 0);
+    
+    // and a queue building well past the target brings it back down
+    sendPaced(controller, now, USECS_PER_SECOND);
+    now += USECS_PER_SECOND;
+    controller.roundTripSampled(BASE_ROUND_TRIP + 2 * CongestionController::TARGET_QUEUING_DELAY, now);
+    assert(controller.getSendRate() < grownRate);
+    assert(controller.getQueuingDelay() == 2 * CongestionController::TARGET_QUEUING_DELAY);
+}
+
+void CongestionControllerTests::applicationLimitedTest() {
+    CongestionController controller;
+    int initialRate = controller.getSendRate();
+    
+    // good round trips say nothing about a rate we haven't been using
+    quint64 now = USECS_PER_SECOND;
+    for (int i = 0; i < 10; i++) {
+        controller.packetSent(PACKET_BYTES, now);
+        now += USECS_PER_SECOND;
+        controller.roundTripSampled(BASE_ROUND_TRIP, now);
+    }
+    assert(controller.getSendRate() == initialRate);
+}
+
+void CongestionControllerTests::lossTest() {
+    CongestionController controller;
+    int initialRate = controller.getSendRate();
+    
+    controller.lossSampled(0.01f);
+    assert(controller.getSendRate() == initialRate);
+    
+    controller.lossSampled(0.2f);
+    assert(controller.getSendRate() < initialRate);
+    
+    for (int i = 0; i < 100; i++) {
+        controller.lossSampled(1.0f);
+    }
+    assert(controller.getSendRate() == CongestionController::MIN_SEND_RATE);
+}
@@ -0,0 +1,26 @@
+//
+//  CongestionControllerTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControllerTests_h
+#define hifi_CongestionControllerTests_h
+
+#include "CongestionController.h"
+
+namespace CongestionControllerTests {
+
+    void runAllTests();
+
+    void pacingTest();
+    void delayTest();
+    void applicationLimitedTest();
+    void lossTest();
+};
+
+#endif // hifi_CongestionControllerTests_h
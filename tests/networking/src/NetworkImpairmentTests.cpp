@@ -0,0 +1,159 @@
+//
+//  NetworkImpairmentTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include <SharedUtil.h>
+
+#include "NetworkImpairmentTests.h"
+
+void NetworkImpairmentTests::runAllTests() {
+    parseTest();
+    delayTest();
+    lossTest();
+    reorderTest();
+    bandwidthTest();
+}
+
+const int DATAGRAM_BYTES = 1000;
+const int NUM_DATAGRAMS = 10000;
+const quint64 SEND_INTERVAL = 10 * USECS_PER_MSEC;
+
+void NetworkImpairmentTests::parseTest() {
+    NetworkImpairment::Settings settings;
+    assert(NetworkImpairment::parseSettings("mobile", settings));
+    assert(settings.isImpaired() && settings.latency > 0.0f && settings.bandwidth > 0);
+
+    // pairs after a profile override it
+    assert(NetworkImpairment::parseSettings("mobile,loss=0.5, latency=10", settings));
+    assert(settings.lossRate == 0.5f && settings.latency == 10.0f && settings.bandwidth > 0);
+
+    assert(NetworkImpairment::parseSettings("jitter=5", settings));
+    assert(settings.jitter == 5.0f && settings.latency == 0.0f && settings.bandwidth == 0);
+
+    assert(NetworkImpairment::parseSettings("none", settings));
+    assert(!settings.isImpaired());
+
+    // anything unreadable leaves the settings alone
+    settings.latency = 42.0f;
+    assert(!NetworkImpairment::parseSettings("carrier-pigeon", settings));
+    assert(!NetworkImpairment::parseSettings("latency=fast", settings));
+    assert(!NetworkImpairment::parseSettings("latency=10,mobile", settings));
+    assert(settings.latency == 42.0f);
+}
+
+void NetworkImpairmentTests::delayTest() {
+    NetworkImpairment impairment;
+    NetworkImpairment::Settings settings;
+    settings.latency = 50.0f;
+    settings.jitter = 20.0f;
+    impairment.setSettings(settings);
+
+    // everything arrives between latency - jitter and latency + jitter late, plus whatever it waited behind the one
+    // before it, and in the order it was sent
+    quint64 lastRelease = 0;
+    quint64 maxDelay = 0;
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        quint64 now = USECS_PER_SECOND + i * SEND_INTERVAL;
+        quint64 release;
+        assert(impairment.admit(DATAGRAM_BYTES, now, release));
+        assert(release >= now + 30 * USECS_PER_MSEC);
+        assert(release >= lastRelease);
+        maxDelay = qMax(maxDelay, release - now);
+        lastRelease = release;
+    }
+    assert(maxDelay <= 70 * USECS_PER_MSEC);
+    assert(maxDelay > 60 * USECS_PER_MSEC);
+
+    // the queue hands them out once they're due
+    impairment.push("a", 1, HifiSockAddr(), 0);
+    impairment.push("b", 1, HifiSockAddr(), 0);
+    QVector<NetworkImpairment::Datagram> due;
+    impairment.takeDueDatagrams(lastRelease - 1, due);
+    assert(due.isEmpty() && impairment.hasQueuedDatagrams());
+    impairment.takeDueDatagrams(lastRelease + USECS_PER_SECOND, due);
+    assert(due.size() == 2 && due[0].data == "a" && due[1].data == "b");
+    assert(!impairment.hasQueuedDatagrams());
+}
+
+void NetworkImpairmentTests::lossTest() {
+    NetworkImpairment impairment;
+    NetworkImpairment::Settings settings;
+    settings.lossRate = 0.1f;
+    impairment.setSettings(settings);
+
+    int admitted = 0;
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        quint64 release;
+        if (impairment.admit(DATAGRAM_BYTES, i * SEND_INTERVAL, release)) {
+            admitted++;
+        }
+    }
+    float lossRate = 1.0f - (float)admitted / NUM_DATAGRAMS;
+    assert(lossRate > 0.08f && lossRate < 0.12f);
+    assert(impairment.getStats().lost == (quint64)(NUM_DATAGRAMS - admitted));
+}
+
+void NetworkImpairmentTests::reorderTest() {
+    NetworkImpairment impairment;
+    NetworkImpairment::Settings settings;
+    settings.latency = 20.0f;
+    settings.reorderRate = 0.05f;
+    impairment.setSettings(settings);
+
+    // a datagram picked to be reordered lands after some of those sent after it, and the others stay in order
+    int passed = 0;
+    quint64 lastInOrderRelease = 0;
+    QVector<quint64> heldBack;
+    for (int i = 0; i < NUM_DATAGRAMS; i++) {
+        quint64 now = i * USECS_PER_MSEC;
+        quint64 release;
+        assert(impairment.admit(DATAGRAM_BYTES, now, release));
+        if (release == now + 20 * USECS_PER_MSEC) {
+            assert(release >= lastInOrderRelease);
+            lastInOrderRelease = release;
+            foreach (quint64 held, heldBack) {
+                if (held > release) {
+                    passed++;
+                }
+            }
+            heldBack.clear();
+        } else {
+            heldBack << release;
+        }
+    }
+    NetworkImpairment::Stats stats = impairment.getStats();
+    assert(stats.reordered > NUM_DATAGRAMS * 0.03f && stats.reordered < NUM_DATAGRAMS * 0.07f);
+    assert(passed > 0);
+}
+
+void NetworkImpairmentTests::bandwidthTest() {
+    NetworkImpairment impairment;
+    NetworkImpairment::Settings settings;
+    settings.bandwidth = 800; // 100 bytes a msec
+    settings.maxQueueDelay = 100.0f;
+    impairment.setSettings(settings);
+
+    // a burst goes out a datagram every 10 msecs until the queue is full, then the rest are dropped
+    quint64 now = USECS_PER_SECOND;
+    quint64 release;
+    for (int i = 0; i < 10; i++) {
+        assert(impairment.admit(DATAGRAM_BYTES, now, release));
+        assert(release == now + (i + 1) * 10 * USECS_PER_MSEC);
+    }
+    assert(impairment.admit(DATAGRAM_BYTES, now, release));
+    assert(!impairment.admit(DATAGRAM_BYTES, now, release));
+    assert(impairment.getStats().overflowed == 1);
+
+    // once it has drained the link carries the rate again
+    now += USECS_PER_SECOND;
+    assert(impairment.admit(DATAGRAM_BYTES, now, release));
+    assert(release == now + 10 * USECS_PER_MSEC);
+}
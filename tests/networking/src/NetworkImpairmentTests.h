@@ -0,0 +1,27 @@
+//
+//  NetworkImpairmentTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkImpairmentTests_h
+#define hifi_NetworkImpairmentTests_h
+
+#include "NetworkImpairment.h"
+
+namespace NetworkImpairmentTests {
+
+    void runAllTests();
+
+    void parseTest();
+    void delayTest();
+    void lossTest();
+    void reorderTest();
+    void bandwidthTest();
+};
+
+#endif // hifi_NetworkImpairmentTests_h
@@ -0,0 +1,67 @@
+//
+//  PacketBufferTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include "SentPacketHistory.h"
+
+#include "PacketBufferTests.h"
+
+void PacketBufferTests::runAllTests() {
+    poolTest();
+    appendTest();
+    sentPacketHistoryTest();
+}
+
+void PacketBufferTests::poolTest() {
+    // a released buffer is the next one handed out on the same thread
+    const char* released;
+    {
+        PacketBuffer buffer;
+        released = buffer.constData();
+    }
+    PacketBuffer reused;
+    assert(reused.constData() == released);
+    assert(reused.size() == 0);
+    
+    // while one that's still held isn't
+    PacketBuffer another;
+    assert(another.constData() != reused.constData());
+}
+
+void PacketBufferTests::appendTest() {
+    PacketBuffer buffer;
+    int numHeaderBytes = buffer.populateHeader(PacketTypeNoisyMute);
+    assert(numHeaderBytes == numBytesForPacketHeaderGivenPacketType(PacketTypeNoisyMute));
+    assert(buffer.size() == numHeaderBytes);
+    assert(packetTypeForPacket(buffer.constData()) == PacketTypeNoisyMute);
+    
+    QByteArray payload(buffer.getBytesAvailable(), 'x');
+    assert(!buffer.append(payload.constData(), payload.size() + 1));
+    assert(buffer.size() == numHeaderBytes);
+    assert(buffer.append(payload.constData(), payload.size()));
+    assert(buffer.size() == PacketBuffer::CAPACITY);
+    assert(buffer.getBytesAvailable() == 0);
+}
+
+void PacketBufferTests::sentPacketHistoryTest() {
+    const int HISTORY_SIZE = 4;
+    SentPacketHistory history(HISTORY_SIZE);
+    
+    // entries are overwritten in place, and still read back as what was sent into them
+    for (int i = 0; i < HISTORY_SIZE * 3; i++) {
+        QByteArray packet(MAX_PACKET_SIZE / (i + 1), (char)i);
+        history.packetSent(i, packet.constData(), packet.size());
+        assert(*history.getPacket(i) == packet);
+    }
+    for (int i = HISTORY_SIZE * 2; i < HISTORY_SIZE * 3; i++) {
+        assert(*history.getPacket(i) == QByteArray(MAX_PACKET_SIZE / (i + 1), (char)i));
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  PacketBufferTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferTests_h
+#define hifi_PacketBufferTests_h
+
+#include "PacketBuffer.h"
+
+namespace PacketBufferTests {
+
+    void runAllTests();
+
+    void poolTest();
+    void appendTest();
+    void sentPacketHistoryTest();
+};
+
+#endif // hifi_PacketBufferTests_h
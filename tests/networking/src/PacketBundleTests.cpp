@@ -0,0 +1,98 @@
+//
+//  PacketBundleTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include "LimitedNodeList.h"
+#include "PacketHeaders.h"
+
+#include "PacketBundleTests.h"
+
+static QByteArray makePacket(PacketType type, int payloadSize, char fill) {
+    QByteArray packet = byteArrayWithPopulatedHeader(type);
+    packet.append(QByteArray(payloadSize, fill));
+    return packet;
+}
+
+void PacketBundleTests::runAllTests() {
+    roundTripTest();
+    lonePacketTest();
+    fullBundleTest();
+    malformedTest();
+}
+
+void PacketBundleTests::roundTripTest() {
+    QVector<QByteArray> sent;
+    sent << makePacket(PacketTypeAudioEnvironment, 9, 'e') << makePacket(PacketTypeMixedAudio, 500, 'm')
+        << makePacket(PacketTypeAudioStreamStats, 60, 's');
+    
+    PacketBundle bundle;
+    foreach (const QByteArray& packet, sent) {
+        assert(bundle.append(packet.constData(), packet.size(), QUuid()));
+    }
+    assert(bundle.getPacketCount() == sent.size());
+    
+    QByteArray datagram(bundle.getDatagram(), bundle.getDatagramSize());
+    assert(packetTypeForPacket(datagram) == PacketTypeBundle);
+    
+    QVector<QByteArray> received;
+    assert(PacketBundle::unbundle(datagram, received));
+    assert(received == sent);
+    
+    // a cleared bundle starts over
+    bundle.clear();
+    assert(bundle.isEmpty());
+    assert(bundle.append(sent.at(0).constData(), sent.at(0).size(), QUuid()));
+    assert(bundle.getPacketCount() == 1);
+}
+
+void PacketBundleTests::lonePacketTest() {
+    // one packet isn't worth the bundle header, and goes out just as it would have
+    QByteArray packet = makePacket(PacketTypeMixedAudio, 500, 'm');
+    PacketBundle bundle;
+    assert(bundle.append(packet.constData(), packet.size(), QUuid()));
+    assert(QByteArray(bundle.getDatagram(), bundle.getDatagramSize()) == packet);
+}
+
+void PacketBundleTests::fullBundleTest() {
+    QByteArray packet = makePacket(PacketTypeBulkAvatarData, 400, 'a');
+    PacketBundle bundle;
+    int expectedCount = (MAX_PACKET_SIZE - numBytesForPacketHeaderGivenPacketType(PacketTypeBundle)) /
+        (PacketBundle::BYTES_PER_PACKET + packet.size());
+    for (int i = 0; i < expectedCount; i++) {
+        assert(bundle.append(packet.constData(), packet.size(), QUuid()));
+    }
+    
+    // a packet that doesn't fit leaves the bundle as it was
+    int fullSize = bundle.getDatagramSize();
+    assert(!bundle.append(packet.constData(), packet.size(), QUuid()));
+    assert(bundle.getPacketCount() == expectedCount);
+    assert(bundle.getDatagramSize() == fullSize);
+    assert(fullSize <= MAX_PACKET_SIZE);
+}
+
+void PacketBundleTests::malformedTest() {
+    QByteArray packet = makePacket(PacketTypeMixedAudio, 100, 'm');
+    PacketBundle bundle;
+    bundle.append(packet.constData(), packet.size(), QUuid());
+    bundle.append(packet.constData(), packet.size(), QUuid());
+    QByteArray datagram(bundle.getDatagram(), bundle.getDatagramSize());
+    
+    // a truncated last packet is an error, but the ones before it are still split out
+    QVector<QByteArray> received;
+    assert(!PacketBundle::unbundle(datagram.left(datagram.size() - 1), received));
+    assert(received.size() == 1 && received.at(0) == packet);
+    
+    // as is a length with no room for it
+    received.clear();
+    datagram.append((char)1);
+    assert(!PacketBundle::unbundle(datagram, received));
+    assert(received.size() == 2);
+}
@@ -0,0 +1,26 @@
+//
+//  PacketBundleTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBundleTests_h
+#define hifi_PacketBundleTests_h
+
+#include "PacketBundle.h"
+
+namespace PacketBundleTests {
+
+    void runAllTests();
+
+    void roundTripTest();
+    void lonePacketTest();
+    void fullBundleTest();
+    void malformedTest();
+};
+
+#endif // hifi_PacketBundleTests_h
@@ -0,0 +1,112 @@
+//
+//  PacketMetricsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <SharedUtil.h>
+
+#include "PacketMetricsTests.h"
+
+static QJsonObject getTypeObject(PacketMetrics& metrics, PacketType type) {
+    return metrics.toJson()["packet_types"].toObject()[nameForPacketType(type)].toObject();
+}
+
+void PacketMetricsTests::runAllTests() {
+    countsTest();
+    ratesTest();
+    processingTest();
+}
+
+void PacketMetricsTests::countsTest() {
+    PacketMetrics metrics;
+    
+    // types never seen are left out
+    if (!metrics.toJson()["packet_types"].toObject().isEmpty()) {
+        qDebug() << "\t FAILED - types never seen are listed";
+        return;
+    }
+    
+    metrics.packetReceived(PacketTypeAvatarData, 100);
+    metrics.packetReceived(PacketTypeAvatarData, 50);
+    metrics.packetSent(PacketTypeBulkAvatarData, 1000);
+    
+    QJsonObject avatarData = getTypeObject(metrics, PacketTypeAvatarData);
+    if (avatarData["packets_received"].toDouble() != 2.0 || avatarData["bytes_received"].toDouble() != 150.0 ||
+            avatarData["packets_sent"].toDouble() != 0.0) {
+        qDebug() << "\t FAILED - received counts" << avatarData;
+        return;
+    }
+    
+    QJsonObject bulkAvatarData = getTypeObject(metrics, PacketTypeBulkAvatarData);
+    if (bulkAvatarData["packets_sent"].toDouble() != 1.0 || bulkAvatarData["bytes_sent"].toDouble() != 1000.0) {
+        qDebug() << "\t FAILED - sent counts" << bulkAvatarData;
+        return;
+    }
+    
+    metrics.setQueueDepth("inbound", 3);
+    metrics.setQueueDepth("inbound", 7);
+    int depth = metrics.toJson()["queue_depths"].toObject()["inbound"].toInt();
+    if (depth != 7) {
+        qDebug() << "\t FAILED - queue depth" << depth << "expected the latest, 7";
+        return;
+    }
+}
+
+void PacketMetricsTests::ratesTest() {
+    PacketMetrics metrics;
+    quint64 now = USECS_PER_SECOND;
+    metrics.packetSent(PacketTypeMixedAudio, 500);
+    metrics.updateRates(now);
+    
+    // the first update only sets where the rates are counted from
+    double rate = getTypeObject(metrics, PacketTypeMixedAudio)["bytes_sent_per_second"].toDouble();
+    if (rate != 0.0) {
+        qDebug() << "\t FAILED - first update gave a rate of" << rate;
+        return;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        metrics.packetSent(PacketTypeMixedAudio, 500);
+    }
+    metrics.updateRates(now + 2 * USECS_PER_SECOND);
+    rate = getTypeObject(metrics, PacketTypeMixedAudio)["bytes_sent_per_second"].toDouble();
+    if (rate != 1000.0) {
+        qDebug() << "\t FAILED - rate of" << rate << "expected 1000";
+        return;
+    }
+    
+    metrics.updateRates(now + 3 * USECS_PER_SECOND);
+    rate = getTypeObject(metrics, PacketTypeMixedAudio)["bytes_sent_per_second"].toDouble();
+    if (rate != 0.0) {
+        qDebug() << "\t FAILED - idle rate of" << rate << "expected 0";
+        return;
+    }
+}
+
+void PacketMetricsTests::processingTest() {
+    PacketMetrics metrics;
+    metrics.packetReceived(PacketTypeEntityAddOrEdit, 100);
+    if (getTypeObject(metrics, PacketTypeEntityAddOrEdit).contains("processing_usecs")) {
+        qDebug() << "\t FAILED - processing times listed before any were recorded";
+        return;
+    }
+    
+    for (int i = 1; i <= 100; i++) {
+        metrics.packetProcessed(PacketTypeEntityAddOrEdit, i);
+    }
+    QJsonObject processing = getTypeObject(metrics, PacketTypeEntityAddOrEdit)["processing_usecs"].toObject();
+    if (processing["samples"].toInt() != 100 ||
+            processing["median"].toDouble() < 50.0 || processing["median"].toDouble() > 51.0 ||
+            processing["95th_percentile"].toDouble() < 95.0 || processing["95th_percentile"].toDouble() > 96.0 ||
+            processing["99th_percentile"].toDouble() < 99.0) {
+        qDebug() << "\t FAILED - processing times" << processing;
+        return;
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  PacketMetricsTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketMetricsTests_h
+#define hifi_PacketMetricsTests_h
+
+#include "PacketMetrics.h"
+
+namespace PacketMetricsTests {
+
+    void runAllTests();
+
+    void countsTest();
+    void ratesTest();
+    void processingTest();
+};
+
+#endif // hifi_PacketMetricsTests_h
@@ -0,0 +1,153 @@
+//
+//  ReliableChannelTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include <SharedUtil.h>
+
+#include "ReliableChannelTests.h"
+
+void ReliableChannelTests::runAllTests() {
+    windowTest();
+    rolloverTest();
+    lossTest();
+    malformedTest();
+}
+
+static QByteArray messageForIndex(int index) {
+    return QByteArray::number(index);
+}
+
+// passes packets between two channels a millisecond at a time, dropping every lossPeriod'th one in each direction
+// (none if zero), until everything has been acknowledged; returns how many milliseconds that took
+static int exchange(ReliableChannel& sender, ReliableChannel& receiver, int lossPeriod, int& nextToDeliver) {
+    const quint64 LATENCY = 10 * USECS_PER_MSEC;
+    const int MAX_MSECS = 5 * 60 * 1000;
+    
+    // packets on the way, with the time they arrive and whether they're headed for the receiver
+    struct Arrival {
+        quint64 time;
+        bool toReceiver;
+        QByteArray payload;
+    };
+    QList<Arrival> wire;
+    int sentCount = 0;
+    
+    for (int msecs = 0; msecs < MAX_MSECS; msecs++) {
+        quint64 now = msecs * USECS_PER_MSEC;
+        
+        QVector<QByteArray> packets;
+        sender.update(now, packets);
+        foreach (const QByteArray& packet, packets) {
+            if (lossPeriod == 0 || ++sentCount % lossPeriod != 0) {
+                Arrival arrival = { now + LATENCY, true, packet };
+                wire.append(arrival);
+            }
+        }
+        packets.clear();
+        receiver.update(now, packets);
+        foreach (const QByteArray& packet, packets) {
+            if (lossPeriod == 0 || ++sentCount % lossPeriod != 0) {
+                Arrival arrival = { now + LATENCY, false, packet };
+                wire.append(arrival);
+            }
+        }
+        
+        while (!wire.isEmpty() && wire.first().time <= now) {
+            Arrival arrival = wire.takeFirst();
+            QVector<QByteArray> messages;
+            if (arrival.toReceiver) {
+                bool parsed = receiver.packetReceived(arrival.payload, now, messages);
+                assert(parsed);
+                foreach (const QByteArray& message, messages) {
+                    assert(message == messageForIndex(nextToDeliver));
+                    nextToDeliver++;
+                }
+            } else {
+                bool parsed = sender.packetReceived(arrival.payload, now, messages);
+                assert(parsed);
+                assert(messages.isEmpty());
+            }
+        }
+        if (sender.getPendingMessageCount() == 0 && wire.isEmpty()) {
+            return msecs;
+        }
+    }
+    assert(false);
+    return MAX_MSECS;
+}
+
+void ReliableChannelTests::windowTest() {
+    ReliableChannel channel;
+    for (int i = 0; i < ReliableChannel::MAX_WINDOW * 2; i++) {
+        channel.queueMessage(messageForIndex(i));
+    }
+    
+    // nothing goes past the initial window until some of it has been acknowledged
+    QVector<QByteArray> packets;
+    channel.update(0, packets);
+    int initialWindow = packets.size();
+    assert(initialWindow > 0 && initialWindow < ReliableChannel::MAX_WINDOW);
+    
+    packets.clear();
+    channel.update(USECS_PER_MSEC, packets);
+    assert(packets.isEmpty());
+    assert(channel.getPendingMessageCount() == ReliableChannel::MAX_WINDOW * 2);
+    
+    // and without any acknowledgement, the first of them go out again once the timeout passes
+    channel.update(channel.getRetransmitTimeout() + 1, packets);
+    assert(packets.size() == initialWindow);
+}
+
+void ReliableChannelTests::rolloverTest() {
+    ReliableChannel sender;
+    ReliableChannel receiver;
+    
+    // enough to wrap the sequence numbers around
+    const int MESSAGE_COUNT = 70000;
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        sender.queueMessage(messageForIndex(i));
+    }
+    int nextToDeliver = 0;
+    exchange(sender, receiver, 0, nextToDeliver);
+    assert(nextToDeliver == MESSAGE_COUNT);
+    assert(receiver.getIncomingStats().getLost() == 0);
+    assert(sender.getCongestionWindow() == ReliableChannel::MAX_WINDOW);
+}
+
+void ReliableChannelTests::lossTest() {
+    ReliableChannel sender;
+    ReliableChannel receiver;
+    
+    const int MESSAGE_COUNT = 5000;
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        sender.queueMessage(messageForIndex(i));
+    }
+    
+    // one in seven lost both ways, which takes out data and acknowledgements alike
+    const int LOSS_PERIOD = 7;
+    int nextToDeliver = 0;
+    exchange(sender, receiver, LOSS_PERIOD, nextToDeliver);
+    assert(nextToDeliver == MESSAGE_COUNT);
+    assert(sender.getCongestionWindow() < ReliableChannel::MAX_WINDOW);
+}
+
+void ReliableChannelTests::malformedTest() {
+    ReliableChannel channel;
+    QVector<QByteArray> messages;
+    assert(!channel.packetReceived(QByteArray(), 0, messages));
+    assert(!channel.packetReceived(QByteArray(3, 0), 0, messages));
+    
+    // a message flag with no sequence number after it
+    QByteArray truncated(ReliableChannel::MAX_OVERHEAD_BYTES - 1, 0);
+    truncated[0] = 1;
+    assert(!channel.packetReceived(truncated, 0, messages));
+    assert(messages.isEmpty());
+}
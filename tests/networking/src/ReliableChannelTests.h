@@ -0,0 +1,26 @@
+//
+//  ReliableChannelTests.h
+//  tests/networking/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReliableChannelTests_h
+#define hifi_ReliableChannelTests_h
+
+#include "ReliableChannel.h"
+
+namespace ReliableChannelTests {
+
+    void runAllTests();
+
+    void windowTest();
+    void rolloverTest();
+    void lossTest();
+    void malformedTest();
+};
+
+#endif // hifi_ReliableChannelTests_h
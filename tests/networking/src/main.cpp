@@ -8,11 +8,30 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QCoreApplication>
+
+#include "CoalescedNetworkReplyTests.h"
+#include "CongestionControllerTests.h"
+#include "NetworkImpairmentTests.h"
+#include "PacketBufferTests.h"
+#include "PacketBundleTests.h"
+#include "PacketMetricsTests.h"
+#include "ReliableChannelTests.h"
 #include "SequenceNumberStatsTests.h"
 #include <stdio.h>
 
 int main(int argc, char** argv) {
+    // the network replies need an application to run their events
+    QCoreApplication application(argc, argv);
+
     SequenceNumberStatsTests::runAllTests();
+    ReliableChannelTests::runAllTests();
+    CongestionControllerTests::runAllTests();
+    PacketBufferTests::runAllTests();
+    PacketBundleTests::runAllTests();
+    PacketMetricsTests::runAllTests();
+    CoalescedNetworkReplyTests::runAllTests();
+    NetworkImpairmentTests::runAllTests();
     printf("tests passed! press enter to exit");
     getchar();
     return 0;
@@ -0,0 +1,323 @@
+//
+//  OctreeBenchmark.cpp
+//  tests/octree-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+
+#include <EntityItem.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <MovingEntitiesOperator.h>
+#include <OctreeConstants.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+#include <PacketHeaders.h>
+#include <SharedUtil.h>
+
+#include "OctreeBenchmark.h"
+
+static const quint64 NSECS_PER_USEC = 1000;
+
+// content comes in clumps, a few hundred of them, with a sprinkling spread over the whole domain
+static const int NUM_CLUSTERS = 256;
+static const float CLUSTER_RADIUS = 0.01f; // domain units
+static const float SCATTERED_FRACTION = 0.1f;
+
+// how far a moving entity goes in one update, in domain units
+static const float MAX_MOVE_DISTANCE = 0.002f;
+
+static glm::vec3 randomPosition() {
+    return glm::vec3(randFloat(), randFloat(), randFloat());
+}
+
+OctreeBenchmark::Settings::Settings() :
+    numEntities(10000),
+    numQueries(10000),
+    queryRadius(10.0f),
+    numMoveUpdates(60),
+    movingFraction(0.05f),
+    seed(1)
+{
+}
+
+OctreeBenchmark::OctreeBenchmark(const Settings& settings) :
+    _settings(settings),
+    _tree(new EntityTree(true)),
+    _buildUsecs(0)
+{
+    _tree->setIsServer(true);
+    srand(_settings.seed);
+}
+
+OctreeBenchmark::~OctreeBenchmark() {
+    delete _tree;
+}
+
+void OctreeBenchmark::buildTree() {
+    QVector<glm::vec3> clusters;
+    for (int i = 0; i < NUM_CLUSTERS; i++) {
+        clusters << randomPosition();
+    }
+
+    _entities.reserve(_settings.numEntities);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < _settings.numEntities; i++) {
+        glm::vec3 position;
+        if (randFloat() < SCATTERED_FRACTION) {
+            position = randomPosition();
+        } else {
+            glm::vec3 offset(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+            position = glm::clamp(clusters[i % NUM_CLUSTERS] + offset * CLUSTER_RADIUS, 0.0f, 1.0f);
+        }
+
+        EntityItemID entityID(QUuid::createUuid());
+        entityID.isKnownID = true; // the server's tree only takes entities with known IDs
+
+        EntityItemProperties properties;
+        properties.setType(i % 2 == 0 ? EntityTypes::Box : EntityTypes::Sphere);
+        properties.setPosition(position * (float)TREE_SCALE);
+        properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 4.0f)));
+        EntityItem* entity = _tree->addEntity(entityID, properties);
+        if (entity) {
+            _entities << entity;
+        }
+    }
+    _buildUsecs = timer.nsecsElapsed() / NSECS_PER_USEC;
+}
+
+bool OctreeBenchmark::run() {
+    printf("entities: %d elements: %lu built in %.3f ms\n", _entities.size(), _tree->getOctreeElementsCount(),
+           (float)_buildUsecs / USECS_PER_MSEC);
+
+    QJsonObject settings;
+    settings["entities"] = _entities.size();
+    settings["queries"] = _settings.numQueries;
+    settings["queryRadius"] = _settings.queryRadius;
+    settings["moveUpdates"] = _settings.numMoveUpdates;
+    settings["movingFraction"] = _settings.movingFraction;
+    settings["seed"] = (int)_settings.seed;
+    settings["buildMsecs"] = (double)_buildUsecs / USECS_PER_MSEC;
+    _results["settings"] = settings;
+
+    benchmarkEncode();
+    benchmarkDecode();
+    benchmarkQueries();
+    benchmarkMoves();
+    benchmarkPersist();
+
+    if (_settings.jsonFilename.isEmpty()) {
+        return true;
+    }
+    QFile file(_settings.jsonFilename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(QJsonDocument(_results).toJson()) < 0) {
+        printf("unable to write %s: %s\n", _settings.jsonFilename.toLocal8Bit().constData(),
+               file.errorString().toLocal8Bit().constData());
+        return false;
+    }
+    return true;
+}
+
+void OctreeBenchmark::addResult(const QString& name, QVector<quint64>& usecs, const QJsonObject& extra) {
+    QJsonObject result = extra;
+    int count = usecs.size();
+    result["count"] = count;
+    if (count == 0) {
+        _results[name] = result;
+        return;
+    }
+
+    quint64 totalUsecs = 0;
+    foreach (quint64 sample, usecs) {
+        totalUsecs += sample;
+    }
+    std::sort(usecs.begin(), usecs.end());
+    float total = (float)totalUsecs / USECS_PER_MSEC;
+    float mean = (float)totalUsecs / count / USECS_PER_MSEC;
+    float p50 = (float)usecs[count / 2] / USECS_PER_MSEC;
+    float p99 = (float)usecs[qMin(count - 1, (int)(count * 0.99f))] / USECS_PER_MSEC;
+    float max = (float)usecs.last() / USECS_PER_MSEC;
+
+    printf("%-8s x%-7d total: %.3f ms mean: %.4f ms p50: %.4f ms p99: %.4f ms max: %.4f ms\n",
+           name.toLocal8Bit().constData(), count, total, mean, p50, p99, max);
+
+    result["totalMsecs"] = total;
+    result["meanMsecs"] = mean;
+    result["p50Msecs"] = p50;
+    result["p99Msecs"] = p99;
+    result["maxMsecs"] = max;
+    _results[name] = result;
+}
+
+void OctreeBenchmark::benchmarkEncode() {
+    // the whole scene into packets the way the OctreeSendThread fills them for a client that has nothing yet, each
+    // sample is the encoding of one subtree
+    OctreeElementBag elementBag;
+    elementBag.insert(_tree->getRoot());
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData;
+    QVector<quint64> usecs;
+    qint64 totalBytes = 0;
+    QElapsedTimer timer;
+
+    _tree->prepareFullSceneEncode();
+    while (!elementBag.isEmpty()) {
+        OctreeElement* subTree = elementBag.extract();
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, WANT_EXISTS_BITS);
+        params.extraEncodeData = &extraEncodeData;
+
+        timer.start();
+        int bytesWritten = _tree->encodeTreeBitstream(subTree, &packetData, elementBag, params);
+        usecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+
+        if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+            if (packetData.hasContent()) {
+                QByteArray packet(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                                  packetData.getUncompressedSize());
+                totalBytes += packet.size();
+                _encodedPackets << packet;
+            }
+            packetData.reset();
+            elementBag.insert(subTree);
+        }
+    }
+    if (packetData.hasContent()) {
+        totalBytes += packetData.getUncompressedSize();
+        _encodedPackets << QByteArray(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                                      packetData.getUncompressedSize());
+    }
+    _tree->releaseSceneEncodeData(&extraEncodeData);
+
+    QJsonObject extra;
+    extra["packets"] = _encodedPackets.size();
+    extra["bytes"] = totalBytes;
+    addResult("encode", usecs, extra);
+}
+
+void OctreeBenchmark::benchmarkDecode() {
+    // the packets benchmarkEncode() made read into a client's tree, one sample a packet
+    EntityTree clientTree;
+    PacketVersion version = versionForPacketType(clientTree.expectedDataPacketType());
+    QVector<quint64> usecs;
+    QElapsedTimer timer;
+
+    foreach (const QByteArray& packet, _encodedPackets) {
+        ReadBitstreamToTreeParams args(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false, version);
+        timer.start();
+        clientTree.readBitstreamToTree(reinterpret_cast<const unsigned char*>(packet.constData()), packet.size(), args);
+        usecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+    }
+
+    QVector<EntityItem*> decodedEntities;
+    clientTree.findEntities(AACube(glm::vec3(0.0f), 1.0f), decodedEntities);
+
+    QJsonObject extra;
+    extra["entities"] = decodedEntities.size();
+    addResult("decode", usecs, extra);
+    if (decodedEntities.size() != _entities.size()) {
+        printf("decode: read %d of %d entities\n", decodedEntities.size(), _entities.size());
+    }
+}
+
+void OctreeBenchmark::benchmarkQueries() {
+    // spheres around entities, so the queries land where the content is
+    float radius = _settings.queryRadius / (float)TREE_SCALE;
+    QVector<const EntityItem*> foundEntities;
+    QVector<quint64> usecs;
+    usecs.reserve(_settings.numQueries);
+    qint64 totalFound = 0;
+    QElapsedTimer timer;
+
+    for (int i = 0; i < _settings.numQueries && !_entities.isEmpty(); i++) {
+        glm::vec3 center = _entities[randIntInRange(0, _entities.size() - 1)]->getPosition();
+        timer.start();
+        _tree->findEntities(center, radius, foundEntities);
+        usecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+        totalFound += foundEntities.size();
+    }
+
+    QJsonObject extra;
+    extra["meanFound"] = usecs.isEmpty() ? 0.0 : (double)totalFound / usecs.size();
+    addResult("query", usecs, extra);
+}
+
+void OctreeBenchmark::benchmarkMoves() {
+    // a share of the entities nudged each update and sorted back into the tree, the way a simulation does
+    int numMoving = qMin(_entities.size(), qMax(1, (int)(_settings.movingFraction * _entities.size())));
+    QVector<quint64> usecs;
+    usecs.reserve(_settings.numMoveUpdates);
+    QElapsedTimer timer;
+
+    for (int update = 0; update < _settings.numMoveUpdates && !_entities.isEmpty(); update++) {
+        int first = randIntInRange(0, _entities.size() - 1);
+
+        timer.start();
+        _tree->lockForWrite();
+        MovingEntitiesOperator moveOperator(_tree);
+        moveOperator.reserve(numMoving);
+        for (int i = 0; i < numMoving; i++) {
+            EntityItem* entity = _entities[(first + i) % _entities.size()];
+            glm::vec3 step(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+            entity->setPosition(glm::clamp(entity->getPosition() + step * MAX_MOVE_DISTANCE, 0.0f, 1.0f));
+            moveOperator.addEntityToMoveList(entity, entity->getMaximumAACube());
+        }
+        moveOperator.moveEntities();
+        _tree->unlock();
+        usecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+    }
+
+    QJsonObject extra;
+    extra["entitiesPerUpdate"] = numMoving;
+    addResult("move", usecs, extra);
+}
+
+void OctreeBenchmark::benchmarkPersist() {
+    // the persist thread's save, then the load a restarted server does
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        printf("persist: no temporary directory\n");
+        return;
+    }
+    QByteArray filename = directory.filePath("models.svo").toLocal8Bit();
+    QElapsedTimer timer;
+
+    QVector<quint64> saveUsecs;
+    timer.start();
+    bool saved = _tree->writeToSVOFile(filename.constData());
+    saveUsecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+    if (!saved) {
+        printf("persist: unable to write %s\n", filename.constData());
+        return;
+    }
+    QJsonObject saveExtra;
+    saveExtra["bytes"] = QFileInfo(QString::fromLocal8Bit(filename)).size();
+    addResult("save", saveUsecs, saveExtra);
+
+    EntityTree loadedTree(true);
+    loadedTree.setIsServer(true);
+    QVector<quint64> loadUsecs;
+    timer.start();
+    loadedTree.readFromSVOFile(filename.constData());
+    loadUsecs << timer.nsecsElapsed() / NSECS_PER_USEC;
+
+    QVector<EntityItem*> loadedEntities;
+    loadedTree.findEntities(AACube(glm::vec3(0.0f), 1.0f), loadedEntities);
+    QJsonObject loadExtra;
+    loadExtra["entities"] = loadedEntities.size();
+    addResult("load", loadUsecs, loadExtra);
+}
@@ -0,0 +1,70 @@
+//
+//  OctreeBenchmark.h
+//  tests/octree-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeBenchmark_h
+#define hifi_OctreeBenchmark_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class EntityItem;
+class EntityTree;
+
+/// Fills an EntityTree with synthetic entities and times the server's hot paths over it: encoding the whole scene into
+/// packets, reading those packets into a client tree, sphere queries, moving entities between elements and a persist
+/// and load through an SVO file. Prints a summary of each and can write the results out as JSON to compare runs.
+class OctreeBenchmark {
+public:
+    struct Settings {
+        Settings();
+
+        int numEntities;
+        int numQueries;
+        float queryRadius;      // meters
+        int numMoveUpdates;
+        float movingFraction;   // of the entities moved by each update
+        unsigned int seed;
+        QString jsonFilename;   // empty for no JSON
+    };
+
+    OctreeBenchmark(const Settings& settings);
+    ~OctreeBenchmark();
+
+    /// adds settings.numEntities boxes and spheres spread over the domain, clustered the way content tends to be
+    void buildTree();
+
+    /// times each phase in turn, prints them and writes the JSON if asked to
+    /// \return false if the JSON couldn't be written
+    bool run();
+
+private:
+    void benchmarkEncode();
+    void benchmarkDecode();
+    void benchmarkQueries();
+    void benchmarkMoves();
+    void benchmarkPersist();
+
+    /// prints the timings of a phase and adds them to the results under name, along with extra
+    void addResult(const QString& name, QVector<quint64>& usecs, const QJsonObject& extra = QJsonObject());
+
+    Settings _settings;
+
+    EntityTree* _tree;
+    QVector<EntityItem*> _entities;
+    quint64 _buildUsecs;
+
+    QVector<QByteArray> _encodedPackets;    // what benchmarkEncode() made, for benchmarkDecode() to read
+
+    QJsonObject _results;
+};
+
+#endif // hifi_OctreeBenchmark_h
@@ -0,0 +1,60 @@
+//
+//  main.cpp
+//  tests/octree-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+
+#include "OctreeBenchmark.h"
+
+static void printUsage() {
+    printf("usage: octree-benchmark [--entities N] [--queries N] [--query-radius METERS] [--move-updates N]\n"
+           "                        [--moving-fraction F] [--seed N] [--json FILE]\n");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    OctreeBenchmark::Settings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (strcmp(option, "--entities") == 0) {
+            settings.numEntities = atoi(value);
+        } else if (strcmp(option, "--queries") == 0) {
+            settings.numQueries = atoi(value);
+        } else if (strcmp(option, "--query-radius") == 0) {
+            settings.queryRadius = (float)atof(value);
+        } else if (strcmp(option, "--move-updates") == 0) {
+            settings.numMoveUpdates = atoi(value);
+        } else if (strcmp(option, "--moving-fraction") == 0) {
+            settings.movingFraction = (float)atof(value);
+        } else if (strcmp(option, "--seed") == 0) {
+            settings.seed = (unsigned int)atoi(value);
+        } else if (strcmp(option, "--json") == 0) {
+            settings.jsonFilename = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    OctreeBenchmark benchmark(settings);
+    benchmark.buildTree();
+    return benchmark.run() ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+//
+//  AnimationClipTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <glm/gtx/quaternion.hpp>
+
+#include <AnimationClip.h>
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+#include "AnimationClipTests.h"
+
+static const int NUMBER_OF_FRAMES = 120;
+
+static float getAngle(const glm::quat& first, const glm::quat& second) {
+    return 2.0f * acosf(glm::min(1.0f, fabsf(glm::dot(first, second))));
+}
+
+void AnimationClipTests::compressionTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "AnimationClipTests::compressionTests()";
+
+    // a joint that holds still, one that turns steadily, and one that changes its mind every few frames
+    QVector<FBXAnimationFrame> frames(NUMBER_OF_FRAMES);
+    glm::quat still = glm::angleAxis(0.3f, glm::normalize(glm::vec3(1.0f, 2.0f, 0.5f)));
+    for (int i = 0; i < NUMBER_OF_FRAMES; i++) {
+        float time = (float)i / NUMBER_OF_FRAMES;
+        frames[i].rotations.append(still);
+        frames[i].rotations.append(glm::angleAxis(time * PI, glm::vec3(0.0f, 1.0f, 0.0f)));
+        frames[i].rotations.append(glm::angleAxis(sinf(time * 40.0f) * 0.5f, glm::vec3(1.0f, 0.0f, 0.0f)) *
+            glm::angleAxis(cosf(time * 23.0f) * 0.7f, glm::vec3(0.0f, 0.0f, 1.0f)));
+    }
+    AnimationClip clip(frames);
+
+    testsTaken++;
+    if (clip.getFrameCount() == NUMBER_OF_FRAMES && clip.getJointCount() == 3 &&
+            clip.getKeyCount() < NUMBER_OF_FRAMES * 3 / 2) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: keys reduced" << clip.getKeyCount() << "of" << NUMBER_OF_FRAMES * 3;
+    }
+
+    // allow for the quantization on top of the key reduction
+    const float MAX_SAMPLE_ERROR = AnimationClip::MAX_KEY_ERROR + 0.001f;
+    float maxError = 0.0f;
+    for (int joint = 0; joint < 3; joint++) {
+        int cursor = 0;
+        for (int i = 0; i < NUMBER_OF_FRAMES; i++) {
+            maxError = glm::max(maxError, getAngle(clip.sampleFrame(joint, i, cursor), frames[i].rotations.at(joint)));
+        }
+    }
+    testsTaken++;
+    if (maxError < MAX_SAMPLE_ERROR) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: samples within error" << maxError << "expected" << MAX_SAMPLE_ERROR;
+    }
+
+    // a cursor left anywhere finds the same keys as a fresh one, and the last frame blends into the first
+    bool cursorsAgree = true;
+    int staleCursor = 1000;
+    for (int i = NUMBER_OF_FRAMES - 1; i >= 0; i -= 7) {
+        int freshCursor = 0;
+        cursorsAgree = cursorsAgree && getAngle(clip.sampleFrame(2, i, staleCursor),
+            clip.sampleFrame(2, i, freshCursor)) < EPSILON;
+    }
+    int cursor = 0;
+    glm::quat wrapped = clip.sample(1, NUMBER_OF_FRAMES - 0.5f, cursor);
+    glm::quat expected = safeMix(clip.sampleFrame(1, NUMBER_OF_FRAMES - 1, cursor), clip.sampleFrame(1, 0, cursor),
+        0.5f);
+    testsTaken++;
+    if (cursorsAgree && getAngle(wrapped, expected) < EPSILON) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: cursors and wrapping";
+    }
+
+    // decompressing gives back every frame
+    QVector<FBXAnimationFrame> decompressed = clip.getFrames();
+    testsTaken++;
+    if (decompressed.size() == NUMBER_OF_FRAMES && decompressed.last().rotations.size() == 3 &&
+            getAngle(decompressed.first().rotations.at(0), still) < MAX_SAMPLE_ERROR) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: decompressed frames";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void AnimationClipTests::runAllTests(bool verbose) {
+    compressionTests(verbose);
+}
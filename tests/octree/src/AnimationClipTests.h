@@ -0,0 +1,20 @@
+//
+//  AnimationClipTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimationClipTests_h
+#define hifi_AnimationClipTests_h
+
+namespace AnimationClipTests {
+    void compressionTests(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_AnimationClipTests_h
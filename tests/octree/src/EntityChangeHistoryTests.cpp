@@ -0,0 +1,102 @@
+//
+//  EntityChangeHistoryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <SharedUtil.h>
+
+#include "EntityChangeHistoryTests.h"
+
+// edits in the same microsecond are one version, so each edit here waits for the clock to move on
+static void markChanged(EntityItem* entity, EntityPropertyList property) {
+    quint64 previousVersion = entity->getLastChangedOnServer();
+    while (usecTimestampNow() == previousVersion) {
+    }
+    entity->markAsChangedOnServer(EntityPropertyFlags(property));
+}
+
+void EntityChangeHistoryTests::changedSinceTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "EntityChangeHistoryTests::changedSinceTests()";
+
+    EntityTree tree;
+    EntityItemID entityID(QUuid::createUuid());
+    entityID.isKnownID = false; // lets a local tree add the entity with its known ID
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    EntityItem* entity = tree.addEntity(entityID, properties);
+    entity->markAsChangedOnServer();
+    quint64 addedVersion = entity->getLastChangedOnServer();
+
+    markChanged(entity, PROP_POSITION);
+    quint64 movedVersion = entity->getLastChangedOnServer();
+    markChanged(entity, PROP_SCRIPT);
+
+    // a client holding a version the entity remembers gets only what changed since
+    EntityPropertyFlags changedProperties;
+    testsTaken++;
+    EntityPropertyFlags expectedProperties;
+    expectedProperties += PROP_POSITION;
+    expectedProperties += PROP_SCRIPT;
+    if (entity->getPropertiesChangedSince(addedVersion, changedProperties) && changedProperties == expectedProperties
+            && entity->getPropertiesChangedSince(movedVersion, changedProperties)
+            && changedProperties == EntityPropertyFlags(PROP_SCRIPT)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: properties changed since a remembered version";
+    }
+
+    // one from before the history needs everything
+    testsTaken++;
+    if (!entity->getPropertiesChangedSince(addedVersion - 1, changedProperties)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: version older than the history";
+    }
+
+    // the history forgets the oldest edits as new ones come in
+    for (int i = 0; i < 4; i++) {
+        markChanged(entity, PROP_VELOCITY);
+    }
+    testsTaken++;
+    if (!entity->getPropertiesChangedSince(movedVersion, changedProperties)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: forgotten version still answered";
+    }
+
+    // a change the history didn't see leaves it unable to answer for the entity
+    quint64 lastVersion = entity->getLastChangedOnServer();
+    entity->setLastEdited(lastVersion + 1);
+    testsTaken++;
+    if (!entity->getPropertiesChangedSince(lastVersion, changedProperties)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: untracked change";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void EntityChangeHistoryTests::runAllTests(bool verbose) {
+    changedSinceTests(verbose);
+}
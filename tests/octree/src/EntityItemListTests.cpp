@@ -0,0 +1,146 @@
+//
+//  EntityItemListTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <BoxEntityItem.h>
+#include <EntityItemList.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+
+#include "EntityItemListTests.h"
+
+static const int NUMBER_OF_ENTITIES = 10; // more than the list holds inline
+
+void EntityItemListTests::listTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "EntityItemListTests::listTests()";
+
+    EntityItemProperties properties;
+    QVector<EntityItem*> entities;
+    for (int i = 0; i < NUMBER_OF_ENTITIES; i++) {
+        entities << new BoxEntityItem(EntityItemID(QUuid::createUuid()), properties);
+        entities.last()->setPosition(glm::vec3(randFloat(), randFloat(), randFloat()));
+    }
+
+    EntityItemList list;
+    foreach (EntityItem* entity, entities) {
+        list.append(entity);
+    }
+
+    // growing past the inline storage keeps every entity and its bounds in order
+    testsTaken++;
+    bool inOrder = list.size() == entities.size();
+    for (int i = 0; inOrder && i < list.size(); i++) {
+        inOrder = list[i] == entities[i] && glm::vec3(list.boundsAt(i)) == entities[i]->getPosition()
+            && list.boundsAt(i).w == entities[i]->getRadius();
+    }
+    if (inOrder) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: appended entities or their bounds are out of order";
+    }
+
+    // removing from the middle keeps the order of the rest
+    testsTaken++;
+    list.removeAt(2);
+    bool removedOne = list.removeOne(entities[7]);
+    entities.remove(7);
+    entities.remove(2);
+    bool orderKept = removedOne && list.size() == entities.size() && list.indexOf(entities.first()) == 0;
+    for (int i = 0; orderKept && i < list.size(); i++) {
+        orderKept = list[i] == entities[i] && glm::vec3(list.boundsAt(i)) == entities[i]->getPosition();
+    }
+    if (orderKept) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: removing entities broke the order of the others";
+    }
+
+    // an entity that isn't there can't be removed
+    testsTaken++;
+    BoxEntityItem stranger(EntityItemID(QUuid::createUuid()), properties);
+    if (!list.removeOne(&stranger) && list.indexOf(&stranger) == -1) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: removed an entity that wasn't in the list";
+    }
+
+    qDeleteAll(entities);
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void EntityItemListTests::elementBoundsTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "EntityItemListTests::elementBoundsTests()";
+
+    EntityTree tree;
+    QVector<EntityItem*> entities;
+    for (int i = 0; i < NUMBER_OF_ENTITIES; i++) {
+        EntityItemID entityID(QUuid::createUuid());
+        entityID.isKnownID = false; // lets a local tree add the entity with its known ID
+
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (float)TREE_SCALE);
+        properties.setDimensions(glm::vec3(1.0f));
+        entities << tree.addEntity(entityID, properties);
+    }
+
+    // moving an entity without moving it between elements still has its element's queries find it where it is now
+    const float SEARCH_RADIUS = 0.0001f;
+    int missed = 0;
+    foreach (EntityItem* entity, entities) {
+        glm::vec3 oldPosition = entity->getPosition();
+        glm::vec3 newPosition = glm::clamp(oldPosition + glm::vec3(0.01f), 0.0f, 1.0f);
+        entity->setPosition(newPosition);
+
+        QVector<const EntityItem*> foundAtNew;
+        QVector<const EntityItem*> foundAtOld;
+        entity->getElement()->getEntities(newPosition, SEARCH_RADIUS, foundAtNew);
+        entity->getElement()->getEntities(oldPosition, SEARCH_RADIUS, foundAtOld);
+        if (!foundAtNew.contains(entity) || (oldPosition != newPosition && foundAtOld.contains(entity))) {
+            missed++;
+        }
+    }
+
+    testsTaken++;
+    if (missed == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1:" << missed << "of" << entities.size() << "moved entities found by stale bounds";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void EntityItemListTests::runAllTests(bool verbose) {
+    listTests(verbose);
+    elementBoundsTests(verbose);
+}
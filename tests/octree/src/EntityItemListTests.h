@@ -0,0 +1,21 @@
+//
+//  EntityItemListTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityItemListTests_h
+#define hifi_EntityItemListTests_h
+
+namespace EntityItemListTests {
+    void listTests(bool verbose);
+    void elementBoundsTests(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_EntityItemListTests_h
@@ -0,0 +1,138 @@
+//
+//  EntitySpatialIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+
+#include "EntitySpatialIndexTests.h"
+
+static const int NUMBER_OF_ENTITIES = 500;
+static const float QUERY_RADIUS_IN_METERS = 500.0f;
+
+// the entities within radius of center, found the slow way
+static QSet<const EntityItem*> entitiesNear(const QVector<EntityItem*>& entities, const glm::vec3& center,
+                                            float radius) {
+    QSet<const EntityItem*> nearEntities;
+    foreach (const EntityItem* entity, entities) {
+        if (glm::length(entity->getPosition() - center) < radius + entity->getRadius()) {
+            nearEntities.insert(entity);
+        }
+    }
+    return nearEntities;
+}
+
+static bool foundAll(EntityTree& tree, const QVector<EntityItem*>& entities, const glm::vec3& center, float radius) {
+    QVector<const EntityItem*> foundEntities;
+    tree.findEntities(center, radius, foundEntities);
+    QSet<const EntityItem*> nearEntities = entitiesNear(entities, center, radius);
+    return foundEntities.size() == nearEntities.size()
+        && QSet<const EntityItem*>::fromList(foundEntities.toList()) == nearEntities;
+}
+
+void EntitySpatialIndexTests::queryTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "EntitySpatialIndexTests::queryTests()";
+
+    srand(0);
+
+    EntityTree tree;
+    QVector<EntityItem*> entities;
+    QVector<EntityItemID> entityIDs;
+    for (int i = 0; i < NUMBER_OF_ENTITIES; i++) {
+        EntityItemID entityID(QUuid::createUuid());
+        entityID.isKnownID = false; // lets a local tree add the entity with its known ID
+
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3(randFloatInRange(1.0f, 4000.0f), randFloatInRange(1.0f, 100.0f),
+                                         randFloatInRange(1.0f, 4000.0f)));
+        // every tenth entity is bigger than a cell of the index
+        float size = (i % 10 == 0) ? randFloatInRange(200.0f, 400.0f) : randFloatInRange(0.1f, 10.0f);
+        properties.setDimensions(glm::vec3(size));
+
+        EntityItem* entity = tree.addEntity(entityID, properties);
+        if (entity) {
+            entities.append(entity);
+            entityID.isKnownID = true;
+            entityIDs.append(entityID);
+        }
+    }
+
+    glm::vec3 center = glm::vec3(2000.0f, 50.0f, 2000.0f) / (float)TREE_SCALE;
+    float radius = QUERY_RADIUS_IN_METERS / (float)TREE_SCALE;
+
+    testsTaken++;
+    if (entities.size() == NUMBER_OF_ENTITIES && foundAll(tree, entities, center, radius)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: sphere query matches a search of every entity";
+    }
+
+    // move some entities into the query and some out of it, and grow one past the size of a cell
+    for (int i = 0; i < entities.size(); i += 7) {
+        EntityItemProperties properties;
+        properties.setPosition(glm::vec3(randFloatInRange(1500.0f, 2500.0f), 50.0f, randFloatInRange(1.0f, 4000.0f)));
+        if (i == 14) {
+            properties.setDimensions(glm::vec3(300.0f));
+        }
+        tree.updateEntity(entityIDs[i], properties, true);
+    }
+
+    testsTaken++;
+    if (foundAll(tree, entities, center, radius)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: sphere query after moving entities";
+    }
+
+    // a deleted entity is no longer found
+    tree.deleteEntity(entityIDs[1], true);
+    entities.remove(1);
+
+    testsTaken++;
+    if (foundAll(tree, entities, center, radius)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: sphere query after deleting an entity";
+    }
+
+    // the closest entity is the one at the query point
+    EntityItemProperties properties;
+    properties.setPosition(center * (float)TREE_SCALE);
+    tree.updateEntity(entityIDs[2], properties, true);
+
+    testsTaken++;
+    const EntityItem* closestEntity = tree.findClosestEntity(center, 1.0f / (float)TREE_SCALE);
+    if (closestEntity == tree.findEntityByEntityItemID(entityIDs[2])) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: closest entity" << (void*)closestEntity;
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void EntitySpatialIndexTests::runAllTests(bool verbose) {
+    queryTests(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  EntitySpatialIndexTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndexTests_h
+#define hifi_EntitySpatialIndexTests_h
+
+namespace EntitySpatialIndexTests {
+    void queryTests(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_EntitySpatialIndexTests_h
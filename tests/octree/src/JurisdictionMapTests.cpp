@@ -0,0 +1,79 @@
+//
+//  JurisdictionMapTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <JurisdictionMap.h>
+#include <OctalCode.h>
+#include <SharedUtil.h>
+
+#include "JurisdictionMapTests.h"
+
+void JurisdictionMapTests::pointTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "JurisdictionMapTests::pointTests()";
+
+    // the low octant of the domain, less the low octant of that
+    std::vector<unsigned char*> endNodes;
+    endNodes.push_back(pointToOctalCode(0.0f, 0.0f, 0.0f, 0.25f));
+    JurisdictionMap map(pointToOctalCode(0.0f, 0.0f, 0.0f, 0.5f), endNodes);
+
+    testsTaken++;
+    if (map.isMyJurisdiction(glm::vec3(0.4f, 0.1f, 0.3f)) == JurisdictionMap::WITHIN) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: point under the root not within";
+    }
+
+    testsTaken++;
+    if (map.isMyJurisdiction(glm::vec3(0.1f, 0.1f, 0.1f)) == JurisdictionMap::BELOW
+            && map.isMyJurisdiction(glm::vec3(0.6f, 0.1f, 0.1f)) == JurisdictionMap::BELOW) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: point under an end node or outside the root is within";
+    }
+
+    // the far corner of the domain still gets a code, an edit out there has to go somewhere
+    unsigned char* cornerCode = JurisdictionMap::octalCodeForPoint(glm::vec3(1.0f));
+    testsTaken++;
+    if (cornerCode && numberOfThreeBitSectionsInCode(cornerCode) > 0
+            && map.isMyJurisdiction(cornerCode, CHECK_NODE_ONLY) == JurisdictionMap::BELOW) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: far corner code";
+    }
+    delete[] cornerCode;
+
+    // edits that don't move an entity carry the root code, it's above every jurisdiction so they go to every server
+    unsigned char* rootCode = pointToOctalCode(0.0f, 0.0f, 0.0f, 1.0f);
+    testsTaken++;
+    if (map.isMyJurisdiction(rootCode, CHECK_NODE_ONLY) == JurisdictionMap::ABOVE) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: root code not above";
+    }
+    delete[] rootCode;
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void JurisdictionMapTests::runAllTests(bool verbose) {
+    pointTests(verbose);
+}
@@ -0,0 +1,110 @@
+//
+//  KinematicEntityArraysTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <KinematicEntityArrays.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+
+#include "KinematicEntityArraysTests.h"
+
+static const int NUMBER_OF_STEPS = 120;
+static const quint64 STEP_USECS = USECS_PER_SECOND / 60;
+
+static EntityItem* addMovingEntity(EntityTree& tree, const glm::vec3& velocity) {
+    EntityItemID entityID(QUuid::createUuid());
+    entityID.isKnownID = false; // lets a local tree add the entity with its known ID
+
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(100.0f, 100.0f, 100.0f));
+    properties.setVelocity(velocity);
+    properties.setGravity(glm::vec3(0.0f, -1.0f, 0.0f));
+    properties.setDamping(0.1f);
+    return tree.addEntity(entityID, properties);
+}
+
+void KinematicEntityArraysTests::integrationTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "KinematicEntityArraysTests::integrationTests()";
+
+    EntityTree tree;
+    EntityItem* simulated = addMovingEntity(tree, glm::vec3(1.0f, 5.0f, 0.0f));
+    EntityItem* integrated = addMovingEntity(tree, glm::vec3(1.0f, 5.0f, 0.0f));
+
+    quint64 now = usecTimestampNow();
+    simulated->setLastSimulated(now);
+    integrated->setLastSimulated(now);
+
+    KinematicEntityArrays arrays;
+    arrays.add(integrated);
+
+    // the arrays move an entity the way it moves itself, and don't tell it about every step
+    QVector<EntityItem*> writtenBack;
+    QVector<EntityItem*> stopped;
+    for (int i = 0; i < NUMBER_OF_STEPS; i++) {
+        now += STEP_USECS;
+        simulated->simulate(now);
+        arrays.simulate(now, writtenBack, stopped);
+    }
+
+    testsTaken++;
+    if (writtenBack.size() > 0 && writtenBack.size() < NUMBER_OF_STEPS && stopped.isEmpty()) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: written back" << writtenBack.size() << "of" << NUMBER_OF_STEPS << "steps";
+    }
+
+    arrays.writeBackAndRemove(integrated);
+
+    testsTaken++;
+    const float EPSILON = 0.0001f / (float)TREE_SCALE;
+    if (glm::distance(simulated->getPosition(), integrated->getPosition()) < EPSILON
+            && glm::distance(simulated->getVelocity(), integrated->getVelocity()) < EPSILON
+            && integrated->getLastSimulated() == now && arrays.size() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: integrated motion matches EntityItem::simulate()"
+            << integrated->getPosition().x << simulated->getPosition().x;
+    }
+
+    // an entity slower than the epsilon stops and leaves the arrays
+    EntityItem* slow = addMovingEntity(tree, glm::vec3(0.0005f, 0.0f, 0.0f));
+    slow->setGravity(glm::vec3(0.0f));
+    slow->setLastSimulated(now);
+    arrays.add(slow);
+    writtenBack.clear();
+    arrays.simulate(now + STEP_USECS, writtenBack, stopped);
+
+    testsTaken++;
+    if (stopped.size() == 1 && stopped[0] == slow && !slow->hasVelocity() && arrays.size() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: slow entity stopped";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void KinematicEntityArraysTests::runAllTests(bool verbose) {
+    integrationTests(verbose);
+}
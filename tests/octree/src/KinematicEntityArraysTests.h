@@ -0,0 +1,20 @@
+//
+//  KinematicEntityArraysTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KinematicEntityArraysTests_h
+#define hifi_KinematicEntityArraysTests_h
+
+namespace KinematicEntityArraysTests {
+    void integrationTests(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_KinematicEntityArraysTests_h
@@ -0,0 +1,92 @@
+//
+//  MovingEntitiesOperatorTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <MovingEntitiesOperator.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+
+#include "MovingEntitiesOperatorTests.h"
+
+static const int NUMBER_OF_ENTITIES = 500;
+
+static glm::vec3 randomPositionInMeters() {
+    return glm::vec3(randFloat(), randFloat(), randFloat()) * (float)TREE_SCALE;
+}
+
+void MovingEntitiesOperatorTests::bulkMoveTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "MovingEntitiesOperatorTests::bulkMoveTests()";
+
+    EntityTree tree;
+    QVector<EntityItem*> entities;
+    for (int i = 0; i < NUMBER_OF_ENTITIES; i++) {
+        EntityItemID entityID(QUuid::createUuid());
+        entityID.isKnownID = false; // lets a local tree add the entity with its known ID
+
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(randomPositionInMeters());
+        properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 10.0f)));
+        entities << tree.addEntity(entityID, properties);
+    }
+
+    // move every entity somewhere else, the way a simulation does before it sorts them
+    MovingEntitiesOperator moveOperator(&tree);
+    moveOperator.reserve(entities.size());
+    foreach (EntityItem* entity, entities) {
+        entity->setPosition(randomPositionInMeters() / (float)TREE_SCALE);
+        moveOperator.addEntityToMoveList(entity, entity->getMaximumAACube());
+    }
+    moveOperator.moveEntities();
+
+    testsTaken++;
+    int misplaced = 0;
+    foreach (EntityItem* entity, entities) {
+        EntityTreeElement* element = tree.getContainingElement(entity->getEntityItemID());
+        if (!element || element != entity->getElement() || !element->bestFitBounds(entity->getMaximumAACube())) {
+            misplaced++;
+        }
+    }
+    if (misplaced == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1:" << misplaced << "of" << entities.size()
+            << "entities not in their best fit element";
+    }
+
+    // nothing was deleted or lost along the way
+    testsTaken++;
+    QVector<EntityItem*> foundEntities;
+    tree.findEntities(AACube(glm::vec3(0.0f), 1.0f), foundEntities);
+    if (foundEntities.size() == entities.size()) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: found" << foundEntities.size() << "of" << entities.size() << "entities";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void MovingEntitiesOperatorTests::runAllTests(bool verbose) {
+    bulkMoveTests(verbose);
+}
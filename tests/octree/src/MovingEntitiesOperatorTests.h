@@ -0,0 +1,20 @@
+//
+//  MovingEntitiesOperatorTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MovingEntitiesOperatorTests_h
+#define hifi_MovingEntitiesOperatorTests_h
+
+namespace MovingEntitiesOperatorTests {
+    void bulkMoveTests(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_MovingEntitiesOperatorTests_h
@@ -0,0 +1,128 @@
+//
+//  OcclusionBufferTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <OcclusionBuffer.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include "OcclusionBufferTests.h"
+
+static AACube cubeAround(const glm::vec3& center, float size) {
+    return AACube(center - glm::vec3(size * 0.5f), size);
+}
+
+void OcclusionBufferTests::occlusionTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "OcclusionBufferTests::occlusionTests()";
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(glm::vec3(100.0f, 100.0f, 100.0f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.calculate();
+    glm::vec3 eye = viewFrustum.getPosition();
+    glm::vec3 direction = viewFrustum.getDirection();
+    glm::vec3 right = viewFrustum.getRight();
+
+    OcclusionBuffer occlusionBuffer;
+    AACube behind = cubeAround(eye + 20.0f * direction, 1.0f);
+
+    // nothing is hidden by an empty buffer
+    testsTaken++;
+    if (!occlusionBuffer.isOccluded(viewFrustum, behind)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: empty buffer occludes";
+    }
+
+    occlusionBuffer.addOccluder(viewFrustum, eye + 10.0f * direction, 2.0f);
+
+    // a small cube straight behind the sphere is hidden, one in front of it or off to the side is not
+    testsTaken++;
+    if (occlusionBuffer.isOccluded(viewFrustum, behind)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: cube behind the occluder";
+    }
+
+    testsTaken++;
+    if (!occlusionBuffer.isOccluded(viewFrustum, cubeAround(eye + 5.0f * direction, 0.5f))) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: cube in front of the occluder";
+    }
+
+    testsTaken++;
+    if (!occlusionBuffer.isOccluded(viewFrustum, cubeAround(eye + 20.0f * direction + 8.0f * right, 1.0f))) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: cube beside the occluder";
+    }
+
+    // a cube behind the sphere but wider than it pokes out around the edges
+    testsTaken++;
+    if (!occlusionBuffer.isOccluded(viewFrustum, cubeAround(eye + 20.0f * direction, 10.0f))) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 5: cube wider than the occluder";
+    }
+
+    // erasing forgets the occluder
+    occlusionBuffer.erase();
+    testsTaken++;
+    if (!occlusionBuffer.isOccluded(viewFrustum, behind) && occlusionBuffer.getOccluderCount() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 6: erased buffer occludes";
+    }
+
+    // what one scene of a thousand occluders and ten thousand tests costs
+    const int OCCLUDERS = 1000;
+    const int TESTS = 10000;
+    srand(0);
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < OCCLUDERS; i++) {
+        glm::vec3 offset(randFloatInRange(-50.0f, 50.0f), randFloatInRange(-50.0f, 50.0f), 0.0f);
+        occlusionBuffer.addOccluder(viewFrustum, eye + randFloatInRange(10.0f, 100.0f) * direction + offset,
+                                    randFloatInRange(0.5f, 5.0f));
+    }
+    quint64 occluded = usecTimestampNow();
+    int occludedCount = 0;
+    for (int i = 0; i < TESTS; i++) {
+        glm::vec3 offset(randFloatInRange(-50.0f, 50.0f), randFloatInRange(-50.0f, 50.0f), 0.0f);
+        if (occlusionBuffer.isOccluded(viewFrustum, cubeAround(eye + randFloatInRange(10.0f, 200.0f) * direction
+                                                               + offset, randFloatInRange(0.5f, 5.0f)))) {
+            occludedCount++;
+        }
+    }
+    quint64 tested = usecTimestampNow();
+
+    qDebug() << "   " << OCCLUDERS << "occluders:" << (occluded - start) << "usecs" << TESTS << "tests:"
+             << (tested - occluded) << "usecs," << occludedCount << "occluded";
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void OcclusionBufferTests::runAllTests(bool verbose) {
+    occlusionTests(verbose);
+}
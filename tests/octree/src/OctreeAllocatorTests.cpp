@@ -0,0 +1,163 @@
+//
+//  OctreeAllocatorTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+#include <new>
+
+#include <QDebug>
+#include <QVector>
+
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <SlabAllocator.h>
+#include <SharedUtil.h>
+
+#include "OctreeAllocatorTests.h"
+
+void OctreeAllocatorTests::allocatorTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "OctreeAllocatorTests::allocatorTests()";
+
+    // a size class no element or child array uses, so these come from a fresh slab, in 16 byte steps
+    const size_t BLOCK_SIZE = 1000;
+    const int BLOCK_STRIDE = 1008;
+
+    // blocks handed out from a fresh slab come front to back
+    char* first = static_cast<char*>(SlabAllocator::allocate(BLOCK_SIZE));
+    char* second = static_cast<char*>(SlabAllocator::allocate(BLOCK_SIZE));
+
+    testsTaken++;
+    if (second - first == BLOCK_STRIDE) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: consecutive blocks are adjacent" << (void*)first << (void*)second;
+    }
+
+    // a freed block is the next one handed out of its size class
+    SlabAllocator::free(first, BLOCK_SIZE);
+    char* reused = static_cast<char*>(SlabAllocator::allocate(BLOCK_SIZE - 1));
+
+    testsTaken++;
+    if (reused == first) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: freed block is reused" << (void*)first << (void*)reused;
+    }
+
+    SlabAllocator::free(reused, BLOCK_SIZE - 1);
+    SlabAllocator::free(second, BLOCK_SIZE);
+
+    // sizes past the pooled range still work
+    const size_t LARGE_SIZE = SlabAllocator::MAX_POOLED_SIZE + 1;
+    char* large = static_cast<char*>(SlabAllocator::allocate(LARGE_SIZE));
+    memset(large, 0, LARGE_SIZE);
+    SlabAllocator::free(large, LARGE_SIZE);
+
+    testsTaken++;
+    testsPassed++;
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+static void addChildren(OctreeElement* element, int levels, int& elementsCreated) {
+    if (levels == 0) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElement* child = element->addChildAtIndex(i);
+        elementsCreated++;
+        addChildren(child, levels - 1, elementsCreated);
+    }
+}
+
+static bool countElementsOperation(OctreeElement* element, void* extraData) {
+    (*static_cast<int*>(extraData))++;
+    return true;
+}
+
+void OctreeAllocatorTests::elementBenchmark(bool verbose) {
+    qDebug() << "OctreeAllocatorTests::elementBenchmark()";
+
+    const int LEVELS = 6;
+    const int ROUNDS = 5;
+
+    EntityTree tree;
+    quint64 createUsecs = 0;
+    quint64 traverseUsecs = 0;
+    quint64 deleteUsecs = 0;
+    int elementsCreated = 0;
+    int elementsVisited = 0;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        quint64 start = usecTimestampNow();
+        addChildren(tree.getRoot(), LEVELS, elementsCreated);
+        quint64 created = usecTimestampNow();
+        tree.recurseTreeWithOperation(countElementsOperation, &elementsVisited);
+        quint64 traversed = usecTimestampNow();
+        tree.eraseAllOctreeElements();
+        quint64 deleted = usecTimestampNow();
+
+        createUsecs += created - start;
+        traverseUsecs += traversed - created;
+        deleteUsecs += deleted - traversed;
+    }
+
+    qDebug() << "   elements per round:" << elementsCreated / ROUNDS << "rounds:" << ROUNDS;
+    qDebug() << "   create:" << createUsecs / ROUNDS << "usecs traverse:" << traverseUsecs / ROUNDS
+             << "usecs delete:" << deleteUsecs / ROUNDS << "usecs";
+    qDebug() << "   slab memory usage:" << SlabAllocator::getSlabMemoryUsage() << "bytes";
+
+    // the same number of element sized blocks, allocated and freed from the slabs and then from the heap
+    const size_t ELEMENT_SIZE = sizeof(EntityTreeElement);
+    int numBlocks = elementsCreated / ROUNDS;
+    QVector<void*> blocks(numBlocks);
+
+    quint64 start = usecTimestampNow();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < numBlocks; i++) {
+            blocks[i] = SlabAllocator::allocate(ELEMENT_SIZE);
+        }
+        for (int i = 0; i < numBlocks; i++) {
+            SlabAllocator::free(blocks[i], ELEMENT_SIZE);
+        }
+    }
+    quint64 pooledUsecs = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < numBlocks; i++) {
+            blocks[i] = ::operator new(ELEMENT_SIZE);
+        }
+        for (int i = 0; i < numBlocks; i++) {
+            ::operator delete(blocks[i]);
+        }
+    }
+    quint64 heapUsecs = usecTimestampNow() - start;
+
+    qDebug() << "   allocate and free" << numBlocks << "blocks of" << ELEMENT_SIZE << "bytes - pooled:"
+             << pooledUsecs / ROUNDS << "usecs heap:" << heapUsecs / ROUNDS << "usecs";
+
+    if (verbose) {
+        qDebug() << "   elements visited per round:" << elementsVisited / ROUNDS;
+    }
+}
+
+void OctreeAllocatorTests::runAllTests(bool verbose) {
+    allocatorTests(verbose);
+    elementBenchmark(verbose);
+}
@@ -0,0 +1,23 @@
+//
+//  OctreeAllocatorTests.h
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeAllocatorTests_h
+#define hifi_OctreeAllocatorTests_h
+
+namespace OctreeAllocatorTests {
+    void allocatorTests(bool verbose);
+
+    /// times building, traversing and deleting a full tree, and pooled against heap allocation of element sized blocks
+    void elementBenchmark(bool verbose);
+
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_OctreeAllocatorTests_h
@@ -0,0 +1,95 @@
+//
+//  OctreeElementBagTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <EntityTree.h>
+#include <OctreeElementBag.h>
+#include <ViewFrustum.h>
+
+#include "OctreeElementBagTests.h"
+
+void OctreeElementBagTests::orderingTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "OctreeElementBagTests::orderingTests()";
+
+    EntityTree tree;
+    OctreeElement* children[NUMBER_OF_CHILDREN];
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        children[i] = tree.getRoot()->addChildAtIndex(i);
+    }
+
+    // without a view frustum elements come out in the order they went in, and only once
+    OctreeElementBag bag;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        bag.insert(children[i]);
+        bag.insert(children[i]);
+    }
+    bag.remove(children[1]);
+
+    testsTaken++;
+    bool inOrder = bag.count() == NUMBER_OF_CHILDREN - 1;
+    for (int i = 0; i < NUMBER_OF_CHILDREN && inOrder; i++) {
+        if (i != 1) {
+            inOrder = bag.extract() == children[i];
+        }
+    }
+    if (inOrder && bag.isEmpty() && bag.extract() == NULL) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: first in first out without a view frustum";
+    }
+
+    // with the viewer standing in the middle of the last child, that child comes out first
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(children[NUMBER_OF_CHILDREN - 1]->getAACube().calcCenter() * (float)TREE_SCALE);
+    viewFrustum.calculate();
+    bag.setViewFrustum(&viewFrustum);
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        bag.insert(children[i]);
+    }
+
+    testsTaken++;
+    OctreeElement* first = bag.extract();
+    if (first == children[NUMBER_OF_CHILDREN - 1]) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: nearest element first" << (void*)first;
+    }
+
+    // moving the viewer to the first child and reprioritizing brings that one to the front
+    viewFrustum.setPosition(children[0]->getAACube().calcCenter() * (float)TREE_SCALE);
+    viewFrustum.calculate();
+    bag.reprioritize();
+
+    testsTaken++;
+    first = bag.extract();
+    if (first == children[0] && bag.count() == NUMBER_OF_CHILDREN - 2) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: reprioritized after the view moved" << (void*)first;
+    }
+    bag.deleteAll();
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void OctreeElementBagTests::runAllTests(bool verbose) {
+    orderingTests(verbose);
+}
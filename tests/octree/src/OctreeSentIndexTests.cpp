@@ -0,0 +1,77 @@
+//
+//  OctreeSentIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <OctreeSentIndex.h>
+
+#include "OctreeSentIndexTests.h"
+
+void OctreeSentIndexTests::pendingTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "OctreeSentIndexTests::pendingTests()";
+
+    QUuid first = QUuid::createUuid();
+    QUuid second = QUuid::createUuid();
+    OctreeSentIndex index;
+
+    // nothing counts as sent until the packet data holding it is written out
+    index.addPending(first, 1);
+    testsTaken++;
+    if (!index.hasSent(first, 1) && index.size() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: pending item reported as sent";
+    }
+
+    // discarding back to a mark keeps what was encoded before it
+    int mark = index.getPendingCount();
+    index.addPending(second, 1);
+    index.discardPending(mark);
+    index.commitPending();
+    testsTaken++;
+    if (index.hasSent(first, 1) && !index.hasSent(second, 1) && index.getPendingCount() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2: discard to a mark then commit";
+    }
+
+    // a newer version of the item has to be sent again
+    testsTaken++;
+    if (!index.hasSent(first, 2)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3: newer version reported as sent";
+    }
+
+    index.remove(first);
+    testsTaken++;
+    if (!index.hasSent(first, 1) && index.size() == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 4: removed item reported as sent";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void OctreeSentIndexTests::runAllTests(bool verbose) {
+    pendingTests(verbose);
+}
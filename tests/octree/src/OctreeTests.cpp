@@ -877,6 +877,59 @@ void OctreeTests::propertyFlagsTests(bool verbose) {
         }
     }
 
+    {
+        if (verbose) {
+            qDebug() << "Test 14: ExamplePropertyFlags: encode / decode in place tests";
+        }
+        ExamplePropertyFlags props;
+
+        props << EXAMPLE_PROP_VISIBLE;
+        props << EXAMPLE_PROP_ANIMATION_PLAYING;
+        props << EXAMPLE_PROP_PAUSE_SIMULATION;
+
+        // leave garbage past the encoding, as if it was a bitstream with more content
+        unsigned char buffer[ExamplePropertyFlags::MAX_ENCODED_BYTES + 4];
+        memset(buffer, 0xba, sizeof(buffer));
+        int encodedLength = props.encode(buffer);
+        QByteArray encoded = props.encode();
+
+        testsTaken++;
+        bool resultA = (encodedLength == encoded.size() && memcmp(buffer, encoded.constData(), encodedLength) == 0);
+        bool expectedA = true;
+        if (resultA == expectedA) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test 14a: encode(buffer) matches encode()";
+        }
+
+        ExamplePropertyFlags propsDecoded;
+        int decodedLength = propsDecoded.decode(buffer, sizeof(buffer));
+
+        testsTaken++;
+        bool resultB = (decodedLength == encodedLength && propsDecoded == props);
+        bool expectedB = true;
+        if (resultB == expectedB) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test 14b: decode(buffer, length) == props";
+        }
+
+        ExamplePropertyFlags propsCutShort;
+        propsCutShort.decode(buffer, encodedLength - 1);
+
+        testsTaken++;
+        bool resultC = !propsCutShort;
+        bool expectedC = true;
+        if (resultC == expectedC) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test 14c: decode(buffer, length) of a cut short encoding is empty";
+        }
+    }
+
     qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
     if (verbose) {
         qDebug() << "******************************************************************************************";
@@ -0,0 +1,226 @@
+//
+//  ViewFrustumTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include "ViewFrustumTests.h"
+
+static int countMismatches(const ViewFrustum& viewFrustum, const QVector<AABox>& boxes) {
+    QVector<bool> outside;
+    viewFrustum.cullBoxes(boxes, outside);
+    int mismatches = outside.size() == boxes.size() ? 0 : boxes.size();
+    for (int i = 0; i < boxes.size() && i < outside.size(); i++) {
+        if (outside.at(i) != (viewFrustum.boxInFrustum(boxes.at(i)) == ViewFrustum::OUTSIDE)) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+void ViewFrustumTests::cullBoxesTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "ViewFrustumTests::cullBoxesTests()";
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(glm::vec3(100.0f, 100.0f, 100.0f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.setFarClip(200.0f);
+    viewFrustum.calculate();
+    glm::vec3 eye = viewFrustum.getPosition();
+    glm::vec3 direction = viewFrustum.getDirection();
+
+    // a box dead ahead is in, one behind is out
+    QVector<AABox> boxes;
+    boxes << AABox(eye + 20.0f * direction - glm::vec3(0.5f), 1.0f);
+    boxes << AABox(eye - 20.0f * direction - glm::vec3(0.5f), 1.0f);
+    QVector<bool> outside;
+    viewFrustum.cullBoxes(boxes, outside);
+    testsTaken++;
+    if (outside.size() == 2 && !outside.at(0) && outside.at(1)) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1: box ahead and box behind";
+    }
+
+    // boxes scattered all around the eye, in a count that leaves a partial group of four, agree with boxInFrustum
+    const int BOXES = 1001;
+    srand(0);
+    boxes.clear();
+    for (int i = 0; i < BOXES; i++) {
+        glm::vec3 corner(randFloatInRange(-150.0f, 350.0f), randFloatInRange(-150.0f, 350.0f),
+                         randFloatInRange(-150.0f, 350.0f));
+        boxes << AABox(corner, glm::vec3(randFloatInRange(0.1f, 20.0f), randFloatInRange(0.1f, 20.0f),
+                                         randFloatInRange(0.1f, 20.0f)));
+    }
+    testsTaken++;
+    int mismatches = countMismatches(viewFrustum, boxes);
+    if (mismatches == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2:" << mismatches << "boxes disagree with boxInFrustum";
+    }
+
+    // with a keyhole, the boxes just behind the eye are kept too
+    viewFrustum.setKeyholeRadius(30.0f);
+    viewFrustum.calculate();
+    boxes << AABox(eye - 5.0f * direction - glm::vec3(0.5f), 1.0f);
+    testsTaken++;
+    mismatches = countMismatches(viewFrustum, boxes);
+    viewFrustum.cullBoxes(boxes, outside);
+    if (mismatches == 0 && !outside.last()) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3:" << mismatches << "boxes disagree with boxInFrustum in a keyhole";
+    }
+
+    // what culling the lot costs each way
+    const int PASSES = 100;
+    quint64 start = usecTimestampNow();
+    int insideCount = 0;
+    for (int pass = 0; pass < PASSES; pass++) {
+        foreach (const AABox& box, boxes) {
+            if (viewFrustum.boxInFrustum(box) != ViewFrustum::OUTSIDE) {
+                insideCount++;
+            }
+        }
+    }
+    quint64 tested = usecTimestampNow();
+    for (int pass = 0; pass < PASSES; pass++) {
+        viewFrustum.cullBoxes(boxes, outside);
+    }
+    quint64 culled = usecTimestampNow();
+
+    qDebug() << "   " << PASSES << "passes of" << boxes.size() << "boxes: boxInFrustum" << (tested - start)
+             << "usecs, cullBoxes" << (culled - tested) << "usecs," << (insideCount / PASSES) << "inside";
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void ViewFrustumTests::classifyTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    qDebug() << "ViewFrustumTests::classifyTests()";
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(glm::vec3(100.0f, 100.0f, 100.0f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.setFarClip(200.0f);
+    viewFrustum.setKeyholeRadius(10.0f);
+    viewFrustum.calculate();
+
+    // cubes like an octree's elements, so that each of the first level's splits into eight of the second
+    const float PARENT_SCALE = 32.0f;
+    const float CHILD_SCALE = PARENT_SCALE / 2.0f;
+    QVector<AABox> parents;
+    for (float x = -60.0f; x < 260.0f; x += PARENT_SCALE) {
+        for (float y = -60.0f; y < 260.0f; y += PARENT_SCALE) {
+            for (float z = -60.0f; z < 260.0f; z += PARENT_SCALE) {
+                parents << AABox(glm::vec3(x, y, z), PARENT_SCALE);
+            }
+        }
+    }
+    QVector<ViewFrustum::location> parentLocations;
+    QVector<int> parentInsidePlanes;
+    viewFrustum.classifyBoxes(parents, parentLocations, parentInsidePlanes);
+
+    // the parents agree with boxInFrustum
+    testsTaken++;
+    int mismatches = 0;
+    for (int i = 0; i < parents.size(); i++) {
+        if (parentLocations.at(i) != viewFrustum.boxInFrustum(parents.at(i))) {
+            mismatches++;
+        }
+    }
+    if (mismatches == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 1:" << mismatches << "boxes disagree with boxInFrustum";
+    }
+
+    // the children agree with boxInFrustum with the planes their parents were fully inside skipped
+    QVector<AABox> children;
+    QVector<int> childInsidePlanes;
+    for (int i = 0; i < parents.size(); i++) {
+        for (int child = 0; child < 8; child++) {
+            glm::vec3 offset((child & 1) ? CHILD_SCALE : 0.0f, (child & 2) ? CHILD_SCALE : 0.0f,
+                             (child & 4) ? CHILD_SCALE : 0.0f);
+            children << AABox(parents.at(i).getCorner() + offset, CHILD_SCALE);
+            childInsidePlanes << parentInsidePlanes.at(i);
+        }
+    }
+    QVector<ViewFrustum::location> childLocations;
+    viewFrustum.classifyBoxes(children, childLocations, childInsidePlanes);
+    testsTaken++;
+    mismatches = 0;
+    for (int i = 0; i < children.size(); i++) {
+        if (childLocations.at(i) != viewFrustum.boxInFrustum(children.at(i)) ||
+                (childInsidePlanes.at(i) & parentInsidePlanes.at(i / 8)) != parentInsidePlanes.at(i / 8)) {
+            mismatches++;
+        }
+    }
+    if (mismatches == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 2:" << mismatches << "children disagree with boxInFrustum";
+    }
+
+    // spheres agree with sphereInFrustum
+    const int SPHERES = 1001;
+    srand(0);
+    QVector<glm::vec3> centers;
+    QVector<float> radii;
+    for (int i = 0; i < SPHERES; i++) {
+        centers << glm::vec3(randFloatInRange(-150.0f, 350.0f), randFloatInRange(-150.0f, 350.0f),
+                             randFloatInRange(-150.0f, 350.0f));
+        radii << randFloatInRange(0.1f, 20.0f);
+    }
+    QVector<ViewFrustum::location> sphereLocations;
+    QVector<int> sphereInsidePlanes;
+    viewFrustum.classifySpheres(centers, radii, sphereLocations, sphereInsidePlanes);
+    testsTaken++;
+    mismatches = 0;
+    for (int i = 0; i < SPHERES; i++) {
+        if (sphereLocations.at(i) != viewFrustum.sphereInFrustum(centers.at(i), radii.at(i))) {
+            mismatches++;
+        }
+    }
+    if (mismatches == 0) {
+        testsPassed++;
+    } else {
+        testsFailed++;
+        qDebug() << "FAILED - Test 3:" << mismatches << "spheres disagree with sphereInFrustum";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (testsFailed > 0 || verbose) {
+        qDebug() << "   tests failed:" << testsFailed;
+    }
+}
+
+void ViewFrustumTests::runAllTests(bool verbose) {
+    cullBoxesTests(verbose);
+    classifyTests(verbose);
+}
@@ -9,9 +9,21 @@
 //
 
 #include "AABoxCubeTests.h"
+#include "AnimationClipTests.h"
+#include "EntityChangeHistoryTests.h"
+#include "EntityItemListTests.h"
+#include "EntitySpatialIndexTests.h"
+#include "JurisdictionMapTests.h"
+#include "KinematicEntityArraysTests.h"
 #include "ModelTests.h" // needs to be EntityTests.h soon
+#include "MovingEntitiesOperatorTests.h"
+#include "OcclusionBufferTests.h"
+#include "OctreeAllocatorTests.h"
+#include "OctreeElementBagTests.h"
+#include "OctreeSentIndexTests.h"
 #include "OctreeTests.h"
 #include "SharedUtil.h"
+#include "ViewFrustumTests.h"
 
 int main(int argc, const char* argv[]) {
     const char* VERBOSE = "--verbose";
@@ -20,5 +32,17 @@ int main(int argc, const char* argv[]) {
     //OctreeTests::runAllTests(verbose);
     //AABoxCubeTests::runAllTests(verbose);
     EntityTests::runAllTests(verbose);
+    OctreeAllocatorTests::runAllTests(verbose);
+    OctreeElementBagTests::runAllTests(verbose);
+    OcclusionBufferTests::runAllTests(verbose);
+    OctreeSentIndexTests::runAllTests(verbose);
+    EntitySpatialIndexTests::runAllTests(verbose);
+    EntityItemListTests::runAllTests(verbose);
+    KinematicEntityArraysTests::runAllTests(verbose);
+    MovingEntitiesOperatorTests::runAllTests(verbose);
+    EntityChangeHistoryTests::runAllTests(verbose);
+    JurisdictionMapTests::runAllTests(verbose);
+    AnimationClipTests::runAllTests(verbose);
+    ViewFrustumTests::runAllTests(verbose);
     return 0;
 }
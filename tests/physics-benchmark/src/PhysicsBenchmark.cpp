@@ -0,0 +1,329 @@
+//
+//  PhysicsBenchmark.cpp
+//  tests/physics-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QtCore/QElapsedTimer>
+
+#include <PhysicsHelpers.h>
+#include <ShapeInfo.h>
+#include <SharedUtil.h>
+#include <ThreadSafeDynamicsWorld.h>
+
+#include "PhysicsBenchmark.h"
+
+static const float GRAVITY = -9.8f;
+static const quint64 NSECS_PER_USEC = 1000;
+
+// every Bullet allocation carries its size in front of it so the frees can be counted too
+static const size_t ALLOCATION_HEADER_SIZE = 16;
+static std::atomic<long long> bulletBytes(0);
+static std::atomic<long long> peakBulletBytes(0);
+
+static void* countingAlloc(size_t size) {
+    char* block = static_cast<char*>(malloc(size + ALLOCATION_HEADER_SIZE));
+    if (!block) {
+        return NULL;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    long long bytes = bulletBytes += (long long)size;
+    long long peak = peakBulletBytes;
+    while (bytes > peak && !peakBulletBytes.compare_exchange_weak(peak, bytes)) {
+    }
+    return block + ALLOCATION_HEADER_SIZE;
+}
+
+static void countingFree(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - ALLOCATION_HEADER_SIZE;
+    bulletBytes -= (long long)*reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void PhysicsBenchmark::trackBulletMemory() {
+    btAlignedAllocSetCustom(countingAlloc, countingFree);
+}
+
+PhysicsBenchmark::Settings::Settings() :
+    scene("box-stack"),
+    numBodies(0),
+    numSubsteps(600),
+    numWarmupSubsteps(60),
+    numSolverThreads(1),
+    seed(1)
+{
+}
+
+PhysicsBenchmark::PhysicsBenchmark(const Settings& settings) :
+    _settings(settings)
+{
+    // the same world the PhysicsEngine builds in init(), with gravity for everything instead of per object
+    _collisionConfig = new btDefaultCollisionConfiguration();
+    _collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+    _broadphaseFilter = new btDbvtBroadphase();
+    _constraintSolver = new btSequentialImpulseConstraintSolver;
+    _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver,
+                                                 _collisionConfig);
+    _dynamicsWorld->setNumSolverThreads(_settings.numSolverThreads);
+    _dynamicsWorld->setGravity(btVector3(0.0f, GRAVITY, 0.0f));
+    srand(_settings.seed);
+}
+
+PhysicsBenchmark::~PhysicsBenchmark() {
+    foreach (btTypedConstraint* constraint, _constraints) {
+        _dynamicsWorld->removeConstraint(constraint);
+        delete constraint;
+    }
+    foreach (btRigidBody* body, _bodies) {
+        _dynamicsWorld->removeRigidBody(body);
+        _shapeManager.releaseShape(body->getCollisionShape());
+        delete body->getMotionState();
+        delete body;
+    }
+    _shapeManager.collectGarbage();
+    delete _dynamicsWorld;
+    delete _constraintSolver;
+    delete _broadphaseFilter;
+    delete _collisionDispatcher;
+    delete _collisionConfig;
+}
+
+float PhysicsBenchmark::random(float minimum, float maximum) {
+    return minimum + (maximum - minimum) * ((float)rand() / (float)RAND_MAX);
+}
+
+btRigidBody* PhysicsBenchmark::addBody(const ShapeInfo& info, float mass, const btVector3& position,
+                                       const btQuaternion& rotation) {
+    btCollisionShape* shape = _shapeManager.getShape(info);
+    btVector3 inertia(0.0f, 0.0f, 0.0f);
+    if (mass > 0.0f) {
+        shape->calculateLocalInertia(mass, inertia);
+    }
+    btDefaultMotionState* motionState = new btDefaultMotionState(btTransform(rotation, position));
+    btRigidBody* body = new btRigidBody(mass, motionState, shape, inertia);
+    _dynamicsWorld->addRigidBody(body);
+    _bodies.push_back(body);
+    return body;
+}
+
+bool PhysicsBenchmark::buildScene() {
+    // everything lands on the same floor
+    ShapeInfo floor;
+    floor.setBox(glm::vec3(200.0f, 1.0f, 200.0f));
+    addBody(floor, 0.0f, btVector3(0.0f, -1.0f, 0.0f));
+
+    if (_settings.scene == "box-stack") {
+        buildBoxStack();
+    } else if (_settings.scene == "rubble") {
+        buildRubble();
+    } else if (_settings.scene == "ragdolls") {
+        buildRagdolls();
+    } else if (_settings.scene == "kinematic") {
+        buildKinematic();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void PhysicsBenchmark::buildBoxStack() {
+    // columns of ten boxes side by side, the stacks that settle are the ones that sleep
+    const int BOXES_PER_COLUMN = 10;
+    const float HALF_SIZE = 0.25f;
+    int numBoxes = _settings.numBodies > 0 ? _settings.numBodies : 200;
+    int numColumns = (numBoxes + BOXES_PER_COLUMN - 1) / BOXES_PER_COLUMN;
+    int columnsPerRow = (int)ceilf(sqrtf((float)numColumns));
+
+    ShapeInfo box;
+    box.setBox(glm::vec3(HALF_SIZE));
+    for (int i = 0; i < numBoxes; i++) {
+        int column = i / BOXES_PER_COLUMN;
+        float x = (float)(column % columnsPerRow) * 3.0f * HALF_SIZE;
+        float z = (float)(column / columnsPerRow) * 3.0f * HALF_SIZE;
+        float y = HALF_SIZE + (float)(i % BOXES_PER_COLUMN) * (2.0f * HALF_SIZE + 0.001f);
+        addBody(box, 1.0f, btVector3(x, y, z));
+    }
+}
+
+void PhysicsBenchmark::buildRubble() {
+    // a cube of mixed small pieces that collapses into a pile
+    const float SPACING = 0.5f;
+    int numPieces = _settings.numBodies > 0 ? _settings.numBodies : 10000;
+    int piecesPerSide = (int)ceilf(cbrtf((float)numPieces));
+
+    ShapeInfo pieces[3];
+    pieces[0].setBox(glm::vec3(0.15f, 0.1f, 0.2f));
+    pieces[1].setSphere(0.15f);
+    pieces[2].setCapsule(0.1f, 0.1f);
+    for (int i = 0; i < numPieces; i++) {
+        float x = (float)(i % piecesPerSide) * SPACING + random(-0.05f, 0.05f);
+        float y = 1.0f + (float)(i / (piecesPerSide * piecesPerSide)) * SPACING;
+        float z = (float)((i / piecesPerSide) % piecesPerSide) * SPACING + random(-0.05f, 0.05f);
+        btQuaternion rotation(btVector3(random(-1.0f, 1.0f), 1.0f, random(-1.0f, 1.0f)).normalized(),
+                              random(0.0f, PI));
+        addBody(pieces[i % 3], random(0.5f, 2.0f), btVector3(x, y, z), rotation);
+    }
+}
+
+void PhysicsBenchmark::buildRagdolls() {
+    // eleven capsules to a ragdoll, pinned together at the joints and dropped side by side
+    struct Part {
+        int parent;
+        float x, y;             // center, the capsules are all upright
+        float radius, halfHeight;
+        float jointX, jointY;   // where it's pinned to its parent
+    };
+    static const Part PARTS[] = {
+        { -1, 0.0f, 1.0f, 0.12f, 0.1f, 0.0f, 0.0f },        // pelvis
+        { 0, 0.0f, 1.35f, 0.14f, 0.15f, 0.0f, 1.15f },      // torso
+        { 1, 0.0f, 1.7f, 0.1f, 0.05f, 0.0f, 1.55f },        // head
+        { 1, -0.25f, 1.35f, 0.05f, 0.12f, -0.2f, 1.5f },    // upper arms
+        { 1, 0.25f, 1.35f, 0.05f, 0.12f, 0.2f, 1.5f },
+        { 3, -0.25f, 1.05f, 0.045f, 0.12f, -0.25f, 1.2f },  // forearms
+        { 4, 0.25f, 1.05f, 0.045f, 0.12f, 0.25f, 1.2f },
+        { 0, -0.1f, 0.7f, 0.07f, 0.15f, -0.1f, 0.9f },      // thighs
+        { 0, 0.1f, 0.7f, 0.07f, 0.15f, 0.1f, 0.9f },
+        { 7, -0.1f, 0.3f, 0.06f, 0.15f, -0.1f, 0.5f },      // shins
+        { 8, 0.1f, 0.3f, 0.06f, 0.15f, 0.1f, 0.5f }
+    };
+    const int NUM_PARTS = sizeof(PARTS) / sizeof(Part);
+    const float SPACING = 1.0f;
+
+    int numRagdolls = _settings.numBodies > 0 ? _settings.numBodies : 50;
+    int ragdollsPerRow = (int)ceilf(sqrtf((float)numRagdolls));
+    for (int i = 0; i < numRagdolls; i++) {
+        btVector3 origin((float)(i % ragdollsPerRow) * SPACING, random(0.5f, 2.0f),
+                         (float)(i / ragdollsPerRow) * SPACING);
+        btRigidBody* parts[NUM_PARTS];
+        for (int j = 0; j < NUM_PARTS; j++) {
+            const Part& part = PARTS[j];
+            ShapeInfo capsule;
+            capsule.setCapsule(part.radius, part.halfHeight);
+            btVector3 center(part.x, part.y, 0.0f);
+            parts[j] = addBody(capsule, 2.0f * part.halfHeight + part.radius, origin + center);
+            if (part.parent != -1) {
+                const Part& parent = PARTS[part.parent];
+                btVector3 joint(part.jointX, part.jointY, 0.0f);
+                btVector3 parentCenter(parent.x, parent.y, 0.0f);
+                btPoint2PointConstraint* constraint = new btPoint2PointConstraint(*parts[part.parent], *parts[j],
+                                                                                  joint - parentCenter,
+                                                                                  joint - center);
+                _dynamicsWorld->addConstraint(constraint, true);
+                _constraints.push_back(constraint);
+            }
+        }
+    }
+}
+
+void PhysicsBenchmark::buildKinematic() {
+    // balls on the floor and kinematic paddles sweeping through them, like entities scripts or avatars move
+    const float SPACING = 0.6f;
+    const int NUM_PADDLES = 20;
+    int numBalls = _settings.numBodies > 0 ? _settings.numBodies : 1000;
+    int ballsPerRow = (int)ceilf(sqrtf((float)numBalls));
+    float halfWidth = 0.5f * (float)ballsPerRow * SPACING;
+
+    ShapeInfo ball;
+    ball.setSphere(0.25f);
+    for (int i = 0; i < numBalls; i++) {
+        float x = (float)(i % ballsPerRow) * SPACING - halfWidth;
+        float z = (float)(i / ballsPerRow) * SPACING - halfWidth;
+        addBody(ball, 1.0f, btVector3(x, 0.25f, z));
+    }
+
+    ShapeInfo paddle;
+    paddle.setBox(glm::vec3(1.0f, 0.5f, 0.2f));
+    for (int i = 0; i < NUM_PADDLES; i++) {
+        btRigidBody* body = addBody(paddle, 0.0f, btVector3(0.0f, 0.5f, 0.0f));
+        body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+        body->setActivationState(DISABLE_DEACTIVATION);
+        _kinematicBodies.push_back(body);
+    }
+    moveKinematicBodies(0.0f);
+}
+
+void PhysicsBenchmark::moveKinematicBodies(float time) {
+    int numPaddles = _kinematicBodies.size();
+    for (int i = 0; i < numPaddles; i++) {
+        float radius = 2.0f + 0.5f * (float)i;
+        float angle = time * (i % 2 == 0 ? 1.0f : -1.0f) + (float)i;
+        btVector3 position(radius * cosf(angle), 0.5f, radius * sinf(angle));
+        btQuaternion rotation(btVector3(0.0f, 1.0f, 0.0f), -angle);
+        // kinematic bodies take their transform from their motion state as the world steps
+        _kinematicBodies[i]->getMotionState()->setWorldTransform(btTransform(rotation, position));
+    }
+}
+
+void PhysicsBenchmark::run() {
+    QVector<quint64> substepUsecs;
+    substepUsecs.reserve(_settings.numSubsteps);
+    quint64 totalSolveUsecs = 0;
+    quint64 totalPairs = 0;
+    quint64 totalManifolds = 0;
+    QElapsedTimer timer;
+
+    for (int substep = 0; substep < _settings.numWarmupSubsteps + _settings.numSubsteps; substep++) {
+        moveKinematicBodies((float)substep * PHYSICS_ENGINE_FIXED_SUBSTEP);
+
+        timer.start();
+        _dynamicsWorld->stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP, 1, PHYSICS_ENGINE_FIXED_SUBSTEP);
+        quint64 nsecs = timer.nsecsElapsed();
+
+        if (substep >= _settings.numWarmupSubsteps) {
+            substepUsecs.append(nsecs / NSECS_PER_USEC);
+            totalSolveUsecs += _dynamicsWorld->getLastSolveUsecs();
+            totalPairs += _broadphaseFilter->getOverlappingPairCache()->getNumOverlappingPairs();
+            int numManifolds = _collisionDispatcher->getNumManifolds();
+            for (int i = 0; i < numManifolds; i++) {
+                if (_collisionDispatcher->getManifoldByIndexInternal(i)->getNumContacts() > 0) {
+                    totalManifolds++;
+                }
+            }
+        }
+    }
+
+    if (substepUsecs.isEmpty()) {
+        return;
+    }
+
+    int numAwake = 0;
+    foreach (btRigidBody* body, _bodies) {
+        if (body->isActive() && !body->isStaticOrKinematicObject()) {
+            numAwake++;
+        }
+    }
+
+    int numSubsteps = substepUsecs.size();
+    quint64 totalUsecs = 0;
+    foreach (quint64 usecs, substepUsecs) {
+        totalUsecs += usecs;
+    }
+    std::sort(substepUsecs.begin(), substepUsecs.end());
+    quint64 p50 = substepUsecs[numSubsteps / 2];
+    quint64 p99 = substepUsecs[qMin(numSubsteps - 1, (int)(numSubsteps * 0.99f))];
+    quint64 max = substepUsecs.last();
+
+    printf("scene: %s bodies: %d (%d awake at the end) constraints: %d solver threads: %d\n",
+           _settings.scene.toLocal8Bit().constData(), _bodies.size(), numAwake, _constraints.size(),
+           _settings.numSolverThreads);
+    printf("substeps: %d mean: %.3f ms p50: %.3f ms p99: %.3f ms max: %.3f ms solve: %.3f ms (budget %.3f ms)\n",
+           numSubsteps, (float)totalUsecs / numSubsteps / USECS_PER_MSEC, (float)p50 / USECS_PER_MSEC,
+           (float)p99 / USECS_PER_MSEC, (float)max / USECS_PER_MSEC,
+           (float)totalSolveUsecs / numSubsteps / USECS_PER_MSEC, PHYSICS_ENGINE_FIXED_SUBSTEP * MSECS_PER_SECOND);
+    printf("broadphase pairs: %.0f touching manifolds: %.0f bullet memory: %lld KB (peak %lld KB)\n",
+           (float)totalPairs / numSubsteps, (float)totalManifolds / numSubsteps,
+           (long long)bulletBytes / 1024, (long long)peakBulletBytes / 1024);
+}
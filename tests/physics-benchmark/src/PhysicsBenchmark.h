@@ -0,0 +1,78 @@
+//
+//  PhysicsBenchmark.h
+//  tests/physics-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsBenchmark_h
+#define hifi_PhysicsBenchmark_h
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ShapeManager.h>
+
+class ThreadSafeDynamicsWorld;
+
+/// Builds one of a fixed set of scenes in a ThreadSafeDynamicsWorld set up the way the PhysicsEngine sets up its own,
+/// steps it headless in PHYSICS_ENGINE_FIXED_SUBSTEP substeps and prints what each substep cost
+class PhysicsBenchmark {
+public:
+    struct Settings {
+        Settings();
+
+        QString scene;          // box-stack, rubble, ragdolls or kinematic
+        int numBodies;          // 0 for the scene's own default, boxes, pieces of rubble, ragdolls or dynamic bodies
+        int numSubsteps;
+        int numWarmupSubsteps;  // stepped but not timed, lets the scene settle into its steady state
+        int numSolverThreads;
+        unsigned int seed;
+    };
+
+    /// counts the memory Bullet allocates from here on, must be called before any Bullet object is created
+    static void trackBulletMemory();
+
+    PhysicsBenchmark(const Settings& settings);
+    ~PhysicsBenchmark();
+
+    /// \return false if the scene is unknown
+    bool buildScene();
+
+    /// steps the scene settings.numSubsteps times and prints the per-substep cost
+    void run();
+
+private:
+    btRigidBody* addBody(const ShapeInfo& info, float mass, const btVector3& position,
+                         const btQuaternion& rotation = btQuaternion::getIdentity());
+
+    void buildBoxStack();
+    void buildRubble();
+    void buildRagdolls();
+    void buildKinematic();
+
+    /// moves the kinematic bodies along their circles to where they should be at time
+    void moveKinematicBodies(float time);
+
+    float random(float minimum, float maximum);
+
+    Settings _settings;
+
+    btDefaultCollisionConfiguration* _collisionConfig;
+    btCollisionDispatcher* _collisionDispatcher;
+    btBroadphaseInterface* _broadphaseFilter;
+    btSequentialImpulseConstraintSolver* _constraintSolver;
+    ThreadSafeDynamicsWorld* _dynamicsWorld;
+    ShapeManager _shapeManager;
+
+    QVector<btRigidBody*> _bodies;
+    QVector<btRigidBody*> _kinematicBodies;
+    QVector<btTypedConstraint*> _constraints;
+};
+
+#endif // hifi_PhysicsBenchmark_h
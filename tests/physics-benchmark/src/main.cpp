@@ -0,0 +1,65 @@
+//
+//  main.cpp
+//  tests/physics-benchmark/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+
+#include "PhysicsBenchmark.h"
+
+static void printUsage() {
+    printf("usage: physics-benchmark [--scene box-stack|rubble|ragdolls|kinematic] [--bodies N] [--substeps N]\n"
+           "                         [--warmup-substeps N] [--threads N] [--seed N]\n");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    PhysicsBenchmark::Settings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (strcmp(option, "--scene") == 0) {
+            settings.scene = value;
+        } else if (strcmp(option, "--bodies") == 0) {
+            settings.numBodies = atoi(value);
+        } else if (strcmp(option, "--substeps") == 0) {
+            settings.numSubsteps = atoi(value);
+        } else if (strcmp(option, "--warmup-substeps") == 0) {
+            settings.numWarmupSubsteps = atoi(value);
+        } else if (strcmp(option, "--threads") == 0) {
+            settings.numSolverThreads = atoi(value);
+        } else if (strcmp(option, "--seed") == 0) {
+            settings.seed = (unsigned int)atoi(value);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    PhysicsBenchmark::trackBulletMemory();
+
+    PhysicsBenchmark benchmark(settings);
+    if (!benchmark.buildScene()) {
+        printUsage();
+        return 1;
+    }
+    benchmark.run();
+
+    return 0;
+}
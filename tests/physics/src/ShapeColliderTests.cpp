@@ -2507,10 +2507,112 @@ void ShapeColliderTests::measureTimeOfCollisionDispatch() {
     */
 }
 
+// spheres and capsules spiraling out from the origin, the nearest of them touching a shape there
+static void makeBatchShapes(int numShapes, QVector<Shape*>& shapes) {
+    for (int i = 0; i < numShapes; ++i) {
+        float angle = (float)i * 2.39996f;
+        float distance = 1.0f + 0.1f * (float)(i % 30);
+        glm::vec3 position = distance * glm::vec3(cosf(angle), 0.1f * (float)(i % 7), sinf(angle));
+        if (i % 2 == 0) {
+            shapes.push_back(new SphereShape(0.25f, position));
+        } else {
+            glm::quat rotation = glm::angleAxis(angle, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+            shapes.push_back(new CapsuleShape(0.2f, 0.3f, position, rotation));
+        }
+    }
+    // a cube has no bounding sphere and is always dispatched
+    shapes.push_back(new AACubeShape(1.0f, glm::vec3(1.2f, 0.0f, 0.0f)));
+}
+
+void ShapeColliderTests::collideShapeWithBatchMatchesShapes() {
+    QVector<Shape*> shapes;
+    makeBatchShapes(64, shapes);
+    ShapeCollider::ShapeBatch batch;
+    batch.add(shapes);
+
+    SphereShape sphere(1.0f, origin);
+    CapsuleShape capsule(0.5f, 1.0f, origin, glm::angleAxis(0.5f, zAxis));
+    QVector<Shape*> shapesA;
+    shapesA.push_back(&sphere);
+    shapesA.push_back(&capsule);
+
+    foreach (Shape* shapeA, shapesA) {
+        CollisionList expectedCollisions(128);
+        CollisionList collisions(128);
+        bool expectedTouching = ShapeCollider::collideShapeWithShapes(shapeA, shapes, 0, expectedCollisions);
+        bool touching = ShapeCollider::collideShapeWithBatch(shapeA, batch, collisions);
+        if (touching != expectedTouching || expectedCollisions.size() == 0) {
+            std::cout << __FILE__ << ":" << __LINE__
+                << " ERROR: expected the batch to touch like the shapes do" << std::endl;
+        }
+        if (collisions.size() != expectedCollisions.size()) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << expectedCollisions.size()
+                << " collisions but found " << collisions.size() << std::endl;
+            continue;
+        }
+        for (int i = 0; i < collisions.size(); ++i) {
+            CollisionInfo* expected = expectedCollisions.getCollision(i);
+            CollisionInfo* collision = collisions.getCollision(i);
+            if (collision->getShapeB() != expected->getShapeB()
+                    || glm::distance(collision->_penetration, expected->_penetration) > EPSILON) {
+                std::cout << __FILE__ << ":" << __LINE__
+                    << " ERROR: batch collision " << i << " differs from the shape by shape one" << std::endl;
+            }
+        }
+    }
+
+    // a full list stops the batch like it stops the shapes
+    CollisionList fewCollisions(2);
+    ShapeCollider::collideShapeWithBatch(&sphere, batch, fewCollisions);
+    if (!fewCollisions.isFull()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the collision list to fill up" << std::endl;
+    }
+
+    foreach (Shape* shape, shapes) {
+        delete shape;
+    }
+}
+
+void ShapeColliderTests::measureTimeOfBatchCollision() {
+    QVector<Shape*> shapes;
+    makeBatchShapes(200, shapes);
+    ShapeCollider::ShapeBatch batch;
+    batch.add(shapes);
+    SphereShape sphere(1.0f, origin);
+    CollisionList collisions(256);
+
+    int numTests = 100000;
+    {
+        quint64 startTime = usecTimestampNow();
+        for (int i = 0; i < numTests; ++i) {
+            collisions.clear();
+            ShapeCollider::collideShapeWithShapes(&sphere, shapes, 0, collisions);
+        }
+        quint64 endTime = usecTimestampNow();
+        std::cout << numTests << " sphere vs " << shapes.size() << " shapes one at a time in "
+            << (endTime - startTime) << " usec" << std::endl;
+    }
+    {
+        quint64 startTime = usecTimestampNow();
+        for (int i = 0; i < numTests; ++i) {
+            collisions.clear();
+            ShapeCollider::collideShapeWithBatch(&sphere, batch, collisions);
+        }
+        quint64 endTime = usecTimestampNow();
+        std::cout << numTests << " sphere vs " << shapes.size() << " shapes as a batch in "
+            << (endTime - startTime) << " usec" << std::endl;
+    }
+
+    foreach (Shape* shape, shapes) {
+        delete shape;
+    }
+}
+
 void ShapeColliderTests::runAllTests() {
     ShapeCollider::initDispatchTable();
 
     //measureTimeOfCollisionDispatch();
+    //measureTimeOfBatchCollision();
 
     sphereMissesSphere();
     sphereTouchesSphere();
@@ -2539,4 +2641,6 @@ void ShapeColliderTests::runAllTests() {
 
     rayHitsAACube();
     rayMissesAACube();
+
+    collideShapeWithBatchMatchesShapes();
 }
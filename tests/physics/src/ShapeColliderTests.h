@@ -41,7 +41,10 @@ namespace ShapeColliderTests {
     void rayHitsAACube();
     void rayMissesAACube();
 
+    void collideShapeWithBatchMatchesShapes();
+
     void measureTimeOfCollisionDispatch();
+    void measureTimeOfBatchCollision();
 
     void runAllTests(); 
 }
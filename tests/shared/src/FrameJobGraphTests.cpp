@@ -0,0 +1,72 @@
+//
+//  FrameJobGraphTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <FrameJobGraph.h>
+#include <SharedUtil.h>
+
+#include "FrameJobGraphTests.h"
+
+static void busyWait(quint64 usecs) {
+    quint64 end = usecTimestampNow() + usecs;
+    while (usecTimestampNow() < end);
+}
+
+void FrameJobGraphTests::runAllTests() {
+    qDebug() << "testing FrameJobGraph...";
+    bool fail = false;
+
+    QVector<int> order;
+
+    // a slow chain, and jobs beside it that nothing waits on
+    FrameJobGraph graph;
+    const int JOB_COUNT = 5;
+    int ids[JOB_COUNT];
+    auto record = [&](int job, quint64 usecs) {
+        return [&, job, usecs](float deltaTime) {
+            busyWait(usecs);
+            order.append(job);
+        };
+    };
+    ids[0] = graph.addJob("first", record(0, 0));
+    ids[1] = graph.addJob("slow", record(1, 2000), QVector<int>() << ids[0]);
+    ids[2] = graph.addJob("aside", record(2, 500));
+    ids[3] = graph.addJob("afterSlow", record(3, 0), QVector<int>() << ids[1]);
+    ids[4] = graph.addJob("afterAside", record(4, 0), QVector<int>() << ids[2]);
+
+    const int RUNS = 3;
+    for (int run = 0; run < RUNS; run++) {
+        order.clear();
+        graph.run(1.0f / 60.0f);
+
+        QVector<int> expectedOrder = QVector<int>() << 0 << 1 << 2 << 3 << 4;
+        if (order != expectedOrder) {
+            qDebug() << "\t FAILED - run" << run << "ran" << order << "expected the order they were added in";
+            fail = true;
+        }
+        QVector<int> expectedPath = QVector<int>() << ids[0] << ids[1] << ids[3];
+        if (graph.getCriticalPath() != expectedPath) {
+            qDebug() << "\t FAILED - run" << run << "critical path" << graph.getCriticalPathDescription()
+                << "expected first > slow > afterSlow";
+            fail = true;
+        }
+        if (graph.getCriticalPathUsecs() < graph.getJobUsecs(ids[1]) ||
+                graph.getCriticalPathUsecs() > graph.getRunUsecs()) {
+            qDebug() << "\t FAILED - run" << run << "critical path of" << graph.getCriticalPathUsecs()
+                << "usecs is shorter than its slow job or longer than the run";
+            fail = true;
+        }
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,61 @@
+//
+//  GLMHelpersTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <math.h>
+
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+#include "GLMHelpersTests.h"
+
+void GLMHelpersTests::testSixByteQuatPacking() {
+    // a few quats with one large component, and random ones
+    QVector<glm::quat> quats;
+    quats << glm::quat() << glm::quat(0.0f, 1.0f, 0.0f, 0.0f) << glm::quat(0.0f, 0.0f, -1.0f, 0.0f)
+        << glm::quat(0.0f, 0.0f, 0.0f, 1.0f) << glm::normalize(glm::quat(0.5f, -0.5f, 0.5f, -0.5f));
+    srand(0);
+    for (int i = 0; i < 1000; i++) {
+        quats << glm::normalize(glm::quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                          randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f)));
+    }
+
+    // 15 bits over +-1/sqrt(2) is a step of about 4e-5, the error should be well under a degree
+    const float MIN_DOT = 0.99999f;
+    const int PACKED_BYTES = 6;
+
+    foreach (const glm::quat& quat, quats) {
+        unsigned char buffer[PACKED_BYTES + 1];
+        buffer[PACKED_BYTES] = 0xaa;
+
+        int packedBytes = packOrientationQuatToSixBytes(buffer, quat);
+        glm::quat unpacked;
+        int unpackedBytes = unpackOrientationQuatFromSixBytes(buffer, unpacked);
+
+        if (packedBytes != PACKED_BYTES || unpackedBytes != PACKED_BYTES || buffer[PACKED_BYTES] != 0xaa) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR : six byte quat used " << packedBytes
+                << " bytes to pack and " << unpackedBytes << " to unpack" << std::endl;
+            return;
+        }
+
+        // q and -q are the same orientation
+        float dot = fabsf(glm::dot(quat, unpacked));
+        if (dot < MIN_DOT) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR : six byte quat (" << quat.w << ", " << quat.x
+                << ", " << quat.y << ", " << quat.z << ") came back as (" << unpacked.w << ", " << unpacked.x
+                << ", " << unpacked.y << ", " << unpacked.z << "), dot = " << dot << std::endl;
+        }
+    }
+}
+
+void GLMHelpersTests::runAllTests() {
+    testSixByteQuatPacking();
+    std::cout << "Passed all tests for GLMHelpers" << std::endl;
+}
@@ -0,0 +1,65 @@
+//
+//  InternedStringTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <InternedString.h>
+
+#include "InternedStringTests.h"
+
+void InternedStringTests::runAllTests() {
+    qDebug() << "testing interned strings...";
+
+    InternedStringTable& table = InternedStringTable::getInstance();
+    int startingSize = table.size();
+    bool fail = false;
+
+    {
+        // equal strings share a handle and their data however they were built
+        QString url = "http://example.com/model.fbx";
+        InternedString first(url);
+        InternedString second(QString("http://example.com/") + "model.fbx");
+        InternedString other(QString("http://example.com/other.fbx"));
+        if (first != second || first == other || table.size() != startingSize + 2) {
+            qDebug() << "\t FAILED - equal strings don't share a handle";
+            fail = true;
+        }
+        if (first.toString() != url || first.toString().constData() != second.toString().constData()) {
+            qDebug() << "\t FAILED - looked up strings don't share their data";
+            fail = true;
+        }
+
+        // copies keep the string alive after the original goes
+        InternedString copy;
+        {
+            InternedString temporary(QString("http://example.com/animation.fbx"));
+            copy = temporary;
+        }
+        if (copy.toString() != "http://example.com/animation.fbx") {
+            qDebug() << "\t FAILED - copy lost its string";
+            fail = true;
+        }
+
+        if (!InternedString().isEmpty() || !InternedString(QString()).isEmpty()) {
+            qDebug() << "\t FAILED - empty string has a handle";
+            fail = true;
+        }
+    }
+
+    // once nothing holds them the strings leave the table
+    if (table.size() != startingSize) {
+        qDebug() << "\t FAILED - released strings still in the table:" << table.size() - startingSize;
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,18 @@
+//
+//  InternedStringTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_InternedStringTests_h
+#define hifi_InternedStringTests_h
+
+namespace InternedStringTests {
+    void runAllTests();
+}
+
+#endif // hifi_InternedStringTests_h
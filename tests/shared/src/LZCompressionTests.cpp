@@ -0,0 +1,124 @@
+//
+//  LZCompressionTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <QByteArray>
+#include <QDebug>
+
+#include <LZCompression.h>
+#include <SharedUtil.h>
+
+#include "LZCompressionTests.h"
+
+static bool roundTrips(const QByteArray& source, int& compressedSize) {
+    QByteArray compressed(LZCompression::maxCompressedSize(source.size()), 0);
+    compressedSize = LZCompression::compress(reinterpret_cast<const uchar*>(source.constData()), source.size(),
+                                             reinterpret_cast<uchar*>(compressed.data()), compressed.size());
+    if (compressedSize < 0) {
+        return false;
+    }
+
+    QByteArray decompressed(source.size(), 0);
+    int decompressedSize = LZCompression::decompress(reinterpret_cast<const uchar*>(compressed.constData()),
+                                                     compressedSize, reinterpret_cast<uchar*>(decompressed.data()),
+                                                     decompressed.size());
+    return decompressedSize == source.size() && decompressed == source;
+}
+
+void LZCompressionTests::runAllTests() {
+    qDebug() << "testing LZ compression...";
+
+    srand(0);
+    const int PACKET_SIZE = 1450;
+
+    // noise doesn't compress, runs compress to almost nothing, repeated records sit in between
+    QByteArray noise(PACKET_SIZE, 0);
+    QByteArray runs(PACKET_SIZE, 0);
+    QByteArray records(PACKET_SIZE, 0);
+    for (int i = 0; i < PACKET_SIZE; i++) {
+        noise[i] = (char)rand();
+        runs[i] = (char)(i / 100);
+        records[i] = (i % 37 < 8) ? (char)rand() : (char)(i % 37);
+    }
+
+    bool fail = false;
+    int compressedSize = 0;
+
+    if (!roundTrips(QByteArray(), compressedSize)) {
+        qDebug() << "\t FAILED - empty buffer";
+        fail = true;
+    }
+    if (!roundTrips(noise, compressedSize) || compressedSize > LZCompression::maxCompressedSize(PACKET_SIZE)) {
+        qDebug() << "\t FAILED - incompressible buffer" << compressedSize;
+        fail = true;
+    }
+    if (!roundTrips(runs, compressedSize) || compressedSize > PACKET_SIZE / 10) {
+        qDebug() << "\t FAILED - runs" << compressedSize;
+        fail = true;
+    }
+    if (!roundTrips(records, compressedSize) || compressedSize >= PACKET_SIZE) {
+        qDebug() << "\t FAILED - repeated records" << compressedSize;
+        fail = true;
+    }
+
+    // a destination that's too small is refused rather than overrun
+    uchar small[16];
+    if (LZCompression::compress(reinterpret_cast<const uchar*>(noise.constData()), PACKET_SIZE, small,
+                                sizeof(small)) != -1) {
+        qDebug() << "\t FAILED - small destination";
+        fail = true;
+    }
+
+    // a truncated or corrupted block decodes to -1 or to something that fits, but never past the destination
+    QByteArray compressed(LZCompression::maxCompressedSize(PACKET_SIZE), 0);
+    int recordsSize = LZCompression::compress(reinterpret_cast<const uchar*>(records.constData()), PACKET_SIZE,
+                                              reinterpret_cast<uchar*>(compressed.data()), compressed.size());
+    QByteArray decompressed(PACKET_SIZE, 0);
+    for (int i = 0; i < 1000; i++) {
+        QByteArray corrupt = compressed.left(rand() % (recordsSize + 1));
+        if (!corrupt.isEmpty()) {
+            corrupt[rand() % corrupt.size()] = (char)rand();
+        }
+        int size = LZCompression::decompress(reinterpret_cast<const uchar*>(corrupt.constData()), corrupt.size(),
+                                             reinterpret_cast<uchar*>(decompressed.data()), decompressed.size());
+        if (size > PACKET_SIZE) {
+            qDebug() << "\t FAILED - corrupt block" << size;
+            fail = true;
+            break;
+        }
+    }
+
+    // against zlib on the same records, as OctreePacketData runs it
+    const int ROUNDS = 1000;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < ROUNDS; i++) {
+        roundTrips(records, compressedSize);
+    }
+    quint64 lzUsecs = usecTimestampNow() - start;
+
+    const int MAX_COMPRESSION = 9;
+    int zlibSize = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < ROUNDS; i++) {
+        QByteArray zlibCompressed = qCompress(records, MAX_COMPRESSION);
+        zlibSize = zlibCompressed.size();
+        qUncompress(zlibCompressed);
+    }
+    quint64 zlibUsecs = usecTimestampNow() - start;
+
+    qDebug() << "\t" << PACKET_SIZE << "bytes - lz:" << compressedSize << "bytes" << lzUsecs / ROUNDS
+             << "usecs zlib:" << zlibSize << "bytes" << zlibUsecs / ROUNDS << "usecs";
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
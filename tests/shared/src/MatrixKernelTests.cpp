@@ -0,0 +1,79 @@
+//
+//  MatrixKernelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <math.h>
+
+#include <MatrixKernel.h>
+#include <SharedUtil.h>
+
+#include "MatrixKernelTests.h"
+
+static glm::mat4 randomMatrix() {
+    glm::mat4 matrix;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            matrix[i][j] = randFloatInRange(-10.0f, 10.0f);
+        }
+    }
+    return matrix;
+}
+
+static float maxDifference(const glm::mat4& first, const glm::mat4& second) {
+    float difference = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            difference = glm::max(difference, fabsf(first[i][j] - second[i][j]));
+        }
+    }
+    return difference;
+}
+
+void MatrixKernelTests::testMultiply() {
+    // the products run up to a few thousand, so allow for the float rounding of a different summation order
+    const float MAX_DIFFERENCE = 0.001f;
+
+    srand(0);
+    for (int i = 0; i < 1000; i++) {
+        glm::mat4 left = randomMatrix();
+        glm::mat4 right = randomMatrix();
+        glm::mat4 expected = left * right;
+
+        float difference = maxDifference(MatrixKernel::multiply(left, right), expected);
+        if (difference > MAX_DIFFERENCE) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR : multiply differs from glm by " << difference
+                << std::endl;
+            return;
+        }
+
+        // the result may be either operand
+        glm::mat4 inPlace = left;
+        MatrixKernel::multiply(inPlace, inPlace, right);
+        difference = maxDifference(inPlace, expected);
+        if (difference > MAX_DIFFERENCE) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR : multiply into the left operand differs from glm by "
+                << difference << std::endl;
+            return;
+        }
+        inPlace = right;
+        MatrixKernel::multiply(inPlace, left, inPlace);
+        difference = maxDifference(inPlace, expected);
+        if (difference > MAX_DIFFERENCE) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR : multiply into the right operand differs from glm by "
+                << difference << std::endl;
+            return;
+        }
+    }
+}
+
+void MatrixKernelTests::runAllTests() {
+    testMultiply();
+    std::cout << "Passed all tests for MatrixKernel" << std::endl;
+}
@@ -0,0 +1,21 @@
+//
+//  MatrixKernelTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MatrixKernelTests_h
+#define hifi_MatrixKernelTests_h
+
+namespace MatrixKernelTests {
+
+    void testMultiply();
+
+    void runAllTests();
+}
+
+#endif // hifi_MatrixKernelTests_h
@@ -0,0 +1,85 @@
+//
+//  MemoryTrackerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QThread>
+
+#include <MemoryTracker.h>
+
+#include "MemoryTrackerTests.h"
+
+const int THREAD_COUNT = 4;
+const int ALLOCATIONS_PER_THREAD = 100000;
+
+class AllocatingThread : public QThread {
+public:
+    AllocatingThread(MemoryCounter& counter) : _counter(counter) { }
+
+protected:
+    virtual void run() {
+        // every allocation but the last is freed again
+        for (int i = 0; i < ALLOCATIONS_PER_THREAD; i++) {
+            _counter.addCPUBytes(64);
+            _counter.addGPUBytes(16);
+            if (i < ALLOCATIONS_PER_THREAD - 1) {
+                _counter.removeCPUBytes(64);
+                _counter.removeGPUBytes(16);
+            }
+        }
+    }
+
+private:
+    MemoryCounter& _counter;
+};
+
+void MemoryTrackerTests::runAllTests() {
+    qDebug() << "testing MemoryTracker...";
+    bool fail = false;
+
+    MemoryTracker& tracker = MemoryTracker::getInstance();
+    MemoryCounter& counter = tracker.getCounter("MemoryTrackerTests");
+    if (&tracker.getCounter("MemoryTrackerTests") != &counter) {
+        qDebug() << "\t FAILED - asking for a name again gave a new counter";
+        fail = true;
+    }
+    qint64 otherCPUBytes = tracker.getTotalCPUBytes();
+    qint64 otherGPUBytes = tracker.getTotalGPUBytes();
+
+    QVector<AllocatingThread*> threads;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        threads.append(new AllocatingThread(counter));
+        threads.last()->start();
+    }
+    foreach (AllocatingThread* thread, threads) {
+        thread->wait();
+        delete thread;
+    }
+    if (counter.getCPUBytes() != THREAD_COUNT * 64 || counter.getGPUBytes() != THREAD_COUNT * 16) {
+        qDebug() << "\t FAILED - counted" << counter.getCPUBytes() << "CPU and" << counter.getGPUBytes()
+            << "GPU bytes, expected" << THREAD_COUNT * 64 << "and" << THREAD_COUNT * 16;
+        fail = true;
+    }
+    if (tracker.getTotalCPUBytes() != otherCPUBytes + THREAD_COUNT * 64 ||
+            tracker.getTotalGPUBytes() != otherGPUBytes + THREAD_COUNT * 16) {
+        qDebug() << "\t FAILED - the totals don't include the counter";
+        fail = true;
+    }
+
+    QJsonObject counterObject = tracker.toJson().value("MemoryTrackerTests").toObject();
+    if (counterObject.value("cpu_bytes").toDouble() != THREAD_COUNT * 64 ||
+            counterObject.value("gpu_bytes").toDouble() != THREAD_COUNT * 16) {
+        qDebug() << "\t FAILED - the JSON has" << counterObject;
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,18 @@
+//
+//  MemoryTrackerTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MemoryTrackerTests_h
+#define hifi_MemoryTrackerTests_h
+
+namespace MemoryTrackerTests {
+    void runAllTests();
+}
+
+#endif // hifi_MemoryTrackerTests_h
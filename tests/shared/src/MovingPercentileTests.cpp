@@ -164,6 +164,56 @@ void MovingPercentileTests::runAllTests() {
                 qDebug() << "\t\t PASS";
             }
         }
+
+
+        {
+            bool fail = false;
+
+            qDebug() << "\t testing changing percentile and reset...";
+
+            lastNSamples.clear();
+            MovingPercentile movingPercentile(N, 0.0f);
+
+            for (int s = 0; s < 3*N; s++) {
+
+                float sample = random();
+
+                lastNSamples.push_back(sample);
+                if (lastNSamples.size() > N) {
+                    lastNSamples.pop_front();
+                }
+
+                movingPercentile.updatePercentile(sample);
+            }
+
+            // moving from the min to the max should pick the max of the samples already seen
+            movingPercentile.setPercentile(1.0f);
+
+            float actualMax = lastNSamples[0];
+            for (int j = 0; j < lastNSamples.size(); j++) {
+                if (lastNSamples.at(j) > actualMax) {
+                    actualMax = lastNSamples.at(j);
+                }
+            }
+
+            if (movingPercentile.getValueAtPercentile() != actualMax) {
+                qDebug() << "\t\t FAIL after setPercentile";
+                fail = true;
+            }
+
+            movingPercentile.reset();
+            float sample = random();
+            movingPercentile.updatePercentile(sample);
+
+            if (movingPercentile.getNumSamples() != 1 || movingPercentile.getValueAtPercentile() != sample) {
+                qDebug() << "\t\t FAIL after reset";
+                fail = true;
+            }
+
+            if (!fail) {
+                qDebug() << "\t\t PASS";
+            }
+        }
     }
 }
 
@@ -0,0 +1,117 @@
+//
+//  OctalCodeTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include <OctalCode.h>
+#include <SharedUtil.h>
+
+#include "OctalCodeTests.h"
+
+// the codes of a random cell's line of ancestors, from the root's first child down
+static QVector<unsigned char*> makeLineage(int levels) {
+    QVector<unsigned char*> lineage;
+    unsigned char* code = NULL;
+    for (int level = 0; level < levels; level++) {
+        code = childOctalCode(code, rand() % 8);
+        lineage.append(code);
+    }
+    return lineage;
+}
+
+void OctalCodeTests::runAllTests() {
+    qDebug() << "testing OctalCode...";
+    bool fail = false;
+    srand(0);
+
+    // the points' cells come back where they are, both for the codes that fit in a key and for the deeper ones
+    const int LEVEL_COUNTS[] = { 1, 7, MortonKey::MAX_LEVELS, MortonKey::MAX_LEVELS + 3 };
+    for (size_t i = 0; i < sizeof(LEVEL_COUNTS) / sizeof(LEVEL_COUNTS[0]); i++) {
+        float size = ldexpf(1.0f, -LEVEL_COUNTS[i]);
+        float x = randFloat(), y = randFloat(), z = randFloat();
+        unsigned char* code = pointToOctalCode(x, y, z, size);
+        VoxelPositionSize details;
+        voxelDetailsForCode(code, details);
+        float cornerX = floorf(x / size) * size, cornerY = floorf(y / size) * size, cornerZ = floorf(z / size) * size;
+        if (details.s != size || details.x != cornerX || details.y != cornerY || details.z != cornerZ) {
+            qDebug() << "\t FAILED - cell of" << LEVEL_COUNTS[i] << "levels at" << details.x << details.y << details.z
+                << details.s << "expected" << cornerX << cornerY << cornerZ << size;
+            fail = true;
+        }
+
+        // and the codes that fit go to keys and back unchanged
+        MortonKey key;
+        bool fits = MortonKey::fromOctalCode(code, key);
+        if (fits != (LEVEL_COUNTS[i] <= MortonKey::MAX_LEVELS)) {
+            qDebug() << "\t FAILED - a code of" << LEVEL_COUNTS[i] << "levels packed into a key:" << fits;
+            fail = true;
+        } else if (fits) {
+            unsigned char unpacked[sizeof(quint64) + 1];
+            key.toOctalCode(unpacked);
+            if (key.getLevels() != LEVEL_COUNTS[i] ||
+                    memcmp(unpacked, code, bytesRequiredForCodeLength(LEVEL_COUNTS[i])) != 0) {
+                qDebug() << "\t FAILED - a code of" << LEVEL_COUNTS[i] << "levels changed on the way through a key";
+                fail = true;
+            }
+        }
+        delete[] code;
+    }
+
+    // each code is an ancestor of those below it in its line but not of its cousins, past the keys' depth too
+    const int LINEAGE_LEVELS = MortonKey::MAX_LEVELS + 4;
+    QVector<unsigned char*> lineage = makeLineage(LINEAGE_LEVELS);
+    QVector<unsigned char*> cousins = makeLineage(LINEAGE_LEVELS);
+    for (int ancestor = 0; ancestor < LINEAGE_LEVELS; ancestor++) {
+        for (int descendant = 0; descendant < LINEAGE_LEVELS; descendant++) {
+            bool isAncestor = isAncestorOf(lineage.at(ancestor), lineage.at(descendant));
+            bool isCousinsAncestor = isAncestorOf(lineage.at(ancestor), cousins.at(descendant));
+            if (isAncestor != (ancestor <= descendant) || (isCousinsAncestor &&
+                    compareOctalCodes(lineage.at(0), cousins.at(0)) != EXACT_MATCH)) {
+                qDebug() << "\t FAILED - level" << ancestor << "against level" << descendant;
+                fail = true;
+            }
+        }
+        if (ancestor > 0) {
+            int branch = branchIndexWithDescendant(lineage.at(ancestor - 1), lineage.at(LINEAGE_LEVELS - 1));
+            unsigned char* child = childOctalCode(lineage.at(ancestor - 1), branch);
+            if (compareOctalCodes(child, lineage.at(ancestor)) != EXACT_MATCH) {
+                qDebug() << "\t FAILED - branch index below level" << ancestor - 1;
+                fail = true;
+            }
+            delete[] child;
+        }
+    }
+
+    // what the jurisdiction checks cost, on codes that fit
+    const int ROUNDS = 1000000;
+    const unsigned char* ancestorCode = lineage.at(MortonKey::MAX_LEVELS / 2);
+    const unsigned char* descendantCode = lineage.at(MortonKey::MAX_LEVELS - 1);
+    int ancestors = 0;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < ROUNDS; i++) {
+        ancestors += isAncestorOf(ancestorCode, descendantCode) ? 1 : 0;
+    }
+    qDebug() << "\t" << ROUNDS << "ancestor checks took" << (usecTimestampNow() - start) << "usecs";
+    if (ancestors != ROUNDS) {
+        qDebug() << "\t FAILED - an ancestor check failed";
+        fail = true;
+    }
+
+    foreach (unsigned char* code, lineage + cousins) {
+        delete[] code;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
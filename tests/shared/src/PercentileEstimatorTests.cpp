@@ -0,0 +1,71 @@
+//
+//  PercentileEstimatorTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include <PercentileEstimator.h>
+
+#include "PercentileEstimatorTests.h"
+
+static float randomSample() {
+    return rand() / (float)RAND_MAX;
+}
+
+void PercentileEstimatorTests::runAllTests() {
+    qDebug() << "testing PercentileEstimator...";
+    bool fail = false;
+
+    // until there are enough samples for the markers the value is exact
+    PercentileEstimator few(100, 0.5f);
+    few.updatePercentile(3.0f);
+    few.updatePercentile(1.0f);
+    few.updatePercentile(2.0f);
+    if (few.getValueAtPercentile() != 2.0f || few.getNumSamples() != 3) {
+        qDebug() << "\t FAILED - median of three samples was" << few.getValueAtPercentile();
+        fail = true;
+    }
+
+    // samples uniform in [0, 1] have the percentile itself as the value at it
+    const int WINDOW_SAMPLES = 1000;
+    const float MAX_ERROR = 0.05f;
+    const float PERCENTILES[] = { 0.1f, 0.5f, 0.8f, 0.95f, 0.99f };
+    srand(0);
+    for (size_t i = 0; i < sizeof(PERCENTILES) / sizeof(PERCENTILES[0]); i++) {
+        PercentileEstimator estimator(WINDOW_SAMPLES, PERCENTILES[i]);
+        for (int s = 0; s < WINDOW_SAMPLES * 3; s++) {
+            estimator.updatePercentile(randomSample());
+        }
+        float value = estimator.getValueAtPercentile();
+        if (fabsf(value - PERCENTILES[i]) > MAX_ERROR) {
+            qDebug() << "\t FAILED -" << PERCENTILES[i] << "percentile estimated at" << value;
+            fail = true;
+        }
+    }
+
+    // the estimate follows the samples from one window to the next
+    PercentileEstimator moving(WINDOW_SAMPLES, 0.5f);
+    for (int s = 0; s < WINDOW_SAMPLES; s++) {
+        moving.updatePercentile(randomSample());
+    }
+    for (int s = 0; s < WINDOW_SAMPLES; s++) {
+        moving.updatePercentile(10.0f + randomSample());
+    }
+    if (fabsf(moving.getValueAtPercentile() - 10.5f) > MAX_ERROR) {
+        qDebug() << "\t FAILED - median after the samples moved estimated at" << moving.getValueAtPercentile();
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "\t PASS";
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  PerformanceTimerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <PerfStat.h>
+
+#include "PerformanceTimerTests.h"
+
+const int INNER_CALLS = 3;
+
+static void timeInner() {
+    PERFORMANCE_TIMER("perfTestInner");
+}
+
+static void timeOuter() {
+    PERFORMANCE_TIMER("perfTestOuter");
+    for (int i = 0; i < INNER_CALLS; i++) {
+        timeInner();
+    }
+}
+
+class TimingThread : public QThread {
+protected:
+    virtual void run() {
+        timeOuter();
+    }
+};
+
+void PerformanceTimerTests::runAllTests() {
+    qDebug() << "testing PerformanceTimer...";
+    bool fail = false;
+
+    int scope = PerformanceTimer::registerScope("perfTestOuter");
+    if (PerformanceTimer::registerScope("perfTestOuter") != scope) {
+        qDebug() << "\t FAILED - registering a name again gave a new ID";
+        fail = true;
+    }
+
+    // the inner scope is timed under the outer, whichever thread it's on
+    timeOuter();
+    TimingThread thread;
+    thread.start();
+    thread.wait();
+
+    PerformanceTimer::tallyAllTimerRecords();
+    const QMap<QString, PerformanceTimerRecord>& records = PerformanceTimer::getAllTimerRecords();
+    if (!records.contains("/perfTestOuter") || !records.contains("/perfTestOuter/perfTestInner")) {
+        qDebug() << "\t FAILED - records are" << records.keys() << "expected /perfTestOuter and its inner scope";
+        fail = true;
+    }
+    if (records.contains("/perfTestInner")) {
+        qDebug() << "\t FAILED - the inner scope was timed outside the outer";
+        fail = true;
+    }
+
+    // both threads left their scopes in the trace
+    QJsonArray events = QJsonDocument::fromJson(PerformanceTimer::getChromeTrace()).object()["traceEvents"].toArray();
+    int numInnerEvents = 0;
+    foreach (const QJsonValue& event, events) {
+        if (event.toObject()["name"].toString() == "perfTestInner") {
+            numInnerEvents++;
+        }
+    }
+    if (numInnerEvents != 2 * INNER_CALLS) {
+        qDebug() << "\t FAILED - trace has" << numInnerEvents << "inner scopes, expected" << 2 * INNER_CALLS;
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,96 @@
+//
+//  SipHashTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdlib.h>
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include <SharedUtil.h>
+#include <SipHash.h>
+
+#include "SipHashTests.h"
+
+static QByteArray hash(const QByteArray& key, const QByteArray& message) {
+    QByteArray result(SipHash::HASH_BYTES, 0);
+    SipHash::hash128(reinterpret_cast<const uchar*>(key.constData()),
+                     reinterpret_cast<const uchar*>(message.constData()), message.size(),
+                     reinterpret_cast<uchar*>(result.data()));
+    return result;
+}
+
+void SipHashTests::runAllTests() {
+    qDebug() << "testing SipHash...";
+
+    // the reference vectors hash the bytes 0, 1, 2... under the key 0, 1, 2... 15
+    QByteArray key(SipHash::KEY_BYTES, 0);
+    QByteArray message(64, 0);
+    for (int i = 0; i < message.size(); i++) {
+        message[i] = (char)i;
+        if (i < key.size()) {
+            key[i] = (char)i;
+        }
+    }
+    struct Vector {
+        int length;
+        const char* hash;
+    };
+    const Vector VECTORS[] = {
+        { 0, "a3817f04ba25a8e66df67214c7550293" },
+        { 1, "da87c1d86b99af44347659119b22fc45" },
+        { 7, "a1f1ebbed8dbc153c0b84aa61ff08239" },
+        { 8, "3b62a9ba6258f5610f83e264f31497b4" },
+        { 15, "5493e99933b0a8117e08ec0f97cfc3d9" },
+        { 63, "5150d1772f50834a503e069a973fbd7c" } };
+
+    bool fail = false;
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+        QByteArray result = hash(key, message.left(VECTORS[i].length)).toHex();
+        if (result != VECTORS[i].hash) {
+            qDebug() << "\t FAILED -" << VECTORS[i].length << "bytes: got" << result << "expected" << VECTORS[i].hash;
+            fail = true;
+        }
+    }
+
+    QByteArray otherKey = key;
+    otherKey[0] = otherKey[0] ^ 1;
+    if (hash(key, message) == hash(otherKey, message)) {
+        qDebug() << "\t FAILED - changing the key didn't change the hash";
+        fail = true;
+    }
+
+    // against the MD5 of payload and secret that packet verification used before
+    srand(0);
+    const int PACKET_SIZE = 1450;
+    QByteArray packet(PACKET_SIZE, 0);
+    for (int i = 0; i < PACKET_SIZE; i++) {
+        packet[i] = (char)rand();
+    }
+    const int ROUNDS = 10000;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < ROUNDS; i++) {
+        hash(key, packet);
+    }
+    quint64 sipHashUsecs = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    for (int i = 0; i < ROUNDS; i++) {
+        QCryptographicHash::hash(packet + key, QCryptographicHash::Md5);
+    }
+    quint64 md5Usecs = usecTimestampNow() - start;
+
+    qDebug() << "\t" << ROUNDS << "packets of" << PACKET_SIZE << "bytes - siphash:" << sipHashUsecs
+             << "usecs md5:" << md5Usecs << "usecs";
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
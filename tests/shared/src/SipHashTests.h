@@ -0,0 +1,18 @@
+//
+//  SipHashTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHashTests_h
+#define hifi_SipHashTests_h
+
+namespace SipHashTests {
+    void runAllTests();
+}
+
+#endif // hifi_SipHashTests_h
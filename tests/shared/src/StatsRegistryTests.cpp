@@ -0,0 +1,104 @@
+//
+//  StatsRegistryTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QThread>
+
+#include <StatsRegistry.h>
+
+#include "StatsRegistryTests.h"
+
+const int THREAD_COUNT = 4;
+const int ADDS_PER_THREAD = 100000;
+
+class AddingThread : public QThread {
+public:
+    AddingThread(StatsRegistry& registry, int counter, int histogram) :
+        _registry(registry), _counter(counter), _histogram(histogram) { }
+
+protected:
+    virtual void run() {
+        for (int i = 0; i < ADDS_PER_THREAD; i++) {
+            _registry.add(_counter);
+            _registry.record(_histogram, i % 200);
+        }
+    }
+
+private:
+    StatsRegistry& _registry;
+    int _counter;
+    int _histogram;
+};
+
+void StatsRegistryTests::runAllTests() {
+    qDebug() << "testing StatsRegistry...";
+    bool fail = false;
+
+    StatsRegistry registry;
+    int counter = registry.registerCounter("adds");
+    int histogram = registry.registerHistogram("samples", QVector<quint64>() << 10 << 100);
+    if (registry.registerCounter("adds") != counter) {
+        qDebug() << "\t FAILED - registering a name again gave a new ID";
+        fail = true;
+    }
+
+    // two rounds of threads, the second taking over the blocks the first left, should lose none of the adds
+    for (int round = 0; round < 2; round++) {
+        QVector<AddingThread*> threads;
+        for (int i = 0; i < THREAD_COUNT; i++) {
+            threads.append(new AddingThread(registry, counter, histogram));
+            threads.last()->start();
+        }
+        foreach (AddingThread* thread, threads) {
+            thread->wait();
+            delete thread;
+        }
+    }
+    const quint64 EXPECTED_ADDS = 2 * THREAD_COUNT * ADDS_PER_THREAD;
+    if (registry.getCount(counter) != EXPECTED_ADDS) {
+        qDebug() << "\t FAILED - counted" << registry.getCount(counter) << "expected" << EXPECTED_ADDS;
+        fail = true;
+    }
+
+    // each thread recorded 0 through 199 over and over, so a bucket's share is known exactly
+    QVector<StatsRegistry::Bucket> buckets = registry.getHistogram(histogram);
+    const quint64 REPEATS = EXPECTED_ADDS / 200;
+    const quint64 EXPECTED_COUNTS[] = { 11 * REPEATS, 90 * REPEATS, 99 * REPEATS, EXPECTED_ADDS };
+    const quint64 EXPECTED_SUMS[] = { 55 * REPEATS, 4995 * REPEATS, 14850 * REPEATS, 19900 * REPEATS };
+    if (buckets.size() != 4) {
+        qDebug() << "\t FAILED - histogram has" << buckets.size() << "buckets with the whole, expected 4";
+        fail = true;
+    } else {
+        for (int i = 0; i < buckets.size(); i++) {
+            if (buckets.at(i).count != EXPECTED_COUNTS[i] || buckets.at(i).sum != EXPECTED_SUMS[i]) {
+                qDebug() << "\t FAILED - bucket" << i << "has" << buckets.at(i).count << "samples summing to"
+                    << buckets.at(i).sum << "expected" << EXPECTED_COUNTS[i] << EXPECTED_SUMS[i];
+                fail = true;
+            }
+        }
+    }
+
+    // a reset starts the reads over, but the totals go on
+    registry.reset();
+    registry.add(counter, 5);
+    if (registry.getCount(counter) != 5 || registry.getHistogram(histogram).last().count != 0) {
+        qDebug() << "\t FAILED - read" << registry.getCount(counter) << "after a reset and an add of 5";
+        fail = true;
+    }
+    if (registry.toJson().value("adds").toDouble() != EXPECTED_ADDS + 5) {
+        qDebug() << "\t FAILED - total of" << registry.toJson().value("adds").toDouble() << "expected"
+            << EXPECTED_ADDS + 5;
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,18 @@
+//
+//  StatsRegistryTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_StatsRegistryTests_h
+#define hifi_StatsRegistryTests_h
+
+namespace StatsRegistryTests {
+    void runAllTests();
+}
+
+#endif // hifi_StatsRegistryTests_h
@@ -0,0 +1,93 @@
+//
+//  TimerWheelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include <TimerWheel.h>
+
+#include "TimerWheelTests.h"
+
+const quint64 TICK_USECS = 1000;
+const int SLOT_COUNT = 64;
+
+void TimerWheelTests::runAllTests() {
+    qDebug() << "testing TimerWheel...";
+    bool fail = false;
+
+    // timers due within a turn, past a turn, and already due, scheduled out of order
+    TimerWheel wheel(TICK_USECS, SLOT_COUNT);
+    const quint64 START = 1000000;
+    QVector<int> ignored;
+    wheel.advance(START, ignored);
+    const quint64 DUES[] = { START + 5500, START + 200000, START, START + 5000, START + SLOT_COUNT * TICK_USECS };
+    const int TIMER_COUNT = sizeof(DUES) / sizeof(DUES[0]);
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        wheel.schedule(i, DUES[i]);
+    }
+
+    // stepping a frame at a time, each timer should come due in the first advance at or after its time
+    QVector<int> fired;
+    quint64 firedAt[TIMER_COUNT];
+    const quint64 FRAME_USECS = 16667;
+    for (quint64 now = START; now <= START + 250000; now += FRAME_USECS) {
+        QVector<int> due;
+        wheel.advance(now, due);
+        foreach (int id, due) {
+            fired.append(id);
+            firedAt[id] = now;
+        }
+    }
+    QVector<int> expectedOrder = QVector<int>() << 2 << 3 << 0 << 4 << 1;
+    if (fired != expectedOrder) {
+        qDebug() << "\t FAILED - fired" << fired << "expected" << expectedOrder;
+        fail = true;
+    } else {
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            if (firedAt[i] < DUES[i] || firedAt[i] >= DUES[i] + FRAME_USECS) {
+                qDebug() << "\t FAILED - timer" << i << "due at" << DUES[i] << "fired at" << firedAt[i];
+                fail = true;
+            }
+        }
+    }
+    if (wheel.getScheduledCount() != 0) {
+        qDebug() << "\t FAILED - " << wheel.getScheduledCount() << "timers left in the wheel";
+        fail = true;
+    }
+
+    // after a pause longer than a turn, everything due comes out in one advance, soonest first
+    srand(0);
+    const int MANY_TIMERS = 10000;
+    quint64 now = START + 1000000;
+    wheel.advance(now, ignored);
+    QVector<quint64> manyDues(MANY_TIMERS);
+    for (int i = 0; i < MANY_TIMERS; i++) {
+        manyDues[i] = now + rand() % (SLOT_COUNT * 3 * TICK_USECS);
+        wheel.schedule(i, manyDues.at(i));
+    }
+    QVector<int> due;
+    wheel.advance(now + SLOT_COUNT * 3 * TICK_USECS, due);
+    if (due.size() != MANY_TIMERS) {
+        qDebug() << "\t FAILED - " << due.size() << "of" << MANY_TIMERS << "timers came due after a pause";
+        fail = true;
+    }
+    for (int i = 1; i < due.size(); i++) {
+        if (manyDues.at(due.at(i)) < manyDues.at(due.at(i - 1))) {
+            qDebug() << "\t FAILED - timer" << due.at(i) << "came out after a later one";
+            fail = true;
+            break;
+        }
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,18 @@
+//
+//  TimerWheelTests.h
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheelTests_h
+#define hifi_TimerWheelTests_h
+
+namespace TimerWheelTests {
+    void runAllTests();
+}
+
+#endif // hifi_TimerWheelTests_h
@@ -0,0 +1,111 @@
+//
+//  TriangleBVHTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <SharedUtil.h>
+#include <TriangleBVH.h>
+
+#include "TriangleBVHTests.h"
+
+const int TRIANGLE_COUNT = 2000;
+const int RAY_COUNT = 2000;
+
+static glm::vec3 randomPoint(float range) {
+    return glm::vec3(randFloatInRange(-range, range), randFloatInRange(-range, range),
+        randFloatInRange(-range, range));
+}
+
+// the nearest hit found by testing every triangle, as the hierarchy is to find it
+static bool findBruteForceIntersection(const QVector<Triangle>& triangles, const glm::vec3& origin,
+        const glm::vec3& direction, float& distance) {
+    bool intersected = false;
+    distance = FLT_MAX;
+    foreach (const Triangle& triangle, triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangle, triangleDistance) && triangleDistance < distance) {
+            distance = triangleDistance;
+            intersected = true;
+        }
+    }
+    return intersected;
+}
+
+void TriangleBVHTests::runAllTests() {
+    qDebug() << "testing TriangleBVH...";
+    bool fail = false;
+
+    float distance;
+    TriangleBVH empty;
+    if (empty.findRayIntersection(glm::vec3(), glm::vec3(0.0f, 0.0f, -1.0f), distance)) {
+        qDebug() << "\t FAILED - a ray hit an empty hierarchy";
+        fail = true;
+    }
+
+    // small triangles scattered through a cube, both ways around, so that some face each ray
+    const float SCATTER_RANGE = 10.0f;
+    const float TRIANGLE_SIZE = 1.0f;
+    QVector<Triangle> triangles;
+    for (int i = 0; i < TRIANGLE_COUNT; i++) {
+        glm::vec3 center = randomPoint(SCATTER_RANGE);
+        Triangle triangle = { center + randomPoint(TRIANGLE_SIZE), center + randomPoint(TRIANGLE_SIZE),
+            center + randomPoint(TRIANGLE_SIZE) };
+        triangles.append(triangle);
+    }
+    TriangleBVH bvh(triangles);
+    if (bvh.getTriangleCount() != TRIANGLE_COUNT) {
+        qDebug() << "\t FAILED - the hierarchy holds" << bvh.getTriangleCount() << "triangles rather than"
+            << TRIANGLE_COUNT;
+        fail = true;
+    }
+
+    int hits = 0;
+    for (int i = 0; i < RAY_COUNT && !fail; i++) {
+        glm::vec3 origin = randomPoint(SCATTER_RANGE * 2.0f);
+        glm::vec3 direction = glm::normalize(randomPoint(SCATTER_RANGE) - origin);
+        float expectedDistance;
+        bool expected = findBruteForceIntersection(triangles, origin, direction, expectedDistance);
+        bool found = bvh.findRayIntersection(origin, direction, distance);
+        if (found != expected || (found && distance != expectedDistance)) {
+            qDebug() << "\t FAILED - the hierarchy found" << (found ? distance : -1.0f) << "where testing all found"
+                << (expected ? expectedDistance : -1.0f);
+            fail = true;
+        }
+        if (found) {
+            hits++;
+
+            // nothing is to be found nearer than what was just found
+            float nearerDistance;
+            if (bvh.findRayIntersection(origin, direction, nearerDistance, distance)) {
+                qDebug() << "\t FAILED - a hit was found beyond the distance looked to";
+                fail = true;
+            }
+        }
+    }
+    if (hits == 0) {
+        qDebug() << "\t FAILED - no ray hit anything, so nothing was compared";
+        fail = true;
+    }
+
+    // a ray along an axis, for which the slab test divides by zero
+    QVector<Triangle> facing;
+    Triangle facingTriangle = { glm::vec3(-1.0f, -1.0f, -5.0f), glm::vec3(1.0f, -1.0f, -5.0f),
+        glm::vec3(0.0f, 1.0f, -5.0f) };
+    facing.append(facingTriangle);
+    if (!TriangleBVH(facing).findRayIntersection(glm::vec3(), glm::vec3(0.0f, 0.0f, -1.0f), distance) ||
+            fabsf(distance - 5.0f) > EPSILON) {
+        qDebug() << "\t FAILED - a ray along an axis missed the triangle in front of it";
+        fail = true;
+    }
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  TripleBufferTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QThread>
+
+#include <TripleBuffer.h>
+
+#include "TripleBufferTests.h"
+
+const int PUBLISHED_VALUES = 1000000;
+
+class Pair {
+public:
+    int first = 0;
+    int second = 0;
+};
+
+class PublishingThread : public QThread {
+public:
+    PublishingThread(TripleBuffer<Pair>& buffer) : _buffer(buffer) { }
+
+protected:
+    virtual void run() {
+        for (int i = 1; i <= PUBLISHED_VALUES; i++) {
+            Pair& pair = _buffer.getWriteBuffer();
+            pair.first = i;
+            pair.second = -i;
+            _buffer.publish();
+        }
+    }
+
+private:
+    TripleBuffer<Pair>& _buffer;
+};
+
+void TripleBufferTests::runAllTests() {
+    qDebug() << "testing TripleBuffer...";
+    bool fail = false;
+
+    TripleBuffer<Pair> buffer;
+    if (buffer.update()) {
+        qDebug() << "\t FAILED - a value was taken before any was published";
+        fail = true;
+    }
+    for (int i = 1; i <= 3; i++) {
+        buffer.getWriteBuffer().first = i;
+        buffer.publish();
+    }
+    if (!buffer.update() || buffer.getReadBuffer().first != 3) {
+        qDebug() << "\t FAILED - the reader didn't take the last value published";
+        fail = true;
+    }
+    if (buffer.update() || buffer.getReadBuffer().first != 3) {
+        qDebug() << "\t FAILED - the reader took a value twice";
+        fail = true;
+    }
+
+    // the reader must only ever see whole values, going forward
+    TripleBuffer<Pair> sharedBuffer;
+    PublishingThread thread(sharedBuffer);
+    thread.start();
+    int last = 0;
+    while (last < PUBLISHED_VALUES && !fail) {
+        if (!sharedBuffer.update()) {
+            continue;
+        }
+        const Pair& pair = sharedBuffer.getReadBuffer();
+        if (pair.second != -pair.first) {
+            qDebug() << "\t FAILED - the reader saw a value half written:" << pair.first << pair.second;
+            fail = true;
+        } else if (pair.first <= last) {
+            qDebug() << "\t FAILED - the reader went back from" << last << "to" << pair.first;
+            fail = true;
+        }
+        last = pair.first;
+    }
+    thread.wait();
+
+    if (!fail) {
+        qDebug() << "passed";
+    }
+}
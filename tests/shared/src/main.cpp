@@ -9,13 +9,41 @@
 //
 
 #include "AngularConstraintTests.h"
+#include "FrameJobGraphTests.h"
+#include "GLMHelpersTests.h"
+#include "InternedStringTests.h"
+#include "LZCompressionTests.h"
+#include "MatrixKernelTests.h"
+#include "MemoryTrackerTests.h"
 #include "MovingPercentileTests.h"
 #include "MovingMinMaxAvgTests.h"
+#include "OctalCodeTests.h"
+#include "PercentileEstimatorTests.h"
+#include "PerformanceTimerTests.h"
+#include "SipHashTests.h"
+#include "StatsRegistryTests.h"
+#include "TimerWheelTests.h"
+#include "TriangleBVHTests.h"
+#include "TripleBufferTests.h"
 
 int main(int argc, char** argv) {
     MovingMinMaxAvgTests::runAllTests();
     MovingPercentileTests::runAllTests();
     AngularConstraintTests::runAllTests();
+    FrameJobGraphTests::runAllTests();
+    GLMHelpersTests::runAllTests();
+    LZCompressionTests::runAllTests();
+    InternedStringTests::runAllTests();
+    MatrixKernelTests::runAllTests();
+    MemoryTrackerTests::runAllTests();
+    OctalCodeTests::runAllTests();
+    PercentileEstimatorTests::runAllTests();
+    PerformanceTimerTests::runAllTests();
+    SipHashTests::runAllTests();
+    StatsRegistryTests::runAllTests();
+    TimerWheelTests::runAllTests();
+    TriangleBVHTests::runAllTests();
+    TripleBufferTests::runAllTests();
     printf("tests complete, press enter to exit\n");
     getchar();
     return 0;
@@ -0,0 +1,631 @@
+//
+//  BotSwarm.cpp
+//  tools/bot-swarm/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QTimer>
+#include <QtNetwork/QHostInfo>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioCodec.h>
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <LimitedNodeList.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+
+#include "BotSwarm.h"
+
+static const int CHECK_IN_INTERVAL_MSECS = 1000;
+static const int AVATAR_SEND_INTERVAL_MSECS = 16;
+
+// silent bots send one packet with the samples of this many frames, like the AudioClient's discontinuous transmission
+static const int SILENT_FRAMES_PER_PACKET = 10;
+
+static const float TONE_FREQUENCY = 440.0f;
+static const float TONE_AMPLITUDE = 0.1f;
+
+static const char* CATEGORY_NAMES[] = { "avatars", "audio", "octree", "control", "other" };
+static const char* SERVER_NAMES[] = { "avatar mixer", "audio mixer", "entity server" };
+
+BotSwarm::Settings::Settings() :
+    domainHostname("localhost"),
+    domainPort(DEFAULT_DOMAIN_SERVER_PORT),
+    numBots(100),
+    path("circle"),
+    center(0.0f),
+    radius(20.0f),
+    speed(1.5f),
+    numJoints(20),
+    talkingFraction(0.1f),
+    queryEntities(true),
+    maxOctreePacketsPerSecond(DEFAULT_MAX_OCTREE_PPS),
+    seconds(0),
+    reportInterval(5)
+{
+}
+
+BotSwarm::Bot::Bot() :
+    index(0),
+    socket(NULL),
+    domainListVersion(0),
+    avatar(NULL),
+    isTalking(false),
+    audioSequence(0),
+    numSilentFrames(0),
+    bytesSent(0),
+    lastAudioReceived(0)
+{
+    memset(packetsReceived, 0, sizeof(packetsReceived));
+    memset(bytesReceived, 0, sizeof(bytesReceived));
+}
+
+BotSwarm::BotSwarm(const Settings& settings, QObject* parent) :
+    QObject(parent),
+    _settings(settings),
+    _startTime(0),
+    _lastAvatarTime(0),
+    _lastReportTime(0),
+    _numDenied(0)
+{
+    // the same frame of a tone for every talking bot
+    _toneFrame.resize(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+    AudioConstants::AudioSample* samples = reinterpret_cast<AudioConstants::AudioSample*>(_toneFrame.data());
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        float phase = TWO_PI * TONE_FREQUENCY * (float)i / (float)AudioConstants::SAMPLE_RATE;
+        samples[i] = (AudioConstants::AudioSample)(TONE_AMPLITUDE * AudioConstants::MAX_SAMPLE_VALUE * sinf(phase));
+    }
+    _octreeQuery.setMaxOctreePacketsPerSecond(_settings.maxOctreePacketsPerSecond);
+}
+
+BotSwarm::~BotSwarm() {
+    for (int i = 0; i < _bots.size(); i++) {
+        delete _bots[i].avatar;
+    }
+}
+
+bool BotSwarm::start() {
+    QHostInfo hostInfo = QHostInfo::fromName(_settings.domainHostname);
+    QHostAddress domainAddress;
+    foreach (const QHostAddress& address, hostInfo.addresses()) {
+        if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+            domainAddress = address;
+            break;
+        }
+    }
+    if (domainAddress.isNull()) {
+        printf("unable to resolve the domain %s\n", _settings.domainHostname.toLocal8Bit().constData());
+        return false;
+    }
+    _domainSockAddr = HifiSockAddr(domainAddress, _settings.domainPort);
+
+    // bots on a domain on this machine are reached through the loopback, others through our local address
+    QHostAddress localAddress = domainAddress.isLoopback() ? QHostAddress(QHostAddress::LocalHost) : getLocalAddress();
+
+    _bots.resize(_settings.numBots);
+    for (int i = 0; i < _bots.size(); i++) {
+        Bot& bot = _bots[i];
+        bot.index = i;
+        bot.connectUUID = QUuid::createUuid();
+        bot.socket = new QUdpSocket(this);
+        if (!bot.socket->bind(QHostAddress::AnyIPv4, 0)) {
+            printf("unable to bind a socket for bot %d, raise the open file limit for more bots: %s\n", i,
+                   bot.socket->errorString().toLocal8Bit().constData());
+            _bots.resize(i);
+            break;
+        }
+        bot.localSockAddr = HifiSockAddr(localAddress, bot.socket->localPort());
+        connect(bot.socket, &QUdpSocket::readyRead, this, [this, i]() { readDatagrams(_bots[i]); });
+
+        bot.avatar = new AvatarData();
+        bot.avatar->setDisplayName(QString("bot %1").arg(i));
+        bot.avatar->setSessionUUID(bot.connectUUID);
+        for (int joint = 0; joint < _settings.numJoints; joint++) {
+            bot.avatar->setJointData(joint, glm::quat());
+        }
+        bot.isTalking = (float)i < _settings.talkingFraction * _settings.numBots;
+        bot.waypoint = _settings.center;
+        move(bot, 0.0f, 0.0f);
+    }
+    printf("%d bots connecting to %s:%d\n", _bots.size(), domainAddress.toString().toLocal8Bit().constData(),
+           _settings.domainPort);
+
+    _startTime = _lastAvatarTime = _lastReportTime = usecTimestampNow();
+
+    QTimer* checkInTimer = new QTimer(this);
+    connect(checkInTimer, &QTimer::timeout, this, &BotSwarm::checkIn);
+    checkInTimer->start(CHECK_IN_INTERVAL_MSECS);
+    checkIn();
+
+    QTimer* avatarTimer = new QTimer(this);
+    avatarTimer->setTimerType(Qt::PreciseTimer);
+    connect(avatarTimer, &QTimer::timeout, this, &BotSwarm::sendAvatarData);
+    avatarTimer->start(AVATAR_SEND_INTERVAL_MSECS);
+
+    QTimer* audioTimer = new QTimer(this);
+    audioTimer->setTimerType(Qt::PreciseTimer);
+    connect(audioTimer, &QTimer::timeout, this, &BotSwarm::sendAudio);
+    audioTimer->start(AudioConstants::NETWORK_FRAME_USECS / USECS_PER_MSEC);
+
+    QTimer* reportTimer = new QTimer(this);
+    connect(reportTimer, &QTimer::timeout, this, &BotSwarm::report);
+    reportTimer->start(_settings.reportInterval * MSECS_PER_SECOND);
+
+    return true;
+}
+
+int BotSwarm::serverForNodeType(NodeType_t nodeType) const {
+    switch (nodeType) {
+        case NodeType::AvatarMixer:
+            return AVATAR_MIXER;
+        case NodeType::AudioMixer:
+            return AUDIO_MIXER;
+        case NodeType::EntityServer:
+            return _settings.queryEntities ? ENTITY_SERVER : -1;
+        default:
+            return -1;
+    }
+}
+
+void BotSwarm::sendTo(Bot& bot, const QByteArray& packet, const HifiSockAddr& destination) {
+    if (bot.socket->writeDatagram(packet, destination.getAddress(), destination.getPort()) > 0) {
+        bot.bytesSent += packet.size();
+    }
+}
+
+void BotSwarm::sendToServer(Bot& bot, Server server, QByteArray& packet) {
+    ServerLink& link = bot.servers[server];
+    if (link.uuid.isNull()) {
+        return;
+    }
+    if (!NON_VERIFIED_PACKETS.contains(packetTypeForPacket(packet))) {
+        replaceHashInPacketGivenConnectionUUID(packet, link.connectionSecret);
+    }
+    if (!link.activeSocket.isNull()) {
+        sendTo(bot, packet, link.activeSocket);
+    } else {
+        sendTo(bot, packet, link.publicSocket);
+        if (link.localSocket != link.publicSocket) {
+            sendTo(bot, packet, link.localSocket);
+        }
+    }
+}
+
+void BotSwarm::checkIn() {
+    NodeType_t ownerType = NodeType::Agent;
+    QList<NodeType_t> nodeTypesOfInterest;
+    nodeTypesOfInterest << NodeType::AvatarMixer << NodeType::AudioMixer;
+    if (_settings.queryEntities) {
+        nodeTypesOfInterest << NodeType::EntityServer;
+    }
+
+    for (int i = 0; i < _bots.size(); i++) {
+        Bot& bot = _bots[i];
+
+        // the same check in the NodeList makes, a connect request until the domain has answered and a list request
+        // with the list version we have after that
+        bool isConnected = !bot.sessionUUID.isNull();
+        PacketType packetType = isConnected ? PacketTypeDomainListRequest : PacketTypeDomainConnectRequest;
+        QByteArray packet = byteArrayWithPopulatedHeader(packetType, isConnected ? bot.sessionUUID : bot.connectUUID);
+        QDataStream packetStream(&packet, QIODevice::Append);
+        packetStream << ownerType << bot.localSockAddr << bot.localSockAddr << nodeTypesOfInterest;
+        if (isConnected) {
+            packetStream << bot.domainListVersion << QHash<QUuid, qint32>();
+        } else {
+            packetStream << QString();
+        }
+        sendTo(bot, packet, _domainSockAddr);
+
+        if (!isConnected) {
+            continue;
+        }
+
+        sendPings(bot);
+
+        // the identity goes out as often as the interface's does, and the query as often as its unchanged view would
+        QByteArray identityPacket = byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity, bot.sessionUUID);
+        identityPacket.append(bot.avatar->identityByteArray(true));
+        sendToServer(bot, AVATAR_MIXER, identityPacket);
+
+        if (_settings.queryEntities) {
+            sendOctreeQuery(bot);
+        }
+    }
+}
+
+void BotSwarm::sendPings(Bot& bot) {
+    for (int server = 0; server < NUM_SERVERS; server++) {
+        ServerLink& link = bot.servers[server];
+        if (link.uuid.isNull()) {
+            continue;
+        }
+        // until one socket answers both are pinged with their type, so the reply says which of them works
+        const PingType_t types[] = { PingType::Public, PingType::Local };
+        const HifiSockAddr* sockets[] = { &link.publicSocket, &link.localSocket };
+        for (int i = 0; i < 2; i++) {
+            if (!link.activeSocket.isNull() && link.activeSocket != *sockets[i]) {
+                continue;
+            }
+            QByteArray ping = byteArrayWithPopulatedHeader(PacketTypePing, bot.sessionUUID);
+            QDataStream pingStream(&ping, QIODevice::Append);
+            pingStream << types[i] << usecTimestampNow();
+            replaceHashInPacketGivenConnectionUUID(ping, link.connectionSecret);
+            sendTo(bot, ping, *sockets[i]);
+        }
+    }
+}
+
+void BotSwarm::sendOctreeQuery(Bot& bot) {
+    if (bot.servers[ENTITY_SERVER].uuid.isNull()) {
+        return;
+    }
+    static unsigned char queryPacket[MAX_PACKET_SIZE];
+    unsigned char* endOfQueryPacket = queryPacket;
+    endOfQueryPacket += populatePacketHeader(reinterpret_cast<char*>(endOfQueryPacket), PacketTypeEntityQuery,
+                                             bot.sessionUUID);
+
+    _octreeQuery.setCameraPosition(bot.avatar->getPosition());
+    _octreeQuery.setCameraOrientation(bot.avatar->getOrientation());
+    endOfQueryPacket += _octreeQuery.getBroadcastData(endOfQueryPacket);
+
+    QByteArray packet(reinterpret_cast<const char*>(queryPacket), endOfQueryPacket - queryPacket);
+    sendToServer(bot, ENTITY_SERVER, packet);
+}
+
+void BotSwarm::move(Bot& bot, float time, float deltaTime) {
+    glm::vec3 position;
+    glm::vec3 direction(0.0f, 0.0f, -1.0f);
+    float phase = (float)bot.index / qMax(_bots.size(), 1);
+
+    if (_settings.path == "line") {
+        // back and forth along x, the bots a meter apart in z
+        float length = 2.0f * _settings.radius;
+        float distance = fmodf(time * _settings.speed + phase * length, 2.0f * length);
+        float x = distance < length ? distance : 2.0f * length - distance;
+        position = _settings.center + glm::vec3(x - _settings.radius, 0.0f, (float)bot.index - 0.5f * _bots.size());
+        direction = glm::vec3(distance < length ? 1.0f : -1.0f, 0.0f, 0.0f);
+
+    } else if (_settings.path == "wander") {
+        // towards a random waypoint inside the radius, and on to another once there
+        position = deltaTime > 0.0f ? bot.avatar->getPosition() : _settings.center;
+        glm::vec3 toWaypoint = bot.waypoint - position;
+        float distance = glm::length(toWaypoint);
+        if (distance < _settings.speed * deltaTime || distance == 0.0f) {
+            float angle = randFloatInRange(0.0f, TWO_PI);
+            float radius = _settings.radius * sqrtf(randFloat());
+            bot.waypoint = _settings.center + glm::vec3(radius * cosf(angle), 0.0f, radius * sinf(angle));
+        } else {
+            direction = toWaypoint / distance;
+            position += direction * _settings.speed * deltaTime;
+        }
+
+    } else {
+        // around the circle, spread evenly along it
+        float angle = TWO_PI * phase + time * _settings.speed / qMax(_settings.radius, EPSILON);
+        position = _settings.center + _settings.radius * glm::vec3(cosf(angle), 0.0f, sinf(angle));
+        direction = glm::vec3(-sinf(angle), 0.0f, cosf(angle));
+    }
+
+    bot.avatar->setPosition(position);
+    bot.avatar->setOrientation(glm::quat(glm::vec3(0.0f, atan2f(-direction.x, -direction.z), 0.0f)));
+}
+
+void BotSwarm::sendAvatarData() {
+    quint64 now = usecTimestampNow();
+    float time = (float)(now - _startTime) / USECS_PER_SECOND;
+    float deltaTime = (float)(now - _lastAvatarTime) / USECS_PER_SECOND;
+    _lastAvatarTime = now;
+
+    // the joints swing a little so there are always some that changed
+    glm::quat jointRotation(glm::vec3(0.2f * sinf(2.0f * time), 0.0f, 0.0f));
+
+    for (int i = 0; i < _bots.size(); i++) {
+        Bot& bot = _bots[i];
+        move(bot, time, deltaTime);
+        if (bot.servers[AVATAR_MIXER].uuid.isNull()) {
+            continue;
+        }
+        for (int joint = 0; joint < _settings.numJoints; joint += 2) {
+            bot.avatar->setJointData(joint, jointRotation);
+        }
+        QByteArray packet = byteArrayWithPopulatedHeader(PacketTypeAvatarData, bot.sessionUUID);
+        packet.append(bot.avatar->toByteArray());
+        sendToServer(bot, AVATAR_MIXER, packet);
+    }
+}
+
+void BotSwarm::sendAudio() {
+    for (int i = 0; i < _bots.size(); i++) {
+        Bot& bot = _bots[i];
+        if (bot.servers[AUDIO_MIXER].uuid.isNull()) {
+            continue;
+        }
+        glm::vec3 position = bot.avatar->getPosition();
+        glm::quat orientation = bot.avatar->getOrientation();
+
+        PacketType packetType = bot.isTalking ? PacketTypeMicrophoneAudioNoEcho : PacketTypeSilentAudioFrame;
+        if (!bot.isTalking && bot.numSilentFrames++ % SILENT_FRAMES_PER_PACKET != 0) {
+            continue;
+        }
+
+        // packed the way the AudioClient packs them
+        QByteArray packet = byteArrayWithPopulatedHeader(packetType, bot.sessionUUID);
+        packet.append(reinterpret_cast<const char*>(&bot.audioSequence), sizeof(quint16));
+        bot.audioSequence++;
+        if (bot.isTalking) {
+            packet.append((char)0); // mono
+            packet.append((char)AudioCodec::PCM);
+        } else {
+            quint16 numSilentSamples = SILENT_FRAMES_PER_PACKET * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+            packet.append(reinterpret_cast<const char*>(&numSilentSamples), sizeof(quint16));
+        }
+        packet.append(reinterpret_cast<const char*>(&position), sizeof(position));
+        packet.append(reinterpret_cast<const char*>(&orientation), sizeof(orientation));
+        if (bot.isTalking) {
+            packet.append(_toneFrame);
+        }
+        sendToServer(bot, AUDIO_MIXER, packet);
+    }
+}
+
+void BotSwarm::readDatagrams(Bot& bot) {
+    static QByteArray packet;
+    HifiSockAddr senderSockAddr;
+    while (bot.socket->hasPendingDatagrams()) {
+        packet.resize(bot.socket->pendingDatagramSize());
+        if (bot.socket->readDatagram(packet.data(), packet.size(), senderSockAddr.getAddressPointer(),
+                                     senderSockAddr.getPortPointer()) < 0) {
+            continue;
+        }
+        PacketType packetType = packetTypeForPacket(packet);
+        Category category = OTHER;
+        switch (packetType) {
+            case PacketTypeDomainList:
+                category = CONTROL;
+                processDomainList(bot, packet);
+                break;
+            case PacketTypeDomainConnectionDenied:
+                category = CONTROL;
+                if (_numDenied++ == 0) {
+                    printf("the domain denied a connection, it may only allow users it can verify\n");
+                }
+                break;
+            case PacketTypePing:
+                category = CONTROL;
+                processPing(bot, packet, senderSockAddr);
+                break;
+            case PacketTypePingReply:
+                category = CONTROL;
+                processPingReply(bot, packet);
+                break;
+            case PacketTypeBulkAvatarData:
+            case PacketTypeAvatarIdentity:
+            case PacketTypeAvatarBillboard:
+            case PacketTypeKillAvatar:
+                category = AVATARS;
+                break;
+            case PacketTypeMixedAudio:
+            case PacketTypeSilentAudioFrame: {
+                category = AUDIO;
+                quint64 now = usecTimestampNow();
+                if (bot.lastAudioReceived != 0) {
+                    bot.audioGaps << now - bot.lastAudioReceived;
+                }
+                bot.lastAudioReceived = now;
+                break;
+            }
+            case PacketTypeEntityData:
+            case PacketTypeEntityErase:
+            case PacketTypeOctreeStats:
+            case PacketTypeJurisdiction:
+                category = OCTREE;
+                break;
+            default:
+                break;
+        }
+        bot.packetsReceived[category]++;
+        bot.bytesReceived[category] += packet.size();
+    }
+}
+
+void BotSwarm::processDomainList(Bot& bot, const QByteArray& packet) {
+    QDataStream packetStream(packet);
+    packetStream.skipRawData(numBytesForPacketHeader(packet));
+
+    // read the same way NodeList::processDomainServerList() does
+    QUuid sessionUUID;
+    bool canAdjustLocks;
+    quint32 listVersion, baseListVersion;
+    QList<QUuid> removedUUIDs;
+    packetStream >> sessionUUID >> canAdjustLocks >> listVersion >> baseListVersion >> removedUUIDs;
+
+    if (bot.sessionUUID != sessionUUID) {
+        bot.sessionUUID = sessionUUID;
+        bot.avatar->setSessionUUID(sessionUUID);
+    }
+    if (baseListVersion == 0 || baseListVersion == bot.domainListVersion || listVersion == bot.domainListVersion) {
+        bot.domainListVersion = listVersion;
+    } else {
+        bot.domainListVersion = 0;
+    }
+
+    foreach (const QUuid& removedUUID, removedUUIDs) {
+        for (int server = 0; server < NUM_SERVERS; server++) {
+            if (bot.servers[server].uuid == removedUUID) {
+                bot.servers[server] = ServerLink();
+            }
+        }
+    }
+
+    while (packetStream.device()->pos() < packet.size()) {
+        qint8 nodeType;
+        QUuid nodeUUID, connectionUUID;
+        HifiSockAddr nodePublicSocket, nodeLocalSocket;
+        bool nodeCanAdjustLocks;
+        packetStream >> nodeType >> nodeUUID >> nodePublicSocket >> nodeLocalSocket >> nodeCanAdjustLocks;
+        packetStream >> connectionUUID;
+
+        int server = serverForNodeType((NodeType_t)nodeType);
+        if (server == -1) {
+            continue;
+        }
+        if (nodePublicSocket.getAddress().isNull()) {
+            nodePublicSocket.setAddress(_domainSockAddr.getAddress());
+        }
+        ServerLink& link = bot.servers[server];
+        if (link.uuid != nodeUUID || link.publicSocket != nodePublicSocket || link.localSocket != nodeLocalSocket) {
+            link = ServerLink();
+            link.uuid = nodeUUID;
+            link.publicSocket = nodePublicSocket;
+            link.localSocket = nodeLocalSocket;
+        }
+        link.connectionSecret = connectionUUID;
+    }
+}
+
+void BotSwarm::processPing(Bot& bot, const QByteArray& packet, const HifiSockAddr& senderSockAddr) {
+    // answer the servers that ping us, their replies are what activate our socket on their side
+    QUuid senderUUID = uuidFromPacketHeader(packet);
+    for (int server = 0; server < NUM_SERVERS; server++) {
+        ServerLink& link = bot.servers[server];
+        if (link.uuid.isNull() || link.uuid != senderUUID) {
+            continue;
+        }
+        QDataStream pingStream(packet);
+        pingStream.skipRawData(numBytesForPacketHeader(packet));
+        PingType_t pingType;
+        quint64 pingTime;
+        pingStream >> pingType >> pingTime;
+
+        QByteArray reply = byteArrayWithPopulatedHeader(PacketTypePingReply, bot.sessionUUID);
+        QDataStream replyStream(&reply, QIODevice::Append);
+        replyStream << pingType << pingTime << usecTimestampNow();
+        replaceHashInPacketGivenConnectionUUID(reply, link.connectionSecret);
+        sendTo(bot, reply, senderSockAddr);
+        return;
+    }
+}
+
+void BotSwarm::processPingReply(Bot& bot, const QByteArray& packet) {
+    QUuid senderUUID = uuidFromPacketHeader(packet);
+    for (int server = 0; server < NUM_SERVERS; server++) {
+        ServerLink& link = bot.servers[server];
+        if (link.uuid.isNull() || link.uuid != senderUUID) {
+            continue;
+        }
+        QDataStream replyStream(packet);
+        replyStream.skipRawData(numBytesForPacketHeader(packet));
+        PingType_t pingType;
+        quint64 pingTime;
+        replyStream >> pingType >> pingTime;
+
+        // the local socket wins over the public one, as it does for the NodeList
+        if (pingType == PingType::Local) {
+            link.activeSocket = link.localSocket;
+        } else if (pingType == PingType::Public && link.activeSocket.isNull()) {
+            link.activeSocket = link.publicSocket;
+        }
+        bot.roundTrips[server] << usecTimestampNow() - pingTime;
+        return;
+    }
+}
+
+static quint64 percentile(QVector<quint64>& values, float fraction) {
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[qMin(values.size() - 1, (int)(values.size() * fraction))];
+}
+
+void BotSwarm::report() {
+    quint64 now = usecTimestampNow();
+    float interval = (float)(now - _lastReportTime) / USECS_PER_SECOND;
+    _lastReportTime = now;
+
+    int numConnected = 0;
+    int numLinked[NUM_SERVERS] = { 0, 0, 0 };
+    qint64 bytesSent = 0;
+    QVector<float> packetRates[NUM_CATEGORIES];
+    QVector<float> kbpsRates[NUM_CATEGORIES];
+    QVector<quint64> audioGaps;
+    QVector<quint64> roundTrips[NUM_SERVERS];
+
+    for (int i = 0; i < _bots.size(); i++) {
+        Bot& bot = _bots[i];
+        if (bot.sessionUUID.isNull()) {
+            continue;
+        }
+        numConnected++;
+        for (int server = 0; server < NUM_SERVERS; server++) {
+            if (!bot.servers[server].activeSocket.isNull()) {
+                numLinked[server]++;
+            }
+            roundTrips[server] += bot.roundTrips[server];
+            bot.roundTrips[server].clear();
+        }
+        for (int category = 0; category < NUM_CATEGORIES; category++) {
+            packetRates[category] << bot.packetsReceived[category] / interval;
+            kbpsRates[category] << bot.bytesReceived[category] * BITS_IN_BYTE / interval / 1000.0f;
+            bot.packetsReceived[category] = 0;
+            bot.bytesReceived[category] = 0;
+        }
+        audioGaps += bot.audioGaps;
+        bot.audioGaps.clear();
+        bytesSent += bot.bytesSent;
+        bot.bytesSent = 0;
+    }
+
+    printf("\n%.0f s: %d of %d bots connected, linked to the avatar mixer: %d audio mixer: %d entity server: %d, "
+           "sending %.0f kbps\n", (float)(now - _startTime) / USECS_PER_SECOND, numConnected, _bots.size(),
+           numLinked[AVATAR_MIXER], numLinked[AUDIO_MIXER], numLinked[ENTITY_SERVER],
+           bytesSent * BITS_IN_BYTE / interval / 1000.0f);
+    if (numConnected == 0) {
+        return;
+    }
+
+    printf("  received per bot     packets/s (min mean max)           kbps (min mean max)\n");
+    for (int category = 0; category < NUM_CATEGORIES; category++) {
+        QVector<float>& packets = packetRates[category];
+        QVector<float>& kbps = kbpsRates[category];
+        float packetSum = 0.0f, kbpsSum = 0.0f;
+        for (int i = 0; i < packets.size(); i++) {
+            packetSum += packets[i];
+            kbpsSum += kbps[i];
+        }
+        printf("  %-8s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", CATEGORY_NAMES[category],
+               *std::min_element(packets.begin(), packets.end()), packetSum / packets.size(),
+               *std::max_element(packets.begin(), packets.end()), *std::min_element(kbps.begin(), kbps.end()),
+               kbpsSum / kbps.size(), *std::max_element(kbps.begin(), kbps.end()));
+    }
+    if (!audioGaps.isEmpty()) {
+        printf("  mixed audio gap p50: %.1f ms p99: %.1f ms max: %.1f ms\n",
+               (float)percentile(audioGaps, 0.5f) / USECS_PER_MSEC, (float)percentile(audioGaps, 0.99f) / USECS_PER_MSEC,
+               (float)percentile(audioGaps, 1.0f) / USECS_PER_MSEC);
+    }
+    for (int server = 0; server < NUM_SERVERS; server++) {
+        if (!roundTrips[server].isEmpty()) {
+            printf("  %s ping p50: %.1f ms p99: %.1f ms max: %.1f ms\n", SERVER_NAMES[server],
+                   (float)percentile(roundTrips[server], 0.5f) / USECS_PER_MSEC,
+                   (float)percentile(roundTrips[server], 0.99f) / USECS_PER_MSEC,
+                   (float)percentile(roundTrips[server], 1.0f) / USECS_PER_MSEC);
+        }
+    }
+    fflush(stdout);
+
+    if (_settings.seconds > 0 && now - _startTime >= (quint64)_settings.seconds * USECS_PER_SECOND) {
+        QCoreApplication::quit();
+    }
+}
@@ -0,0 +1,144 @@
+//
+//  BotSwarm.h
+//  tools/bot-swarm/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BotSwarm_h
+#define hifi_BotSwarm_h
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtNetwork/QUdpSocket>
+
+#include <glm/glm.hpp>
+
+#include <HifiSockAddr.h>
+#include <Node.h>
+#include <OctreeQuery.h>
+#include <PacketHeaders.h>
+
+class AvatarData;
+
+/// Connects a swarm of synthetic clients to a domain from one process, each with a socket of its own, and has them
+/// move along paths sending what an interface sends: avatar data and identity to the avatar mixer, microphone or
+/// silent audio to the audio mixer and octree queries to the entity server.  It reports what each client gets back
+/// and how long the servers take to answer a ping, so the mixers can be loaded the way a crowd would load them.
+class BotSwarm : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        Settings();
+
+        QString domainHostname;
+        quint16 domainPort;
+        int numBots;
+        QString path;           // circle, line or wander
+        glm::vec3 center;       // meters
+        float radius;           // meters
+        float speed;            // meters per second
+        int numJoints;
+        float talkingFraction;  // of the bots that send a tone, the others send silent frames
+        bool queryEntities;
+        int maxOctreePacketsPerSecond;
+        int seconds;            // 0 to run until killed
+        int reportInterval;     // seconds
+    };
+
+    BotSwarm(const Settings& settings, QObject* parent = NULL);
+    ~BotSwarm();
+
+    /// \return false if the domain's hostname can't be resolved
+    bool start();
+
+private slots:
+    void checkIn();
+    void sendAvatarData();
+    void sendAudio();
+    void report();
+
+private:
+    enum Server {
+        AVATAR_MIXER,
+        AUDIO_MIXER,
+        ENTITY_SERVER,
+        NUM_SERVERS
+    };
+
+    enum Category {
+        AVATARS,
+        AUDIO,
+        OCTREE,
+        CONTROL,    // domain lists and pings
+        OTHER,
+        NUM_CATEGORIES
+    };
+
+    struct ServerLink {
+        QUuid uuid;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket;          // null until a ping reply says which of the two works
+        QUuid connectionSecret;
+    };
+
+    struct Bot {
+        Bot();
+
+        int index;
+        QUdpSocket* socket;
+        HifiSockAddr localSockAddr;
+        QUuid connectUUID;                  // the connect requests' UUID, until the domain gives a session UUID
+        QUuid sessionUUID;
+        quint32 domainListVersion;
+        ServerLink servers[NUM_SERVERS];
+
+        AvatarData* avatar;
+        bool isTalking;
+        quint16 audioSequence;
+        int numSilentFrames;
+        glm::vec3 waypoint;
+
+        // this report interval's counts
+        int packetsReceived[NUM_CATEGORIES];
+        qint64 bytesReceived[NUM_CATEGORIES];
+        qint64 bytesSent;
+        quint64 lastAudioReceived;
+        QVector<quint64> audioGaps;
+        QVector<quint64> roundTrips[NUM_SERVERS];
+    };
+
+    void readDatagrams(Bot& bot);
+    void processDomainList(Bot& bot, const QByteArray& packet);
+    void processPing(Bot& bot, const QByteArray& packet, const HifiSockAddr& senderSockAddr);
+    void processPingReply(Bot& bot, const QByteArray& packet);
+
+    /// hashes the packet for the server if it's verified and sends it to the server's active socket, or to both
+    /// candidates until one is active
+    void sendToServer(Bot& bot, Server server, QByteArray& packet);
+    void sendTo(Bot& bot, const QByteArray& packet, const HifiSockAddr& destination);
+    void sendPings(Bot& bot);
+    void sendOctreeQuery(Bot& bot);
+
+    /// moves the bot along its path by deltaTime seconds
+    void move(Bot& bot, float time, float deltaTime);
+
+    int serverForNodeType(NodeType_t nodeType) const;
+
+    Settings _settings;
+    HifiSockAddr _domainSockAddr;
+    QVector<Bot> _bots;
+    OctreeQuery _octreeQuery;
+    QByteArray _toneFrame;
+
+    quint64 _startTime;
+    quint64 _lastAvatarTime;
+    quint64 _lastReportTime;
+    int _numDenied;
+};
+
+#endif // hifi_BotSwarm_h
@@ -0,0 +1,88 @@
+//
+//  main.cpp
+//  tools/bot-swarm/src
+//
+//  Copyright 2026 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+
+#include "BotSwarm.h"
+
+static void printUsage() {
+    printf("usage: bot-swarm [--domain HOST[:PORT]] [--bots N] [--path circle|line|wander] [--center X,Y,Z]\n"
+           "                 [--radius METERS] [--speed METERS_PER_SECOND] [--joints N] [--talking FRACTION]\n"
+           "                 [--entities 0|1] [--octree-pps N] [--seconds N] [--report SECONDS]\n");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    BotSwarm::Settings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (strcmp(option, "--domain") == 0) {
+            QStringList hostAndPort = QString(value).split(':');
+            settings.domainHostname = hostAndPort.at(0);
+            if (hostAndPort.size() > 1) {
+                settings.domainPort = (quint16)hostAndPort.at(1).toUInt();
+            }
+        } else if (strcmp(option, "--bots") == 0) {
+            settings.numBots = atoi(value);
+        } else if (strcmp(option, "--path") == 0) {
+            settings.path = value;
+        } else if (strcmp(option, "--center") == 0) {
+            QStringList coordinates = QString(value).split(',');
+            if (coordinates.size() != 3) {
+                printUsage();
+                return 1;
+            }
+            settings.center = glm::vec3(coordinates.at(0).toFloat(), coordinates.at(1).toFloat(),
+                                        coordinates.at(2).toFloat());
+        } else if (strcmp(option, "--radius") == 0) {
+            settings.radius = (float)atof(value);
+        } else if (strcmp(option, "--speed") == 0) {
+            settings.speed = (float)atof(value);
+        } else if (strcmp(option, "--joints") == 0) {
+            settings.numJoints = atoi(value);
+        } else if (strcmp(option, "--talking") == 0) {
+            settings.talkingFraction = (float)atof(value);
+        } else if (strcmp(option, "--entities") == 0) {
+            settings.queryEntities = atoi(value) != 0;
+        } else if (strcmp(option, "--octree-pps") == 0) {
+            settings.maxOctreePacketsPerSecond = atoi(value);
+        } else if (strcmp(option, "--seconds") == 0) {
+            settings.seconds = atoi(value);
+        } else if (strcmp(option, "--report") == 0) {
+            settings.reportInterval = qMax(1, atoi(value));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.path != "circle" && settings.path != "line" && settings.path != "wander") {
+        printUsage();
+        return 1;
+    }
+
+    BotSwarm swarm(settings);
+    if (!swarm.start()) {
+        return 1;
+    }
+    return app.exec();
+}